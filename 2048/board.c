@@ -0,0 +1,98 @@
+#include "board.h"
+
+#define ROW_MASK 0xFFFFULL
+
+uint8_t board_get_cell(Board board, uint8_t row, uint8_t column) {
+    return (board >> (4 * (BOARD_SIZE * row + column))) & 0xF;
+}
+
+Board board_set_cell(Board board, uint8_t row, uint8_t column, uint8_t value) {
+    uint8_t shift = 4 * (BOARD_SIZE * row + column);
+    return (board & ~(0xFULL << shift)) | ((Board)(value & 0xF) << shift);
+}
+
+uint8_t board_count_empty(Board board) {
+    uint8_t count = 0;
+    for(uint8_t i = 0; i < BOARD_SIZE * BOARD_SIZE; i++) {
+        if(((board >> (4 * i)) & 0xF) == 0) count++;
+    }
+    return count;
+}
+
+// Swaps rows and columns with three masked nibble exchanges instead of a cell-by-cell copy
+Board board_transpose(Board board) {
+    Board a1 = board & 0xF0F00F0FF0F00F0FULL;
+    Board a2 = board & 0x0000F0F00000F0F0ULL;
+    Board a3 = board & 0x0F0F00000F0F0000ULL;
+    Board a = a1 | (a2 << 12) | (a3 >> 12);
+    Board b1 = a & 0xFF00FF0000FF00FFULL;
+    Board b2 = a & 0x00FF00FF00000000ULL;
+    Board b3 = a & 0x00000000FF00FF00ULL;
+    return b1 | (b2 >> 24) | (b3 << 24);
+}
+
+static uint16_t reverse_row(uint16_t row) {
+    return (row >> 12) | ((row >> 4) & 0x00F0) | ((row << 4) & 0x0F00) | (row << 12);
+}
+
+// Slides a packed row towards column 0, merging each pair of equal tiles once.
+// Two tiles of the largest exponent don't fit into a cell and are left as they are.
+static uint16_t move_row_left(uint16_t row, uint32_t* points) {
+    uint16_t result = 0;
+    uint8_t count = 0;
+    uint8_t pending = 0;
+    for(uint8_t i = 0; i < BOARD_SIZE; i++) {
+        uint8_t value = (row >> (4 * i)) & 0xF;
+        if(value == 0) continue;
+        if(pending == value && value < BOARD_MAX_EXPONENT) {
+            result |= (uint16_t)(value + 1) << (4 * count++);
+            *points += 2 << value;
+            pending = 0;
+        } else {
+            if(pending) result |= (uint16_t)pending << (4 * count++);
+            pending = value;
+        }
+    }
+    if(pending) result |= (uint16_t)pending << (4 * count);
+    return result;
+}
+
+static Board move_rows(Board board, bool reverse, uint32_t* points) {
+    Board result = 0;
+    for(uint8_t r = 0; r < BOARD_SIZE; r++) {
+        uint16_t row = (board >> (16 * r)) & ROW_MASK;
+        if(reverse) {
+            row = reverse_row(move_row_left(reverse_row(row), points));
+        } else {
+            row = move_row_left(row, points);
+        }
+        result |= (Board)row << (16 * r);
+    }
+    return result;
+}
+
+Board board_move(Board board, Direction direction, uint32_t* points) {
+    uint32_t unused = 0;
+    if(!points) points = &unused;
+
+    switch(direction) {
+    case DirectionLeft:
+        return move_rows(board, false, points);
+    case DirectionRight:
+        return move_rows(board, true, points);
+    case DirectionUp:
+        return board_transpose(move_rows(board_transpose(board), false, points));
+    case DirectionDown:
+        return board_transpose(move_rows(board_transpose(board), true, points));
+    default:
+        return board;
+    }
+}
+
+bool board_can_move(Board board) {
+    if(board_count_empty(board)) return true;
+    for(uint8_t direction = 0; direction < DirectionCount; direction++) {
+        if(board_move(board, direction, NULL) != board) return true;
+    }
+    return false;
+}
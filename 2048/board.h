@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// The 4x4 board packed into 64 bits: each cell is a 4-bit exponent (0 - empty, 1 - "2",
+// 2 - "4", ...), the cell at row r and column c lives in bits [4 * (4 * r + c), +4)
+typedef uint64_t Board;
+
+#define BOARD_SIZE 4
+#define BOARD_MAX_EXPONENT 15
+
+typedef enum {
+    DirectionLeft,
+    DirectionRight,
+    DirectionUp,
+    DirectionDown,
+    DirectionCount,
+} Direction;
+
+uint8_t board_get_cell(Board board, uint8_t row, uint8_t column);
+
+Board board_set_cell(Board board, uint8_t row, uint8_t column, uint8_t value);
+
+uint8_t board_count_empty(Board board);
+
+// Returns the board after the move, `points` (optional) receives the merged tiles' value.
+// The board is returned unchanged if nothing can move in that direction.
+Board board_move(Board board, Direction direction, uint32_t* points);
+
+bool board_can_move(Board board);
+
+Board board_transpose(Board board);
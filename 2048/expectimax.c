@@ -0,0 +1,161 @@
+#include "expectimax.h"
+
+#include <furi.h>
+
+#define SEARCH_MAX_DEPTH 8
+// chance branches less likely than this are evaluated instead of searched
+#define SEARCH_MIN_PROBABILITY 0.0001f
+// how many nodes are searched between checks of the time budget
+#define SEARCH_CHECK_MASK 0x3F
+
+// Heuristic weights, per row and per column
+#define SCORE_LOST_PENALTY 200000.0f
+#define MONOTONICITY_WEIGHT 47.0f
+#define SUM_WEIGHT 11.0f
+#define MERGES_WEIGHT 700.0f
+#define EMPTY_WEIGHT 270.0f
+
+// exponent ^ 3.5 and exponent ^ 4
+static const float sum_powers[16] = {
+    0.0f,    1.0f,    11.3f,   46.8f,   128.0f,  279.5f,  529.1f,   907.5f,
+    1448.2f, 2187.0f, 3162.3f, 4414.4f, 5986.0f, 7921.4f, 10267.1f, 13071.3f,
+};
+static const float monotonicity_powers[16] = {
+    0.0f,    1.0f,    16.0f,    81.0f,    256.0f,   625.0f,   1296.0f,  2401.0f,
+    4096.0f, 6561.0f, 10000.0f, 14641.0f, 20736.0f, 28561.0f, 38416.0f, 50625.0f,
+};
+
+typedef struct {
+    uint32_t start;
+    uint32_t budget;
+    uint32_t nodes;
+    bool aborted;
+} SearchContext;
+
+// Rewards empty cells and adjacent equal tiles, punishes big tiles and rows that are not
+// sorted in either direction
+static float evaluate_row(uint16_t row) {
+    uint8_t line[BOARD_SIZE];
+    float sum = 0;
+    uint8_t empty = 0;
+    uint8_t merges = 0;
+    uint8_t prev = 0;
+    uint8_t counter = 0;
+    for(uint8_t i = 0; i < BOARD_SIZE; i++) {
+        uint8_t rank = (row >> (4 * i)) & 0xF;
+        line[i] = rank;
+        sum += sum_powers[rank];
+        if(rank == 0) {
+            empty++;
+        } else {
+            if(prev == rank) {
+                counter++;
+            } else if(counter > 0) {
+                merges += 1 + counter;
+                counter = 0;
+            }
+            prev = rank;
+        }
+    }
+    if(counter > 0) merges += 1 + counter;
+
+    float monotonicity_left = 0;
+    float monotonicity_right = 0;
+    for(uint8_t i = 1; i < BOARD_SIZE; i++) {
+        if(line[i - 1] > line[i]) {
+            monotonicity_left += monotonicity_powers[line[i - 1]] - monotonicity_powers[line[i]];
+        } else {
+            monotonicity_right += monotonicity_powers[line[i]] - monotonicity_powers[line[i - 1]];
+        }
+    }
+
+    return SCORE_LOST_PENALTY + EMPTY_WEIGHT * empty + MERGES_WEIGHT * merges -
+           MONOTONICITY_WEIGHT *
+               (monotonicity_left < monotonicity_right ? monotonicity_left : monotonicity_right) -
+           SUM_WEIGHT * sum;
+}
+
+static float evaluate(Board board) {
+    Board transposed = board_transpose(board);
+    float score = 0;
+    for(uint8_t r = 0; r < BOARD_SIZE; r++) {
+        score += evaluate_row((board >> (16 * r)) & 0xFFFF);
+        score += evaluate_row((transposed >> (16 * r)) & 0xFFFF);
+    }
+    return score;
+}
+
+static float search_chance(SearchContext* ctx, Board board, uint8_t depth, float probability);
+
+// Player's turn: the best of the moves that change the board, 0 if there are none
+static float search_max(SearchContext* ctx, Board board, uint8_t depth, float probability) {
+    if((++ctx->nodes & SEARCH_CHECK_MASK) == 0 && furi_get_tick() - ctx->start >= ctx->budget) {
+        ctx->aborted = true;
+    }
+    if(ctx->aborted) return 0;
+
+    float best = 0;
+    for(uint8_t direction = 0; direction < DirectionCount; direction++) {
+        Board moved = board_move(board, direction, NULL);
+        if(moved == board) continue;
+        float score = search_chance(ctx, moved, depth, probability);
+        if(score > best) best = score;
+    }
+    return best;
+}
+
+// New tile's turn: a 2 (90%) or a 4 (10%) on any empty cell, averaged
+static float search_chance(SearchContext* ctx, Board board, uint8_t depth, float probability) {
+    uint8_t empty = board_count_empty(board);
+    if(depth == 0 || empty == 0 || probability < SEARCH_MIN_PROBABILITY) {
+        return evaluate(board);
+    }
+
+    float total = 0;
+    float cell_probability = probability / empty;
+    for(uint8_t i = 0; i < BOARD_SIZE * BOARD_SIZE; i++) {
+        uint8_t shift = 4 * i;
+        if((board >> shift) & 0xF) continue;
+        total += 0.9f * search_max(
+                             ctx, board | (1ULL << shift), depth - 1, cell_probability * 0.9f);
+        total += 0.1f * search_max(
+                             ctx, board | (2ULL << shift), depth - 1, cell_probability * 0.1f);
+        if(ctx->aborted) return 0;
+    }
+    return total / empty;
+}
+
+// Iterative deepening: a depth that runs out of time is thrown away and the previous
+// depth's choice is kept
+int8_t expectimax_best_move(Board board, uint32_t time_ms) {
+    int8_t best = -1;
+    for(uint8_t direction = 0; direction < DirectionCount; direction++) {
+        if(board_move(board, direction, NULL) != board) {
+            best = direction;
+            break;
+        }
+    }
+    if(best < 0) return -1;
+
+    SearchContext ctx = {
+        .start = furi_get_tick(),
+        .budget = furi_ms_to_ticks(time_ms),
+        .nodes = 0,
+        .aborted = false,
+    };
+    for(uint8_t depth = 1; depth <= SEARCH_MAX_DEPTH && !ctx.aborted; depth++) {
+        int8_t depth_best = best;
+        float best_score = -1;
+        for(uint8_t direction = 0; direction < DirectionCount && !ctx.aborted; direction++) {
+            Board moved = board_move(board, direction, NULL);
+            if(moved == board) continue;
+            float score = search_chance(&ctx, moved, depth - 1, 1.0f);
+            if(score > best_score) {
+                best_score = score;
+                depth_best = direction;
+            }
+        }
+        if(!ctx.aborted) best = depth_best;
+    }
+    return best;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "board.h"
+
+// Picks the move with the best expected outcome, searching deeper while `time_ms` allows.
+// Returns -1 if no move is possible.
+int8_t expectimax_best_move(Board board, uint32_t time_ms);
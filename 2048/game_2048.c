@@ -16,9 +16,10 @@
 #include <dolphin/dolphin.h>
 
 #include "digits.h"
-#include "array_utils.h"
+#include "board.h"
+#include "expectimax.h"
 
-#define CELLS_COUNT 4
+#define CELLS_COUNT BOARD_SIZE
 #define CELL_INNER_SIZE 14
 #define FRAME_LEFT 10
 #define FRAME_TOP 1
@@ -27,6 +28,11 @@
 #define SAVING_DIRECTORY STORAGE_APP_DATA_PATH_PREFIX
 #define SAVING_FILENAME SAVING_DIRECTORY "/game_2048.save"
 
+#define HINT_TIME_MS 500
+#define AUTOPLAY_TIME_MS 150
+#define AUTOPLAY_INTERVAL_MS 50
+#define HINT_NONE -1
+
 typedef enum {
     GameStateMenu,
     GameStateInProgress,
@@ -36,20 +42,35 @@ typedef enum {
 typedef struct {
     FuriMutex* mutex;
     State state;
-    uint8_t table[CELLS_COUNT][CELLS_COUNT];
+    Board board;
     uint32_t score;
     uint32_t moves;
     int8_t selected_menu_item;
     uint32_t top_score;
+    int8_t hint;
+    bool autoplay;
 } GameState;
 
+// Save file layout of the versions with a byte per cell
 typedef struct {
-    uint32_t points;
-    bool is_table_updated;
-} MoveResult;
+    FuriMutex* mutex;
+    State state;
+    uint8_t table[CELLS_COUNT][CELLS_COUNT];
+    uint32_t score;
+    uint32_t moves;
+    int8_t selected_menu_item;
+    uint32_t top_score;
+} LegacyGameState;
 
-#define MENU_ITEMS_COUNT 2
-static const char* popup_menu_strings[] = {"Resume", "New Game"};
+typedef enum {
+    MenuItemResume,
+    MenuItemNewGame,
+    MenuItemHint,
+    MenuItemAutoplay,
+    MENU_ITEMS_COUNT,
+} MenuItem;
+static const char* popup_menu_strings[] = {"Resume", "New Game", "Hint", "Autoplay"};
+static const char* hint_strings[] = {"<", ">", "^", "v"};
 
 static void input_callback(InputEvent* input_event, void* ctx) {
     furi_assert(ctx);
@@ -87,10 +108,10 @@ static void draw_digit(Canvas* canvas, uint8_t row, uint8_t column, uint8_t valu
     }
 }
 
-static void draw_table(Canvas* canvas, const uint8_t table[CELLS_COUNT][CELLS_COUNT]) {
+static void draw_table(Canvas* canvas, Board board) {
     for(uint8_t row = 0; row < CELLS_COUNT; row++) {
         for(uint8_t column = 0; column < CELLS_COUNT; column++) {
-            draw_digit(canvas, row, column, table[row][column]);
+            draw_digit(canvas, row, column, board_get_cell(board, row, column));
         }
     }
 }
@@ -112,7 +133,18 @@ static void draw_callback(Canvas* const canvas, void* ctx) {
     canvas_clear(canvas);
 
     draw_frame(canvas);
-    draw_table(canvas, game_state->table);
+    draw_table(canvas, game_state->board);
+
+    if(game_state->hint != HINT_NONE) {
+        canvas_set_font(canvas, FontPrimary);
+        canvas_draw_str_aligned(
+            canvas,
+            FRAME_LEFT / 2,
+            FRAME_TOP + FRAME_SIZE / 2,
+            AlignCenter,
+            AlignCenter,
+            hint_strings[game_state->hint]);
+    }
 
     canvas_set_font(canvas, FontPrimary);
     canvas_draw_str_aligned(canvas, 128, FRAME_TOP, AlignRight, AlignTop, "Score");
@@ -139,20 +171,20 @@ static void draw_callback(Canvas* const canvas, void* ctx) {
         gray_canvas(canvas);
 
         canvas_set_color(canvas, ColorWhite);
-        canvas_draw_rbox(canvas, 28, 16, 72, 32, 4);
+        canvas_draw_rbox(canvas, 28, 4, 72, 56, 4);
         canvas_set_color(canvas, ColorBlack);
-        canvas_draw_rframe(canvas, 28, 16, 72, 32, 4);
+        canvas_draw_rframe(canvas, 28, 4, 72, 56, 4);
 
         for(int i = 0; i < MENU_ITEMS_COUNT; i++) {
             if(i == game_state->selected_menu_item) {
                 canvas_set_color(canvas, ColorBlack);
-                canvas_draw_box(canvas, 34, 20 + 12 * i, 60, 12);
+                canvas_draw_box(canvas, 34, 8 + 12 * i, 60, 12);
             }
 
             canvas_set_color(
                 canvas, i == game_state->selected_menu_item ? ColorWhite : ColorBlack);
             canvas_draw_str_aligned(
-                canvas, 64, 26 + 12 * i, AlignCenter, AlignCenter, popup_menu_strings[i]);
+                canvas, 64, 14 + 12 * i, AlignCenter, AlignCenter, popup_menu_strings[i]);
         }
 
     } else if(game_state->state == GameStateGameOver) {
@@ -186,91 +218,12 @@ static void draw_callback(Canvas* const canvas, void* ctx) {
     furi_mutex_release(game_state->mutex);
 }
 
-void calculate_move_to_left(uint8_t arr[], MoveResult* const move_result) {
-    uint8_t index = 0;
-    uint8_t next_index;
-    uint8_t offset;
-    bool was_moved;
-    while(index < CELLS_COUNT - 1) {
-        // find offset from [index] to next non-empty value
-        offset = 1;
-        while(index + offset < CELLS_COUNT && arr[index + offset] == 0) offset++;
-
-        // if all remaining values in this row are empty then go to next row
-        if(index + offset >= CELLS_COUNT) break;
-
-        // if current cell is empty then shift all cells [index+offset .. CELLS_COUNT-1] to [index]
-        if(arr[index] == 0) {
-            was_moved = shift_array_to_left(CELLS_COUNT, arr, index, offset);
-            if(was_moved) move_result->is_table_updated = true;
-        }
-
-        next_index = index + 1;
-        if(arr[next_index] == 0) {
-            // find offset from [next_index] to next non-empty value
-            offset = 1;
-            while(next_index + offset < CELLS_COUNT && arr[next_index + offset] == 0) offset++;
-
-            // if all remaining values in this row are empty then go to next row
-            if(next_index + offset >= CELLS_COUNT) break;
-
-            // if next cell is empty then shift cells [next_index+offset .. CELLS_COUNT-1] to [next_index]
-            was_moved = shift_array_to_left(CELLS_COUNT, arr, next_index, offset);
-            if(was_moved) move_result->is_table_updated = true;
-        }
-
-        if(arr[index] == arr[next_index]) {
-            arr[index]++;
-            shift_array_to_left(CELLS_COUNT, arr, next_index, 1);
-
-            move_result->is_table_updated = true;
-            move_result->points += 2 << (arr[index] - 1);
-        }
-
-        index++;
-    }
-}
-
-void move_left(uint8_t table[CELLS_COUNT][CELLS_COUNT], MoveResult* const move_result) {
-    for(uint8_t row_index = 0; row_index < CELLS_COUNT; row_index++) {
-        calculate_move_to_left(table[row_index], move_result);
-    }
-}
-
-void move_right(uint8_t table[CELLS_COUNT][CELLS_COUNT], MoveResult* const move_result) {
-    for(uint8_t row_index = 0; row_index < CELLS_COUNT; row_index++) {
-        reverse_array(CELLS_COUNT, table[row_index]);
-        calculate_move_to_left(table[row_index], move_result);
-        reverse_array(CELLS_COUNT, table[row_index]);
-    }
-}
-
-void move_up(uint8_t table[CELLS_COUNT][CELLS_COUNT], MoveResult* const move_result) {
-    uint8_t column[CELLS_COUNT];
-    for(uint8_t column_index = 0; column_index < CELLS_COUNT; column_index++) {
-        get_column_from_array(CELLS_COUNT, CELLS_COUNT, table, column_index, column);
-        calculate_move_to_left(column, move_result);
-        set_column_to_array(CELLS_COUNT, CELLS_COUNT, table, column_index, column);
-    }
-}
-
-void move_down(uint8_t table[CELLS_COUNT][CELLS_COUNT], MoveResult* const move_result) {
-    uint8_t column[CELLS_COUNT];
-    for(uint8_t column_index = 0; column_index < CELLS_COUNT; column_index++) {
-        get_column_from_array(CELLS_COUNT, CELLS_COUNT, table, column_index, column);
-        reverse_array(CELLS_COUNT, column);
-        calculate_move_to_left(column, move_result);
-        reverse_array(CELLS_COUNT, column);
-        set_column_to_array(CELLS_COUNT, CELLS_COUNT, table, column_index, column);
-    }
-}
-
 void add_new_digit(GameState* const game_state) {
     uint8_t empty_cell_indexes[CELLS_COUNT * CELLS_COUNT];
     uint8_t empty_cells_count = 0;
     for(u_int8_t i = 0; i < CELLS_COUNT; i++) {
         for(u_int8_t j = 0; j < CELLS_COUNT; j++) {
-            if(game_state->table[i][j] == 0) {
+            if(board_get_cell(game_state->board, i, j) == 0) {
                 empty_cell_indexes[empty_cells_count++] = i * CELLS_COUNT + j;
             }
         }
@@ -282,11 +235,12 @@ void add_new_digit(GameState* const game_state) {
     u_int8_t col = random_empty_cell_index % CELLS_COUNT;
 
     int random_value_percent = random() % 100;
-    game_state->table[row][col] = random_value_percent < 90 ? 1 : 2; // 90% for 2, 25% for 4
+    game_state->board = board_set_cell(
+        game_state->board, row, col, random_value_percent < 90 ? 1 : 2); // 90% for 2, 10% for 4
 }
 
 void init_game(GameState* const game_state, bool clear_top_score) {
-    memset(game_state->table, 0, CELLS_COUNT * CELLS_COUNT * sizeof(uint8_t));
+    game_state->board = 0;
     add_new_digit(game_state);
     add_new_digit(game_state);
 
@@ -294,6 +248,8 @@ void init_game(GameState* const game_state, bool clear_top_score) {
     game_state->moves = 0;
     game_state->state = GameStateInProgress;
     game_state->selected_menu_item = 0;
+    game_state->hint = HINT_NONE;
+    game_state->autoplay = false;
     if(clear_top_score) {
         game_state->top_score = 0;
     }
@@ -303,17 +259,46 @@ bool load_game(GameState* game_state) {
     Storage* storage = furi_record_open(RECORD_STORAGE);
     storage_common_migrate(storage, EXT_PATH("apps/Games/game_2048.save"), SAVING_FILENAME);
 
+    union {
+        GameState current;
+        LegacyGameState legacy;
+    } saved;
     File* file = storage_file_alloc(storage);
     uint16_t bytes_readed = 0;
     if(storage_file_open(file, SAVING_FILENAME, FSAM_READ, FSOM_OPEN_EXISTING)) {
-        bytes_readed = storage_file_read(file, game_state, sizeof(GameState));
+        bytes_readed = storage_file_read(file, &saved, sizeof(saved));
     }
     storage_file_close(file);
     storage_file_free(file);
 
     furi_record_close(RECORD_STORAGE);
 
-    return bytes_readed == sizeof(GameState);
+    if(bytes_readed == sizeof(GameState)) {
+        *game_state = saved.current;
+    } else if(bytes_readed == sizeof(LegacyGameState)) {
+        // keep the game and the top score from a save of an older version
+        game_state->state = saved.legacy.state;
+        game_state->board = 0;
+        for(uint8_t row = 0; row < CELLS_COUNT; row++) {
+            for(uint8_t column = 0; column < CELLS_COUNT; column++) {
+                uint8_t value = saved.legacy.table[row][column];
+                game_state->board = board_set_cell(
+                    game_state->board,
+                    row,
+                    column,
+                    value > BOARD_MAX_EXPONENT ? BOARD_MAX_EXPONENT : value);
+            }
+        }
+        game_state->score = saved.legacy.score;
+        game_state->moves = saved.legacy.moves;
+        game_state->selected_menu_item = saved.legacy.selected_menu_item;
+        game_state->top_score = saved.legacy.top_score;
+    } else {
+        return false;
+    }
+    game_state->hint = HINT_NONE;
+    game_state->autoplay = false;
+    return true;
 }
 
 void save_game(GameState* game_state) {
@@ -330,44 +315,28 @@ void save_game(GameState* game_state) {
 }
 
 bool is_game_over(GameState* const game_state) {
-    FURI_LOG_I("is_game_over", "====check====");
-
-    // check if table contains at least one empty cell
-    for(uint8_t i = 0; i < CELLS_COUNT; i++) {
-        for(u_int8_t j = 0; j < CELLS_COUNT; j++) {
-            if(game_state->table[i][j] == 0) {
-                FURI_LOG_I("is_game_over", "has empty cells");
-                return false;
-            }
-        }
-    }
-    FURI_LOG_I("is_game_over", "no empty cells");
-
-    uint8_t tmp_table[CELLS_COUNT][CELLS_COUNT];
-    MoveResult* tmp_move_result = malloc(sizeof(MoveResult));
-
-    // check if we can move to any direction
-    memcpy(tmp_table, game_state->table, CELLS_COUNT * CELLS_COUNT * sizeof(uint8_t));
-    move_left(tmp_table, tmp_move_result);
-    if(tmp_move_result->is_table_updated) return false;
-    FURI_LOG_I("is_game_over", "can't move left");
-
-    memcpy(tmp_table, game_state->table, CELLS_COUNT * CELLS_COUNT * sizeof(uint8_t));
-    move_right(tmp_table, tmp_move_result);
-    if(tmp_move_result->is_table_updated) return false;
-    FURI_LOG_I("is_game_over", "can't move right");
+    return !board_can_move(game_state->board);
+}
 
-    memcpy(tmp_table, game_state->table, CELLS_COUNT * CELLS_COUNT * sizeof(uint8_t));
-    move_up(tmp_table, tmp_move_result);
-    if(tmp_move_result->is_table_updated) return false;
-    FURI_LOG_I("is_game_over", "can't move up");
+void make_move(GameState* const game_state, Direction direction) {
+    uint32_t points = 0;
+    Board moved = board_move(game_state->board, direction, &points);
+    game_state->score += points;
+    game_state->hint = HINT_NONE;
 
-    memcpy(tmp_table, game_state->table, CELLS_COUNT * CELLS_COUNT * sizeof(uint8_t));
-    move_down(tmp_table, tmp_move_result);
-    if(tmp_move_result->is_table_updated) return false;
-    FURI_LOG_I("is_game_over", "can't move down");
+    if(moved != game_state->board) {
+        game_state->board = moved;
+        game_state->moves++;
+        add_new_digit(game_state);
+    }
 
-    return true;
+    if(is_game_over(game_state)) {
+        game_state->state = GameStateGameOver;
+        game_state->autoplay = false;
+        if(game_state->score >= game_state->top_score) {
+            game_state->top_score = game_state->score;
+        }
+    }
 }
 
 int32_t game_2048_app() {
@@ -376,8 +345,6 @@ int32_t game_2048_app() {
         init_game(game_state, true);
     }
 
-    MoveResult* move_result = malloc(sizeof(MoveResult));
-
     game_state->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
     if(!game_state->mutex) {
         FURI_LOG_E("2048Game", "cannot create mutex\r\n");
@@ -400,13 +367,37 @@ int32_t game_2048_app() {
 
     bool is_finished = false;
     while(!is_finished) {
-        FuriStatus event_status = furi_message_queue_get(event_queue, &input, FuriWaitForever);
+        // only this thread changes the game state, so it can be searched without the mutex
+        bool autoplay = game_state->autoplay && game_state->state == GameStateInProgress;
+        FuriStatus event_status = furi_message_queue_get(
+            event_queue, &input, autoplay ? AUTOPLAY_INTERVAL_MS : FuriWaitForever);
+        if(event_status != FuriStatusOk && autoplay) {
+            int8_t direction = expectimax_best_move(game_state->board, AUTOPLAY_TIME_MS);
+
+            furi_mutex_acquire(game_state->mutex, FuriWaitForever);
+            if(direction < 0) {
+                game_state->autoplay = false;
+            } else {
+                make_move(game_state, direction);
+            }
+            furi_mutex_release(game_state->mutex);
+            view_port_update(view_port);
+        }
         if(event_status == FuriStatusOk) {
             // handle only press event, ignore repeat/release events
             if(input.type != InputTypePress) continue;
 
+            bool hint_requested = false;
             furi_mutex_acquire(game_state->mutex, FuriWaitForever);
 
+            if(game_state->autoplay) {
+                // any key takes the game back
+                game_state->autoplay = false;
+                furi_mutex_release(game_state->mutex);
+                view_port_update(view_port);
+                continue;
+            }
+
             switch(game_state->state) {
             case GameStateMenu:
 
@@ -424,10 +415,14 @@ int32_t game_2048_app() {
                     }
                     break;
                 case InputKeyOk:
-                    if(game_state->selected_menu_item == 1) {
+                    if(game_state->selected_menu_item == MenuItemNewGame) {
                         // new game
                         init_game(game_state, false);
                         save_game(game_state);
+                    } else if(game_state->selected_menu_item == MenuItemHint) {
+                        hint_requested = true;
+                    } else if(game_state->selected_menu_item == MenuItemAutoplay) {
+                        game_state->autoplay = true;
                     }
                     game_state->state = GameStateInProgress;
                     break;
@@ -440,21 +435,18 @@ int32_t game_2048_app() {
 
                 break;
             case GameStateInProgress:
-                move_result->is_table_updated = false;
-                move_result->points = 0;
-
                 switch(input.key) {
                 case InputKeyLeft:
-                    move_left(game_state->table, move_result);
+                    make_move(game_state, DirectionLeft);
                     break;
                 case InputKeyRight:
-                    move_right(game_state->table, move_result);
+                    make_move(game_state, DirectionRight);
                     break;
                 case InputKeyUp:
-                    move_up(game_state->table, move_result);
+                    make_move(game_state, DirectionUp);
                     break;
                 case InputKeyDown:
-                    move_down(game_state->table, move_result);
+                    make_move(game_state, DirectionDown);
                     break;
                 case InputKeyOk:
                     game_state->state = GameStateMenu;
@@ -464,22 +456,9 @@ int32_t game_2048_app() {
                     save_game(game_state);
                     is_finished = true;
                     break;
-                case InputKeyMAX:
+                default:
                     break;
                 }
-                game_state->score += move_result->points;
-
-                if(move_result->is_table_updated) {
-                    game_state->moves++;
-                    add_new_digit(game_state);
-                }
-
-                if(is_game_over(game_state)) {
-                    game_state->state = GameStateGameOver;
-                    if(game_state->score >= game_state->top_score) {
-                        game_state->top_score = game_state->score;
-                    }
-                }
 
                 break;
             case GameStateGameOver:
@@ -491,6 +470,15 @@ int32_t game_2048_app() {
 
             furi_mutex_release(game_state->mutex);
             view_port_update(view_port);
+
+            if(hint_requested) {
+                int8_t hint = expectimax_best_move(game_state->board, HINT_TIME_MS);
+
+                furi_mutex_acquire(game_state->mutex, FuriWaitForever);
+                game_state->hint = hint;
+                furi_mutex_release(game_state->mutex);
+                view_port_update(view_port);
+            }
         }
     }
 
@@ -504,7 +492,6 @@ int32_t game_2048_app() {
     furi_mutex_free(game_state->mutex);
 
     free(game_state);
-    free(move_result);
 
     return 0;
 }
@@ -6,12 +6,32 @@
 #include <notification/notification_messages.h>
 #include <dolphin/dolphin.h>
 
+#define ROWS 6
+#define COLS 7
+#define CELLS (ROWS * COLS)
+
+// time the computer may spend on a move
+#define COMPUTER_TIME_MS 1000
+// how many nodes are searched between checks of the time budget
+#define SEARCH_CHECK_MASK 0x3FF
+#define SCORE_WIN 1000
+#define SCORE_INFINITY 10000
+
 static int matrix[6][7] = {0};
 static int cursorx = 3;
 static int cursory = 5;
 static int player = 1;
 static int scoreX = 0;
 static int scoreO = 0;
+// discs dropped so far, the board is full at CELLS
+static int moves = 0;
+// -1 while playing, 0 - draw, 1 or 2 - the winner
+static int result = -1;
+// the computer plays O
+static bool vs_computer = false;
+
+// Columns tried centre first, the centre takes part in the most lines
+static const int column_order[COLS] = {3, 2, 4, 1, 5, 0, 6};
 
 typedef struct {
     FuriMutex* mutex;
@@ -26,6 +46,8 @@ void init() {
     cursorx = 3;
     cursory = 5;
     player = 1;
+    moves = 0;
+    result = -1;
 }
 
 const NotificationSequence end = {
@@ -91,56 +113,202 @@ int next_height(int x) {
     return 5;
 }
 
-int wincheck() {
-    for(size_t y = 0; y <= 2; y++) {
-        for(size_t x = 0; x <= 6; x++) {
-            if(matrix[y][x] != 0 && matrix[y][x] == matrix[y + 1][x] &&
-               matrix[y][x] == matrix[y + 2][x] && matrix[y][x] == matrix[y + 3][x]) {
-                return matrix[y][x];
-            }
-        }
+// Counts the discs of the same player next to (y, x) in direction (dy, dx)
+static int count_direction(int y, int x, int dy, int dx) {
+    int count = 0;
+    for(int cy = y + dy, cx = x + dx;
+        cy >= 0 && cy < ROWS && cx >= 0 && cx < COLS && matrix[cy][cx] == matrix[y][x];
+        cy += dy, cx += dx) {
+        count++;
     }
+    return count;
+}
 
-    for(size_t y = 0; y <= 5; y++) {
-        for(size_t x = 0; x <= 3; x++) {
-            if(matrix[y][x] != 0 && matrix[y][x] == matrix[y][x + 1] &&
-               matrix[y][x] == matrix[y][x + 2] && matrix[y][x] == matrix[y][x + 3]) {
-                return matrix[y][x];
-            }
+// Only the lines through the last placed disc can have become four in a row
+static bool connects_four(int y, int x) {
+    static const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+    for(size_t i = 0; i < 4; i++) {
+        int dy = directions[i][0];
+        int dx = directions[i][1];
+        if(1 + count_direction(y, x, dy, dx) + count_direction(y, x, -dy, -dx) >= 4) {
+            return true;
         }
     }
+    return false;
+}
 
-    for(size_t y = 0; y <= 2; y++) {
-        for(size_t x = 0; x <= 3; x++) {
-            if(matrix[y][x] != 0 && matrix[y][x] == matrix[y + 1][x + 1] &&
-               matrix[y][x] == matrix[y + 2][x + 2] && matrix[y][x] == matrix[y + 3][x + 3]) {
-                return matrix[y][x];
-            }
-        }
+// Drops a disc of the current player into column x, returns false if the column is full
+bool drop(int x) {
+    int y = next_height(x);
+    if(y == -1) {
+        return false;
+    }
+    matrix[y][x] = player;
+    moves++;
+    if(connects_four(y, x)) {
+        result = player;
+    } else if(moves == CELLS) {
+        result = 0;
     }
+    player = 3 - player;
+    return true;
+}
 
-    for(size_t y = 3; y <= 5; y++) {
-        for(size_t x = 0; x <= 3; x++) {
-            if(matrix[y][x] != 0 && matrix[y][x] == matrix[y - 1][x + 1] &&
-               matrix[y][x] == matrix[y - 2][x + 2] && matrix[y][x] == matrix[y - 3][x + 3]) {
-                return matrix[y][x];
-            }
+int wincheck() {
+    return result;
+}
+
+/*
+ * Computer opponent: negamax with alpha-beta over bitboards. Every column takes ROWS + 1
+ * bits, bottom row first, the extra bit keeps lines from wrapping into the next column.
+ * `position` holds the discs of the player to move, `mask` holds all discs.
+ */
+
+#define BB_HEIGHT (ROWS + 1)
+#define BB_BOTTOM(x) (1ULL << ((x) * BB_HEIGHT))
+#define BB_TOP(x) (1ULL << ((x) * BB_HEIGHT + ROWS - 1))
+#define BB_COLUMN(x) (((1ULL << ROWS) - 1) << ((x) * BB_HEIGHT))
+#define BB_BOTTOM_ROW 0x0040810204081ULL
+#define BB_BOARD (BB_BOTTOM_ROW * ((1ULL << ROWS) - 1))
+
+typedef struct {
+    uint32_t start;
+    uint32_t budget;
+    uint32_t nodes;
+    bool aborted;
+} SearchContext;
+
+static bool bb_alignment(uint64_t position) {
+    static const uint8_t shifts[4] = {1, BB_HEIGHT - 1, BB_HEIGHT, BB_HEIGHT + 1};
+    for(size_t i = 0; i < 4; i++) {
+        uint64_t m = position & (position >> shifts[i]);
+        if(m & (m >> (2 * shifts[i]))) return true;
+    }
+    return false;
+}
+
+static bool bb_can_play(uint64_t mask, int x) {
+    return !(mask & BB_TOP(x));
+}
+
+static bool bb_is_winning_move(uint64_t position, uint64_t mask, int x) {
+    return bb_alignment(position | ((mask + BB_BOTTOM(x)) & BB_COLUMN(x)));
+}
+
+// Empty cells that would complete a line for `position`
+static uint64_t bb_threats(uint64_t position, uint64_t mask) {
+    // vertical
+    uint64_t r = (position << 1) & (position << 2) & (position << 3);
+    static const uint8_t shifts[3] = {BB_HEIGHT - 1, BB_HEIGHT, BB_HEIGHT + 1};
+    for(size_t i = 0; i < 3; i++) {
+        uint8_t s = shifts[i];
+        uint64_t p = (position << s) & (position << (2 * s));
+        r |= p & (position << (3 * s));
+        r |= p & (position >> s);
+        p = (position >> s) & (position >> (2 * s));
+        r |= p & (position << s);
+        r |= p & (position >> (3 * s));
+    }
+    return r & (BB_BOARD ^ mask);
+}
+
+static int bb_evaluate(uint64_t position, uint64_t mask) {
+    return __builtin_popcountll(bb_threats(position, mask)) -
+           __builtin_popcountll(bb_threats(position ^ mask, mask));
+}
+
+static int negamax(
+    SearchContext* ctx,
+    uint64_t position,
+    uint64_t mask,
+    int played,
+    int depth,
+    int alpha,
+    int beta) {
+    if((++ctx->nodes & SEARCH_CHECK_MASK) == 0 && furi_get_tick() - ctx->start >= ctx->budget) {
+        ctx->aborted = true;
+    }
+    if(ctx->aborted) return 0;
+    if(played == CELLS) return 0;
+
+    for(int x = 0; x < COLS; x++) {
+        if(bb_can_play(mask, x) && bb_is_winning_move(position, mask, x)) {
+            // sooner wins score higher
+            return SCORE_WIN + CELLS - played;
         }
     }
+    if(depth == 0) return bb_evaluate(position, mask);
+
+    for(int i = 0; i < COLS; i++) {
+        int x = column_order[i];
+        if(!bb_can_play(mask, x)) continue;
+        int score = -negamax(
+            ctx,
+            position ^ mask,
+            mask | (mask + BB_BOTTOM(x)),
+            played + 1,
+            depth - 1,
+            -beta,
+            -alpha);
+        if(ctx->aborted) return 0;
+        if(score >= beta) return score;
+        if(score > alpha) alpha = score;
+    }
+    return alpha;
+}
 
-    bool tf = true;
-    for(size_t y = 0; y < 6; y++) {
-        for(size_t x = 0; x < 7; x++) {
-            if(matrix[y][x] == 0) {
-                tf = false;
-            }
+// Picks the computer's column with iterative deepening, a depth that runs out of time is
+// thrown away and the previous depth's choice is kept
+static int computer_column() {
+    uint64_t position = 0;
+    uint64_t mask = 0;
+    for(int y = 0; y < ROWS; y++) {
+        for(int x = 0; x < COLS; x++) {
+            uint64_t bit = 1ULL << (x * BB_HEIGHT + (ROWS - 1 - y));
+            if(matrix[y][x] != 0) mask |= bit;
+            if(matrix[y][x] == player) position |= bit;
         }
     }
-    if(tf) {
-        return 0;
+
+    int best = -1;
+    for(int i = 0; i < COLS; i++) {
+        int x = column_order[i];
+        if(!bb_can_play(mask, x)) continue;
+        if(bb_is_winning_move(position, mask, x)) return x;
+        if(best == -1) best = x;
     }
 
-    return -1;
+    SearchContext ctx = {
+        .start = furi_get_tick(),
+        .budget = furi_ms_to_ticks(COMPUTER_TIME_MS),
+        .nodes = 0,
+        .aborted = false,
+    };
+    for(int depth = 1; depth <= CELLS - moves && !ctx.aborted; depth++) {
+        int depth_best = best;
+        int alpha = -SCORE_INFINITY;
+        for(int i = 0; i < COLS && !ctx.aborted; i++) {
+            int x = column_order[i];
+            if(!bb_can_play(mask, x)) continue;
+            int score = -negamax(
+                &ctx,
+                position ^ mask,
+                mask | (mask + BB_BOTTOM(x)),
+                moves + 1,
+                depth - 1,
+                -SCORE_INFINITY,
+                -alpha);
+            if(!ctx.aborted && score > alpha) {
+                alpha = score;
+                depth_best = x;
+            }
+        }
+        if(ctx.aborted) break;
+        best = depth_best;
+        // the outcome is decided, searching deeper won't change the choice
+        if(alpha >= SCORE_WIN || alpha <= -SCORE_WIN) break;
+    }
+    return best;
 }
 
 static void draw_callback(Canvas* canvas, void* ctx) {
@@ -195,9 +363,9 @@ static void draw_callback(Canvas* canvas, void* ctx) {
     if(player == 2) {
         canvas_draw_str(canvas, 80, 10, "Turn: O");
     }
-    char scX[1];
+    char scX[12];
     intToStr(scoreX, scX);
-    char scO[1];
+    char scO[12];
     intToStr(scoreO, scO);
 
     canvas_draw_str(canvas, 80, 20, "X:");
@@ -206,6 +374,8 @@ static void draw_callback(Canvas* canvas, void* ctx) {
     canvas_draw_str(canvas, 80, 30, "O:");
     canvas_draw_str(canvas, 90, 30, scO);
 
+    canvas_draw_str(canvas, 80, 50, vs_computer ? "vs CPU" : "2 players");
+
     furi_mutex_release(fourinrow_state->mutex);
 }
 
@@ -277,15 +447,11 @@ int32_t four_in_row_app(void* p) {
             }
 
             if(event.type == InputTypePress) {
-                if(event.key == InputKeyOk) {
-                    int nh = next_height(cursorx);
-                    if(nh != -1) {
-                        matrix[nh][cursorx] = player;
-                        player = 3 - player;
-                    }
+                if(event.key == InputKeyOk && !(vs_computer && player == 2)) {
+                    drop(cursorx);
                 }
                 if(event.key == InputKeyUp) {
-                    //cursory--;
+                    vs_computer = !vs_computer;
                 }
                 if(event.key == InputKeyDown) {
                     //cursory++;
@@ -305,6 +471,15 @@ int32_t four_in_row_app(void* p) {
             furi_mutex_release(fourinrow_state->mutex);
         }
         view_port_update(view_port);
+
+        if(vs_computer && player == 2 && wincheck() == -1) {
+            // only this thread changes the board, so it can be searched without the mutex
+            int x = computer_column();
+            furi_mutex_acquire(fourinrow_state->mutex, FuriWaitForever);
+            drop(x);
+            furi_mutex_release(fourinrow_state->mutex);
+            view_port_update(view_port);
+        }
     }
 
     // Чистим созданные объекты, связанные с интерфейсом
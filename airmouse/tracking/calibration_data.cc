@@ -9,39 +9,142 @@
 #include <algorithm>
 
 // Student's distribution T value for 95% (two-sided) confidence interval.
-static const double Tn = 1.960;
+static const float Tn = 1.960f;
 
 // Number of samples (degrees of freedom) for the corresponding T values.
 static const int Nn = 200;
 
+// Readings are checked for outliers once the variance estimate has settled.
+static const int OUTLIER_MIN_SAMPLES = 20;
+static const float OUTLIER_SIGMAS = 5.0f;
+// Lower bound of the rejection window, a very quiet sensor would reject everything otherwise.
+static const float OUTLIER_MIN_WINDOW = 0.005f;
+
+// Desired marker position increments for the 0.5 quantile.
+static const float P2_INCREMENT[5] = {0.0f, 0.25f, 0.5f, 0.75f, 1.0f};
+
+void P2Median::add(float x)
+{
+    if (count < 5) {
+        height[count++] = x;
+        if (count == 5) {
+            std::sort(height, height + 5);
+            for (int i = 0; i < 5; i++) {
+                position[i] = i;
+                desired[i] = 4 * P2_INCREMENT[i];
+            }
+        }
+        return;
+    }
+
+    // Find the cell the sample falls into, extending the extremes if needed.
+    int k;
+    if (x < height[0]) {
+        height[0] = x;
+        k = 0;
+    } else if (x >= height[4]) {
+        height[4] = x;
+        k = 3;
+    } else {
+        k = 0;
+        while (x >= height[k + 1]) {
+            k++;
+        }
+    }
+
+    for (int i = k + 1; i < 5; i++) {
+        position[i]++;
+    }
+    for (int i = 0; i < 5; i++) {
+        desired[i] += P2_INCREMENT[i];
+    }
+    count++;
+
+    // Move the middle markers towards their desired positions.
+    for (int i = 1; i < 4; i++) {
+        const float d = desired[i] - position[i];
+        if ((d >= 1 && position[i + 1] - position[i] > 1)
+            || (d <= -1 && position[i - 1] - position[i] < -1)) {
+            const int s = d > 0 ? 1 : -1;
+            const float next = (height[i + 1] - height[i]) / (position[i + 1] - position[i]);
+            const float prev = (height[i] - height[i - 1]) / (position[i] - position[i - 1]);
+            const float parabolic = height[i]
+                + (float)s / (position[i + 1] - position[i - 1])
+                    * ((position[i] - position[i - 1] + s) * next
+                        + (position[i + 1] - position[i] - s) * prev);
+            if (height[i - 1] < parabolic && parabolic < height[i + 1]) {
+                height[i] = parabolic;
+            } else {
+                height[i] += s * (height[i + s] - height[i]) / (position[i + s] - position[i]);
+            }
+            position[i] += s;
+        }
+    }
+}
+
+float P2Median::get() const
+{
+    if (count >= 5) {
+        return height[2];
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    float sorted[5];
+    std::copy(height, height + count, sorted);
+    std::sort(sorted, sorted + count);
+    int middle = count / 2;
+    return (count % 2 == 1) ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2;
+}
+
 void CalibrationData::reset()
 {
     complete = false;
     count = 0;
-    sum = Vector::Zero();
-    sumSq = Vector::Zero();
     mean = Vector::Zero();
+    m2 = Vector::Zero();
     median = Vector::Zero();
     sigma = Vector::Zero();
     delta = Vector::Zero();
-    xData.clear();
-    yData.clear();
-    zData.clear();
+    for (int i = 0; i < 3; i++) {
+        medianEstimator[i].reset();
+    }
 }
 
-bool CalibrationData::add(Vector& data)
+bool CalibrationData::isOutlier(const Vector& data)
+{
+    if (count < OUTLIER_MIN_SAMPLES) {
+        return false;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        const float window
+            = std::max(OUTLIER_MIN_WINDOW, OUTLIER_SIGMAS * std::sqrt(m2[i] / count));
+        if (std::fabs(data[i] - mean[i]) > window) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CalibrationData::add(const Vector& data)
 {
     if (complete) {
         return true;
     }
 
-    xData.push_back(data[0]);
-    yData.push_back(data[1]);
-    zData.push_back(data[2]);
+    if (isOutlier(data)) {
+        return false;
+    }
 
-    sum += data;
-    sumSq += data * data;
     count++;
+    const Vector d = data - mean;
+    mean += d / count;
+    m2 += d * (data - mean);
+    for (int i = 0; i < 3; i++) {
+        medianEstimator[i].add(data[i]);
+    }
 
     if (count >= Nn) {
         calcDelta();
@@ -51,35 +154,28 @@ bool CalibrationData::add(Vector& data)
     return complete;
 }
 
-static inline double medianOf(std::vector<double>& list)
-{
-    std::sort(list.begin(), list.end());
-    int count = list.size();
-    int middle = count / 2;
-    return (count % 2 == 1) ? list[middle] : (list[middle - 1] + list[middle]) / 2.0l;
-}
-
 void CalibrationData::calcDelta()
 {
-    median.Set(medianOf(xData), medianOf(yData), medianOf(zData));
+    median.Set(medianEstimator[0].get(), medianEstimator[1].get(), medianEstimator[2].get());
 
-    mean = sum / count;
-    Vector m2 = mean * mean;
-    Vector d = sumSq / count - m2;
-    Vector s2 = (d * count) / (count - 1);
+    Vector d = m2 / count;
+    Vector s2 = m2 / (count - 1);
     sigma = Vector(std::sqrt(d[0]), std::sqrt(d[1]), std::sqrt(d[2]));
     Vector s = Vector(std::sqrt(s2[0]), std::sqrt(s2[1]), std::sqrt(s2[2]));
-    delta = s * Tn / std::sqrt((double)count);
+    delta = s * Tn / std::sqrt((float)count);
     Vector low = mean - delta;
     Vector high = mean + delta;
 
-    FURI_LOG_I(TAG,
+    FURI_LOG_D(TAG,
         "M[x] = { %f ... %f }  //  median = %f  //  avg = %f  //  delta = %f  //  sigma = %f",
-        low[0], high[0], median[0], mean[0], delta[0], sigma[0]);
-    FURI_LOG_I(TAG,
+        (double)low[0], (double)high[0], (double)median[0], (double)mean[0], (double)delta[0],
+        (double)sigma[0]);
+    FURI_LOG_D(TAG,
         "M[y] = { %f ... %f }  //  median = %f  //  avg = %f  //  delta = %f  //  sigma = %f",
-        low[1], high[1], median[1], mean[1], delta[1], sigma[1]);
-    FURI_LOG_I(TAG,
+        (double)low[1], (double)high[1], (double)median[1], (double)mean[1], (double)delta[1],
+        (double)sigma[1]);
+    FURI_LOG_D(TAG,
         "M[z] = { %f ... %f }  //  median = %f  //  avg = %f  //  delta = %f  //  sigma = %f",
-        low[2], high[2], median[2], mean[2], delta[2], sigma[2]);
-}
\ No newline at end of file
+        (double)low[2], (double)high[2], (double)median[2], (double)mean[2], (double)delta[2],
+        (double)sigma[2]);
+}
@@ -2,7 +2,6 @@
 
 #include <toolbox/saved_struct.h>
 #include <storage/storage.h>
-#include <vector>
 
 #include "util/vector.h"
 
@@ -35,6 +34,38 @@ typedef struct {
 
 typedef cardboard::Vector3 Vector;
 
+/**
+ * Streaming median estimator (P-square algorithm by Jain and Chlamtac). Keeps five markers instead
+ * of the samples, so the memory use and the cost per sample do not depend on the sample count.
+ */
+class P2Median {
+public:
+    /** Forget all the samples. */
+    void reset() {
+        count = 0;
+    }
+
+    /**
+     * Add a new sample to the estimate.
+     *
+     * @param x sample value.
+     */
+    void add(float x);
+
+    /**
+     * Retrieve the current median estimate.
+     *
+     * @return Median of the samples added so far, or 0 if there are none.
+     */
+    float get() const;
+
+private:
+    int count;
+    float height[5];
+    int position[5];
+    float desired[5];
+};
+
 /**
  * Helper class to gather some stats and store the calibration data. Right now it calculates a lot
  * more stats than actually needed. Some of them are used for logging the sensors quality (and
@@ -93,25 +124,29 @@ public:
     /**
      * Add a new gyroscope reading to the stats.
      *
+     * Readings further than a few standard deviations from the running mean are rejected, so a
+     * short bump does not skew the result.
+     *
      * @param data gyroscope values vector.
      * @return {@code true} if we now have enough data for calibration, or {@code false} otherwise.
      */
-    bool add(Vector& data);
+    bool add(const Vector& data);
 
 private:
     // Calculates the confidence interval (mean +- delta) and some other related values, like
     // standard deviation, etc. See https://en.wikipedia.org/wiki/Student%27s_t-distribution
     void calcDelta();
 
+    // Checks the reading against the running mean and variance.
+    bool isOutlier(const Vector& data);
+
     int count;
     bool complete;
-    Vector sum;
-    Vector sumSq;
+    // Running mean and sum of squared differences (Welford's algorithm).
     Vector mean;
+    Vector m2;
     Vector median;
     Vector sigma;
     Vector delta;
-    std::vector<double> xData;
-    std::vector<double> yData;
-    std::vector<double> zData;
+    P2Median medianEstimator[3];
 };
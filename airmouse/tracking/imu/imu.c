@@ -2,11 +2,12 @@
 #include <furi_hal.h>
 
 bool bmi160_begin();
-int bmi160_read(double* vec);
+int bmi160_read(float* vec);
+int bmi160_read_fifo(float* vec, int max);
 
 bool lsm6ds3trc_begin();
 void lsm6ds3trc_end();
-int lsm6ds3trc_read(double* vec);
+int lsm6ds3trc_read(float* vec);
 
 bool imu_begin() {
     furi_hal_i2c_acquire(&furi_hal_i2c_handle_external);
@@ -21,9 +22,16 @@ void imu_end() {
     // furi_hal_i2c_release(&furi_hal_i2c_handle_external);
 }
 
-int imu_read(double* vec) {
+int imu_read(float* vec) {
     furi_hal_i2c_acquire(&furi_hal_i2c_handle_external);
     int ret = bmi160_read(vec); // lsm6ds3trc_read(vec);
     furi_hal_i2c_release(&furi_hal_i2c_handle_external);
     return ret;
 }
+
+int imu_read_fifo(float* vec, int max) {
+    furi_hal_i2c_acquire(&furi_hal_i2c_handle_external);
+    int ret = bmi160_read_fifo(vec, max);
+    furi_hal_i2c_release(&furi_hal_i2c_handle_external);
+    return ret;
+}
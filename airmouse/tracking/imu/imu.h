@@ -9,9 +9,17 @@ extern "C" {
 #define ACC_DATA_READY (1 << 0)
 #define GYR_DATA_READY (1 << 1)
 
+// Output data rate of the samples queued in the sensor FIFO
+#define IMU_SAMPLE_RATE_HZ 200
+// Max number of samples returned by a single imu_read_fifo() call
+#define IMU_FIFO_DEPTH 16
+
 bool imu_begin();
 void imu_end();
-int imu_read(double* vec);
+int imu_read(float* vec);
+// Drains up to max queued samples (6 floats each: acc xyz, gyr xyz) in one burst.
+// Returns the number of samples stored in vec.
+int imu_read_fifo(float* vec, int max);
 
 #ifdef __cplusplus
 }
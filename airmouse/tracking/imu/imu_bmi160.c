@@ -8,13 +8,22 @@
 
 #define BMI160_DEV_ADDR (0x69 << 1)
 
-static const double DEG_TO_RAD = 0.017453292519943295769236907684886;
-static const double G = 9.81;
+// Header-less FIFO frame: gyro xyz followed by accel xyz
+#define BMI160_FIFO_FRAME_SIZE 12
+
+// 4G and 2000 DPS full scale to m/s^2 and rad/s
+static const float ACC_SCALE = 4.0f / 32768 * 9.81f;
+static const float GYR_SCALE = 2000.0f / 32768 * 0.017453292519943295769236907684886f;
 
 struct bmi160_dev bmi160dev;
 struct bmi160_sensor_data bmi160_accel;
 struct bmi160_sensor_data bmi160_gyro;
 
+static struct bmi160_fifo_frame bmi160_fifo;
+static uint8_t bmi160_fifo_data[IMU_FIFO_DEPTH * BMI160_FIFO_FRAME_SIZE];
+static struct bmi160_sensor_data bmi160_fifo_accel[IMU_FIFO_DEPTH];
+static struct bmi160_sensor_data bmi160_fifo_gyro[IMU_FIFO_DEPTH];
+
 int8_t bmi160_write_i2c(uint8_t dev_addr, uint8_t reg_addr, uint8_t* data, uint16_t len) {
     if(furi_hal_i2c_write_mem(&furi_hal_i2c_handle_external, dev_addr, reg_addr, data, len, 50))
         return BMI160_OK;
@@ -49,11 +58,11 @@ bool bmi160_begin() {
         return false;
     }
 
-    bmi160dev.accel_cfg.odr = BMI160_ACCEL_ODR_400HZ;
+    bmi160dev.accel_cfg.odr = BMI160_ACCEL_ODR_200HZ;
     bmi160dev.accel_cfg.range = BMI160_ACCEL_RANGE_4G;
     bmi160dev.accel_cfg.bw = BMI160_ACCEL_BW_NORMAL_AVG4;
     bmi160dev.accel_cfg.power = BMI160_ACCEL_NORMAL_MODE;
-    bmi160dev.gyro_cfg.odr = BMI160_GYRO_ODR_400HZ;
+    bmi160dev.gyro_cfg.odr = BMI160_GYRO_ODR_200HZ;
     bmi160dev.gyro_cfg.range = BMI160_GYRO_RANGE_2000_DPS;
     bmi160dev.gyro_cfg.bw = BMI160_GYRO_BW_NORMAL_MODE;
     bmi160dev.gyro_cfg.power = BMI160_GYRO_NORMAL_MODE;
@@ -64,25 +73,64 @@ bool bmi160_begin() {
         return false;
     }
 
+    // Queue every sample so a late tick can still feed them all to the filter
+    bmi160_fifo.data = bmi160_fifo_data;
+    bmi160dev.fifo = &bmi160_fifo;
+    if(bmi160_set_fifo_config(BMI160_FIFO_HEADER, BMI160_DISABLE, &bmi160dev) != BMI160_OK ||
+       bmi160_set_fifo_config(BMI160_FIFO_GYRO | BMI160_FIFO_ACCEL, BMI160_ENABLE, &bmi160dev) !=
+           BMI160_OK ||
+       bmi160_set_fifo_flush(&bmi160dev) != BMI160_OK) {
+        FURI_LOG_E(TAG, "FIFO setup failure!");
+        return false;
+    }
+
     FURI_LOG_I(TAG, "Initialization success!");
     FURI_LOG_I(TAG, "Chip ID 0x%X", bmi160dev.chip_id);
 
     return true;
 }
 
-int bmi160_read(double* vec) {
+int bmi160_read(float* vec) {
     if(bmi160_get_sensor_data(
            (BMI160_ACCEL_SEL | BMI160_GYRO_SEL), &bmi160_accel, &bmi160_gyro, &bmi160dev) !=
        BMI160_OK) {
         return 0;
     }
 
-    vec[0] = ((double)bmi160_accel.x * 4 / 32768) * G;
-    vec[1] = ((double)bmi160_accel.y * 4 / 32768) * G;
-    vec[2] = ((double)bmi160_accel.z * 4 / 32768) * G;
-    vec[3] = ((double)bmi160_gyro.x * 2000 / 32768) * DEG_TO_RAD;
-    vec[4] = ((double)bmi160_gyro.y * 2000 / 32768) * DEG_TO_RAD;
-    vec[5] = ((double)bmi160_gyro.z * 2000 / 32768) * DEG_TO_RAD;
+    vec[0] = bmi160_accel.x * ACC_SCALE;
+    vec[1] = bmi160_accel.y * ACC_SCALE;
+    vec[2] = bmi160_accel.z * ACC_SCALE;
+    vec[3] = bmi160_gyro.x * GYR_SCALE;
+    vec[4] = bmi160_gyro.y * GYR_SCALE;
+    vec[5] = bmi160_gyro.z * GYR_SCALE;
 
     return ACC_DATA_READY | GYR_DATA_READY;
 }
+
+int bmi160_read_fifo(float* vec, int max) {
+    if(max > IMU_FIFO_DEPTH) max = IMU_FIFO_DEPTH;
+
+    // Fill level and frames are fetched back to back, older frames stay queued
+    bmi160_fifo.length = max * BMI160_FIFO_FRAME_SIZE;
+    if(bmi160_get_fifo_data(&bmi160dev) != BMI160_OK) {
+        return 0;
+    }
+
+    uint8_t acc_count = max;
+    uint8_t gyr_count = max;
+    bmi160_extract_accel(bmi160_fifo_accel, &acc_count, &bmi160dev);
+    bmi160_extract_gyro(bmi160_fifo_gyro, &gyr_count, &bmi160dev);
+
+    int count = MIN(acc_count, gyr_count);
+    for(int i = 0; i < count; i++) {
+        float* s = &vec[i * 6];
+        s[0] = bmi160_fifo_accel[i].x * ACC_SCALE;
+        s[1] = bmi160_fifo_accel[i].y * ACC_SCALE;
+        s[2] = bmi160_fifo_accel[i].z * ACC_SCALE;
+        s[3] = bmi160_fifo_gyro[i].x * GYR_SCALE;
+        s[4] = bmi160_fifo_gyro[i].y * GYR_SCALE;
+        s[5] = bmi160_fifo_gyro[i].z * GYR_SCALE;
+    }
+
+    return count;
+}
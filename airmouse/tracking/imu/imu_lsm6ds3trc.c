@@ -8,7 +8,7 @@
 
 #define LSM6DS3_ADDRESS (0x6A << 1)
 
-static const double DEG_TO_RAD = 0.017453292519943295769236907684886;
+static const float DEG_TO_RAD = 0.017453292519943295769236907684886f;
 
 stmdev_ctx_t lsm6ds3trc_ctx;
 
@@ -68,7 +68,7 @@ void lsm6ds3trc_end() {
     lsm6ds3tr_c_gy_data_rate_set(&lsm6ds3trc_ctx, LSM6DS3TR_C_GY_ODR_OFF);
 }
 
-int lsm6ds3trc_read(double* vec) {
+int lsm6ds3trc_read(float* vec) {
     int ret = 0;
     int16_t data[3];
     lsm6ds3tr_c_reg_t reg;
@@ -76,17 +76,17 @@ int lsm6ds3trc_read(double* vec) {
 
     if(reg.status_reg.xlda) {
         lsm6ds3tr_c_acceleration_raw_get(&lsm6ds3trc_ctx, data);
-        vec[2] = (double)lsm6ds3tr_c_from_fs2g_to_mg(data[0]) / 1000;
-        vec[0] = (double)lsm6ds3tr_c_from_fs2g_to_mg(data[1]) / 1000;
-        vec[1] = (double)lsm6ds3tr_c_from_fs2g_to_mg(data[2]) / 1000;
+        vec[2] = lsm6ds3tr_c_from_fs2g_to_mg(data[0]) / 1000;
+        vec[0] = lsm6ds3tr_c_from_fs2g_to_mg(data[1]) / 1000;
+        vec[1] = lsm6ds3tr_c_from_fs2g_to_mg(data[2]) / 1000;
         ret |= ACC_DATA_READY;
     }
 
     if(reg.status_reg.gda) {
         lsm6ds3tr_c_angular_rate_raw_get(&lsm6ds3trc_ctx, data);
-        vec[5] = (double)lsm6ds3tr_c_from_fs2000dps_to_mdps(data[0]) * DEG_TO_RAD / 1000;
-        vec[3] = (double)lsm6ds3tr_c_from_fs2000dps_to_mdps(data[1]) * DEG_TO_RAD / 1000;
-        vec[4] = (double)lsm6ds3tr_c_from_fs2000dps_to_mdps(data[2]) * DEG_TO_RAD / 1000;
+        vec[5] = lsm6ds3tr_c_from_fs2000dps_to_mdps(data[0]) * DEG_TO_RAD / 1000;
+        vec[3] = lsm6ds3tr_c_from_fs2000dps_to_mdps(data[1]) * DEG_TO_RAD / 1000;
+        vec[4] = lsm6ds3tr_c_from_fs2000dps_to_mdps(data[2]) * DEG_TO_RAD / 1000;
         ret |= GYR_DATA_READY;
     }
 
@@ -3,14 +3,23 @@
 #include <furi.h>
 #include <furi_hal.h>
 
+#include <algorithm>
+#include <cmath>
+
 #include "imu/imu.h"
 #include "orientation_tracker.h"
 #include "calibration_data.h"
 
 #define TAG "tracker"
 
-static const float CURSOR_SPEED = 1024.0 / (M_PI / 4);
-static const float STABILIZE_BIAS = 16.0;
+static const float PI_F = (float)M_PI;
+static const float CURSOR_SPEED = 1024.0f / (PI_F / 4);
+static const float RAD_PER_STEP = 1 / CURSOR_SPEED;
+static const float STABILIZE_BIAS = 16.0f;
+static const float STABILIZE_SCALE = CURSOR_SPEED / STABILIZE_BIAS;
+static const uint64_t SAMPLE_PERIOD_NS = 1000000000llu / IMU_SAMPLE_RATE_HZ;
+// Max corrected gyro rate (rad/s) on every axis for the mouse to count as idle.
+static const float IDLE_RATE = 0.05f;
 
 class TrackingState {
 private:
@@ -21,16 +30,19 @@ private:
     bool firstRead;
     bool stabilize;
     CalibrationData calibration;
+    // Refreshed in the background while the mouse is kept still.
+    CalibrationData idleCalibration;
+    cardboard::Vector3 bias;
     cardboard::OrientationTracker tracker;
-    uint64_t ippus, ippus2;
+    uint64_t timestamp;
 
 private:
     float clamp(float val) {
-        while (val <= -M_PI) {
-            val += 2 * M_PI;
+        while (val <= -PI_F) {
+            val += 2 * PI_F;
         }
-        while (val >= M_PI) {
-            val -= 2 * M_PI;
+        while (val >= PI_F) {
+            val -= 2 * PI_F;
         }
         return val;
     }
@@ -40,7 +52,8 @@ private:
             return newVal;
         }
         float delta = clamp(oldVal - newVal);
-        float alpha = (float) std::max(0.0, 1 - std::pow(std::fabs(delta) * CURSOR_SPEED / STABILIZE_BIAS, 3.0));
+        float x = std::fabs(delta) * STABILIZE_SCALE;
+        float alpha = std::max(0.0f, 1 - x * x * x);
         return newVal + alpha * delta;
     }
 
@@ -50,33 +63,33 @@ private:
 
         // Scale the shift down to fit the protocol.
         if (dX > 127) {
-            dY *= 127.0 / dX;
+            dY *= 127.0f / dX;
             dX = 127;
         }
         if (dX < -127) {
-            dY *= -127.0 / dX;
+            dY *= -127.0f / dX;
             dX = -127;
         }
         if (dY > 127) {
-            dX *= 127.0 / dY;
+            dX *= 127.0f / dY;
             dY = 127;
         }
         if (dY < -127) {
-            dX *= -127.0 / dY;
+            dX *= -127.0f / dY;
             dY = -127;
         }
 
-        const int8_t x = (int8_t)std::floor(dX + 0.5);
-        const int8_t y = (int8_t)std::floor(dY + 0.5);
+        const int8_t x = (int8_t)std::floor(dX + 0.5f);
+        const int8_t y = (int8_t)std::floor(dY + 0.5f);
 
         mouse_move(x, y, context);
 
         // Only subtract the part of the error that was already sent.
         if (x != 0) {
-            dYaw -= x / CURSOR_SPEED;
+            dYaw -= x * RAD_PER_STEP;
         }
         if (y != 0) {
-            dPitch -= y / CURSOR_SPEED;
+            dPitch -= y * RAD_PER_STEP;
         }
     }
 
@@ -87,10 +100,11 @@ private:
         float q0 = quaternion[3]; // cos(T/2)
 
         float yaw = std::atan2(2 * (q0 * q3 - q1 * q2), (1 - 2 * (q1 * q1 + q3 * q3)));
-        float pitch = std::asin(2 * (q0 * q1 + q2 * q3));
+        // Rounding can push a unit quaternion just outside asin's domain
+        float pitch = std::asin(std::min(1.0f, std::max(-1.0f, 2 * (q0 * q1 + q2 * q3))));
         // float roll = std::atan2(2 * (q0 * q2 - q1 * q3), (1 - 2 * (q1 * q1 + q2 * q2)));
 
-        if (yaw == NAN || pitch == NAN) {
+        if (std::isnan(yaw) || std::isnan(pitch)) {
             // NaN case, skip it
             return;
         }
@@ -114,6 +128,21 @@ private:
         }
     }
 
+    void refreshCalibration(const cardboard::Vector3& gyro) {
+        const cardboard::Vector3 rate = gyro - bias;
+        if (std::fabs(rate[0]) > IDLE_RATE || std::fabs(rate[1]) > IDLE_RATE
+            || std::fabs(rate[2]) > IDLE_RATE) {
+            idleCalibration.reset();
+            return;
+        }
+
+        if (idleCalibration.add(gyro)) {
+            bias = idleCalibration.getMedian();
+            tracker.SetCalibration(bias);
+            idleCalibration.reset();
+        }
+    }
+
 public:
     TrackingState()
         : yaw(0)
@@ -122,9 +151,9 @@ public:
         , dPitch(0)
         , firstRead(true)
         , stabilize(true)
-        , tracker(10000000l) { // 10 ms / 100 Hz
-        ippus = furi_hal_cortex_instructions_per_microsecond();
-        ippus2 = ippus / 2;
+        , bias(cardboard::Vector3::Zero())
+        , tracker(SAMPLE_PERIOD_NS)
+        , timestamp(0) {
     }
 
     void beginCalibration() {
@@ -135,7 +164,7 @@ public:
         if (calibration.isComplete())
             return true;
 
-        double vec[6];
+        float vec[6];
         if (imu_read(vec) & GYR_DATA_READY) {
             cardboard::Vector3 data(vec[3], vec[4], vec[5]);
             furi_delay_ms(9); // Artificially limit to ~100Hz
@@ -163,34 +192,41 @@ public:
             median[2] = store.z;
         }
 
-        tracker.SetCalibration(median);
+        bias = median;
+        tracker.SetCalibration(bias);
     }
 
     void beginTracking() {
         loadCalibration();
+        idleCalibration.reset();
         tracker.Resume();
     }
 
     void stepTracking(MouseMoveCallback mouse_move, void *context) {
-        double vec[6];
-        int ret = imu_read(vec);
-        if (ret != 0) {
-            uint64_t t = (DWT->CYCCNT * 1000llu + ippus2) / ippus;
-            if (ret & ACC_DATA_READY) {
-                cardboard::AccelerometerData adata
-                    = { .system_timestamp = t, .sensor_timestamp_ns = t,
-                        .data = cardboard::Vector3(vec[0], vec[1], vec[2]) };
-                tracker.OnAccelerometerData(adata);
-            }
-            if (ret & GYR_DATA_READY) {
-                cardboard::GyroscopeData gdata
-                    = { .system_timestamp = t, .sensor_timestamp_ns = t,
-                        .data = cardboard::Vector3(vec[3], vec[4], vec[5]) };
-                cardboard::Vector4 pose = tracker.OnGyroscopeData(gdata);
-                onOrientation(pose);
-                sendCurrentState(mouse_move, context);
-            }
+        float vec[IMU_FIFO_DEPTH * 6];
+        int count = imu_read_fifo(vec, IMU_FIFO_DEPTH);
+        if (count == 0) {
+            return;
+        }
+
+        // FIFO samples are evenly spaced, so stamp them from the sample clock
+        // rather than from when this tick happened to run.
+        cardboard::Vector4 pose;
+        for (int i = 0; i < count; i++) {
+            const float* sample = &vec[i * 6];
+            timestamp += SAMPLE_PERIOD_NS;
+            cardboard::AccelerometerData adata
+                = { .system_timestamp = timestamp, .sensor_timestamp_ns = timestamp,
+                    .data = cardboard::Vector3(sample[0], sample[1], sample[2]) };
+            tracker.OnAccelerometerData(adata);
+            cardboard::GyroscopeData gdata
+                = { .system_timestamp = timestamp, .sensor_timestamp_ns = timestamp,
+                    .data = cardboard::Vector3(sample[3], sample[4], sample[5]) };
+            pose = tracker.OnGyroscopeData(gdata);
+            refreshCalibration(gdata.data);
         }
+        onOrientation(pose);
+        sendCurrentState(mouse_move, context);
     }
 
     void stopTracking() {
@@ -31,7 +31,7 @@ const float kGyroscopeLowPassCutOffFrequencyHz = 1.0f;
 const float kGyroscopeBiasLowPassCutOffFrequencyHz = 0.15f;
 
 // Note that MEMS IMU are not that precise.
-const double kEpsilon = 1.0e-8;
+const float kEpsilon = 1.0e-8f;
 
 // Size of the filtering window for the mean and median filter. The larger the
 // windows the larger the filter delay.
@@ -39,7 +39,7 @@ const int kFilterWindowSize = 5;
 
 // Threshold used to compare rotation computed from the accelerometer and the
 // gyroscope bias.
-const double kRatioBetweenGyroBiasAndAccel = 1.5;
+const float kRatioBetweenGyroBiasAndAccel = 1.5f;
 
 // The minimum sum of weights we need to acquire before returning a bias
 // estimation.
@@ -47,11 +47,11 @@ const float kMinSumOfWeightsGyroBiasThreshold = 25.0f;
 
 // Amount of change in m/s^3 we allow on the smoothed accelerometer values to
 // consider the phone static.
-const double kAccelerometerDeltaStaticThreshold = 0.5;
+const float kAccelerometerDeltaStaticThreshold = 0.5f;
 
 // Amount of change in radians/s^2 we allow on the smoothed gyroscope values to
 // consider the phone static.
-const double kGyroscopeDeltaStaticThreshold = 0.03;
+const float kGyroscopeDeltaStaticThreshold = 0.03f;
 
 // If the gyroscope value is above this threshold, don't update the gyroscope
 // bias estimation. This threshold is applied to the magnitude of gyroscope
@@ -63,7 +63,7 @@ const float kGyroscopeForBiasThreshold = 0.30f;
 const int kStaticFrameDetectionThreshold = 50;
 
 // Minimum time step between sensor updates.
-const double kMinTimestep = 1; // std::chrono::nanoseconds(1);
+const float kMinTimestep = 1; // std::chrono::nanoseconds(1);
 } // namespace
 
 namespace cardboard {
@@ -207,14 +207,14 @@ void GyroscopeBiasEstimator::ProcessAccelerometer(
 
     // Compute a mock gyroscope value from accelerometer.
     const int64_t diff = timestamp_ns - previous_accel_timestamp_ns;
-    const double timestep = static_cast<double>(diff);
+    const float timestep = static_cast<float>(diff);
 
     simulated_gyroscope_from_accelerometer_lowpass_filter_.AddSample(
         ComputeAngularVelocityFromLatestAccelerometer(timestep), timestamp_ns);
     last_mean_filtered_accelerometer_value_ = mean_filter_.GetFilteredData();
 }
 
-Vector3 GyroscopeBiasEstimator::ComputeAngularVelocityFromLatestAccelerometer(double timestep) const
+Vector3 GyroscopeBiasEstimator::ComputeAngularVelocityFromLatestAccelerometer(float timestep) const
 {
     if (timestep < kMinTimestep) {
         return { 0, 0, 0 };
@@ -224,9 +224,6 @@ Vector3 GyroscopeBiasEstimator::ComputeAngularVelocityFromLatestAccelerometer(do
 
     // Compute an incremental rotation between the last state and the current
     // state.
-    //
-    // Note that we switch to double precision here because of precision problem
-    // with small rotation.
     const auto incremental_rotation = Rotation::RotateInto(
         Vector3(last_mean_filtered_accelerometer_value_[0],
             last_mean_filtered_accelerometer_value_[1], last_mean_filtered_accelerometer_value_[2]),
@@ -234,7 +231,7 @@ Vector3 GyroscopeBiasEstimator::ComputeAngularVelocityFromLatestAccelerometer(do
 
     // We use axis angle here because this is how gyroscope values are stored.
     Vector3 incremental_rotation_axis;
-    double incremental_rotation_angle;
+    float incremental_rotation_angle;
     incremental_rotation.GetAxisAndAngle(&incremental_rotation_axis, &incremental_rotation_angle);
 
     incremental_rotation_axis *= incremental_rotation_angle / timestep;
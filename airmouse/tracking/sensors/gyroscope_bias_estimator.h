@@ -107,7 +107,7 @@ private:
     // @param timestep in seconds between the last two samples.
     // @return rotation velocity from latest accelerometer. This can be
     // interpreted as an gyroscope.
-    Vector3 ComputeAngularVelocityFromLatestAccelerometer(double timestep) const;
+    Vector3 ComputeAngularVelocityFromLatestAccelerometer(float timestep) const;
 
     LowpassFilter accelerometer_lowpass_filter_;
     LowpassFilter simulated_gyroscope_from_accelerometer_lowpass_filter_;
@@ -19,20 +19,20 @@
 
 namespace {
 
-const double kSecondsFromNanoseconds = 1.0e-9;
+const float kSecondsFromNanoseconds = 1.0e-9f;
 
 // Minimum time step between sensor updates. This corresponds to 1000 Hz.
-const double kMinTimestepS = 0.001f;
+const float kMinTimestepS = 0.001f;
 
 // Maximum time step between sensor updates. This corresponds to 1 Hz.
-const double kMaxTimestepS = 1.00f;
+const float kMaxTimestepS = 1.00f;
 
 } // namespace
 
 namespace cardboard {
 
-LowpassFilter::LowpassFilter(double cutoff_freq_hz)
-    : cutoff_time_constant_(1 / (2 * (double)M_PI * cutoff_freq_hz))
+LowpassFilter::LowpassFilter(float cutoff_freq_hz)
+    : cutoff_time_constant_(1 / (2 * (float)M_PI * cutoff_freq_hz))
     , initialized_(false)
 {
     Reset();
@@ -40,10 +40,10 @@ LowpassFilter::LowpassFilter(double cutoff_freq_hz)
 
 void LowpassFilter::AddSample(const Vector3& sample, uint64_t timestamp_ns)
 {
-    AddWeightedSample(sample, timestamp_ns, 1.0);
+    AddWeightedSample(sample, timestamp_ns, 1.0f);
 }
 
-void LowpassFilter::AddWeightedSample(const Vector3& sample, uint64_t timestamp_ns, double weight)
+void LowpassFilter::AddWeightedSample(const Vector3& sample, uint64_t timestamp_ns, float weight)
 {
     if (!initialized_) {
         // Initialize filter state
@@ -58,16 +58,16 @@ void LowpassFilter::AddWeightedSample(const Vector3& sample, uint64_t timestamp_
         return;
     }
 
-    const double delta_s = static_cast<double>(timestamp_ns - timestamp_most_recent_update_ns_)
+    const float delta_s = static_cast<float>(timestamp_ns - timestamp_most_recent_update_ns_)
         * kSecondsFromNanoseconds;
     if (delta_s <= kMinTimestepS || delta_s > kMaxTimestepS) {
         timestamp_most_recent_update_ns_ = timestamp_ns;
         return;
     }
 
-    const double weighted_delta_secs = weight * delta_s;
+    const float weighted_delta_secs = weight * delta_s;
 
-    const double alpha = weighted_delta_secs / (cutoff_time_constant_ + weighted_delta_secs);
+    const float alpha = weighted_delta_secs / (cutoff_time_constant_ + weighted_delta_secs);
 
     for (int i = 0; i < 3; ++i) {
         filtered_data_[i] = (1 - alpha) * filtered_data_[i] + alpha * sample[i];
@@ -29,7 +29,7 @@ namespace cardboard {
 class LowpassFilter {
 public:
     // Initializes a filter with the given cutoff frequency in Hz.
-    explicit LowpassFilter(double cutoff_freq_hz);
+    explicit LowpassFilter(float cutoff_freq_hz);
 
     // Updates the filter with the given sample. Note that samples with
     // non-monotonic timestamps and successive samples with a time steps below 1
@@ -47,7 +47,7 @@ public:
     //     sample. A weight of 1 corresponds to calling AddSample. A weight of 0
     //     makes the update no-op. The first initial sample is not affected by
     //     this.
-    void AddWeightedSample(const Vector3& sample, uint64_t timestamp_ns, double weight);
+    void AddWeightedSample(const Vector3& sample, uint64_t timestamp_ns, float weight);
 
     // Returns the filtered value. A vector with zeros is returned if no samples
     // have been added.
@@ -69,7 +69,7 @@ public:
     void Reset();
 
 private:
-    const double cutoff_time_constant_;
+    const float cutoff_time_constant_;
     uint64_t timestamp_most_recent_update_ns_;
     bool initialized_;
 
@@ -40,7 +40,7 @@ Vector3 MeanFilter::GetFilteredData() const
         mean += sample;
     }
 
-    return mean / static_cast<double>(filter_size_);
+    return mean / static_cast<float>(filter_size_);
 }
 
 } // namespace cardboard
@@ -23,14 +23,14 @@
 namespace cardboard {
 
 namespace {
-    const double kEpsilon = 1.0e-15;
+    const float kEpsilon = 1.0e-15f;
 } // namespace
 
 namespace pose_prediction {
 
-    Rotation GetRotationFromGyroscope(const Vector3& gyroscope_value, double timestep_s)
+    Rotation GetRotationFromGyroscope(const Vector3& gyroscope_value, float timestep_s)
     {
-        const double velocity = Length(gyroscope_value);
+        const float velocity = Length(gyroscope_value);
 
         // When there is no rotation data return an identity rotation.
         if (velocity < kEpsilon) {
@@ -49,7 +49,7 @@ namespace pose_prediction {
     {
         // Subtracting unsigned numbers is bad when the result is negative.
         const int64_t diff = requested_pose_timestamp - current_state.timestamp;
-        const double timestep_s = diff * 1.0e-9;
+        const float timestep_s = diff * 1.0e-9f;
 
         const Rotation update = GetRotationFromGyroscope(
             current_state.sensor_from_start_rotation_velocity, timestep_s);
@@ -60,7 +60,7 @@ namespace pose_prediction {
     {
         // Subtracting unsigned numbers is bad when the result is negative.
         const int64_t diff = requested_pose_timestamp - current_state.timestamp;
-        const double timestep_s = diff * 1.0e-9;
+        const float timestep_s = diff * 1.0e-9f;
 
         const Rotation update = GetRotationFromGyroscope(
             current_state.sensor_from_start_rotation_velocity, timestep_s);
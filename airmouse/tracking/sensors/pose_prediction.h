@@ -32,7 +32,7 @@ namespace pose_prediction {
 // @param timestep_s integration period in seconds.
 // @return Integration of the gyroscope value the rotation is from Start to
 //         Sensor Space.
-Rotation GetRotationFromGyroscope(const Vector3& gyroscope_value, double timestep_s);
+Rotation GetRotationFromGyroscope(const Vector3& gyroscope_value, float timestep_s);
 
 // Gets a predicted pose for a given time in the future (e.g. rendering time)
 // based on a linear prediction model. This uses the system current state
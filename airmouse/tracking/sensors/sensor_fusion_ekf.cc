@@ -27,33 +27,35 @@ namespace cardboard {
 
 namespace {
 
-    const double kFiniteDifferencingEpsilon = 1.0e-7;
-    const double kEpsilon = 1.0e-15;
+    // Single precision leaves ~7 significant digits, so the step has to stay well
+    // above the rounding error of the innovation it is differencing.
+    const float kFiniteDifferencingEpsilon = 1.0e-3f;
+    const float kEpsilon = 1.0e-15f;
     // Default gyroscope frequency. This corresponds to 100 Hz.
-    const double kDefaultGyroscopeTimestep_s = 0.01f;
+    const float kDefaultGyroscopeTimestep_s = 0.01f;
     // Maximum time between gyroscope before we start limiting the integration.
-    const double kMaximumGyroscopeSampleDelay_s = 0.04f;
+    const float kMaximumGyroscopeSampleDelay_s = 0.04f;
     // Compute a first-order exponential moving average of changes in accel norm per
     // frame.
-    const double kSmoothingFactor = 0.5;
+    const float kSmoothingFactor = 0.5f;
     // Minimum and maximum values used for accelerometer noise covariance matrix.
     // The smaller the sigma value, the more weight is given to the accelerometer
     // signal.
-    const double kMinAccelNoiseSigma = 0.75;
-    const double kMaxAccelNoiseSigma = 7.0;
+    const float kMinAccelNoiseSigma = 0.75f;
+    const float kMaxAccelNoiseSigma = 7.0f;
     // Initial value for the diagonal elements of the different covariance matrices.
-    const double kInitialStateCovarianceValue = 25.0;
-    const double kInitialProcessCovarianceValue = 1.0;
+    const float kInitialStateCovarianceValue = 25.0f;
+    const float kInitialProcessCovarianceValue = 1.0f;
     // Maximum accelerometer norm change allowed before capping it covariance to a
     // large value.
-    const double kMaxAccelNormChange = 0.15;
+    const float kMaxAccelNormChange = 0.15f;
     // Timestep IIR filtering coefficient.
-    const double kTimestepFilterCoeff = 0.95;
+    const float kTimestepFilterCoeff = 0.95f;
     // Minimum number of sample for timestep filtering.
     const int kTimestepFilterMinSamples = 10;
 
     // Z direction in start space.
-    const Vector3 kCanonicalZDirection(0.0, 0.0, 1.0);
+    const Vector3 kCanonicalZDirection(0.0f, 0.0f, 1.0f);
 
     // Computes an axis-angle rotation from the input vector.
     // angle = norm(a)
@@ -61,7 +63,7 @@ namespace {
     // If norm(a) == 0, it returns an identity rotation.
     static inline void RotationFromVector(const Vector3& a, Rotation& r)
     {
-        const double norm_a = Length(a);
+        const float norm_a = Length(a);
         if (norm_a < kEpsilon) {
             r = Rotation::Identity();
             return;
@@ -103,7 +105,7 @@ void SensorFusionEkf::ResetState()
     control_input_ = Vector3::Zero();
     state_update_ = Vector3::Zero();
 
-    moving_average_accelerometer_norm_change_ = 0.0;
+    moving_average_accelerometer_norm_change_ = 0.0f;
 
     is_timestep_filter_initialized_ = false;
     is_gyroscope_filter_valid_ = false;
@@ -134,7 +136,7 @@ void SensorFusionEkf::ProcessGyroscopeSample(const GyroscopeData& sample)
 
     // Checks that we received at least one gyroscope sample in the past.
     if (current_gyroscope_sensor_timestamp_ns_ != 0) {
-        double current_timestep_s = std::chrono::duration_cast<std::chrono::duration<double>>(
+        float current_timestep_s = std::chrono::duration_cast<std::chrono::duration<float>>(
             std::chrono::nanoseconds(
                 sample.sensor_timestamp_ns - current_gyroscope_sensor_timestamp_ns_))
                                         .count();
@@ -189,7 +191,7 @@ Vector3 SensorFusionEkf::ComputeInnovation(const Rotation& pose)
     const Rotation rotation
         = Rotation::RotateInto(predicted_down_direction, accelerometer_measurement_);
     Vector3 axis;
-    double angle;
+    float angle;
     rotation.GetAxisAndAngle(&axis, &angle);
     return axis * angle;
 }
@@ -278,7 +280,7 @@ void SensorFusionEkf::UpdateStateCovariance(const Matrix3x3& motion_update)
     state_covariance_ = motion_update * state_covariance_ * Transpose(motion_update);
 }
 
-void SensorFusionEkf::FilterGyroscopeTimestep(double gyroscope_timestep_s)
+void SensorFusionEkf::FilterGyroscopeTimestep(float gyroscope_timestep_s)
 {
     if (!is_timestep_filter_initialized_) {
         // Initializes the filter.
@@ -300,9 +302,9 @@ void SensorFusionEkf::FilterGyroscopeTimestep(double gyroscope_timestep_s)
 
 void SensorFusionEkf::UpdateMeasurementCovariance()
 {
-    const double current_accelerometer_norm = Length(accelerometer_measurement_);
+    const float current_accelerometer_norm = Length(accelerometer_measurement_);
     // Norm change between current and previous accel readings.
-    const double current_accelerometer_norm_change
+    const float current_accelerometer_norm_change
         = std::abs(current_accelerometer_norm - previous_accelerometer_norm_);
     previous_accelerometer_norm_ = current_accelerometer_norm;
 
@@ -312,9 +314,9 @@ void SensorFusionEkf::UpdateMeasurementCovariance()
     // If we hit the accel norm change threshold, we use the maximum noise sigma
     // for the accel covariance. For anything below that, we use a linear
     // combination between min and max sigma values.
-    const double norm_change_ratio
+    const float norm_change_ratio
         = moving_average_accelerometer_norm_change_ / kMaxAccelNormChange;
-    const double accelerometer_noise_sigma = std::min(kMaxAccelNoiseSigma,
+    const float accelerometer_noise_sigma = std::min(kMaxAccelNoiseSigma,
         kMinAccelNoiseSigma + norm_change_ratio * (kMaxAccelNoiseSigma - kMinAccelNoiseSigma));
 
     // Updates the accel covariance matrix with the new sigma value.
@@ -88,7 +88,7 @@ public:
 
 private:
     // Estimates the average timestep between gyroscope event.
-    void FilterGyroscopeTimestep(double gyroscope_timestep);
+    void FilterGyroscopeTimestep(float gyroscope_timestep);
 
     // Updates the state covariance with an incremental motion. It changes the
     // space of the quadric.
@@ -157,14 +157,14 @@ private:
     uint64_t current_accelerometer_sensor_timestamp_ns_;
 
     // Estimates of the timestep between gyroscope event in seconds.
-    double filtered_gyroscope_timestep_s_;
+    float filtered_gyroscope_timestep_s_;
     // Number of timestep samples processed so far by the filter.
     uint32_t num_gyroscope_timestep_samples_;
     // Norm of the accelerometer for the previous measurement.
-    double previous_accelerometer_norm_;
+    float previous_accelerometer_norm_;
     // Moving average of the accelerometer norm changes. It is computed for every
     // sensor datum.
-    double moving_average_accelerometer_norm_change_;
+    float moving_average_accelerometer_norm_change_;
 
     // Flag indicating if a state reset should be executed with the next
     // accelerometer sample.
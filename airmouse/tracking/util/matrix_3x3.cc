@@ -17,8 +17,8 @@
 
 namespace cardboard {
 
-Matrix3x3::Matrix3x3(double m00, double m01, double m02, double m10, double m11, double m12,
-    double m20, double m21, double m22)
+Matrix3x3::Matrix3x3(float m00, float m01, float m02, float m10, float m11, float m12,
+    float m20, float m21, float m22)
     : elem_ { { { m00, m01, m02 }, { m10, m11, m12 }, { m20, m21, m22 } } }
 {
 }
@@ -46,7 +46,7 @@ Matrix3x3 Matrix3x3::Identity()
     return result;
 }
 
-void Matrix3x3::MultiplyScalar(double s)
+void Matrix3x3::MultiplyScalar(float s)
 {
     for (int row = 0; row < 3; ++row) {
         for (int col = 0; col < 3; ++col)
@@ -64,7 +64,7 @@ Matrix3x3 Matrix3x3::Negation() const
     return result;
 }
 
-Matrix3x3 Matrix3x3::Scale(const Matrix3x3& m, double s)
+Matrix3x3 Matrix3x3::Scale(const Matrix3x3& m, float s)
 {
     Matrix3x3 result;
     for (int row = 0; row < 3; ++row) {
@@ -33,18 +33,18 @@ public:
 
     // Dimension-specific constructors that are passed individual element values.
     Matrix3x3(
-        double m00,
-        double m01,
-        double m02,
-        double m10,
-        double m11,
-        double m12,
-        double m20,
-        double m21,
-        double m22);
+        float m00,
+        float m01,
+        float m02,
+        float m10,
+        float m11,
+        float m12,
+        float m20,
+        float m21,
+        float m22);
 
     // Constructor that reads elements from a linear array of the correct size.
-    explicit Matrix3x3(const double array[3 * 3]);
+    explicit Matrix3x3(const float array[3 * 3]);
 
     // Returns a Matrix3x3 containing all zeroes.
     static Matrix3x3 Zero();
@@ -53,31 +53,31 @@ public:
     static Matrix3x3 Identity();
 
     // Mutable element accessors.
-    double& operator()(int row, int col) {
+    float& operator()(int row, int col) {
         return elem_[row][col];
     }
-    std::array<double, 3>& operator[](int row) {
+    std::array<float, 3>& operator[](int row) {
         return elem_[row];
     }
 
     // Read-only element accessors.
-    const double& operator()(int row, int col) const {
+    const float& operator()(int row, int col) const {
         return elem_[row][col];
     }
-    const std::array<double, 3>& operator[](int row) const {
+    const std::array<float, 3>& operator[](int row) const {
         return elem_[row];
     }
 
     // Return a pointer to the data for interfacing with libraries.
-    double* Data() {
+    float* Data() {
         return &elem_[0][0];
     }
-    const double* Data() const {
+    const float* Data() const {
         return &elem_[0][0];
     }
 
     // Self-modifying multiplication operators.
-    void operator*=(double s) {
+    void operator*=(float s) {
         MultiplyScalar(s);
     }
     void operator*=(const Matrix3x3& m) {
@@ -90,10 +90,10 @@ public:
     }
 
     // Binary scale operators.
-    friend Matrix3x3 operator*(const Matrix3x3& m, double s) {
+    friend Matrix3x3 operator*(const Matrix3x3& m, float s) {
         return Scale(m, s);
     }
-    friend Matrix3x3 operator*(double s, const Matrix3x3& m) {
+    friend Matrix3x3 operator*(float s, const Matrix3x3& m) {
         return Scale(m, s);
     }
 
@@ -122,15 +122,15 @@ public:
 
 private:
     // These private functions implement most of the operators.
-    void MultiplyScalar(double s);
+    void MultiplyScalar(float s);
     Matrix3x3 Negation() const;
     static Matrix3x3 Addition(const Matrix3x3& lhs, const Matrix3x3& rhs);
     static Matrix3x3 Subtraction(const Matrix3x3& lhs, const Matrix3x3& rhs);
-    static Matrix3x3 Scale(const Matrix3x3& m, double s);
+    static Matrix3x3 Scale(const Matrix3x3& m, float s);
     static Matrix3x3 Product(const Matrix3x3& m0, const Matrix3x3& m1);
     static bool AreEqual(const Matrix3x3& m0, const Matrix3x3& m1);
 
-    std::array<std::array<double, 3>, 3> elem_;
+    std::array<std::array<float, 3>, 3> elem_;
 };
 
 } // namespace cardboard
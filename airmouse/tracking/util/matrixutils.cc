@@ -28,14 +28,14 @@ namespace {
         return ((row + col) & 1) != 0;
     }
 
-    static double CofactorElement3(const Matrix3x3& m, int row, int col)
+    static float CofactorElement3(const Matrix3x3& m, int row, int col)
     {
         static const int index[3][2] = { { 1, 2 }, { 0, 2 }, { 0, 1 } };
         const int i0 = index[row][0];
         const int i1 = index[row][1];
         const int j0 = index[col][0];
         const int j1 = index[col][1];
-        const double cofactor = m(i0, j0) * m(i1, j1) - m(i0, j1) * m(i1, j0);
+        const float cofactor = m(i0, j0) * m(i1, j1) - m(i0, j1) * m(i1, j0);
         return IsCofactorNegated(row, col) ? -cofactor : cofactor;
     }
 
@@ -63,18 +63,18 @@ namespace {
         //         2ac - 2bd               2bc + 2ad        -a^2 - b^2 + c^2 + d^2
         //
         const Vector<4>& quat = r.GetQuaternion();
-        const double aa = quat[0] * quat[0];
-        const double bb = quat[1] * quat[1];
-        const double cc = quat[2] * quat[2];
-        const double dd = quat[3] * quat[3];
+        const float aa = quat[0] * quat[0];
+        const float bb = quat[1] * quat[1];
+        const float cc = quat[2] * quat[2];
+        const float dd = quat[3] * quat[3];
 
-        const double ab = quat[0] * quat[1];
-        const double ac = quat[0] * quat[2];
-        const double bc = quat[1] * quat[2];
+        const float ab = quat[0] * quat[1];
+        const float ac = quat[0] * quat[2];
+        const float bc = quat[1] * quat[2];
 
-        const double ad = quat[0] * quat[3];
-        const double bd = quat[1] * quat[3];
-        const double cd = quat[2] * quat[3];
+        const float ad = quat[0] * quat[3];
+        const float bd = quat[1] * quat[3];
+        const float cd = quat[2] * quat[3];
 
         Matrix3x3& m = *matrix;
         m[0][0] = aa - bb - cc + dd;
@@ -102,7 +102,7 @@ Matrix3x3 CofactorMatrix(const Matrix3x3& m)
     return result;
 }
 
-Matrix3x3 AdjugateWithDeterminant(const Matrix3x3& m, double* determinant)
+Matrix3x3 AdjugateWithDeterminant(const Matrix3x3& m, float* determinant)
 {
     const Matrix3x3 cofactor_matrix = CofactorMatrix(m);
     if (determinant) {
@@ -123,10 +123,10 @@ Matrix3x3 Transpose(const Matrix3x3& m)
     return result;
 }
 
-Matrix3x3 InverseWithDeterminant(const Matrix3x3& m, double* determinant)
+Matrix3x3 InverseWithDeterminant(const Matrix3x3& m, float* determinant)
 {
     // The inverse is the adjugate divided by the determinant.
-    double det;
+    float det;
     Matrix3x3 adjugate = AdjugateWithDeterminant(m, &det);
     if (determinant)
         *determinant = det;
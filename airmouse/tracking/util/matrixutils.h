@@ -36,19 +36,19 @@ Vector3 operator*(const Matrix3x3& m, const Vector3& v);
 
 // Returns the determinant of the matrix. This function is defined for all the
 // typedef'ed Matrix types.
-double Determinant(const Matrix3x3& m);
+float Determinant(const Matrix3x3& m);
 
 // Returns the adjugate of the matrix, which is defined as the transpose of the
 // cofactor matrix. This function is defined for all the typedef'ed Matrix
 // types.  The determinant of the matrix is computed as a side effect, so it is
 // returned in the determinant parameter if it is not null.
-Matrix3x3 AdjugateWithDeterminant(const Matrix3x3& m, double* determinant);
+Matrix3x3 AdjugateWithDeterminant(const Matrix3x3& m, float* determinant);
 
 // Returns the inverse of the matrix. This function is defined for all the
 // typedef'ed Matrix types.  The determinant of the matrix is computed as a
 // side effect, so it is returned in the determinant parameter if it is not
 // null. If the determinant is 0, the returned matrix has all zeroes.
-Matrix3x3 InverseWithDeterminant(const Matrix3x3& m, double* determinant);
+Matrix3x3 InverseWithDeterminant(const Matrix3x3& m, float* determinant);
 
 // Returns the inverse of the matrix. This function is defined for all the
 // typedef'ed Matrix types. If the determinant of the matrix is 0, the returned
@@ -22,82 +22,82 @@
 
 namespace cardboard {
 
-void Rotation::SetAxisAndAngle(const VectorType& axis, double angle)
+void Rotation::SetAxisAndAngle(const VectorType& axis, float angle)
 {
     VectorType unit_axis = axis;
     if (!Normalize(&unit_axis)) {
         *this = Identity();
     } else {
-        double a = angle / 2;
-        const double s = sin(a);
+        float a = angle / 2;
+        const float s = std::sin(a);
         const VectorType v(unit_axis * s);
-        SetQuaternion(QuaternionType(v[0], v[1], v[2], cos(a)));
+        SetQuaternion(QuaternionType(v[0], v[1], v[2], std::cos(a)));
     }
 }
 
 Rotation Rotation::FromRotationMatrix(const Matrix3x3& mat)
 {
-    static const double kOne = 1.0;
-    static const double kFour = 4.0;
+    static const float kOne = 1.0f;
+    static const float kFour = 4.0f;
 
-    const double d0 = mat(0, 0), d1 = mat(1, 1), d2 = mat(2, 2);
-    const double ww = kOne + d0 + d1 + d2;
-    const double xx = kOne + d0 - d1 - d2;
-    const double yy = kOne - d0 + d1 - d2;
-    const double zz = kOne - d0 - d1 + d2;
+    const float d0 = mat(0, 0), d1 = mat(1, 1), d2 = mat(2, 2);
+    const float ww = kOne + d0 + d1 + d2;
+    const float xx = kOne + d0 - d1 - d2;
+    const float yy = kOne - d0 + d1 - d2;
+    const float zz = kOne - d0 - d1 + d2;
 
-    const double max = std::max(ww, std::max(xx, std::max(yy, zz)));
+    const float max = std::max(ww, std::max(xx, std::max(yy, zz)));
     if (ww == max) {
-        const double w4 = sqrt(ww * kFour);
+        const float w4 = std::sqrt(ww * kFour);
         return Rotation::FromQuaternion(QuaternionType((mat(2, 1) - mat(1, 2)) / w4,
             (mat(0, 2) - mat(2, 0)) / w4, (mat(1, 0) - mat(0, 1)) / w4, w4 / kFour));
     }
 
     if (xx == max) {
-        const double x4 = sqrt(xx * kFour);
+        const float x4 = std::sqrt(xx * kFour);
         return Rotation::FromQuaternion(QuaternionType(x4 / kFour, (mat(0, 1) + mat(1, 0)) / x4,
             (mat(0, 2) + mat(2, 0)) / x4, (mat(2, 1) - mat(1, 2)) / x4));
     }
 
     if (yy == max) {
-        const double y4 = sqrt(yy * kFour);
+        const float y4 = std::sqrt(yy * kFour);
         return Rotation::FromQuaternion(QuaternionType((mat(0, 1) + mat(1, 0)) / y4, y4 / kFour,
             (mat(1, 2) + mat(2, 1)) / y4, (mat(0, 2) - mat(2, 0)) / y4));
     }
 
     // zz is the largest component.
-    const double z4 = sqrt(zz * kFour);
+    const float z4 = std::sqrt(zz * kFour);
     return Rotation::FromQuaternion(QuaternionType((mat(0, 2) + mat(2, 0)) / z4,
         (mat(1, 2) + mat(2, 1)) / z4, z4 / kFour, (mat(1, 0) - mat(0, 1)) / z4));
 }
 
-void Rotation::GetAxisAndAngle(VectorType* axis, double* angle) const
+void Rotation::GetAxisAndAngle(VectorType* axis, float* angle) const
 {
     VectorType vec(quat_[0], quat_[1], quat_[2]);
     if (Normalize(&vec)) {
-        *angle = 2 * acos(quat_[3]);
+        *angle = 2 * std::acos(quat_[3]);
         *axis = vec;
     } else {
         *axis = VectorType(1, 0, 0);
-        *angle = 0.0;
+        *angle = 0.0f;
     }
 }
 
 Rotation Rotation::RotateInto(const VectorType& from, const VectorType& to)
 {
-    static const double kTolerance = std::numeric_limits<double>::epsilon() * 100;
+    static const float kTolerance = std::numeric_limits<float>::epsilon() * 100;
 
     // Directly build the quaternion using the following technique:
     // http://lolengine.net/blog/2014/02/24/quaternion-from-two-vectors-final
-    const double norm_u_norm_v = sqrt(LengthSquared(from) * LengthSquared(to));
-    double real_part = norm_u_norm_v + Dot(from, to);
+    const float norm_u_norm_v = std::sqrt(LengthSquared(from) * LengthSquared(to));
+    float real_part = norm_u_norm_v + Dot(from, to);
     VectorType w;
     if (real_part < kTolerance * norm_u_norm_v) {
         // If |from| and |to| are exactly opposite, rotate 180 degrees around an
         // arbitrary orthogonal axis. Axis normalization can happen later, when we
         // normalize the quaternion.
-        real_part = 0.0;
-        w = (abs(from[0]) > abs(from[2])) ? VectorType(-from[1], from[0], 0)
+        real_part = 0.0f;
+        w = (std::abs(from[0]) > std::abs(from[2])) ? VectorType(-from[1], from[0], 0)
                                           : VectorType(0, -from[2], from[1]);
     } else {
         // Otherwise, build the quaternion the standard way.
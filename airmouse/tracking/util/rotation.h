@@ -53,16 +53,16 @@ public:
     // Sets the Rotation to rotate by the given angle around the given axis,
     // following the right-hand rule. The axis does not need to be unit
     // length. If it is zero length, this results in an identity Rotation.
-    void SetAxisAndAngle(const VectorType& axis, double angle);
+    void SetAxisAndAngle(const VectorType& axis, float angle);
 
     // Returns the right-hand rule axis and angle corresponding to the
     // Rotation. If the Rotation is the identity rotation, this returns the +X
     // axis and an angle of 0.
-    void GetAxisAndAngle(VectorType* axis, double* angle) const;
+    void GetAxisAndAngle(VectorType* axis, float* angle) const;
 
     // Convenience function that constructs and returns a Rotation given an axis
     // and angle.
-    static Rotation FromAxisAndAngle(const VectorType& axis, double angle) {
+    static Rotation FromAxisAndAngle(const VectorType& axis, float angle) {
         Rotation r;
         r.SetAxisAndAngle(axis, angle);
         return r;
@@ -83,7 +83,7 @@ public:
     // Convenience function that constructs and returns a Rotation given Euler
     // angles that are applied in the order of rotate-Z by roll, rotate-X by
     // pitch, rotate-Y by yaw (same as GetRollPitchYaw).
-    static Rotation FromRollPitchYaw(double roll, double pitch, double yaw) {
+    static Rotation FromRollPitchYaw(float roll, float pitch, float yaw) {
         VectorType x(1, 0, 0), y(0, 1, 0), z(0, 0, 1);
         return FromAxisAndAngle(z, roll) * (FromAxisAndAngle(x, pitch) * FromAxisAndAngle(y, yaw));
     }
@@ -91,7 +91,7 @@ public:
     // Convenience function that constructs and returns a Rotation given Euler
     // angles that are applied in the order of rotate-Y by yaw, rotate-X by
     // pitch, rotate-Z by roll (same as GetYawPitchRoll).
-    static Rotation FromYawPitchRoll(double yaw, double pitch, double roll) {
+    static Rotation FromYawPitchRoll(float yaw, float pitch, float roll) {
         VectorType x(1, 0, 0), y(0, 1, 0), z(0, 0, 1);
         return FromAxisAndAngle(y, yaw) * (FromAxisAndAngle(x, pitch) * FromAxisAndAngle(z, roll));
     }
@@ -132,7 +132,7 @@ public:
 
 private:
     // Private constructor that builds a Rotation from quaternion components.
-    Rotation(double q0, double q1, double q2, double q3)
+    Rotation(float q0, float q1, float q2, float q3)
         : quat_(q0, q1, q2, q3) {
     }
 
@@ -140,7 +140,7 @@ private:
     // http://blog.molecular-matters.com/2013/05/24/a-faster-quaternion-vector-multiplication/
     VectorType ApplyToVector(const VectorType& v) const {
         VectorType im(quat_[0], quat_[1], quat_[2]);
-        VectorType temp = 2.0 * Cross(im, v);
+        VectorType temp = 2.0f * Cross(im, v);
         return v + quat_[3] * temp + Cross(im, temp);
     }
 
@@ -28,24 +28,24 @@ public:
     Vector();
 
     // Dimension-specific constructors that are passed individual element values.
-    constexpr Vector(double e0, double e1, double e2);
-    constexpr Vector(double e0, double e1, double e2, double e3);
+    constexpr Vector(float e0, float e1, float e2);
+    constexpr Vector(float e0, float e1, float e2, float e3);
 
     // Constructor for a Vector of dimension N from a Vector of dimension N-1 and
     // a scalar of the correct type, assuming N is at least 2.
-    // constexpr Vector(const Vector<Dimension - 1>& v, double s);
+    // constexpr Vector(const Vector<Dimension - 1>& v, float s);
 
-    void Set(double e0, double e1, double e2); // Only when Dimension == 3.
-    void Set(double e0, double e1, double e2,
-             double e3); // Only when Dimension == 4.
+    void Set(float e0, float e1, float e2); // Only when Dimension == 3.
+    void Set(float e0, float e1, float e2,
+             float e3); // Only when Dimension == 4.
 
     // Mutable element accessor.
-    double& operator[](int index) {
+    float& operator[](int index) {
         return elem_[index];
     }
 
     // Element accessor.
-    double operator[](int index) const {
+    float operator[](int index) const {
         return elem_[index];
     }
 
@@ -59,10 +59,10 @@ public:
     void operator-=(const Vector& v) {
         Subtract(v);
     }
-    void operator*=(double s) {
+    void operator*=(float s) {
         Multiply(s);
     }
-    void operator/=(double s) {
+    void operator/=(float s) {
         Divide(s);
     }
 
@@ -78,16 +78,16 @@ public:
     friend Vector operator-(const Vector& v0, const Vector& v1) {
         return Difference(v0, v1);
     }
-    friend Vector operator*(const Vector& v, double s) {
+    friend Vector operator*(const Vector& v, float s) {
         return Scale(v, s);
     }
-    friend Vector operator*(double s, const Vector& v) {
+    friend Vector operator*(float s, const Vector& v) {
         return Scale(v, s);
     }
     friend Vector operator*(const Vector& v, const Vector& s) {
         return Product(v, s);
     }
-    friend Vector operator/(const Vector& v, double s) {
+    friend Vector operator/(const Vector& v, float s) {
         return Divide(v, s);
     }
 
@@ -96,9 +96,9 @@ public:
     // Self-modifying subtraction.
     void Subtract(const Vector& v);
     // Self-modifying multiplication by a scalar.
-    void Multiply(double s);
+    void Multiply(float s);
     // Self-modifying division by a scalar.
-    void Divide(double s);
+    void Divide(float s);
 
     // Unary negation.
     Vector Negation() const;
@@ -110,12 +110,12 @@ public:
     // Binary component-wise subtraction.
     static Vector Difference(const Vector& v0, const Vector& v1);
     // Binary multiplication by a scalar.
-    static Vector Scale(const Vector& v, double s);
+    static Vector Scale(const Vector& v, float s);
     // Binary division by a scalar.
-    static Vector Divide(const Vector& v, double s);
+    static Vector Divide(const Vector& v, float s);
 
 private:
-    std::array<double, Dimension> elem_;
+    std::array<float, Dimension> elem_;
 };
 //------------------------------------------------------------------------------
 
@@ -127,28 +127,28 @@ Vector<Dimension>::Vector() {
 }
 
 template <int Dimension>
-constexpr Vector<Dimension>::Vector(double e0, double e1, double e2)
+constexpr Vector<Dimension>::Vector(float e0, float e1, float e2)
     : elem_{e0, e1, e2} {
 }
 
 template <int Dimension>
-constexpr Vector<Dimension>::Vector(double e0, double e1, double e2, double e3)
+constexpr Vector<Dimension>::Vector(float e0, float e1, float e2, float e3)
     : elem_{e0, e1, e2, e3} {
 }
 /*
 template <>
-constexpr Vector<4>::Vector(const Vector<3>& v, double s)
+constexpr Vector<4>::Vector(const Vector<3>& v, float s)
     : elem_{v[0], v[1], v[2], s} {}
 */
 template <int Dimension>
-void Vector<Dimension>::Set(double e0, double e1, double e2) {
+void Vector<Dimension>::Set(float e0, float e1, float e2) {
     elem_[0] = e0;
     elem_[1] = e1;
     elem_[2] = e2;
 }
 
 template <int Dimension>
-void Vector<Dimension>::Set(double e0, double e1, double e2, double e3) {
+void Vector<Dimension>::Set(float e0, float e1, float e2, float e3) {
     elem_[0] = e0;
     elem_[1] = e1;
     elem_[2] = e2;
@@ -176,14 +176,14 @@ void Vector<Dimension>::Subtract(const Vector& v) {
 }
 
 template <int Dimension>
-void Vector<Dimension>::Multiply(double s) {
+void Vector<Dimension>::Multiply(float s) {
     for(int i = 0; i < Dimension; i++) {
         elem_[i] *= s;
     }
 }
 
 template <int Dimension>
-void Vector<Dimension>::Divide(double s) {
+void Vector<Dimension>::Divide(float s) {
     for(int i = 0; i < Dimension; i++) {
         elem_[i] /= s;
     }
@@ -226,7 +226,7 @@ Vector<Dimension> Vector<Dimension>::Difference(const Vector& v0, const Vector&
 }
 
 template <int Dimension>
-Vector<Dimension> Vector<Dimension>::Scale(const Vector& v, double s) {
+Vector<Dimension> Vector<Dimension>::Scale(const Vector& v, float s) {
     Vector<Dimension> ret;
     for(int i = 0; i < Dimension; i++) {
         ret.elem_[i] = v[i] * s;
@@ -235,7 +235,7 @@ Vector<Dimension> Vector<Dimension>::Scale(const Vector& v, double s) {
 }
 
 template <int Dimension>
-Vector<Dimension> Vector<Dimension>::Divide(const Vector& v, double s) {
+Vector<Dimension> Vector<Dimension>::Divide(const Vector& v, float s) {
     Vector<Dimension> ret;
     for(int i = 0; i < Dimension; i++) {
         ret.elem_[i] = v[i] / s;
@@ -27,10 +27,10 @@
 namespace cardboard {
 
 // Returns the dot (inner) product of two Vectors.
-double Dot(const Vector<3>& v0, const Vector<3>& v1);
+float Dot(const Vector<3>& v0, const Vector<3>& v1);
 
 // Returns the dot (inner) product of two Vectors.
-double Dot(const Vector<4>& v0, const Vector<4>& v1);
+float Dot(const Vector<4>& v0, const Vector<4>& v1);
 
 // Returns the 3-dimensional cross product of 2 Vectors. Note that this is
 // defined only for 3-dimensional Vectors.
@@ -38,20 +38,20 @@ Vector<3> Cross(const Vector<3>& v0, const Vector<3>& v1);
 
 // Returns the square of the length of a Vector.
 template <int Dimension>
-double LengthSquared(const Vector<Dimension>& v) {
+float LengthSquared(const Vector<Dimension>& v) {
     return Dot(v, v);
 }
 
 // Returns the geometric length of a Vector.
 template <int Dimension>
-double Length(const Vector<Dimension>& v) {
-    return sqrt(LengthSquared(v));
+float Length(const Vector<Dimension>& v) {
+    return std::sqrt(LengthSquared(v));
 }
 
 // the Vector untouched and returns false.
 template <int Dimension>
 bool Normalize(Vector<Dimension>* v) {
-    const double len = Length(*v);
+    const float len = Length(*v);
     if(len == 0) {
         return false;
     } else {
@@ -33,6 +33,13 @@
 #ifndef PI
 #define PI 3.14159265358979f
 #endif
+#define SIN_TABLE_SIZE 256 /* Angle steps in a full rotation, power of 2. */
+#define GRID_CELL_SIZE 16 /* Collision grid cell size in pixels. */
+#define GRID_COLS (SCREEN_XRES / GRID_CELL_SIZE)
+#define GRID_ROWS (SCREEN_YRES / GRID_CELL_SIZE)
+/* Asteroids are at most 18 pixels in radius, so they span at most
+ * 4x4 grid cells. */
+#define GRID_MAX_ENTRIES (MAXAST * 16)
 
 /* ============================ Data structures ============================= */
 typedef enum PowerUpType {
@@ -122,6 +129,21 @@ typedef struct AsteroidsApp {
     bool fire; /* Short press detected: fire a bullet. */
 } AsteroidsApp;
 
+/* Coarse screen grid used for collision detection. Each asteroid is
+ * listed in every cell its bounding box touches, so an object only needs
+ * to be tested against the asteroids listed in the cells it touches.
+ * The asteroids of cell c are entries[start[c]] .. entries[start[c+1]-1].
+ * It is not part of AsteroidsApp since the whole app state is what
+ * gets saved to the SD card. */
+typedef struct AsteroidGrid {
+    uint16_t start[GRID_COLS * GRID_ROWS + 1];
+    uint8_t entries[GRID_MAX_ENTRIES];
+} AsteroidGrid;
+
+_Static_assert(MAXAST <= 32, "grid lookups track seen asteroids in a 32 bit mask");
+
+static AsteroidGrid asteroid_grid;
+
 const NotificationSequence sequence_thrusters = {
     &message_vibro_on,
     &message_delay_10,
@@ -245,14 +267,38 @@ Poly ShipPoly = {{-3, 0, 3}, {-3, 6, -3}, 3};
 
 Poly ShipFirePoly = {{-1.5, 0, 1.5}, {-3, -6, -3}, 3};
 
+/* sin() of SIN_TABLE_SIZE angles evenly spaced over a full rotation.
+ * sin() and cos() in double precision are very slow on the Flipper,
+ * and the angle step of the ship is so coarse that the quantization
+ * is not visible. Filled by init_sin_table() at startup. */
+static float sin_table[SIN_TABLE_SIZE];
+
+void init_sin_table(void) {
+    for(int j = 0; j < SIN_TABLE_SIZE; j++) {
+        sin_table[j] = sinf(PI * 2 * j / SIN_TABLE_SIZE);
+    }
+}
+
+/* Table based sin() / cos() of an angle in radians, any sign and
+ * magnitude: the masking wraps the index around the table. */
+static inline float fast_sin(float a) {
+    int32_t j = (int32_t)(a * (SIN_TABLE_SIZE / (PI * 2)));
+    return sin_table[j & (SIN_TABLE_SIZE - 1)];
+}
+
+static inline float fast_cos(float a) {
+    int32_t j = (int32_t)(a * (SIN_TABLE_SIZE / (PI * 2))) + SIN_TABLE_SIZE / 4;
+    return sin_table[j & (SIN_TABLE_SIZE - 1)];
+}
+
 /* Rotate the point of the poligon 'poly' and store the new rotated
  * polygon in 'rot'. The polygon is rotated by an angle 'a', with
  * center at 0,0. */
 void rotate_poly(Poly* rot, Poly* poly, float a) {
     /* We want to compute sin(a) and cos(a) only one time
-     * for every point to rotate. It's a slow operation. */
-    float sin_a = (float)sin(a);
-    float cos_a = (float)cos(a);
+     * for every point to rotate. */
+    float sin_a = fast_sin(a);
+    float cos_a = fast_cos(a);
     for(uint32_t j = 0; j < poly->points; j++) {
         rot->x[j] = poly->x[j] * cos_a - poly->y[j] * sin_a;
         rot->y[j] = poly->y[j] * cos_a + poly->x[j] * sin_a;
@@ -303,12 +349,11 @@ void draw_bullet(Canvas* const canvas, Bullet* b) {
 void draw_asteroid(Canvas* const canvas, Asteroid* ast) {
     Poly ap;
 
-    /* Start with what is kinda of a circle. Note that this could be
-     * stored into a template and copied here, to avoid computing
-     * sin() / cos(). But the Flipper can handle it without problems. */
+    /* Start with what is kinda of a circle. The 8 points are at
+     * exact steps of the sine table. */
     uint8_t r = ast->shape_seed;
     for(int j = 0; j < 8; j++) {
-        float a = (PI * 2) / 8 * j;
+        int a = SIN_TABLE_SIZE / 8 * j;
 
         /* Before generating the point, to make the shape unique generate
          * a random factor between .7 and 1.3 to scale the distance from
@@ -316,10 +361,10 @@ void draw_asteroid(Canvas* const canvas, Asteroid* ast) {
          * that remains always the same, so we use a predictable PRNG
          * implemented by an 8 bit shift register. */
         lfsr_next(&r);
-        float scaling = .7 + ((float)r / 255 * .6);
+        float scaling = .7f + ((float)r / 255 * .6f);
 
-        ap.x[j] = (float)sin(a) * ast->size * scaling;
-        ap.y[j] = (float)cos(a) * ast->size * scaling;
+        ap.x[j] = sin_table[a] * ast->size * scaling;
+        ap.y[j] = sin_table[(a + SIN_TABLE_SIZE / 4) & (SIN_TABLE_SIZE - 1)] * ast->size * scaling;
     }
     ap.points = 8;
     draw_poly(canvas, &ap, ast->x, ast->y, ast->rot);
@@ -369,7 +414,7 @@ void draw_powerUp_RemainingLife(Canvas* canvas, PowerUp* const p, int y_offset)
 
     if(p->ttl > 0) {
         canvas_set_color(canvas, ColorBlack);
-        int remaining = ceil(((float)p->ttl / (float)POWERUPSTTL) * (float)progress_bar_width);
+        int remaining = (p->ttl * progress_bar_width + POWERUPSTTL - 1) / POWERUPSTTL;
 
         if(remaining > 0) {
             canvas_draw_line(
@@ -526,11 +571,8 @@ void render_callback(Canvas* const canvas, void* ctx) {
         char* str_high_score = malloc(length + 1);
         snprintf(str_high_score, length + 1, "%lu", app->highscore);
 
-        // Get length to center on screen
-        int nDigits = 0;
-        if(app->highscore > 0) {
-            nDigits = floor(log10(app->highscore)) + 1;
-        }
+        // Get length to center on screen, no digits are counted for a zero score
+        int nDigits = app->highscore > 0 ? length : 0;
 
         // Draw highscore centered
         canvas_draw_str(canvas, (SCREEN_XRES / 2) - (nDigits * 2), 20, str_high_score);
@@ -563,7 +605,7 @@ void update_pos_by_velocity(float* x, float* y, float vx, float vy) {
 float distance(float x1, float y1, float x2, float y2) {
     float dx = x1 - x2;
     float dy = y1 - y2;
-    return sqrt(dx * dx + dy * dy);
+    return sqrtf(dx * dx + dy * dy);
 }
 
 /* Detect a collision between the object at x1,y1 of radius r1 and
@@ -606,8 +648,8 @@ void ship_fire_bullet(AsteroidsApp* app) {
     Bullet* b = &app->bullets[app->bullets_num];
     b->x = app->ship.x;
     b->y = app->ship.y;
-    b->vx = -sin(app->ship.rot);
-    b->vy = cos(app->ship.rot);
+    b->vx = -fast_sin(app->ship.rot);
+    b->vy = fast_cos(app->ship.rot);
 
     /* Ship should fire from its head, not in the middle. */
     b->x += b->vx * 5;
@@ -991,44 +1033,104 @@ void update_powerUp_status(AsteroidsApp* app) {
     }
 }
 
+/* Range of grid cells touched by the bounding box of a circle at x,y
+ * with radius r, clipped to the screen. */
+void grid_cells_range(float x, float y, float r, int* x0, int* y0, int* x1, int* y1) {
+    *x0 = x - r < 0 ? 0 : (int)(x - r) / GRID_CELL_SIZE;
+    *y0 = y - r < 0 ? 0 : (int)(y - r) / GRID_CELL_SIZE;
+    *x1 = x + r >= SCREEN_XRES ? GRID_COLS - 1 : (int)(x + r) / GRID_CELL_SIZE;
+    *y1 = y + r >= SCREEN_YRES ? GRID_ROWS - 1 : (int)(y + r) / GRID_CELL_SIZE;
+}
+
+/* Bucket the asteroids into the grid with a counting sort: count the
+ * entries of each cell, turn the counts into start offsets, then fill. */
+void grid_build(AsteroidsApp* app) {
+    AsteroidGrid* g = &asteroid_grid;
+    uint16_t next[GRID_COLS * GRID_ROWS];
+    int x0, y0, x1, y1;
+
+    memset(next, 0, sizeof(next));
+    for(int i = 0; i < app->asteroids_num; i++) {
+        Asteroid* a = &app->asteroids[i];
+        grid_cells_range(a->x, a->y, a->size, &x0, &y0, &x1, &y1);
+        for(int cy = y0; cy <= y1; cy++)
+            for(int cx = x0; cx <= x1; cx++) next[cy * GRID_COLS + cx]++;
+    }
+
+    g->start[0] = 0;
+    for(int c = 0; c < GRID_COLS * GRID_ROWS; c++) {
+        g->start[c + 1] = g->start[c] + next[c];
+        next[c] = g->start[c];
+    }
+
+    for(int i = 0; i < app->asteroids_num; i++) {
+        Asteroid* a = &app->asteroids[i];
+        grid_cells_range(a->x, a->y, a->size, &x0, &y0, &x1, &y1);
+        for(int cy = y0; cy <= y1; cy++)
+            for(int cx = x0; cx <= x1; cx++) g->entries[next[cy * GRID_COLS + cx]++] = i;
+    }
+}
+
+/* Return the index of an asteroid colliding with the object at x,y
+ * of radius r, or -1 if there is none. Only the asteroids listed in the
+ * grid cells touched by the object are tested. */
+int grid_find_collision(AsteroidsApp* app, float x, float y, float r) {
+    AsteroidGrid* g = &asteroid_grid;
+    uint32_t seen = 0; /* Big asteroids are listed in more cells. */
+    int x0, y0, x1, y1;
+
+    grid_cells_range(x, y, r, &x0, &y0, &x1, &y1);
+    for(int cy = y0; cy <= y1; cy++) {
+        for(int cx = x0; cx <= x1; cx++) {
+            int c = cy * GRID_COLS + cx;
+            for(int e = g->start[c]; e < g->start[c + 1]; e++) {
+                int i = g->entries[e];
+                if(seen & (1UL << i)) continue;
+                seen |= 1UL << i;
+                Asteroid* a = &app->asteroids[i];
+                if(objects_are_colliding(a->x, a->y, a->size, x, y, r, 1)) return i;
+            }
+        }
+    }
+    return -1;
+}
+
 /* Collision detection and game state update based on collisions. */
 void detect_collisions(AsteroidsApp* app) {
-    /* Detect collision between bullet and asteroid. */
+    /* Detect collision between bullet and asteroid. Every hit removes
+     * the asteroid and maybe adds fragments, renumbering the asteroids
+     * array, so the grid is built again after it. */
+    grid_build(app);
     for(int j = 0; j < app->bullets_num; j++) {
         Bullet* b = &app->bullets[j];
-        for(int i = 0; i < app->asteroids_num; i++) {
-            Asteroid* a = &app->asteroids[i];
-            if(objects_are_colliding(a->x, a->y, a->size, b->x, b->y, 1.5, 1)) {
-                asteroid_was_hit(app, i);
-                remove_bullet(app, j);
-                /* The bullet no longer exist. Break the loop.
-                 * However we want to start processing from the
-                 * same bullet index, since now it is used by
-                 * another bullet (see remove_bullet()). */
-                j--; /* Scan this j value again. */
-                break;
-            }
+        int i = grid_find_collision(app, b->x, b->y, 1.5);
+        if(i >= 0) {
+            asteroid_was_hit(app, i);
+            remove_bullet(app, j);
+            /* The bullet no longer exist. However we want to start
+             * processing from the same bullet index, since now it is used
+             * by another bullet (see remove_bullet()). */
+            j--; /* Scan this j value again. */
+            grid_build(app);
         }
     }
 
     /* Detect collision between ship and asteroid. */
-    for(int j = 0; j < app->asteroids_num; j++) {
-        Asteroid* a = &app->asteroids[j];
-        if(objects_are_colliding(a->x, a->y, a->size, app->ship.x, app->ship.y, 4, 1)) {
-            if(isPowerUpActive(app, PowerUpTypeShield)) {
-                // Asteroid was hit with shield
-                notification_message(
-                    furi_record_open(RECORD_NOTIFICATION), &sequence_bullet_fired);
-                asteroid_was_hit(app, j);
-                j--; /* Scan this j value again. */
-            } else {
-                // No sheild active, take damage
-                ship_was_hit(app);
-                break;
-            }
+    int j;
+    while((j = grid_find_collision(app, app->ship.x, app->ship.y, 4)) >= 0) {
+        if(isPowerUpActive(app, PowerUpTypeShield)) {
+            // Asteroid was hit with shield
+            notification_message(furi_record_open(RECORD_NOTIFICATION), &sequence_bullet_fired);
+            asteroid_was_hit(app, j);
+            grid_build(app); /* Look again, fragments may still collide. */
+        } else {
+            // No sheild active, take damage
+            ship_was_hit(app);
+            break;
         }
     }
 
+    /* Powerups are at most MAXPOWERUPS, no need for the grid here. */
     /* Detect collision between ship and powerUp. */
     for(int j = 0; j < app->powerUps_num; j++) {
         PowerUp* p = &app->powerUps[j];
@@ -1054,7 +1156,7 @@ void game_tick(void* ctx) {
      * again, and show an animation of a rotating ship. */
     if(app->ship_hit) {
         notification_message(furi_record_open(RECORD_NOTIFICATION), &sequence_crash);
-        app->ship.rot += 0.5;
+        app->ship.rot += 0.5f;
         app->ship_hit--;
         view_port_update(app->view_port);
         if(app->ship_hit == 0) {
@@ -1081,15 +1183,15 @@ void game_tick(void* ctx) {
     }
 
     /* Handle keypresses. */
-    if(app->pressed[InputKeyLeft]) app->ship.rot -= .35;
-    if(app->pressed[InputKeyRight]) app->ship.rot += .35;
+    if(app->pressed[InputKeyLeft]) app->ship.rot -= .35f;
+    if(app->pressed[InputKeyRight]) app->ship.rot += .35f;
     if(app->pressed[InputKeyUp]) {
-        app->ship.vx -= 0.5 * (float)sin(app->ship.rot);
-        app->ship.vy += 0.5 * (float)cos(app->ship.rot);
+        app->ship.vx -= 0.5f * fast_sin(app->ship.rot);
+        app->ship.vy += 0.5f * fast_cos(app->ship.rot);
     } else if(app->pressed[InputKeyDown]) {
         notification_message(furi_record_open(RECORD_NOTIFICATION), &sequence_brake);
-        app->ship.vx *= 0.75;
-        app->ship.vy *= 0.75;
+        app->ship.vx *= 0.75f;
+        app->ship.vy *= 0.75f;
     }
 
     /* Fire a bullet if needed. app->fire is set in
@@ -1186,6 +1288,7 @@ void input_callback(InputEvent* input_event, void* ctx) {
 AsteroidsApp* asteroids_app_alloc() {
     AsteroidsApp* app = malloc(sizeof(AsteroidsApp));
 
+    init_sin_table();
     load_game(app);
 
     app->gui = furi_record_open(RECORD_GUI);
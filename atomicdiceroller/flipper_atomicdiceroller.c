@@ -4,22 +4,44 @@
 
 #include <stdio.h>
 #include <furi.h>
+#include <furi_hal.h>
 #include <gui/gui.h>
 #include <input/input.h>
-#include <notification/notification_messages.h>
 #include <furi_hal_power.h>
+#include <furi_hal_usb_cdc.h>
+#include <cli/cli.h>
+#include <cli/cli_vcp.h>
 #include <locale/locale.h>
-#include <toolbox/crc32_calc.h>
-#include <lib/toolbox/md5.h>
+#include <mbedtls/sha256.h>
 
 #define SCREEN_SIZE_X 128
 #define SCREEN_SIZE_Y 64
 
+// Pulse timestamps taken in the GPIO interrupt, must be a power of two
+#define PULSE_RING_SIZE 64
+
+// Health tests from NIST SP 800-90B 4.4, on the low byte of the interval between two pulses.
+// The cutoffs assume only 2 bits of min-entropy per sample and a false alarm rate of 2^-20.
+#define RCT_CUTOFF 11
+#define APT_WINDOW 512
+#define APT_CUTOFF 177
+
+// 512 von Neumann debiased bits are hashed into 256 conditioned bits
+#define CONDITIONER_INPUT_SIZE 64
+#define POOL_SIZE 256
+#define DICE_BUFFER_SIZE 64
+
+// The CLI stays on the first CDC interface, random bytes are streamed on the second one
+#define TRNG_CDC_CH 1
+#define TRNG_CDC_PKT_LEN 64
+
 typedef enum {
     EventTypeInput,
     ClockEventTypeTick,
     ClockEventTypeTickPause,
     EventGPIO,
+    EventUsbTx,
+    EventUsbLine,
 } EventType;
 
 typedef struct {
@@ -33,11 +55,45 @@ typedef struct {
     FuriMutex* mutex;
     uint32_t cps;
     uint32_t diceAvailiable;
+    uint32_t healthFailures;
+    uint16_t poolBytes;
     uint8_t dice;
-    uint8_t method;
+    uint8_t usb;
     uint8_t pause;
 } mutexStruct;
 
+typedef struct {
+    FuriMessageQueue* event_queue;
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t overflows;
+    uint32_t timestamps[PULSE_RING_SIZE];
+} PulseRing;
+
+typedef struct {
+    // Health tests
+    uint8_t rctSample;
+    uint8_t rctCount;
+    uint8_t aptSample;
+    uint16_t aptCount;
+    uint16_t aptIndex;
+    uint32_t failures;
+
+    // von Neumann debiasing and SHA-256 conditioning
+    uint32_t lastTimestamp;
+    bool hasLastTimestamp;
+    uint8_t debiased[CONDITIONER_INPUT_SIZE];
+    uint16_t debiasedBits;
+    mbedtls_sha256_context sha;
+
+    // Conditioned output
+    uint8_t pool[POOL_SIZE];
+    uint16_t poolRead;
+    uint16_t poolCount;
+    uint32_t bits;
+    uint8_t bitCount;
+} EntropyState;
+
 static void draw_callback(Canvas* canvas, void* ctx) {
     mutexStruct* mutexVal = ctx;
     mutexStruct mutexDraw;
@@ -50,15 +106,24 @@ static void draw_callback(Canvas* canvas, void* ctx) {
     snprintf(buffer, sizeof(buffer), "%ld cps", mutexDraw.cps);
     canvas_draw_str_aligned(canvas, 0, 10, AlignLeft, AlignBottom, buffer);
 
-    snprintf(buffer, sizeof(buffer), "%lu/64", mutexDraw.diceAvailiable);
+    if(mutexDraw.usb) {
+        snprintf(buffer, sizeof(buffer), "%u B", mutexDraw.poolBytes);
+    } else {
+        snprintf(buffer, sizeof(buffer), "%lu/64", mutexDraw.diceAvailiable);
+    }
     canvas_draw_str_aligned(canvas, SCREEN_SIZE_X, 10, AlignRight, AlignBottom, buffer);
 
-    if(mutexDraw.method == 0)
-        canvas_draw_str_aligned(canvas, 0, 20, AlignLeft, AlignBottom, "Hash: CRC32");
-    else
-        canvas_draw_str_aligned(canvas, 0, 20, AlignLeft, AlignBottom, "Hash: MD5");
+    if(mutexDraw.healthFailures == 0) {
+        canvas_draw_str_aligned(canvas, 0, 20, AlignLeft, AlignBottom, "SHA-256, health OK");
+    } else {
+        snprintf(buffer, sizeof(buffer), "Health fails: %lu", mutexDraw.healthFailures);
+        canvas_draw_str_aligned(canvas, 0, 20, AlignLeft, AlignBottom, buffer);
+    }
 
-    if(mutexDraw.dice != 0 && mutexDraw.pause == 0) {
+    if(mutexDraw.usb) {
+        canvas_draw_str_aligned(
+            canvas, SCREEN_SIZE_X / 2, 40, AlignCenter, AlignBottom, "USB TRNG on CDC 1");
+    } else if(mutexDraw.dice != 0 && mutexDraw.pause == 0) {
         canvas_set_font(canvas, FontBigNumbers);
         snprintf(buffer, sizeof(buffer), "%u", mutexDraw.dice);
         canvas_draw_str_aligned(canvas, SCREEN_SIZE_X / 2, 50, AlignCenter, AlignBottom, buffer);
@@ -88,11 +153,167 @@ static void clock_tick_pause(void* ctx) {
     furi_message_queue_put(queue, &event, 0);
 }
 
+// Runs in the EXTI interrupt: the timer is read first, so no scheduling latency ends up in the
+// timestamp. A dropped event is harmless, the main loop drains the whole ring on every event.
 static void gpiocallback(void* ctx) {
-    furi_assert(ctx);
-    FuriMessageQueue* queue = ctx;
+    uint32_t timestamp = TIM2->CNT;
+    PulseRing* ring = ctx;
+
+    uint32_t head = ring->head;
+    if(head - ring->tail < PULSE_RING_SIZE) {
+        ring->timestamps[head & (PULSE_RING_SIZE - 1)] = timestamp;
+        ring->head = head + 1;
+    } else {
+        ring->overflows++;
+    }
+
     EventApp event = {.type = EventGPIO};
-    furi_message_queue_put(queue, &event, 0);
+    furi_message_queue_put(ring->event_queue, &event, 0);
+}
+
+static void vcp_on_cdc_tx_complete(void* context) {
+    EventApp event = {.type = EventUsbTx};
+    furi_message_queue_put(context, &event, 0);
+}
+
+static void vcp_on_cdc_control_line(void* context, uint8_t state) {
+    UNUSED(state);
+    EventApp event = {.type = EventUsbLine};
+    furi_message_queue_put(context, &event, 0);
+}
+
+static const CdcCallbacks cdc_cb = {
+    .tx_ep_callback = &vcp_on_cdc_tx_complete,
+    .ctrl_line_callback = &vcp_on_cdc_control_line,
+};
+
+static void trng_usb_init(FuriMessageQueue* event_queue) {
+    furi_hal_usb_unlock();
+    Cli* cli = furi_record_open(RECORD_CLI);
+    cli_session_close(cli);
+    furi_hal_cdc_set_callbacks(0, NULL, NULL);
+    furi_check(furi_hal_usb_set_config(&usb_cdc_dual, NULL) == true);
+    cli_session_open(cli, &cli_vcp);
+    furi_record_close(RECORD_CLI);
+
+    furi_hal_cdc_set_callbacks(TRNG_CDC_CH, (CdcCallbacks*)&cdc_cb, event_queue);
+}
+
+static void trng_usb_deinit(void) {
+    furi_hal_cdc_set_callbacks(TRNG_CDC_CH, NULL, NULL);
+
+    Cli* cli = furi_record_open(RECORD_CLI);
+    cli_session_close(cli);
+    furi_hal_usb_unlock();
+    furi_check(furi_hal_usb_set_config(&usb_cdc_single, NULL) == true);
+    cli_session_open(cli, &cli_vcp);
+    furi_record_close(RECORD_CLI);
+}
+
+static void entropy_reset_block(EntropyState* entropy) {
+    entropy->debiasedBits = 0;
+    memset(entropy->debiased, 0, sizeof(entropy->debiased));
+}
+
+// Returns false when a health test fails for this sample
+static bool entropy_health_test(EntropyState* entropy, uint8_t sample) {
+    bool healthy = true;
+
+    // Repetition count test
+    if(sample == entropy->rctSample) {
+        if(++entropy->rctCount >= RCT_CUTOFF) healthy = false;
+    } else {
+        entropy->rctSample = sample;
+        entropy->rctCount = 1;
+    }
+
+    // Adaptive proportion test
+    if(entropy->aptIndex == 0) {
+        entropy->aptSample = sample;
+        entropy->aptCount = 1;
+    } else if(sample == entropy->aptSample) {
+        if(++entropy->aptCount >= APT_CUTOFF) healthy = false;
+    }
+    if(++entropy->aptIndex == APT_WINDOW) entropy->aptIndex = 0;
+
+    return healthy;
+}
+
+// Feeds one pulse, returns true when a new conditioned block was added to the pool
+static bool entropy_add_pulse(EntropyState* entropy, uint32_t timestamp) {
+    if(!entropy->hasLastTimestamp) {
+        entropy->lastTimestamp = timestamp;
+        entropy->hasLastTimestamp = true;
+        return false;
+    }
+
+    uint8_t sample = timestamp - entropy->lastTimestamp;
+    entropy->lastTimestamp = timestamp;
+
+    if(!entropy_health_test(entropy, sample)) {
+        // Throw away everything collected for the block the bad samples went into
+        entropy->failures++;
+        entropy_reset_block(entropy);
+        return false;
+    }
+
+    // von Neumann: 01 gives 0, 10 gives 1, 00 and 11 are dropped
+    for(uint8_t i = 0; i < 8; i += 2) {
+        uint8_t pair = (sample >> i) & 0b11;
+        if(pair != 0b01 && pair != 0b10) continue;
+
+        if(pair == 0b10) {
+            entropy->debiased[entropy->debiasedBits / 8] |= 1 << (entropy->debiasedBits % 8);
+        }
+        entropy->debiasedBits++;
+
+        if(entropy->debiasedBits == CONDITIONER_INPUT_SIZE * 8) {
+            uint8_t hash[32];
+            mbedtls_sha256_starts(&entropy->sha, 0);
+            mbedtls_sha256_update(&entropy->sha, entropy->debiased, sizeof(entropy->debiased));
+            mbedtls_sha256_finish(&entropy->sha, hash);
+            entropy_reset_block(entropy);
+
+            bool added = false;
+            for(uint8_t j = 0; j < sizeof(hash) && entropy->poolCount < POOL_SIZE; j++) {
+                entropy->pool[(entropy->poolRead + entropy->poolCount) % POOL_SIZE] = hash[j];
+                entropy->poolCount++;
+                added = true;
+            }
+            memset(hash, 0, sizeof(hash));
+            return added;
+        }
+    }
+    return false;
+}
+
+static uint16_t entropy_take_bytes(EntropyState* entropy, uint8_t* buffer, uint16_t size) {
+    uint16_t count = 0;
+    while(count < size && entropy->poolCount > 0) {
+        buffer[count++] = entropy->pool[entropy->poolRead];
+        entropy->pool[entropy->poolRead] = 0;
+        entropy->poolRead = (entropy->poolRead + 1) % POOL_SIZE;
+        entropy->poolCount--;
+    }
+    return count;
+}
+
+// Rejection sampling: 3 bits give 0..7, 6 and 7 are thrown away. Returns 0 when the pool is
+// too low.
+static uint8_t entropy_roll_die(EntropyState* entropy) {
+    while(true) {
+        if(entropy->bitCount < 3) {
+            uint8_t byte;
+            if(entropy_take_bytes(entropy, &byte, 1) == 0) return 0;
+            entropy->bits |= (uint32_t)byte << entropy->bitCount;
+            entropy->bitCount += 8;
+        }
+
+        uint8_t value = entropy->bits & 0b111;
+        entropy->bits >>= 3;
+        entropy->bitCount -= 3;
+        if(value < 6) return value + 1;
+    }
 }
 
 int32_t flipper_atomicdiceroller_app() {
@@ -113,7 +334,10 @@ int32_t flipper_atomicdiceroller_app() {
     mutexVal.cps = 0;
     mutexVal.dice = 0;
     mutexVal.diceAvailiable = 0;
-    mutexVal.method = 0;
+    mutexVal.healthFailures = 0;
+    mutexVal.poolBytes = 0;
+    mutexVal.usb = 0;
+    mutexVal.pause = 0;
     uint32_t counter = 0;
 
     mutexVal.mutex = furi_mutex_alloc(FuriMutexTypeNormal);
@@ -126,7 +350,9 @@ int32_t flipper_atomicdiceroller_app() {
     view_port_draw_callback_set(view_port, draw_callback, &mutexVal.mutex);
     view_port_input_callback_set(view_port, input_callback, event_queue);
 
-    furi_hal_gpio_add_int_callback(&gpio_ext_pa7, gpiocallback, event_queue);
+    PulseRing* ring = malloc(sizeof(PulseRing));
+    ring->event_queue = event_queue;
+    furi_hal_gpio_add_int_callback(&gpio_ext_pa7, gpiocallback, ring);
 
     Gui* gui = furi_record_open(RECORD_GUI);
     gui_add_view_port(gui, view_port, GuiLayerFullscreen);
@@ -142,21 +368,19 @@ int32_t flipper_atomicdiceroller_app() {
         furi_hal_power_enable_otg();
         furi_delay_ms(10);
     }
-    uint8_t diceBuffer[64];
-    for(uint8_t i = 0; i < 64; i++) diceBuffer[i] = 0;
+    uint8_t diceBuffer[DICE_BUFFER_SIZE];
+    for(uint8_t i = 0; i < DICE_BUFFER_SIZE; i++) diceBuffer[i] = 0;
 
     uint8_t diceBufferCounter = 0;
     uint8_t diceBufferPositionWrite = 0;
     uint8_t diceBufferPositionRead = 0;
-    uint8_t tickCounter = 0;
-    uint32_t CRC32 = 0;
-    uint8_t method = 0;
 
-    // MD5
-    md5_context* md5_ctx = malloc(sizeof(md5_context));
-    uint8_t* hash = malloc(sizeof(uint8_t) * 16);
-    uint8_t* bufferTim2 = malloc(4);
-    md5_starts(md5_ctx);
+    EntropyState* entropy = malloc(sizeof(EntropyState));
+    mbedtls_sha256_init(&entropy->sha);
+
+    uint8_t usb = 0;
+    uint8_t usbTxIdle = 1;
+    uint8_t* usbBuffer = malloc(TRNG_CDC_PKT_LEN);
 
     uint8_t pause = 0;
 
@@ -169,7 +393,21 @@ int32_t flipper_atomicdiceroller_app() {
             if(event.type == EventTypeInput) {
                 if(event.input.key == InputKeyBack && event.input.type == InputTypeLong) {
                     break;
-                } else if(pause == 0) {
+                } else if(event.input.key == InputKeyRight && event.input.type == InputTypeLong) {
+                    // Toggle the USB TRNG, the dice are rolled from the pool otherwise
+                    usb = !usb;
+                    if(usb) {
+                        trng_usb_init(event_queue);
+                        usbTxIdle = 1;
+                    } else {
+                        trng_usb_deinit();
+                    }
+                    furi_mutex_acquire(mutexVal.mutex, FuriWaitForever);
+                    mutexVal.usb = usb;
+                    mutexVal.dice = 0;
+                    furi_mutex_release(mutexVal.mutex);
+                    screenRefresh = 1;
+                } else if(pause == 0 && usb == 0) {
                     if(event.input.key == InputKeyOk && event.input.type == InputTypeShort) {
                         if(diceBufferCounter > 0) {
                             furi_mutex_acquire(mutexVal.mutex, FuriWaitForever);
@@ -178,45 +416,15 @@ int32_t flipper_atomicdiceroller_app() {
                             mutexVal.pause = 1;
                             furi_mutex_release(mutexVal.mutex);
 
-                            if(diceBufferPositionRead != 63)
-                                diceBufferPositionRead++;
-                            else
-                                diceBufferPositionRead = 0;
+                            // a die is used once
+                            diceBuffer[diceBufferPositionRead] = 0;
+                            diceBufferPositionRead =
+                                (diceBufferPositionRead + 1) % DICE_BUFFER_SIZE;
 
                             pause = 1;
                             furi_timer_start(timerPause, 500);
                             screenRefresh = 1;
                         }
-                    } else if(event.input.key == InputKeyLeft && event.input.type == InputTypeLong) {
-                        if(method == 1) {
-                            method = 0;
-                            diceBufferPositionWrite = 0;
-                            diceBufferPositionRead = 0;
-                            diceBufferCounter = 0;
-                            CRC32 = 0;
-                            tickCounter = 0;
-                            furi_mutex_acquire(mutexVal.mutex, FuriWaitForever);
-                            mutexVal.method = 0;
-                            mutexVal.dice = 0;
-                            mutexVal.diceAvailiable = 0;
-                            furi_mutex_release(mutexVal.mutex);
-                            screenRefresh = 1;
-                        }
-                    } else if(event.input.key == InputKeyRight && event.input.type == InputTypeLong) {
-                        if(method == 0) {
-                            method = 1;
-                            diceBufferPositionWrite = 0;
-                            diceBufferPositionRead = 0;
-                            diceBufferCounter = 0;
-                            md5_starts(md5_ctx);
-                            tickCounter = 0;
-                            furi_mutex_acquire(mutexVal.mutex, FuriWaitForever);
-                            mutexVal.method = 1;
-                            mutexVal.dice = 0;
-                            mutexVal.diceAvailiable = 0;
-                            furi_mutex_release(mutexVal.mutex);
-                            screenRefresh = 1;
-                        }
                     }
                 }
             } else if(event.type == ClockEventTypeTick) {
@@ -235,99 +443,60 @@ int32_t flipper_atomicdiceroller_app() {
 
                 pause = 0;
                 screenRefresh = 1;
-            } else if(event.type == EventGPIO) {
-                if(diceBufferCounter < 64) {
-                    // CRC32
-                    if(method == 0) {
-                        uint32_t TIM2Tick = TIM2->CNT;
-                        bufferTim2[0] = (uint8_t)(TIM2Tick >> 24);
-                        bufferTim2[1] = (uint8_t)(TIM2Tick >> 16);
-                        bufferTim2[2] = (uint8_t)(TIM2Tick >> 8);
-                        bufferTim2[3] = (uint8_t)TIM2Tick;
-                        CRC32 = crc32_calc_buffer(CRC32, bufferTim2, 4);
-                        tickCounter++;
-
-                        if(tickCounter == 8) {
-                            uint8_t localDice = CRC32 & 0b111;
-
-                            if(localDice == 0 || localDice == 7) {
-                                localDice = (diceBuffer[diceBufferPositionRead] >> 3) & 0b111;
-                            }
-
-                            if(localDice >= 1 && localDice <= 6) {
-                                diceBuffer[diceBufferPositionWrite] = localDice;
-                                diceBufferCounter++;
-                                if(diceBufferPositionWrite != 63)
-                                    diceBufferPositionWrite++;
-                                else
-                                    diceBufferPositionWrite = 0;
-
-                                furi_mutex_acquire(mutexVal.mutex, FuriWaitForever);
-                                mutexVal.diceAvailiable = diceBufferCounter;
-                                furi_mutex_release(mutexVal.mutex);
-
-                                screenRefresh = 1;
-                            }
-
-                            CRC32 = 0;
-                            tickCounter = 0;
-                        }
-                    }
-                    // MD5
-                    else {
-                        uint32_t tick = TIM2->CNT;
-                        bufferTim2[0] = (uint8_t)(tick >> 24);
-                        bufferTim2[1] = (uint8_t)(tick >> 16);
-                        bufferTim2[2] = (uint8_t)(tick >> 8);
-                        bufferTim2[3] = (uint8_t)tick;
-                        md5_update(md5_ctx, bufferTim2, 4);
-
-                        tickCounter++;
-
-                        if(tickCounter == 32) {
-                            md5_finish(md5_ctx, hash);
-                            uint8_t localDice = 0;
-
-                            for(uint8_t i = 0; i < 16; i++) {
-                                localDice = hash[i] & 0b111;
-                                if(localDice >= 1 && localDice <= 6) {
-                                    diceBuffer[diceBufferPositionWrite] = localDice;
-                                    diceBufferCounter++;
-                                    if(diceBufferPositionWrite != 63)
-                                        diceBufferPositionWrite++;
-                                    else
-                                        diceBufferPositionWrite = 0;
-
-                                    furi_mutex_acquire(mutexVal.mutex, FuriWaitForever);
-                                    mutexVal.diceAvailiable = diceBufferCounter;
-                                    furi_mutex_release(mutexVal.mutex);
-
-                                    screenRefresh = 1;
-                                    break;
-                                }
-                            }
-
-                            md5_starts(md5_ctx);
-                            tickCounter = 0;
-                        }
-                    }
-                }
+            } else if(event.type == EventUsbTx) {
+                usbTxIdle = 1;
+            } else if(event.type == EventUsbLine) {
+                // a new connection, a transfer pending on the old one will never complete
+                usbTxIdle = 1;
+            }
+        }
+
+        // Drain the pulses captured by the interrupt
+        while(ring->tail != ring->head) {
+            uint32_t timestamp = ring->timestamps[ring->tail & (PULSE_RING_SIZE - 1)];
+            ring->tail++;
+            counter++;
+            if(entropy_add_pulse(entropy, timestamp)) screenRefresh = 1;
+        }
+
+        // Fill the dice buffer from the pool
+        while(usb == 0 && diceBufferCounter < DICE_BUFFER_SIZE) {
+            uint8_t localDice = entropy_roll_die(entropy);
+            if(localDice == 0) break;
 
-                counter++;
+            diceBuffer[diceBufferPositionWrite] = localDice;
+            diceBufferCounter++;
+            diceBufferPositionWrite = (diceBufferPositionWrite + 1) % DICE_BUFFER_SIZE;
+            screenRefresh = 1;
+        }
+
+        // Stream the pool to the host
+        if(usb == 1 && usbTxIdle == 1 &&
+           (furi_hal_cdc_get_ctrl_line_state(TRNG_CDC_CH) & CdcCtrlLineDTR)) {
+            uint16_t len = entropy_take_bytes(entropy, usbBuffer, TRNG_CDC_PKT_LEN);
+            if(len > 0) {
+                usbTxIdle = 0;
+                furi_hal_cdc_send(TRNG_CDC_CH, usbBuffer, len);
+                memset(usbBuffer, 0, TRNG_CDC_PKT_LEN);
+                screenRefresh = 1;
             }
         }
 
-        if(screenRefresh == 1) view_port_update(view_port);
+        if(screenRefresh == 1) {
+            furi_mutex_acquire(mutexVal.mutex, FuriWaitForever);
+            mutexVal.diceAvailiable = diceBufferCounter;
+            mutexVal.healthFailures = entropy->failures;
+            mutexVal.poolBytes = entropy->poolCount;
+            furi_mutex_release(mutexVal.mutex);
+
+            view_port_update(view_port);
+        }
     }
 
     LL_TIM_DisableCounter(TIM2);
     furi_hal_bus_disable(FuriHalBusTIM2);
 
-    free(md5_ctx);
-    free(bufferTim2);
-    free(hash);
-
-    furi_record_close(RECORD_NOTIFICATION);
+    if(usb) trng_usb_deinit();
 
     // Disable 5v power
     if(furi_hal_power_is_otg_enabled()) {
@@ -337,6 +506,12 @@ int32_t flipper_atomicdiceroller_app() {
     furi_hal_gpio_disable_int_callback(&gpio_ext_pa7);
     furi_hal_gpio_remove_int_callback(&gpio_ext_pa7);
 
+    mbedtls_sha256_free(&entropy->sha);
+    memset(entropy, 0, sizeof(EntropyState));
+    free(entropy);
+    free(usbBuffer);
+    free(ring);
+
     furi_message_queue_free(event_queue);
     furi_mutex_free(mutexVal.mutex);
     gui_remove_view_port(gui, view_port);
@@ -346,4 +521,4 @@ int32_t flipper_atomicdiceroller_app() {
     furi_record_close(RECORD_GUI);
 
     return 0;
-}
\ No newline at end of file
+}
@@ -7,8 +7,15 @@
 #define AVR_ISP_PROG_TX_RX_BUF_SIZE 320
 #define TAG "AvrIsp"
 
+// Flash words per batched SPI transfer, every word is two 4 byte commands
+#define AVR_ISP_SPI_BATCH_WORDS 32
+#define AVR_ISP_SPI_BATCH_SIZE (AVR_ISP_SPI_BATCH_WORDS * 8)
+#define AVR_ISP_FLASH_TIMEOUT 30
+
 struct AvrIsp {
     AvrIspSpiSw* spi;
+    uint8_t spi_tx[AVR_ISP_SPI_BATCH_SIZE];
+    uint8_t spi_rx[AVR_ISP_SPI_BATCH_SIZE];
     bool pmode;
     AvrIspCallback callback;
     void* context;
@@ -48,6 +55,14 @@ uint8_t avr_isp_spi_transaction(
     return avr_isp_spi_sw_txrx(instance->spi, data);
 }
 
+// Put a 4 byte command at cmd, the same layout as the AVR_ISP_* macros
+static void avr_isp_set_cmd(uint8_t* cmd, uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+    cmd[0] = a;
+    cmd[1] = b;
+    cmd[2] = c;
+    cmd[3] = d;
+}
+
 static bool avr_isp_set_pmode(AvrIsp* instance, uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
     furi_assert(instance);
 
@@ -116,10 +131,12 @@ static bool avr_isp_start_pmode(AvrIsp* instance, AvrIspSpiSwSpeed spi_speed) {
 bool avr_isp_auto_set_spi_speed_start_pmode(AvrIsp* instance) {
     furi_assert(instance);
 
+    // fastest first, hardware SPI down to 250 kHz and bit-banging below that
     AvrIspSpiSwSpeed spi_speed[] = {
-        AvrIspSpiSwSpeed1Mhz,
-        AvrIspSpiSwSpeed400Khz,
-        AvrIspSpiSwSpeed250Khz,
+        AvrIspSpiSwSpeedHw2Mhz,
+        AvrIspSpiSwSpeedHw1Mhz,
+        AvrIspSpiSwSpeedHw500Khz,
+        AvrIspSpiSwSpeedHw250Khz,
         AvrIspSpiSwSpeed125Khz,
         AvrIspSpiSwSpeed60Khz,
         AvrIspSpiSwSpeed40Khz,
@@ -141,7 +158,7 @@ bool avr_isp_auto_set_spi_speed_start_pmode(AvrIsp* instance) {
                 y++;
             }
             if(y == 8) {
-                if(spi_speed[i] > AvrIspSpiSwSpeed1Mhz) {
+                if(i > 0) { // not stable at full speed, keep one step of margin
                     if(i < (COUNT_OF(spi_speed) - 1)) {
                         avr_isp_end_pmode(instance);
                         i++;
@@ -161,12 +178,19 @@ bool avr_isp_auto_set_spi_speed_start_pmode(AvrIsp* instance) {
     return false;
 }
 
-static void avr_isp_commit(AvrIsp* instance, uint16_t addr, uint8_t data) {
+static void avr_isp_commit(AvrIsp* instance, uint16_t addr, uint8_t data, bool ready_busy) {
     furi_assert(instance);
 
     avr_isp_spi_transaction(instance, AVR_ISP_COMMIT(addr));
-    /* polling flash */
-    if(data == 0xFF) {
+    if(ready_busy) {
+        /* polling RDY/BSY, paged AVRs are ready long before the timeout */
+        uint32_t starttime = furi_get_tick();
+        while((furi_get_tick() - starttime) < AVR_ISP_FLASH_TIMEOUT) {
+            if(!(avr_isp_spi_transaction(instance, AVR_ISP_POLL_READY) &
+                 AVR_ISP_READY_BUSY_MASK))
+                break;
+        }
+    } else if(data == 0xFF) {
         furi_delay_ms(5);
     } else {
         /* polling flash */
@@ -214,18 +238,31 @@ static bool avr_isp_flash_write_pages(
     furi_assert(instance);
 
     size_t x = 0;
+    size_t batch = 0;
     uint16_t page = avr_isp_current_page(instance, addr, page_size);
+    // every paged part supports RDY/BSY polling, see avr_isp_current_page()
+    bool ready_busy = (page_size >= 32 && page_size <= 256);
 
     while(x < data_size) {
         if(page != avr_isp_current_page(instance, addr, page_size)) {
-            avr_isp_commit(instance, page, data[x - 1]);
+            avr_isp_spi_sw_txrx_buf(instance->spi, instance->spi_tx, NULL, batch);
+            batch = 0;
+            avr_isp_commit(instance, page, data[x - 1], ready_busy);
             page = avr_isp_current_page(instance, addr, page_size);
         }
-        avr_isp_spi_transaction(instance, AVR_ISP_WRITE_FLASH_LO(addr, data[x++]));
-        avr_isp_spi_transaction(instance, AVR_ISP_WRITE_FLASH_HI(addr, data[x++]));
+        // the page buffer is loaded by one transfer per batch instead of one per byte
+        avr_isp_set_cmd(&instance->spi_tx[batch], AVR_ISP_WRITE_FLASH_LO(addr, data[x]));
+        avr_isp_set_cmd(&instance->spi_tx[batch + 4], AVR_ISP_WRITE_FLASH_HI(addr, data[x + 1]));
+        batch += 8;
+        x += 2;
         addr++;
+        if(batch == AVR_ISP_SPI_BATCH_SIZE) {
+            avr_isp_spi_sw_txrx_buf(instance->spi, instance->spi_tx, NULL, batch);
+            batch = 0;
+        }
     }
-    avr_isp_commit(instance, page, data[x - 1]);
+    avr_isp_spi_sw_txrx_buf(instance->spi, instance->spi_tx, NULL, batch);
+    avr_isp_commit(instance, page, data[x - 1], ready_busy);
     return true;
 }
 
@@ -296,10 +333,20 @@ static bool avr_isp_flash_read_page(
     furi_assert(instance);
 
     if(page_size > data_size) return false;
-    for(uint16_t i = 0; i < page_size; i += 2) {
-        data[i] = avr_isp_spi_transaction(instance, AVR_ISP_READ_FLASH_LO(addr));
-        data[i + 1] = avr_isp_spi_transaction(instance, AVR_ISP_READ_FLASH_HI(addr));
-        addr++;
+    uint16_t x = 0;
+    while(x < page_size) {
+        size_t words = MIN((size_t)AVR_ISP_SPI_BATCH_WORDS, (size_t)(page_size - x + 1) / 2);
+        for(size_t i = 0; i < words; i++) {
+            uint16_t word_addr = addr + i;
+            avr_isp_set_cmd(&instance->spi_tx[i * 8], AVR_ISP_READ_FLASH_LO(word_addr));
+            avr_isp_set_cmd(&instance->spi_tx[i * 8 + 4], AVR_ISP_READ_FLASH_HI(word_addr));
+        }
+        avr_isp_spi_sw_txrx_buf(instance->spi, instance->spi_tx, instance->spi_rx, words * 8);
+        // the answer is the last byte of every command
+        for(size_t i = 0; i < words * 2 && x < page_size; i++) {
+            data[x++] = instance->spi_rx[i * 4 + 3];
+        }
+        addr += words;
     }
     return true;
 }
@@ -7,6 +7,7 @@
 
 #include "flipper_i32hex_file.h"
 #include <flipper_format/flipper_format.h>
+#include <storage/storage.h>
 
 #include <furi.h>
 
@@ -14,6 +15,9 @@
 
 #define NAME_PATERN_FLASH_FILE "flash.hex"
 #define NAME_PATERN_EEPROM_FILE "eeprom.hex"
+// Raw images saved next to the HEX files, verification compares pages against them directly
+#define NAME_PATERN_FLASH_BIN_FILE "flash.bin"
+#define NAME_PATERN_EEPROM_BIN_FILE "eeprom.bin"
 
 struct AvrIspWorkerRW {
     AvrIsp* avr_isp;
@@ -319,7 +323,33 @@ float avr_isp_worker_rw_get_progress_eeprom(AvrIspWorkerRW* instance) {
     return instance->progress_eeprom;
 }
 
-static void avr_isp_worker_rw_get_dump_flash(AvrIspWorkerRW* instance, const char* file_path) {
+static File* avr_isp_worker_rw_open_bin_write(Storage* storage, const char* file_path) {
+    File* file = storage_file_alloc(storage);
+    if(!storage_file_open(file, file_path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        FURI_LOG_E(TAG, "Failed to open file %s", file_path);
+        storage_file_free(file);
+        file = NULL;
+    }
+    return file;
+}
+
+static void avr_isp_worker_rw_bin_write(File* file, const uint8_t* data, size_t size) {
+    if(file && storage_file_write(file, data, size) != size) {
+        FURI_LOG_E(TAG, "Failed to write raw dump");
+    }
+}
+
+static void avr_isp_worker_rw_bin_close(File* file) {
+    if(file) {
+        storage_file_close(file);
+        storage_file_free(file);
+    }
+}
+
+static void avr_isp_worker_rw_get_dump_flash(
+    AvrIspWorkerRW* instance,
+    const char* file_path,
+    const char* bin_file_path) {
     furi_assert(instance);
     furi_check(instance->avr_isp);
 
@@ -327,6 +357,8 @@ static void avr_isp_worker_rw_get_dump_flash(AvrIspWorkerRW* instance, const cha
 
     FlipperI32HexFile* flipper_hex_flash = flipper_i32hex_file_open_write(
         file_path, avr_isp_chip_arr[instance->chip_arr_ind].flashoffset);
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* bin_file = avr_isp_worker_rw_open_bin_write(storage, bin_file_path);
 
     uint8_t data[272] = {0};
     bool send_extended_addr = ((avr_isp_chip_arr[instance->chip_arr_ind].flashsize / 2) > 0x10000);
@@ -350,17 +382,22 @@ static void avr_isp_worker_rw_get_dump_flash(AvrIspWorkerRW* instance, const cha
             sizeof(data));
         flipper_i32hex_file_bin_to_i32hex_set_data(
             flipper_hex_flash, data, avr_isp_chip_arr[instance->chip_arr_ind].pagesize);
-        FURI_LOG_D(TAG, "%s", flipper_i32hex_file_get_string(flipper_hex_flash));
+        avr_isp_worker_rw_bin_write(
+            bin_file, data, avr_isp_chip_arr[instance->chip_arr_ind].pagesize);
         instance->progress_flash =
             (float)(i) / ((float)avr_isp_chip_arr[instance->chip_arr_ind].flashsize / 2.0f);
     }
     flipper_i32hex_file_bin_to_i32hex_set_end_line(flipper_hex_flash);
-    FURI_LOG_D(TAG, "%s", flipper_i32hex_file_get_string(flipper_hex_flash));
     flipper_i32hex_file_close(flipper_hex_flash);
+    avr_isp_worker_rw_bin_close(bin_file);
+    furi_record_close(RECORD_STORAGE);
     instance->progress_flash = 1.0f;
 }
 
-static void avr_isp_worker_rw_get_dump_eeprom(AvrIspWorkerRW* instance, const char* file_path) {
+static void avr_isp_worker_rw_get_dump_eeprom(
+    AvrIspWorkerRW* instance,
+    const char* file_path,
+    const char* bin_file_path) {
     furi_assert(instance);
     furi_check(instance->avr_isp);
 
@@ -368,6 +405,8 @@ static void avr_isp_worker_rw_get_dump_eeprom(AvrIspWorkerRW* instance, const ch
 
     FlipperI32HexFile* flipper_hex_eeprom = flipper_i32hex_file_open_write(
         file_path, avr_isp_chip_arr[instance->chip_arr_ind].eepromoffset);
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* bin_file = avr_isp_worker_rw_open_bin_write(storage, bin_file_path);
 
     int32_t size_data = 32;
     uint8_t data[256] = {0};
@@ -381,13 +420,14 @@ static void avr_isp_worker_rw_get_dump_eeprom(AvrIspWorkerRW* instance, const ch
         avr_isp_read_page(
             instance->avr_isp, STK_SET_EEPROM_TYPE, (uint16_t)i, size_data, data, sizeof(data));
         flipper_i32hex_file_bin_to_i32hex_set_data(flipper_hex_eeprom, data, size_data);
-        FURI_LOG_D(TAG, "%s", flipper_i32hex_file_get_string(flipper_hex_eeprom));
+        avr_isp_worker_rw_bin_write(bin_file, data, size_data);
         instance->progress_eeprom =
             (float)(i) / ((float)avr_isp_chip_arr[instance->chip_arr_ind].eepromsize);
     }
     flipper_i32hex_file_bin_to_i32hex_set_end_line(flipper_hex_eeprom);
-    FURI_LOG_D(TAG, "%s", flipper_i32hex_file_get_string(flipper_hex_eeprom));
     flipper_i32hex_file_close(flipper_hex_eeprom);
+    avr_isp_worker_rw_bin_close(bin_file);
+    furi_record_close(RECORD_STORAGE);
     instance->progress_eeprom = 1.0f;
 }
 
@@ -407,6 +447,7 @@ bool avr_isp_worker_rw_read_dump(
     Storage* storage = furi_record_open(RECORD_STORAGE);
     FlipperFormat* flipper_format = flipper_format_file_alloc(storage);
     FuriString* file_path_name = furi_string_alloc();
+    FuriString* bin_file_path_name = furi_string_alloc();
 
     if(!avr_isp_worker_rw_detect_chip(instance)) {
         FURI_LOG_E(TAG, "No detect AVR chip");
@@ -490,12 +531,26 @@ bool avr_isp_worker_rw_read_dump(
             //Dump flash
             furi_string_printf(
                 file_path_name, "%s/%s_%s", file_path, file_name, NAME_PATERN_FLASH_FILE);
-            avr_isp_worker_rw_get_dump_flash(instance, furi_string_get_cstr(file_path_name));
+            furi_string_printf(
+                bin_file_path_name, "%s/%s_%s", file_path, file_name, NAME_PATERN_FLASH_BIN_FILE);
+            avr_isp_worker_rw_get_dump_flash(
+                instance,
+                furi_string_get_cstr(file_path_name),
+                furi_string_get_cstr(bin_file_path_name));
             //Dump eeprom
             if(avr_isp_chip_arr[instance->chip_arr_ind].eepromsize > 0) {
                 furi_string_printf(
                     file_path_name, "%s/%s_%s", file_path, file_name, NAME_PATERN_EEPROM_FILE);
-                avr_isp_worker_rw_get_dump_eeprom(instance, furi_string_get_cstr(file_path_name));
+                furi_string_printf(
+                    bin_file_path_name,
+                    "%s/%s_%s",
+                    file_path,
+                    file_name,
+                    NAME_PATERN_EEPROM_BIN_FILE);
+                avr_isp_worker_rw_get_dump_eeprom(
+                    instance,
+                    furi_string_get_cstr(file_path_name),
+                    furi_string_get_cstr(bin_file_path_name));
             }
 
             avr_isp_end_pmode(instance->avr_isp);
@@ -503,6 +558,7 @@ bool avr_isp_worker_rw_read_dump(
     }
 
     furi_string_free(file_path_name);
+    furi_string_free(bin_file_path_name);
 
     return true;
 }
@@ -518,6 +574,121 @@ void avr_isp_worker_rw_read_dump_start(
     furi_thread_flags_set(furi_thread_get_id(instance->thread), AvrIspWorkerRWEvtReading);
 }
 
+static void avr_isp_worker_rw_verification_log_error(
+    const char* mem_name,
+    uint32_t addr,
+    const uint8_t* data_file,
+    const uint8_t* data_chip,
+    size_t size) {
+    FURI_LOG_E(TAG, "Verification %s error", mem_name);
+    FURI_LOG_E(TAG, "Addr: 0x%04lX", addr);
+    for(size_t i = 0; i < size; i++) {
+        FURI_LOG_RAW_E("%02X ", data_file[i]);
+    }
+    FURI_LOG_RAW_E("\r\n");
+    for(size_t i = 0; i < size; i++) {
+        FURI_LOG_RAW_E("%02X ", data_chip[i]);
+    }
+    FURI_LOG_RAW_E("\r\n");
+}
+
+static bool
+    avr_isp_worker_rw_verification_flash_bin(AvrIspWorkerRW* instance, const char* file_path) {
+    furi_assert(instance);
+    furi_assert(file_path);
+
+    FURI_LOG_D(TAG, "Verification flash %s", file_path);
+
+    instance->progress_flash = 0.0;
+    const AvrIspChipArr* chip = &avr_isp_chip_arr[instance->chip_arr_ind];
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+
+    uint8_t data_read_flash[272] = {0};
+    uint8_t data_read_file[272] = {0};
+    bool send_extended_addr = ((chip->flashsize / 2) > 0x10000);
+    uint8_t extended_addr = 0;
+    size_t page_size = MIN((size_t)chip->pagesize, sizeof(data_read_file));
+
+    bool ret = storage_file_open(file, file_path, FSAM_READ, FSOM_OPEN_EXISTING);
+    for(int32_t i = chip->flashoffset; ret && (i < chip->flashsize / 2); i += page_size / 2) {
+        size_t size = storage_file_read(file, data_read_file, page_size);
+        if(size == 0) break;
+        if(send_extended_addr) {
+            if(extended_addr <= ((i >> 16) & 0xFF)) {
+                avr_isp_write_extended_addr(instance->avr_isp, extended_addr);
+                extended_addr = ((i >> 16) & 0xFF) + 1;
+            }
+        }
+        avr_isp_read_page(
+            instance->avr_isp,
+            STK_SET_FLASH_TYPE,
+            (uint16_t)i,
+            size,
+            data_read_flash,
+            sizeof(data_read_flash));
+
+        if(memcmp(data_read_file, data_read_flash, size) != 0) {
+            ret = false;
+            avr_isp_worker_rw_verification_log_error(
+                "flash", i, data_read_file, data_read_flash, size);
+        }
+        instance->progress_flash = (float)(i) / ((float)chip->flashsize / 2.0f);
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    instance->progress_flash = 1.0f;
+
+    return ret;
+}
+
+static bool
+    avr_isp_worker_rw_verification_eeprom_bin(AvrIspWorkerRW* instance, const char* file_path) {
+    furi_assert(instance);
+    furi_assert(file_path);
+
+    FURI_LOG_D(TAG, "Verification eeprom %s", file_path);
+
+    instance->progress_eeprom = 0.0;
+    const AvrIspChipArr* chip = &avr_isp_chip_arr[instance->chip_arr_ind];
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+
+    uint8_t data_read_eeprom[256] = {0};
+    uint8_t data_read_file[256] = {0};
+    int32_t size_data = 32;
+    if(size_data > chip->eepromsize) size_data = chip->eepromsize;
+
+    bool ret = storage_file_open(file, file_path, FSAM_READ, FSOM_OPEN_EXISTING);
+    for(int32_t i = chip->eepromoffset; ret && (i < chip->eepromsize); i += size_data) {
+        size_t size = storage_file_read(file, data_read_file, size_data);
+        if(size == 0) break;
+        avr_isp_read_page(
+            instance->avr_isp,
+            STK_SET_EEPROM_TYPE,
+            (uint16_t)i,
+            size,
+            data_read_eeprom,
+            sizeof(data_read_eeprom));
+
+        if(memcmp(data_read_file, data_read_eeprom, size) != 0) {
+            ret = false;
+            avr_isp_worker_rw_verification_log_error(
+                "eeprom", i, data_read_file, data_read_eeprom, size);
+        }
+        instance->progress_eeprom = (float)(i) / ((float)chip->eepromsize);
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    instance->progress_eeprom = 1.0f;
+
+    return ret;
+}
+
 static bool avr_isp_worker_rw_verification_flash(AvrIspWorkerRW* instance, const char* file_path) {
     furi_assert(instance);
     furi_assert(file_path);
@@ -683,30 +854,48 @@ bool avr_isp_worker_rw_verification(
     instance->progress_flash = 0.0f;
     instance->progress_eeprom = 0.0f;
     FuriString* file_path_name = furi_string_alloc();
+    Storage* storage = furi_record_open(RECORD_STORAGE);
 
     bool ret = false;
 
     if(avr_isp_auto_set_spi_speed_start_pmode(instance->avr_isp)) {
         do {
+            //Dumps made before the raw images were added only have the HEX files
             furi_string_printf(
-                file_path_name, "%s/%s_%s", file_path, file_name, NAME_PATERN_FLASH_FILE);
-            if(!avr_isp_worker_rw_verification_flash(
-                   instance, furi_string_get_cstr(file_path_name)))
-                break;
-
-            if(avr_isp_chip_arr[instance->chip_arr_ind].eepromsize > 0) {
+                file_path_name, "%s/%s_%s", file_path, file_name, NAME_PATERN_FLASH_BIN_FILE);
+            if(storage_file_exists(storage, furi_string_get_cstr(file_path_name))) {
+                if(!avr_isp_worker_rw_verification_flash_bin(
+                       instance, furi_string_get_cstr(file_path_name)))
+                    break;
+            } else {
                 furi_string_printf(
-                    file_path_name, "%s/%s_%s", file_path, file_name, NAME_PATERN_EEPROM_FILE);
-
-                if(!avr_isp_worker_rw_verification_eeprom(
+                    file_path_name, "%s/%s_%s", file_path, file_name, NAME_PATERN_FLASH_FILE);
+                if(!avr_isp_worker_rw_verification_flash(
                        instance, furi_string_get_cstr(file_path_name)))
                     break;
             }
+
+            if(avr_isp_chip_arr[instance->chip_arr_ind].eepromsize > 0) {
+                furi_string_printf(
+                    file_path_name, "%s/%s_%s", file_path, file_name, NAME_PATERN_EEPROM_BIN_FILE);
+                if(storage_file_exists(storage, furi_string_get_cstr(file_path_name))) {
+                    if(!avr_isp_worker_rw_verification_eeprom_bin(
+                           instance, furi_string_get_cstr(file_path_name)))
+                        break;
+                } else {
+                    furi_string_printf(
+                        file_path_name, "%s/%s_%s", file_path, file_name, NAME_PATERN_EEPROM_FILE);
+                    if(!avr_isp_worker_rw_verification_eeprom(
+                           instance, furi_string_get_cstr(file_path_name)))
+                        break;
+                }
+            }
             ret = true;
         } while(false);
         avr_isp_end_pmode(instance->avr_isp);
-        furi_string_free(file_path_name);
     }
+    furi_record_close(RECORD_STORAGE);
+    furi_string_free(file_path_name);
     return ret;
 }
 
@@ -16,6 +16,10 @@
 #define I32HEX_TYPE_EXT_LINEAR_ADDR 0x04
 #define I32HEX_TYPE_START_LINEAR_ADDR 0x05
 
+// ':' + count, address, type, data and crc as hex + "\r\n"
+#define I32HEX_RECORD_MAX_SIZE (1 + (5 + COUNT_BYTE_PAYLOAD) * 2 + 2)
+#define WRITE_BUFFER_SIZE 1024 //records are encoded here and written in big chunks
+
 struct FlipperI32HexFile {
     uint32_t addr;
     uint32_t addr_last;
@@ -23,8 +27,57 @@ struct FlipperI32HexFile {
     Stream* stream;
     FuriString* str_data;
     FlipperI32HexFileStatus file_open;
+    char* write_buffer;
+    size_t write_buffer_len;
+    bool write_error;
 };
 
+static bool flipper_i32hex_file_flush(FlipperI32HexFile* instance) {
+    if(instance->write_buffer_len) {
+        if(stream_write(
+               instance->stream, (uint8_t*)instance->write_buffer, instance->write_buffer_len) !=
+           instance->write_buffer_len) {
+            instance->write_error = true;
+        }
+        instance->write_buffer_len = 0;
+    }
+    return !instance->write_error;
+}
+
+static char* flipper_i32hex_file_put_byte(char* str, uint8_t byte) {
+    static const char hex[] = "0123456789ABCDEF";
+    *str++ = hex[byte >> 4];
+    *str++ = hex[byte & 0x0F];
+    return str;
+}
+
+static void flipper_i32hex_file_put_record(
+    FlipperI32HexFile* instance,
+    uint8_t type,
+    uint16_t addr,
+    const uint8_t* data,
+    uint8_t data_size) {
+    if(instance->write_buffer_len + I32HEX_RECORD_MAX_SIZE > WRITE_BUFFER_SIZE) {
+        flipper_i32hex_file_flush(instance);
+    }
+    char* str = &instance->write_buffer[instance->write_buffer_len];
+    uint8_t crc = data_size + (addr >> 8) + (addr & 0xFF) + type;
+
+    *str++ = ':';
+    str = flipper_i32hex_file_put_byte(str, data_size);
+    str = flipper_i32hex_file_put_byte(str, addr >> 8);
+    str = flipper_i32hex_file_put_byte(str, addr & 0xFF);
+    str = flipper_i32hex_file_put_byte(str, type);
+    for(uint8_t i = 0; i < data_size; i++) {
+        str = flipper_i32hex_file_put_byte(str, data[i]);
+        crc += data[i];
+    }
+    str = flipper_i32hex_file_put_byte(str, 0x01 + ~crc);
+    *str++ = '\r';
+    *str++ = '\n';
+    instance->write_buffer_len = str - instance->write_buffer;
+}
+
 FlipperI32HexFile* flipper_i32hex_file_open_write(const char* name, uint32_t start_addr) {
     furi_assert(name);
 
@@ -33,6 +86,9 @@ FlipperI32HexFile* flipper_i32hex_file_open_write(const char* name, uint32_t sta
     instance->addr_last = 0;
     instance->storage = furi_record_open(RECORD_STORAGE);
     instance->stream = file_stream_alloc(instance->storage);
+    instance->write_buffer = malloc(WRITE_BUFFER_SIZE);
+    instance->write_buffer_len = 0;
+    instance->write_error = false;
 
     if(file_stream_open(instance->stream, name, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
         instance->file_open = FlipperI32HexFileStatusOpenFileWrite;
@@ -54,6 +110,7 @@ FlipperI32HexFile* flipper_i32hex_file_open_read(const char* name) {
     instance->addr_last = 0;
     instance->storage = furi_record_open(RECORD_STORAGE);
     instance->stream = file_stream_alloc(instance->storage);
+    instance->write_buffer = NULL;
 
     if(file_stream_open(instance->stream, name, FSAM_READ, FSOM_OPEN_EXISTING)) {
         instance->file_open = FlipperI32HexFileStatusOpenFileRead;
@@ -70,10 +127,17 @@ FlipperI32HexFile* flipper_i32hex_file_open_read(const char* name) {
 void flipper_i32hex_file_close(FlipperI32HexFile* instance) {
     furi_assert(instance);
 
+    if(instance->write_buffer) {
+        if(instance->file_open == FlipperI32HexFileStatusOpenFileWrite) {
+            flipper_i32hex_file_flush(instance);
+        }
+        free(instance->write_buffer);
+    }
     furi_string_free(instance->str_data);
     file_stream_close(instance->stream);
     stream_free(instance->stream);
     furi_record_close(RECORD_STORAGE);
+    free(instance);
 }
 
 FlipperI32HexFileRet flipper_i32hex_file_bin_to_i32hex_set_data(
@@ -86,19 +150,15 @@ FlipperI32HexFileRet flipper_i32hex_file_bin_to_i32hex_set_data(
     FlipperI32HexFileRet ret = {.status = FlipperI32HexFileStatusOK, .data_size = 0};
     if(instance->file_open != FlipperI32HexFileStatusOpenFileWrite) {
         ret.status = FlipperI32HexFileStatusErrorFileWrite;
+        return ret;
     }
     uint8_t count_byte = 0;
     uint32_t ind = 0;
-    uint8_t crc = 0;
-
-    furi_string_reset(instance->str_data);
 
     if((instance->addr_last & 0xFF0000) < (instance->addr & 0xFF0000)) {
-        crc = 0x02 + 0x04 + ((instance->addr >> 24) & 0xFF) + ((instance->addr >> 16) & 0xFF);
-        crc = 0x01 + ~crc;
-        //I32HEX_TYPE_EXT_LINEAR_ADDR
-        furi_string_cat_printf(
-            instance->str_data, ":02000004%04lX%02X\r\n", (instance->addr >> 16), crc);
+        uint8_t ext_addr[2] = {(instance->addr >> 24) & 0xFF, (instance->addr >> 16) & 0xFF};
+        flipper_i32hex_file_put_record(
+            instance, I32HEX_TYPE_EXT_LINEAR_ADDR, 0, ext_addr, sizeof(ext_addr));
         instance->addr_last = instance->addr;
     }
 
@@ -108,22 +168,13 @@ FlipperI32HexFileRet flipper_i32hex_file_bin_to_i32hex_set_data(
         } else {
             count_byte = COUNT_BYTE_PAYLOAD;
         }
-        //I32HEX_TYPE_DATA
-        furi_string_cat_printf(
-            instance->str_data, ":%02X%04lX00", count_byte, (instance->addr & 0xFFFF));
-        crc = count_byte + ((instance->addr >> 8) & 0xFF) + (instance->addr & 0xFF);
-
-        for(uint32_t i = 0; i < count_byte; i++) {
-            furi_string_cat_printf(instance->str_data, "%02X", *data);
-            crc += *data++;
-        }
-        crc = 0x01 + ~crc;
-        furi_string_cat_printf(instance->str_data, "%02X\r\n", crc);
-
+        flipper_i32hex_file_put_record(
+            instance, I32HEX_TYPE_DATA, instance->addr & 0xFFFF, &data[ind], count_byte);
         ind += count_byte;
         instance->addr += count_byte;
     }
-    if(instance->file_open) stream_write_string(instance->stream, instance->str_data);
+    if(instance->write_error) ret.status = FlipperI32HexFileStatusErrorFileWrite;
+    ret.data_size = data_size;
     return ret;
 }
 
@@ -133,11 +184,10 @@ FlipperI32HexFileRet flipper_i32hex_file_bin_to_i32hex_set_end_line(FlipperI32He
     FlipperI32HexFileRet ret = {.status = FlipperI32HexFileStatusOK, .data_size = 0};
     if(instance->file_open != FlipperI32HexFileStatusOpenFileWrite) {
         ret.status = FlipperI32HexFileStatusErrorFileWrite;
+        return ret;
     }
-    furi_string_reset(instance->str_data);
-    //I32HEX_TYPE_END_OF_FILE
-    furi_string_cat_printf(instance->str_data, ":00000001FF\r\n");
-    if(instance->file_open) stream_write_string(instance->stream, instance->str_data);
+    flipper_i32hex_file_put_record(instance, I32HEX_TYPE_END_OF_FILE, 0, NULL, 0);
+    if(!flipper_i32hex_file_flush(instance)) ret.status = FlipperI32HexFileStatusErrorFileWrite;
     return ret;
 }
 
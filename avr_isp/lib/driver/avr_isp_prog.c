@@ -4,6 +4,10 @@
 #include <furi.h>
 
 #define AVR_ISP_PROG_TX_RX_BUF_SIZE 320
+// Flash words per batched SPI transfer, every word is two 4 byte commands
+#define AVR_ISP_PROG_SPI_BATCH_WORDS 32
+#define AVR_ISP_PROG_SPI_BATCH_SIZE (AVR_ISP_PROG_SPI_BATCH_WORDS * 8)
+#define AVR_ISP_PROG_FLASH_TIMEOUT 30
 #define TAG "AvrIspProg"
 
 struct AvrIspProgSignature {
@@ -44,6 +48,8 @@ struct AvrIspProg {
     bool exit;
     bool rst_active_high;
     uint8_t buff[AVR_ISP_PROG_TX_RX_BUF_SIZE];
+    uint8_t spi_tx[AVR_ISP_PROG_SPI_BATCH_SIZE];
+    uint8_t spi_rx[AVR_ISP_PROG_SPI_BATCH_SIZE];
 
     AvrIspProgCallback callback;
     void* context;
@@ -141,6 +147,14 @@ static uint8_t avr_isp_prog_spi_transaction(
     return avr_isp_spi_sw_txrx(instance->spi, data);
 }
 
+// Put a 4 byte command at cmd, the same layout as the AVR_ISP_* macros
+static void avr_isp_prog_set_cmd(uint8_t* cmd, uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+    cmd[0] = a;
+    cmd[1] = b;
+    cmd[2] = c;
+    cmd[3] = d;
+}
+
 static void avr_isp_prog_empty_reply(AvrIspProg* instance) {
     furi_assert(instance);
     if(avr_isp_prog_getch(instance) == CRC_EOP) {
@@ -280,10 +294,12 @@ static AvrIspProgSignature avr_isp_prog_check_signature(AvrIspProg* instance) {
 }
 
 static bool avr_isp_prog_auto_set_spi_speed_start_pmode(AvrIspProg* instance) {
+    // fastest first, hardware SPI down to 250 kHz and bit-banging below that
     AvrIspSpiSwSpeed spi_speed[] = {
-        AvrIspSpiSwSpeed1Mhz,
-        AvrIspSpiSwSpeed400Khz,
-        AvrIspSpiSwSpeed250Khz,
+        AvrIspSpiSwSpeedHw2Mhz,
+        AvrIspSpiSwSpeedHw1Mhz,
+        AvrIspSpiSwSpeedHw500Khz,
+        AvrIspSpiSwSpeedHw250Khz,
         AvrIspSpiSwSpeed125Khz,
         AvrIspSpiSwSpeed60Khz,
         AvrIspSpiSwSpeed40Khz,
@@ -306,7 +322,7 @@ static bool avr_isp_prog_auto_set_spi_speed_start_pmode(AvrIspProg* instance) {
                 y++;
             }
             if(y == 8) {
-                if(spi_speed[i] > AvrIspSpiSwSpeed1Mhz) {
+                if(i > 0) { // not stable at full speed, keep one step of margin
                     if(i < (COUNT_OF(spi_speed) - 1)) {
                         avr_isp_prog_end_pmode(instance);
                         i++;
@@ -339,8 +355,15 @@ static void avr_isp_prog_universal(AvrIspProg* instance) {
 static void avr_isp_prog_commit(AvrIspProg* instance, uint16_t addr, uint8_t data) {
     furi_assert(instance);
     avr_isp_prog_spi_transaction(instance, AVR_ISP_COMMIT(addr));
-    /* polling flash */
-    if(data == 0xFF) {
+    if(instance->cfg->polling && !instance->rst_active_high) {
+        /* polling RDY/BSY, paged AVRs are ready long before the timeout */
+        uint32_t starttime = furi_get_tick();
+        while((furi_get_tick() - starttime) < AVR_ISP_PROG_FLASH_TIMEOUT) {
+            if(!(avr_isp_prog_spi_transaction(instance, AVR_ISP_POLL_READY) &
+                 AVR_ISP_READY_BUSY_MASK))
+                break;
+        }
+    } else if(data == 0xFF) {
         furi_delay_ms(5);
     } else {
         /* polling flash */
@@ -381,22 +404,33 @@ static uint16_t avr_isp_prog_current_page(AvrIspProg* instance) {
 static uint8_t avr_isp_prog_write_flash_pages(AvrIspProg* instance, size_t length) {
     furi_assert(instance);
     size_t x = 0;
+    size_t batch = 0;
     uint16_t page = avr_isp_prog_current_page(instance);
     while(x < length) {
         if(page != avr_isp_prog_current_page(instance)) {
-            --x;
-            avr_isp_prog_commit(instance, page, instance->buff[x++]);
+            avr_isp_spi_sw_txrx_buf(instance->spi, instance->spi_tx, NULL, batch);
+            batch = 0;
+            avr_isp_prog_commit(instance, page, instance->buff[x - 1]);
             page = avr_isp_prog_current_page(instance);
         }
-        avr_isp_prog_spi_transaction(
-            instance, AVR_ISP_WRITE_FLASH_LO(instance->addr, instance->buff[x++]));
-
-        avr_isp_prog_spi_transaction(
-            instance, AVR_ISP_WRITE_FLASH_HI(instance->addr, instance->buff[x++]));
+        // the page buffer is loaded by one transfer per batch instead of one per byte
+        avr_isp_prog_set_cmd(
+            &instance->spi_tx[batch],
+            AVR_ISP_WRITE_FLASH_LO(instance->addr, instance->buff[x]));
+        avr_isp_prog_set_cmd(
+            &instance->spi_tx[batch + 4],
+            AVR_ISP_WRITE_FLASH_HI(instance->addr, instance->buff[x + 1]));
+        batch += 8;
+        x += 2;
         instance->addr++;
+        if(batch == AVR_ISP_PROG_SPI_BATCH_SIZE) {
+            avr_isp_spi_sw_txrx_buf(instance->spi, instance->spi_tx, NULL, batch);
+            batch = 0;
+        }
     }
+    avr_isp_spi_sw_txrx_buf(instance->spi, instance->spi_tx, NULL, batch);
 
-    avr_isp_prog_commit(instance, page, instance->buff[--x]);
+    avr_isp_prog_commit(instance, page, instance->buff[x - 1]);
     return STK_OK;
 }
 
@@ -473,14 +507,23 @@ static void avr_isp_prog_program_page(AvrIspProg* instance) {
 
 static uint8_t avr_isp_prog_flash_read_page(AvrIspProg* instance, uint16_t length) {
     furi_assert(instance);
-    for(uint16_t x = 0; x < length; x += 2) {
-        avr_isp_prog_tx_ch(
-            instance,
-            avr_isp_prog_spi_transaction(instance, AVR_ISP_READ_FLASH_LO(instance->addr)));
-        avr_isp_prog_tx_ch(
-            instance,
-            avr_isp_prog_spi_transaction(instance, AVR_ISP_READ_FLASH_HI(instance->addr)));
-        instance->addr++;
+    uint16_t x = 0;
+    while(x < length) {
+        size_t words = MIN((size_t)AVR_ISP_PROG_SPI_BATCH_WORDS, (size_t)(length - x + 1) / 2);
+        for(size_t i = 0; i < words; i++) {
+            uint16_t addr = instance->addr + i;
+            avr_isp_prog_set_cmd(&instance->spi_tx[i * 8], AVR_ISP_READ_FLASH_LO(addr));
+            avr_isp_prog_set_cmd(&instance->spi_tx[i * 8 + 4], AVR_ISP_READ_FLASH_HI(addr));
+        }
+        avr_isp_spi_sw_txrx_buf(instance->spi, instance->spi_tx, instance->spi_rx, words * 8);
+        // the answer is the last byte of every command, reuse spi_tx for the reply
+        for(size_t i = 0; i < words * 2; i++) {
+            instance->spi_tx[i] = instance->spi_rx[i * 4 + 3];
+        }
+        size_t size = MIN(words * 2, (size_t)(length - x));
+        furi_stream_buffer_send(instance->stream_tx, instance->spi_tx, size, FuriWaitForever);
+        x += size;
+        instance->addr += words;
     }
     return STK_OK;
 }
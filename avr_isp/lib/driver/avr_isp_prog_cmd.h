@@ -30,6 +30,9 @@
 #define AVR_ISP_COMMIT(add) \
     0x4C, (add >> 8) & 0xFF, add & 0xFF, 0x00 //Send cmd, polling read last addr page
 
+#define AVR_ISP_POLL_READY 0xF0, 0x00, 0x00, 0x00 //Bit 0 of the answer is 1 while busy
+#define AVR_ISP_READY_BUSY_MASK 0x01
+
 #define AVR_ISP_OSCCAL(add) 0x38, 0x00, add, 0x00
 
 #define AVR_ISP_WRITE_LOCK_BYTE(data) 0xAC, 0xE0, 0x00, data //Send cmd, Wait N ms
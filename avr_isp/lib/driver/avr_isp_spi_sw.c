@@ -1,28 +1,64 @@
 #include "avr_isp_spi_sw.h"
 
 #include <furi.h>
+#include <stm32wbxx_ll_spi.h>
 
 #define AVR_ISP_SPI_SW_MISO &gpio_ext_pa6
 #define AVR_ISP_SPI_SW_MOSI &gpio_ext_pa7
 #define AVR_ISP_SPI_SW_SCK &gpio_ext_pb3
 #define AVR_ISP_RESET &gpio_ext_pb2
 
+#define AVR_ISP_SPI_HW_TIMEOUT 100
+
 struct AvrIspSpiSw {
     AvrIspSpiSwSpeed speed_wait_time;
+    bool hw;
     const GpioPin* miso;
     const GpioPin* mosi;
     const GpioPin* sck;
     const GpioPin* res;
 };
 
+static uint32_t avr_isp_spi_sw_get_prescaler(AvrIspSpiSwSpeed speed) {
+    switch(speed) {
+    case AvrIspSpiSwSpeedHw2Mhz:
+        return LL_SPI_BAUDRATEPRESCALER_DIV32;
+    case AvrIspSpiSwSpeedHw1Mhz:
+        return LL_SPI_BAUDRATEPRESCALER_DIV64;
+    case AvrIspSpiSwSpeedHw500Khz:
+        return LL_SPI_BAUDRATEPRESCALER_DIV128;
+    default:
+        return LL_SPI_BAUDRATEPRESCALER_DIV256;
+    }
+}
+
+// MISO, MOSI and SCK are the SPI1 pins of the external bus. The bus is held
+// until free, its CS (PA4) is driven low meanwhile but is not used by the wiring
+static void avr_isp_spi_sw_hw_init(AvrIspSpiSw* instance) {
+    furi_hal_spi_bus_handle_init(&furi_hal_spi_bus_handle_external);
+    furi_hal_spi_acquire(&furi_hal_spi_bus_handle_external);
+    // acquire applies the 2 MHz mode 0 preset, only the divider changes
+    SPI_TypeDef* spi = furi_hal_spi_bus_handle_external.bus->spi;
+    LL_SPI_Disable(spi);
+    LL_SPI_SetBaudRatePrescaler(spi, avr_isp_spi_sw_get_prescaler(instance->speed_wait_time));
+    LL_SPI_Enable(spi);
+}
+
 AvrIspSpiSw* avr_isp_spi_sw_init(AvrIspSpiSwSpeed speed) {
     AvrIspSpiSw* instance = malloc(sizeof(AvrIspSpiSw));
     instance->speed_wait_time = speed;
+    instance->hw = (speed & AVR_ISP_SPI_SPEED_HW);
     instance->miso = AVR_ISP_SPI_SW_MISO;
     instance->mosi = AVR_ISP_SPI_SW_MOSI;
     instance->sck = AVR_ISP_SPI_SW_SCK;
     instance->res = AVR_ISP_RESET;
 
+    if(instance->hw) {
+        avr_isp_spi_sw_hw_init(instance);
+        furi_hal_gpio_init(instance->res, GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
+        return instance;
+    }
+
     furi_hal_gpio_init(instance->miso, GpioModeInput, GpioPullNo, GpioSpeedVeryHigh);
     furi_hal_gpio_write(instance->mosi, false);
     furi_hal_gpio_init(instance->mosi, GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
@@ -35,6 +71,10 @@ AvrIspSpiSw* avr_isp_spi_sw_init(AvrIspSpiSwSpeed speed) {
 
 void avr_isp_spi_sw_free(AvrIspSpiSw* instance) {
     furi_assert(instance);
+    if(instance->hw) {
+        furi_hal_spi_release(&furi_hal_spi_bus_handle_external);
+        furi_hal_spi_bus_handle_deinit(&furi_hal_spi_bus_handle_external);
+    }
     furi_hal_gpio_init(instance->res, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
     furi_hal_gpio_init(instance->miso, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
     furi_hal_gpio_init(instance->mosi, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
@@ -44,6 +84,12 @@ void avr_isp_spi_sw_free(AvrIspSpiSw* instance) {
 
 uint8_t avr_isp_spi_sw_txrx(AvrIspSpiSw* instance, uint8_t data) {
     furi_assert(instance);
+    if(instance->hw) {
+        uint8_t rx = 0;
+        furi_hal_spi_bus_trx(
+            &furi_hal_spi_bus_handle_external, &data, &rx, 1, AVR_ISP_SPI_HW_TIMEOUT);
+        return rx;
+    }
     for(uint8_t i = 0; i < 8; ++i) {
         furi_hal_gpio_write(instance->mosi, (data & 0x80) ? true : false);
 
@@ -60,6 +106,24 @@ uint8_t avr_isp_spi_sw_txrx(AvrIspSpiSw* instance, uint8_t data) {
     return data;
 }
 
+void avr_isp_spi_sw_txrx_buf(AvrIspSpiSw* instance, const uint8_t* tx, uint8_t* rx, size_t size) {
+    furi_assert(instance);
+    if(instance->hw) {
+        if(rx) {
+            furi_hal_spi_bus_trx(
+                &furi_hal_spi_bus_handle_external, tx, rx, size, AVR_ISP_SPI_HW_TIMEOUT);
+        } else {
+            furi_hal_spi_bus_tx(
+                &furi_hal_spi_bus_handle_external, tx, size, AVR_ISP_SPI_HW_TIMEOUT);
+        }
+        return;
+    }
+    for(size_t i = 0; i < size; i++) {
+        uint8_t data = avr_isp_spi_sw_txrx(instance, tx[i]);
+        if(rx) rx[i] = data;
+    }
+}
+
 void avr_isp_spi_sw_res_set(AvrIspSpiSw* instance, bool state) {
     furi_assert(instance);
     furi_hal_gpio_write(instance->res, state);
@@ -67,5 +131,7 @@ void avr_isp_spi_sw_res_set(AvrIspSpiSw* instance, bool state) {
 
 void avr_isp_spi_sw_sck_set(AvrIspSpiSw* instance, bool state) {
     furi_assert(instance);
+    // SPI1 idles SCK low in mode 0 and owns the pin
+    if(instance->hw) return;
     furi_hal_gpio_write(instance->sck, state);
 }
\ No newline at end of file
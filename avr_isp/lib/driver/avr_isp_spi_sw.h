@@ -2,7 +2,15 @@
 
 #include <furi_hal.h>
 
+#define AVR_ISP_SPI_SPEED_HW 0x8000
+
 typedef enum {
+    // Hardware SPI1 on the same pins, the low bits are the 64 MHz clock divider
+    AvrIspSpiSwSpeedHw2Mhz = AVR_ISP_SPI_SPEED_HW | 32,
+    AvrIspSpiSwSpeedHw1Mhz = AVR_ISP_SPI_SPEED_HW | 64,
+    AvrIspSpiSwSpeedHw500Khz = AVR_ISP_SPI_SPEED_HW | 128,
+    AvrIspSpiSwSpeedHw250Khz = AVR_ISP_SPI_SPEED_HW | 256,
+    // Bit-banged, the value is the half period in us
     AvrIspSpiSwSpeed1Mhz = 0,
     AvrIspSpiSwSpeed400Khz = 1,
     AvrIspSpiSwSpeed250Khz = 2,
@@ -20,5 +28,7 @@ typedef struct AvrIspSpiSw AvrIspSpiSw;
 AvrIspSpiSw* avr_isp_spi_sw_init(AvrIspSpiSwSpeed speed);
 void avr_isp_spi_sw_free(AvrIspSpiSw* instance);
 uint8_t avr_isp_spi_sw_txrx(AvrIspSpiSw* instance, uint8_t data);
+// Clock out size bytes in one go, rx (may be NULL) gets what the target sent back
+void avr_isp_spi_sw_txrx_buf(AvrIspSpiSw* instance, const uint8_t* tx, uint8_t* rx, size_t size);
 void avr_isp_spi_sw_res_set(AvrIspSpiSw* instance, bool state);
 void avr_isp_spi_sw_sck_set(AvrIspSpiSw* instance, bool state);
\ No newline at end of file
@@ -145,6 +145,8 @@ void select_barcode_item(BarcodeApp* app) {
                 } else {
                     model->data->reason = reason;
                 }
+
+                barcode_render(model);
             },
             true);
 
@@ -23,18 +23,6 @@
 #define BARCODE_HEIGHT 50
 #define BARCODE_Y_START 3
 
-//the folder where the codabar encoding table is located
-#define CODABAR_DICT_FILE_PATH APP_ASSETS_PATH("codabar_encodings.txt")
-
-//the folder where the code 39 encoding table is located
-#define CODE39_DICT_FILE_PATH APP_ASSETS_PATH("code39_encodings.txt")
-
-//the folder where the code 128 encoding table is located
-#define CODE128_DICT_FILE_PATH APP_ASSETS_PATH("code128_encodings.txt")
-
-//the folder where the code 128 C encoding table is located
-#define CODE128C_DICT_FILE_PATH APP_ASSETS_PATH("code128c_encodings.txt")
-
 //the folder where the user stores their barcodes
 #define DEFAULT_USER_BARCODES EXT_PATH("apps_data/barcodes")
 
@@ -1,4 +1,5 @@
 #include "barcode_validator.h"
+#include "encodings.h"
 
 void barcode_loader(BarcodeData* barcode_data) {
     switch(barcode_data->type_obj->type) {
@@ -134,6 +135,15 @@ void ean_upc_loader(BarcodeData* barcode_data) {
     }
 }
 
+/**
+ * Finds the encoding of a character in one of the wide/narrow tables
+ * @returns the index of the character in chars, or -1 if it can't be encoded
+*/
+static int find_encoding(const char* chars, char character) {
+    const char* found = (character == '\0') ? NULL : strchr(chars, character);
+    return (found == NULL) ? -1 : (found - chars);
+}
+
 void code_39_loader(BarcodeData* barcode_data) {
     int barcode_length = furi_string_size(barcode_data->raw_data);
 
@@ -164,42 +174,19 @@ void code_39_loader(BarcodeData* barcode_data) {
     furi_string_free(temp_string);
     barcode_length = furi_string_size(barcode_data->raw_data);
 
-    //Open Storage
-    Storage* storage = furi_record_open(RECORD_STORAGE);
-    FlipperFormat* ff = flipper_format_file_alloc(storage);
+    for(int i = 0; i < barcode_length; i++) {
+        char barcode_char = toupper(furi_string_get_char(barcode_data->raw_data, i));
 
-    if(!flipper_format_file_open_existing(ff, CODE39_DICT_FILE_PATH)) {
-        FURI_LOG_E(TAG, "Could not open file %s", CODE39_DICT_FILE_PATH);
-        barcode_data->reason = MissingEncodingTable;
-        barcode_data->valid = false;
-    } else {
-        FuriString* char_bits = furi_string_alloc();
-        for(int i = 0; i < barcode_length; i++) {
-            char barcode_char = toupper(furi_string_get_char(barcode_data->raw_data, i));
-
-            //convert a char into a string so it used in flipper_format_read_string
-            char current_character[2];
-            snprintf(current_character, 2, "%c", barcode_char);
-
-            if(!flipper_format_read_string(ff, current_character, char_bits)) {
-                FURI_LOG_E(TAG, "Could not read \"%c\" string", barcode_char);
-                barcode_data->reason = InvalidCharacters;
-                barcode_data->valid = false;
-                break;
-            } else {
-                FURI_LOG_I(
-                    TAG, "\"%c\" string: %s", barcode_char, furi_string_get_cstr(char_bits));
-                furi_string_cat(barcode_bits, char_bits);
-            }
-            flipper_format_rewind(ff);
+        int index = find_encoding(CODE_39_CHARS, barcode_char);
+        if(index < 0) {
+            FURI_LOG_E(TAG, "Could not encode \"%c\"", barcode_char);
+            barcode_data->reason = InvalidCharacters;
+            barcode_data->valid = false;
+            break;
         }
-        furi_string_free(char_bits);
+        furi_string_cat_str(barcode_bits, CODE_39_CODES[index]);
     }
 
-    //Close Storage
-    flipper_format_free(ff);
-    furi_record_close(RECORD_STORAGE);
-
     furi_string_cat(barcode_data->correct_data, barcode_bits);
     furi_string_free(barcode_bits);
 }
@@ -212,15 +199,6 @@ void code_39_loader(BarcodeData* barcode_data) {
 void code_128_loader(BarcodeData* barcode_data) {
     int barcode_length = furi_string_size(barcode_data->raw_data);
 
-    //the start code for character set B
-    int start_code_value = 104;
-
-    //The bits for the start code
-    const char* start_code_bits = "11010010000";
-
-    //The bits for the stop code
-    const char* stop_code_bits = "1100011101011";
-
     int min_digits = barcode_data->type_obj->min_digits;
 
     /**
@@ -235,15 +213,7 @@ void code_128_loader(BarcodeData* barcode_data) {
      * 
      * Add 104 since we are using set B
      */
-    int checksum_adder = start_code_value;
-    /**
-     * Checksum digits is the number of characters it has read so far
-     * In the above example the checksum_digits would be 3
-    */
-    int checksum_digits = 0;
-
-    //the calculated check digit
-    int final_check_digit = 0;
+    int checksum_adder = CODE_128_START_B;
 
     //check the length of the barcode, must contain atleast a character,
     //this can have as many characters as it wants, it might not fit on the screen
@@ -253,97 +223,35 @@ void code_128_loader(BarcodeData* barcode_data) {
         return;
     }
 
-    //Open Storage
-    Storage* storage = furi_record_open(RECORD_STORAGE);
-    FlipperFormat* ff = flipper_format_file_alloc(storage);
-
     FuriString* barcode_bits = furi_string_alloc();
 
     //add the start code
-    furi_string_cat(barcode_bits, start_code_bits);
+    furi_string_cat_str(barcode_bits, CODE_128_CODES[CODE_128_START_B]);
 
-    if(!flipper_format_file_open_existing(ff, CODE128_DICT_FILE_PATH)) {
-        FURI_LOG_E(TAG, "Could not open file %s", CODE128_DICT_FILE_PATH);
-        barcode_data->reason = MissingEncodingTable;
-        barcode_data->valid = false;
-    } else {
-        FuriString* value = furi_string_alloc();
-        FuriString* char_bits = furi_string_alloc();
-        for(int i = 0; i < barcode_length; i++) {
-            char barcode_char = furi_string_get_char(barcode_data->raw_data, i);
-
-            //convert a char into a string so it used in flipper_format_read_string
-            char current_character[2];
-            snprintf(current_character, 2, "%c", barcode_char);
-
-            //get the value of the character
-            if(!flipper_format_read_string(ff, current_character, value)) {
-                FURI_LOG_E(TAG, "Could not read \"%c\" string", barcode_char);
-                barcode_data->reason = InvalidCharacters;
-                barcode_data->valid = false;
-                break;
-            }
-            //using the value of the character, get the characters bits
-            if(!flipper_format_read_string(ff, furi_string_get_cstr(value), char_bits)) {
-                FURI_LOG_E(TAG, "Could not read \"%c\" string", barcode_char);
-                barcode_data->reason = EncodingTableError;
-                barcode_data->valid = false;
-                break;
-            } else {
-                //add the bits to the full barcode
-                furi_string_cat(barcode_bits, char_bits);
-
-                //calculate the checksum
-                checksum_digits += 1;
-                checksum_adder += (atoi(furi_string_get_cstr(value)) * checksum_digits);
-
-                FURI_LOG_D(
-                    TAG,
-                    "\"%c\" string: %s : %s : %d : %d : %d",
-                    barcode_char,
-                    furi_string_get_cstr(char_bits),
-                    furi_string_get_cstr(value),
-                    checksum_digits,
-                    (atoi(furi_string_get_cstr(value)) * checksum_digits),
-                    checksum_adder);
-            }
-            //bring the file pointer back to the beginning
-            flipper_format_rewind(ff);
-        }
-
-        //calculate the check digit and convert it into a c string for lookup in the encoding table
-        final_check_digit = checksum_adder % 103;
-        int length = snprintf(NULL, 0, "%d", final_check_digit);
-        char* final_check_digit_string = malloc(length + 1);
-        snprintf(final_check_digit_string, length + 1, "%d", final_check_digit);
+    for(int i = 0; i < barcode_length; i++) {
+        char barcode_char = furi_string_get_char(barcode_data->raw_data, i);
 
-        //after the checksum has been calculated, add the bits to the full barcode
-        if(!flipper_format_read_string(ff, final_check_digit_string, char_bits)) {
-            FURI_LOG_E(TAG, "Could not read \"%s\" string", final_check_digit_string);
-            barcode_data->reason = EncodingTableError;
+        //set B covers the printable ascii characters, the value is the offset from a space
+        if(barcode_char < ' ' || barcode_char > '~') {
+            FURI_LOG_E(TAG, "Could not encode \"%c\"", barcode_char);
+            barcode_data->reason = InvalidCharacters;
             barcode_data->valid = false;
-        } else {
-            //add the check digit bits to the full barcode
-            furi_string_cat(barcode_bits, char_bits);
-
-            FURI_LOG_D(
-                TAG,
-                "\"%s\" string: %s",
-                final_check_digit_string,
-                furi_string_get_cstr(char_bits));
+            break;
         }
+        int value = barcode_char - ' ';
 
-        free(final_check_digit_string);
-        furi_string_free(value);
-        furi_string_free(char_bits);
+        //add the bits to the full barcode
+        furi_string_cat_str(barcode_bits, CODE_128_CODES[value]);
+
+        //calculate the checksum
+        checksum_adder += value * (i + 1);
     }
 
-    //add the stop code
-    furi_string_cat(barcode_bits, stop_code_bits);
+    //after the checksum has been calculated, add the check digit bits to the full barcode
+    furi_string_cat_str(barcode_bits, CODE_128_CODES[checksum_adder % 103]);
 
-    //Close Storage
-    flipper_format_free(ff);
-    furi_record_close(RECORD_STORAGE);
+    //add the stop code
+    furi_string_cat_str(barcode_bits, CODE_128_STOP_CODE);
 
     furi_string_cat(barcode_data->correct_data, barcode_bits);
     furi_string_free(barcode_bits);
@@ -355,23 +263,11 @@ void code_128_loader(BarcodeData* barcode_data) {
 void code_128c_loader(BarcodeData* barcode_data) {
     int barcode_length = furi_string_size(barcode_data->raw_data);
 
-    //the start code for character set C
-    int start_code_value = 105;
-
-    //The bits for the start code
-    const char* start_code_bits = "11010011100";
-
-    //The bits for the stop code
-    const char* stop_code_bits = "1100011101011";
-
     int min_digits = barcode_data->type_obj->min_digits;
 
-    int checksum_adder = start_code_value;
+    int checksum_adder = CODE_128_START_C;
     int checksum_digits = 0;
 
-    //the calculated check digit
-    int final_check_digit = 0;
-
     // check the length of the barcode, must contain atleast 2 character,
     // this can have as many characters as it wants, it might not fit on the screen
     // code 128 C: the length must be even
@@ -380,96 +276,39 @@ void code_128c_loader(BarcodeData* barcode_data) {
         barcode_data->valid = false;
         return;
     }
-    //Open Storage
-    Storage* storage = furi_record_open(RECORD_STORAGE);
-    FlipperFormat* ff = flipper_format_file_alloc(storage);
 
     FuriString* barcode_bits = furi_string_alloc();
 
     //add the start code
-    furi_string_cat(barcode_bits, start_code_bits);
+    furi_string_cat_str(barcode_bits, CODE_128_CODES[CODE_128_START_C]);
 
-    if(!flipper_format_file_open_existing(ff, CODE128C_DICT_FILE_PATH)) {
-        FURI_LOG_E(TAG, "c128c Could not open file %s", CODE128C_DICT_FILE_PATH);
-        barcode_data->reason = MissingEncodingTable;
-        barcode_data->valid = false;
-    } else {
-        FuriString* value = furi_string_alloc();
-        FuriString* char_bits = furi_string_alloc();
-        for(int i = 0; i < barcode_length; i += 2) {
-            char barcode_char1 = furi_string_get_char(barcode_data->raw_data, i);
-            char barcode_char2 = furi_string_get_char(barcode_data->raw_data, i + 1);
-            FURI_LOG_I(TAG, "c128c bc1='%c' bc2='%c'", barcode_char1, barcode_char2);
-
-            char current_chars[4];
-            snprintf(current_chars, 3, "%c%c", barcode_char1, barcode_char2);
-            FURI_LOG_I(TAG, "c128c current_chars='%s'", current_chars);
-
-            //using the value of the characters, get the characters bits
-            if(!flipper_format_read_string(ff, current_chars, char_bits)) {
-                FURI_LOG_E(TAG, "c128c Could not read \"%s\" string", current_chars);
-                barcode_data->reason = EncodingTableError;
-                barcode_data->valid = false;
-                break;
-            } else {
-                //add the bits to the full barcode
-                furi_string_cat(barcode_bits, char_bits);
-
-                // calculate the checksum
-                checksum_digits += 1;
-                checksum_adder += (atoi(current_chars) * checksum_digits);
-
-                FURI_LOG_I(
-                    TAG,
-                    "c128c \"%s\" string: %s : %s : %d : %d : %d",
-                    current_chars,
-                    furi_string_get_cstr(char_bits),
-                    furi_string_get_cstr(value),
-                    checksum_digits,
-                    (atoi(furi_string_get_cstr(value)) * checksum_digits),
-                    checksum_adder);
-            }
-            //bring the file pointer back to the begining
-            flipper_format_rewind(ff);
-        }
-        //calculate the check digit and convert it into a c string for lookup in the encoding table
-        final_check_digit = checksum_adder % 103;
-        FURI_LOG_I(TAG, "c128c finale_check_digit=%d", final_check_digit);
-
-        int length = snprintf(NULL, 0, "%d", final_check_digit);
-        if(final_check_digit < 100) length = 2;
-        char* final_check_digit_string = malloc(length + 1);
-        snprintf(final_check_digit_string, length + 1, "%02d", final_check_digit);
-
-        //after the checksum has been calculated, add the bits to the full barcode
-        if(!flipper_format_read_string(ff, final_check_digit_string, char_bits)) {
-            FURI_LOG_E(TAG, "c128c cksum Could not read \"%s\" string", final_check_digit_string);
-            barcode_data->reason = EncodingTableError;
+    for(int i = 0; i < barcode_length; i += 2) {
+        char barcode_char1 = furi_string_get_char(barcode_data->raw_data, i);
+        char barcode_char2 = furi_string_get_char(barcode_data->raw_data, i + 1);
+
+        //every pair of digits is one symbol
+        if(!isdigit((unsigned char)barcode_char1) || !isdigit((unsigned char)barcode_char2)) {
+            FURI_LOG_E(TAG, "c128c Could not encode \"%c%c\"", barcode_char1, barcode_char2);
+            barcode_data->reason = InvalidCharacters;
             barcode_data->valid = false;
-        } else {
-            //add the check digit bits to the full barcode
-            furi_string_cat(barcode_bits, char_bits);
-
-            FURI_LOG_I(
-                TAG,
-                "check digit \"%s\" string: %s",
-                final_check_digit_string,
-                furi_string_get_cstr(char_bits));
+            break;
         }
+        int value = (barcode_char1 - '0') * 10 + (barcode_char2 - '0');
 
-        free(final_check_digit_string);
-        furi_string_free(value);
-        furi_string_free(char_bits);
+        //add the bits to the full barcode
+        furi_string_cat_str(barcode_bits, CODE_128_CODES[value]);
+
+        // calculate the checksum
+        checksum_digits += 1;
+        checksum_adder += value * checksum_digits;
     }
 
-    //add the stop code
-    furi_string_cat(barcode_bits, stop_code_bits);
+    //after the checksum has been calculated, add the check digit bits to the full barcode
+    furi_string_cat_str(barcode_bits, CODE_128_CODES[checksum_adder % 103]);
 
-    //Close Storage
-    flipper_format_free(ff);
-    furi_record_close(RECORD_STORAGE);
+    //add the stop code
+    furi_string_cat_str(barcode_bits, CODE_128_STOP_CODE);
 
-    FURI_LOG_I(TAG, "c128c %s", furi_string_get_cstr(barcode_bits));
     furi_string_cat(barcode_data->correct_data, barcode_bits);
     furi_string_free(barcode_bits);
 }
@@ -489,44 +328,19 @@ void codabar_loader(BarcodeData* barcode_data) {
 
     FuriString* barcode_bits = furi_string_alloc();
 
-    barcode_length = furi_string_size(barcode_data->raw_data);
-
-    //Open Storage
-    Storage* storage = furi_record_open(RECORD_STORAGE);
-    FlipperFormat* ff = flipper_format_file_alloc(storage);
+    for(int i = 0; i < barcode_length; i++) {
+        char barcode_char = toupper(furi_string_get_char(barcode_data->raw_data, i));
 
-    if(!flipper_format_file_open_existing(ff, CODABAR_DICT_FILE_PATH)) {
-        FURI_LOG_E(TAG, "Could not open file %s", CODABAR_DICT_FILE_PATH);
-        barcode_data->reason = MissingEncodingTable;
-        barcode_data->valid = false;
-    } else {
-        FuriString* char_bits = furi_string_alloc();
-        for(int i = 0; i < barcode_length; i++) {
-            char barcode_char = toupper(furi_string_get_char(barcode_data->raw_data, i));
-
-            //convert a char into a string so it used in flipper_format_read_string
-            char current_character[2];
-            snprintf(current_character, 2, "%c", barcode_char);
-
-            if(!flipper_format_read_string(ff, current_character, char_bits)) {
-                FURI_LOG_E(TAG, "Could not read \"%c\" string", barcode_char);
-                barcode_data->reason = InvalidCharacters;
-                barcode_data->valid = false;
-                break;
-            } else {
-                FURI_LOG_I(
-                    TAG, "\"%c\" string: %s", barcode_char, furi_string_get_cstr(char_bits));
-                furi_string_cat(barcode_bits, char_bits);
-            }
-            flipper_format_rewind(ff);
+        int index = find_encoding(CODABAR_CHARS, barcode_char);
+        if(index < 0) {
+            FURI_LOG_E(TAG, "Could not encode \"%c\"", barcode_char);
+            barcode_data->reason = InvalidCharacters;
+            barcode_data->valid = false;
+            break;
         }
-        furi_string_free(char_bits);
+        furi_string_cat_str(barcode_bits, CODABAR_CODES[index]);
     }
 
-    //Close Storage
-    flipper_format_free(ff);
-    furi_record_close(RECORD_STORAGE);
-
     furi_string_cat(barcode_data->correct_data, barcode_bits);
     furi_string_free(barcode_bits);
 }
@@ -49,4 +49,194 @@ const char UPC_EAN_R_CODES[10][8] = {
     "1000100", // 7
     "1001000", // 8
     "1110100" // 9
-};
\ No newline at end of file
+};
+
+//the characters of CODE_39_CODES, in the same order
+const char CODE_39_CHARS[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ-. *$/+%";
+
+//9 elements per character, alternating bar and space, 1 for wide, 0 for narrow
+const char CODE_39_CODES[44][10] = {
+    "000110100", // 0
+    "100100001", // 1
+    "001100001", // 2
+    "101100000", // 3
+    "000110001", // 4
+    "100110000", // 5
+    "001110000", // 6
+    "000100101", // 7
+    "100100100", // 8
+    "001100100", // 9
+    "100001001", // A
+    "001001001", // B
+    "101001000", // C
+    "000011001", // D
+    "100011000", // E
+    "001011000", // F
+    "000001101", // G
+    "100001100", // H
+    "001001100", // I
+    "000011100", // J
+    "100000011", // K
+    "001000011", // L
+    "101000010", // M
+    "000010011", // N
+    "100010010", // O
+    "001010010", // P
+    "000000111", // Q
+    "100000110", // R
+    "001000110", // S
+    "000010110", // T
+    "110000001", // U
+    "011000001", // V
+    "111000000", // W
+    "010010001", // X
+    "110010000", // Y
+    "011010000", // Z
+    "010000101", // -
+    "110000100", // .
+    "011000100", // ' '
+    "010010100", // *
+    "010101000", // $
+    "010100010", // /
+    "010001010", // +
+    "000101010" // %
+};
+
+//the characters of CODABAR_CODES, in the same order
+const char CODABAR_CHARS[] = "0123456789-$:/.+ABCD";
+
+//7 elements per character, alternating bar and space, 1 for wide, 0 for narrow
+const char CODABAR_CODES[20][8] = {
+    "0000011", // 0
+    "0000110", // 1
+    "0001001", // 2
+    "1100000", // 3
+    "0010010", // 4
+    "1000010", // 5
+    "0100001", // 6
+    "0100100", // 7
+    "0110000", // 8
+    "1001000", // 9
+    "0001100", // -
+    "0011000", // $
+    "1000101", // :
+    "1010001", // /
+    "1010100", // .
+    "0010101", // +
+    "0011010", // A
+    "0101001", // B
+    "0001011", // C
+    "0001110" // D
+};
+
+//module patterns indexed by the symbol value, set B characters have the value (char - 32)
+const char CODE_128_CODES[106][12] = {
+    "11011001100", // 0
+    "11001101100", // 1
+    "11001100110", // 2
+    "10010011000", // 3
+    "10010001100", // 4
+    "10001001100", // 5
+    "10011001000", // 6
+    "10011000100", // 7
+    "10001100100", // 8
+    "11001001000", // 9
+    "11001000100", // 10
+    "11000100100", // 11
+    "10110011100", // 12
+    "10011011100", // 13
+    "10011001110", // 14
+    "10111001100", // 15
+    "10011101100", // 16
+    "10011100110", // 17
+    "11001110010", // 18
+    "11001011100", // 19
+    "11001001110", // 20
+    "11011100100", // 21
+    "11001110100", // 22
+    "11101101110", // 23
+    "11101001100", // 24
+    "11100101100", // 25
+    "11100100110", // 26
+    "11101100100", // 27
+    "11100110100", // 28
+    "11100110010", // 29
+    "11011011000", // 30
+    "11011000110", // 31
+    "11000110110", // 32
+    "10100011000", // 33
+    "10001011000", // 34
+    "10001000110", // 35
+    "10110001000", // 36
+    "10001101000", // 37
+    "10001100010", // 38
+    "11010001000", // 39
+    "11000101000", // 40
+    "11000100010", // 41
+    "10110111000", // 42
+    "10110001110", // 43
+    "10001101110", // 44
+    "10111011000", // 45
+    "10111000110", // 46
+    "10001110110", // 47
+    "11101110110", // 48
+    "11010001110", // 49
+    "11000101110", // 50
+    "11011101000", // 51
+    "11011100010", // 52
+    "11011101110", // 53
+    "11101011000", // 54
+    "11101000110", // 55
+    "11100010110", // 56
+    "11101101000", // 57
+    "11101100010", // 58
+    "11100011010", // 59
+    "11101111010", // 60
+    "11001000010", // 61
+    "11110001010", // 62
+    "10100110000", // 63
+    "10100001100", // 64
+    "10010110000", // 65
+    "10010000110", // 66
+    "10000101100", // 67
+    "10000100110", // 68
+    "10110010000", // 69
+    "10110000100", // 70
+    "10011010000", // 71
+    "10011000010", // 72
+    "10000110100", // 73
+    "10000110010", // 74
+    "11000010010", // 75
+    "11001010000", // 76
+    "11110111010", // 77
+    "11000010100", // 78
+    "10001111010", // 79
+    "10100111100", // 80
+    "10010111100", // 81
+    "10010011110", // 82
+    "10111100100", // 83
+    "10011110100", // 84
+    "10011110010", // 85
+    "11110100100", // 86
+    "11110010100", // 87
+    "11110010010", // 88
+    "11011011110", // 89
+    "11011110110", // 90
+    "11110110110", // 91
+    "10101111000", // 92
+    "10100011110", // 93
+    "10001011110", // 94
+    "10111101000", // 95
+    "10111100010", // 96
+    "11110101000", // 97
+    "11110100010", // 98
+    "10111011110", // 99
+    "10111101110", // 100
+    "11101011110", // 101
+    "11110101110", // 102
+    "11010000100", // 103
+    "11010010000", // 104
+    "11010011100" // 105
+};
+
+const char CODE_128_STOP_CODE[] = "1100011101011";
@@ -3,4 +3,17 @@
 extern const char EAN_13_STRUCTURE_CODES[10][6];
 extern const char UPC_EAN_L_CODES[10][8];
 extern const char EAN_G_CODES[10][8];
-extern const char UPC_EAN_R_CODES[10][8];
\ No newline at end of file
+extern const char UPC_EAN_R_CODES[10][8];
+
+#define CODE_39_CHARS_LEN 44
+#define CODABAR_CHARS_LEN 20
+#define CODE_128_VALUES 106
+#define CODE_128_START_B 104
+#define CODE_128_START_C 105
+
+extern const char CODE_39_CHARS[CODE_39_CHARS_LEN + 1];
+extern const char CODE_39_CODES[CODE_39_CHARS_LEN][10];
+extern const char CODABAR_CHARS[CODABAR_CHARS_LEN + 1];
+extern const char CODABAR_CODES[CODABAR_CHARS_LEN][8];
+extern const char CODE_128_CODES[CODE_128_VALUES][12];
+extern const char CODE_128_STOP_CODE[14];
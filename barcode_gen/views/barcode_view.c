@@ -3,21 +3,21 @@
 #include "../encodings.h"
 
 /**
- * @brief Draws a single bit from a barcode at a specified location
- * @param canvas 
+ * @brief Renders a single bit of a barcode into the line buffers
+ * @param model  the model holding the line buffers
  * @param bit  a 1 or a 0 to signify a bit of data
- * @param x  the top left x coordinate
- * @param y  the top left y coordinate
- * @param width  the width of the bit
- * @param height  the height of the bit
+ * @param x  the column of the bit
+ * @param tall  true if the bar extends below the others (guard patterns)
  */
-static void draw_bit(Canvas* canvas, int bit, int x, int y, int width, int height) {
-    if(bit == 1) {
-        canvas_set_color(canvas, ColorBlack);
-    } else {
-        canvas_set_color(canvas, ColorWhite);
+static void render_bit(BarcodeModel* model, int bit, int x, bool tall) {
+    if(bit != 1 || x < 0 || x >= BARCODE_LINE_WIDTH) {
+        return;
+    }
+    uint8_t mask = 1 << (x & 7);
+    model->bars[x >> 3] |= mask;
+    if(tall) {
+        model->guards[x >> 3] |= mask;
     }
-    canvas_draw_box(canvas, x, y, width, height);
 }
 
 /**
@@ -32,355 +32,287 @@ static void draw_error_str(Canvas* canvas, const char* error) {
  * @param bits  a string of 1's and 0's
  * @returns the x coordinate after the bits have been drawn, useful for drawing the next section of bits
 */
-static int draw_bits(Canvas* canvas, const char* bits, int x, int y, int width, int height) {
-    int bits_length = strlen(bits);
-    for(int i = 0; i < bits_length; i++) {
-        char c = bits[i];
-        int num = c - '0';
-
-        draw_bit(canvas, num, x, y, width, height);
-
-        x += width;
+static int render_bits(BarcodeModel* model, const char* bits, int x, bool tall) {
+    for(; *bits != '\0'; bits++) {
+        render_bit(model, *bits - '0', x, tall);
+        x++;
     }
     return x;
 }
 
 /**
- * Draws an EAN-8 type barcode, does not check if the barcode is valid
- * @param canvas  the canvas
- * @param barcode_digits  the digits in the barcode, must be 8 characters long
+ * Adds a human readable digit below the bars
+*/
+static void render_digit(BarcodeModel* model, int x, char digit) {
+    if(model->digit_count < BARCODE_MAX_DIGITS) {
+        model->digits[model->digit_count].x = x;
+        model->digits[model->digit_count].digit = digit;
+        model->digit_count++;
+    }
+}
+
+/**
+ * Renders an EAN-8 type barcode, does not check if the barcode is valid
+ * @param model  the model to render in to
+ * @param barcode_data  the digits in the barcode, must be 8 characters long
 */
-static void draw_ean_8(Canvas* canvas, BarcodeData* barcode_data) {
+static void render_ean_8(BarcodeModel* model, BarcodeData* barcode_data) {
     FuriString* barcode_digits = barcode_data->correct_data;
     BarcodeTypeObj* type_obj = barcode_data->type_obj;
 
     int barcode_length = furi_string_size(barcode_digits);
 
     int x = type_obj->start_pos;
-    int y = BARCODE_Y_START;
-    int width = 1;
-    int height = BARCODE_HEIGHT;
 
     //the guard patterns for the beginning, center, ending
     const char* end_bits = "101";
     const char* center_bits = "01010";
 
-    //draw the starting guard pattern
-    x = draw_bits(canvas, end_bits, x, y, width, height + 5);
-
-    FuriString* code_part = furi_string_alloc();
+    //render the starting guard pattern
+    x = render_bits(model, end_bits, x, true);
 
-    //loop through each digit, find the encoding, and draw it
+    //loop through each digit, find the encoding, and render it
     for(int i = 0; i < barcode_length; i++) {
         char current_digit = furi_string_get_char(barcode_digits, i);
 
         //the actual number and the index of the bits
         int index = current_digit - '0';
+
+        render_digit(model, x + 1, current_digit);
+
         //use the L-codes for the first 4 digits and the R-Codes for the last 4 digits
         if(i <= 3) {
-            furi_string_set_str(code_part, UPC_EAN_L_CODES[index]);
+            x = render_bits(model, UPC_EAN_L_CODES[index], x, false);
         } else {
-            furi_string_set_str(code_part, UPC_EAN_R_CODES[index]);
+            x = render_bits(model, UPC_EAN_R_CODES[index], x, false);
         }
 
-        //convert the current_digit char into a string so it can be printed
-        char current_digit_string[2];
-        snprintf(current_digit_string, 2, "%c", current_digit);
-
-        //set the canvas color to black to print the digit
-        canvas_set_color(canvas, ColorBlack);
-        canvas_draw_str(canvas, x + 1, y + height + 8, current_digit_string);
-
-        //draw the bits of the barcode
-        x = draw_bits(canvas, furi_string_get_cstr(code_part), x, y, width, height);
-
-        //if the index has reached 3, that means 4 digits have been drawn and now draw the center guard pattern
+        //if the index has reached 3, that means 4 digits have been rendered and now render the center guard pattern
         if(i == 3) {
-            x = draw_bits(canvas, center_bits, x, y, width, height + 5);
+            x = render_bits(model, center_bits, x, true);
         }
     }
-    furi_string_free(code_part);
 
-    //draw the ending guard pattern
-    x = draw_bits(canvas, end_bits, x, y, width, height + 5);
+    //render the ending guard pattern
+    x = render_bits(model, end_bits, x, true);
 }
 
-static void draw_ean_13(Canvas* canvas, BarcodeData* barcode_data) {
+static void render_ean_13(BarcodeModel* model, BarcodeData* barcode_data) {
     FuriString* barcode_digits = barcode_data->correct_data;
     BarcodeTypeObj* type_obj = barcode_data->type_obj;
 
     int barcode_length = furi_string_size(barcode_digits);
 
     int x = type_obj->start_pos;
-    int y = BARCODE_Y_START;
-    int width = 1;
-    int height = BARCODE_HEIGHT;
 
     //the guard patterns for the beginning, center, ending
     const char* end_bits = "101";
     const char* center_bits = "01010";
 
-    //draw the starting guard pattern
-    x = draw_bits(canvas, end_bits, x, y, width, height + 5);
+    //render the starting guard pattern
+    x = render_bits(model, end_bits, x, true);
 
-    FuriString* left_structure = furi_string_alloc();
-    FuriString* code_part = furi_string_alloc();
+    const char* left_structure = EAN_13_STRUCTURE_CODES[0];
 
-    //loop through each digit, find the encoding, and draw it
+    //loop through each digit, find the encoding, and render it
     for(int i = 0; i < barcode_length; i++) {
         char current_digit = furi_string_get_char(barcode_digits, i);
         int index = current_digit - '0';
 
         if(i == 0) {
-            furi_string_set_str(left_structure, EAN_13_STRUCTURE_CODES[index]);
-
-            //convert the current_digit char into a string so it can be printed
-            char current_digit_string[2];
-            snprintf(current_digit_string, 2, "%c", current_digit);
+            left_structure = EAN_13_STRUCTURE_CODES[index];
 
-            //set the canvas color to black to print the digit
-            canvas_set_color(canvas, ColorBlack);
-            canvas_draw_str(canvas, x - 10, y + height + 8, current_digit_string);
+            //the first digit is only printed, left of the bars
+            render_digit(model, x - 10, current_digit);
 
             continue;
         } else {
+            render_digit(model, x + 1, current_digit);
+
             //use the L-codes for the first 6 digits and the R-Codes for the last 6 digits
             if(i <= 6) {
                 //get the encoding type at the current barcode bit position
-                char encoding_type = furi_string_get_char(left_structure, i - 1);
-                if(encoding_type == 'L') {
-                    furi_string_set_str(code_part, UPC_EAN_L_CODES[index]);
+                if(left_structure[i - 1] == 'L') {
+                    x = render_bits(model, UPC_EAN_L_CODES[index], x, false);
                 } else {
-                    furi_string_set_str(code_part, EAN_G_CODES[index]);
+                    x = render_bits(model, EAN_G_CODES[index], x, false);
                 }
             } else {
-                furi_string_set_str(code_part, UPC_EAN_R_CODES[index]);
+                x = render_bits(model, UPC_EAN_R_CODES[index], x, false);
             }
 
-            //convert the current_digit char into a string so it can be printed
-            char current_digit_string[2];
-            snprintf(current_digit_string, 2, "%c", current_digit);
-
-            //set the canvas color to black to print the digit
-            canvas_set_color(canvas, ColorBlack);
-            canvas_draw_str(canvas, x + 1, y + height + 8, current_digit_string);
-
-            //draw the bits of the barcode
-            x = draw_bits(canvas, furi_string_get_cstr(code_part), x, y, width, height);
-
-            //if the index has reached 6, that means 6 digits have been drawn and we now draw the center guard pattern
+            //if the index has reached 6, that means 6 digits have been rendered and we now render the center guard pattern
             if(i == 6) {
-                x = draw_bits(canvas, center_bits, x, y, width, height + 5);
+                x = render_bits(model, center_bits, x, true);
             }
         }
     }
 
-    furi_string_free(left_structure);
-    furi_string_free(code_part);
-
-    //draw the ending guard pattern
-    x = draw_bits(canvas, end_bits, x, y, width, height + 5);
+    //render the ending guard pattern
+    x = render_bits(model, end_bits, x, true);
 }
 
 /**
- * Draw a UPC-A barcode
+ * Render a UPC-A barcode
 */
-static void draw_upc_a(Canvas* canvas, BarcodeData* barcode_data) {
+static void render_upc_a(BarcodeModel* model, BarcodeData* barcode_data) {
     FuriString* barcode_digits = barcode_data->correct_data;
     BarcodeTypeObj* type_obj = barcode_data->type_obj;
 
     int barcode_length = furi_string_size(barcode_digits);
 
     int x = type_obj->start_pos;
-    int y = BARCODE_Y_START;
-    int width = 1;
-    int height = BARCODE_HEIGHT;
 
     //the guard patterns for the beginning, center, ending
-    char* end_bits = "101";
-    char* center_bits = "01010";
-
-    //draw the starting guard pattern
-    x = draw_bits(canvas, end_bits, x, y, width, height + 5);
+    const char* end_bits = "101";
+    const char* center_bits = "01010";
 
-    FuriString* code_part = furi_string_alloc();
+    //render the starting guard pattern
+    x = render_bits(model, end_bits, x, true);
 
-    //loop through each digit, find the encoding, and draw it
+    //loop through each digit, find the encoding, and render it
     for(int i = 0; i < barcode_length; i++) {
         char current_digit = furi_string_get_char(barcode_digits, i);
         int index = current_digit - '0'; //convert the number into an int (also the index)
 
+        render_digit(model, x + 1, current_digit);
+
         //use the L-codes for the first 6 digits and the R-Codes for the last 6 digits
         if(i <= 5) {
-            furi_string_set_str(code_part, UPC_EAN_L_CODES[index]);
+            x = render_bits(model, UPC_EAN_L_CODES[index], x, false);
         } else {
-            furi_string_set_str(code_part, UPC_EAN_R_CODES[index]);
+            x = render_bits(model, UPC_EAN_R_CODES[index], x, false);
         }
 
-        //convert the current_digit char into a string so it can be printed
-        char current_digit_string[2];
-        snprintf(current_digit_string, 2, "%c", current_digit);
-
-        //set the canvas color to black to print the digit
-        canvas_set_color(canvas, ColorBlack);
-        canvas_draw_str(canvas, x + 1, y + height + 8, current_digit_string);
-
-        //draw the bits of the barcode
-        x = draw_bits(canvas, furi_string_get_cstr(code_part), x, y, width, height);
-
-        //if the index has reached 6, that means 6 digits have been drawn and we now draw the center guard pattern
+        //if the index has reached 6, that means 6 digits have been rendered and we now render the center guard pattern
         if(i == 5) {
-            x = draw_bits(canvas, center_bits, x, y, width, height + 5);
+            x = render_bits(model, center_bits, x, true);
         }
     }
 
-    furi_string_free(code_part);
-
-    //draw the ending guard pattern
-    x = draw_bits(canvas, end_bits, x, y, width, height + 5);
+    //render the ending guard pattern
+    x = render_bits(model, end_bits, x, true);
 }
 
-static void draw_code_39(Canvas* canvas, BarcodeData* barcode_data) {
-    FuriString* raw_data = barcode_data->raw_data;
+/**
+ * Renders a barcode made of wide(1) and narrow(0) elements, alternating bar and space,
+ * with a narrow space between characters (Code 39 and Codabar)
+ * @param char_length  the number of elements in one character
+*/
+static void render_wide_narrow(BarcodeModel* model, BarcodeData* barcode_data, int char_length) {
     FuriString* barcode_digits = barcode_data->correct_data;
-    //BarcodeTypeObj* type_obj = barcode_data->type_obj;
+    const char* elements = furi_string_get_cstr(barcode_digits);
 
     int barcode_length = furi_string_size(barcode_digits);
     int total_pixels = 0;
 
     for(int i = 0; i < barcode_length; i++) {
-        //1 for wide, 0 for narrow
-        char wide_or_narrow = furi_string_get_char(barcode_digits, i);
-        int wn_digit = wide_or_narrow - '0'; //wide(1) or narrow(0) digit
-
-        if(wn_digit == 1) {
-            total_pixels += 3;
-        } else {
-            total_pixels += 1;
-        }
-        if((i + 1) % 9 == 0) {
+        //wide elements are 3 pixels, narrow ones 1
+        total_pixels += (elements[i] == '1') ? 3 : 1;
+        if((i + 1) % char_length == 0) {
             total_pixels += 1;
         }
     }
 
     int x = (128 - total_pixels) / 2;
-    int y = BARCODE_Y_START;
-    int width = 1;
-    int height = BARCODE_HEIGHT;
     bool filled_in = true;
 
-    //set the canvas color to black to print the digit
-    canvas_set_color(canvas, ColorBlack);
-    // canvas_draw_str_aligned(canvas, 62, 30, AlignCenter, AlignCenter, error);
-    canvas_draw_str_aligned(
-        canvas, 62, y + height + 8, AlignCenter, AlignBottom, furi_string_get_cstr(raw_data));
-
     for(int i = 0; i < barcode_length; i++) {
         //1 for wide, 0 for narrow
-        char wide_or_narrow = furi_string_get_char(barcode_digits, i);
-        int wn_digit = wide_or_narrow - '0'; //wide(1) or narrow(0) digit
+        int wn_digit = elements[i] - '0'; //wide(1) or narrow(0) digit
 
         if(filled_in) {
-            if(wn_digit == 1) {
-                x = draw_bits(canvas, "111", x, y, width, height);
-            } else {
-                x = draw_bits(canvas, "1", x, y, width, height);
-            }
+            x = render_bits(model, (wn_digit == 1) ? "111" : "1", x, false);
             filled_in = false;
         } else {
-            if(wn_digit == 1) {
-                x = draw_bits(canvas, "000", x, y, width, height);
-            } else {
-                x = draw_bits(canvas, "0", x, y, width, height);
-            }
+            x = render_bits(model, (wn_digit == 1) ? "000" : "0", x, false);
             filled_in = true;
         }
-        if((i + 1) % 9 == 0) {
-            x = draw_bits(canvas, "0", x, y, width, height);
+        if((i + 1) % char_length == 0) {
+            x = render_bits(model, "0", x, false);
             filled_in = true;
         }
     }
 }
 
-static void draw_code_128(Canvas* canvas, BarcodeData* barcode_data) {
-    FuriString* raw_data = barcode_data->raw_data;
+static void render_code_128(BarcodeModel* model, BarcodeData* barcode_data) {
     FuriString* barcode_digits = barcode_data->correct_data;
 
     int barcode_length = furi_string_size(barcode_digits);
 
     int x = (128 - barcode_length) / 2;
-    int y = BARCODE_Y_START;
-    int width = 1;
-    int height = BARCODE_HEIGHT;
-
-    x = draw_bits(canvas, furi_string_get_cstr(barcode_digits), x, y, width, height);
 
-    //set the canvas color to black to print the digit
-    canvas_set_color(canvas, ColorBlack);
-    // canvas_draw_str_aligned(canvas, 62, 30, AlignCenter, AlignCenter, error);
-    canvas_draw_str_aligned(
-        canvas, 62, y + height + 8, AlignCenter, AlignBottom, furi_string_get_cstr(raw_data));
+    x = render_bits(model, furi_string_get_cstr(barcode_digits), x, false);
 }
 
-static void draw_codabar(Canvas* canvas, BarcodeData* barcode_data) {
-    FuriString* raw_data = barcode_data->raw_data;
-    FuriString* barcode_digits = barcode_data->correct_data;
-    //BarcodeTypeObj* type_obj = barcode_data->type_obj;
+void barcode_render(BarcodeModel* model) {
+    BarcodeData* data = model->data;
 
-    int barcode_length = furi_string_size(barcode_digits);
-    int total_pixels = 0;
+    memset(model->bars, 0, sizeof(model->bars));
+    memset(model->guards, 0, sizeof(model->guards));
+    model->digit_count = 0;
 
-    for(int i = 0; i < barcode_length; i++) {
-        //1 for wide, 0 for narrow
-        char wide_or_narrow = furi_string_get_char(barcode_digits, i);
-        int wn_digit = wide_or_narrow - '0'; //wide(1) or narrow(0) digit
+    if(data == NULL || !data->valid) {
+        return;
+    }
 
-        if(wn_digit == 1) {
-            total_pixels += 3;
-        } else {
-            total_pixels += 1;
-        }
-        if((i + 1) % 7 == 0) {
-            total_pixels += 1;
-        }
+    switch(data->type_obj->type) {
+    case UPCA:
+        render_upc_a(model, data);
+        break;
+    case EAN8:
+        render_ean_8(model, data);
+        break;
+    case EAN13:
+        render_ean_13(model, data);
+        break;
+    case CODE39:
+        render_wide_narrow(model, data, 9);
+        break;
+    case CODE128:
+    case CODE128C:
+        render_code_128(model, data);
+        break;
+    case CODABAR:
+        render_wide_narrow(model, data, 7);
+        break;
+    case UNKNOWN:
+    default:
+        break;
     }
+}
 
-    int x = (128 - total_pixels) / 2;
+/**
+ * Blits the rendered line buffers, every row of the barcode is the same
+*/
+static void draw_barcode(Canvas* canvas, BarcodeModel* model) {
+    BarcodeData* data = model->data;
     int y = BARCODE_Y_START;
-    int width = 1;
     int height = BARCODE_HEIGHT;
-    bool filled_in = true;
 
-    //set the canvas color to black to print the digit
     canvas_set_color(canvas, ColorBlack);
-    // canvas_draw_str_aligned(canvas, 62, 30, AlignCenter, AlignCenter, error);
-    canvas_draw_str_aligned(
-        canvas, 62, y + height + 8, AlignCenter, AlignBottom, furi_string_get_cstr(raw_data));
-
-    for(int i = 0; i < barcode_length; i++) {
-        //1 for wide, 0 for narrow
-        char wide_or_narrow = furi_string_get_char(barcode_digits, i);
-        int wn_digit = wide_or_narrow - '0'; //wide(1) or narrow(0) digit
+    for(int row = 0; row < height; row++) {
+        canvas_draw_xbm(canvas, 0, y + row, BARCODE_LINE_WIDTH, 1, model->bars);
+    }
+    for(int row = height; row < height + 5; row++) {
+        canvas_draw_xbm(canvas, 0, y + row, BARCODE_LINE_WIDTH, 1, model->guards);
+    }
 
-        if(filled_in) {
-            if(wn_digit == 1) {
-                x = draw_bits(canvas, "111", x, y, width, height);
-            } else {
-                x = draw_bits(canvas, "1", x, y, width, height);
-            }
-            filled_in = false;
-        } else {
-            if(wn_digit == 1) {
-                x = draw_bits(canvas, "000", x, y, width, height);
-            } else {
-                x = draw_bits(canvas, "0", x, y, width, height);
-            }
-            filled_in = true;
-        }
-        if((i + 1) % 7 == 0) {
-            x = draw_bits(canvas, "0", x, y, width, height);
-            filled_in = true;
+    if(model->digit_count > 0) {
+        //EAN/UPC, a digit below each group of bars
+        char digit_string[2] = {0};
+        for(int i = 0; i < model->digit_count; i++) {
+            digit_string[0] = model->digits[i].digit;
+            canvas_draw_str(canvas, model->digits[i].x, y + height + 8, digit_string);
         }
+    } else {
+        canvas_draw_str_aligned(
+            canvas,
+            62,
+            y + height + 8,
+            AlignCenter,
+            AlignBottom,
+            furi_string_get_cstr(data->raw_data));
     }
 }
 
@@ -392,29 +324,8 @@ static void barcode_draw_callback(Canvas* canvas, void* ctx) {
 
     canvas_clear(canvas);
     if(data->valid) {
-        switch(data->type_obj->type) {
-        case UPCA:
-            draw_upc_a(canvas, data);
-            break;
-        case EAN8:
-            draw_ean_8(canvas, data);
-            break;
-        case EAN13:
-            draw_ean_13(canvas, data);
-            break;
-        case CODE39:
-            draw_code_39(canvas, data);
-            break;
-        case CODE128:
-        case CODE128C:
-            draw_code_128(canvas, data);
-            break;
-        case CODABAR:
-            draw_codabar(canvas, data);
-            break;
-        case UNKNOWN:
-        default:
-            break;
+        if(data->type_obj->type != UNKNOWN) {
+            draw_barcode(canvas, barcode_model);
         }
     } else {
         switch(data->reason) {
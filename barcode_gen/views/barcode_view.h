@@ -9,13 +9,34 @@ typedef struct {
     BarcodeApp* barcode_app;
 } Barcode;
 
+//width of the rendered barcode, one bit per column
+#define BARCODE_LINE_WIDTH 128
+//the most human readable digits printed under a barcode (EAN-13)
+#define BARCODE_MAX_DIGITS 13
+
+typedef struct {
+    int x;
+    char digit;
+} BarcodeDigit;
+
 typedef struct {
     FuriString* file_path;
     BarcodeData* data;
+
+    //the barcode rendered once by barcode_render(), as 1-bpp (xbm) lines
+    uint8_t bars[BARCODE_LINE_WIDTH / 8]; //every bar
+    uint8_t guards[BARCODE_LINE_WIDTH / 8]; //the guard bars that extend below the others
+    BarcodeDigit digits[BARCODE_MAX_DIGITS];
+    int digit_count;
 } BarcodeModel;
 
 Barcode* barcode_view_allocate(BarcodeApp* barcode_app);
 
+/**
+ * Renders the model's barcode data into its line buffers, call whenever the data changes
+*/
+void barcode_render(BarcodeModel* model);
+
 void barcode_free_model(Barcode* barcode);
 
 void barcode_free(Barcode* barcode);
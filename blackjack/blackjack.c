@@ -442,7 +442,7 @@ void start_round(GameState* game_state) {
     game_state->started = false;
     game_state->doubled = false;
     game_state->queue_state.running = true;
-    shuffle_deck(&(game_state->deck));
+    shuffle_deck(&(game_state->deck), &(game_state->rng));
     game_state->doubled = false;
     game_state->bet = game_state->settings.round_price;
     if(game_state->player_score < game_state->settings.round_price) {
@@ -546,6 +546,10 @@ int32_t blackjack_app(void* p) {
     GameState* game_state = malloc(sizeof(GameState));
     game_state->menu = malloc(sizeof(Menu));
     game_state->menu->menu_width = 40;
+    rng_init(&(game_state->rng));
+#ifdef FURI_DEBUG
+    rng_self_test(&(game_state->rng));
+#endif
     init(game_state);
     add_menu(game_state->menu, "Double", doubleAction);
     add_menu(game_state->menu, "Hit", hitAction);
@@ -145,16 +145,9 @@ void generate_deck(Deck* deck_ptr, uint8_t deck_count) {
     }
 }
 
-void shuffle_deck(Deck* deck_ptr) {
-    srand(DWT->CYCCNT);
+void shuffle_deck(Deck* deck_ptr, Rng* rng) {
     deck_ptr->index = 0;
-    int max = deck_ptr->deck_count * 52;
-    for(int i = 0; i < max; i++) {
-        int r = i + (rand() % (max - i));
-        Card tmp = deck_ptr->cards[i];
-        deck_ptr->cards[i] = deck_ptr->cards[r];
-        deck_ptr->cards[r] = tmp;
-    }
+    rng_shuffle(rng, deck_ptr->cards, deck_ptr->deck_count * 52, sizeof(Card));
 }
 
 uint8_t hand_count(const Card* cards, uint8_t count) {
@@ -4,6 +4,7 @@
 #include <math.h>
 #include <stdlib.h>
 #include "dml.h"
+#include "rng.h"
 
 #define CARD_HEIGHT 23
 #define CARD_HALF_HEIGHT 11
@@ -101,8 +102,9 @@ void generate_deck(Deck* deck_ptr, uint8_t deck_count);
  * Shuffles the deck
  *
  * @param deck_ptr Pointer to the deck
+ * @param rng      Seeded generator
  */
-void shuffle_deck(Deck* deck_ptr);
+void shuffle_deck(Deck* deck_ptr, Rng* rng);
 
 /**
  * Calculates the hand count for blackjack
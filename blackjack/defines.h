@@ -8,6 +8,7 @@
 #include "common/card.h"
 #include "common/queue.h"
 #include "common/menu.h"
+#include "common/rng.h"
 
 #define APP_NAME "Blackjack"
 
@@ -69,6 +70,7 @@ typedef struct {
     bool started;
     bool processing;
     Deck deck;
+    Rng rng;
     PlayState state;
     QueueState queue_state;
     Menu* menu;
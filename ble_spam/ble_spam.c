@@ -4,6 +4,7 @@
 #include <gui/elements.h>
 
 #include "protocols/_protocols.h"
+#include "profile.h"
 
 // Hacked together by @Willy-JL
 // Custom adv API by @Willy-JL (idea by @xMasterX)
@@ -167,7 +168,7 @@ static int32_t adv_thread(void* _ctx) {
     State* state = _ctx;
     uint8_t size;
     uint16_t delay;
-    uint8_t* packet;
+    uint8_t packet[PACKET_MAX_SIZE];
     uint8_t mac[GAP_MAC_ADDR_SIZE];
     Payload* payload = &attacks[state->index].payload;
     const Protocol* protocol = attacks[state->index].protocol;
@@ -181,12 +182,11 @@ static int32_t adv_thread(void* _ctx) {
                 payload->bruteforce.value =
                     (payload->bruteforce.value + 1) % (1 << (payload->bruteforce.size * 8));
             }
-            protocol->make_packet(&size, &packet, payload);
+            protocol->make_packet(&size, packet, payload);
         } else {
-            protocols[rand() % protocols_count]->make_packet(&size, &packet, NULL);
+            protocols[rand() % protocols_count]->make_packet(&size, packet, NULL);
         }
         furi_hal_bt_custom_adv_set(packet, size);
-        free(packet);
 
         if(payload->random_mac) furi_hal_random_fill_buf(mac, sizeof(mac));
         delay = delays[state->delay];
@@ -196,6 +196,7 @@ static int32_t adv_thread(void* _ctx) {
     }
 
     if(state->ctx.led_indicator) stop_blink(state);
+    profile_thread_exit("adv");
     return 0;
 }
 
@@ -519,10 +520,9 @@ static bool input_callback(InputEvent* input, void* _ctx) {
                     const Protocol* protocol = attacks[state->index].protocol;
 
                     uint8_t size;
-                    uint8_t* packet;
-                    protocol->make_packet(&size, &packet, payload);
+                    uint8_t packet[PACKET_MAX_SIZE];
+                    protocol->make_packet(&size, packet, payload);
                     furi_hal_bt_custom_adv_set(packet, size);
-                    free(packet);
 
                     uint8_t mac[GAP_MAC_ADDR_SIZE];
                     furi_hal_random_fill_buf(mac, sizeof(mac));
@@ -595,6 +595,7 @@ static bool back_event_callback(void* _ctx) {
 
 int32_t ble_spam(void* p) {
     UNUSED(p);
+    profile_start(); // "profile" CLI command in debug builds
     State* state = malloc(sizeof(State));
     state->thread = furi_thread_alloc();
     furi_thread_set_callback(state->thread, adv_thread);
@@ -666,5 +667,6 @@ int32_t ble_spam(void* p) {
     furi_timer_free(state->lock_timer);
     furi_thread_free(state->thread);
     free(state);
+    profile_stop();
     return 0;
 }
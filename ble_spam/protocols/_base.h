@@ -10,12 +10,15 @@
 #include <core/core_defines.h>
 #include "../ble_spam.h"
 
+// Max legacy advertising data length, every make_packet() fits in this
+#define PACKET_MAX_SIZE (31)
+
 typedef struct Payload Payload;
 
 typedef struct {
     const Icon* icon;
     const char* (*get_name)(const Payload* payload);
-    void (*make_packet)(uint8_t* _size, uint8_t** _packet, Payload* payload);
+    void (*make_packet)(uint8_t* _size, uint8_t* packet, Payload* payload);
     void (*extra_config)(Ctx* ctx);
     uint8_t (*config_count)(const Payload* payload);
 } Protocol;
@@ -87,7 +87,7 @@ static uint8_t packet_sizes[ContinuityTypeCOUNT] = {
     [ContinuityTypeNearbyInfo] = HEADER_LEN + 5,
     [ContinuityTypeCustomCrash] = HEADER_LEN + 11,
 };
-static void make_packet(uint8_t* _size, uint8_t** _packet, Payload* payload) {
+static void make_packet(uint8_t* _size, uint8_t* packet, Payload* payload) {
     ContinuityCfg* cfg = payload ? &payload->cfg.continuity : NULL;
 
     ContinuityType type;
@@ -103,7 +103,6 @@ static void make_packet(uint8_t* _size, uint8_t** _packet, Payload* payload) {
     }
 
     uint8_t size = packet_sizes[type];
-    uint8_t* packet = malloc(size);
     uint8_t i = 0;
 
     packet[i++] = size - 1; // Size
@@ -284,7 +283,6 @@ static void make_packet(uint8_t* _size, uint8_t** _packet, Payload* payload) {
     }
 
     *_size = size;
-    *_packet = packet;
 }
 
 enum {
@@ -77,7 +77,7 @@ static uint8_t packet_sizes[EasysetupTypeCOUNT] = {
     [EasysetupTypeBuds] = 31,
     [EasysetupTypeWatch] = 15,
 };
-void make_packet(uint8_t* out_size, uint8_t** out_packet, Payload* payload) {
+void make_packet(uint8_t* out_size, uint8_t* packet, Payload* payload) {
     EasysetupCfg* cfg = payload ? &payload->cfg.easysetup : NULL;
 
     EasysetupType type;
@@ -92,7 +92,6 @@ void make_packet(uint8_t* out_size, uint8_t** out_packet, Payload* payload) {
     }
 
     uint8_t size = packet_sizes[type];
-    uint8_t* packet = malloc(size);
     uint8_t i = 0;
 
     switch(type) {
@@ -183,7 +182,6 @@ void make_packet(uint8_t* out_size, uint8_t** out_packet, Payload* payload) {
     }
 
     *out_size = size;
-    *out_packet = packet;
 }
 
 enum {
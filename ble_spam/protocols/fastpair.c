@@ -527,7 +527,7 @@ static const char* get_name(const Payload* payload) {
     return "FastPair";
 }
 
-static void make_packet(uint8_t* _size, uint8_t** _packet, Payload* payload) {
+static void make_packet(uint8_t* _size, uint8_t* packet, Payload* payload) {
     FastpairCfg* cfg = payload ? &payload->cfg.fastpair : NULL;
 
     uint32_t model;
@@ -545,7 +545,6 @@ static void make_packet(uint8_t* _size, uint8_t** _packet, Payload* payload) {
     }
 
     uint8_t size = 14;
-    uint8_t* packet = malloc(size);
     uint8_t i = 0;
 
     packet[i++] = 3; // Size
@@ -566,7 +565,6 @@ static void make_packet(uint8_t* _size, uint8_t** _packet, Payload* payload) {
     packet[i++] = (rand() % 120) - 100; // -100 to +20 dBm
 
     *_size = size;
-    *_packet = packet;
 }
 
 enum {
@@ -19,7 +19,7 @@ static const char* get_name(const Payload* payload) {
     return "SwiftPair";
 }
 
-static void make_packet(uint8_t* _size, uint8_t** _packet, Payload* payload) {
+static void make_packet(uint8_t* _size, uint8_t* packet, Payload* payload) {
     SwiftpairCfg* cfg = payload ? &payload->cfg.swiftpair : NULL;
 
     const char* name;
@@ -35,7 +35,6 @@ static void make_packet(uint8_t* _size, uint8_t** _packet, Payload* payload) {
     uint8_t name_len = strlen(name);
 
     uint8_t size = 7 + name_len;
-    uint8_t* packet = malloc(size);
     uint8_t i = 0;
 
     packet[i++] = size - 1; // Size
@@ -49,7 +48,6 @@ static void make_packet(uint8_t* _size, uint8_t** _packet, Payload* payload) {
     i += name_len;
 
     *_size = size;
-    *_packet = packet;
 }
 
 enum {
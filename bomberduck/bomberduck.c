@@ -19,6 +19,11 @@ int min(int a, int b) {
 #define WorldSizeX 12
 #define WorldSizeY 6
 #define BombRange 1
+#define MaxBombs 2
+// Enough for every open cell right of the start to get crowded
+#define MaxEnemies 16
+#define ExplosionMs 200
+#define Unreachable 0xFF
 
 typedef struct {
     FuriMutex* mutex;
@@ -69,6 +74,7 @@ typedef struct {
     int last;
     bool side;
     int level;
+    bool active;
 } Enemy;
 
 typedef struct {
@@ -77,69 +83,25 @@ typedef struct {
     bool running;
     int level;
 
-    Enemy enemies[10];
-    int enemies_count;
+    // A fixed pool, dead enemies are only marked inactive
+    Enemy enemies[MaxEnemies];
 
-    Bomb bombs[100];
+    Bomb bombs[MaxBombs];
     int bombs_count;
 
     int endx;
     int endy;
+
+    // Steps from the player to every cell, rebuilt each tick for the enemies to follow
+    uint8_t distance[WorldSizeY][WorldSizeX];
+    // Explosions stay on the matrix until then
+    uint32_t explosion_end;
 } World;
 
 Player player = {0, 0, 1};
-World world = {{{0}}, &player, 1, 0, {}, 0, {}, 0, 0, 0};
+World world = {.player = &player, .running = 1};
 bool vibration = false;
 
-void init() {
-    player.x = 1;
-    player.y = 1;
-
-    world.endx = 4 + rand() % 8;
-    world.endy = rand() % 6;
-    for(int i = 0; i < WorldSizeY; i++) {
-        for(int j = 0; j < WorldSizeX; j++) {
-            world.matrix[i][j] = rand() % 3;
-        }
-    }
-    world.running = 1;
-    world.bombs_count = 0;
-    vibration = false;
-    for(int j = max(0, player.y - BombRange); j < min(WorldSizeY, player.y + BombRange + 1); j++) {
-        world.matrix[j][player.x] = 0;
-    }
-
-    for(int j = max(0, player.x - BombRange); j < min(WorldSizeX, player.x + BombRange + 1); j++) {
-        world.matrix[player.y][j] = 0;
-    }
-
-    world.enemies_count = 0;
-    for(int j = 0; j < rand() % 4 + world.level / 5; j++) {
-        Enemy enemy;
-        enemy.x = 4 + rand() % 7;
-        enemy.y = rand() % 6;
-        enemy.last = 0;
-        enemy.side = 1;
-        enemy.level = 0;
-
-        world.enemies[j] = enemy;
-        world.enemies_count++;
-
-        for(int m = max(0, world.enemies[j].y - BombRange);
-            m < min(WorldSizeY, world.enemies[j].y + BombRange + 1);
-            m++) {
-            world.matrix[m][world.enemies[j].x] = 0;
-        }
-
-        for(int m = max(0, world.enemies[j].x - BombRange);
-            m < min(WorldSizeX, world.enemies[j].x + BombRange + 1);
-            m++) {
-            world.matrix[world.enemies[j].y][m] = 0;
-        }
-    }
-    world.matrix[world.endy][world.endx] = 1;
-}
-
 const NotificationSequence end = {
     &message_vibro_on,
 
@@ -218,53 +180,270 @@ void intToStr(int num, char* str) {
     }
 }
 
-bool BFS() {
-    // Initialize visited array and queue
-    int visited[WorldSizeY][WorldSizeX] = {0};
+static bool passable_wall(int cell) {
+    return cell != 2;
+}
+
+static bool passable_walk(int cell) {
+    return cell == 0;
+}
+
+// Breadth first from the player over the cells passable lets through
+static void distance_field(uint8_t distance[WorldSizeY][WorldSizeX], bool (*passable)(int)) {
+    memset(distance, Unreachable, sizeof(uint8_t) * WorldSizeY * WorldSizeX);
     Queue q = {.front = 0, .rear = 0};
-    // Mark the starting cell as visited and enqueue it
-    visited[world.player->y][world.player->x] = 1;
+    distance[world.player->y][world.player->x] = 0;
     Cell startCell = {.row = world.player->y, .col = world.player->x};
     enqueue(&q, startCell);
-    // Traverse the field
     while(!is_empty(&q)) {
-        // Dequeue a cell from the queue
         Cell currentCell = dequeue(&q);
-        // Check if the current cell is the destination cell
-        if(currentCell.row == world.endy && currentCell.col == world.endx) {
+        for(int d = 0; d < 4; d++) {
+            int neighborRow = currentCell.row + (d == 0 ? -1 : d == 1 ? 1 : 0);
+            int neighborCol = currentCell.col + (d == 2 ? -1 : d == 3 ? 1 : 0);
+            // Skip out-of-bounds cells and already visited cells
+            if(neighborRow < 0 || neighborRow >= WorldSizeY || neighborCol < 0 ||
+               neighborCol >= WorldSizeX) {
+                continue;
+            }
+            if(distance[neighborRow][neighborCol] != Unreachable) {
+                continue;
+            }
+            if(passable(world.matrix[neighborRow][neighborCol])) {
+                distance[neighborRow][neighborCol] =
+                    distance[currentCell.row][currentCell.col] + 1;
+                Cell neighborCell = {.row = neighborRow, .col = neighborCol};
+                enqueue(&q, neighborCell);
+            }
+        }
+    }
+}
+
+static void clear_cross(int x, int y) {
+    for(int j = max(0, y - BombRange); j < min(WorldSizeY, y + BombRange + 1); j++) {
+        world.matrix[j][x] = 0;
+    }
+
+    for(int j = max(0, x - BombRange); j < min(WorldSizeX, x + BombRange + 1); j++) {
+        world.matrix[y][j] = 0;
+    }
+}
+
+void init() {
+    player.x = 1;
+    player.y = 1;
+
+    world.running = 1;
+    world.bombs_count = 0;
+    world.explosion_end = 0;
+    vibration = false;
+
+    int enemies_count = min(rand() % 4 + world.level / 3, MaxEnemies);
+    // Walls only get in the way of the exit if they wall it off for good, then roll again
+    do {
+        world.endx = 4 + rand() % 8;
+        world.endy = rand() % 6;
+        for(int i = 0; i < WorldSizeY; i++) {
+            for(int j = 0; j < WorldSizeX; j++) {
+                world.matrix[i][j] = rand() % 3;
+            }
+        }
+        clear_cross(player.x, player.y);
+
+        for(int j = 0; j < MaxEnemies; j++) {
+            Enemy enemy = {0};
+            if(j < enemies_count) {
+                enemy.x = 4 + rand() % 7;
+                enemy.y = rand() % 6;
+                enemy.side = 1;
+                enemy.active = true;
+                clear_cross(enemy.x, enemy.y);
+            }
+            world.enemies[j] = enemy;
+        }
+        world.matrix[world.endy][world.endx] = 1;
+
+        distance_field(world.distance, passable_wall);
+    } while(world.distance[world.endy][world.endx] == Unreachable);
+}
+
+static const int MoveX[4] = {0, 0, -1, 1};
+static const int MoveY[4] = {-1, 1, 0, 0};
+
+static bool in_blast(int x, int y) {
+    for(int i = 0; i < world.bombs_count; i++) {
+        int dx = abs(world.bombs[i].x - x);
+        int dy = abs(world.bombs[i].y - y);
+        if((dx == 0 && dy <= BombRange) || (dy == 0 && dx <= BombRange)) {
             return true;
         }
-        // Check the neighboring cells
-        for(int rowOffset = -1; rowOffset <= 1; rowOffset++) {
-            for(int colOffset = -1; colOffset <= 1; colOffset++) {
-                // Skip diagonals and the current cell
-                if(rowOffset == 0 && colOffset == 0) {
-                    continue;
-                }
-                if(rowOffset != 0 && colOffset != 0) {
-                    continue;
-                }
-                // Calculate the row and column of the neighboring cell
-                int neighborRow = currentCell.row + rowOffset;
-                int neighborCol = currentCell.col + colOffset;
-                // Skip out-of-bounds cells and already visited cells
-                if(neighborRow < 0 || neighborRow >= WorldSizeY || neighborCol < 0 ||
-                   neighborCol >= WorldSizeX) {
-                    continue;
-                }
-                if(visited[neighborRow][neighborCol]) {
-                    continue;
-                }
-                // Mark the neighboring cell as visited and enqueue it
-                if(world.matrix[neighborRow][neighborCol] != 2) {
-                    visited[neighborRow][neighborCol] = 1;
-                    Cell neighborCell = {.row = neighborRow, .col = neighborCol};
-                    enqueue(&q, neighborCell);
+    }
+    return false;
+}
+
+static void blast_cell(int x, int y, NotificationApp* notification) {
+    if(world.matrix[y][x] == 2) {
+        return;
+    }
+    world.matrix[y][x] = 6;
+    if(y == world.player->y && x == world.player->x) {
+        notification_message(notification, &end);
+        world.running = 0;
+    }
+    for(int e = 0; e < MaxEnemies; e++) {
+        Enemy* enemy = &world.enemies[e];
+        if(enemy->active && enemy->y == y && enemy->x == x) {
+            if(enemy->level > 0) {
+                enemy->level--;
+            } else {
+                enemy->active = false;
+            }
+        }
+    }
+}
+
+static void explode(const Bomb* bomb, NotificationApp* notification) {
+    vibration = false;
+    world.explosion_end = furi_get_tick() + ExplosionMs;
+    notification_message(notification, &bomb_explore);
+
+    for(int j = max(0, bomb->y - BombRange); j < min(WorldSizeY, bomb->y + BombRange + 1); j++) {
+        blast_cell(bomb->x, j, notification);
+    }
+    for(int j = max(0, bomb->x - BombRange); j < min(WorldSizeX, bomb->x + BombRange + 1); j++) {
+        if(j != bomb->x) {
+            blast_cell(j, bomb->y, notification);
+        }
+    }
+}
+
+static bool enemy_can_enter(const Enemy* enemy, int x, int y) {
+    if(x < 0 || x >= WorldSizeX || y < 0 || y >= WorldSizeY) {
+        return false;
+    }
+    // Upgraded enemies go over boxes and bombs
+    return enemy->level > 0 ? world.matrix[y][x] != 2 : world.matrix[y][x] == 0;
+}
+
+// Out of a bomb's reach if it stands in one, otherwise down the distance field towards the
+// player, more often the higher the level, and a random step the rest of the time
+static int enemy_choose_move(const Enemy* enemy) {
+    bool fleeing = in_blast(enemy->x, enemy->y);
+    if(!fleeing && rand() % 100 >= min(30 + world.level * 5, 90)) {
+        return rand() % 4;
+    }
+
+    int best = -1;
+    int best_distance = fleeing ? Unreachable + 1 : world.distance[enemy->y][enemy->x];
+    int first = rand() % 4;
+    for(int i = 0; i < 4; i++) {
+        int move = (first + i) % 4;
+        int x = enemy->x + MoveX[move];
+        int y = enemy->y + MoveY[move];
+        if(!enemy_can_enter(enemy, x, y) || (fleeing && in_blast(x, y))) {
+            continue;
+        }
+        if(world.distance[y][x] < best_distance) {
+            best_distance = world.distance[y][x];
+            best = move;
+        }
+    }
+    return best >= 0 ? best : rand() % 4;
+}
+
+static void enemy_move(Enemy* enemy) {
+    int move = enemy_choose_move(enemy);
+    if(move == 2) {
+        enemy->side = 0;
+    } else if(move == 3) {
+        enemy->side = 1;
+    }
+    int x = enemy->x + MoveX[move];
+    int y = enemy->y + MoveY[move];
+    if(enemy_can_enter(enemy, x, y)) {
+        enemy->x = x;
+        enemy->y = y;
+    }
+}
+
+// Everything that changes the world on its own, drawing only ever reads it
+static void tick(NotificationApp* notification) {
+    uint32_t now = furi_get_tick();
+
+    if(world.player->x == world.endx && world.player->y == world.endy) {
+        notification_message(notification, &end);
+        world.running = 0;
+        world.level += 1;
+        if(world.level % 5 == 0) {
+            dolphin_deed(DolphinDeedPluginGameWin);
+        }
+    }
+
+    if((int32_t)(now - world.explosion_end) >= 0) {
+        for(int i = 0; i < WorldSizeY; i++) {
+            for(int j = 0; j < WorldSizeX; j++) {
+                if(world.matrix[i][j] == 6) {
+                    world.matrix[i][j] = 0;
                 }
             }
         }
     }
-    return false;
+
+    for(int i = 0; i < world.bombs_count; i++) {
+        Bomb* bomb = &world.bombs[i];
+        if(now - bomb->planted > (unsigned long)max((3000 - world.level * 150), 1000)) {
+            explode(bomb, notification);
+            for(int j = i; j < world.bombs_count - 1; j++) {
+                world.bombs[j] = world.bombs[j + 1];
+            }
+            world.bombs_count--;
+            i--;
+        } else if(
+            now - bomb->planted > (unsigned long)max((3000 - world.level * 150) * 2 / 3, 666) &&
+            world.matrix[bomb->y][bomb->x] != 5) {
+            world.matrix[bomb->y][bomb->x] = 5;
+            vibration = true;
+
+        } else if(
+            now - bomb->planted > (unsigned long)max((3000 - world.level * 150) / 3, 333) &&
+            world.matrix[bomb->y][bomb->x] != 4) {
+            world.matrix[bomb->y][bomb->x] = 4;
+        }
+    }
+
+    distance_field(world.distance, passable_walk);
+
+    for(int e = 0; e < MaxEnemies; e++) {
+        Enemy* enemy = &world.enemies[e];
+        if(!enemy->active) {
+            continue;
+        }
+        if(world.player->y == enemy->y && world.player->x == enemy->x) {
+            notification_message(notification, &end);
+            world.running = 0;
+        }
+
+        int interval = enemy->level > 0 ? max((2000 - world.level * 100), 1000) :
+                                          max((1000 - world.level * 50), 500);
+        if(now - enemy->last > (unsigned long)interval) {
+            enemy->last = now;
+            enemy_move(enemy);
+        }
+    }
+
+    // Two enemies on one cell make a stronger one
+    for(int e = 0; e < MaxEnemies; e++) {
+        for(int h = e + 1; h < MaxEnemies && world.enemies[e].active; h++) {
+            if(world.enemies[h].active && world.enemies[e].y == world.enemies[h].y &&
+               world.enemies[e].x == world.enemies[h].x) {
+                world.enemies[h].level++;
+                world.enemies[e].active = false;
+            }
+        }
+    }
+
+    if(vibration) {
+        notification_message(notification, &vibr1);
+    }
 }
 
 static void draw_callback(Canvas* canvas, void* ctx) {
@@ -272,9 +451,6 @@ static void draw_callback(Canvas* canvas, void* ctx) {
     const BomberState* bomber_state = ctx;
 
     furi_mutex_acquire(bomber_state->mutex, FuriWaitForever);
-    if(!BFS()) {
-        init();
-    }
     canvas_clear(canvas);
 
     canvas_draw_icon(canvas, world.endx * 10 + 4, world.endy * 10 + 2, &I_end);
@@ -302,7 +478,6 @@ static void draw_callback(Canvas* canvas, void* ctx) {
                     break;
                 case 6:
                     canvas_draw_icon(canvas, j * 10 + 4, i * 10 + 2, &I_explore);
-                    world.matrix[i][j] = 0;
                     break;
                 }
             }
@@ -316,7 +491,10 @@ static void draw_callback(Canvas* canvas, void* ctx) {
                 canvas, world.player->x * 10 + 4, world.player->y * 10 + 2, &I_playerleft);
         }
 
-        for(int i = 0; i < world.enemies_count; i++) {
+        for(int i = 0; i < MaxEnemies; i++) {
+            if(!world.enemies[i].active) {
+                continue;
+            }
             if(world.enemies[i].level > 0) {
                 canvas_draw_icon(
                     canvas, world.enemies[i].x * 10 + 4, world.enemies[i].y * 10 + 2, &I_enemy1);
@@ -401,16 +579,18 @@ int32_t bomberduck_app(void* p) {
     init();
 
     // Бесконечный цикл обработки очереди событий
-    while(1) {
-        if(furi_message_queue_get(event_queue, &event, 100) == FuriStatusOk) {
-            furi_mutex_acquire(bomber_state->mutex, FuriWaitForever);
+    bool quit = false;
+    while(!quit) {
+        FuriStatus status = furi_message_queue_get(event_queue, &event, 100);
+        furi_mutex_acquire(bomber_state->mutex, FuriWaitForever);
+        if(status == FuriStatusOk) {
             // Если нажата кнопка "назад", то выходим из цикла, а следовательно и из приложения
 
             if(event.type == InputTypePress) {
                 if(event.key == InputKeyOk) {
                     if(world.running) {
                         if(world.matrix[world.player->y][world.player->x] == 0 &&
-                           world.bombs_count < 2) {
+                           world.bombs_count < MaxBombs) {
                             notification_message(notification, &bomb2);
                             world.matrix[world.player->y][world.player->x] = 3;
                             Bomb bomb = {world.player->x, world.player->y, furi_get_tick()};
@@ -447,182 +627,12 @@ int32_t bomberduck_app(void* p) {
                 }
             } else if(event.type == InputTypeLong) {
                 if(event.key == InputKeyBack) {
-                    break;
+                    quit = true;
                 }
             }
         }
         if(world.running) {
-            if(world.player->x == world.endx && world.player->y == world.endy) {
-                notification_message(notification, &end);
-                world.running = 0;
-                world.level += 1;
-                if(world.level % 5 == 0) {
-                    dolphin_deed(DolphinDeedPluginGameWin);
-                }
-            }
-            for(int i = 0; i < world.bombs_count; i++) {
-                if(furi_get_tick() - world.bombs[i].planted >
-                   (unsigned long)max((3000 - world.level * 150), 1000)) {
-                    vibration = false;
-                    world.matrix[world.bombs[i].y][world.bombs[i].x] = 6;
-                    notification_message(notification, &bomb_explore);
-
-                    for(int j = max(0, world.bombs[i].y - BombRange);
-                        j < min(WorldSizeY, world.bombs[i].y + BombRange + 1);
-                        j++) {
-                        if(world.matrix[j][world.bombs[i].x] != 2) {
-                            world.matrix[j][world.bombs[i].x] = 6;
-                            if(j == world.player->y && world.bombs[i].x == world.player->x) {
-                                notification_message(notification, &end);
-                                world.running = 0;
-                            }
-                            for(int e = 0; e < world.enemies_count; e++) {
-                                if(j == world.enemies[e].y &&
-                                   world.bombs[i].x == world.enemies[e].x) {
-                                    if(world.enemies[e].level > 0) {
-                                        world.enemies[e].level--;
-                                    } else {
-                                        for(int l = e; l < world.enemies_count - 1; l++) {
-                                            world.enemies[l] = world.enemies[l + 1];
-                                        }
-                                        world.enemies_count--;
-                                    }
-                                }
-                            }
-                        }
-                    }
-
-                    for(int j = max(0, world.bombs[i].x - BombRange);
-                        j < min(WorldSizeX, world.bombs[i].x + BombRange + 1);
-                        j++) {
-                        if(world.matrix[world.bombs[i].y][j] != 2) {
-                            world.matrix[world.bombs[i].y][j] = 6;
-                            if(world.bombs[i].y == world.player->y && j == world.player->x) {
-                                notification_message(notification, &end);
-                                world.running = 0;
-                            }
-                            for(int e = 0; e < world.enemies_count; e++) {
-                                if(world.bombs[i].y == world.enemies[e].y &&
-                                   j == world.enemies[e].x) {
-                                    if(world.enemies[e].level > 0) {
-                                        world.enemies[e].level--;
-                                    } else {
-                                        for(int l = e; l < world.enemies_count - 1; l++) {
-                                            world.enemies[l] = world.enemies[l + 1];
-                                        }
-                                        world.enemies_count--;
-                                    }
-                                }
-                            }
-                        }
-                    }
-
-                    for(int j = i; j < world.bombs_count - 1; j++) {
-                        world.bombs[j] = world.bombs[j + 1];
-                    }
-                    world.bombs_count--;
-                } else if(
-                    furi_get_tick() - world.bombs[i].planted >
-                        (unsigned long)max((3000 - world.level * 150) * 2 / 3, 666) &&
-                    world.matrix[world.bombs[i].y][world.bombs[i].x] != 5) {
-                    world.matrix[world.bombs[i].y][world.bombs[i].x] = 5;
-                    vibration = true;
-
-                } else if(
-                    furi_get_tick() - world.bombs[i].planted >
-                        (unsigned long)max((3000 - world.level * 150) / 3, 333) &&
-                    world.matrix[world.bombs[i].y][world.bombs[i].x] != 4) {
-                    world.matrix[world.bombs[i].y][world.bombs[i].x] = 4;
-                }
-            }
-            for(int e = 0; e < world.enemies_count; e++) {
-                if(world.player->y == world.enemies[e].y &&
-                   world.player->x == world.enemies[e].x) {
-                    notification_message(notification, &end);
-                    world.running = 0;
-                }
-            }
-
-            for(int e = 0; e < world.enemies_count; e++) {
-                if(world.enemies[e].level > 0) {
-                    if(furi_get_tick() - world.enemies[e].last >
-                       (unsigned long)max((2000 - world.level * 100), 1000)) {
-                        world.enemies[e].last = furi_get_tick();
-                        int move = rand() % 4;
-                        switch(move) {
-                        case 0:
-                            if(world.enemies[e].y > 0 &&
-                               world.matrix[world.enemies[e].y - 1][world.enemies[e].x] != 2)
-                                world.enemies[e].y--;
-                            break;
-                        case 1:
-                            if(world.enemies[e].y < WorldSizeY - 1 &&
-                               world.matrix[world.enemies[e].y + 1][world.enemies[e].x] != 2)
-                                world.enemies[e].y++;
-                            break;
-                        case 2:
-                            world.enemies[e].side = 0;
-                            if(world.enemies[e].x > 0 &&
-                               world.matrix[world.enemies[e].y][world.enemies[e].x - 1] != 2)
-                                world.enemies[e].x--;
-                            break;
-                        case 3:
-                            world.enemies[e].side = 1;
-                            if(world.enemies[e].x < WorldSizeX - 1 &&
-                               world.matrix[world.enemies[e].y][world.enemies[e].x + 1] != 2)
-                                world.enemies[e].x++;
-                        default:
-                            break;
-                        }
-                    }
-                } else {
-                    if(furi_get_tick() - world.enemies[e].last >
-                       (unsigned long)max((1000 - world.level * 50), 500)) {
-                        world.enemies[e].last = furi_get_tick();
-                        int move = rand() % 4;
-                        switch(move) {
-                        case 0:
-                            if(world.enemies[e].y > 0 &&
-                               world.matrix[world.enemies[e].y - 1][world.enemies[e].x] == 0)
-                                world.enemies[e].y--;
-                            break;
-                        case 1:
-                            if(world.enemies[e].y < WorldSizeY - 1 &&
-                               world.matrix[world.enemies[e].y + 1][world.enemies[e].x] == 0)
-                                world.enemies[e].y++;
-                            break;
-                        case 2:
-                            world.enemies[e].side = 0;
-                            if(world.enemies[e].x > 0 &&
-                               world.matrix[world.enemies[e].y][world.enemies[e].x - 1] == 0)
-                                world.enemies[e].x--;
-                            break;
-                        case 3:
-                            world.enemies[e].side = 1;
-                            if(world.enemies[e].x < WorldSizeX - 1 &&
-                               world.matrix[world.enemies[e].y][world.enemies[e].x + 1] == 0)
-                                world.enemies[e].x++;
-                        default:
-                            break;
-                        }
-                    }
-                }
-            }
-            for(int e = 0; e < world.enemies_count; e++) {
-                for(int h = e + 1; h < world.enemies_count; h++) {
-                    if(world.enemies[e].y == world.enemies[h].y &&
-                       world.enemies[e].x == world.enemies[h].x) {
-                        world.enemies[h].level++;
-                        for(int l = e; l < world.enemies_count - 1; l++) {
-                            world.enemies[l] = world.enemies[l + 1];
-                        }
-                        world.enemies_count--;
-                    }
-                }
-            }
-            if(vibration) {
-                notification_message(notification, &vibr1);
-            }
+            tick(notification);
         }
 
         furi_mutex_release(bomber_state->mutex);
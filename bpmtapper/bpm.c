@@ -5,6 +5,8 @@
 #include <input/input.h>
 #include <core/string.h>
 #include <stdlib.h>
+#include <storage/storage.h>
+#include <flipper_format/flipper_format.h>
 #include "bpm_tapper_icons.h"
 
 #include <assets_icons.h>
@@ -19,70 +21,137 @@ typedef struct {
     InputEvent input;
 } PluginEvent;
 
-//QUEUE
+// Intervals between taps are kept as integer ticks in a ring, the tempo is estimated from the
+// ones that agree with their median so a missed or doubled tap doesn't throw it off
 
-struct node {
-    int interval;
-    struct node* next;
-};
-typedef struct node node;
+#define TAP_RING_SIZE 16
+// a longer pause starts a new measurement
+#define TAP_TIMEOUT_MS 3000
+// an interval within this many percent of the median is the same beat
+#define BEAT_TOLERANCE 20
+// this many taps in a row at another tempo replace the old ones
+#define TEMPO_SWITCH_TAPS 4
+
+#define METRONOME_TEMPO_PATH EXT_PATH("apps_data/metronome/tempo.txt")
+#define METRONOME_TEMPO_FILE_TYPE "Metronome Tempo"
+#define METRONOME_TEMPO_FILE_VERSION 1
 
 typedef struct {
-    int size;
-    int max_size;
-    node* front;
-    node* rear;
-} queue;
-
-static void init_queue(queue* q) {
-    q->size = 0;
-    q->max_size = 8;
-    q->front = NULL;
-    q->rear = NULL;
+    uint32_t intervals[TAP_RING_SIZE];
+    uint8_t head; // next slot to write
+    uint8_t count;
+} TapRing;
+
+typedef enum {
+    TempoSwitchNone,
+    TempoSwitchHalf,
+    TempoSwitchDouble,
+    TempoSwitchOther,
+} TempoSwitch;
+
+static void tap_ring_reset(TapRing* ring) {
+    ring->head = 0;
+    ring->count = 0;
+}
+
+static void tap_ring_add(TapRing* ring, uint32_t interval) {
+    ring->intervals[ring->head] = interval;
+    ring->head = (ring->head + 1) % TAP_RING_SIZE;
+    if(ring->count < TAP_RING_SIZE) ring->count++;
+}
+
+// age 0 is the newest interval
+static uint32_t tap_ring_get(const TapRing* ring, uint8_t age) {
+    return ring->intervals[(ring->head + TAP_RING_SIZE - 1 - age) % TAP_RING_SIZE];
+}
+
+static uint32_t median(uint32_t* values, uint8_t count) {
+    for(uint8_t i = 1; i < count; i++) {
+        uint32_t value = values[i];
+        uint8_t j = i;
+        for(; j > 0 && values[j - 1] > value; j--) {
+            values[j] = values[j - 1];
+        }
+        values[j] = value;
+    }
+    return values[count / 2];
 }
 
-static void queue_remove(queue* q) {
-    node* tmp;
-    tmp = q->front;
-    q->front = q->front->next;
-    q->size--;
-    free(tmp);
+static bool same_beat(uint32_t interval, uint32_t beat) {
+    return interval * 100 >= beat * (100 - BEAT_TOLERANCE) &&
+           interval * 100 <= beat * (100 + BEAT_TOLERANCE);
 }
 
-static void queue_add(queue* q, int value) {
-    node* tmp = malloc(sizeof(node));
-    tmp->interval = value;
-    tmp->next = NULL;
-    if(q->size == q->max_size) {
-        queue_remove(q);
+// Median of `count` intervals, starting `age` intervals back
+static uint32_t tap_ring_median(const TapRing* ring, uint8_t age, uint8_t count) {
+    uint32_t sorted[TAP_RING_SIZE];
+    for(uint8_t i = 0; i < count; i++) {
+        sorted[i] = tap_ring_get(ring, age + i);
     }
-    // check if empty
-    if(q->rear == NULL) {
-        q->front = tmp;
-        q->rear = tmp;
-    } else {
-        q->rear->next = tmp;
-        q->rear = tmp;
+    return median(sorted, count);
+}
+
+// When the newest taps all agree on a tempo the older ones don't, only the newest are kept
+static TempoSwitch tap_ring_check_switch(TapRing* ring) {
+    if(ring->count <= TEMPO_SWITCH_TAPS) return TempoSwitchNone;
+
+    uint32_t recent = tap_ring_median(ring, 0, TEMPO_SWITCH_TAPS);
+    uint32_t older =
+        tap_ring_median(ring, TEMPO_SWITCH_TAPS, ring->count - TEMPO_SWITCH_TAPS);
+    for(uint8_t i = 0; i < TEMPO_SWITCH_TAPS; i++) {
+        uint32_t interval = tap_ring_get(ring, i);
+        if(same_beat(interval, older) || !same_beat(interval, recent)) return TempoSwitchNone;
     }
-    q->size++;
+
+    ring->count = TEMPO_SWITCH_TAPS;
+    if(same_beat(recent, older * 2)) return TempoSwitchHalf;
+    if(same_beat(recent * 2, older)) return TempoSwitchDouble;
+    return TempoSwitchOther;
 }
 
-static float queue_avg(queue* q) {
-    float avg = 0.0;
-    if(q->size == 0) {
-        return avg;
-    } else {
-        node* tmp;
-        float sum = 0.0;
-        tmp = q->front;
-        while(tmp != NULL) {
-            sum = sum + tmp->interval;
-            tmp = tmp->next;
+// Averages the intervals close to the median, an interval of about two beats is a missed tap
+// and counts as two. Returns the beat length in ticks and a confidence from 0 to 100.
+static double tap_ring_estimate(const TapRing* ring, uint8_t* confidence) {
+    *confidence = 0;
+    if(ring->count == 0) return 0;
+
+    uint32_t beat = tap_ring_median(ring, 0, ring->count);
+    uint32_t sum = 0;
+    uint8_t beats = 0;
+    uint8_t inliers = 0;
+    for(uint8_t i = 0; i < ring->count; i++) {
+        uint32_t interval = tap_ring_get(ring, i);
+        if(same_beat(interval, beat)) {
+            sum += interval;
+            beats++;
+        } else if(same_beat(interval, beat * 2)) {
+            sum += interval;
+            beats += 2;
+        } else {
+            continue;
         }
-        avg = sum / q->size;
-        FURI_LOG_D("BPM-Tapper", "Sum: %.2f Avg: %.2f", (double)sum, (double)avg);
-        return avg;
+        inliers++;
     }
+
+    // mean absolute deviation of the beats that were kept, in percent of the beat
+    uint32_t deviation = 0;
+    for(uint8_t i = 0; i < ring->count; i++) {
+        uint32_t interval = tap_ring_get(ring, i);
+        uint32_t expected = same_beat(interval, beat) ? sum / beats :
+                            same_beat(interval, beat * 2) ? sum * 2 / beats :
+                                                            0;
+        if(expected == 0) continue;
+        deviation += interval > expected ? interval - expected : expected - interval;
+    }
+    uint32_t spread = deviation * 100 / sum;
+
+    // few taps, rejected taps and a wide spread all lower the confidence
+    uint32_t score = 100 * inliers / ring->count;
+    score = score * MIN(ring->count, TEMPO_SWITCH_TAPS) / TEMPO_SWITCH_TAPS;
+    score = score * (100 - MIN(spread * 4, 100u)) / 100;
+    *confidence = score;
+
+    return (double)sum / beats;
 }
 
 // TOO SLOW!
@@ -96,11 +165,62 @@ typedef struct {
     FuriMutex* mutex;
     int taps;
     double bpm;
+    uint8_t confidence;
+    TempoSwitch tempo_switch;
+    bool sent;
     uint32_t last_stamp;
     uint32_t interval;
-    queue* tap_queue;
+    TapRing tap_ring;
 } BPMTapper;
 
+static void bpm_tap(BPMTapper* bpm_state) {
+    bpm_state->taps++;
+    bpm_state->sent = false;
+    uint32_t new_stamp = furi_get_tick();
+    if(bpm_state->last_stamp == 0) {
+        bpm_state->last_stamp = new_stamp;
+        return;
+    }
+    bpm_state->interval = new_stamp - bpm_state->last_stamp;
+    bpm_state->last_stamp = new_stamp;
+
+    if(bpm_state->interval > furi_ms_to_ticks(TAP_TIMEOUT_MS)) {
+        tap_ring_reset(&bpm_state->tap_ring);
+        bpm_state->tempo_switch = TempoSwitchNone;
+        return;
+    }
+    tap_ring_add(&bpm_state->tap_ring, bpm_state->interval);
+
+    TempoSwitch tempo_switch = tap_ring_check_switch(&bpm_state->tap_ring);
+    if(tempo_switch != TempoSwitchNone) bpm_state->tempo_switch = tempo_switch;
+
+    double beat = tap_ring_estimate(&bpm_state->tap_ring, &bpm_state->confidence);
+    bpm_state->bpm = 60.0 * furi_kernel_get_tick_frequency() / beat;
+    FURI_LOG_D(
+        "BPM-Tapper",
+        "Beat: %.2f BPM: %.2f Conf: %u",
+        beat,
+        bpm_state->bpm,
+        bpm_state->confidence);
+}
+
+// The metronome picks the tempo up the next time it starts
+static bool send_to_metronome(double bpm) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, EXT_PATH("apps_data/metronome"));
+    FlipperFormat* file = flipper_format_file_alloc(storage);
+
+    float value = bpm;
+    bool sent = flipper_format_file_open_always(file, METRONOME_TEMPO_PATH) &&
+                flipper_format_write_header_cstr(
+                    file, METRONOME_TEMPO_FILE_TYPE, METRONOME_TEMPO_FILE_VERSION) &&
+                flipper_format_write_float(file, "BPM", &value, 1);
+
+    flipper_format_free(file);
+    furi_record_close(RECORD_STORAGE);
+    return sent;
+}
+
 static void show_hello() {
     // BEGIN HELLO DIALOG
     DialogsApp* dialogs = furi_record_open(RECORD_DIALOGS);
@@ -145,7 +265,7 @@ static void render_callback(Canvas* const canvas, void* ctx) {
     canvas_draw_str_aligned(canvas, 5, 10, AlignLeft, AlignBottom, furi_string_get_cstr(tempStr));
     furi_string_reset(tempStr);
 
-    furi_string_printf(tempStr, "Queue: %d", bpm_state->tap_queue->size);
+    furi_string_printf(tempStr, "Conf: %d%%", bpm_state->confidence);
     canvas_draw_str_aligned(canvas, 70, 10, AlignLeft, AlignBottom, furi_string_get_cstr(tempStr));
     furi_string_reset(tempStr);
 
@@ -153,6 +273,20 @@ static void render_callback(Canvas* const canvas, void* ctx) {
     canvas_draw_str_aligned(canvas, 5, 20, AlignLeft, AlignBottom, furi_string_get_cstr(tempStr));
     furi_string_reset(tempStr);
 
+    canvas_set_font(canvas, FontSecondary);
+    const char* status = NULL;
+    if(bpm_state->sent) {
+        status = "Sent";
+    } else if(bpm_state->tempo_switch == TempoSwitchHalf) {
+        status = "Half";
+    } else if(bpm_state->tempo_switch == TempoSwitchDouble) {
+        status = "Double";
+    }
+    if(status) {
+        canvas_draw_str_aligned(canvas, 123, 20, AlignRight, AlignBottom, status);
+    }
+    canvas_set_font(canvas, FontPrimary);
+
     furi_string_printf(tempStr, "x2 %.2f /2 %.2f", bpm_state->bpm * 2, bpm_state->bpm / 2);
     canvas_draw_str_aligned(
         canvas, 64, 60, AlignCenter, AlignCenter, furi_string_get_cstr(tempStr));
@@ -174,10 +308,10 @@ static void bpm_state_init(BPMTapper* const plugin_state) {
     plugin_state->bpm = 120.0;
     plugin_state->last_stamp = 0; // furi_get_tick();
     plugin_state->interval = 0;
-    queue* q;
-    q = malloc(sizeof(queue));
-    init_queue(q);
-    plugin_state->tap_queue = q;
+    plugin_state->confidence = 0;
+    plugin_state->tempo_switch = TempoSwitchNone;
+    plugin_state->sent = false;
+    tap_ring_reset(&plugin_state->tap_ring);
     plugin_state->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
 }
 
@@ -218,22 +352,10 @@ int32_t bpm_tapper_app(void* p) {
                 if(event.input.type == InputTypePress) {
                     switch(event.input.key) {
                     case InputKeyUp:
-                    case InputKeyDown:
                     case InputKeyRight:
                     case InputKeyLeft:
                     case InputKeyOk:
-                        bpm_state->taps++;
-                        uint32_t new_stamp = furi_get_tick();
-                        if(bpm_state->last_stamp == 0) {
-                            bpm_state->last_stamp = new_stamp;
-                            break;
-                        }
-                        bpm_state->interval = new_stamp - bpm_state->last_stamp;
-                        bpm_state->last_stamp = new_stamp;
-                        queue_add(bpm_state->tap_queue, bpm_state->interval);
-                        float avg = queue_avg(bpm_state->tap_queue);
-                        float bps = 1.0 / (avg / 1000.0);
-                        bpm_state->bpm = bps * 60.0;
+                        bpm_tap(bpm_state);
                         break;
                     case InputKeyBack:
                         // Exit the plugin
@@ -242,6 +364,18 @@ int32_t bpm_tapper_app(void* p) {
                     default:
                         break;
                     }
+                } else if(event.input.key == InputKeyDown) {
+                    if(event.input.type == InputTypeShort) {
+                        // start over
+                        bpm_state->taps = 0;
+                        bpm_state->last_stamp = 0;
+                        bpm_state->interval = 0;
+                        bpm_state->confidence = 0;
+                        bpm_state->tempo_switch = TempoSwitchNone;
+                        tap_ring_reset(&bpm_state->tap_ring);
+                    } else if(event.input.type == InputTypeLong && bpm_state->confidence > 0) {
+                        bpm_state->sent = send_to_metronome(bpm_state->bpm);
+                    }
                 }
             }
         }
@@ -255,8 +389,6 @@ int32_t bpm_tapper_app(void* p) {
     view_port_free(view_port);
     furi_message_queue_free(event_queue);
     furi_mutex_free(bpm_state->mutex);
-    queue* q = bpm_state->tap_queue;
-    free(q);
     free(bpm_state);
 
     return 0;
@@ -45,6 +45,8 @@ typedef unsigned char byte;
 #define BF_STACK_INITIAL_SIZE 128
 #define BF_INPUT_BUFFER_SIZE 64
 #define BF_STACK_STEP_SIZE 32
+#define BF_CANCEL_CHECK_OPS 4096 //ops between checks for the back button
+#define BF_OUTPUT_REFRESH_RATE 10 //Hz
 
 enum brainfuckCustomEvent {
     // Reserve first 100 events for button types and indexes, starting from 0
@@ -70,6 +72,7 @@ struct BFApp {
     Popup* popup;
     TextInput* text_input;
     TextBox* text_box;
+    FuriTimer* exec_timer;
     FuriString* text_box_store;
     FuriString* BF_file_path;
     BFDevEnv* BF_dev_env;
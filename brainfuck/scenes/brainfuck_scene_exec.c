@@ -1,8 +1,19 @@
 #include "../brainfuck_i.h"
 
+static void brainfuck_scene_exec_env_timer_callback(void* context) {
+    BFApp* app = context;
+    if(workerUpdateOutput()) {
+        text_box_set_text(app->text_box, workerGetOutput());
+    }
+}
+
 void brainfuck_scene_exec_env_on_enter(void* context) {
     BFApp* app = context;
     view_dispatcher_switch_to_view(app->view_dispatcher, brainfuckViewTextBox);
+
+    app->exec_timer = furi_timer_alloc(
+        brainfuck_scene_exec_env_timer_callback, FuriTimerTypePeriodic, app);
+    furi_timer_start(app->exec_timer, furi_kernel_get_tick_frequency() / BF_OUTPUT_REFRESH_RATE);
 }
 
 bool brainfuck_scene_exec_env_on_event(void* context, SceneManagerEvent event) {
@@ -12,5 +23,8 @@ bool brainfuck_scene_exec_env_on_event(void* context, SceneManagerEvent event) {
 }
 
 void brainfuck_scene_exec_env_on_exit(void* context) {
-    UNUSED(context);
+    BFApp* app = context;
+    furi_timer_stop(app->exec_timer);
+    furi_timer_free(app->exec_timer);
+    app->exec_timer = NULL;
 }
@@ -2,17 +2,19 @@
 #include <furi_hal_resources.h>
 #include <furi.h>
 
-bool killswitch = false;
+volatile bool killswitch = false;
 
 int status = 0; //0: idle, 1: running, 2: failure
 
 char* inst = 0;
 int instCount = 0;
-int instPtr = 0;
 int runOpCount = 0;
 
+//the interpreter only appends to the ring, the UI copies it out on its own timer
 char* wOutput = 0;
-int wOutputPtr = 0;
+volatile uint32_t wOutputCount = 0; //characters written in total
+char* wDisplay = 0;
+uint32_t wDisplayCount = 0;
 
 char* wInput = 0;
 int wInputPtr = 0;
@@ -28,22 +30,25 @@ void killThread() {
     killswitch = true;
 }
 
-bool validateInstPtr() {
-    if(instPtr > instCount || instPtr < 0) {
-        return false;
-    }
-    return true;
+char* workerGetOutput() {
+    return wDisplay;
 }
 
-bool validateStackPtr() {
-    if(stackPtr > stackSize || stackPtr < 0) {
+bool workerUpdateOutput() {
+    uint32_t count = wOutputCount;
+    if(count == wDisplayCount) {
         return false;
     }
-    return true;
-}
 
-char* workerGetOutput() {
-    return wOutput;
+    //oldest character first once the ring has wrapped
+    uint32_t length = (count < BF_OUTPUT_SIZE) ? count : BF_OUTPUT_SIZE;
+    for(uint32_t i = 0; i < length; i++) {
+        wDisplay[i] = wOutput[(count - length + i) % BF_OUTPUT_SIZE];
+    }
+    wDisplay[length] = 0x00;
+
+    wDisplayCount = count;
+    return true;
 }
 
 int getStackSize() {
@@ -66,7 +71,14 @@ void initWorker(BFApp* app) {
         free(wOutput);
     }
     wOutput = (char*)malloc(BF_OUTPUT_SIZE);
-    wOutputPtr = 0;
+    wOutputCount = 0;
+
+    if(wDisplay) {
+        free(wDisplay);
+    }
+    wDisplay = (char*)malloc(BF_OUTPUT_SIZE + 1);
+    wDisplay[0] = 0x00;
+    wDisplayCount = 0;
 
     //rebuild stack
     if(bfStack) {
@@ -81,7 +93,6 @@ void initWorker(BFApp* app) {
     //set instructions
     inst = wrkrApp->dataBuffer;
     instCount = wrkrApp->dataSize;
-    instPtr = 0;
     runOpCount = 0;
 
     //set input
@@ -90,72 +101,148 @@ void initWorker(BFApp* app) {
 
     //set status
     status = 0;
+    killswitch = false;
 }
 
-void rShift() {
-    runOpCount++;
-    stackPtr++;
-    if(!validateStackPtr()) {
-        status = 2;
-        return;
+/* The program is compiled before running: runs of +- and <> are folded into
+  one op, [-] and [+] become a single clear and brackets get the index of their
+  pair so jumps don't need to search for it. */
+typedef enum {
+    BFOpAdd, //add arg to the cell
+    BFOpMove, //move the pointer by arg cells
+    BFOpClear,
+    BFOpPrint,
+    BFOpInput,
+    BFOpJumpZero, //[, arg is the op after the matching ]
+    BFOpJumpNotZero, //], arg is the op after the matching [
+    BFOpEnd,
+} BFOpCode;
+
+typedef struct {
+    uint8_t code;
+    int16_t arg;
+} BFOp;
+
+BFOp* program = 0;
+
+static bool isFoldable(char c, char first) {
+    if(first == '+' || first == '-') {
+        return c == '+' || c == '-';
     }
+    return c == '>' || c == '<';
+}
 
-    while(stackPtr > stackSize) {
-        stackSize += BF_STACK_STEP_SIZE;
-        void* tmp = realloc(bfStack, stackSize);
+//returns the unmatched bracket, or 0 on success
+char compileProgram() {
+    int count = 0;
+    int open = -1; //innermost unmatched [, the args of open [ link to the outer one
 
-        if(!tmp) {
-            status = 2;
-            return;
+    program = (BFOp*)malloc(sizeof(BFOp) * (instCount + 1));
+
+    for(int i = 0; i < instCount && inst[i] != 0x00; i++) {
+        char c = inst[i];
+        BFOp* op = &program[count];
+
+        switch(c) {
+        case '+':
+        case '-':
+        case '>':
+        case '<': {
+            int value = 0;
+            while(i < instCount && isFoldable(inst[i], c)) {
+                value += (inst[i] == '+' || inst[i] == '>') ? 1 : -1;
+                i++;
+            }
+            i--;
+
+            if(value == 0) {
+                continue;
+            }
+            op->code = (c == '+' || c == '-') ? BFOpAdd : BFOpMove;
+            op->arg = value;
+            break;
         }
 
-        memset((tmp + stackSize) - BF_STACK_STEP_SIZE, 0x00, BF_STACK_STEP_SIZE);
-        bfStack = (uint8_t*)tmp;
-    };
-    if(stackPtr > stackSizeReal) {
-        stackSizeReal = stackPtr;
+        case '.':
+            op->code = BFOpPrint;
+            break;
+
+        case ',':
+            op->code = BFOpInput;
+            break;
+
+        case '[':
+            if(i + 2 < instCount && (inst[i + 1] == '-' || inst[i + 1] == '+') &&
+               inst[i + 2] == ']') {
+                op->code = BFOpClear;
+                i += 2;
+                break;
+            }
+            op->code = BFOpJumpZero;
+            op->arg = open;
+            open = count;
+            break;
+
+        case ']': {
+            if(open < 0) {
+                return ']';
+            }
+            int pair = open;
+            open = program[pair].arg;
+            program[pair].arg = count + 1;
+            op->code = BFOpJumpNotZero;
+            op->arg = pair + 1;
+            break;
+        }
+
+        default:
+            continue;
+        }
+        count++;
     }
-}
 
-void lShift() {
-    runOpCount++;
-    stackPtr--;
-    if(!validateStackPtr()) {
-        status = 2;
-        return;
+    program[count].code = BFOpEnd;
+
+    if(open >= 0) {
+        return '[';
     }
+    return 0;
 }
 
-void inc() {
-    runOpCount++;
-    if(!validateStackPtr()) {
-        status = 2;
-        return;
+bool moveStackPtr(int offset) {
+    stackPtr += offset;
+    if(stackPtr < 0) {
+        return false;
     }
-    bfStack[stackPtr]++;
-}
 
-void dec() {
-    runOpCount++;
-    if(!validateStackPtr()) {
-        status = 2;
-        return;
+    if(stackPtr >= stackSize) {
+        int newSize = stackSize;
+        while(stackPtr >= newSize) {
+            newSize += BF_STACK_STEP_SIZE;
+        }
+
+        void* tmp = realloc(bfStack, newSize);
+        if(!tmp) {
+            return false;
+        }
+
+        memset((uint8_t*)tmp + stackSize, 0x00, newSize - stackSize);
+        bfStack = (uint8_t*)tmp;
+        stackSize = newSize;
     }
-    bfStack[stackPtr]--;
-}
 
-void print() {
-    runOpCount++;
-    wOutput[wOutputPtr] = bfStack[stackPtr];
-    wOutputPtr++;
-    if(wOutputPtr > (BF_OUTPUT_SIZE - 1)) {
-        wOutputPtr = 0;
+    if(stackPtr > stackSizeReal) {
+        stackSizeReal = stackPtr;
     }
+    return true;
 }
 
-void input() {
-    runOpCount++;
+void print(char c) {
+    wOutput[wOutputCount % BF_OUTPUT_SIZE] = c;
+    wOutputCount++;
+}
 
+void input() {
     bfStack[stackPtr] = (uint8_t)wInput[wInputPtr];
     if(wInput[wInputPtr] == 0x00 || wInputPtr >= 64) {
         wInputPtr = 0;
@@ -164,44 +251,6 @@ void input() {
     }
 }
 
-void loop() {
-    runOpCount++;
-    if(bfStack[stackPtr] == 0) {
-        int loopCount = 1;
-        while(loopCount > 0) {
-            instPtr++;
-            if(!validateInstPtr()) {
-                status = 2;
-                return;
-            }
-            if(inst[instPtr] == '[') {
-                loopCount++;
-            } else if(inst[instPtr] == ']') {
-                loopCount--;
-            }
-        }
-    }
-}
-
-void endLoop() {
-    runOpCount++;
-    if(bfStack[stackPtr] != 0) {
-        int loopCount = 1;
-        while(loopCount > 0) {
-            instPtr--;
-            if(!validateInstPtr()) {
-                status = 2;
-                return;
-            }
-            if(inst[instPtr] == ']') {
-                loopCount++;
-            } else if(inst[instPtr] == '[') {
-                loopCount--;
-            }
-        }
-    }
-}
-
 static const NotificationSequence led_on = {
     &message_blue_255,
     &message_do_not_reset,
@@ -224,68 +273,79 @@ void beginWorker() {
     //redefined from furi_hal_resources.c
     const GpioPin gpio_button_back = {.port = GPIOC, .pin = LL_GPIO_PIN_13};
 
-    while(inst[instPtr] != 0x00) {
-        if(runOpCount % 500 == 0) {
-            text_box_set_text(wrkrApp->text_box, workerGetOutput());
-            notification_message(wrkrApp->notifications, &led_on);
+    char unmatched = compileProgram();
+    if(unmatched) {
+        const char* error = "Error: unmatched ";
+        while(*error) {
+            print(*error++);
         }
+        print(unmatched);
+    }
 
-        //status 2 indicates failure
-        if(status == 2) {
-            status = 0;
-            break;
-        }
+    notification_message(wrkrApp->notifications, &led_on);
 
-        //read back button directly to avoid weirdness in furi
-        if(killswitch || !furi_hal_gpio_read(&gpio_button_back)) {
-            status = 0;
-            killswitch = false;
-            break;
+    const BFOp* op = program;
+    while(!unmatched && op->code != BFOpEnd) {
+        runOpCount++;
+        if((runOpCount % BF_CANCEL_CHECK_OPS) == 0) {
+            //read back button directly to avoid weirdness in furi
+            if(killswitch || !furi_hal_gpio_read(&gpio_button_back)) {
+                killswitch = false;
+                break;
+            }
         }
 
-        switch(inst[instPtr]) {
-        case '>':
-            rShift();
-            break;
-        case '<':
-            lShift();
+        switch(op->code) {
+        case BFOpAdd:
+            bfStack[stackPtr] += op->arg;
             break;
 
-        case '+':
-            inc();
+        case BFOpMove:
+            if(!moveStackPtr(op->arg)) {
+                status = 2;
+            }
             break;
 
-        case '-':
-            dec();
+        case BFOpClear:
+            bfStack[stackPtr] = 0;
             break;
 
-        case '.':
-            print();
+        case BFOpPrint:
+            print(bfStack[stackPtr]);
             break;
 
-        case ',':
+        case BFOpInput:
             input();
             break;
 
-        case '[':
-            loop();
+        case BFOpJumpZero:
+            if(bfStack[stackPtr] == 0) {
+                op = &program[op->arg];
+                continue;
+            }
             break;
 
-        case ']':
-            endLoop();
+        case BFOpJumpNotZero:
+            if(bfStack[stackPtr] != 0) {
+                op = &program[op->arg];
+                continue;
+            }
             break;
 
         default:
             break;
         }
-        instPtr++;
-        if(!validateInstPtr()) {
-            status = 0;
+
+        //status 2 indicates failure
+        if(status == 2) {
             break;
         }
+        op++;
     }
 
+    free(program);
+    program = 0;
+
     notification_message(wrkrApp->notifications, &led_off);
-    text_box_set_text(wrkrApp->text_box, workerGetOutput());
     status = 0;
-}
\ No newline at end of file
+}
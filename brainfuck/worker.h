@@ -4,6 +4,7 @@
 
 void initWorker(BFApp* application);
 char* workerGetOutput();
+bool workerUpdateOutput();
 int getStackSize();
 int getOpCount();
 int getStatus();
@@ -5,10 +5,25 @@
 #include <gui/gui.h>
 #include <gui/view.h>
 #include <gui/view_dispatcher.h>
+#include <gui/modules/submenu.h>
 #include <gui/modules/text_input.h>
 #include <gui/modules/text_box.h>
 
+#include "ciphers.h"
+
 #define TEXT_BUFFER_SIZE 256
+// every Caesar rotation gets listed
+#define MAX_CANDIDATES 25
+#define AFFINE_SHOWN 8
+#define VIGENERE_SHOWN 3
+// the menu entry after the ciphers tries them all
+#define MENU_AUTO CipherCount
+
+typedef enum {
+    CaesarViewMenu,
+    CaesarViewInput,
+    CaesarViewOutput,
+} CaesarView;
 
 typedef enum {
     EventTypeTick,
@@ -23,10 +38,14 @@ typedef struct {
 typedef struct {
     FuriMutex* mutex;
     ViewDispatcher* view_dispatcher;
+    Submenu* submenu;
     TextInput* text_input;
     TextBox* text_box;
+    uint32_t mode;
     char input[TEXT_BUFFER_SIZE];
-    char output[(TEXT_BUFFER_SIZE * 26) + (26)]; // linebreaks
+    char plain[TEXT_BUFFER_SIZE];
+    CipherCandidate candidates[MAX_CANDIDATES];
+    FuriString* output;
 } CaesarState;
 
 static void string_to_uppercase(char* input) {
@@ -40,22 +59,67 @@ static void string_to_uppercase(char* input) {
     }
 }
 
-static void build_output(char* input, char* output) {
-    int out = 0;
-    for(int rot = 1; rot < 26; rot++) {
-        int in;
-        for(in = 0; input[in] != '\0'; in++) {
-            if(input[in] >= 'A' && input[in] <= 'Z') {
-                output[out] = 65 + (((input[in] - 65) + rot) % 26);
-            } else {
-                output[out] = input[in];
+static void describe_candidate(const CipherCandidate* candidate, FuriString* output) {
+    switch(candidate->type) {
+    case CipherCaesar:
+        furi_string_cat_printf(output, "ROT%u", candidate->shift);
+        break;
+    case CipherVigenere:
+        furi_string_cat_printf(output, "Key %s", candidate->key);
+        break;
+    case CipherAffine:
+        furi_string_cat_printf(output, "a=%u b=%u", candidate->multiplier, candidate->shift);
+        break;
+    default:
+        break;
+    }
+}
+
+static void append_candidate(
+    CaesarState* caesar_state,
+    const CipherCandidate* candidate,
+    bool with_name) {
+    if(with_name) {
+        furi_string_cat_printf(caesar_state->output, "%s ", cipher_name(candidate->type));
+    }
+    describe_candidate(candidate, caesar_state->output);
+    if(candidate->type != CipherAtbash || with_name) {
+        furi_string_cat_str(caesar_state->output, ":\n");
+    }
+    cipher_decrypt(candidate, caesar_state->input, caesar_state->plain);
+    furi_string_cat_printf(caesar_state->output, "%s\n", caesar_state->plain);
+}
+
+// Candidates best first, the most English looking plaintext on top
+static void build_output(CaesarState* caesar_state) {
+    furi_string_reset(caesar_state->output);
+    CipherCandidate* candidates = caesar_state->candidates;
+
+    size_t count = 0;
+    if(caesar_state->mode == MENU_AUTO) {
+        // the best guess of each cipher, ranked against each other
+        for(CipherType type = 0; type < CipherCount; type++) {
+            CipherCandidate best;
+            if(!cipher_crack(type, caesar_state->input, &best, 1)) continue;
+            size_t i = count++;
+            for(; i > 0 && candidates[i - 1].cost > best.cost; i--) {
+                candidates[i] = candidates[i - 1];
             }
-            out++;
+            candidates[i] = best;
         }
-        output[out] = '\n';
-        out++;
+    } else {
+        size_t max = MAX_CANDIDATES;
+        if(caesar_state->mode == CipherAffine) max = AFFINE_SHOWN;
+        if(caesar_state->mode == CipherVigenere) max = VIGENERE_SHOWN;
+        count = cipher_crack(caesar_state->mode, caesar_state->input, candidates, max);
+    }
+
+    if(!count) {
+        furi_string_set_str(caesar_state->output, "No letters to work with");
+    }
+    for(size_t i = 0; i < count; i++) {
+        append_candidate(caesar_state, &candidates[i], caesar_state->mode == MENU_AUTO);
     }
-    output[out] = '\0';
 }
 
 static void text_input_callback(void* ctx) {
@@ -67,34 +131,51 @@ static void text_input_callback(void* ctx) {
     // this is where we build the output.
     string_to_uppercase(caesar_state->input);
     FURI_LOG_D("caesar_cipher", "Upper text: %s", caesar_state->input);
-    build_output(caesar_state->input, caesar_state->output);
-    text_box_set_text(caesar_state->text_box, caesar_state->output);
-    view_dispatcher_switch_to_view(caesar_state->view_dispatcher, 1);
+    build_output(caesar_state);
+    text_box_set_text(caesar_state->text_box, furi_string_get_cstr(caesar_state->output));
+    view_dispatcher_switch_to_view(caesar_state->view_dispatcher, CaesarViewOutput);
 
     furi_mutex_release(caesar_state->mutex);
 }
 
-static bool back_event_callback(void* ctx) {
-    const CaesarState* caesar_state = ctx;
+static void submenu_callback(void* ctx, uint32_t index) {
+    furi_assert(ctx);
+    CaesarState* caesar_state = ctx;
     furi_mutex_acquire(caesar_state->mutex, FuriWaitForever);
-    view_dispatcher_stop(caesar_state->view_dispatcher);
+    caesar_state->mode = index;
     furi_mutex_release(caesar_state->mutex);
-    return true;
+    view_dispatcher_switch_to_view(caesar_state->view_dispatcher, CaesarViewInput);
+}
+
+static uint32_t exit_callback(void* ctx) {
+    UNUSED(ctx);
+    return VIEW_NONE;
+}
+
+static uint32_t menu_callback(void* ctx) {
+    UNUSED(ctx);
+    return CaesarViewMenu;
 }
 
 static void caesar_cipher_state_init(CaesarState* const caesar_state) {
     caesar_state->view_dispatcher = view_dispatcher_alloc();
+    caesar_state->submenu = submenu_alloc();
     caesar_state->text_input = text_input_alloc();
     caesar_state->text_box = text_box_alloc();
+    caesar_state->output = furi_string_alloc();
+    caesar_state->mode = CipherCaesar;
     text_box_set_font(caesar_state->text_box, TextBoxFontText);
 }
 
 static void caesar_cipher_state_free(CaesarState* const caesar_state) {
+    view_dispatcher_remove_view(caesar_state->view_dispatcher, CaesarViewMenu);
+    view_dispatcher_remove_view(caesar_state->view_dispatcher, CaesarViewInput);
+    view_dispatcher_remove_view(caesar_state->view_dispatcher, CaesarViewOutput);
+    submenu_free(caesar_state->submenu);
     text_input_free(caesar_state->text_input);
     text_box_free(caesar_state->text_box);
-    view_dispatcher_remove_view(caesar_state->view_dispatcher, 0);
-    view_dispatcher_remove_view(caesar_state->view_dispatcher, 1);
     view_dispatcher_free(caesar_state->view_dispatcher);
+    furi_string_free(caesar_state->output);
     free(caesar_state);
 }
 
@@ -111,6 +192,13 @@ int32_t caesar_cipher_app() {
         return 255;
     }
 
+    for(CipherType type = 0; type < CipherCount; type++) {
+        submenu_add_item(
+            caesar_state->submenu, cipher_name(type), type, submenu_callback, caesar_state);
+    }
+    submenu_add_item(
+        caesar_state->submenu, "Auto detect", MENU_AUTO, submenu_callback, caesar_state);
+
     FURI_LOG_D("caesar_cipher", "Assigning text input callback");
     text_input_set_result_callback(
         caesar_state->text_input,
@@ -130,18 +218,24 @@ int32_t caesar_cipher_app() {
     view_dispatcher_enable_queue(caesar_state->view_dispatcher);
 
     FURI_LOG_D("caesar_cipher", "Adding text input view to dispatcher");
+    view_set_previous_callback(submenu_get_view(caesar_state->submenu), exit_callback);
+    view_dispatcher_add_view(
+        caesar_state->view_dispatcher, CaesarViewMenu, submenu_get_view(caesar_state->submenu));
+    view_set_previous_callback(text_input_get_view(caesar_state->text_input), menu_callback);
     view_dispatcher_add_view(
-        caesar_state->view_dispatcher, 0, text_input_get_view(caesar_state->text_input));
+        caesar_state->view_dispatcher,
+        CaesarViewInput,
+        text_input_get_view(caesar_state->text_input));
+    view_set_previous_callback(text_box_get_view(caesar_state->text_box), menu_callback);
     view_dispatcher_add_view(
-        caesar_state->view_dispatcher, 1, text_box_get_view(caesar_state->text_box));
+        caesar_state->view_dispatcher,
+        CaesarViewOutput,
+        text_box_get_view(caesar_state->text_box));
     FURI_LOG_D("caesar_cipher", "Attaching view dispatcher to GUI");
     view_dispatcher_attach_to_gui(
         caesar_state->view_dispatcher, gui, ViewDispatcherTypeFullscreen);
     FURI_LOG_D("ceasar_cipher", "starting view dispatcher");
-    view_dispatcher_set_navigation_event_callback(
-        caesar_state->view_dispatcher, back_event_callback);
-    view_dispatcher_set_event_callback_context(caesar_state->view_dispatcher, caesar_state);
-    view_dispatcher_switch_to_view(caesar_state->view_dispatcher, 0);
+    view_dispatcher_switch_to_view(caesar_state->view_dispatcher, CaesarViewMenu);
     view_dispatcher_run(caesar_state->view_dispatcher);
 
     furi_record_close("gui");
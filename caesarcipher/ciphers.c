@@ -0,0 +1,357 @@
+#include "ciphers.h"
+#include "english.h"
+
+#include <furi.h>
+#include <stdlib.h>
+#include <string.h>
+
+// key lengths picked by the index of coincidence and Kasiski for a full solve
+#define VIGENERE_TRIED_LENGTHS 6
+#define VIGENERE_PASSES 4
+// a multiple of the key length fits just as well and more key letters always fit a little
+// better, each one has to pay for itself
+#define VIGENERE_KEY_PENALTY 100
+
+static const char* const cipher_names[CipherCount] = {
+    [CipherCaesar] = "Caesar",
+    [CipherVigenere] = "Vigenere",
+    [CipherAffine] = "Affine",
+    [CipherAtbash] = "Atbash",
+};
+
+// a values with an inverse mod 26
+static const uint8_t affine_multipliers[] = {1, 3, 5, 7, 9, 11, 15, 17, 19, 21, 23, 25};
+
+static int8_t letter_index(char c) {
+    if(c >= 'A' && c <= 'Z') return c - 'A';
+    if(c >= 'a' && c <= 'z') return c - 'a';
+    return -1;
+}
+
+static char letter_replace(char c, uint8_t index) {
+    return (c >= 'a' && c <= 'z' ? 'a' : 'A') + index;
+}
+
+static uint8_t mod26(int32_t value) {
+    value %= 26;
+    return value < 0 ? value + 26 : value;
+}
+
+static uint8_t affine_inverse(uint8_t multiplier) {
+    for(uint8_t inverse = 1; inverse < 26; inverse++) {
+        if(multiplier * inverse % 26 == 1) return inverse;
+    }
+    return 1;
+}
+
+// Cost of the letters once mapped, a letter pair counts even across spaces and punctuation
+static uint32_t substitution_cost(const uint8_t* letters, size_t count, const uint8_t* map) {
+    uint32_t cost = 0;
+    for(size_t i = 1; i < count; i++) {
+        cost += english_bigram_cost[map[letters[i - 1]]][map[letters[i]]];
+    }
+    return cost;
+}
+
+static uint32_t
+    vigenere_cost(const uint8_t* letters, size_t count, const uint8_t* key, size_t length) {
+    uint32_t cost = 0;
+    uint8_t previous = mod26(letters[0] - key[0]);
+    for(size_t i = 1; i < count; i++) {
+        uint8_t current = mod26(letters[i] - key[i % length]);
+        cost += english_bigram_cost[previous][current];
+        previous = current;
+    }
+    return cost;
+}
+
+// Letters of the text as 0-25, the caller frees them
+static uint8_t* cipher_letters(const char* text, size_t* count) {
+    uint8_t* letters = malloc(strlen(text) + 1);
+    *count = 0;
+    for(; *text; text++) {
+        int8_t index = letter_index(*text);
+        if(index >= 0) letters[(*count)++] = index;
+    }
+    return letters;
+}
+
+// Keeps the best max candidates in a list sorted best first
+static void candidates_insert(
+    CipherCandidate* candidates,
+    size_t* count,
+    size_t max,
+    const CipherCandidate* candidate) {
+    if(*count == max && candidates[max - 1].cost <= candidate->cost) return;
+    size_t i = *count < max ? (*count)++ : max - 1;
+    for(; i > 0 && candidates[i - 1].cost > candidate->cost; i--) {
+        candidates[i] = candidates[i - 1];
+    }
+    candidates[i] = *candidate;
+}
+
+static size_t caesar_crack(
+    const uint8_t* letters,
+    size_t count,
+    CipherCandidate* candidates,
+    size_t max) {
+    size_t found = 0;
+    for(uint8_t shift = 1; shift < 26; shift++) {
+        uint8_t map[26];
+        for(uint8_t i = 0; i < 26; i++) map[i] = (i + shift) % 26;
+        CipherCandidate candidate = {.type = CipherCaesar, .shift = shift};
+        candidate.cost = substitution_cost(letters, count, map);
+        candidates_insert(candidates, &found, max, &candidate);
+    }
+    return found;
+}
+
+static size_t affine_crack(
+    const uint8_t* letters,
+    size_t count,
+    CipherCandidate* candidates,
+    size_t max) {
+    size_t found = 0;
+    for(size_t m = 0; m < COUNT_OF(affine_multipliers); m++) {
+        uint8_t inverse = affine_inverse(affine_multipliers[m]);
+        for(uint8_t shift = 0; shift < 26; shift++) {
+            // a = 1, b = 0 leaves the text as it is
+            if(m == 0 && shift == 0) continue;
+            uint8_t map[26];
+            for(uint8_t i = 0; i < 26; i++) map[i] = mod26(inverse * (i - shift));
+            CipherCandidate candidate = {
+                .type = CipherAffine, .multiplier = affine_multipliers[m], .shift = shift};
+            candidate.cost = substitution_cost(letters, count, map);
+            candidates_insert(candidates, &found, max, &candidate);
+        }
+    }
+    return found;
+}
+
+static size_t atbash_crack(
+    const uint8_t* letters,
+    size_t count,
+    CipherCandidate* candidates,
+    size_t max) {
+    if(!max) return 0;
+    uint8_t map[26];
+    for(uint8_t i = 0; i < 26; i++) map[i] = 25 - i;
+    candidates[0] = (CipherCandidate){.type = CipherAtbash};
+    candidates[0].cost = substitution_cost(letters, count, map);
+    return 1;
+}
+
+// Average index of coincidence of the columns, English is about 0.066 and random text 0.038
+static float vigenere_coincidence(const uint8_t* letters, size_t count, size_t length) {
+    float total = 0;
+    for(size_t column = 0; column < length; column++) {
+        uint16_t histogram[26] = {0};
+        uint32_t size = 0;
+        for(size_t i = column; i < count; i += length) {
+            histogram[letters[i]]++;
+            size++;
+        }
+        if(size < 2) continue;
+        uint32_t pairs = 0;
+        for(uint8_t i = 0; i < 26; i++) pairs += histogram[i] * (histogram[i] - 1);
+        total += (float)pairs / (size * (size - 1));
+    }
+    return total / length;
+}
+
+// Kasiski: distances between repeated trigrams tend to be multiples of the key length.
+// votes[length] counts the distances length divides.
+static uint32_t
+    vigenere_kasiski(const uint8_t* letters, size_t count, uint16_t* votes, size_t max) {
+    uint32_t repeats = 0;
+    for(size_t i = 0; i + 3 <= count; i++) {
+        for(size_t j = i + 1; j + 3 <= count; j++) {
+            if(memcmp(letters + i, letters + j, 3) != 0) continue;
+            repeats++;
+            for(size_t length = 2; length <= max; length++) {
+                if((j - i) % length == 0) votes[length]++;
+            }
+        }
+    }
+    return repeats;
+}
+
+// Column by column the shift whose letter counts fit English best by chi-squared, then a few
+// rounds of trying every letter at every key position against the pair costs
+static uint32_t vigenere_solve(const uint8_t* letters, size_t count, uint8_t* key, size_t length) {
+    for(size_t column = 0; column < length; column++) {
+        uint16_t histogram[26] = {0};
+        uint32_t size = 0;
+        for(size_t i = column; i < count; i += length) {
+            histogram[letters[i]]++;
+            size++;
+        }
+
+        float best = 0;
+        key[column] = 0;
+        for(uint8_t shift = 0; shift < 26; shift++) {
+            float chi = 0;
+            for(uint8_t plain = 0; plain < 26; plain++) {
+                float expected = size * english_letter_frequency[plain] / 10000.0f + 0.01f;
+                float difference = histogram[(plain + shift) % 26] - expected;
+                chi += difference * difference / expected;
+            }
+            if(shift == 0 || chi < best) {
+                best = chi;
+                key[column] = shift;
+            }
+        }
+    }
+
+    uint32_t cost = vigenere_cost(letters, count, key, length);
+    for(uint8_t pass = 0; pass < VIGENERE_PASSES; pass++) {
+        bool improved = false;
+        for(size_t position = 0; position < length; position++) {
+            uint8_t original = key[position];
+            for(uint8_t shift = 0; shift < 26; shift++) {
+                if(shift == original) continue;
+                uint8_t kept = key[position];
+                key[position] = shift;
+                uint32_t trial = vigenere_cost(letters, count, key, length);
+                if(trial < cost) {
+                    cost = trial;
+                    improved = true;
+                } else {
+                    key[position] = kept;
+                }
+            }
+        }
+        if(!improved) break;
+    }
+    return cost;
+}
+
+// Shortest repeating unit of the key, a key found at twice the real length repeats itself
+static size_t vigenere_period(const uint8_t* key, size_t length) {
+    for(size_t period = 1; period < length; period++) {
+        if(length % period) continue;
+        if(memcmp(key, key + period, length - period) == 0) return period;
+    }
+    return length;
+}
+
+static size_t vigenere_crack(
+    const uint8_t* letters,
+    size_t count,
+    CipherCandidate* candidates,
+    size_t max) {
+    size_t longest = MIN(count / 2, CIPHER_MAX_KEY);
+    if(longest < 1) return 0;
+
+    uint16_t votes[CIPHER_MAX_KEY + 1] = {0};
+    uint32_t repeats = vigenere_kasiski(letters, count, votes, longest);
+
+    float scores[CIPHER_MAX_KEY + 1];
+    for(size_t length = 1; length <= longest; length++) {
+        scores[length] = vigenere_coincidence(letters, count, length);
+        // a length dividing many of the repeat distances gets a boost
+        if(repeats && length > 1) scores[length] *= 1.0f + 0.5f * votes[length] / repeats;
+    }
+
+    size_t lengths[VIGENERE_TRIED_LENGTHS];
+    size_t ranked = 0;
+    for(size_t length = 1; length <= longest; length++) {
+        if(ranked == VIGENERE_TRIED_LENGTHS && scores[lengths[ranked - 1]] >= scores[length]) {
+            continue;
+        }
+
+        size_t i = ranked < VIGENERE_TRIED_LENGTHS ? ranked++ : ranked - 1;
+        for(; i > 0 && scores[lengths[i - 1]] < scores[length]; i--) {
+            lengths[i] = lengths[i - 1];
+        }
+        lengths[i] = length;
+    }
+
+    size_t found = 0;
+    for(size_t i = 0; i < ranked; i++) {
+        uint8_t key[CIPHER_MAX_KEY];
+        uint32_t cost = vigenere_solve(letters, count, key, lengths[i]);
+        size_t period = vigenere_period(key, lengths[i]);
+
+        cost += period * VIGENERE_KEY_PENALTY;
+        CipherCandidate candidate = {.type = CipherVigenere, .cost = cost};
+        for(size_t j = 0; j < period; j++) candidate.key[j] = 'A' + key[j];
+
+        bool duplicate = false;
+        for(size_t j = 0; j < found; j++) {
+            if(strcmp(candidates[j].key, candidate.key) == 0) duplicate = true;
+        }
+        if(!duplicate) candidates_insert(candidates, &found, max, &candidate);
+    }
+
+    return found;
+}
+
+const char* cipher_name(CipherType type) {
+    furi_assert(type < CipherCount);
+    return cipher_names[type];
+}
+
+size_t cipher_crack(CipherType type, const char* text, CipherCandidate* candidates, size_t max) {
+    furi_assert(type < CipherCount);
+    size_t count;
+    uint8_t* letters = cipher_letters(text, &count);
+
+    size_t found = 0;
+    if(count) {
+        switch(type) {
+        case CipherCaesar:
+            found = caesar_crack(letters, count, candidates, max);
+            break;
+        case CipherVigenere:
+            found = vigenere_crack(letters, count, candidates, max);
+            break;
+        case CipherAffine:
+            found = affine_crack(letters, count, candidates, max);
+            break;
+        case CipherAtbash:
+            found = atbash_crack(letters, count, candidates, max);
+            break;
+        default:
+            break;
+        }
+    }
+
+    free(letters);
+    return found;
+}
+
+void cipher_decrypt(const CipherCandidate* candidate, const char* text, char* out) {
+    uint8_t inverse = affine_inverse(candidate->multiplier);
+    size_t key_length = strlen(candidate->key);
+    size_t position = 0;
+
+    for(; *text; text++, out++) {
+        int8_t index = letter_index(*text);
+        if(index < 0) {
+            *out = *text;
+            continue;
+        }
+
+        uint8_t plain = index;
+        switch(candidate->type) {
+        case CipherCaesar:
+            plain = (index + candidate->shift) % 26;
+            break;
+        case CipherVigenere:
+            if(key_length) plain = mod26(index - (candidate->key[position % key_length] - 'A'));
+            break;
+        case CipherAffine:
+            plain = mod26(inverse * (index - candidate->shift));
+            break;
+        case CipherAtbash:
+            plain = 25 - index;
+            break;
+        default:
+            break;
+        }
+        *out = letter_replace(*text, plain);
+        position++;
+    }
+    *out = '\0';
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Classical ciphers and their crackers. Candidate plaintexts are scored by how likely their
+// letter pairs are in English, so the right one comes out on top without reading them all.
+// Only the letters A-Z are touched, everything else passes through.
+
+#define CIPHER_MAX_KEY 16
+
+typedef enum {
+    CipherCaesar,
+    CipherVigenere,
+    CipherAffine,
+    CipherAtbash,
+    CipherCount,
+} CipherType;
+
+typedef struct {
+    CipherType type;
+    // how unlikely the letter pairs of the plaintext are in English, lower is better. Only
+    // comparable between candidates for the same text.
+    uint32_t cost;
+    // Caesar rotation or the affine b
+    uint8_t shift;
+    // the affine a
+    uint8_t multiplier;
+    // Vigenère key, the letters that were added
+    char key[CIPHER_MAX_KEY + 1];
+} CipherCandidate;
+
+const char* cipher_name(CipherType type);
+
+// Fills in up to max candidates for the text, best first, and returns how many there are
+size_t cipher_crack(CipherType type, const char* text, CipherCandidate* candidates, size_t max);
+
+// Plaintext of the text under the candidate's key, out holds as many characters as text
+void cipher_decrypt(const CipherCandidate* candidate, const char* text, char* out);
@@ -0,0 +1,63 @@
+#include "english.h"
+
+// Letter frequencies of English in 1/10000, A to Z
+const uint16_t english_letter_frequency[26] = {
+    729, 187, 311, 363, 1299, 295, 190, 603, 713, 5, 43, 395, 224,
+    653, 755, 211, 20, 670, 641, 1013, 244, 76, 164, 29, 164, 2,
+};
+
+// -log2 of the probability of each letter pair times 8, row is the first letter
+const uint8_t english_bigram_cost[26][26] = {
+    {110, 75, 62, 71, 131, 83, 76, 108, 74, 117, 80, 58, 70,
+     47, 109, 71, 107, 55, 57, 53, 87, 80, 89, 99, 68, 131},
+    {94, 99, 103, 111, 59, 133, 136, 117, 86, 92, 159, 69, 133,
+     131, 71, 129, 146, 82, 82, 106, 77, 133, 129, 125, 65, 159},
+    {72, 108, 85, 111, 60, 122, 131, 63, 71, 129, 79, 78, 129,
+     121, 57, 113, 116, 84, 112, 62, 77, 159, 123, 146, 116, 159},
+    {67, 71, 84, 82, 60, 81, 89, 92, 57, 118, 122, 80, 84,
+     88, 70, 82, 112, 81, 72, 62, 84, 93, 77, 140, 88, 140},
+    {54, 68, 58, 53, 63, 58, 73, 81, 60, 120, 90, 63, 64,
+     53, 62, 64, 82, 45, 48, 54, 89, 75, 69, 72, 73, 127},
+    {68, 98, 91, 107, 75, 81, 93, 106, 67, 136, 133, 73, 99,
+     104, 64, 101, 123, 62, 88, 56, 92, 104, 90, 159, 99, 146},
+    {79, 97, 103, 106, 68, 99, 100, 65, 76, 159, 136, 73, 95,
+     92, 81, 99, 126, 69, 81, 75, 86, 116, 98, 140, 117, 159},
+    {56, 93, 94, 95, 39, 97, 108, 107, 57, 131, 136, 103, 94,
+     100, 66, 91, 125, 80, 91, 63, 93, 112, 89, 159, 98, 136},
+    {81, 78, 61, 69, 72, 70, 65, 98, 99, 159, 90, 68, 72,
+     46, 59, 92, 91, 64, 56, 54, 90, 78, 112, 85, 159, 105},
+    {115, 140, 146, 136, 91, 159, 159, 159, 146, 159, 136, 159, 159,
+     159, 115, 159, 159, 159, 140, 131, 116, 159, 159, 159, 159, 159},
+    {94, 111, 104, 118, 77, 114, 121, 121, 86, 159, 129, 103, 114,
+     85, 104, 109, 131, 108, 92, 99, 121, 127, 112, 136, 121, 159},
+    {63, 84, 94, 78, 56, 89, 105, 109, 60, 140, 118, 60, 92,
+     104, 63, 88, 127, 93, 78, 75, 73, 93, 97, 146, 68, 159},
+    {63, 84, 106, 101, 60, 102, 116, 110, 69, 146, 136, 114, 91,
+     101, 66, 78, 127, 108, 81, 74, 82, 115, 94, 140, 99, 159},
+    {66, 83, 62, 50, 60, 82, 56, 100, 68, 127, 110, 86, 91,
+     86, 62, 87, 112, 96, 61, 52, 84, 87, 84, 140, 78, 159},
+    {77, 70, 84, 74, 92, 51, 82, 100, 79, 131, 91, 63, 62,
+     51, 77, 70, 125, 55, 66, 58, 56, 80, 68, 127, 109, 136},
+    {64, 121, 140, 113, 63, 131, 129, 88, 84, 146, 140, 74, 127,
+     127, 66, 77, 117, 66, 101, 83, 88, 118, 108, 121, 103, 159},
+    {116, 127, 123, 140, 133, 126, 140, 159, 127, 159, 136, 133, 140,
+     129, 140, 140, 146, 110, 121, 121, 74, 159, 140, 159, 146, 159},
+    {54, 80, 72, 71, 47, 78, 83, 97, 59, 122, 85, 86, 75,
+     85, 58, 78, 122, 81, 63, 59, 83, 81, 79, 146, 76, 159},
+    {60, 73, 75, 84, 55, 79, 95, 73, 58, 131, 105, 81, 69,
+     85, 56, 69, 98, 85, 62, 53, 67, 96, 71, 133, 92, 159},
+    {60, 76, 83, 88, 54, 83, 94, 37, 53, 129, 116, 76, 83,
+     94, 54, 82, 103, 66, 64, 61, 76, 102, 68, 112, 79, 131},
+    {77, 85, 75, 95, 77, 99, 80, 121, 85, 159, 136, 73, 74,
+     71, 97, 77, 159, 62, 69, 67, 112, 136, 113, 131, 146, 146},
+    {79, 136, 159, 123, 62, 140, 159, 146, 75, 159, 159, 159, 146,
+     136, 102, 129, 159, 140, 136, 116, 121, 159, 131, 129, 127, 159},
+    {68, 106, 110, 100, 72, 107, 110, 61, 66, 159, 159, 108, 105,
+     93, 75, 123, 146, 106, 94, 93, 133, 121, 103, 146, 133, 159},
+    {105, 129, 96, 101, 105, 113, 123, 103, 84, 159, 159, 131, 136,
+     159, 115, 84, 159, 127, 122, 88, 146, 118, 121, 136, 115, 159},
+    {75, 81, 84, 90, 76, 89, 101, 98, 82, 146, 120, 95, 88,
+     97, 74, 89, 140, 82, 70, 69, 101, 102, 83, 140, 121, 140},
+    {121, 159, 140, 136, 115, 140, 159, 159, 126, 159, 159, 140, 159,
+     159, 118, 159, 159, 146, 140, 129, 140, 159, 140, 159, 146, 159},
+};
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stdint.h>
+
+// Counted over a few hundred thousand letters of English prose, with word gaps left out so
+// text without spaces scores the same
+
+extern const uint16_t english_letter_frequency[26];
+extern const uint8_t english_bigram_cost[26][26];
@@ -47,7 +47,9 @@ CameraSuite* camera_suite_app_alloc() {
     app->dither = 0; // Dither algorithm is "Floyd Steinberg" by default.
     app->flash = 1; // Flash is enabled by default.
     app->haptic = 1; // Haptic is enabled by default
-    app->jpeg = 0; // Save JPEG to ESP32-CAM sd-card is disabled by default.
+    app->jpeg = 0; // Full resolution JPEG from the ESP32-CAM is disabled by default.
+    app->burst = 1; // One picture per shot by default.
+    app->timelapse = 0; // Timelapse is disabled by default.
     app->speaker = 1; // Speaker is enabled by default
     app->led = 1; // LED is enabled by default
 
@@ -34,6 +34,8 @@ typedef struct {
     uint32_t flash;
     uint32_t haptic;
     uint32_t jpeg;
+    uint32_t burst;
+    uint32_t timelapse;
     uint32_t speaker;
     uint32_t led;
     ButtonMenu* button_menu;
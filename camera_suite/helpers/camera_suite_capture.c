@@ -0,0 +1,207 @@
+#include "camera_suite_capture.h"
+#include "../views/camera_suite_view_camera.h"
+
+#define CAPTURE_QUEUE_LENGTH 4
+#define CAPTURE_CHUNK_TIMEOUT_MS 100
+
+typedef enum {
+    CaptureMessageStop,
+    CaptureMessageFrame,
+    CaptureMessageFileBegin,
+    CaptureMessageFileData,
+    CaptureMessageFileEnd,
+} CaptureMessageType;
+
+typedef struct {
+    CaptureMessageType type;
+    bool inverted;
+    CameraSuiteCaptureFormat format;
+    uint16_t length;
+    uint8_t data[FRAME_BUFFER_LENGTH];
+} CaptureMessage;
+
+struct CameraSuiteCapture {
+    FuriThread* thread;
+    FuriMessageQueue* queue;
+    Storage* storage;
+    File* file;
+    FuriString* path;
+    CaptureMessage message; // Being written by the thread.
+    CaptureMessage pending; // Being filled by the producer.
+    uint8_t bitmap[BITMAP_HEADER_LENGTH + FRAME_BUFFER_LENGTH];
+};
+
+// Timestamped name, with a counter appended for pictures taken in the same second.
+static void capture_resolve_path(CameraSuiteCapture* capture, const char* extension) {
+    FuriHalRtcDateTime datetime = {0};
+    furi_hal_rtc_get_datetime(&datetime);
+
+    for(uint32_t i = 0;; ++i) {
+        furi_string_printf(
+            capture->path,
+            EXT_PATH("DCIM/%.4d%.2d%.2d-%.2d%.2d%.2d"),
+            datetime.year,
+            datetime.month,
+            datetime.day,
+            datetime.hour,
+            datetime.minute,
+            datetime.second);
+        if(i > 0) {
+            furi_string_cat_printf(capture->path, "-%lu", i);
+        }
+        furi_string_cat_printf(capture->path, ".%s", extension);
+        if(!storage_file_exists(capture->storage, furi_string_get_cstr(capture->path))) {
+            break;
+        }
+    }
+}
+
+static void capture_write_bitmap(CameraSuiteCapture* capture) {
+    CaptureMessage* message = &capture->message;
+
+    // BMP rows are stored bottom up, and a set bit is white.
+    memcpy(capture->bitmap, bitmap_header, BITMAP_HEADER_LENGTH);
+    uint8_t* row = &capture->bitmap[BITMAP_HEADER_LENGTH];
+    for(size_t i = FRAME_HEIGHT; i > 0; --i) {
+        for(size_t j = 0; j < ROW_BUFFER_LENGTH; ++j) {
+            uint8_t pixel = message->data[((i - 1) * ROW_BUFFER_LENGTH) + j];
+            *row++ = message->inverted ? pixel : ~pixel;
+        }
+    }
+
+    capture_resolve_path(capture, "bmp");
+    if(storage_file_open(
+           capture->file, furi_string_get_cstr(capture->path), FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        // The whole picture in one write.
+        storage_file_write(capture->file, capture->bitmap, sizeof(capture->bitmap));
+    }
+    storage_file_close(capture->file);
+}
+
+static int32_t capture_worker(void* context) {
+    CameraSuiteCapture* capture = context;
+    CaptureMessage* message = &capture->message;
+
+    while(furi_message_queue_get(capture->queue, message, FuriWaitForever) == FuriStatusOk) {
+        if(message->type == CaptureMessageStop) {
+            break;
+        }
+
+        switch(message->type) {
+        case CaptureMessageFrame:
+            capture_write_bitmap(capture);
+            break;
+        case CaptureMessageFileBegin:
+            if(storage_file_is_open(capture->file)) {
+                storage_file_close(capture->file);
+            }
+            capture_resolve_path(
+                capture, message->format == CameraSuiteCaptureFormatJpeg ? "jpg" : "pgm");
+            storage_file_open(
+                capture->file, furi_string_get_cstr(capture->path), FSAM_WRITE, FSOM_CREATE_ALWAYS);
+            break;
+        case CaptureMessageFileData:
+            if(storage_file_is_open(capture->file)) {
+                storage_file_write(capture->file, message->data, message->length);
+            }
+            break;
+        case CaptureMessageFileEnd:
+        default:
+            storage_file_close(capture->file);
+            break;
+        }
+    }
+
+    storage_file_close(capture->file);
+    return 0;
+}
+
+CameraSuiteCapture* camera_suite_capture_alloc() {
+    CameraSuiteCapture* capture = malloc(sizeof(CameraSuiteCapture));
+
+    capture->storage = furi_record_open(RECORD_STORAGE);
+    capture->file = storage_file_alloc(capture->storage);
+    capture->path = furi_string_alloc();
+    capture->queue = furi_message_queue_alloc(CAPTURE_QUEUE_LENGTH, sizeof(CaptureMessage));
+
+    // Create the folder for the image files if it does not exist.
+    if(storage_common_stat(capture->storage, EXT_PATH("DCIM"), NULL) == FSE_NOT_EXIST) {
+        storage_simply_mkdir(capture->storage, EXT_PATH("DCIM"));
+    }
+
+    capture->thread = furi_thread_alloc_ex("CameraCapture", 2048, capture_worker, capture);
+    furi_thread_start(capture->thread);
+
+    return capture;
+}
+
+void camera_suite_capture_free(CameraSuiteCapture* capture) {
+    furi_assert(capture);
+
+    // Queued behind anything still to be written.
+    capture->pending.type = CaptureMessageStop;
+    furi_message_queue_put(capture->queue, &capture->pending, FuriWaitForever);
+
+    furi_thread_join(capture->thread);
+    furi_thread_free(capture->thread);
+
+    furi_message_queue_free(capture->queue);
+    furi_string_free(capture->path);
+    storage_file_free(capture->file);
+    furi_record_close(RECORD_STORAGE);
+    free(capture);
+}
+
+static bool capture_put(CameraSuiteCapture* capture, CaptureMessageType type, uint32_t timeout) {
+    capture->pending.type = type;
+    bool queued = furi_message_queue_put(capture->queue, &capture->pending, timeout) ==
+                  FuriStatusOk;
+    capture->pending.length = 0;
+    return queued;
+}
+
+bool camera_suite_capture_frame(CameraSuiteCapture* capture, const uint8_t* pixels, bool inverted) {
+    furi_assert(capture);
+    furi_assert(pixels);
+
+    // A picture from the ESP32-CAM is being collected.
+    if(capture->pending.length > 0) {
+        return false;
+    }
+
+    memcpy(capture->pending.data, pixels, FRAME_BUFFER_LENGTH);
+    capture->pending.inverted = inverted;
+    return capture_put(capture, CaptureMessageFrame, 0);
+}
+
+void camera_suite_capture_file_begin(CameraSuiteCapture* capture, CameraSuiteCaptureFormat format) {
+    furi_assert(capture);
+
+    capture->pending.format = format;
+    capture_put(capture, CaptureMessageFileBegin, CAPTURE_CHUNK_TIMEOUT_MS);
+}
+
+void camera_suite_capture_file_data(CameraSuiteCapture* capture, const uint8_t* data, size_t length) {
+    furi_assert(capture);
+
+    // Collected into whole chunks, so the writer gets few large writes.
+    while(length > 0) {
+        size_t chunk = MIN(length, (size_t)(FRAME_BUFFER_LENGTH - capture->pending.length));
+        memcpy(&capture->pending.data[capture->pending.length], data, chunk);
+        capture->pending.length += chunk;
+        data += chunk;
+        length -= chunk;
+        if(capture->pending.length == FRAME_BUFFER_LENGTH) {
+            capture_put(capture, CaptureMessageFileData, CAPTURE_CHUNK_TIMEOUT_MS);
+        }
+    }
+}
+
+void camera_suite_capture_file_end(CameraSuiteCapture* capture) {
+    furi_assert(capture);
+
+    if(capture->pending.length > 0) {
+        capture_put(capture, CaptureMessageFileData, CAPTURE_CHUNK_TIMEOUT_MS);
+    }
+    capture_put(capture, CaptureMessageFileEnd, CAPTURE_CHUNK_TIMEOUT_MS);
+}
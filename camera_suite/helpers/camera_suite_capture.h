@@ -0,0 +1,30 @@
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+
+// Saves pictures to the DCIM folder from a thread of its own, so neither the
+// input callback nor the camera worker waits on the SD card. Requests are
+// queued; a frame that does not fit into the queue is dropped. All requests
+// must come from the same thread.
+typedef struct CameraSuiteCapture CameraSuiteCapture;
+
+// Picture formats the ESP32-CAM can send straight to the SD card.
+typedef enum {
+    CameraSuiteCaptureFormatJpeg = 'J',
+    CameraSuiteCaptureFormatGrayscale = 'G', // Complete PGM file.
+} CameraSuiteCaptureFormat;
+
+CameraSuiteCapture* camera_suite_capture_alloc();
+
+// Writes out everything still queued before stopping the thread.
+void camera_suite_capture_free(CameraSuiteCapture* capture);
+
+// Queues a copy of a preview frame to be saved as a BMP.
+bool camera_suite_capture_frame(CameraSuiteCapture* capture, const uint8_t* pixels, bool inverted);
+
+// Streams a picture received from the ESP32-CAM into a new file. Data is
+// collected into 1 KB chunks, which wait briefly for room in the queue.
+void camera_suite_capture_file_begin(CameraSuiteCapture* capture, CameraSuiteCaptureFormat format);
+void camera_suite_capture_file_data(CameraSuiteCapture* capture, const uint8_t* data, size_t length);
+void camera_suite_capture_file_end(CameraSuiteCapture* capture);
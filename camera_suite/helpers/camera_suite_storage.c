@@ -54,6 +54,9 @@ void camera_suite_save_settings(void* context) {
     flipper_format_write_uint32(fff_file, BOILERPLATE_SETTINGS_KEY_DITHER, &app->dither, 1);
     flipper_format_write_uint32(fff_file, BOILERPLATE_SETTINGS_KEY_FLASH, &app->flash, 1);
     flipper_format_write_uint32(fff_file, BOILERPLATE_SETTINGS_KEY_JPEG, &app->jpeg, 1);
+    flipper_format_write_uint32(fff_file, BOILERPLATE_SETTINGS_KEY_BURST, &app->burst, 1);
+    flipper_format_write_uint32(
+        fff_file, BOILERPLATE_SETTINGS_KEY_TIMELAPSE, &app->timelapse, 1);
     flipper_format_write_uint32(fff_file, BOILERPLATE_SETTINGS_KEY_HAPTIC, &app->haptic, 1);
     flipper_format_write_uint32(fff_file, BOILERPLATE_SETTINGS_KEY_SPEAKER, &app->speaker, 1);
     flipper_format_write_uint32(fff_file, BOILERPLATE_SETTINGS_KEY_LED, &app->led, 1);
@@ -109,6 +112,9 @@ void camera_suite_read_settings(void* context) {
     flipper_format_read_uint32(fff_file, BOILERPLATE_SETTINGS_KEY_DITHER, &app->dither, 1);
     flipper_format_read_uint32(fff_file, BOILERPLATE_SETTINGS_KEY_FLASH, &app->flash, 1);
     flipper_format_read_uint32(fff_file, BOILERPLATE_SETTINGS_KEY_JPEG, &app->jpeg, 1);
+    flipper_format_read_uint32(fff_file, BOILERPLATE_SETTINGS_KEY_BURST, &app->burst, 1);
+    flipper_format_read_uint32(
+        fff_file, BOILERPLATE_SETTINGS_KEY_TIMELAPSE, &app->timelapse, 1);
     flipper_format_read_uint32(fff_file, BOILERPLATE_SETTINGS_KEY_HAPTIC, &app->haptic, 1);
     flipper_format_read_uint32(fff_file, BOILERPLATE_SETTINGS_KEY_SPEAKER, &app->speaker, 1);
     flipper_format_read_uint32(fff_file, BOILERPLATE_SETTINGS_KEY_LED, &app->led, 1);
@@ -17,6 +17,8 @@
 #define BOILERPLATE_SETTINGS_KEY_DITHER "Dither"
 #define BOILERPLATE_SETTINGS_KEY_FLASH "Flash"
 #define BOILERPLATE_SETTINGS_KEY_JPEG "SaveJPEG"
+#define BOILERPLATE_SETTINGS_KEY_BURST "Burst"
+#define BOILERPLATE_SETTINGS_KEY_TIMELAPSE "Timelapse"
 #define BOILERPLATE_SETTINGS_KEY_HAPTIC "Haptic"
 #define BOILERPLATE_SETTINGS_KEY_LED "Led"
 #define BOILERPLATE_SETTINGS_KEY_SPEAKER "Speaker"
@@ -49,6 +49,27 @@ const uint32_t jpeg_value[2] = {
     CameraSuiteJpegOn,
 };
 
+// Frames saved per shot.
+const char* const burst_text[4] = {
+    "1",
+    "3",
+    "5",
+    "10",
+};
+
+const uint32_t burst_value[4] = {1, 3, 5, 10};
+
+// Seconds between shots, 0 disables the timelapse.
+const char* const timelapse_text[5] = {
+    "OFF",
+    "5s",
+    "10s",
+    "30s",
+    "60s",
+};
+
+const uint32_t timelapse_value[5] = {0, 5, 10, 30, 60};
+
 const char* const haptic_text[2] = {
     "OFF",
     "ON",
@@ -111,6 +132,22 @@ static void camera_suite_scene_settings_set_jpeg(VariableItem* item) {
     app->jpeg = jpeg_value[index];
 }
 
+static void camera_suite_scene_settings_set_burst(VariableItem* item) {
+    CameraSuite* app = variable_item_get_context(item);
+    uint8_t index = variable_item_get_current_value_index(item);
+
+    variable_item_set_current_value_text(item, burst_text[index]);
+    app->burst = burst_value[index];
+}
+
+static void camera_suite_scene_settings_set_timelapse(VariableItem* item) {
+    CameraSuite* app = variable_item_get_context(item);
+    uint8_t index = variable_item_get_current_value_index(item);
+
+    variable_item_set_current_value_text(item, timelapse_text[index]);
+    app->timelapse = timelapse_value[index];
+}
+
 static void camera_suite_scene_settings_set_haptic(VariableItem* item) {
     CameraSuite* app = variable_item_get_context(item);
     uint8_t index = variable_item_get_current_value_index(item);
@@ -172,19 +209,27 @@ void camera_suite_scene_settings_on_enter(void* context) {
     variable_item_set_current_value_index(item, value_index);
     variable_item_set_current_value_text(item, flash_text[value_index]);
 
-    // @todo - Save picture to ESP32-CAM sd-card instead of Flipper Zero
-    // sd-card. This hides the setting for it, for now.
-    // Save JPEG to ESP32-CAM sd-card instead of Flipper Zero sd-card ON/OFF
-    // item = variable_item_list_add(
-    //     app->variable_item_list,
-    //     "Save JPEG to ext sdcard:",
-    //     2,
-    //     camera_suite_scene_settings_set_jpeg,
-    //     app);
-    // value_index = value_index_uint32(app->jpeg, jpeg_value, 2);
-    // variable_item_set_current_value_index(item, value_index);
-    // variable_item_set_current_value_text(item, jpeg_text[value_index]);
-    UNUSED(camera_suite_scene_settings_set_jpeg);
+    // Save a full resolution JPEG sent by the ESP32-CAM instead of the
+    // preview frame ON/OFF
+    item = variable_item_list_add(
+        app->variable_item_list, "Full Res JPEG:", 2, camera_suite_scene_settings_set_jpeg, app);
+    value_index = value_index_uint32(app->jpeg, jpeg_value, 2);
+    variable_item_set_current_value_index(item, value_index);
+    variable_item_set_current_value_text(item, jpeg_text[value_index]);
+
+    // Burst, frames per shot
+    item = variable_item_list_add(
+        app->variable_item_list, "Burst:", 4, camera_suite_scene_settings_set_burst, app);
+    value_index = value_index_uint32(app->burst, burst_value, 4);
+    variable_item_set_current_value_index(item, value_index);
+    variable_item_set_current_value_text(item, burst_text[value_index]);
+
+    // Timelapse interval
+    item = variable_item_list_add(
+        app->variable_item_list, "Timelapse:", 5, camera_suite_scene_settings_set_timelapse, app);
+    value_index = value_index_uint32(app->timelapse, timelapse_value, 5);
+    variable_item_set_current_value_index(item, value_index);
+    variable_item_set_current_value_text(item, timelapse_text[value_index]);
 
     // Haptic FX ON/OFF
     item = variable_item_list_add(
@@ -59,6 +59,11 @@ static void camera_suite_view_camera_draw(Canvas* canvas, void* model) {
         }
     }
 
+    if(uartDumpModel->timelapse) {
+        canvas_set_font(canvas, FontSecondary);
+        canvas_draw_str(canvas, 2, 62, "TL");
+    }
+
     // Draw the guide if the camera is not initialized.
     if(!uartDumpModel->initialized) {
         canvas_draw_icon(canvas, 74, 16, &I_DolphinCommon_56x48);
@@ -71,98 +76,47 @@ static void camera_suite_view_camera_draw(Canvas* canvas, void* model) {
     }
 }
 
-static void save_image(void* model) {
-    furi_assert(model);
-
-    UartDumpModel* uartDumpModel = model;
-
-    // This pointer is used to access the storage.
-    Storage* storage = furi_record_open(RECORD_STORAGE);
-
-    // This pointer is used to access the filesystem.
-    File* file = storage_file_alloc(storage);
-
-    // Store path in local variable.
-    const char* folderName = EXT_PATH("DCIM");
-
-    // Create the folder name for the image file if it does not exist.
-    if(storage_common_stat(storage, folderName, NULL) == FSE_NOT_EXIST) {
-        storage_simply_mkdir(storage, folderName);
-    }
-
-    // This pointer is used to access the file name.
-    FuriString* file_name = furi_string_alloc();
-
-    // Get the current date and time.
-    FuriHalRtcDateTime datetime = {0};
-    furi_hal_rtc_get_datetime(&datetime);
-
-    // Create the file name.
-    furi_string_printf(
-        file_name,
-        EXT_PATH("DCIM/%.4d%.2d%.2d-%.2d%.2d%.2d.bmp"),
-        datetime.year,
-        datetime.month,
-        datetime.day,
-        datetime.hour,
-        datetime.minute,
-        datetime.second);
-
-    // Open the file for writing. If the file does not exist (it shouldn't),
-    // create it.
-    bool result =
-        storage_file_open(file, furi_string_get_cstr(file_name), FSAM_WRITE, FSOM_OPEN_ALWAYS);
-
-    // Free the file name after use.
-    furi_string_free(file_name);
-
-    if(!uartDumpModel->inverted) {
-        for(size_t i = 0; i < FRAME_BUFFER_LENGTH; ++i) {
-            uartDumpModel->pixels[i] = ~uartDumpModel->pixels[i];
-        }
-    }
-
-    // If the file was opened successfully, write the bitmap header and the
-    // image data.
-    if(result) {
-        // Write BMP Header
-        storage_file_write(file, bitmap_header, BITMAP_HEADER_LENGTH);
-
-        // @todo - Add a function for saving the image directly from the
-        // ESP32-CAM to the Flipper Zero SD card.
-
-        // Write locally to the Flipper Zero SD card in the DCIM folder.
-        int8_t row_buffer[ROW_BUFFER_LENGTH];
+// Pictures are saved by the capture thread, this only asks for them.
+static void take_picture(CameraSuiteViewCamera* instance) {
+    CameraSuite* instance_context = instance->context;
 
-        // @todo - Save image based on orientation.
-        for(size_t i = 64; i > 0; --i) {
-            for(size_t j = 0; j < ROW_BUFFER_LENGTH; ++j) {
-                row_buffer[j] = uartDumpModel->pixels[((i - 1) * ROW_BUFFER_LENGTH) + j];
-            }
-            storage_file_write(file, row_buffer, ROW_BUFFER_LENGTH);
-        }
+    if(instance_context->jpeg) {
+        // Ask the ESP32-CAM for a full resolution picture, it arrives as a
+        // 'P' packet and bypasses the preview.
+        uint8_t picture = 'P';
+        furi_hal_uart_tx(UART_CH, &picture, 1);
+    } else {
+        // Save the next frames as they complete.
+        instance->capture_remaining = instance_context->burst;
     }
+}
 
-    // Close the file.
-    storage_file_close(file);
-
-    // Free up memory.
-    storage_file_free(file);
+static void timelapse_timer_callback(void* context) {
+    furi_assert(context);
+    take_picture(context);
 }
 
-static void
-    camera_suite_view_camera_model_init(UartDumpModel* const model, CameraSuite* instance_context) {
+static void camera_suite_view_camera_model_init(
+    UartDumpModel* const model,
+    CameraSuiteViewCamera* instance) {
     furi_assert(model);
-    furi_assert(instance_context);
+    furi_assert(instance);
 
-    for(size_t i = 0; i < FRAME_BUFFER_LENGTH; i++) {
-        model->pixels[i] = 0;
-    }
+    CameraSuite* instance_context = instance->context;
+
+    // Start over with blank frames and no partial row.
+    memset(instance->frames, 0, sizeof(instance->frames));
+    instance->back_frame = 1;
+    instance->row_index = 0;
+    instance->picture_remaining = 0;
+    instance->capture_remaining = 0;
+    model->pixels = instance->frames[0];
 
     uint32_t orientation = instance_context->orientation;
     model->flash = instance_context->flash;
     model->inverted = false;
     model->orientation = orientation;
+    model->timelapse = false;
 }
 
 static bool camera_suite_view_camera_input(InputEvent* event, void* context) {
@@ -285,27 +239,27 @@ static bool camera_suite_view_camera_input(InputEvent* event, void* context) {
                 instance->view,
                 UartDumpModel * model,
                 {
+                    CameraSuite* instance_context = instance->context;
                     camera_suite_play_long_bump(instance->context);
                     camera_suite_play_input_sound(instance->context);
                     camera_suite_led_set_rgb(instance->context, 0, 0, 255);
 
-                    // Save picture directly to ESP32-CAM.
-                    // @todo - Add this functionality.
-                    // data[0] = 'P';
-                    // furi_hal_uart_tx(UART_CH, data, 1);
-
-                    // if(model->flash) {
-                    //     data[0] = 'F';
-                    //     furi_hal_uart_tx(UART_CH, data, 1);
-                    //     furi_delay_ms(50);
-                    // }
-
-                    // Take a picture.
-                    save_image(model);
+                    if(instance_context->timelapse) {
+                        // Start or stop taking a picture every interval.
+                        model->timelapse = !model->timelapse;
+                        if(model->timelapse) {
+                            take_picture(instance);
+                            furi_timer_start(
+                                instance->timelapse_timer,
+                                furi_ms_to_ticks(instance_context->timelapse * 1000));
+                        } else {
+                            furi_timer_stop(instance->timelapse_timer);
+                        }
+                    } else {
+                        // Take a picture.
+                        take_picture(instance);
+                    }
 
-                    // if(model->flash) {
-                    //     data[0] = 'f';
-                    // }
                     instance->callback(CameraSuiteCustomEventSceneCameraOk, instance->context);
                 },
                 true);
@@ -327,7 +281,10 @@ static bool camera_suite_view_camera_input(InputEvent* event, void* context) {
 }
 
 static void camera_suite_view_camera_exit(void* context) {
-    UNUSED(context);
+    furi_assert(context);
+
+    CameraSuiteViewCamera* instance = context;
+    furi_timer_stop(instance->timelapse_timer);
 
     // Set the camera flash to off.
     uint8_t flash_off = 'f';
@@ -378,70 +335,109 @@ static void camera_suite_view_camera_enter(void* context) {
     with_view_model(
         instance->view,
         UartDumpModel * model,
-        { camera_suite_view_camera_model_init(model, instance_context); },
+        { camera_suite_view_camera_model_init(model, instance); },
         true);
 }
 
-static void camera_on_irq_cb(UartIrqEvent uartIrqEvent, uint8_t data, void* context) {
-    furi_assert(uartIrqEvent);
-    furi_assert(data);
-    furi_assert(context);
-
-    // Cast `context` to `CameraSuiteViewCamera*` and store it in `instance`.
-    CameraSuiteViewCamera* instance = context;
-
-    // If `uartIrqEvent` is `UartIrqEventRXNE`, send the data to the
-    // `rx_stream` and set the `WorkerEventRx` flag.
-    if(uartIrqEvent == UartIrqEventRXNE) {
-        furi_stream_buffer_send(instance->rx_stream, &data, 1, 0);
-        furi_thread_flags_set(furi_thread_get_id(instance->worker_thread), WorkerEventRx);
-    }
+// Make the back frame the one drawn, the old front frame receives the next rows.
+static void swap_frames(CameraSuiteViewCamera* instance) {
+    with_view_model(
+        instance->view,
+        UartDumpModel * model,
+        {
+            // Queue the completed frame while a burst is running.
+            if(instance->capture_remaining > 0 &&
+               camera_suite_capture_frame(
+                   instance->capture, instance->frames[instance->back_frame], model->inverted)) {
+                instance->capture_remaining--;
+            }
+            model->pixels = instance->frames[instance->back_frame];
+            model->initialized = true; // Set the connection as successfully established.
+        },
+        true);
+    instance->back_frame ^= 1;
 }
 
-static void process_ringbuffer(UartDumpModel* model, uint8_t const byte) {
-    furi_assert(model);
-    furi_assert(byte);
-
-    // The first HEADER_LENGTH bytes are reserved for header information.
-    if(model->ringbuffer_index < HEADER_LENGTH) {
-        // Validate the start of row characters 'Y' and ':'.
-        if(model->ringbuffer_index == 0 && byte != 'Y') {
-            // Incorrect start of frame; reset.
-            return;
-        }
-        if(model->ringbuffer_index == 1 && byte != ':') {
-            // Incorrect start of frame; reset.
-            model->ringbuffer_index = 0;
-            return;
-        }
-        if(model->ringbuffer_index == 2) {
-            // Assign the third byte as the row identifier.
-            model->row_identifier = byte;
-        }
-        model->ringbuffer_index++; // Increment index for the next byte.
-        return;
-    }
+// Rows arrive as 'Y', ':', row identifier and ROW_BUFFER_LENGTH pixel bytes.
+// Pixel bytes are copied straight into the back frame, a chunk at a time.
+// Pictures arrive as a PICTURE_HEADER_LENGTH header and the file contents.
+static void process_rows(CameraSuiteViewCamera* instance, const uint8_t* data, size_t length) {
+    furi_assert(instance);
 
-    // Store pixel value directly after the header.
-    model->row_ringbuffer[model->ringbuffer_index - HEADER_LENGTH] = byte;
-    model->ringbuffer_index++; // Increment index for the next byte.
+    while(length > 0) {
+        // Picture contents go to the capture thread as they are.
+        if(instance->picture_remaining > 0) {
+            size_t chunk = MIN(length, instance->picture_remaining);
+            camera_suite_capture_file_data(instance->capture, data, chunk);
+            instance->picture_remaining -= chunk;
+            data += chunk;
+            length -= chunk;
+            if(instance->picture_remaining == 0) {
+                camera_suite_capture_file_end(instance->capture);
+            }
+            continue;
+        }
 
-    // Check whether the ring buffer is filled.
-    if(model->ringbuffer_index >= RING_BUFFER_LENGTH) {
-        model->ringbuffer_index = 0; // Reset the ring buffer index.
-        model->initialized = true; // Set the connection as successfully established.
+        // The first HEADER_LENGTH bytes are reserved for header information.
+        if(instance->row_index < HEADER_LENGTH ||
+           (instance->packet_type == 'P' && instance->row_index < PICTURE_HEADER_LENGTH)) {
+            uint8_t byte = *data++;
+            length--;
+            if(instance->row_index == 0) {
+                if(byte != 'Y' && byte != 'P') {
+                    // Incorrect start of packet; keep looking.
+                    continue;
+                }
+                instance->packet_type = byte;
+                instance->picture_remaining = 0;
+            }
+            if(instance->row_index == 1 && byte != ':') {
+                // Incorrect start of packet; this byte may start the next one.
+                instance->row_index = (byte == 'Y' || byte == 'P') ? 1 : 0;
+                instance->packet_type = byte;
+                continue;
+            }
+            if(instance->row_index == 2) {
+                // Row identifier or picture format.
+                instance->row_identifier = byte;
+            }
+            if(instance->row_index >= HEADER_LENGTH) {
+                instance->picture_remaining |= (uint32_t)byte
+                                               << (8 * (instance->row_index - HEADER_LENGTH));
+            }
+            instance->row_index++;
+
+            if(instance->packet_type == 'P' && instance->row_index == PICTURE_HEADER_LENGTH) {
+                instance->row_index = 0;
+                if(instance->picture_remaining > PICTURE_MAX_LENGTH) {
+                    // Not a sane length; resynchronize on the next packet.
+                    instance->picture_remaining = 0;
+                } else if(instance->picture_remaining > 0) {
+                    camera_suite_capture_file_begin(instance->capture, instance->row_identifier);
+                }
+            }
+            continue;
+        }
 
-        // Compute the starting index for the row in the pixel buffer.
-        size_t row_start_index = model->row_identifier * ROW_BUFFER_LENGTH;
+        size_t received = instance->row_index - HEADER_LENGTH;
+        size_t chunk = MIN(length, ROW_BUFFER_LENGTH - received);
 
-        // Ensure the row start index is within the valid range.
-        if(row_start_index > LAST_ROW_INDEX) {
-            row_start_index = 0; // Reset to a safe value in case of an overflow.
+        // Rows outside the frame are consumed but not stored.
+        if(instance->row_identifier < FRAME_HEIGHT) {
+            uint8_t* row =
+                &instance->frames[instance->back_frame]
+                                 [instance->row_identifier * ROW_BUFFER_LENGTH];
+            memcpy(&row[received], data, chunk);
         }
-
-        // Flush the contents of the ring buffer to the pixel buffer.
-        for(size_t i = 0; i < ROW_BUFFER_LENGTH; ++i) {
-            model->pixels[row_start_index + i] = model->row_ringbuffer[i];
+        instance->row_index += chunk;
+        data += chunk;
+        length -= chunk;
+
+        if(instance->row_index >= RING_BUFFER_LENGTH) {
+            instance->row_index = 0;
+            if(instance->row_identifier == FRAME_HEIGHT - 1) {
+                swap_frames(instance);
+            }
         }
     }
 }
@@ -450,6 +446,7 @@ static int32_t camera_worker(void* context) {
     furi_assert(context);
 
     CameraSuiteViewCamera* instance = context;
+    uint8_t data[RX_CHUNK_LENGTH];
 
     while(1) {
         uint32_t events =
@@ -459,28 +456,12 @@ static int32_t camera_worker(void* context) {
         if(events & WorkerEventStop) {
             break;
         } else if(events & WorkerEventRx) {
+            // Parsing runs without the model lock, only a frame swap takes it.
             size_t length = 0;
             do {
-                size_t intended_data_size = 64;
-                uint8_t data[intended_data_size];
-                length =
-                    furi_stream_buffer_receive(instance->rx_stream, data, intended_data_size, 0);
-
-                if(length > 0) {
-                    with_view_model(
-                        instance->view,
-                        UartDumpModel * model,
-                        {
-                            for(size_t i = 0; i < length; i++) {
-                                process_ringbuffer(model, data[i]);
-                            }
-                        },
-                        false);
-                }
+                length = uart_dma_receive(instance->rx_dma, data, sizeof(data));
+                process_rows(instance, data, length);
             } while(length > 0);
-
-            with_view_model(
-                instance->view, UartDumpModel * model, { UNUSED(model); }, true);
         }
     }
 
@@ -494,11 +475,21 @@ CameraSuiteViewCamera* camera_suite_view_camera_alloc() {
     // Allocate the view object
     instance->view = view_alloc();
 
-    // Allocate a stream buffer
-    instance->rx_stream = furi_stream_buffer_alloc(2048, 1);
+    // Allocate the DMA receive buffer
+    instance->rx_dma = uart_dma_alloc(2048);
+
+    // Allocate the picture writer and the timelapse timer
+    instance->capture = camera_suite_capture_alloc();
+    instance->timelapse_timer =
+        furi_timer_alloc(timelapse_timer_callback, FuriTimerTypePeriodic, instance);
 
     // Allocate model
     view_allocate_model(instance->view, ViewModelTypeLocking, sizeof(UartDumpModel));
+    with_view_model(
+        instance->view,
+        UartDumpModel * model,
+        { model->pixels = instance->frames[0]; },
+        false);
 
     // Set context for the view
     view_set_context(instance->view, instance);
@@ -530,8 +521,9 @@ CameraSuiteViewCamera* camera_suite_view_camera_alloc() {
     // 115200 is the default baud rate for the ESP32-CAM.
     furi_hal_uart_set_br(UART_CH, 230400);
 
-    // Enable UART1 and set the IRQ callback.
-    furi_hal_uart_set_irq_cb(UART_CH, camera_on_irq_cb, instance);
+    // Start receiving into the DMA buffer.
+    uart_dma_start(
+        instance->rx_dma, UART_CH, furi_thread_get_id(instance->worker_thread), WorkerEventRx);
 
     return instance;
 }
@@ -539,14 +531,20 @@ CameraSuiteViewCamera* camera_suite_view_camera_alloc() {
 void camera_suite_view_camera_free(CameraSuiteViewCamera* instance) {
     furi_assert(instance);
 
-    // Remove the IRQ callback.
-    furi_hal_uart_set_irq_cb(UART_CH, NULL, NULL);
+    // Stop receiving and remove the IRQ callback.
+    uart_dma_stop(instance->rx_dma);
 
-    // Free the worker thread.
+    // Stop and free the worker thread, it is the only one feeding the writer.
+    furi_thread_flags_set(furi_thread_get_id(instance->worker_thread), WorkerEventStop);
+    furi_thread_join(instance->worker_thread);
     furi_thread_free(instance->worker_thread);
 
-    // Free the allocated stream buffer.
-    furi_stream_buffer_free(instance->rx_stream);
+    // Free the DMA receive buffer.
+    uart_dma_free(instance->rx_dma);
+
+    // Write out queued pictures and free the writer.
+    furi_timer_free(instance->timelapse_timer);
+    camera_suite_capture_free(instance->capture);
 
     // Re-enable the console.
     if(UART_CH == FuriHalUartIdLPUART1) {
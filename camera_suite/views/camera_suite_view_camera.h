@@ -1,6 +1,8 @@
 #pragma once
 
+#include "../helpers/camera_suite_capture.h"
 #include "../helpers/camera_suite_custom_event.h"
+#include "../helpers/uart_dma.h"
 #include <furi.h>
 #include <furi_hal.h>
 #include <furi_hal_console.h>
@@ -28,8 +30,13 @@
 #define FRAME_WIDTH 128
 #define HEADER_LENGTH 3 // 'Y', ':', and row identifier
 #define LAST_ROW_INDEX 1008
+// 'P', ':', picture format, and the picture length as 4 bytes little endian.
+// The picture file follows and goes straight to the SD card.
+#define PICTURE_HEADER_LENGTH 7
+#define PICTURE_MAX_LENGTH (1024 * 1024)
 #define RING_BUFFER_LENGTH 19
 #define ROW_BUFFER_LENGTH 16
+#define RX_CHUNK_LENGTH 256 // Bytes taken from the DMA ring per parsing pass
 
 static const unsigned char bitmap_header[BITMAP_HEADER_LENGTH] = {
     0x42, 0x4D, 0x3E, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3E, 0x00, 0x00, 0x00, 0x28, 0x00,
@@ -51,11 +58,22 @@ typedef void (*CameraSuiteViewCameraCallback)(CameraSuiteCustomEvent event, void
 
 typedef struct CameraSuiteViewCamera {
     CameraSuiteViewCameraCallback callback;
-    FuriStreamBuffer* rx_stream;
+    UartDma* rx_dma;
     FuriThread* worker_thread;
     NotificationApp* notification;
     View* view;
     void* context;
+    // Rows are written into the back frame by the worker, the model points at
+    // the front frame, which only changes when a complete frame is swapped in.
+    uint8_t frames[2][FRAME_BUFFER_LENGTH];
+    uint8_t back_frame;
+    uint8_t row_index; // Bytes of the current row received so far, header included.
+    uint8_t row_identifier;
+    uint8_t packet_type; // 'Y' for a row, 'P' for a picture.
+    uint32_t picture_remaining; // Picture bytes still to be passed to the writer.
+    CameraSuiteCapture* capture;
+    uint8_t capture_remaining; // Completed frames still to be saved by a burst.
+    FuriTimer* timelapse_timer;
 } CameraSuiteViewCamera;
 
 typedef struct UartDumpModel {
@@ -63,11 +81,9 @@ typedef struct UartDumpModel {
     bool initialized;
     bool inverted;
     int rotation_angle;
+    bool timelapse;
     uint32_t orientation;
-    uint8_t pixels[FRAME_BUFFER_LENGTH];
-    uint8_t ringbuffer_index;
-    uint8_t row_identifier;
-    uint8_t row_ringbuffer[RING_BUFFER_LENGTH];
+    const uint8_t* pixels; // Front frame, stable until the next swap.
 } UartDumpModel;
 
 // Function Prototypes
@@ -112,6 +112,28 @@ void SCL_randomBetterSeed(uint16_t seed);
 #define SCL_ALPHA_BETA 1
 #endif
 
+#ifndef SCL_TRANSPOSITION_TABLE_SIZE
+/**
+    Number of entries (power of two) of the transposition table in which the
+    AI remembers already searched positions (by their Zobrist key) to skip
+    searching them again and to try their best move first. Each entry takes
+    12 bytes of RAM, 0 turns the table off.
+  */
+#define SCL_TRANSPOSITION_TABLE_SIZE 512
+#endif
+
+#ifndef SCL_BITBOARDS
+/**
+    If 1, the board state also keeps bitboards (64 bit sets) of squares taken
+    by each side and attack checks and move generation use them along with
+    precomputed attack tables instead of trying the moves of all pieces. This
+    makes the AI a lot faster, but each board takes 16 more bytes and the
+    tables take 5 KB of constant data (in RAM on AVR Arduinos, so keep it off
+    there).
+  */
+#define SCL_BITBOARDS 0
+#endif
+
 /**
   A set of game squares as a bit array, each bit representing one game square.
   Useful for representing e.g. possible moves. To easily iterate over the set
@@ -163,7 +185,11 @@ uint8_t SCL_squareSetGetRandom(const SCL_SquareSet squareSet, SCL_RandomFunction
 #define SCL_SQUARE_SET_ITERATE(squareSet, command) \
     SCL_SQUARE_SET_ITERATE_BEGIN(squareSet){command} SCL_SQUARE_SET_ITERATE_END
 
-#define SCL_BOARD_STATE_SIZE 69
+#if SCL_BITBOARDS
+#define SCL_BOARD_STATE_SIZE 89
+#else
+#define SCL_BOARD_STATE_SIZE 73
+#endif
 
 /**
   Represents chess board state as a string in this format:
@@ -195,8 +221,14 @@ uint8_t SCL_squareSetGetRandom(const SCL_SquareSet squareSet, SCL_RandomFunction
       the last pawn move or capture.
     - 67: Extra byte, left for storing additional info in variants. For normal
       chess this byte should always be 0.
-    - 68: The last byte is always 0 to properly terminate the string in case
+    - 68: This byte is always 0 to properly terminate the string in case
       someone tries to print it.
+    - 69-72: Zobrist key of the position (little endian), see
+      SCL_boardZobrist. SCL_boardMakeMove and SCL_boardUndoMove update it
+      incrementally, functions setting up a board compute it.
+    - 73-88: Only with SCL_BITBOARDS, sets of squares taken by white (73-80)
+      and black (81-88) pieces in the same format as SCL_SquareSet, kept up
+      to date the same way as the Zobrist key.
   - The state is designed so as to be simple and also print-friendly, i.e. you
     can simply print it with line break after 8 characters to get a human
     readable representation of the board.
@@ -214,6 +246,9 @@ typedef char SCL_Board[SCL_BOARD_STATE_SIZE];
 #define SCL_BOARD_PLY_BYTE 65
 #define SCL_BOARD_MOVE_COUNT_BYTE 66
 #define SCL_BOARD_EXTRA_BYTE 67
+#define SCL_BOARD_TERMINATOR_BYTE 68
+#define SCL_BOARD_ZOBRIST_BYTE 69
+#define SCL_BOARD_BITBOARD_BYTE 73
 
 #if SCL_960_CASTLING
 #define _SCL_EXTRA_BYTE_VALUE (0 | (7 << 3)) // rooks on classic positions
@@ -221,12 +256,20 @@ typedef char SCL_Board[SCL_BOARD_STATE_SIZE];
 #define _SCL_EXTRA_BYTE_VALUE 0
 #endif
 
+#if SCL_BITBOARDS
+#define _SCL_BITBOARD_START_STATE                                                          \
+    , (char)0xff, (char)0xff, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, (char)0xff, (char)0xff
+#else
+#define _SCL_BITBOARD_START_STATE
+#endif
+
 #define SCL_BOARD_START_STATE                                                                   \
     {                                                                                           \
         82, 78, 66, 81, 75, 66, 78, 82, 80, 80, 80, 80, 80, 80, 80, 80, 46, 46, 46, 46, 46, 46, \
             46, 46, 46, 46, 46, 46, 46, 46, 46, 46, 46, 46, 46, 46, 46, 46, 46, 46, 46, 46, 46, \
             46, 46, 46, 46, 46, 112, 112, 112, 112, 112, 112, 112, 112, 114, 110, 98, 113, 107, \
-            98, 110, 114, (char)0xff, 0, 0, _SCL_EXTRA_BYTE_VALUE, 0                            \
+            98, 110, 114, (char)0xff, 0, 0, _SCL_EXTRA_BYTE_VALUE, 0, 17, 37, 111, 43       \
+            _SCL_BITBOARD_START_STATE                                                           \
     }
 
 #define SCL_FEN_START "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
@@ -249,6 +292,7 @@ typedef struct {
     uint8_t squareTo; ///< target square
     char enPassantCastle; ///< previous en passant/castle byte
     char moveCount; ///< previous values of the move counter byte
+    uint32_t zobrist; ///< previous Zobrist key
     uint8_t other; /**< lowest 7 bits: previous value of target square,
                                 highest bit: if 1 then the move was promotion or
                                 en passant */
@@ -284,6 +328,19 @@ void SCL_boardDisableCastling(SCL_Board board);
 
 uint32_t SCL_boardHash32(const SCL_Board board);
 
+/**
+  Computes the Zobrist key of the position from scratch. It covers the pieces,
+  castling and en passant rights and the side to move, but not the move
+  counters. Boards keep this key up to date in their state, so unless the
+  board was modified by hand SCL_boardGetZobrist gives the same value faster.
+*/
+uint32_t SCL_boardZobrist(const SCL_Board board);
+
+/**
+  Returns the Zobrist key stored in the board state.
+*/
+uint32_t SCL_boardGetZobrist(const SCL_Board board);
+
 #define SCL_PHASE_OPENING 0
 #define SCL_PHASE_MIDGAME 1
 #define SCL_PHASE_ENDGAME 2
@@ -659,6 +716,37 @@ int16_t SCL_getAIMove(
     uint8_t* resultTo,
     char* resultProm);
 
+/**
+  Function that returns non-zero when the AI should stop searching (e.g. when
+  the time for the move is up). It is polled for every searched position so it
+  should be fast.
+*/
+typedef uint8_t (*SCL_StopFunction)(void);
+
+/**
+  Same as SCL_getAIMove but searches with increasing depth (1, 2, ... maxDepth)
+  until stopFunc (if not 0) says to stop, the move found by the deepest
+  completed search is returned. Depth 1 is always completed so that there is
+  always a move. Each search starts with the best moves of the previous one
+  remembered in the transposition table, so the shallow searches cost little.
+  If resultDepth is not 0, the depth of the returned move is written to it.
+*/
+int16_t SCL_getAIMoveIterative(
+    SCL_Board board,
+    uint8_t maxDepth,
+    uint8_t extensionExtraDepth,
+    uint8_t endgameExtraDepth,
+    SCL_StaticEvaluationFunction evalFunc,
+    SCL_RandomFunction randFunc,
+    uint8_t randomness,
+    uint8_t repetitionMoveFrom,
+    uint8_t repetitionMoveTo,
+    SCL_StopFunction stopFunc,
+    uint8_t* resultFrom,
+    uint8_t* resultTo,
+    char* resultProm,
+    uint8_t* resultDepth);
+
 /**
   Function that prints out a single character. This is passed to printing
   functions.
@@ -845,6 +933,80 @@ void _SCL_board960RememberRookPositions(SCL_Board board) {
     }
 }
 
+/**
+  Bijective 32 bit integer hash (MurmurHash3 finalizer), gives a pseudorandom
+  Zobrist key for each small number without storing a table of keys.
+*/
+uint32_t _SCL_zobristMix(uint32_t value) {
+    value ^= value >> 16;
+    value *= 0x85ebca6b;
+    value ^= value >> 13;
+    value *= 0xc2b2ae35;
+    value ^= value >> 16;
+    return value;
+}
+
+uint32_t _SCL_zobristPiece(char piece, uint8_t square) {
+    return piece == '.' ? 0 : _SCL_zobristMix((((uint32_t)((uint8_t)piece)) << 6) | square);
+}
+
+uint32_t _SCL_zobristState(const SCL_Board board) {
+    return _SCL_zobristMix(0x10000 | (uint8_t)board[SCL_BOARD_ENPASSANT_CASTLE_BYTE]) ^
+           ((board[SCL_BOARD_PLY_BYTE] & 0x01) ? 0x9e3779b9 : 0);
+}
+
+uint32_t SCL_boardGetZobrist(const SCL_Board board) {
+    const uint8_t* b = (const uint8_t*)board + SCL_BOARD_ZOBRIST_BYTE;
+
+    return b[0] | (((uint32_t)b[1]) << 8) | (((uint32_t)b[2]) << 16) | (((uint32_t)b[3]) << 24);
+}
+
+void _SCL_boardSetZobrist(SCL_Board board, uint32_t key) {
+    for(uint8_t i = 0; i < 4; ++i) {
+        board[SCL_BOARD_ZOBRIST_BYTE + i] = key & 0xff;
+        key >>= 8;
+    }
+}
+
+/**
+  Puts a piece on a square, keeping the bitboards (if used) up to date.
+*/
+static inline void _SCL_boardSetSquare(SCL_Board board, uint8_t square, char piece) {
+#if SCL_BITBOARDS
+    uint8_t* b = ((uint8_t*)board) + SCL_BOARD_BITBOARD_BYTE + square / 8;
+    uint8_t mask = 0x01 << (square % 8);
+
+    b[0] &= ~mask;
+    b[8] &= ~mask;
+
+    if(piece != '.') b[SCL_pieceIsWhite(piece) ? 0 : 8] |= mask;
+#endif
+
+    board[square] = piece;
+}
+
+/**
+  Updates the stored Zobrist key and bitboards after the board has been set up
+  by hand.
+*/
+void _SCL_boardUpdateDerived(SCL_Board board) {
+#if SCL_BITBOARDS
+    for(uint8_t i = 0; i < 16; ++i) board[SCL_BOARD_BITBOARD_BYTE + i] = 0;
+
+    for(uint8_t i = 0; i < SCL_BOARD_SQUARES; ++i) _SCL_boardSetSquare(board, i, board[i]);
+#endif
+
+    _SCL_boardSetZobrist(board, SCL_boardZobrist(board));
+}
+
+/**
+  Puts a piece on a square and updates the Zobrist key accordingly.
+*/
+void _SCL_boardPutPiece(SCL_Board board, uint32_t* key, uint8_t square, char piece) {
+    *key ^= _SCL_zobristPiece(board[square], square) ^ _SCL_zobristPiece(piece, square);
+    _SCL_boardSetSquare(board, square, piece);
+}
+
 void SCL_boardInit(SCL_Board board) {
     /*
     We might use SCL_BOARD_START_STATE and copy it to the board, but that might
@@ -905,6 +1067,8 @@ void SCL_boardInit(SCL_Board board) {
 #if SCL_960_CASTLING
     _SCL_board960RememberRookPositions(board);
 #endif
+
+    _SCL_boardUpdateDerived(board);
 }
 
 void _SCL_boardPlaceOnNthAvailable(SCL_Board board, uint8_t pos, char piece) {
@@ -977,6 +1141,8 @@ void SCL_boardInit960(SCL_Board board, uint16_t positionNumber) {
 #else
     SCL_boardDisableCastling(board);
 #endif
+
+    _SCL_boardUpdateDerived(board);
 }
 
 uint8_t SCL_boardsDiffer(SCL_Board b1, SCL_Board b2) {
@@ -1288,8 +1454,8 @@ void SCL_boardUndoMove(SCL_Board board, SCL_MoveUndo moveUndo) {
     char squareToNow = board[moveUndo.squareTo];
 #endif
 
-    board[moveUndo.squareFrom] = board[moveUndo.squareTo];
-    board[moveUndo.squareTo] = moveUndo.other & 0x7f;
+    _SCL_boardSetSquare(board, moveUndo.squareFrom, board[moveUndo.squareTo]);
+    _SCL_boardSetSquare(board, moveUndo.squareTo, moveUndo.other & 0x7f);
     board[SCL_BOARD_PLY_BYTE]--;
     board[SCL_BOARD_ENPASSANT_CASTLE_BYTE] = moveUndo.enPassantCastle;
     board[SCL_BOARD_MOVE_COUNT_BYTE] = moveUndo.moveCount;
@@ -1298,53 +1464,60 @@ void SCL_boardUndoMove(SCL_Board board, SCL_MoveUndo moveUndo) {
         moveUndo.squareTo /= 8;
 
         if(moveUndo.squareTo == 0 || moveUndo.squareTo == 7)
-            board[moveUndo.squareFrom] = SCL_pieceIsWhite(board[moveUndo.squareFrom]) ? 'P' : 'p';
+            _SCL_boardSetSquare(
+                board,
+                moveUndo.squareFrom,
+                SCL_pieceIsWhite(board[moveUndo.squareFrom]) ? 'P' : 'p');
         // ^ was promotion
         else
-            board[(moveUndo.squareFrom / 8) * 8 + (moveUndo.enPassantCastle & 0x0f)] =
-                (board[moveUndo.squareFrom] == 'P') ? 'p' : 'P'; // was en passant
+            _SCL_boardSetSquare(
+                board,
+                (moveUndo.squareFrom / 8) * 8 + (moveUndo.enPassantCastle & 0x0f),
+                (board[moveUndo.squareFrom] == 'P') ? 'p' : 'P'); // was en passant
     }
 #if !SCL_960_CASTLING
     else if(
         board[moveUndo.squareFrom] == 'k' && // black castling
         moveUndo.squareFrom == 60) {
         if(moveUndo.squareTo == 58) {
-            board[59] = '.';
-            board[56] = 'r';
+            _SCL_boardSetSquare(board, 59, '.');
+            _SCL_boardSetSquare(board, 56, 'r');
         } else if(moveUndo.squareTo == 62) {
-            board[61] = '.';
-            board[63] = 'r';
+            _SCL_boardSetSquare(board, 61, '.');
+            _SCL_boardSetSquare(board, 63, 'r');
         }
     } else if(
         board[moveUndo.squareFrom] == 'K' && // white castling
         moveUndo.squareFrom == 4) {
         if(moveUndo.squareTo == 2) {
-            board[3] = '.';
-            board[0] = 'R';
+            _SCL_boardSetSquare(board, 3, '.');
+            _SCL_boardSetSquare(board, 0, 'R');
         } else if(moveUndo.squareTo == 6) {
-            board[5] = '.';
-            board[7] = 'R';
+            _SCL_boardSetSquare(board, 5, '.');
+            _SCL_boardSetSquare(board, 7, 'R');
         }
     }
 #else // 960 castling
     else if(
         ((moveUndo.other & 0x7f) == 'r') && // black castling
         (squareToNow == '.' || !SCL_pieceIsWhite(squareToNow))) {
-        board[moveUndo.squareTo < moveUndo.squareFrom ? 59 : 61] = '.';
-        board[moveUndo.squareTo < moveUndo.squareFrom ? 58 : 62] = '.';
+        _SCL_boardSetSquare(board, moveUndo.squareTo < moveUndo.squareFrom ? 59 : 61, '.');
+        _SCL_boardSetSquare(board, moveUndo.squareTo < moveUndo.squareFrom ? 58 : 62, '.');
 
-        board[moveUndo.squareFrom] = 'k';
-        board[moveUndo.squareTo] = 'r';
+        _SCL_boardSetSquare(board, moveUndo.squareFrom, 'k');
+        _SCL_boardSetSquare(board, moveUndo.squareTo, 'r');
     } else if(
         ((moveUndo.other & 0x7f) == 'R') && // white castling
         (squareToNow == '.' || SCL_pieceIsWhite(squareToNow))) {
-        board[moveUndo.squareTo < moveUndo.squareFrom ? 3 : 5] = '.';
-        board[moveUndo.squareTo < moveUndo.squareFrom ? 2 : 6] = '.';
+        _SCL_boardSetSquare(board, moveUndo.squareTo < moveUndo.squareFrom ? 3 : 5, '.');
+        _SCL_boardSetSquare(board, moveUndo.squareTo < moveUndo.squareFrom ? 2 : 6, '.');
 
-        board[moveUndo.squareFrom] = 'K';
-        board[moveUndo.squareTo] = 'R';
+        _SCL_boardSetSquare(board, moveUndo.squareFrom, 'K');
+        _SCL_boardSetSquare(board, moveUndo.squareTo, 'R');
     }
 #endif
+
+    _SCL_boardSetZobrist(board, moveUndo.zobrist);
 }
 
 /**
@@ -1392,6 +1565,10 @@ SCL_MoveUndo
     moveUndo.moveCount = board[SCL_BOARD_MOVE_COUNT_BYTE];
     moveUndo.enPassantCastle = board[SCL_BOARD_ENPASSANT_CASTLE_BYTE];
     moveUndo.other = board[squareTo];
+    moveUndo.zobrist = SCL_boardGetZobrist(board);
+
+    // the state part of the key is replaced as a whole at the end
+    uint32_t key = moveUndo.zobrist ^ _SCL_zobristState(board);
 
     // reset the en-passant state
     board[SCL_BOARD_ENPASSANT_CASTLE_BYTE] |= 0x0f;
@@ -1415,12 +1592,12 @@ SCL_MoveUndo
 
             if(difference == 2) // short
             {
-                board[squareTo - 1] = rook;
-                board[squareTo + 1] = '.';
+                _SCL_boardPutPiece(board, &key, squareTo - 1, rook);
+                _SCL_boardPutPiece(board, &key, squareTo + 1, '.');
             } else if(difference == -2) // long
             {
-                board[squareTo - 2] = '.';
-                board[squareTo + 1] = rook;
+                _SCL_boardPutPiece(board, &key, squareTo - 2, '.');
+                _SCL_boardPutPiece(board, &key, squareTo + 1, rook);
             }
         }
 #else // 960 castling
@@ -1430,17 +1607,17 @@ SCL_MoveUndo
         if(board[squareTo] == rook) {
             castled = 1;
 
-            board[squareFrom] = '.';
-            board[squareTo] = '.';
+            _SCL_boardPutPiece(board, &key, squareFrom, '.');
+            _SCL_boardPutPiece(board, &key, squareTo, '.');
 
             if(squareTo > squareFrom) // short
             {
-                board[isWhite ? 6 : (56 + 6)] = s;
-                board[isWhite ? 5 : (56 + 5)] = rook;
+                _SCL_boardPutPiece(board, &key, isWhite ? 6 : (56 + 6), s);
+                _SCL_boardPutPiece(board, &key, isWhite ? 5 : (56 + 5), rook);
             } else // long
             {
-                board[isWhite ? 2 : (56 + 2)] = s;
-                board[isWhite ? 3 : (56 + 3)] = rook;
+                _SCL_boardPutPiece(board, &key, isWhite ? 2 : (56 + 2), s);
+                _SCL_boardPutPiece(board, &key, isWhite ? 3 : (56 + 3), rook);
             }
         }
 #endif
@@ -1469,7 +1646,7 @@ SCL_MoveUndo
             int8_t columnDiff = (squareTo % 8) - (squareFrom % 8);
 
             if((columnDiff != 0) && (board[squareTo] == '.')) {
-                board[squareFrom + columnDiff] = '.';
+                _SCL_boardPutPiece(board, &key, squareFrom + columnDiff, '.');
                 moveUndo.other |= 0x80;
             }
         }
@@ -1486,12 +1663,14 @@ SCL_MoveUndo
     if(!castled)
 #endif
     {
-        board[squareTo] = s;
-        board[squareFrom] = '.';
+        _SCL_boardPutPiece(board, &key, squareTo, s);
+        _SCL_boardPutPiece(board, &key, squareFrom, '.');
     }
 
     board[SCL_BOARD_PLY_BYTE]++; // increase ply count
 
+    _SCL_boardSetZobrist(board, key ^ _SCL_zobristState(board));
+
     return moveUndo;
 }
 
@@ -1510,7 +1689,9 @@ void SCL_boardSetPosition(
     board[SCL_BOARD_ENPASSANT_CASTLE_BYTE] = castlingEnPassant;
     board[SCL_BOARD_PLY_BYTE] = ply;
     board[SCL_BOARD_MOVE_COUNT_BYTE] = moveCount;
-    board[SCL_BOARD_STATE_SIZE - 1] = 0;
+    board[SCL_BOARD_TERMINATOR_BYTE] = 0;
+
+    _SCL_boardUpdateDerived(board);
 }
 
 void SCL_squareSetAdd(SCL_SquareSet squareSet, uint8_t square) {
@@ -1568,6 +1749,295 @@ void SCL_boardCopy(const SCL_Board boardFrom, SCL_Board boardTo) {
     for(uint8_t i = 0; i < SCL_BOARD_STATE_SIZE; ++i) boardTo[i] = boardFrom[i];
 }
 
+#if SCL_BITBOARDS
+/* Squares attacked by a knight and a king from each square. */
+static const uint64_t _SCL_knightAttacks[SCL_BOARD_SQUARES] = {
+    0x0000000000020400ULL, 0x0000000000050800ULL, 0x00000000000a1100ULL, 0x0000000000142200ULL,
+    0x0000000000284400ULL, 0x0000000000508800ULL, 0x0000000000a01000ULL, 0x0000000000402000ULL,
+    0x0000000002040004ULL, 0x0000000005080008ULL, 0x000000000a110011ULL, 0x0000000014220022ULL,
+    0x0000000028440044ULL, 0x0000000050880088ULL, 0x00000000a0100010ULL, 0x0000000040200020ULL,
+    0x0000000204000402ULL, 0x0000000508000805ULL, 0x0000000a1100110aULL, 0x0000001422002214ULL,
+    0x0000002844004428ULL, 0x0000005088008850ULL, 0x000000a0100010a0ULL, 0x0000004020002040ULL,
+    0x0000020400040200ULL, 0x0000050800080500ULL, 0x00000a1100110a00ULL, 0x0000142200221400ULL,
+    0x0000284400442800ULL, 0x0000508800885000ULL, 0x0000a0100010a000ULL, 0x0000402000204000ULL,
+    0x0002040004020000ULL, 0x0005080008050000ULL, 0x000a1100110a0000ULL, 0x0014220022140000ULL,
+    0x0028440044280000ULL, 0x0050880088500000ULL, 0x00a0100010a00000ULL, 0x0040200020400000ULL,
+    0x0204000402000000ULL, 0x0508000805000000ULL, 0x0a1100110a000000ULL, 0x1422002214000000ULL,
+    0x2844004428000000ULL, 0x5088008850000000ULL, 0xa0100010a0000000ULL, 0x4020002040000000ULL,
+    0x0400040200000000ULL, 0x0800080500000000ULL, 0x1100110a00000000ULL, 0x2200221400000000ULL,
+    0x4400442800000000ULL, 0x8800885000000000ULL, 0x100010a000000000ULL, 0x2000204000000000ULL,
+    0x0004020000000000ULL, 0x0008050000000000ULL, 0x00110a0000000000ULL, 0x0022140000000000ULL,
+    0x0044280000000000ULL, 0x0088500000000000ULL, 0x0010a00000000000ULL, 0x0020400000000000ULL};
+
+static const uint64_t _SCL_kingAttacks[SCL_BOARD_SQUARES] = {
+    0x0000000000000302ULL, 0x0000000000000705ULL, 0x0000000000000e0aULL, 0x0000000000001c14ULL,
+    0x0000000000003828ULL, 0x0000000000007050ULL, 0x000000000000e0a0ULL, 0x000000000000c040ULL,
+    0x0000000000030203ULL, 0x0000000000070507ULL, 0x00000000000e0a0eULL, 0x00000000001c141cULL,
+    0x0000000000382838ULL, 0x0000000000705070ULL, 0x0000000000e0a0e0ULL, 0x0000000000c040c0ULL,
+    0x0000000003020300ULL, 0x0000000007050700ULL, 0x000000000e0a0e00ULL, 0x000000001c141c00ULL,
+    0x0000000038283800ULL, 0x0000000070507000ULL, 0x00000000e0a0e000ULL, 0x00000000c040c000ULL,
+    0x0000000302030000ULL, 0x0000000705070000ULL, 0x0000000e0a0e0000ULL, 0x0000001c141c0000ULL,
+    0x0000003828380000ULL, 0x0000007050700000ULL, 0x000000e0a0e00000ULL, 0x000000c040c00000ULL,
+    0x0000030203000000ULL, 0x0000070507000000ULL, 0x00000e0a0e000000ULL, 0x00001c141c000000ULL,
+    0x0000382838000000ULL, 0x0000705070000000ULL, 0x0000e0a0e0000000ULL, 0x0000c040c0000000ULL,
+    0x0003020300000000ULL, 0x0007050700000000ULL, 0x000e0a0e00000000ULL, 0x001c141c00000000ULL,
+    0x0038283800000000ULL, 0x0070507000000000ULL, 0x00e0a0e000000000ULL, 0x00c040c000000000ULL,
+    0x0302030000000000ULL, 0x0705070000000000ULL, 0x0e0a0e0000000000ULL, 0x1c141c0000000000ULL,
+    0x3828380000000000ULL, 0x7050700000000000ULL, 0xe0a0e00000000000ULL, 0xc040c00000000000ULL,
+    0x0203000000000000ULL, 0x0507000000000000ULL, 0x0a0e000000000000ULL, 0x141c000000000000ULL,
+    0x2838000000000000ULL, 0x5070000000000000ULL, 0xa0e0000000000000ULL, 0x40c0000000000000ULL};
+
+/* Squares seen from each square by a slider on an empty board, in the same
+  directions as the offsets in SCL_boardGetPseudoMoves: down, right, up, left
+  (rook) and down right, up right, down left, up left (bishop). */
+static const uint64_t _SCL_rays[8][SCL_BOARD_SQUARES] = {
+    {0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+     0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+     0x0000000000000001ULL, 0x0000000000000002ULL, 0x0000000000000004ULL, 0x0000000000000008ULL,
+     0x0000000000000010ULL, 0x0000000000000020ULL, 0x0000000000000040ULL, 0x0000000000000080ULL,
+     0x0000000000000101ULL, 0x0000000000000202ULL, 0x0000000000000404ULL, 0x0000000000000808ULL,
+     0x0000000000001010ULL, 0x0000000000002020ULL, 0x0000000000004040ULL, 0x0000000000008080ULL,
+     0x0000000000010101ULL, 0x0000000000020202ULL, 0x0000000000040404ULL, 0x0000000000080808ULL,
+     0x0000000000101010ULL, 0x0000000000202020ULL, 0x0000000000404040ULL, 0x0000000000808080ULL,
+     0x0000000001010101ULL, 0x0000000002020202ULL, 0x0000000004040404ULL, 0x0000000008080808ULL,
+     0x0000000010101010ULL, 0x0000000020202020ULL, 0x0000000040404040ULL, 0x0000000080808080ULL,
+     0x0000000101010101ULL, 0x0000000202020202ULL, 0x0000000404040404ULL, 0x0000000808080808ULL,
+     0x0000001010101010ULL, 0x0000002020202020ULL, 0x0000004040404040ULL, 0x0000008080808080ULL,
+     0x0000010101010101ULL, 0x0000020202020202ULL, 0x0000040404040404ULL, 0x0000080808080808ULL,
+     0x0000101010101010ULL, 0x0000202020202020ULL, 0x0000404040404040ULL, 0x0000808080808080ULL,
+     0x0001010101010101ULL, 0x0002020202020202ULL, 0x0004040404040404ULL, 0x0008080808080808ULL,
+     0x0010101010101010ULL, 0x0020202020202020ULL, 0x0040404040404040ULL, 0x0080808080808080ULL},
+    {0x00000000000000feULL, 0x00000000000000fcULL, 0x00000000000000f8ULL, 0x00000000000000f0ULL,
+     0x00000000000000e0ULL, 0x00000000000000c0ULL, 0x0000000000000080ULL, 0x0000000000000000ULL,
+     0x000000000000fe00ULL, 0x000000000000fc00ULL, 0x000000000000f800ULL, 0x000000000000f000ULL,
+     0x000000000000e000ULL, 0x000000000000c000ULL, 0x0000000000008000ULL, 0x0000000000000000ULL,
+     0x0000000000fe0000ULL, 0x0000000000fc0000ULL, 0x0000000000f80000ULL, 0x0000000000f00000ULL,
+     0x0000000000e00000ULL, 0x0000000000c00000ULL, 0x0000000000800000ULL, 0x0000000000000000ULL,
+     0x00000000fe000000ULL, 0x00000000fc000000ULL, 0x00000000f8000000ULL, 0x00000000f0000000ULL,
+     0x00000000e0000000ULL, 0x00000000c0000000ULL, 0x0000000080000000ULL, 0x0000000000000000ULL,
+     0x000000fe00000000ULL, 0x000000fc00000000ULL, 0x000000f800000000ULL, 0x000000f000000000ULL,
+     0x000000e000000000ULL, 0x000000c000000000ULL, 0x0000008000000000ULL, 0x0000000000000000ULL,
+     0x0000fe0000000000ULL, 0x0000fc0000000000ULL, 0x0000f80000000000ULL, 0x0000f00000000000ULL,
+     0x0000e00000000000ULL, 0x0000c00000000000ULL, 0x0000800000000000ULL, 0x0000000000000000ULL,
+     0x00fe000000000000ULL, 0x00fc000000000000ULL, 0x00f8000000000000ULL, 0x00f0000000000000ULL,
+     0x00e0000000000000ULL, 0x00c0000000000000ULL, 0x0080000000000000ULL, 0x0000000000000000ULL,
+     0xfe00000000000000ULL, 0xfc00000000000000ULL, 0xf800000000000000ULL, 0xf000000000000000ULL,
+     0xe000000000000000ULL, 0xc000000000000000ULL, 0x8000000000000000ULL, 0x0000000000000000ULL},
+    {0x0101010101010100ULL, 0x0202020202020200ULL, 0x0404040404040400ULL, 0x0808080808080800ULL,
+     0x1010101010101000ULL, 0x2020202020202000ULL, 0x4040404040404000ULL, 0x8080808080808000ULL,
+     0x0101010101010000ULL, 0x0202020202020000ULL, 0x0404040404040000ULL, 0x0808080808080000ULL,
+     0x1010101010100000ULL, 0x2020202020200000ULL, 0x4040404040400000ULL, 0x8080808080800000ULL,
+     0x0101010101000000ULL, 0x0202020202000000ULL, 0x0404040404000000ULL, 0x0808080808000000ULL,
+     0x1010101010000000ULL, 0x2020202020000000ULL, 0x4040404040000000ULL, 0x8080808080000000ULL,
+     0x0101010100000000ULL, 0x0202020200000000ULL, 0x0404040400000000ULL, 0x0808080800000000ULL,
+     0x1010101000000000ULL, 0x2020202000000000ULL, 0x4040404000000000ULL, 0x8080808000000000ULL,
+     0x0101010000000000ULL, 0x0202020000000000ULL, 0x0404040000000000ULL, 0x0808080000000000ULL,
+     0x1010100000000000ULL, 0x2020200000000000ULL, 0x4040400000000000ULL, 0x8080800000000000ULL,
+     0x0101000000000000ULL, 0x0202000000000000ULL, 0x0404000000000000ULL, 0x0808000000000000ULL,
+     0x1010000000000000ULL, 0x2020000000000000ULL, 0x4040000000000000ULL, 0x8080000000000000ULL,
+     0x0100000000000000ULL, 0x0200000000000000ULL, 0x0400000000000000ULL, 0x0800000000000000ULL,
+     0x1000000000000000ULL, 0x2000000000000000ULL, 0x4000000000000000ULL, 0x8000000000000000ULL,
+     0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+     0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL},
+    {0x0000000000000000ULL, 0x0000000000000001ULL, 0x0000000000000003ULL, 0x0000000000000007ULL,
+     0x000000000000000fULL, 0x000000000000001fULL, 0x000000000000003fULL, 0x000000000000007fULL,
+     0x0000000000000000ULL, 0x0000000000000100ULL, 0x0000000000000300ULL, 0x0000000000000700ULL,
+     0x0000000000000f00ULL, 0x0000000000001f00ULL, 0x0000000000003f00ULL, 0x0000000000007f00ULL,
+     0x0000000000000000ULL, 0x0000000000010000ULL, 0x0000000000030000ULL, 0x0000000000070000ULL,
+     0x00000000000f0000ULL, 0x00000000001f0000ULL, 0x00000000003f0000ULL, 0x00000000007f0000ULL,
+     0x0000000000000000ULL, 0x0000000001000000ULL, 0x0000000003000000ULL, 0x0000000007000000ULL,
+     0x000000000f000000ULL, 0x000000001f000000ULL, 0x000000003f000000ULL, 0x000000007f000000ULL,
+     0x0000000000000000ULL, 0x0000000100000000ULL, 0x0000000300000000ULL, 0x0000000700000000ULL,
+     0x0000000f00000000ULL, 0x0000001f00000000ULL, 0x0000003f00000000ULL, 0x0000007f00000000ULL,
+     0x0000000000000000ULL, 0x0000010000000000ULL, 0x0000030000000000ULL, 0x0000070000000000ULL,
+     0x00000f0000000000ULL, 0x00001f0000000000ULL, 0x00003f0000000000ULL, 0x00007f0000000000ULL,
+     0x0000000000000000ULL, 0x0001000000000000ULL, 0x0003000000000000ULL, 0x0007000000000000ULL,
+     0x000f000000000000ULL, 0x001f000000000000ULL, 0x003f000000000000ULL, 0x007f000000000000ULL,
+     0x0000000000000000ULL, 0x0100000000000000ULL, 0x0300000000000000ULL, 0x0700000000000000ULL,
+     0x0f00000000000000ULL, 0x1f00000000000000ULL, 0x3f00000000000000ULL, 0x7f00000000000000ULL},
+    {0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+     0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+     0x0000000000000002ULL, 0x0000000000000004ULL, 0x0000000000000008ULL, 0x0000000000000010ULL,
+     0x0000000000000020ULL, 0x0000000000000040ULL, 0x0000000000000080ULL, 0x0000000000000000ULL,
+     0x0000000000000204ULL, 0x0000000000000408ULL, 0x0000000000000810ULL, 0x0000000000001020ULL,
+     0x0000000000002040ULL, 0x0000000000004080ULL, 0x0000000000008000ULL, 0x0000000000000000ULL,
+     0x0000000000020408ULL, 0x0000000000040810ULL, 0x0000000000081020ULL, 0x0000000000102040ULL,
+     0x0000000000204080ULL, 0x0000000000408000ULL, 0x0000000000800000ULL, 0x0000000000000000ULL,
+     0x0000000002040810ULL, 0x0000000004081020ULL, 0x0000000008102040ULL, 0x0000000010204080ULL,
+     0x0000000020408000ULL, 0x0000000040800000ULL, 0x0000000080000000ULL, 0x0000000000000000ULL,
+     0x0000000204081020ULL, 0x0000000408102040ULL, 0x0000000810204080ULL, 0x0000001020408000ULL,
+     0x0000002040800000ULL, 0x0000004080000000ULL, 0x0000008000000000ULL, 0x0000000000000000ULL,
+     0x0000020408102040ULL, 0x0000040810204080ULL, 0x0000081020408000ULL, 0x0000102040800000ULL,
+     0x0000204080000000ULL, 0x0000408000000000ULL, 0x0000800000000000ULL, 0x0000000000000000ULL,
+     0x0002040810204080ULL, 0x0004081020408000ULL, 0x0008102040800000ULL, 0x0010204080000000ULL,
+     0x0020408000000000ULL, 0x0040800000000000ULL, 0x0080000000000000ULL, 0x0000000000000000ULL},
+    {0x8040201008040200ULL, 0x0080402010080400ULL, 0x0000804020100800ULL, 0x0000008040201000ULL,
+     0x0000000080402000ULL, 0x0000000000804000ULL, 0x0000000000008000ULL, 0x0000000000000000ULL,
+     0x4020100804020000ULL, 0x8040201008040000ULL, 0x0080402010080000ULL, 0x0000804020100000ULL,
+     0x0000008040200000ULL, 0x0000000080400000ULL, 0x0000000000800000ULL, 0x0000000000000000ULL,
+     0x2010080402000000ULL, 0x4020100804000000ULL, 0x8040201008000000ULL, 0x0080402010000000ULL,
+     0x0000804020000000ULL, 0x0000008040000000ULL, 0x0000000080000000ULL, 0x0000000000000000ULL,
+     0x1008040200000000ULL, 0x2010080400000000ULL, 0x4020100800000000ULL, 0x8040201000000000ULL,
+     0x0080402000000000ULL, 0x0000804000000000ULL, 0x0000008000000000ULL, 0x0000000000000000ULL,
+     0x0804020000000000ULL, 0x1008040000000000ULL, 0x2010080000000000ULL, 0x4020100000000000ULL,
+     0x8040200000000000ULL, 0x0080400000000000ULL, 0x0000800000000000ULL, 0x0000000000000000ULL,
+     0x0402000000000000ULL, 0x0804000000000000ULL, 0x1008000000000000ULL, 0x2010000000000000ULL,
+     0x4020000000000000ULL, 0x8040000000000000ULL, 0x0080000000000000ULL, 0x0000000000000000ULL,
+     0x0200000000000000ULL, 0x0400000000000000ULL, 0x0800000000000000ULL, 0x1000000000000000ULL,
+     0x2000000000000000ULL, 0x4000000000000000ULL, 0x8000000000000000ULL, 0x0000000000000000ULL,
+     0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+     0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL},
+    {0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+     0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+     0x0000000000000000ULL, 0x0000000000000001ULL, 0x0000000000000002ULL, 0x0000000000000004ULL,
+     0x0000000000000008ULL, 0x0000000000000010ULL, 0x0000000000000020ULL, 0x0000000000000040ULL,
+     0x0000000000000000ULL, 0x0000000000000100ULL, 0x0000000000000201ULL, 0x0000000000000402ULL,
+     0x0000000000000804ULL, 0x0000000000001008ULL, 0x0000000000002010ULL, 0x0000000000004020ULL,
+     0x0000000000000000ULL, 0x0000000000010000ULL, 0x0000000000020100ULL, 0x0000000000040201ULL,
+     0x0000000000080402ULL, 0x0000000000100804ULL, 0x0000000000201008ULL, 0x0000000000402010ULL,
+     0x0000000000000000ULL, 0x0000000001000000ULL, 0x0000000002010000ULL, 0x0000000004020100ULL,
+     0x0000000008040201ULL, 0x0000000010080402ULL, 0x0000000020100804ULL, 0x0000000040201008ULL,
+     0x0000000000000000ULL, 0x0000000100000000ULL, 0x0000000201000000ULL, 0x0000000402010000ULL,
+     0x0000000804020100ULL, 0x0000001008040201ULL, 0x0000002010080402ULL, 0x0000004020100804ULL,
+     0x0000000000000000ULL, 0x0000010000000000ULL, 0x0000020100000000ULL, 0x0000040201000000ULL,
+     0x0000080402010000ULL, 0x0000100804020100ULL, 0x0000201008040201ULL, 0x0000402010080402ULL,
+     0x0000000000000000ULL, 0x0001000000000000ULL, 0x0002010000000000ULL, 0x0004020100000000ULL,
+     0x0008040201000000ULL, 0x0010080402010000ULL, 0x0020100804020100ULL, 0x0040201008040201ULL},
+    {0x0000000000000000ULL, 0x0000000000000100ULL, 0x0000000000010200ULL, 0x0000000001020400ULL,
+     0x0000000102040800ULL, 0x0000010204081000ULL, 0x0001020408102000ULL, 0x0102040810204000ULL,
+     0x0000000000000000ULL, 0x0000000000010000ULL, 0x0000000001020000ULL, 0x0000000102040000ULL,
+     0x0000010204080000ULL, 0x0001020408100000ULL, 0x0102040810200000ULL, 0x0204081020400000ULL,
+     0x0000000000000000ULL, 0x0000000001000000ULL, 0x0000000102000000ULL, 0x0000010204000000ULL,
+     0x0001020408000000ULL, 0x0102040810000000ULL, 0x0204081020000000ULL, 0x0408102040000000ULL,
+     0x0000000000000000ULL, 0x0000000100000000ULL, 0x0000010200000000ULL, 0x0001020400000000ULL,
+     0x0102040800000000ULL, 0x0204081000000000ULL, 0x0408102000000000ULL, 0x0810204000000000ULL,
+     0x0000000000000000ULL, 0x0000010000000000ULL, 0x0001020000000000ULL, 0x0102040000000000ULL,
+     0x0204080000000000ULL, 0x0408100000000000ULL, 0x0810200000000000ULL, 0x1020400000000000ULL,
+     0x0000000000000000ULL, 0x0001000000000000ULL, 0x0102000000000000ULL, 0x0204000000000000ULL,
+     0x0408000000000000ULL, 0x0810000000000000ULL, 0x1020000000000000ULL, 0x2040000000000000ULL,
+     0x0000000000000000ULL, 0x0100000000000000ULL, 0x0200000000000000ULL, 0x0400000000000000ULL,
+     0x0800000000000000ULL, 0x1000000000000000ULL, 0x2000000000000000ULL, 0x4000000000000000ULL,
+     0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL,
+     0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000000ULL}};
+
+#define _SCL_RAYS_UP 0xa6 ///< bit of each direction going to higher squares
+
+uint64_t _SCL_boardGetBitboard(const SCL_Board board, uint8_t white) {
+    const uint8_t* b = ((const uint8_t*)board) + SCL_BOARD_BITBOARD_BYTE + (white ? 0 : 8);
+    uint64_t result = 0;
+
+    for(int8_t i = 7; i >= 0; --i) result = (result << 8) | b[i];
+
+    return result;
+}
+
+void _SCL_bitboardToSquareSet(uint64_t bitboard, SCL_SquareSet squareSet) {
+    for(uint8_t i = 0; i < 8; ++i, bitboard >>= 8) squareSet[i] = bitboard & 0xff;
+}
+
+/**
+  Returns the lowest (first = 1) or highest (first = 0) square of a non-empty
+  bitboard.
+*/
+static inline uint8_t _SCL_bitboardSquare(uint64_t bitboard, uint8_t first) {
+#ifdef __GNUC__
+    return first ? __builtin_ctzll(bitboard) : 63 - __builtin_clzll(bitboard);
+#else
+    uint8_t result = first ? 0 : 63;
+
+    while(!(bitboard & (first ? 0x01 : (((uint64_t)1) << 63)))) {
+        bitboard = first ? (bitboard >> 1) : (bitboard << 1);
+        result += first ? 1 : -1;
+    }
+
+    return result;
+#endif
+}
+
+/**
+  Squares a slider on given square attacks in given direction (up to and
+  including the first taken square).
+*/
+static inline uint64_t
+    _SCL_bitboardRay(uint64_t occupied, uint8_t direction, uint8_t square) {
+    uint64_t ray = _SCL_rays[direction][square];
+    uint64_t blockers = ray & occupied;
+
+    if(blockers != 0)
+        ray ^= _SCL_rays[direction]
+                        [_SCL_bitboardSquare(blockers, (_SCL_RAYS_UP >> direction) & 0x01)];
+
+    return ray;
+}
+
+uint8_t SCL_boardSquareAttacked(SCL_Board board, uint8_t square, uint8_t byWhite) {
+    /* Instead of generating the moves of all pieces we look from the square
+     in the way of each piece type and see if we find such enemy piece. The
+     piece on the square itself doesn't matter. */
+
+    uint64_t attackers = _SCL_boardGetBitboard(board, byWhite);
+    uint64_t occupied = attackers | _SCL_boardGetBitboard(board, !byWhite);
+    char knight = SCL_pieceToColor('n', byWhite);
+    char king = SCL_pieceToColor('k', byWhite);
+    char pawn = SCL_pieceToColor('p', byWhite);
+    char queen = SCL_pieceToColor('q', byWhite);
+    char rook = SCL_pieceToColor('r', byWhite);
+    char bishop = SCL_pieceToColor('b', byWhite);
+
+    uint64_t b = _SCL_knightAttacks[square] & attackers;
+
+    while(b != 0) {
+        if(board[_SCL_bitboardSquare(b, 1)] == knight) return 1;
+
+        b &= b - 1;
+    }
+
+    b = _SCL_kingAttacks[square] & attackers;
+
+    while(b != 0) {
+        if(board[_SCL_bitboardSquare(b, 1)] == king) return 1;
+
+        b &= b - 1;
+    }
+
+    uint8_t column = square % 8;
+
+    if(byWhite ? (square >= 8) : (square < 56)) {
+        uint8_t pawnSquare = byWhite ? square - 8 : square + 8;
+
+        if((column != 0 && board[pawnSquare - 1] == pawn) ||
+           (column != 7 && board[pawnSquare + 1] == pawn))
+            return 1;
+    }
+
+    for(uint8_t direction = 0; direction < 8; ++direction) {
+        b = _SCL_rays[direction][square] & occupied;
+
+        if(b == 0) continue;
+
+        char c = board[_SCL_bitboardSquare(b, (_SCL_RAYS_UP >> direction) & 0x01)];
+
+        if(c == queen || c == (direction < 4 ? rook : bishop)) return 1;
+    }
+
+    return 0;
+}
+
+uint8_t SCL_boardCheck(SCL_Board board, uint8_t white) {
+    char kingChar = white ? 'K' : 'k';
+    uint64_t pieces = _SCL_boardGetBitboard(board, white);
+
+    while(pieces != 0) {
+        uint8_t i = _SCL_bitboardSquare(pieces, 1);
+
+        if(board[i] == kingChar) return SCL_boardSquareAttacked(board, i, !white);
+
+        pieces &= pieces - 1;
+    }
+
+    return 0;
+}
+#else
 uint8_t SCL_boardSquareAttacked(SCL_Board board, uint8_t square, uint8_t byWhite) {
     const char* currentSquare = board;
 
@@ -1605,6 +2075,7 @@ uint8_t SCL_boardCheck(SCL_Board board, uint8_t white) {
 
     return 0;
 }
+#endif // SCL_BITBOARDS
 
 uint8_t SCL_boardGameOver(SCL_Board board) {
     uint8_t position = SCL_boardGetPosition(board);
@@ -1708,6 +2179,18 @@ void SCL_boardGetPseudoMoves(
     case 'B':
     case 'q': // queen
     case 'Q': {
+#if SCL_BITBOARDS
+        uint64_t own = _SCL_boardGetBitboard(board, isWhite);
+        uint64_t occupied = own | _SCL_boardGetBitboard(board, !isWhite);
+        uint64_t moves = 0;
+
+        uint8_t from = (piece == 'b' || piece == 'B') * 4;
+        uint8_t to = 4 + (piece != 'r' && piece != 'R') * 4;
+
+        for(uint8_t i = from; i < to; ++i) moves |= _SCL_bitboardRay(occupied, i, pieceSquare);
+
+        _SCL_bitboardToSquareSet(moves & ~own, result);
+#else
         const int8_t offsets[8] = {-8, 1, 8, -1, -7, 9, -9, 7};
         const int8_t columnDirs[8] = {0, 1, 0, -1, 1, 1, -1, -1};
 
@@ -1737,10 +2220,15 @@ void SCL_boardGetPseudoMoves(
                 }
             }
         }
+#endif
     } break;
 
     case 'n': // knight
     case 'N': {
+#if SCL_BITBOARDS
+        _SCL_bitboardToSquareSet(
+            _SCL_knightAttacks[pieceSquare] & ~_SCL_boardGetBitboard(board, isWhite), result);
+#else
         const int8_t offsets[4] = {6, 10, 15, 17};
         const int8_t columnsMinus[4] = {2, -2, 1, -1};
         const int8_t columnsPlus[4] = {-2, 2, -1, 1};
@@ -1763,10 +2251,15 @@ void SCL_boardGetPseudoMoves(
         checkOffsets(-, <, 0, Minus) checkOffsets(+, >=, SCL_BOARD_SQUARES, Plus)
 
 #undef checkOffsets
+#endif
     } break;
 
     case 'k': // king
     case 'K': {
+#if SCL_BITBOARDS
+        _SCL_bitboardToSquareSet(
+            _SCL_kingAttacks[pieceSquare] & ~_SCL_boardGetBitboard(board, isWhite), result);
+#else
         uint8_t verticalPosition = pieceSquare / 8;
 
         uint8_t u = verticalPosition != 0, d = verticalPosition != 7, l = horizontalPosition != 0,
@@ -1782,6 +2275,7 @@ void SCL_boardGetPseudoMoves(
         checkSquare(l && u, 1) checkSquare(u, 1) checkSquare(r && u, 6) checkSquare(l, 2)
             checkSquare(r, 6) checkSquare(l && d, 1) checkSquare(d, 1) checkSquare(r && d, 0)
 #undef checkSquare
+#endif
 
             // castling:
 
@@ -2533,6 +3027,31 @@ int16_t SCL_boardEvaluateStatic(SCL_Board board) {
 SCL_StaticEvaluationFunction _SCL_staticEvaluationFunction;
 int16_t _SCL_currentEval;
 int8_t _SCL_depthHardLimit;
+SCL_StopFunction _SCL_stopFunction = 0;
+uint8_t _SCL_searchStopped = 0; ///< set once _SCL_stopFunction says to stop
+
+#if SCL_TRANSPOSITION_TABLE_SIZE
+#define _SCL_TT_EMPTY 0
+#define _SCL_TT_EXACT 1
+#define _SCL_TT_LOWER 2 ///< search was cut off, score is a lower bound for the side to move
+
+typedef struct {
+    uint32_t key;
+    int16_t score; ///< value returned by the search (positive favoring white)
+    int8_t depth; ///< remaining depth the position was searched to
+    uint8_t bound;
+    uint8_t moveFrom; ///< best move, moveFrom == moveTo means none
+    uint8_t moveTo;
+} _SCL_TTEntry;
+
+_SCL_TTEntry _SCL_transpositionTable[SCL_TRANSPOSITION_TABLE_SIZE];
+
+/* Mixed into the keys so that entries of searches with different parameters
+  don't match. */
+uint32_t _SCL_ttSalt;
+SCL_StaticEvaluationFunction _SCL_ttEvaluationFunction;
+uint32_t _SCL_ttGeneration;
+#endif
 
 /**
   Inner recursive function for SCL_boardEvaluateDynamic. It is passed a square
@@ -2551,11 +3070,45 @@ int16_t _SCL_boardEvaluateDynamic(
     wdt_reset();
 #endif
 
+    if(_SCL_stopFunction != 0 && (_SCL_searchStopped || _SCL_stopFunction())) {
+        _SCL_searchStopped = 1; // the result will be thrown away
+        return 0;
+    }
+
     uint8_t whitesTurn = SCL_boardWhitesTurn(board);
     int8_t valueMultiply = whitesTurn ? 1 : -1;
     int16_t bestMoveValue = -1 * SCL_EVALUATION_MAX_SCORE;
     uint8_t shouldCompute = depth > 0;
     uint8_t extended = 0;
+    uint8_t hintFrom = 0, hintTo = 0; // move to search first, none if equal
+    uint8_t bestFrom = 0, bestTo = 0;
+    uint8_t end = 0;
+
+#if SCL_TRANSPOSITION_TABLE_SIZE
+    /* Only positions searched to a full ply are remembered, below that the
+      extensions depend on too much. The capture square changes which
+      extensions are done, so it is a part of the key. */
+    _SCL_TTEntry* ttEntry = 0;
+    uint32_t ttKey = 0;
+    int8_t ttDepth = depth;
+
+    if(shouldCompute) {
+        ttKey = SCL_boardGetZobrist(board) ^ _SCL_ttSalt ^
+                _SCL_zobristMix(0x20000 | (uint8_t)(takenSquare + 1));
+        ttEntry = &_SCL_transpositionTable[ttKey & (SCL_TRANSPOSITION_TABLE_SIZE - 1)];
+
+        if(ttEntry->bound != _SCL_TT_EMPTY && ttEntry->key == ttKey) {
+            if(ttEntry->depth >= depth &&
+               (ttEntry->bound == _SCL_TT_EXACT ||
+                ttEntry->score * valueMultiply > alphaBeta * valueMultiply))
+                return ttEntry->score;
+
+            hintFrom = ttEntry->moveFrom;
+            hintTo = ttEntry->moveTo;
+        }
+    }
+#endif
+
     uint8_t positionType = SCL_boardGetPosition(board);
 
     if(!shouldCompute) {
@@ -2579,82 +3132,105 @@ int16_t _SCL_boardEvaluateDynamic(
 #endif
 
         alphaBeta *= valueMultiply;
-        uint8_t end = 0;
-        const char* b = board;
 
         depth--;
 
-        for(uint8_t i = 0; i < SCL_BOARD_SQUARES; ++i, ++b) {
-            char s = *b;
+        /* The first pass only tries the remembered best move, if it's still
+      legal (keys may collide), the other passes go square by square. */
+        for(uint8_t pass = 0; pass <= SCL_BOARD_SQUARES; ++pass) {
+            uint8_t i = pass == 0 ? hintFrom : pass - 1;
+            char s = board[i];
+            SCL_SquareSet moves;
 
-            if(s != '.' && SCL_pieceIsWhite(s) == whitesTurn) {
-                SCL_SquareSet moves;
+            if(s == '.' || SCL_pieceIsWhite(s) != whitesTurn) {
+                if(pass == 0) hintTo = hintFrom; // invalid hint
+                continue;
+            }
 
-                SCL_squareSetClear(moves);
+            if(pass == 0 && hintFrom == hintTo) continue;
 
-                SCL_boardGetMoves(board, i, moves);
+            SCL_squareSetClear(moves);
 
-                if(!SCL_squareSetEmpty(moves)) {
-                    SCL_SQUARE_SET_ITERATE_BEGIN(moves)
+            SCL_boardGetMoves(board, i, moves);
 
-                    int8_t captureExtension = -1;
+            if(hintFrom != hintTo && i == hintFrom) {
+                if(pass == 0) {
+                    if(!SCL_squareSetContains(moves, hintTo)) {
+                        hintTo = hintFrom;
+                        continue;
+                    }
+
+                    SCL_squareSetClear(moves);
+                    SCL_squareSetAdd(moves, hintTo);
+                } else // already searched in the first pass
+                    moves[hintTo / 8] &= ~(0x01 << (hintTo % 8));
+            }
 
-                    if(board[iteratedSquare] != '.' && // takes a piece
-                       (takenSquare == -1 || // extend on first taken sq.
-                        (extended && takenSquare != -1) || // ignore check extension
-                        (iteratedSquare == takenSquare))) // extend on same sq. taken
-                        captureExtension = iteratedSquare;
+            if(!SCL_squareSetEmpty(moves)) {
+                SCL_SQUARE_SET_ITERATE_BEGIN(moves)
 
-                    SCL_MoveUndo undo = SCL_boardMakeMove(board, i, iteratedSquare, 'q');
+                int8_t captureExtension = -1;
+
+                if(board[iteratedSquare] != '.' && // takes a piece
+                   (takenSquare == -1 || // extend on first taken sq.
+                    (extended && takenSquare != -1) || // ignore check extension
+                    (iteratedSquare == takenSquare))) // extend on same sq. taken
+                    captureExtension = iteratedSquare;
+
+                SCL_MoveUndo undo = SCL_boardMakeMove(board, i, iteratedSquare, 'q');
 
-                    uint8_t s0Dummy, s1Dummy;
-                    char pDummy;
+                uint8_t s0Dummy, s1Dummy;
+                char pDummy;
 
-                    SCL_UNUSED(s0Dummy);
-                    SCL_UNUSED(s1Dummy);
-                    SCL_UNUSED(pDummy);
+                SCL_UNUSED(s0Dummy);
+                SCL_UNUSED(s1Dummy);
+                SCL_UNUSED(pDummy);
 
 #if SCL_DEBUG_AI
-                    if(debugFirst)
-                        debugFirst = 0;
-                    else
-                        putchar(',');
+                if(debugFirst)
+                    debugFirst = 0;
+                else
+                    putchar(',');
 
-                    if(extended) putchar('*');
+                if(extended) putchar('*');
 
-                    printf("%s ", SCL_moveToString(board, i, iteratedSquare, 'q', moveStr));
+                printf("%s ", SCL_moveToString(board, i, iteratedSquare, 'q', moveStr));
 #endif
 
-                    int16_t value = _SCL_boardEvaluateDynamic(
-                                        board,
-                                        depth, // this is depth - 1, we decremented it
+                int16_t value = _SCL_boardEvaluateDynamic(
+                                    board,
+                                    depth, // this is depth - 1, we decremented it
 #if SCL_ALPHA_BETA
-                                        valueMultiply * bestMoveValue,
+                                    valueMultiply * bestMoveValue,
 #else
-                                        0,
+                                    0,
 #endif
-                                        captureExtension) *
-                                    valueMultiply;
+                                    captureExtension) *
+                                valueMultiply;
 
-                    SCL_boardUndoMove(board, undo);
+                SCL_boardUndoMove(board, undo);
 
-                    if(value > bestMoveValue) {
-                        bestMoveValue = value;
+                if(_SCL_searchStopped) {
+                    end = 1;
+                    iterationEnd = 1;
+                } else if(value > bestMoveValue) {
+                    bestMoveValue = value;
+                    bestFrom = i;
+                    bestTo = iteratedSquare;
 
 #if SCL_ALPHA_BETA
-                        // alpha-beta pruning:
+                    // alpha-beta pruning:
 
-                        if(value > alphaBeta) // no, >= can't be here
-                        {
-                            end = 1;
-                            iterationEnd = 1;
-                        }
-#endif
+                    if(value > alphaBeta) // no, >= can't be here
+                    {
+                        end = 1;
+                        iterationEnd = 1;
                     }
+#endif
+                }
 
-                    SCL_SQUARE_SET_ITERATE_END
-                } // !squre set empty?
-            } // valid piece?
+                SCL_SQUARE_SET_ITERATE_END
+            } // !squre set empty?
 
             if(end) break;
 
@@ -2690,6 +3266,24 @@ int16_t _SCL_boardEvaluateDynamic(
     printf("%d", bestMoveValue * valueMultiply);
 #endif
 
+#if SCL_TRANSPOSITION_TABLE_SIZE
+    // keep the deeper result of the same position, replace anything else
+    if(ttEntry != 0 && !_SCL_searchStopped &&
+       (ttEntry->key != ttKey || ttEntry->depth <= ttDepth)) {
+        ttEntry->key = ttKey;
+        ttEntry->score = bestMoveValue * valueMultiply;
+        ttEntry->depth = ttDepth;
+        ttEntry->bound = end ? _SCL_TT_LOWER : _SCL_TT_EXACT;
+        ttEntry->moveFrom = bestFrom;
+        ttEntry->moveTo = bestTo;
+    }
+#else
+    SCL_UNUSED(hintFrom);
+    SCL_UNUSED(hintTo);
+    SCL_UNUSED(bestFrom);
+    SCL_UNUSED(bestTo);
+#endif
+
     return bestMoveValue * valueMultiply;
 }
 
@@ -2703,6 +3297,18 @@ int16_t SCL_boardEvaluateDynamic(
     _SCL_depthHardLimit = 0;
     _SCL_depthHardLimit -= extensionExtraDepth;
 
+#if SCL_TRANSPOSITION_TABLE_SIZE
+    /* Entries stay valid between calls (and AI moves) as long as the
+      parameters that change the search stay the same. */
+    if(evalFunction != _SCL_ttEvaluationFunction) {
+        _SCL_ttEvaluationFunction = evalFunction;
+        _SCL_ttGeneration++;
+    }
+
+    _SCL_ttSalt = _SCL_zobristMix(0x30000 | (uint8_t)_SCL_depthHardLimit) ^
+                  _SCL_zobristMix(0x40000 + _SCL_ttGeneration);
+#endif
+
     return _SCL_boardEvaluateDynamic(
         board,
         baseDepth,
@@ -2873,6 +3479,81 @@ int16_t SCL_getAIMove(
     return bestScore;
 }
 
+int16_t SCL_getAIMoveIterative(
+    SCL_Board board,
+    uint8_t maxDepth,
+    uint8_t extensionExtraDepth,
+    uint8_t endgameExtraDepth,
+    SCL_StaticEvaluationFunction evalFunc,
+    SCL_RandomFunction randFunc,
+    uint8_t randomness,
+    uint8_t repetitionMoveFrom,
+    uint8_t repetitionMoveTo,
+    SCL_StopFunction stopFunc,
+    uint8_t* resultFrom,
+    uint8_t* resultTo,
+    char* resultProm,
+    uint8_t* resultDepth) {
+    if(resultDepth != 0) *resultDepth = 0;
+
+    if(maxDepth == 0)
+        return SCL_getAIMove(
+            board,
+            0,
+            extensionExtraDepth,
+            0,
+            evalFunc,
+            randFunc,
+            randomness,
+            repetitionMoveFrom,
+            repetitionMoveTo,
+            resultFrom,
+            resultTo,
+            resultProm);
+
+    if(SCL_boardEstimatePhase(board) == SCL_PHASE_ENDGAME) maxDepth += endgameExtraDepth;
+
+    int16_t result = 0;
+
+    for(uint8_t depth = 1; depth <= maxDepth; ++depth) {
+        uint8_t s0, s1;
+        char p;
+
+        _SCL_searchStopped = 0;
+        _SCL_stopFunction = depth > 1 ? stopFunc : 0;
+
+        int16_t score = SCL_getAIMove(
+            board,
+            depth,
+            extensionExtraDepth,
+            0,
+            evalFunc,
+            randFunc,
+            randomness,
+            repetitionMoveFrom,
+            repetitionMoveTo,
+            &s0,
+            &s1,
+            &p);
+
+        if(_SCL_searchStopped) break;
+
+        result = score;
+        *resultFrom = s0;
+        *resultTo = s1;
+        *resultProm = p;
+
+        if(resultDepth != 0) *resultDepth = depth;
+
+        if(stopFunc != 0 && stopFunc()) break;
+    }
+
+    _SCL_stopFunction = 0;
+    _SCL_searchStopped = 0;
+
+    return result;
+}
+
 uint8_t SCL_boardToFEN(SCL_Board board, char* string) {
     uint8_t square = 56;
     uint8_t spaces = 0;
@@ -3069,6 +3750,8 @@ uint8_t SCL_boardFromFEN(SCL_Board board, const char* string) {
     _SCL_board960RememberRookPositions(board);
 #endif
 
+    _SCL_boardUpdateDerived(board);
+
     return 1;
 #undef nextChar
 }
@@ -3234,6 +3917,15 @@ uint32_t SCL_boardHash32(const SCL_Board board) {
 
 void SCL_boardDisableCastling(SCL_Board board) {
     board[SCL_BOARD_ENPASSANT_CASTLE_BYTE] &= 0x0f;
+    _SCL_boardUpdateDerived(board);
+}
+
+uint32_t SCL_boardZobrist(const SCL_Board board) {
+    uint32_t result = _SCL_zobristState(board);
+
+    for(uint8_t i = 0; i < SCL_BOARD_SQUARES; ++i) result ^= _SCL_zobristPiece(board[i], i);
+
+    return result;
 }
 
 uint8_t SCL_boardMoveResetsCount(SCL_Board board, uint8_t squareFrom, uint8_t squareTo) {
@@ -128,6 +128,11 @@ FlipChess* flipchess_app_alloc() {
 void flipchess_app_free(FlipChess* app) {
     furi_assert(app);
 
+    // Back on the start screen may leave while the saved game is read
+    if(app->load) {
+        lazy_load_free(app->load);
+    }
+
     // Scene manager
     scene_manager_free(app->scene_manager);
 
@@ -12,6 +12,7 @@
 #include <gui/scene_manager.h>
 #include <gui/modules/variable_item_list.h>
 #include <gui/modules/text_input.h>
+#include "helpers/lazy_load.h"
 #include "scenes/flipchess_scene.h"
 #include "views/flipchess_startscreen.h"
 #include "views/flipchess_scene_1.h"
@@ -37,6 +38,8 @@ typedef struct {
     int black_mode;
     // Startscreen options
     uint8_t sound;
+    // Saved game being read while the start screen shows
+    LazyLoad* load;
     // Main menu options
     uint8_t import_game;
     // Text input
@@ -7,6 +7,7 @@ typedef enum {
     FlipChessCustomEventStartscreenRight,
     FlipChessCustomEventStartscreenOk,
     FlipChessCustomEventStartscreenBack,
+    FlipChessCustomEventStartscreenLoaded,
     FlipChessCustomEventScene1Up,
     FlipChessCustomEventScene1Down,
     FlipChessCustomEventScene1Left,
@@ -37,13 +37,16 @@ bool flipchess_has_file(const FlipChessFile file_type, const char* file_name, co
     return ret;
 }
 
-bool flipchess_load_file(char* contents, const FlipChessFile file_type, const char* file_name) {
-    bool ret = false;
+bool flipchess_load_file(
+    LazyLoad* load,
+    char* contents,
+    const FlipChessFile file_type,
+    const char* file_name) {
     const char* path;
+    char path_buf[FILE_MAX_PATH_LEN] = {0}; // path points into it past the branch
     if(file_type == FlipChessFileBoard) {
         path = FLIPCHESS_BOARD_PATH;
     } else {
-        char path_buf[FILE_MAX_PATH_LEN] = {0};
         strcpy(path_buf, FLIPCHESS_APP_BASE_FOLDER); // 22
         strcpy(path_buf + strlen(path_buf), "/");
         strcpy(path_buf + strlen(path_buf), file_name);
@@ -51,43 +54,25 @@ bool flipchess_load_file(char* contents, const FlipChessFile file_type, const ch
     }
 
     Storage* fs_api = furi_record_open(RECORD_STORAGE);
+    size_t size = 0;
+    uint8_t* data = lazy_load_read_file(load, fs_api, path, &size);
+    furi_record_close(RECORD_STORAGE);
 
-    File* settings_file = storage_file_alloc(fs_api);
-    if(storage_file_open(settings_file, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
-        char chr;
-        int i = 0;
-        while((storage_file_read(settings_file, &chr, 1) == 1) &&
-              !storage_file_eof(settings_file)) {
-            if(i < FILE_MAX_CHARS) {
-                contents[i] = chr;
-            }
-            i++;
-        }
-        ret = true;
-    } else {
-        contents[0] = '\0';
-        ret = false;
+    contents[0] = '\0';
+    if(data == NULL) {
+        return false;
     }
-    storage_file_close(settings_file);
-    storage_file_free(settings_file);
-    furi_record_close(RECORD_STORAGE);
 
-    if(strlen(contents) > 0) {
-        Storage* fs_api = furi_record_open(RECORD_STORAGE);
-        FileInfo layout_file_info;
-        FS_Error file_check_err = storage_common_stat(fs_api, path, &layout_file_info);
-        furi_record_close(RECORD_STORAGE);
-        if(file_check_err != FSE_OK) {
-            contents[0] = '\0';
-            ret = false;
-        }
-        // if(layout_file_info.size != 256) {
-        //     memzero(settings, strlen(settings));
-        //     settings[0] = '\0';
-        // }
+    // the first line, flipchess_save_file() ends it with a newline
+    size_t len = strcspn((char*)data, "\r\n");
+    if(len > FILE_MAX_CHARS) {
+        len = FILE_MAX_CHARS;
     }
+    memcpy(contents, data, len);
+    contents[len] = '\0';
+    free(data);
 
-    return ret;
+    return len > 0;
 }
 
 bool flipchess_save_file(
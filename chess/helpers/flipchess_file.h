@@ -1,4 +1,5 @@
 #include <stdbool.h>
+#include "lazy_load.h"
 
 typedef enum {
     FlipChessFileBoard,
@@ -6,7 +7,11 @@ typedef enum {
 } FlipChessFile;
 
 bool flipchess_has_file(const FlipChessFile file_type, const char* file_name, const bool remove);
-bool flipchess_load_file(char* contents, const FlipChessFile file_type, const char* file_name);
+bool flipchess_load_file(
+    LazyLoad* load,
+    char* contents,
+    const FlipChessFile file_type,
+    const char* file_name);
 bool flipchess_save_file(
     const char* contents,
     const FlipChessFile file_type,
@@ -0,0 +1,151 @@
+#include "lazy_load.h"
+
+#include <gui/elements.h>
+
+struct LazyLoad {
+    FuriThread* thread;
+    LazyLoadCallback callback;
+    void* context;
+    LazyLoadProgressCallback progress_callback;
+    void* progress_context;
+    LazyLoadDoneCallback done_callback;
+    void* done_context;
+
+    volatile bool stop;
+    volatile bool done;
+    volatile bool success;
+    volatile size_t progress_done;
+    volatile size_t progress_total;
+};
+
+static int32_t lazy_load_thread(void* context) {
+    LazyLoad* load = context;
+
+    load->success = load->callback(load, load->context);
+    load->done = true;
+
+    if(load->done_callback) {
+        load->done_callback(load->success, load->done_context);
+    }
+
+    return 0;
+}
+
+LazyLoad* lazy_load_alloc(const char* name, LazyLoadCallback callback, void* context) {
+    furi_assert(callback);
+
+    LazyLoad* load = malloc(sizeof(LazyLoad));
+    memset(load, 0, sizeof(LazyLoad));
+    load->callback = callback;
+    load->context = context;
+    load->thread = furi_thread_alloc_ex(name, LAZY_LOAD_STACK_SIZE, lazy_load_thread, load);
+
+    return load;
+}
+
+void lazy_load_free(LazyLoad* load) {
+    furi_assert(load);
+
+    load->stop = true;
+    furi_thread_join(load->thread);
+    furi_thread_free(load->thread);
+    free(load);
+}
+
+void lazy_load_set_progress_callback(
+    LazyLoad* load,
+    LazyLoadProgressCallback callback,
+    void* context) {
+    furi_assert(load);
+    load->progress_callback = callback;
+    load->progress_context = context;
+}
+
+void lazy_load_set_done_callback(LazyLoad* load, LazyLoadDoneCallback callback, void* context) {
+    furi_assert(load);
+    load->done_callback = callback;
+    load->done_context = context;
+}
+
+void lazy_load_start(LazyLoad* load) {
+    furi_assert(load);
+    furi_thread_start(load->thread);
+}
+
+bool lazy_load_is_done(LazyLoad* load) {
+    return load->done;
+}
+
+bool lazy_load_succeeded(LazyLoad* load) {
+    return load->done && load->success;
+}
+
+bool lazy_load_should_stop(LazyLoad* load) {
+    return load->stop;
+}
+
+void lazy_load_set_progress(LazyLoad* load, size_t done, size_t total) {
+    load->progress_total = total;
+    load->progress_done = done;
+
+    if(load->progress_callback) {
+        load->progress_callback(load->progress_context);
+    }
+}
+
+float lazy_load_progress(LazyLoad* load) {
+    size_t total = load->progress_total;
+    size_t done = load->progress_done;
+
+    if(total == 0) return load->done ? 1.0f : 0.0f;
+    return done >= total ? 1.0f : (float)done / (float)total;
+}
+
+size_t lazy_load_read(LazyLoad* load, File* file, void* buffer, size_t size) {
+    uint8_t* data = buffer;
+    size_t read = 0;
+
+    while(read < size && !load->stop) {
+        size_t chunk = MIN(size - read, (size_t)LAZY_LOAD_CHUNK);
+        size_t chunk_read = storage_file_read(file, data + read, chunk);
+
+        read += chunk_read;
+        load->progress_done += chunk_read;
+        if(load->progress_callback) {
+            load->progress_callback(load->progress_context);
+        }
+
+        if(chunk_read < chunk) break;
+    }
+
+    return read;
+}
+
+uint8_t* lazy_load_read_file(LazyLoad* load, Storage* storage, const char* path, size_t* size) {
+    File* file = storage_file_alloc(storage);
+    uint8_t* data = NULL;
+
+    if(storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        size_t file_size = storage_file_size(file);
+        lazy_load_set_progress(load, 0, file_size);
+
+        data = malloc(file_size + 1);
+        if(lazy_load_read(load, file, data, file_size) == file_size) {
+            data[file_size] = '\0';
+            *size = file_size;
+        } else {
+            free(data);
+            data = NULL;
+        }
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+    return data;
+}
+
+void lazy_load_draw(LazyLoad* load, Canvas* canvas, const char* label) {
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str_aligned(canvas, 64, 20, AlignCenter, AlignBottom, label);
+    elements_progress_bar(canvas, 14, 30, 100, lazy_load_progress(load));
+}
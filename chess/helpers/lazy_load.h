@@ -0,0 +1,80 @@
+#pragma once
+
+#include <furi.h>
+#include <gui/canvas.h>
+#include <storage/storage.h>
+
+/**
+ * Loads an app's files on a worker thread, so that the app can show its first view
+ * right away and draw the progress of the load in it.
+ *
+ * The load callback runs on the worker and reads with lazy_load_read() or
+ * lazy_load_read_file(). These go LAZY_LOAD_CHUNK bytes at a time, advance the progress
+ * lazy_load_draw() shows and give up once lazy_load_free() asks the load to stop. The
+ * progress callback runs on the worker each time the progress moves, to redraw the view.
+ * The done callback runs on the worker after the load callback, post an event from it to
+ * pick the result up on the app thread:
+ *
+ *     app->load = lazy_load_alloc("AppLoad", app_load_callback, app);
+ *     lazy_load_set_progress_callback(app->load, app_redraw_callback, app);
+ *     lazy_load_set_done_callback(app->load, app_load_done_callback, app);
+ *     lazy_load_start(app->load);
+ *
+ * The draw callback must be done with the LazyLoad before lazy_load_free(), with a locking
+ * view model clear the app's pointer to it under the lock first.
+ *
+ * A fap only builds its own sources, so this is copied per app like profile.c.
+ */
+
+#define LAZY_LOAD_CHUNK 1024
+#define LAZY_LOAD_STACK_SIZE 2048
+
+typedef struct LazyLoad LazyLoad;
+
+/** Loads on the worker, returns whether the load succeeded */
+typedef bool (*LazyLoadCallback)(LazyLoad* load, void* context);
+
+/** Called on the worker as the progress moves */
+typedef void (*LazyLoadProgressCallback)(void* context);
+
+/** Called on the worker once the load callback returned */
+typedef void (*LazyLoadDoneCallback)(bool success, void* context);
+
+LazyLoad* lazy_load_alloc(const char* name, LazyLoadCallback callback, void* context);
+
+/** Asks a running load to stop, waits for the worker and frees */
+void lazy_load_free(LazyLoad* load);
+
+void lazy_load_set_progress_callback(
+    LazyLoad* load,
+    LazyLoadProgressCallback callback,
+    void* context);
+
+void lazy_load_set_done_callback(LazyLoad* load, LazyLoadDoneCallback callback, void* context);
+
+void lazy_load_start(LazyLoad* load);
+
+bool lazy_load_is_done(LazyLoad* load);
+
+/** Only meaningful once lazy_load_is_done() */
+bool lazy_load_succeeded(LazyLoad* load);
+
+/** For load callbacks that do their own long steps between reads */
+bool lazy_load_should_stop(LazyLoad* load);
+
+void lazy_load_set_progress(LazyLoad* load, size_t done, size_t total);
+
+/** From 0 to 1 */
+float lazy_load_progress(LazyLoad* load);
+
+/** Reads size bytes from file in chunks and adds them to the progress. Returns the bytes
+ * read, fewer on the end of the file, an error or a stop request. */
+size_t lazy_load_read(LazyLoad* load, File* file, void* buffer, size_t size);
+
+/** Reads a whole file with lazy_load_read(), its size being the progress total. Returns
+ * a malloc'd buffer one byte longer than the file with a '\0' there, or NULL if the file
+ * could not be read. */
+uint8_t* lazy_load_read_file(LazyLoad* load, Storage* storage, const char* path, size_t* size);
+
+/** The label centered above a progress bar */
+void lazy_load_draw(LazyLoad* load, Canvas* canvas, const char* label);
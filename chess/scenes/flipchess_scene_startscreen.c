@@ -10,14 +10,32 @@ void flipchess_scene_startscreen_callback(FlipChessCustomEvent event, void* cont
     view_dispatcher_send_custom_event(app->view_dispatcher, event);
 }
 
+static bool flipchess_scene_startscreen_load(LazyLoad* load, void* context) {
+    FlipChess* app = context;
+    return flipchess_load_file(load, app->import_game_text, FlipChessFileBoard, NULL);
+}
+
+static void flipchess_scene_startscreen_load_progress(void* context) {
+    FlipChess* app = context;
+    flipchess_startscreen_update(app->flipchess_startscreen);
+}
+
+static void flipchess_scene_startscreen_load_done(bool success, void* context) {
+    UNUSED(success);
+    flipchess_scene_startscreen_callback(FlipChessCustomEventStartscreenLoaded, context);
+}
+
 void flipchess_scene_startscreen_on_enter(void* context) {
     furi_assert(context);
     FlipChess* app = context;
 
-    if(flipchess_has_file(FlipChessFileBoard, NULL, false)) {
-        if(flipchess_load_file(app->import_game_text, FlipChessFileBoard, NULL)) {
-            app->import_game = 1;
-        }
+    // the saved game is read on a worker while the start screen shows
+    if(app->load == NULL && flipchess_has_file(FlipChessFileBoard, NULL, false)) {
+        app->load = lazy_load_alloc("FlipChessLoad", flipchess_scene_startscreen_load, app);
+        lazy_load_set_progress_callback(app->load, flipchess_scene_startscreen_load_progress, app);
+        lazy_load_set_done_callback(app->load, flipchess_scene_startscreen_load_done, app);
+        flipchess_startscreen_set_load(app->flipchess_startscreen, app->load);
+        lazy_load_start(app->load);
     }
 
     flipchess_startscreen_set_callback(
@@ -41,6 +59,16 @@ bool flipchess_scene_startscreen_on_event(void* context, SceneManagerEvent event
             scene_manager_next_scene(app->scene_manager, FlipChessSceneMenu);
             consumed = true;
             break;
+        case FlipChessCustomEventStartscreenLoaded:
+            // the view is done with the load once it no longer draws it
+            flipchess_startscreen_set_load(app->flipchess_startscreen, NULL);
+            if(lazy_load_succeeded(app->load)) {
+                app->import_game = 1;
+            }
+            lazy_load_free(app->load);
+            app->load = NULL;
+            consumed = true;
+            break;
         case FlipChessCustomEventStartscreenBack:
             notification_message(app->notification, &sequence_reset_red);
             notification_message(app->notification, &sequence_reset_green);
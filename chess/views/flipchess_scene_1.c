@@ -14,6 +14,7 @@
 #define XBOARD_DEBUG 0 // will create files with xboard communication
 #define SCL_EVALUATION_FUNCTION SCL_boardEvaluateStatic
 #define SCL_DEBUG_AI 0
+#define SCL_BITBOARDS 1 // faster move generation for 5 KB of flash
 
 #include "../chess/smallchesslib.h"
 
@@ -21,6 +22,9 @@
 #define MAX_TEXT_LEN 15 // 15 = max length of text
 #define MAX_TEXT_BUF (MAX_TEXT_LEN + 1) // max length of text + null terminator
 #define THREAD_WAIT_TIME 20 // time to wait for draw thread to finish
+#define AI_MOVE_TIME 1500 // ms the AI may think per CPU level
+#define AI_DEPTH_BONUS 1 // search deeper than the level if the time allows
+#define PONDER_STACK_SIZE (4 * 1024)
 
 struct FlipChessScene1 {
     View* view;
@@ -69,6 +73,42 @@ typedef struct {
 
 static uint8_t picture[SCL_BOARD_PICTURE_WIDTH * SCL_BOARD_PICTURE_WIDTH];
 
+/* While the player thinks, the worker guesses the player's move and searches
+  the AI reply to it. The search fills the transposition table, so even a
+  wrong guess makes the real search faster. The worker never runs at the same
+  time as another search as smallchesslib keeps its search state in globals. */
+typedef struct {
+    FuriThread* thread;
+    bool running;
+    volatile bool stop;
+
+    SCL_Board board; // position with the player to move
+    uint8_t depth;
+    uint8_t extraDepth;
+    uint8_t endgameDepth;
+
+    // results, only valid after the thread is joined
+    bool done; // the reply was searched to the full depth
+    uint8_t guessFrom;
+    uint8_t guessTo;
+    char guessProm;
+    uint8_t replyFrom;
+    uint8_t replyTo;
+    char replyProm;
+    int16_t replyValue;
+} FlipChessPonder;
+
+static FlipChessPonder ponder;
+static uint32_t moveDeadline;
+
+static uint8_t flipchess_ponderShouldStop(void) {
+    return ponder.stop;
+}
+
+static uint8_t flipchess_moveTimeUp(void) {
+    return (int32_t)(furi_get_tick() - moveDeadline) >= 0;
+}
+
 void flipchess_putImagePixel(uint8_t pixel, uint16_t index) {
     picture[index] = pixel;
 }
@@ -86,6 +126,120 @@ uint8_t flipchess_stringsEqual(const char* s1, const char* s2, int max) {
     return 1;
 }
 
+bool flipchess_isPlayerTurn(FlipChessScene1Model* model) {
+    return (SCL_boardWhitesTurn(model->game.board) && model->paramPlayerW == 0) ||
+           (!SCL_boardWhitesTurn(model->game.board) && model->paramPlayerB == 0);
+}
+
+static void flipchess_getAIParams(
+    FlipChessScene1Model* model,
+    uint8_t level,
+    uint8_t* depth,
+    uint8_t* extraDepth,
+    uint8_t* endgameDepth) {
+    *depth = (level > 0) ? level : 1;
+    *extraDepth = 3;
+    *endgameDepth = 1;
+
+    if(model->clockSeconds >= 0) // when using clock, choose AI params accordingly
+    {
+        if(model->clockSeconds <= 5) {
+            *depth = 1;
+            *extraDepth = 2;
+            *endgameDepth = 0;
+        } else if(model->clockSeconds < 15) {
+            *depth = 2;
+            *extraDepth = 2;
+        } else if(model->clockSeconds < 100) {
+            *depth = 2;
+        } else if(model->clockSeconds < 5 * 60) {
+            *depth = 3;
+        } else {
+            *depth = 3;
+            *extraDepth = 4;
+        }
+    }
+}
+
+static int32_t flipchess_ponderThread(void* context) {
+    UNUSED(context);
+    SCL_Board board;
+
+    SCL_boardCopy(ponder.board, board);
+
+    // the player's move is guessed with a shallower search to leave time for the reply
+    SCL_getAIMoveIterative(
+        board,
+        ponder.depth,
+        ponder.extraDepth,
+        0,
+        SCL_boardEvaluateStatic,
+        0,
+        0,
+        0,
+        0,
+        flipchess_ponderShouldStop,
+        &(ponder.guessFrom),
+        &(ponder.guessTo),
+        &(ponder.guessProm),
+        NULL);
+
+    if(ponder.stop) return 0;
+
+    SCL_boardMakeMove(board, ponder.guessFrom, ponder.guessTo, ponder.guessProm);
+
+    if(SCL_boardGameOver(board)) return 0;
+
+    ponder.replyValue = SCL_getAIMoveIterative(
+        board,
+        ponder.depth + AI_DEPTH_BONUS,
+        ponder.extraDepth,
+        ponder.endgameDepth,
+        SCL_boardEvaluateStatic,
+        0,
+        0,
+        0,
+        0,
+        flipchess_ponderShouldStop,
+        &(ponder.replyFrom),
+        &(ponder.replyTo),
+        &(ponder.replyProm),
+        NULL);
+
+    ponder.done = !ponder.stop;
+
+    return 0;
+}
+
+static void flipchess_ponderStart(FlipChessScene1Model* model) {
+    if(ponder.running || model->game.state != SCL_GAME_STATE_PLAYING) return;
+
+    // in the first moves the AI plays with randomness for different openings
+    if(model->game.ply < 2 || !flipchess_isPlayerTurn(model)) return;
+
+    uint8_t level = SCL_boardWhitesTurn(model->game.board) ? model->paramPlayerB :
+                                                             model->paramPlayerW;
+
+    if(level == 0) return; // human against human
+
+    flipchess_getAIParams(
+        model, level, &(ponder.depth), &(ponder.extraDepth), &(ponder.endgameDepth));
+    SCL_boardCopy(model->game.board, ponder.board);
+
+    ponder.stop = false;
+    ponder.done = false;
+    ponder.running = true;
+    furi_thread_start(ponder.thread);
+}
+
+static void flipchess_ponderStop() {
+    if(!ponder.running) return;
+
+    ponder.stop = true;
+    furi_thread_join(ponder.thread);
+    ponder.running = false;
+}
+
 int16_t flipchess_makeAIMove(
     SCL_Board board,
     uint8_t* s0,
@@ -93,38 +247,40 @@ int16_t flipchess_makeAIMove(
     char* prom,
     FlipChessScene1Model* model) {
     uint8_t level = SCL_boardWhitesTurn(board) ? model->paramPlayerW : model->paramPlayerB;
-    uint8_t depth = (level > 0) ? level : 1;
-    uint8_t extraDepth = 3;
-    uint8_t endgameDepth = 1;
+    uint8_t depth, extraDepth, endgameDepth;
     uint8_t randomness =
         model->game.ply < 2 ? 1 : 0; /* in first moves increase randomness for different 
                              openings */
     uint8_t rs0, rs1;
 
+    flipchess_getAIParams(model, level, &depth, &extraDepth, &endgameDepth);
     SCL_gameGetRepetiotionMove(&(model->game), &rs0, &rs1);
 
-    if(model->clockSeconds >= 0) // when using clock, choose AI params accordingly
-    {
-        if(model->clockSeconds <= 5) {
-            depth = 1;
-            extraDepth = 2;
-            endgameDepth = 0;
-        } else if(model->clockSeconds < 15) {
-            depth = 2;
-            extraDepth = 2;
-        } else if(model->clockSeconds < 100) {
-            depth = 2;
-        } else if(model->clockSeconds < 5 * 60) {
-            depth = 3;
-        } else {
-            depth = 3;
-            extraDepth = 4;
+    flipchess_ponderStop();
+
+    // if the player made the guessed move, the reply is already known
+    if(ponder.done && ponder.depth == depth && ponder.extraDepth == extraDepth &&
+       (ponder.replyFrom != rs0 || ponder.replyTo != rs1)) {
+        SCL_Board guess;
+
+        SCL_boardCopy(ponder.board, guess);
+        SCL_boardMakeMove(guess, ponder.guessFrom, ponder.guessTo, ponder.guessProm);
+        ponder.done = false;
+
+        if(!SCL_boardsDiffer(guess, board)) {
+            *s0 = ponder.replyFrom;
+            *s1 = ponder.replyTo;
+            *prom = ponder.replyProm;
+            return ponder.replyValue;
         }
     }
 
-    return SCL_getAIMove(
+    moveDeadline = furi_get_tick() +
+                   AI_MOVE_TIME * depth * furi_kernel_get_tick_frequency() / 1000;
+
+    return SCL_getAIMoveIterative(
         board,
-        depth,
+        depth + AI_DEPTH_BONUS,
         extraDepth,
         endgameDepth,
         SCL_boardEvaluateStatic,
@@ -132,14 +288,11 @@ int16_t flipchess_makeAIMove(
         randomness,
         rs0,
         rs1,
+        flipchess_moveTimeUp,
         s0,
         s1,
-        prom);
-}
-
-bool flipchess_isPlayerTurn(FlipChessScene1Model* model) {
-    return (SCL_boardWhitesTurn(model->game.board) && model->paramPlayerW == 0) ||
-           (!SCL_boardWhitesTurn(model->game.board) && model->paramPlayerB == 0);
+        prom,
+        NULL);
 }
 
 void flipchess_shiftMessages(FlipChessScene1Model* model) {
@@ -341,6 +494,8 @@ uint8_t flipchess_turn(FlipChessScene1Model* model) {
         }
     }
 
+    flipchess_ponderStart(model);
+
     model->thinking = 0;
     return model->paramExit;
 }
@@ -652,6 +807,8 @@ void flipchess_scene_1_exit(void* context) {
     furi_assert(context);
     FlipChessScene1* instance = (FlipChessScene1*)context;
 
+    flipchess_ponderStop();
+
     with_view_model(
         instance->view, FlipChessScene1Model * model, { model->paramExit = 0; }, true);
 }
@@ -708,12 +865,19 @@ FlipChessScene1* flipchess_scene_1_alloc() {
     view_set_enter_callback(instance->view, flipchess_scene_1_enter);
     view_set_exit_callback(instance->view, flipchess_scene_1_exit);
 
+    ponder.thread =
+        furi_thread_alloc_ex("FlipChessPonder", PONDER_STACK_SIZE, flipchess_ponderThread, NULL);
+    furi_thread_set_priority(ponder.thread, FuriThreadPriorityLow);
+
     return instance;
 }
 
 void flipchess_scene_1_free(FlipChessScene1* instance) {
     furi_assert(instance);
 
+    flipchess_ponderStop();
+    furi_thread_free(ponder.thread);
+
     with_view_model(
         instance->view, FlipChessScene1Model * model, { UNUSED(model); }, true);
 
@@ -15,6 +15,7 @@ struct FlipChessStartscreen {
 
 typedef struct {
     int some_value;
+    LazyLoad* load;
 } FlipChessStartscreenModel;
 
 void flipchess_startscreen_set_callback(
@@ -28,10 +29,14 @@ void flipchess_startscreen_set_callback(
 }
 
 void flipchess_startscreen_draw(Canvas* canvas, FlipChessStartscreenModel* model) {
-    UNUSED(model);
     canvas_clear(canvas);
     canvas_set_color(canvas, ColorBlack);
 
+    if(model->load) {
+        lazy_load_draw(model->load, canvas, "Loading game");
+        return;
+    }
+
     canvas_draw_icon(canvas, 0, 0, &I_FLIPR_128x64);
 
 #ifdef CANVAS_HAS_FONT_SCUMM_ROMAN_OUTLINE
@@ -69,6 +74,11 @@ bool flipchess_startscreen_input(InputEvent* event, void* context) {
     FlipChessStartscreen* instance = context;
     FlipChess* app = instance->context;
 
+    // Left and Right go to the menu, which needs the saved game read first
+    if(app->load && (event->key == InputKeyLeft || event->key == InputKeyRight)) {
+        return true;
+    }
+
     if(event->type == InputTypeRelease) {
         switch(event->key) {
         case InputKeyBack:
@@ -159,6 +169,18 @@ void flipchess_startscreen_free(FlipChessStartscreen* instance) {
     free(instance);
 }
 
+void flipchess_startscreen_set_load(FlipChessStartscreen* instance, LazyLoad* load) {
+    furi_assert(instance);
+    with_view_model(
+        instance->view, FlipChessStartscreenModel * model, { model->load = load; }, true);
+}
+
+void flipchess_startscreen_update(FlipChessStartscreen* instance) {
+    furi_assert(instance);
+    with_view_model(
+        instance->view, FlipChessStartscreenModel * model, { UNUSED(model); }, true);
+}
+
 View* flipchess_startscreen_get_view(FlipChessStartscreen* instance) {
     furi_assert(instance);
     return instance->view;
@@ -2,6 +2,7 @@
 
 #include <gui/view.h>
 #include "../helpers/flipchess_custom_event.h"
+#include "../helpers/lazy_load.h"
 
 typedef struct FlipChessStartscreen FlipChessStartscreen;
 
@@ -12,6 +13,12 @@ void flipchess_startscreen_set_callback(
     FlipChessStartscreenCallback callback,
     void* context);
 
+// Shows the progress of load instead of the start screen until set back to NULL
+void flipchess_startscreen_set_load(FlipChessStartscreen* instance, LazyLoad* load);
+
+// Redraws the progress, from the load's worker
+void flipchess_startscreen_update(FlipChessStartscreen* instance);
+
 View* flipchess_startscreen_get_view(FlipChessStartscreen* flipchess_static);
 
 FlipChessStartscreen* flipchess_startscreen_alloc();
@@ -8,19 +8,30 @@
 #include <loader/loader_i.h>
 #include <FreeRTOS.h>
 
+// Output ring between the cli session and the gui, drained on the gui tick
+#define TX_RING_SIZE (4096)
+
 volatile bool gotCallbackSet = false;
 
 FuriStreamBuffer* tx_stream;
 FuriStreamBuffer* rx_stream;
+volatile size_t tx_dropped = 0;
 static FuriThread* volatile cliThread = NULL;
 static FuriThread* prev_appthread = NULL;
+// Never wait on the gui, output that doesn't fit in the ring is counted and dropped
+static void tx_ring_push(const void* buffer, size_t size) {
+    size_t sent = furi_stream_buffer_send(tx_stream, buffer, size, 0);
+    if(sent < size) {
+        tx_dropped += size - sent;
+    }
+}
 static void tx_handler_stdout(const char* buffer, size_t size) {
-    furi_stream_buffer_send(tx_stream, buffer, size, FuriWaitForever);
+    tx_ring_push(buffer, size);
 }
 static void tx_handler(const uint8_t* buffer, size_t size) {
     furi_thread_set_stdout_callback(tx_handler_stdout);
     cliThread = furi_thread_get_current();
-    furi_stream_buffer_send(tx_stream, buffer, size, FuriWaitForever);
+    tx_ring_push(buffer, size);
 }
 static size_t real_rx_handler(uint8_t* buffer, size_t size, uint32_t timeout) {
     size_t rx_cnt = 0;
@@ -64,7 +75,8 @@ void latch_tx_handler() {
     }
 
     rx_stream = furi_stream_buffer_alloc(128, 1);
-    tx_stream = furi_stream_buffer_alloc(128, 1);
+    tx_stream = furi_stream_buffer_alloc(TX_RING_SIZE, 1);
+    tx_dropped = 0;
 
     session.tx = &tx_handler;
     session.rx = &real_rx_handler;
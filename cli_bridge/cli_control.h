@@ -5,4 +5,6 @@
 extern void latch_tx_handler();
 extern void unlatch_tx_handler(bool persist);
 extern FuriStreamBuffer* tx_stream;
-extern FuriStreamBuffer* rx_stream;
\ No newline at end of file
+extern FuriStreamBuffer* rx_stream;
+// Bytes of cli output lost because the gui fell behind
+extern volatile size_t tx_dropped;
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include "console_output.h"
 #include <gui/view_dispatcher_i.h>
 
+#define RX_CHUNK_SIZE (256)
+
 static bool cligui_custom_event_cb(void* context, uint32_t event) {
     UNUSED(event);
     CliguiApp* app = context;
@@ -17,20 +19,39 @@ static bool cligui_back_event_cb(void* context) {
 }
 static void cligui_tick_event_cb(void* context) {
     CliguiApp* app = context;
-    size_t available = furi_stream_buffer_bytes_available(app->data->streams.app_rx);
-    for(size_t i = 0; i < available; i++) {
-        char c = 0;
-        size_t len = furi_stream_buffer_receive(app->data->streams.app_rx, &c, 1, 100);
-        if(len > 0) {
-            furi_string_push_back(app->text_box_store, c);
-        }
+    bool changed = false;
+    // Drain everything the cli queued since the last tick in a few large reads
+    char chunk[RX_CHUNK_SIZE + 1];
+    size_t len;
+    while((len = furi_stream_buffer_receive(app->data->streams.app_rx, chunk, RX_CHUNK_SIZE, 0)) >
+          0) {
+        chunk[len] = '\0';
+        furi_string_cat_str(app->text_box_store, chunk);
+        changed = true;
     }
-    if(available > 0) {
-        text_box_set_text(app->text_box, furi_string_get_cstr(app->text_box_store));
+    size_t dropped = tx_dropped;
+    if(dropped != app->tx_dropped_seen) {
+        furi_string_cat_printf(
+            app->text_box_store, "\n[%zu bytes dropped]\n", dropped - app->tx_dropped_seen);
+        app->tx_dropped_seen = dropped;
+        changed = true;
     }
+    if(!changed) {
+        return;
+    }
+
+    // Limit the scrollback, keeping whole lines of the newest output
+    len = furi_string_size(app->text_box_store);
+    if(len > TEXT_BOX_STORE_SIZE) {
+        size_t cut = len - TEXT_BOX_STORE_SIZE;
+        size_t newline = furi_string_search_char(app->text_box_store, '\n', cut);
+        furi_string_right(app->text_box_store, newline == FURI_STRING_FAILURE ? cut : newline + 1);
+        len = furi_string_size(app->text_box_store);
+    }
+    text_box_set_text(app->text_box, furi_string_get_cstr(app->text_box_store));
+
     // Set input header stuff
-    size_t len = furi_string_size(app->text_box_store);
-    size_t idx = len - 2;
+    size_t idx = len > 1 ? len - 2 : 0;
     while(idx > 0) {
         if(furi_string_get_char(app->text_box_store, idx) == '\n') {
             idx++;
@@ -39,7 +60,6 @@ static void cligui_tick_event_cb(void* context) {
         idx--;
     }
     text_input_set_header_text(app->text_input, furi_string_get_cstr(app->text_box_store) + idx);
-    UNUSED(app);
 }
 
 ViewPortInputCallback prev_input_callback;
@@ -72,6 +92,7 @@ int32_t cligui_main(void* p) {
     latch_tx_handler();
     cligui->data->streams.app_tx = rx_stream;
     cligui->data->streams.app_rx = tx_stream;
+    cligui->tx_dropped_seen = 0;
 
     cligui->gui = furi_record_open(RECORD_GUI);
     cligui->view_dispatcher = view_dispatcher_alloc();
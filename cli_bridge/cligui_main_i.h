@@ -12,6 +12,7 @@
 #include <m-dict.h>
 #include <loader/loader.h>
 
+// Scrollback limit of the console output, in bytes
 #define TEXT_BOX_STORE_SIZE (4096)
 #define TEXT_INPUT_STORE_SIZE (512)
 
@@ -33,6 +34,7 @@ typedef struct {
     Gui* gui;
     TextBox* text_box;
     FuriString* text_box_store;
+    size_t tx_dropped_seen;
     char text_input_store[TEXT_INPUT_STORE_SIZE + 1];
     TextInput* text_input;
     ViewDispatcher* view_dispatcher;
@@ -1,7 +1,16 @@
 #include "views/countdown_view.h"
+#include "utils/utils.h"
 #include "app.h"
 
+#define LIST_INDEX_NEW TIMERS_MAX
+
+typedef enum {
+    CountDownCustomEventTick,
+} CountDownCustomEvent;
+
 static void register_view(ViewDispatcher* dispatcher, View* view, uint32_t viewid);
+static void countdown_app_fill_list(CountDownTimerApp* app);
+static void countdown_app_sync_ticker(CountDownTimerApp* app);
 
 int32_t app_main(void* p) {
     UNUSED(p);
@@ -16,31 +25,170 @@ int32_t app_main(void* p) {
 }
 
 static uint32_t view_exit(void* ctx) {
-    furi_assert(ctx);
+    UNUSED(ctx);
 
     return VIEW_NONE;
 }
 
+static uint32_t view_list(void* ctx) {
+    UNUSED(ctx);
+
+    return CountDownViewList;
+}
+
+static void ticker_cb(void* ctx) {
+    CountDownTimerApp* app = ctx;
+
+    // handled on the gui thread like the input
+    view_dispatcher_send_custom_event(app->view_dispatcher, CountDownCustomEventTick);
+}
+
+// stop the timers that ran out, alert if any did
+static void countdown_app_expire(CountDownTimerApp* app) {
+    if(timers_expire(&app->timers, furi_hal_rtc_get_timestamp())) {
+        timers_save(&app->timers);
+        countdown_app_fill_list(app);
+        notification_timeup();
+    }
+}
+
+static bool custom_event_cb(void* ctx, uint32_t event) {
+    CountDownTimerApp* app = ctx;
+
+    if(event == CountDownCustomEventTick) {
+        countdown_app_expire(app);
+        countdown_timer_view_update(app->helloworld_view);
+        countdown_app_sync_ticker(app);
+        return true;
+    }
+
+    return false;
+}
+
+static void countdown_app_open_timer(CountDownTimerApp* app, uint8_t index) {
+    app->current = index;
+    countdown_timer_view_set_timer(app->helloworld_view, &app->timers.timers[index]);
+    view_dispatcher_switch_to_view(app->view_dispatcher, CountDownViewTimer);
+}
+
+static void name_input_cb(void* ctx) {
+    CountDownTimerApp* app = ctx;
+
+    if(app->renaming) {
+        strlcpy(app->timers.timers[app->current].name, app->name, TIMER_NAME_SIZE);
+    } else if(timers_add(&app->timers, app->name, app->timers.timers[app->current].setting)) {
+        app->current = app->timers.count - 1;
+    }
+
+    timers_save(&app->timers);
+    countdown_app_fill_list(app);
+    countdown_app_open_timer(app, app->current);
+}
+
+static void countdown_app_ask_name(CountDownTimerApp* app, bool renaming) {
+    app->renaming = renaming;
+    if(renaming) {
+        strlcpy(app->name, app->timers.timers[app->current].name, sizeof(app->name));
+    } else {
+        snprintf(app->name, sizeof(app->name), "Timer %d", app->timers.count + 1);
+    }
+
+    text_input_set_header_text(app->name_input, renaming ? "Rename timer" : "New timer");
+    text_input_set_result_callback(
+        app->name_input, name_input_cb, app, app->name, sizeof(app->name), !renaming);
+    view_dispatcher_switch_to_view(app->view_dispatcher, CountDownViewName);
+}
+
+static void list_cb(void* ctx, uint32_t index) {
+    CountDownTimerApp* app = ctx;
+
+    if(index == LIST_INDEX_NEW) {
+        countdown_app_ask_name(app, false);
+    } else if(index < app->timers.count) {
+        countdown_app_open_timer(app, index);
+    }
+}
+
+static void timer_view_cb(CountDownTimerEvent event, void* ctx) {
+    CountDownTimerApp* app = ctx;
+
+    switch(event) {
+    case CountDownTimerEventRename:
+        countdown_app_ask_name(app, true);
+        return;
+
+    case CountDownTimerEventSet:
+        // saved with the next start or on exit, not on every step while a key repeats
+        return;
+
+    case CountDownTimerEventDelete:
+        // the last one stays
+        if(app->timers.count == 1) {
+            return;
+        }
+        timers_remove(&app->timers, app->current);
+        app->current = 0;
+        countdown_timer_view_set_timer(app->helloworld_view, &app->timers.timers[0]);
+        view_dispatcher_switch_to_view(app->view_dispatcher, CountDownViewList);
+        break;
+
+    default:
+        break;
+    }
+
+    timers_save(&app->timers);
+    countdown_app_fill_list(app);
+    countdown_app_sync_ticker(app);
+}
+
 CountDownTimerApp* countdown_app_new(void) {
     CountDownTimerApp* app = (CountDownTimerApp*)(malloc(sizeof(CountDownTimerApp)));
 
     // 1.1 open gui
     app->gui = furi_record_open(RECORD_GUI);
 
+    // 1.2 load the timers, the ones that ran out with the app closed go off now
+    timers_load(&app->timers);
+    app->current = 0;
+    app->renaming = false;
+    app->ticker = furi_timer_alloc(ticker_cb, FuriTimerTypePeriodic, app);
+
     // 2.1 setup view dispatcher
     app->view_dispatcher = view_dispatcher_alloc();
     view_dispatcher_enable_queue(app->view_dispatcher);
+    view_dispatcher_set_event_callback_context(app->view_dispatcher, app);
+    view_dispatcher_set_custom_event_callback(app->view_dispatcher, custom_event_cb);
 
     // 2.2 attach view dispatcher to gui
     view_dispatcher_attach_to_gui(app->view_dispatcher, app->gui, ViewDispatcherTypeFullscreen);
 
     // 2.3 attach views to the dispatcher
-    // helloworld view
+    app->list = submenu_alloc();
+    register_view(app->view_dispatcher, submenu_get_view(app->list), CountDownViewList);
+    view_set_previous_callback(submenu_get_view(app->list), view_exit);
+
+    // countdown view
     app->helloworld_view = countdown_timer_view_new();
-    register_view(app->view_dispatcher, countdown_timer_view_get_view(app->helloworld_view), 0xff);
+    countdown_timer_view_set_callback(app->helloworld_view, timer_view_cb, app);
+    register_view(
+        app->view_dispatcher,
+        countdown_timer_view_get_view(app->helloworld_view),
+        CountDownViewTimer);
+
+    app->name_input = text_input_alloc();
+    register_view(app->view_dispatcher, text_input_get_view(app->name_input), CountDownViewName);
 
-    // 2.5 switch to default view
-    view_dispatcher_switch_to_view(app->view_dispatcher, 0xff);
+    countdown_app_expire(app);
+    countdown_app_fill_list(app);
+    countdown_app_sync_ticker(app);
+
+    // 2.5 switch to default view, the only timer needs no list
+    if(app->timers.count == 1) {
+        countdown_app_open_timer(app, 0);
+    } else {
+        countdown_timer_view_set_timer(app->helloworld_view, &app->timers.timers[0]);
+        view_dispatcher_switch_to_view(app->view_dispatcher, CountDownViewList);
+    }
 
     return app;
 }
@@ -48,9 +196,19 @@ CountDownTimerApp* countdown_app_new(void) {
 void countdown_app_delete(CountDownTimerApp* app) {
     furi_assert(app);
 
+    furi_timer_stop(app->ticker);
+    furi_timer_free(app->ticker);
+
+    // running timers keep their deadlines
+    timers_save(&app->timers);
+
     // delete views
-    view_dispatcher_remove_view(app->view_dispatcher, 0xff);
+    view_dispatcher_remove_view(app->view_dispatcher, CountDownViewList);
+    view_dispatcher_remove_view(app->view_dispatcher, CountDownViewTimer);
+    view_dispatcher_remove_view(app->view_dispatcher, CountDownViewName);
+    submenu_free(app->list);
     countdown_timer_view_delete(app->helloworld_view); // hello world view
+    text_input_free(app->name_input);
 
     // delete view dispatcher
     view_dispatcher_free(app->view_dispatcher);
@@ -67,5 +225,37 @@ void countdown_app_run(CountDownTimerApp* app) {
 static void register_view(ViewDispatcher* dispatcher, View* view, uint32_t viewid) {
     view_dispatcher_add_view(dispatcher, viewid, view);
 
-    view_set_previous_callback(view, view_exit);
+    view_set_previous_callback(view, view_list);
+}
+
+// names with what the timers are doing, only changes when one does
+static void countdown_app_fill_list(CountDownTimerApp* app) {
+    char label[TIMER_NAME_SIZE + 16];
+    char time[16];
+
+    submenu_reset(app->list);
+    for(uint8_t i = 0; i < app->timers.count; i++) {
+        CountDownTimer* timer = &app->timers.timers[i];
+        if(timer_running(timer)) {
+            snprintf(label, sizeof(label), "%s: running", timer->name);
+        } else {
+            parse_sec_to_time_str(time, sizeof(time), timer->remaining);
+            snprintf(label, sizeof(label), "%s: %s", timer->name, time);
+        }
+        submenu_add_item(app->list, label, i, list_cb, app);
+    }
+    if(app->timers.count < TIMERS_MAX) {
+        submenu_add_item(app->list, "+ New timer", LIST_INDEX_NEW, list_cb, app);
+    }
+    submenu_set_selected_item(app->list, app->current);
+}
+
+// tick only while there is something counting down
+static void countdown_app_sync_ticker(CountDownTimerApp* app) {
+    bool running = timers_running(&app->timers);
+    if(running && !furi_timer_is_running(app->ticker)) {
+        furi_timer_start(app->ticker, furi_kernel_get_tick_frequency()); // 1s
+    } else if(!running) {
+        furi_timer_stop(app->ticker);
+    }
 }
@@ -4,6 +4,16 @@
 #include <furi.h>
 #include <gui/gui.h>
 #include <gui/view_dispatcher.h>
+#include <gui/modules/submenu.h>
+#include <gui/modules/text_input.h>
+
+#include "utils/timers.h"
+
+typedef enum {
+    CountDownViewList,
+    CountDownViewTimer,
+    CountDownViewName,
+} CountDownViewId;
 
 // app
 typedef struct {
@@ -11,12 +21,20 @@ typedef struct {
     ViewDispatcher* view_dispatcher; // view dispacther of the gui
 
     // views
+    Submenu* list;
     CountDownTimView* helloworld_view;
+    TextInput* name_input;
+
+    CountDownTimers timers; // saved to the SD card on every change
+    uint8_t current; // timer on the countdown view
+    bool renaming; // the name input renames the current timer instead of adding one
+    char name[TIMER_NAME_SIZE];
 
+    FuriTimer* ticker; // 1Hz while a timer runs
 } CountDownTimerApp;
 
 CountDownTimerApp* countdown_app_new(void);
 void countdown_app_delete(CountDownTimerApp* app);
 void countdown_app_run(CountDownTimerApp* app);
 
-#endif
\ No newline at end of file
+#endif
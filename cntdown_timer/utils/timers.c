@@ -0,0 +1,127 @@
+#include "timers.h"
+
+#include <storage/storage.h>
+
+#define TIMERS_PATH APP_DATA_PATH("timers.dat")
+// "CDT" and the layout version
+#define TIMERS_MAGIC 0x01544443
+
+#define INIT_COUNT 10
+
+void timers_load(CountDownTimers* timers) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+
+    bool loaded = storage_file_open(file, TIMERS_PATH, FSAM_READ, FSOM_OPEN_EXISTING) &&
+                  storage_file_read(file, timers, sizeof(CountDownTimers)) ==
+                      sizeof(CountDownTimers) &&
+                  timers->magic == TIMERS_MAGIC && timers->count <= TIMERS_MAX;
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    if(!loaded) {
+        memset(timers, 0, sizeof(CountDownTimers));
+        timers->magic = TIMERS_MAGIC;
+    }
+    if(!timers->count) {
+        timers_add(timers, "Timer", INIT_COUNT);
+    }
+}
+
+void timers_save(const CountDownTimers* timers) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, STORAGE_APP_DATA_PATH_PREFIX);
+    File* file = storage_file_alloc(storage);
+
+    if(storage_file_open(file, TIMERS_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        storage_file_write(file, timers, sizeof(CountDownTimers));
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+CountDownTimer* timers_add(CountDownTimers* timers, const char* name, int32_t setting) {
+    if(timers->count == TIMERS_MAX) {
+        return NULL;
+    }
+
+    CountDownTimer* timer = &timers->timers[timers->count++];
+    memset(timer, 0, sizeof(CountDownTimer));
+    strlcpy(timer->name, name, sizeof(timer->name));
+    timer_set(timer, setting);
+    return timer;
+}
+
+void timers_remove(CountDownTimers* timers, uint8_t index) {
+    furi_assert(index < timers->count);
+
+    memmove(
+        &timers->timers[index],
+        &timers->timers[index + 1],
+        sizeof(CountDownTimer) * (timers->count - index - 1));
+    timers->count--;
+}
+
+uint8_t timers_expire(CountDownTimers* timers, uint32_t now) {
+    uint8_t expired = 0;
+    for(uint8_t i = 0; i < timers->count; i++) {
+        CountDownTimer* timer = &timers->timers[i];
+        if(timer_running(timer) && timer_remaining(timer, now) == 0) {
+            timer_pause(timer, now);
+            expired++;
+        }
+    }
+    return expired;
+}
+
+bool timers_running(const CountDownTimers* timers) {
+    for(uint8_t i = 0; i < timers->count; i++) {
+        if(timer_running(&timers->timers[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool timer_running(const CountDownTimer* timer) {
+    return timer->deadline != 0;
+}
+
+int32_t timer_remaining(const CountDownTimer* timer, uint32_t now) {
+    if(!timer_running(timer)) {
+        return timer->remaining;
+    }
+    return timer->deadline > now ? (int32_t)(timer->deadline - now) : 0;
+}
+
+void timer_start(CountDownTimer* timer, uint32_t now) {
+    if(timer_running(timer) || timer->remaining <= 0) {
+        return;
+    }
+    timer->deadline = now + timer->remaining;
+}
+
+void timer_pause(CountDownTimer* timer, uint32_t now) {
+    if(!timer_running(timer)) {
+        return;
+    }
+    timer->remaining = timer_remaining(timer, now);
+    timer->deadline = 0;
+}
+
+void timer_reset(CountDownTimer* timer) {
+    timer->deadline = 0;
+    timer->remaining = timer->setting;
+}
+
+void timer_set(CountDownTimer* timer, int32_t setting) {
+    if(timer_running(timer)) {
+        return;
+    }
+    timer->setting = setting < 0 ? 0 : setting;
+    timer->remaining = timer->setting;
+}
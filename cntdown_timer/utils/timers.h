@@ -0,0 +1,44 @@
+#ifndef __TIMERS_H__
+#define __TIMERS_H__
+
+#include <furi.h>
+
+#define TIMERS_MAX 6
+#define TIMER_NAME_SIZE 16
+
+// A running timer only keeps the RTC timestamp it runs out at, so it goes on counting with
+// the app closed and is caught up from the clock when the app opens again.
+typedef struct {
+    char name[TIMER_NAME_SIZE];
+    int32_t setting; // seconds it counts down from
+    int32_t remaining; // seconds left while paused
+    uint32_t deadline; // timestamp it runs out at, 0 while paused
+} CountDownTimer;
+
+typedef struct {
+    uint32_t magic;
+    uint8_t count;
+    CountDownTimer timers[TIMERS_MAX];
+} CountDownTimers;
+
+// load the timers from the SD card, a first timer if there are none
+void timers_load(CountDownTimers* timers);
+void timers_save(const CountDownTimers* timers);
+
+// NULL if there is no room for another one
+CountDownTimer* timers_add(CountDownTimers* timers, const char* name, int32_t setting);
+void timers_remove(CountDownTimers* timers, uint8_t index);
+
+// stop the running timers that ran out by now, return how many did
+uint8_t timers_expire(CountDownTimers* timers, uint32_t now);
+bool timers_running(const CountDownTimers* timers);
+
+bool timer_running(const CountDownTimer* timer);
+int32_t timer_remaining(const CountDownTimer* timer, uint32_t now);
+void timer_start(CountDownTimer* timer, uint32_t now);
+void timer_pause(CountDownTimer* timer, uint32_t now);
+void timer_reset(CountDownTimer* timer);
+// change the setting of a paused timer, its count restarts from it
+void timer_set(CountDownTimer* timer, int32_t setting);
+
+#endif // __TIMERS_H__
@@ -7,23 +7,20 @@ static void handle_time_setting_updown(CountDownTimView* cdv, CountDownViewCmd c
 static void handle_time_setting_select(InputKey key, CountDownTimView* cdv);
 static void draw_selection(Canvas* canvas, CountDownViewSelect selection);
 
-static void countdown_timer_start_counting(CountDownTimView* cdv);
-static void countdown_timer_pause_counting(CountDownTimView* cdv);
+static void countdown_timer_notify(CountDownTimView* cdv, CountDownTimerEvent event);
 
 // callbacks
 static void countdown_timer_view_on_enter(void* ctx);
 static void countdown_timer_view_on_draw(Canvas* canvas, void* ctx);
 static bool countdown_timer_view_on_input(InputEvent* event, void* ctx);
-static void timer_cb(void* ctx);
 
 CountDownTimView* countdown_timer_view_new() {
     CountDownTimView* cdv = (CountDownTimView*)(malloc(sizeof(CountDownTimView)));
 
     cdv->view = view_alloc();
 
-    cdv->timer = furi_timer_alloc(timer_cb, FuriTimerTypePeriodic, cdv);
-
-    cdv->counting = false;
+    cdv->timer = NULL;
+    cdv->callback = NULL;
 
     view_set_context(cdv->view, cdv);
 
@@ -40,8 +37,6 @@ void countdown_timer_view_delete(CountDownTimView* cdv) {
     furi_assert(cdv);
 
     view_free(cdv->view);
-    furi_timer_stop(cdv->timer);
-    furi_timer_free(cdv->timer);
 
     free(cdv);
 }
@@ -50,22 +45,70 @@ View* countdown_timer_view_get_view(CountDownTimView* cdv) {
     return cdv->view;
 }
 
-void countdown_timer_view_state_reset(CountDownTimView* cdv) {
-    cdv->counting = false;
+void countdown_timer_view_set_callback(
+    CountDownTimView* cdv,
+    CountDownTimerViewCallback callback,
+    void* ctx) {
+    cdv->callback = callback;
+    cdv->callback_ctx = ctx;
+}
+
+void countdown_timer_view_set_timer(CountDownTimView* cdv, CountDownTimer* timer) {
+    cdv->timer = timer;
+    countdown_timer_view_update(cdv);
+}
+
+void countdown_timer_view_update(CountDownTimView* cdv) {
+    CountDownTimer* timer = cdv->timer;
+    if(!timer) {
+        return;
+    }
+
+    int32_t count = timer_remaining(timer, furi_hal_rtc_get_timestamp());
+    bool counting = timer_running(timer);
+    bool changed = false;
 
     with_view_model(
-        cdv->view, CountDownModel * model, { model->count = model->saved_count_setting; }, true)
+        cdv->view,
+        CountDownModel * model,
+        {
+            changed = model->count != count || model->saved_count_setting != timer->setting ||
+                      model->counting != counting || strcmp(model->name, timer->name) != 0;
+            model->count = count;
+            model->saved_count_setting = timer->setting;
+            model->counting = counting;
+            strlcpy(model->name, timer->name, sizeof(model->name));
+        },
+        changed);
+}
+
+void countdown_timer_view_state_reset(CountDownTimView* cdv) {
+    timer_reset(cdv->timer);
+    countdown_timer_notify(cdv, CountDownTimerEventChanged);
 }
 
 void countdown_timer_state_toggle(CountDownTimView* cdv) {
-    bool on = cdv->counting;
-    if(!on) {
-        countdown_timer_start_counting(cdv);
+    uint32_t now = furi_hal_rtc_get_timestamp();
+    if(!timer_running(cdv->timer)) {
+        // one that ran out starts over
+        if(timer_remaining(cdv->timer, now) == 0) {
+            timer_reset(cdv->timer);
+        }
+        timer_start(cdv->timer, now);
     } else {
-        countdown_timer_pause_counting(cdv);
+        timer_pause(cdv->timer, now);
+        notification_off();
     }
 
-    cdv->counting = !on;
+    countdown_timer_notify(cdv, CountDownTimerEventChanged);
+}
+
+// let the app save the timer, then show it as it is now
+static void countdown_timer_notify(CountDownTimView* cdv, CountDownTimerEvent event) {
+    if(cdv->callback) {
+        cdv->callback(event, cdv->callback_ctx);
+    }
+    countdown_timer_view_update(cdv);
 }
 
 // on enter callback, CountDownTimView as ctx
@@ -74,15 +117,8 @@ static void countdown_timer_view_on_enter(void* ctx) {
 
     CountDownTimView* cdv = (CountDownTimView*)ctx;
 
-    // set current count to a initial value
-    with_view_model(
-        cdv->view,
-        CountDownModel * model,
-        {
-            model->count = INIT_COUNT;
-            model->saved_count_setting = INIT_COUNT;
-        },
-        true);
+    // it may have counted on while another view was shown
+    countdown_timer_view_update(cdv);
 }
 
 // view draw callback, CountDownModel as ctx
@@ -106,7 +142,11 @@ static void countdown_timer_view_on_draw(Canvas* canvas, void* ctx) {
     canvas_draw_str_aligned(
         canvas, SCREEN_CENTER_X, SCREEN_CENTER_Y, AlignCenter, AlignCenter, buffer);
 
-    elements_progress_bar(canvas, 0, 0, SCREEN_WIDTH, (1.0 * count / expected_count));
+    elements_progress_bar(
+        canvas, 0, 0, SCREEN_WIDTH, expected_count ? (1.0 * count / expected_count) : 0);
+
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str_aligned(canvas, SCREEN_CENTER_X, 13, AlignCenter, AlignTop, model->name);
 }
 
 // keys input event callback, CountDownTimView as ctx
@@ -119,9 +159,15 @@ static bool countdown_timer_view_on_input(InputEvent* event, void* ctx) {
         switch(event->key) {
         case InputKeyUp:
         case InputKeyDown:
+            handle_time_setting_select(event->key, hw);
+            break;
+
         case InputKeyRight:
         case InputKeyLeft:
-            handle_time_setting_select(event->key, hw);
+            // holding them down renames or deletes the timer
+            if(event->type == InputTypeShort) {
+                handle_time_setting_select(event->key, hw);
+            }
             break;
 
         case InputKeyOk:
@@ -146,6 +192,14 @@ static bool countdown_timer_view_on_input(InputEvent* event, void* ctx) {
             handle_misc_cmd(hw, CountDownTimerReset);
             break;
 
+        case InputKeyRight:
+            countdown_timer_notify(hw, CountDownTimerEventRename);
+            break;
+
+        case InputKeyLeft:
+            countdown_timer_notify(hw, CountDownTimerEventDelete);
+            break;
+
         case InputKeyBack:
             return false;
             break;
@@ -160,89 +214,40 @@ static bool countdown_timer_view_on_input(InputEvent* event, void* ctx) {
     return false;
 }
 
-static void timer_cb(void* ctx) {
-    furi_assert(ctx);
-
-    CountDownTimView* cdv = (CountDownTimView*)ctx;
-
-    int32_t count;
-    bool timeup = false;
-
-    // decrement counter
-    with_view_model(
-        cdv->view,
-        CountDownModel * model,
-        {
-            count = model->count;
-            count--;
-
-            // check timeup
-            if(count <= 0) {
-                count = 0;
-                timeup = true;
-            }
-
-            model->count = count;
-        },
-        true);
-
-    if(timeup) {
-        handle_misc_cmd(cdv, CountDownTimerTimeUp);
-    }
-}
-
 static void handle_time_setting_updown(CountDownTimView* cdv, CountDownViewCmd cmd) {
-    int32_t count;
+    int32_t count = cdv->timer->remaining;
 
-    with_view_model(
-        cdv->view,
-        CountDownModel * model,
-        {
-            count = model->count;
-            switch(cmd) {
-            case CountDownTimerMinuteUp:
-                count += 60;
-                break;
-            case CountDownTimerMinuteDown:
-                count -= 60;
-                break;
-            case CountDownTimerHourDown:
-                count -= 3600;
-                break;
-            case CountDownTimerHourUp:
-                count += 3600;
-                break;
-            case CountDownTimerSecUp:
-                count++;
-                break;
-            case CountDownTimerSecDown:
-                count--;
-                break;
-            default:
-                break;
-            }
-
-            if(count < 0) {
-                count = 0;
-            }
-
-            // update count state
-            model->count = count;
+    switch(cmd) {
+    case CountDownTimerMinuteUp:
+        count += 60;
+        break;
+    case CountDownTimerMinuteDown:
+        count -= 60;
+        break;
+    case CountDownTimerHourDown:
+        count -= 3600;
+        break;
+    case CountDownTimerHourUp:
+        count += 3600;
+        break;
+    case CountDownTimerSecUp:
+        count++;
+        break;
+    case CountDownTimerSecDown:
+        count--;
+        break;
+    default:
+        break;
+    }
 
-            // save the count time setting
-            model->saved_count_setting = count;
-        },
-        true);
+    // the count time setting, the count starts over from it
+    timer_set(cdv->timer, count);
+    countdown_timer_notify(cdv, CountDownTimerEventSet);
 }
 
 static void handle_misc_cmd(CountDownTimView* hw, CountDownViewCmd cmd) {
     switch(cmd) {
-    case CountDownTimerTimeUp:
-        notification_timeup();
-        break;
-
     case CountDownTimerReset:
-        furi_timer_stop(hw->timer);
         countdown_timer_view_state_reset(hw);
         notification_off();
 
@@ -260,7 +265,7 @@ static void handle_misc_cmd(CountDownTimView* hw, CountDownViewCmd cmd) {
 }
 
 static void handle_time_setting_select(InputKey key, CountDownTimView* cdv) {
-    bool counting = cdv->counting;
+    bool counting = timer_running(cdv->timer);
     CountDownViewCmd setting_cmd = CountDownTimerSecUp;
     CountDownViewSelect selection;
 
@@ -322,7 +327,7 @@ static void handle_time_setting_select(InputKey key, CountDownTimView* cdv) {
 
     // save selection to model context
     with_view_model(
-        cdv->view, CountDownModel * model, { model->select = selection; }, false);
+        cdv->view, CountDownModel * model, { model->select = selection; }, true);
 }
 
 static void draw_selection(Canvas* canvas, CountDownViewSelect selection) {
@@ -338,12 +343,3 @@ static void draw_selection(Canvas* canvas, CountDownViewSelect selection) {
         break;
     }
 }
-
-static void countdown_timer_start_counting(CountDownTimView* cdv) {
-    furi_timer_start(cdv->timer, furi_kernel_get_tick_frequency() * 1); // 1s
-}
-
-static void countdown_timer_pause_counting(CountDownTimView* cdv) {
-    furi_timer_stop(cdv->timer);
-    notification_off();
-}
\ No newline at end of file
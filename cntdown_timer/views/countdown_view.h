@@ -6,13 +6,13 @@
 #include <gui/view.h>
 #include <gui/elements.h>
 
+#include "../utils/timers.h"
+
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
 #define SCREEN_CENTER_X (SCREEN_WIDTH / 2)
 #define SCREEN_CENTER_Y (SCREEN_HEIGHT / 2)
 
-#define INIT_COUNT 10
-
 typedef enum {
     CountDownTimerMinuteUp,
     CountDownTimerMinuteDown,
@@ -21,10 +21,19 @@ typedef enum {
     CountDownTimerHourUp,
     CountDownTimerHourDown,
     CountDownTimerReset,
-    CountDownTimerTimeUp,
     CountDownTimerToggleCounting,
 } CountDownViewCmd;
 
+// what the view asks of the app
+typedef enum {
+    CountDownTimerEventChanged, // started, paused or reset
+    CountDownTimerEventSet, // count time setting changed
+    CountDownTimerEventRename,
+    CountDownTimerEventDelete,
+} CountDownTimerEvent;
+
+typedef void (*CountDownTimerViewCallback)(CountDownTimerEvent event, void* ctx);
+
 typedef enum {
     CountDownTimerSelectSec,
     CountDownTimerSelectMinute,
@@ -35,12 +44,15 @@ typedef struct {
     int32_t count;
     int32_t saved_count_setting;
     CountDownViewSelect select; // setting
+    bool counting;
+    char name[TIMER_NAME_SIZE];
 } CountDownModel;
 
 typedef struct {
     View* view;
-    FuriTimer* timer; // 1Hz tick timer
-    bool counting;
+    CountDownTimer* timer; // timer on the screen, owned by the app
+    CountDownTimerViewCallback callback;
+    void* callback_ctx;
 
 } CountDownTimView;
 
@@ -54,6 +66,17 @@ void countdown_timer_view_delete(CountDownTimView* cdv);
 // return view
 View* countdown_timer_view_get_view(CountDownTimView* cdv);
 
+void countdown_timer_view_set_callback(
+    CountDownTimView* cdv,
+    CountDownTimerViewCallback callback,
+    void* ctx);
+
+// show the timer and keep the display in step with it
+void countdown_timer_view_set_timer(CountDownTimView* cdv, CountDownTimer* timer);
+
+// redraw if the timer changed, once a second while it runs
+void countdown_timer_view_update(CountDownTimView* cdv);
+
 void countdown_timer_view_state_reset(CountDownTimView* cdv); // set initial state
 void countdown_timer_state_toggle(CountDownTimView* cdv);
 #endif // __COUNTDOWN_VIEW_H__
\ No newline at end of file
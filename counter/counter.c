@@ -2,6 +2,7 @@
 #include <gui/gui.h>
 #include <input/input.h>
 #include <stdlib.h>
+#include <storage/storage.h>
 #include <counter_icons.h>
 
 #define MAX_COUNT 99
@@ -10,6 +11,7 @@
 #define MIDDLE_X 64 - BOXWIDTH / 2
 #define MIDDLE_Y 32 - BOXWIDTH / 2
 #define OFFSET_Y 9
+#define COUNT_FILENAME APP_DATA_PATH("count.save")
 
 typedef struct {
     FuriMessageQueue* input_queue;
@@ -22,6 +24,35 @@ typedef struct {
     int boxtimer;
 } Counter;
 
+// the count is kept on the SD card between runs
+static void count_load(Counter* c) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+
+    int count = 0;
+    if(storage_file_open(file, COUNT_FILENAME, FSAM_READ, FSOM_OPEN_EXISTING) &&
+       storage_file_read(file, &count, sizeof(count)) == sizeof(count) && count >= 0 &&
+       count <= MAX_COUNT) {
+        c->count = count;
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+static void count_save(Counter* c) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, STORAGE_APP_DATA_PATH_PREFIX);
+    File* file = storage_file_alloc(storage);
+
+    if(storage_file_open(file, COUNT_FILENAME, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        storage_file_write(file, &c->count, sizeof(c->count));
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
 void state_free(Counter* c) {
     gui_remove_view_port(c->gui, c->view_port);
     furi_record_close(RECORD_GUI);
@@ -72,6 +103,7 @@ Counter* state_init() {
     c->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
     c->count = 0;
     c->boxtimer = 0;
+    count_load(c);
     view_port_input_callback_set(c->view_port, input_callback, c);
     view_port_draw_callback_set(c->view_port, render_callback, c);
     gui_add_view_port(c->gui, c->view_port, GuiLayerFullscreen);
@@ -87,6 +119,7 @@ int32_t counterapp(void) {
             furi_check(furi_mutex_acquire(c->mutex, FuriWaitForever) == FuriStatusOk);
 
             if(input.key == InputKeyBack) {
+                count_save(c);
                 furi_mutex_release(c->mutex);
                 state_free(c);
                 return 0;
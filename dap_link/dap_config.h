@@ -13,8 +13,11 @@
 #define DAP_CONFIG_DEFAULT_PORT DAP_PORT_SWD
 #define DAP_CONFIG_DEFAULT_CLOCK 4200000 // Hz
 
+// USB is full speed only, so a packet is limited to a single 64 byte endpoint transfer.
+// Advertising several packets lets the host queue requests: the next one waits in the
+// endpoint buffer while the current one is processed and its response is sent.
 #define DAP_CONFIG_PACKET_SIZE 64
-#define DAP_CONFIG_PACKET_COUNT 1
+#define DAP_CONFIG_PACKET_COUNT 4
 
 #define DAP_CONFIG_JTAG_DEV_COUNT 8
 
@@ -64,6 +67,17 @@ static inline void DAP_CONFIG_SWDIO_TMS_write(int value) {
     furi_hal_gpio_write(&flipper_dap_swdio_pin, value);
 }
 
+// SWCLK and SWDIO share GPIOA on both pinouts (see dap_init_gpio()), so the SWD
+// write loop sets the data bit and the falling clock edge with a single BSRR store
+#define DAP_CONFIG_SWDIO_SWCLK_SAME_PORT
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_SWDIO_TMS_write_SWCLK_TCK_clr(int value) {
+    uint32_t swdio = flipper_dap_swdio_pin.pin;
+    flipper_dap_swdio_pin.port->BSRR = ((uint32_t)flipper_dap_swclk_pin.pin << 16) |
+                                       (value ? swdio : (swdio << 16));
+}
+
 //-----------------------------------------------------------------------------
 static inline void DAP_CONFIG_TDI_write(int value) {
 #ifdef DAP_CONFIG_ENABLE_JTAG
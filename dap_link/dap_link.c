@@ -102,23 +102,52 @@ static void dap_app_usb_state_callback(bool state, void* context) {
     }
 }
 
+// Responses to DAP_QueueCommands are held back until a request that is not queued
+// arrives, then all of them are sent in order
+typedef struct {
+    DapPacket packets[DAP_CONFIG_PACKET_COUNT];
+    uint8_t count;
+} DapResponseQueue;
+
+typedef int32_t (*DapTxFunction)(uint8_t* buffer, uint8_t size);
+
+static void dap_app_process_request(
+    DapResponseQueue* queue,
+    DapPacket* rx_packet,
+    bool fixed_size,
+    DapTxFunction tx) {
+    bool queued = dap_request_is_queued(rx_packet->data);
+    DapPacket* tx_packet = &queue->packets[queue->count++];
+
+    if(fixed_size) memset(tx_packet, 0, sizeof(DapPacket));
+    tx_packet->size = dap_process_request(
+        rx_packet->data, rx_packet->size, tx_packet->data, DAP_CONFIG_PACKET_SIZE);
+    if(fixed_size) tx_packet->size = DAP_CONFIG_PACKET_SIZE;
+
+    if(!queued || queue->count == DAP_CONFIG_PACKET_COUNT) {
+        for(uint8_t i = 0; i < queue->count; i++) {
+            tx(queue->packets[i].data, queue->packets[i].size);
+        }
+        queue->count = 0;
+    }
+}
+
 static void dap_app_process_v1() {
-    DapPacket tx_packet;
-    DapPacket rx_packet;
-    memset(&tx_packet, 0, sizeof(DapPacket));
+    // HID reports always have the full size, unused bytes are zero
+    static DapResponseQueue queue;
+    static DapPacket rx_packet;
     rx_packet.size = dap_v1_usb_rx(rx_packet.data, DAP_CONFIG_PACKET_SIZE);
-    dap_process_request(rx_packet.data, rx_packet.size, tx_packet.data, DAP_CONFIG_PACKET_SIZE);
-    dap_v1_usb_tx(tx_packet.data, DAP_CONFIG_PACKET_SIZE);
+    if(rx_packet.size == 0) return;
+    dap_app_process_request(&queue, &rx_packet, true, dap_v1_usb_tx);
 }
 
 static void dap_app_process_v2() {
-    DapPacket tx_packet;
-    DapPacket rx_packet;
-    memset(&tx_packet, 0, sizeof(DapPacket));
+    // bulk responses are sent with their real length, nothing to clear
+    static DapResponseQueue queue;
+    static DapPacket rx_packet;
     rx_packet.size = dap_v2_usb_rx(rx_packet.data, DAP_CONFIG_PACKET_SIZE);
-    size_t len = dap_process_request(
-        rx_packet.data, rx_packet.size, tx_packet.data, DAP_CONFIG_PACKET_SIZE);
-    dap_v2_usb_tx(tx_packet.data, len);
+    if(rx_packet.size == 0) return;
+    dap_app_process_request(&queue, &rx_packet, false, dap_v2_usb_tx);
 }
 
 void dap_app_vendor_cmd(uint8_t cmd) {
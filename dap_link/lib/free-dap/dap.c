@@ -295,6 +295,14 @@ static void dap_delay_us(int delay)
 DAP_SWJ_FN(slow, DAP_CONFIG_DELAY)
 DAP_SWJ_FN(fast, (void))
 
+//-----------------------------------------------------------------------------
+#ifdef DAP_CONFIG_SWDIO_SWCLK_SAME_PORT
+#define DAP_SWD_WRITE_BIT_CLK_LOW(value) DAP_CONFIG_SWDIO_TMS_write_SWCLK_TCK_clr(value)
+#else
+#define DAP_SWD_WRITE_BIT_CLK_LOW(value) \
+  do { DAP_CONFIG_SWDIO_TMS_write(value); DAP_CONFIG_SWCLK_TCK_clr(); } while (0)
+#endif
+
 //-----------------------------------------------------------------------------
 #define DAP_SWD_FN(ver, delay) \
   DAP_CONFIG_PERFORMANCE_ATTR						\
@@ -302,8 +310,7 @@ DAP_SWJ_FN(fast, (void))
   {									\
     for (int i = 0; i < size; i++)					\
     {									\
-      DAP_CONFIG_SWDIO_TMS_write(value & 1);				\
-      DAP_CONFIG_SWCLK_TCK_clr();					\
+      DAP_SWD_WRITE_BIT_CLK_LOW(value & 1);				\
       delay(dap_clock_delay);						\
       DAP_CONFIG_SWCLK_TCK_set();					\
       delay(dap_clock_delay);						\
@@ -343,14 +350,22 @@ static inline uint32_t dap_parity(uint32_t value)
 }
 
 //-----------------------------------------------------------------------------
-static int dap_swd_operation(int req, uint32_t *data)
+static inline int dap_swd_request_header(int req)
+{
+  req &= (DAP_TRANSFER_APnDP | DAP_TRANSFER_RnW | DAP_TRANSFER_A2 | DAP_TRANSFER_A3);
+
+  return 0x81 | (dap_parity(req) << 5) | (req << 1);
+}
+
+//-----------------------------------------------------------------------------
+static int dap_swd_transfer(int header, uint32_t *data)
 {
+  int req = (header >> 1) &
+      (DAP_TRANSFER_APnDP | DAP_TRANSFER_RnW | DAP_TRANSFER_A2 | DAP_TRANSFER_A3);
   uint32_t value;
   int ack = 0;
 
-  req &= (DAP_TRANSFER_APnDP | DAP_TRANSFER_RnW | DAP_TRANSFER_A2 | DAP_TRANSFER_A3);
-
-  dap_swd_write(0x81 | (dap_parity(req) << 5) | (req << 1), 8);
+  dap_swd_write(header, 8);
 
   DAP_CONFIG_SWDIO_TMS_in();
 
@@ -414,6 +429,12 @@ static int dap_swd_operation(int req, uint32_t *data)
   return ack;
 }
 
+//-----------------------------------------------------------------------------
+static int dap_swd_operation(int req, uint32_t *data)
+{
+  return dap_swd_transfer(dap_swd_request_header(req), data);
+}
+
 #ifdef DAP_CONFIG_ENABLE_JTAG
 //-----------------------------------------------------------------------------
 #define DAP_JTAG_FN(ver, delay) \
@@ -798,7 +819,7 @@ static void dap_info(void)
 
   if (DAP_INFO_CAPABILITIES == index)
   {
-    int cap = DAP_CAP_SWD;
+    int cap = DAP_CAP_SWD | DAP_CAP_ATOMIC_CMD;
 #ifdef DAP_CONFIG_ENABLE_JTAG
     cap |= DAP_CAP_JTAG;
 #endif
@@ -1022,6 +1043,59 @@ static void dap_transfer(void)
   dap_resp_set_byte(2, ack);
 }
 
+//-----------------------------------------------------------------------------
+// All transfers of a block use the same request, so on SWD its header is built once
+// and the words are clocked back to back with only the WAIT retries in between
+static int dap_transfer_block_swd(int request, int req_count, int *resp_count)
+{
+  int header = dap_swd_request_header(request);
+  bool read = (request & DAP_TRANSFER_RnW);
+  bool posted = dap_needs_posted_read(request);
+  int ack = DAP_TRANSFER_INVALID;
+  uint32_t data = 0;
+
+  for (int i = 0; i < req_count; i++)
+  {
+    if (!read)
+      data = dap_req_get_word();
+
+    for (int retry = 0; retry < dap_retry_count; retry++)
+    {
+      ack = dap_swd_transfer(header, &data);
+
+      if (DAP_TRANSFER_WAIT != ack || dap_abort)
+        break;
+    }
+
+    if (DAP_TRANSFER_OK != ack)
+      return ack;
+
+    if (read && posted && 0 == i)
+      continue;
+
+    if (read)
+      dap_resp_add_word(data);
+
+    (*resp_count)++;
+  }
+
+  if (!read)
+    return dap_transfer_word(SWD_DP_R_RDBUFF | DAP_TRANSFER_RnW, NULL);
+
+  if (posted)
+  {
+    ack = dap_transfer_word(SWD_DP_R_RDBUFF | DAP_TRANSFER_RnW, &data);
+
+    if (DAP_TRANSFER_OK == ack)
+    {
+      dap_resp_add_word(data);
+      (*resp_count)++;
+    }
+  }
+
+  return ack;
+}
+
 //-----------------------------------------------------------------------------
 static void dap_transfer_block(void)
 {
@@ -1044,7 +1118,11 @@ static void dap_transfer_block(void)
   request = dap_req_get_byte();
   ack = DAP_TRANSFER_INVALID;
 
-  if (request & DAP_TRANSFER_RnW)
+  if (DAP_PORT_SWD == dap_port)
+  {
+    ack = dap_transfer_block_swd(request, req_count, &resp_count);
+  }
+  else if (request & DAP_TRANSFER_RnW)
   {
     bool needs_posted = dap_needs_posted_read(request);
     int transfers = needs_posted ? (req_count + 1) : req_count;
@@ -1409,6 +1487,34 @@ void dap_init(void)
   DAP_CONFIG_SETUP();
 }
 
+//-----------------------------------------------------------------------------
+static bool dap_process_command(int cmd);
+
+//-----------------------------------------------------------------------------
+static void dap_execute_commands(void)
+{
+  int count = dap_req_get_byte();
+
+  // Queued commands are rewritten to executed ones, like the reference firmware does
+  dap_resp_set_byte(0, ID_DAP_EXECUTE_COMMANDS);
+  dap_resp_add_byte(count);
+
+  for (int i = 0; i < count && !dap_buf_error; i++)
+  {
+    int index = dap_resp_ptr;
+    int cmd = dap_req_get_byte();
+
+    dap_resp_add_byte(cmd);
+
+    if (ID_DAP_EXECUTE_COMMANDS == cmd || ID_DAP_QUEUE_COMMANDS == cmd ||
+        !dap_process_command(cmd))
+    {
+      dap_resp_set_byte(index, ID_DAP_INVALID);
+      break;
+    }
+  }
+}
+
 //-----------------------------------------------------------------------------
 bool dap_filter_request(uint8_t *req)
 {
@@ -1424,7 +1530,13 @@ bool dap_filter_request(uint8_t *req)
 }
 
 //-----------------------------------------------------------------------------
-int dap_process_request(uint8_t *req, int req_size, uint8_t *resp, int resp_size)
+bool dap_request_is_queued(uint8_t *req)
+{
+  return ID_DAP_QUEUE_COMMANDS == req[0];
+}
+
+//-----------------------------------------------------------------------------
+static bool dap_process_command(int cmd)
 {
   static const struct
   {
@@ -1451,26 +1563,16 @@ int dap_process_request(uint8_t *req, int req_size, uint8_t *resp, int resp_size
     { ID_DAP_JTAG_SEQUENCE,		dap_jtag_sequence },
     { ID_DAP_JTAG_CONFIGURE,		dap_jtag_configure },
     { ID_DAP_JTAG_IDCODE,		dap_jtag_idcode },
+    { ID_DAP_QUEUE_COMMANDS,		dap_execute_commands },
+    { ID_DAP_EXECUTE_COMMANDS,		dap_execute_commands },
   };
-  int cmd;
-
-  dap_buf_init(req, req_size, resp, resp_size);
-
-  dap_abort = false;
-
-#ifdef DAP_CONFIG_ENABLE_JTAG
-  dap_jtag_ir = JTAG_INVALID;
-#endif
-
-  cmd = dap_req_get_byte();
-  dap_resp_add_byte(cmd);
 
   for (int i = 0; i < ARRAY_SIZE(handlers); i++)
   {
     if (cmd == handlers[i].cmd)
     {
       handlers[i].handler();
-      return dap_resp_ptr;
+      return true;
     }
   }
 
@@ -1481,10 +1583,30 @@ int dap_process_request(uint8_t *req, int req_size, uint8_t *resp, int resp_size
 #else
     dap_resp_add_byte(DAP_ERROR);
 #endif
-    return dap_resp_ptr;
+    return true;
   }
 
-  dap_resp_set_byte(0, ID_DAP_INVALID);
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+int dap_process_request(uint8_t *req, int req_size, uint8_t *resp, int resp_size)
+{
+  int cmd;
+
+  dap_buf_init(req, req_size, resp, resp_size);
+
+  dap_abort = false;
+
+#ifdef DAP_CONFIG_ENABLE_JTAG
+  dap_jtag_ir = JTAG_INVALID;
+#endif
+
+  cmd = dap_req_get_byte();
+  dap_resp_add_byte(cmd);
+
+  if (!dap_process_command(cmd))
+    dap_resp_set_byte(0, ID_DAP_INVALID);
 
   return dap_resp_ptr;
 }
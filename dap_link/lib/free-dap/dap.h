@@ -43,6 +43,7 @@ void dap_resp_add_word(uint32_t value);
 void dap_resp_set_byte(int index, uint8_t value);
 bool dap_is_buf_error(void);
 bool dap_filter_request(uint8_t *req);
+bool dap_request_is_queued(uint8_t *req);
 int dap_process_request(uint8_t *req, int req_size, uint8_t *resp, int resp_size);
 void dap_clock_test(int delay);
 
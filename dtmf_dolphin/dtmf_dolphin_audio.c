@@ -1,4 +1,6 @@
 #include "dtmf_dolphin_audio.h"
+#include "dtmf_dolphin_data.h"
+#include <math.h>
 
 DTMFDolphinAudio* current_player;
 
@@ -26,12 +28,23 @@ void dtmf_dolphin_audio_clear_samples(DTMFDolphinAudio* player) {
     }
 }
 
+// Q15 sine shared by both oscillators, filled once
+static int16_t sine_lut[DTMF_DOLPHIN_SINE_SIZE];
+static bool sine_lut_ready = false;
+
+static void dtmf_dolphin_sine_lut_init() {
+    if(sine_lut_ready) return;
+    for(size_t i = 0; i < DTMF_DOLPHIN_SINE_SIZE; i++) {
+        sine_lut[i] = sinf(i * 2 * (float)M_PI / DTMF_DOLPHIN_SINE_SIZE) * INT16_MAX;
+    }
+    sine_lut_ready = true;
+}
+
 DTMFDolphinOsc* dtmf_dolphin_osc_alloc() {
     DTMFDolphinOsc* osc = malloc(sizeof(DTMFDolphinOsc));
     osc->cached_freq = 0;
-    osc->offset = 0;
-    osc->period = 0;
-    osc->lookup_table = NULL;
+    osc->phase = 0;
+    osc->phase_inc = 0;
     return osc;
 }
 
@@ -39,8 +52,9 @@ DTMFDolphinPulseFilter* dtmf_dolphin_pulse_filter_alloc() {
     DTMFDolphinPulseFilter* pf = malloc(sizeof(DTMFDolphinPulseFilter));
     pf->duration = 0;
     pf->period = 0;
+    pf->pulse_period = 0;
     pf->offset = 0;
-    pf->lookup_table = NULL;
+    pf->position = 0;
     return pf;
 }
 
@@ -54,87 +68,51 @@ DTMFDolphinAudio* dtmf_dolphin_audio_alloc() {
     player->volume = 1.0f;
     player->queue = furi_message_queue_alloc(10, sizeof(DTMFDolphinCustomEvent));
     player->filter = dtmf_dolphin_pulse_filter_alloc();
+    player->sequence = NULL;
     player->playing = false;
     dtmf_dolphin_audio_clear_samples(player);
+    dtmf_dolphin_sine_lut_init();
 
     return player;
 }
 
-size_t calc_waveform_period(float freq) {
-    if(!freq) {
-        return 0;
-    }
-    // DMA Rate calculation, thanks to Dr_Zlo
-    float dma_rate = CPU_CLOCK_FREQ / 2 / DTMF_DOLPHIN_HAL_DMA_PRESCALER /
-                     (DTMF_DOLPHIN_HAL_DMA_AUTORELOAD + 1);
-
-    // Using a constant scaling modifier, which likely represents
-    // the combined system overhead and isr latency.
-    return (uint16_t)dma_rate * 2 / freq * 0.801923;
+static uint32_t ms_to_samples(uint16_t ms) {
+    return (uint32_t)ms * DTMF_DOLPHIN_SAMPLE_RATE / 1000;
 }
 
-void osc_generate_lookup_table(DTMFDolphinOsc* osc, float freq) {
-    if(osc->lookup_table != NULL) {
-        free(osc->lookup_table);
-    }
-    osc->offset = 0;
+void osc_set_freq(DTMFDolphinOsc* osc, float freq) {
+    osc->phase = 0;
     osc->cached_freq = freq;
-    osc->period = calc_waveform_period(freq);
-    if(!osc->period) {
-        osc->lookup_table = NULL;
-        return;
-    }
-    osc->lookup_table = malloc(sizeof(float) * osc->period);
-
-    for(size_t i = 0; i < osc->period; i++) {
-        osc->lookup_table[i] = sin(i * PERIOD_2_PI / osc->period) + 1;
-    }
+    // phase step per sample, 2^32 is one full turn
+    osc->phase_inc = freq > 0 ? (uint32_t)(freq * 4294967296.0f / DTMF_DOLPHIN_SAMPLE_RATE) : 0;
 }
 
-void filter_generate_lookup_table(
+void filter_set_pulses(
     DTMFDolphinPulseFilter* pf,
     uint16_t pulses,
     uint16_t pulse_ms,
     uint16_t gap_ms) {
-    if(pf->lookup_table != NULL) {
-        free(pf->lookup_table);
-    }
     pf->offset = 0;
-
-    uint16_t gap_period = calc_waveform_period(1000 / (float)gap_ms);
-    uint16_t pulse_period = calc_waveform_period(1000 / (float)pulse_ms);
-    pf->period = pulse_period + gap_period;
-
-    if(!pf->period) {
-        pf->lookup_table = NULL;
-        return;
-    }
+    pf->position = 0;
+    pf->pulse_period = ms_to_samples(pulse_ms);
+    pf->period = pf->pulse_period + ms_to_samples(gap_ms);
     pf->duration = pf->period * pulses;
-    pf->lookup_table = malloc(sizeof(bool) * pf->duration);
-
-    for(size_t i = 0; i < pf->duration; i++) {
-        pf->lookup_table[i] = i % pf->period < pulse_period;
-    }
 }
 
-float sample_frame(DTMFDolphinOsc* osc) {
-    float frame = 0.0;
-
-    if(osc->period) {
-        frame = osc->lookup_table[osc->offset];
-        osc->offset = (osc->offset + 1) % osc->period;
-    }
-
+static inline int32_t sample_frame(DTMFDolphinOsc* osc) {
+    int32_t frame = sine_lut[osc->phase >> (32 - DTMF_DOLPHIN_SINE_BITS)];
+    osc->phase += osc->phase_inc;
     return frame;
 }
 
-bool sample_filter(DTMFDolphinPulseFilter* pf) {
+static inline bool sample_filter(DTMFDolphinPulseFilter* pf) {
     bool frame = true;
 
     if(pf->duration) {
         if(pf->offset < pf->duration) {
-            frame = pf->lookup_table[pf->offset];
-            pf->offset = pf->offset + 1;
+            frame = pf->position < pf->pulse_period;
+            pf->offset++;
+            if(++pf->position == pf->period) pf->position = 0;
         } else {
             frame = false;
         }
@@ -144,16 +122,10 @@ bool sample_filter(DTMFDolphinPulseFilter* pf) {
 }
 
 void dtmf_dolphin_osc_free(DTMFDolphinOsc* osc) {
-    if(osc->lookup_table != NULL) {
-        free(osc->lookup_table);
-    }
     free(osc);
 }
 
 void dtmf_dolphin_filter_free(DTMFDolphinPulseFilter* pf) {
-    if(pf->lookup_table != NULL) {
-        free(pf->lookup_table);
-    }
     free(pf);
 }
 
@@ -162,39 +134,118 @@ void dtmf_dolphin_audio_free(DTMFDolphinAudio* player) {
     dtmf_dolphin_osc_free(player->osc1);
     dtmf_dolphin_osc_free(player->osc2);
     dtmf_dolphin_filter_free(player->filter);
+    if(player->sequence != NULL) {
+        free(player->sequence);
+    }
     free(player->sample_buffer);
     free(player);
     current_player = NULL;
 }
 
-bool generate_waveform(DTMFDolphinAudio* player, uint16_t buffer_index) {
-    uint16_t* sample_buffer_start = &player->sample_buffer[buffer_index];
+// Centred oscillator mix, -32767..32767
+static inline int32_t mix_frame(DTMFDolphinAudio* player) {
+    if(player->osc2->phase_inc) {
+        return (sample_frame(player->osc1) + sample_frame(player->osc2)) >> 1;
+    } else if(player->osc1->phase_inc) {
+        return sample_frame(player->osc1);
+    }
+    return 0;
+}
 
-    for(size_t i = 0; i < player->half_buffer_length; i++) {
-        float data = 0;
-        if(player->osc2->period) {
-            data = (sample_frame(player->osc1) / 2) + (sample_frame(player->osc2) / 2);
-        } else {
-            data = (sample_frame(player->osc1));
-        }
-        data *= sample_filter(player->filter) ? player->volume : 0.0;
-        data *= UINT8_MAX / 2; // scale -128..127
-        data += UINT8_MAX / 2; // to unsigned
+static inline uint16_t to_pwm(int32_t data, int32_t gain) {
+    data = ((data * gain) >> 15) + UINT8_MAX / 2; // to unsigned
+
+    if(data < 0) {
+        data = 0;
+    }
+
+    if(data > 255) {
+        data = 255;
+    }
 
-        if(data < 0) {
-            data = 0;
+    return data;
+}
+
+static void generate_sequence(DTMFDolphinAudio* player, uint16_t* buffer, int32_t gain) {
+    DTMFDolphinSequence* sequence = player->sequence;
+    size_t done = 0;
+
+    if(sequence->position == sequence->length && !sequence->mark && sequence->left == 0) {
+        sequence->silent_halves++;
+    }
+
+    while(done < player->half_buffer_length) {
+        if(sequence->left == 0) {
+            if(sequence->mark) {
+                sequence->mark = false;
+                sequence->left = sequence->space_samples;
+            } else if(sequence->position < sequence->length) {
+                DTMFDolphinSequenceTone* tone = &sequence->tones[sequence->position++];
+                osc_set_freq(player->osc1, tone->freq1);
+                osc_set_freq(player->osc2, tone->freq2);
+                sequence->mark = true;
+                sequence->left = sequence->mark_samples;
+            } else {
+                for(; done < player->half_buffer_length; done++) {
+                    buffer[done] = UINT8_MAX / 2;
+                }
+            }
+            continue;
         }
 
-        if(data > 255) {
-            data = 255;
+        size_t count = MIN(sequence->left, player->half_buffer_length - done);
+        if(sequence->mark) {
+            for(size_t i = 0; i < count; i++) {
+                buffer[done + i] = to_pwm(mix_frame(player), gain);
+            }
+        } else {
+            for(size_t i = 0; i < count; i++) {
+                buffer[done + i] = UINT8_MAX / 2;
+            }
         }
+        sequence->left -= count;
+        done += count;
+    }
+}
 
-        sample_buffer_start[i] = data;
+bool generate_waveform(DTMFDolphinAudio* player, uint16_t buffer_index) {
+    uint16_t* sample_buffer_start = &player->sample_buffer[buffer_index];
+    // Q15 sample to -127..127 at full volume
+    const int32_t gain = player->volume * (UINT8_MAX / 2);
+
+    if(player->sequence != NULL) {
+        generate_sequence(player, sample_buffer_start, gain);
+        return true;
+    }
+
+    for(size_t i = 0; i < player->half_buffer_length; i++) {
+        int32_t data = mix_frame(player);
+        sample_buffer_start[i] = to_pwm(sample_filter(player->filter) ? data : 0, gain);
     }
 
     return true;
 }
 
+static bool dtmf_dolphin_audio_start(DTMFDolphinAudio* player) {
+    generate_waveform(player, 0);
+    generate_waveform(player, player->half_buffer_length);
+
+    dtmf_dolphin_dma_init((uint32_t)player->sample_buffer, player->buffer_length);
+
+    furi_hal_interrupt_set_isr(
+        FuriHalInterruptIdDma1Ch1, dtmf_dolphin_audio_dma_isr, player->queue);
+    if(furi_hal_speaker_acquire(1000)) {
+        dtmf_dolphin_speaker_init();
+        dtmf_dolphin_dma_start();
+        dtmf_dolphin_speaker_start();
+        player->playing = true;
+        return true;
+    } else {
+        player->playing = false;
+        return false;
+    }
+}
+
 bool dtmf_dolphin_audio_play_tones(
     float freq1,
     float freq2,
@@ -207,27 +258,53 @@ bool dtmf_dolphin_audio_play_tones(
     }
     current_player = dtmf_dolphin_audio_alloc();
 
-    osc_generate_lookup_table(current_player->osc1, freq1);
-    osc_generate_lookup_table(current_player->osc2, freq2);
-    filter_generate_lookup_table(current_player->filter, pulses, pulse_ms, gap_ms);
+    osc_set_freq(current_player->osc1, freq1);
+    osc_set_freq(current_player->osc2, freq2);
+    filter_set_pulses(current_player->filter, pulses, pulse_ms, gap_ms);
 
-    generate_waveform(current_player, 0);
-    generate_waveform(current_player, current_player->half_buffer_length);
+    return dtmf_dolphin_audio_start(current_player);
+}
 
-    dtmf_dolphin_dma_init((uint32_t)current_player->sample_buffer, current_player->buffer_length);
+bool dtmf_dolphin_audio_play_sequence(const char* digits, uint16_t mark_ms, uint16_t space_ms) {
+    if(current_player != NULL && current_player->playing) {
+        // Cannot start playing while still playing something else
+        return false;
+    }
 
-    furi_hal_interrupt_set_isr(
-        FuriHalInterruptIdDma1Ch1, dtmf_dolphin_audio_dma_isr, current_player->queue);
-    if(furi_hal_speaker_acquire(1000)) {
-        dtmf_dolphin_speaker_init();
-        dtmf_dolphin_dma_start();
-        dtmf_dolphin_speaker_start();
-        current_player->playing = true;
-        return true;
-    } else {
-        current_player->playing = false;
+    DTMFDolphinSequence* sequence = malloc(sizeof(DTMFDolphinSequence));
+    sequence->length = 0;
+    for(const char* digit = digits; *digit && sequence->length < DTMF_DOLPHIN_SEQUENCE_MAX;
+        digit++) {
+        DTMFDolphinSequenceTone* tone = &sequence->tones[sequence->length];
+        if(dtmf_dolphin_data_get_digit_frequencies(&tone->freq1, &tone->freq2, *digit)) {
+            sequence->length++;
+        }
+    }
+
+    if(sequence->length == 0) {
+        free(sequence);
         return false;
     }
+
+    sequence->position = 0;
+    sequence->mark_samples = ms_to_samples(mark_ms);
+    sequence->space_samples = ms_to_samples(space_ms);
+    sequence->left = 0;
+    sequence->mark = false;
+    sequence->silent_halves = 0;
+
+    current_player = dtmf_dolphin_audio_alloc();
+    current_player->sequence = sequence;
+
+    return dtmf_dolphin_audio_start(current_player);
+}
+
+bool dtmf_dolphin_audio_sequence_done() {
+    if(current_player == NULL || current_player->sequence == NULL) {
+        return true;
+    }
+    // the last tone has left the DMA buffer once both halves were refilled with silence
+    return current_player->sequence->silent_halves >= 2;
 }
 
 bool dtmf_dolphin_audio_stop_tones() {
@@ -4,23 +4,51 @@
 #include "dtmf_dolphin_hal.h"
 
 #define SAMPLE_BUFFER_LENGTH 8192
-#define PERIOD_2_PI 6.2832
 #define CPU_CLOCK_FREQ 64000000
+// TIM16 update rate, one sample per PWM period
+#define DTMF_DOLPHIN_SAMPLE_RATE \
+    (CPU_CLOCK_FREQ / (DTMF_DOLPHIN_HAL_DMA_PRESCALER + 1) / (DTMF_DOLPHIN_HAL_DMA_AUTORELOAD + 1))
+
+#define DTMF_DOLPHIN_SINE_BITS 8
+#define DTMF_DOLPHIN_SINE_SIZE (1 << DTMF_DOLPHIN_SINE_BITS)
 
 typedef struct {
     float cached_freq;
-    size_t period;
-    float* lookup_table;
-    uint16_t offset;
+    // 32-bit phase, the top DTMF_DOLPHIN_SINE_BITS index the sine table
+    uint32_t phase;
+    uint32_t phase_inc;
 } DTMFDolphinOsc;
 
 typedef struct {
-    float duration;
-    size_t period;
-    bool* lookup_table;
-    uint16_t offset;
+    // total length in samples, 0 plays the tone until stopped
+    uint32_t duration;
+    uint32_t period;
+    uint32_t pulse_period;
+    uint32_t offset;
+    uint32_t position;
 } DTMFDolphinPulseFilter;
 
+// Longest digit string a dial sequence takes
+#define DTMF_DOLPHIN_SEQUENCE_MAX 32
+
+typedef struct {
+    float freq1;
+    float freq2;
+} DTMFDolphinSequenceTone;
+
+typedef struct {
+    DTMFDolphinSequenceTone tones[DTMF_DOLPHIN_SEQUENCE_MAX];
+    size_t length;
+    size_t position;
+    uint32_t mark_samples;
+    uint32_t space_samples;
+    // samples left of the current mark or space
+    uint32_t left;
+    bool mark;
+    // whole half buffers of silence rendered after the last space
+    uint8_t silent_halves;
+} DTMFDolphinSequence;
+
 typedef struct {
     size_t buffer_length;
     size_t half_buffer_length;
@@ -31,6 +59,7 @@ typedef struct {
     DTMFDolphinOsc* osc1;
     DTMFDolphinOsc* osc2;
     DTMFDolphinPulseFilter* filter;
+    DTMFDolphinSequence* sequence;
     bool playing;
 } DTMFDolphinAudio;
 
@@ -49,6 +78,13 @@ bool dtmf_dolphin_audio_play_tones(
     uint16_t pulse_ms,
     uint16_t gap_ms);
 
+// Play digits (tone names of the current section) back to back, mark_ms of
+// tone and space_ms of silence each, in one continuous DMA stream.
+// Keep calling dtmf_dolphin_audio_handle_tick() until the sequence is done.
+bool dtmf_dolphin_audio_play_sequence(const char* digits, uint16_t mark_ms, uint16_t space_ms);
+
+bool dtmf_dolphin_audio_sequence_done();
+
 bool dtmf_dolphin_audio_stop_tones();
 
 bool dtmf_dolphin_audio_handle_tick();
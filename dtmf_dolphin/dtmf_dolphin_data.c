@@ -154,6 +154,18 @@ bool dtmf_dolphin_data_get_tone_frequencies(float* freq1, float* freq2, uint8_t
     return false;
 }
 
+bool dtmf_dolphin_data_get_digit_frequencies(float* freq1, float* freq2, char digit) {
+    for(size_t i = 0; i < current_scene_data->tone_count; i++) {
+        DTMFDolphinTones tones = current_scene_data->tones[i];
+        if(tones.name[0] == digit && tones.name[1] == '\0') {
+            freq1[0] = tones.frequency_1;
+            freq2[0] = tones.frequency_2;
+            return true;
+        }
+    }
+    return false;
+}
+
 bool dtmf_dolphin_data_get_filter_data(
     uint16_t* pulses,
     uint16_t* pulse_ms,
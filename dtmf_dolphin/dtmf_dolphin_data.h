@@ -20,6 +20,9 @@ DTMFDolphinToneSection dtmf_dolphin_data_get_current_section();
 
 bool dtmf_dolphin_data_get_tone_frequencies(float* freq1, float* freq2, uint8_t row, uint8_t col);
 
+// Frequencies of the current section tone named by the single character digit
+bool dtmf_dolphin_data_get_digit_frequencies(float* freq1, float* freq2, char digit);
+
 bool dtmf_dolphin_data_get_filter_data(
     uint16_t* pulses,
     uint16_t* pulse_ms,
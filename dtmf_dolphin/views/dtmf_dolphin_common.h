@@ -8,3 +8,9 @@
 #define DTMF_DOLPHIN_BUTTON_WIDTH 13
 #define DTMF_DOLPHIN_BUTTON_HEIGHT 13
 #define DTMF_DOLPHIN_BUTTON_PADDING 1 // all sides
+
+// Redial timing, about the fastest rate exchanges still decode
+#define DTMF_DOLPHIN_DIAL_MARK_MS 40
+#define DTMF_DOLPHIN_DIAL_SPACE_MS 40
+// Digits of the redial buffer shown in the detail pane
+#define DTMF_DOLPHIN_DIAL_SHOWN 8
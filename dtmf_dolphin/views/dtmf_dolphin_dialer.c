@@ -18,6 +18,9 @@ typedef struct {
     uint16_t pulses;
     uint16_t pulse_ms;
     uint16_t gap_ms;
+    // single character tones played so far, Long Up dials them again
+    char dialed[DTMF_DOLPHIN_SEQUENCE_MAX + 1];
+    bool dialing;
 } DTMFDolphinDialerModel;
 
 static bool dtmf_dolphin_dialer_process_up(DTMFDolphinDialer* dtmf_dolphin_dialer);
@@ -26,6 +29,8 @@ static bool dtmf_dolphin_dialer_process_left(DTMFDolphinDialer* dtmf_dolphin_dia
 static bool dtmf_dolphin_dialer_process_right(DTMFDolphinDialer* dtmf_dolphin_dialer);
 static bool
     dtmf_dolphin_dialer_process_ok(DTMFDolphinDialer* dtmf_dolphin_dialer, InputEvent* event);
+static bool dtmf_dolphin_dialer_redial(DTMFDolphinDialer* dtmf_dolphin_dialer);
+static bool dtmf_dolphin_dialer_clear(DTMFDolphinDialer* dtmf_dolphin_dialer);
 
 void draw_button(Canvas* canvas, uint8_t row, uint8_t col, bool invert) {
     uint8_t left = DTMF_DOLPHIN_NUMPAD_X + // ((col + 1) * DTMF_DOLPHIN_BUTTON_PADDING) +
@@ -102,6 +107,18 @@ void update_frequencies(DTMFDolphinDialerModel* model) {
 
 static void dtmf_dolphin_dialer_draw_callback(Canvas* canvas, void* _model) {
     DTMFDolphinDialerModel* model = _model;
+    if(model->dialing) {
+        // The redial loop refills the DMA buffer itself
+        canvas_set_font(canvas, FontPrimary);
+        elements_multiline_text_aligned(
+            canvas,
+            canvas_width(canvas) / 2,
+            canvas_height(canvas) / 2,
+            AlignCenter,
+            AlignCenter,
+            "Dialing");
+        return;
+    }
     if(model->playing) {
         // Leverage the prioritized draw callback to handle
         // the DMA so that it doesn't skip.
@@ -158,6 +175,13 @@ static void dtmf_dolphin_dialer_draw_callback(Canvas* canvas, void* _model) {
     if(model->gap_ms) {
         furi_string_cat_printf(output, "Gaps: %u ms\n", model->gap_ms);
     }
+    size_t dialed = strlen(model->dialed);
+    if(dialed) {
+        furi_string_cat_printf(
+            output,
+            "Redial: %s\n",
+            &model->dialed[dialed - MIN(dialed, (size_t)DTMF_DOLPHIN_DIAL_SHOWN)]);
+    }
     elements_multiline_text(
         canvas, (max_span * DTMF_DOLPHIN_BUTTON_WIDTH) + 4, 21, furi_string_get_cstr(output));
 
@@ -180,6 +204,10 @@ static bool dtmf_dolphin_dialer_input_callback(InputEvent* event, void* context)
             consumed = dtmf_dolphin_dialer_process_down(dtmf_dolphin_dialer);
         }
 
+    } else if(event->type == InputTypeLong && event->key == InputKeyUp) {
+        consumed = dtmf_dolphin_dialer_redial(dtmf_dolphin_dialer);
+    } else if(event->type == InputTypeLong && event->key == InputKeyDown) {
+        consumed = dtmf_dolphin_dialer_clear(dtmf_dolphin_dialer);
     } else if(event->key == InputKeyOk) {
         consumed = dtmf_dolphin_dialer_process_ok(dtmf_dolphin_dialer, event);
     }
@@ -284,6 +312,14 @@ static bool
             if(event->type == InputTypePress) {
                 model->playing = dtmf_dolphin_audio_play_tones(
                     model->freq1, model->freq2, model->pulses, model->pulse_ms, model->gap_ms);
+
+                const char* name = dtmf_dolphin_data_get_tone_name(model->row, model->col);
+                size_t dialed = strlen(model->dialed);
+                if(model->playing && name && name[0] && !name[1] &&
+                   dialed < DTMF_DOLPHIN_SEQUENCE_MAX) {
+                    model->dialed[dialed] = name[0];
+                    model->dialed[dialed + 1] = '\0';
+                }
             } else if(event->type == InputTypeRelease) {
                 model->playing = !dtmf_dolphin_audio_stop_tones();
             }
@@ -293,6 +329,49 @@ static bool
     return consumed;
 }
 
+static bool dtmf_dolphin_dialer_redial(DTMFDolphinDialer* dtmf_dolphin_dialer) {
+    char digits[DTMF_DOLPHIN_SEQUENCE_MAX + 1];
+    bool dial = false;
+
+    with_view_model(
+        dtmf_dolphin_dialer->view,
+        DTMFDolphinDialerModel * model,
+        {
+            if(!model->playing && model->dialed[0]) {
+                strcpy(digits, model->dialed);
+                model->dialing = true;
+                dial = true;
+            }
+        },
+        true);
+
+    if(!dial) return true;
+
+    // One DMA stream for the whole string, keep it fed until the last tone is out
+    if(dtmf_dolphin_audio_play_sequence(
+           digits, DTMF_DOLPHIN_DIAL_MARK_MS, DTMF_DOLPHIN_DIAL_SPACE_MS)) {
+        while(!dtmf_dolphin_audio_sequence_done() && dtmf_dolphin_audio_handle_tick()) {
+        }
+        dtmf_dolphin_audio_stop_tones();
+    }
+
+    with_view_model(
+        dtmf_dolphin_dialer->view,
+        DTMFDolphinDialerModel * model,
+        { model->dialing = false; },
+        true);
+    return true;
+}
+
+static bool dtmf_dolphin_dialer_clear(DTMFDolphinDialer* dtmf_dolphin_dialer) {
+    with_view_model(
+        dtmf_dolphin_dialer->view,
+        DTMFDolphinDialerModel * model,
+        { model->dialed[0] = '\0'; },
+        true);
+    return true;
+}
+
 static void dtmf_dolphin_dialer_enter_callback(void* context) {
     furi_assert(context);
     DTMFDolphinDialer* dtmf_dolphin_dialer = context;
@@ -307,6 +386,8 @@ static void dtmf_dolphin_dialer_enter_callback(void* context) {
             model->freq1 = 0.0;
             model->freq2 = 0.0;
             model->playing = false;
+            model->dialed[0] = '\0';
+            model->dialing = false;
         },
         true);
 }
@@ -328,6 +409,8 @@ DTMFDolphinDialer* dtmf_dolphin_dialer_alloc() {
             model->freq1 = 0.0;
             model->freq2 = 0.0;
             model->playing = false;
+            model->dialed[0] = '\0';
+            model->dialing = false;
         },
         true);
 
@@ -0,0 +1,188 @@
+#include "esp_flasher_deflate.h"
+
+#include <furi.h>
+
+#define DEFLATE_HASH_BITS (12)
+#define DEFLATE_HASH_SIZE (1 << DEFLATE_HASH_BITS)
+#define DEFLATE_MIN_MATCH (3)
+#define DEFLATE_MAX_MATCH (258)
+#define DEFLATE_MAX_CHAIN (16)
+#define DEFLATE_NO_POS (0xFFFF)
+
+struct EspFlasherDeflate {
+    uint32_t bit_buf;
+    uint8_t bit_count;
+    bool header_done;
+    uint32_t adler_a;
+    uint32_t adler_b;
+
+    // positions in the current block, chained by hash of the next 3 bytes
+    uint16_t head[DEFLATE_HASH_SIZE];
+    uint16_t prev[ESP_FLASHER_DEFLATE_BLOCK_SIZE];
+
+    uint8_t* out;
+};
+
+static const uint16_t length_base[29] = {3,  4,  5,  6,  7,  8,  9,  10,  11,  13,
+                                         15, 17, 19, 23, 27, 31, 35, 43,  51,  59,
+                                         67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const uint8_t length_extra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                         2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t dist_base[30] = {1,    2,    3,    4,    5,    7,     9,     13,
+                                       17,   25,   33,   49,   65,   97,    129,   193,
+                                       257,  385,  513,  769,  1025, 1537,  2049,  3073,
+                                       4097, 6145, 8193, 12289, 16385, 24577};
+static const uint8_t dist_extra[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                       6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+static void deflate_put_bits(EspFlasherDeflate* deflate, uint32_t value, uint8_t count) {
+    deflate->bit_buf |= value << deflate->bit_count;
+    deflate->bit_count += count;
+    while(deflate->bit_count >= 8) {
+        *deflate->out++ = deflate->bit_buf & 0xFF;
+        deflate->bit_buf >>= 8;
+        deflate->bit_count -= 8;
+    }
+}
+
+// Huffman codes are sent most significant bit first
+static void deflate_put_code(EspFlasherDeflate* deflate, uint32_t code, uint8_t count) {
+    uint32_t reversed = 0;
+    for(uint8_t i = 0; i < count; i++) {
+        reversed = (reversed << 1) | (code & 1);
+        code >>= 1;
+    }
+    deflate_put_bits(deflate, reversed, count);
+}
+
+static void deflate_put_symbol(EspFlasherDeflate* deflate, uint16_t symbol) {
+    if(symbol < 144) {
+        deflate_put_code(deflate, 0x30 + symbol, 8);
+    } else if(symbol < 256) {
+        deflate_put_code(deflate, 0x190 + symbol - 144, 9);
+    } else if(symbol < 280) {
+        deflate_put_code(deflate, symbol - 256, 7);
+    } else {
+        deflate_put_code(deflate, 0xC0 + symbol - 280, 8);
+    }
+}
+
+static void deflate_put_match(EspFlasherDeflate* deflate, uint16_t length, uint16_t dist) {
+    uint8_t code = 28;
+    while(length_base[code] > length) code--;
+    deflate_put_symbol(deflate, 257 + code);
+    deflate_put_bits(deflate, length - length_base[code], length_extra[code]);
+
+    code = 29;
+    while(dist_base[code] > dist) code--;
+    deflate_put_code(deflate, code, 5);
+    deflate_put_bits(deflate, dist - dist_base[code], dist_extra[code]);
+}
+
+static uint16_t deflate_hash(const uint8_t* data) {
+    uint32_t value = data[0] << 16 | data[1] << 8 | data[2];
+    return (uint32_t)(value * 2654435761U) >> (32 - DEFLATE_HASH_BITS);
+}
+
+static void deflate_insert(EspFlasherDeflate* deflate, const uint8_t* in, size_t pos) {
+    uint16_t hash = deflate_hash(in + pos);
+    deflate->prev[pos] = deflate->head[hash];
+    deflate->head[hash] = pos;
+}
+
+static void deflate_adler(EspFlasherDeflate* deflate, const uint8_t* in, size_t in_size) {
+    // sums stay below 2^32 for at least 5552 bytes between reductions
+    while(in_size) {
+        size_t chunk = MIN(in_size, 5552U);
+        in_size -= chunk;
+        while(chunk--) {
+            deflate->adler_a += *in++;
+            deflate->adler_b += deflate->adler_a;
+        }
+        deflate->adler_a %= 65521;
+        deflate->adler_b %= 65521;
+    }
+}
+
+EspFlasherDeflate* esp_flasher_deflate_alloc(void) {
+    EspFlasherDeflate* deflate = malloc(sizeof(EspFlasherDeflate));
+    esp_flasher_deflate_reset(deflate);
+    return deflate;
+}
+
+void esp_flasher_deflate_free(EspFlasherDeflate* deflate) {
+    free(deflate);
+}
+
+void esp_flasher_deflate_reset(EspFlasherDeflate* deflate) {
+    deflate->bit_buf = 0;
+    deflate->bit_count = 0;
+    deflate->header_done = false;
+    deflate->adler_a = 1;
+    deflate->adler_b = 0;
+}
+
+size_t esp_flasher_deflate_block(
+    EspFlasherDeflate* deflate,
+    const uint8_t* in,
+    size_t in_size,
+    bool final,
+    uint8_t* out) {
+    furi_assert(in_size <= ESP_FLASHER_DEFLATE_BLOCK_SIZE);
+    deflate->out = out;
+    if(!deflate->header_done) {
+        // 32 KB window, no preset dictionary, header checksum is a multiple of 31
+        *deflate->out++ = 0x78;
+        *deflate->out++ = 0x01;
+        deflate->header_done = true;
+    }
+
+    deflate_put_bits(deflate, final ? 1 : 0, 1);
+    deflate_put_bits(deflate, 1, 2); // fixed Huffman codes
+
+    memset(deflate->head, 0xFF, sizeof(deflate->head));
+    size_t pos = 0;
+    while(pos < in_size) {
+        uint16_t best_length = 0;
+        uint16_t best_dist = 0;
+        if(in_size - pos >= DEFLATE_MIN_MATCH) {
+            size_t max_length = MIN(in_size - pos, (size_t)DEFLATE_MAX_MATCH);
+            uint16_t candidate = deflate->head[deflate_hash(in + pos)];
+            for(uint8_t chain = 0; chain < DEFLATE_MAX_CHAIN && candidate != DEFLATE_NO_POS;
+                chain++) {
+                uint16_t length = 0;
+                while(length < max_length && in[candidate + length] == in[pos + length]) length++;
+                if(length > best_length) {
+                    best_length = length;
+                    best_dist = pos - candidate;
+                    if(length == max_length) break;
+                }
+                candidate = deflate->prev[candidate];
+            }
+            deflate_insert(deflate, in, pos);
+        }
+
+        if(best_length >= DEFLATE_MIN_MATCH) {
+            deflate_put_match(deflate, best_length, best_dist);
+            for(size_t i = 1; i < best_length; i++) {
+                if(in_size - (pos + i) >= DEFLATE_MIN_MATCH) deflate_insert(deflate, in, pos + i);
+            }
+            pos += best_length;
+        } else {
+            deflate_put_symbol(deflate, in[pos]);
+            pos++;
+        }
+    }
+    deflate_put_symbol(deflate, 256); // end of block
+
+    deflate_adler(deflate, in, in_size);
+    if(final) {
+        if(deflate->bit_count) deflate_put_bits(deflate, 0, 8 - deflate->bit_count);
+        uint32_t adler = deflate->adler_b << 16 | deflate->adler_a;
+        *deflate->out++ = adler >> 24;
+        *deflate->out++ = adler >> 16;
+        *deflate->out++ = adler >> 8;
+        *deflate->out++ = adler & 0xFF;
+    }
+    return deflate->out - out;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Input is compressed in blocks of at most this size, matches never cross a block
+#define ESP_FLASHER_DEFLATE_BLOCK_SIZE (4096)
+// Worst case output of esp_flasher_deflate_block() for in_size bytes of input
+#define ESP_FLASHER_DEFLATE_BOUND(in_size) (((in_size) * 9 + 7) / 8 + 16)
+
+typedef struct EspFlasherDeflate EspFlasherDeflate;
+
+// Small zlib compressor (fixed Huffman codes) for FLASH_DEFL_DATA
+EspFlasherDeflate* esp_flasher_deflate_alloc(void);
+void esp_flasher_deflate_free(EspFlasherDeflate* deflate);
+
+// Starts a new zlib stream
+void esp_flasher_deflate_reset(EspFlasherDeflate* deflate);
+
+// Compresses the next block of the stream into out, returns the number of bytes written.
+// The last block must be passed with final set, it also writes the zlib trailer.
+size_t esp_flasher_deflate_block(
+    EspFlasherDeflate* deflate,
+    const uint8_t* in,
+    size_t in_size,
+    bool final,
+    uint8_t* out);
@@ -5,7 +5,6 @@
 
 #define UART_CH \
     (xtreme_settings.uart_esp_channel == UARTDefault ? FuriHalUartIdUSART1 : FuriHalUartIdLPUART1)
-#define BAUDRATE (115200)
 
 struct EspFlasherUart {
     EspFlasherApp* app;
@@ -65,6 +64,10 @@ void esp_flasher_uart_tx(uint8_t* data, size_t len) {
     furi_hal_uart_tx(UART_CH, data, len);
 }
 
+void esp_flasher_uart_set_br(uint32_t baudrate) {
+    furi_hal_uart_set_br(UART_CH, baudrate);
+}
+
 EspFlasherUart*
     esp_flasher_uart_init(EspFlasherApp* app, FuriHalUartId channel, const char* thread_name) {
     EspFlasherUart* uart = malloc(sizeof(EspFlasherUart));
@@ -81,9 +84,9 @@ EspFlasherUart*
     if(channel == FuriHalUartIdUSART1) {
         furi_hal_console_disable();
     } else if(channel == FuriHalUartIdLPUART1) {
-        furi_hal_uart_init(channel, BAUDRATE);
+        furi_hal_uart_init(channel, ESP_FLASHER_UART_BAUDRATE);
     }
-    furi_hal_uart_set_br(channel, BAUDRATE);
+    furi_hal_uart_set_br(channel, ESP_FLASHER_UART_BAUDRATE);
     furi_hal_uart_set_irq_cb(channel, esp_flasher_uart_on_irq_cb, uart);
 
     return uart;
@@ -1,4 +1,7 @@
 #include "esp_flasher_worker.h"
+#include "esp_flasher_deflate.h"
+
+#include <lib/toolbox/md5.h>
 
 FuriStreamBuffer* flash_rx_stream; // TODO make safe
 EspFlasherApp* global_app; // TODO make safe
@@ -12,29 +15,21 @@ static void _timer_callback(void* context) {
     }
 }
 
-static esp_loader_error_t _flash_file(EspFlasherApp* app, char* filepath, uint32_t addr) {
-    // TODO cleanup
-    esp_loader_error_t err;
-    static uint8_t payload[1024];
-    File* bin_file = storage_file_alloc(app->storage);
+// ROM loader FLASH_WRITE_SIZE, also the size of each compressed packet
+#define FLASH_BLOCK_SIZE (1024)
+// Rate used while flashing, the ROM loader answers at 115200 until it is changed
+#define FLASH_BAUDRATE (921600)
+// Readable on every chip, used to check the link after changing the rate
+#define ESP_CHIP_DETECT_MAGIC_REG (0x40001000)
 
+static esp_loader_error_t _flash_file_raw(File* bin_file, uint64_t size, uint32_t addr) {
+    esp_loader_error_t err;
+    static uint8_t payload[FLASH_BLOCK_SIZE];
     char user_msg[256];
 
-    // open file
-    if(!storage_file_open(bin_file, filepath, FSAM_READ, FSOM_OPEN_EXISTING)) {
-        storage_file_close(bin_file);
-        storage_file_free(bin_file);
-        dialog_message_show_storage_error(app->dialogs, "Cannot open file");
-        return ESP_LOADER_ERROR_FAIL;
-    }
-
-    uint64_t size = storage_file_size(bin_file);
-
     loader_port_debug_print("Erasing flash...this may take a while\n");
     err = esp_loader_flash_start(addr, size, sizeof(payload));
     if(err != ESP_LOADER_SUCCESS) {
-        storage_file_close(bin_file);
-        storage_file_free(bin_file);
         snprintf(user_msg, sizeof(user_msg), "Erasing flash failed with error %d\n", err);
         loader_port_debug_print(user_msg);
         return err;
@@ -55,8 +50,6 @@ static esp_loader_error_t _flash_file(EspFlasherApp* app, char* filepath, uint32
         err = esp_loader_flash_write(payload, num_bytes);
         if(err != ESP_LOADER_SUCCESS) {
             snprintf(user_msg, sizeof(user_msg), "Packet could not be written! Error: %u\n", err);
-            storage_file_close(bin_file);
-            storage_file_free(bin_file);
             loader_port_debug_print(user_msg);
             return err;
         }
@@ -65,13 +58,202 @@ static esp_loader_error_t _flash_file(EspFlasherApp* app, char* filepath, uint32
     }
 
     loader_port_debug_print("Finished programming\n");
+    return ESP_LOADER_SUCCESS;
+}
+
+typedef struct {
+    EspFlasherDeflate* deflate;
+    uint8_t in[ESP_FLASHER_DEFLATE_BLOCK_SIZE];
+    uint8_t out[ESP_FLASHER_DEFLATE_BOUND(ESP_FLASHER_DEFLATE_BLOCK_SIZE)];
+    uint8_t packet[FLASH_BLOCK_SIZE];
+    size_t packet_len;
+    md5_context md5_ctx;
+    uint8_t md5[16];
+} FlashDeflate;
+
+// Runs the file through the compressor, sending the stream in FLASH_BLOCK_SIZE packets
+// if send is set. The ROM loader needs the packet count up front, so this runs twice.
+// The first run also hashes the file to compare it with what is already on the target.
+static esp_loader_error_t _deflate_file(
+    FlashDeflate* ctx,
+    File* bin_file,
+    uint64_t size,
+    bool send,
+    uint32_t* compressed_size) {
+    esp_loader_error_t err;
+    char user_msg[64];
+
+    if(!storage_file_seek(bin_file, 0, true)) return ESP_LOADER_ERROR_FAIL;
+    esp_flasher_deflate_reset(ctx->deflate);
+    ctx->packet_len = 0;
+    *compressed_size = 0;
+    if(!send) md5_starts(&ctx->md5_ctx);
+
+    uint64_t last_updated = size;
+    while(size > 0) {
+        if(send && (last_updated - size) > 50000) {
+            snprintf(user_msg, sizeof(user_msg), "%llu bytes left.\n", size);
+            loader_port_debug_print(user_msg);
+            last_updated = size;
+        }
+        size_t to_read = MIN(size, sizeof(ctx->in));
+        if(storage_file_read(bin_file, ctx->in, to_read) != to_read) return ESP_LOADER_ERROR_FAIL;
+        size -= to_read;
+        if(!send) md5_update(&ctx->md5_ctx, ctx->in, to_read);
+
+        size_t out_len =
+            esp_flasher_deflate_block(ctx->deflate, ctx->in, to_read, !size, ctx->out);
+        *compressed_size += out_len;
+        if(!send) continue;
+
+        for(size_t i = 0; i < out_len;) {
+            size_t chunk = MIN(out_len - i, sizeof(ctx->packet) - ctx->packet_len);
+            memcpy(ctx->packet + ctx->packet_len, ctx->out + i, chunk);
+            ctx->packet_len += chunk;
+            i += chunk;
+            if(ctx->packet_len == sizeof(ctx->packet) || (!size && i == out_len)) {
+                err = esp_loader_flash_defl_write(ctx->packet, ctx->packet_len);
+                if(err != ESP_LOADER_SUCCESS) {
+                    snprintf(
+                        user_msg,
+                        sizeof(user_msg),
+                        "Packet could not be written! Error: %u\n",
+                        err);
+                    loader_port_debug_print(user_msg);
+                    return err;
+                }
+                ctx->packet_len = 0;
+            }
+        }
+    }
+    if(!send) md5_finish(&ctx->md5_ctx, ctx->md5);
+
+    return ESP_LOADER_SUCCESS;
+}
+
+static esp_loader_error_t _flash_file_deflate(File* bin_file, uint64_t size, uint32_t addr) {
+    esp_loader_error_t err;
+    char user_msg[256];
+    uint32_t compressed_size;
+
+    FlashDeflate* ctx = malloc(sizeof(FlashDeflate));
+    ctx->deflate = esp_flasher_deflate_alloc();
+    do {
+        loader_port_debug_print("Compressing...\n");
+        err = _deflate_file(ctx, bin_file, size, false, &compressed_size);
+        if(err != ESP_LOADER_SUCCESS) {
+            loader_port_debug_print("Cannot read file\n");
+            break;
+        }
+        snprintf(
+            user_msg,
+            sizeof(user_msg),
+            "%llu bytes compressed to %lu\n",
+            size,
+            compressed_size);
+        loader_port_debug_print(user_msg);
+
+        // unchanged regions are skipped, erasing and writing them again gains nothing
+        err = esp_loader_flash_verify_known_md5(addr, size, ctx->md5);
+        if(err == ESP_LOADER_SUCCESS) {
+            loader_port_debug_print("Already on the device, skipping\n");
+            break;
+        } else if(err != ESP_LOADER_ERROR_INVALID_MD5) {
+            snprintf(
+                user_msg, sizeof(user_msg), "Cannot read flash MD5 (error %d), flashing\n", err);
+            loader_port_debug_print(user_msg);
+        }
+
+        loader_port_debug_print("Erasing flash...this may take a while\n");
+        err = esp_loader_flash_defl_start(addr, size, compressed_size, FLASH_BLOCK_SIZE);
+        if(err != ESP_LOADER_SUCCESS) {
+            snprintf(user_msg, sizeof(user_msg), "Erasing flash failed with error %d\n", err);
+            loader_port_debug_print(user_msg);
+            break;
+        }
+
+        loader_port_debug_print("Start programming\n");
+        err = _deflate_file(ctx, bin_file, size, true, &compressed_size);
+        if(err == ESP_LOADER_SUCCESS) loader_port_debug_print("Finished programming\n");
+    } while(false);
+    esp_flasher_deflate_free(ctx->deflate);
+    free(ctx);
+
+    return err;
+}
+
+static esp_loader_error_t _flash_file(EspFlasherApp* app, char* filepath, uint32_t addr) {
+    esp_loader_error_t err;
+    File* bin_file = storage_file_alloc(app->storage);
+
+    // open file
+    if(!storage_file_open(bin_file, filepath, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        storage_file_close(bin_file);
+        storage_file_free(bin_file);
+        dialog_message_show_storage_error(app->dialogs, "Cannot open file");
+        return ESP_LOADER_ERROR_FAIL;
+    }
+
+    uint64_t size = storage_file_size(bin_file);
+
+    // ESP8266 ROM has no compressed flash commands
+    if(size && esp_loader_get_target() != ESP8266_CHIP) {
+        err = _flash_file_deflate(bin_file, size, addr);
+    } else {
+        err = _flash_file_raw(bin_file, size, addr);
+    }
 
     // TODO verify
 
     storage_file_close(bin_file);
     storage_file_free(bin_file);
 
-    return ESP_LOADER_SUCCESS;
+    return err;
+}
+
+// Returns false if the link is lost, the target is left at 115200 in every other case
+static bool _set_flash_baudrate(esp_loader_connect_args_t* connect_config) {
+    char user_msg[128];
+
+    loader_port_debug_print("Increasing speed for faster flash\n");
+    esp_loader_error_t err = esp_loader_change_transmission_rate(FLASH_BAUDRATE);
+    if(err != ESP_LOADER_SUCCESS) {
+        snprintf(
+            user_msg,
+            sizeof(user_msg),
+            "Cannot change transmission rate. Error: %u\nStaying at %u baud\n",
+            err,
+            ESP_FLASHER_UART_BAUDRATE);
+        loader_port_debug_print(user_msg);
+        return true;
+    }
+
+    // the answer comes at the old rate, drop anything received while both sides switch
+    esp_flasher_uart_set_br(FLASH_BAUDRATE);
+    loader_port_delay_ms(50);
+    furi_stream_buffer_reset(flash_rx_stream);
+
+    uint32_t reg;
+    if(esp_loader_read_register(ESP_CHIP_DETECT_MAGIC_REG, &reg) == ESP_LOADER_SUCCESS) {
+        return true;
+    }
+
+    snprintf(
+        user_msg,
+        sizeof(user_msg),
+        "No answer at %u baud, reconnecting at %u baud\n",
+        FLASH_BAUDRATE,
+        ESP_FLASHER_UART_BAUDRATE);
+    loader_port_debug_print(user_msg);
+    esp_flasher_uart_set_br(ESP_FLASHER_UART_BAUDRATE);
+    loader_port_enter_bootloader();
+    furi_stream_buffer_reset(flash_rx_stream);
+    if(esp_loader_connect(connect_config) != ESP_LOADER_SUCCESS) {
+        loader_port_debug_print("Cannot reconnect to target.\n"
+                                "Put the device in bootloader/reflash mode and try again.\n");
+        return false;
+    }
+    return true;
 }
 
 // This in-app FW switch "exploits" the otadata (boot_app0)
@@ -227,23 +409,9 @@ static int32_t esp_flasher_flash_bin(void* context) {
         loader_port_debug_print(err_msg);
     }
 
-#if 0 // still getting packet drops with this
-    // higher BR
-    if(!err) {
-        loader_port_debug_print("Increasing speed for faster flash\n");
-        err = esp_loader_change_transmission_rate(230400);
-        if (err != ESP_LOADER_SUCCESS) {
-            char err_msg[256];
-            snprintf(
-                err_msg,
-                sizeof(err_msg),
-                "Cannot change transmission rate. Error: %u\n",
-                err);
-            loader_port_debug_print(err_msg);
-        }
-        furi_hal_uart_set_br(FuriHalUartIdUSART1, 230400);
+    if(!err && !_set_flash_baudrate(&connect_config)) {
+        err = ESP_LOADER_ERROR_FAIL;
     }
-#endif
 
     if(!err) {
         loader_port_debug_print("Connected\n");
@@ -251,10 +419,8 @@ static int32_t esp_flasher_flash_bin(void* context) {
             _flash_all_files(app);
         }
         app->switch_fw = SwitchNotSet;
-#if 0
-        loader_port_debug_print("Restoring transmission rate\n");
-        furi_hal_uart_set_br(FuriHalUartIdUSART1, 115200);
-#endif
+        // the firmware talks at the default rate after reset
+        esp_flasher_uart_set_br(ESP_FLASHER_UART_BAUDRATE);
         loader_port_debug_print(
             "Done flashing. Please reset the board manually if it doesn't auto-reset.\n");
 
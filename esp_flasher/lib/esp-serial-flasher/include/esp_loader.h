@@ -187,6 +187,36 @@ esp_loader_error_t esp_loader_flash_write(void *payload, uint32_t size);
   *     - ESP_LOADER_ERROR_INVALID_RESPONSE Internal error
   */
 esp_loader_error_t esp_loader_flash_finish(bool reboot);
+
+/**
+  * @brief Initiates compressed flash operation. Not supported by ESP8266 ROM.
+  *
+  * @param offset[in]          Address from which flash operation will be performed.
+  * @param image_size[in]      Size of the whole binary once decompressed.
+  * @param compressed_size[in] Size of the zlib stream sent with esp_loader_flash_defl_write.
+  * @param block_size[in]      Maximum size of the chunks passed to esp_loader_flash_defl_write.
+  *
+  * @return
+  *     - ESP_LOADER_SUCCESS Success
+  *     - ESP_LOADER_ERROR_TIMEOUT Timeout
+  *     - ESP_LOADER_ERROR_INVALID_RESPONSE Internal error
+  *     - ESP_LOADER_ERROR_UNSUPPORTED_FUNC Target is ESP8266
+  */
+esp_loader_error_t esp_loader_flash_defl_start(uint32_t offset, uint32_t image_size,
+                                               uint32_t compressed_size, uint32_t block_size);
+
+/**
+  * @brief Writes the next chunk of the zlib stream to the target.
+  *
+  * @param payload[in]      Compressed data, not padded.
+  * @param size[in]         Size of payload in bytes, at most block_size.
+  *
+  * @return
+  *     - ESP_LOADER_SUCCESS Success
+  *     - ESP_LOADER_ERROR_TIMEOUT Timeout
+  *     - ESP_LOADER_ERROR_INVALID_RESPONSE Internal error
+  */
+esp_loader_error_t esp_loader_flash_defl_write(const void *payload, uint32_t size);
 #endif /* SERIAL_FLASHER_INTERFACE_UART */
 
 
@@ -300,6 +330,25 @@ esp_loader_error_t esp_loader_change_transmission_rate(uint32_t transmission_rat
   */
 #if MD5_ENABLED
 esp_loader_error_t esp_loader_flash_verify(void);
+
+/**
+  * @brief Compare a flash region of the target against a known MD5, nothing is written.
+  *
+  * @note  This function is only available if MD5_ENABLED is set.
+  *
+  * @param address[in]       Start of the region in target's flash.
+  * @param size[in]          Size of the region in bytes.
+  * @param expected_md5[in]  Raw MD5 digest of the expected content.
+  *
+  * @return
+  *     - ESP_LOADER_SUCCESS Region matches
+  *     - ESP_LOADER_ERROR_INVALID_MD5 Region differs
+  *     - ESP_LOADER_ERROR_TIMEOUT Timeout
+  *     - ESP_LOADER_ERROR_INVALID_RESPONSE Internal error
+  *     - ESP_LOADER_ERROR_UNSUPPORTED_FUNC Unsupported on the target
+  */
+esp_loader_error_t esp_loader_flash_verify_known_md5(uint32_t address, uint32_t size,
+                                                     const uint8_t expected_md5[16]);
 #endif
 /**
   * @brief Toggles reset pin.
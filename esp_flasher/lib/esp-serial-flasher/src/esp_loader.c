@@ -307,6 +307,50 @@ esp_loader_error_t esp_loader_flash_finish(bool reboot)
 
     return loader_flash_end_cmd(!reboot);
 }
+
+
+esp_loader_error_t esp_loader_flash_defl_start(uint32_t offset, uint32_t image_size,
+                                               uint32_t compressed_size, uint32_t block_size)
+{
+    if (s_target == ESP8266_CHIP) {
+        return ESP_LOADER_ERROR_UNSUPPORTED_FUNC;
+    }
+
+    s_flash_write_size = block_size;
+
+    size_t flash_size = 0;
+    if (detect_flash_size(&flash_size) == ESP_LOADER_SUCCESS) {
+        if (image_size > flash_size) {
+            return ESP_LOADER_ERROR_IMAGE_SIZE;
+        }
+        loader_port_start_timer(DEFAULT_TIMEOUT);
+        RETURN_ON_ERROR( loader_spi_parameters(flash_size) );
+    } else {
+        loader_port_debug_print("Flash size detection failed, falling back to default");
+    }
+
+    // ROM loader erases the decompressed size up front, rounded up to whole blocks
+    bool encryption_in_cmd = encryption_in_begin_flash_cmd(s_target);
+    const uint32_t erase_size = ROUNDUP(image_size, block_size) * block_size;
+    const uint32_t blocks_to_write = ROUNDUP(compressed_size, block_size);
+
+    const uint32_t erase_region_timeout_per_mb = 10000;
+    loader_port_start_timer(timeout_per_mb(erase_size, erase_region_timeout_per_mb));
+    return loader_flash_defl_begin_cmd(offset, erase_size, block_size, blocks_to_write, encryption_in_cmd);
+}
+
+
+esp_loader_error_t esp_loader_flash_defl_write(const void *payload, uint32_t size)
+{
+    if (size > s_flash_write_size) {
+        return ESP_LOADER_ERROR_INVALID_PARAM;
+    }
+
+    // decompressing and writing a block can take a while on the target
+    loader_port_start_timer(DEFAULT_FLASH_TIMEOUT);
+
+    return loader_flash_defl_data_cmd((const uint8_t *)payload, size);
+}
 #endif /* SERIAL_FLASHER_INTERFACE_UART */
 
 esp_loader_error_t esp_loader_mem_start(uint32_t offset, uint32_t size, uint32_t block_size)
@@ -410,6 +454,30 @@ esp_loader_error_t esp_loader_flash_verify(void)
     return ESP_LOADER_SUCCESS;
 }
 
+
+esp_loader_error_t esp_loader_flash_verify_known_md5(uint32_t address, uint32_t size,
+                                                     const uint8_t expected_md5[16])
+{
+    if (s_target == ESP8266_CHIP) {
+        return ESP_LOADER_ERROR_UNSUPPORTED_FUNC;
+    }
+
+    uint8_t hex_md5[MD5_SIZE + 2] = {0};
+    uint8_t received_md5[MD5_SIZE + 2] = {0};
+
+    hexify(expected_md5, hex_md5);
+
+    loader_port_start_timer(timeout_per_mb(size, MD5_TIMEOUT_PER_MB));
+
+    RETURN_ON_ERROR( loader_md5_cmd(address, size, received_md5) );
+
+    if (memcmp(hex_md5, received_md5, MD5_SIZE) != 0) {
+        return ESP_LOADER_ERROR_INVALID_MD5;
+    }
+
+    return ESP_LOADER_SUCCESS;
+}
+
 #endif
 
 void esp_loader_reset_target(void)
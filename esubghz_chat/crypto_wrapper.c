@@ -1,5 +1,4 @@
 #include <furi_hal.h>
-#include <lib/mlib/m-dict.h>
 #include <toolbox/sha256.h>
 
 #ifndef FURI_HAL_CRYPTO_ADVANCED_AVAIL
@@ -8,14 +7,23 @@
 
 #include "crypto_wrapper.h"
 
-DICT_DEF2(ESubGhzChatReplayDict, uint64_t, uint32_t)
+#define REPLAY_TABLE_MASK (REPLAY_TABLE_SIZE - 1)
+
+/* Slot of the replay table. Slots are only ever emptied all at once, so a
+ * lookup can stop at the first empty slot of its probe sequence. */
+struct ESubGhzChatReplayEntry {
+    uint64_t run_id;
+    uint32_t counter;
+    uint32_t last_seen;
+    bool used;
+};
 
 struct ESugGhzChatCryptoCtx {
     uint8_t key[KEY_BITS / 8];
 #ifndef FURI_HAL_CRYPTO_ADVANCED_AVAIL
     gcm_context gcm_ctx;
 #endif /* FURI_HAL_CRYPTO_ADVANCED_AVAIL */
-    ESubGhzChatReplayDict_t replay_dict;
+    struct ESubGhzChatReplayEntry replay_table[REPLAY_TABLE_SIZE];
     uint64_t run_id;
     uint32_t counter;
 };
@@ -45,7 +53,6 @@ ESubGhzChatCryptoCtx* crypto_ctx_alloc(void) {
 
     if(ret != NULL) {
         memset(ret, 0, sizeof(ESubGhzChatCryptoCtx));
-        ESubGhzChatReplayDict_init(ret->replay_dict);
         ret->run_id = 0;
         ret->counter = 1;
     }
@@ -55,7 +62,6 @@ ESubGhzChatCryptoCtx* crypto_ctx_alloc(void) {
 
 void crypto_ctx_free(ESubGhzChatCryptoCtx* ctx) {
     crypto_ctx_clear(ctx);
-    ESubGhzChatReplayDict_clear(ctx->replay_dict);
     free(ctx);
 }
 
@@ -64,11 +70,71 @@ void crypto_ctx_clear(ESubGhzChatCryptoCtx* ctx) {
 #ifndef FURI_HAL_CRYPTO_ADVANCED_AVAIL
     crypto_explicit_bzero(&(ctx->gcm_ctx), sizeof(ctx->gcm_ctx));
 #endif /* FURI_HAL_CRYPTO_ADVANCED_AVAIL */
-    ESubGhzChatReplayDict_reset(ctx->replay_dict);
+    memset(ctx->replay_table, 0, sizeof(ctx->replay_table));
     ctx->run_id = 0;
     ctx->counter = 1;
 }
 
+static size_t replay_table_hash(uint64_t run_id) {
+    /* run IDs are truncated SHA-256 hashes, no further mixing needed */
+    return (size_t)(run_id ^ (run_id >> 32)) & REPLAY_TABLE_MASK;
+}
+
+/* Returns the slot holding run_id, or NULL if it is not in the table. */
+static struct ESubGhzChatReplayEntry*
+    replay_table_get(ESubGhzChatCryptoCtx* ctx, uint64_t run_id) {
+    size_t idx = replay_table_hash(run_id);
+    for(size_t i = 0; i < REPLAY_TABLE_SIZE; i++) {
+        struct ESubGhzChatReplayEntry* entry = &(ctx->replay_table[idx]);
+        if(!entry->used) {
+            return NULL;
+        }
+        if(entry->run_id == run_id) {
+            return entry;
+        }
+        idx = (idx + 1) & REPLAY_TABLE_MASK;
+    }
+
+    return NULL;
+}
+
+/* Stores counter for run_id. If run_id is new and the table is full, the
+ * least recently seen run ID is evicted. */
+static void replay_table_set(
+    ESubGhzChatCryptoCtx* ctx,
+    uint64_t run_id,
+    uint32_t counter,
+    uint32_t last_seen) {
+    struct ESubGhzChatReplayEntry* entry = replay_table_get(ctx, run_id);
+
+    if(entry == NULL) {
+        size_t idx = replay_table_hash(run_id);
+        struct ESubGhzChatReplayEntry* oldest = NULL;
+        for(size_t i = 0; i < REPLAY_TABLE_SIZE; i++) {
+            struct ESubGhzChatReplayEntry* cur = &(ctx->replay_table[idx]);
+            if(!cur->used) {
+                entry = cur;
+                break;
+            }
+            if(oldest == NULL || (int32_t)(cur->last_seen - oldest->last_seen) < 0) {
+                oldest = cur;
+            }
+            idx = (idx + 1) & REPLAY_TABLE_MASK;
+        }
+
+        /* no free slot means all slots were scanned */
+        if(entry == NULL) {
+            entry = oldest;
+        }
+
+        entry->run_id = run_id;
+        entry->used = true;
+    }
+
+    entry->counter = counter;
+    entry->last_seen = last_seen;
+}
+
 static uint64_t crypto_calc_run_id(FuriString* flipper_name, uint32_t tick) {
     const char* fn = furi_string_get_cstr(flipper_name);
     size_t fn_len = strlen(fn);
@@ -106,22 +172,27 @@ void crypto_ctx_get_key(ESubGhzChatCryptoCtx* ctx, uint8_t* key) {
     memcpy(key, ctx->key, KEY_BITS / 8);
 }
 
-bool crypto_ctx_decrypt(ESubGhzChatCryptoCtx* ctx, uint8_t* in, size_t in_len, uint8_t* out) {
-    if(in_len < MSG_OVERHEAD + 1) {
-        return false;
+uint64_t crypto_ctx_get_run_id(ESubGhzChatCryptoCtx* ctx) {
+    return ctx->run_id;
+}
+
+uint8_t* crypto_ctx_decrypt(ESubGhzChatCryptoCtx* ctx, uint8_t* buf, size_t buf_len) {
+    if(buf_len < MSG_OVERHEAD + 1) {
+        return NULL;
     }
 
-    struct ESubGhzChatCryptoMsg* msg = (struct ESubGhzChatCryptoMsg*)in;
+    struct ESubGhzChatCryptoMsg* msg = (struct ESubGhzChatCryptoMsg*)buf;
+    size_t data_len = buf_len - MSG_OVERHEAD;
 
     // check if message is stale, if yes, discard
-    uint32_t* counter = ESubGhzChatReplayDict_get(ctx->replay_dict, msg->run_id);
-    if(counter != NULL) {
-        if(*counter >= __ntohl(msg->counter)) {
-            return false;
+    struct ESubGhzChatReplayEntry* entry = replay_table_get(ctx, msg->run_id);
+    if(entry != NULL) {
+        if(entry->counter >= __ntohl(msg->counter)) {
+            return NULL;
         }
     }
 
-    // decrypt and auth message
+    // decrypt and auth message, in place
 #ifdef FURI_HAL_CRYPTO_ADVANCED_AVAIL
     bool ret =
         (furi_hal_crypto_gcm_decrypt_and_verify(
@@ -130,8 +201,8 @@ bool crypto_ctx_decrypt(ESubGhzChatCryptoCtx* ctx, uint8_t* in, size_t in_len, u
              (uint8_t*)msg,
              RUN_ID_BYTES + COUNTER_BYTES,
              msg->data,
-             out,
-             in_len - MSG_OVERHEAD,
+             msg->data,
+             data_len,
              msg->tag) == FuriHalCryptoGCMStateOk);
 #else /* FURI_HAL_CRYPTO_ADVANCED_AVAIL */
     bool ret =
@@ -142,29 +213,33 @@ bool crypto_ctx_decrypt(ESubGhzChatCryptoCtx* ctx, uint8_t* in, size_t in_len, u
              (uint8_t*)msg,
              RUN_ID_BYTES + COUNTER_BYTES,
              msg->data,
-             out,
-             in_len - MSG_OVERHEAD,
+             msg->data,
+             data_len,
              msg->tag,
              TAG_BYTES) == 0);
 #endif /* FURI_HAL_CRYPTO_ADVANCED_AVAIL */
 
-    // if auth was successful update replay dict
-    if(ret) {
-        ESubGhzChatReplayDict_set_at(ctx->replay_dict, msg->run_id, __ntohl(msg->counter));
+    // if auth was successful update replay dict, otherwise don't leave
+    // unauthenticated plaintext in the buffer
+    if(!ret) {
+        crypto_explicit_bzero(msg->data, data_len);
+        return NULL;
     }
 
-    return ret;
+    replay_table_set(ctx, msg->run_id, __ntohl(msg->counter), furi_get_tick());
+
+    return msg->data;
 }
 
-bool crypto_ctx_encrypt(ESubGhzChatCryptoCtx* ctx, uint8_t* in, size_t in_len, uint8_t* out) {
-    struct ESubGhzChatCryptoMsg* msg = (struct ESubGhzChatCryptoMsg*)out;
+bool crypto_ctx_encrypt(ESubGhzChatCryptoCtx* ctx, uint8_t* buf, size_t data_len) {
+    struct ESubGhzChatCryptoMsg* msg = (struct ESubGhzChatCryptoMsg*)buf;
 
     // fill message header
     msg->run_id = ctx->run_id;
     msg->counter = __htonl(ctx->counter);
     furi_hal_random_fill_buf(msg->iv, IV_BYTES);
 
-    // encrypt message and store tag in header
+    // encrypt message in place and store tag in header
 #ifdef FURI_HAL_CRYPTO_ADVANCED_AVAIL
     bool ret =
         (furi_hal_crypto_gcm_encrypt_and_tag(
@@ -172,9 +247,9 @@ bool crypto_ctx_encrypt(ESubGhzChatCryptoCtx* ctx, uint8_t* in, size_t in_len, u
              msg->iv,
              (uint8_t*)msg,
              RUN_ID_BYTES + COUNTER_BYTES,
-             in,
              msg->data,
-             in_len,
+             msg->data,
+             data_len,
              msg->tag) == FuriHalCryptoGCMStateOk);
 #else /* FURI_HAL_CRYPTO_ADVANCED_AVAIL */
     bool ret =
@@ -185,53 +260,73 @@ bool crypto_ctx_encrypt(ESubGhzChatCryptoCtx* ctx, uint8_t* in, size_t in_len, u
              IV_BYTES,
              (uint8_t*)msg,
              RUN_ID_BYTES + COUNTER_BYTES,
-             in,
              msg->data,
-             in_len,
+             msg->data,
+             data_len,
              msg->tag,
              TAG_BYTES) == 0);
 #endif /* FURI_HAL_CRYPTO_ADVANCED_AVAIL */
 
     // update replay dict and increase internal counter
     if(ret) {
-        ESubGhzChatReplayDict_set_at(ctx->replay_dict, ctx->run_id, ctx->counter);
+        replay_table_set(ctx, ctx->run_id, ctx->counter, furi_get_tick());
         ctx->counter++;
     }
 
     return ret;
 }
 
-size_t crypto_ctx_dump_replay_dict(
-    ESubGhzChatCryptoCtx* ctx,
-    CryptoCtxReplayDictWriter writer,
-    void* writer_ctx) {
-    size_t ret = 0;
-    ESubGhzChatReplayDict_it_t i;
-
-    for(ESubGhzChatReplayDict_it(i, ctx->replay_dict); !ESubGhzChatReplayDict_end_p(i);
-        ESubGhzChatReplayDict_next(i), ret++) {
-        ESubGhzChatReplayDict_itref_t* ref = ESubGhzChatReplayDict_ref(i);
-        if(!writer(ref->key, ref->value, writer_ctx)) {
-            break;
+size_t crypto_ctx_dump_replay_dict(ESubGhzChatCryptoCtx* ctx, uint8_t* buf, size_t buf_len) {
+    /* order the used slots by last seen tick, most recent first */
+    uint8_t order[REPLAY_TABLE_SIZE];
+    size_t n_used = 0;
+    for(size_t i = 0; i < REPLAY_TABLE_SIZE; i++) {
+        if(!ctx->replay_table[i].used) {
+            continue;
+        }
+
+        size_t j = n_used++;
+        for(; j > 0; j--) {
+            struct ESubGhzChatReplayEntry* prev = &(ctx->replay_table[order[j - 1]]);
+            if((int32_t)(ctx->replay_table[i].last_seen - prev->last_seen) <= 0) {
+                break;
+            }
+            order[j] = order[j - 1];
         }
+        order[j] = i;
     }
 
-    return ret;
+    /* write as many entries as fit */
+    size_t n_entries = buf_len / sizeof(struct ESubGhzChatReplaySnapshotEntry);
+    if(n_entries > n_used) {
+        n_entries = n_used;
+    }
+
+    struct ESubGhzChatReplaySnapshotEntry* out = (struct ESubGhzChatReplaySnapshotEntry*)buf;
+    for(size_t i = 0; i < n_entries; i++) {
+        struct ESubGhzChatReplayEntry* entry = &(ctx->replay_table[order[i]]);
+        out[i].run_id = entry->run_id;
+        out[i].counter = __htonl(entry->counter);
+        out[i].unused = 0;
+    }
+
+    return n_entries * sizeof(struct ESubGhzChatReplaySnapshotEntry);
 }
 
 size_t crypto_ctx_read_replay_dict(
     ESubGhzChatCryptoCtx* ctx,
-    CryptoCtxReplayDictReader reader,
-    void* reader_ctx) {
-    size_t ret = 0;
-
-    uint64_t run_id;
-    uint32_t counter;
-
-    while(reader(&run_id, &counter, reader_ctx)) {
-        ESubGhzChatReplayDict_set_at(ctx->replay_dict, run_id, counter);
-        ret++;
+    const uint8_t* buf,
+    size_t buf_len) {
+    size_t n_entries = buf_len / sizeof(struct ESubGhzChatReplaySnapshotEntry);
+    const struct ESubGhzChatReplaySnapshotEntry* in =
+        (const struct ESubGhzChatReplaySnapshotEntry*)buf;
+
+    /* the snapshot is ordered most recent first, keep that order in the
+     * last seen ticks so eviction picks the oldest entries */
+    uint32_t now = furi_get_tick();
+    for(size_t i = 0; i < n_entries; i++) {
+        replay_table_set(ctx, in[i].run_id, __ntohl(in[i].counter), now - i);
     }
 
-    return ret;
+    return n_entries;
 }
@@ -12,6 +12,17 @@ extern "C" {
 
 #define MSG_OVERHEAD (RUN_ID_BYTES + COUNTER_BYTES + IV_BYTES + TAG_BYTES)
 
+/* Number of run IDs tracked for replay protection, must be a power of two.
+ * When full, the least recently seen run ID is evicted. */
+#define REPLAY_TABLE_SIZE 32
+
+/* Replay table snapshot entry, also the format shared via NFC. */
+struct ESubGhzChatReplaySnapshotEntry {
+    uint64_t run_id;
+    uint32_t counter; /* big endian */
+    uint32_t unused;
+} __attribute__((packed));
+
 typedef struct ESugGhzChatCryptoCtx ESubGhzChatCryptoCtx;
 
 void crypto_init(void);
@@ -30,21 +41,27 @@ bool crypto_ctx_set_key(
     FuriString* flipper_name,
     uint32_t tick);
 void crypto_ctx_get_key(ESubGhzChatCryptoCtx* ctx, uint8_t* key);
+uint64_t crypto_ctx_get_run_id(ESubGhzChatCryptoCtx* ctx);
 
-bool crypto_ctx_decrypt(ESubGhzChatCryptoCtx* ctx, uint8_t* in, size_t in_len, uint8_t* out);
-bool crypto_ctx_encrypt(ESubGhzChatCryptoCtx* ctx, uint8_t* in, size_t in_len, uint8_t* out);
+/* Decrypts and authenticates the message in buf in place. On success returns
+ * a pointer to the plaintext inside buf, which is buf_len - MSG_OVERHEAD
+ * bytes long. Returns NULL if the message is stale or forged. */
+uint8_t* crypto_ctx_decrypt(ESubGhzChatCryptoCtx* ctx, uint8_t* buf, size_t buf_len);
 
-typedef bool (*CryptoCtxReplayDictWriter)(uint64_t run_id, uint32_t counter, void* context);
-typedef bool (*CryptoCtxReplayDictReader)(uint64_t* run_id, uint32_t* counter, void* context);
+/* Encrypts the data_len bytes of plaintext placed at buf + MSG_OVERHEAD in
+ * place and fills in the message header in front of it. */
+bool crypto_ctx_encrypt(ESubGhzChatCryptoCtx* ctx, uint8_t* buf, size_t data_len);
 
-size_t crypto_ctx_dump_replay_dict(
-    ESubGhzChatCryptoCtx* ctx,
-    CryptoCtxReplayDictWriter writer,
-    void* writer_ctx);
+/* Writes a compact snapshot of the replay table to buf, as many entries as
+ * fit, most recently seen first. Returns the number of bytes written. */
+size_t crypto_ctx_dump_replay_dict(ESubGhzChatCryptoCtx* ctx, uint8_t* buf, size_t buf_len);
+
+/* Loads a snapshot written by crypto_ctx_dump_replay_dict(). Returns the
+ * number of entries read. */
 size_t crypto_ctx_read_replay_dict(
     ESubGhzChatCryptoCtx* ctx,
-    CryptoCtxReplayDictReader reader,
-    void* reader_ctx);
+    const uint8_t* buf,
+    size_t buf_len);
 
 #ifdef __cplusplus
 }
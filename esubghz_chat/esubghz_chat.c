@@ -8,9 +8,25 @@
 #include "bgloader_api.h"
 
 #define CHAT_LEAVE_DELAY 10
+#define CHAT_LEAVE_DRAIN_TIMEOUT 5000
 #define TICK_INTERVAL 50
 #define MESSAGE_COMPLETION_TIMEOUT 500
 
+/* receivers delimit frames by RX silence, so frames need to be spaced */
+#define TX_FRAME_GAP (MESSAGE_COMPLETION_TIMEOUT + 2 * TICK_INTERVAL)
+#define TX_BATCH_WINDOW 300
+#define FRAG_REASSEMBLY_TIMEOUT (3 * TX_FRAME_GAP)
+#define FRAG_NACK_RETRIES 2
+/* how long a fragmented message is kept for retransmission */
+#define FRAG_HOLD_TIME (FRAG_REASSEMBLY_TIMEOUT * (FRAG_NACK_RETRIES + 1) + TX_FRAME_GAP)
+
+/* Frames starting with these control characters carry transport data instead
+ * of chat text. Other frames hold one or more '\n' separated messages. */
+#define FRAME_TYPE_FRAGMENT 0x1e /* ASCII record separator */
+#define FRAME_TYPE_NACK 0x15 /* ASCII negative acknowledge */
+#define FRAG_HEADER_SIZE 4 /* type, message ID, index, count */
+#define NACK_SIZE (3 + RUN_ID_BYTES) /* type, message ID, missing, run ID */
+
 #define KBD_UNLOCK_CNT 3
 #define KBD_UNLOCK_TIMEOUT 1000
 
@@ -49,18 +65,295 @@ void append_msg(ESubGhzChatState* state, const char* msg) {
     text_box_set_focus(state->chat_box, TextBoxFocusEnd);
 }
 
-/* Decrypts a message for post_rx(). */
-static bool post_rx_decrypt(ESubGhzChatState* state, size_t rx_size) {
-    bool ret = crypto_ctx_decrypt(
-        state->crypto_ctx, state->rx_buffer, rx_size, (uint8_t*)state->rx_str_buffer);
+/* Decrypts a message for post_rx() in place. Returns the plaintext string
+ * inside the RX buffer or NULL if decryption failed. */
+static char* post_rx_decrypt(ESubGhzChatState* state, size_t rx_size) {
+    uint8_t* plaintext = crypto_ctx_decrypt(state->crypto_ctx, state->rx_buffer, rx_size);
 
-    if(ret) {
-        state->rx_str_buffer[rx_size - (MSG_OVERHEAD)] = 0;
-    } else {
-        state->rx_str_buffer[0] = 0;
+    if(plaintext != NULL) {
+        state->rx_buffer[rx_size] = 0;
     }
 
-    return ret;
+    return (char*)plaintext;
+}
+
+/* Bitmask with the lowest frag_count bits set. */
+static uint8_t frag_mask(uint8_t frag_count) {
+    return (uint8_t)((1u << frag_count) - 1);
+}
+
+/* Appends every '\n' separated message of a frame or reassembled message to
+ * the chat box. */
+static void transport_deliver(ESubGhzChatState* state, char* text) {
+    char* line = text;
+    while(line != NULL) {
+        char* next = strchr(line, '\n');
+        if(next != NULL) {
+            *next = 0;
+            next++;
+        }
+        if(line[0] != 0) {
+            append_msg(state, line);
+        }
+        line = next;
+    }
+}
+
+/* Encrypts and transmits a transport header followed by data. */
+static void transport_tx_frame(
+    ESubGhzChatState* state,
+    const uint8_t* header,
+    size_t header_len,
+    const char* data,
+    size_t data_len) {
+    size_t tx_size = MSG_OVERHEAD + header_len + data_len;
+    furi_check(tx_size <= sizeof(state->tx_buffer));
+
+    /* assemble the plaintext behind the header and encrypt it in place */
+    uint8_t* plaintext = state->tx_buffer + MSG_OVERHEAD;
+    if(header_len > 0) {
+        memcpy(plaintext, header, header_len);
+    }
+    if(data_len > 0) {
+        memcpy(plaintext + header_len, data, data_len);
+    }
+    crypto_ctx_encrypt(state->crypto_ctx, state->tx_buffer, header_len + data_len);
+
+    subghz_tx_rx_worker_write(state->subghz_worker, state->tx_buffer, tx_size);
+    state->tx_last_tick = furi_get_tick();
+}
+
+/* Whether the message in tx_msg is still being sent or kept for
+ * retransmission requests. */
+static bool transport_tx_busy(ESubGhzChatState* state) {
+    if(state->tx_frags_pending != 0) {
+        return true;
+    }
+
+    return (state->tx_frag_count > 1 && furi_get_tick() - state->tx_last_tick < FRAG_HOLD_TIME);
+}
+
+/* Moves as many whole messages from the batch to tx_msg as fit. */
+static void transport_take_batch(ESubGhzChatState* state) {
+    const char* batch = furi_string_get_cstr(state->tx_batch);
+    size_t batch_len = furi_string_size(state->tx_batch);
+
+    size_t take = batch_len;
+    if(take > TRANSPORT_MSG_MAX) {
+        /* cut after the last complete message, or truncate a single
+         * oversized one */
+        take = TRANSPORT_MSG_MAX;
+        while(take > 0 && batch[take - 1] != '\n') {
+            take--;
+        }
+        if(take == 0) {
+            take = TRANSPORT_MSG_MAX;
+        }
+    }
+
+    memcpy(state->tx_msg, batch, take);
+    state->tx_msg_len = take;
+    /* drop the separator at the end of the taken messages */
+    if(take < batch_len && batch[take] == '\n') {
+        take++;
+    }
+    furi_string_right(state->tx_batch, take);
+    state->tx_batch_tick = furi_get_tick();
+
+    state->tx_msg_id++;
+    state->tx_frag_count = (state->tx_msg_len + FRAG_PAYLOAD_SIZE - 1) / FRAG_PAYLOAD_SIZE;
+    state->tx_frags_pending = frag_mask(state->tx_frag_count);
+}
+
+/* Transmits the next pending frame, if any, respecting the frame gap. When
+ * force is set the batch window is ignored. */
+static void transport_tx_tick(ESubGhzChatState* state, bool force) {
+    uint32_t now = furi_get_tick();
+    if(now - state->tx_last_tick < TX_FRAME_GAP) {
+        return;
+    }
+
+    /* when forced, don't keep the last message around for retransmissions */
+    bool busy = force ? (state->tx_frags_pending != 0) : transport_tx_busy(state);
+    if(!busy && furi_string_size(state->tx_batch) > 0 &&
+       (force || now - state->tx_batch_tick >= TX_BATCH_WINDOW)) {
+        transport_take_batch(state);
+    }
+
+    if(state->tx_frags_pending == 0) {
+        return;
+    }
+
+    /* short messages go out as plain text frames, as before */
+    if(state->tx_frag_count == 1) {
+        state->tx_frags_pending = 0;
+        transport_tx_frame(state, NULL, 0, state->tx_msg, state->tx_msg_len);
+        return;
+    }
+
+    /* send the lowest pending fragment */
+    uint8_t index = 0;
+    while(!(state->tx_frags_pending & (1 << index))) {
+        index++;
+    }
+    state->tx_frags_pending &= ~(1 << index);
+
+    size_t offset = index * FRAG_PAYLOAD_SIZE;
+    size_t len = state->tx_msg_len - offset;
+    if(len > FRAG_PAYLOAD_SIZE) {
+        len = FRAG_PAYLOAD_SIZE;
+    }
+
+    uint8_t header[FRAG_HEADER_SIZE] = {
+        FRAME_TYPE_FRAGMENT, state->tx_msg_id, index, state->tx_frag_count};
+    transport_tx_frame(state, header, sizeof(header), state->tx_msg + offset, len);
+}
+
+/* Requests the missing fragments of incomplete messages and gives up on them
+ * after FRAG_NACK_RETRIES requests. */
+static void transport_rx_tick(ESubGhzChatState* state) {
+    uint32_t now = furi_get_tick();
+
+    for(size_t i = 0; i < REASSEMBLY_SLOTS; i++) {
+        ESubGhzChatReassembly* slot = &(state->reassembly[i]);
+        if(!slot->used || now - slot->last_rx < FRAG_REASSEMBLY_TIMEOUT) {
+            continue;
+        }
+
+        if(slot->nacks_sent >= FRAG_NACK_RETRIES) {
+            slot->used = false;
+            append_msg(state, "ERR: Message incomplete!");
+            continue;
+        }
+
+        /* the NACK has to wait for the frame gap like every other frame */
+        if(now - state->tx_last_tick < TX_FRAME_GAP) {
+            continue;
+        }
+
+        uint8_t nack[NACK_SIZE] = {
+            FRAME_TYPE_NACK,
+            slot->msg_id,
+            frag_mask(slot->frag_count) & ~slot->frags_received};
+        memcpy(nack + 3, &(slot->run_id), RUN_ID_BYTES);
+        transport_tx_frame(state, nack, sizeof(nack), NULL, 0);
+
+        slot->nacks_sent++;
+        slot->last_rx = now;
+    }
+}
+
+/* Runs the transport layer, called every TICK_INTERVAL. */
+static void transport_tick(ESubGhzChatState* state) {
+    if(!state->encrypted || !subghz_tx_rx_worker_is_running(state->subghz_worker)) {
+        return;
+    }
+
+    transport_rx_tick(state);
+    transport_tx_tick(state, false);
+}
+
+/* Stores a received fragment. Returns the slot once the message is
+ * complete, NULL otherwise. */
+static ESubGhzChatReassembly* transport_rx_fragment(
+    ESubGhzChatState* state,
+    uint64_t run_id,
+    const uint8_t* frame,
+    size_t frame_len) {
+    if(frame_len <= FRAG_HEADER_SIZE) {
+        return NULL;
+    }
+
+    uint8_t msg_id = frame[1];
+    uint8_t index = frame[2];
+    uint8_t frag_count = frame[3];
+    size_t len = frame_len - FRAG_HEADER_SIZE;
+    if(frag_count < 2 || frag_count > FRAG_MAX_COUNT || index >= frag_count ||
+       len > FRAG_PAYLOAD_SIZE || (index < frag_count - 1 && len != FRAG_PAYLOAD_SIZE)) {
+        return NULL;
+    }
+
+    /* find the sender's slot, or reuse a free or the least recent one */
+    ESubGhzChatReassembly* slot = NULL;
+    for(size_t i = 0; i < REASSEMBLY_SLOTS; i++) {
+        ESubGhzChatReassembly* cur = &(state->reassembly[i]);
+        if(cur->used && cur->run_id == run_id) {
+            slot = cur;
+            break;
+        }
+        if(slot == NULL || !cur->used ||
+           (slot->used && (int32_t)(cur->last_rx - slot->last_rx) < 0)) {
+            slot = cur;
+        }
+    }
+
+    if(!slot->used || slot->run_id != run_id || slot->msg_id != msg_id) {
+        slot->used = true;
+        slot->run_id = run_id;
+        slot->msg_id = msg_id;
+        slot->frag_count = frag_count;
+        slot->frags_received = 0;
+        slot->nacks_sent = 0;
+        slot->msg_len = 0;
+    }
+
+    if(slot->frag_count != frag_count) {
+        return NULL;
+    }
+
+    memcpy(slot->msg + index * FRAG_PAYLOAD_SIZE, frame + FRAG_HEADER_SIZE, len);
+    if(index == frag_count - 1) {
+        slot->msg_len = index * FRAG_PAYLOAD_SIZE + len;
+    }
+    slot->frags_received |= (1 << index);
+    slot->last_rx = furi_get_tick();
+
+    if(slot->frags_received != frag_mask(frag_count)) {
+        return NULL;
+    }
+
+    slot->msg[slot->msg_len] = 0;
+    slot->used = false;
+    return slot;
+}
+
+/* Handles a retransmission request, resends the requested fragments if they
+ * belong to the message we are holding. */
+static void transport_rx_nack(ESubGhzChatState* state, const uint8_t* frame, size_t frame_len) {
+    if(frame_len != NACK_SIZE || state->tx_frag_count < 2) {
+        return;
+    }
+
+    uint64_t run_id;
+    memcpy(&run_id, frame + 3, RUN_ID_BYTES);
+    if(run_id != crypto_ctx_get_run_id(state->crypto_ctx) || frame[1] != state->tx_msg_id) {
+        return;
+    }
+
+    state->tx_frags_pending |= frame[2] & frag_mask(state->tx_frag_count);
+}
+
+/* Handles a decrypted frame. Returns true if messages were appended to the
+ * chat box. */
+static bool transport_rx_frame(ESubGhzChatState* state, char* plaintext, size_t len) {
+    uint64_t run_id;
+    memcpy(&run_id, state->rx_buffer, RUN_ID_BYTES);
+
+    const uint8_t* frame = (const uint8_t*)plaintext;
+    if(frame[0] == FRAME_TYPE_FRAGMENT) {
+        ESubGhzChatReassembly* slot = transport_rx_fragment(state, run_id, frame, len);
+        if(slot == NULL) {
+            return false;
+        }
+        transport_deliver(state, slot->msg);
+        return true;
+    } else if(frame[0] == FRAME_TYPE_NACK) {
+        transport_rx_nack(state, frame, len);
+        return false;
+    }
+
+    transport_deliver(state, plaintext);
+    return true;
 }
 
 /* Post RX handler, decrypts received messages and calls append_msg(). */
@@ -75,53 +368,56 @@ static void post_rx(ESubGhzChatState* state, size_t rx_size) {
 
     /* decrypt if necessary */
     if(!state->encrypted) {
-        memcpy(state->rx_str_buffer, state->rx_buffer, rx_size);
-        state->rx_str_buffer[rx_size] = 0;
+        state->rx_buffer[rx_size] = 0;
 
         /* remove trailing newline if it is there, for compat with CLI
 		 * Sub-GHz chat */
-        if(state->rx_str_buffer[rx_size - 1] == '\n') {
-            state->rx_str_buffer[rx_size - 1] = 0;
+        if(state->rx_buffer[rx_size - 1] == '\n') {
+            state->rx_buffer[rx_size - 1] = 0;
         }
+
+        /* append message to text box and prepare message preview */
+        append_msg(state, (const char*)state->rx_buffer);
     } else {
-        /* if decryption fails output an error message */
-        if(!post_rx_decrypt(state, rx_size)) {
-            strcpy(state->rx_str_buffer, "ERR: Decryption failed!");
+        char* plaintext = post_rx_decrypt(state, rx_size);
+
+        if(plaintext == NULL) {
+            /* if decryption fails output an error message */
+            append_msg(state, "ERR: Decryption failed!");
+        } else if(!transport_rx_frame(state, plaintext, rx_size - MSG_OVERHEAD)) {
+            /* fragment of an incomplete message or a transport request */
+            return;
         }
     }
 
-    /* append message to text box and prepare message preview */
-    append_msg(state, state->rx_str_buffer);
-
     /* send notification (make the flipper vibrate) */
     notification_message(state->notification, &sequence_single_vibro);
 }
 
 /* Reads the message from msg_input, encrypts it if necessary and then
- * transmits it. */
+ * transmits it. Encrypted messages are handed to the transport layer, which
+ * batches and fragments them. */
 void tx_msg_input(ESubGhzChatState* state) {
-    /* encrypt message if necessary */
     size_t msg_len = strlen(furi_string_get_cstr(state->msg_input));
-    size_t tx_size = msg_len;
-    if(state->encrypted) {
-        tx_size += MSG_OVERHEAD;
-        furi_check(tx_size <= sizeof(state->tx_buffer));
-
-        crypto_ctx_encrypt(
-            state->crypto_ctx,
-            (uint8_t*)furi_string_get_cstr(state->msg_input),
-            msg_len,
-            state->tx_buffer);
-    } else {
-        tx_size += 2;
-        furi_check(tx_size <= sizeof(state->tx_buffer));
-        memcpy(state->tx_buffer, furi_string_get_cstr(state->msg_input), msg_len);
 
-        /* append \r\n for compat with Sub-GHz CLI chat */
-        state->tx_buffer[msg_len] = '\r';
-        state->tx_buffer[msg_len + 1] = '\n';
+    if(state->encrypted) {
+        if(furi_string_size(state->tx_batch) == 0) {
+            state->tx_batch_tick = furi_get_tick();
+        } else {
+            furi_string_push_back(state->tx_batch, '\n');
+        }
+        furi_string_cat(state->tx_batch, state->msg_input);
+        return;
     }
 
+    size_t tx_size = msg_len + 2;
+    furi_check(tx_size <= sizeof(state->tx_buffer));
+    memcpy(state->tx_buffer, furi_string_get_cstr(state->msg_input), msg_len);
+
+    /* append \r\n for compat with Sub-GHz CLI chat */
+    state->tx_buffer[msg_len] = '\r';
+    state->tx_buffer[msg_len + 1] = '\n';
+
     /* transmit */
     subghz_tx_rx_worker_write(state->subghz_worker, state->tx_buffer, tx_size);
 }
@@ -166,6 +462,15 @@ void exit_chat(ESubGhzChatState* state) {
     /* clear message input buffer */
     furi_string_set_char(state->msg_input, 0, 0);
 
+    /* send whatever the transport layer still holds */
+    uint32_t start = furi_get_tick();
+    while(state->encrypted &&
+          (state->tx_frags_pending != 0 || furi_string_size(state->tx_batch) > 0) &&
+          furi_get_tick() - start < CHAT_LEAVE_DRAIN_TIMEOUT) {
+        transport_tx_tick(state, true);
+        furi_delay_ms(TICK_INTERVAL);
+    }
+
     /* wait for leave message to be delivered */
     furi_delay_ms(CHAT_LEAVE_DELAY);
 }
@@ -259,6 +564,7 @@ static void esubghz_chat_tick_event_callback(void* context) {
     }
 
     esubghz_chat_check_messages(state);
+    transport_tick(state);
 
     /* call scene manager */
     scene_manager_handle_tick_event(state->scene_manager);
@@ -478,6 +784,7 @@ static void esubghz_bgloader_loop(ESubGhzChatState* state, const char* bg_app_pa
             if(furi_message_queue_get(bg_app->to_app, &msg, TICK_INTERVAL) != FuriStatusOk) {
                 /* check for messages on timeout */
                 esubghz_chat_check_messages(state);
+                transport_tick(state);
                 continue;
             }
             if(msg.type == BGLoaderMessageType_AppReattached) {
@@ -507,6 +814,13 @@ static bool helper_strings_alloc(ESubGhzChatState* state) {
         return false;
     }
 
+    state->tx_batch = furi_string_alloc();
+    if(state->tx_batch == NULL) {
+        furi_string_free(state->name_prefix);
+        furi_string_free(state->msg_input);
+        return false;
+    }
+
     return true;
 }
 
@@ -515,6 +829,7 @@ static void helper_strings_free(ESubGhzChatState* state) {
 
     furi_string_free(state->name_prefix);
     furi_string_free(state->msg_input);
+    furi_string_free(state->tx_batch);
 }
 
 static bool chat_box_alloc(ESubGhzChatState* state) {
@@ -36,6 +36,26 @@
 
 #define KEY_HEX_STR_SIZE ((KEY_BITS / 8) * 3)
 
+/* Transport layer for encrypted chats: messages typed in quick succession
+ * are sent as one frame, long messages are split into fragments. */
+#define FRAG_PAYLOAD_SIZE 160
+#define FRAG_MAX_COUNT 8
+#define TRANSPORT_MSG_MAX (FRAG_PAYLOAD_SIZE * FRAG_MAX_COUNT)
+#define REASSEMBLY_SLOTS 2
+
+/* Reassembly of a fragmented message from one sender. */
+typedef struct {
+    bool used;
+    uint64_t run_id;
+    uint8_t msg_id;
+    uint8_t frag_count;
+    uint8_t frags_received;
+    uint8_t nacks_sent;
+    uint32_t last_rx;
+    size_t msg_len;
+    char msg[TRANSPORT_MSG_MAX + 1];
+} ESubGhzChatReassembly;
+
 typedef struct {
     SceneManager* scene_manager;
     ViewDispatcher* view_dispatcher;
@@ -73,12 +93,24 @@ typedef struct {
     bool encrypted;
     ESubGhzChatCryptoCtx* crypto_ctx;
 
-    // RX and TX buffers
-    uint8_t rx_buffer[RX_TX_BUFFER_SIZE];
+    // RX and TX buffers, messages are decrypted and encrypted in place, the
+    // extra RX byte holds the terminator of the received string
+    uint8_t rx_buffer[RX_TX_BUFFER_SIZE + 1];
     uint8_t tx_buffer[RX_TX_BUFFER_SIZE];
-    char rx_str_buffer[RX_TX_BUFFER_SIZE + 1];
     volatile uint32_t last_time_rx_data;
 
+    // transport layer, messages waiting for the batch window and the
+    // message being transmitted, kept for selective retransmission
+    FuriString* tx_batch;
+    uint32_t tx_batch_tick;
+    char tx_msg[TRANSPORT_MSG_MAX];
+    size_t tx_msg_len;
+    uint8_t tx_msg_id;
+    uint8_t tx_frag_count;
+    uint8_t tx_frags_pending;
+    uint32_t tx_last_tick;
+    ESubGhzChatReassembly reassembly[REASSEMBLY_SLOTS];
+
     // for locking
     ViewPortDrawCallback orig_draw_cb;
     ViewPortInputCallback orig_input_cb;
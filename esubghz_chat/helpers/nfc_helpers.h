@@ -14,11 +14,8 @@ struct FreqNfcEntry {
     uint32_t unused3;
 } __attribute__((packed));
 
-struct ReplayDictNfcEntry {
-    uint64_t run_id;
-    uint32_t counter;
-    uint32_t unused;
-} __attribute__((packed));
+/* The replay dict follows the frequency entry as an array of
+ * struct ESubGhzChatReplaySnapshotEntry. */
 
 #ifdef __cplusplus
 }
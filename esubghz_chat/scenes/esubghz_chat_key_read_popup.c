@@ -36,27 +36,6 @@ static void key_read_popup_timeout_cb(void* context) {
     }
 }
 
-struct ReplayDictNfcReaderContext {
-    uint8_t* cur;
-    uint8_t* max;
-};
-
-static bool replay_dict_nfc_reader(uint64_t* run_id, uint32_t* counter, void* context) {
-    struct ReplayDictNfcReaderContext* ctx = (struct ReplayDictNfcReaderContext*)context;
-
-    if(ctx->cur + sizeof(struct ReplayDictNfcEntry) > ctx->max) {
-        return false;
-    }
-
-    struct ReplayDictNfcEntry* entry = (struct ReplayDictNfcEntry*)ctx->cur;
-    *run_id = entry->run_id;
-    *counter = __ntohl(entry->counter);
-
-    ctx->cur += sizeof(struct ReplayDictNfcEntry);
-
-    return true;
-}
-
 static bool key_read_popup_handle_key_read(ESubGhzChatState* state) {
     NfcDeviceData* dev_data = state->nfc_dev_data;
 
@@ -92,12 +71,14 @@ static bool key_read_popup_handle_key_read(ESubGhzChatState* state) {
     }
 
     /* read the replay dict */
-    struct ReplayDictNfcReaderContext rd_ctx = {
-        .cur = dev_data->mf_ul_data.data + (KEY_BITS / 8) + sizeof(struct FreqNfcEntry),
-        .max =
-            dev_data->mf_ul_data.data + (data_read < NFC_MAX_BYTES ? data_read : NFC_MAX_BYTES)};
-
-    crypto_ctx_read_replay_dict(state->crypto_ctx, replay_dict_nfc_reader, &rd_ctx);
+    size_t replay_offset = (KEY_BITS / 8) + sizeof(struct FreqNfcEntry);
+    size_t replay_end = (data_read < NFC_MAX_BYTES ? data_read : NFC_MAX_BYTES);
+    if(replay_end > replay_offset) {
+        crypto_ctx_read_replay_dict(
+            state->crypto_ctx,
+            dev_data->mf_ul_data.data + replay_offset,
+            replay_end - replay_offset);
+    }
 
     /* set encrypted flag */
     state->encrypted = true;
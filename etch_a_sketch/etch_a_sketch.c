@@ -6,6 +6,8 @@
 #include <input/input.h>
 #include <notification/notification.h>
 #include <notification/notification_messages.h>
+#include <storage/storage.h>
+#include <dialogs/dialogs.h>
 #include <stdbool.h> // Header-file for boolean data-type.
 #include <stdio.h>
 #include <string.h>
@@ -15,6 +17,17 @@
 
 #define WIDTH 64
 #define HEIGHT 32
+// The board is packed one bit per cell, MSB first like a PBM row
+#define BOARD_ROW_BYTES (WIDTH / 8)
+#define BOARD_BYTES (BOARD_ROW_BYTES * HEIGHT)
+// Every cell is brush_size x brush_size pixels of the screen bitmap, which is XBM (LSB first)
+#define SCREEN_WIDTH 128
+#define SCREEN_HEIGHT 64
+#define SCREEN_ROW_BYTES (SCREEN_WIDTH / 8)
+
+#define UNDO_LEVELS 8
+#define SKETCH_EXTENSION ".pbm"
+#define SKETCH_MAX 1000
 
 const int brush_size = 2;
 
@@ -23,12 +36,29 @@ typedef struct selected_position {
     int y;
 } selected_position;
 
+typedef enum {
+    MenuUndo,
+    MenuSave,
+    MenuLoad,
+    MenuCount,
+} MenuItem;
+
+const char* const menu_items[MenuCount] = {"Undo", "Save", "Load"};
+
 typedef struct {
     FuriMutex* mutex;
     selected_position selected;
-    bool board[64][32];
+    uint8_t board[BOARD_BYTES];
+    // rows of the board that changed since the screen bitmap was last updated
+    uint32_t dirty_rows;
+    uint8_t screen[SCREEN_ROW_BYTES * SCREEN_HEIGHT];
+    uint8_t undo[UNDO_LEVELS][BOARD_BYTES];
+    uint8_t undo_head;
+    uint8_t undo_count;
     bool isDrawing;
     bool showWelcome;
+    bool showMenu;
+    uint8_t menuIndex;
 } EtchData;
 
 // Sequence to indicate that drawing is enabled.
@@ -85,9 +115,150 @@ const NotificationSequence sequence_cleanup = {
     NULL,
 };
 
+static bool etch_get(const uint8_t* board, int x, int y) {
+    return board[y * BOARD_ROW_BYTES + x / 8] & (0x80 >> (x % 8));
+}
+
+static void etch_set(EtchData* etch_state, int x, int y, bool value) {
+    uint8_t* byte = &etch_state->board[y * BOARD_ROW_BYTES + x / 8];
+    if(value) {
+        *byte |= 0x80 >> (x % 8);
+    } else {
+        *byte &= ~(0x80 >> (x % 8));
+    }
+    etch_state->dirty_rows |= 1UL << y;
+}
+
+static void etch_clear(EtchData* etch_state) {
+    memset(etch_state->board, 0, BOARD_BYTES);
+    etch_state->dirty_rows = UINT32_MAX;
+}
+
+// Expands the changed board rows into the screen bitmap
+static void etch_update_screen(EtchData* etch_state) {
+    for(int y = 0; y < HEIGHT && etch_state->dirty_rows; y++) {
+        if(!(etch_state->dirty_rows & (1UL << y))) continue;
+        etch_state->dirty_rows &= ~(1UL << y);
+
+        uint8_t* row = &etch_state->screen[y * brush_size * SCREEN_ROW_BYTES];
+        memset(row, 0, SCREEN_ROW_BYTES);
+        for(int x = 0; x < WIDTH; x++) {
+            if(etch_get(etch_state->board, x, y)) {
+                int pixel = x * brush_size;
+                row[pixel / 8] |= 0x3 << (pixel % 8);
+            }
+        }
+        for(int i = 1; i < brush_size; i++) {
+            memcpy(row + i * SCREEN_ROW_BYTES, row, SCREEN_ROW_BYTES);
+        }
+    }
+}
+
+// Remembers the board before a change, the oldest level is dropped when all are used
+static void etch_push_undo(EtchData* etch_state) {
+    memcpy(etch_state->undo[etch_state->undo_head], etch_state->board, BOARD_BYTES);
+    etch_state->undo_head = (etch_state->undo_head + 1) % UNDO_LEVELS;
+    if(etch_state->undo_count < UNDO_LEVELS) etch_state->undo_count++;
+}
+
+static bool etch_pop_undo(EtchData* etch_state) {
+    if(etch_state->undo_count == 0) return false;
+    etch_state->undo_head = (etch_state->undo_head + UNDO_LEVELS - 1) % UNDO_LEVELS;
+    etch_state->undo_count--;
+    memcpy(etch_state->board, etch_state->undo[etch_state->undo_head], BOARD_BYTES);
+    etch_state->dirty_rows = UINT32_MAX;
+    return true;
+}
+
+// Drawings are saved as binary PBM (P4), one row of 64 cells is 8 bytes
+static bool etch_save(EtchData* etch_state, Storage* storage) {
+    storage_simply_mkdir(storage, STORAGE_APP_DATA_PATH_PREFIX);
+    FuriString* path = furi_string_alloc();
+    bool saved = false;
+
+    // the first free sketch_NNN.pbm
+    for(int i = 0; i < SKETCH_MAX; i++) {
+        furi_string_printf(
+            path, "%s/sketch_%03d%s", STORAGE_APP_DATA_PATH_PREFIX, i, SKETCH_EXTENSION);
+        if(!storage_file_exists(storage, furi_string_get_cstr(path))) {
+            File* file = storage_file_alloc(storage);
+            if(storage_file_open(
+                   file, furi_string_get_cstr(path), FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+                char header[16];
+                int len = snprintf(header, sizeof(header), "P4\n%d %d\n", WIDTH, HEIGHT);
+                saved = storage_file_write(file, header, len) == (size_t)len &&
+                        storage_file_write(file, etch_state->board, BOARD_BYTES) == BOARD_BYTES;
+            }
+            storage_file_close(file);
+            storage_file_free(file);
+            break;
+        }
+    }
+
+    furi_string_free(path);
+    return saved;
+}
+
+// Reads a decimal number of a PBM header, skipping whitespace and comments
+static bool pbm_read_number(File* file, int* value) {
+    char c;
+    *value = -1;
+    while(storage_file_read(file, &c, 1) == 1) {
+        if(c == '#') {
+            while(storage_file_read(file, &c, 1) == 1 && c != '\n') {
+            }
+        } else if(c >= '0' && c <= '9') {
+            *value = (*value < 0 ? 0 : *value * 10) + (c - '0');
+        } else if(*value >= 0) {
+            // the single whitespace after the last number ends the header
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool etch_load(EtchData* etch_state, Storage* storage, const char* path) {
+    File* file = storage_file_alloc(storage);
+    uint8_t board[BOARD_BYTES];
+    bool loaded = false;
+
+    do {
+        if(!storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) break;
+        char magic[2];
+        if(storage_file_read(file, magic, 2) != 2 || magic[0] != 'P' || magic[1] != '4') break;
+        int width, height;
+        if(!pbm_read_number(file, &width) || !pbm_read_number(file, &height)) break;
+        if(width != WIDTH || height != HEIGHT) break;
+        if(storage_file_read(file, board, BOARD_BYTES) != BOARD_BYTES) break;
+        loaded = true;
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+
+    if(loaded) {
+        etch_push_undo(etch_state);
+        memcpy(etch_state->board, board, BOARD_BYTES);
+        etch_state->dirty_rows = UINT32_MAX;
+    }
+    return loaded;
+}
+
+static bool etch_select_file(FuriString* path) {
+    DialogsFileBrowserOptions browser_options;
+    dialog_file_browser_set_basic_options(&browser_options, SKETCH_EXTENSION, &I_etch_10px);
+    browser_options.base_path = STORAGE_APP_DATA_PATH_PREFIX;
+    furi_string_set(path, STORAGE_APP_DATA_PATH_PREFIX);
+
+    DialogsApp* dialogs = furi_record_open(RECORD_DIALOGS);
+    bool selected = dialog_file_browser_show(dialogs, path, path, &browser_options);
+    furi_record_close(RECORD_DIALOGS);
+    return selected;
+}
+
 void etch_draw_callback(Canvas* canvas, void* ctx) {
     furi_assert(ctx);
-    const EtchData* etch_state = ctx;
+    EtchData* etch_state = ctx;
     furi_mutex_acquire(etch_state->mutex, FuriWaitForever);
 
     canvas_clear(canvas);
@@ -119,14 +290,9 @@ void etch_draw_callback(Canvas* canvas, void* ctx) {
     }
 
     canvas_set_color(canvas, ColorBlack);
-    //draw the canvas(64x32) on screen(144x64) using brush_size*brush_size tiles
-    for(int y = 0; y < 32; y++) {
-        for(int x = 0; x < 64; x++) {
-            if(etch_state->board[x][y]) {
-                canvas_draw_box(canvas, x * brush_size, y * brush_size, 2, 2);
-            }
-        }
-    }
+    //draw the canvas(64x32) on screen(128x64), only the rows that changed are expanded again
+    etch_update_screen(etch_state);
+    canvas_draw_xbm(canvas, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, etch_state->screen);
 
     //draw cursor as a brush_size by brush_size black box
     canvas_set_color(canvas, ColorBlack);
@@ -137,6 +303,18 @@ void etch_draw_callback(Canvas* canvas, void* ctx) {
         brush_size,
         brush_size);
 
+    if(etch_state->showMenu) {
+        canvas_set_color(canvas, ColorWhite);
+        canvas_draw_box(canvas, 84, 18, 40, 34);
+        canvas_set_color(canvas, ColorBlack);
+        canvas_draw_frame(canvas, 84, 18, 40, 34);
+        canvas_set_font(canvas, FontSecondary);
+        for(uint8_t i = 0; i < MenuCount; i++) {
+            if(i == etch_state->menuIndex) canvas_draw_str(canvas, 88, 28 + i * 10, ">");
+            canvas_draw_str(canvas, 95, 28 + i * 10, menu_items[i]);
+        }
+    }
+
     //release the mutex
     furi_mutex_release(etch_state->mutex);
 }
@@ -152,6 +330,7 @@ int32_t etch_a_sketch_app(void* p) {
     FuriMessageQueue* event_queue = furi_message_queue_alloc(8, sizeof(InputEvent));
 
     EtchData* etch_state = malloc(sizeof(EtchData));
+    memset(etch_state, 0, sizeof(EtchData));
     etch_state->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
     if(!etch_state->mutex) {
         FURI_LOG_E("etch", "cannot create mutex\r\n");
@@ -169,6 +348,8 @@ int32_t etch_a_sketch_app(void* p) {
     gui_add_view_port(gui, view_port, GuiLayerFullscreen);
 
     NotificationApp* notification = furi_record_open(RECORD_NOTIFICATION);
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    FuriString* path = furi_string_alloc();
 
     InputEvent event;
 
@@ -176,21 +357,66 @@ int32_t etch_a_sketch_app(void* p) {
     etch_state->showWelcome = true;
 
     while(furi_message_queue_get(event_queue, &event, FuriWaitForever) == FuriStatusOk) {
-        //break out of the loop if the back key is pressed
+        furi_mutex_acquire(etch_state->mutex, FuriWaitForever);
+
+        if(etch_state->showMenu) {
+            bool exit = false;
+            if(event.type == InputTypeShort) {
+                switch(event.key) {
+                case InputKeyUp:
+                    etch_state->menuIndex = (etch_state->menuIndex + MenuCount - 1) % MenuCount;
+                    break;
+                case InputKeyDown:
+                    etch_state->menuIndex = (etch_state->menuIndex + 1) % MenuCount;
+                    break;
+                case InputKeyBack:
+                    // back twice leaves the app
+                    exit = true;
+                    break;
+                case InputKeyOk: {
+                    bool done = false;
+                    etch_state->showMenu = false;
+                    if(etch_state->menuIndex == MenuUndo) {
+                        done = etch_pop_undo(etch_state);
+                    } else if(etch_state->menuIndex == MenuSave) {
+                        done = etch_save(etch_state, storage);
+                    } else {
+                        // the file browser takes over the screen, the board stays unlocked
+                        furi_mutex_release(etch_state->mutex);
+                        bool selected = etch_select_file(path);
+                        furi_mutex_acquire(etch_state->mutex, FuriWaitForever);
+                        if(selected) {
+                            done = etch_load(etch_state, storage, furi_string_get_cstr(path));
+                        }
+                    }
+                    notification_message(notification, done ? &sequence_success : &sequence_error);
+                    break;
+                }
+                default:
+                    etch_state->showMenu = false;
+                    break;
+                }
+            }
+            furi_mutex_release(etch_state->mutex);
+            if(exit) break;
+            view_port_update(view_port);
+            continue;
+        }
+
+        //open the menu if the back key is pressed
         if(event.key == InputKeyBack && event.type == InputTypeShort) {
-            break;
+            etch_state->showWelcome = false;
+            etch_state->showMenu = true;
+            etch_state->menuIndex = MenuUndo;
+            view_port_update(view_port);
         }
 
         // Clear
         // TODO: Do animation of shaking board
         if(event.key == InputKeyBack && event.type == InputTypeLong) {
             etch_state->showWelcome = false;
-            etch_state->board[1][1] = true;
-            for(int y = 0; y < 32; y++) {
-                for(int x = 0; x < 64; x++) {
-                    etch_state->board[x][y] = false;
-                }
-            }
+            etch_push_undo(etch_state);
+            etch_clear(etch_state);
             view_port_update(view_port);
         }
 
@@ -203,8 +429,12 @@ int32_t etch_a_sketch_app(void* p) {
 
         // Single Dot Select
         if(event.key == InputKeyOk && event.type == InputTypeShort) {
-            etch_state->board[etch_state->selected.x][etch_state->selected.y] =
-                !etch_state->board[etch_state->selected.x][etch_state->selected.y];
+            etch_push_undo(etch_state);
+            etch_set(
+                etch_state,
+                etch_state->selected.x,
+                etch_state->selected.y,
+                !etch_get(etch_state->board, etch_state->selected.x, etch_state->selected.y));
         }
 
         // Start Drawing
@@ -215,10 +445,13 @@ int32_t etch_a_sketch_app(void* p) {
             if(etch_state->isDrawing) {
                 // We're ending the drawing
                 notification_message(notification, &sequence_end_draw);
+            } else {
+                // a whole stroke is undone at once
+                etch_push_undo(etch_state);
             }
 
             etch_state->isDrawing = !etch_state->isDrawing;
-            etch_state->board[etch_state->selected.x][etch_state->selected.y] = true;
+            etch_set(etch_state, etch_state->selected.x, etch_state->selected.y, true);
 
             view_port_update(view_port);
         }
@@ -257,10 +490,12 @@ int32_t etch_a_sketch_app(void* p) {
                 etch_state->selected.y = 31;
             }
             if(etch_state->isDrawing == true) {
-                etch_state->board[etch_state->selected.x][etch_state->selected.y] = true;
+                etch_set(etch_state, etch_state->selected.x, etch_state->selected.y, true);
             }
             view_port_update(view_port);
         }
+
+        furi_mutex_release(etch_state->mutex);
     }
 
     notification_message(notification, &sequence_cleanup);
@@ -268,6 +503,8 @@ int32_t etch_a_sketch_app(void* p) {
     view_port_free(view_port);
     furi_mutex_free(etch_state->mutex);
     furi_message_queue_free(event_queue);
+    furi_string_free(path);
+    furi_record_close(RECORD_STORAGE);
     furi_record_close(RECORD_NOTIFICATION);
     furi_record_close(RECORD_GUI);
     free(etch_state);
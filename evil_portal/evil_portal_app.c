@@ -73,8 +73,7 @@ Evil_PortalApp* evil_portal_app_alloc() {
     app->text_box = text_box_alloc();
     view_dispatcher_add_view(
         app->view_dispatcher, Evil_PortalAppViewConsoleOutput, text_box_get_view(app->text_box));
-    app->text_box_store = furi_string_alloc();
-    furi_string_reserve(app->text_box_store, EVIL_PORTAL_TEXT_BOX_STORE_SIZE);
+    app->text_box_store = text_box_store_alloc(EVIL_PORTAL_TEXT_BOX_STORE_SIZE);
 
     scene_manager_next_scene(app->scene_manager, Evil_PortalSceneStart);
 
@@ -99,7 +98,7 @@ void evil_portal_app_free(Evil_PortalApp* app) {
     view_dispatcher_remove_view(app->view_dispatcher, Evil_PortalAppViewConsoleOutput);
 
     text_box_free(app->text_box);
-    furi_string_free(app->text_box_store);
+    text_box_store_free(app->text_box_store);
     text_input_free(app->text_input);
 
     view_stack_free(app->view_stack);
@@ -110,6 +109,7 @@ void evil_portal_app_free(Evil_PortalApp* app) {
     scene_manager_free(app->scene_manager);
 
     evil_portal_uart_free(app->uart);
+    evil_portal_free_index_html(app);
 
     // Close records
     furi_record_close(RECORD_GUI);
@@ -3,6 +3,7 @@
 #include "evil_portal_app.h"
 #include "evil_portal_custom_event.h"
 #include "evil_portal_uart.h"
+#include "helpers/text_box_store.h"
 #include "scenes/evil_portal_scene.h"
 #include "evil_portal_icons.h"
 
@@ -38,8 +39,7 @@ struct Evil_PortalApp {
     int command_index;
     bool has_command_queue;
 
-    FuriString* text_box_store;
-    size_t text_box_store_strlen;
+    TextBoxStore* text_box_store;
     TextBox* text_box;
 
     VariableItemList* var_item_list;
@@ -63,7 +63,9 @@ struct Evil_PortalApp {
     int BAUDRATE;
     char text_store[2][128 + 1];
 
+    // index.html stays loaded for the session, until another portal is selected
     uint8_t* index_html;
+    size_t index_html_size;
     uint8_t* ap_name;
 };
 
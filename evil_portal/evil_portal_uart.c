@@ -1,11 +1,12 @@
 #include "evil_portal_app_i.h"
 #include "evil_portal_uart.h"
+#include "helpers/uart_dma.h"
 #include "helpers/evil_portal_storage.h"
 
 struct Evil_PortalUart {
     Evil_PortalApp* app;
     FuriThread* rx_thread;
-    FuriStreamBuffer* rx_stream;
+    UartDma* rx_dma;
     uint8_t rx_buf[RX_BUF_SIZE + 1];
     void (*handle_rx_data_cb)(uint8_t* buf, size_t len, void* context);
 };
@@ -24,15 +25,6 @@ void evil_portal_uart_set_handle_rx_data_cb(
 
 #define WORKER_ALL_RX_EVENTS (WorkerEvtStop | WorkerEvtRxDone)
 
-void evil_portal_uart_on_irq_cb(UartIrqEvent ev, uint8_t data, void* context) {
-    Evil_PortalUart* uart = (Evil_PortalUart*)context;
-
-    if(ev == UartIrqEventRXNE) {
-        furi_stream_buffer_send(uart->rx_stream, &data, 1, 0);
-        furi_thread_flags_set(furi_thread_get_id(uart->rx_thread), WorkerEvtRxDone);
-    }
-}
-
 static int32_t uart_worker(void* context) {
     Evil_PortalUart* uart = (void*)context;
 
@@ -42,7 +34,7 @@ static int32_t uart_worker(void* context) {
         furi_check((events & FuriFlagError) == 0);
         if(events & WorkerEvtStop) break;
         if(events & WorkerEvtRxDone) {
-            size_t len = furi_stream_buffer_receive(uart->rx_stream, uart->rx_buf, RX_BUF_SIZE, 0);
+            size_t len = uart_dma_receive(uart->rx_dma, uart->rx_buf, RX_BUF_SIZE);
 
             if(len > 0) {
                 if(uart->handle_rx_data_cb) {
@@ -99,8 +91,8 @@ static int32_t uart_worker(void* context) {
         }
     }
 
-    furi_hal_uart_set_irq_cb(UART_CH, NULL, NULL);
-    furi_stream_buffer_free(uart->rx_stream);
+    uart_dma_stop(uart->rx_dma);
+    uart_dma_free(uart->rx_dma);
 
     return 0;
 }
@@ -109,11 +101,23 @@ void evil_portal_uart_tx(uint8_t* data, size_t len) {
     furi_hal_uart_tx(UART_CH, data, len);
 }
 
+// Large payloads go out a chunk at a time with a yield in between, so the rx worker
+// keeps draining replies from the board while a portal is being sent
+void evil_portal_uart_tx_chunked(uint8_t* data, size_t len) {
+    while(len > 0) {
+        size_t chunk = MIN(len, (size_t)TX_CHUNK_SIZE);
+        furi_hal_uart_tx(UART_CH, data, chunk);
+        data += chunk;
+        len -= chunk;
+        furi_thread_yield();
+    }
+}
+
 Evil_PortalUart* evil_portal_uart_init(Evil_PortalApp* app) {
     Evil_PortalUart* uart = malloc(sizeof(Evil_PortalUart));
     uart->app = app;
     // Init all rx stream and thread early to avoid crashes
-    uart->rx_stream = furi_stream_buffer_alloc(RX_BUF_SIZE, 1);
+    uart->rx_dma = uart_dma_alloc(RX_BUF_SIZE);
     uart->rx_thread = furi_thread_alloc();
     furi_thread_set_name(uart->rx_thread, "Evil_PortalUartRxThread");
     furi_thread_set_stack_size(uart->rx_thread, 1024);
@@ -133,7 +137,7 @@ Evil_PortalUart* evil_portal_uart_init(Evil_PortalApp* app) {
         app->BAUDRATE = 115200;
     }
     furi_hal_uart_set_br(UART_CH, app->BAUDRATE);
-    furi_hal_uart_set_irq_cb(UART_CH, evil_portal_uart_on_irq_cb, uart);
+    uart_dma_start(uart->rx_dma, UART_CH, furi_thread_get_id(uart->rx_thread), WorkerEvtRxDone);
 
     evil_portal_uart_tx((uint8_t*)("XFW#EVILPORTAL=1\n"), strlen("XFW#EVILPORTAL=1\n"));
 
@@ -10,6 +10,12 @@ static void evil_portal_close_storage() {
 
 void evil_portal_read_index_html(void* context) {
     Evil_PortalApp* app = context;
+
+    // Already loaded this session
+    if(app->index_html) {
+        return;
+    }
+
     Storage* storage = evil_portal_open_storage();
     FileInfo fi;
 
@@ -23,31 +29,45 @@ void evil_portal_read_index_html(void* context) {
         File* index_html = storage_file_alloc(storage);
         if(storage_file_open(
                index_html, EVIL_PORTAL_INDEX_SAVE_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
-            app->index_html = malloc((size_t)fi.size);
+            app->index_html = malloc((size_t)fi.size + 1);
             uint8_t* buf_ptr = app->index_html;
             size_t read = 0;
             while(read < fi.size) {
                 size_t to_read = fi.size - read;
                 if(to_read > UINT16_MAX) to_read = UINT16_MAX;
                 uint16_t now_read = storage_file_read(index_html, buf_ptr, (uint16_t)to_read);
+                if(now_read == 0) break;
                 read += now_read;
                 buf_ptr += now_read;
             }
-            free(buf_ptr);
+            *buf_ptr = '\0';
+            app->index_html_size = read;
         }
         storage_file_close(index_html);
         storage_file_free(index_html);
-    } else {
+    }
+
+    if(!app->index_html) {
         char* html_error = "<b>Evil portal</b><br>Unable to read the html file.<br>"
                            "Is the SD Card set up correctly? <br>See instructions @ "
                            "github.com/bigbrodude6119/flipper-zero-evil-portal<br>"
                            "Under the 'Install pre-built app on the flipper' section.";
-        app->index_html = (uint8_t*)html_error;
+        app->index_html = (uint8_t*)strdup(html_error);
+        app->index_html_size = strlen(html_error);
     }
 
     evil_portal_close_storage();
 }
 
+void evil_portal_free_index_html(void* context) {
+    Evil_PortalApp* app = context;
+    if(app->index_html) {
+        free(app->index_html);
+        app->index_html = NULL;
+        app->index_html_size = 0;
+    }
+}
+
 void evil_portal_replace_index_html(FuriString* path) {
     Storage* storage = evil_portal_open_storage();
     FS_Error error;
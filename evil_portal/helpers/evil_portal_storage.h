@@ -14,6 +14,7 @@
 #define EVIL_PORTAL_LOG_SAVE_PATH PORTAL_FILE_DIRECTORY_PATH "/logs"
 
 void evil_portal_read_index_html(void* context);
+void evil_portal_free_index_html(void* context);
 void evil_portal_read_ap_name(void* context);
 void evil_portal_write_ap_name(void* context);
 void evil_portal_replace_index_html(FuriString* path);
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <furi.h>
+#include <gui/modules/text_box.h>
+
+/**
+ * Fixed size console store for a TextBox.
+ *
+ * Text is appended to a ring buffer that drops the oldest whole lines once full, so long
+ * sessions never move the kept text around. The TextBox is only handed a fresh copy when
+ * text_box_store_update() is called, which the console scenes do from the tick event.
+ */
+typedef struct TextBoxStore TextBoxStore;
+
+TextBoxStore* text_box_store_alloc(size_t size);
+
+void text_box_store_free(TextBoxStore* store);
+
+void text_box_store_reset(TextBoxStore* store);
+
+/** Safe to call from any thread, NUL bytes are skipped */
+void text_box_store_append(TextBoxStore* store, const char* data, size_t len);
+
+void text_box_store_append_str(TextBoxStore* store, const char* str);
+
+bool text_box_store_is_empty(TextBoxStore* store);
+
+/** Set the stored text on the TextBox */
+void text_box_store_show(TextBoxStore* store, TextBox* text_box);
+
+/** Set the stored text on the TextBox if anything was appended since it was last shown
+ *
+ * @return true if the TextBox was updated
+ */
+bool text_box_store_update(TextBoxStore* store, TextBox* text_box);
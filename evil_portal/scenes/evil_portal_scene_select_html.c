@@ -35,6 +35,9 @@ void evil_portal_scene_select_html_on_enter(void* context) {
         //Replace HTML File
         evil_portal_show_loading_popup(app, true);
         evil_portal_replace_index_html(app->file_path);
+        evil_portal_free_index_html(app);
+        // Load the new portal now, so starting it does not wait on the SD card
+        evil_portal_read_index_html(app);
         evil_portal_show_loading_popup(app, false);
     }
 
@@ -1,10 +1,12 @@
 #include "flipbip_file.h"
 #include <storage/storage.h>
 #include <loader/loader.h>
+#include <furi_hal_crypto.h>
 #include "../helpers/flipbip_string.h"
 // From: lib/crypto
 #include <memzero.h>
 #include <rand.h>
+#include <sha2.h>
 
 // #define FLIPBIP_APP_BASE_FOLDER APP_DATA_PATH("flipbip")
 #define FLIPBIP_APP_BASE_FOLDER EXT_PATH("apps_data/flipbip")
@@ -19,6 +21,8 @@
 #define FLIPBIP_DAT_PATH_BAK FLIPBIP_APP_BASE_FOLDER_PATH(FLIPBIP_DAT_FILE_NAME_BAK)
 #define FLIPBIP_KEY_PATH FLIPBIP_APP_BASE_FOLDER_PATH(FLIPBIP_KEY_FILE_NAME)
 #define FLIPBIP_KEY_PATH_BAK FLIPBIP_APP_BASE_FOLDER_PATH(FLIPBIP_KEY_FILE_NAME_BAK)
+#define FLIPBIP_SEED_FILE_NAME ".flipbip.seed"
+#define FLIPBIP_SEED_PATH FLIPBIP_APP_BASE_FOLDER_PATH(FLIPBIP_SEED_FILE_NAME)
 
 const char* TEXT_QRFILE = "Filetype: QRCode\n"
                           "Version: 0\n"
@@ -29,6 +33,12 @@ const char* TEXT_QRFILE = "Filetype: QRCode\n"
 #define FILE_MAX_PATH_LEN 48
 #define FILE_MAX_QRFILE_CONTENT 90
 const char* FILE_HSTR = "fb01";
+// seed cache: header, iv, encrypted (check digest, seed)
+const char* SEED_HSTR = "fbsd";
+#define SEED_IVLEN 16
+#define SEED_CHECKLEN SHA256_DIGEST_LENGTH
+#define SEED_LEN 64
+#define SEED_DLEN (SEED_CHECKLEN + SEED_LEN) // multiple of the AES block size
 const char* FILE_K1 = "fb0131d5cf688221c109163908ebe51debb46227c6cc8b37641910833222772a"
                       "baefe6d9ceb651842260e0d1e05e3b90d15e7d5ffaaabc0207bf200a117793a2";
 
@@ -265,6 +275,9 @@ bool flipbip_save_file_secure(const char* settings) {
     size_t len = strlen(settings);
     if(len > (FILE_SLEN / 2)) len = FILE_SLEN / 2;
 
+    // the cached seed belongs to the mnemonic being replaced
+    flipbip_remove_seed_cache();
+
     // allocate memory for key/data
     char* data = malloc(dlen);
     memzero(data, dlen);
@@ -312,3 +325,103 @@ bool flipbip_save_file_secure(const char* settings) {
 
     return true;
 }
+
+// binds the cached seed to the mnemonic and passphrase it was derived from
+static void flipbip_seed_check(const char* mnemonic, const char* passphrase, uint8_t* check) {
+    SHA256_CTX ctx;
+    sha256_Init(&ctx);
+    // include the null terminator to separate mnemonic and passphrase
+    sha256_Update(&ctx, (const uint8_t*)mnemonic, strlen(mnemonic) + 1);
+    sha256_Update(&ctx, (const uint8_t*)passphrase, strlen(passphrase));
+    sha256_Final(&ctx, check);
+    memzero(&ctx, sizeof(ctx));
+}
+
+bool flipbip_load_seed_cache(uint8_t* seed, const char* mnemonic, const char* passphrase) {
+    bool ret = false;
+    uint8_t header[FILE_HLEN + SEED_IVLEN] = {0};
+    uint8_t encrypted[SEED_DLEN] = {0};
+    uint8_t data[SEED_DLEN] = {0};
+    uint8_t check[SEED_CHECKLEN] = {0};
+
+    Storage* fs_api = furi_record_open(RECORD_STORAGE);
+    File* seed_file = storage_file_alloc(fs_api);
+    bool loaded = false;
+    if(storage_file_open(seed_file, FLIPBIP_SEED_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        loaded = storage_file_read(seed_file, header, sizeof(header)) == sizeof(header) &&
+                 storage_file_read(seed_file, encrypted, sizeof(encrypted)) == sizeof(encrypted) &&
+                 memcmp(header, SEED_HSTR, FILE_HLEN) == 0;
+    }
+    storage_file_close(seed_file);
+    storage_file_free(seed_file);
+    furi_record_close(RECORD_STORAGE);
+
+    const uint8_t* iv = header + FILE_HLEN;
+    if(loaded && furi_hal_crypto_enclave_load_key(FURI_HAL_CRYPTO_ENCLAVE_UNIQUE_KEY_SLOT, iv)) {
+        bool decrypted = furi_hal_crypto_decrypt(encrypted, data, SEED_DLEN);
+        furi_hal_crypto_enclave_unload_key(FURI_HAL_CRYPTO_ENCLAVE_UNIQUE_KEY_SLOT);
+
+        // a different mnemonic or passphrase, or a file from another device, won't match
+        flipbip_seed_check(mnemonic, passphrase, check);
+        if(decrypted && memcmp(data, check, SEED_CHECKLEN) == 0) {
+            memcpy(seed, data + SEED_CHECKLEN, SEED_LEN);
+            ret = true;
+        }
+    }
+
+    // clear memory
+    memzero(data, sizeof(data));
+    memzero(check, sizeof(check));
+
+    return ret;
+}
+
+bool flipbip_save_seed_cache(const uint8_t* seed, const char* mnemonic, const char* passphrase) {
+    bool ret = false;
+    uint8_t header[FILE_HLEN + SEED_IVLEN] = {0};
+    uint8_t encrypted[SEED_DLEN] = {0};
+    uint8_t data[SEED_DLEN] = {0};
+
+    // fresh iv for every save
+    memcpy(header, SEED_HSTR, FILE_HLEN);
+    random_buffer(header + FILE_HLEN, SEED_IVLEN);
+
+    flipbip_seed_check(mnemonic, passphrase, data);
+    memcpy(data + SEED_CHECKLEN, seed, SEED_LEN);
+
+    bool encrypted_ok = false;
+    const uint8_t* iv = header + FILE_HLEN;
+    if(furi_hal_crypto_enclave_load_key(FURI_HAL_CRYPTO_ENCLAVE_UNIQUE_KEY_SLOT, iv)) {
+        encrypted_ok = furi_hal_crypto_encrypt(data, encrypted, SEED_DLEN);
+        furi_hal_crypto_enclave_unload_key(FURI_HAL_CRYPTO_ENCLAVE_UNIQUE_KEY_SLOT);
+    }
+    memzero(data, sizeof(data));
+
+    if(encrypted_ok) {
+        Storage* fs_api = furi_record_open(RECORD_STORAGE);
+        // try to create the folder
+        storage_simply_mkdir(fs_api, FLIPBIP_APP_BASE_FOLDER);
+
+        File* seed_file = storage_file_alloc(fs_api);
+        if(storage_file_open(seed_file, FLIPBIP_SEED_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+            ret = storage_file_write(seed_file, header, sizeof(header)) == sizeof(header) &&
+                  storage_file_write(seed_file, encrypted, sizeof(encrypted)) == sizeof(encrypted);
+        }
+        storage_file_close(seed_file);
+        storage_file_free(seed_file);
+
+        if(!ret) {
+            storage_simply_remove(fs_api, FLIPBIP_SEED_PATH);
+        }
+        furi_record_close(RECORD_STORAGE);
+    }
+
+    return ret;
+}
+
+bool flipbip_remove_seed_cache() {
+    Storage* fs_api = furi_record_open(RECORD_STORAGE);
+    bool ret = storage_simply_remove(fs_api, FLIPBIP_SEED_PATH);
+    furi_record_close(RECORD_STORAGE);
+    return ret;
+}
@@ -1,5 +1,6 @@
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 typedef enum {
     FlipBipFileDat,
@@ -26,3 +27,8 @@ bool flipbip_save_qrfile(
 
 bool flipbip_load_file_secure(char* settings);
 bool flipbip_save_file_secure(const char* settings);
+
+// BIP39 seed cache, encrypted with the device unique enclave key
+bool flipbip_load_seed_cache(uint8_t* seed, const char* mnemonic, const char* passphrase);
+bool flipbip_save_seed_cache(const uint8_t* seed, const char* mnemonic, const char* passphrase);
+bool flipbip_remove_seed_cache();
@@ -0,0 +1,113 @@
+#include "flipbip_precomp.h"
+#include <furi.h>
+#include <storage/storage.h>
+#include <string.h>
+// From: lib/crypto
+#include <ecdsa.h>
+#include <secp256k1.h>
+#include <sha2.h>
+
+#define FLIPBIP_PRECOMP_FOLDER EXT_PATH("apps_data/flipbip")
+#define FLIPBIP_PRECOMP_PATH FLIPBIP_PRECOMP_FOLDER "/secp256k1.cp"
+#define PRECOMP_HSTR "fbcp"
+#define PRECOMP_HLEN 4
+#define PRECOMP_ROWS 64
+#define PRECOMP_COLS 8
+#define PRECOMP_SIZE (sizeof(curve_point) * PRECOMP_ROWS * PRECOMP_COLS) // 36864 bytes
+// heap left for the rest of the app once the table is allocated
+#define PRECOMP_HEAP_RESERVE (16 * 1024)
+
+static curve_point (*s_precomp)[PRECOMP_COLS] = NULL;
+
+// cp[i][j] = (2*j+1) * 16^i * G, same layout as the compiled-in table
+static void flipbip_precomp_generate(curve_point (*cp)[PRECOMP_COLS]) {
+    curve_point base = {0};
+    curve_point twice = {0};
+    point_copy(&secp256k1.G, &base);
+    for(size_t i = 0; i < PRECOMP_ROWS; i++) {
+        point_copy(&base, &twice);
+        point_double(&secp256k1, &twice);
+        point_copy(&base, &cp[i][0]);
+        for(size_t j = 1; j < PRECOMP_COLS; j++) {
+            point_copy(&cp[i][j - 1], &cp[i][j]);
+            point_add(&secp256k1, &twice, &cp[i][j]);
+        }
+        // base = 16 * base
+        for(size_t d = 0; d < 4; d++) {
+            point_double(&secp256k1, &base);
+        }
+    }
+}
+
+static bool flipbip_precomp_read(Storage* fs_api, curve_point (*cp)[PRECOMP_COLS]) {
+    bool ret = false;
+    uint8_t header[PRECOMP_HLEN + SHA256_DIGEST_LENGTH] = {0};
+    uint8_t digest[SHA256_DIGEST_LENGTH] = {0};
+
+    File* file = storage_file_alloc(fs_api);
+    if(storage_file_open(file, FLIPBIP_PRECOMP_PATH, FSAM_READ, FSOM_OPEN_EXISTING) &&
+       storage_file_size(file) == sizeof(header) + PRECOMP_SIZE &&
+       storage_file_read(file, header, sizeof(header)) == sizeof(header) &&
+       memcmp(header, PRECOMP_HSTR, PRECOMP_HLEN) == 0 &&
+       storage_file_read(file, cp, PRECOMP_SIZE) == PRECOMP_SIZE) {
+        sha256_Raw((const uint8_t*)cp, PRECOMP_SIZE, digest);
+        ret = memcmp(digest, header + PRECOMP_HLEN, SHA256_DIGEST_LENGTH) == 0 &&
+              point_is_equal(&cp[0][0], &secp256k1.G);
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+
+    return ret;
+}
+
+static void flipbip_precomp_write(Storage* fs_api, const curve_point (*cp)[PRECOMP_COLS]) {
+    uint8_t header[PRECOMP_HLEN + SHA256_DIGEST_LENGTH] = {0};
+    memcpy(header, PRECOMP_HSTR, PRECOMP_HLEN);
+    sha256_Raw((const uint8_t*)cp, PRECOMP_SIZE, header + PRECOMP_HLEN);
+
+    // try to create the folder
+    storage_simply_mkdir(fs_api, FLIPBIP_PRECOMP_FOLDER);
+
+    bool written = false;
+    File* file = storage_file_alloc(fs_api);
+    if(storage_file_open(file, FLIPBIP_PRECOMP_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        written = storage_file_write(file, header, sizeof(header)) == sizeof(header) &&
+                  storage_file_write(file, cp, PRECOMP_SIZE) == PRECOMP_SIZE;
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+
+    // don't leave a truncated table behind, it would be regenerated on every load
+    if(!written) {
+        storage_simply_remove(fs_api, FLIPBIP_PRECOMP_PATH);
+    }
+}
+
+bool flipbip_precomp_load(void) {
+    if(s_precomp != NULL) return true;
+
+    // fall back to plain point multiplication if there is no room for the table
+    if(memmgr_heap_get_max_free_block() < PRECOMP_SIZE + PRECOMP_HEAP_RESERVE) return false;
+
+    curve_point (*cp)[PRECOMP_COLS] = malloc(PRECOMP_SIZE);
+
+    Storage* fs_api = furi_record_open(RECORD_STORAGE);
+    if(!flipbip_precomp_read(fs_api, cp)) {
+        flipbip_precomp_generate(cp);
+        flipbip_precomp_write(fs_api, (const curve_point(*)[PRECOMP_COLS])cp);
+    }
+    furi_record_close(RECORD_STORAGE);
+
+    s_precomp = cp;
+    ecdsa_set_precomputed_cp(&secp256k1, (const curve_point(*)[PRECOMP_COLS])s_precomp);
+
+    return true;
+}
+
+void flipbip_precomp_free(void) {
+    if(s_precomp == NULL) return;
+
+    ecdsa_set_precomputed_cp(&secp256k1, NULL);
+    free(s_precomp);
+    s_precomp = NULL;
+}
@@ -0,0 +1,6 @@
+#include <stdbool.h>
+
+// Registers the secp256k1 precomputed curve point table with lib/crypto.
+// The table is loaded from SD card, or generated and saved there if missing.
+bool flipbip_precomp_load(void);
+void flipbip_precomp_free(void);
@@ -530,12 +530,16 @@ int point_multiply(
     return 0;
 }
 
-#if USE_PRECOMPUTED_CP
+#if USE_PRECOMPUTED_CP || USE_PRECOMPUTED_CP_EXTERNAL
 
-// res = k * G
+// res = k * G using table cp[i][j] = (2*j+1) * 16^i * G
 // k must be a normalized number with 0 <= k < curve->order
 // returns 0 on success
-int scalar_multiply(const ecdsa_curve* curve, const bignum256* k, curve_point* res) {
+static int scalar_multiply_cp(
+    const ecdsa_curve* curve,
+    const curve_point (*cp)[8],
+    const bignum256* k,
+    curve_point* res) {
     if(!bn_is_less(k, &curve->order)) {
         return 1;
     }
@@ -592,7 +596,7 @@ int scalar_multiply(const ecdsa_curve* curve, const bignum256* k, curve_point* r
     lowbits = a.val[0] & ((1 << 5) - 1);
     lowbits ^= (lowbits >> 4) - 1;
     lowbits &= 15;
-    curve_to_jacobian(&curve->cp[0][lowbits >> 1], &jres, prime);
+    curve_to_jacobian(&cp[0][lowbits >> 1], &jres, prime);
     for(i = 1; i < 64; i++) {
         // invariant res = sign(a[i-1]) sum_{j=0..i-1} (a[j] * 16^j * G)
 
@@ -612,7 +616,7 @@ int scalar_multiply(const ecdsa_curve* curve, const bignum256* k, curve_point* r
         bn_cnegate(~lowbits & 1, &jres.y, prime);
 
         // add odd factor
-        point_jacobian_add(&curve->cp[i][lowbits >> 1], &jres, curve);
+        point_jacobian_add(&cp[i][lowbits >> 1], &jres, curve);
     }
     bn_cnegate(~(a.val[0] >> 4) & 1, &jres.y, prime);
     jacobian_to_curve(&jres, res, prime);
@@ -622,14 +626,34 @@ int scalar_multiply(const ecdsa_curve* curve, const bignum256* k, curve_point* r
     return 0;
 }
 
-#else
+#endif
 
-int scalar_multiply(const ecdsa_curve* curve, const bignum256* k, curve_point* res) {
-    return point_multiply(curve, k, &curve->G, res);
+#if USE_PRECOMPUTED_CP_EXTERNAL
+
+static const ecdsa_curve* external_cp_curve = NULL;
+static const curve_point (*external_cp)[8] = NULL;
+
+// cp must stay valid until replaced, NULL reverts curve to point_multiply
+void ecdsa_set_precomputed_cp(const ecdsa_curve* curve, const curve_point (*cp)[8]) {
+    external_cp_curve = cp ? curve : NULL;
+    external_cp = cp;
 }
 
 #endif
 
+int scalar_multiply(const ecdsa_curve* curve, const bignum256* k, curve_point* res) {
+#if USE_PRECOMPUTED_CP
+    return scalar_multiply_cp(curve, curve->cp, k, res);
+#else
+#if USE_PRECOMPUTED_CP_EXTERNAL
+    if(external_cp != NULL && external_cp_curve == curve) {
+        return scalar_multiply_cp(curve, external_cp, k, res);
+    }
+#endif
+    return point_multiply(curve, k, &curve->G, res);
+#endif
+}
+
 int ecdh_multiply(
     const ecdsa_curve* curve,
     const uint8_t* priv_key,
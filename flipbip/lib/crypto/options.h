@@ -28,6 +28,12 @@
 #define USE_PRECOMPUTED_CP 0
 #endif
 
+// allow the application to register a precomputed curve point table at runtime,
+// for example loaded from SD card, instead of compiling it into flash
+#ifndef USE_PRECOMPUTED_CP_EXTERNAL
+#define USE_PRECOMPUTED_CP_EXTERNAL 1
+#endif
+
 // use fast inverse method
 #ifndef USE_INVERSE_FAST
 #define USE_INVERSE_FAST 1
@@ -8,12 +8,16 @@
 //#include "flipbip_icons.h"
 #include "../helpers/flipbip_string.h"
 #include "../helpers/flipbip_file.h"
+#include "../helpers/flipbip_precomp.h"
 // From: /lib/crypto
 #include <memzero.h>
 #include <rand.h>
 #include <curves.h>
 #include <bip32.h>
 #include <bip39.h>
+#include <secp256k1.h>
+#include <sha2.h>
+#include <sha3.h>
 
 #define DERIV_PURPOSE 44
 #define DERIV_ACCOUNT 0
@@ -23,6 +27,8 @@
 #define MAX_TEXT_BUF (MAX_TEXT_LEN + 1) // max length of text + null terminator
 #define MAX_ADDR_BUF (42 + 1) // 42 = max length of address + null terminator
 #define NUM_ADDRS 6
+#define NUM_COINS 4
+#define FLIPBIP_SCENE_1_WORKER_STACK_SIZE (4 * 1024)
 
 #define PAGE_LOADING 0
 #define PAGE_INFO 1
@@ -70,6 +76,12 @@ struct FlipBipScene1 {
     View* view;
     FlipBipScene1Callback callback;
     void* context;
+    // Background wallet derivation
+    FuriThread* worker;
+    int strength;
+    uint32_t coin;
+    bool overwrite;
+    const char* passphrase_text;
 };
 typedef struct {
     int page;
@@ -86,10 +98,21 @@ typedef struct {
     CONFIDENTIAL const char* xprv_extended;
     CONFIDENTIAL const char* xpub_extended;
     char* recv_addresses[NUM_ADDRS];
+    float seed_progress;
 } FlipBipScene1Model;
 
-// Node for the receive address
-static CONFIDENTIAL HDNode* s_addr_node = NULL;
+// Account and change nodes per coin, kept for the lifetime of the app
+// so re-entering the wallet doesn't redo the hardened derivations
+typedef struct {
+    bool valid;
+    uint8_t seed_digest[SHA256_DIGEST_LENGTH];
+    uint32_t account_fingerprint;
+    uint32_t change_fingerprint;
+    HDNode account;
+    HDNode change;
+    curve_point change_point; // receive addresses are derived from this point
+} FlipBipNodeCache;
+static CONFIDENTIAL FlipBipNodeCache* s_node_cache = NULL;
 // Generic display text
 static CONFIDENTIAL char* s_disp_text1 = NULL;
 static CONFIDENTIAL char* s_disp_text2 = NULL;
@@ -103,7 +126,10 @@ static const char* s_derivation_text = TEXT_DEFAULT_COIN; // TEXT_DEFAULT_DERIV;
 static bool s_warn_insecure = false;
 #define WARN_INSECURE_TEXT_1 "Recommendation:"
 #define WARN_INSECURE_TEXT_2 "Set BIP39 Passphrase"
-//static bool s_busy = false;
+// Set while the wallet is derived in the background
+static volatile bool s_busy = false;
+// View to report seed derivation progress to
+static View* s_progress_view = NULL;
 
 void flipbip_scene_1_set_callback(
     FlipBipScene1* instance,
@@ -117,23 +143,23 @@ void flipbip_scene_1_set_callback(
 
 static void flipbip_scene_1_init_address(
     char* addr_text,
-    const HDNode* node,
+    const curve_point* parent,
+    const uint8_t* parent_chain_code,
     uint32_t coin_type,
     uint32_t addr_index) {
-    //s_busy = true;
-
     // buffer for address serialization
     // subtract 2 for "0x", 1 for null terminator
     const size_t buflen = MAX_ADDR_BUF - (2 + 1);
     // subtract 2 for "0x"
     char buf[MAX_ADDR_BUF - 2] = {0};
 
-    // Use static node for address generation
-    memcpy(s_addr_node, node, sizeof(HDNode));
+    // public key (compressed, or raw x/y for ETH)
+    uint8_t pubkey[65] = {0};
     memzero(addr_text, MAX_ADDR_BUF);
 
-    hdnode_private_ckd(s_addr_node, addr_index);
-    hdnode_fill_public_key(s_addr_node);
+    // Public derivation from the parent point, one scalar multiplication per address
+    curve_point child = {0};
+    hdnode_public_ckd_cp(&secp256k1, parent, parent_chain_code, addr_index, &child, NULL);
 
     // coin info
     // bip44_coin, xprv_version, xpub_version, addr_version, wif_version, addr_format
@@ -144,30 +170,33 @@ static void flipbip_scene_1_init_address(
 
     if(coin_info[5] == FlipBipCoinBTC0) { // BTC / DOGE style address
         // BTC / DOGE style address
-        ecdsa_get_address(
-            s_addr_node->public_key, coin_info[3], HASHER_SHA2_RIPEMD, HASHER_SHA2D, buf, buflen);
+        compress_coords(&child, pubkey);
+        ecdsa_get_address(pubkey, coin_info[3], HASHER_SHA2_RIPEMD, HASHER_SHA2D, buf, buflen);
         strcpy(addr_text, buf);
         //ecdsa_get_wif(addr_node->private_key, WIF_VERSION, HASHER_SHA2D, buf, buflen);
 
     } else if(coin_info[5] == FlipBipCoinETH60) { // ETH
-        // ETH style address
-        hdnode_get_ethereum_pubkeyhash(s_addr_node, (uint8_t*)buf);
+        // ETH style address, last 20 bytes of keccak256(x || y)
+        uint8_t hash[32] = {0};
+        bn_write_be(&child.x, pubkey);
+        bn_write_be(&child.y, pubkey + 32);
+        keccak_256(pubkey, 64, hash);
+        memcpy(buf, hash + 12, 20);
         addr_text[0] = '0';
         addr_text[1] = 'x';
         // Convert the hash to a hex string
         flipbip_btox((uint8_t*)buf, 20, addr_text + 2);
 
     } else if(coin_info[5] == FlipBipCoinZEC133) { // ZEC
-        ecdsa_get_address(
-            s_addr_node->public_key, coin_info[3], HASHER_SHA2_RIPEMD, HASHER_SHA2D, buf, buflen);
+        compress_coords(&child, pubkey);
+        ecdsa_get_address(pubkey, coin_info[3], HASHER_SHA2_RIPEMD, HASHER_SHA2D, buf, buflen);
         addr_text[0] = 't';
         strcpy(addr_text, buf);
     }
 
-    // Clear the address node
-    memzero(s_addr_node, sizeof(HDNode));
-
-    //s_busy = false;
+    // Clear the address key material
+    memzero(&child, sizeof(child));
+    memzero(pubkey, sizeof(pubkey));
 }
 
 static void
@@ -316,6 +345,9 @@ void flipbip_scene_1_draw(Canvas* canvas, FlipBipScene1Model* model) {
         canvas_set_font(canvas, FontPrimary);
         canvas_draw_str(canvas, 2, 10, TEXT_LOADING);
         canvas_draw_str(canvas, 7, 30, s_derivation_text);
+        if(model->seed_progress > 0) {
+            elements_progress_bar(canvas, 2, 33, 124, model->seed_progress);
+        }
         // canvas_draw_icon(canvas, 86, 22, &I_Keychain_39x36);
         if(s_warn_insecure) {
             canvas_set_font(canvas, FontSecondary);
@@ -367,6 +399,15 @@ void flipbip_scene_1_draw(Canvas* canvas, FlipBipScene1Model* model) {
     }
 }
 
+static void flipbip_scene_1_seed_progress(uint32_t current, uint32_t total) {
+    if(s_progress_view == NULL || total == 0) return;
+    with_view_model(
+        s_progress_view,
+        FlipBipScene1Model * model,
+        { model->seed_progress = (float)current / (float)total; },
+        true);
+}
+
 static int flipbip_scene_1_model_init(
     FlipBipScene1Model* const model,
     const int strength,
@@ -423,8 +464,15 @@ static int flipbip_scene_1_model_init(
         return FlipBipStatusReturn; // 10 = mnemonic only, return from parent
     }
 
-    // Generate a BIP39 seed from the mnemonic
-    mnemonic_to_seed(model->mnemonic, passphrase_text, model->seed, 0);
+    // Generate a BIP39 seed from the mnemonic, PBKDF2 is skipped if this device cached it
+    if(!flipbip_load_seed_cache(model->seed, model->mnemonic, passphrase_text)) {
+        mnemonic_to_seed(
+            model->mnemonic, passphrase_text, model->seed, flipbip_scene_1_seed_progress);
+        flipbip_save_seed_cache(model->seed, model->mnemonic, passphrase_text);
+    }
+
+    // Speed up scalar multiplications with the precomputed curve point table, if it fits
+    flipbip_precomp_load();
 
     // Generate a BIP32 root HD node from the mnemonic
     HDNode* root = malloc(sizeof(HDNode));
@@ -448,51 +496,69 @@ static int flipbip_scene_1_model_init(
     strncpy(xprv_root, buf, buflen);
     model->xprv_root = xprv_root;
 
-    HDNode* node = root;
-
-    // purpose m/44'
-    fingerprint = hdnode_fingerprint(node);
-    hdnode_private_ckd_prime(node, DERIV_PURPOSE); // purpose
-
-    // coin m/44'/0' or m/44'/60'
-    fingerprint = hdnode_fingerprint(node);
-    hdnode_private_ckd_prime(node, coin_info[0]); // coin
-
-    // account m/44'/0'/0' or m/44'/60'/0'
-    fingerprint = hdnode_fingerprint(node);
-    hdnode_private_ckd_prime(node, DERIV_ACCOUNT); // account
+    // The cache is keyed by the seed, so a new mnemonic or passphrase invalidates it
+    uint8_t seed_digest[SHA256_DIGEST_LENGTH] = {0};
+    sha256_Raw(model->seed, 64, seed_digest);
+    FlipBipNodeCache* cache = &s_node_cache[coin];
+    if(!cache->valid || memcmp(cache->seed_digest, seed_digest, SHA256_DIGEST_LENGTH) != 0) {
+        memzero(cache, sizeof(FlipBipNodeCache));
+        memcpy(&cache->account, root, sizeof(HDNode));
+
+        // purpose m/44'
+        hdnode_private_ckd_prime(&cache->account, DERIV_PURPOSE); // purpose
+
+        // coin m/44'/0' or m/44'/60'
+        hdnode_private_ckd_prime(&cache->account, coin_info[0]); // coin
+
+        // account m/44'/0'/0' or m/44'/60'/0'
+        cache->account_fingerprint = hdnode_fingerprint(&cache->account);
+        hdnode_private_ckd_prime(&cache->account, DERIV_ACCOUNT); // account
+        hdnode_fill_public_key(&cache->account);
+
+        // external/internal (change) m/44'/0'/0'/0 or m/44'/60'/0'/0
+        cache->change_fingerprint = hdnode_fingerprint(&cache->account);
+        memcpy(&cache->change, &cache->account, sizeof(HDNode));
+        hdnode_private_ckd(&cache->change, DERIV_CHANGE); // external/internal (change)
+        hdnode_fill_public_key(&cache->change);
+        ecdsa_read_pubkey(&secp256k1, cache->change.public_key, &cache->change_point);
+
+        memcpy(cache->seed_digest, seed_digest, SHA256_DIGEST_LENGTH);
+        cache->valid = true;
+    }
+    memzero(seed_digest, sizeof(seed_digest));
 
-    hdnode_serialize_private(node, fingerprint, coin_info[1], buf, buflen);
+    hdnode_serialize_private(
+        &cache->account, cache->account_fingerprint, coin_info[1], buf, buflen);
     char* xprv_acc = malloc(buflen + 1);
     strncpy(xprv_acc, buf, buflen);
     model->xprv_account = xprv_acc;
 
-    hdnode_serialize_public(node, fingerprint, coin_info[2], buf, buflen);
+    hdnode_serialize_public(
+        &cache->account, cache->account_fingerprint, coin_info[2], buf, buflen);
     char* xpub_acc = malloc(buflen + 1);
     strncpy(xpub_acc, buf, buflen);
     model->xpub_account = xpub_acc;
 
-    // external/internal (change) m/44'/0'/0'/0 or m/44'/60'/0'/0
-    fingerprint = hdnode_fingerprint(node);
-    hdnode_private_ckd(node, DERIV_CHANGE); // external/internal (change)
-
-    hdnode_serialize_private(node, fingerprint, coin_info[1], buf, buflen);
+    hdnode_serialize_private(&cache->change, cache->change_fingerprint, coin_info[1], buf, buflen);
     char* xprv_ext = malloc(buflen + 1);
     strncpy(xprv_ext, buf, buflen);
     model->xprv_extended = xprv_ext;
 
-    hdnode_serialize_public(node, fingerprint, coin_info[2], buf, buflen);
+    hdnode_serialize_public(&cache->change, cache->change_fingerprint, coin_info[2], buf, buflen);
     char* xpub_ext = malloc(buflen + 1);
     strncpy(xpub_ext, buf, buflen);
     model->xpub_extended = xpub_ext;
 
+    HDNode* node = root;
+    memcpy(node, &cache->change, sizeof(HDNode));
     model->node = node;
 
     // Initialize addresses
     for(uint8_t a = 0; a < NUM_ADDRS; a++) {
         model->recv_addresses[a] = malloc(MAX_ADDR_BUF);
         memzero(model->recv_addresses[a], MAX_ADDR_BUF);
-        flipbip_scene_1_init_address(model->recv_addresses[a], node, coin, a);
+        flipbip_scene_1_init_address(
+            model->recv_addresses[a], &cache->change_point, cache->change.chain_code, coin, a);
 
         // Save QR code file
         memzero(buf, buflen);
@@ -520,9 +586,9 @@ bool flipbip_scene_1_input(InputEvent* event, void* context) {
     FlipBipScene1* instance = context;
 
     // Ignore input if busy
-    // if(s_busy) {
-    //     return false;
-    // }
+    if(s_busy) {
+        return true;
+    }
 
     if(event->type == InputTypeRelease) {
         switch(event->key) {
@@ -590,11 +656,19 @@ void flipbip_scene_1_exit(void* context) {
     furi_assert(context);
     FlipBipScene1* instance = (FlipBipScene1*)context;
 
+    // Wait for the wallet derivation to finish before freeing its results
+    if(instance->worker != NULL) {
+        furi_thread_join(instance->worker);
+        furi_thread_free(instance->worker);
+        instance->worker = NULL;
+    }
+
     with_view_model(
         instance->view,
         FlipBipScene1Model * model,
         {
             model->page = PAGE_LOADING;
+            model->seed_progress = 0;
             model->strength = FlipBipStrength256;
             model->coin = FlipBipCoinBTC0;
             memzero(model->seed, 64);
@@ -625,6 +699,60 @@ void flipbip_scene_1_exit(void* context) {
     flipbip_scene_1_clear_text();
 }
 
+static int32_t flipbip_scene_1_worker(void* context) {
+    FlipBipScene1* instance = (FlipBipScene1*)context;
+
+    // Derive into a private model, the view model stays unlocked for progress updates
+    FlipBipScene1Model* work = malloc(sizeof(FlipBipScene1Model));
+    memzero(work, sizeof(FlipBipScene1Model));
+
+    const int status = flipbip_scene_1_model_init(
+        work, instance->strength, instance->coin, instance->overwrite, instance->passphrase_text);
+
+    // nonzero status, free the mnemonic
+    if(status != FlipBipStatusSuccess) {
+        // calling strlen on mnemonic here can cause a crash, don't.
+        // it wasn't loaded properly anyways, no need to zero the memory
+        free((void*)work->mnemonic);
+    }
+
+    // if error, set the error message
+    if(status == FlipBipStatusSaveError) {
+        work->mnemonic = "ERROR:,Save error";
+        work->page = PAGE_MNEMONIC;
+        //flipbip_play_long_bump(app);
+    } else if(status == FlipBipStatusLoadError) {
+        work->mnemonic = "ERROR:,Load error";
+        work->page = PAGE_MNEMONIC;
+        //flipbip_play_long_bump(app);
+    } else if(status == FlipBipStatusMnemonicCheckError) {
+        work->mnemonic = "ERROR:,Mnemonic check error";
+        work->page = PAGE_MNEMONIC;
+        //flipbip_play_long_bump(app);
+    }
+
+    with_view_model(
+        instance->view,
+        FlipBipScene1Model * model,
+        {
+            memcpy(model, work, sizeof(FlipBipScene1Model));
+            model->seed_progress = 0;
+        },
+        true);
+
+    memzero(work, sizeof(FlipBipScene1Model));
+    free(work);
+
+    s_busy = false;
+
+    // if overwrite is set and mnemonic generated, return from scene immediately
+    if(status == FlipBipStatusReturn) {
+        instance->callback(FlipBipCustomEventScene1Back, instance->context);
+    }
+
+    return 0;
+}
+
 void flipbip_scene_1_enter(void* context) {
     furi_assert(context);
     FlipBipScene1* instance = (FlipBipScene1*)context;
@@ -659,8 +787,10 @@ void flipbip_scene_1_enter(void* context) {
         s_derivation_text = TEXT_NEW_WALLET;
     }
 
-    // Wait a beat to allow the display time to update to the loading screen
-    furi_thread_flags_wait(0, FuriFlagWaitAny, 20);
+    instance->strength = strength;
+    instance->coin = coin;
+    instance->overwrite = overwrite;
+    instance->passphrase_text = passphrase_text;
 
     //flipbip_play_happy_bump(app);
     //notification_message(app->notification, &sequence_blink_cyan_100);
@@ -670,41 +800,19 @@ void flipbip_scene_1_enter(void* context) {
         instance->view,
         FlipBipScene1Model * model,
         {
-            // s_busy = true;
-
-            const int status =
-                flipbip_scene_1_model_init(model, strength, coin, overwrite, passphrase_text);
-
-            // nonzero status, free the mnemonic
-            if(status != FlipBipStatusSuccess) {
-                // calling strlen on mnemonic here can cause a crash, don't.
-                // it wasn't loaded properly anyways, no need to zero the memory
-                free((void*)model->mnemonic);
-            }
-
-            // if error, set the error message
-            if(status == FlipBipStatusSaveError) {
-                model->mnemonic = "ERROR:,Save error";
-                model->page = PAGE_MNEMONIC;
-                //flipbip_play_long_bump(app);
-            } else if(status == FlipBipStatusLoadError) {
-                model->mnemonic = "ERROR:,Load error";
-                model->page = PAGE_MNEMONIC;
-                //flipbip_play_long_bump(app);
-            } else if(status == FlipBipStatusMnemonicCheckError) {
-                model->mnemonic = "ERROR:,Mnemonic check error";
-                model->page = PAGE_MNEMONIC;
-                //flipbip_play_long_bump(app);
-            }
-
-            // s_busy = false;
-
-            // if overwrite is set and mnemonic generated, return from scene immediately
-            if(status == FlipBipStatusReturn) {
-                instance->callback(FlipBipCustomEventScene1Back, instance->context);
-            }
+            model->page = PAGE_LOADING;
+            model->seed_progress = 0;
         },
         true);
+
+    // Derive the wallet in the background so the loading screen can show progress
+    s_busy = true;
+    instance->worker = furi_thread_alloc_ex(
+        "FlipBipScene1Worker",
+        FLIPBIP_SCENE_1_WORKER_STACK_SIZE,
+        flipbip_scene_1_worker,
+        instance);
+    furi_thread_start(instance->worker);
 }
 
 FlipBipScene1* flipbip_scene_1_alloc() {
@@ -716,9 +824,12 @@ FlipBipScene1* flipbip_scene_1_alloc() {
     view_set_input_callback(instance->view, flipbip_scene_1_input);
     view_set_enter_callback(instance->view, flipbip_scene_1_enter);
     view_set_exit_callback(instance->view, flipbip_scene_1_exit);
+    instance->worker = NULL;
+    s_progress_view = instance->view;
 
-    // allocate the address node
-    s_addr_node = (HDNode*)malloc(sizeof(HDNode));
+    // allocate the node cache
+    s_node_cache = (FlipBipNodeCache*)malloc(sizeof(FlipBipNodeCache) * NUM_COINS);
+    memzero(s_node_cache, sizeof(FlipBipNodeCache) * NUM_COINS);
 
     // allocate the display text
     s_disp_text1 = (char*)malloc(MAX_TEXT_BUF);
@@ -737,9 +848,12 @@ void flipbip_scene_1_free(FlipBipScene1* instance) {
     with_view_model(
         instance->view, FlipBipScene1Model * model, { UNUSED(model); }, true);
 
-    // free the address node
-    memzero(s_addr_node, sizeof(HDNode));
-    free(s_addr_node);
+    // free the node cache
+    memzero(s_node_cache, sizeof(FlipBipNodeCache) * NUM_COINS);
+    free(s_node_cache);
+
+    // free the precomputed curve point table
+    flipbip_precomp_free();
 
     // free the display text
     flipbip_scene_1_clear_text();
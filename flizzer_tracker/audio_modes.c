@@ -1,8 +1,26 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "audio_modes.h"
+
 char* audio_modes_text[2] = {
     "Internal",
     "External",
 };
-bool audio_modes_values[2] = {false, true};
\ No newline at end of file
+bool audio_modes_values[2] = {false, true};
+
+char* export_bits_text[2] = {
+    "8 bit",
+    "16 bit",
+};
+bool export_bits_values[2] = {false, true};
+
+char* sample_rates_text[SAMPLE_RATES_COUNT] = {
+    "11025",
+    "16000",
+    "22050",
+    "32000",
+    "44100",
+    "48000",
+};
+uint32_t sample_rates_values[SAMPLE_RATES_COUNT] = {11025, 16000, 22050, 32000, 44100, 48000};
\ No newline at end of file
@@ -0,0 +1,3 @@
+#pragma once
+
+#define SAMPLE_RATES_COUNT 6
@@ -1,4 +1,5 @@
 #include "diskop.h"
+#include "util.h"
 
 #define CFG_FILENAME "settings.cfg"
 
@@ -116,6 +117,11 @@ bool save_song(FlizzerTrackerApp* tracker, FuriString* filepath) {
     rwops = stream_write(tracker->stream, (uint8_t*)&song->speed, sizeof(song->speed));
     rwops = stream_write(tracker->stream, (uint8_t*)&song->rate, sizeof(song->rate));
 
+    rwops = stream_write(
+        tracker->stream, (uint8_t*)&song->num_channels, sizeof(song->num_channels));
+    rwops =
+        stream_write(tracker->stream, (uint8_t*)&song->sample_rate, sizeof(song->sample_rate));
+
     rwops = stream_write(
         tracker->stream, (uint8_t*)&song->num_sequence_steps, sizeof(song->num_sequence_steps));
 
@@ -129,11 +135,20 @@ bool save_song(FlizzerTrackerApp* tracker, FuriString* filepath) {
     rwops =
         stream_write(tracker->stream, (uint8_t*)&song->num_patterns, sizeof(song->num_patterns));
 
+    // Patterns are stored as they are in memory: the number of rows then each row number
+    // with its step
     for(uint16_t i = 0; i < song->num_patterns; i++) {
-        rwops = stream_write(
-            tracker->stream,
-            (uint8_t*)song->pattern[i].step,
-            sizeof(TrackerSongPatternStep) * (song->pattern_length));
+        TrackerSongPatternData* data = song->pattern[i].data;
+        uint16_t num_rows = data ? data->num_rows : 0;
+
+        rwops = stream_write(tracker->stream, (uint8_t*)&num_rows, sizeof(num_rows));
+
+        for(uint16_t j = 0; j < num_rows; j++) {
+            rwops = stream_write(
+                tracker->stream, (uint8_t*)&data->rows[j].row, sizeof(data->rows[j].row));
+            rwops = stream_write(
+                tracker->stream, (uint8_t*)&data->rows[j].step, sizeof(TrackerSongPatternStep));
+        }
     }
 
     rwops = stream_write(
@@ -153,33 +168,20 @@ bool save_song(FlizzerTrackerApp* tracker, FuriString* filepath) {
     return false;
 }
 
-bool load_song_util(FlizzerTrackerApp* tracker, FuriString* filepath) {
-    bool open_file = file_stream_open(
-        tracker->stream, furi_string_get_cstr(filepath), FSAM_READ, FSOM_OPEN_ALWAYS);
-
-    bool result = load_song(&tracker->song, tracker->stream);
-
-    tracker->is_loading = false;
-    file_stream_close(tracker->stream);
-    furi_string_free(filepath);
-    UNUSED(open_file);
-    return result;
-}
-
-bool load_instrument_disk(TrackerSong* song, uint8_t inst, Stream* stream) {
+bool load_instrument_disk(TrackerSong* song, uint8_t inst, DiskopReader* reader) {
     set_default_instrument(song->instrument[inst]);
 
     char header[sizeof(INST_FILE_SIG) + 2] = {0};
-    size_t rwops = stream_read(stream, (uint8_t*)&header, sizeof(INST_FILE_SIG) - 1);
+    size_t rwops = diskop_read(reader, (uint8_t*)&header, sizeof(INST_FILE_SIG) - 1);
     header[sizeof(INST_FILE_SIG)] = '\0';
 
     uint8_t version = 0;
 
     if(strcmp(header, INST_FILE_SIG) == 0) {
-        rwops = stream_read(stream, (uint8_t*)&version, sizeof(version));
+        rwops = diskop_read(reader, (uint8_t*)&version, sizeof(version));
 
         if(version <= TRACKER_ENGINE_VERSION) {
-            load_instrument_inner(stream, song->instrument[inst], version);
+            load_instrument_inner(reader, song->instrument[inst], version);
         }
     }
 
@@ -187,18 +189,86 @@ bool load_instrument_disk(TrackerSong* song, uint8_t inst, Stream* stream) {
     return false;
 }
 
+// Runs on the load worker, the app thread draws "Loading" and ignores input meanwhile
+static bool load_file_callback(LazyLoad* load, void* context) {
+    FlizzerTrackerApp* tracker = (FlizzerTrackerApp*)context;
+
+    size_t size = 0;
+    uint8_t* data = lazy_load_read_file(
+        load, tracker->storage, furi_string_get_cstr(tracker->load_path), &size);
+
+    if(data == NULL) {
+        return false;
+    }
+
+    DiskopReader reader = {.data = data, .size = size, .position = 0};
+
+    if(tracker->is_loading) {
+        load_song(&tracker->song, &reader);
+    }
+
+    else {
+        load_instrument_disk(&tracker->song, tracker->current_instrument, &reader);
+    }
+
+    free(data);
+    return true;
+}
+
+static void load_progress_callback(void* context) {
+    FlizzerTrackerApp* tracker = (FlizzerTrackerApp*)context;
+    with_view_model(
+        tracker->tracker_view->view, TrackerViewModel * model, { UNUSED(model); }, true);
+}
+
+static void load_done_callback(bool success, void* context) {
+    UNUSED(success);
+    FlizzerTrackerApp* tracker = (FlizzerTrackerApp*)context;
+
+    FlizzerTrackerEvent event = {.type = EventTypeLoadDone, .input = {{0}}, .period = 0};
+    furi_message_queue_put(tracker->event_queue, &event, FuriWaitForever);
+}
+
+static void load_file_start(FlizzerTrackerApp* tracker, FuriString* filepath) {
+    tracker->load_path = filepath;
+    tracker->load = lazy_load_alloc("FlizzerLoad", load_file_callback, tracker);
+    lazy_load_set_progress_callback(tracker->load, load_progress_callback, tracker);
+    lazy_load_set_done_callback(tracker->load, load_done_callback, tracker);
+    lazy_load_start(tracker->load);
+}
+
+bool load_song_util(FlizzerTrackerApp* tracker, FuriString* filepath) {
+    load_file_start(tracker, filepath);
+    return true;
+}
+
 bool load_instrument_util(FlizzerTrackerApp* tracker, FuriString* filepath) {
-    bool open_file = file_stream_open(
-        tracker->stream, furi_string_get_cstr(filepath), FSAM_READ, FSOM_OPEN_ALWAYS);
+    load_file_start(tracker, filepath);
+    return true;
+}
 
-    bool result =
-        load_instrument_disk(&tracker->song, tracker->current_instrument, tracker->stream);
+void load_finish(FlizzerTrackerApp* tracker) {
+    LazyLoad* load = tracker->load;
 
-    tracker->is_loading_instrument = false;
-    file_stream_close(tracker->stream);
-    furi_string_free(filepath);
-    UNUSED(open_file);
-    return result;
+    if(tracker->is_loading) {
+        apply_song_audio_settings(tracker);
+    }
+
+    // The draw callback runs with the model locked, so it no longer uses the load after this
+    with_view_model(
+        tracker->tracker_view->view,
+        TrackerViewModel * model,
+        {
+            UNUSED(model);
+            tracker->load = NULL;
+            tracker->is_loading = false;
+            tracker->is_loading_instrument = false;
+        },
+        true);
+
+    lazy_load_free(load);
+    furi_string_free(tracker->load_path);
+    tracker->load_path = NULL;
 }
 
 void save_config(FlizzerTrackerApp* tracker) {
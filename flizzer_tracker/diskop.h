@@ -6,8 +6,11 @@
 bool save_song(FlizzerTrackerApp* tracker, FuriString* filepath);
 bool save_instrument(FlizzerTrackerApp* tracker, FuriString* filepath);
 
+// These start the load on a worker and take filepath, EventTypeLoadDone is posted when it
+// is over and the app thread then calls load_finish()
 bool load_song_util(FlizzerTrackerApp* tracker, FuriString* filepath);
 bool load_instrument_util(FlizzerTrackerApp* tracker, FuriString* filepath);
+void load_finish(FlizzerTrackerApp* tracker);
 
 void save_config(FlizzerTrackerApp* tracker);
 void load_config(FlizzerTrackerApp* tracker);
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include "init_deinit.h"
 #include "input_event.h"
 #include "util.h"
+#include "profile.h"
+#include "wav_export.h"
 #include "view/instrument_editor.h"
 #include "view/pattern_editor.h"
 
@@ -13,10 +15,21 @@ void draw_callback(Canvas* canvas, void* ctx) {
     TrackerViewModel* model = (TrackerViewModel*)ctx;
     FlizzerTrackerApp* tracker = (FlizzerTrackerApp*)(model->tracker);
 
+    profile_first_frame();
     canvas_set_color(canvas, ColorXOR);
 
     if(tracker->is_loading || tracker->is_loading_instrument) {
-        canvas_draw_str(canvas, 10, 10, "Loading...");
+        if(tracker->load) {
+            lazy_load_draw(
+                tracker->load,
+                canvas,
+                tracker->is_loading ? "Loading song" : "Loading instrument");
+        }
+
+        else {
+            canvas_draw_str(canvas, 10, 10, "Loading...");
+        }
+
         return;
     }
 
@@ -25,6 +38,14 @@ void draw_callback(Canvas* canvas, void* ctx) {
         return;
     }
 
+    if(tracker->is_exporting) {
+        char buffer[24];
+        snprintf(buffer, sizeof(buffer), "Exporting... %d%%", tracker->export_progress);
+        canvas_draw_str(canvas, 10, 10, buffer);
+        canvas_draw_str(canvas, 10, 20, "Back to cancel");
+        return;
+    }
+
     if(tracker->showing_help) {
         canvas_draw_icon(canvas, 0, 0, &I_help);
         return;
@@ -87,7 +108,14 @@ bool input_callback(InputEvent* input_event, void* ctx) {
     FlizzerTrackerEvent event = {
         .type = EventTypeInput, .input = *input_event, .period = final_period};
 
-    if(!(tracker->is_loading) && !(tracker->is_saving)) {
+    // The export blocks the app thread, so Back is handled right here
+    if(tracker->is_exporting) {
+        if(input_event->key == InputKeyBack && input_event->type == InputTypeShort) {
+            tracker->export_cancel = true;
+        }
+    }
+
+    else if(!(tracker->is_loading) && !(tracker->is_saving)) {
         furi_message_queue_put(tracker->event_queue, &event, FuriWaitForever);
     }
 
@@ -97,6 +125,7 @@ bool input_callback(InputEvent* input_event, void* ctx) {
 
 int32_t flizzer_tracker_app(void* p) {
     UNUSED(p);
+    profile_start(); // "profile" CLI command in debug builds
 
     Storage* storage = furi_record_open(RECORD_STORAGE);
     bool st = storage_simply_mkdir(storage, APPSDATA_FOLDER);
@@ -106,6 +135,7 @@ int32_t flizzer_tracker_app(void* p) {
     furi_record_close(RECORD_STORAGE);
 
     FlizzerTrackerApp* tracker = init_tracker(44100, 50, true, 1024);
+    profile_phase("init");
 
     // Текущее событие типа кастомного типа FlizzerTrackerEvent
     FlizzerTrackerEvent event;
@@ -132,6 +162,14 @@ int32_t flizzer_tracker_app(void* p) {
             save_instrument(tracker, tracker->filepath);
         }
 
+        if(event.type == EventTypeExportWav) {
+            bool result = export_song_wav(tracker, tracker->filepath);
+            UNUSED(result);
+
+            furi_string_free(tracker->filepath);
+            tracker->is_exporting = false;
+        }
+
         if(event.type == EventTypeLoadSong) {
             stop_song(tracker);
 
@@ -197,10 +235,14 @@ int32_t flizzer_tracker_app(void* p) {
 
             else {
                 furi_string_free(path);
-                tracker->is_loading = false;
+                tracker->is_loading_instrument = false;
             }
         }
 
+        if(event.type == EventTypeLoadDone) {
+            load_finish(tracker);
+        }
+
         if(event.type == EventTypeSetAudioMode) {
             sound_engine_PWM_timer_init(tracker->external_audio);
 
@@ -209,6 +251,7 @@ int32_t flizzer_tracker_app(void* p) {
     }
 
     stop();
+    profile_stop();
 
     save_config(tracker);
 
@@ -17,6 +17,7 @@
 #include <gui/view_dispatcher.h>
 
 #include "flizzer_tracker_hal.h"
+#include "lazy_load.h"
 #include "sound_engine/freqs.h"
 #include "sound_engine/sound_engine_defs.h"
 #include "sound_engine/sound_engine_filter.h"
@@ -34,6 +35,8 @@ typedef enum {
     EventTypeLoadInstrument,
     EventTypeSaveInstrument,
     EventTypeSetAudioMode,
+    EventTypeExportWav,
+    EventTypeLoadDone,
 } EventType;
 
 typedef struct {
@@ -143,6 +146,7 @@ typedef enum {
 typedef enum {
     SUBMENU_PATTERN_LOAD_SONG,
     SUBMENU_PATTERN_SAVE_SONG,
+    SUBMENU_PATTERN_EXPORT_WAV,
     SUBMENU_PATTERN_SETTINGS,
     SUBMENU_PATTERN_HELP,
     SUBMENU_PATTERN_EXIT,
@@ -171,11 +175,16 @@ typedef struct {
     Storage* storage;
     Stream* stream;
     FuriString* filepath;
+    LazyLoad* load; // song or instrument file being loaded
+    FuriString* load_path;
     DialogsApp* dialogs;
     Submenu* pattern_submenu;
     Submenu* pattern_copypaste_submenu;
     Submenu* instrument_submenu;
     VariableItemList* settings_list;
+    VariableItem* channels_item;
+    VariableItem* sample_rate_item;
+    VariableItem* cpu_load_item;
     Widget* overwrite_file_widget;
     Widget* overwrite_instrument_file_widget;
     char filename[FILE_NAME_LEN + 1];
@@ -184,6 +193,10 @@ typedef struct {
     uint32_t period;
 
     bool external_audio;
+    bool export_16bit;
+
+    bool export_cancel; // set from the input callback while the export runs
+    uint8_t export_progress; // percent of the sequence rendered
 
     SoundEngine sound_engine;
     TrackerEngine tracker_engine;
@@ -207,6 +220,7 @@ typedef struct {
     bool is_saving;
     bool is_loading_instrument;
     bool is_saving_instrument;
+    bool is_exporting;
     bool showing_help;
 
     bool cut_pattern; //if we need to clear the pattern we pasted from
@@ -4,6 +4,8 @@
 void sound_engine_dma_isr(void* ctx) {
     SoundEngine* sound_engine = (SoundEngine*)ctx;
 
+    uint32_t start = DWT->CYCCNT; // the cycle counter is already running for furi delays
+
     // sound_engine->counter++;
 
     // half of transfer
@@ -23,6 +25,32 @@ void sound_engine_dma_isr(void* ctx) {
         uint16_t* audio_buffer = &sound_engine->audio_buffer[audio_buffer_length];
         sound_engine_fill_buffer(sound_engine, audio_buffer, audio_buffer_length);
     }
+
+    uint32_t cycles = DWT->CYCCNT - start;
+
+    if(cycles > sound_engine->isr_cycles_max) {
+        sound_engine->isr_cycles_max = cycles;
+    }
+}
+
+// CPU cycles available to fill half of the buffer before the DMA reaches it
+uint32_t sound_engine_cycle_budget(SoundEngine* sound_engine, uint32_t sample_rate) {
+    return TIMER_BASE_CLOCK / sample_rate * (sound_engine->audio_buffer_size / 2);
+}
+
+// Load in percent that num_channels at sample_rate would take, scaled from the peak
+// measured with the current channel count. The fill time per sample does not depend on
+// the sample rate, only the budget does. Returns 0 if nothing was measured yet
+uint32_t sound_engine_cpu_load(
+    SoundEngine* sound_engine,
+    uint8_t num_channels,
+    uint32_t sample_rate) {
+    if(sound_engine->num_channels == 0) return 0;
+
+    uint64_t cycles =
+        (uint64_t)sound_engine->isr_cycles_max * num_channels / sound_engine->num_channels;
+
+    return cycles * 100 / sound_engine_cycle_budget(sound_engine, sample_rate);
 }
 
 void tracker_engine_timer_isr(
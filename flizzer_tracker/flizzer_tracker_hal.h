@@ -21,6 +21,8 @@
 
 #define DMA_INSTANCE DMA1, LL_DMA_CHANNEL_1
 
+#define SE_MAX_LOAD 90 /* percent of the half buffer fill time, the rest is for tracker and GUI */
+
 void sound_engine_dma_isr(void* ctx);
 void tracker_engine_timer_isr(void* ctx);
 void sound_engine_init_hardware(
@@ -29,6 +31,12 @@ void sound_engine_init_hardware(
     uint16_t* audio_buffer,
     uint32_t audio_buffer_size);
 void sound_engine_dma_init(uint32_t address, uint32_t size);
+void sound_engine_timer_init(uint32_t sample_rate);
+uint32_t sound_engine_cycle_budget(SoundEngine* sound_engine, uint32_t sample_rate);
+uint32_t sound_engine_cpu_load(
+    SoundEngine* sound_engine,
+    uint8_t num_channels,
+    uint32_t sample_rate);
 void sound_engine_PWM_timer_init(bool external_audio_output);
 void sound_engine_set_audio_output(bool external_audio_output);
 void tracker_engine_init_hardware(uint8_t rate);
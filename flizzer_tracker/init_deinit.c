@@ -2,6 +2,7 @@
 #include "input_event.h"
 
 #include "diskop.h"
+#include "profile.h"
 
 #define AUDIO_MODES_COUNT 2
 
@@ -54,6 +55,7 @@ FlizzerTrackerApp* init_tracker(
     sound_engine_init(
         &tracker->sound_engine, sample_rate, external_audio_output, audio_buffer_size);
     tracker_engine_init(&tracker->tracker_engine, rate, &tracker->sound_engine);
+    profile_phase("engines");
 
     tracker->tracker_engine.song = &tracker->song;
 
@@ -103,6 +105,12 @@ FlizzerTrackerApp* init_tracker(
         SUBMENU_PATTERN_SAVE_SONG,
         submenu_callback,
         tracker);
+    submenu_add_item(
+        tracker->pattern_submenu,
+        "Export WAV",
+        SUBMENU_PATTERN_EXPORT_WAV,
+        submenu_callback,
+        tracker);
     submenu_add_item(
         tracker->pattern_submenu, "Settings", SUBMENU_PATTERN_SETTINGS, submenu_callback, tracker);
     submenu_add_item(
@@ -164,6 +172,7 @@ FlizzerTrackerApp* init_tracker(
         submenu_get_view(tracker->instrument_submenu));
 
     load_config(tracker);
+    profile_phase("config");
 
     tracker->settings_list = variable_item_list_alloc();
     View* view = variable_item_list_get_view(tracker->settings_list);
@@ -183,6 +192,23 @@ FlizzerTrackerApp* init_tracker(
     variable_item_set_current_value_index(item, value_index);
     variable_item_set_current_value_text(item, audio_modes_text[value_index]);
 
+    item = variable_item_list_add(
+        tracker->settings_list, "WAV export", 2, export_bits_changed_callback, tracker);
+    value_index = my_value_index_bool(tracker->export_16bit, export_bits_values, 2);
+    variable_item_set_current_value_index(item, value_index);
+    variable_item_set_current_value_text(item, export_bits_text[value_index]);
+
+    tracker->channels_item = variable_item_list_add(
+        tracker->settings_list, "Channels", NUM_CHANNELS, channels_changed_callback, tracker);
+    tracker->sample_rate_item = variable_item_list_add(
+        tracker->settings_list,
+        "Sample rate",
+        SAMPLE_RATES_COUNT,
+        sample_rate_changed_callback,
+        tracker);
+    tracker->cpu_load_item =
+        variable_item_list_add(tracker->settings_list, "CPU peak", 1, NULL, tracker);
+
     view_dispatcher_add_view(tracker->view_dispatcher, VIEW_SETTINGS, view);
 
     tracker->overwrite_file_widget = widget_alloc();
@@ -279,13 +279,12 @@ void pattern_edit_event(FlizzerTrackerApp* tracker, FlizzerTrackerEvent* event)
 
     TrackerSongPattern* pattern = &tracker->tracker_engine.song->pattern[current_pattern];
 
-    TrackerSongPatternStep* step = NULL;
+    if(pattern_step >= pattern_length) return;
 
-    if(pattern_step < pattern_length) {
-        step = &pattern->step[pattern_step];
-    }
-
-    if(!(step)) return;
+    // Edits go to a copy that is stored back at the end, so moving around a shared
+    // pattern doesn't copy it
+    TrackerSongPatternStep edited_step = *tracker_engine_get_step(pattern, pattern_step);
+    TrackerSongPatternStep* step = &edited_step;
 
     if(event->input.key == InputKeyOk && event->input.type == InputTypeShort &&
        !tracker->tracker_engine.playing) {
@@ -407,4 +406,6 @@ void pattern_edit_event(FlizzerTrackerApp* tracker, FlizzerTrackerEvent* event)
 
         delete_field(step, field);
     }
+
+    tracker_engine_set_step(pattern, pattern_step, step);
 }
\ No newline at end of file
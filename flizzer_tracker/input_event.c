@@ -1,6 +1,7 @@
 #include "input_event.h"
 
 #include "diskop.h"
+#include "wav_export.h"
 
 #define AUDIO_MODES_COUNT 2
 
@@ -8,7 +9,7 @@ void return_from_keyboard_callback(void* ctx) {
     FlizzerTrackerApp* tracker = (FlizzerTrackerApp*)ctx;
 
     if(!tracker->is_loading && !tracker->is_saving && !tracker->is_loading_instrument &&
-       !tracker->is_saving_instrument) {
+       !tracker->is_saving_instrument && !tracker->is_exporting) {
         uint8_t string_length = 0;
         char* string = NULL;
 
@@ -90,6 +91,15 @@ void return_from_keyboard_callback(void* ctx) {
             furi_message_queue_put(tracker->event_queue, &event, FuriWaitForever);
         }
     }
+
+    if(tracker->is_exporting) {
+        tracker->filepath = furi_string_alloc();
+        furi_string_cat_printf(
+            tracker->filepath, "%s/%s%s", FLIZZER_TRACKER_FOLDER, tracker->filename, WAV_FILE_EXT);
+
+        FlizzerTrackerEvent event = {.type = EventTypeExportWav, .input = {{0}}, .period = 0};
+        furi_message_queue_put(tracker->event_queue, &event, FuriWaitForever);
+    }
 }
 
 void overwrite_file_widget_yes_input_callback(GuiButtonType result, InputType type, void* ctx) {
@@ -205,6 +215,23 @@ void submenu_callback(void* context, uint32_t index) {
             break;
         }
 
+        case SUBMENU_PATTERN_EXPORT_WAV: {
+            text_input_set_header_text(tracker->text_input, "WAV filename:");
+            memset(&tracker->filename, 0, FILE_NAME_LEN);
+            text_input_set_result_callback(
+                tracker->text_input,
+                return_from_keyboard_callback,
+                tracker,
+                (char*)&tracker->filename,
+                FILE_NAME_LEN,
+                true);
+
+            tracker->is_exporting = true;
+
+            view_dispatcher_switch_to_view(tracker->view_dispatcher, VIEW_KEYBOARD);
+            break;
+        }
+
         case SUBMENU_PATTERN_LOAD_SONG: {
             FlizzerTrackerEvent event = {.type = EventTypeLoadSong, .input = {{0}}, .period = 0};
             furi_message_queue_put(tracker->event_queue, &event, FuriWaitForever);
@@ -213,6 +240,7 @@ void submenu_callback(void* context, uint32_t index) {
         }
 
         case SUBMENU_PATTERN_SETTINGS: {
+            update_song_settings(tracker);
             view_dispatcher_switch_to_view(tracker->view_dispatcher, VIEW_SETTINGS);
             break;
         }
@@ -293,8 +321,6 @@ void submenu_copypaste_callback(void* context, uint32_t index) {
 
     TrackerSongPattern* current_pattern = &tracker->song.pattern[current_pattern_index];
 
-    uint16_t pattern_length = tracker->tracker_engine.song->pattern_length;
-
     switch(index) {
     case SUBMENU_PATTERN_COPYPASTE_COPY: {
         tracker->source_pattern_index = current_pattern_index;
@@ -303,14 +329,12 @@ void submenu_copypaste_callback(void* context, uint32_t index) {
     }
 
     case SUBMENU_PATTERN_COPYPASTE_PASTE: {
-        if(tracker->source_pattern_index >= 0) {
-            memcpy(
-                current_pattern->step,
-                source_pattern->step,
-                sizeof(TrackerSongPatternStep) * pattern_length);
+        if(tracker->source_pattern_index >= 0 && source_pattern != current_pattern) {
+            // both patterns use the same steps until one of them is edited
+            tracker_engine_share_pattern(current_pattern, source_pattern);
 
             if(tracker->cut_pattern) {
-                set_empty_pattern(source_pattern, pattern_length);
+                set_empty_pattern(source_pattern);
                 tracker->cut_pattern = false;
             }
         }
@@ -324,7 +348,7 @@ void submenu_copypaste_callback(void* context, uint32_t index) {
     }
 
     case SUBMENU_PATTERN_COPYPASTE_CLEAR: {
-        set_empty_pattern(current_pattern, pattern_length);
+        set_empty_pattern(current_pattern);
         break;
     }
 
@@ -355,6 +379,109 @@ void audio_output_changed_callback(VariableItem* item) {
     }
 }
 
+void export_bits_changed_callback(VariableItem* item) {
+    FlizzerTrackerApp* tracker = (FlizzerTrackerApp*)variable_item_get_context(item);
+    uint8_t index = variable_item_get_current_value_index(item);
+    variable_item_set_current_value_text(item, export_bits_text[(index > 1 ? 1 : index)]);
+
+    if(tracker) {
+        tracker->export_16bit = export_bits_values[(index > 1 ? 1 : index)];
+    }
+}
+
+static void set_load_text(FlizzerTrackerApp* tracker, const char* prefix, uint32_t load) {
+    char buffer[16];
+
+    if(load == 0) {
+        snprintf(buffer, sizeof(buffer), "%s--", prefix);
+    }
+
+    else {
+        snprintf(buffer, sizeof(buffer), "%s%lu%%", prefix, load);
+    }
+
+    variable_item_set_current_value_text(tracker->cpu_load_item, buffer);
+}
+
+// Settings are per song, show the ones of the song in memory and its last measured peak
+void update_song_settings(FlizzerTrackerApp* tracker) {
+    char buffer[4];
+    uint8_t value_index = 0;
+
+    snprintf(buffer, sizeof(buffer), "%d", tracker->song.num_channels);
+    variable_item_set_current_value_index(tracker->channels_item, tracker->song.num_channels - 1);
+    variable_item_set_current_value_text(tracker->channels_item, buffer);
+
+    for(uint8_t i = 0; i < SAMPLE_RATES_COUNT; i++) {
+        if(sample_rates_values[i] == tracker->song.sample_rate) {
+            value_index = i;
+            break;
+        }
+    }
+
+    variable_item_set_current_value_index(tracker->sample_rate_item, value_index);
+    variable_item_set_current_value_text(
+        tracker->sample_rate_item, sample_rates_text[value_index]);
+
+    set_load_text(
+        tracker,
+        "",
+        sound_engine_cpu_load(
+            &tracker->sound_engine, tracker->song.num_channels, tracker->song.sample_rate));
+}
+
+// Setting that the measured peak says would not fit in the half buffer time is refused
+static bool
+    song_settings_fit(FlizzerTrackerApp* tracker, uint8_t num_channels, uint32_t sample_rate) {
+    uint32_t load = sound_engine_cpu_load(&tracker->sound_engine, num_channels, sample_rate);
+
+    if(load > SE_MAX_LOAD) {
+        set_load_text(tracker, "No ", load);
+        return false;
+    }
+
+    set_load_text(tracker, "", load);
+    return true;
+}
+
+void channels_changed_callback(VariableItem* item) {
+    FlizzerTrackerApp* tracker = (FlizzerTrackerApp*)variable_item_get_context(item);
+    uint8_t num_channels = variable_item_get_current_value_index(item) + 1;
+
+    if(song_settings_fit(tracker, num_channels, tracker->song.sample_rate)) {
+        stop_song(tracker);
+        tracker->song.num_channels = num_channels;
+        apply_song_audio_settings(tracker);
+    }
+
+    char buffer[4];
+    snprintf(buffer, sizeof(buffer), "%d", tracker->song.num_channels);
+    variable_item_set_current_value_index(item, tracker->song.num_channels - 1);
+    variable_item_set_current_value_text(item, buffer);
+}
+
+void sample_rate_changed_callback(VariableItem* item) {
+    FlizzerTrackerApp* tracker = (FlizzerTrackerApp*)variable_item_get_context(item);
+    uint8_t index = variable_item_get_current_value_index(item);
+
+    if(index >= SAMPLE_RATES_COUNT) index = SAMPLE_RATES_COUNT - 1;
+
+    if(song_settings_fit(tracker, tracker->song.num_channels, sample_rates_values[index])) {
+        stop_song(tracker);
+        tracker->song.sample_rate = sample_rates_values[index];
+        apply_song_audio_settings(tracker);
+    }
+
+    else {
+        for(index = 0; index < SAMPLE_RATES_COUNT - 1; index++) {
+            if(sample_rates_values[index] == tracker->song.sample_rate) break;
+        }
+    }
+
+    variable_item_set_current_value_index(item, index);
+    variable_item_set_current_value_text(item, sample_rates_text[index]);
+}
+
 void cycle_focus(FlizzerTrackerApp* tracker) {
     switch(tracker->mode) {
     case PATTERN_VIEW: {
@@ -421,7 +548,7 @@ void process_input_event(FlizzerTrackerApp* tracker, FlizzerTrackerEvent* event)
     }
 
     if(tracker->showing_help || tracker->is_loading || tracker->is_saving ||
-       tracker->is_loading_instrument || tracker->is_saving_instrument)
+       tracker->is_loading_instrument || tracker->is_saving_instrument || tracker->is_exporting)
         return; //do not react until these are finished
 
     if(event->input.key == InputKeyBack && event->input.type == InputTypeShort &&
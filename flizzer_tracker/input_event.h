@@ -7,6 +7,7 @@
 #include "flizzer_tracker.h"
 #include "sound_engine/sound_engine_defs.h"
 #include "tracker_engine/tracker_engine_defs.h"
+#include "audio_modes.h"
 #include "util.h"
 
 #include "input/instrument.h"
@@ -18,6 +19,12 @@
 extern bool audio_modes_values[];
 extern char* audio_modes_text[];
 
+extern bool export_bits_values[];
+extern char* export_bits_text[];
+
+extern uint32_t sample_rates_values[];
+extern char* sample_rates_text[];
+
 void overwrite_file_widget_yes_input_callback(GuiButtonType result, InputType type, void* ctx);
 void overwrite_file_widget_no_input_callback(GuiButtonType result, InputType type, void* ctx);
 
@@ -35,4 +42,8 @@ uint32_t submenu_settings_exit_callback(void* context);
 void submenu_callback(void* context, uint32_t index);
 void submenu_copypaste_callback(void* context, uint32_t index);
 void audio_output_changed_callback(VariableItem* item);
+void export_bits_changed_callback(VariableItem* item);
+void channels_changed_callback(VariableItem* item);
+void sample_rate_changed_callback(VariableItem* item);
+void update_song_settings(FlizzerTrackerApp* tracker);
 void process_input_event(FlizzerTrackerApp* tracker, FlizzerTrackerEvent* event);
\ No newline at end of file
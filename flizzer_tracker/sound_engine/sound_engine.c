@@ -1,10 +1,17 @@
 #include "sound_engine.h"
 #include "../flizzer_tracker_hal.h"
+#include "../profile.h"
 
 #include <furi_hal.h>
 
 #define PI 3.1415
 
+// Samples rendered per channel at once, kept off the stack of the DMA ISR
+#define SE_RENDER_BLOCK 64
+
+static int32_t mix_block[SE_RENDER_BLOCK];
+static int32_t channel_block[SE_RENDER_BLOCK];
+
 void sound_engine_init(
     SoundEngine* sound_engine,
     uint32_t sample_rate,
@@ -24,6 +31,7 @@ void sound_engine_init(
     memset(sound_engine->audio_buffer, 0, sizeof(SoundEngine));
     sound_engine->audio_buffer_size = audio_buffer_size;
     sound_engine->sample_rate = sample_rate;
+    sound_engine->num_channels = NUM_CHANNELS;
     sound_engine->external_audio_output = external_audio_output;
 
     for(int i = 0; i < NUM_CHANNELS; ++i) {
@@ -61,6 +69,11 @@ void sound_engine_deinit(SoundEngine* sound_engine) {
     sound_engine_deinit_timer();
 }
 
+void sound_engine_set_sample_rate(SoundEngine* sound_engine, uint32_t sample_rate) {
+    sound_engine->sample_rate = sample_rate;
+    sound_engine_timer_init(sample_rate);
+}
+
 void sound_engine_set_channel_frequency(
     SoundEngine* sound_engine,
     SoundEngineChannel* channel,
@@ -96,7 +109,8 @@ void sound_engine_enable_gate(SoundEngine* sound_engine, SoundEngineChannel* cha
     }
 }
 
-void sound_engine_fill_buffer(
+// Sample by sample render, needed when channels hard sync or ring modulate each other
+static void sound_engine_fill_buffer_interleaved(
     SoundEngine* sound_engine,
     uint16_t* audio_buffer,
     uint32_t audio_buffer_size) {
@@ -106,20 +120,14 @@ void sound_engine_fill_buffer(
     for(uint32_t i = 0; i < audio_buffer_size; ++i) {
         int32_t output = WAVE_AMP * 2;
 
-        for(uint32_t chan = 0; chan < NUM_CHANNELS; ++chan) {
+        for(uint32_t chan = 0; chan < sound_engine->num_channels; ++chan) {
             SoundEngineChannel* channel = &sound_engine->channel[chan];
 
             if(channel->frequency > 0) {
-                uint32_t prev_acc = channel->accumulator;
-
-                channel->accumulator += channel->frequency;
-
-                channel->sync_bit |= (channel->accumulator & ACC_LENGTH);
-
-                channel->accumulator &= ACC_LENGTH - 1;
+                uint32_t prev_acc = sound_engine_osc_advance(channel);
 
                 if(channel->flags & SE_ENABLE_HARD_SYNC) {
-                    uint8_t hard_sync_src = channel->hard_sync == 0xff ? i : channel->hard_sync;
+                    uint8_t hard_sync_src = channel->hard_sync == 0xff ? chan : channel->hard_sync;
 
                     if(sound_engine->channel[hard_sync_src].sync_bit) {
                         channel->accumulator = 0;
@@ -130,7 +138,7 @@ void sound_engine_fill_buffer(
                     sound_engine_osc(sound_engine, channel, prev_acc) - WAVE_AMP / 2;
 
                 if(channel->flags & SE_ENABLE_RING_MOD) {
-                    uint8_t ring_mod_src = channel->ring_mod == 0xff ? i : channel->ring_mod;
+                    uint8_t ring_mod_src = channel->ring_mod == 0xff ? chan : channel->ring_mod;
                     channel_output[chan] =
                         channel_output[chan] * channel_output[ring_mod_src] / WAVE_AMP;
                 }
@@ -200,4 +208,59 @@ void sound_engine_fill_buffer(
         //audio_buffer[i] = output / (64 * 4);
         audio_buffer[i] = output >> 8;
     }
-}
\ No newline at end of file
+}
+
+void sound_engine_fill_buffer(
+    SoundEngine* sound_engine,
+    uint16_t* audio_buffer,
+    uint32_t audio_buffer_size) {
+    PROFILE_BEGIN(sound_engine_fill_buffer);
+
+    for(uint32_t chan = 0; chan < sound_engine->num_channels; ++chan) {
+        SoundEngineChannel* channel = &sound_engine->channel[chan];
+
+        if(channel->frequency > 0 &&
+           (channel->flags & (SE_ENABLE_HARD_SYNC | SE_ENABLE_RING_MOD))) {
+            sound_engine_fill_buffer_interleaved(sound_engine, audio_buffer, audio_buffer_size);
+            PROFILE_END(sound_engine_fill_buffer);
+            return;
+        }
+    }
+
+    // Channels don't depend on each other: each one is rendered a block at a time,
+    // with its oscillator, envelope and filter kernels picked once per block
+    for(uint32_t start = 0; start < audio_buffer_size; start += SE_RENDER_BLOCK) {
+        uint32_t size = audio_buffer_size - start;
+
+        if(size > SE_RENDER_BLOCK) size = SE_RENDER_BLOCK;
+
+        for(uint32_t i = 0; i < size; ++i) {
+            mix_block[i] = WAVE_AMP * 2;
+        }
+
+        for(uint32_t chan = 0; chan < sound_engine->num_channels; ++chan) {
+            SoundEngineChannel* channel = &sound_engine->channel[chan];
+
+            if(channel->frequency == 0) continue;
+
+            sound_engine_osc_block(sound_engine, channel, channel_block, size);
+            sound_engine_adsr_block(
+                channel_block, size, sound_engine, &channel->adsr, &channel->flags);
+
+            if((channel->flags & SE_ENABLE_FILTER) && channel->filter_mode != 0) {
+                sound_engine_filter_block(
+                    &channel->filter, channel->filter_mode, channel_block, size);
+            }
+
+            for(uint32_t i = 0; i < size; ++i) {
+                mix_block[i] += channel_block[i];
+            }
+        }
+
+        for(uint32_t i = 0; i < size; ++i) {
+            audio_buffer[start + i] = mix_block[i] >> 8;
+        }
+    }
+
+    PROFILE_END(sound_engine_fill_buffer);
+}
@@ -12,6 +12,7 @@ void sound_engine_init(
     bool external_audio_output,
     uint32_t audio_buffer_size);
 void sound_engine_deinit(SoundEngine* sound_engine);
+void sound_engine_set_sample_rate(SoundEngine* sound_engine, uint32_t sample_rate);
 void sound_engine_set_channel_frequency(
     SoundEngine* sound_engine,
     SoundEngineChannel* channel,
@@ -56,4 +56,28 @@ int32_t sound_engine_cycle_and_output_adsr(
 
     return (int32_t)((int32_t)input * (int32_t)(adsr->envelope >> 10) / (int32_t)(MAX_ADSR >> 10) *
                      (int32_t)adsr->volume / (int32_t)MAX_ADSR_VOLUME);
-}
\ No newline at end of file
+}
+
+void sound_engine_adsr_block(
+    int32_t* buffer,
+    uint32_t size,
+    SoundEngine* eng,
+    SoundEngineADSR* adsr,
+    uint16_t* flags) {
+    if(adsr->envelope_state == SUSTAIN || adsr->envelope_state == DONE) {
+        // The envelope stays where it is, only the gain is applied
+        int32_t envelope = adsr->envelope >> 10;
+        int32_t volume = adsr->volume;
+
+        for(uint32_t i = 0; i < size; ++i) {
+            buffer[i] = buffer[i] * envelope / (int32_t)(MAX_ADSR >> 10) * volume /
+                        (int32_t)MAX_ADSR_VOLUME;
+        }
+
+        return;
+    }
+
+    for(uint32_t i = 0; i < size; ++i) {
+        buffer[i] = sound_engine_cycle_and_output_adsr(buffer[i], eng, adsr, flags);
+    }
+}
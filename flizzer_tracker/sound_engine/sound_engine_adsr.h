@@ -6,4 +6,12 @@ int32_t sound_engine_cycle_and_output_adsr(
     int32_t input,
     SoundEngine* eng,
     SoundEngineADSR* adsr,
+    uint16_t* flags);
+
+// sound_engine_cycle_and_output_adsr() over size samples of buffer, in place
+void sound_engine_adsr_block(
+    int32_t* buffer,
+    uint32_t size,
+    SoundEngine* eng,
+    SoundEngineADSR* adsr,
     uint16_t* flags);
\ No newline at end of file
@@ -92,11 +92,14 @@ typedef struct {
 
 typedef struct {
     SoundEngineChannel channel[NUM_CHANNELS];
+    uint8_t num_channels; // channels rendered, NUM_CHANNELS at most
     uint32_t sample_rate;
     uint16_t* audio_buffer;
     uint32_t audio_buffer_size;
     bool external_audio_output;
     uint8_t sine_lut[SINE_LUT_SIZE];
 
+    uint32_t isr_cycles_max; // longest half buffer fill since the last reset, in CPU cycles
+
     // uint32_t counter; //for debug
 } SoundEngine;
\ No newline at end of file
@@ -25,4 +25,65 @@ int32_t sound_engine_output_highpass(SoundEngineFilter* flt) {
 
 int32_t sound_engine_output_bandpass(SoundEngineFilter* flt) {
     return flt->band * 8;
-}
\ No newline at end of file
+}
+
+#define FILTER_BLOCK(output)                           \
+    for(uint32_t i = 0; i < size; ++i) {               \
+        sound_engine_filter_cycle(flt, buffer[i]);     \
+        buffer[i] = (output);                          \
+    }
+
+// Run the filter over size samples of buffer in place, with the filter_mode picked once
+void sound_engine_filter_block(
+    SoundEngineFilter* flt,
+    uint8_t mode,
+    int32_t* buffer,
+    uint32_t size) {
+    switch(mode) {
+    case FIL_OUTPUT_LOWPASS: {
+        FILTER_BLOCK(sound_engine_output_lowpass(flt));
+        break;
+    }
+
+    case FIL_OUTPUT_HIGHPASS: {
+        FILTER_BLOCK(sound_engine_output_highpass(flt));
+        break;
+    }
+
+    case FIL_OUTPUT_BANDPASS: {
+        FILTER_BLOCK(sound_engine_output_bandpass(flt));
+        break;
+    }
+
+    case FIL_OUTPUT_LOW_HIGH: {
+        FILTER_BLOCK(sound_engine_output_lowpass(flt) + sound_engine_output_highpass(flt));
+        break;
+    }
+
+    case FIL_OUTPUT_HIGH_BAND: {
+        FILTER_BLOCK(sound_engine_output_highpass(flt) + sound_engine_output_bandpass(flt));
+        break;
+    }
+
+    case FIL_OUTPUT_LOW_BAND: {
+        FILTER_BLOCK(sound_engine_output_lowpass(flt) + sound_engine_output_bandpass(flt));
+        break;
+    }
+
+    case FIL_OUTPUT_LOW_HIGH_BAND: {
+        FILTER_BLOCK(
+            sound_engine_output_lowpass(flt) + sound_engine_output_highpass(flt) +
+            sound_engine_output_bandpass(flt));
+        break;
+    }
+
+    default: {
+        // Unknown modes keep the filter running but don't change the output
+        for(uint32_t i = 0; i < size; ++i) {
+            sound_engine_filter_cycle(flt, buffer[i]);
+        }
+
+        break;
+    }
+    }
+}
@@ -6,4 +6,9 @@ void sound_engine_filter_set_coeff(SoundEngineFilter* flt, uint32_t frequency, u
 void sound_engine_filter_cycle(SoundEngineFilter* flt, int32_t input);
 int32_t sound_engine_output_lowpass(SoundEngineFilter* flt);
 int32_t sound_engine_output_highpass(SoundEngineFilter* flt);
-int32_t sound_engine_output_bandpass(SoundEngineFilter* flt);
\ No newline at end of file
+int32_t sound_engine_output_bandpass(SoundEngineFilter* flt);
+void sound_engine_filter_block(
+    SoundEngineFilter* flt,
+    uint8_t mode,
+    int32_t* buffer,
+    uint32_t size);
\ No newline at end of file
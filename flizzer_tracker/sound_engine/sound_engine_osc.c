@@ -1,4 +1,5 @@
 #include "sound_engine_osc.h"
+#include "sound_engine_wavetable.h"
 
 static inline uint16_t sound_engine_pulse(uint32_t acc, uint32_t pw) // 0-FFF pulse width range
 {
@@ -275,4 +276,79 @@ uint16_t
     }
 
     return WAVE_AMP / 2;
-}
\ No newline at end of file
+}
+
+void sound_engine_osc_block(
+    SoundEngine* sound_engine,
+    SoundEngineChannel* channel,
+    int32_t* output,
+    uint32_t size) {
+    uint8_t octave = sound_engine_wavetable_octave(channel->frequency);
+
+    // Single waveforms are read from the band-limited tables, combinations and noise
+    // go through sound_engine_osc()
+    switch(channel->waveform) {
+    case SE_WAVEFORM_PULSE: {
+        // saw(p) - saw(p + d) is a band-limited pulse, low until the pulse width like the
+        // plain one; dc brings its levels back around 0
+        const int16_t* table = sound_engine_wavetable_saw[octave];
+        uint32_t threshold = (uint32_t)(channel->pw == 0xfff ? channel->pw + 1 : channel->pw)
+                             << (ACC_BITS - 1 - 12);
+        uint32_t offset = ACC_LENGTH - threshold;
+        int32_t dc = ((((int32_t)offset - ACC_LENGTH / 2) >> (ACC_BITS - 1 - OUTPUT_BITS)) *
+                      WT_SAW_GAIN) >>
+                     15;
+
+        for(uint32_t i = 0; i < size; ++i) {
+            sound_engine_osc_advance(channel);
+            output[i] = sound_engine_wavetable_lookup(table, channel->accumulator) -
+                        sound_engine_wavetable_lookup(
+                            table, (channel->accumulator + offset) & (ACC_LENGTH - 1)) +
+                        dc;
+        }
+
+        break;
+    }
+
+    case SE_WAVEFORM_TRIANGLE: {
+        const int16_t* table = sound_engine_wavetable_triangle[octave];
+
+        for(uint32_t i = 0; i < size; ++i) {
+            sound_engine_osc_advance(channel);
+            output[i] = sound_engine_wavetable_lookup(table, channel->accumulator);
+        }
+
+        break;
+    }
+
+    case SE_WAVEFORM_SAW: {
+        const int16_t* table = sound_engine_wavetable_saw[octave];
+
+        for(uint32_t i = 0; i < size; ++i) {
+            sound_engine_osc_advance(channel);
+            output[i] = sound_engine_wavetable_lookup(table, channel->accumulator);
+        }
+
+        break;
+    }
+
+    case SE_WAVEFORM_SINE: {
+        for(uint32_t i = 0; i < size; ++i) {
+            sound_engine_osc_advance(channel);
+            output[i] =
+                sound_engine_wavetable_lookup(sound_engine_wavetable_sine, channel->accumulator);
+        }
+
+        break;
+    }
+
+    default: {
+        for(uint32_t i = 0; i < size; ++i) {
+            uint32_t prev_acc = sound_engine_osc_advance(channel);
+            output[i] = sound_engine_osc(sound_engine, channel, prev_acc) - WAVE_AMP / 2;
+        }
+
+        break;
+    }
+    }
+}
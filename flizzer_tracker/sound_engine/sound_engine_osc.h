@@ -2,7 +2,27 @@
 
 #include "sound_engine_defs.h"
 
+// Step the phase accumulator by one sample, returns the previous value
+static inline uint32_t sound_engine_osc_advance(SoundEngineChannel* channel) {
+    uint32_t prev_acc = channel->accumulator;
+
+    channel->accumulator += channel->frequency;
+
+    channel->sync_bit |= (channel->accumulator & ACC_LENGTH);
+
+    channel->accumulator &= ACC_LENGTH - 1;
+
+    return prev_acc;
+}
+
 uint16_t sound_engine_triangle(uint32_t acc);
 
 uint16_t
-    sound_engine_osc(SoundEngine* sound_engine, SoundEngineChannel* channel, uint32_t prev_acc);
\ No newline at end of file
+    sound_engine_osc(SoundEngine* sound_engine, SoundEngineChannel* channel, uint32_t prev_acc);
+
+// Advance the oscillator for size samples, output is centered like in sound_engine_fill_buffer()
+void sound_engine_osc_block(
+    SoundEngine* sound_engine,
+    SoundEngineChannel* channel,
+    int32_t* output,
+    uint32_t size);
\ No newline at end of file
@@ -0,0 +1,404 @@
+#include "sound_engine_wavetable.h"
+
+// Generated: sum of the first 2^octave harmonics (up to 127) of the centered waveform,
+// scaled so that the Gibbs overshoot of the richest table still fits in int16.
+// Saw gain 0.854, triangle gain 1.000. The last entry repeats the first for the
+// interpolation.
+
+const int16_t sound_engine_wavetable_saw[WT_OCTAVES][WT_SIZE + 1] = {
+    {
+        0, -437, -874, -1310, -1746, -2180, -2613, -3045, -3475, -3903, -4328, -4751, -5170,
+        -5587, -6001, -6410, -6816, -7218, -7615, -8008, -8396, -8779, -9157, -9529, -9896,
+        -10256, -10610, -10958, -11300, -11634, -11962, -12282, -12595, -12900, -13197, -13487,
+        -13769, -14042, -14306, -14562, -14810, -15048, -15277, -15498, -15708, -15910, -16101,
+        -16283, -16456, -16618, -16770, -16913, -17045, -17166, -17278, -17379, -17469, -17549,
+        -17619, -17678, -17726, -17763, -17790, -17806, -17812, -17806, -17790, -17763, -17726,
+        -17678, -17619, -17549, -17469, -17379, -17278, -17166, -17045, -16913, -16770, -16618,
+        -16456, -16283, -16101, -15910, -15708, -15498, -15277, -15048, -14810, -14562, -14306,
+        -14042, -13769, -13487, -13197, -12900, -12595, -12282, -11962, -11634, -11300, -10958,
+        -10610, -10256, -9896, -9529, -9157, -8779, -8396, -8008, -7615, -7218, -6816, -6410,
+        -6001, -5587, -5170, -4751, -4328, -3903, -3475, -3045, -2613, -2180, -1746, -1310, -874,
+        -437, 0, 437, 874, 1310, 1746, 2180, 2613, 3045, 3475, 3903, 4328, 4751, 5170, 5587, 6001,
+        6410, 6816, 7218, 7615, 8008, 8396, 8779, 9157, 9529, 9896, 10256, 10610, 10958, 11300,
+        11634, 11962, 12282, 12595, 12900, 13197, 13487, 13769, 14042, 14306, 14562, 14810, 15048,
+        15277, 15498, 15708, 15910, 16101, 16283, 16456, 16618, 16770, 16913, 17045, 17166, 17278,
+        17379, 17469, 17549, 17619, 17678, 17726, 17763, 17790, 17806, 17812, 17806, 17790, 17763,
+        17726, 17678, 17619, 17549, 17469, 17379, 17278, 17166, 17045, 16913, 16770, 16618, 16456,
+        16283, 16101, 15910, 15708, 15498, 15277, 15048, 14810, 14562, 14306, 14042, 13769, 13487,
+        13197, 12900, 12595, 12282, 11962, 11634, 11300, 10958, 10610, 10256, 9896, 9529, 9157,
+        8779, 8396, 8008, 7615, 7218, 6816, 6410, 6001, 5587, 5170, 4751, 4328, 3903, 3475, 3045,
+        2613, 2180, 1746, 1310, 874, 437, 0,
+    },
+    {
+        0, -874, -1747, -2617, -3483, -4344, -5199, -6045, -6883, -7710, -8526, -9329, -10118,
+        -10892, -11650, -12391, -13114, -13817, -14500, -15161, -15801, -16418, -17011, -17580,
+        -18123, -18641, -19133, -19597, -20034, -20443, -20824, -21177, -21500, -21795, -22060,
+        -22296, -22503, -22681, -22829, -22948, -23038, -23099, -23132, -23136, -23113, -23063,
+        -22986, -22882, -22753, -22599, -22420, -22218, -21992, -21745, -21476, -21186, -20877,
+        -20550, -20204, -19842, -19463, -19070, -18663, -18243, -17812, -17369, -16917, -16457,
+        -15988, -15514, -15034, -14549, -14061, -13571, -13080, -12588, -12097, -11607, -11121,
+        -10637, -10158, -9685, -9217, -8757, -8304, -7859, -7423, -6997, -6582, -6177, -5784,
+        -5403, -5034, -4678, -4335, -4005, -3689, -3387, -3099, -2825, -2565, -2319, -2088, -1871,
+        -1668, -1478, -1303, -1141, -991, -855, -731, -619, -519, -430, -351, -282, -223, -172,
+        -130, -95, -67, -45, -28, -16, -8, -4, -1, 0, 0, 0, 1, 4, 8, 16, 28, 45, 67, 95, 130, 172,
+        223, 282, 351, 430, 519, 619, 731, 855, 991, 1141, 1303, 1478, 1668, 1871, 2088, 2319,
+        2565, 2825, 3099, 3387, 3689, 4005, 4335, 4678, 5034, 5403, 5784, 6177, 6582, 6997, 7423,
+        7859, 8304, 8757, 9217, 9685, 10158, 10637, 11121, 11607, 12097, 12588, 13080, 13571,
+        14061, 14549, 15034, 15514, 15988, 16457, 16917, 17369, 17812, 18243, 18663, 19070, 19463,
+        19842, 20204, 20550, 20877, 21186, 21476, 21745, 21992, 22218, 22420, 22599, 22753, 22882,
+        22986, 23063, 23113, 23136, 23132, 23099, 23038, 22948, 22829, 22681, 22503, 22296, 22060,
+        21795, 21500, 21177, 20824, 20443, 20034, 19597, 19133, 18641, 18123, 17580, 17011, 16418,
+        15801, 15161, 14500, 13817, 13114, 12391, 11650, 10892, 10118, 9329, 8526, 7710, 6883,
+        6045, 5199, 4344, 3483, 2617, 1747, 874, 0,
+    },
+    {
+        0, -1747, -3487, -5210, -6911, -8580, -10211, -11797, -13330, -14805, -16216, -17556,
+        -18822, -20008, -21110, -22126, -23052, -23886, -24626, -25272, -25824, -26281, -26644,
+        -26915, -27095, -27188, -27197, -27124, -26974, -26752, -26462, -26109, -25699, -25237,
+        -24728, -24180, -23598, -22987, -22355, -21706, -21047, -20384, -19721, -19064, -18417,
+        -17787, -17176, -16588, -16028, -15498, -15000, -14538, -14112, -13724, -13374, -13064,
+        -12792, -12559, -12363, -12203, -12078, -11985, -11921, -11886, -11874, -11885, -11913,
+        -11956, -12011, -12073, -12140, -12208, -12273, -12333, -12383, -12421, -12444, -12450,
+        -12436, -12399, -12339, -12254, -12142, -12003, -11835, -11640, -11417, -11166, -10889,
+        -10586, -10258, -9908, -9537, -9147, -8740, -8319, -7887, -7446, -6999, -6548, -6097,
+        -5648, -5204, -4768, -4342, -3929, -3530, -3149, -2786, -2444, -2123, -1825, -1551, -1301,
+        -1076, -875, -698, -545, -414, -305, -217, -146, -93, -54, -28, -12, -4, 0, 0, 0, 4, 12,
+        28, 54, 93, 146, 217, 305, 414, 545, 698, 875, 1076, 1301, 1551, 1825, 2123, 2444, 2786,
+        3149, 3530, 3929, 4342, 4768, 5204, 5648, 6097, 6548, 6999, 7446, 7887, 8319, 8740, 9147,
+        9537, 9908, 10258, 10586, 10889, 11166, 11417, 11640, 11835, 12003, 12142, 12254, 12339,
+        12399, 12436, 12450, 12444, 12421, 12383, 12333, 12273, 12208, 12140, 12073, 12011, 11956,
+        11913, 11885, 11874, 11886, 11921, 11985, 12078, 12203, 12363, 12559, 12792, 13064, 13374,
+        13724, 14112, 14538, 15000, 15498, 16028, 16588, 17176, 17787, 18417, 19064, 19721, 20384,
+        21047, 21706, 22355, 22987, 23598, 24180, 24728, 25237, 25699, 26109, 26462, 26752, 26974,
+        27124, 27197, 27188, 27095, 26915, 26644, 26281, 25824, 25272, 24626, 23886, 23052, 22126,
+        21110, 20008, 18822, 17556, 16216, 14805, 13330, 11797, 10211, 8580, 6911, 5210, 3487,
+        1747, 0,
+    },
+    {
+        0, -3488, -6923, -10253, -13428, -16403, -19138, -21598, -23757, -25594, -27098, -28264,
+        -29097, -29607, -29813, -29739, -29416, -28877, -28160, -27304, -26350, -25337, -24303,
+        -23284, -22312, -21414, -20613, -19927, -19365, -18936, -18638, -18466, -18412, -18461,
+        -18596, -18798, -19046, -19316, -19589, -19842, -20057, -20218, -20310, -20324, -20252,
+        -20093, -19847, -19518, -19115, -18648, -18129, -17574, -16998, -16416, -15845, -15299,
+        -14791, -14332, -13932, -13596, -13327, -13126, -12991, -12915, -12892, -12912, -12963,
+        -13034, -13111, -13182, -13234, -13257, -13240, -13176, -13059, -12886, -12656, -12370,
+        -12032, -11649, -11228, -10778, -10310, -9835, -9363, -8907, -8475, -8076, -7718, -7407,
+        -7145, -6934, -6772, -6658, -6585, -6548, -6538, -6545, -6560, -6573, -6573, -6552, -6501,
+        -6414, -6284, -6108, -5886, -5616, -5303, -4949, -4562, -4148, -3717, -3277, -2838, -2410,
+        -2002, -1621, -1274, -968, -705, -488, -316, -187, -98, -42, -13, -2, 0, 2, 13, 42, 98,
+        187, 316, 488, 705, 968, 1274, 1621, 2002, 2410, 2838, 3277, 3717, 4148, 4562, 4949, 5303,
+        5616, 5886, 6108, 6284, 6414, 6501, 6552, 6573, 6573, 6560, 6545, 6538, 6548, 6585, 6658,
+        6772, 6934, 7145, 7407, 7718, 8076, 8475, 8907, 9363, 9835, 10310, 10778, 11228, 11649,
+        12032, 12370, 12656, 12886, 13059, 13176, 13240, 13257, 13234, 13182, 13111, 13034, 12963,
+        12912, 12892, 12915, 12991, 13126, 13327, 13596, 13932, 14332, 14791, 15299, 15845, 16416,
+        16998, 17574, 18129, 18648, 19115, 19518, 19847, 20093, 20252, 20324, 20310, 20218, 20057,
+        19842, 19589, 19316, 19046, 18798, 18596, 18461, 18412, 18466, 18638, 18936, 19365, 19927,
+        20613, 21414, 22312, 23284, 24303, 25337, 26350, 27304, 28160, 28877, 29416, 29739, 29813,
+        29607, 29097, 28264, 27098, 25594, 23757, 21598, 19138, 16403, 13428, 10253, 6923, 3488,
+        0,
+    },
+    {
+        0, -6929, -13474, -19287, -24092, -27706, -30056, -31181, -31219, -30390, -28965, -27234,
+        -25474, -23918, -22738, -22027, -21799, -21997, -22511, -23194, -23891, -24459, -24789,
+        -24817, -24529, -23962, -23191, -22316, -21448, -20688, -20113, -19767, -19657, -19751,
+        -19989, -20292, -20573, -20756, -20781, -20618, -20268, -19758, -19143, -18490, -17869,
+        -17342, -16955, -16729, -16659, -16715, -16851, -17006, -17120, -17143, -17038, -16792,
+        -16413, -15930, -15390, -14844, -14345, -13937, -13647, -13483, -13435, -13471, -13549,
+        -13621, -13640, -13570, -13388, -13092, -12696, -12230, -11736, -11257, -10836, -10504,
+        -10277, -10155, -10121, -10143, -10183, -10197, -10151, -10016, -9780, -9448, -9040,
+        -8586, -8125, -7697, -7334, -7058, -6879, -6788, -6765, -6776, -6785, -6756, -6657, -6471,
+        -6193, -5833, -5414, -4970, -4537, -4149, -3833, -3605, -3466, -3401, -3387, -3389, -3373,
+        -3305, -3162, -2931, -2615, -2230, -1803, -1368, -959, -608, -335, -150, -46, -6, 0, 6,
+        46, 150, 335, 608, 959, 1368, 1803, 2230, 2615, 2931, 3162, 3305, 3373, 3389, 3387, 3401,
+        3466, 3605, 3833, 4149, 4537, 4970, 5414, 5833, 6193, 6471, 6657, 6756, 6785, 6776, 6765,
+        6788, 6879, 7058, 7334, 7697, 8125, 8586, 9040, 9448, 9780, 10016, 10151, 10197, 10183,
+        10143, 10121, 10155, 10277, 10504, 10836, 11257, 11736, 12230, 12696, 13092, 13388, 13570,
+        13640, 13621, 13549, 13471, 13435, 13483, 13647, 13937, 14345, 14844, 15390, 15930, 16413,
+        16792, 17038, 17143, 17120, 17006, 16851, 16715, 16659, 16729, 16955, 17342, 17869, 18490,
+        19143, 19758, 20268, 20618, 20781, 20756, 20573, 20292, 19989, 19751, 19657, 19767, 20113,
+        20688, 21448, 22316, 23191, 23962, 24529, 24817, 24789, 24459, 23891, 23194, 22511, 21997,
+        21799, 22027, 22738, 23918, 25474, 27234, 28965, 30390, 31219, 31181, 30056, 27706, 24092,
+        19287, 13474, 6929, 0,
+    },
+    {
+        0, -13497, -24255, -30525, -32107, -30264, -27059, -24445, -23520, -24263, -25803, -27027,
+        -27193, -26257, -24782, -23548, -23099, -23470, -24234, -24787, -24709, -23979, -22951,
+        -22119, -21820, -22059, -22530, -22814, -22633, -21995, -21176, -20537, -20314, -20485,
+        -20799, -20936, -20696, -20112, -19415, -18893, -18716, -18843, -19058, -19101, -18824,
+        -18275, -17660, -17217, -17071, -17169, -17315, -17290, -16987, -16463, -15908, -15522,
+        -15399, -15475, -15569, -15494, -15170, -14666, -14157, -13816, -13711, -13770, -13822,
+        -13707, -13367, -12879, -12407, -12102, -12012, -12056, -12075, -11926, -11572, -11098,
+        -10657, -10383, -10306, -10338, -10327, -10150, -9784, -9321, -8908, -8661, -8595, -8615,
+        -8579, -8376, -8000, -7547, -7159, -6936, -6879, -6891, -6831, -6605, -6220, -5776, -5410,
+        -5209, -5162, -5164, -5082, -4836, -4441, -4006, -3661, -3481, -3442, -3436, -3334, -3067,
+        -2664, -2237, -1912, -1752, -1721, -1707, -1585, -1299, -888, -469, -163, -22, 0, 22, 163,
+        469, 888, 1299, 1585, 1707, 1721, 1752, 1912, 2237, 2664, 3067, 3334, 3436, 3442, 3481,
+        3661, 4006, 4441, 4836, 5082, 5164, 5162, 5209, 5410, 5776, 6220, 6605, 6831, 6891, 6879,
+        6936, 7159, 7547, 8000, 8376, 8579, 8615, 8595, 8661, 8908, 9321, 9784, 10150, 10327,
+        10338, 10306, 10383, 10657, 11098, 11572, 11926, 12075, 12056, 12012, 12102, 12407, 12879,
+        13367, 13707, 13822, 13770, 13711, 13816, 14157, 14666, 15170, 15494, 15569, 15475, 15399,
+        15522, 15908, 16463, 16987, 17290, 17315, 17169, 17071, 17217, 17660, 18275, 18824, 19101,
+        19058, 18843, 18716, 18893, 19415, 20112, 20696, 20936, 20799, 20485, 20314, 20537, 21176,
+        21995, 22633, 22814, 22530, 22059, 21820, 22119, 22951, 23979, 24709, 24787, 24234, 23470,
+        23099, 23548, 24782, 26257, 27193, 27027, 25803, 24263, 23520, 24445, 27059, 30264, 32107,
+        30525, 24255, 13497, 0,
+    },
+    {
+        0, -24336, -32548, -27853, -24387, -26758, -28515, -26450, -24834, -26063, -26912, -25494,
+        -24422, -25233, -25717, -24593, -23784, -24376, -24662, -23706, -23052, -23511, -23672,
+        -22826, -22274, -22641, -22716, -21948, -21470, -21770, -21781, -21071, -20648, -20897,
+        -20860, -20195, -19815, -20024, -19949, -19320, -18975, -19151, -19043, -18444, -18129,
+        -18277, -18143, -17570, -17278, -17404, -17247, -16695, -16425, -16530, -16353, -15820,
+        -15568, -15656, -15462, -14945, -14710, -14782, -14572, -14071, -13850, -13908, -13684,
+        -13196, -12989, -13033, -12798, -12322, -12126, -12159, -11912, -11447, -11263, -11285,
+        -11027, -10573, -10399, -10411, -10143, -9698, -9534, -9537, -9259, -8824, -8669, -8662,
+        -8376, -7950, -7803, -7788, -7493, -7075, -6937, -6914, -6611, -6201, -6070, -6040, -5729,
+        -5327, -5204, -5165, -4847, -4452, -4337, -4291, -3966, -3578, -3470, -3417, -3084, -2704,
+        -2602, -2542, -2203, -1829, -1735, -1668, -1322, -955, -867, -794, -441, -81, 0, 81, 441,
+        794, 867, 955, 1322, 1668, 1735, 1829, 2203, 2542, 2602, 2704, 3084, 3417, 3470, 3578,
+        3966, 4291, 4337, 4452, 4847, 5165, 5204, 5327, 5729, 6040, 6070, 6201, 6611, 6914, 6937,
+        7075, 7493, 7788, 7803, 7950, 8376, 8662, 8669, 8824, 9259, 9537, 9534, 9698, 10143,
+        10411, 10399, 10573, 11027, 11285, 11263, 11447, 11912, 12159, 12126, 12322, 12798, 13033,
+        12989, 13196, 13684, 13908, 13850, 14071, 14572, 14782, 14710, 14945, 15462, 15656, 15568,
+        15820, 16353, 16530, 16425, 16695, 17247, 17404, 17278, 17570, 18143, 18277, 18129, 18444,
+        19043, 19151, 18975, 19320, 19949, 20024, 19815, 20195, 20860, 20897, 20648, 21071, 21781,
+        21770, 21470, 21948, 22716, 22641, 22274, 22826, 23672, 23511, 23052, 23706, 24662, 24376,
+        23784, 24593, 25717, 25233, 24422, 25494, 26912, 26063, 24834, 26450, 28515, 26758, 24387,
+        27853, 32548, 24336, 0,
+    },
+    {
+        0, -32767, -24823, -29174, -25705, -28009, -25729, -27253, -25525, -26637, -25230, -26085,
+        -24887, -25569, -24518, -25073, -24132, -24591, -23734, -24118, -23329, -23652, -22918,
+        -23191, -22503, -22733, -22085, -22279, -21664, -21827, -21241, -21376, -20816, -20927,
+        -20390, -20480, -19962, -20033, -19534, -19588, -19105, -19143, -18675, -18699, -18245,
+        -18255, -17814, -17812, -17382, -17369, -16951, -16927, -16518, -16485, -16086, -16043,
+        -15653, -15602, -15220, -15161, -14787, -14720, -14353, -14279, -13920, -13838, -13486,
+        -13398, -13052, -12958, -12618, -12518, -12183, -12078, -11749, -11638, -11315, -11198,
+        -10880, -10758, -10445, -10319, -10011, -9879, -9576, -9440, -9141, -9000, -8706, -8561,
+        -8271, -8121, -7836, -7682, -7401, -7243, -6966, -6804, -6531, -6365, -6095, -5926, -5660,
+        -5487, -5225, -5048, -4790, -4609, -4354, -4170, -3919, -3731, -3483, -3292, -3048, -2853,
+        -2613, -2414, -2177, -1975, -1742, -1536, -1306, -1097, -871, -658, -435, -219, 0, 219,
+        435, 658, 871, 1097, 1306, 1536, 1742, 1975, 2177, 2414, 2613, 2853, 3048, 3292, 3483,
+        3731, 3919, 4170, 4354, 4609, 4790, 5048, 5225, 5487, 5660, 5926, 6095, 6365, 6531, 6804,
+        6966, 7243, 7401, 7682, 7836, 8121, 8271, 8561, 8706, 9000, 9141, 9440, 9576, 9879, 10011,
+        10319, 10445, 10758, 10880, 11198, 11315, 11638, 11749, 12078, 12183, 12518, 12618, 12958,
+        13052, 13398, 13486, 13838, 13920, 14279, 14353, 14720, 14787, 15161, 15220, 15602, 15653,
+        16043, 16086, 16485, 16518, 16927, 16951, 17369, 17382, 17812, 17814, 18255, 18245, 18699,
+        18675, 19143, 19105, 19588, 19534, 20033, 19962, 20480, 20390, 20927, 20816, 21376, 21241,
+        21827, 21664, 22279, 22085, 22733, 22503, 23191, 22918, 23652, 23329, 24118, 23734, 24591,
+        24132, 25073, 24518, 25569, 24887, 26085, 25230, 26637, 25525, 27253, 25729, 28009, 25705,
+        29174, 24823, 32767, 0,
+    },
+};
+
+const int16_t sound_engine_wavetable_triangle[WT_OCTAVES][WT_SIZE + 1] = {
+    {
+        -26561, -26553, -26529, -26489, -26433, -26361, -26273, -26170, -26050, -25915, -25765,
+        -25599, -25417, -25220, -25008, -24781, -24539, -24282, -24011, -23725, -23424, -23110,
+        -22782, -22440, -22084, -21716, -21334, -20939, -20532, -20112, -19680, -19237, -18781,
+        -18315, -17837, -17349, -16850, -16341, -15822, -15294, -14756, -14210, -13655, -13092,
+        -12521, -11942, -11356, -10764, -10164, -9559, -8948, -8332, -7710, -7084, -6454, -5819,
+        -5182, -4541, -3897, -3251, -2603, -1954, -1303, -652, 0, 652, 1303, 1954, 2603, 3251,
+        3897, 4541, 5182, 5819, 6454, 7084, 7710, 8332, 8948, 9559, 10164, 10764, 11356, 11942,
+        12521, 13092, 13655, 14210, 14756, 15294, 15822, 16341, 16850, 17349, 17837, 18315, 18781,
+        19237, 19680, 20112, 20532, 20939, 21334, 21716, 22084, 22440, 22782, 23110, 23424, 23725,
+        24011, 24282, 24539, 24781, 25008, 25220, 25417, 25599, 25765, 25915, 26050, 26170, 26273,
+        26361, 26433, 26489, 26529, 26553, 26561, 26553, 26529, 26489, 26433, 26361, 26273, 26170,
+        26050, 25915, 25765, 25599, 25417, 25220, 25008, 24781, 24539, 24282, 24011, 23725, 23424,
+        23110, 22782, 22440, 22084, 21716, 21334, 20939, 20532, 20112, 19680, 19237, 18781, 18315,
+        17837, 17349, 16850, 16341, 15822, 15294, 14756, 14210, 13655, 13092, 12521, 11942, 11356,
+        10764, 10164, 9559, 8948, 8332, 7710, 7084, 6454, 5819, 5182, 4541, 3897, 3251, 2603,
+        1954, 1303, 652, 0, -652, -1303, -1954, -2603, -3251, -3897, -4541, -5182, -5819, -6454,
+        -7084, -7710, -8332, -8948, -9559, -10164, -10764, -11356, -11942, -12521, -13092, -13655,
+        -14210, -14756, -15294, -15822, -16341, -16850, -17349, -17837, -18315, -18781, -19237,
+        -19680, -20112, -20532, -20939, -21334, -21716, -22084, -22440, -22782, -23110, -23424,
+        -23725, -24011, -24282, -24539, -24781, -25008, -25220, -25417, -25599, -25765, -25915,
+        -26050, -26170, -26273, -26361, -26433, -26489, -26529, -26553, -26561,
+    },
+    {
+        -26561, -26553, -26529, -26489, -26433, -26361, -26273, -26170, -26050, -25915, -25765,
+        -25599, -25417, -25220, -25008, -24781, -24539, -24282, -24011, -23725, -23424, -23110,
+        -22782, -22440, -22084, -21716, -21334, -20939, -20532, -20112, -19680, -19237, -18781,
+        -18315, -17837, -17349, -16850, -16341, -15822, -15294, -14756, -14210, -13655, -13092,
+        -12521, -11942, -11356, -10764, -10164, -9559, -8948, -8332, -7710, -7084, -6454, -5819,
+        -5182, -4541, -3897, -3251, -2603, -1954, -1303, -652, 0, 652, 1303, 1954, 2603, 3251,
+        3897, 4541, 5182, 5819, 6454, 7084, 7710, 8332, 8948, 9559, 10164, 10764, 11356, 11942,
+        12521, 13092, 13655, 14210, 14756, 15294, 15822, 16341, 16850, 17349, 17837, 18315, 18781,
+        19237, 19680, 20112, 20532, 20939, 21334, 21716, 22084, 22440, 22782, 23110, 23424, 23725,
+        24011, 24282, 24539, 24781, 25008, 25220, 25417, 25599, 25765, 25915, 26050, 26170, 26273,
+        26361, 26433, 26489, 26529, 26553, 26561, 26553, 26529, 26489, 26433, 26361, 26273, 26170,
+        26050, 25915, 25765, 25599, 25417, 25220, 25008, 24781, 24539, 24282, 24011, 23725, 23424,
+        23110, 22782, 22440, 22084, 21716, 21334, 20939, 20532, 20112, 19680, 19237, 18781, 18315,
+        17837, 17349, 16850, 16341, 15822, 15294, 14756, 14210, 13655, 13092, 12521, 11942, 11356,
+        10764, 10164, 9559, 8948, 8332, 7710, 7084, 6454, 5819, 5182, 4541, 3897, 3251, 2603,
+        1954, 1303, 652, 0, -652, -1303, -1954, -2603, -3251, -3897, -4541, -5182, -5819, -6454,
+        -7084, -7710, -8332, -8948, -9559, -10164, -10764, -11356, -11942, -12521, -13092, -13655,
+        -14210, -14756, -15294, -15822, -16341, -16850, -17349, -17837, -18315, -18781, -19237,
+        -19680, -20112, -20532, -20939, -21334, -21716, -22084, -22440, -22782, -23110, -23424,
+        -23725, -24011, -24282, -24539, -24781, -25008, -25220, -25417, -25599, -25765, -25915,
+        -26050, -26170, -26273, -26361, -26433, -26489, -26529, -26553, -26561,
+    },
+    {
+        -29512, -29496, -29448, -29368, -29257, -29114, -28941, -28737, -28504, -28242, -27951,
+        -27634, -27289, -26919, -26525, -26108, -25668, -25208, -24728, -24229, -23714, -23183,
+        -22637, -22079, -21509, -20929, -20340, -19743, -19141, -18533, -17922, -17309, -16694,
+        -16080, -15467, -14855, -14247, -13643, -13044, -12450, -11862, -11281, -10707, -10141,
+        -9584, -9034, -8493, -7961, -7438, -6923, -6417, -5919, -5429, -4947, -4472, -4004, -3542,
+        -3086, -2635, -2189, -1747, -1307, -870, -435, 0, 435, 870, 1307, 1747, 2189, 2635, 3086,
+        3542, 4004, 4472, 4947, 5429, 5919, 6417, 6923, 7438, 7961, 8493, 9034, 9584, 10141,
+        10707, 11281, 11862, 12450, 13044, 13643, 14247, 14855, 15467, 16080, 16694, 17309, 17922,
+        18533, 19141, 19743, 20340, 20929, 21509, 22079, 22637, 23183, 23714, 24229, 24728, 25208,
+        25668, 26108, 26525, 26919, 27289, 27634, 27951, 28242, 28504, 28737, 28941, 29114, 29257,
+        29368, 29448, 29496, 29512, 29496, 29448, 29368, 29257, 29114, 28941, 28737, 28504, 28242,
+        27951, 27634, 27289, 26919, 26525, 26108, 25668, 25208, 24728, 24229, 23714, 23183, 22637,
+        22079, 21509, 20929, 20340, 19743, 19141, 18533, 17922, 17309, 16694, 16080, 15467, 14855,
+        14247, 13643, 13044, 12450, 11862, 11281, 10707, 10141, 9584, 9034, 8493, 7961, 7438,
+        6923, 6417, 5919, 5429, 4947, 4472, 4004, 3542, 3086, 2635, 2189, 1747, 1307, 870, 435, 0,
+        -435, -870, -1307, -1747, -2189, -2635, -3086, -3542, -4004, -4472, -4947, -5429, -5919,
+        -6417, -6923, -7438, -7961, -8493, -9034, -9584, -10141, -10707, -11281, -11862, -12450,
+        -13044, -13643, -14247, -14855, -15467, -16080, -16694, -17309, -17922, -18533, -19141,
+        -19743, -20340, -20929, -21509, -22079, -22637, -23183, -23714, -24229, -24728, -25208,
+        -25668, -26108, -26525, -26919, -27289, -27634, -27951, -28242, -28504, -28737, -28941,
+        -29114, -29257, -29368, -29448, -29496, -29512,
+    },
+    {
+        -31116, -31084, -30989, -30831, -30613, -30337, -30007, -29627, -29200, -28733, -28230,
+        -27696, -27138, -26560, -25968, -25367, -24761, -24155, -23553, -22959, -22374, -21801,
+        -21241, -20696, -20166, -19649, -19147, -18656, -18177, -17706, -17243, -16783, -16327,
+        -15870, -15410, -14947, -14478, -14002, -13517, -13023, -12520, -12007, -11484, -10954,
+        -10415, -9870, -9320, -8767, -8212, -7657, -7104, -6554, -6008, -5469, -4936, -4411,
+        -3894, -3385, -2884, -2391, -1904, -1423, -946, -472, 0, 472, 946, 1423, 1904, 2391, 2884,
+        3385, 3894, 4411, 4936, 5469, 6008, 6554, 7104, 7657, 8212, 8767, 9320, 9870, 10415,
+        10954, 11484, 12007, 12520, 13023, 13517, 14002, 14478, 14947, 15410, 15870, 16327, 16783,
+        17243, 17706, 18177, 18656, 19147, 19649, 20166, 20696, 21241, 21801, 22374, 22959, 23553,
+        24155, 24761, 25367, 25968, 26560, 27138, 27696, 28230, 28733, 29200, 29627, 30007, 30337,
+        30613, 30831, 30989, 31084, 31116, 31084, 30989, 30831, 30613, 30337, 30007, 29627, 29200,
+        28733, 28230, 27696, 27138, 26560, 25968, 25367, 24761, 24155, 23553, 22959, 22374, 21801,
+        21241, 20696, 20166, 19649, 19147, 18656, 18177, 17706, 17243, 16783, 16327, 15870, 15410,
+        14947, 14478, 14002, 13517, 13023, 12520, 12007, 11484, 10954, 10415, 9870, 9320, 8767,
+        8212, 7657, 7104, 6554, 6008, 5469, 4936, 4411, 3894, 3385, 2884, 2391, 1904, 1423, 946,
+        472, 0, -472, -946, -1423, -1904, -2391, -2884, -3385, -3894, -4411, -4936, -5469, -6008,
+        -6554, -7104, -7657, -8212, -8767, -9320, -9870, -10415, -10954, -11484, -12007, -12520,
+        -13023, -13517, -14002, -14478, -14947, -15410, -15870, -16327, -16783, -17243, -17706,
+        -18177, -18656, -19147, -19649, -20166, -20696, -21241, -21801, -22374, -22959, -23553,
+        -24155, -24761, -25367, -25968, -26560, -27138, -27696, -28230, -28733, -29200, -29627,
+        -30007, -30337, -30613, -30831, -30989, -31084, -31116,
+    },
+    {
+        -31939, -31875, -31687, -31385, -30982, -30497, -29953, -29369, -28768, -28166, -27578,
+        -27012, -26474, -25964, -25476, -25005, -24543, -24081, -23611, -23129, -22630, -22114,
+        -21584, -21043, -20496, -19948, -19407, -18874, -18354, -17845, -17348, -16860, -16376,
+        -15891, -15403, -14907, -14401, -13886, -13361, -12829, -12293, -11757, -11225, -10699,
+        -10182, -9674, -9174, -8680, -8189, -7699, -7205, -6705, -6197, -5682, -5158, -4629,
+        -4097, -3565, -3036, -2513, -1996, -1488, -987, -492, 0, 492, 987, 1488, 1996, 2513, 3036,
+        3565, 4097, 4629, 5158, 5682, 6197, 6705, 7205, 7699, 8189, 8680, 9174, 9674, 10182,
+        10699, 11225, 11757, 12293, 12829, 13361, 13886, 14401, 14907, 15403, 15891, 16376, 16860,
+        17348, 17845, 18354, 18874, 19407, 19948, 20496, 21043, 21584, 22114, 22630, 23129, 23611,
+        24081, 24543, 25005, 25476, 25964, 26474, 27012, 27578, 28166, 28768, 29369, 29953, 30497,
+        30982, 31385, 31687, 31875, 31939, 31875, 31687, 31385, 30982, 30497, 29953, 29369, 28768,
+        28166, 27578, 27012, 26474, 25964, 25476, 25005, 24543, 24081, 23611, 23129, 22630, 22114,
+        21584, 21043, 20496, 19948, 19407, 18874, 18354, 17845, 17348, 16860, 16376, 15891, 15403,
+        14907, 14401, 13886, 13361, 12829, 12293, 11757, 11225, 10699, 10182, 9674, 9174, 8680,
+        8189, 7699, 7205, 6705, 6197, 5682, 5158, 4629, 4097, 3565, 3036, 2513, 1996, 1488, 987,
+        492, 0, -492, -987, -1488, -1996, -2513, -3036, -3565, -4097, -4629, -5158, -5682, -6197,
+        -6705, -7205, -7699, -8189, -8680, -9174, -9674, -10182, -10699, -11225, -11757, -12293,
+        -12829, -13361, -13886, -14401, -14907, -15403, -15891, -16376, -16860, -17348, -17845,
+        -18354, -18874, -19407, -19948, -20496, -21043, -21584, -22114, -22630, -23129, -23611,
+        -24081, -24543, -25005, -25476, -25964, -26474, -27012, -27578, -28166, -28768, -29369,
+        -29953, -30497, -30982, -31385, -31687, -31875, -31939,
+    },
+    {
+        -32353, -32227, -31875, -31360, -30768, -30174, -29622, -29123, -28655, -28188, -27697,
+        -27175, -26632, -26089, -25563, -25060, -24571, -24083, -23582, -23062, -22531, -22000,
+        -21479, -20974, -20478, -19982, -19477, -18960, -18434, -17907, -17389, -16882, -16383,
+        -15884, -15377, -14861, -14337, -13813, -13296, -12788, -12287, -11786, -11279, -10763,
+        -10240, -9718, -9202, -8694, -8192, -7690, -7182, -6666, -6144, -5623, -5107, -4599,
+        -4096, -3593, -3085, -2569, -2048, -1527, -1011, -503, 0, 503, 1011, 1527, 2048, 2569,
+        3085, 3593, 4096, 4599, 5107, 5623, 6144, 6666, 7182, 7690, 8192, 8694, 9202, 9718, 10240,
+        10763, 11279, 11786, 12287, 12788, 13296, 13813, 14337, 14861, 15377, 15884, 16383, 16882,
+        17389, 17907, 18434, 18960, 19477, 19982, 20478, 20974, 21479, 22000, 22531, 23062, 23582,
+        24083, 24571, 25060, 25563, 26089, 26632, 27175, 27697, 28188, 28655, 29123, 29622, 30174,
+        30768, 31360, 31875, 32227, 32353, 32227, 31875, 31360, 30768, 30174, 29622, 29123, 28655,
+        28188, 27697, 27175, 26632, 26089, 25563, 25060, 24571, 24083, 23582, 23062, 22531, 22000,
+        21479, 20974, 20478, 19982, 19477, 18960, 18434, 17907, 17389, 16882, 16383, 15884, 15377,
+        14861, 14337, 13813, 13296, 12788, 12287, 11786, 11279, 10763, 10240, 9718, 9202, 8694,
+        8192, 7690, 7182, 6666, 6144, 5623, 5107, 4599, 4096, 3593, 3085, 2569, 2048, 1527, 1011,
+        503, 0, -503, -1011, -1527, -2048, -2569, -3085, -3593, -4096, -4599, -5107, -5623, -6144,
+        -6666, -7182, -7690, -8192, -8694, -9202, -9718, -10240, -10763, -11279, -11786, -12287,
+        -12788, -13296, -13813, -14337, -14861, -15377, -15884, -16383, -16882, -17389, -17907,
+        -18434, -18960, -19477, -19982, -20478, -20974, -21479, -22000, -22531, -23062, -23582,
+        -24083, -24571, -25060, -25563, -26089, -26632, -27175, -27697, -28188, -28655, -29123,
+        -29622, -30174, -30768, -31360, -31875, -32227, -32353,
+    },
+    {
+        -32561, -32321, -31768, -31195, -30712, -30232, -29700, -29166, -28670, -28174, -27650,
+        -27124, -26623, -26122, -25601, -25079, -24575, -24072, -23552, -23033, -22528, -22023,
+        -21504, -20986, -20480, -19974, -19456, -18939, -18432, -17925, -17408, -16891, -16384,
+        -15876, -15360, -14844, -14336, -13828, -13312, -12796, -12288, -11780, -11264, -10748,
+        -10240, -9732, -9216, -8700, -8192, -7683, -7168, -6653, -6144, -5635, -5120, -4605,
+        -4096, -3587, -3072, -2557, -2048, -1539, -1024, -509, 0, 509, 1024, 1539, 2048, 2557,
+        3072, 3587, 4096, 4605, 5120, 5635, 6144, 6653, 7168, 7683, 8192, 8700, 9216, 9732, 10240,
+        10748, 11264, 11780, 12288, 12796, 13312, 13828, 14336, 14844, 15360, 15876, 16384, 16891,
+        17408, 17925, 18432, 18939, 19456, 19974, 20480, 20986, 21504, 22023, 22528, 23033, 23552,
+        24072, 24575, 25079, 25601, 26122, 26623, 27124, 27650, 28174, 28670, 29166, 29700, 30232,
+        30712, 31195, 31768, 32321, 32561, 32321, 31768, 31195, 30712, 30232, 29700, 29166, 28670,
+        28174, 27650, 27124, 26623, 26122, 25601, 25079, 24575, 24072, 23552, 23033, 22528, 22023,
+        21504, 20986, 20480, 19974, 19456, 18939, 18432, 17925, 17408, 16891, 16384, 15876, 15360,
+        14844, 14336, 13828, 13312, 12796, 12288, 11780, 11264, 10748, 10240, 9732, 9216, 8700,
+        8192, 7683, 7168, 6653, 6144, 5635, 5120, 4605, 4096, 3587, 3072, 2557, 2048, 1539, 1024,
+        509, 0, -509, -1024, -1539, -2048, -2557, -3072, -3587, -4096, -4605, -5120, -5635, -6144,
+        -6653, -7168, -7683, -8192, -8700, -9216, -9732, -10240, -10748, -11264, -11780, -12288,
+        -12796, -13312, -13828, -14336, -14844, -15360, -15876, -16384, -16891, -17408, -17925,
+        -18432, -18939, -19456, -19974, -20480, -20986, -21504, -22023, -22528, -23033, -23552,
+        -24072, -24575, -25079, -25601, -26122, -26623, -27124, -27650, -28174, -28670, -29166,
+        -29700, -30232, -30712, -31195, -31768, -32321, -32561,
+    },
+    {
+        -32664, -32268, -31740, -31234, -30719, -30209, -29695, -29184, -28672, -28160, -27648,
+        -27136, -26624, -26112, -25600, -25088, -24576, -24064, -23552, -23040, -22528, -22016,
+        -21504, -20992, -20480, -19968, -19456, -18944, -18432, -17920, -17408, -16896, -16384,
+        -15872, -15360, -14848, -14336, -13824, -13312, -12800, -12288, -11776, -11264, -10752,
+        -10240, -9728, -9216, -8704, -8192, -7680, -7168, -6656, -6144, -5632, -5120, -4608,
+        -4096, -3584, -3072, -2560, -2048, -1536, -1024, -512, 0, 512, 1024, 1536, 2048, 2560,
+        3072, 3584, 4096, 4608, 5120, 5632, 6144, 6656, 7168, 7680, 8192, 8704, 9216, 9728, 10240,
+        10752, 11264, 11776, 12288, 12800, 13312, 13824, 14336, 14848, 15360, 15872, 16384, 16896,
+        17408, 17920, 18432, 18944, 19456, 19968, 20480, 20992, 21504, 22016, 22528, 23040, 23552,
+        24064, 24576, 25088, 25600, 26112, 26624, 27136, 27648, 28160, 28672, 29184, 29695, 30209,
+        30719, 31234, 31740, 32268, 32664, 32268, 31740, 31234, 30719, 30209, 29695, 29184, 28672,
+        28160, 27648, 27136, 26624, 26112, 25600, 25088, 24576, 24064, 23552, 23040, 22528, 22016,
+        21504, 20992, 20480, 19968, 19456, 18944, 18432, 17920, 17408, 16896, 16384, 15872, 15360,
+        14848, 14336, 13824, 13312, 12800, 12288, 11776, 11264, 10752, 10240, 9728, 9216, 8704,
+        8192, 7680, 7168, 6656, 6144, 5632, 5120, 4608, 4096, 3584, 3072, 2560, 2048, 1536, 1024,
+        512, 0, -512, -1024, -1536, -2048, -2560, -3072, -3584, -4096, -4608, -5120, -5632, -6144,
+        -6656, -7168, -7680, -8192, -8704, -9216, -9728, -10240, -10752, -11264, -11776, -12288,
+        -12800, -13312, -13824, -14336, -14848, -15360, -15872, -16384, -16896, -17408, -17920,
+        -18432, -18944, -19456, -19968, -20480, -20992, -21504, -22016, -22528, -23040, -23552,
+        -24064, -24576, -25088, -25600, -26112, -26624, -27136, -27648, -28160, -28672, -29184,
+        -29695, -30209, -30719, -31234, -31740, -32268, -32664,
+    },
+};
+
+// Two periods per cycle, the same pitch as the sine LUT of the sound engine
+const int16_t sound_engine_wavetable_sine[WT_SIZE + 1] = {
+    0, 1608, 3212, 4808, 6393, 7962, 9512, 11039, 12539, 14010, 15446, 16846, 18204, 19519, 20787,
+    22005, 23170, 24279, 25329, 26319, 27245, 28105, 28898, 29621, 30273, 30852, 31356, 31785,
+    32137, 32412, 32609, 32728, 32767, 32728, 32609, 32412, 32137, 31785, 31356, 30852, 30273,
+    29621, 28898, 28105, 27245, 26319, 25329, 24279, 23170, 22005, 20787, 19519, 18204, 16846,
+    15446, 14010, 12539, 11039, 9512, 7962, 6393, 4808, 3212, 1608, 0, -1608, -3212, -4808, -6393,
+    -7962, -9512, -11039, -12539, -14010, -15446, -16846, -18204, -19519, -20787, -22005, -23170,
+    -24279, -25329, -26319, -27245, -28105, -28898, -29621, -30273, -30852, -31356, -31785,
+    -32137, -32412, -32609, -32728, -32767, -32728, -32609, -32412, -32137, -31785, -31356,
+    -30852, -30273, -29621, -28898, -28105, -27245, -26319, -25329, -24279, -23170, -22005,
+    -20787, -19519, -18204, -16846, -15446, -14010, -12539, -11039, -9512, -7962, -6393, -4808,
+    -3212, -1608, 0, 1608, 3212, 4808, 6393, 7962, 9512, 11039, 12539, 14010, 15446, 16846, 18204,
+    19519, 20787, 22005, 23170, 24279, 25329, 26319, 27245, 28105, 28898, 29621, 30273, 30852,
+    31356, 31785, 32137, 32412, 32609, 32728, 32767, 32728, 32609, 32412, 32137, 31785, 31356,
+    30852, 30273, 29621, 28898, 28105, 27245, 26319, 25329, 24279, 23170, 22005, 20787, 19519,
+    18204, 16846, 15446, 14010, 12539, 11039, 9512, 7962, 6393, 4808, 3212, 1608, 0, -1608, -3212,
+    -4808, -6393, -7962, -9512, -11039, -12539, -14010, -15446, -16846, -18204, -19519, -20787,
+    -22005, -23170, -24279, -25329, -26319, -27245, -28105, -28898, -29621, -30273, -30852,
+    -31356, -31785, -32137, -32412, -32609, -32728, -32767, -32728, -32609, -32412, -32137,
+    -31785, -31356, -30852, -30273, -29621, -28898, -28105, -27245, -26319, -25329, -24279,
+    -23170, -22005, -20787, -19519, -18204, -16846, -15446, -14010, -12539, -11039, -9512, -7962,
+    -6393, -4808, -3212, -1608, 0,
+};
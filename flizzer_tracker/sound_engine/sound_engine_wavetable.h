@@ -0,0 +1,35 @@
+#pragma once
+
+#include "sound_engine_defs.h"
+
+#define WT_SIZE_BITS 8
+#define WT_SIZE (1 << WT_SIZE_BITS)
+#define WT_OCTAVES 8 // table n holds 2^n harmonics
+
+#define WT_FRAC_BITS (ACC_BITS - 1 - WT_SIZE_BITS)
+
+#define WT_SAW_GAIN 27978 // 0.854 in Q15, the saw tables are scaled down to fit their overshoot
+
+extern const int16_t sound_engine_wavetable_saw[WT_OCTAVES][WT_SIZE + 1];
+extern const int16_t sound_engine_wavetable_triangle[WT_OCTAVES][WT_SIZE + 1];
+extern const int16_t sound_engine_wavetable_sine[WT_SIZE + 1];
+
+// Richest table whose harmonics all stay below Nyquist at this phase increment
+static inline uint8_t sound_engine_wavetable_octave(uint32_t frequency) {
+    uint32_t harmonics = frequency ? (ACC_LENGTH / 2) / frequency : ACC_LENGTH;
+
+    if(harmonics == 0) return 0;
+
+    uint8_t octave = 31 - __builtin_clz(harmonics);
+
+    return octave >= WT_OCTAVES ? WT_OCTAVES - 1 : octave;
+}
+
+// Linearly interpolated table read at accumulator phase acc, centered around 0
+static inline int32_t sound_engine_wavetable_lookup(const int16_t* table, uint32_t acc) {
+    uint32_t index = acc >> WT_FRAC_BITS;
+    int32_t frac = acc & ((1 << WT_FRAC_BITS) - 1);
+    int32_t a = table[index];
+
+    return a + (((table[index + 1] - a) * frac) >> WT_FRAC_BITS);
+}
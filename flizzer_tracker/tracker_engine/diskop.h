@@ -7,6 +7,16 @@
 #include <storage/storage.h>
 #include <toolbox/stream/file_stream.h>
 
-bool load_song(TrackerSong* song, Stream* stream);
-bool load_instrument(Instrument* inst, Stream* stream);
-void load_instrument_inner(Stream* stream, Instrument* inst, uint8_t version);
\ No newline at end of file
+// A song or instrument file read into memory, parsed from the front
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    size_t position;
+} DiskopReader;
+
+// Like stream_read(), fewer bytes at the end of the data
+size_t diskop_read(DiskopReader* reader, void* data, size_t size);
+
+bool load_song(TrackerSong* song, DiskopReader* reader);
+bool load_instrument(Instrument* inst, DiskopReader* reader);
+void load_instrument_inner(DiskopReader* reader, Instrument* inst, uint8_t version);
\ No newline at end of file
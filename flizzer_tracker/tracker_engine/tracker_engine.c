@@ -19,9 +19,7 @@ void tracker_engine_init(TrackerEngine* tracker_engine, uint8_t rate, SoundEngin
 
 void tracker_engine_deinit_song(TrackerSong* song, bool free_song) {
     for(int i = 0; i < MAX_PATTERNS; i++) {
-        if(song->pattern[i].step != NULL) {
-            free(song->pattern[i].step);
-        }
+        set_empty_pattern(&song->pattern[i]);
     }
 
     for(int i = 0; i < MAX_INSTRUMENTS; i++) {
@@ -97,30 +95,225 @@ void set_default_instrument(Instrument* inst) {
     inst->vibrato_delay = 0x20;
 }
 
-void set_empty_pattern(TrackerSongPattern* pattern, uint16_t pattern_length) {
-    for(uint16_t i = 0; i < pattern_length; i++) {
-        TrackerSongPatternStep* step = &pattern->step[i];
+static const TrackerSongPatternStep empty_step = {
+    .note = MUS_NOTE_NONE | ((MUS_NOTE_INSTRUMENT_NONE & 0x10) << 3),
+    .inst_vol = ((MUS_NOTE_INSTRUMENT_NONE & 0xf) << 4) | (MUS_NOTE_VOLUME_NONE & 0xf),
+    .command = (MUS_NOTE_VOLUME_NONE & 0x10) << 11,
+};
+
+#define PATTERN_DATA_SIZE(rows) \
+    (sizeof(TrackerSongPatternData) + (rows) * sizeof(TrackerSongPatternRow))
+#define PATTERN_DATA_GROW 8
+
+static TrackerSongPatternData* pattern_data_alloc(uint16_t size) {
+    TrackerSongPatternData* data = malloc(PATTERN_DATA_SIZE(size));
+    data->refs = 1;
+    data->num_rows = 0;
+    data->size = size;
+    return data;
+}
+
+void set_empty_pattern(TrackerSongPattern* pattern) {
+    TrackerSongPatternData* data = pattern->data;
 
-        set_note(step, MUS_NOTE_NONE);
-        set_instrument(step, MUS_NOTE_INSTRUMENT_NONE);
-        set_volume(step, MUS_NOTE_VOLUME_NONE);
-        set_command(step, 0);
+    pattern->data = NULL;
+
+    if(data && --data->refs == 0) {
+        free(data);
     }
 }
 
-uint8_t tracker_engine_get_note(TrackerSongPatternStep* step) {
+bool tracker_engine_is_step_empty(const TrackerSongPatternStep* step) {
+    return memcmp(step, &empty_step, sizeof(TrackerSongPatternStep)) == 0;
+}
+
+// Index of the first stored row >= row
+static uint16_t pattern_find_row(TrackerSongPatternData* data, uint16_t row) {
+    uint16_t low = 0;
+    uint16_t high = data->num_rows;
+
+    while(low < high) {
+        uint16_t mid = (low + high) / 2;
+
+        if(data->rows[mid].row < row) {
+            low = mid + 1;
+        }
+
+        else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+const TrackerSongPatternStep* tracker_engine_get_step(TrackerSongPattern* pattern, uint16_t row) {
+    TrackerSongPatternData* data = pattern->data;
+
+    if(data) {
+        uint16_t index = pattern_find_row(data, row);
+
+        if(index < data->num_rows && data->rows[index].row == row) {
+            return &data->rows[index].step;
+        }
+    }
+
+    return &empty_step;
+}
+
+// New data is filled before it replaces the old one, the tracker ISR can read the pattern
+// at any point of an edit
+static void pattern_replace_data(
+    TrackerSongPattern* pattern,
+    TrackerSongPatternData* old_data,
+    uint16_t size) {
+    TrackerSongPatternData* data = pattern_data_alloc(size);
+
+    if(old_data) {
+        data->num_rows = old_data->num_rows;
+        memcpy(data->rows, old_data->rows, old_data->num_rows * sizeof(TrackerSongPatternRow));
+    }
+
+    pattern->data = data;
+
+    if(old_data && --old_data->refs == 0) {
+        free(old_data);
+    }
+}
+
+void tracker_engine_set_step(
+    TrackerSongPattern* pattern,
+    uint16_t row,
+    const TrackerSongPatternStep* step) {
+    TrackerSongPatternData* data = pattern->data;
+    bool empty = tracker_engine_is_step_empty(step);
+
+    if(data == NULL && empty) return;
+
+    uint16_t index = data ? pattern_find_row(data, row) : 0;
+    bool stored = data && index < data->num_rows && data->rows[index].row == row;
+
+    if(!stored && empty) return;
+
+    if(stored && memcmp(&data->rows[index].step, step, sizeof(TrackerSongPatternStep)) == 0) {
+        return;
+    }
+
+    // copy on write, and make room for a new row
+    if(data == NULL || data->refs > 1 || (!stored && data->num_rows == data->size)) {
+        uint16_t size = data ? data->num_rows : 0;
+
+        if(!stored) size += PATTERN_DATA_GROW;
+
+        pattern_replace_data(pattern, data, size);
+        data = pattern->data;
+    }
+
+    if(stored && empty) {
+        memmove(
+            &data->rows[index],
+            &data->rows[index + 1],
+            (data->num_rows - index - 1) * sizeof(TrackerSongPatternRow));
+        data->num_rows--;
+    }
+
+    else if(stored) {
+        data->rows[index].step = *step;
+    }
+
+    else {
+        memmove(
+            &data->rows[index + 1],
+            &data->rows[index],
+            (data->num_rows - index) * sizeof(TrackerSongPatternRow));
+        data->rows[index].row = row;
+        data->rows[index].step = *step;
+        data->num_rows++;
+    }
+}
+
+void tracker_engine_share_pattern(TrackerSongPattern* pattern, TrackerSongPattern* source) {
+    if(pattern == source || pattern->data == source->data) return;
+
+    set_empty_pattern(pattern);
+
+    if(source->data) {
+        source->data->refs++;
+        pattern->data = source->data;
+    }
+}
+
+// Every pattern is resized at once, so shared data is cut in place
+void tracker_engine_truncate_pattern(TrackerSongPattern* pattern, uint16_t pattern_length) {
+    TrackerSongPatternData* data = pattern->data;
+
+    if(data) {
+        data->num_rows = pattern_find_row(data, pattern_length);
+    }
+}
+
+static bool pattern_data_equal(TrackerSongPatternData* a, TrackerSongPatternData* b) {
+    uint16_t rows_a = a ? a->num_rows : 0;
+    uint16_t rows_b = b ? b->num_rows : 0;
+
+    if(rows_a != rows_b) return false;
+
+    return rows_a == 0 || memcmp(a->rows, b->rows, rows_a * sizeof(TrackerSongPatternRow)) == 0;
+}
+
+// Point the pattern at the data of an earlier identical one, if any
+void tracker_engine_share_identical_pattern(TrackerSong* song, uint8_t pattern) {
+    TrackerSongPatternData* data = song->pattern[pattern].data;
+
+    if(data == NULL) return;
+
+    if(data->num_rows == 0) {
+        set_empty_pattern(&song->pattern[pattern]);
+        return;
+    }
+
+    for(uint8_t i = 0; i < pattern; i++) {
+        if(song->pattern[i].data != data && pattern_data_equal(song->pattern[i].data, data)) {
+            tracker_engine_share_pattern(&song->pattern[pattern], &song->pattern[i]);
+            return;
+        }
+    }
+}
+
+// Heap taken by the pattern data, shared data is counted once
+uint32_t tracker_engine_patterns_size(TrackerSong* song) {
+    uint32_t size = 0;
+
+    for(uint16_t i = 0; i < song->num_patterns; i++) {
+        TrackerSongPatternData* data = song->pattern[i].data;
+
+        if(data == NULL) continue;
+
+        bool counted = false;
+
+        for(uint16_t j = 0; j < i && !counted; j++) {
+            counted = song->pattern[j].data == data;
+        }
+
+        if(!counted) size += PATTERN_DATA_SIZE(data->size);
+    }
+
+    return size;
+}
+
+uint8_t tracker_engine_get_note(const TrackerSongPatternStep* step) {
     return (step->note & 0x7f);
 }
 
-uint8_t tracker_engine_get_instrument(TrackerSongPatternStep* step) {
+uint8_t tracker_engine_get_instrument(const TrackerSongPatternStep* step) {
     return ((step->note & 0x80) >> 3) | ((step->inst_vol & 0xf0) >> 4);
 }
 
-uint8_t tracker_engine_get_volume(TrackerSongPatternStep* step) {
+uint8_t tracker_engine_get_volume(const TrackerSongPatternStep* step) {
     return (step->inst_vol & 0xf) | ((step->command & 0x8000) >> 11);
 }
 
-uint16_t tracker_engine_get_command(TrackerSongPatternStep* step) {
+uint16_t tracker_engine_get_command(const TrackerSongPatternStep* step) {
     return (step->command & 0x7fff);
 }
 
@@ -242,7 +435,7 @@ void tracker_engine_trigger_instrument_internal(
 void tracker_engine_execute_track_command(
     TrackerEngine* tracker_engine,
     uint8_t chan,
-    TrackerSongPatternStep* step,
+    const TrackerSongPatternStep* step,
     bool first_tick) {
     UNUSED(first_tick);
     UNUSED(tracker_engine);
@@ -468,7 +661,7 @@ void tracker_engine_advance_tick(TrackerEngine* tracker_engine) {
 
     uint16_t opcode = 0;
 
-    for(uint8_t chan = 0; chan < SONG_MAX_CHANNELS; chan++) {
+    for(uint8_t chan = 0; chan < tracker_engine->sound_engine->num_channels; chan++) {
         SoundEngineChannel* se_channel = &tracker_engine->sound_engine->channel[chan];
         TrackerEngineChannel* te_channel = &tracker_engine->channel[chan];
 
@@ -479,18 +672,19 @@ void tracker_engine_advance_tick(TrackerEngine* tracker_engine) {
             uint8_t pattern_step = tracker_engine->pattern_position;
 
             TrackerSongPattern* pattern = &song->pattern[current_pattern];
+            const TrackerSongPatternStep* step = tracker_engine_get_step(pattern, pattern_step);
 
             uint8_t note_delay = 0;
 
-            opcode = tracker_engine_get_command(&pattern->step[pattern_step]);
+            opcode = tracker_engine_get_command(step);
 
             if((opcode & 0x7ff0) == TE_EFFECT_EXT_NOTE_DELAY) {
                 note_delay = (opcode & 0xf);
             }
 
             if(tracker_engine->current_tick == note_delay) {
-                uint8_t note = tracker_engine_get_note(&pattern->step[pattern_step]);
-                uint8_t inst = tracker_engine_get_instrument(&pattern->step[pattern_step]);
+                uint8_t note = tracker_engine_get_note(step);
+                uint8_t inst = tracker_engine_get_instrument(step);
 
                 Instrument* pinst = NULL;
 
@@ -557,7 +751,7 @@ void tracker_engine_advance_tick(TrackerEngine* tracker_engine) {
             tracker_engine_execute_track_command(
                 tracker_engine,
                 chan,
-                &pattern->step[pattern_step],
+                step,
                 tracker_engine->current_tick == note_delay);
         }
 
@@ -580,7 +774,8 @@ void tracker_engine_advance_tick(TrackerEngine* tracker_engine) {
 
                 TrackerSongPattern* pattern = &song->pattern[current_pattern];
 
-                opcode = tracker_engine_get_command(&pattern->step[pattern_step]);
+                opcode =
+                    tracker_engine_get_command(tracker_engine_get_step(pattern, pattern_step));
 
                 if((opcode & 0x7ff0) == TE_EFFECT_EXT_PATTERN_LOOP) {
                     if(opcode & 0xf) // loop end
@@ -590,7 +785,10 @@ void tracker_engine_advance_tick(TrackerEngine* tracker_engine) {
                             tracker_engine->in_loop = true;
 
                             for(int j = tracker_engine->pattern_position; j >= 0; j--) {
-                                if(tracker_engine_get_command(&pattern->step[j]) ==
+                                const TrackerSongPatternStep* loop_step =
+                                    tracker_engine_get_step(pattern, j);
+
+                                if(tracker_engine_get_command(loop_step) ==
                                    TE_EFFECT_EXT_PATTERN_LOOP) // search for loop start
                                 {
                                     tracker_engine->pattern_position =
@@ -610,7 +808,10 @@ void tracker_engine_advance_tick(TrackerEngine* tracker_engine) {
                             }
 
                             for(int j = tracker_engine->pattern_position; j >= 0; j--) {
-                                if(tracker_engine_get_command(&pattern->step[j]) ==
+                                const TrackerSongPatternStep* loop_step =
+                                    tracker_engine_get_step(pattern, j);
+
+                                if(tracker_engine_get_command(loop_step) ==
                                    TE_EFFECT_EXT_PATTERN_LOOP) // search for loop start
                                 {
                                     tracker_engine->pattern_position =
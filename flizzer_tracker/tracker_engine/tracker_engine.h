@@ -14,10 +14,10 @@ void tracker_engine_trigger_instrument_internal(
     Instrument* pinst,
     uint16_t note);
 
-uint8_t tracker_engine_get_note(TrackerSongPatternStep* step);
-uint8_t tracker_engine_get_instrument(TrackerSongPatternStep* step);
-uint8_t tracker_engine_get_volume(TrackerSongPatternStep* step);
-uint16_t tracker_engine_get_command(TrackerSongPatternStep* step);
+uint8_t tracker_engine_get_note(const TrackerSongPatternStep* step);
+uint8_t tracker_engine_get_instrument(const TrackerSongPatternStep* step);
+uint8_t tracker_engine_get_volume(const TrackerSongPatternStep* step);
+uint16_t tracker_engine_get_command(const TrackerSongPatternStep* step);
 
 void set_note(TrackerSongPatternStep* step, uint8_t note);
 void set_instrument(TrackerSongPatternStep* step, uint8_t inst);
@@ -25,4 +25,16 @@ void set_volume(TrackerSongPatternStep* step, uint8_t vol);
 void set_command(TrackerSongPatternStep* step, uint16_t command);
 
 void set_default_instrument(Instrument* inst);
-void set_empty_pattern(TrackerSongPattern* pattern, uint16_t pattern_length);
\ No newline at end of file
+void set_empty_pattern(TrackerSongPattern* pattern);
+
+bool tracker_engine_is_step_empty(const TrackerSongPatternStep* step);
+// Read only, rows that are not stored give a shared empty step
+const TrackerSongPatternStep* tracker_engine_get_step(TrackerSongPattern* pattern, uint16_t row);
+void tracker_engine_set_step(
+    TrackerSongPattern* pattern,
+    uint16_t row,
+    const TrackerSongPatternStep* step);
+void tracker_engine_share_pattern(TrackerSongPattern* pattern, TrackerSongPattern* source);
+void tracker_engine_truncate_pattern(TrackerSongPattern* pattern, uint16_t pattern_length);
+void tracker_engine_share_identical_pattern(TrackerSong* song, uint8_t pattern);
+uint32_t tracker_engine_patterns_size(TrackerSong* song);
\ No newline at end of file
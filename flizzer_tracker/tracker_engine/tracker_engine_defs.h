@@ -28,7 +28,9 @@
 #define INST_FILE_SIG "FZT!INST"
 #define INST_FILE_EXT ".fzi"
 
-#define TRACKER_ENGINE_VERSION 1
+#define TRACKER_ENGINE_VERSION 3 // 2: song channel count and sample rate, 3: sparse patterns
+
+#define SONG_DEFAULT_SAMPLE_RATE 44100
 
 #define MIDDLE_C (12 * 4)
 #define MAX_NOTE (12 * 7 + 11)
@@ -184,7 +186,20 @@ typedef struct {
 } TrackerSongPatternStep;
 
 typedef struct {
-    TrackerSongPatternStep* step;
+    uint8_t row;
+    TrackerSongPatternStep step;
+} TrackerSongPatternRow;
+
+// Only the rows that hold something are stored, sorted by row. Identical patterns point at
+// the same data, it is copied before one of them gets edited
+typedef struct {
+    uint16_t refs; // patterns using this data
+    uint16_t num_rows, size;
+    TrackerSongPatternRow rows[];
+} TrackerSongPatternData;
+
+typedef struct {
+    TrackerSongPatternData* data; // NULL while the pattern is empty
 } TrackerSongPattern;
 
 typedef struct {
@@ -208,6 +223,9 @@ typedef struct {
     uint8_t speed, rate;
 
     uint8_t loop_start, loop_end;
+
+    uint8_t num_channels; // channels played, SONG_MAX_CHANNELS at most
+    uint32_t sample_rate;
 } TrackerSong;
 
 typedef struct {
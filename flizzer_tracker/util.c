@@ -21,11 +21,29 @@ void stop_song(FlizzerTrackerApp* tracker) {
     reset_buffer(&tracker->sound_engine);
 }
 
+void apply_song_audio_settings(FlizzerTrackerApp* tracker) {
+    SoundEngine* sound_engine = &tracker->sound_engine;
+
+    if(sound_engine->sample_rate != tracker->song.sample_rate) {
+        sound_engine_set_sample_rate(sound_engine, tracker->song.sample_rate);
+    }
+
+    if(sound_engine->num_channels != tracker->song.num_channels) {
+        // keep the measured peak in line with the channels it will be compared to
+        sound_engine->isr_cycles_max = (uint64_t)sound_engine->isr_cycles_max *
+                                       tracker->song.num_channels / sound_engine->num_channels;
+        sound_engine->num_channels = tracker->song.num_channels;
+    }
+}
+
 void play_song(FlizzerTrackerApp* tracker, bool from_cursor) {
     uint16_t temppos = tracker->tracker_engine.pattern_position;
 
     stop_song(tracker);
 
+    apply_song_audio_settings(tracker);
+    tracker->sound_engine.isr_cycles_max = 0; // peak of this playback
+
     sound_engine_dma_init(
         (uint32_t)tracker->sound_engine.audio_buffer, tracker->sound_engine.audio_buffer_size);
 
@@ -67,20 +85,9 @@ void play_song(FlizzerTrackerApp* tracker, bool from_cursor) {
 }
 
 bool is_pattern_empty(TrackerSong* song, uint8_t pattern) {
-    TrackerSongPattern song_pattern = song->pattern[pattern];
-
-    for(int i = 0; i < song->pattern_length; i++) {
-        TrackerSongPatternStep* step = &song_pattern.step[i];
-
-        if(tracker_engine_get_note(step) != MUS_NOTE_NONE ||
-           tracker_engine_get_instrument(step) != MUS_NOTE_INSTRUMENT_NONE ||
-           tracker_engine_get_volume(step) != MUS_NOTE_VOLUME_NONE ||
-           tracker_engine_get_command(step) != 0) {
-            return false;
-        }
-    }
+    TrackerSongPatternData* data = song->pattern[pattern].data;
 
-    return true;
+    return data == NULL || data->num_rows == 0;
 }
 
 bool check_and_allocate_pattern(TrackerSong* song, uint8_t pattern) {
@@ -90,15 +97,13 @@ bool check_and_allocate_pattern(TrackerSong* song, uint8_t pattern) {
     }
 
     else {
-        if(song->pattern[pattern - 1].step == NULL)
+        if(pattern > song->num_patterns)
             return false; // if we hop through several patterns (e.g. editing upper digit)
 
         if(!(is_pattern_empty(
                song, pattern - 1))) // don't let the user flood the song with empty patterns
         {
-            song->pattern[pattern].step =
-                malloc(sizeof(TrackerSongPatternStep) * song->pattern_length);
-            set_empty_pattern(&song->pattern[pattern], song->pattern_length);
+            set_empty_pattern(&song->pattern[pattern]); // steps are stored once they are set
             song->num_patterns++;
             return true;
         }
@@ -109,23 +114,9 @@ bool check_and_allocate_pattern(TrackerSong* song, uint8_t pattern) {
     }
 }
 
-void resize_pattern(TrackerSongPattern* pattern, uint16_t old_length, uint16_t new_length) {
-    TrackerSongPattern temp;
-    temp.step = malloc((new_length) * sizeof(TrackerSongPatternStep));
-
-    set_empty_pattern(&temp, new_length);
-    memcpy(
-        temp.step, pattern->step, my_min(old_length, new_length) * sizeof(TrackerSongPatternStep));
-
-    free(pattern->step);
-    pattern->step = temp.step;
-}
-
 void change_pattern_length(TrackerSong* song, uint16_t new_length) {
     for(int i = 0; i < MAX_PATTERNS; i++) {
-        if(song->pattern[i].step) {
-            resize_pattern(&song->pattern[i], song->pattern_length, new_length);
-        }
+        tracker_engine_truncate_pattern(&song->pattern[i], new_length);
     }
 
     song->pattern_length = new_length;
@@ -169,6 +160,8 @@ void set_default_song(FlizzerTrackerApp* tracker) {
 
     tracker->song.speed = 6;
     tracker->song.rate = tracker->tracker_engine.rate;
+    tracker->song.num_channels = SONG_MAX_CHANNELS;
+    tracker->song.sample_rate = tracker->sound_engine.sample_rate;
     tracker->song.num_instruments = 1;
     tracker->song.num_patterns = 5;
     tracker->song.num_sequence_steps = 1;
@@ -179,21 +172,6 @@ void set_default_song(FlizzerTrackerApp* tracker) {
     tracker->song.sequence.sequence_step[0].pattern_indices[2] = 3;
     tracker->song.sequence.sequence_step[0].pattern_indices[3] = 4;
 
-    for(int i = 0; i < 5; i++) {
-        tracker->song.pattern[i].step = malloc(64 * sizeof(TrackerSongPatternStep));
-        memset(tracker->song.pattern[i].step, 0, 64 * sizeof(TrackerSongPatternStep));
-    }
-
-    for(int i = 0; i < 64; ++i) {
-        for(int j = 0; j < 5; j++) {
-            set_note(&tracker->song.pattern[j].step[i], MUS_NOTE_NONE);
-
-            set_instrument(&tracker->song.pattern[j].step[i], MUS_NOTE_INSTRUMENT_NONE);
-
-            set_volume(&tracker->song.pattern[j].step[i], MUS_NOTE_VOLUME_NONE);
-        }
-    }
-
     tracker->song.instrument[0] = malloc(sizeof(Instrument));
 
     set_default_instrument(tracker->song.instrument[0]);
@@ -17,6 +17,7 @@
 void reset_buffer(SoundEngine* sound_engine);
 void play_song(FlizzerTrackerApp* tracker, bool from_cursor);
 void stop_song(FlizzerTrackerApp* tracker);
+void apply_song_audio_settings(FlizzerTrackerApp* tracker);
 
 bool is_pattern_empty(TrackerSong* song, uint8_t pattern);
 bool check_and_allocate_pattern(TrackerSong* song, uint8_t pattern);
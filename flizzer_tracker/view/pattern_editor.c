@@ -74,12 +74,12 @@ void draw_pattern_view(Canvas* canvas, FlizzerTrackerApp* tracker) {
         TrackerSongPattern* pattern = &tracker->tracker_engine.song->pattern[current_pattern];
 
         for(uint8_t pos = 0; pos < ((tracker->focus == EDIT_PATTERN) ? 9 : 5); ++pos) {
-            TrackerSongPatternStep* step = NULL;
+            const TrackerSongPatternStep* step = NULL;
 
             if(pattern_step - ((tracker->focus == EDIT_PATTERN) ? 4 : 2) + pos >= 0 &&
                pattern_step - ((tracker->focus == EDIT_PATTERN) ? 4 : 2) + pos < pattern_length) {
-                step =
-                    &pattern->step[pattern_step + pos - ((tracker->focus == EDIT_PATTERN) ? 4 : 2)];
+                step = tracker_engine_get_step(
+                    pattern, pattern_step + pos - ((tracker->focus == EDIT_PATTERN) ? 4 : 2));
             }
 
             uint8_t string_x = i * 32;
@@ -162,7 +162,8 @@ void draw_pattern_view(Canvas* canvas, FlizzerTrackerApp* tracker) {
     }
 
     for(int i = 0; i < SONG_MAX_CHANNELS; ++i) {
-        if(tracker->tracker_engine.channel[i].channel_flags & TEC_DISABLED) {
+        if((tracker->tracker_engine.channel[i].channel_flags & TEC_DISABLED) ||
+           i >= tracker->song.num_channels) {
             canvas_draw_icon(canvas, 13 + 32 * i, PATTERN_EDITOR_Y - 3, &I_channel_off);
         }
 
@@ -274,7 +275,7 @@ void draw_sequence_view(Canvas* canvas, FlizzerTrackerApp* tracker) {
 uint32_t calculate_song_size(TrackerSong* song) {
     uint32_t song_size =
         SONG_HEADER_SIZE + sizeof(Instrument) * song->num_instruments +
-        sizeof(TrackerSongPatternStep) * song->num_patterns * song->pattern_length +
+        tracker_engine_patterns_size(song) +
         sizeof(TrackerSongSequenceStep) * song->num_sequence_steps;
     return song_size;
 }
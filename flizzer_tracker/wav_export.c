@@ -0,0 +1,314 @@
+#include "wav_export.h"
+#include "util.h"
+#include "profile.h"
+
+#define TAG "FlizzerTrackerExport"
+
+#define WAV_EXPORT_BUFFER_SAMPLES 2048
+#define WAV_EXPORT_BUFFERS 2
+#define WAV_EXPORT_DONE 0xff
+#define WAV_EXPORT_TAIL_SECONDS 1 // left for the releases after the last row
+#define WAV_EXPORT_MAX_SECONDS (20 * 60)
+
+#define WAV_HEADER_SIZE 44
+
+typedef struct {
+    FlizzerTrackerApp* tracker;
+    uint16_t* buffer[WAV_EXPORT_BUFFERS];
+    uint32_t length[WAV_EXPORT_BUFFERS];
+    FuriMessageQueue* free_buffers;
+    FuriMessageQueue* filled_buffers; // WAV_EXPORT_DONE once the song is rendered
+    volatile bool stop;
+} WavExport;
+
+static void wav_export_put_u16(uint8_t* dst, uint16_t value) {
+    dst[0] = value & 0xff;
+    dst[1] = value >> 8;
+}
+
+static void wav_export_put_u32(uint8_t* dst, uint32_t value) {
+    wav_export_put_u16(dst, value & 0xffff);
+    wav_export_put_u16(dst + 2, value >> 16);
+}
+
+static bool wav_export_write_header(
+    Stream* stream,
+    uint32_t sample_rate,
+    uint8_t bits_per_sample,
+    uint32_t data_size) {
+    uint8_t header[WAV_HEADER_SIZE];
+    uint16_t block_align = bits_per_sample / 8;
+
+    memcpy(&header[0], "RIFF", 4);
+    wav_export_put_u32(&header[4], WAV_HEADER_SIZE - 8 + data_size);
+    memcpy(&header[8], "WAVEfmt ", 8);
+    wav_export_put_u32(&header[16], 16);
+    wav_export_put_u16(&header[20], 1); // PCM
+    wav_export_put_u16(&header[22], 1); // mono
+    wav_export_put_u32(&header[24], sample_rate);
+    wav_export_put_u32(&header[28], sample_rate * block_align);
+    wav_export_put_u16(&header[32], block_align);
+    wav_export_put_u16(&header[34], bits_per_sample);
+    memcpy(&header[36], "data", 4);
+    wav_export_put_u32(&header[40], data_size);
+
+    return stream_seek(stream, 0, StreamOffsetFromStart) &&
+           stream_write(stream, header, WAV_HEADER_SIZE) == WAV_HEADER_SIZE;
+}
+
+static void wav_export_reset_engines(FlizzerTrackerApp* tracker) {
+    TrackerEngine* tracker_engine = &tracker->tracker_engine;
+
+    // Same starting state as play_song() from the top, without the timers and DMA
+    tracker_engine_set_song(tracker_engine, &tracker->song);
+
+    for(uint8_t i = 0; i < SONG_MAX_CHANNELS; i++) {
+        bool was_disabled = tracker_engine->channel[i].channel_flags & TEC_DISABLED;
+
+        memset(&tracker->sound_engine.channel[i], 0, sizeof(SoundEngineChannel));
+        memset(&tracker_engine->channel[i], 0, sizeof(TrackerEngineChannel));
+
+        if(was_disabled) {
+            tracker_engine->channel[i].channel_flags |= TEC_DISABLED;
+        }
+    }
+
+    tracker_engine->sequence_position = 0;
+    tracker_engine->pattern_position = 0;
+    tracker_engine->current_tick = 0;
+    tracker_engine->in_loop = false;
+    tracker_engine->playing = true;
+}
+
+static int32_t wav_export_render_thread(void* ctx) {
+    WavExport* export = ctx;
+    TrackerEngine* tracker_engine = &export->tracker->tracker_engine;
+    SoundEngine* sound_engine = &export->tracker->sound_engine;
+    TrackerSong* song = &export->tracker->song;
+
+    uint8_t rate = song->rate ? song->rate : tracker_engine->rate;
+    uint32_t tick_samples = 0;
+    uint32_t tick_remainder = 0;
+    uint32_t tail_samples = sound_engine->sample_rate * WAV_EXPORT_TAIL_SECONDS;
+    uint32_t samples_left = sound_engine->sample_rate * WAV_EXPORT_MAX_SECONDS;
+    uint16_t last_sequence_position = 0;
+    uint16_t last_pattern_position = 0;
+    bool done = false;
+
+    while(!done) {
+        uint8_t index;
+
+        if(furi_message_queue_get(export->free_buffers, &index, FuriWaitForever) !=
+           FuriStatusOk) {
+            break;
+        }
+
+        uint16_t* buffer = export->buffer[index];
+        uint32_t length = 0;
+
+        while(length < WAV_EXPORT_BUFFER_SAMPLES && !done) {
+            if(tick_samples == 0) {
+                if(tracker_engine->playing) {
+                    tracker_engine_advance_tick(tracker_engine);
+
+                    // The song loops back, one pass is enough. A jump back inside the same
+                    // step is an E6X pattern loop while in_loop is set
+                    if(tracker_engine->sequence_position < last_sequence_position ||
+                       (tracker_engine->sequence_position == last_sequence_position &&
+                        tracker_engine->pattern_position < last_pattern_position &&
+                        !(tracker_engine->in_loop))) {
+                        tracker_engine->playing = false;
+
+                        for(uint8_t i = 0; i < SONG_MAX_CHANNELS; i++) {
+                            sound_engine_enable_gate(
+                                sound_engine, &sound_engine->channel[i], false);
+                        }
+                    }
+
+                    last_sequence_position = tracker_engine->sequence_position;
+                    last_pattern_position = tracker_engine->pattern_position;
+                }
+
+                // sample_rate / rate samples per tick, the remainder is spread over the ticks
+                tick_samples = sound_engine->sample_rate / rate;
+                tick_remainder += sound_engine->sample_rate % rate;
+
+                if(tick_remainder >= rate) {
+                    tick_remainder -= rate;
+                    tick_samples++;
+                }
+            }
+
+            uint32_t count = WAV_EXPORT_BUFFER_SAMPLES - length;
+
+            if(count > tick_samples) count = tick_samples;
+            if(count > samples_left) count = samples_left;
+            if(!(tracker_engine->playing) && count > tail_samples) count = tail_samples;
+
+            sound_engine_fill_buffer(sound_engine, &buffer[length], count);
+
+            length += count;
+            tick_samples -= count;
+            samples_left -= count;
+
+            if(!(tracker_engine->playing)) tail_samples -= count;
+
+            done = export->stop || samples_left == 0 ||
+                   (!(tracker_engine->playing) && tail_samples == 0);
+        }
+
+        export->length[index] = length;
+        furi_message_queue_put(export->filled_buffers, &index, FuriWaitForever);
+    }
+
+    uint8_t index = WAV_EXPORT_DONE;
+    furi_message_queue_put(export->filled_buffers, &index, FuriWaitForever);
+    profile_thread_exit("wav_export");
+
+    return 0;
+}
+
+// Engine output is centered on 512 for the 10 bit PWM, converted in place
+static size_t wav_export_convert(uint16_t* buffer, uint32_t length, bool is_16bit) {
+    if(is_16bit) {
+        for(uint32_t i = 0; i < length; i++) {
+            int32_t sample = ((int32_t)buffer[i] - 512) * 64;
+
+            if(sample > INT16_MAX) sample = INT16_MAX;
+            if(sample < INT16_MIN) sample = INT16_MIN;
+
+            wav_export_put_u16((uint8_t*)&buffer[i], (uint16_t)(int16_t)sample);
+        }
+
+        return length * 2;
+    }
+
+    uint8_t* bytes = (uint8_t*)buffer;
+
+    for(uint32_t i = 0; i < length; i++) {
+        uint16_t sample = buffer[i] >> 2;
+
+        bytes[i] = sample > UINT8_MAX ? UINT8_MAX : sample;
+    }
+
+    return length;
+}
+
+static void wav_export_update_view(FlizzerTrackerApp* tracker) {
+    with_view_model(
+        tracker->tracker_view->view, TrackerViewModel * model, { UNUSED(model); }, true);
+}
+
+bool export_song_wav(FlizzerTrackerApp* tracker, FuriString* filepath) {
+    stop_song(tracker);
+    apply_song_audio_settings(tracker);
+
+    bool is_16bit = tracker->export_16bit;
+    uint32_t sample_rate = tracker->sound_engine.sample_rate;
+    Stream* stream = file_stream_alloc(tracker->storage);
+    uint32_t data_size = 0;
+    bool success = false;
+
+    if(!file_stream_open(stream, furi_string_get_cstr(filepath), FSAM_WRITE, FSOM_CREATE_ALWAYS) ||
+       !wav_export_write_header(stream, sample_rate, is_16bit ? 16 : 8, 0)) {
+        FURI_LOG_E(TAG, "Can't create %s", furi_string_get_cstr(filepath));
+        file_stream_close(stream);
+        stream_free(stream);
+        return false;
+    }
+
+    WavExport* export = malloc(sizeof(WavExport));
+    memset(export, 0, sizeof(WavExport));
+    export->tracker = tracker;
+    export->free_buffers = furi_message_queue_alloc(WAV_EXPORT_BUFFERS, sizeof(uint8_t));
+    export->filled_buffers = furi_message_queue_alloc(WAV_EXPORT_BUFFERS + 1, sizeof(uint8_t));
+
+    for(uint8_t i = 0; i < WAV_EXPORT_BUFFERS; i++) {
+        export->buffer[i] = malloc(WAV_EXPORT_BUFFER_SAMPLES * sizeof(uint16_t));
+        furi_message_queue_put(export->free_buffers, &i, 0);
+    }
+
+    tracker->export_progress = 0;
+    tracker->export_cancel = false;
+    wav_export_reset_engines(tracker);
+
+    FuriThread* thread = furi_thread_alloc_ex(
+        "FlizzerTrackerExport", 2048, wav_export_render_thread, export);
+    uint32_t start_time = furi_get_tick();
+    furi_thread_start(thread);
+
+    bool write_failed = false;
+
+    // Write one buffer while the other one is rendered
+    while(true) {
+        uint8_t index;
+
+        if(furi_message_queue_get(export->filled_buffers, &index, 100) != FuriStatusOk) {
+            wav_export_update_view(tracker);
+            continue;
+        }
+
+        if(index == WAV_EXPORT_DONE) break;
+
+        if(tracker->export_cancel || write_failed) {
+            export->stop = true;
+        }
+
+        else {
+            size_t size =
+                wav_export_convert(export->buffer[index], export->length[index], is_16bit);
+
+            if(stream_write(stream, (uint8_t*)export->buffer[index], size) != size) {
+                FURI_LOG_E(TAG, "Write failed");
+                write_failed = true;
+            }
+
+            data_size += size;
+        }
+
+        furi_message_queue_put(export->free_buffers, &index, FuriWaitForever);
+
+        uint8_t progress = tracker->song.num_sequence_steps ?
+                               tracker->tracker_engine.sequence_position * 100 /
+                                   tracker->song.num_sequence_steps :
+                               0;
+
+        if(progress != tracker->export_progress) {
+            tracker->export_progress = progress;
+            wav_export_update_view(tracker);
+        }
+    }
+
+    furi_thread_join(thread);
+    furi_thread_free(thread);
+
+    FURI_LOG_I(
+        TAG,
+        "Rendered %lu bytes in %lu ms",
+        data_size,
+        (uint32_t)(furi_get_tick() - start_time));
+
+    success = !write_failed && !tracker->export_cancel &&
+              wav_export_write_header(stream, sample_rate, is_16bit ? 16 : 8, data_size);
+
+    file_stream_close(stream);
+    stream_free(stream);
+
+    if(!success) {
+        storage_simply_remove(tracker->storage, furi_string_get_cstr(filepath));
+    }
+
+    for(uint8_t i = 0; i < WAV_EXPORT_BUFFERS; i++) {
+        free(export->buffer[i]);
+    }
+
+    furi_message_queue_free(export->free_buffers);
+    furi_message_queue_free(export->filled_buffers);
+    free(export);
+
+    tracker->tracker_engine.sequence_position = 0;
+    tracker->tracker_engine.pattern_position = 0;
+    stop_song(tracker);
+
+    return success;
+}
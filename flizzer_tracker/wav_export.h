@@ -0,0 +1,9 @@
+#pragma once
+
+#include "flizzer_tracker.h"
+
+#define WAV_FILE_EXT ".wav"
+
+// Render the song from the start into a mono PCM WAV file, as fast as the CPU allows.
+// The tracker and sound engines run in a thread of their own, the ISRs stay off
+bool export_song_wav(FlizzerTrackerApp* tracker, FuriString* filepath);
@@ -4,8 +4,11 @@
 #include <notification/notification_messages.h>
 #include <storage/storage.h>
 #include <dolphin/dolphin.h>
+#include <stddef.h>
+#include <string.h>
 
 #include "sandbox.h"
+#include "solver.h"
 
 #define FPS 20
 #define CELL_WIDTH 10
@@ -14,7 +17,8 @@
 #define KEY_STACK_SIZE 16
 #define SAVING_DIRECTORY STORAGE_APP_DATA_PATH_PREFIX
 #define SAVING_FILENAME SAVING_DIRECTORY "/game15.save"
-#define POPUP_MENU_ITEMS 2
+#define POPUP_MENU_ITEMS 4
+#define HINT_BLINK_TICKS 4
 
 typedef enum {
     DirectionNone,
@@ -26,6 +30,8 @@ typedef enum {
 
 typedef enum { ScenePlay, SceneWin, ScenePopup } scene_e;
 
+typedef enum { HelpNone, HelpHint, HelpAutoplay } help_e;
+
 typedef struct {
     uint8_t cell_index;
     uint8_t zero_index;
@@ -39,6 +45,8 @@ typedef struct {
     uint16_t move_count;
     uint32_t tick_count;
     uint8_t board[16];
+    uint8_t par; // shortest solution of the shuffled board, 0 while unknown
+    bool assisted; // hints or autoplay were used, the game can't set a record
 } game_state_t;
 
 static game_state_t game_state;
@@ -46,8 +54,21 @@ static NotificationApp* notification;
 static moving_cell_t moving_cell;
 static uint8_t loaded_saving_ticks;
 static uint8_t popup_menu_selected_item;
-
-static const char* popup_menu_strings[] = {"Continue", "Reset"};
+static uint8_t par_found_ticks;
+
+static const char* popup_menu_strings[] = {"Continue", "Hint", "Autoplay", "Reset"};
+
+static Solver* solver;
+static SolverResult solution;
+// moves made since the solver was started, the solution is followed while they match it
+static uint8_t history[SOLVER_MAX_MOVES];
+static uint8_t history_length;
+static bool history_lost;
+// the solver works on the board as it was shuffled, its result is the par
+static bool par_search;
+static uint8_t par_bound;
+static help_e help;
+static uint8_t help_ticks;
 
 static uint8_t keys[KEY_STACK_SIZE];
 static uint8_t key_stack_head = 0;
@@ -127,6 +148,13 @@ static bool storage_game_state_load() {
     storage_file_close(file);
     storage_file_free(file);
     furi_record_close(RECORD_STORAGE);
+
+    // saves from before the solver don't know the par
+    if(bytes_readed == offsetof(game_state_t, par)) {
+        game_state.par = 0;
+        game_state.assisted = false;
+        return true;
+    }
     return bytes_readed == sizeof(game_state_t);
 }
 
@@ -201,6 +229,74 @@ static void board_init() {
     } while(!is_board_has_solution());
 }
 
+static bool is_board_solved() {
+    for(int i = 0; i < 16; i++)
+        if(((i + 1) % 16) != game_state.board[i]) return false;
+    return true;
+}
+
+static void solver_request(bool for_par) {
+    solver_start(solver, game_state.board);
+    memset(&solution, 0, sizeof(solution));
+    solution.running = true;
+    history_length = 0;
+    history_lost = false;
+    par_search = for_par;
+}
+
+static void solver_reset() {
+    solver_stop(solver);
+    memset(&solution, 0, sizeof(solution));
+    history_lost = true;
+    par_search = false;
+    par_bound = 0;
+    help = HelpNone;
+}
+
+static void solver_update() {
+    if(!solver_get_result(solver, &solution)) return;
+    if(!par_search) return;
+
+    par_bound = solution.lower_bound;
+    if(solution.optimal) {
+        game_state.par = solution.length;
+        par_found_ticks = FPS * 2;
+    }
+    if(!solution.running) par_search = false;
+}
+
+static void history_push(direction_e direction) {
+    if(history_length < SOLVER_MAX_MOVES)
+        history[history_length++] = direction - DirectionUp;
+    else
+        history_lost = true;
+}
+
+// Next move of the solution from the current board, DirectionNone if there is none to follow
+static direction_e solution_next_move() {
+    if(history_lost || !solution.solved || history_length >= solution.length)
+        return DirectionNone;
+    if(memcmp(history, solution.moves, history_length)) return DirectionNone;
+    return solution.moves[history_length] + DirectionUp;
+}
+
+// Asks the solver again when the board left its solution, a running search for the par is
+// given up for that
+static void help_update() {
+    if(help == HelpNone || is_board_solved()) return;
+    if(solution_next_move() != DirectionNone) return;
+
+    bool same_board = !history_length && !history_lost;
+    if(same_board && solution.running) return;
+    if(same_board && !solution.solved) {
+        // nothing was found within the budget
+        notification_message(notification, &sequence_single_vibro);
+        help = HelpNone;
+        return;
+    }
+    solver_request(false);
+}
+
 static void game_init() {
     game_state.scene = ScenePlay;
     game_state.move_count = 0;
@@ -209,19 +305,28 @@ static void game_init() {
     board_init();
     key_stack_init();
     popup_menu_selected_item = 0;
-}
-
-static bool is_board_solved() {
-    for(int i = 0; i < 16; i++)
-        if(((i + 1) % 16) != game_state.board[i]) return false;
-    return true;
+    game_state.par = 0;
+    game_state.assisted = false;
+    solver_reset();
+    solver_request(true);
 }
 
 static void game_tick() {
+    solver_update();
+
     switch(game_state.scene) {
     case ScenePlay:
         if(game_state.move_count >= 1) game_state.tick_count++;
         if(loaded_saving_ticks) loaded_saving_ticks--;
+        if(par_found_ticks) par_found_ticks--;
+        help_ticks++;
+        if(moving_cell.move_direction == DirectionNone) {
+            help_update();
+            if(help == HelpAutoplay && key_stack_is_empty()) {
+                direction_e direction = solution_next_move();
+                if(direction != DirectionNone) key_stack_push(direction);
+            }
+        }
         if(moving_cell.move_direction == DirectionNone && !key_stack_is_empty()) {
             set_moving_cell_by_direction(key_stack_pop());
             if(moving_cell.move_direction == DirectionNone) {
@@ -236,12 +341,18 @@ static void game_tick() {
                 game_state.board[moving_cell.zero_index] =
                     game_state.board[moving_cell.cell_index];
                 game_state.board[moving_cell.cell_index] = 0;
+                history_push(moving_cell.move_direction);
                 moving_cell.move_direction = DirectionNone;
                 game_state.move_count++;
+                // a hint is shown until the next move
+                if(help == HelpHint) help = HelpNone;
             }
             if(is_board_solved()) {
                 notification_message(notification, &sequence_double_vibro);
-                if(game_state.move_count < game_state.top_record || game_state.top_record == 0) {
+                help = HelpNone;
+                // a helped game sets no record
+                if(!game_state.assisted && (game_state.move_count < game_state.top_record ||
+                                            game_state.top_record == 0)) {
                     game_state.top_record = game_state.move_count;
                     storage_game_state_save();
                 }
@@ -269,7 +380,13 @@ static void game_tick() {
                 if(popup_menu_selected_item == 0) {
                     game_state.scene = ScenePlay;
                     notification_message(notification, &sequence_single_vibro);
-                } else if(popup_menu_selected_item == 1) {
+                } else if(popup_menu_selected_item == 1 || popup_menu_selected_item == 2) {
+                    game_state.scene = ScenePlay;
+                    game_state.assisted = true;
+                    help = popup_menu_selected_item == 1 ? HelpHint : HelpAutoplay;
+                    help_ticks = 0;
+                    notification_message(notification, &sequence_single_vibro);
+                } else if(popup_menu_selected_item == 3) {
                     notification_message(notification, &sequence_single_vibro);
                     game_init();
                 }
@@ -287,6 +404,30 @@ static void draw_cell(Canvas* canvas, uint8_t x, uint8_t y, uint8_t cell_number)
     canvas_draw_xbm(canvas, x + 4, y + 3, CELL_WIDTH, CELL_HEIGHT, pic_cells + cell_number * 16);
 }
 
+// Cell of the tile the direction slides, -1 if there is none
+static int8_t cell_by_direction(direction_e direction) {
+    int8_t zero_index = 0;
+    while(zero_index < 16 && game_state.board[zero_index]) zero_index++;
+
+    uint8_t x = zero_index % 4;
+    uint8_t y = zero_index / 4;
+    if(direction == DirectionUp && y < 3) return zero_index + 4;
+    if(direction == DirectionDown && y > 0) return zero_index - 4;
+    if(direction == DirectionLeft && x < 3) return zero_index + 1;
+    if(direction == DirectionRight && x > 0) return zero_index - 1;
+    return -1;
+}
+
+static void hint_draw(Canvas* canvas) {
+    if(moving_cell.move_direction != DirectionNone) return;
+    if((help_ticks / HINT_BLINK_TICKS) % 2) return;
+
+    int8_t cell = cell_by_direction(solution_next_move());
+    if(cell < 0) return;
+    canvas_set_color(canvas, ColorBlack);
+    canvas_draw_rframe(canvas, (cell % 4) * 20 + 8, (cell / 4) * 16 + 2, 16, 12, 1);
+}
+
 static void board_draw(Canvas* canvas) {
     for(int i = 0; i < 16; i++) {
         if(game_state.board[i]) {
@@ -305,6 +446,23 @@ static void board_draw(Canvas* canvas) {
     }
 }
 
+static void message_draw(Canvas* canvas, const char* text) {
+    canvas_set_color(canvas, ColorWhite);
+    canvas_draw_rbox(canvas, 20, 24, 88, 16, 4);
+    canvas_set_color(canvas, ColorBlack);
+    canvas_draw_rframe(canvas, 20, 24, 88, 16, 4);
+    canvas_draw_str_aligned(canvas, 64, 32, AlignCenter, AlignCenter, text);
+}
+
+static void par_format(char* text, size_t size) {
+    if(game_state.par)
+        snprintf(text, size, "Par %u", game_state.par);
+    else if(par_bound)
+        snprintf(text, size, par_search ? "Par >= %u ..." : "Par >= %u", par_bound);
+    else
+        snprintf(text, size, "Par ?");
+}
+
 static void number_draw(Canvas* canvas, uint8_t y, uint32_t value) {
     uint8_t x = 121;
     while(true) {
@@ -354,13 +512,17 @@ static void render_callback(Canvas* const canvas) {
         board_draw(canvas);
         info_draw(canvas);
 
+        if(game_state.scene == ScenePlay && help == HelpHint) hint_draw(canvas);
+
         if(loaded_saving_ticks && game_state.scene != ScenePopup) {
-            canvas_set_color(canvas, ColorWhite);
-            canvas_draw_rbox(canvas, 20, 24, 88, 16, 4);
-            canvas_set_color(canvas, ColorBlack);
-            canvas_draw_rframe(canvas, 20, 24, 88, 16, 4);
-            canvas_draw_str_aligned(
-                canvas, 64, 32, AlignCenter, AlignCenter, "Restoring game ...");
+            message_draw(canvas, "Restoring game ...");
+        } else if(game_state.scene == ScenePlay && help != HelpNone && !is_board_solved() &&
+                  solution_next_move() == DirectionNone) {
+            message_draw(canvas, "Solving ...");
+        } else if(par_found_ticks && game_state.scene == ScenePlay) {
+            char text[24];
+            snprintf(text, sizeof(text), "Par: %u moves", game_state.par);
+            message_draw(canvas, text);
         }
     }
 
@@ -373,29 +535,47 @@ static void render_callback(Canvas* const canvas) {
         canvas_draw_box(canvas, 10, 23, 108, 18);
         canvas_set_color(canvas, ColorBlack);
         canvas_draw_xbm(canvas, 14, 27, 100, 10, pic_puzzled);
+
+        char text[24];
+        par_format(text, sizeof(text));
+        canvas_set_color(canvas, ColorWhite);
+        canvas_draw_rbox(canvas, 34, 47, 60, 13, 3);
+        canvas_set_color(canvas, ColorBlack);
+        canvas_draw_rframe(canvas, 34, 47, 60, 13, 3);
+        canvas_draw_str_aligned(canvas, 64, 53, AlignCenter, AlignCenter, text);
     } else if(game_state.scene == ScenePopup) {
         gray_screen(canvas);
         canvas_set_color(canvas, ColorWhite);
-        canvas_draw_rbox(canvas, 28, 16, 72, 32, 4);
+        canvas_draw_rbox(canvas, 28, 2, 72, 60, 4);
         canvas_set_color(canvas, ColorBlack);
-        canvas_draw_rframe(canvas, 28, 16, 72, 32, 4);
+        canvas_draw_rframe(canvas, 28, 2, 72, 60, 4);
 
         for(int i = 0; i < POPUP_MENU_ITEMS; i++) {
             if(i == popup_menu_selected_item) {
                 canvas_set_color(canvas, ColorBlack);
-                canvas_draw_box(canvas, 34, 20 + 12 * i, 60, 12);
+                canvas_draw_box(canvas, 34, 5 + 12 * i, 60, 12);
             }
 
             canvas_set_color(canvas, i == popup_menu_selected_item ? ColorWhite : ColorBlack);
             canvas_draw_str_aligned(
-                canvas, 64, 26 + 12 * i, AlignCenter, AlignCenter, popup_menu_strings[i]);
+                canvas, 64, 11 + 12 * i, AlignCenter, AlignCenter, popup_menu_strings[i]);
         }
+
+        char text[24];
+        par_format(text, sizeof(text));
+        canvas_set_color(canvas, ColorBlack);
+        canvas_draw_str_aligned(canvas, 64, 56, AlignCenter, AlignCenter, text);
     }
 }
 
 static void game_event_handler(GameEvent const event) {
     if(event.type == EventTypeKey) {
-        if(event.input.type == InputTypePress) {
+        if(event.input.type == InputTypePress && help == HelpAutoplay &&
+           game_state.scene == ScenePlay && event.input.key != InputKeyBack) {
+            // any key takes the game back from the autoplay
+            help = HelpNone;
+            key_stack_init();
+        } else if(event.input.type == InputTypePress) {
             switch(event.input.key) {
             case InputKeyUp:
                 key_stack_push(DirectionUp);
@@ -435,6 +615,7 @@ static void game_event_handler(GameEvent const event) {
 
 static void game_alloc() {
     key_stack_init();
+    solver = solver_alloc();
     notification = furi_record_open(RECORD_NOTIFICATION);
     notification_message_block(notification, &sequence_display_backlight_enforce_on);
 }
@@ -442,6 +623,7 @@ static void game_alloc() {
 static void game_free() {
     notification_message_block(notification, &sequence_display_backlight_enforce_auto);
     furi_record_close(RECORD_NOTIFICATION);
+    solver_free(solver);
 }
 
 int32_t game15_app() {
@@ -452,8 +634,13 @@ int32_t game15_app() {
     if(storage_game_state_load()) {
         if(game_state.scene != ScenePlay)
             game_init();
-        else
+        else {
             loaded_saving_ticks = FPS;
+            // the par of an untouched board can still be found, otherwise the solver waits
+            // until help is asked for
+            solver_reset();
+            if(!game_state.move_count && !game_state.par) solver_request(true);
+        }
     } else
         game_init();
 
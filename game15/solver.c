@@ -0,0 +1,333 @@
+#include "solver.h"
+#include <string.h>
+
+// The board is packed into 64 bits, cell i in bits 4i..4i+3. Tile t belongs in cell t - 1,
+// the empty cell in cell 15.
+#define CELL(board, i) ((uint8_t)(((board) >> ((i) * 4)) & 0xf))
+
+// The first search weights the heuristic to come up with some solution quickly
+#define SOLVER_WEIGHT 2
+// Bounds the search for the shortest solution
+#define SOLVER_NODE_BUDGET 60000000
+#define SOLVER_TIME_BUDGET_MS 30000
+#define SOLVER_CHECK_INTERVAL 4096
+
+// The empty cell moves in these directions, the tile next to it slides the opposite way
+typedef enum {
+    GapUp,
+    GapDown,
+    GapLeft,
+    GapRight,
+    GapCount,
+} GapMove;
+
+typedef struct {
+    uint64_t board;
+    uint8_t gap;
+    uint8_t distance; // manhattan distance of all tiles
+    uint8_t row_conflicts[4];
+    uint8_t column_conflicts[4];
+    uint8_t heuristic;
+    uint8_t move; // the move that led here
+    uint8_t next_move; // next move to try from here
+} SolverNode;
+
+typedef enum {
+    SearchFound,
+    SearchNotFound,
+    SearchAborted,
+} SearchStatus;
+
+typedef struct {
+    SolverNode nodes[SOLVER_MAX_MOVES + 1];
+    uint8_t length;
+    uint32_t visited;
+    uint32_t start_tick;
+} SolverSearch;
+
+struct Solver {
+    FuriThread* thread;
+    FuriMutex* mutex;
+    uint64_t root;
+    volatile bool stop;
+    bool fresh;
+    SolverResult result;
+};
+
+static uint8_t distance(uint8_t from, uint8_t to) {
+    uint8_t rows = from / 4 > to / 4 ? from / 4 - to / 4 : to / 4 - from / 4;
+    uint8_t columns = from % 4 > to % 4 ? from % 4 - to % 4 : to % 4 - from % 4;
+    return rows + columns;
+}
+
+// Tiles that sit in their goal line but in the wrong order have to step out of it and back,
+// two moves each. The fewest that must leave are the ones outside the longest increasing run.
+static uint8_t line_conflicts(uint64_t board, uint8_t line, bool row) {
+    uint8_t goals[4];
+    uint8_t count = 0;
+    for(uint8_t i = 0; i < 4; i++) {
+        uint8_t tile = CELL(board, row ? line * 4 + i : i * 4 + line);
+        if(!tile) continue;
+        uint8_t goal = tile - 1;
+        if(row && goal / 4 == line) goals[count++] = goal % 4;
+        if(!row && goal % 4 == line) goals[count++] = goal / 4;
+    }
+
+    uint8_t runs[4];
+    uint8_t longest = 0;
+    for(uint8_t i = 0; i < count; i++) {
+        runs[i] = 1;
+        for(uint8_t j = 0; j < i; j++) {
+            if(goals[j] < goals[i] && runs[j] + 1 > runs[i]) runs[i] = runs[j] + 1;
+        }
+        if(runs[i] > longest) longest = runs[i];
+    }
+    return (count - longest) * 2;
+}
+
+static void node_update_heuristic(SolverNode* node) {
+    node->heuristic = node->distance;
+    for(uint8_t i = 0; i < 4; i++) {
+        node->heuristic += node->row_conflicts[i] + node->column_conflicts[i];
+    }
+}
+
+static void node_init(SolverNode* node, uint64_t board) {
+    node->board = board;
+    node->distance = 0;
+    for(uint8_t i = 0; i < 16; i++) {
+        uint8_t tile = CELL(board, i);
+        if(tile) {
+            node->distance += distance(i, tile - 1);
+        } else {
+            node->gap = i;
+        }
+    }
+    for(uint8_t i = 0; i < 4; i++) {
+        node->row_conflicts[i] = line_conflicts(board, i, true);
+        node->column_conflicts[i] = line_conflicts(board, i, false);
+    }
+    node_update_heuristic(node);
+    node->move = GapCount;
+    node->next_move = 0;
+}
+
+static bool node_can_move(const SolverNode* node, uint8_t move) {
+    switch(move) {
+    case GapUp:
+        return node->gap >= 4;
+    case GapDown:
+        return node->gap < 12;
+    case GapLeft:
+        return node->gap % 4 > 0;
+    default:
+        return node->gap % 4 < 3;
+    }
+}
+
+// Only the lines the tile leaves and enters can change their conflicts: rows for a vertical
+// move, columns for a horizontal one
+static void node_move(const SolverNode* node, SolverNode* child, uint8_t move) {
+    static const int8_t offsets[GapCount] = {-4, 4, -1, 1};
+    uint8_t from = node->gap + offsets[move];
+    uint8_t tile = CELL(node->board, from);
+    uint8_t goal = tile - 1;
+
+    *child = *node;
+    child->board ^= ((uint64_t)tile << (from * 4)) | ((uint64_t)tile << (node->gap * 4));
+    child->gap = from;
+    child->distance = node->distance - distance(from, goal) + distance(node->gap, goal);
+    if(move == GapUp || move == GapDown) {
+        if(goal / 4 == from / 4 || goal / 4 == node->gap / 4) {
+            child->row_conflicts[from / 4] = line_conflicts(child->board, from / 4, true);
+            child->row_conflicts[node->gap / 4] =
+                line_conflicts(child->board, node->gap / 4, true);
+        }
+    } else if(goal % 4 == from % 4 || goal % 4 == node->gap % 4) {
+        child->column_conflicts[from % 4] = line_conflicts(child->board, from % 4, false);
+        child->column_conflicts[node->gap % 4] =
+            line_conflicts(child->board, node->gap % 4, false);
+    }
+    node_update_heuristic(child);
+    child->move = move;
+    child->next_move = 0;
+}
+
+static bool solver_out_of_budget(Solver* solver, SolverSearch* search) {
+    if(solver->stop) return true;
+    if(search->visited >= SOLVER_NODE_BUDGET) return true;
+    return furi_get_tick() - search->start_tick >= furi_ms_to_ticks(SOLVER_TIME_BUDGET_MS);
+}
+
+// One depth first pass of IDA*, nodes whose g + weight * h exceeds the threshold are cut off.
+// `next_threshold` gets the smallest value that was cut off.
+static SearchStatus solver_search(
+    Solver* solver,
+    SolverSearch* search,
+    uint16_t threshold,
+    uint8_t weight,
+    uint16_t* next_threshold) {
+    uint8_t depth = 0;
+    search->nodes[0].next_move = 0;
+    *next_threshold = UINT16_MAX;
+
+    while(true) {
+        SolverNode* node = &search->nodes[depth];
+        if(node->next_move == GapCount) {
+            if(depth == 0) return SearchNotFound;
+            depth--;
+            continue;
+        }
+
+        uint8_t move = node->next_move++;
+        // going straight back never helps
+        if(move == (node->move ^ 1) || !node_can_move(node, move)) continue;
+        if(depth == SOLVER_MAX_MOVES) {
+            node->next_move = GapCount;
+            continue;
+        }
+
+        SolverNode* child = &search->nodes[depth + 1];
+        node_move(node, child, move);
+        if(++search->visited % SOLVER_CHECK_INTERVAL == 0 &&
+           solver_out_of_budget(solver, search)) {
+            return SearchAborted;
+        }
+
+        uint16_t cost = depth + 1 + weight * child->heuristic;
+        if(cost > threshold) {
+            if(cost < *next_threshold) *next_threshold = cost;
+            continue;
+        }
+        if(child->heuristic == 0) {
+            search->length = depth + 1;
+            return SearchFound;
+        }
+        depth++;
+    }
+}
+
+static void
+    solver_publish(Solver* solver, const SolverSearch* search, const SolverResult* result) {
+    furi_mutex_acquire(solver->mutex, FuriWaitForever);
+    if(!solver->stop) {
+        solver->result.running = result->running;
+        solver->result.lower_bound = result->lower_bound;
+        if(search) {
+            solver->result.solved = true;
+            solver->result.optimal = result->optimal;
+            solver->result.length = search->length;
+            for(uint8_t i = 0; i < search->length; i++) {
+                // the tile slides against the empty cell
+                solver->result.moves[i] = search->nodes[i + 1].move ^ 1;
+            }
+        }
+        solver->fresh = true;
+    }
+    furi_mutex_release(solver->mutex);
+}
+
+static int32_t solver_thread(void* context) {
+    Solver* solver = context;
+    SolverSearch* search = malloc(sizeof(SolverSearch));
+    SolverResult result = {.running = true};
+    uint16_t threshold;
+    uint16_t next_threshold;
+
+    node_init(&search->nodes[0], solver->root);
+    result.lower_bound = search->nodes[0].heuristic;
+    search->visited = 0;
+    search->start_tick = furi_get_tick();
+
+    if(search->nodes[0].heuristic == 0) {
+        result.running = false;
+        result.optimal = true;
+        search->length = 0;
+        solver_publish(solver, search, &result);
+        free(search);
+        return 0;
+    }
+
+    // a quick solution first, so there is something to hint while the optimal search runs
+    threshold = SOLVER_WEIGHT * search->nodes[0].heuristic;
+    SearchStatus status = SearchNotFound;
+    while(threshold != UINT16_MAX && !solver->stop) {
+        status = solver_search(solver, search, threshold, SOLVER_WEIGHT, &next_threshold);
+        if(status != SearchNotFound) break;
+        threshold = next_threshold;
+    }
+    if(status == SearchFound) solver_publish(solver, search, &result);
+
+    // then IDA*: every pass that fails raises the lower bound
+    search->visited = 0;
+    threshold = search->nodes[0].heuristic;
+    status = SearchNotFound;
+    while(threshold != UINT16_MAX && !solver->stop) {
+        result.lower_bound = threshold;
+        solver_publish(solver, NULL, &result);
+
+        status = solver_search(solver, search, threshold, 1, &next_threshold);
+        if(status != SearchNotFound) break;
+        threshold = next_threshold;
+    }
+
+    result.running = false;
+    if(status == SearchFound) {
+        result.optimal = true;
+        result.lower_bound = search->length;
+        solver_publish(solver, search, &result);
+    } else {
+        solver_publish(solver, NULL, &result);
+    }
+
+    free(search);
+    return 0;
+}
+
+Solver* solver_alloc(void) {
+    Solver* solver = malloc(sizeof(Solver));
+    solver->thread = furi_thread_alloc_ex("Game15Solver", 1024, solver_thread, solver);
+    // keep the game responsive while searching
+    furi_thread_set_priority(solver->thread, FuriThreadPriorityLow);
+    solver->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    solver->stop = false;
+    solver->fresh = false;
+    memset(&solver->result, 0, sizeof(SolverResult));
+    return solver;
+}
+
+void solver_free(Solver* solver) {
+    solver_stop(solver);
+    furi_thread_free(solver->thread);
+    furi_mutex_free(solver->mutex);
+    free(solver);
+}
+
+void solver_start(Solver* solver, const uint8_t* board) {
+    solver_stop(solver);
+    solver->root = 0;
+    for(uint8_t i = 0; i < 16; i++) {
+        solver->root |= (uint64_t)board[i] << (i * 4);
+    }
+    memset(&solver->result, 0, sizeof(SolverResult));
+    solver->result.running = true;
+    solver->fresh = true;
+    solver->stop = false;
+    furi_thread_start(solver->thread);
+}
+
+void solver_stop(Solver* solver) {
+    if(furi_thread_get_state(solver->thread) != FuriThreadStateStopped) {
+        solver->stop = true;
+        furi_thread_join(solver->thread);
+    }
+}
+
+bool solver_get_result(Solver* solver, SolverResult* result) {
+    furi_mutex_acquire(solver->mutex, FuriWaitForever);
+    bool fresh = solver->fresh;
+    if(fresh) *result = solver->result;
+    solver->fresh = false;
+    furi_mutex_release(solver->mutex);
+    return fresh;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <furi.h>
+
+#define SOLVER_MAX_MOVES 200
+
+// Direction a tile slides into the empty cell
+typedef enum {
+    SolverMoveUp,
+    SolverMoveDown,
+    SolverMoveLeft,
+    SolverMoveRight,
+} SolverMove;
+
+typedef struct {
+    bool running; // the search goes on, a shorter solution may follow
+    bool solved; // moves lead from the board the search was started with to the goal
+    bool optimal; // no shorter solution exists
+    uint8_t lower_bound; // every solution takes at least this many moves
+    uint8_t length;
+    uint8_t moves[SOLVER_MAX_MOVES]; // SolverMove
+} SolverResult;
+
+typedef struct Solver Solver;
+
+Solver* solver_alloc(void);
+void solver_free(Solver* solver);
+
+// Starts solving `board` (the tile numbers row by row, 0 is the empty cell) in a background
+// thread, a running search is cancelled first. Some solution is usually found within a
+// second, then IDA* looks for the shortest one until its node or time budget runs out.
+void solver_start(Solver* solver, const uint8_t* board);
+void solver_stop(Solver* solver);
+
+// Copies the latest result, returns false when nothing changed since the last call
+bool solver_get_result(Solver* solver, SolverResult* result);
@@ -22,10 +22,12 @@
 // FOR J305 GEIGER TUBE
 #define CONVERSION_FACTOR 0.0081
 
+// Log lines are kept in RAM and written to the SD card once per this many seconds
+#define LOG_FLUSH_PERIOD 60
+
 typedef enum {
     EventTypeInput,
     ClockEventTypeTick,
-    EventGPIO,
 } EventType;
 
 typedef struct {
@@ -33,6 +35,27 @@ typedef struct {
     InputEvent input;
 } EventApp;
 
+typedef enum {
+    HistoryScaleSecond,
+    HistoryScaleMinute,
+    HistoryScaleHour,
+    HistoryScaleCount,
+} HistoryScale;
+
+typedef struct {
+    uint32_t value[SCREEN_SIZE_X];
+    uint8_t position;
+} HistoryRing;
+
+// Counts per second, per minute and per hour. Only complete buckets are pushed to the
+// minute and hour rings, partial ones accumulate in the sums below.
+typedef struct {
+    HistoryRing ring[HistoryScaleCount];
+    uint32_t cpm;
+    uint32_t minuteSum, hourSum;
+    uint8_t secondsInMinute, minutesInHour;
+} History;
+
 typedef struct {
     FuriMutex* mutex;
     uint32_t cps, cpm;
@@ -42,6 +65,7 @@ typedef struct {
     uint8_t zoom;
     uint8_t newLinePosition;
     uint8_t version;
+    uint8_t scale;
 } mutexStruct;
 
 static void draw_callback(Canvas* canvas, void* ctx) {
@@ -96,6 +120,17 @@ static void draw_callback(Canvas* canvas, void* ctx) {
         canvas_set_font(canvas, FontPrimary);
         canvas_draw_str_aligned(canvas, 64, 10, AlignCenter, AlignBottom, buffer);
 
+        if(mutexDraw.scale != HistoryScaleSecond) {
+            canvas_set_font(canvas, FontSecondary);
+            canvas_draw_str_aligned(
+                canvas,
+                SCREEN_SIZE_X - 1,
+                20,
+                AlignRight,
+                AlignBottom,
+                mutexDraw.scale == HistoryScaleMinute ? "1 min" : "1 h");
+        }
+
         uint8_t linePosition = mutexDraw.newLinePosition;
 
         if(mutexDraw.zoom == 0) {
@@ -171,11 +206,66 @@ static void clock_tick(void* ctx) {
     furi_message_queue_put(queue, &event, 0);
 }
 
+// Runs in interrupt context for every tube pulse, only bumps a free running counter so no
+// pulse is lost however high the rate gets. The main loop samples it once per clock tick.
 static void gpiocallback(void* ctx) {
     furi_assert(ctx);
-    FuriMessageQueue* queue = ctx;
-    EventApp event = {.type = EventGPIO};
-    furi_message_queue_put(queue, &event, 0);
+    volatile uint32_t* pulses = ctx;
+    (*pulses)++;
+}
+
+static void history_push(HistoryRing* ring, uint32_t value) {
+    ring->value[ring->position] = value;
+    if(ring->position != SCREEN_SIZE_X - 1)
+        ring->position++;
+    else
+        ring->position = 0;
+}
+
+static void history_add(History* history, uint32_t counter) {
+    HistoryRing* second = &history->ring[HistoryScaleSecond];
+
+    // Slide the 60 seconds window instead of summing it again on every tick
+    history->cpm -= second->value[(second->position + SCREEN_SIZE_X - 60) % SCREEN_SIZE_X];
+    history->cpm += counter;
+    history_push(second, counter);
+
+    history->minuteSum += counter;
+    if(++history->secondsInMinute < 60) return;
+
+    history_push(&history->ring[HistoryScaleMinute], history->minuteSum);
+    history->hourSum += history->minuteSum;
+    history->minuteSum = 0;
+    history->secondsInMinute = 0;
+    if(++history->minutesInHour < 60) return;
+
+    history_push(&history->ring[HistoryScaleHour], history->hourSum);
+    history->hourSum = 0;
+    history->minutesInHour = 0;
+}
+
+// Copy the selected ring to the drawing state, must be called with the mutex held
+static void history_show(const History* history, mutexStruct* mutexVal) {
+    const HistoryRing* ring = &history->ring[mutexVal->scale];
+
+    uint32_t max = 0;
+    for(int i = 0; i < SCREEN_SIZE_X; i++) {
+        mutexVal->line[i] = ring->value[i];
+        if(ring->value[i] > max) max = ring->value[i];
+    }
+    mutexVal->newLinePosition = ring->position;
+    mutexVal->cpm = history->cpm;
+
+    if(max > 0)
+        mutexVal->coef = ((float)(SCREEN_SIZE_Y - 15)) / ((float)max);
+    else
+        mutexVal->coef = 1;
+}
+
+static void log_flush(Stream* file_stream, FuriString* logBuffer) {
+    if(furi_string_size(logBuffer) == 0) return;
+    stream_write_string(file_stream, logBuffer);
+    furi_string_reset(logBuffer);
 }
 
 int32_t flipper_geiger_app() {
@@ -194,11 +284,18 @@ int32_t flipper_geiger_app() {
     mutexVal.zoom = 2;
     mutexVal.newLinePosition = 0;
     mutexVal.version = 0;
+    mutexVal.scale = HistoryScaleSecond;
+
+    History* history = malloc(sizeof(History));
+    memset(history, 0, sizeof(History));
 
     uint32_t counter = 0;
+    volatile uint32_t pulses = 0;
+    uint32_t lastPulses = 0;
 
     mutexVal.mutex = furi_mutex_alloc(FuriMutexTypeNormal);
     if(!mutexVal.mutex) {
+        free(history);
         furi_message_queue_free(event_queue);
         return 255;
     }
@@ -207,7 +304,7 @@ int32_t flipper_geiger_app() {
     view_port_draw_callback_set(view_port, draw_callback, &mutexVal.mutex);
     view_port_input_callback_set(view_port, input_callback, event_queue);
 
-    furi_hal_gpio_add_int_callback(&gpio_ext_pa7, gpiocallback, event_queue);
+    furi_hal_gpio_add_int_callback(&gpio_ext_pa7, gpiocallback, (void*)&pulses);
 
     Gui* gui = furi_record_open(RECORD_GUI);
     gui_add_view_port(gui, view_port, GuiLayerFullscreen);
@@ -227,6 +324,7 @@ int32_t flipper_geiger_app() {
     Storage* storage = furi_record_open(RECORD_STORAGE);
     Stream* file_stream = buffered_file_stream_alloc(storage);
     FuriString* dataString = furi_string_alloc();
+    FuriString* logBuffer = furi_string_alloc();
     uint32_t epoch = 0;
     uint8_t recordData = 0;
 
@@ -243,13 +341,23 @@ int32_t flipper_geiger_app() {
                    (event.input.type == InputTypeShort || event.input.type == InputTypeLong)) {
                     break;
                 } else if(event.input.key == InputKeyOk && event.input.type == InputTypeLong) {
-                    counter = 0;
+                    lastPulses = pulses;
+                    memset(history, 0, sizeof(History));
                     furi_mutex_acquire(mutexVal.mutex, FuriWaitForever);
 
                     mutexVal.cps = 0;
-                    mutexVal.cpm = 0;
-                    for(uint8_t i = 0; i < SCREEN_SIZE_X; i++) mutexVal.line[i] = 0;
-                    mutexVal.newLinePosition = 0;
+                    history_show(history, &mutexVal);
+
+                    screenRefresh = 1;
+                    furi_mutex_release(mutexVal.mutex);
+                } else if(event.input.key == InputKeyOk && event.input.type == InputTypeShort) {
+                    furi_mutex_acquire(mutexVal.mutex, FuriWaitForever);
+
+                    if(mutexVal.scale != HistoryScaleCount - 1)
+                        mutexVal.scale++;
+                    else
+                        mutexVal.scale = HistoryScaleSecond;
+                    history_show(history, &mutexVal);
 
                     screenRefresh = 1;
                     furi_mutex_release(mutexVal.mutex);
@@ -279,6 +387,7 @@ int32_t flipper_geiger_app() {
                         epoch = 0;
                         recordData = 1;
                     } else {
+                        log_flush(file_stream, logBuffer);
                         buffered_file_stream_close(file_stream);
                         notification_message(notification, &sequence_reset_red);
                         recordData = 0;
@@ -330,45 +439,25 @@ int32_t flipper_geiger_app() {
                     furi_mutex_release(mutexVal.mutex);
                 }
             } else if(event.type == ClockEventTypeTick) {
+                // Unsigned difference stays right across the counter wrapping
+                uint32_t currentPulses = pulses;
+                counter = currentPulses - lastPulses;
+                lastPulses = currentPulses;
+
                 if(recordData == 1) {
-                    furi_string_printf(dataString, "%lu,%lu\n", epoch++, counter);
-                    stream_write_string(file_stream, dataString);
+                    furi_string_cat_printf(logBuffer, "%lu,%lu\n", epoch++, counter);
+                    if(epoch % LOG_FLUSH_PERIOD == 0) log_flush(file_stream, logBuffer);
                 }
 
+                history_add(history, counter);
+
                 furi_mutex_acquire(mutexVal.mutex, FuriWaitForever);
 
-                mutexVal.line[mutexVal.newLinePosition] = counter;
                 mutexVal.cps = counter;
-                counter = 0;
-
-                mutexVal.cpm = mutexVal.line[mutexVal.newLinePosition];
-                uint32_t max = mutexVal.line[mutexVal.newLinePosition];
-                uint8_t linePosition = mutexVal.newLinePosition;
-
-                for(int i = 1; i < SCREEN_SIZE_X; i++) {
-                    if(linePosition != 0)
-                        linePosition--;
-                    else
-                        linePosition = SCREEN_SIZE_X - 1;
-
-                    if(i < 60) mutexVal.cpm += mutexVal.line[linePosition];
-                    if(mutexVal.line[linePosition] > max) max = mutexVal.line[linePosition];
-                }
-
-                if(max > 0)
-                    mutexVal.coef = ((float)(SCREEN_SIZE_Y - 15)) / ((float)max);
-                else
-                    mutexVal.coef = 1;
-
-                if(mutexVal.newLinePosition != SCREEN_SIZE_X - 1)
-                    mutexVal.newLinePosition++;
-                else
-                    mutexVal.newLinePosition = 0;
+                history_show(history, &mutexVal);
 
                 screenRefresh = 1;
                 furi_mutex_release(mutexVal.mutex);
-            } else if(event.type == EventGPIO) {
-                counter++;
             }
         }
 
@@ -376,10 +465,12 @@ int32_t flipper_geiger_app() {
     }
 
     if(recordData == 1) {
+        log_flush(file_stream, logBuffer);
         buffered_file_stream_close(file_stream);
         notification_message(notification, &sequence_reset_red);
     }
 
+    furi_string_free(logBuffer);
     furi_string_free(dataString);
     furi_record_close(RECORD_NOTIFICATION);
     stream_free(file_stream);
@@ -397,6 +488,7 @@ int32_t flipper_geiger_app() {
 
     furi_message_queue_free(event_queue);
     furi_mutex_free(mutexVal.mutex);
+    free(history);
     gui_remove_view_port(gui, view_port);
     view_port_free(view_port);
     furi_timer_free(timer);
@@ -22,8 +22,10 @@ void gpio_scene_usb_uart_on_enter(void* context) {
         scene_usb_uart->cfg.vcp_ch = 0; // TODO: settings load
         scene_usb_uart->cfg.uart_ch = 0;
         scene_usb_uart->cfg.flow_pins = 0;
+        scene_usb_uart->cfg.flow_control = UsbUartFlowControlNone;
         scene_usb_uart->cfg.baudrate_mode = 0;
         scene_usb_uart->cfg.baudrate = 0;
+        scene_usb_uart->cfg.rx_buf_mode = 2; // 8 KiB
         app->usb_uart_bridge = usb_uart_enable(&scene_usb_uart->cfg);
     }
 
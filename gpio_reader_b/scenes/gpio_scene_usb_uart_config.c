@@ -7,11 +7,15 @@ typedef enum {
     UsbUartLineIndexBaudrate,
     UsbUartLineIndexUart,
     UsbUartLineIndexFlow,
+    UsbUartLineIndexFlowControl,
+    UsbUartLineIndexRxBuffer,
 } LineIndex;
 
 static const char* vcp_ch[] = {"0 (CLI)", "1"};
 static const char* uart_ch[] = {"13,14", "15,16"};
 static const char* flow_pins[] = {"None", "2,3", "6,7", "16,15"};
+static const char* flow_control[] = {"None", "RTS/CTS"};
+static const char* rx_buf[] = {"2 KiB", "4 KiB", "8 KiB", "16 KiB"};
 static const char* baudrate_mode[] = {"Host"};
 static const uint32_t baudrate_list[] = {
     2400,
@@ -23,6 +27,9 @@ static const uint32_t baudrate_list[] = {
     230400,
     460800,
     921600,
+    1000000,
+    1500000,
+    2000000,
 };
 
 bool gpio_scene_usb_uart_cfg_on_event(void* context, SceneManagerEvent event) {
@@ -92,6 +99,28 @@ static void line_flow_cb(VariableItem* item) {
     view_dispatcher_send_custom_event(app->view_dispatcher, GpioUsbUartEventConfigSet);
 }
 
+static void line_flow_control_cb(VariableItem* item) {
+    GpioApp* app = variable_item_get_context(item);
+    furi_assert(app);
+    uint8_t index = variable_item_get_current_value_index(item);
+
+    variable_item_set_current_value_text(item, flow_control[index]);
+
+    app->usb_uart_cfg->flow_control = index;
+    view_dispatcher_send_custom_event(app->view_dispatcher, GpioUsbUartEventConfigSet);
+}
+
+static void line_rx_buf_cb(VariableItem* item) {
+    GpioApp* app = variable_item_get_context(item);
+    furi_assert(app);
+    uint8_t index = variable_item_get_current_value_index(item);
+
+    variable_item_set_current_value_text(item, rx_buf[index]);
+
+    app->usb_uart_cfg->rx_buf_mode = index;
+    view_dispatcher_send_custom_event(app->view_dispatcher, GpioUsbUartEventConfigSet);
+}
+
 static void line_baudrate_cb(VariableItem* item) {
     GpioApp* app = variable_item_get_context(item);
     furi_assert(app);
@@ -100,7 +129,7 @@ static void line_baudrate_cb(VariableItem* item) {
     char br_text[8];
 
     if(index > 0) {
-        snprintf(br_text, 7, "%lu", baudrate_list[index - 1]);
+        snprintf(br_text, sizeof(br_text), "%lu", baudrate_list[index - 1]);
         variable_item_set_current_value_text(item, br_text);
         app->usb_uart_cfg->baudrate = baudrate_list[index - 1];
     } else {
@@ -134,7 +163,11 @@ void gpio_scene_usb_uart_cfg_on_enter(void* context) {
         app);
     variable_item_set_current_value_index(item, app->usb_uart_cfg->baudrate_mode);
     if(app->usb_uart_cfg->baudrate_mode > 0) {
-        snprintf(br_text, 7, "%lu", baudrate_list[app->usb_uart_cfg->baudrate_mode - 1]);
+        snprintf(
+            br_text,
+            sizeof(br_text),
+            "%lu",
+            baudrate_list[app->usb_uart_cfg->baudrate_mode - 1]);
         variable_item_set_current_value_text(item, br_text);
     } else {
         variable_item_set_current_value_text(
@@ -152,6 +185,16 @@ void gpio_scene_usb_uart_cfg_on_enter(void* context) {
     app->var_item_flow = item;
     line_ensure_flow_invariant(app);
 
+    item = variable_item_list_add(
+        var_item_list, "Flow Control", COUNT_OF(flow_control), line_flow_control_cb, app);
+    variable_item_set_current_value_index(item, app->usb_uart_cfg->flow_control);
+    variable_item_set_current_value_text(item, flow_control[app->usb_uart_cfg->flow_control]);
+
+    item =
+        variable_item_list_add(var_item_list, "RX Buffer", COUNT_OF(rx_buf), line_rx_buf_cb, app);
+    variable_item_set_current_value_index(item, app->usb_uart_cfg->rx_buf_mode);
+    variable_item_set_current_value_text(item, rx_buf[app->usb_uart_cfg->rx_buf_mode]);
+
     variable_item_list_set_selected_item(
         var_item_list, scene_manager_get_scene_state(app->scene_manager, GpioAppViewUsbUartCfg));
 
@@ -1,4 +1,5 @@
 #include "usb_uart_bridge.h"
+#include "uart_dma.h"
 #include "furi_hal.h"
 #include <furi_hal_usb_cdc.h>
 #include "usb_cdc.h"
@@ -7,7 +8,10 @@
 #include "cli/cli.h"
 
 #define USB_CDC_PKT_LEN CDC_DATA_SZ
-#define USB_UART_RX_BUF_SIZE (USB_CDC_PKT_LEN * 5)
+// UART TX is cut into chunks this long so CTS is looked at in between
+#define USB_UART_CTS_CHUNK 16
+
+static const uint32_t rx_buf_sizes[] = {2048, 4096, 8192, 16384};
 
 #define USB_CDC_BIT_DTR (1 << 0)
 #define USB_CDC_BIT_RTS (1 << 1)
@@ -44,7 +48,9 @@ struct UsbUartBridge {
     FuriThread* thread;
     FuriThread* tx_thread;
 
-    FuriStreamBuffer* rx_stream;
+    UartDma* rx_dma;
+    size_t rx_buf_size;
+    bool rts_hold;
 
     FuriMutex* usb_mutex;
 
@@ -75,15 +81,6 @@ static const CdcCallbacks cdc_cb = {
 
 static int32_t usb_uart_tx_thread(void* context);
 
-static void usb_uart_on_irq_cb(UartIrqEvent ev, uint8_t data, void* context) {
-    UsbUartBridge* usb_uart = (UsbUartBridge*)context;
-
-    if(ev == UartIrqEventRXNE) {
-        furi_stream_buffer_send(usb_uart->rx_stream, &data, 1, 0);
-        furi_thread_flags_set(furi_thread_get_id(usb_uart->thread), WorkerEvtRxDone);
-    }
-}
-
 static void usb_uart_vcp_init(UsbUartBridge* usb_uart, uint8_t vcp_ch) {
     furi_hal_usb_unlock();
     if(vcp_ch == 0) {
@@ -110,18 +107,31 @@ static void usb_uart_vcp_deinit(UsbUartBridge* usb_uart, uint8_t vcp_ch) {
     }
 }
 
+static void usb_uart_rx_start(UsbUartBridge* usb_uart, uint8_t uart_ch) {
+    furi_assert(usb_uart->cfg.rx_buf_mode < COUNT_OF(rx_buf_sizes));
+    usb_uart->rx_buf_size = rx_buf_sizes[usb_uart->cfg.rx_buf_mode];
+    usb_uart->rx_dma = uart_dma_alloc(usb_uart->rx_buf_size);
+    uart_dma_start(
+        usb_uart->rx_dma, uart_ch, furi_thread_get_id(usb_uart->thread), WorkerEvtRxDone);
+}
+
+static void usb_uart_rx_stop(UsbUartBridge* usb_uart) {
+    uart_dma_stop(usb_uart->rx_dma);
+    usb_uart->st.rx_overflow += uart_dma_take_overflow(usb_uart->rx_dma);
+    uart_dma_free(usb_uart->rx_dma);
+}
+
 static void usb_uart_serial_init(UsbUartBridge* usb_uart, uint8_t uart_ch) {
     if(uart_ch == FuriHalUartIdUSART1) {
         furi_hal_console_disable();
     } else if(uart_ch == FuriHalUartIdLPUART1) {
         furi_hal_uart_init(uart_ch, 115200);
     }
-    furi_hal_uart_set_irq_cb(uart_ch, usb_uart_on_irq_cb, usb_uart);
+    usb_uart_rx_start(usb_uart, uart_ch);
 }
 
 static void usb_uart_serial_deinit(UsbUartBridge* usb_uart, uint8_t uart_ch) {
-    UNUSED(usb_uart);
-    furi_hal_uart_set_irq_cb(uart_ch, NULL, NULL);
+    usb_uart_rx_stop(usb_uart);
     if(uart_ch == FuriHalUartIdUSART1)
         furi_hal_console_enable();
     else if(uart_ch == FuriHalUartIdLPUART1)
@@ -142,8 +152,52 @@ static void usb_uart_set_baudrate(UsbUartBridge* usb_uart, uint32_t baudrate) {
     }
 }
 
-static void usb_uart_update_ctrl_lines(UsbUartBridge* usb_uart) {
+static void usb_uart_flow_pins_init(UsbUartBridge* usb_uart) {
     if(usb_uart->cfg.flow_pins != 0) {
+        furi_assert((size_t)(usb_uart->cfg.flow_pins - 1) < COUNT_OF(flow_pins));
+        furi_hal_gpio_init_simple(
+            flow_pins[usb_uart->cfg.flow_pins - 1][0], GpioModeOutputPushPull);
+        if(usb_uart->cfg.flow_control == UsbUartFlowControlRtsCts) {
+            // an unconnected CTS reads as clear to send
+            furi_hal_gpio_init(
+                flow_pins[usb_uart->cfg.flow_pins - 1][1],
+                GpioModeInput,
+                GpioPullDown,
+                GpioSpeedLow);
+        } else {
+            furi_hal_gpio_init_simple(
+                flow_pins[usb_uart->cfg.flow_pins - 1][1], GpioModeOutputPushPull);
+        }
+    }
+    usb_uart->rts_hold = false;
+}
+
+static void usb_uart_flow_pins_deinit(UsbUartBridge* usb_uart) {
+    if(usb_uart->cfg.flow_pins != 0) {
+        furi_hal_gpio_init_simple(flow_pins[usb_uart->cfg.flow_pins - 1][0], GpioModeAnalog);
+        furi_hal_gpio_init_simple(flow_pins[usb_uart->cfg.flow_pins - 1][1], GpioModeAnalog);
+    }
+}
+
+// With RTS/CTS the device is held off while the RX ring fills up, instead of losing data
+static void usb_uart_update_rts(UsbUartBridge* usb_uart) {
+    if(usb_uart->cfg.flow_pins == 0 || usb_uart->cfg.flow_control != UsbUartFlowControlRtsCts)
+        return;
+
+    size_t pending = uart_dma_get_pending(usb_uart->rx_dma);
+    if(pending > usb_uart->rx_buf_size / 4 * 3) {
+        usb_uart->rts_hold = true;
+    } else if(pending < usb_uart->rx_buf_size / 4) {
+        usb_uart->rts_hold = false;
+    }
+    // RTS is active low
+    furi_hal_gpio_write(flow_pins[usb_uart->cfg.flow_pins - 1][0], usb_uart->rts_hold);
+}
+
+static void usb_uart_update_ctrl_lines(UsbUartBridge* usb_uart) {
+    if(usb_uart->cfg.flow_control == UsbUartFlowControlRtsCts) {
+        usb_uart_update_rts(usb_uart);
+    } else if(usb_uart->cfg.flow_pins != 0) {
         furi_assert((size_t)(usb_uart->cfg.flow_pins - 1) < COUNT_OF(flow_pins));
         uint8_t state = furi_hal_cdc_get_ctrl_line_state(usb_uart->cfg.vcp_ch);
 
@@ -152,13 +206,37 @@ static void usb_uart_update_ctrl_lines(UsbUartBridge* usb_uart) {
     }
 }
 
+// Sends what was received so far, a CDC packet at a time for as long as the host takes them.
+// Returns how long to wait before looking again.
+static uint32_t usb_uart_rx_drain(UsbUartBridge* usb_uart) {
+    uint32_t timeout = FuriWaitForever;
+    while(uart_dma_get_pending(usb_uart->rx_dma) > 0) {
+        // the last packet hasn't been picked up yet, the data waits in the ring until the
+        // host takes it and the ring stops the device through RTS when it fills up
+        if(furi_semaphore_acquire(usb_uart->tx_sem, 0) != FuriStatusOk) {
+            if(usb_uart->cfg.flow_control == UsbUartFlowControlRtsCts) timeout = 1;
+            break;
+        }
+        size_t len = uart_dma_receive(usb_uart->rx_dma, usb_uart->rx_buf, USB_CDC_PKT_LEN);
+        if(len == 0) {
+            furi_semaphore_release(usb_uart->tx_sem);
+            break;
+        }
+        usb_uart->st.rx_cnt += len;
+        furi_check(furi_mutex_acquire(usb_uart->usb_mutex, FuriWaitForever) == FuriStatusOk);
+        furi_hal_cdc_send(usb_uart->cfg.vcp_ch, usb_uart->rx_buf, len);
+        furi_check(furi_mutex_release(usb_uart->usb_mutex) == FuriStatusOk);
+    }
+    usb_uart->st.rx_overflow += uart_dma_take_overflow(usb_uart->rx_dma);
+    usb_uart_update_rts(usb_uart);
+    return timeout;
+}
+
 static int32_t usb_uart_worker(void* context) {
     UsbUartBridge* usb_uart = (UsbUartBridge*)context;
 
     memcpy(&usb_uart->cfg, &usb_uart->cfg_new, sizeof(UsbUartConfig));
 
-    usb_uart->rx_stream = furi_stream_buffer_alloc(USB_UART_RX_BUF_SIZE, 1);
-
     usb_uart->tx_sem = furi_semaphore_alloc(1, 1);
     usb_uart->usb_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
 
@@ -168,38 +246,23 @@ static int32_t usb_uart_worker(void* context) {
     usb_uart_vcp_init(usb_uart, usb_uart->cfg.vcp_ch);
     usb_uart_serial_init(usb_uart, usb_uart->cfg.uart_ch);
     usb_uart_set_baudrate(usb_uart, usb_uart->cfg.baudrate);
-    if(usb_uart->cfg.flow_pins != 0) {
-        furi_assert((size_t)(usb_uart->cfg.flow_pins - 1) < COUNT_OF(flow_pins));
-        furi_hal_gpio_init_simple(
-            flow_pins[usb_uart->cfg.flow_pins - 1][0], GpioModeOutputPushPull);
-        furi_hal_gpio_init_simple(
-            flow_pins[usb_uart->cfg.flow_pins - 1][1], GpioModeOutputPushPull);
-        usb_uart_update_ctrl_lines(usb_uart);
-    }
+    usb_uart_flow_pins_init(usb_uart);
+    usb_uart_update_ctrl_lines(usb_uart);
 
     furi_thread_flags_set(furi_thread_get_id(usb_uart->tx_thread), WorkerEvtCdcRx);
 
     furi_thread_start(usb_uart->tx_thread);
 
+    uint32_t timeout = FuriWaitForever;
     while(1) {
-        uint32_t events =
-            furi_thread_flags_wait(WORKER_ALL_RX_EVENTS, FuriFlagWaitAny, FuriWaitForever);
+        uint32_t events = furi_thread_flags_wait(WORKER_ALL_RX_EVENTS, FuriFlagWaitAny, timeout);
+        if(events == (uint32_t)FuriFlagErrorTimeout) {
+            events = WorkerEvtRxDone;
+        }
         furi_check(!(events & FuriFlagError));
         if(events & WorkerEvtStop) break;
         if(events & WorkerEvtRxDone) {
-            size_t len = furi_stream_buffer_receive(
-                usb_uart->rx_stream, usb_uart->rx_buf, USB_CDC_PKT_LEN, 0);
-            if(len > 0) {
-                if(furi_semaphore_acquire(usb_uart->tx_sem, 100) == FuriStatusOk) {
-                    usb_uart->st.rx_cnt += len;
-                    furi_check(
-                        furi_mutex_acquire(usb_uart->usb_mutex, FuriWaitForever) == FuriStatusOk);
-                    furi_hal_cdc_send(usb_uart->cfg.vcp_ch, usb_uart->rx_buf, len);
-                    furi_check(furi_mutex_release(usb_uart->usb_mutex) == FuriStatusOk);
-                } else {
-                    furi_stream_buffer_reset(usb_uart->rx_stream);
-                }
-            }
+            timeout = usb_uart_rx_drain(usb_uart);
         }
         if(events & WorkerEvtCfgChange) {
             if(usb_uart->cfg.vcp_ch != usb_uart->cfg_new.vcp_ch) {
@@ -230,21 +293,17 @@ static int32_t usb_uart_worker(void* context) {
                 usb_uart_set_baudrate(usb_uart, usb_uart->cfg_new.baudrate);
                 usb_uart->cfg.baudrate = usb_uart->cfg_new.baudrate;
             }
-            if(usb_uart->cfg.flow_pins != usb_uart->cfg_new.flow_pins) {
-                if(usb_uart->cfg.flow_pins != 0) {
-                    furi_hal_gpio_init_simple(
-                        flow_pins[usb_uart->cfg.flow_pins - 1][0], GpioModeAnalog);
-                    furi_hal_gpio_init_simple(
-                        flow_pins[usb_uart->cfg.flow_pins - 1][1], GpioModeAnalog);
-                }
-                if(usb_uart->cfg_new.flow_pins != 0) {
-                    furi_assert((size_t)(usb_uart->cfg_new.flow_pins - 1) < COUNT_OF(flow_pins));
-                    furi_hal_gpio_init_simple(
-                        flow_pins[usb_uart->cfg_new.flow_pins - 1][0], GpioModeOutputPushPull);
-                    furi_hal_gpio_init_simple(
-                        flow_pins[usb_uart->cfg_new.flow_pins - 1][1], GpioModeOutputPushPull);
-                }
+            if(usb_uart->cfg.rx_buf_mode != usb_uart->cfg_new.rx_buf_mode) {
+                usb_uart_rx_stop(usb_uart);
+                usb_uart->cfg.rx_buf_mode = usb_uart->cfg_new.rx_buf_mode;
+                usb_uart_rx_start(usb_uart, usb_uart->cfg.uart_ch);
+            }
+            if(usb_uart->cfg.flow_pins != usb_uart->cfg_new.flow_pins ||
+               usb_uart->cfg.flow_control != usb_uart->cfg_new.flow_control) {
+                usb_uart_flow_pins_deinit(usb_uart);
                 usb_uart->cfg.flow_pins = usb_uart->cfg_new.flow_pins;
+                usb_uart->cfg.flow_control = usb_uart->cfg_new.flow_control;
+                usb_uart_flow_pins_init(usb_uart);
                 events |= WorkerEvtCtrlLineSet;
             }
             api_lock_unlock(usb_uart->cfg_lock);
@@ -259,17 +318,12 @@ static int32_t usb_uart_worker(void* context) {
     }
     usb_uart_vcp_deinit(usb_uart, usb_uart->cfg.vcp_ch);
     usb_uart_serial_deinit(usb_uart, usb_uart->cfg.uart_ch);
-
-    if(usb_uart->cfg.flow_pins != 0) {
-        furi_hal_gpio_init_simple(flow_pins[usb_uart->cfg.flow_pins - 1][0], GpioModeAnalog);
-        furi_hal_gpio_init_simple(flow_pins[usb_uart->cfg.flow_pins - 1][1], GpioModeAnalog);
-    }
+    usb_uart_flow_pins_deinit(usb_uart);
 
     furi_thread_flags_set(furi_thread_get_id(usb_uart->tx_thread), WorkerEvtTxStop);
     furi_thread_join(usb_uart->tx_thread);
     furi_thread_free(usb_uart->tx_thread);
 
-    furi_stream_buffer_free(usb_uart->rx_stream);
     furi_mutex_free(usb_uart->usb_mutex);
     furi_semaphore_free(usb_uart->tx_sem);
 
@@ -282,6 +336,26 @@ static int32_t usb_uart_worker(void* context) {
     return 0;
 }
 
+// With RTS/CTS nothing goes out while the device holds CTS high
+static void usb_uart_tx(UsbUartBridge* usb_uart, uint8_t* data, size_t len) {
+    if(usb_uart->cfg.flow_pins == 0 || usb_uart->cfg.flow_control != UsbUartFlowControlRtsCts) {
+        furi_hal_uart_tx(usb_uart->cfg.uart_ch, data, len);
+        return;
+    }
+
+    const GpioPin* cts = flow_pins[usb_uart->cfg.flow_pins - 1][1];
+    while(len > 0) {
+        while(furi_hal_gpio_read(cts)) {
+            if(furi_thread_flags_get() & WorkerEvtTxStop) return;
+            furi_delay_tick(1);
+        }
+        size_t chunk = MIN(len, (size_t)USB_UART_CTS_CHUNK);
+        furi_hal_uart_tx(usb_uart->cfg.uart_ch, data, chunk);
+        data += chunk;
+        len -= chunk;
+    }
+}
+
 static int32_t usb_uart_tx_thread(void* context) {
     UsbUartBridge* usb_uart = (UsbUartBridge*)context;
 
@@ -298,7 +372,7 @@ static int32_t usb_uart_tx_thread(void* context) {
 
             if(len > 0) {
                 usb_uart->st.tx_cnt += len;
-                furi_hal_uart_tx(usb_uart->cfg.uart_ch, data, len);
+                usb_uart_tx(usb_uart, data, len);
             }
         }
     }
@@ -310,6 +384,8 @@ static int32_t usb_uart_tx_thread(void* context) {
 static void vcp_on_cdc_tx_complete(void* context) {
     UsbUartBridge* usb_uart = (UsbUartBridge*)context;
     furi_semaphore_release(usb_uart->tx_sem);
+    // more may be waiting in the ring
+    furi_thread_flags_set(furi_thread_get_id(usb_uart->thread), WorkerEvtRxDone);
 }
 
 static void vcp_on_cdc_rx(void* context) {
@@ -5,18 +5,27 @@
 
 typedef struct UsbUartBridge UsbUartBridge;
 
+typedef enum {
+    UsbUartFlowControlNone,
+    // the flow pins are RTS and CTS instead of mirroring the host's RTS and DTR
+    UsbUartFlowControlRtsCts,
+} UsbUartFlowControl;
+
 typedef struct {
     uint8_t vcp_ch;
     uint8_t uart_ch;
     uint8_t flow_pins;
+    uint8_t flow_control;
     uint8_t baudrate_mode;
     uint32_t baudrate;
+    uint8_t rx_buf_mode; // RX ring of 2, 4, 8 or 16 KiB
 } UsbUartConfig;
 
 typedef struct {
     uint32_t rx_cnt;
     uint32_t tx_cnt;
     uint32_t baudrate_cur;
+    uint32_t rx_overflow;
 } UsbUartState;
 
 UsbUartBridge* usb_uart_enable(UsbUartConfig* cfg);
@@ -0,0 +1,209 @@
+#include "buffered_file_writer.h"
+
+#include <furi.h>
+
+typedef enum {
+    WriterEvtStop = (1 << 0),
+    WriterEvtData = (1 << 1),
+} WriterEvtFlags;
+
+#define WRITER_ALL_EVENTS (WriterEvtStop | WriterEvtData)
+
+struct BufferedFileWriter {
+    File* file;
+    FuriThread* thread;
+    uint8_t* buffer;
+    size_t size;
+    size_t chunk;
+    uint32_t flush_ticks;
+    // free running positions, only the producer moves head and only the writer moves tail
+    volatile size_t head;
+    volatile size_t tail;
+    // bytes refused by write() and bytes the card failed to take
+    volatile uint32_t dropped;
+    volatile uint32_t lost;
+
+    size_t rotate_size;
+    uint32_t rotate_ms;
+    BufferedFileWriterRotateCallback rotate_callback;
+    void* rotate_context;
+    // where and when the current file started, kept by the producer
+    size_t file_start;
+    uint32_t file_tick;
+    // ring position the file is switched at, set by the producer and cleared by the writer
+    volatile size_t rotate_at;
+    volatile bool rotate_pending;
+    // ring position of the first byte in the file being written, kept by the writer
+    size_t file_origin;
+};
+
+// Writes up to len bytes from the tail, never across the end of the ring
+static bool buffered_file_writer_flush_chunk(BufferedFileWriter* writer, size_t len) {
+    size_t offset = writer->tail % writer->size;
+    if(len > writer->size - offset) len = writer->size - offset;
+    if(storage_file_write(writer->file, &writer->buffer[offset], len) != len) return false;
+    writer->tail += len;
+    return true;
+}
+
+// Unless partial, stops at the last chunk boundary so file offsets stay chunk aligned.
+// Everything before a pending rotation point is written, then the file is switched.
+static void buffered_file_writer_flush(BufferedFileWriter* writer, bool partial) {
+    while(true) {
+        bool rotating = writer->rotate_pending;
+        size_t limit = rotating ? writer->rotate_at : writer->head;
+        size_t pending = limit - writer->tail;
+        if(!partial && !rotating) {
+            size_t tail_of_chunk = (limit - writer->file_origin) % writer->chunk;
+            pending = pending > tail_of_chunk ? pending - tail_of_chunk : 0;
+        }
+        if(pending > 0 && buffered_file_writer_flush_chunk(writer, pending)) continue;
+        if(pending > 0) {
+            // card is gone, count the rest as lost rather than spinning on it
+            writer->lost += limit - writer->tail;
+            writer->tail = limit;
+        }
+        if(!rotating) break;
+
+        if(!writer->rotate_callback(writer->file, writer->rotate_context)) {
+            FURI_LOG_E("BufferedFileWriter", "Cannot open the next file");
+        }
+        writer->file_origin = limit;
+        writer->rotate_pending = false;
+    }
+}
+
+static int32_t buffered_file_writer_worker(void* context) {
+    BufferedFileWriter* writer = context;
+
+    while(1) {
+        uint32_t events =
+            furi_thread_flags_wait(WRITER_ALL_EVENTS, FuriFlagWaitAny, writer->flush_ticks);
+        if(events == (uint32_t)FuriFlagErrorTimeout) {
+            buffered_file_writer_flush(writer, true);
+            continue;
+        }
+        furi_check((events & FuriFlagError) == 0);
+        if(events & WriterEvtStop) break;
+        if(events & WriterEvtData) buffered_file_writer_flush(writer, false);
+    }
+
+    buffered_file_writer_flush(writer, true);
+
+    return 0;
+}
+
+BufferedFileWriter* buffered_file_writer_alloc(File* file, size_t size, const char* name) {
+    furi_assert(file);
+    furi_assert(size >= BUFFERED_FILE_WRITER_MIN_SIZE && (size & (size - 1)) == 0);
+
+    BufferedFileWriter* writer = malloc(sizeof(BufferedFileWriter));
+    memset(writer, 0, sizeof(BufferedFileWriter));
+    writer->file = file;
+    writer->buffer = malloc(size);
+    writer->size = size;
+    writer->chunk = MIN((size_t)BUFFERED_FILE_WRITER_CHUNK_SIZE, size / 2);
+    writer->flush_ticks = furi_ms_to_ticks(BUFFERED_FILE_WRITER_FLUSH_MS);
+    writer->file_tick = furi_get_tick();
+
+    writer->thread = furi_thread_alloc();
+    furi_thread_set_name(writer->thread, name);
+    furi_thread_set_stack_size(writer->thread, 1024);
+    // the card waits behind the threads feeding the ring
+    furi_thread_set_priority(writer->thread, FuriThreadPriorityLow);
+    furi_thread_set_context(writer->thread, writer);
+    furi_thread_set_callback(writer->thread, buffered_file_writer_worker);
+    furi_thread_start(writer->thread);
+
+    return writer;
+}
+
+void buffered_file_writer_free(BufferedFileWriter* writer) {
+    furi_assert(writer);
+
+    furi_thread_flags_set(furi_thread_get_id(writer->thread), WriterEvtStop);
+    furi_thread_join(writer->thread);
+    furi_thread_free(writer->thread);
+
+    free(writer->buffer);
+    free(writer);
+}
+
+void buffered_file_writer_set_flush_interval(BufferedFileWriter* writer, uint32_t ms) {
+    furi_assert(writer);
+    writer->flush_ticks = furi_ms_to_ticks(ms);
+}
+
+void buffered_file_writer_set_rotation(
+    BufferedFileWriter* writer,
+    size_t max_size,
+    uint32_t max_ms,
+    BufferedFileWriterRotateCallback callback,
+    void* context) {
+    furi_assert(writer);
+    furi_assert(callback);
+
+    writer->rotate_size = max_size;
+    writer->rotate_ms = max_ms;
+    writer->rotate_context = context;
+    writer->rotate_callback = callback;
+}
+
+// Marks the head as the start of the next file once the current one is over a limit
+static bool buffered_file_writer_check_rotation(BufferedFileWriter* writer, size_t len) {
+    if(!writer->rotate_callback || writer->rotate_pending) return false;
+
+    size_t head = writer->head;
+    size_t in_file = head - writer->file_start;
+    uint32_t tick = furi_get_tick();
+    // a file is as old as its first byte, an empty one is never switched
+    if(in_file == 0) {
+        writer->file_tick = tick;
+        return false;
+    }
+
+    bool full = writer->rotate_size && in_file + len > writer->rotate_size;
+    bool old = writer->rotate_ms &&
+               tick - writer->file_tick >= furi_ms_to_ticks(writer->rotate_ms);
+    if(!full && !old) return false;
+
+    writer->rotate_at = head;
+    writer->rotate_pending = true;
+    writer->file_start = head;
+    writer->file_tick = tick;
+    return true;
+}
+
+bool buffered_file_writer_write(BufferedFileWriter* writer, const uint8_t* data, size_t len) {
+    furi_assert(writer);
+
+    bool rotated = buffered_file_writer_check_rotation(writer, len);
+
+    size_t head = writer->head;
+    size_t used = head - writer->tail;
+    if(len > writer->size - used) {
+        // a partial chunk would only corrupt the file further, drop all of it
+        writer->dropped += len;
+        if(rotated) furi_thread_flags_set(furi_thread_get_id(writer->thread), WriterEvtData);
+        return false;
+    }
+
+    size_t offset = head % writer->size;
+    size_t first = MIN(len, writer->size - offset);
+    memcpy(&writer->buffer[offset], data, first);
+    memcpy(writer->buffer, data + first, len - first);
+    writer->head = head + len;
+
+    // wake the writer once per completed chunk, and to switch files
+    size_t chunk = writer->chunk;
+    if(rotated || (head + len) / chunk != head / chunk) {
+        furi_thread_flags_set(furi_thread_get_id(writer->thread), WriterEvtData);
+    }
+
+    return true;
+}
+
+uint32_t buffered_file_writer_get_dropped(BufferedFileWriter* writer) {
+    furi_assert(writer);
+    return writer->dropped + writer->lost;
+}
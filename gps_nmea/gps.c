@@ -1,5 +1,6 @@
 #include "gps_uart.h"
 #include "constants.h"
+#include "profile.h"
 
 #include <furi.h>
 #include <gui/gui.h>
@@ -15,12 +16,41 @@ typedef struct {
     InputEvent input;
 } PluginEvent;
 
+static const uint32_t track_decimations[4] = {1, 5, 10, 30};
+
+static void render_track_info(Canvas* const canvas, GpsUart* gps_uart) {
+    char buffer[64];
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str_aligned(canvas, 64, 17, AlignCenter, AlignBottom, "Track logging");
+
+    canvas_set_font(canvas, FontSecondary);
+    if(gps_track_is_recording(gps_uart->track)) {
+        snprintf(buffer, 64, "Recording, %lu points", gps_track_get_points(gps_uart->track));
+    } else {
+        snprintf(buffer, 64, "Stopped");
+    }
+    canvas_draw_str_aligned(canvas, 64, 32, AlignCenter, AlignBottom, buffer);
+    snprintf(
+        buffer,
+        64,
+        "%s, every %lu. fix",
+        gps_uart->track_format == GPX ? "GPX" : "CSV",
+        gps_uart->track_decimation);
+    canvas_draw_str_aligned(canvas, 64, 47, AlignCenter, AlignBottom, buffer);
+}
+
 static void render_callback(Canvas* const canvas, void* context) {
     furi_assert(context);
     GpsUart* gps_uart = context;
     furi_mutex_acquire(gps_uart->mutex, FuriWaitForever);
 
-    if(!gps_uart->changing_baudrate) {
+    if(!gps_uart->changing_baudrate && furi_get_tick() < gps_uart->track_info_tick) {
+        render_track_info(canvas, gps_uart);
+    } else if(!gps_uart->changing_baudrate) {
+        if(gps_track_is_recording(gps_uart->track)) {
+            canvas_draw_disc(canvas, 2, 2, 2);
+        }
+
         canvas_set_font(canvas, FontPrimary);
         canvas_draw_str_aligned(canvas, 32, 8, AlignCenter, AlignBottom, "Latitude");
         canvas_draw_str_aligned(canvas, 96, 8, AlignCenter, AlignBottom, "Longitude");
@@ -95,6 +125,7 @@ int32_t gps_app(void* p) {
     FuriMessageQueue* event_queue = furi_message_queue_alloc(8, sizeof(PluginEvent));
 
     GpsUart* gps_uart = gps_uart_enable();
+    profile_start(); // "profile" CLI command in debug builds
 
     gps_uart->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
     if(!gps_uart->mutex) {
@@ -173,6 +204,34 @@ int32_t gps_app(void* p) {
                             gps_uart->speed_units = KNOTS;
                         }
                         break;
+                    case InputKeyOk:
+                        if(gps_track_is_recording(gps_uart->track)) {
+                            gps_track_stop(gps_uart->track);
+                        } else if(!gps_track_start(
+                                      gps_uart->track,
+                                      gps_uart->track_format,
+                                      gps_uart->track_decimation)) {
+                            FURI_LOG_E("GPS", "cannot open track file");
+                        }
+                        gps_uart->track_info_tick = furi_get_tick() + furi_ms_to_ticks(2000);
+                        break;
+                    case InputKeyLeft:
+                        // applies to the next track
+                        gps_uart->track_format = gps_uart->track_format == GPX ? CSV : GPX;
+                        gps_uart->track_info_tick = furi_get_tick() + furi_ms_to_ticks(2000);
+                        break;
+                    case InputKeyDown: {
+                        const int decimations_length =
+                            sizeof(track_decimations) / sizeof(track_decimations[0]);
+                        int i = 0;
+                        while(i < decimations_length - 1 &&
+                              track_decimations[i] != gps_uart->track_decimation) {
+                            i++;
+                        }
+                        gps_uart->track_decimation = track_decimations[(i + 1) % decimations_length];
+                        gps_uart->track_info_tick = furi_get_tick() + furi_ms_to_ticks(2000);
+                        break;
+                    }
                     case InputKeyBack:
                         processing = false;
                         break;
@@ -199,6 +258,7 @@ int32_t gps_app(void* p) {
     furi_message_queue_free(event_queue);
     furi_mutex_free(gps_uart->mutex);
     gps_uart_disable(gps_uart);
+    profile_stop();
 
     if(furi_hal_power_is_otg_enabled() && !otg_was_enabled) {
         furi_hal_power_disable_otg();
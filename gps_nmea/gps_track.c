@@ -0,0 +1,170 @@
+#include "gps_track.h"
+#include "gps_uart.h"
+
+struct GpsTrack {
+    FuriMutex* mutex;
+    Storage* storage;
+    File* file;
+    // fixes are formatted by the UART worker, its thread writes them to the card
+    BufferedFileWriter* writer;
+    TrackFormat format;
+    bool recording;
+    uint32_t decimation;
+    uint32_t skipped;
+    uint32_t points;
+};
+
+static const char* gpx_header =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<gpx version=\"1.1\" creator=\"Flipper Zero GPS\" xmlns=\"http://www.topografix.com/GPX/1/1\">\n"
+    "<trk><trkseg>\n";
+static const char* gpx_footer = "</trkseg></trk>\n</gpx>\n";
+static const char* csv_header = "time,latitude,longitude,altitude,speed_kn,course,satellites\n";
+
+GpsTrack* gps_track_alloc() {
+    GpsTrack* track = malloc(sizeof(GpsTrack));
+
+    track->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    track->storage = furi_record_open(RECORD_STORAGE);
+    track->file = storage_file_alloc(track->storage);
+
+    return track;
+}
+
+void gps_track_free(GpsTrack* track) {
+    furi_assert(track);
+
+    gps_track_stop(track);
+
+    storage_file_free(track->file);
+    furi_record_close(RECORD_STORAGE);
+    furi_mutex_free(track->mutex);
+    free(track);
+}
+
+bool gps_track_start(GpsTrack* track, TrackFormat format, uint32_t decimation) {
+    furi_assert(track);
+
+    gps_track_stop(track);
+    storage_simply_mkdir(track->storage, GPS_TRACK_FOLDER);
+
+    FuriHalRtcDateTime datetime;
+    furi_hal_rtc_get_datetime(&datetime);
+    FuriString* path = furi_string_alloc_printf(
+        "%s/track_%.4d%.2d%.2d-%.2d%.2d%.2d.%s",
+        GPS_TRACK_FOLDER,
+        datetime.year,
+        datetime.month,
+        datetime.day,
+        datetime.hour,
+        datetime.minute,
+        datetime.second,
+        format == GPX ? "gpx" : "csv");
+    bool opened = storage_file_open(
+        track->file, furi_string_get_cstr(path), FSAM_WRITE, FSOM_CREATE_ALWAYS);
+    furi_string_free(path);
+    if(!opened) {
+        storage_file_close(track->file);
+        return false;
+    }
+
+    track->writer = buffered_file_writer_alloc(track->file, GPS_TRACK_BUFFER_SIZE, "GpsTrack");
+    buffered_file_writer_set_flush_interval(track->writer, GPS_TRACK_FLUSH_INTERVAL_MS);
+    const char* header = format == GPX ? gpx_header : csv_header;
+    buffered_file_writer_write(track->writer, (const uint8_t*)header, strlen(header));
+
+    furi_mutex_acquire(track->mutex, FuriWaitForever);
+    track->format = format;
+    track->decimation = MAX(decimation, 1UL);
+    track->skipped = 0;
+    track->points = 0;
+    track->recording = true;
+    furi_mutex_release(track->mutex);
+
+    return true;
+}
+
+void gps_track_stop(GpsTrack* track) {
+    furi_assert(track);
+
+    if(!track->recording) {
+        return;
+    }
+
+    // the footer goes in after the last fix the worker adds
+    furi_mutex_acquire(track->mutex, FuriWaitForever);
+    track->recording = false;
+    if(track->format == GPX) {
+        buffered_file_writer_write(track->writer, (const uint8_t*)gpx_footer, strlen(gpx_footer));
+    }
+    furi_mutex_release(track->mutex);
+
+    buffered_file_writer_free(track->writer);
+    track->writer = NULL;
+    storage_file_close(track->file);
+}
+
+bool gps_track_is_recording(GpsTrack* track) {
+    furi_assert(track);
+    return track->recording;
+}
+
+uint32_t gps_track_get_points(GpsTrack* track) {
+    furi_assert(track);
+    return track->points;
+}
+
+void gps_track_add(GpsTrack* track, const GpsStatus* status) {
+    furi_assert(track);
+    furi_assert(status);
+
+    furi_mutex_acquire(track->mutex, FuriWaitForever);
+
+    if(track->recording && status->valid && ++track->skipped >= track->decimation) {
+        track->skipped = 0;
+
+        char line[GPS_TRACK_LINE_SIZE];
+        int len;
+        if(track->format == GPX) {
+            len = snprintf(
+                line,
+                sizeof(line),
+                "<trkpt lat=\"%.6f\" lon=\"%.6f\"><ele>%.1f</ele>"
+                "<time>20%02d-%02d-%02dT%02d:%02d:%02dZ</time></trkpt>\n",
+                (double)status->latitude,
+                (double)status->longitude,
+                (double)status->altitude,
+                status->date_year,
+                status->date_month,
+                status->date_day,
+                status->time_hours,
+                status->time_minutes,
+                status->time_seconds);
+        } else {
+            len = snprintf(
+                line,
+                sizeof(line),
+                "20%02d-%02d-%02dT%02d:%02d:%02dZ,%.6f,%.6f,%.1f,%.2f,%.1f,%d\n",
+                status->date_year,
+                status->date_month,
+                status->date_day,
+                status->time_hours,
+                status->time_minutes,
+                status->time_seconds,
+                (double)status->latitude,
+                (double)status->longitude,
+                (double)status->altitude,
+                (double)status->speed,
+                (double)status->course,
+                status->satellites_tracked);
+        }
+
+        // a fix the card cannot keep up with is dropped by the writer, not counted
+        len = MIN(len, (int)sizeof(line) - 1);
+        if(buffered_file_writer_write(track->writer, (const uint8_t*)line, len)) {
+            track->points++;
+        }
+    }
+
+    furi_mutex_release(track->mutex);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+#include "buffered_file_writer.h"
+
+#define GPS_TRACK_FOLDER EXT_PATH("apps_data/gps_nmea")
+// Fixes are written out after this long, or sooner once half the buffer is full
+#define GPS_TRACK_FLUSH_INTERVAL_MS (30 * 1000)
+#define GPS_TRACK_BUFFER_SIZE 4096
+#define GPS_TRACK_LINE_SIZE 160
+
+typedef enum { GPX, CSV } TrackFormat;
+
+typedef struct GpsStatus GpsStatus;
+
+/**
+ * Track logger. Fixes are formatted by the UART worker into the ring of a
+ * BufferedFileWriter, whose own thread writes them out in chunks, so the SD card is
+ * touched once per flush interval rather than once per sentence.
+ */
+typedef struct GpsTrack GpsTrack;
+
+GpsTrack* gps_track_alloc();
+
+void gps_track_free(GpsTrack* track);
+
+/** Open a new timestamped track file and start recording
+ *
+ * @param decimation keep one fix out of this many
+ * @return false if the file could not be created
+ */
+bool gps_track_start(GpsTrack* track, TrackFormat format, uint32_t decimation);
+
+/** Write out what is left, close the document and the file */
+void gps_track_stop(GpsTrack* track);
+
+bool gps_track_is_recording(GpsTrack* track);
+
+/** Number of fixes written to the current track so far */
+uint32_t gps_track_get_points(GpsTrack* track);
+
+/** Append a valid fix to the track, called from the UART worker */
+void gps_track_add(GpsTrack* track, const GpsStatus* status);
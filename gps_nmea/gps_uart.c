@@ -2,6 +2,7 @@
 
 #include <minmea.h>
 #include "gps_uart.h"
+#include "profile.h"
 
 typedef enum {
     WorkerEvtStop = (1 << 0),
@@ -10,15 +11,6 @@ typedef enum {
 
 #define WORKER_ALL_RX_EVENTS (WorkerEvtStop | WorkerEvtRxDone)
 
-static void gps_uart_on_irq_cb(UartIrqEvent ev, uint8_t data, void* context) {
-    GpsUart* gps_uart = (GpsUart*)context;
-
-    if(ev == UartIrqEventRXNE) {
-        furi_stream_buffer_send(gps_uart->rx_stream, &data, 1, 0);
-        furi_thread_flags_set(furi_thread_get_id(gps_uart->thread), WorkerEvtRxDone);
-    }
-}
-
 static void gps_uart_serial_init(GpsUart* gps_uart) {
     if(UART_CH == FuriHalUartIdUSART1) {
         furi_hal_console_disable();
@@ -26,13 +18,13 @@ static void gps_uart_serial_init(GpsUart* gps_uart) {
         furi_hal_uart_init(UART_CH, gps_uart->baudrate);
     }
 
-    furi_hal_uart_set_irq_cb(UART_CH, gps_uart_on_irq_cb, gps_uart);
     furi_hal_uart_set_br(UART_CH, gps_uart->baudrate);
+    uart_dma_start(
+        gps_uart->rx_dma, UART_CH, furi_thread_get_id(gps_uart->thread), WorkerEvtRxDone);
 }
 
 static void gps_uart_serial_deinit(GpsUart* gps_uart) {
-    UNUSED(gps_uart);
-    furi_hal_uart_set_irq_cb(UART_CH, NULL, NULL);
+    uart_dma_stop(gps_uart->rx_dma);
     if(UART_CH == FuriHalUartIdLPUART1) {
         furi_hal_uart_deinit(UART_CH);
     } else {
@@ -40,6 +32,33 @@ static void gps_uart_serial_deinit(GpsUart* gps_uart) {
     }
 }
 
+// The blink does not wait for the LED and is skipped when the last one was too recent
+static void gps_uart_notify(GpsUart* gps_uart, const NotificationSequence* sequence) {
+    uint32_t now = furi_get_tick();
+    if(now - gps_uart->notify_tick < furi_ms_to_ticks(GPS_NOTIFY_INTERVAL_MS)) {
+        return;
+    }
+    gps_uart->notify_tick = now;
+    notification_message(gps_uart->notifications, sequence);
+}
+
+// Sentence type from the three letters after any two letter talker ID (GP, GN, GL, ...),
+// checked before minmea walks the whole line for its checksum
+static uint8_t gps_uart_sentence_type(const char* line, size_t len) {
+    if(len < 6 || line[0] != '$') {
+        return 0;
+    }
+    const char* type = line + 3;
+    if(strncmp(type, "RMC", 3) == 0) {
+        return GpsSentenceRmc;
+    } else if(strncmp(type, "GGA", 3) == 0) {
+        return GpsSentenceGga;
+    } else if(strncmp(type, "GLL", 3) == 0) {
+        return GpsSentenceGll;
+    }
+    return 0;
+}
+
 static void gps_uart_parse_nmea(GpsUart* gps_uart, char* line) {
     switch(minmea_sentence_id(line, false)) {
     case MINMEA_SENTENCE_RMC: {
@@ -53,8 +72,14 @@ static void gps_uart_parse_nmea(GpsUart* gps_uart, char* line) {
             gps_uart->status.time_hours = frame.time.hours;
             gps_uart->status.time_minutes = frame.time.minutes;
             gps_uart->status.time_seconds = frame.time.seconds;
+            gps_uart->status.date_day = frame.date.day;
+            gps_uart->status.date_month = frame.date.month;
+            gps_uart->status.date_year = frame.date.year;
+
+            // one point per epoch, with the altitude from the last GGA
+            gps_track_add(gps_uart->track, &gps_uart->status);
 
-            notification_message_block(gps_uart->notifications, &sequence_blink_green_10);
+            gps_uart_notify(gps_uart, &sequence_blink_green_10);
         }
     } break;
 
@@ -71,7 +96,7 @@ static void gps_uart_parse_nmea(GpsUart* gps_uart, char* line) {
             gps_uart->status.time_minutes = frame.time.minutes;
             gps_uart->status.time_seconds = frame.time.seconds;
 
-            notification_message_block(gps_uart->notifications, &sequence_blink_magenta_10);
+            gps_uart_notify(gps_uart, &sequence_blink_magenta_10);
         }
     } break;
 
@@ -84,7 +109,7 @@ static void gps_uart_parse_nmea(GpsUart* gps_uart, char* line) {
             gps_uart->status.time_minutes = frame.time.minutes;
             gps_uart->status.time_seconds = frame.time.seconds;
 
-            notification_message_block(gps_uart->notifications, &sequence_blink_red_10);
+            gps_uart_notify(gps_uart, &sequence_blink_red_10);
         }
     } break;
 
@@ -93,6 +118,33 @@ static void gps_uart_parse_nmea(GpsUart* gps_uart, char* line) {
     }
 }
 
+// Terminates and parses each complete line where it lies in rx_buf, then moves the
+// trailing partial line to the front. Returns the length of that partial line.
+static size_t gps_uart_scan_lines(GpsUart* gps_uart, size_t length) {
+    char* buf = (char*)gps_uart->rx_buf;
+    size_t start = 0;
+
+    char* newline;
+    while((newline = memchr(buf + start, '\n', length - start)) != NULL) {
+        size_t end = newline - buf;
+        *newline = '\0';
+        if(gps_uart_sentence_type(buf + start, end - start) & gps_uart->sentences) {
+            gps_uart_parse_nmea(gps_uart, buf + start);
+        }
+        start = end + 1;
+    }
+
+    if(start == 0 && length >= RX_BUF_SIZE - 1) {
+        // no newline in a full buffer, this is not NMEA
+        return 0;
+    }
+    length -= start;
+    if(start > 0 && length > 0) {
+        memmove(buf, buf + start, length);
+    }
+    return length;
+}
+
 static int32_t gps_uart_worker(void* context) {
     GpsUart* gps_uart = (GpsUart*)context;
 
@@ -108,64 +160,21 @@ static int32_t gps_uart_worker(void* context) {
         }
 
         if(events & WorkerEvtRxDone) {
+            PROFILE_BEGIN(gps_uart_rx);
             size_t len = 0;
             do {
-                // receive serial bytes into rx_buf, starting at rx_offset from the start of the buffer
-                // the maximum we can receive is RX_BUF_SIZE - 1 - rx_offset
-                len = furi_stream_buffer_receive(
-                    gps_uart->rx_stream,
-                    gps_uart->rx_buf + rx_offset,
-                    RX_BUF_SIZE - 1 - rx_offset,
-                    0);
-                if(len > 0) {
-                    // increase rx_offset by the number of bytes received, and null-terminate rx_buf
-                    rx_offset += len;
-                    gps_uart->rx_buf[rx_offset] = '\0';
-
-                    // look for strings ending in newlines, starting at the start of rx_buf
-                    char* line_current = (char*)gps_uart->rx_buf;
-                    while(1) {
-                        // skip null characters
-                        while(*line_current == '\0' &&
-                              line_current < (char*)gps_uart->rx_buf + rx_offset - 1) {
-                            line_current++;
-                        }
-
-                        // find the next newline
-                        char* newline = strchr(line_current, '\n');
-                        if(newline) // newline found
-                        {
-                            // put a null terminator in place of the newline, to delimit the line string
-                            *newline = '\0';
-
-                            // attempt to parse the line as a NMEA sentence
-                            gps_uart_parse_nmea(gps_uart, line_current);
-
-                            // move the cursor to the character after the newline
-                            line_current = newline + 1;
-                        } else // no more newlines found
-                        {
-                            if(line_current >
-                               (char*)gps_uart->rx_buf) // at least one line was found
-                            {
-                                // clear parsed lines, and move any leftover bytes to the start of rx_buf
-                                rx_offset = 0;
-                                while(
-                                    *line_current) // stop when the original rx_offset terminator is reached
-                                {
-                                    gps_uart->rx_buf[rx_offset++] = *(line_current++);
-                                }
-                            }
-                            break; // go back to receiving bytes from the serial stream
-                        }
-                    }
-                }
+                // append to the partial line left over from the last pass
+                len = uart_dma_receive(
+                    gps_uart->rx_dma, gps_uart->rx_buf + rx_offset, RX_BUF_SIZE - 1 - rx_offset);
+                rx_offset = gps_uart_scan_lines(gps_uart, rx_offset + len);
             } while(len > 0);
+            PROFILE_END(gps_uart_rx);
         }
     }
 
     gps_uart_serial_deinit(gps_uart);
-    furi_stream_buffer_free(gps_uart->rx_stream);
+    uart_dma_free(gps_uart->rx_dma);
+    profile_thread_exit("uart");
 
     return 0;
 }
@@ -184,12 +193,15 @@ void gps_uart_init_thread(GpsUart* gps_uart) {
     gps_uart->status.time_hours = 0;
     gps_uart->status.time_minutes = 0;
     gps_uart->status.time_seconds = 0;
+    gps_uart->status.date_day = 0;
+    gps_uart->status.date_month = 0;
+    gps_uart->status.date_year = 0;
 
-    gps_uart->rx_stream = furi_stream_buffer_alloc(RX_BUF_SIZE * 5, 1);
+    gps_uart->rx_dma = uart_dma_alloc(RX_BUF_SIZE * 5);
 
     gps_uart->thread = furi_thread_alloc();
     furi_thread_set_name(gps_uart->thread, "GpsUartWorker");
-    furi_thread_set_stack_size(gps_uart->thread, 1024);
+    furi_thread_set_stack_size(gps_uart->thread, 2048);
     furi_thread_set_context(gps_uart->thread, gps_uart);
     furi_thread_set_callback(gps_uart->thread, gps_uart_worker);
 
@@ -214,6 +226,11 @@ GpsUart* gps_uart_enable() {
     gps_uart->changing_baudrate = false;
     gps_uart->backlight_on = false;
     gps_uart->speed_units = KNOTS;
+    gps_uart->sentences = GpsSentenceAll;
+
+    gps_uart->track = gps_track_alloc();
+    gps_uart->track_format = GPX;
+    gps_uart->track_decimation = 1;
 
     gps_uart_init_thread(gps_uart);
 
@@ -223,6 +240,7 @@ GpsUart* gps_uart_enable() {
 void gps_uart_disable(GpsUart* gps_uart) {
     furi_assert(gps_uart);
     gps_uart_deinit_thread(gps_uart);
+    gps_track_free(gps_uart->track);
     furi_record_close(RECORD_NOTIFICATION);
 
     free(gps_uart);
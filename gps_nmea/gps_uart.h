@@ -5,15 +5,19 @@
 
 #include <xtreme.h>
 
+#include "uart_dma.h"
+#include "gps_track.h"
+
 #define UART_CH \
     (xtreme_settings.uart_nmea_channel == UARTDefault ? FuriHalUartIdUSART1 : FuriHalUartIdLPUART1)
 
 #define RX_BUF_SIZE 1024
+#define GPS_NOTIFY_INTERVAL_MS 500
 
 static const int gps_baudrates[6] = {4800, 9600, 19200, 38400, 57600, 115200};
 static int current_gps_baudrate = 1;
 
-typedef struct {
+struct GpsStatus {
     bool valid;
     float latitude;
     float longitude;
@@ -26,22 +30,39 @@ typedef struct {
     int time_hours;
     int time_minutes;
     int time_seconds;
-} GpsStatus;
+    int date_day;
+    int date_month;
+    int date_year;
+};
 
 typedef enum { KNOTS, KPH, MPH, INVALID } SpeedUnit;
 
+typedef enum {
+    GpsSentenceRmc = (1 << 0),
+    GpsSentenceGga = (1 << 1),
+    GpsSentenceGll = (1 << 2),
+    GpsSentenceAll = GpsSentenceRmc | GpsSentenceGga | GpsSentenceGll,
+} GpsSentence;
+
 typedef struct {
     FuriMutex* mutex;
     FuriThread* thread;
-    FuriStreamBuffer* rx_stream;
+    UartDma* rx_dma;
     uint8_t rx_buf[RX_BUF_SIZE];
 
     NotificationApp* notifications;
+    uint32_t notify_tick;
+    uint8_t sentences; // GpsSentence types to parse, others are skipped unchecked
     uint32_t baudrate;
     bool changing_baudrate;
     bool backlight_on;
     SpeedUnit speed_units;
 
+    GpsTrack* track;
+    TrackFormat track_format;
+    uint32_t track_decimation;
+    uint32_t track_info_tick; // show the track settings until this tick
+
     GpsStatus status;
 } GpsUart;
 
@@ -0,0 +1,206 @@
+#include "uart_dma.h"
+
+#include <stm32wbxx_ll_dma.h>
+#include <stm32wbxx_ll_lpuart.h>
+#include <stm32wbxx_ll_usart.h>
+
+// the firmware leaves DMA1 channels 6 and 7 alone
+#define UART_DMA DMA1
+#define UART_DMA_USART_CHANNEL LL_DMA_CHANNEL_6
+#define UART_DMA_LPUART_CHANNEL LL_DMA_CHANNEL_7
+
+struct UartDma {
+    FuriHalUartId channel;
+    uint32_t dma_channel;
+    uint8_t* buffer;
+    size_t size;
+    // ring position of the next byte to hand out
+    size_t read;
+    // running byte counts, the DMA side is counted in laps of the ring
+    volatile uint32_t laps;
+    uint32_t read_total;
+    size_t overflow;
+    FuriThreadId thread;
+    uint32_t flag;
+};
+
+static void uart_dma_on_irq_cb(UartIrqEvent ev, uint8_t data, void* context) {
+    UNUSED(data);
+    UartDma* dma = context;
+
+    if(ev == UartIrqEventIDLE) {
+        furi_thread_flags_set(dma->thread, dma->flag);
+    }
+}
+
+static void uart_dma_isr(void* context) {
+    UartDma* dma = context;
+
+    if(dma->dma_channel == UART_DMA_USART_CHANNEL) {
+        if(LL_DMA_IsActiveFlag_HT6(UART_DMA)) LL_DMA_ClearFlag_HT6(UART_DMA);
+        if(LL_DMA_IsActiveFlag_TC6(UART_DMA)) {
+            LL_DMA_ClearFlag_TC6(UART_DMA);
+            dma->laps++;
+        }
+    } else {
+        if(LL_DMA_IsActiveFlag_HT7(UART_DMA)) LL_DMA_ClearFlag_HT7(UART_DMA);
+        if(LL_DMA_IsActiveFlag_TC7(UART_DMA)) {
+            LL_DMA_ClearFlag_TC7(UART_DMA);
+            dma->laps++;
+        }
+    }
+
+    furi_thread_flags_set(dma->thread, dma->flag);
+}
+
+static FuriHalInterruptId uart_dma_get_interrupt(UartDma* dma) {
+    return dma->dma_channel == UART_DMA_USART_CHANNEL ? FuriHalInterruptIdDma1Ch6 :
+                                                        FuriHalInterruptIdDma1Ch7;
+}
+
+UartDma* uart_dma_alloc(size_t size) {
+    furi_assert(size);
+    UartDma* dma = malloc(sizeof(UartDma));
+    dma->buffer = malloc(size);
+    dma->size = size;
+    return dma;
+}
+
+void uart_dma_free(UartDma* dma) {
+    furi_assert(dma);
+    free(dma->buffer);
+    free(dma);
+}
+
+void uart_dma_start(UartDma* dma, FuriHalUartId channel, FuriThreadId thread, uint32_t flag) {
+    furi_assert(dma);
+    dma->channel = channel;
+    dma->read = 0;
+    dma->laps = 0;
+    dma->read_total = 0;
+    dma->overflow = 0;
+    dma->thread = thread;
+    dma->flag = flag;
+
+    uint32_t source;
+    uint32_t request;
+    if(channel == FuriHalUartIdUSART1) {
+        dma->dma_channel = UART_DMA_USART_CHANNEL;
+        source = (uint32_t) & (USART1->RDR);
+        request = LL_DMAMUX_REQ_USART1_RX;
+    } else {
+        dma->dma_channel = UART_DMA_LPUART_CHANNEL;
+        source = (uint32_t) & (LPUART1->RDR);
+        request = LL_DMAMUX_REQ_LPUART1_RX;
+    }
+
+    LL_DMA_DisableChannel(UART_DMA, dma->dma_channel);
+    LL_DMA_ConfigAddresses(
+        UART_DMA,
+        dma->dma_channel,
+        source,
+        (uint32_t)dma->buffer,
+        LL_DMA_DIRECTION_PERIPH_TO_MEMORY);
+    LL_DMA_SetDataLength(UART_DMA, dma->dma_channel, dma->size);
+    LL_DMA_SetPeriphRequest(UART_DMA, dma->dma_channel, request);
+    LL_DMA_SetDataTransferDirection(
+        UART_DMA, dma->dma_channel, LL_DMA_DIRECTION_PERIPH_TO_MEMORY);
+    LL_DMA_SetChannelPriorityLevel(UART_DMA, dma->dma_channel, LL_DMA_PRIORITY_HIGH);
+    LL_DMA_SetMode(UART_DMA, dma->dma_channel, LL_DMA_MODE_CIRCULAR);
+    LL_DMA_SetPeriphIncMode(UART_DMA, dma->dma_channel, LL_DMA_PERIPH_NOINCREMENT);
+    LL_DMA_SetMemoryIncMode(UART_DMA, dma->dma_channel, LL_DMA_MEMORY_INCREMENT);
+    LL_DMA_SetPeriphSize(UART_DMA, dma->dma_channel, LL_DMA_PDATAALIGN_BYTE);
+    LL_DMA_SetMemorySize(UART_DMA, dma->dma_channel, LL_DMA_MDATAALIGN_BYTE);
+    LL_DMA_EnableIT_HT(UART_DMA, dma->dma_channel);
+    LL_DMA_EnableIT_TC(UART_DMA, dma->dma_channel);
+
+    furi_hal_interrupt_set_isr(uart_dma_get_interrupt(dma), uart_dma_isr, dma);
+    LL_DMA_EnableChannel(UART_DMA, dma->dma_channel);
+
+    // the HAL enables the per byte RXNE interrupt with the callback, only IDLE is needed now
+    furi_hal_uart_set_irq_cb(channel, uart_dma_on_irq_cb, dma);
+    if(channel == FuriHalUartIdUSART1) {
+        LL_USART_DisableIT_RXNE_RXFNE(USART1);
+        LL_USART_ClearFlag_IDLE(USART1);
+        LL_USART_EnableIT_IDLE(USART1);
+        LL_USART_EnableDMAReq_RX(USART1);
+    } else {
+        LL_LPUART_DisableIT_RXNE_RXFNE(LPUART1);
+        LL_LPUART_ClearFlag_IDLE(LPUART1);
+        LL_LPUART_EnableIT_IDLE(LPUART1);
+        LL_LPUART_EnableDMAReq_RX(LPUART1);
+    }
+}
+
+void uart_dma_stop(UartDma* dma) {
+    furi_assert(dma);
+
+    if(dma->channel == FuriHalUartIdUSART1) {
+        LL_USART_DisableDMAReq_RX(USART1);
+        LL_USART_DisableIT_IDLE(USART1);
+    } else {
+        LL_LPUART_DisableDMAReq_RX(LPUART1);
+        LL_LPUART_DisableIT_IDLE(LPUART1);
+    }
+    furi_hal_uart_set_irq_cb(dma->channel, NULL, NULL);
+
+    LL_DMA_DisableChannel(UART_DMA, dma->dma_channel);
+    furi_hal_interrupt_set_isr(uart_dma_get_interrupt(dma), NULL, NULL);
+}
+
+// Bytes written by the DMA but not handed out yet, more than the ring size after an overflow
+static uint32_t uart_dma_get_unread(UartDma* dma) {
+    uint32_t laps;
+    uint32_t remaining;
+    do {
+        laps = dma->laps;
+        remaining = LL_DMA_GetDataLength(UART_DMA, dma->dma_channel);
+    } while(laps != dma->laps);
+
+    uint32_t written = laps * dma->size + (dma->size - remaining);
+    uint32_t unread = written - dma->read_total;
+    // the counter reloaded but the lap isn't counted yet
+    if((int32_t)unread < 0) unread += dma->size;
+    return unread;
+}
+
+size_t uart_dma_receive(UartDma* dma, uint8_t* data, size_t size) {
+    furi_assert(dma);
+
+    uint32_t unread = uart_dma_get_unread(dma);
+    if(unread > dma->size) {
+        // the oldest bytes were written over, continue half a ring behind the DMA so the
+        // bytes being copied out can't change under the copy
+        size_t lost = unread - dma->size / 2;
+        dma->overflow += lost;
+        dma->read_total += lost;
+        dma->read = (dma->read + lost) % dma->size;
+        unread = dma->size / 2;
+    }
+
+    size_t count = 0;
+    while(count < unread && count < size) {
+        // up to the end of the ring or what is wanted, whichever comes first
+        size_t chunk = MIN(dma->size - dma->read, MIN(unread, size) - count);
+        memcpy(data + count, dma->buffer + dma->read, chunk);
+        count += chunk;
+        dma->read = (dma->read + chunk) % dma->size;
+    }
+    dma->read_total += count;
+
+    if(count && count < unread) furi_thread_flags_set(dma->thread, dma->flag);
+
+    return count;
+}
+
+size_t uart_dma_get_pending(UartDma* dma) {
+    furi_assert(dma);
+    return MIN(uart_dma_get_unread(dma), dma->size);
+}
+
+size_t uart_dma_take_overflow(UartDma* dma) {
+    furi_assert(dma);
+    size_t overflow = dma->overflow;
+    dma->overflow = 0;
+    return overflow;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <furi_hal.h>
+
+/**
+ * Circular DMA receiver for the USART1 and LPUART1 channels.
+ *
+ * Received bytes are copied into a ring buffer by DMA, the owner thread is only woken up by
+ * the IDLE line, half transfer and transfer complete interrupts instead of once per byte.
+ * The ring buffer size must hold what arrives between two wakeups of that thread, bytes the
+ * DMA writes over before they were picked up are skipped and counted as overflow.
+ */
+typedef struct UartDma UartDma;
+
+UartDma* uart_dma_alloc(size_t size);
+
+void uart_dma_free(UartDma* dma);
+
+/** Start receiving on a channel that already has its baudrate set
+ *
+ * Takes over the channel irq callback until uart_dma_stop().
+ *
+ * @param channel USART1 or LPUART1
+ * @param thread thread to wake up when data arrived
+ * @param flag thread flag to set on that thread
+ */
+void uart_dma_start(UartDma* dma, FuriHalUartId channel, FuriThreadId thread, uint32_t flag);
+
+/** Stop receiving and release the channel irq callback */
+void uart_dma_stop(UartDma* dma);
+
+/** Copy received bytes out of the ring buffer
+ *
+ * Sets the thread flag again when more bytes are left than fit into data.
+ *
+ * @return number of bytes copied
+ */
+size_t uart_dma_receive(UartDma* dma, uint8_t* data, size_t size);
+
+/** Number of received bytes waiting in the ring buffer */
+size_t uart_dma_get_pending(UartDma* dma);
+
+/** Number of bytes lost to overflow since the last call */
+size_t uart_dma_take_overflow(UartDma* dma);
@@ -8,27 +8,44 @@
 
 #include <storage/storage.h>
 #include <stream/stream.h>
-#include <stream/buffered_file_stream.h>
 #include <toolbox/stream/file_stream.h>
 
 #include <hex_editor_icons.h>
 #include <assets_icons.h>
 
+#include "hex_editor_cache.h"
+
 #define TAG "HexEditor"
 
+#define HEX_EDITOR_BYTES_PER_ROW (8UL)
+#define HEX_EDITOR_ROWS (6UL)
+#define HEX_EDITOR_VIEW_BYTES (HEX_EDITOR_BYTES_PER_ROW * HEX_EDITOR_ROWS)
+// Held Up/Down doubles the step every few repeats, up to 1/16 of the file
+#define HEX_EDITOR_REPEATS_PER_DOUBLING (4)
+
+typedef enum {
+    HexEditorStatusNone,
+    HexEditorStatusSaved,
+    HexEditorStatusSaveFailed,
+    HexEditorStatusEditsFull,
+    HexEditorStatusUnsaved,
+} HexEditorStatus;
+
 typedef struct {
-    uint32_t file_offset;
-    uint32_t file_read_bytes;
     uint32_t file_size;
-    uint8_t string_offset;
-    char editable_char;
-    Stream* stream;
+    uint32_t view_offset; // first byte on screen, always at a row start
+    uint32_t cursor;
+    uint8_t view_data[HEX_EDITOR_VIEW_BYTES];
+    uint8_t view_size;
+    uint8_t editable_byte;
     bool mode;
+    bool dirty;
+    HexEditorStatus status;
 } HexEditorModel;
 
 typedef struct {
     HexEditorModel* model;
-    FuriMutex** mutex;
+    FuriMutex* mutex;
 
     FuriMessageQueue* input_queue;
 
@@ -36,39 +53,72 @@ typedef struct {
     Gui* gui;
     Storage* storage;
 
-    FuriString* buffer;
+    Stream* stream;
+    HexEditorCache* cache;
+    uint32_t repeat_count;
 } HexEditor;
 
+static const char* hex_editor_status_text[] = {
+    [HexEditorStatusSaved] = "Saved",
+    [HexEditorStatusSaveFailed] = "Save failed",
+    [HexEditorStatusEditsFull] = "Hold OK to save first",
+    [HexEditorStatusUnsaved] = "Unsaved! Back: discard",
+};
+
+static char hex_editor_printable(uint8_t value) {
+    return (value >= 0x20 && value < 0x7F) ? (char)value : '.';
+}
+
 static void draw_callback(Canvas* canvas, void* ctx) {
     HexEditor* hex_editor = ctx;
+    furi_mutex_acquire(hex_editor->mutex, FuriWaitForever);
+    HexEditorModel* model = hex_editor->model;
 
     canvas_clear(canvas);
-    canvas_set_font(canvas, FontPrimary);
-    canvas_draw_str(canvas, 0, 10, "Line and mode:");
-
     canvas_set_font(canvas, FontSecondary);
 
-    canvas_draw_str_aligned(
-        canvas,
-        0,
-        20,
-        AlignLeft,
-        AlignBottom,
-        furi_string_get_cstr(hex_editor->buffer) + hex_editor->model->string_offset);
-
-    canvas_draw_icon(canvas, 0, 20, &I_Pin_arrow_up_7x9);
-
-    if(hex_editor->model->mode) {
-        elements_button_left(canvas, "ASCII -");
-        elements_button_right(canvas, "ASCII +");
+    char header[32];
+    if(model->status != HexEditorStatusNone) {
+        canvas_draw_str(canvas, 0, 8, hex_editor_status_text[model->status]);
+    } else if(!model->file_size) {
+        canvas_draw_str(canvas, 0, 8, "Empty file");
     } else {
-        elements_button_left(canvas, "");
-        elements_button_right(canvas, "");
+        uint8_t value = model->mode ? model->editable_byte :
+                                      model->view_data[model->cursor - model->view_offset];
+        snprintf(
+            header,
+            sizeof(header),
+            "%08lX '%c' %u",
+            model->cursor,
+            hex_editor_printable(value),
+            value);
+        canvas_draw_str(canvas, 0, 8, header);
+        const char* mode = model->mode ? "EDIT" : (model->dirty ? "*" : "");
+        canvas_draw_str_aligned(canvas, 128, 8, AlignRight, AlignBottom, mode);
+    }
+    canvas_draw_line(canvas, 0, 10, 127, 10);
+
+    canvas_set_font(canvas, FontKeyboard);
+    for(uint8_t i = 0; i < model->view_size; i++) {
+        uint8_t x = 4 + (i % HEX_EDITOR_BYTES_PER_ROW) * 15;
+        uint8_t y = 20 + (i / HEX_EDITOR_BYTES_PER_ROW) * 9;
+        bool selected = model->view_offset + i == model->cursor;
+        uint8_t value = (selected && model->mode) ? model->editable_byte : model->view_data[i];
+
+        char hex[3];
+        snprintf(hex, sizeof(hex), "%02X", value);
+        if(selected && model->mode) {
+            canvas_draw_box(canvas, x - 1, y - 8, 14, 10);
+            canvas_set_color(canvas, ColorWhite);
+            canvas_draw_str(canvas, x, y, hex);
+            canvas_set_color(canvas, ColorBlack);
+        } else {
+            if(selected) canvas_draw_frame(canvas, x - 1, y - 8, 14, 10);
+            canvas_draw_str(canvas, x, y, hex);
+        }
     }
 
-    canvas_set_font(canvas, FontPrimary);
-    canvas_draw_glyph(canvas, 0, 45, '0' + hex_editor->model->mode);
-    canvas_draw_glyph(canvas, 30, 45, hex_editor->model->editable_char);
+    furi_mutex_release(hex_editor->mutex);
 }
 
 static void input_callback(InputEvent* input_event, void* ctx) {
@@ -85,8 +135,6 @@ static HexEditor* hex_editor_alloc() {
     instance->model = malloc(sizeof(HexEditorModel));
     memset(instance->model, 0x0, sizeof(HexEditorModel));
 
-    instance->model->editable_char = ' ';
-
     instance->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
 
     instance->input_queue = furi_message_queue_alloc(8, sizeof(InputEvent));
@@ -100,14 +148,10 @@ static HexEditor* hex_editor_alloc() {
 
     instance->storage = furi_record_open(RECORD_STORAGE);
 
-    instance->buffer = furi_string_alloc();
-
     return instance;
 }
 
 static void hex_editor_free(HexEditor* instance) {
-    furi_record_close(RECORD_STORAGE);
-
     gui_remove_view_port(instance->gui, instance->view_port);
     furi_record_close(RECORD_GUI);
     view_port_free(instance->view_port);
@@ -116,9 +160,13 @@ static void hex_editor_free(HexEditor* instance) {
 
     furi_mutex_free(instance->mutex);
 
-    if(instance->model->stream) buffered_file_stream_close(instance->model->stream);
+    if(instance->cache) hex_editor_cache_free(instance->cache);
+    if(instance->stream) {
+        file_stream_close(instance->stream);
+        stream_free(instance->stream);
+    }
 
-    furi_string_free(instance->buffer);
+    furi_record_close(RECORD_STORAGE);
 
     free(instance->model);
     free(instance);
@@ -128,26 +176,134 @@ static bool hex_editor_open_file(HexEditor* hex_editor, const char* file_path) {
     furi_assert(hex_editor);
     furi_assert(file_path);
 
-    hex_editor->model->stream = buffered_file_stream_alloc(hex_editor->storage);
+    hex_editor->stream = file_stream_alloc(hex_editor->storage);
     bool isOk = true;
 
     do {
-        if(!buffered_file_stream_open(
-               hex_editor->model->stream, file_path, FSAM_READ_WRITE, FSOM_OPEN_EXISTING)) {
+        if(!file_stream_open(hex_editor->stream, file_path, FSAM_READ_WRITE, FSOM_OPEN_EXISTING)) {
             FURI_LOG_E(TAG, "Unable to open stream: %s", file_path);
             isOk = false;
             break;
         };
 
-        hex_editor->model->file_size = stream_size(hex_editor->model->stream);
+        hex_editor->cache = hex_editor_cache_alloc(hex_editor->stream);
+        hex_editor->model->file_size = hex_editor_cache_size(hex_editor->cache);
     } while(false);
 
     return isOk;
 }
 
-int32_t hex_editor_app(void* p) {
-    UNUSED(p);
+// Scrolls the view to the cursor and copies the visible bytes out of the page cache,
+// so the draw callback never touches storage
+static void hex_editor_update_view(HexEditor* hex_editor) {
+    HexEditorModel* model = hex_editor->model;
+    uint32_t row_start = model->cursor - model->cursor % HEX_EDITOR_BYTES_PER_ROW;
+
+    if(model->cursor < model->view_offset) {
+        model->view_offset = row_start;
+    } else if(model->cursor >= model->view_offset + HEX_EDITOR_VIEW_BYTES) {
+        model->view_offset = row_start - (HEX_EDITOR_ROWS - 1) * HEX_EDITOR_BYTES_PER_ROW;
+    }
+
+    model->view_size = MIN(HEX_EDITOR_VIEW_BYTES, model->file_size - model->view_offset);
+    if(!hex_editor_cache_read(
+           hex_editor->cache, model->view_offset, model->view_data, model->view_size)) {
+        FURI_LOG_E(TAG, "Unable to read at %08lX", model->view_offset);
+        memset(model->view_data, 0, sizeof(model->view_data));
+    }
+    model->dirty = hex_editor_cache_is_dirty(hex_editor->cache);
+}
+
+static void hex_editor_move(HexEditor* hex_editor, int64_t delta) {
+    HexEditorModel* model = hex_editor->model;
+    int64_t cursor = (int64_t)model->cursor + delta;
+    if(cursor < 0) cursor = 0;
+    if(cursor >= model->file_size) cursor = model->file_size - 1;
+    model->cursor = cursor;
+}
+
+// One row per press, held keys speed up so multi-megabyte files stay navigable
+static uint32_t hex_editor_row_step(HexEditor* hex_editor, InputType type) {
+    if(type == InputTypeShort) {
+        hex_editor->repeat_count = 0;
+        return HEX_EDITOR_BYTES_PER_ROW;
+    }
+    uint32_t shift = MIN(hex_editor->repeat_count++ / HEX_EDITOR_REPEATS_PER_DOUBLING, 31UL);
+    uint32_t max_rows = MAX(hex_editor->model->file_size / 16 / HEX_EDITOR_BYTES_PER_ROW, 1UL);
+    uint32_t rows = MIN(1UL << shift, max_rows);
+    return rows * HEX_EDITOR_BYTES_PER_ROW;
+}
+
+// Returns false when the app should exit
+static bool hex_editor_process_input(HexEditor* hex_editor, InputEvent* event) {
+    HexEditorModel* model = hex_editor->model;
+
+    if(event->type == InputTypeRelease) {
+        hex_editor->repeat_count = 0;
+        return true;
+    }
+    if(event->type != InputTypeShort && event->type != InputTypeRepeat &&
+       event->type != InputTypeLong) {
+        return true;
+    }
 
+    HexEditorStatus status = model->status;
+    model->status = HexEditorStatusNone;
+
+    if(event->key == InputKeyBack) {
+        if(event->type != InputTypeShort) return true;
+        if(model->mode) {
+            model->mode = 0;
+        } else if(!model->dirty || status == HexEditorStatusUnsaved) {
+            return false;
+        } else {
+            model->status = HexEditorStatusUnsaved;
+        }
+        return true;
+    }
+    if(!model->file_size) return true;
+
+    if(model->mode) {
+        if(event->type == InputTypeLong) return true;
+        if(event->key == InputKeyUp) model->editable_byte++;
+        if(event->key == InputKeyDown) model->editable_byte--;
+        if(event->key == InputKeyRight) model->editable_byte += 0x10;
+        if(event->key == InputKeyLeft) model->editable_byte -= 0x10;
+        if(event->key == InputKeyOk) {
+            if(!hex_editor_cache_write_byte(
+                   hex_editor->cache, model->cursor, model->editable_byte)) {
+                model->status = HexEditorStatusEditsFull;
+            }
+            model->mode = 0;
+        }
+        return true;
+    }
+
+    if(event->key == InputKeyOk) {
+        if(event->type == InputTypeShort) {
+            model->editable_byte = model->view_data[model->cursor - model->view_offset];
+            model->mode = 1;
+        } else if(event->type == InputTypeLong) {
+            model->status = hex_editor_cache_flush(hex_editor->cache) ?
+                                HexEditorStatusSaved :
+                                HexEditorStatusSaveFailed;
+        }
+        return true;
+    }
+    if(event->type == InputTypeLong) return true;
+
+    if(event->key == InputKeyRight) hex_editor_move(hex_editor, 1);
+    if(event->key == InputKeyLeft) hex_editor_move(hex_editor, -1);
+    if(event->key == InputKeyDown) {
+        hex_editor_move(hex_editor, hex_editor_row_step(hex_editor, event->type));
+    }
+    if(event->key == InputKeyUp) {
+        hex_editor_move(hex_editor, -(int64_t)hex_editor_row_step(hex_editor, event->type));
+    }
+    return true;
+}
+
+int32_t hex_editor_app(void* p) {
     HexEditor* hex_editor = hex_editor_alloc();
 
     FuriString* file_path;
@@ -177,134 +333,25 @@ int32_t hex_editor_app(void* p) {
 
         if(!hex_editor_open_file(hex_editor, furi_string_get_cstr(file_path))) break;
 
-        if(!stream_read_line(hex_editor->model->stream, hex_editor->buffer)) {
-            FURI_LOG_T(TAG, "No keys left in dict");
-            break;
-        }
+        furi_mutex_acquire(hex_editor->mutex, FuriWaitForever);
+        hex_editor_update_view(hex_editor);
+        furi_mutex_release(hex_editor->mutex);
+        view_port_update(hex_editor->view_port);
 
         InputEvent event;
-        int8_t off;
-        while(1) {
+        bool running = true;
+        while(running) {
             // Выбираем событие из очереди в переменную event (ждем бесконечно долго, если очередь пуста)
             // и проверяем, что у нас получилось это сделать
             furi_check(
                 furi_message_queue_get(hex_editor->input_queue, &event, FuriWaitForever) ==
                 FuriStatusOk);
 
-            // Если нажата кнопка "назад", то выходим из цикла, а следовательно и из приложения
-            if(event.type == InputTypeShort || event.type == InputTypeRepeat) {
-                if(!hex_editor->model->mode) {
-                    off = 1;
-                    if(event.type == InputTypeRepeat) {
-                        off = 2;
-                    }
-                    if(event.key == InputKeyRight) {
-                        hex_editor->model->string_offset += off;
-                        if(hex_editor->model->string_offset >=
-                           furi_string_size(hex_editor->buffer)) {
-                            // dengeros
-                            hex_editor->model->string_offset -=
-                                furi_string_size(hex_editor->buffer);
-                        }
-                    }
-                    if(event.key == InputKeyLeft) {
-                        if(hex_editor->model->string_offset - off < 0) {
-                            // dengeros
-                            hex_editor->model->string_offset +=
-                                furi_string_size(hex_editor->buffer);
-                        }
-                        hex_editor->model->string_offset -= off;
-                    }
-                    if(event.key == InputKeyDown) {
-                        hex_editor->model->string_offset = 0;
-                        if(!stream_read_line(hex_editor->model->stream, hex_editor->buffer)) {
-                            FURI_LOG_T(TAG, "No keys left in dict");
-                        }
-                    }
-                    if(event.key == InputKeyUp) {
-                        hex_editor->model->string_offset = 0;
-                        // TODO asert
-                        if(!stream_seek(hex_editor->model->stream, -1, StreamOffsetFromCurrent)) {
-                            FURI_LOG_E(TAG, "Unable to seek stream");
-                            break;
-                        }
-                        // NOT work on first line
-                        stream_seek_to_char(
-                            hex_editor->model->stream, '\n', StreamDirectionBackward);
-
-                        if(!stream_seek_to_char(
-                               hex_editor->model->stream, '\n', StreamDirectionBackward)) {
-                            stream_rewind(hex_editor->model->stream);
-                        } else {
-                            if(!stream_seek(
-                                   hex_editor->model->stream, 1, StreamOffsetFromCurrent)) {
-                                FURI_LOG_E(TAG, "Unable to seek stream");
-                                break;
-                            }
-                        }
-
-                        if(!stream_read_line(hex_editor->model->stream, hex_editor->buffer)) {
-                            FURI_LOG_T(TAG, "No keys left in dict");
-                            break;
-                        }
-                    }
-
-                    if(event.key == InputKeyOk) {
-                        hex_editor->model->editable_char = furi_string_get_char(
-                            hex_editor->buffer, hex_editor->model->string_offset);
-
-                        hex_editor->model->mode = 1;
-                    }
-                } else {
-                    off = 1;
-                    if(event.type == InputTypeRepeat) {
-                        off = 4;
-                    }
-                    if(event.key == InputKeyRight) {
-                        hex_editor->model->editable_char += off;
-                    }
-                    if(event.key == InputKeyLeft) {
-                        hex_editor->model->editable_char -= off;
-                    }
-
-                    if(event.key == InputKeyOk) {
-                        if(!stream_seek(hex_editor->model->stream, -1, StreamOffsetFromCurrent)) {
-                            FURI_LOG_E(TAG, "Unable to seek stream");
-                            break;
-                        }
-                        stream_seek_to_char(
-                            hex_editor->model->stream, '\n', StreamDirectionBackward);
-                        stream_seek(
-                            hex_editor->model->stream,
-                            hex_editor->model->string_offset + 1,
-                            StreamOffsetFromCurrent);
-
-                        stream_write_char(
-                            hex_editor->model->stream, hex_editor->model->editable_char);
-
-                        hex_editor->model->editable_char = ' ';
-
-                        hex_editor->model->mode = 0;
-
-                        stream_seek_to_char(
-                            hex_editor->model->stream, '\n', StreamDirectionBackward);
-
-                        if(!stream_seek(hex_editor->model->stream, 1, StreamOffsetFromCurrent)) {
-                            FURI_LOG_E(TAG, "Unable to seek stream");
-                            break;
-                        }
-
-                        if(!stream_read_line(hex_editor->model->stream, hex_editor->buffer)) {
-                            FURI_LOG_T(TAG, "No keys left in dict");
-                            break;
-                        }
-                    }
-                }
-            }
-            if(event.key == InputKeyBack) {
-                break;
-            }
-            // ?
+            furi_mutex_acquire(hex_editor->mutex, FuriWaitForever);
+            running = hex_editor_process_input(hex_editor, &event);
+            if(hex_editor->model->file_size) hex_editor_update_view(hex_editor);
+            furi_mutex_release(hex_editor->mutex);
+
             view_port_update(hex_editor->view_port);
         }
     } while(false);
@@ -313,4 +360,4 @@ int32_t hex_editor_app(void* p) {
     hex_editor_free(hex_editor);
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,123 @@
+#include "hex_editor_cache.h"
+
+#include <furi.h>
+
+#define TAG "HexEditorCache"
+
+typedef struct {
+    uint32_t index; // page number in the file
+    uint32_t last_use;
+    bool valid;
+    bool dirty;
+    uint8_t data[HEX_EDITOR_PAGE_SIZE];
+} HexEditorPage;
+
+struct HexEditorCache {
+    Stream* stream;
+    uint32_t size;
+    uint32_t use_counter;
+    uint8_t dirty_count;
+    HexEditorPage pages[HEX_EDITOR_PAGE_COUNT];
+};
+
+static size_t hex_editor_page_length(HexEditorCache* cache, uint32_t index) {
+    uint32_t start = index * HEX_EDITOR_PAGE_SIZE;
+    return MIN(HEX_EDITOR_PAGE_SIZE, cache->size - start);
+}
+
+static bool hex_editor_page_io(HexEditorCache* cache, HexEditorPage* page, bool write) {
+    size_t length = hex_editor_page_length(cache, page->index);
+    if(!stream_seek(cache->stream, page->index * HEX_EDITOR_PAGE_SIZE, StreamOffsetFromStart)) {
+        FURI_LOG_E(TAG, "Unable to seek to page %lu", page->index);
+        return false;
+    }
+    size_t done = write ? stream_write(cache->stream, page->data, length) :
+                          stream_read(cache->stream, page->data, length);
+    if(done != length) {
+        FURI_LOG_E(TAG, "Unable to %s page %lu", write ? "write" : "read", page->index);
+        return false;
+    }
+    return true;
+}
+
+// Cached page or a freshly loaded one in place of the least recently used clean page
+static HexEditorPage* hex_editor_page_get(HexEditorCache* cache, uint32_t index) {
+    HexEditorPage* victim = NULL;
+    for(size_t i = 0; i < HEX_EDITOR_PAGE_COUNT; i++) {
+        HexEditorPage* page = &cache->pages[i];
+        if(page->valid && page->index == index) {
+            page->last_use = ++cache->use_counter;
+            return page;
+        }
+        if(page->dirty) continue;
+        if(!victim || !page->valid || (victim->valid && page->last_use < victim->last_use)) {
+            victim = page;
+        }
+    }
+    // Only possible if the dirty page limit is broken
+    furi_check(victim);
+
+    victim->index = index;
+    victim->valid = hex_editor_page_io(cache, victim, false);
+    if(!victim->valid) return NULL;
+    victim->last_use = ++cache->use_counter;
+    return victim;
+}
+
+HexEditorCache* hex_editor_cache_alloc(Stream* stream) {
+    HexEditorCache* cache = malloc(sizeof(HexEditorCache));
+    cache->stream = stream;
+    cache->size = stream_size(stream);
+    return cache;
+}
+
+void hex_editor_cache_free(HexEditorCache* cache) {
+    free(cache);
+}
+
+uint32_t hex_editor_cache_size(HexEditorCache* cache) {
+    return cache->size;
+}
+
+bool hex_editor_cache_read(HexEditorCache* cache, uint32_t offset, uint8_t* data, size_t size) {
+    if(offset > cache->size || size > cache->size - offset) return false;
+    while(size) {
+        HexEditorPage* page = hex_editor_page_get(cache, offset / HEX_EDITOR_PAGE_SIZE);
+        if(!page) return false;
+        size_t page_offset = offset % HEX_EDITOR_PAGE_SIZE;
+        size_t length = MIN(size, HEX_EDITOR_PAGE_SIZE - page_offset);
+        memcpy(data, page->data + page_offset, length);
+        data += length;
+        offset += length;
+        size -= length;
+    }
+    return true;
+}
+
+bool hex_editor_cache_write_byte(HexEditorCache* cache, uint32_t offset, uint8_t value) {
+    if(offset >= cache->size) return false;
+    HexEditorPage* page = hex_editor_page_get(cache, offset / HEX_EDITOR_PAGE_SIZE);
+    if(!page) return false;
+    if(!page->dirty) {
+        if(cache->dirty_count >= HEX_EDITOR_DIRTY_PAGES_MAX) return false;
+        page->dirty = true;
+        cache->dirty_count++;
+    }
+    page->data[offset % HEX_EDITOR_PAGE_SIZE] = value;
+    return true;
+}
+
+bool hex_editor_cache_is_dirty(HexEditorCache* cache) {
+    return cache->dirty_count > 0;
+}
+
+bool hex_editor_cache_flush(HexEditorCache* cache) {
+    for(size_t i = 0; i < HEX_EDITOR_PAGE_COUNT; i++) {
+        HexEditorPage* page = &cache->pages[i];
+        if(!page->dirty) continue;
+        if(!hex_editor_page_io(cache, page, true)) return false;
+        page->dirty = false;
+        cache->dirty_count--;
+    }
+    return true;
+}
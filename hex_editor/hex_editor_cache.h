@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <toolbox/stream/stream.h>
+
+#define HEX_EDITOR_PAGE_SIZE (512UL)
+#define HEX_EDITOR_PAGE_COUNT (8)
+// Pages that may hold unsaved edits, the rest stays free for the view,
+// which never spans more than two pages
+#define HEX_EDITOR_DIRTY_PAGES_MAX (HEX_EDITOR_PAGE_COUNT - 2)
+
+typedef struct HexEditorCache HexEditorCache;
+
+// LRU cache of file pages with an overlay of edited bytes.
+// Edits stay in RAM until hex_editor_cache_flush(), dirty pages are never evicted.
+HexEditorCache* hex_editor_cache_alloc(Stream* stream);
+void hex_editor_cache_free(HexEditorCache* cache);
+
+uint32_t hex_editor_cache_size(HexEditorCache* cache);
+bool hex_editor_cache_read(HexEditorCache* cache, uint32_t offset, uint8_t* data, size_t size);
+// Returns false if the byte is outside the file or every editable page is already dirty
+bool hex_editor_cache_write_byte(HexEditorCache* cache, uint32_t offset, uint8_t value);
+bool hex_editor_cache_is_dirty(HexEditorCache* cache);
+bool hex_editor_cache_flush(HexEditorCache* cache);
@@ -0,0 +1,96 @@
+// Encodes the barcodes of a fixture ("TYPE data" lines, types as in the app's
+// files) with barcode_loader() and barcode_render(), and prints the encoded
+// data and the rendered line buffers
+
+#include "../barcode_gen/barcode_app.h"
+#include "bench.h"
+
+// How many times every barcode is encoded for the throughput figure
+#define BENCH_ROUNDS 2000
+
+static void barcode_encode(BarcodeModel* model, const char* type, const char* data) {
+    FuriString* type_string = furi_string_alloc_set_str(type);
+
+    model->data = calloc(1, sizeof(BarcodeData));
+    model->data->valid = true;
+    model->data->raw_data = furi_string_alloc_set_str(data);
+    model->data->correct_data = furi_string_alloc();
+    model->data->type_obj = get_type(type_string);
+    barcode_loader(model->data);
+    barcode_render(model);
+
+    furi_string_free(type_string);
+}
+
+static void barcode_release(BarcodeModel* model) {
+    furi_string_free(model->data->raw_data);
+    furi_string_free(model->data->correct_data);
+    free(model->data);
+}
+
+static void print_line(const char* name, const uint8_t* line) {
+    printf("  %s ", name);
+    for(int x = 0; x < BARCODE_LINE_WIDTH; x++) {
+        putchar(line[x >> 3] & (1 << (x & 7)) ? '#' : '.');
+    }
+    printf("\n");
+}
+
+int main(int argc, char** argv) {
+    if(argc != 2) {
+        fprintf(stderr, "Usage: %s barcodes.txt\n", argv[0]);
+        return 1;
+    }
+    FILE* fp = fopen(argv[1], "r");
+    if(!fp) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    init_types();
+
+    char line[256];
+    int count = 0;
+    double seconds = 0;
+    while(fgets(line, sizeof(line), fp)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if(line[0] == '#' || line[0] == '\0') continue;
+        char* data = strchr(line, ' ');
+        if(!data) continue;
+        *data++ = '\0';
+
+        BarcodeModel model = {0};
+        barcode_encode(&model, line, data);
+
+        printf("%s %s: ", line, data);
+        if(model.data->valid) {
+            printf("%s\n", furi_string_get_cstr(model.data->correct_data));
+            print_line("bars  ", model.bars);
+            print_line("guards", model.guards);
+            if(model.digit_count) {
+                printf("  digits");
+                for(int j = 0; j < model.digit_count; j++) {
+                    printf(" %c@%d", model.digits[j].digit, model.digits[j].x);
+                }
+                printf("\n");
+            }
+        } else {
+            printf("%s\n", get_error_code_name(model.data->reason));
+        }
+        barcode_release(&model);
+
+        double start = bench_seconds();
+        for(int round = 0; round < BENCH_ROUNDS; round++) {
+            BarcodeModel bench_model = {0};
+            barcode_encode(&bench_model, line, data);
+            barcode_release(&bench_model);
+        }
+        seconds += bench_seconds() - start;
+        count++;
+    }
+    fclose(fp);
+    free_types();
+
+    bench_report("barcode_loader()+render", (double)count * BENCH_ROUNDS, "barcodes", seconds);
+    return 0;
+}
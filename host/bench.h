@@ -0,0 +1,25 @@
+#pragma once
+
+// Timing helpers shared by the host benches. Results go to stdout, where they
+// are diffed against golden/, throughput goes to stderr
+
+#include <stdio.h>
+#include <time.h>
+
+static inline double bench_seconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static inline void bench_report(const char* name, double count, const char* unit, double seconds) {
+    fprintf(
+        stderr,
+        "%-24s %12.0f %s/s (%.0f %s in %.3f s)\n",
+        name,
+        seconds > 0 ? count / seconds : 0,
+        unit,
+        count,
+        unit,
+        seconds);
+}
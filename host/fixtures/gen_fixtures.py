@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+# Writes the mfkey32 and mifare_nested fixtures and their golden outputs from
+# a plain Python model of Crypto1 and of the 16 bit tag PRNG, so that the
+# expected keys and PRNG positions don't come from the code under test.
+#
+# Usage (from host/): python3 fixtures/gen_fixtures.py
+
+import os
+import random
+
+LF_POLY_ODD = 0x29CE5C
+LF_POLY_EVEN = 0x870804
+
+
+def bit(x, n):
+    return (x >> n) & 1
+
+
+def bebit(x, n):
+    return bit(x, n ^ 24)
+
+
+def parity(x):
+    return bin(x).count("1") & 1
+
+
+def filter_bit(x):
+    f = (0xF22C0 >> (x & 0xF)) & 16
+    f |= (0x6C9C0 >> ((x >> 4) & 0xF)) & 8
+    f |= (0x3C8B0 >> ((x >> 8) & 0xF)) & 4
+    f |= (0x1E458 >> ((x >> 12) & 0xF)) & 2
+    f |= (0x0D938 >> ((x >> 16) & 0xF)) & 1
+    return bit(0xEC57E80A, f)
+
+
+class Crypto1:
+    def __init__(self, key):
+        self.odd = 0
+        self.even = 0
+        for i in range(47, 0, -2):
+            self.odd = self.odd << 1 | bit(key, (i - 1) ^ 7)
+            self.even = self.even << 1 | bit(key, i ^ 7)
+
+    def bit(self, data_in):
+        ret = filter_bit(self.odd)
+        feedin = data_in & 1
+        feedin ^= LF_POLY_ODD & self.odd
+        feedin ^= LF_POLY_EVEN & self.even
+        self.even = (self.even << 1 | parity(feedin)) & 0xFFFFFFFF
+        self.odd, self.even = self.even, self.odd
+        return ret
+
+    def word(self, data_in):
+        ret = 0
+        for i in range(32):
+            ret |= self.bit(bebit(data_in, i)) << (i ^ 24)
+        return ret
+
+
+def swapendian(x):
+    return int.from_bytes(x.to_bytes(4, "big"), "little")
+
+
+def prng_successor(x, n):
+    x = swapendian(x)
+    for _ in range(n):
+        x = (x >> 1 | ((x >> 16 ^ x >> 18 ^ x >> 19 ^ x >> 21) & 1) << 31) & 0xFFFFFFFF
+    return swapendian(x)
+
+
+def reader_auth(key, uid, nt, nr):
+    """Encrypted reader nonce and answer of an authentication sniffed by mfkey32"""
+    state = Crypto1(key)
+    state.word(uid ^ nt)
+    nr_enc = nr ^ state.word(nr)
+    ar_enc = prng_successor(nt, 64) ^ state.word(0)
+    return nr_enc, ar_enc
+
+
+def prng16_sequence():
+    """The 65535 states of the 16 bit PRNG from 0x0001, as sent on air (bytes swapped)"""
+    states = []
+    x = 1
+    for _ in range(65535):
+        states.append((x << 8 | x >> 8) & 0xFFFF)
+        x = (x >> 1 | ((x ^ x >> 2 ^ x >> 3 ^ x >> 5) & 1) << 15) & 0xFFFF
+    return states
+
+
+def write_mfkey32(fixture, golden, rng):
+    keys = [0xA0A1A2A3A4A5, 0xFFFFFFFFFFFF, 0x4D3A99C351DD, 0x1A982C7E459A]
+    with open(fixture, "w") as f, open(golden, "w") as g:
+        for n, key in enumerate(keys):
+            uid = rng.getrandbits(32)
+            nt0, nt1 = rng.getrandbits(32), rng.getrandbits(32)
+            nr0, nr1 = rng.getrandbits(32), rng.getrandbits(32)
+            nr0_enc, ar0_enc = reader_auth(key, uid, nt0, nr0)
+            nr1_enc, ar1_enc = reader_auth(key, uid, nt1, nr1)
+            f.write(
+                "Sec %d key A cuid %08x nt0 %08x nr0 %08x ar0 %08x nt1 %08x nr1 %08x ar1 %08x\n"
+                % (n, uid, nt0, nr0_enc, ar0_enc, nt1, nr1_enc, ar1_enc)
+            )
+            g.write("%08x %08x %012X\n" % (uid, ar1_enc, key))
+
+
+def write_nested(fixture, golden, rng):
+    states = prng16_sequence()
+    position = {value: p + 1 for p, value in enumerate(states)}
+    position[0] = 0
+    pairs = []
+    for _ in range(24):
+        p1 = rng.randrange(65535)
+        p2 = (p1 + rng.randrange(1, 2000)) % 65535
+        nt1 = states[p1] << 16 | states[(p1 + 16) % 65535]
+        nt2 = states[p2] << 16 | states[(p2 + 16) % 65535]
+        pairs.append((nt1, nt2, "%u" % ((p2 - p1) % 65535)))
+    # Hard (random) nonces, validate_prng_nonce() must reject them
+    for _ in range(8):
+        pairs.append((rng.getrandbits(32), rng.getrandbits(32), "hard"))
+
+    with open(fixture, "w") as f, open(golden, "w") as g:
+        f.write("# nt1 nt2, 24 pairs of weak PRNG nonces then 8 pairs of hard ones\n")
+        for nt1, nt2, distance in pairs:
+            f.write("%08x %08x\n" % (nt1, nt2))
+            g.write(
+                "%08x %08x %5u %5u %5u %5u %s\n"
+                % (
+                    nt1,
+                    nt2,
+                    position[nt1 >> 16],
+                    position[nt1 & 0xFFFF],
+                    position[nt2 >> 16],
+                    position[nt2 & 0xFFFF],
+                    distance,
+                )
+            )
+
+
+def main():
+    host = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    rng = random.Random(143)
+    write_mfkey32(
+        os.path.join(host, "fixtures", "mfkey32.log"),
+        os.path.join(host, "golden", "mfkey32.out"),
+        rng,
+    )
+    write_nested(
+        os.path.join(host, "fixtures", "nested_nonces.txt"),
+        os.path.join(host, "golden", "nested_prng.out"),
+        rng,
+    )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,67 @@
+// Cracks the nonces of an mfkey32 log with recover(), msb_limit msb values per
+// round like the app does with its RAM budget, and prints uid, ar1 and key
+
+#include "../mfkey32/crypto1_recover.h"
+#include "bench.h"
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+int main(int argc, char** argv) {
+    if(argc != 3) {
+        fprintf(stderr, "Usage: %s msb_limit mfkey32.log\n", argv[0]);
+        return 1;
+    }
+    int msb_limit = atoi(argv[1]);
+    FILE* fp = fopen(argv[2], "r");
+    if(!fp || msb_limit < 1 || 256 % msb_limit != 0) {
+        fprintf(stderr, "%s: bad arguments\n", argv[0]);
+        return 1;
+    }
+
+    char line[512];
+    int nonces = 0;
+    double seconds = 0;
+    while(fgets(line, sizeof(line), fp)) {
+        uint32_t uid, nt0, nr0_enc, ar0_enc, nt1, nr1_enc, ar1_enc;
+        int fields = sscanf(
+            line,
+            "Sec %*s key %*s cuid %" SCNx32 " nt0 %" SCNx32 " nr0 %" SCNx32 " ar0 %" SCNx32
+            " nt1 %" SCNx32 " nr1 %" SCNx32 " ar1 %" SCNx32,
+            &uid,
+            &nt0,
+            &nr0_enc,
+            &ar0_enc,
+            &nt1,
+            &nr1_enc,
+            &ar1_enc);
+        if(fields != 7) continue;
+
+        uint32_t p64 = prng_successor(nt0, 64);
+        struct Crypto1Params p = {
+            0,
+            nr0_enc,
+            uid ^ nt0,
+            uid ^ nt1,
+            nr1_enc,
+            prng_successor(nt1, 64),
+            ar1_enc};
+
+        double start = bench_seconds();
+        bool found = recover(&p, ar0_enc ^ p64, msb_limit, 0, NULL);
+        seconds += bench_seconds() - start;
+        nonces++;
+
+        if(found) {
+            printf("%08" PRIx32 " %08" PRIx32 " %012" PRIX64 "\n", uid, ar1_enc, p.key);
+        } else {
+            printf("%08" PRIx32 " %08" PRIx32 " no key\n", uid, ar1_enc);
+        }
+    }
+    fclose(fp);
+
+    char name[32];
+    snprintf(name, sizeof(name), "recover() msb_limit %d", msb_limit);
+    bench_report(name, nonces, "nonces", seconds);
+    return 0;
+}
@@ -0,0 +1,76 @@
+// PRNG positions and distances of nonce pairs with mifare_nested's
+// nonce_distance() and nested_prng_distance(), then validate_prng_nonce()
+// throughput over every weak nonce
+
+#include "../mifare_nested/lib/nested/nested_prng.h"
+#include "bench.h"
+
+#include <inttypes.h>
+
+static uint16_t prng_next(uint16_t x) {
+    return x >> 1 | (x ^ x >> 2 ^ x >> 3 ^ x >> 5) << 15;
+}
+
+int main(int argc, char** argv) {
+    if(argc != 2) {
+        fprintf(stderr, "Usage: %s nonces.txt\n", argv[0]);
+        return 1;
+    }
+    FILE* fp = fopen(argv[1], "r");
+    if(!fp) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    char line[128];
+    while(fgets(line, sizeof(line), fp)) {
+        uint32_t nt1, nt2;
+        if(sscanf(line, "%" SCNx32 " %" SCNx32, &nt1, &nt2) != 2) continue;
+
+        uint32_t msb1 = nt1 >> 16, lsb1 = nt1 & 0xffff;
+        uint32_t msb2 = nt2 >> 16, lsb2 = nt2 & 0xffff;
+        nonce_distance(&msb1, &lsb1);
+        nonce_distance(&msb2, &lsb2);
+
+        printf(
+            "%08" PRIx32 " %08" PRIx32 " %5" PRIu32 " %5" PRIu32 " %5" PRIu32 " %5" PRIu32 " ",
+            nt1,
+            nt2,
+            msb1,
+            lsb1,
+            msb2,
+            lsb2);
+        uint32_t distance = nested_prng_distance(nt1, nt2, 0);
+        if(distance == UINT32_MAX) {
+            printf("hard\n");
+        } else {
+            printf("%" PRIu32 "\n", distance);
+        }
+    }
+    fclose(fp);
+
+    // Every weak nonce once: msb is a PRNG state, lsb the state 16 steps later
+    uint16_t states[16];
+    uint16_t x = 1;
+    for(int i = 0; i < 16; i++) {
+        states[i] = x;
+        x = prng_next(x);
+    }
+
+    uint32_t weak = 0;
+    double start = bench_seconds();
+    for(uint32_t i = 0; i < 65535; i++) {
+        uint16_t msb = states[i % 16];
+        uint32_t nonce = (uint32_t)(msb << 8 | msb >> 8) << 16 | (uint16_t)(x << 8 | x >> 8);
+        weak += validate_prng_nonce(nonce);
+        states[i % 16] = x;
+        x = prng_next(x);
+    }
+    double seconds = bench_seconds() - start;
+    if(weak != 65535) {
+        fprintf(stderr, "validate_prng_nonce() rejected %" PRIu32 " weak nonces\n", 65535 - weak);
+        return 1;
+    }
+    bench_report("validate_prng_nonce()", 65535, "nonces", seconds);
+    return 0;
+}
@@ -0,0 +1,200 @@
+// Scans the RAW_Data of a .sub file for coherent signals like protoview's
+// scan_for_signal() does, and prints what decode_signal() made of each one.
+// With -b it writes a .sub file with a message of the named decoder instead,
+// built from the decoder's default fields and made a bit less ideal.
+
+#include "../protoview/app.h"
+#include "bench.h"
+
+#include <inttypes.h>
+
+// Min run of coherent samples decoded, SEARCH_MIN_RUN in signal.c
+#define BENCH_MIN_RUN 18
+// How many times the whole file is scanned for the throughput figure
+#define BENCH_ROUNDS 1000
+
+extern ProtoViewDecoder* Decoders[];
+bool decode_signal(RawSamplesBuffer* s, uint64_t len, ProtoViewMsgInfo* info);
+uint32_t search_coherent_signal(RawSamplesBuffer* s, uint32_t idx, uint32_t min_duration);
+void fieldset_free(ProtoViewFieldSet* fs);
+ProtoViewFieldSet* fieldset_new(void);
+int field_to_string(char* buf, size_t len, ProtoViewField* f);
+
+// Defined by app.c and view_raw_signal.c, which are not built on the host
+RawSamplesBuffer *RawSamples, *DetectedSamples;
+
+void adjust_raw_view_scale(ProtoViewApp* app, uint32_t short_pulse_dur) {
+    UNUSED(app);
+    UNUSED(short_pulse_dur);
+}
+
+static uint32_t bench_rand_state = 143;
+
+static uint32_t bench_rand(uint32_t range) {
+    bench_rand_state = bench_rand_state * 1103515245 + 12345;
+    return (bench_rand_state >> 16) % range;
+}
+
+// A sample with up to +-6% of jitter, in the .sub signed duration format
+static void write_sample(FILE* out, bool level, uint32_t dur, int* column) {
+    int32_t jitter = (int32_t)bench_rand(dur / 8 + 1) - (int32_t)dur / 16;
+    int32_t value = (int32_t)dur + jitter;
+    if(*column == 0) fprintf(out, "RAW_Data:");
+    fprintf(out, " %" PRId32, level ? value : -value);
+    if(++*column == 512) {
+        fprintf(out, "\n");
+        *column = 0;
+    }
+}
+
+static int build(const char* name) {
+    ProtoViewDecoder* decoder = NULL;
+    for(int j = 0; Decoders[j]; j++) {
+        if(strcmp(Decoders[j]->name, name) == 0) decoder = Decoders[j];
+    }
+    if(decoder == NULL || decoder->build_message == NULL) {
+        fprintf(stderr, "No decoder named \"%s\" that builds messages\n", name);
+        return 1;
+    }
+
+    ProtoViewFieldSet* fields = fieldset_new();
+    decoder->get_fields(fields);
+    RawSamplesBuffer* samples = raw_samples_alloc();
+    decoder->build_message(samples, fields);
+
+    printf("Filetype: Flipper SubGhz RAW File\n");
+    printf("Version: 1\n");
+    printf("Frequency: 433920000\n");
+    printf("Preset: FuriHalSubGhzPresetOok650Async\n");
+    printf("Protocol: RAW\n");
+
+    // Noise, then the message three times with noise in between
+    int column = 0;
+    for(int repeat = 0; repeat < 3; repeat++) {
+        for(int j = 0; j < 40; j++) {
+            write_sample(stdout, j % 2, 20 + bench_rand(3000), &column);
+        }
+        for(uint32_t j = 0; j < samples->idx; j++) {
+            write_sample(stdout, samples->samples[j].level, samples->samples[j].dur, &column);
+        }
+    }
+    if(column) printf("\n");
+
+    raw_samples_free(samples);
+    fieldset_free(fields);
+    return 0;
+}
+
+static RawSamplesBuffer* load_sub(const char* path) {
+    FILE* fp = fopen(path, "r");
+    if(!fp) {
+        perror(path);
+        return NULL;
+    }
+
+    uint32_t count = 0, capacity = 0;
+    int32_t* values = NULL;
+    char line[8192];
+    while(fgets(line, sizeof(line), fp)) {
+        if(strncmp(line, "RAW_Data:", 9) != 0) continue;
+        char* p = line + 9;
+        char* end;
+        for(long value = strtol(p, &end, 10); end != p; value = strtol(p, &end, 10)) {
+            if(count == capacity) {
+                capacity = capacity ? capacity * 2 : 1024;
+                values = realloc(values, sizeof(int32_t) * capacity);
+                furi_check(values);
+            }
+            values[count++] = value;
+            p = end;
+        }
+    }
+    fclose(fp);
+
+    // The smallest power of two holding the file, the oldest samples stay zero
+    uint32_t total = RAW_SAMPLES_NUM;
+    while(total < count) total *= 2;
+    RawSamplesBuffer* s = raw_samples_alloc_size(total);
+    for(uint32_t j = 0; j < count; j++) {
+        uint32_t dur = values[j] < 0 ? -values[j] : values[j];
+        raw_samples_add(s, values[j] > 0, dur > 0x7fff ? 0x7fff : dur);
+    }
+    free(values);
+    return s;
+}
+
+static void print_message(uint32_t start, uint32_t len, ProtoViewMsgInfo* info) {
+    printf("%" PRIu32 " %" PRIu32 " %s", start, len, info->decoder->name);
+    for(uint32_t j = 0; j < info->fieldset->numfields; j++) {
+        char buf[64];
+        field_to_string(buf, sizeof(buf), info->fieldset->fields[j]);
+        printf(" %s=%s", info->fieldset->fields[j]->name, buf);
+    }
+    // Only pulses_count bits are set, the rest of the last byte is garbage
+    printf(" bits=");
+    for(uint32_t j = 0; j < info->bits_bytes; j++) {
+        uint32_t valid = info->pulses_count - j * 8;
+        printf("%02X", valid < 8 ? info->bits[j] & (0xff << (8 - valid)) & 0xff : info->bits[j]);
+    }
+    printf("\n");
+}
+
+// The scan_for_signal() loop, decoding every run instead of keeping the best
+static uint32_t scan(RawSamplesBuffer* s, uint32_t min_duration, bool print) {
+    uint32_t decoded = 0;
+    uint32_t i = 0;
+    while(i < s->total - 1) {
+        uint32_t len = search_coherent_signal(s, i, min_duration);
+        if(len > BENCH_MIN_RUN) {
+            ProtoViewMsgInfo* info = malloc(sizeof(ProtoViewMsgInfo));
+            init_msg_info(info, NULL);
+            info->short_pulse_dur = s->short_pulse_dur;
+
+            uint32_t saved_idx = s->idx;
+            raw_samples_center(s, i);
+            if(decode_signal(s, len, info)) {
+                decoded++;
+                if(print) print_message(i, len, info);
+            } else if(print) {
+                printf("%" PRIu32 " %" PRIu32 " -\n", i, len);
+            }
+            s->idx = saved_idx;
+            free_msg_info(info);
+        }
+        i += len ? len : 1;
+    }
+    return decoded;
+}
+
+int main(int argc, char** argv) {
+    if(argc == 3 && strcmp(argv[1], "-b") == 0) return build(argv[2]);
+
+    uint32_t min_duration = 30;
+    if(argc == 4 && strcmp(argv[1], "-d") == 0) {
+        min_duration = strtoul(argv[2], NULL, 10);
+        argv += 2;
+        argc -= 2;
+    }
+    if(argc != 2) {
+        fprintf(stderr, "Usage: %s [-d min_duration] file.sub\n", argv[0]);
+        fprintf(stderr, "       %s -b decoder_name > file.sub\n", argv[0]);
+        return 1;
+    }
+
+    RawSamplesBuffer* s = load_sub(argv[1]);
+    if(!s) return 1;
+
+    scan(s, min_duration, true);
+
+    double start = bench_seconds();
+    for(int round = 0; round < BENCH_ROUNDS; round++) scan(s, min_duration, false);
+    double seconds = bench_seconds() - start;
+
+    const char* name = strrchr(argv[1], '/');
+    char label[40];
+    snprintf(label, sizeof(label), "scan %s", name ? name + 1 : argv[1]);
+    bench_report(label, (double)s->total * BENCH_ROUNDS, "samples", seconds);
+
+    raw_samples_free(s);
+    return 0;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+// Host stand-in for the parts of the Furi core the algorithm cores use
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <furi/core/string.h>
+
+#ifndef UNUSED
+#define UNUSED(X) (void)(X)
+#endif
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+#ifndef COUNT_OF
+#define COUNT_OF(x) (sizeof(x) / sizeof(x[0]))
+#endif
+
+#define FURI_BIT(x, n) (((x) >> (n)) & 1)
+
+#define FURI_SWAP(x, y)     \
+    do {                    \
+        typeof(x) SWAP = x; \
+        x = y;              \
+        y = SWAP;           \
+    } while(0)
+
+#define FURI_PACKED __attribute__((packed))
+
+#define furi_assert(x) furi_check(x)
+
+#define furi_check(x)                                                               \
+    do {                                                                            \
+        if(!(x)) furi_crash("furi_check failed: " #x " at " __FILE__ ":" FURI_LINE); \
+    } while(0)
+
+#define FURI_LINE_STR(x) #x
+#define FURI_LINE_XSTR(x) FURI_LINE_STR(x)
+#define FURI_LINE FURI_LINE_XSTR(__LINE__)
+
+#define EXT_PATH(path) "/ext/" path
+
+typedef enum {
+    FuriLogLevelError = 1,
+    FuriLogLevelWarn,
+    FuriLogLevelInfo,
+    FuriLogLevelDebug,
+    FuriLogLevelTrace,
+} FuriLogLevel;
+
+// Printed to stderr when FURI_HOST_LOG is set to the highest level to print (1 to 5).
+// The format is not checked: uint32_t is unsigned long on the device, not here
+void furi_log_print_format(FuriLogLevel level, const char* tag, const char* format, ...);
+
+#define FURI_LOG_E(tag, format, ...) \
+    furi_log_print_format(FuriLogLevelError, tag, format, ##__VA_ARGS__)
+#define FURI_LOG_W(tag, format, ...) \
+    furi_log_print_format(FuriLogLevelWarn, tag, format, ##__VA_ARGS__)
+#define FURI_LOG_I(tag, format, ...) \
+    furi_log_print_format(FuriLogLevelInfo, tag, format, ##__VA_ARGS__)
+#define FURI_LOG_D(tag, format, ...) \
+    furi_log_print_format(FuriLogLevelDebug, tag, format, ##__VA_ARGS__)
+#define FURI_LOG_T(tag, format, ...) \
+    furi_log_print_format(FuriLogLevelTrace, tag, format, ##__VA_ARGS__)
+
+_Noreturn void furi_crash(const char* message);
+
+// Milliseconds since the first call
+uint32_t furi_get_tick(void);
+
+typedef struct FuriMutex FuriMutex;
+typedef struct FuriMessageQueue FuriMessageQueue;
+typedef struct FuriThread FuriThread;
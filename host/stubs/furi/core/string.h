@@ -0,0 +1,50 @@
+#pragma once
+
+// Host FuriString: a plain heap string, with the same generic helpers the firmware has
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct FuriString FuriString;
+
+#define FURI_STRING_FAILURE ((size_t)-1)
+
+FuriString* furi_string_alloc(void);
+FuriString* furi_string_alloc_set_str(const char* cstr);
+void furi_string_free(FuriString* string);
+void furi_string_reset(FuriString* string);
+const char* furi_string_get_cstr(const FuriString* string);
+size_t furi_string_size(const FuriString* string);
+char furi_string_get_char(const FuriString* string, size_t index);
+void furi_string_set_char(FuriString* string, size_t index, const char c);
+void furi_string_push_back(FuriString* string, char c);
+
+void furi_string_set_str(FuriString* string, const char* source);
+void furi_string_cat_str(FuriString* string, const char* cstring_2);
+int furi_string_cmp_str(const FuriString* string_1, const char* cstring_2);
+bool furi_string_start_with_str(const FuriString* string, const char* start);
+bool furi_string_end_with_str(const FuriString* string, const char* end);
+
+// FuriString or C string arguments, like the firmware's generic macros
+static inline const char* furi_string_host_cstr(const FuriString* string) {
+    return furi_string_get_cstr(string);
+}
+
+static inline const char* furi_string_host_passthrough(const char* cstr) {
+    return cstr;
+}
+
+#define FURI_STRING_CSTR(x)                       \
+    _Generic(                                     \
+        (x),                                      \
+        FuriString*: furi_string_host_cstr,       \
+        const FuriString*: furi_string_host_cstr, \
+        char*: furi_string_host_passthrough,      \
+        const char*: furi_string_host_passthrough)(x)
+
+#define furi_string_set(a, b) furi_string_set_str(a, FURI_STRING_CSTR(b))
+#define furi_string_cat(a, b) furi_string_cat_str(a, FURI_STRING_CSTR(b))
+#define furi_string_cmp(a, b) furi_string_cmp_str(a, FURI_STRING_CSTR(b))
+#define furi_string_start_with(a, b) furi_string_start_with_str(a, FURI_STRING_CSTR(b))
+#define furi_string_end_with(a, b) furi_string_end_with_str(a, FURI_STRING_CSTR(b))
+#define furi_string_alloc_set(x) furi_string_alloc_set_str(FURI_STRING_CSTR(x))
@@ -0,0 +1,23 @@
+#pragma once
+
+// Host stand-in for the HAL types the algorithm cores' headers mention
+
+#include <furi.h>
+
+typedef enum {
+    FuriHalSubGhzPresetIDLE,
+    FuriHalSubGhzPresetOok270Async,
+    FuriHalSubGhzPresetOok650Async,
+    FuriHalSubGhzPreset2FSKDev238Async,
+    FuriHalSubGhzPreset2FSKDev476Async,
+    FuriHalSubGhzPresetMSK99_97KbAsync,
+    FuriHalSubGhzPresetGFSK9_99KbAsync,
+    FuriHalSubGhzPresetCustom,
+} FuriHalSubGhzPreset;
+
+typedef struct {
+    uint32_t duration;
+    bool level;
+} LevelDuration;
+
+typedef LevelDuration (*FuriHalSubGhzAsyncTxCallback)(void* context);
@@ -0,0 +1,126 @@
+// Host implementation of the Furi core stubs (furi.h, furi/core/string.h)
+
+#include <furi.h>
+
+#include <stdarg.h>
+#include <time.h>
+
+struct FuriString {
+    char* data;
+    size_t size;
+    size_t capacity;
+};
+
+static void furi_string_reserve(FuriString* string, size_t size) {
+    if(size + 1 <= string->capacity) return;
+    while(string->capacity < size + 1) {
+        string->capacity = string->capacity ? string->capacity * 2 : 16;
+    }
+    string->data = realloc(string->data, string->capacity);
+    furi_check(string->data);
+}
+
+FuriString* furi_string_alloc(void) {
+    FuriString* string = calloc(1, sizeof(FuriString));
+    furi_check(string);
+    furi_string_reserve(string, 0);
+    string->data[0] = '\0';
+    return string;
+}
+
+FuriString* furi_string_alloc_set_str(const char* cstr) {
+    FuriString* string = furi_string_alloc();
+    furi_string_set_str(string, cstr);
+    return string;
+}
+
+void furi_string_free(FuriString* string) {
+    free(string->data);
+    free(string);
+}
+
+void furi_string_reset(FuriString* string) {
+    string->size = 0;
+    string->data[0] = '\0';
+}
+
+const char* furi_string_get_cstr(const FuriString* string) {
+    return string->data;
+}
+
+size_t furi_string_size(const FuriString* string) {
+    return string->size;
+}
+
+char furi_string_get_char(const FuriString* string, size_t index) {
+    furi_check(index < string->size);
+    return string->data[index];
+}
+
+void furi_string_set_char(FuriString* string, size_t index, const char c) {
+    furi_check(index < string->size);
+    string->data[index] = c;
+}
+
+void furi_string_push_back(FuriString* string, char c) {
+    furi_string_reserve(string, string->size + 1);
+    string->data[string->size++] = c;
+    string->data[string->size] = '\0';
+}
+
+void furi_string_set_str(FuriString* string, const char* source) {
+    furi_string_reset(string);
+    furi_string_cat_str(string, source);
+}
+
+void furi_string_cat_str(FuriString* string, const char* cstring_2) {
+    // The source may be the string itself, copy it before the buffer moves
+    char* source = strdup(cstring_2);
+    size_t len = strlen(source);
+    furi_string_reserve(string, string->size + len);
+    memcpy(string->data + string->size, source, len + 1);
+    string->size += len;
+    free(source);
+}
+
+int furi_string_cmp_str(const FuriString* string_1, const char* cstring_2) {
+    return strcmp(string_1->data, cstring_2);
+}
+
+bool furi_string_start_with_str(const FuriString* string, const char* start) {
+    return strncmp(string->data, start, strlen(start)) == 0;
+}
+
+bool furi_string_end_with_str(const FuriString* string, const char* end) {
+    size_t len = strlen(end);
+    return len <= string->size && strcmp(string->data + string->size - len, end) == 0;
+}
+
+void furi_log_print_format(FuriLogLevel level, const char* tag, const char* format, ...) {
+    static int max_level = -1;
+    if(max_level < 0) {
+        const char* env = getenv("FURI_HOST_LOG");
+        max_level = env ? atoi(env) : 0;
+    }
+    if((int)level > max_level) return;
+
+    va_list args;
+    va_start(args, format);
+    fprintf(stderr, "[%s] ", tag);
+    vfprintf(stderr, format, args);
+    fputc('\n', stderr);
+    va_end(args);
+}
+
+void furi_crash(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    abort();
+}
+
+uint32_t furi_get_tick(void) {
+    static struct timespec start;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if(start.tv_sec == 0 && start.tv_nsec == 0) start = now;
+    return (now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <gui/canvas.h>
+#include <gui/view_port.h>
+
+typedef struct Gui Gui;
@@ -0,0 +1,5 @@
+#pragma once
+
+#include <gui/canvas.h>
+
+typedef struct ViewPort ViewPort;
@@ -0,0 +1,120 @@
+// Host implementation of the GUI and notification stubs: views only keep their model
+
+#include <gui/view.h>
+#include <notification/notification_messages.h>
+
+struct View {
+    void* context;
+    void* model;
+    ViewDrawCallback draw_callback;
+    ViewInputCallback input_callback;
+};
+
+struct NotificationMessage {
+    int unused;
+};
+
+const NotificationMessage message_red_0;
+const NotificationMessage message_red_255;
+const NotificationMessage message_green_0;
+const NotificationMessage message_green_255;
+const NotificationMessage message_blue_0;
+const NotificationMessage message_blue_255;
+const NotificationMessage message_vibro_on;
+const NotificationMessage message_vibro_off;
+const NotificationMessage message_delay_50;
+
+void notification_message(NotificationApp* app, const NotificationSequence* sequence) {
+    UNUSED(app);
+    UNUSED(sequence);
+}
+
+View* view_alloc(void) {
+    View* view = calloc(1, sizeof(View));
+    furi_check(view);
+    return view;
+}
+
+void view_free(View* view) {
+    free(view->model);
+    free(view);
+}
+
+void view_set_context(View* view, void* context) {
+    view->context = context;
+}
+
+void view_set_draw_callback(View* view, ViewDrawCallback callback) {
+    view->draw_callback = callback;
+}
+
+void view_set_input_callback(View* view, ViewInputCallback callback) {
+    view->input_callback = callback;
+}
+
+void view_allocate_model(View* view, ViewModelType type, size_t size) {
+    UNUSED(type);
+    free(view->model);
+    view->model = calloc(1, size);
+    furi_check(view->model);
+}
+
+void* view_get_model(View* view) {
+    return view->model;
+}
+
+void view_commit_model(View* view, bool update) {
+    UNUSED(view);
+    UNUSED(update);
+}
+
+void canvas_clear(Canvas* canvas) {
+    UNUSED(canvas);
+}
+
+void canvas_set_color(Canvas* canvas, Color color) {
+    UNUSED(canvas);
+    UNUSED(color);
+}
+
+void canvas_set_font(Canvas* canvas, Font font) {
+    UNUSED(canvas);
+    UNUSED(font);
+}
+
+void canvas_draw_str(Canvas* canvas, uint8_t x, uint8_t y, const char* str) {
+    UNUSED(canvas);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(str);
+}
+
+void canvas_draw_str_aligned(
+    Canvas* canvas,
+    uint8_t x,
+    uint8_t y,
+    Align horizontal,
+    Align vertical,
+    const char* str) {
+    UNUSED(canvas);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(horizontal);
+    UNUSED(vertical);
+    UNUSED(str);
+}
+
+void canvas_draw_xbm(
+    Canvas* canvas,
+    uint8_t x,
+    uint8_t y,
+    uint8_t width,
+    uint8_t height,
+    const uint8_t* bitmap) {
+    UNUSED(canvas);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(width);
+    UNUSED(height);
+    UNUSED(bitmap);
+}
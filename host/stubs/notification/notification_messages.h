@@ -0,0 +1,19 @@
+#pragma once
+
+// Host notifications: messages are accepted and dropped
+
+typedef struct NotificationApp NotificationApp;
+typedef struct NotificationMessage NotificationMessage;
+typedef const NotificationMessage* NotificationSequence[];
+
+void notification_message(NotificationApp* app, const NotificationSequence* sequence);
+
+extern const NotificationMessage message_red_0;
+extern const NotificationMessage message_red_255;
+extern const NotificationMessage message_green_0;
+extern const NotificationMessage message_green_255;
+extern const NotificationMessage message_blue_0;
+extern const NotificationMessage message_blue_255;
+extern const NotificationMessage message_vibro_on;
+extern const NotificationMessage message_vibro_off;
+extern const NotificationMessage message_delay_50;
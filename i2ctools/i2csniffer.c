@@ -1,86 +1,210 @@
 #include "i2csniffer.h"
 
+typedef enum {
+    WorkerEvtHalf = (1 << 0),
+    WorkerEvtFull = (1 << 1),
+    WorkerEvtStop = (1 << 2),
+} WorkerEvt;
+
+#define WORKER_EVT_ALL (WorkerEvtHalf | WorkerEvtFull | WorkerEvtStop)
+#define LINES_MASK (SCL_MASK | SDA_MASK)
+
 void clear_sniffer_buffers(i2cSniffer* i2c_sniffer) {
     furi_assert(i2c_sniffer);
-    for(uint8_t i = 0; i < MAX_RECORDS; i++) {
-        for(uint8_t j = 0; j < MAX_MESSAGE_SIZE; j++) {
-            i2c_sniffer->frames[i].ack[j] = false;
-            i2c_sniffer->frames[i].data[j] = 0;
-        }
-        i2c_sniffer->frames[i].bit_index = 0;
-        i2c_sniffer->frames[i].data_index = 0;
-    }
-    i2c_sniffer->frame_index = 0;
+    memset(i2c_sniffer->frames, 0, sizeof(i2c_sniffer->frames));
+    i2c_sniffer->frame_head = 0;
+    i2c_sniffer->frame_count = 0;
+    i2c_sniffer->overruns = 0;
     i2c_sniffer->state = I2C_BUS_FREE;
     i2c_sniffer->first = true;
 }
 
-void start_interrupts(i2cSniffer* i2c_sniffer) {
+i2cFrame* i2c_sniffer_get_frame(i2cSniffer* i2c_sniffer, uint16_t index) {
     furi_assert(i2c_sniffer);
-    furi_hal_gpio_init(pinSCL, GpioModeInterruptRise, GpioPullNo, GpioSpeedHigh);
-    furi_hal_gpio_add_int_callback(pinSCL, SCLcallback, i2c_sniffer);
+    return &i2c_sniffer->frames[(i2c_sniffer->frame_head + index) % MAX_RECORDS];
+}
 
-    // Add Rise and Fall Interrupt on SDA pin
-    furi_hal_gpio_init(pinSDA, GpioModeInterruptRiseFall, GpioPullNo, GpioSpeedHigh);
-    furi_hal_gpio_add_int_callback(pinSDA, SDAcallback, i2c_sniffer);
+bool i2c_frame_get_ack(i2cFrame* frame, uint8_t index) {
+    furi_assert(frame);
+    return frame->ack[index / 8] & (1 << (index % 8));
 }
 
-void stop_interrupts() {
-    furi_hal_gpio_remove_int_callback(pinSCL);
-    furi_hal_gpio_remove_int_callback(pinSDA);
-    // Reset GPIO pins to default state
-    furi_hal_gpio_init(pinSCL, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
-    furi_hal_gpio_init(pinSDA, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
+// Start condition: open a new frame, dropping the oldest one if the ring is full
+static void start_frame(i2cSniffer* i2c_sniffer) {
+    i2c_sniffer->state = I2C_BUS_STARTED;
+    if(i2c_sniffer->frame_count < MAX_RECORDS) {
+        i2c_sniffer->frame_count++;
+    } else {
+        i2c_sniffer->frame_head = (i2c_sniffer->frame_head + 1) % MAX_RECORDS;
+    }
+    i2cFrame* frame = i2c_sniffer_get_frame(i2c_sniffer, i2c_sniffer->frame_count - 1);
+    memset(frame, 0, sizeof(i2cFrame));
+    i2c_sniffer->first = false;
 }
 
-// Called on Fallin/Rising SDA
-// Used to monitor i2c bus state
-void SDAcallback(void* _i2c_sniffer) {
-    i2cSniffer* i2c_sniffer = _i2c_sniffer;
-    // SCL is low maybe cclock strecching
-    if(furi_hal_gpio_read(pinSCL) == false) {
+// Rising SCL: 8 data bits then the ack bit
+static void push_bit(i2cSniffer* i2c_sniffer, bool bit) {
+    i2cFrame* frame = i2c_sniffer_get_frame(i2c_sniffer, i2c_sniffer->frame_count - 1);
+    uint8_t data_idx = frame->data_index;
+    if(data_idx >= MAX_MESSAGE_SIZE) {
         return;
     }
-    // Check for stop condition: SDA rising while SCL is High
-    if(i2c_sniffer->state == I2C_BUS_STARTED) {
-        if(furi_hal_gpio_read(pinSDA) == true) {
-            i2c_sniffer->state = I2C_BUS_FREE;
+    if(frame->bit_index < 8) {
+        frame->data[data_idx] <<= 1;
+        frame->data[data_idx] |= bit;
+        frame->bit_index++;
+    } else {
+        if(!bit) {
+            frame->ack[data_idx / 8] |= 1 << (data_idx % 8);
         }
+        frame->data_index++;
+        frame->bit_index = 0;
     }
-    // Check for start condition: SDA falling while SCL is high
-    else if(furi_hal_gpio_read(pinSDA) == false) {
-        i2c_sniffer->state = I2C_BUS_STARTED;
-        if(i2c_sniffer->first) {
-            i2c_sniffer->first = false;
-            return;
+}
+
+static void decode_samples(i2cSniffer* i2c_sniffer, const uint8_t* samples, size_t count) {
+    uint8_t prev = i2c_sniffer->last_sample;
+    size_t i = 0;
+    while(i < count) {
+        // Skip 4 samples at once while both lines are steady, most of the time on an idle bus
+        if((i & 3) == 0 && i + 4 <= count &&
+           ((*(const uint32_t*)&samples[i] ^ (prev * 0x01010101UL)) & 0x03030303UL) == 0) {
+            i += 4;
+            continue;
         }
-        i2c_sniffer->frame_index++;
-        if(i2c_sniffer->frame_index >= MAX_RECORDS) {
-            clear_sniffer_buffers(i2c_sniffer);
+        uint8_t cur = samples[i++] & LINES_MASK;
+        if(cur == prev) {
+            continue;
         }
+        if((cur & SCL_MASK) && (prev & SCL_MASK)) {
+            // SDA changed while SCL is high
+            if(cur & SDA_MASK) {
+                // Stop condition
+                i2c_sniffer->state = I2C_BUS_FREE;
+            } else {
+                // Start or repeated start condition
+                start_frame(i2c_sniffer);
+            }
+        } else if((cur & SCL_MASK) && i2c_sniffer->state == I2C_BUS_STARTED) {
+            push_bit(i2c_sniffer, cur & SDA_MASK);
+        }
+        prev = cur;
     }
-    return;
+    i2c_sniffer->last_sample = prev;
 }
 
-// Called on Rising SCL
-// Used to read bus datas
-void SCLcallback(void* _i2c_sniffer) {
-    i2cSniffer* i2c_sniffer = _i2c_sniffer;
-    if(i2c_sniffer->state == I2C_BUS_FREE) {
-        return;
+static void sniffer_dma_isr(void* ctx) {
+    i2cSniffer* i2c_sniffer = ctx;
+    uint32_t events = 0;
+    if(LL_DMA_IsActiveFlag_HT2(DMA1)) {
+        LL_DMA_ClearFlag_HT2(DMA1);
+        events |= WorkerEvtHalf;
     }
-    uint8_t frame = i2c_sniffer->frame_index;
-    uint8_t bit = i2c_sniffer->frames[frame].bit_index;
-    uint8_t data_idx = i2c_sniffer->frames[frame].data_index;
-    if(bit < 8) {
-        i2c_sniffer->frames[frame].data[data_idx] <<= 1;
-        i2c_sniffer->frames[frame].data[data_idx] |= (int)furi_hal_gpio_read(pinSDA);
-        i2c_sniffer->frames[frame].bit_index++;
-    } else {
-        i2c_sniffer->frames[frame].ack[data_idx] = !furi_hal_gpio_read(pinSDA);
-        i2c_sniffer->frames[frame].data_index++;
-        i2c_sniffer->frames[frame].bit_index = 0;
+    if(LL_DMA_IsActiveFlag_TC2(DMA1)) {
+        LL_DMA_ClearFlag_TC2(DMA1);
+        events |= WorkerEvtFull;
+    }
+    if(events) {
+        furi_thread_flags_set(furi_thread_get_id(i2c_sniffer->worker), events);
+    }
+}
+
+static int32_t sniffer_worker(void* ctx) {
+    i2cSniffer* i2c_sniffer = ctx;
+    const size_t half = SAMPLE_BUFFER_SIZE / 2;
+    while(true) {
+        uint32_t events =
+            furi_thread_flags_wait(WORKER_EVT_ALL, FuriFlagWaitAny, FuriWaitForever);
+        if(events & FuriFlagError) continue;
+        if(events & WorkerEvtStop) break;
+        if((events & WorkerEvtHalf) && (events & WorkerEvtFull)) {
+            // Both halves were filled meanwhile, one of them is already being overwritten
+            i2c_sniffer->overruns++;
+            i2c_sniffer->state = I2C_BUS_FREE;
+        }
+        if(events & WorkerEvtHalf) {
+            decode_samples(i2c_sniffer, i2c_sniffer->samples, half);
+        }
+        if(events & WorkerEvtFull) {
+            decode_samples(i2c_sniffer, i2c_sniffer->samples + half, half);
+        }
     }
+    return 0;
+}
+
+void start_sniffing(i2cSniffer* i2c_sniffer) {
+    furi_assert(i2c_sniffer);
+    furi_hal_gpio_init(pinSCL, GpioModeInput, GpioPullNo, GpioSpeedVeryHigh);
+    furi_hal_gpio_init(pinSDA, GpioModeInput, GpioPullNo, GpioSpeedVeryHigh);
+
+    i2c_sniffer->samples = malloc(SAMPLE_BUFFER_SIZE);
+    // Idle bus, both lines high
+    i2c_sniffer->last_sample = LINES_MASK;
+    i2c_sniffer->state = I2C_BUS_FREE;
+    i2c_sniffer->worker =
+        furi_thread_alloc_ex("I2CSnifferWorker", 1024, sniffer_worker, i2c_sniffer);
+    furi_thread_set_priority(i2c_sniffer->worker, FuriThreadPriorityHighest);
+    furi_thread_start(i2c_sniffer->worker);
+
+    furi_hal_bus_enable(FuriHalBusTIM1);
+    LL_TIM_InitTypeDef tim_init = {
+        .Prescaler = 0,
+        .CounterMode = LL_TIM_COUNTERMODE_UP,
+        .Autoreload = (64000000 / SAMPLE_RATE) - 1, /* CPU frequency is ~64Mhz. */
+    };
+    LL_TIM_Init(SAMPLE_TIM, &tim_init);
+    LL_TIM_SetClockSource(SAMPLE_TIM, LL_TIM_CLOCKSOURCE_INTERNAL);
+    LL_TIM_DisableCounter(SAMPLE_TIM);
+    LL_TIM_SetCounter(SAMPLE_TIM, 0);
+
+    LL_DMA_InitTypeDef dma_init = {
+        .PeriphOrM2MSrcAddress = (uint32_t) & (GPIOC->IDR),
+        .MemoryOrM2MDstAddress = (uint32_t)i2c_sniffer->samples,
+        .Direction = LL_DMA_DIRECTION_PERIPH_TO_MEMORY,
+        .Mode = LL_DMA_MODE_CIRCULAR,
+        .PeriphOrM2MSrcIncMode = LL_DMA_PERIPH_NOINCREMENT,
+        .MemoryOrM2MDstIncMode = LL_DMA_MEMORY_INCREMENT,
+        .PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_BYTE,
+        .MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_BYTE,
+        .NbData = SAMPLE_BUFFER_SIZE,
+        .PeriphRequest = LL_DMAMUX_REQ_TIM1_UP,
+        .Priority = LL_DMA_PRIORITY_VERYHIGH,
+    };
+    LL_DMA_Init(SAMPLE_DMA, &dma_init);
+    LL_DMA_ClearFlag_HT2(DMA1);
+    LL_DMA_ClearFlag_TC2(DMA1);
+    furi_hal_interrupt_set_isr(FuriHalInterruptIdDma1Ch2, sniffer_dma_isr, i2c_sniffer);
+    LL_DMA_EnableIT_HT(SAMPLE_DMA);
+    LL_DMA_EnableIT_TC(SAMPLE_DMA);
+    LL_DMA_EnableChannel(SAMPLE_DMA);
+    LL_TIM_EnableDMAReq_UPDATE(SAMPLE_TIM);
+    LL_TIM_EnableCounter(SAMPLE_TIM);
+}
+
+void stop_sniffing(i2cSniffer* i2c_sniffer) {
+    furi_assert(i2c_sniffer);
+    if(!i2c_sniffer->worker) {
+        return;
+    }
+    LL_TIM_DisableCounter(SAMPLE_TIM);
+    LL_TIM_DisableDMAReq_UPDATE(SAMPLE_TIM);
+    LL_DMA_DisableChannel(SAMPLE_DMA);
+    LL_DMA_DisableIT_HT(SAMPLE_DMA);
+    LL_DMA_DisableIT_TC(SAMPLE_DMA);
+    furi_hal_interrupt_set_isr(FuriHalInterruptIdDma1Ch2, NULL, NULL);
+    LL_DMA_DeInit(SAMPLE_DMA);
+    furi_hal_bus_disable(FuriHalBusTIM1);
+
+    furi_thread_flags_set(furi_thread_get_id(i2c_sniffer->worker), WorkerEvtStop);
+    furi_thread_join(i2c_sniffer->worker);
+    furi_thread_free(i2c_sniffer->worker);
+    i2c_sniffer->worker = NULL;
+    free(i2c_sniffer->samples);
+    i2c_sniffer->samples = NULL;
+
+    // Reset GPIO pins to default state
+    furi_hal_gpio_init(pinSCL, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
+    furi_hal_gpio_init(pinSDA, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
 }
 
 i2cSniffer* i2c_sniffer_alloc() {
@@ -88,6 +212,8 @@ i2cSniffer* i2c_sniffer_alloc() {
     i2c_sniffer->started = false;
     i2c_sniffer->row_index = 0;
     i2c_sniffer->menu_index = 0;
+    i2c_sniffer->samples = NULL;
+    i2c_sniffer->worker = NULL;
     clear_sniffer_buffers(i2c_sniffer);
     return i2c_sniffer;
 }
@@ -95,7 +221,7 @@ i2cSniffer* i2c_sniffer_alloc() {
 void i2c_sniffer_free(i2cSniffer* i2c_sniffer) {
     furi_assert(i2c_sniffer);
     if(i2c_sniffer->started) {
-        stop_interrupts();
+        stop_sniffing(i2c_sniffer);
     }
     free(i2c_sniffer);
 }
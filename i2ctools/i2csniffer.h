@@ -2,10 +2,23 @@
 
 #include <furi.h>
 #include <furi_hal.h>
+#include <stm32wbxx_ll_tim.h>
+#include <stm32wbxx_ll_dma.h>
 
 // I2C Pins
 #define pinSCL &gpio_ext_pc0
 #define pinSDA &gpio_ext_pc1
+// Their bits in GPIOC->IDR
+#define SCL_MASK (1 << 0)
+#define SDA_MASK (1 << 1)
+
+// Sampler: every TIM1 update event copies GPIOC->IDR to a circular buffer by DMA
+#define SAMPLE_TIM TIM1
+#define SAMPLE_DMA DMA1, LL_DMA_CHANNEL_2
+// 2MHz catches every SCL high phase of a 400kHz bus (0.6us minimum)
+#define SAMPLE_RATE 2000000
+// The worker decodes one half of the buffer while the DMA fills the other one
+#define SAMPLE_BUFFER_SIZE 4096
 
 // Bus States
 typedef enum { I2C_BUS_FREE, I2C_BUS_STARTED } i2cBusStates;
@@ -15,13 +28,13 @@ typedef enum { I2C_BUS_FREE, I2C_BUS_STARTED } i2cBusStates;
 // They're not real limit to maximum frames send
 #define MAX_MESSAGE_SIZE 128
 
-// Nb of records
-#define MAX_RECORDS 128
+// Nb of records, the oldest frames are overwritten once full
+#define MAX_RECORDS 256
 
 /// @brief Struct used to store our reads
 typedef struct {
     uint8_t data[MAX_MESSAGE_SIZE];
-    bool ack[MAX_MESSAGE_SIZE];
+    uint8_t ack[MAX_MESSAGE_SIZE / 8]; // One bit by data byte
     uint8_t bit_index;
     uint8_t data_index;
 } i2cFrame;
@@ -31,16 +44,24 @@ typedef struct {
     bool first;
     i2cBusStates state;
     i2cFrame frames[MAX_RECORDS];
-    uint8_t frame_index;
-    uint8_t menu_index;
+    uint16_t frame_head; // Oldest frame of the ring
+    uint16_t frame_count; // Frames in the ring, the last one is being recorded
+    uint16_t menu_index;
     uint8_t row_index;
+    uint32_t overruns; // Buffer halves the worker was too late for
+    // Capture
+    uint8_t* samples;
+    uint8_t last_sample;
+    FuriThread* worker;
 } i2cSniffer;
 
 void clear_sniffer_buffers(i2cSniffer* i2c_sniffer);
-void start_interrupts(i2cSniffer* i2c_sniffer);
-void stop_interrupts();
-void SDAcallback(void* _i2c_sniffer);
-void SCLcallback(void* _i2c_sniffer);
+void start_sniffing(i2cSniffer* i2c_sniffer);
+void stop_sniffing(i2cSniffer* i2c_sniffer);
+
+/// @brief Frame by its position in the ring, 0 is the oldest one
+i2cFrame* i2c_sniffer_get_frame(i2cSniffer* i2c_sniffer, uint16_t index);
+bool i2c_frame_get_ack(i2cFrame* frame, uint8_t index);
 
 i2cSniffer* i2c_sniffer_alloc();
-void i2c_sniffer_free(i2cSniffer* i2c_sniffer);
\ No newline at end of file
+void i2c_sniffer_free(i2cSniffer* i2c_sniffer);
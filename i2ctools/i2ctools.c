@@ -81,7 +81,7 @@ int32_t i2ctools_app(void* p) {
                     break;
                 } else {
                     if(i2ctools->main_view->current_view == SNIFF_VIEW) {
-                        stop_interrupts();
+                        stop_sniffing(i2ctools->sniffer);
                         i2ctools->sniffer->started = false;
                         i2ctools->sniffer->state = I2C_BUS_FREE;
                     }
@@ -142,7 +142,8 @@ int32_t i2ctools_app(void* p) {
                     }
                 } else if(i2ctools->main_view->current_view == SNIFF_VIEW) {
                     if((i2ctools->sniffer->row_index + 3) <
-                       (int)i2ctools->sniffer->frames[i2ctools->sniffer->menu_index].data_index) {
+                       (int)i2c_sniffer_get_frame(i2ctools->sniffer, i2ctools->sniffer->menu_index)
+                           ->data_index) {
                         i2ctools->sniffer->row_index++;
                     }
                 } else if(i2ctools->main_view->current_view == SEND_VIEW) {
@@ -166,7 +167,8 @@ int32_t i2ctools_app(void* p) {
                     }
                 } else if(i2ctools->main_view->current_view == SNIFF_VIEW) {
                     if((i2ctools->sniffer->row_index + 8) <
-                       (int)i2ctools->sniffer->frames[i2ctools->sniffer->menu_index].data_index) {
+                       (int)i2c_sniffer_get_frame(i2ctools->sniffer, i2ctools->sniffer->menu_index)
+                           ->data_index) {
                         i2ctools->sniffer->row_index += 5;
                     }
                 }
@@ -180,11 +182,11 @@ int32_t i2ctools_app(void* p) {
                     i2ctools->sender->must_send = true;
                 } else if(i2ctools->main_view->current_view == SNIFF_VIEW) {
                     if(i2ctools->sniffer->started) {
-                        stop_interrupts();
+                        stop_sniffing(i2ctools->sniffer);
                         i2ctools->sniffer->started = false;
                         i2ctools->sniffer->state = I2C_BUS_FREE;
                     } else {
-                        start_interrupts(i2ctools->sniffer);
+                        start_sniffing(i2ctools->sniffer);
                         i2ctools->sniffer->started = true;
                         i2ctools->sniffer->state = I2C_BUS_FREE;
                     }
@@ -196,7 +198,7 @@ int32_t i2ctools_app(void* p) {
                         i2ctools->sender->sended = false;
                     }
                 } else if(i2ctools->main_view->current_view == SNIFF_VIEW) {
-                    if(i2ctools->sniffer->menu_index < i2ctools->sniffer->frame_index) {
+                    if(i2ctools->sniffer->menu_index + 1 < i2ctools->sniffer->frame_count) {
                         i2ctools->sniffer->menu_index++;
                         i2ctools->sniffer->row_index = 0;
                     }
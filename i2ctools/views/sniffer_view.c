@@ -20,6 +20,7 @@ void draw_sniffer_view(Canvas* canvas, i2cSniffer* i2c_sniffer) {
         canvas_draw_str_aligned(canvas, 30, 3, AlignLeft, AlignTop, "Nothing Recorded");
         return;
     }
+    i2cFrame* frame = i2c_sniffer_get_frame(i2c_sniffer, i2c_sniffer->menu_index);
     char text_buffer[10];
     // nbFrame text
     canvas_draw_str_aligned(canvas, 3, 3, AlignLeft, AlignTop, "Frame: ");
@@ -28,24 +29,24 @@ void draw_sniffer_view(Canvas* canvas, i2cSniffer* i2c_sniffer) {
         sizeof(text_buffer),
         "%d/%d",
         (int)i2c_sniffer->menu_index + 1,
-        (int)i2c_sniffer->frame_index + 1);
+        (int)i2c_sniffer->frame_count);
     canvas_draw_str_aligned(canvas, 38, 3, AlignLeft, AlignTop, text_buffer);
     // Address text
     snprintf(
         text_buffer,
         sizeof(text_buffer),
         "0x%02x",
-        (int)(i2c_sniffer->frames[i2c_sniffer->menu_index].data[0] >> 1));
+        (int)(frame->data[0] >> 1));
     canvas_draw_str_aligned(canvas, 3, 13, AlignLeft, AlignTop, "Addr: ");
     canvas_draw_str_aligned(canvas, 30, 13, AlignLeft, AlignTop, text_buffer);
     // R/W
-    if((int)(i2c_sniffer->frames[i2c_sniffer->menu_index].data[0]) % 2 == 0) {
+    if((int)(frame->data[0]) % 2 == 0) {
         canvas_draw_str_aligned(canvas, 58, 13, AlignLeft, AlignTop, "Write");
     } else {
         canvas_draw_str_aligned(canvas, 58, 13, AlignLeft, AlignTop, "Read");
     }
     // ACK
-    if(i2c_sniffer->frames[i2c_sniffer->menu_index].ack[0]) {
+    if(i2c_frame_get_ack(frame, 0)) {
         canvas_draw_str_aligned(canvas, 90, 13, AlignLeft, AlignTop, "ACK");
     } else {
         canvas_draw_str_aligned(canvas, 90, 13, AlignLeft, AlignTop, "NACK");
@@ -57,7 +58,7 @@ void draw_sniffer_view(Canvas* canvas, i2cSniffer* i2c_sniffer) {
     uint8_t y_pos = 0;
     uint8_t row = 1;
     uint8_t column = 1;
-    uint8_t frame_size = i2c_sniffer->frames[i2c_sniffer->menu_index].data_index;
+    uint8_t frame_size = frame->data_index;
     uint8_t offset = i2c_sniffer->row_index;
     if(i2c_sniffer->row_index > 0) {
         offset += 1;
@@ -68,14 +69,14 @@ void draw_sniffer_view(Canvas* canvas, i2cSniffer* i2c_sniffer) {
             text_buffer,
             sizeof(text_buffer),
             "0x%02x",
-            (int)i2c_sniffer->frames[i2c_sniffer->menu_index].data[i]);
+            (int)frame->data[i]);
         x_pos = x_min + (column - 1) * 35;
         if(row == 1) {
             x_pos += 30;
         }
         y_pos = y_min + (row - 1) * 10;
         canvas_draw_str_aligned(canvas, x_pos, y_pos, AlignLeft, AlignTop, text_buffer);
-        if(i2c_sniffer->frames[i2c_sniffer->menu_index].ack[i]) {
+        if(i2c_frame_get_ack(frame, i)) {
             canvas_draw_str_aligned(canvas, x_pos + 24, y_pos, AlignLeft, AlignTop, "A");
         } else {
             canvas_draw_str_aligned(canvas, x_pos + 24, y_pos, AlignLeft, AlignTop, "N");
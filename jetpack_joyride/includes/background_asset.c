@@ -6,20 +6,20 @@ static AssetProperties assetProperties[BG_ASSETS_MAX] = {
     {.width = 27, .spawn_chance = 1, .x_offset = 24, .y_offset = 36, .sprite = &I_door},
     {.width = 12, .spawn_chance = 6, .x_offset = 33, .y_offset = 14, .sprite = &I_air_vent}};
 
-void background_assets_tick(BackgroundAsset* const assets) {
+void background_assets_tick(BackgroundAsset* const assets, EntityPool* const pool) {
     // Move assets towards the player
-    for(int i = 0; i < BG_ASSETS_MAX; i++) {
-        if(assets[i].visible) {
-            assets[i].point.x -= 1; // move left by 2 units
-            if(assets[i].point.x <=
-               -assets[i].properties->width) { // if the asset is out of screen
-                assets[i].visible = false; // set asset x coordinate to 0 to mark it as "inactive"
-            }
+    for(uint8_t i = 0; i < pool->count;) {
+        BackgroundAsset* asset = &assets[pool->slots[i]];
+        asset->point.x -= 1; // move left by 1 unit
+        if(asset->point.x <= -asset->properties->width) { // if the asset is out of screen
+            entity_pool_despawn(pool, i);
+            continue;
         }
+        i++;
     }
 }
 
-void spawn_random_background_asset(BackgroundAsset* const assets) {
+void spawn_random_background_asset(BackgroundAsset* const assets, EntityPool* const pool) {
     // Calculate the total spawn chances for all assets
     int total_spawn_chance = 0;
     for(int i = 0; i < BG_ASSETS_MAX; ++i) {
@@ -46,19 +46,16 @@ void spawn_random_background_asset(BackgroundAsset* const assets) {
     }
 
     // Look for an available slot for the chosen asset
-    for(int i = 0; i < BG_ASSETS_MAX; ++i) {
-        if(assets[i].visible == false) {
-            // Spawn the asset
-            assets[i].point.x = 127 + assetProperties[chosen_asset].x_offset;
-            assets[i].point.y = assetProperties[chosen_asset].y_offset;
-            assets[i].properties = &assetProperties[chosen_asset];
-            assets[i].visible = true;
-            break;
-        }
-    }
+    int slot = entity_pool_spawn(pool);
+    if(slot < 0) return;
+
+    assets[slot].point.x = 127 + assetProperties[chosen_asset].x_offset;
+    assets[slot].point.y = assetProperties[chosen_asset].y_offset;
+    assets[slot].properties = &assetProperties[chosen_asset];
 }
 
-void draw_background_assets(const BackgroundAsset* assets, Canvas* const canvas, int distance) {
+void draw_background_assets(
+    const BackgroundAsset* assets, const EntityPool* pool, Canvas* const canvas, int distance) {
     canvas_draw_box(canvas, 0, 6, 128, 1);
     canvas_draw_box(canvas, 0, 56, 128, 2);
 
@@ -71,11 +68,10 @@ void draw_background_assets(const BackgroundAsset* assets, Canvas* const canvas,
     }
 
     // Draw assets
-    for(int i = 0; i < BG_ASSETS_MAX; ++i) {
-        if(assets[i].visible) {
-            canvas_set_color(canvas, ColorBlack);
-            canvas_draw_icon(
-                canvas, assets[i].point.x, assets[i].point.y, assets[i].properties->sprite);
-        }
+    canvas_set_color(canvas, ColorBlack);
+    for(uint8_t i = 0; i < pool->count; ++i) {
+        const BackgroundAsset* asset = &assets[pool->slots[i]];
+        if(asset->point.x >= SCREEN_WIDTH) continue; // not on screen yet
+        canvas_draw_icon(canvas, asset->point.x, asset->point.y, asset->properties->sprite);
     }
 }
@@ -9,6 +9,7 @@
 #include "point.h"
 #include "states.h"
 #include "game_sprites.h"
+#include "entity_pool.h"
 #include <jetpack_game_icons.h>
 
 #define BG_ASSETS_MAX 3
@@ -24,11 +25,11 @@ typedef struct {
 typedef struct {
     POINT point;
     AssetProperties* properties;
-    bool visible;
 } BackgroundAsset;
 
-void background_assets_tick(BackgroundAsset* const assets);
-void spawn_random_background_asset(BackgroundAsset* const assets);
-void draw_background_assets(const BackgroundAsset* assets, Canvas* const canvas, int distance);
+void background_assets_tick(BackgroundAsset* const assets, EntityPool* const pool);
+void spawn_random_background_asset(BackgroundAsset* const assets, EntityPool* const pool);
+void draw_background_assets(
+    const BackgroundAsset* assets, const EntityPool* pool, Canvas* const canvas, int distance);
 
 #endif // BACKGROUND_ASSETS_H
@@ -23,19 +23,24 @@ const COIN_PATTERN coin_patterns[] = {
     // Add more patterns here
 };
 
-void coin_tick(COIN* const coins, BARRY* const barry, int* const total_coins) {
-    // Move coins towards the player
-    for(int i = 0; i < COINS_MAX; i++) {
-        if(coin_colides(&coins[i], barry)) {
-            coins[i].point.x = 0; // Remove the coin
+void coin_tick(
+    COIN* const coins, EntityPool* const pool, BARRY* const barry, int* const total_coins) {
+    // Move coins towards the player, collect the ones Barry touches and drop the ones that
+    // left the screen, all in one pass
+    for(uint8_t i = 0; i < pool->count;) {
+        COIN* coin = &coins[pool->slots[i]];
+        if(entity_spans_overlap(barry->point.x, BARRY_WIDTH, coin->point.x, COIN_WIDTH) &&
+           coin_colides(coin, barry)) {
             (*total_coins)++;
+            entity_pool_despawn(pool, i);
+            continue;
         }
-        if(coins[i].point.x > 0) {
-            coins[i].point.x -= 1; // move left by 1 unit
-            if(coins[i].point.x < -COIN_WIDTH) { // if the coin is out of screen
-                coins[i].point.x = 0; // set coin x coordinate to 0 to mark it as "inactive"
-            }
+        coin->point.x -= 1; // move left by 1 unit
+        if(coin->point.x < -COIN_WIDTH) { // if the coin is out of screen
+            entity_pool_despawn(pool, i);
+            continue;
         }
+        i++;
     }
 }
 
@@ -47,52 +52,37 @@ bool coin_colides(COIN* const coin, BARRY* const barry) {
         barry->point.y + BARRY_HEIGHT < coin->point.y); // Barry is above the coin
 }
 
-void spawn_random_coin(COIN* const coins) {
+void spawn_random_coin(COIN* const coins, EntityPool* const pool) {
     // Select a random pattern
     int pattern_index = rand() % (sizeof(coin_patterns) / sizeof(coin_patterns[0]));
     const COIN_PATTERN* pattern = &coin_patterns[pattern_index];
 
-    // Count available slots for new coins
-    int available_slots = 0;
-    for(int i = 0; i < COINS_MAX; ++i) {
-        if(coins[i].point.x <= 0) {
-            ++available_slots;
-        }
-    }
-
     // If there aren't enough slots, return without spawning coins
-    if(available_slots < pattern->count) return;
+    if(entity_pool_free_count(pool) < pattern->count) return;
 
     // Spawn coins according to the selected pattern
-    int coin_index = 0;
     int random_offset = rand() % (SCREEN_HEIGHT - PATTERN_MAX_HEIGHT);
     int random_offset_x = rand() % 16;
     for(int i = 0; i < pattern->count; ++i) {
-        // Find an available slot for a new coin
-        while(coins[coin_index].point.x > 0 && coin_index < COINS_MAX) {
-            ++coin_index;
-        }
-        // If no slot is available, stop spawning coins
-        if(coin_index == COINS_MAX) break;
-
-        // Spawn the coin
-        coins[coin_index].point.x = SCREEN_WIDTH - 1 + pattern->coins[i].x + random_offset_x;
-        coins[coin_index].point.y =
+        COIN* coin = &coins[entity_pool_spawn(pool)];
+        coin->point.x = SCREEN_WIDTH - 1 + pattern->coins[i].x + random_offset_x;
+        coin->point.y =
             random_offset +
             pattern->coins[i]
                 .y; // The pattern is spawned at a random y position, but not too close to the screen edge
     }
 }
 
-void draw_coins(const COIN* coins, Canvas* const canvas, const GameSprites* sprites) {
-    canvas_set_color(canvas, ColorBlack);
-    for(int i = 0; i < COINS_MAX; ++i) {
-        if(coins[i].point.x > 0) {
-            canvas_set_color(canvas, ColorBlack);
-            canvas_draw_icon(canvas, coins[i].point.x, coins[i].point.y, sprites->coin);
+void draw_coins(
+    const COIN* coins, const EntityPool* pool, Canvas* const canvas, const GameSprites* sprites) {
+    for(uint8_t i = 0; i < pool->count; ++i) {
+        const COIN* coin = &coins[pool->slots[i]];
+        if(coin->point.x >= SCREEN_WIDTH) continue; // not on screen yet
 
-            canvas_set_color(canvas, ColorWhite);
-            canvas_draw_icon(canvas, coins[i].point.x, coins[i].point.y, sprites->coin_infill);
-        }
+        canvas_set_color(canvas, ColorBlack);
+        canvas_draw_icon(canvas, coin->point.x, coin->point.y, sprites->coin);
+
+        canvas_set_color(canvas, ColorWhite);
+        canvas_draw_icon(canvas, coin->point.x, coin->point.y, sprites->coin_infill);
     }
 }
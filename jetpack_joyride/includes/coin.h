@@ -5,6 +5,7 @@
 
 #include "point.h"
 #include "barry.h"
+#include "entity_pool.h"
 
 #define COINS_MAX 15
 
@@ -18,9 +19,10 @@ typedef struct {
     POINT coins[COINS_MAX];
 } COIN_PATTERN;
 
-void coin_tick(COIN* const coins, BARRY* const barry, int* const poins);
-void spawn_random_coin(COIN* const coins);
+void coin_tick(COIN* const coins, EntityPool* const pool, BARRY* const barry, int* const poins);
+void spawn_random_coin(COIN* const coins, EntityPool* const pool);
 bool coin_colides(COIN* const coin, BARRY* const barry);
-void draw_coins(const COIN* coins, Canvas* const canvas, const GameSprites* sprites);
+void draw_coins(
+    const COIN* coins, const EntityPool* pool, Canvas* const canvas, const GameSprites* sprites);
 
 #endif // COIN_H
\ No newline at end of file
@@ -0,0 +1,22 @@
+#include "entity_pool.h"
+
+void entity_pool_init(EntityPool* const pool, uint8_t capacity) {
+    pool->capacity = capacity < ENTITY_POOL_MAX ? capacity : ENTITY_POOL_MAX;
+    pool->count = 0;
+    for(uint8_t i = 0; i < pool->capacity; i++) {
+        pool->slots[i] = i;
+    }
+}
+
+int entity_pool_spawn(EntityPool* const pool) {
+    if(pool->count == pool->capacity) return -1;
+    return pool->slots[pool->count++];
+}
+
+void entity_pool_despawn(EntityPool* const pool, uint8_t i) {
+    if(i >= pool->count) return;
+    uint8_t slot = pool->slots[i];
+    pool->count--;
+    pool->slots[i] = pool->slots[pool->count];
+    pool->slots[pool->count] = slot;
+}
@@ -0,0 +1,35 @@
+#ifndef ENTITY_POOL_H
+#define ENTITY_POOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ENTITY_POOL_MAX 50
+
+// Fixed-capacity pool of entity slots. slots[0..count) are the live entities, the rest are
+// free, so spawning and despawning are O(1) and loops only visit what is on the field.
+typedef struct {
+    uint8_t capacity;
+    uint8_t count;
+    uint8_t slots[ENTITY_POOL_MAX];
+} EntityPool;
+
+void entity_pool_init(EntityPool* const pool, uint8_t capacity);
+
+// Returns the index of a free slot or -1 if the pool is full
+int entity_pool_spawn(EntityPool* const pool);
+
+// Frees the entity at position `i` of the live list. The last live entity is swapped into
+// its place, so a loop that despawns must look at position `i` again.
+void entity_pool_despawn(EntityPool* const pool, uint8_t i);
+
+static inline uint8_t entity_pool_free_count(const EntityPool* pool) {
+    return pool->capacity - pool->count;
+}
+
+// Broad phase on the x axis, rejects most pairs before the full bounding box test
+static inline bool entity_spans_overlap(int a, int a_width, int b, int b_width) {
+    return a <= b + b_width && b <= a + a_width;
+}
+
+#endif // ENTITY_POOL_H
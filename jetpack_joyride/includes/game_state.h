@@ -12,6 +12,8 @@
 #include "states.h"
 #include "missile.h"
 #include "background_assets.h"
+#include "entity_pool.h"
+
 typedef struct {
     int total_coins;
     int distance;
@@ -22,11 +24,20 @@ typedef struct {
     SCIENTIST scientists[SCIENTISTS_MAX];
     MISSILE missiles[MISSILES_MAX];
     BackgroundAsset bg_assets[BG_ASSETS_MAX];
+    EntityPool coin_pool;
+    EntityPool particle_pool;
+    EntityPool scientist_pool;
+    EntityPool missile_pool;
+    EntityPool bg_asset_pool;
     State state;
     GameSprites sprites;
     FuriMutex* mutex;
     FuriTimer* timer;
     void (*death_handler)();
+#ifdef FURI_DEBUG
+    uint32_t frame_us; // how long the last game tick took
+    uint32_t frame_us_max;
+#endif
 } GameState;
 
 void game_state_tick(GameState* const game_state);
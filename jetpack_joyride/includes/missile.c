@@ -9,49 +9,49 @@
 #include "missile.h"
 #include "barry.h"
 
-void missile_tick(MISSILE* const missiles, BARRY* const barry, void (*death_handler)()) {
+void missile_tick(
+    MISSILE* const missiles, EntityPool* const pool, BARRY* const barry, void (*death_handler)()) {
     // Move missiles towards the player
-    for(int i = 0; i < MISSILES_MAX; i++) {
-        if(missiles[i].visible && missile_colides(&missiles[i], barry)) {
+    for(uint8_t i = 0; i < pool->count;) {
+        MISSILE* missile = &missiles[pool->slots[i]];
+        if(entity_spans_overlap(barry->point.x, BARRY_WIDTH, missile->point.x, MISSILE_WIDTH) &&
+           missile_colides(missile, barry)) {
             death_handler();
         }
-        if(missiles[i].visible) {
-            missiles[i].point.x -= 2; // move left by 2 units
-            if(missiles[i].point.x < -MISSILE_WIDTH) { // if the missile is out of screen
-                missiles[i].visible = false; // set missile as "inactive"
-            }
+        missile->point.x -= 2; // move left by 2 units
+        if(missile->point.x < -MISSILE_WIDTH) { // if the missile is out of screen
+            entity_pool_despawn(pool, i);
+            continue;
         }
+        i++;
     }
 }
 
-void spawn_random_missile(MISSILE* const missiles) {
-    // Check for an available slot for a new missile
-    for(int i = 0; i < MISSILES_MAX; ++i) {
-        if(!missiles[i].visible) {
-            missiles[i].point.x = 2 * SCREEN_WIDTH;
-            missiles[i].point.y = rand() % (SCREEN_HEIGHT - MISSILE_HEIGHT);
-            missiles[i].visible = true;
-            break;
-        }
-    }
+void spawn_random_missile(MISSILE* const missiles, EntityPool* const pool) {
+    int slot = entity_pool_spawn(pool);
+    if(slot < 0) return;
+
+    missiles[slot].point.x = 2 * SCREEN_WIDTH;
+    missiles[slot].point.y = rand() % (SCREEN_HEIGHT - MISSILE_HEIGHT);
 }
 
-void draw_missiles(const MISSILE* missiles, Canvas* const canvas, const GameSprites* sprites) {
-    for(int i = 0; i < MISSILES_MAX; ++i) {
-        if(missiles[i].visible) {
-            canvas_set_color(canvas, ColorBlack);
+void draw_missiles(
+    const MISSILE* missiles,
+    const EntityPool* pool,
+    Canvas* const canvas,
+    const GameSprites* sprites) {
+    for(uint8_t i = 0; i < pool->count; ++i) {
+        const MISSILE* missile = &missiles[pool->slots[i]];
+        canvas_set_color(canvas, ColorBlack);
 
-            if(missiles[i].point.x > 128) {
-                canvas_draw_icon_animation(
-                    canvas, SCREEN_WIDTH - 7, missiles[i].point.y, sprites->alert);
-            } else {
-                canvas_draw_icon_animation(
-                    canvas, missiles[i].point.x, missiles[i].point.y, sprites->missile);
+        if(missile->point.x > 128) {
+            canvas_draw_icon_animation(canvas, SCREEN_WIDTH - 7, missile->point.y, sprites->alert);
+        } else {
+            canvas_draw_icon_animation(
+                canvas, missile->point.x, missile->point.y, sprites->missile);
 
-                canvas_set_color(canvas, ColorWhite);
-                canvas_draw_icon(
-                    canvas, missiles[i].point.x, missiles[i].point.y, sprites->missile_infill);
-            }
+            canvas_set_color(canvas, ColorWhite);
+            canvas_draw_icon(canvas, missile->point.x, missile->point.y, sprites->missile_infill);
         }
     }
 }
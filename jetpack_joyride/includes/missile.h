@@ -7,18 +7,23 @@
 #include "states.h"
 #include "point.h"
 #include "barry.h"
+#include "entity_pool.h"
 
 #define MISSILES_MAX 5
 
 typedef struct {
     POINT point;
-    bool visible;
 } MISSILE;
 
-void missile_tick(MISSILE* const missiles, BARRY* const barry, void (*death_handler)());
-void spawn_random_missile(MISSILE* const MISSILEs);
+void missile_tick(
+    MISSILE* const missiles, EntityPool* const pool, BARRY* const barry, void (*death_handler)());
+void spawn_random_missile(MISSILE* const missiles, EntityPool* const pool);
 bool missile_colides(MISSILE* const MISSILE, BARRY* const barry);
 int get_rocket_spawn_distance(int player_distance);
-void draw_missiles(const MISSILE* missiles, Canvas* const canvas, const GameSprites* sprites);
+void draw_missiles(
+    const MISSILE* missiles,
+    const EntityPool* pool,
+    Canvas* const canvas,
+    const GameSprites* sprites);
 
 #endif // MISSILE_H
\ No newline at end of file
@@ -4,54 +4,77 @@
 #include "scientist.h"
 #include "barry.h"
 
-void particle_tick(PARTICLE* const particles, SCIENTIST* const scientists) {
+void particle_tick(
+    PARTICLE* const particles,
+    EntityPool* const pool,
+    SCIENTIST* const scientists,
+    EntityPool* const scientist_pool) {
+    // Broad phase: the span on the x axis covered by living scientists, particles outside of
+    // it can't hit anyone
+    int scientists_left = SCREEN_WIDTH;
+    int scientists_right = 0;
+    for(uint8_t j = 0; j < scientist_pool->count; j++) {
+        const SCIENTIST* scientist = &scientists[scientist_pool->slots[j]];
+        if(scientist->state == ScientistStateAlive && scientist->point.x > 0) {
+            if(scientist->point.x < scientists_left) scientists_left = scientist->point.x;
+            if(scientist->point.x > scientists_right) scientists_right = scientist->point.x;
+        }
+    }
+
     // Move particles
-    for(int i = 0; i < PARTICLES_MAX; i++) {
-        if(particles[i].point.y > 0) {
-            particles[i].point.y += PARTICLE_VELOCITY;
+    for(uint8_t i = 0; i < pool->count;) {
+        PARTICLE* particle = &particles[pool->slots[i]];
+        particle->point.y += PARTICLE_VELOCITY;
 
-            // Check collision with scientists
-            for(int j = 0; j < SCIENTISTS_MAX; j++) {
-                if(scientists[j].state == ScientistStateAlive && scientists[j].point.x > 0) {
+        // Check collision with scientists
+        if(scientists_left <= scientists_right &&
+           entity_spans_overlap(
+               particle->point.x,
+               0,
+               scientists_left,
+               scientists_right - scientists_left + SCIENTIST_WIDTH)) {
+            for(uint8_t j = 0; j < scientist_pool->count; j++) {
+                SCIENTIST* scientist = &scientists[scientist_pool->slots[j]];
+                if(scientist->state == ScientistStateAlive && scientist->point.x > 0) {
                     // Check whether the particle lies within the scientist's bounding box
-                    if(!(particles[i].point.x > scientists[j].point.x + SCIENTIST_WIDTH ||
-                         particles[i].point.x < scientists[j].point.x ||
-                         particles[i].point.y > scientists[j].point.y + SCIENTIST_HEIGHT ||
-                         particles[i].point.y < scientists[j].point.y)) {
-                        scientists[j].state = ScientistStateDead;
+                    if(!(particle->point.x > scientist->point.x + SCIENTIST_WIDTH ||
+                         particle->point.x < scientist->point.x ||
+                         particle->point.y > scientist->point.y + SCIENTIST_HEIGHT ||
+                         particle->point.y < scientist->point.y)) {
+                        scientist->state = ScientistStateDead;
                         // (*points) += 2; // Increase the score by 2
                     }
                 }
             }
+        }
 
-            if(particles[i].point.x < 0 || particles[i].point.x > SCREEN_WIDTH ||
-               particles[i].point.y < 0 || particles[i].point.y > SCREEN_HEIGHT) {
-                particles[i].point.y = 0;
-            }
+        if(particle->point.x < 0 || particle->point.x > SCREEN_WIDTH ||
+           particle->point.y < 0 || particle->point.y > SCREEN_HEIGHT) {
+            entity_pool_despawn(pool, i);
+            continue;
         }
+        i++;
     }
 }
 
-void spawn_random_particles(PARTICLE* const particles, BARRY* const barry) {
-    for(int i = 0; i < PARTICLES_MAX; i++) {
-        if(particles[i].point.y <= 0) {
-            particles[i].point.x = barry->point.x + (rand() % 4);
-            particles[i].point.y = barry->point.y + 14;
-            break;
-        }
-    }
+void spawn_random_particles(
+    PARTICLE* const particles, EntityPool* const pool, BARRY* const barry) {
+    int slot = entity_pool_spawn(pool);
+    if(slot < 0) return;
+
+    particles[slot].point.x = barry->point.x + (rand() % 4);
+    particles[slot].point.y = barry->point.y + 14;
 }
 
-void draw_particles(const PARTICLE* particles, Canvas* const canvas) {
+void draw_particles(const PARTICLE* particles, const EntityPool* pool, Canvas* const canvas) {
     canvas_set_color(canvas, ColorBlack);
-    for(int i = 0; i < PARTICLES_MAX; i++) {
-        if(particles[i].point.y > 0) {
-            canvas_draw_line(
-                canvas,
-                particles[i].point.x,
-                particles[i].point.y,
-                particles[i].point.x,
-                particles[i].point.y + 3);
-        }
+    for(uint8_t i = 0; i < pool->count; i++) {
+        const PARTICLE* particle = &particles[pool->slots[i]];
+        canvas_draw_line(
+            canvas,
+            particle->point.x,
+            particle->point.y,
+            particle->point.x,
+            particle->point.y + 3);
     }
 }
@@ -6,6 +6,7 @@
 #include "point.h"
 #include "scientist.h"
 #include "barry.h"
+#include "entity_pool.h"
 
 #define PARTICLES_MAX 50
 #define PARTICLE_VELOCITY 2
@@ -14,8 +15,12 @@ typedef struct {
     POINT point;
 } PARTICLE;
 
-void particle_tick(PARTICLE* const particles, SCIENTIST* const scientists);
-void spawn_random_particles(PARTICLE* const particles, BARRY* const barry);
-void draw_particles(const PARTICLE* particles, Canvas* const canvas);
+void particle_tick(
+    PARTICLE* const particles,
+    EntityPool* const pool,
+    SCIENTIST* const scientists,
+    EntityPool* const scientist_pool);
+void spawn_random_particles(PARTICLE* const particles, EntityPool* const pool, BARRY* const barry);
+void draw_particles(const PARTICLE* particles, const EntityPool* pool, Canvas* const canvas);
 
 #endif // PARTICLE_H
\ No newline at end of file
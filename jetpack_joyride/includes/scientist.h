@@ -3,6 +3,7 @@
 
 #include "point.h"
 #include "game_sprites.h"
+#include "entity_pool.h"
 #include <gui/gui.h>
 
 #define SCIENTIST_VELOCITY_MIN -0.5f
@@ -16,14 +17,17 @@ typedef enum {
 } ScientistState;
 
 typedef struct {
-    bool visible;
     POINTF point;
     float velocity_x;
     ScientistState state;
 } SCIENTIST;
 
-void scientist_tick(SCIENTIST* const scientist);
-void spawn_random_scientist(SCIENTIST* const scientists);
-void draw_scientists(const SCIENTIST* scientists, Canvas* const canvas, const GameSprites* sprites);
+void scientist_tick(SCIENTIST* const scientists, EntityPool* const pool);
+void spawn_random_scientist(SCIENTIST* const scientists, EntityPool* const pool);
+void draw_scientists(
+    const SCIENTIST* scientists,
+    const EntityPool* pool,
+    Canvas* const canvas,
+    const GameSprites* sprites);
 
 #endif // SCIENTIST_H
\ No newline at end of file
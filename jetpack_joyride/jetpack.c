@@ -6,6 +6,9 @@
 #include <gui/icon_animation.h>
 #include <input/input.h>
 #include <storage/storage.h>
+#ifdef FURI_DEBUG
+#include <furi_hal.h>
+#endif
 
 #include "includes/point.h"
 #include "includes/barry.h"
@@ -19,6 +22,8 @@
 
 #define TAG "Jetpack Game"
 #define SAVING_FILENAME APP_DATA_PATH("jetpack.save")
+#define FRAMES_PER_SECOND 25
+#define FRAME_BUDGET_US (1000000 / FRAMES_PER_SECOND)
 static GameState* global_state;
 
 typedef enum {
@@ -121,6 +126,17 @@ static void jetpack_game_state_init(GameState* const game_state) {
     memset(game_state->coins, 0, sizeof(game_state->coins));
     memset(game_state->particles, 0, sizeof(game_state->particles));
     memset(game_state->missiles, 0, sizeof(game_state->missiles));
+
+    entity_pool_init(&game_state->coin_pool, COINS_MAX);
+    entity_pool_init(&game_state->particle_pool, PARTICLES_MAX);
+    entity_pool_init(&game_state->scientist_pool, SCIENTISTS_MAX);
+    entity_pool_init(&game_state->missile_pool, MISSILES_MAX);
+    entity_pool_init(&game_state->bg_asset_pool, BG_ASSETS_MAX);
+
+#ifdef FURI_DEBUG
+    game_state->frame_us = 0;
+    game_state->frame_us_max = 0;
+#endif
 }
 
 static void jetpack_game_state_free(GameState* const game_state) {
@@ -133,34 +149,57 @@ static void jetpack_game_state_free(GameState* const game_state) {
 
 static void jetpack_game_tick(GameState* const game_state) {
     if(game_state->state == GameStateGameOver) return;
+#ifdef FURI_DEBUG
+    uint32_t start = DWT->CYCCNT;
+#endif
     barry_tick(&game_state->barry);
     game_state_tick(game_state);
-    coin_tick(game_state->coins, &game_state->barry, &game_state->total_coins);
-    particle_tick(game_state->particles, game_state->scientists);
-    scientist_tick(game_state->scientists);
-    missile_tick(game_state->missiles, &game_state->barry, game_state->death_handler);
-
-    background_assets_tick(game_state->bg_assets);
+    coin_tick(
+        game_state->coins, &game_state->coin_pool, &game_state->barry, &game_state->total_coins);
+    particle_tick(
+        game_state->particles,
+        &game_state->particle_pool,
+        game_state->scientists,
+        &game_state->scientist_pool);
+    scientist_tick(game_state->scientists, &game_state->scientist_pool);
+    missile_tick(
+        game_state->missiles,
+        &game_state->missile_pool,
+        &game_state->barry,
+        game_state->death_handler);
+
+    background_assets_tick(game_state->bg_assets, &game_state->bg_asset_pool);
 
     // generate background every 64px aka. ticks
     if(game_state->distance % 64 == 0 && rand() % 3 == 0) {
-        spawn_random_background_asset(game_state->bg_assets);
+        spawn_random_background_asset(game_state->bg_assets, &game_state->bg_asset_pool);
     }
 
     if(game_state->distance % 48 == 0 && rand() % 2 == 0) {
-        spawn_random_coin(game_state->coins);
+        spawn_random_coin(game_state->coins, &game_state->coin_pool);
     }
 
     if(game_state->distance % get_rocket_spawn_distance(game_state->distance) == 0 &&
        rand() % 2 == 0) {
-        spawn_random_missile(game_state->missiles);
+        spawn_random_missile(game_state->missiles, &game_state->missile_pool);
     }
 
-    spawn_random_scientist(game_state->scientists);
+    spawn_random_scientist(game_state->scientists, &game_state->scientist_pool);
 
     if(game_state->barry.isBoosting) {
-        spawn_random_particles(game_state->particles, &game_state->barry);
+        spawn_random_particles(
+            game_state->particles, &game_state->particle_pool, &game_state->barry);
+    }
+
+#ifdef FURI_DEBUG
+    game_state->frame_us = (DWT->CYCCNT - start) / furi_hal_cortex_instructions_per_microsecond();
+    if(game_state->frame_us > game_state->frame_us_max) {
+        game_state->frame_us_max = game_state->frame_us;
+    }
+    if(game_state->frame_us > FRAME_BUDGET_US) {
+        FURI_LOG_W(TAG, "tick took %lu us at %d", game_state->frame_us, game_state->distance);
     }
+#endif
 }
 
 static void jetpack_game_render_callback(Canvas* const canvas, void* ctx) {
@@ -171,14 +210,17 @@ static void jetpack_game_render_callback(Canvas* const canvas, void* ctx) {
     if(game_state->state == GameStateLife) {
         canvas_set_bitmap_mode(canvas, false);
 
-        draw_background_assets(game_state->bg_assets, canvas, game_state->distance);
+        draw_background_assets(
+            game_state->bg_assets, &game_state->bg_asset_pool, canvas, game_state->distance);
 
         canvas_set_bitmap_mode(canvas, true);
 
-        draw_coins(game_state->coins, canvas, &game_state->sprites);
-        draw_scientists(game_state->scientists, canvas, &game_state->sprites);
-        draw_particles(game_state->particles, canvas);
-        draw_missiles(game_state->missiles, canvas, &game_state->sprites);
+        draw_coins(game_state->coins, &game_state->coin_pool, canvas, &game_state->sprites);
+        draw_scientists(
+            game_state->scientists, &game_state->scientist_pool, canvas, &game_state->sprites);
+        draw_particles(game_state->particles, &game_state->particle_pool, canvas);
+        draw_missiles(
+            game_state->missiles, &game_state->missile_pool, canvas, &game_state->sprites);
 
         draw_barry(&game_state->barry, canvas, &game_state->sprites);
 
@@ -190,6 +232,18 @@ static void jetpack_game_render_callback(Canvas* const canvas, void* ctx) {
 
         snprintf(buffer, sizeof(buffer), "$%u", game_state->total_coins);
         canvas_draw_str_aligned(canvas, 5, 15, AlignLeft, AlignBottom, buffer);
+
+#ifdef FURI_DEBUG
+        // last and worst tick time, in microseconds
+        char frame_buffer[24];
+        snprintf(
+            frame_buffer,
+            sizeof(frame_buffer),
+            "%lu/%lu us",
+            game_state->frame_us,
+            game_state->frame_us_max);
+        canvas_draw_str_aligned(canvas, 123, 63, AlignRight, AlignBottom, frame_buffer);
+#endif
     }
 
     if(game_state->state == GameStateGameOver) {
@@ -294,7 +348,7 @@ int32_t jetpack_game_app(void* p) {
 
     FuriTimer* timer =
         furi_timer_alloc(jetpack_game_update_timer_callback, FuriTimerTypePeriodic, event_queue);
-    furi_timer_start(timer, furi_kernel_get_tick_frequency() / 25);
+    furi_timer_start(timer, furi_kernel_get_tick_frequency() / FRAMES_PER_SECOND);
 
     game_state->timer = timer;
 
@@ -42,7 +42,7 @@ static const int nd_numbers[] = {
     [ND_4096] = 4096,
 };
 
-const float aperture_numbers[] = {
+static const float aperture_numbers[] = {
     [AP_1] = 1.0,
     [AP_1_4] = 1.4,
     [AP_2] = 2.0,
@@ -60,7 +60,7 @@ const float aperture_numbers[] = {
     [AP_128] = 128,
 };
 
-const float speed_numbers[] = {
+static const float speed_numbers[] = {
     [SPEED_8000] = 1.0 / 8000, [SPEED_4000] = 1.0 / 4000, [SPEED_2000] = 1.0 / 2000,
     [SPEED_1000] = 1.0 / 1000, [SPEED_500] = 1.0 / 500,   [SPEED_250] = 1.0 / 250,
     [SPEED_125] = 1.0 / 125,   [SPEED_60] = 1.0 / 60,     [SPEED_48] = 1.0 / 48,
@@ -354,22 +354,19 @@ void draw_top_row(Canvas* canvas, MainViewModel* context) {
         canvas_draw_str(canvas, 24, 10, "No sensor found");
         canvas_set_color(canvas, ColorBlack);
     } else {
-        model->iso_val = iso_numbers[model->iso];
-        if(model->nd > 0) model->iso_val /= nd_numbers[model->nd];
-
+        // aperture_val and speed_val are table indices, -1 when out of range
         if(model->lux > 0) {
+            float ev = evForSettings(model->EV, model->iso, model->nd);
             if(model->current_mode == FIXED_APERTURE) {
-                model->speed_val = 100 * pow(aperture_numbers[model->aperture], 2) /
-                                   (double)model->iso_val / pow(2, model->EV);
+                model->speed_val = speedForAperture(ev, model->aperture);
             } else {
-                model->aperture_val = sqrt(
-                    pow(2, model->EV) * (double)model->iso_val *
-                    (double)speed_numbers[model->speed] / 100);
+                model->aperture_val = apertureForSpeed(ev, model->speed);
             }
+        } else {
+            model->speed_val = -1;
+            model->aperture_val = -1;
         }
 
-        // TODO when T:30, f/0 instead of f/128
-
         canvas_draw_line(canvas, 0, 10, 128, 10);
 
         canvas_set_font(canvas, FontPrimary);
@@ -404,12 +401,12 @@ void draw_aperture(Canvas* canvas, MainViewModel* context) {
         canvas_draw_str_aligned(canvas, 27, 15, AlignLeft, AlignTop, str);
         break;
     case FIXED_SPEED:
-        if(model->aperture_val < aperture_numbers[0] || !model->response) {
+        if(model->aperture_val < 0 || !model->response) {
             snprintf(str, sizeof(str), " ---");
-        } else if(model->aperture_val < aperture_numbers[AP_8]) {
-            snprintf(str, sizeof(str), "/%.1f", (double)normalizeAperture(model->aperture_val));
+        } else if(model->aperture_val < AP_8) {
+            snprintf(str, sizeof(str), "/%.1f", (double)aperture_numbers[model->aperture_val]);
         } else {
-            snprintf(str, sizeof(str), "/%.0f", (double)normalizeAperture(model->aperture_val));
+            snprintf(str, sizeof(str), "/%.0f", (double)aperture_numbers[model->aperture_val]);
         }
         canvas_draw_str_aligned(canvas, 27, 15, AlignLeft, AlignTop, str);
         break;
@@ -425,11 +422,11 @@ void draw_speed(Canvas* canvas, MainViewModel* context) {
 
     switch(model->current_mode) {
     case FIXED_APERTURE:
-        if(model->lux > 0 && model->response) {
-            if(model->speed_val < 1 && model->speed_val > 0) {
-                snprintf(str, sizeof(str), ":1/%.0f", 1 / (double)normalizeTime(model->speed_val));
+        if(model->speed_val >= 0 && model->response) {
+            if(model->speed_val < SPEED_1S) {
+                snprintf(str, sizeof(str), ":1/%.0f", 1 / (double)speed_numbers[model->speed_val]);
             } else {
-                snprintf(str, sizeof(str), ":%.0f", (double)normalizeTime(model->speed_val));
+                snprintf(str, sizeof(str), ":%.0f", (double)speed_numbers[model->speed_val]);
             }
         } else {
             snprintf(str, sizeof(str), " ---");
@@ -31,9 +31,8 @@ typedef struct {
     float lux;
     float peakLux;
     float EV;
-    float aperture_val;
-    float speed_val;
-    int iso_val;
+    int aperture_val;
+    int speed_val;
     bool response;
     int iso;
     int nd;
@@ -3,6 +3,15 @@
 
 #define TAG "MAIN APP"
 
+// Sensors run in continuous mode, so the tick only has to be longer than the slowest
+// conversion (180 ms for BH1750 high resolution) to get a fresh reading every time
+#define SENSOR_SAMPLE_PERIOD_MS 200
+
+// Weight of a new reading in the EV average, jumps larger than EV_SMOOTHING_RESET stops
+// are taken as they are so the meter follows real changes of light without lag
+#define EV_SMOOTHING 0.3f
+#define EV_SMOOTHING_RESET 1.0f
+
 static bool lightmeter_custom_event_callback(void* context, uint32_t event) {
     furi_assert(context);
     LightMeterApp* app = context;
@@ -38,6 +47,9 @@ LightMeterApp* lightmeter_app_alloc(uint32_t first_scene) {
     app->config->device_addr = ADDR_LOW;
     app->config->lux_only = LUX_ONLY_OFF;
 
+    app->ev = 0;
+    app->ev_valid = false;
+
     // Records
     app->gui = furi_record_open(RECORD_GUI);
     app->storage = furi_record_open(RECORD_STORAGE);
@@ -73,7 +85,9 @@ LightMeterApp* lightmeter_app_alloc(uint32_t first_scene) {
     view_dispatcher_set_navigation_event_callback(
         app->view_dispatcher, lightmeter_back_event_callback);
     view_dispatcher_set_tick_event_callback(
-        app->view_dispatcher, lightmeter_tick_event_callback, furi_ms_to_ticks(200));
+        app->view_dispatcher,
+        lightmeter_tick_event_callback,
+        furi_ms_to_ticks(SENSOR_SAMPLE_PERIOD_MS));
     view_dispatcher_attach_to_gui(app->view_dispatcher, app->gui, ViewDispatcherTypeFullscreen);
 
     // Views
@@ -192,7 +206,17 @@ void lightmeter_app_i2c_init_sensor(LightMeterApp* context) {
             bh1750_init_with_addr(0x23);
             break;
         }
-        bh1750_set_mode(ONETIME_HIGH_RES_MODE);
+        switch(app->config->measurement_resolution) {
+        case LOW_RES:
+            bh1750_set_mode(CONTINUOUS_LOW_RES_MODE);
+            break;
+        case HIGH_RES2:
+            bh1750_set_mode(CONTINUOUS_HIGH_RES_MODE_2);
+            break;
+        default:
+            bh1750_set_mode(CONTINUOUS_HIGH_RES_MODE);
+            break;
+        }
         break;
     case SENSOR_MAX44009:
         switch(app->config->device_addr) {
@@ -236,10 +260,7 @@ void lightmeter_app_i2c_callback(LightMeterApp* context) {
     bool response = 0;
 
     if(app->config->sensor_type == SENSOR_BH1750) {
-        if(bh1750_trigger_manual_conversion() == BH1750_OK) {
-            bh1750_read_light(&lux);
-            response = 1;
-        }
+        if(bh1750_read_light(&lux) == BH1750_OK) response = 1;
     } else if(app->config->sensor_type == SENSOR_MAX44009) {
         if(max44009_read_light(&lux)) response = 1;
     }
@@ -247,6 +268,18 @@ void lightmeter_app_i2c_callback(LightMeterApp* context) {
     if(main_view_get_dome(app->main_view)) lux *= DOME_COEFFICIENT;
     EV = lux2ev(lux);
 
+    if(response && lux > 0) {
+        if(!app->ev_valid || fabsf(EV - app->ev) > EV_SMOOTHING_RESET) {
+            app->ev = EV;
+            app->ev_valid = true;
+        } else {
+            app->ev += (EV - app->ev) * EV_SMOOTHING;
+        }
+        EV = app->ev;
+    } else {
+        app->ev_valid = false;
+    }
+
     main_view_set_lux(app->main_view, lux);
     main_view_set_EV(app->main_view, EV);
     main_view_set_response(app->main_view, response);
@@ -51,6 +51,10 @@ typedef struct {
 
     Storage* storage;
     FuriString* cfg_path;
+
+    // Averaged EV, see lightmeter_app_i2c_callback
+    float ev;
+    bool ev_valid;
 } LightMeterApp;
 
 typedef enum {
@@ -1,43 +1,55 @@
 #include "lightmeter_helper.h"
 #include "lightmeter_config.h"
 
-extern const float aperture_numbers[];
-extern const float speed_numbers[];
+// log2(N^2), stops of light lost from f/1
+static const float aperture_stops[] = {
+    [AP_1] = 0.0f,     [AP_1_4] = 0.971f, [AP_2] = 2.0f,    [AP_2_8] = 2.971f, [AP_4] = 4.0f,
+    [AP_5_6] = 4.971f, [AP_8] = 6.0f,     [AP_11] = 6.919f, [AP_16] = 8.0f,    [AP_22] = 8.919f,
+    [AP_32] = 10.0f,   [AP_45] = 10.984f, [AP_64] = 12.0f,  [AP_90] = 12.984f, [AP_128] = 14.0f,
+};
+
+// log2(t), stops of light gained from a 1 second exposure
+static const float speed_stops[] = {
+    [SPEED_8000] = -12.966f, [SPEED_4000] = -11.966f, [SPEED_2000] = -10.966f,
+    [SPEED_1000] = -9.966f,  [SPEED_500] = -8.966f,   [SPEED_250] = -7.966f,
+    [SPEED_125] = -6.966f,   [SPEED_60] = -5.907f,    [SPEED_48] = -5.585f,
+    [SPEED_30] = -4.907f,    [SPEED_15] = -3.907f,    [SPEED_8] = -3.0f,
+    [SPEED_4] = -2.0f,       [SPEED_2] = -1.0f,       [SPEED_1S] = 0.0f,
+    [SPEED_2S] = 1.0f,       [SPEED_4S] = 2.0f,       [SPEED_8S] = 3.0f,
+    [SPEED_15S] = 3.907f,    [SPEED_30S] = 4.907f,
+};
 
 float lux2ev(float lux) {
-    return log2(lux / 2.5);
+    return log2f(lux / 2.5f);
 }
 
-float getMinDistance(float x, float v1, float v2) {
-    if(x - v1 > v2 - x) {
-        return v2;
+// Binary search for the entry closest to x in an ascending table, -1 if x is more than
+// half a stop outside of it
+static int nearestStop(const float* stops, int size, float x) {
+    if(x < stops[0] - 0.5f || x > stops[size - 1] + 0.5f) return -1;
+
+    int lo = 0;
+    int hi = size - 1;
+    while(hi - lo > 1) {
+        int mid = (lo + hi) / 2;
+        if(stops[mid] <= x)
+            lo = mid;
+        else
+            hi = mid;
     }
 
-    return v1;
+    return (x - stops[lo] > stops[hi] - x) ? hi : lo;
 }
 
-float normalizeAperture(float a) {
-    for(int i = 0; i < AP_NUM; i++) {
-        float a1 = aperture_numbers[i];
-        float a2 = aperture_numbers[i + 1];
-
-        if(a1 < a && a2 >= a) {
-            return getMinDistance(a, a1, a2);
-        }
-    }
-
-    return 0;
+float evForSettings(float ev, int iso, int nd) {
+    // ISO and ND tables are whole stops apart, ISO_100 and ND_0 being the reference
+    return ev + (float)(iso - ISO_100) - (float)nd;
 }
 
-float normalizeTime(float a) {
-    for(int i = 0; i < SPEED_NUM; i++) {
-        float a1 = speed_numbers[i];
-        float a2 = speed_numbers[i + 1];
-
-        if(a1 < a && a2 >= a) {
-            return getMinDistance(a, a1, a2);
-        }
-    }
+int apertureForSpeed(float ev, int speed) {
+    return nearestStop(aperture_stops, AP_NUM, ev + speed_stops[speed]);
+}
 
-    return 0;
+int speedForAperture(float ev, int aperture) {
+    return nearestStop(speed_stops, SPEED_NUM, aperture_stops[aperture] - ev);
 }
@@ -4,8 +4,10 @@
 
 float lux2ev(float lux);
 
-float getMinDistance(float x, float v1, float v2);
+// Exposure value at ISO 100 shifted to the given ISO and ND filter enumerators
+float evForSettings(float ev, int iso, int nd);
 
-float normalizeAperture(float a);
+// Closest aperture or speed enumerator for the exposure, -1 when it is out of range
+int apertureForSpeed(float ev, int speed);
 
-float normalizeTime(float a);
+int speedForAperture(float ev, int aperture);
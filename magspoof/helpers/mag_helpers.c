@@ -1,4 +1,5 @@
 #include "mag_helpers.h"
+#include "mag_waveform.h"
 
 #define TAG "MagHelpers"
 
@@ -12,6 +13,9 @@
 #define ZERO_BETWEEN 53 // n zeros between tracks
 #define ZERO_SUFFIX 25 // n zeros suffix
 
+// half-bits of the longest swipe: two full manchester track buffers plus all the zeros
+#define MAX_HALFBITS (2 * (ZERO_PREFIX + ZERO_BETWEEN + ZERO_SUFFIX) + 2 * 128 * 8)
+
 // bits per char on a given track
 const uint8_t bitlen[] = {7, 5, 5};
 // char offset by track
@@ -88,7 +92,7 @@ void play_halfbit(bool value, MagSetting* setting) {
     last_value = value;
 }
 
-void play_track(uint8_t* bits_manchester, uint16_t n_bits, MagSetting* setting, bool reverse) {
+void build_track(MagWaveform* waveform, uint8_t* bits_manchester, uint16_t n_bits, bool reverse) {
     for(uint16_t i = 0; i < n_bits; i++) {
         uint16_t j = (reverse) ? (n_bits - i - 1) : i;
         uint8_t byte = j / 8;
@@ -113,16 +117,74 @@ void play_track(uint8_t* bits_manchester, uint16_t n_bits, MagSetting* setting,
 
         bool bit = !!(bits_manchester[byte] & bitmask);
 
-        // TODO: reimplement timing delays. Replace fixed furi_hal_cortex_delay_us to wait instead to a specific value
-        // for DWT->CYCCNT. Note timer is aliased to 64us as per
-        // #define FURI_HAL_CORTEX_INSTRUCTIONS_PER_MICROSECOND (SystemCoreClock / 1000000) | furi_hal_cortex.c
+        mag_waveform_add(waveform, bit);
+    }
+}
 
-        play_halfbit(bit, setting);
-        furi_delay_us(setting->us_clock);
-        // if (i % 2 == 1) furi_delay_us(setting->us_interpacket);
+void build_zeros(MagWaveform* waveform, uint16_t n_zeros, bool* bit) {
+    for(uint16_t i = 0; i < (n_zeros * 2); i++) {
+        // is this right?
+        if(!!(i % 2)) *bit ^= 1;
+        mag_waveform_add(waveform, *bit);
     }
 }
 
+static bool get_dma_pins(MagSetting* setting, GPIO_TypeDef** port, uint32_t* high, uint32_t* low) {
+    // BSRR: lower half sets pins, upper half resets them
+    switch(setting->tx) {
+    case MagTxStateRFID:
+        *port = (RFID_PIN_OUT)->port;
+        *high = (RFID_PIN_OUT)->pin;
+        *low = (uint32_t)(RFID_PIN_OUT)->pin << 16;
+        return true;
+    case MagTxStateGPIO:
+        if((GPIO_PIN_A)->port != (GPIO_PIN_B)->port) return false;
+        *port = (GPIO_PIN_A)->port;
+        *high = (GPIO_PIN_A)->pin | ((uint32_t)(GPIO_PIN_B)->pin << 16);
+        *low = ((uint32_t)(GPIO_PIN_A)->pin << 16) | (GPIO_PIN_B)->pin;
+        return true;
+    case MagTxStatePiezo:
+        *port = gpio_speaker.port;
+        *high = gpio_speaker.pin;
+        *low = (uint32_t)gpio_speaker.pin << 16;
+        return true;
+    case MagTxStateLF_P:
+        if((RFID_PIN_OUT)->port != gpio_speaker.port) return false;
+        *port = gpio_speaker.port;
+        *high = (RFID_PIN_OUT)->pin | gpio_speaker.pin;
+        *low = *high << 16;
+        return true;
+    default:
+        // NFC field and CC1101 pulses are not plain GPIO writes
+        return false;
+    }
+}
+
+void play_waveform(MagWaveform* waveform, MagSetting* setting) {
+    GPIO_TypeDef* port;
+    uint32_t high, low;
+
+    if(get_dma_pins(setting, &port, &high, &low)) {
+        mag_waveform_play_dma(waveform, port, high, low, setting->us_clock);
+        return;
+    }
+
+    // Half-bits end on deadlines counted from the start of the swipe, so the time spent in
+    // play_halfbit does not stretch the clock like a fixed furi_delay_us after it did
+    const uint32_t period = setting->us_clock * furi_hal_cortex_instructions_per_microsecond();
+    size_t count = mag_waveform_get_count(waveform);
+
+    FURI_CRITICAL_ENTER();
+    FuriHalCortexTimer deadline = furi_hal_cortex_timer_get(0);
+    for(size_t i = 0; i < count; i++) {
+        play_halfbit(mag_waveform_get(waveform, i), setting);
+        deadline.value += period;
+        while(!furi_hal_cortex_timer_is_expired(deadline)) {
+        }
+    }
+    FURI_CRITICAL_EXIT();
+}
+
 void tx_init_rfid() {
     // initialize RFID system for TX
 
@@ -320,47 +382,38 @@ void mag_spoof(Mag* mag) {
     last_value = 2;
     bool bit = false;
 
-    if(!tx_init(setting)) return;
+    // Whole swipe is laid out before transmitting, playback only has to keep the clock
+    MagWaveform* waveform = mag_waveform_alloc(MAX_HALFBITS);
 
-    FURI_CRITICAL_ENTER();
-    for(uint16_t i = 0; i < (ZERO_PREFIX * 2); i++) {
-        // is this right?
-        if(!!(i % 2)) bit ^= 1;
-        play_halfbit(bit, setting);
-        furi_delay_us(setting->us_clock);
-    }
+    build_zeros(waveform, ZERO_PREFIX, &bit);
 
     if((setting->track == MagTrackStateOneAndTwo) || (setting->track == MagTrackStateOne))
-        play_track((uint8_t*)bits_t1_manchester, bits_t1_count, setting, false);
+        build_track(waveform, (uint8_t*)bits_t1_manchester, bits_t1_count, false);
 
-    if((setting->track == MagTrackStateOneAndTwo))
-        for(uint16_t i = 0; i < (ZERO_BETWEEN * 2); i++) {
-            if(!!(i % 2)) bit ^= 1;
-            play_halfbit(bit, setting);
-            furi_delay_us(setting->us_clock);
-        }
+    if((setting->track == MagTrackStateOneAndTwo)) build_zeros(waveform, ZERO_BETWEEN, &bit);
 
     if((setting->track == MagTrackStateOneAndTwo) || (setting->track == MagTrackStateTwo))
-        play_track(
+        build_track(
+            waveform,
             (uint8_t*)bits_t2_manchester,
             bits_t2_count,
-            setting,
             (setting->reverse == MagReverseStateOn));
 
     if((setting->track == MagTrackStateThree))
-        play_track((uint8_t*)bits_t3_manchester, bits_t3_count, setting, false);
+        build_track(waveform, (uint8_t*)bits_t3_manchester, bits_t3_count, false);
 
-    for(uint16_t i = 0; i < (ZERO_SUFFIX * 2); i++) {
-        if(!!(i % 2)) bit ^= 1;
-        play_halfbit(bit, setting);
-        furi_delay_us(setting->us_clock);
-    }
-    FURI_CRITICAL_EXIT();
+    build_zeros(waveform, ZERO_SUFFIX, &bit);
 
     free(data1);
     free(data2);
     free(data3);
-    tx_deinit(setting);
+
+    if(tx_init(setting)) {
+        play_waveform(waveform, setting);
+        tx_deinit(setting);
+    }
+
+    mag_waveform_free(waveform);
 }
 
 uint16_t add_bit(bool value, uint8_t* out, uint16_t count) {
@@ -2,8 +2,12 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "mag_waveform.h"
+
 void play_halfbit(bool value, MagSetting* setting);
-void play_track(uint8_t* bits_manchester, uint16_t n_bits, MagSetting* setting, bool reverse);
+void build_track(MagWaveform* waveform, uint8_t* bits_manchester, uint16_t n_bits, bool reverse);
+void build_zeros(MagWaveform* waveform, uint16_t n_zeros, bool* bit);
+void play_waveform(MagWaveform* waveform, MagSetting* setting);
 
 void tx_init_rf(int hz);
 void tx_init_rfid();
@@ -0,0 +1,140 @@
+#include "mag_waveform.h"
+
+#include <stm32wbxx_ll_tim.h>
+#include <stm32wbxx_ll_dma.h>
+
+#define TAG "MagWaveform"
+
+#define MAG_WAVEFORM_TIM TIM2
+// the firmware leaves DMA1 channels 6 and 7 alone
+#define MAG_WAVEFORM_DMA DMA1
+#define MAG_WAVEFORM_DMA_CHANNEL LL_DMA_CHANNEL_7
+
+struct MagWaveform {
+    uint8_t* levels; // one bit per half-bit, MSB first
+    size_t count;
+    size_t max_halfbits;
+};
+
+MagWaveform* mag_waveform_alloc(size_t max_halfbits) {
+    MagWaveform* waveform = malloc(sizeof(MagWaveform));
+    waveform->levels = malloc((max_halfbits + 7) / 8);
+    waveform->max_halfbits = max_halfbits;
+    mag_waveform_reset(waveform);
+    return waveform;
+}
+
+void mag_waveform_free(MagWaveform* waveform) {
+    furi_assert(waveform);
+    free(waveform->levels);
+    free(waveform);
+}
+
+void mag_waveform_reset(MagWaveform* waveform) {
+    furi_assert(waveform);
+    memset(waveform->levels, 0, (waveform->max_halfbits + 7) / 8);
+    waveform->count = 0;
+}
+
+void mag_waveform_add(MagWaveform* waveform, bool level) {
+    furi_assert(waveform);
+    if(waveform->count >= waveform->max_halfbits) return;
+
+    if(level) {
+        waveform->levels[waveform->count / 8] |= 0x80 >> (waveform->count % 8);
+    }
+    waveform->count++;
+}
+
+size_t mag_waveform_get_count(MagWaveform* waveform) {
+    furi_assert(waveform);
+    return waveform->count;
+}
+
+bool mag_waveform_get(MagWaveform* waveform, size_t index) {
+    furi_assert(waveform);
+    furi_assert(index < waveform->count);
+    return !!(waveform->levels[index / 8] & (0x80 >> (index % 8)));
+}
+
+void mag_waveform_play_dma(
+    MagWaveform* waveform,
+    GPIO_TypeDef* port,
+    uint32_t bsrr_high,
+    uint32_t bsrr_low,
+    uint32_t us_per_halfbit) {
+    furi_assert(waveform);
+    furi_assert(port);
+
+    if(waveform->count == 0) return;
+
+    uint32_t* bsrr = malloc(waveform->count * sizeof(uint32_t));
+    for(size_t i = 0; i < waveform->count; i++) {
+        bsrr[i] = mag_waveform_get(waveform, i) ? bsrr_high : bsrr_low;
+    }
+
+    furi_hal_bus_enable(FuriHalBusTIM2);
+
+    // 1 MHz counter, one update event per half-bit
+    LL_TIM_InitTypeDef tim_init = {
+        .Prescaler = 63, /* CPU frequency is ~64Mhz. */
+        .CounterMode = LL_TIM_COUNTERMODE_UP,
+        .Autoreload = us_per_halfbit - 1,
+    };
+    LL_TIM_Init(MAG_WAVEFORM_TIM, &tim_init);
+    LL_TIM_SetClockSource(MAG_WAVEFORM_TIM, LL_TIM_CLOCKSOURCE_INTERNAL);
+    LL_TIM_DisableCounter(MAG_WAVEFORM_TIM);
+    LL_TIM_SetCounter(MAG_WAVEFORM_TIM, 0);
+
+    // The first half-bit is written right away, every update event moves on to the next one
+    size_t dma_count = waveform->count - 1;
+    if(dma_count) {
+        LL_DMA_InitTypeDef dma_init = {
+            .PeriphOrM2MSrcAddress = (uint32_t) & (port->BSRR),
+            .MemoryOrM2MDstAddress = (uint32_t)&bsrr[1],
+            .Direction = LL_DMA_DIRECTION_MEMORY_TO_PERIPH,
+            .Mode = LL_DMA_MODE_NORMAL,
+            .PeriphOrM2MSrcIncMode = LL_DMA_PERIPH_NOINCREMENT,
+            .MemoryOrM2MDstIncMode = LL_DMA_MEMORY_INCREMENT,
+            .PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_WORD,
+            .MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_WORD,
+            .NbData = dma_count,
+            .PeriphRequest = LL_DMAMUX_REQ_TIM2_UP,
+            .Priority = LL_DMA_PRIORITY_VERYHIGH,
+        };
+        LL_DMA_Init(MAG_WAVEFORM_DMA, MAG_WAVEFORM_DMA_CHANNEL, &dma_init);
+        LL_DMA_ClearFlag_TC7(MAG_WAVEFORM_DMA);
+        LL_DMA_ClearFlag_TE7(MAG_WAVEFORM_DMA);
+        LL_DMA_EnableChannel(MAG_WAVEFORM_DMA, MAG_WAVEFORM_DMA_CHANNEL);
+        LL_TIM_EnableDMAReq_UPDATE(MAG_WAVEFORM_TIM);
+    }
+
+    FURI_CRITICAL_ENTER();
+    port->BSRR = bsrr[0];
+    LL_TIM_EnableCounter(MAG_WAVEFORM_TIM);
+    FURI_CRITICAL_EXIT();
+
+    // The CPU is free meanwhile, timing is kept by the timer and the DMA
+    uint32_t timeout_ms = waveform->count * us_per_halfbit / 1000 + 100;
+    uint32_t start = furi_get_tick();
+    while(dma_count && !LL_DMA_IsActiveFlag_TC7(MAG_WAVEFORM_DMA)) {
+        if(furi_get_tick() - start > furi_ms_to_ticks(timeout_ms)) {
+            FURI_LOG_E(TAG, "DMA timeout");
+            break;
+        }
+        furi_delay_tick(1);
+    }
+    // Hold the last half-bit for its full duration
+    furi_delay_us(us_per_halfbit);
+
+    LL_TIM_DisableCounter(MAG_WAVEFORM_TIM);
+    if(dma_count) {
+        LL_TIM_DisableDMAReq_UPDATE(MAG_WAVEFORM_TIM);
+        LL_DMA_DisableChannel(MAG_WAVEFORM_DMA, MAG_WAVEFORM_DMA_CHANNEL);
+        LL_DMA_ClearFlag_TC7(MAG_WAVEFORM_DMA);
+        LL_DMA_DeInit(MAG_WAVEFORM_DMA, MAG_WAVEFORM_DMA_CHANNEL);
+    }
+    furi_hal_bus_disable(FuriHalBusTIM2);
+
+    free(bsrr);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <furi.h>
+#include <furi_hal.h>
+
+/*
+ * Precomputed half-bit levels of a whole swipe.
+ *
+ * Outputs driven by plain GPIO writes are played back by DMA into the port BSRR register,
+ * paced by the TIM2 update event, so half-bit timing does not depend on the CPU at all.
+ */
+typedef struct MagWaveform MagWaveform;
+
+MagWaveform* mag_waveform_alloc(size_t max_halfbits);
+
+void mag_waveform_free(MagWaveform* waveform);
+
+void mag_waveform_reset(MagWaveform* waveform);
+
+/** Append one half-bit, silently dropped once max_halfbits is reached */
+void mag_waveform_add(MagWaveform* waveform, bool level);
+
+size_t mag_waveform_get_count(MagWaveform* waveform);
+
+bool mag_waveform_get(MagWaveform* waveform, size_t index);
+
+/** Play the waveform on one GPIO port and block until the last half-bit is over
+ *
+ * @param port GPIO port holding every pin to drive
+ * @param bsrr_high BSRR value written for a high half-bit
+ * @param bsrr_low BSRR value written for a low half-bit
+ * @param us_per_halfbit half-bit duration
+ */
+void mag_waveform_play_dma(
+    MagWaveform* waveform,
+    GPIO_TypeDef* port,
+    uint32_t bsrr_high,
+    uint32_t bsrr_low,
+    uint32_t us_per_halfbit);
@@ -0,0 +1,154 @@
+#include "mass_storage_cache.h"
+#include "mass_storage_scsi.h"
+
+#define TAG "MassStorageCache"
+
+// 64 blocks, one bit per block fits in the valid/dirty masks
+#define CACHE_CHUNK_BLOCKS (64UL)
+#define CACHE_CHUNK_SIZE (CACHE_CHUNK_BLOCKS * SCSI_BLOCK_SIZE)
+#define CACHE_NO_CHUNK (UINT32_MAX)
+
+struct MassStorageCache {
+    MassStorageImage* image;
+    uint32_t num_blocks;
+
+    uint32_t chunk; // index of the cached chunk
+    uint64_t valid; // blocks of the chunk that match or replace the file
+    uint64_t dirty; // blocks of the chunk not written to the file yet
+    uint32_t next_lba; // where a sequential read would continue
+    uint8_t* data;
+};
+
+static uint64_t cache_mask(uint32_t offset, uint32_t count) {
+    if(count == CACHE_CHUNK_BLOCKS) return UINT64_MAX;
+    return ((1ULL << count) - 1) << offset;
+}
+
+// Blocks of the cached chunk that are inside the file
+static uint64_t cache_chunk_mask(MassStorageCache* cache) {
+    uint32_t first_lba = cache->chunk * CACHE_CHUNK_BLOCKS;
+    return cache_mask(0, MIN(CACHE_CHUNK_BLOCKS, cache->num_blocks - first_lba));
+}
+
+static bool cache_file_io(
+    MassStorageCache* cache,
+    uint32_t lba,
+    uint32_t count,
+    uint8_t* buf,
+    bool write) {
+    if(write) return mass_storage_image_write(cache->image, lba, count, buf);
+    return mass_storage_image_read(cache->image, lba, count, buf);
+}
+
+// One file operation per run of consecutive blocks in mask
+static bool cache_chunk_io(MassStorageCache* cache, uint64_t mask, bool write) {
+    uint32_t first_lba = cache->chunk * CACHE_CHUNK_BLOCKS;
+    uint32_t i = 0;
+    while(i < CACHE_CHUNK_BLOCKS) {
+        if(!(mask & (1ULL << i))) {
+            i++;
+            continue;
+        }
+        uint32_t start = i;
+        while(i < CACHE_CHUNK_BLOCKS && (mask & (1ULL << i))) i++;
+        if(!cache_file_io(
+               cache,
+               first_lba + start,
+               i - start,
+               cache->data + start * SCSI_BLOCK_SIZE,
+               write))
+            return false;
+    }
+    return true;
+}
+
+static bool cache_select(MassStorageCache* cache, uint32_t chunk) {
+    if(cache->chunk == chunk) return true;
+    if(!mass_storage_cache_flush(cache)) return false;
+    cache->chunk = chunk;
+    cache->valid = 0;
+    return true;
+}
+
+MassStorageCache* mass_storage_cache_alloc(MassStorageImage* image) {
+    MassStorageCache* cache = malloc(sizeof(MassStorageCache));
+    cache->image = image;
+    cache->num_blocks = mass_storage_image_num_blocks(image);
+    cache->chunk = CACHE_NO_CHUNK;
+    cache->data = malloc(CACHE_CHUNK_SIZE);
+    return cache;
+}
+
+void mass_storage_cache_free(MassStorageCache* cache) {
+    if(!mass_storage_cache_flush(cache)) {
+        FURI_LOG_E(
+            TAG, "flush failed, %lu blocks lost", (uint32_t)__builtin_popcountll(cache->dirty));
+    }
+    free(cache->data);
+    free(cache);
+}
+
+bool mass_storage_cache_read(MassStorageCache* cache, uint32_t lba, uint32_t count, uint8_t* out) {
+    if(lba >= cache->num_blocks || count > cache->num_blocks - lba) return false;
+    // read ahead the rest of the chunk only when the host reads sequentially,
+    // random metadata reads only load what was asked for
+    bool sequential = (lba == cache->next_lba);
+    cache->next_lba = lba + count;
+
+    while(count) {
+        uint32_t chunk = lba / CACHE_CHUNK_BLOCKS;
+        uint32_t offset = lba % CACHE_CHUNK_BLOCKS;
+        uint32_t blocks = MIN(count, CACHE_CHUNK_BLOCKS - offset);
+        if(chunk != cache->chunk && blocks == CACHE_CHUNK_BLOCKS) {
+            // whole chunk, reading it into the cache first only adds a copy
+            if(!cache_file_io(cache, lba, blocks, out, false)) return false;
+        } else {
+            if(!cache_select(cache, chunk)) return false;
+            uint64_t mask = sequential ? cache_chunk_mask(cache) : cache_mask(offset, blocks);
+            if(!cache_chunk_io(cache, mask & ~cache->valid, false)) return false;
+            cache->valid |= mask;
+            memcpy(out, cache->data + offset * SCSI_BLOCK_SIZE, blocks * SCSI_BLOCK_SIZE);
+        }
+        lba += blocks;
+        count -= blocks;
+        out += blocks * SCSI_BLOCK_SIZE;
+    }
+    return true;
+}
+
+bool mass_storage_cache_write(
+    MassStorageCache* cache,
+    uint32_t lba,
+    uint32_t count,
+    const uint8_t* data) {
+    if(lba >= cache->num_blocks || count > cache->num_blocks - lba) return false;
+
+    while(count) {
+        uint32_t chunk = lba / CACHE_CHUNK_BLOCKS;
+        uint32_t offset = lba % CACHE_CHUNK_BLOCKS;
+        uint32_t blocks = MIN(count, CACHE_CHUNK_BLOCKS - offset);
+        if(chunk != cache->chunk && blocks == CACHE_CHUNK_BLOCKS) {
+            if(!cache_file_io(cache, lba, blocks, (uint8_t*)data, true)) return false;
+        } else {
+            if(!cache_select(cache, chunk)) return false;
+            uint64_t mask = cache_mask(offset, blocks);
+            memcpy(cache->data + offset * SCSI_BLOCK_SIZE, data, blocks * SCSI_BLOCK_SIZE);
+            cache->valid |= mask;
+            cache->dirty |= mask;
+        }
+        lba += blocks;
+        count -= blocks;
+        data += blocks * SCSI_BLOCK_SIZE;
+    }
+    return true;
+}
+
+bool mass_storage_cache_flush(MassStorageCache* cache) {
+    if(!cache->dirty) return true;
+    if(!cache_chunk_io(cache, cache->dirty, true)) {
+        FURI_LOG_W(TAG, "flush failed");
+        return false;
+    }
+    cache->dirty = 0;
+    return true;
+}
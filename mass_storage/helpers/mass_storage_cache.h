@@ -0,0 +1,19 @@
+#pragma once
+
+#include "mass_storage_image.h"
+
+typedef struct MassStorageCache MassStorageCache;
+
+// Block cache in front of the disk image, one 32 KB, LBA aligned chunk is kept in RAM.
+// Small writes are held back until mass_storage_cache_flush() or a switch to another chunk.
+MassStorageCache* mass_storage_cache_alloc(MassStorageImage* image);
+// Flushes pending writes before freeing
+void mass_storage_cache_free(MassStorageCache* cache);
+
+bool mass_storage_cache_read(MassStorageCache* cache, uint32_t lba, uint32_t count, uint8_t* out);
+bool mass_storage_cache_write(
+    MassStorageCache* cache,
+    uint32_t lba,
+    uint32_t count,
+    const uint8_t* data);
+bool mass_storage_cache_flush(MassStorageCache* cache);
@@ -0,0 +1,224 @@
+#include "mass_storage_image.h"
+#include "mass_storage_scsi.h"
+
+#define TAG "MassStorageImage"
+
+#define IMAGE_SPARSE_MAGIC "FZSPARSE"
+#define IMAGE_SPARSE_VERSION (1)
+// Keeps the cluster map at 8 KB of RAM, the cluster size grows with the image instead
+#define IMAGE_SPARSE_MAX_CLUSTERS (4096UL)
+#define IMAGE_SPARSE_MIN_CLUSTER_SIZE (64UL * 1024)
+#define IMAGE_ZERO_BUFFER_SIZE (4096UL)
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t cluster_size; // bytes, power of two
+    uint64_t size; // bytes, multiple of cluster_size
+    uint32_t cluster_count;
+    uint32_t data_offset; // first cluster, block aligned
+} __attribute__((packed)) SparseHeader;
+
+struct MassStorageImage {
+    File* file;
+    uint32_t num_blocks;
+
+    // sparse only, map is NULL for raw images
+    uint32_t cluster_blocks;
+    uint32_t data_offset;
+    uint16_t clusters_used;
+    // file slot + 1 of every cluster, 0 if unallocated
+    uint16_t* map;
+};
+
+static bool image_file_io(File* file, uint64_t offset, uint8_t* buf, size_t size, bool write) {
+    if(!storage_file_seek(file, offset, true)) {
+        FURI_LOG_W(TAG, "seek failed");
+        return false;
+    }
+    if(write) return storage_file_write(file, buf, size) == size;
+    return storage_file_read(file, buf, size) == size;
+}
+
+static bool image_write_zero(File* file, uint64_t offset, size_t size) {
+    if(!size) return true;
+    uint8_t* zero = malloc(IMAGE_ZERO_BUFFER_SIZE);
+    bool result = storage_file_seek(file, offset, true);
+    while(result && size) {
+        size_t chunk = MIN(size, IMAGE_ZERO_BUFFER_SIZE);
+        result = storage_file_write(file, zero, chunk) == chunk;
+        size -= chunk;
+    }
+    free(zero);
+    return result;
+}
+
+static uint32_t image_sparse_data_offset(uint32_t cluster_count) {
+    uint32_t size = sizeof(SparseHeader) + cluster_count * sizeof(uint16_t);
+    return (size + SCSI_BLOCK_SIZE - 1) / SCSI_BLOCK_SIZE * SCSI_BLOCK_SIZE;
+}
+
+static bool image_sparse_open(MassStorageImage* image) {
+    SparseHeader header;
+    if(!image_file_io(image->file, 0, (uint8_t*)&header, sizeof(header), false)) return false;
+    if(memcmp(header.magic, IMAGE_SPARSE_MAGIC, sizeof(header.magic)) != 0) return false;
+
+    do {
+        if(header.version != IMAGE_SPARSE_VERSION) break;
+        if(header.cluster_size < IMAGE_SPARSE_MIN_CLUSTER_SIZE) break;
+        if(header.cluster_size & (header.cluster_size - 1)) break;
+        if(!header.cluster_count || header.cluster_count > IMAGE_SPARSE_MAX_CLUSTERS) break;
+        if(header.size != (uint64_t)header.cluster_count * header.cluster_size) break;
+        if(header.data_offset != image_sparse_data_offset(header.cluster_count)) break;
+
+        image->map = malloc(header.cluster_count * sizeof(uint16_t));
+        if(!image_file_io(
+               image->file,
+               sizeof(header),
+               (uint8_t*)image->map,
+               header.cluster_count * sizeof(uint16_t),
+               false))
+            break;
+        uint32_t i = 0;
+        for(; i < header.cluster_count; i++) {
+            if(image->map[i] > header.cluster_count) break;
+            image->clusters_used = MAX(image->clusters_used, image->map[i]);
+        }
+        if(i != header.cluster_count) break;
+        image->num_blocks = header.size / SCSI_BLOCK_SIZE;
+        image->cluster_blocks = header.cluster_size / SCSI_BLOCK_SIZE;
+        image->data_offset = header.data_offset;
+        FURI_LOG_I(
+            TAG,
+            "sparse, %lu/%lu clusters of %lu bytes",
+            (uint32_t)image->clusters_used,
+            header.cluster_count,
+            header.cluster_size);
+        return true;
+    } while(false);
+
+    FURI_LOG_E(TAG, "bad sparse header");
+    free(image->map);
+    image->map = NULL;
+    return false;
+}
+
+MassStorageImage* mass_storage_image_open(File* file) {
+    MassStorageImage* image = malloc(sizeof(MassStorageImage));
+    image->file = file;
+    if(!image_sparse_open(image)) {
+        image->num_blocks = storage_file_size(file) / SCSI_BLOCK_SIZE;
+    }
+    return image;
+}
+
+void mass_storage_image_close(MassStorageImage* image) {
+    free(image->map);
+    free(image);
+}
+
+uint32_t mass_storage_image_num_blocks(MassStorageImage* image) {
+    return image->num_blocks;
+}
+
+static uint64_t image_cluster_offset(MassStorageImage* image, uint16_t slot) {
+    return image->data_offset + (uint64_t)(slot - 1) * image->cluster_blocks * SCSI_BLOCK_SIZE;
+}
+
+// Writes the data and clears the rest of a new cluster, then syncs before the map entry
+// is written, so a power loss or a failed write never maps garbage
+static bool image_sparse_alloc(
+    MassStorageImage* image,
+    uint32_t cluster,
+    uint32_t offset,
+    uint32_t count,
+    uint8_t* data) {
+    uint16_t slot = image->clusters_used + 1;
+    uint64_t start = image_cluster_offset(image, slot);
+    uint64_t end = start + image->cluster_blocks * SCSI_BLOCK_SIZE;
+    uint64_t data_start = start + offset * SCSI_BLOCK_SIZE;
+    uint64_t data_end = data_start + count * SCSI_BLOCK_SIZE;
+    if(!image_write_zero(image->file, start, data_start - start)) return false;
+    if(!image_file_io(image->file, data_start, data, data_end - data_start, true)) return false;
+    if(!image_write_zero(image->file, data_end, end - data_end)) return false;
+    if(!storage_file_sync(image->file)) return false;
+    if(!image_file_io(
+           image->file,
+           sizeof(SparseHeader) + cluster * sizeof(uint16_t),
+           (uint8_t*)&slot,
+           sizeof(slot),
+           true))
+        return false;
+    image->map[cluster] = slot;
+    image->clusters_used = slot;
+    return true;
+}
+
+static bool image_sparse_io(
+    MassStorageImage* image,
+    uint32_t lba,
+    uint32_t count,
+    uint8_t* buf,
+    bool write) {
+    while(count) {
+        uint32_t cluster = lba / image->cluster_blocks;
+        uint32_t offset = lba % image->cluster_blocks;
+        uint32_t blocks = MIN(count, image->cluster_blocks - offset);
+        size_t size = blocks * SCSI_BLOCK_SIZE;
+        if(!image->map[cluster]) {
+            if(!write) {
+                memset(buf, 0, size);
+            } else if(!image_sparse_alloc(image, cluster, offset, blocks, buf)) {
+                return false;
+            }
+        } else {
+            uint64_t file_offset = image_cluster_offset(image, image->map[cluster]) +
+                                   offset * SCSI_BLOCK_SIZE;
+            if(!image_file_io(image->file, file_offset, buf, size, write)) return false;
+        }
+        lba += blocks;
+        count -= blocks;
+        buf += size;
+    }
+    return true;
+}
+
+bool mass_storage_image_read(MassStorageImage* image, uint32_t lba, uint32_t count, uint8_t* out) {
+    if(lba >= image->num_blocks || count > image->num_blocks - lba) return false;
+    if(image->map) return image_sparse_io(image, lba, count, out, false);
+    return image_file_io(
+        image->file, (uint64_t)lba * SCSI_BLOCK_SIZE, out, count * SCSI_BLOCK_SIZE, false);
+}
+
+bool mass_storage_image_write(
+    MassStorageImage* image,
+    uint32_t lba,
+    uint32_t count,
+    const uint8_t* data) {
+    if(lba >= image->num_blocks || count > image->num_blocks - lba) return false;
+    if(image->map) return image_sparse_io(image, lba, count, (uint8_t*)data, true);
+    return image_file_io(
+        image->file,
+        (uint64_t)lba * SCSI_BLOCK_SIZE,
+        (uint8_t*)data,
+        count * SCSI_BLOCK_SIZE,
+        true);
+}
+
+bool mass_storage_image_create_sparse(File* file, uint64_t size) {
+    uint32_t cluster_size = IMAGE_SPARSE_MIN_CLUSTER_SIZE;
+    while(size / cluster_size > IMAGE_SPARSE_MAX_CLUSTERS) cluster_size <<= 1;
+    SparseHeader header = {
+        .version = IMAGE_SPARSE_VERSION,
+        .cluster_size = cluster_size,
+        .cluster_count = size / cluster_size,
+    };
+    if(!header.cluster_count) return false;
+    memcpy(header.magic, IMAGE_SPARSE_MAGIC, sizeof(header.magic));
+    header.size = (uint64_t)header.cluster_count * cluster_size;
+    header.data_offset = image_sparse_data_offset(header.cluster_count);
+
+    if(!image_file_io(file, 0, (uint8_t*)&header, sizeof(header), true)) return false;
+    // empty cluster map, padded up to the first cluster
+    return image_write_zero(file, sizeof(header), header.data_offset - sizeof(header));
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <storage/storage.h>
+
+typedef struct MassStorageImage MassStorageImage;
+
+// Raw images are plain disk dumps. Sparse images start with a header and a cluster map,
+// clusters are appended to the file on first write and unallocated ones read as zero.
+MassStorageImage* mass_storage_image_open(File* file);
+// The file stays open, it belongs to the caller
+void mass_storage_image_close(MassStorageImage* image);
+
+uint32_t mass_storage_image_num_blocks(MassStorageImage* image);
+bool mass_storage_image_read(MassStorageImage* image, uint32_t lba, uint32_t count, uint8_t* out);
+bool mass_storage_image_write(
+    MassStorageImage* image,
+    uint32_t lba,
+    uint32_t count,
+    const uint8_t* data);
+
+// Writes an empty sparse image of size bytes (rounded down to whole clusters) to an open file
+bool mass_storage_image_create_sparse(File* file, uint64_t size);
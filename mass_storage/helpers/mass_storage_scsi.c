@@ -14,6 +14,34 @@
 #define SCSI_PREVENT_MEDIUM_REMOVAL (0x1E)
 #define SCSI_START_STOP_UNIT (0x1B)
 #define SCSI_WRITE_10 (0x2A)
+#define SCSI_SYNCHRONIZE_CACHE_10 (0x35)
+#define SCSI_READ_16 (0x88)
+#define SCSI_WRITE_16 (0x8A)
+#define SCSI_SERVICE_ACTION_IN_16 (0x9E)
+
+#define SCSI_SA_READ_CAPACITY_16 (0x10)
+
+static uint32_t scsi_get_be32(const uint8_t* data) {
+    return data[0] << 24 | data[1] << 16 | data[2] << 8 | data[3];
+}
+
+static void scsi_put_be32(uint8_t* data, uint32_t value) {
+    data[0] = value >> 24;
+    data[1] = value >> 16;
+    data[2] = value >> 8;
+    data[3] = value & 0xFF;
+}
+
+// 16 byte commands carry a 64 bit LBA, images never get past 32 bits of blocks
+static bool scsi_get_lba_16(SCSISession* scsi, const uint8_t* cmd, uint32_t* lba) {
+    if(scsi_get_be32(cmd + 2)) {
+        scsi->sk = SCSI_SK_ILLEGAL_REQUEST;
+        scsi->asc = SCSI_ASC_LBA_OOB;
+        return false;
+    }
+    *lba = scsi_get_be32(cmd + 6);
+    return true;
+}
 
 bool scsi_cmd_start(SCSISession* scsi, uint8_t* cmd, uint8_t len) {
     if(!len) {
@@ -29,16 +57,30 @@ bool scsi_cmd_start(SCSISession* scsi, uint8_t* cmd, uint8_t len) {
     switch(cmd[0]) {
     case SCSI_WRITE_10: {
         if(len < 10) return false;
-        scsi->write_10.lba = cmd[2] << 24 | cmd[3] << 16 | cmd[4] << 8 | cmd[5];
+        scsi->write_10.lba = scsi_get_be32(cmd + 2);
         scsi->write_10.count = cmd[7] << 8 | cmd[8];
-        FURI_LOG_D(TAG, "SCSI_WRITE_10 %08lX %04X", scsi->write_10.lba, scsi->write_10.count);
+        FURI_LOG_D(TAG, "SCSI_WRITE_10 %08lX %04lX", scsi->write_10.lba, scsi->write_10.count);
+        return true;
+    }; break;
+    case SCSI_WRITE_16: {
+        if(len < 16) return false;
+        if(!scsi_get_lba_16(scsi, cmd, &scsi->write_10.lba)) return false;
+        scsi->write_10.count = scsi_get_be32(cmd + 10);
+        FURI_LOG_D(TAG, "SCSI_WRITE_16 %08lX %08lX", scsi->write_10.lba, scsi->write_10.count);
         return true;
     }; break;
     case SCSI_READ_10: {
         if(len < 10) return false;
-        scsi->read_10.lba = cmd[2] << 24 | cmd[3] << 16 | cmd[4] << 8 | cmd[5];
+        scsi->read_10.lba = scsi_get_be32(cmd + 2);
         scsi->read_10.count = cmd[7] << 8 | cmd[8];
-        FURI_LOG_D(TAG, "SCSI_READ_10 %08lX %04X", scsi->read_10.lba, scsi->read_10.count);
+        FURI_LOG_D(TAG, "SCSI_READ_10 %08lX %04lX", scsi->read_10.lba, scsi->read_10.count);
+        return true;
+    }; break;
+    case SCSI_READ_16: {
+        if(len < 16) return false;
+        if(!scsi_get_lba_16(scsi, cmd, &scsi->read_10.lba)) return false;
+        scsi->read_10.count = scsi_get_be32(cmd + 10);
+        FURI_LOG_D(TAG, "SCSI_READ_16 %08lX %08lX", scsi->read_10.lba, scsi->read_10.count);
         return true;
     }; break;
     }
@@ -49,7 +91,8 @@ bool scsi_cmd_rx_data(SCSISession* scsi, uint8_t* data, uint32_t len) {
     FURI_LOG_T(TAG, "RX %02X len %lu", scsi->cmd[0], len);
     if(scsi->rx_done) return false;
     switch(scsi->cmd[0]) {
-    case SCSI_WRITE_10: {
+    case SCSI_WRITE_10:
+    case SCSI_WRITE_16: {
         uint32_t block_size = SCSI_BLOCK_SIZE;
         uint16_t blocks = len / block_size;
         bool result =
@@ -127,11 +170,18 @@ bool scsi_cmd_tx_data(SCSISession* scsi, uint8_t* data, uint32_t* len, uint32_t
             *len = 36;
             scsi->tx_done = true;
             return true;
-        } else {
-            if(page_code != 0x80) {
-                FURI_LOG_W(TAG, "Unsupported VPD code %02X", page_code);
-                return false;
-            }
+        } else if(page_code == 0x00) {
+            data[0] = 0x00;
+            data[1] = 0x00; // supported VPD pages
+            data[2] = 0x00;
+            data[3] = 0x03; // page list len
+            data[4] = 0x00;
+            data[5] = 0x80;
+            data[6] = 0xB0;
+            *len = 7;
+            scsi->tx_done = true;
+            return true;
+        } else if(page_code == 0x80) {
             data[0] = 0x00;
             data[1] = 0x80;
             data[2] = 0x00;
@@ -140,6 +190,20 @@ bool scsi_cmd_tx_data(SCSISession* scsi, uint8_t* data, uint32_t* len, uint32_t
             *len = 5;
             scsi->tx_done = true;
             return true;
+        } else if(page_code == 0xB0) {
+            memset(data, 0, 64);
+            data[1] = 0xB0; // block limits
+            data[3] = 0x3C; // page len
+            data[6] = SCSI_OPTIMAL_TRANSFER_GRANULARITY >> 8;
+            data[7] = SCSI_OPTIMAL_TRANSFER_GRANULARITY & 0xFF;
+            scsi_put_be32(data + 8, UINT16_MAX); // maximum transfer length
+            scsi_put_be32(data + 12, SCSI_OPTIMAL_TRANSFER_LENGTH);
+            *len = MIN(64UL, cap);
+            scsi->tx_done = true;
+            return true;
+        } else {
+            FURI_LOG_W(TAG, "Unsupported VPD code %02X", page_code);
+            return false;
         }
     }; break;
     case SCSI_READ_FORMAT_CAPACITIES: {
@@ -185,6 +249,18 @@ bool scsi_cmd_tx_data(SCSISession* scsi, uint8_t* data, uint32_t* len, uint32_t
         scsi->tx_done = true;
         return true;
     }; break;
+    case SCSI_SERVICE_ACTION_IN_16: {
+        if((scsi->cmd[1] & 0x1F) != SCSI_SA_READ_CAPACITY_16) return false;
+        FURI_LOG_D(TAG, "SCSI_READ_CAPACITY_16");
+        if(cap < 32) return false;
+        uint32_t n_blocks = scsi->fn.num_blocks(scsi->fn.ctx);
+        memset(data, 0, 32);
+        scsi_put_be32(data + 4, n_blocks - 1); // last LBA, upper 32 bits stay 0
+        scsi_put_be32(data + 8, SCSI_BLOCK_SIZE);
+        *len = 32;
+        scsi->tx_done = true;
+        return true;
+    }; break;
     case SCSI_MODE_SENSE_6: {
         FURI_LOG_D(TAG, "SCSI_MODE_SENSE_6 %lu", cap);
         if(cap < 4) return false;
@@ -196,10 +272,12 @@ bool scsi_cmd_tx_data(SCSISession* scsi, uint8_t* data, uint32_t* len, uint32_t
         scsi->tx_done = true;
         return true;
     }; break;
-    case SCSI_READ_10: {
+    case SCSI_READ_10:
+    case SCSI_READ_16: {
         uint32_t block_size = SCSI_BLOCK_SIZE;
-        bool result =
-            scsi->fn.read(scsi->fn.ctx, scsi->read_10.lba, scsi->read_10.count, data, len, cap);
+        // cap limits a single call far below this anyway
+        uint16_t count = MIN(scsi->read_10.count, UINT16_MAX);
+        bool result = scsi->fn.read(scsi->fn.ctx, scsi->read_10.lba, count, data, len, cap);
         *len -= *len % block_size;
         uint16_t blocks = *len / block_size;
         scsi->read_10.lba += blocks;
@@ -226,6 +304,7 @@ bool scsi_cmd_end(SCSISession* scsi) {
     scsi->cmd_len = 0;
     switch(cmd[0]) {
     case SCSI_WRITE_10:
+    case SCSI_WRITE_16:
         return scsi->rx_done;
 
     case SCSI_REQUEST_SENSE:
@@ -234,6 +313,8 @@ bool scsi_cmd_end(SCSISession* scsi) {
     case SCSI_READ_CAPACITY_10:
     case SCSI_MODE_SENSE_6:
     case SCSI_READ_10:
+    case SCSI_READ_16:
+    case SCSI_SERVICE_ACTION_IN_16:
         return scsi->tx_done;
 
     case SCSI_TEST_UNIT_READY: {
@@ -256,6 +337,10 @@ bool scsi_cmd_end(SCSISession* scsi) {
         }
         return true;
     }; break;
+    case SCSI_SYNCHRONIZE_CACHE_10: {
+        FURI_LOG_D(TAG, "SCSI_SYNCHRONIZE_CACHE_10");
+        return scsi->fn.sync(scsi->fn.ctx);
+    }; break;
     default: {
         FURI_LOG_W(TAG, "unexpected scsi cmd=%02X", cmd[0]);
         scsi->sk = SCSI_SK_ILLEGAL_REQUEST;
@@ -3,6 +3,10 @@
 #include <furi.h>
 
 #define SCSI_BLOCK_SIZE (0x200UL)
+// Reported in the Block Limits VPD page: transfers aligned to the 32 KB block cache chunk,
+// large enough to fill both 32 KB USB buffers several times per command
+#define SCSI_OPTIMAL_TRANSFER_GRANULARITY (64UL)
+#define SCSI_OPTIMAL_TRANSFER_LENGTH (256UL)
 
 #define SCSI_SK_ILLEGAL_REQUEST (5)
 
@@ -20,6 +24,7 @@ typedef struct {
         uint32_t* out_len,
         uint32_t out_cap);
     bool (*write)(void* ctx, uint32_t lba, uint16_t count, uint8_t* buf, uint32_t len);
+    bool (*sync)(void* ctx);
     uint32_t (*num_blocks)(void* ctx);
     void (*eject)(void* ctx);
 } SCSIDeviceFunc;
@@ -39,14 +44,14 @@ typedef struct {
     // valid from cmd_start to cmd_end
     union {
         struct {
-            uint16_t count;
+            uint32_t count;
             uint32_t lba;
-        } read_10; // SCSI_READ_10
+        } read_10; // SCSI_READ_10, SCSI_READ_16
 
         struct {
-            uint16_t count;
+            uint32_t count;
             uint32_t lba;
-        } write_10; // SCSI_WRITE_10
+        } write_10; // SCSI_WRITE_10, SCSI_WRITE_16
     };
 } SCSISession;
 
@@ -21,8 +21,8 @@
 #define CSW_STATUS_PHASE_ERROR (2)
 
 // must be SCSI_BLOCK_SIZE aligned
-// larger than 0x10000 exceeds size_t, storage_file_* ops fail
-#define USB_MSC_BUF_MAX (0x10000UL - SCSI_BLOCK_SIZE)
+// two of them are used to overlap storage reads with USB transfers
+#define USB_MSC_BUF_MAX (0x8000UL)
 
 static usbd_respond usb_ep_config(usbd_device* dev, uint8_t cfg);
 static usbd_respond usb_control(usbd_device* dev, usbd_ctlreq* req, usbd_rqc_callback* callback);
@@ -31,10 +31,18 @@ typedef enum {
     EventExit = 1 << 0,
     EventReset = 1 << 1,
     EventRxTx = 1 << 2,
+    EventIoDone = 1 << 3,
 
-    EventAll = EventExit | EventReset | EventRxTx,
+    EventAll = EventExit | EventReset | EventRxTx | EventIoDone,
 } MassStorageEvent;
 
+typedef enum {
+    IoEventExit = 1 << 0,
+    IoEventRead = 1 << 1,
+
+    IoEventAll = IoEventExit | IoEventRead,
+} MassStorageIoEvent;
+
 typedef struct {
     uint32_t sig;
     uint32_t tag;
@@ -61,6 +69,33 @@ struct MassStorageUsb {
     SCSIDeviceFunc fn;
 };
 
+// Device to host data is produced here, so the next chunk is read from storage
+// while the USB worker sends the previous one
+typedef struct {
+    FuriThread* thread;
+    FuriThreadId owner; // gets EventIoDone when a read is finished
+    SCSISession* scsi;
+
+    uint8_t* buf;
+    uint32_t cap;
+    uint32_t len;
+    bool result;
+} MassStorageIo;
+
+static int32_t mass_io_worker(void* context) {
+    MassStorageIo* io = context;
+    while(true) {
+        uint32_t flags = furi_thread_flags_wait(IoEventAll, FuriFlagWaitAny, FuriWaitForever);
+        if(flags & IoEventExit) break;
+        if(flags & IoEventRead) {
+            io->len = 0;
+            io->result = scsi_cmd_tx_data(io->scsi, io->buf, &io->len, io->cap);
+            furi_thread_flags_set(io->owner, EventIoDone);
+        }
+    }
+    return 0;
+}
+
 static int32_t mass_thread_worker(void* context) {
     MassStorageUsb* mass = context;
     usbd_device* dev = mass->dev;
@@ -69,8 +104,26 @@ static int32_t mass_thread_worker(void* context) {
     };
     CBW cbw = {0};
     CSW csw = {0};
-    uint8_t* buf = NULL;
-    uint32_t buf_len = 0, buf_cap = 0, buf_sent = 0;
+    uint8_t* buf[2] = {malloc(USB_MSC_BUF_MAX), malloc(USB_MSC_BUF_MAX)};
+    uint32_t buf_len = 0, buf_sent = 0;
+    // device to host: buf[tx_slot] is being sent, buf[io_slot] is filled next
+    uint32_t tx_len[2] = {0};
+    bool tx_ready[2] = {false};
+    uint8_t tx_slot = 0, io_slot = 0;
+    uint32_t io_left = 0;
+    bool io_busy = false, io_end = false;
+
+    MassStorageIo io = {
+        .owner = furi_thread_get_current_id(),
+        .scsi = &scsi,
+    };
+    io.thread = furi_thread_alloc();
+    furi_thread_set_name(io.thread, "MassStorageIo");
+    furi_thread_set_stack_size(io.thread, 1024);
+    furi_thread_set_context(io.thread, &io);
+    furi_thread_set_callback(io.thread, mass_io_worker);
+    furi_thread_start(io.thread);
+
     enum {
         StateReadCBW,
         StateReadData,
@@ -80,6 +133,22 @@ static int32_t mass_thread_worker(void* context) {
     } state = StateReadCBW;
     while(true) {
         uint32_t flags = furi_thread_flags_wait(EventAll, FuriFlagWaitAny, FuriWaitForever);
+        if(flags & EventIoDone) {
+            io_busy = false;
+            if(io.result && io.len) {
+                tx_len[io_slot] = io.len;
+                tx_ready[io_slot] = true;
+                io_left -= io.len;
+                io_slot ^= 1;
+            } else {
+                io_end = true;
+            }
+        }
+        if((flags & (EventExit | EventReset)) && io_busy) {
+            // the session and buffers are in use until the read is done
+            furi_thread_flags_wait(EventIoDone, FuriFlagWaitAny, FuriWaitForever);
+            io_busy = false;
+        }
         if(flags & EventExit) {
             FURI_LOG_D(TAG, "exit");
             break;
@@ -90,14 +159,10 @@ static int32_t mass_thread_worker(void* context) {
             scsi.asc = 0;
             memset(&cbw, 0, sizeof(cbw));
             memset(&csw, 0, sizeof(csw));
-            if(buf) {
-                free(buf);
-                buf = NULL;
-            }
-            buf_len = buf_cap = buf_sent = 0;
+            buf_len = buf_sent = 0;
             state = StateReadCBW;
         }
-        if(flags & EventRxTx) do {
+        if(flags & (EventRxTx | EventIoDone)) do {
                 switch(state) {
                 case StateReadCBW: {
                     FURI_LOG_T(TAG, "StateReadCBW");
@@ -122,8 +187,11 @@ static int32_t mass_thread_worker(void* context) {
                         continue;
                     }
                     if(cbw.flags & CBW_FLAGS_DEVICE_TO_HOST) {
-                        buf_len = 0;
                         buf_sent = 0;
+                        tx_ready[0] = tx_ready[1] = false;
+                        tx_slot = io_slot = 0;
+                        io_left = cbw.len;
+                        io_end = false;
                         state = StateWriteData;
                     } else {
                         buf_len = 0;
@@ -138,17 +206,9 @@ static int32_t mass_thread_worker(void* context) {
                         continue;
                     }
                     uint32_t buf_clamp = MIN(cbw.len, USB_MSC_BUF_MAX);
-                    if(buf_clamp > buf_cap) {
-                        FURI_LOG_T(TAG, "growing buf %lu -> %lu", buf_cap, buf_clamp);
-                        if(buf) {
-                            free(buf);
-                        }
-                        buf_cap = buf_clamp;
-                        buf = malloc(buf_cap);
-                    }
                     if(buf_len < buf_clamp) {
-                        int32_t len =
-                            usbd_ep_read(dev, USB_MSC_RX_EP, buf + buf_len, buf_clamp - buf_len);
+                        int32_t len = usbd_ep_read(
+                            dev, USB_MSC_RX_EP, buf[0] + buf_len, buf_clamp - buf_len);
                         if(len < 0) {
                             FURI_LOG_T(TAG, "rx not ready %ld", len);
                             break;
@@ -157,7 +217,7 @@ static int32_t mass_thread_worker(void* context) {
                         buf_len += len;
                     }
                     if(buf_len == buf_clamp) {
-                        if(!scsi_cmd_rx_data(&scsi, buf, buf_len)) {
+                        if(!scsi_cmd_rx_data(&scsi, buf[0], buf_len)) {
                             FURI_LOG_W(TAG, "short rx");
                             usbd_ep_stall(dev, USB_MSC_RX_EP);
                             csw.sig = CSW_SIG;
@@ -178,16 +238,18 @@ static int32_t mass_thread_worker(void* context) {
                         state = StateBuildCSW;
                         continue;
                     }
-                    uint32_t buf_clamp = MIN(cbw.len, USB_MSC_BUF_MAX);
-                    if(buf_clamp > buf_cap) {
-                        FURI_LOG_T(TAG, "growing buf %lu -> %lu", buf_cap, buf_clamp);
-                        if(buf) {
-                            free(buf);
-                        }
-                        buf_cap = buf_clamp;
-                        buf = malloc(buf_cap);
+                    // keep the storage worker busy while the other buffer goes out
+                    if(!io_busy && !io_end && io_left && !tx_ready[io_slot]) {
+                        io.buf = buf[io_slot];
+                        io.cap = MIN(io_left, USB_MSC_BUF_MAX);
+                        io_busy = true;
+                        furi_thread_flags_set(furi_thread_get_id(io.thread), IoEventRead);
                     }
-                    if(!buf_len && !scsi_cmd_tx_data(&scsi, buf, &buf_len, buf_clamp)) {
+                    if(!tx_ready[tx_slot]) {
+                        if(io_busy) {
+                            FURI_LOG_T(TAG, "waiting for storage");
+                            break;
+                        }
                         FURI_LOG_W(TAG, "short tx");
                         // usbd_ep_stall(dev, USB_MSC_TX_EP);
                         state = StateBuildCSW;
@@ -196,16 +258,17 @@ static int32_t mass_thread_worker(void* context) {
                     int32_t len = usbd_ep_write(
                         dev,
                         USB_MSC_TX_EP,
-                        buf + buf_sent,
-                        MIN(USB_MSC_TX_EP_SIZE, buf_len - buf_sent));
+                        buf[tx_slot] + buf_sent,
+                        MIN(USB_MSC_TX_EP_SIZE, tx_len[tx_slot] - buf_sent));
                     if(len < 0) {
                         FURI_LOG_T(TAG, "tx not ready %ld", len);
                         break;
                     }
                     buf_sent += len;
-                    if(buf_sent == buf_len) {
-                        cbw.len -= buf_len;
-                        buf_len = 0;
+                    if(buf_sent == tx_len[tx_slot]) {
+                        cbw.len -= tx_len[tx_slot];
+                        tx_ready[tx_slot] = false;
+                        tx_slot ^= 1;
                         buf_sent = 0;
                     }
                     continue;
@@ -253,9 +316,11 @@ static int32_t mass_thread_worker(void* context) {
                 break;
             } while(true);
     }
-    if(buf) {
-        free(buf);
-    }
+    furi_thread_flags_set(furi_thread_get_id(io.thread), IoEventExit);
+    furi_thread_join(io.thread);
+    furi_thread_free(io.thread);
+    free(buf[0]);
+    free(buf[1]);
     return 0;
 }
 
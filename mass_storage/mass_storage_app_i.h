@@ -3,6 +3,7 @@
 #include "mass_storage_app.h"
 #include "scenes/mass_storage_scene.h"
 #include "helpers/mass_storage_usb.h"
+#include "helpers/mass_storage_cache.h"
 
 #include <furi_hal.h>
 #include <gui/gui.h>
@@ -37,6 +38,9 @@ struct MassStorageApp {
 
     FuriString* file_path;
     File* file;
+    MassStorageImage* image;
+    MassStorageCache* cache;
+    uint32_t io_tick;
     MassStorage* mass_storage_view;
 
     FuriMutex* usb_mutex;
@@ -44,6 +48,7 @@ struct MassStorageApp {
 
     uint64_t create_image_max;
     uint8_t create_image_size;
+    bool create_image_sparse;
     char create_image_name[MASS_STORAGE_FILE_NAME_LEN];
 
     uint32_t bytes_read, bytes_written;
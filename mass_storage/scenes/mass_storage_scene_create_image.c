@@ -3,6 +3,7 @@
 
 enum VarItemListIndex {
     VarItemListIndexImageSize,
+    VarItemListIndexImageType,
     VarItemListIndexImageName,
     VarItemListIndexCreateImage,
 };
@@ -43,6 +44,14 @@ static void mass_storage_scene_create_image_image_size_changed(VariableItem* ite
     variable_item_set_current_value_text(item, image_sizes[app->create_image_size].name);
 }
 
+static const char* const image_types[] = {"Raw", "Sparse"};
+
+static void mass_storage_scene_create_image_image_type_changed(VariableItem* item) {
+    MassStorageApp* app = variable_item_get_context(item);
+    app->create_image_sparse = variable_item_get_current_value_index(item);
+    variable_item_set_current_value_text(item, image_types[app->create_image_sparse]);
+}
+
 void mass_storage_scene_create_image_on_enter(void* context) {
     MassStorageApp* app = context;
     VariableItemList* variable_item_list = app->variable_item_list;
@@ -69,6 +78,15 @@ void mass_storage_scene_create_image_on_enter(void* context) {
     variable_item_set_current_value_index(item, app->create_image_size);
     variable_item_set_current_value_text(item, image_sizes[app->create_image_size].name);
 
+    item = variable_item_list_add(
+        variable_item_list,
+        "Image Type",
+        COUNT_OF(image_types),
+        mass_storage_scene_create_image_image_type_changed,
+        app);
+    variable_item_set_current_value_index(item, app->create_image_sparse);
+    variable_item_set_current_value_text(item, image_types[app->create_image_sparse]);
+
     item = variable_item_list_add(variable_item_list, "Image Name", 0, NULL, app);
     variable_item_set_current_value_text(item, app->create_image_name);
 
@@ -139,6 +157,12 @@ bool mass_storage_scene_create_image_on_event(void* context, SceneManagerEvent e
 
                 uint64_t size = image_sizes[app->create_image_size].value;
                 if(size == app->create_image_max) size--;
+                if(app->create_image_sparse) {
+                    // clusters are allocated on first write, nothing to wipe
+                    if(!mass_storage_image_create_sparse(app->file, size)) break;
+                    success = true;
+                    break;
+                }
                 if(!storage_file_expand(app->file, size)) break;
 
                 // Zero out first 4k - partition table and adjacent data
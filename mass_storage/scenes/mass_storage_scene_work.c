@@ -5,6 +5,9 @@
 
 #define TAG "MassStorageSceneWork"
 
+// Pending writes are flushed once the host has been idle for this long
+#define WORK_CACHE_IDLE_FLUSH_MS (1000)
+
 static bool file_read(
     void* ctx,
     uint32_t lba,
@@ -14,15 +17,14 @@ static bool file_read(
     uint32_t out_cap) {
     MassStorageApp* app = ctx;
     FURI_LOG_T(TAG, "file_read lba=%08lX count=%04X out_cap=%08lX", lba, count, out_cap);
-    if(!storage_file_seek(app->file, lba * SCSI_BLOCK_SIZE, true)) {
-        FURI_LOG_W(TAG, "seek failed");
-        return false;
-    }
-    uint16_t clamp = MIN(out_cap, count * SCSI_BLOCK_SIZE);
-    *out_len = storage_file_read(app->file, out, clamp);
-    FURI_LOG_T(TAG, "%lu/%lu", *out_len, count * SCSI_BLOCK_SIZE);
+    uint32_t blocks = MIN(out_cap, count * SCSI_BLOCK_SIZE) / SCSI_BLOCK_SIZE;
+    furi_mutex_acquire(app->usb_mutex, FuriWaitForever);
+    bool result = mass_storage_cache_read(app->cache, lba, blocks, out);
+    app->io_tick = furi_get_tick();
+    furi_mutex_release(app->usb_mutex);
+    *out_len = result ? blocks * SCSI_BLOCK_SIZE : 0;
     app->bytes_read += *out_len;
-    return *out_len == clamp;
+    return result;
 }
 
 static bool file_write(void* ctx, uint32_t lba, uint16_t count, uint8_t* buf, uint32_t len) {
@@ -32,22 +34,31 @@ static bool file_write(void* ctx, uint32_t lba, uint16_t count, uint8_t* buf, ui
         FURI_LOG_W(TAG, "bad write params count=%u len=%lu", count, len);
         return false;
     }
-    if(!storage_file_seek(app->file, lba * SCSI_BLOCK_SIZE, true)) {
-        FURI_LOG_W(TAG, "seek failed");
-        return false;
-    }
-    app->bytes_written += len;
-    return storage_file_write(app->file, buf, len) == len;
+    furi_mutex_acquire(app->usb_mutex, FuriWaitForever);
+    bool result = mass_storage_cache_write(app->cache, lba, count, buf);
+    app->io_tick = furi_get_tick();
+    furi_mutex_release(app->usb_mutex);
+    if(result) app->bytes_written += len;
+    return result;
+}
+
+static bool file_sync(void* ctx) {
+    MassStorageApp* app = ctx;
+    furi_mutex_acquire(app->usb_mutex, FuriWaitForever);
+    bool result = mass_storage_cache_flush(app->cache);
+    furi_mutex_release(app->usb_mutex);
+    return result;
 }
 
 static uint32_t file_num_blocks(void* ctx) {
     MassStorageApp* app = ctx;
-    return storage_file_size(app->file) / SCSI_BLOCK_SIZE;
+    return mass_storage_image_num_blocks(app->image);
 }
 
 static void file_eject(void* ctx) {
     MassStorageApp* app = ctx;
     FURI_LOG_D(TAG, "EJECT");
+    file_sync(app);
     view_dispatcher_send_custom_event(app->view_dispatcher, MassStorageCustomEventEject);
 }
 
@@ -65,6 +76,14 @@ bool mass_storage_scene_work_on_event(void* context, SceneManagerEvent event) {
         }
     } else if(event.type == SceneManagerEventTypeTick) {
         mass_storage_set_stats(app->mass_storage_view, app->bytes_read, app->bytes_written);
+        // hosts that don't send SYNCHRONIZE CACHE can be unplugged at any time
+        if(app->cache) {
+            furi_mutex_acquire(app->usb_mutex, FuriWaitForever);
+            if(furi_get_tick() - app->io_tick > furi_ms_to_ticks(WORK_CACHE_IDLE_FLUSH_MS)) {
+                mass_storage_cache_flush(app->cache);
+            }
+            furi_mutex_release(app->usb_mutex);
+        }
     } else if(event.type == SceneManagerEventTypeBack) {
         consumed = scene_manager_search_and_switch_to_previous_scene(
             app->scene_manager, MassStorageSceneFileSelect);
@@ -100,11 +119,14 @@ void mass_storage_scene_work_on_enter(void* context) {
         furi_string_get_cstr(app->file_path),
         FSAM_READ | FSAM_WRITE,
         FSOM_OPEN_EXISTING));
+    app->image = mass_storage_image_open(app->file);
+    app->cache = mass_storage_cache_alloc(app->image);
 
     SCSIDeviceFunc fn = {
         .ctx = app,
         .read = file_read,
         .write = file_write,
+        .sync = file_sync,
         .num_blocks = file_num_blocks,
         .eject = file_eject,
     };
@@ -121,14 +143,22 @@ void mass_storage_scene_work_on_exit(void* context) {
     MassStorageApp* app = context;
     mass_storage_app_show_loading_popup(app, true);
 
-    if(app->usb_mutex) {
-        furi_mutex_free(app->usb_mutex);
-        app->usb_mutex = NULL;
-    }
     if(app->usb) {
         mass_storage_usb_stop(app->usb);
         app->usb = NULL;
     }
+    if(app->cache) {
+        mass_storage_cache_free(app->cache);
+        app->cache = NULL;
+    }
+    if(app->image) {
+        mass_storage_image_close(app->image);
+        app->image = NULL;
+    }
+    if(app->usb_mutex) {
+        furi_mutex_free(app->usb_mutex);
+        app->usb_mutex = NULL;
+    }
     if(app->file) {
         storage_file_free(app->file);
         app->file = NULL;
@@ -128,16 +128,6 @@ static uint32_t camera_exit(void* context) {
     return VIEW_NONE;
 }
 
-static void camera_on_irq_cb(UartIrqEvent ev, uint8_t data, void* context) {
-    furi_assert(context);
-    UartEchoApp* app = context;
-
-    if(ev == UartIrqEventRXNE) {
-        furi_stream_buffer_send(app->rx_stream, &data, 1, 0);
-        furi_thread_flags_set(furi_thread_get_id(app->worker_thread), WorkerEventRx);
-    }
-}
-
 static void process_ringbuffer(UartDumpModel* model, uint8_t byte) {
     //// 1. Phase: filling the ringbuffer
     if(model->ringbuffer_index == 0 && byte != 'Y') { // First char has to be 'Y' in the buffer.
@@ -190,7 +180,7 @@ static int32_t camera_worker(void* context) {
             do {
                 size_t intended_data_size = 64;
                 uint8_t data[intended_data_size];
-                length = furi_stream_buffer_receive(app->rx_stream, data, intended_data_size, 0);
+                length = uart_dma_receive(app->rx_dma, data, intended_data_size);
 
                 if(length > 0) {
                     //furi_hal_uart_tx(FuriHalUartIdUSART1, data, length);
@@ -218,7 +208,7 @@ static int32_t camera_worker(void* context) {
 static UartEchoApp* camera_app_alloc() {
     UartEchoApp* app = malloc(sizeof(UartEchoApp));
 
-    app->rx_stream = furi_stream_buffer_alloc(2048, 1);
+    app->rx_dma = uart_dma_alloc(2048);
 
     // Gui
     app->gui = furi_record_open(RECORD_GUI);
@@ -256,7 +246,8 @@ static UartEchoApp* camera_app_alloc() {
     // Enable uart listener
     furi_hal_console_disable();
     furi_hal_uart_set_br(FuriHalUartIdUSART1, 230400);
-    furi_hal_uart_set_irq_cb(FuriHalUartIdUSART1, camera_on_irq_cb, app);
+    uart_dma_start(
+        app->rx_dma, FuriHalUartIdUSART1, furi_thread_get_id(app->worker_thread), WorkerEventRx);
 
     furi_hal_power_disable_external_3_3v();
     furi_hal_power_disable_otg();
@@ -274,7 +265,8 @@ static UartEchoApp* camera_app_alloc() {
 static void camera_app_free(UartEchoApp* app) {
     furi_assert(app);
 
-    furi_hal_console_enable(); // this will also clear IRQ callback so thread is no longer referenced
+    uart_dma_stop(app->rx_dma); // clears the IRQ callback so thread is no longer referenced
+    furi_hal_console_enable();
 
     furi_thread_flags_set(furi_thread_get_id(app->worker_thread), WorkerEventStop);
     furi_thread_join(app->worker_thread);
@@ -291,7 +283,7 @@ static void camera_app_free(UartEchoApp* app) {
     furi_record_close(RECORD_NOTIFICATION);
     app->gui = NULL;
 
-    furi_stream_buffer_free(app->rx_stream);
+    uart_dma_free(app->rx_dma);
 
     // Free rest
     free(app);
@@ -21,6 +21,8 @@
 #include <storage/filesystem_api_defines.h>
 #include <storage/storage.h>
 
+#include "uart_dma.h"
+
 #define THREAD_ALLOC 2048
 
 #define FRAME_WIDTH 128
@@ -73,7 +75,7 @@ typedef struct {
     ViewDispatcher* view_dispatcher;
     View* view;
     FuriThread* worker_thread;
-    FuriStreamBuffer* rx_stream;
+    UartDma* rx_dma;
 } UartEchoApp;
 
 struct UartDumpModel {
@@ -0,0 +1,250 @@
+#include "morse.h"
+
+#include <string.h>
+
+// a unit at 1 wpm
+#define MORSE_UNIT_US 1200000
+// PARIS has 31 units of marks and gaps inside the characters, 19 between them
+#define MORSE_CHAR_UNITS 31
+#define MORSE_SPACE_UNITS 19
+
+#define MORSE_MIN_WPM 3
+#define MORSE_MAX_WPM 80
+// longer gaps are pauses, they don't say anything about the sender's timing
+#define MORSE_MAX_GAP_DOTS 100
+
+#define MORSE_KMEANS_ROUNDS 8
+
+static const char* const morse_codes[64] = {
+    ['A' - ' '] = ".-",      ['B' - ' '] = "-...",    ['C' - ' '] = "-.-.",
+    ['D' - ' '] = "-..",     ['E' - ' '] = ".",       ['F' - ' '] = "..-.",
+    ['G' - ' '] = "--.",     ['H' - ' '] = "....",    ['I' - ' '] = "..",
+    ['J' - ' '] = ".---",    ['K' - ' '] = "-.-",     ['L' - ' '] = ".-..",
+    ['M' - ' '] = "--",      ['N' - ' '] = "-.",      ['O' - ' '] = "---",
+    ['P' - ' '] = ".--.",    ['Q' - ' '] = "--.-",    ['R' - ' '] = ".-.",
+    ['S' - ' '] = "...",     ['T' - ' '] = "-",       ['U' - ' '] = "..-",
+    ['V' - ' '] = "...-",    ['W' - ' '] = ".--",     ['X' - ' '] = "-..-",
+    ['Y' - ' '] = "-.--",    ['Z' - ' '] = "--..",    ['0' - ' '] = "-----",
+    ['1' - ' '] = ".----",   ['2' - ' '] = "..---",   ['3' - ' '] = "...--",
+    ['4' - ' '] = "....-",   ['5' - ' '] = ".....",   ['6' - ' '] = "-....",
+    ['7' - ' '] = "--...",   ['8' - ' '] = "---..",   ['9' - ' '] = "----.",
+    ['.' - ' '] = ".-.-.-",  [',' - ' '] = "--..--",  ['?' - ' '] = "..--..",
+    ['\'' - ' '] = ".----.", ['!' - ' '] = "-.-.--",  ['/' - ' '] = "-..-.",
+    ['(' - ' '] = "-.--.",   [')' - ' '] = "-.--.-",  ['&' - ' '] = ".-...",
+    [':' - ' '] = "---...",  [';' - ' '] = "-.-.-.",  ['=' - ' '] = "-...-",
+    ['+' - ' '] = ".-.-.",   ['-' - ' '] = "-....-",  ['_' - ' '] = "..--.-",
+    ['"' - ' '] = ".-..-.",  ['$' - ' '] = "...-..-", ['@' - ' '] = ".--.-.",
+};
+
+void morse_timing_init(MorseTiming* timing, uint8_t char_wpm, uint8_t wpm) {
+    furi_assert(char_wpm > 0);
+    if(wpm == 0 || wpm > char_wpm) wpm = char_wpm;
+
+    timing->dot_us = MORSE_UNIT_US / char_wpm;
+    timing->dash_us = timing->dot_us * 3;
+    timing->element_gap_us = timing->dot_us;
+
+    // what is left of a PARIS word at the overall speed goes to the gaps
+    uint32_t word_us = MORSE_UNIT_US * 50 / wpm;
+    uint32_t space_unit_us = (word_us - timing->dot_us * MORSE_CHAR_UNITS) / MORSE_SPACE_UNITS;
+    timing->char_gap_us = space_unit_us * 3;
+    timing->word_gap_us = space_unit_us * 7;
+}
+
+const char* morse_code(char c) {
+    if(c >= 'a' && c <= 'z') c -= 'a' - 'A';
+    if(c < ' ' || c >= ' ' + (char)COUNT_OF(morse_codes)) return NULL;
+    return morse_codes[c - ' '];
+}
+
+void morse_encoder_init(MorseEncoder* encoder, const char* text, const MorseTiming* timing) {
+    furi_assert(text);
+    encoder->timing = *timing;
+    encoder->text = text;
+    encoder->position = 0;
+    encoder->code = NULL;
+    encoder->gap_us = 0;
+    encoder->sent = false;
+}
+
+bool morse_encoder_next(MorseEncoder* encoder, bool* on, uint32_t* us) {
+    const MorseTiming* timing = &encoder->timing;
+
+    while(!encoder->code || !*encoder->code) {
+        char c = encoder->text[encoder->position];
+        if(!c) return false;
+        encoder->position++;
+
+        if(c == ' ') {
+            if(encoder->sent) encoder->gap_us = MAX(encoder->gap_us, timing->word_gap_us);
+            encoder->code = NULL;
+        } else {
+            encoder->code = morse_code(c);
+        }
+    }
+
+    if(encoder->gap_us) {
+        *on = false;
+        *us = encoder->gap_us;
+        encoder->gap_us = 0;
+        return true;
+    }
+
+    char element = *encoder->code++;
+    *on = true;
+    *us = element == '-' ? timing->dash_us : timing->dot_us;
+    encoder->gap_us = *encoder->code ? timing->element_gap_us : timing->char_gap_us;
+    encoder->sent = true;
+    return true;
+}
+
+// One dimensional k-means with two clusters, started from the extremes. low_count gets the
+// size of the lower cluster.
+static void morse_kmeans(
+    const uint32_t* values,
+    uint8_t count,
+    uint32_t* low,
+    uint32_t* high,
+    uint8_t* low_count) {
+    *low = values[0];
+    *high = values[0];
+    for(uint8_t i = 1; i < count; i++) {
+        if(values[i] < *low) *low = values[i];
+        if(values[i] > *high) *high = values[i];
+    }
+
+    *low_count = count;
+    for(uint8_t round = 0; round < MORSE_KMEANS_ROUNDS; round++) {
+        uint32_t threshold = *low + (*high - *low) / 2;
+        uint64_t low_sum = 0;
+        uint64_t high_sum = 0;
+        *low_count = 0;
+        for(uint8_t i = 0; i < count; i++) {
+            if(values[i] <= threshold) {
+                low_sum += values[i];
+                (*low_count)++;
+            } else {
+                high_sum += values[i];
+            }
+        }
+
+        uint32_t new_low = *low_count ? low_sum / *low_count : *low;
+        uint32_t new_high = *low_count < count ? high_sum / (count - *low_count) : *high;
+        if(new_low == *low && new_high == *high) break;
+        *low = new_low;
+        *high = new_high;
+    }
+}
+
+static void morse_decoder_add(uint32_t* history, uint8_t* count, uint8_t* next, uint32_t us) {
+    history[*next] = us;
+    *next = (*next + 1) % MORSE_DECODER_HISTORY;
+    if(*count < MORSE_DECODER_HISTORY) (*count)++;
+}
+
+static void morse_decoder_update_dot(MorseDecoder* decoder) {
+    uint32_t low;
+    uint32_t high;
+    uint8_t low_count;
+    uint8_t count = decoder->mark_count;
+    morse_kmeans(decoder->marks, count, &low, &high, &low_count);
+
+    uint32_t dot_us;
+    if(high >= low * 2) {
+        // dots and dashes, a dash is worth three dots
+        dot_us = ((uint64_t)low * low_count + (uint64_t)(high / 3) * (count - low_count)) / count;
+    } else {
+        // only one kind lately, whichever the old estimate says it is
+        uint32_t mean = ((uint64_t)low * low_count + (uint64_t)high * (count - low_count)) / count;
+        dot_us = mean < decoder->dot_us * 2 ? mean : mean / 3;
+    }
+    decoder->dot_us = CLAMP(dot_us, MORSE_UNIT_US / MORSE_MIN_WPM, MORSE_UNIT_US / MORSE_MAX_WPM);
+}
+
+static void morse_decoder_update_word_threshold(MorseDecoder* decoder) {
+    uint32_t low;
+    uint32_t high;
+    uint8_t low_count;
+    morse_kmeans(decoder->gaps, decoder->gap_count, &low, &high, &low_count);
+
+    // word gaps are 7 units to the 3 of character gaps, even stretched ones
+    if(high * 2 >= low * 3) {
+        decoder->word_threshold_us = low + (high - low) / 2;
+        decoder->word_split = true;
+    } else if(!decoder->word_split) {
+        decoder->word_threshold_us = decoder->dot_us * 5;
+    }
+}
+
+static uint8_t morse_decoder_end_char(MorseDecoder* decoder, char* text) {
+    if(!decoder->code_length) return 0;
+
+    char elements[MORSE_MAX_ELEMENTS + 1];
+    char decoded = '*';
+    if(decoder->code_length <= MORSE_MAX_ELEMENTS) {
+        for(uint8_t i = 0; i < decoder->code_length; i++) {
+            elements[i] = decoder->code[i] < decoder->dot_us * 2 ? '.' : '-';
+        }
+        elements[decoder->code_length] = '\0';
+
+        for(uint8_t i = 0; i < COUNT_OF(morse_codes); i++) {
+            if(morse_codes[i] && strcmp(morse_codes[i], elements) == 0) {
+                decoded = ' ' + i;
+                break;
+            }
+        }
+    }
+
+    decoder->code_length = 0;
+    text[0] = decoded;
+    return 1;
+}
+
+void morse_decoder_init(MorseDecoder* decoder, uint8_t wpm) {
+    memset(decoder, 0, sizeof(MorseDecoder));
+    decoder->dot_us = MORSE_UNIT_US / wpm;
+    decoder->word_threshold_us = decoder->dot_us * 5;
+    decoder->idle = true;
+}
+
+uint8_t morse_decoder_feed(MorseDecoder* decoder, bool mark, uint32_t us, char* text) {
+    if(mark) {
+        decoder->idle = false;
+        morse_decoder_add(decoder->marks, &decoder->mark_count, &decoder->mark_next, us);
+        morse_decoder_update_dot(decoder);
+        if(decoder->code_length <= MORSE_MAX_ELEMENTS) {
+            decoder->code[decoder->code_length++] = us;
+        }
+        return 0;
+    }
+
+    // gaps inside a character are a single unit
+    if(us < decoder->dot_us * 2) return 0;
+    if(us < decoder->dot_us * MORSE_MAX_GAP_DOTS) {
+        morse_decoder_add(decoder->gaps, &decoder->gap_count, &decoder->gap_next, us);
+        morse_decoder_update_word_threshold(decoder);
+    }
+    // after a flush the gap only teaches the timing
+    if(decoder->idle) return 0;
+
+    uint8_t length = morse_decoder_end_char(decoder, text);
+    if(us >= decoder->word_threshold_us) text[length++] = ' ';
+    return length;
+}
+
+uint8_t morse_decoder_flush(MorseDecoder* decoder, char* text) {
+    if(decoder->idle) return 0;
+    decoder->idle = true;
+
+    uint8_t length = morse_decoder_end_char(decoder, text);
+    text[length++] = ' ';
+    return length;
+}
+
+uint32_t morse_decoder_get_word_gap(MorseDecoder* decoder) {
+    return decoder->word_threshold_us;
+}
+
+uint8_t morse_decoder_get_wpm(MorseDecoder* decoder) {
+    return MORSE_UNIT_US / decoder->dot_us;
+}
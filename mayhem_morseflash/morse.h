@@ -0,0 +1,75 @@
+#pragma once
+
+#include <furi.h>
+
+// Morse timing follows the PARIS standard: a word is 50 units, so a unit lasts 1.2 s / wpm.
+// With Farnsworth timing the characters keep their speed and only the gaps between
+// characters and words are stretched to bring the overall speed down.
+
+#define MORSE_MAX_ELEMENTS 7
+#define MORSE_DECODER_HISTORY 16
+
+typedef struct {
+    uint32_t dot_us;
+    uint32_t dash_us;
+    uint32_t element_gap_us;
+    uint32_t char_gap_us;
+    uint32_t word_gap_us;
+} MorseTiming;
+
+// Turns text into a stream of on and off times, one piece at a time so it can run from an
+// interrupt without a buffer. Characters without a code are skipped.
+typedef struct {
+    MorseTiming timing;
+    const char* text;
+    size_t position;
+    const char* code; // elements left of the character being sent
+    uint32_t gap_us; // off time before the next mark
+    bool sent;
+} MorseEncoder;
+
+// Classifies marks and gaps, the dot length follows the sender. Marks split into dots and
+// dashes and long gaps into character and word gaps by clustering the recent ones.
+typedef struct {
+    uint32_t marks[MORSE_DECODER_HISTORY];
+    uint8_t mark_count;
+    uint8_t mark_next;
+    uint32_t gaps[MORSE_DECODER_HISTORY];
+    uint8_t gap_count;
+    uint8_t gap_next;
+
+    uint32_t dot_us;
+    uint32_t word_threshold_us;
+    bool word_split; // character and word gaps have been told apart
+
+    uint32_t code[MORSE_MAX_ELEMENTS + 1]; // marks of the character being received
+    uint8_t code_length;
+    bool idle; // the line went quiet, the word is done
+} MorseDecoder;
+
+// wpm is the overall speed, it only makes a difference when below char_wpm
+void morse_timing_init(MorseTiming* timing, uint8_t char_wpm, uint8_t wpm);
+
+// Dots and dashes of a character, NULL if it has none
+const char* morse_code(char c);
+
+// The text has to stay around while the encoder is in use
+void morse_encoder_init(MorseEncoder* encoder, const char* text, const MorseTiming* timing);
+
+// Next piece of the stream, false at the end. It starts with a mark and alternates, trailing
+// gaps are left out.
+bool morse_encoder_next(MorseEncoder* encoder, bool* on, uint32_t* us);
+
+void morse_decoder_init(MorseDecoder* decoder, uint8_t wpm);
+
+// Feeds a mark or the gap after it. Decoded characters go to text, a word gap adds a space.
+// Returns the number of characters written, at most 2.
+uint8_t morse_decoder_feed(MorseDecoder* decoder, bool mark, uint32_t us, char* text);
+
+// The line has been quiet for a while: ends the character and the word
+uint8_t morse_decoder_flush(MorseDecoder* decoder, char* text);
+
+// How long the line has to be quiet to end a word
+uint32_t morse_decoder_get_word_gap(MorseDecoder* decoder);
+
+uint8_t morse_decoder_get_wpm(MorseDecoder* decoder);
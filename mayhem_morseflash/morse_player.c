@@ -0,0 +1,161 @@
+#include "morse_player.h"
+
+#include <furi_hal.h>
+#include <furi_hal_bus.h>
+#include <furi_hal_interrupt.h>
+#include <stm32wbxx_ll_tim.h>
+
+#define MORSE_PLAYER_PIN (&gpio_ext_pa7)
+#define MORSE_PLAYER_LIGHTS (LightRed | LightGreen | LightBlue)
+#define MORSE_TONE_FREQ 700.0f
+#define MORSE_TONE_VOLUME 1.0f
+// the first mark is scheduled this far ahead of the start
+#define START_DELAY_US 100
+
+typedef enum {
+    PlayerEvtStop = (1 << 0),
+    PlayerEvtKey = (1 << 1),
+    PlayerEvtDone = (1 << 2),
+} PlayerEvtFlags;
+
+#define PLAYER_ALL_EVENTS (PlayerEvtStop | PlayerEvtKey | PlayerEvtDone)
+
+struct MorsePlayer {
+    MorsePlayerCallback callback;
+    void* context;
+    FuriThread* thread;
+    bool running;
+    bool speaker;
+
+    MorseEncoder encoder;
+    uint32_t next_change; // absolute TIM2 count in us
+    volatile bool on;
+};
+
+static void morse_player_key(MorsePlayer* player, bool on) {
+    if(player->speaker) {
+        if(on) {
+            furi_hal_speaker_start(MORSE_TONE_FREQ, MORSE_TONE_VOLUME);
+        } else {
+            furi_hal_speaker_stop();
+        }
+    }
+    furi_hal_gpio_write(MORSE_PLAYER_PIN, on);
+
+    // the LED driver sits on I2C, which can't be used from an interrupt
+    player->on = on;
+    furi_thread_flags_set(furi_thread_get_id(player->thread), PlayerEvtKey);
+}
+
+static void morse_player_isr(void* context) {
+    MorsePlayer* player = context;
+    if(!LL_TIM_IsActiveFlag_CC1(TIM2)) return;
+    LL_TIM_ClearFlag_CC1(TIM2);
+
+    while(true) {
+        bool on;
+        uint32_t us;
+        if(!morse_encoder_next(&player->encoder, &on, &us)) {
+            morse_player_key(player, false);
+            LL_TIM_DisableIT_CC1(TIM2);
+            furi_thread_flags_set(furi_thread_get_id(player->thread), PlayerEvtDone);
+            return;
+        }
+        morse_player_key(player, on);
+
+        // the compare only fires on an exact match, a deadline that went by while it was
+        // being set is handled right here
+        player->next_change += us;
+        LL_TIM_OC_SetCompareCH1(TIM2, player->next_change);
+        if((int32_t)(player->next_change - TIM2->CNT) > 0) break;
+    }
+}
+
+static int32_t morse_player_worker(void* context) {
+    MorsePlayer* player = context;
+
+    while(1) {
+        uint32_t events =
+            furi_thread_flags_wait(PLAYER_ALL_EVENTS, FuriFlagWaitAny, FuriWaitForever);
+        furi_check((events & FuriFlagError) == 0);
+        if(events & PlayerEvtKey) {
+            furi_hal_light_set(MORSE_PLAYER_LIGHTS, player->on ? 0xFF : 0x00);
+        }
+        if(events & PlayerEvtStop) break;
+        if(events & PlayerEvtDone) player->callback(player->context);
+    }
+
+    furi_hal_light_set(MORSE_PLAYER_LIGHTS, 0x00);
+    return 0;
+}
+
+MorsePlayer* morse_player_alloc(MorsePlayerCallback callback, void* context) {
+    furi_assert(callback);
+    MorsePlayer* player = malloc(sizeof(MorsePlayer));
+    player->callback = callback;
+    player->context = context;
+    player->running = false;
+    player->speaker = false;
+    player->on = false;
+    player->thread = furi_thread_alloc_ex("MorsePlayer", 1024, morse_player_worker, player);
+    return player;
+}
+
+void morse_player_free(MorsePlayer* player) {
+    furi_assert(player);
+    morse_player_stop(player);
+    furi_thread_free(player->thread);
+    free(player);
+}
+
+void morse_player_start(MorsePlayer* player, const char* text, const MorseTiming* timing) {
+    furi_assert(player);
+    morse_player_stop(player);
+
+    morse_encoder_init(&player->encoder, text, timing);
+    furi_hal_gpio_init(MORSE_PLAYER_PIN, GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
+    furi_hal_gpio_write(MORSE_PLAYER_PIN, false);
+    // the speaker is held for the whole message, the interrupt only starts and stops it
+    player->speaker = furi_hal_speaker_acquire(1000);
+    furi_thread_start(player->thread);
+    player->running = true;
+
+    // 1 MHz free running counter
+    furi_hal_bus_enable(FuriHalBusTIM2);
+    LL_TIM_SetCounterMode(TIM2, LL_TIM_COUNTERMODE_UP);
+    LL_TIM_SetClockDivision(TIM2, LL_TIM_CLOCKDIVISION_DIV1);
+    LL_TIM_SetPrescaler(TIM2, furi_hal_cortex_instructions_per_microsecond() - 1);
+    LL_TIM_SetAutoReload(TIM2, 0xFFFFFFFF);
+    LL_TIM_OC_SetMode(TIM2, LL_TIM_CHANNEL_CH1, LL_TIM_OCMODE_FROZEN);
+    LL_TIM_GenerateEvent_UPDATE(TIM2);
+    LL_TIM_SetCounter(TIM2, 0);
+
+    player->next_change = START_DELAY_US;
+    LL_TIM_OC_SetCompareCH1(TIM2, player->next_change);
+    LL_TIM_ClearFlag_CC1(TIM2);
+
+    furi_hal_interrupt_set_isr(FuriHalInterruptIdTIM2, morse_player_isr, player);
+    LL_TIM_EnableIT_CC1(TIM2);
+    LL_TIM_EnableCounter(TIM2);
+}
+
+void morse_player_stop(MorsePlayer* player) {
+    furi_assert(player);
+    if(!player->running) return;
+
+    LL_TIM_DisableIT_CC1(TIM2);
+    LL_TIM_DisableCounter(TIM2);
+    furi_hal_interrupt_set_isr(FuriHalInterruptIdTIM2, NULL, NULL);
+    furi_hal_bus_disable(FuriHalBusTIM2);
+
+    morse_player_key(player, false);
+    if(player->speaker) {
+        furi_hal_speaker_release();
+        player->speaker = false;
+    }
+    furi_hal_gpio_init(MORSE_PLAYER_PIN, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
+
+    furi_thread_flags_set(furi_thread_get_id(player->thread), PlayerEvtStop);
+    furi_thread_join(player->thread);
+    player->running = false;
+}
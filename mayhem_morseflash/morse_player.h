@@ -0,0 +1,18 @@
+#pragma once
+
+#include "morse.h"
+
+// Keys the LED, the speaker and GPIO pin 2 (A7) together. The marks and gaps are scheduled on
+// TIM2 against absolute deadlines, so the timing holds up at high speeds.
+
+// Called from the player's thread once the whole text has been sent
+typedef void (*MorsePlayerCallback)(void* context);
+
+typedef struct MorsePlayer MorsePlayer;
+
+MorsePlayer* morse_player_alloc(MorsePlayerCallback callback, void* context);
+void morse_player_free(MorsePlayer* player);
+
+// The text has to stay around until the player is done or stopped
+void morse_player_start(MorsePlayer* player, const char* text, const MorseTiming* timing);
+void morse_player_stop(MorsePlayer* player);
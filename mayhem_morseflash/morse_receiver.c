@@ -0,0 +1,188 @@
+#include "morse_receiver.h"
+
+#include <furi_hal.h>
+
+#define MORSE_RECEIVER_PIN (&gpio_ext_pa6)
+#define EDGE_RING_SIZE 64
+// shorter pulses are bounces or flicker, a dot at 60 wpm is 20 ms
+#define GLITCH_US 2000
+
+typedef enum {
+    ReceiverEvtStop = (1 << 0),
+    ReceiverEvtEdge = (1 << 1),
+} ReceiverEvtFlags;
+
+#define RECEIVER_ALL_EVENTS (ReceiverEvtStop | ReceiverEvtEdge)
+
+typedef struct {
+    uint32_t cycles;
+    bool level;
+} MorseEdge;
+
+struct MorseReceiver {
+    MorseReceiverCallback callback;
+    void* context;
+    FuriThread* thread;
+    bool running;
+    bool active_low;
+
+    MorseEdge edges[EDGE_RING_SIZE];
+    volatile uint32_t head;
+    uint32_t tail;
+
+    // the level since the last edge
+    bool level;
+    uint32_t last_edge;
+    // a finished stretch of one level, held back until it is clear the next one isn't a glitch
+    bool has_pending;
+    bool pending_level;
+    uint32_t pending_us;
+    bool flushed;
+
+    MorseDecoder decoder;
+};
+
+static void morse_receiver_edge_callback(void* context) {
+    uint32_t cycles = DWT->CYCCNT;
+    MorseReceiver* receiver = context;
+
+    // the level is read back so a missed edge can't invert the state
+    uint32_t head = receiver->head;
+    if(head - receiver->tail < EDGE_RING_SIZE) {
+        MorseEdge* edge = &receiver->edges[head % EDGE_RING_SIZE];
+        edge->cycles = cycles;
+        edge->level = furi_hal_gpio_read(MORSE_RECEIVER_PIN);
+        receiver->head = head + 1;
+    }
+    furi_thread_flags_set(furi_thread_get_id(receiver->thread), ReceiverEvtEdge);
+}
+
+static void morse_receiver_feed(MorseReceiver* receiver, bool level, uint32_t us) {
+    char text[2];
+    bool mark = level != receiver->active_low;
+    uint8_t length = morse_decoder_feed(&receiver->decoder, mark, us, text);
+    if(length) {
+        uint8_t wpm = morse_decoder_get_wpm(&receiver->decoder);
+        receiver->callback(text, length, wpm, receiver->context);
+    }
+}
+
+static void morse_receiver_segment(MorseReceiver* receiver, bool level, uint32_t us) {
+    if(receiver->has_pending && (level == receiver->pending_level || us < GLITCH_US)) {
+        receiver->pending_us += us;
+        return;
+    }
+    if(receiver->has_pending) {
+        morse_receiver_feed(receiver, receiver->pending_level, receiver->pending_us);
+    }
+    receiver->has_pending = true;
+    receiver->pending_level = level;
+    receiver->pending_us = us;
+}
+
+// Ends the word once the line has been quiet for twice a word gap, returns how long to wait
+// before checking again
+static uint32_t morse_receiver_check_idle(MorseReceiver* receiver) {
+    bool mark = receiver->level != receiver->active_low;
+    if(receiver->flushed || mark) return FuriWaitForever;
+
+    uint32_t idle_us = morse_decoder_get_word_gap(&receiver->decoder) * 2;
+    uint32_t elapsed =
+        (DWT->CYCCNT - receiver->last_edge) / furi_hal_cortex_instructions_per_microsecond();
+    if(elapsed < idle_us) return furi_ms_to_ticks((idle_us - elapsed) / 1000 + 1);
+
+    if(receiver->has_pending) {
+        morse_receiver_feed(receiver, receiver->pending_level, receiver->pending_us);
+        receiver->has_pending = false;
+    }
+    char text[2];
+    uint8_t length = morse_decoder_flush(&receiver->decoder, text);
+    if(length) {
+        uint8_t wpm = morse_decoder_get_wpm(&receiver->decoder);
+        receiver->callback(text, length, wpm, receiver->context);
+    }
+    receiver->flushed = true;
+    return FuriWaitForever;
+}
+
+static int32_t morse_receiver_worker(void* context) {
+    MorseReceiver* receiver = context;
+    uint32_t timeout = FuriWaitForever;
+
+    while(1) {
+        uint32_t events = furi_thread_flags_wait(RECEIVER_ALL_EVENTS, FuriFlagWaitAny, timeout);
+        if(events != (uint32_t)FuriFlagErrorTimeout) {
+            furi_check((events & FuriFlagError) == 0);
+            if(events & ReceiverEvtStop) break;
+        }
+
+        uint32_t cycles_per_us = furi_hal_cortex_instructions_per_microsecond();
+        while(receiver->tail != receiver->head) {
+            MorseEdge edge = receiver->edges[receiver->tail % EDGE_RING_SIZE];
+            receiver->tail++;
+
+            uint32_t us = (edge.cycles - receiver->last_edge) / cycles_per_us;
+            morse_receiver_segment(receiver, receiver->level, us);
+            receiver->level = edge.level;
+            receiver->last_edge = edge.cycles;
+            receiver->flushed = false;
+        }
+        timeout = morse_receiver_check_idle(receiver);
+    }
+
+    return 0;
+}
+
+MorseReceiver* morse_receiver_alloc(MorseReceiverCallback callback, void* context) {
+    furi_assert(callback);
+    MorseReceiver* receiver = malloc(sizeof(MorseReceiver));
+    receiver->callback = callback;
+    receiver->context = context;
+    receiver->running = false;
+    receiver->thread =
+        furi_thread_alloc_ex("MorseReceiver", 1024, morse_receiver_worker, receiver);
+    return receiver;
+}
+
+void morse_receiver_free(MorseReceiver* receiver) {
+    furi_assert(receiver);
+    morse_receiver_stop(receiver);
+    furi_thread_free(receiver->thread);
+    free(receiver);
+}
+
+void morse_receiver_start(MorseReceiver* receiver, bool active_low, uint8_t wpm) {
+    furi_assert(receiver);
+    morse_receiver_stop(receiver);
+
+    morse_decoder_init(&receiver->decoder, wpm);
+    receiver->active_low = active_low;
+    receiver->head = 0;
+    receiver->tail = 0;
+    receiver->has_pending = false;
+    receiver->flushed = true;
+
+    furi_hal_gpio_init(
+        MORSE_RECEIVER_PIN,
+        GpioModeInterruptRiseFall,
+        active_low ? GpioPullUp : GpioPullDown,
+        GpioSpeedVeryHigh);
+    receiver->level = furi_hal_gpio_read(MORSE_RECEIVER_PIN);
+    receiver->last_edge = DWT->CYCCNT;
+
+    furi_thread_start(receiver->thread);
+    receiver->running = true;
+    furi_hal_gpio_add_int_callback(MORSE_RECEIVER_PIN, morse_receiver_edge_callback, receiver);
+}
+
+void morse_receiver_stop(MorseReceiver* receiver) {
+    furi_assert(receiver);
+    if(!receiver->running) return;
+
+    furi_hal_gpio_remove_int_callback(MORSE_RECEIVER_PIN);
+    furi_hal_gpio_init(MORSE_RECEIVER_PIN, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
+
+    furi_thread_flags_set(furi_thread_get_id(receiver->thread), ReceiverEvtStop);
+    furi_thread_join(receiver->thread);
+    receiver->running = false;
+}
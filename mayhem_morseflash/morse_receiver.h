@@ -0,0 +1,24 @@
+#pragma once
+
+#include "morse.h"
+
+// Reads Morse from GPIO pin 3 (A6): a key, or a light sensor module with a digital output.
+// Edges are timestamped in the pin interrupt, short glitches are filtered out and the marks
+// and gaps go through the adaptive decoder.
+
+// Called from the receiver's thread with the decoded characters
+typedef void (*MorseReceiverCallback)(
+    const char* text,
+    uint8_t length,
+    uint8_t wpm,
+    void* context);
+
+typedef struct MorseReceiver MorseReceiver;
+
+MorseReceiver* morse_receiver_alloc(MorseReceiverCallback callback, void* context);
+void morse_receiver_free(MorseReceiver* receiver);
+
+// wpm is the first guess of the speed. With active_low the marks pull the pin low, otherwise
+// they drive it high.
+void morse_receiver_start(MorseReceiver* receiver, bool active_low, uint8_t wpm);
+void morse_receiver_stop(MorseReceiver* receiver);
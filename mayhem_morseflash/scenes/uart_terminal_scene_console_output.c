@@ -19,6 +19,29 @@ void uart_terminal_console_output_handle_rx_data_cb(uint8_t* buf, size_t len, vo
         app->view_dispatcher, UART_TerminalEventRefreshConsoleOutput);
 }
 
+static void uart_terminal_console_output_morse_done_cb(void* context) {
+    char done[] = "\nDone\n";
+    uart_terminal_console_output_handle_rx_data_cb((uint8_t*)done, strlen(done), context);
+}
+
+static void uart_terminal_console_output_morse_rx_cb(
+    const char* text,
+    uint8_t length,
+    uint8_t wpm,
+    void* context) {
+    UART_TerminalApp* app = context;
+    char buf[16];
+    size_t len = 0;
+
+    // the speed is shown again whenever the sender changes pace
+    if(wpm + 2 < app->decoded_wpm || wpm > app->decoded_wpm + 2) {
+        app->decoded_wpm = wpm;
+        len = snprintf(buf, sizeof(buf), "\n[%u wpm] ", wpm);
+    }
+    memcpy(buf + len, text, length);
+    uart_terminal_console_output_handle_rx_data_cb((uint8_t*)buf, len + length, app);
+}
+
 void uart_terminal_scene_console_output_on_enter(void* context) {
     UART_TerminalApp* app = context;
 
@@ -39,7 +62,9 @@ void uart_terminal_scene_console_output_on_enter(void* context) {
         if(app->show_stopscan_tip ||
            0 == strncmp("help", app->selected_tx_string, strlen("help"))) {
             const char* help_msg =
-                "Morse Flasher for\nMayhem Fin\n\nBased on UART terminal by\ncool4uma, which is a\nmodified WiFi Marauder\ncompanion by 0xchocolate\n\n";
+                "Morse Flasher for\nMayhem Fin\n\nBased on UART terminal by\ncool4uma, which is a\nmodified WiFi Marauder\ncompanion by 0xchocolate\n\n"
+                "Send with Flipper keys\nthe LED, the speaker and\npin 2.\n"
+                "Decode reads a key\nor light sensor on pin 3.\n\n";
             furi_string_cat_str(app->text_box_store, help_msg);
             app->text_box_store_strlen += strlen(help_msg);
         }
@@ -51,12 +76,33 @@ void uart_terminal_scene_console_output_on_enter(void* context) {
         }
     }
 
+    if(app->decode) {
+        const char* msg = "Decoding pin 3...\n";
+        furi_string_cat_str(app->text_box_store, msg);
+        app->text_box_store_strlen += strlen(msg);
+    } else if(app->send_local) {
+        furi_string_cat_printf(app->text_box_store, "%s\n", app->selected_tx_string);
+        app->text_box_store_strlen += strlen(app->selected_tx_string) + 1;
+    }
+
     // Set starting text - for "View Log", this will just be what was already in the text box store
     text_box_set_text(app->text_box, furi_string_get_cstr(app->text_box_store));
 
     scene_manager_set_scene_state(app->scene_manager, UART_TerminalSceneConsoleOutput, 0);
     view_dispatcher_switch_to_view(app->view_dispatcher, UART_TerminalAppViewConsoleOutput);
 
+    if(app->decode) {
+        app->decoded_wpm = 0;
+        app->receiver = morse_receiver_alloc(uart_terminal_console_output_morse_rx_cb, app);
+        morse_receiver_start(app->receiver, app->decode_active_low, app->char_wpm);
+        return;
+    }
+    if(app->send_local) {
+        app->player = morse_player_alloc(uart_terminal_console_output_morse_done_cb, app);
+        morse_player_start(app->player, app->selected_tx_string, &app->timing);
+        return;
+    }
+
     // Register callback to receive data
     uart_terminal_uart_set_handle_rx_data_cb(
         app->uart, uart_terminal_console_output_handle_rx_data_cb); // setup callback for rx thread
@@ -90,6 +136,15 @@ void uart_terminal_scene_console_output_on_exit(void* context) {
     // Unregister rx callback
     uart_terminal_uart_set_handle_rx_data_cb(app->uart, NULL);
 
+    if(app->player) {
+        morse_player_free(app->player);
+        app->player = NULL;
+    }
+    if(app->receiver) {
+        morse_receiver_free(app->receiver);
+        app->receiver = NULL;
+    }
+
     // Automatically logut when exiting view
     //if(app->is_command) {
     //    uart_terminal_uart_tx((uint8_t*)("exit\n"), strlen("exit\n"));
@@ -7,6 +7,9 @@ typedef enum { NO_ARGS = 0, INPUT_ARGS, TOGGLE_ARGS } InputArgs;
 
 typedef enum { FOCUS_CONSOLE_END = 0, FOCUS_CONSOLE_START, FOCUS_CONSOLE_TOGGLE } FocusConsole;
 
+// Settings only change with left and right, decoding listens instead of sending
+typedef enum { SEND_ACTION = 0, SETTING_ACTION, DECODE_ACTION } ItemAction;
+
 #define SHOW_STOPSCAN_TIP (true)
 #define NO_TIP (false)
 
@@ -19,11 +22,12 @@ typedef struct {
     InputArgs needs_keyboard;
     FocusConsole focus_console;
     bool show_stopscan_tip;
+    ItemAction action;
 } UART_TerminalItem;
 
 // NUM_MENU_ITEMS defined in uart_terminal_app_i.h - if you add an entry here, increment it!
 const UART_TerminalItem items[NUM_MENU_ITEMS] = {
-    {"New custom message", {""}, 1, {""}, INPUT_ARGS, FOCUS_CONSOLE_END, NO_TIP},
+    {"New custom message", {""}, 1, {""}, INPUT_ARGS, FOCUS_CONSOLE_END, NO_TIP, SEND_ACTION},
     {"Quick message",
      {"SOS", "CQD", "VVV", "Eureka", "E.T ph...", "what h...", "Mayhem", "Flipper"},
      8,
@@ -37,8 +41,41 @@ const UART_TerminalItem items[NUM_MENU_ITEMS] = {
       "flipper zero in da housa"},
      NO_ARGS,
      FOCUS_CONSOLE_END,
-     NO_TIP},
-    {"Help", {""}, 1, {""}, NO_ARGS, FOCUS_CONSOLE_START, SHOW_STOPSCAN_TIP},
+     NO_TIP,
+     SEND_ACTION},
+    {"Send with",
+     {"ESP32-CAM", "Flipper"},
+     2,
+     {"", ""},
+     NO_ARGS,
+     FOCUS_CONSOLE_END,
+     NO_TIP,
+     SETTING_ACTION},
+    {"Speed",
+     {"5 wpm", "10 wpm", "15 wpm", "20 wpm", "25 wpm", "30 wpm", "35 wpm", "40 wpm", "50 wpm"},
+     9,
+     {"5", "10", "15", "20", "25", "30", "35", "40", "50"},
+     NO_ARGS,
+     FOCUS_CONSOLE_END,
+     NO_TIP,
+     SETTING_ACTION},
+    {"Farnsworth",
+     {"Off", "5 wpm", "8 wpm", "10 wpm", "13 wpm", "15 wpm", "18 wpm", "20 wpm", "25 wpm"},
+     9,
+     {"0", "5", "8", "10", "13", "15", "18", "20", "25"},
+     NO_ARGS,
+     FOCUS_CONSOLE_END,
+     NO_TIP,
+     SETTING_ACTION},
+    {"Decode pin 3",
+     {"High=on", "Low=on"},
+     2,
+     {"", ""},
+     NO_ARGS,
+     FOCUS_CONSOLE_END,
+     NO_TIP,
+     DECODE_ACTION},
+    {"Help", {""}, 1, {""}, NO_ARGS, FOCUS_CONSOLE_START, SHOW_STOPSCAN_TIP, SEND_ACTION},
 };
 
 static void uart_terminal_scene_start_var_list_enter_callback(void* context, uint32_t index) {
@@ -47,6 +84,7 @@ static void uart_terminal_scene_start_var_list_enter_callback(void* context, uin
 
     furi_assert(index < NUM_MENU_ITEMS);
     const UART_TerminalItem* item = &items[index];
+    if(item->action == SETTING_ACTION) return;
 
     const int selected_option_index = app->selected_option_index[index];
     furi_assert(selected_option_index < item->num_options_menu);
@@ -59,6 +97,19 @@ static void uart_terminal_scene_start_var_list_enter_callback(void* context, uin
                                    item->focus_console;
     app->show_stopscan_tip = item->show_stopscan_tip;
 
+    // the Help item keeps going to the ESP32-CAM
+    app->decode = item->action == DECODE_ACTION;
+    app->decode_active_low = app->decode && selected_option_index == 1;
+    app->send_local = item->action == SEND_ACTION && index < MENU_ITEM_SEND_WITH &&
+                      app->selected_option_index[MENU_ITEM_SEND_WITH] == 1;
+    const UART_TerminalItem* speed = &items[MENU_ITEM_SPEED];
+    const UART_TerminalItem* farnsworth = &items[MENU_ITEM_FARNSWORTH];
+    app->char_wpm = atoi(speed->actual_commands[app->selected_option_index[MENU_ITEM_SPEED]]);
+    morse_timing_init(
+        &app->timing,
+        app->char_wpm,
+        atoi(farnsworth->actual_commands[app->selected_option_index[MENU_ITEM_FARNSWORTH]]));
+
     bool needs_keyboard = (item->needs_keyboard == TOGGLE_ARGS) ? (selected_option_index != 0) :
                                                                   item->needs_keyboard;
     if(needs_keyboard) {
@@ -49,6 +49,9 @@ UART_TerminalApp* uart_terminal_app_alloc() {
     for(int i = 0; i < NUM_MENU_ITEMS; ++i) {
         app->selected_option_index[i] = 0;
     }
+    app->selected_option_index[MENU_ITEM_SPEED] = DEFAULT_SPEED_OPTION;
+    app->player = NULL;
+    app->receiver = NULL;
 
     app->text_box = text_box_alloc();
     view_dispatcher_add_view(
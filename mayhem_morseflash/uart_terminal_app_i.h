@@ -4,6 +4,8 @@
 #include "scenes/uart_terminal_scene.h"
 #include "uart_terminal_custom_event.h"
 #include "uart_terminal_uart.h"
+#include "morse_player.h"
+#include "morse_receiver.h"
 
 #include <gui/gui.h>
 #include <gui/view_dispatcher.h>
@@ -12,7 +14,12 @@
 #include <gui/modules/text_input.h>
 #include <gui/modules/variable_item_list.h>
 
-#define NUM_MENU_ITEMS (3)
+#define NUM_MENU_ITEMS (7)
+// settings in the start menu
+#define MENU_ITEM_SEND_WITH (2)
+#define MENU_ITEM_SPEED (3)
+#define MENU_ITEM_FARNSWORTH (4)
+#define DEFAULT_SPEED_OPTION (3)
 
 #define UART_TERMINAL_TEXT_BOX_STORE_SIZE (4096)
 #define UART_TERMINAL_TEXT_INPUT_STORE_SIZE (512)
@@ -33,6 +40,8 @@ struct UART_TerminalApp {
     VariableItemList* var_item_list;
 
     UART_TerminalUart* uart;
+    MorsePlayer* player;
+    MorseReceiver* receiver;
     int selected_menu_index;
     int selected_option_index[NUM_MENU_ITEMS];
     const char* selected_tx_string;
@@ -40,6 +49,14 @@ struct UART_TerminalApp {
     bool is_custom_tx_string;
     bool focus_console_start;
     bool show_stopscan_tip;
+
+    // messages are keyed on the Flipper itself instead of the ESP32-CAM
+    bool send_local;
+    bool decode;
+    bool decode_active_low;
+    MorseTiming timing;
+    uint8_t char_wpm;
+    uint8_t decoded_wpm;
 };
 
 typedef enum {
@@ -1,34 +1,5 @@
 #include "uart_echo.h"
 
-static void uart_echo_view_draw_callback(Canvas* canvas, void* _model) {
-    UartDumpModel* model = _model;
-
-    // Prepare canvas
-    canvas_clear(canvas);
-    canvas_set_color(canvas, ColorBlack);
-    canvas_set_font(canvas, FontKeyboard);
-
-    for(size_t i = 0; i < LINES_ON_SCREEN; i++) {
-        canvas_draw_str(
-            canvas,
-            0,
-            (i + 1) * (canvas_current_font_height(canvas) - 1),
-            furi_string_get_cstr(model->list[i]->text));
-
-        if(i == model->line) {
-            uint8_t width =
-                canvas_string_width(canvas, furi_string_get_cstr(model->list[i]->text));
-
-            canvas_draw_box(
-                canvas,
-                width,
-                (i) * (canvas_current_font_height(canvas) - 1) + 2,
-                2,
-                canvas_current_font_height(canvas) - 2);
-        }
-    }
-}
-
 static bool uart_echo_view_input_callback(InputEvent* event, void* context) {
     UNUSED(event);
     UNUSED(context);
@@ -50,61 +21,15 @@ static void uart_echo_on_irq_cb(UartIrqEvent ev, uint8_t data, void* context) {
     }
 }
 
-static void uart_echo_push_to_list(UartDumpModel* model, void* context, const char data) {
-    // Alarm sound
-    if(data == '!') {
-        UartEchoApp* app = context;
-        notification_message(app->notification, &sequence_alarm);
-    }
-
-    if(model->escape) {
-        // escape code end with letter
-        if((data >= 'a' && data <= 'z') || (data >= 'A' && data <= 'Z')) {
-            model->escape = false;
-        }
-    } else if(data == '[' && model->last_char == '\e') {
-        // "Esc[" is a escape code
-        model->escape = true;
-    } else if((data >= ' ' && data <= '~') || (data == '\n' || data == '\r')) {
-        bool new_string_needed = false;
-        if(furi_string_size(model->list[model->line]->text) >= COLUMNS_ON_SCREEN) {
-            new_string_needed = true;
-        } else if((data == '\n' || data == '\r')) {
-            // pack line breaks
-            if(model->last_char != '\n' && model->last_char != '\r') {
-                new_string_needed = true;
-            }
-        }
-
-        if(new_string_needed) {
-            if((model->line + 1) < LINES_ON_SCREEN) {
-                model->line += 1;
-            } else {
-                ListElement* first = model->list[0];
-
-                for(size_t i = 1; i < LINES_ON_SCREEN; i++) {
-                    model->list[i - 1] = model->list[i];
-                }
-
-                furi_string_reset(first->text);
-                model->list[model->line] = first;
-            }
-        }
-
-        if(data != '\n' && data != '\r') {
-            furi_string_push_back(model->list[model->line]->text, data);
-        }
-    }
-    model->last_char = data;
-}
-
 static int32_t uart_echo_worker(void* context) {
     furi_assert(context);
     UartEchoApp* app = context;
 
+    uint32_t timeout = FuriWaitForever;
     while(1) {
-        uint32_t events =
-            furi_thread_flags_wait(WORKER_EVENTS_MASK, FuriFlagWaitAny, FuriWaitForever);
+        uint32_t events = furi_thread_flags_wait(WORKER_EVENTS_MASK, FuriFlagWaitAny, timeout);
+        // a timeout only means a redraw is due
+        if(events == (uint32_t)FuriFlagErrorTimeout) events = 0;
         furi_check((events & FuriFlagError) == 0);
 
         if(events & WorkerEventStop) break;
@@ -115,22 +40,17 @@ static int32_t uart_echo_worker(void* context) {
                 length = furi_stream_buffer_receive(app->rx_stream, data, 64, 0);
                 if(length > 0 && app->initialized) {
                     furi_hal_uart_tx(FuriHalUartIdUSART1, data, length);
-                    with_view_model(
-                        app->view,
-                        UartDumpModel * model,
-                        {
-                            for(size_t i = 0; i < length; i++) {
-                                uart_echo_push_to_list(model, app, data[i]);
-                            }
-                        },
-                        false);
+                    // Alarm sound
+                    if(memchr(data, '!', length)) {
+                        notification_message(app->notification, &sequence_alarm);
+                    }
+                    uart_line_view_push(app->line_view, data, length);
                 }
             } while(length > 0);
 
             //notification_message(app->notification, &sequence_notification);
-            with_view_model(
-                app->view, UartDumpModel * model, { UNUSED(model); }, true);
         }
+        timeout = uart_line_view_update(app->line_view);
     }
 
     return 0;
@@ -151,25 +71,11 @@ static UartEchoApp* uart_echo_app_alloc() {
     view_dispatcher_attach_to_gui(app->view_dispatcher, app->gui, ViewDispatcherTypeFullscreen);
 
     // Views
-    app->view = view_alloc();
-    view_set_draw_callback(app->view, uart_echo_view_draw_callback);
-    view_set_input_callback(app->view, uart_echo_view_input_callback);
-    view_allocate_model(app->view, ViewModelTypeLocking, sizeof(UartDumpModel));
-    with_view_model(
-        app->view,
-        UartDumpModel * model,
-        {
-            for(size_t i = 0; i < LINES_ON_SCREEN; i++) {
-                model->line = 0;
-                model->escape = false;
-                model->list[i] = malloc(sizeof(ListElement));
-                model->list[i]->text = furi_string_alloc();
-            }
-        },
-        true);
-
-    view_set_previous_callback(app->view, uart_echo_exit);
-    view_dispatcher_add_view(app->view_dispatcher, 0, app->view);
+    app->line_view = uart_line_view_alloc();
+    View* view = uart_line_view_get_view(app->line_view);
+    view_set_input_callback(view, uart_echo_view_input_callback);
+    view_set_previous_callback(view, uart_echo_exit);
+    view_dispatcher_add_view(app->view_dispatcher, 0, view);
     view_dispatcher_switch_to_view(app->view_dispatcher, 0);
 
     app->worker_thread = furi_thread_alloc_ex("UsbUartWorker", 1024, uart_echo_worker, app);
@@ -206,17 +112,7 @@ static void uart_echo_app_free(UartEchoApp* app) {
     // Free views
     view_dispatcher_remove_view(app->view_dispatcher, 0);
 
-    with_view_model(
-        app->view,
-        UartDumpModel * model,
-        {
-            for(size_t i = 0; i < LINES_ON_SCREEN; i++) {
-                furi_string_free(model->list[i]->text);
-                free(model->list[i]);
-            }
-        },
-        true);
-    view_free(app->view);
+    uart_line_view_free(app->line_view);
     view_dispatcher_free(app->view_dispatcher);
 
     // Close gui record
@@ -8,34 +8,18 @@
 #include <furi_hal_console.h>
 #include <gui/view_dispatcher.h>
 #include <gui/modules/dialog_ex.h>
-
-#define LINES_ON_SCREEN 6
-#define COLUMNS_ON_SCREEN 21
-
-typedef struct UartDumpModel UartDumpModel;
+#include <uart_line_view.h>
 
 typedef struct {
     Gui* gui;
     NotificationApp* notification;
     ViewDispatcher* view_dispatcher;
-    View* view;
+    UartLineView* line_view;
     FuriThread* worker_thread;
     FuriStreamBuffer* rx_stream;
     bool initialized;
 } UartEchoApp;
 
-typedef struct {
-    FuriString* text;
-} ListElement;
-
-struct UartDumpModel {
-    ListElement* list[LINES_ON_SCREEN];
-    uint8_t line;
-
-    char last_char;
-    bool escape;
-};
-
 typedef enum {
     WorkerEventReserved = (1 << 0), // Reserved for StreamBuffer internal event
     WorkerEventStop = (1 << 1),
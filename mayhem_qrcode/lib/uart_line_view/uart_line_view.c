@@ -0,0 +1,141 @@
+#include "uart_line_view.h"
+
+#include <gui/canvas.h>
+
+typedef struct {
+    char lines[UART_LINE_VIEW_LINES][UART_LINE_VIEW_COLUMNS + 1];
+    uint8_t head; // oldest line on screen
+    uint8_t count; // lines in use, the last one is being written
+    uint8_t column;
+
+    char last_char;
+    bool escape;
+} UartLineViewModel;
+
+struct UartLineView {
+    View* view;
+    // only touched by the feeding thread
+    bool dirty;
+    uint32_t last_redraw;
+};
+
+static char* uart_line_view_line(UartLineViewModel* model, uint8_t index) {
+    return model->lines[(model->head + index) % UART_LINE_VIEW_LINES];
+}
+
+static void uart_line_view_draw_callback(Canvas* canvas, void* _model) {
+    UartLineViewModel* model = _model;
+
+    // Prepare canvas
+    canvas_clear(canvas);
+    canvas_set_color(canvas, ColorBlack);
+    canvas_set_font(canvas, FontKeyboard);
+    uint8_t height = canvas_current_font_height(canvas) - 1;
+
+    for(uint8_t i = 0; i < model->count; i++) {
+        const char* line = uart_line_view_line(model, i);
+        canvas_draw_str(canvas, 0, (i + 1) * height, line);
+
+        if(i == model->count - 1) {
+            canvas_draw_box(
+                canvas, canvas_string_width(canvas, line), i * height + 2, 2, height - 1);
+        }
+    }
+}
+
+static void uart_line_view_new_line(UartLineViewModel* model) {
+    if(model->count < UART_LINE_VIEW_LINES) {
+        model->count++;
+    } else {
+        // the oldest line scrolls out and gets reused
+        model->head = (model->head + 1) % UART_LINE_VIEW_LINES;
+    }
+    uart_line_view_line(model, model->count - 1)[0] = '\0';
+    model->column = 0;
+}
+
+static void uart_line_view_push_char(UartLineViewModel* model, char data) {
+    if(model->escape) {
+        // escape code end with letter
+        if((data >= 'a' && data <= 'z') || (data >= 'A' && data <= 'Z')) {
+            model->escape = false;
+        }
+    } else if(data == '[' && model->last_char == '\e') {
+        // "Esc[" is a escape code
+        model->escape = true;
+    } else if((data >= ' ' && data <= '~') || (data == '\n' || data == '\r')) {
+        bool line_break = data == '\n' || data == '\r';
+        if(model->column >= UART_LINE_VIEW_COLUMNS) {
+            uart_line_view_new_line(model);
+        } else if(line_break && model->last_char != '\n' && model->last_char != '\r') {
+            // pack line breaks
+            uart_line_view_new_line(model);
+        }
+
+        if(!line_break) {
+            char* line = uart_line_view_line(model, model->count - 1);
+            line[model->column++] = data;
+            line[model->column] = '\0';
+        }
+    }
+    model->last_char = data;
+}
+
+UartLineView* uart_line_view_alloc(void) {
+    UartLineView* line_view = malloc(sizeof(UartLineView));
+    line_view->dirty = false;
+    line_view->last_redraw = 0;
+
+    line_view->view = view_alloc();
+    view_set_draw_callback(line_view->view, uart_line_view_draw_callback);
+    view_allocate_model(line_view->view, ViewModelTypeLocking, sizeof(UartLineViewModel));
+    with_view_model(
+        line_view->view,
+        UartLineViewModel * model,
+        {
+            memset(model, 0, sizeof(UartLineViewModel));
+            model->count = 1;
+        },
+        true);
+    return line_view;
+}
+
+void uart_line_view_free(UartLineView* line_view) {
+    furi_assert(line_view);
+    view_free(line_view->view);
+    free(line_view);
+}
+
+View* uart_line_view_get_view(UartLineView* line_view) {
+    furi_assert(line_view);
+    return line_view->view;
+}
+
+void uart_line_view_push(UartLineView* line_view, const uint8_t* data, size_t length) {
+    furi_assert(line_view);
+    with_view_model(
+        line_view->view,
+        UartLineViewModel * model,
+        {
+            for(size_t i = 0; i < length; i++) {
+                uart_line_view_push_char(model, data[i]);
+            }
+        },
+        false);
+    line_view->dirty = true;
+}
+
+uint32_t uart_line_view_update(UartLineView* line_view) {
+    furi_assert(line_view);
+    if(!line_view->dirty) return FuriWaitForever;
+
+    uint32_t interval = furi_ms_to_ticks(UART_LINE_VIEW_REDRAW_MS);
+    uint32_t elapsed = furi_get_tick() - line_view->last_redraw;
+    if(elapsed < interval) return interval - elapsed;
+
+    line_view->dirty = false;
+    line_view->last_redraw = furi_get_tick();
+    with_view_model(
+        line_view->view, UartLineViewModel * model, { UNUSED(model); }, true);
+    return FuriWaitForever;
+}
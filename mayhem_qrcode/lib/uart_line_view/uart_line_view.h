@@ -0,0 +1,45 @@
+#pragma once
+
+#include <furi.h>
+#include <gui/view.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Terminal style view of the lines received over UART, shared by the Mayhem apps that echo
+ * the ESP32-CAM output. The text lives in a fixed ring of lines, so feeding it never
+ * allocates and scrolling only moves the head index.
+ *
+ * One thread feeds the view with uart_line_view_push() and calls uart_line_view_update()
+ * to redraw, at most every UART_LINE_VIEW_REDRAW_MS.
+ */
+typedef struct UartLineView UartLineView;
+
+#define UART_LINE_VIEW_LINES 6
+#define UART_LINE_VIEW_COLUMNS 21
+#define UART_LINE_VIEW_REDRAW_MS 50
+
+UartLineView* uart_line_view_alloc(void);
+
+void uart_line_view_free(UartLineView* line_view);
+
+View* uart_line_view_get_view(UartLineView* line_view);
+
+/**
+ * @brief Appends received bytes, taking the view lock once for the whole chunk. Escape
+ *        sequences and other unprintable bytes are dropped, runs of line breaks count once.
+ */
+void uart_line_view_push(UartLineView* line_view, const uint8_t* data, size_t length);
+
+/**
+ * @brief Redraws when something was pushed and the last redraw is long enough ago.
+ * @return ticks until a pending redraw is due, FuriWaitForever when nothing is pending. Meant
+ *         as the timeout of the feeding thread's next wait.
+ */
+uint32_t uart_line_view_update(UartLineView* line_view);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,247 @@
+#include "click_scheduler.h"
+
+#include <furi_hal.h>
+#include <furi_hal_bus.h>
+#include <furi_hal_interrupt.h>
+#include <stm32wbxx_ll_tim.h>
+#include <math.h>
+
+#define CLICK_US 50000
+#define ACCENT_FREQ 440.0f
+#define BEAT_FREQ 220.0f
+#define POLY_FREQ 660.0f
+#define CLICK_VOLUME 1.0f
+// the first beat is scheduled this far ahead of the start
+#define START_DELAY_US 100
+
+struct ClickScheduler {
+    ClickSchedulerCallback callback;
+    void* context;
+    bool speaker;
+
+    ClickPattern pattern;
+    ClickPattern pending;
+    bool has_pending;
+
+    // Deadlines are absolute TIM2 counts in us, the 1/16 us remainders keep the beat from
+    // drifting when the period isn't a whole number of us
+    uint32_t next_beat;
+    uint32_t next_beat_frac;
+    uint8_t beat;
+
+    // the second voice is laid out from the start of the bar
+    uint32_t bar_start;
+    uint32_t bar_start_frac;
+    uint64_t poly_period;
+    uint8_t poly_index;
+    uint8_t poly_count;
+    uint32_t next_poly;
+
+    bool click_on;
+    ClickOutput click_output;
+    uint32_t click_end;
+
+    uint32_t jitter_last;
+    uint32_t jitter_max;
+};
+
+static inline bool click_scheduler_due(uint32_t deadline, uint32_t now) {
+    return (int32_t)(now - deadline) >= 0;
+}
+
+uint32_t click_scheduler_beat_period(double bpm, int note_length) {
+    return (uint32_t)round(60.0 * 1000000.0 * 16.0 / bpm * 4.0 / note_length);
+}
+
+static void click_scheduler_click_on(ClickScheduler* scheduler, float freq, uint32_t length) {
+    ClickOutput output = scheduler->pattern.output;
+    if(output == ClickOutputSpeaker && scheduler->speaker) {
+        furi_hal_speaker_start(freq, CLICK_VOLUME);
+    } else if(output == ClickOutputVibro) {
+        furi_hal_vibro_on(true);
+    }
+
+    scheduler->click_on = true;
+    scheduler->click_output = output;
+    scheduler->click_end = TIM2->CNT + length;
+}
+
+static void click_scheduler_click_off(ClickScheduler* scheduler) {
+    if(!scheduler->click_on) return;
+
+    if(scheduler->click_output == ClickOutputSpeaker && scheduler->speaker) {
+        furi_hal_speaker_stop();
+    } else if(scheduler->click_output == ClickOutputVibro) {
+        furi_hal_vibro_on(false);
+    }
+    scheduler->click_on = false;
+}
+
+static void click_scheduler_beat(ClickScheduler* scheduler, uint32_t now) {
+    uint32_t late = now - scheduler->next_beat;
+    scheduler->jitter_last = late;
+    if(late > scheduler->jitter_max) scheduler->jitter_max = late;
+
+    if(scheduler->has_pending) {
+        scheduler->pattern = scheduler->pending;
+        scheduler->has_pending = false;
+        if(scheduler->beat >= scheduler->pattern.beats_per_bar) scheduler->beat = 0;
+    }
+    const ClickPattern* pattern = &scheduler->pattern;
+    uint8_t beat = scheduler->beat;
+
+    // clicks never take more than half a beat, and off beats only vibrate half as long
+    uint32_t length = MIN((uint32_t)CLICK_US, pattern->beat_us / 32);
+    if(beat != 0 && pattern->output == ClickOutputVibro) length /= 2;
+    click_scheduler_click_on(scheduler, beat == 0 ? ACCENT_FREQ : BEAT_FREQ, length);
+
+    if(beat == 0) {
+        scheduler->bar_start = scheduler->next_beat;
+        scheduler->bar_start_frac = scheduler->next_beat_frac;
+        // the first click of the second voice falls on the accent
+        scheduler->poly_count = pattern->poly > 1 ? pattern->poly : 0;
+        scheduler->poly_index = 1;
+        if(scheduler->poly_count) {
+            scheduler->poly_period =
+                (uint64_t)pattern->beat_us * pattern->beats_per_bar / scheduler->poly_count;
+            scheduler->next_poly =
+                scheduler->bar_start +
+                ((scheduler->bar_start_frac + scheduler->poly_period) >> 4);
+        }
+    }
+
+    scheduler->callback(ClickEventBeat, beat, scheduler->context);
+
+    scheduler->next_beat_frac += pattern->beat_us;
+    scheduler->next_beat += scheduler->next_beat_frac >> 4;
+    scheduler->next_beat_frac &= 0xf;
+    scheduler->beat = (beat + 1) % pattern->beats_per_bar;
+}
+
+static void click_scheduler_poly(ClickScheduler* scheduler) {
+    uint32_t length = MIN((uint64_t)CLICK_US, scheduler->poly_period / 32);
+    click_scheduler_click_on(scheduler, POLY_FREQ, length);
+    scheduler->callback(ClickEventPoly, scheduler->poly_index, scheduler->context);
+
+    scheduler->poly_index++;
+    if(scheduler->poly_index < scheduler->poly_count) {
+        scheduler->next_poly =
+            scheduler->bar_start +
+            ((scheduler->bar_start_frac + scheduler->poly_period * scheduler->poly_index) >> 4);
+    } else {
+        scheduler->poly_count = 0;
+    }
+}
+
+static void click_scheduler_isr(void* context) {
+    ClickScheduler* scheduler = context;
+    if(!LL_TIM_IsActiveFlag_CC1(TIM2)) return;
+    LL_TIM_ClearFlag_CC1(TIM2);
+
+    while(true) {
+        uint32_t now = TIM2->CNT;
+
+        if(scheduler->click_on && click_scheduler_due(scheduler->click_end, now)) {
+            click_scheduler_click_off(scheduler);
+            scheduler->callback(ClickEventClickEnd, 0, scheduler->context);
+        }
+        if(click_scheduler_due(scheduler->next_beat, now)) {
+            click_scheduler_beat(scheduler, now);
+        } else if(scheduler->poly_count && click_scheduler_due(scheduler->next_poly, now)) {
+            click_scheduler_poly(scheduler);
+        }
+
+        // the compare only fires on an exact match, so a deadline that went by while it was
+        // being set is handled right here
+        uint32_t next = scheduler->next_beat;
+        if(scheduler->poly_count && (int32_t)(scheduler->next_poly - next) < 0) {
+            next = scheduler->next_poly;
+        }
+        if(scheduler->click_on && (int32_t)(scheduler->click_end - next) < 0) {
+            next = scheduler->click_end;
+        }
+        LL_TIM_OC_SetCompareCH1(TIM2, next);
+        if((int32_t)(next - TIM2->CNT) > 0) break;
+    }
+}
+
+ClickScheduler* click_scheduler_alloc(ClickSchedulerCallback callback, void* context) {
+    furi_assert(callback);
+    ClickScheduler* scheduler = malloc(sizeof(ClickScheduler));
+    scheduler->callback = callback;
+    scheduler->context = context;
+    return scheduler;
+}
+
+void click_scheduler_free(ClickScheduler* scheduler) {
+    furi_assert(scheduler);
+    free(scheduler);
+}
+
+void click_scheduler_start(ClickScheduler* scheduler, const ClickPattern* pattern) {
+    furi_assert(scheduler);
+    furi_assert(pattern->beats_per_bar > 0);
+
+    // the speaker is held for the whole run, the interrupt only starts and stops it
+    scheduler->speaker = furi_hal_speaker_acquire(1000);
+    scheduler->pattern = *pattern;
+    scheduler->has_pending = false;
+    scheduler->beat = 0;
+    scheduler->poly_count = 0;
+    scheduler->click_on = false;
+    scheduler->jitter_last = 0;
+    scheduler->jitter_max = 0;
+
+    // 1 MHz free running counter
+    furi_hal_bus_enable(FuriHalBusTIM2);
+    LL_TIM_SetCounterMode(TIM2, LL_TIM_COUNTERMODE_UP);
+    LL_TIM_SetClockDivision(TIM2, LL_TIM_CLOCKDIVISION_DIV1);
+    LL_TIM_SetPrescaler(TIM2, furi_hal_cortex_instructions_per_microsecond() - 1);
+    LL_TIM_SetAutoReload(TIM2, 0xFFFFFFFF);
+    LL_TIM_OC_SetMode(TIM2, LL_TIM_CHANNEL_CH1, LL_TIM_OCMODE_FROZEN);
+    LL_TIM_GenerateEvent_UPDATE(TIM2);
+    LL_TIM_SetCounter(TIM2, 0);
+
+    scheduler->next_beat = START_DELAY_US;
+    scheduler->next_beat_frac = 0;
+    LL_TIM_OC_SetCompareCH1(TIM2, scheduler->next_beat);
+    LL_TIM_ClearFlag_CC1(TIM2);
+
+    furi_hal_interrupt_set_isr(FuriHalInterruptIdTIM2, click_scheduler_isr, scheduler);
+    LL_TIM_EnableIT_CC1(TIM2);
+    LL_TIM_EnableCounter(TIM2);
+}
+
+void click_scheduler_stop(ClickScheduler* scheduler) {
+    furi_assert(scheduler);
+
+    LL_TIM_DisableIT_CC1(TIM2);
+    LL_TIM_DisableCounter(TIM2);
+    furi_hal_interrupt_set_isr(FuriHalInterruptIdTIM2, NULL, NULL);
+    furi_hal_bus_disable(FuriHalBusTIM2);
+
+    click_scheduler_click_off(scheduler);
+    if(scheduler->speaker) {
+        furi_hal_speaker_release();
+        scheduler->speaker = false;
+    }
+}
+
+void click_scheduler_set_pattern(ClickScheduler* scheduler, const ClickPattern* pattern) {
+    furi_assert(scheduler);
+    furi_assert(pattern->beats_per_bar > 0);
+
+    FURI_CRITICAL_ENTER();
+    scheduler->pending = *pattern;
+    scheduler->has_pending = true;
+    FURI_CRITICAL_EXIT();
+}
+
+void click_scheduler_get_jitter(ClickScheduler* scheduler, uint32_t* last, uint32_t* max) {
+    furi_assert(scheduler);
+
+    FURI_CRITICAL_ENTER();
+    *last = scheduler->jitter_last;
+    *max = scheduler->jitter_max;
+    FURI_CRITICAL_EXIT();
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <furi.h>
+
+// Beats are scheduled on TIM2 against absolute deadlines, so the beat doesn't drift and clicks
+// start and stop in the timer interrupt instead of a sleeping thread.
+
+typedef enum {
+    ClickOutputSpeaker,
+    ClickOutputVibro,
+    ClickOutputNone,
+} ClickOutput;
+
+typedef struct {
+    uint32_t beat_us; // beat period in 1/16 us
+    uint8_t beats_per_bar;
+    uint8_t poly; // clicks of the second voice spread over a bar, 0 to turn it off
+    ClickOutput output;
+} ClickPattern;
+
+typedef enum {
+    ClickEventBeat, // a beat of the main voice, beat 0 starts a bar
+    ClickEventPoly, // a click of the second voice
+    ClickEventClickEnd,
+} ClickEvent;
+
+// Called from the timer interrupt, must not block
+typedef void (*ClickSchedulerCallback)(ClickEvent event, uint8_t beat, void* context);
+
+typedef struct ClickScheduler ClickScheduler;
+
+// Returns the beat period of a tempo, in the unit ClickPattern.beat_us expects
+uint32_t click_scheduler_beat_period(double bpm, int note_length);
+
+ClickScheduler* click_scheduler_alloc(ClickSchedulerCallback callback, void* context);
+void click_scheduler_free(ClickScheduler* scheduler);
+
+// The first beat sounds right away
+void click_scheduler_start(ClickScheduler* scheduler, const ClickPattern* pattern);
+void click_scheduler_stop(ClickScheduler* scheduler);
+
+// The new pattern is used from the next beat on
+void click_scheduler_set_pattern(ClickScheduler* scheduler, const ClickPattern* pattern);
+
+// How late the last beat and the latest beat since the start sounded, in us
+void click_scheduler_get_jitter(ClickScheduler* scheduler, uint32_t* last, uint32_t* max);
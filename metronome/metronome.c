@@ -11,13 +11,26 @@
 #include <notification/notification.h>
 #include <notification/notification_messages.h>
 
+#include <storage/storage.h>
+#include <flipper_format/flipper_format.h>
+
 #include "gui_extensions.h"
+#include "click_scheduler.h"
 
 #define BPM_STEP_SIZE_FINE 0.5d
 #define BPM_STEP_SIZE_COARSE 10.0d
 #define BPM_BOUNDARY_LOW 10.0d
 #define BPM_BOUNDARY_HIGH 300.0d
-#define BEEP_DELAY_MS 50
+// speed trainer: the tempo goes up by RAMP_STEP every RAMP_BARS bars, up to RAMP_RANGE above
+// the tempo it was started at
+#define RAMP_STEP 5.0d
+#define RAMP_BARS 4
+#define RAMP_RANGE 40.0d
+
+// written by the BPM Tapper, used once on the next start
+#define TEMPO_FILE_NAME "tempo.txt"
+#define TEMPO_FILE_TYPE "Metronome Tempo"
+#define TEMPO_FILE_VERSION 1
 
 #define wave_bitmap_left_width 4
 #define wave_bitmap_left_height 14
@@ -32,11 +45,15 @@ static uint8_t wave_bitmap_right_bits[] =
 typedef enum {
     EventTypeTick,
     EventTypeKey,
+    EventTypeBeat,
+    EventTypePoly,
+    EventTypeClickEnd,
 } EventType;
 
 typedef struct {
     EventType type;
     InputEvent input;
+    uint8_t beat;
 } PluginEvent;
 
 enum OutputMode { Loud, Vibro, Silent };
@@ -47,8 +64,12 @@ typedef struct {
     int beats_per_bar;
     int note_length;
     int current_beat;
+    int poly; // clicks of a second voice over a bar, 0 if off
+    bool ramp;
+    double ramp_target;
+    int ramp_bars;
     enum OutputMode output_mode;
-    FuriTimer* timer;
+    ClickScheduler* scheduler;
     NotificationApp* notifications;
     FuriMutex* mutex;
 } MetronomeState;
@@ -65,8 +86,18 @@ static void render_callback(Canvas* const canvas, void* ctx) {
     canvas_set_font(canvas, FontPrimary);
 
     // draw bars/beat
-    furi_string_printf(
-        tempStr, "%d/%d", metronome_state->beats_per_bar, metronome_state->note_length);
+    if(metronome_state->poly) {
+        furi_string_printf(
+            tempStr,
+            "%d/%d %d:%d",
+            metronome_state->beats_per_bar,
+            metronome_state->note_length,
+            metronome_state->poly,
+            metronome_state->beats_per_bar);
+    } else {
+        furi_string_printf(
+            tempStr, "%d/%d", metronome_state->beats_per_bar, metronome_state->note_length);
+    }
     canvas_draw_str_aligned(
         canvas, 64, 8, AlignCenter, AlignCenter, furi_string_get_cstr(tempStr));
     furi_string_reset(tempStr);
@@ -125,7 +156,23 @@ static void render_callback(Canvas* const canvas, void* ctx) {
 
     // draw progress bar
     elements_progress_bar(
-        canvas, 8, 36, 112, (float)metronome_state->current_beat / metronome_state->beats_per_bar);
+        canvas, 8, 34, 112, (float)metronome_state->current_beat / metronome_state->beats_per_bar);
+
+    // draw how late the beats sound and the speed trainer
+    if(metronome_state->playing) {
+        uint32_t jitter_last, jitter_max;
+        click_scheduler_get_jitter(metronome_state->scheduler, &jitter_last, &jitter_max);
+        furi_string_printf(tempStr, "jitter %lu/%luus", jitter_last, jitter_max);
+        canvas_draw_str_aligned(
+            canvas, 8, 51, AlignLeft, AlignBottom, furi_string_get_cstr(tempStr));
+        furi_string_reset(tempStr);
+    }
+    if(metronome_state->ramp) {
+        furi_string_printf(tempStr, "to %.0f", metronome_state->ramp_target);
+        canvas_draw_str_aligned(
+            canvas, 120, 51, AlignRight, AlignBottom, furi_string_get_cstr(tempStr));
+        furi_string_reset(tempStr);
+    }
 
     // cleanup
     furi_string_free(tempStr);
@@ -139,87 +186,69 @@ static void input_callback(InputEvent* input_event, FuriMessageQueue* event_queu
     furi_message_queue_put(event_queue, &event, FuriWaitForever);
 }
 
-static void timer_callback(void* ctx) {
-    // this is where we go BEEP!
-    furi_assert(ctx);
-    MetronomeState* metronome_state = ctx;
-    furi_mutex_acquire(metronome_state->mutex, FuriWaitForever);
-
-    metronome_state->current_beat++;
-    if(metronome_state->current_beat > metronome_state->beats_per_bar) {
-        metronome_state->current_beat = 1;
+// called from the timer interrupt
+static void click_callback(ClickEvent click_event, uint8_t beat, void* ctx) {
+    FuriMessageQueue* event_queue = ctx;
+    PluginEvent event = {.beat = beat};
+    switch(click_event) {
+    case ClickEventBeat:
+        event.type = EventTypeBeat;
+        break;
+    case ClickEventPoly:
+        event.type = EventTypePoly;
+        break;
+    default:
+        event.type = EventTypeClickEnd;
+        break;
     }
-    if(metronome_state->current_beat == 1) {
-        // pronounced beat
-        notification_message(metronome_state->notifications, &sequence_set_only_red_255);
-        switch(metronome_state->output_mode) {
-        case Loud:
-            if(furi_hal_speaker_acquire(1000)) {
-                furi_hal_speaker_start(440.0f, 1.0f);
-            }
-            break;
-        case Vibro:
-            notification_message(metronome_state->notifications, &sequence_set_vibro_on);
-            break;
-        case Silent:
-            break;
-        }
-    } else {
-        // unpronounced beat
-        notification_message(metronome_state->notifications, &sequence_set_only_green_255);
-        switch(metronome_state->output_mode) {
-        case Loud:
-            if(furi_hal_speaker_acquire(1000)) {
-                furi_hal_speaker_start(220.0f, 1.0f);
-            }
-            break;
-        case Vibro:
-            notification_message(metronome_state->notifications, &sequence_set_vibro_on);
-            break;
-        case Silent:
-            break;
-        }
-    };
+    furi_message_queue_put(event_queue, &event, 0);
+}
 
-    // this is a bit of a kludge... if we are on vibro and unpronounced, stop vibro after half the usual duration
+static void state_to_pattern(MetronomeState* metronome_state, ClickPattern* pattern) {
+    pattern->beat_us =
+        click_scheduler_beat_period(metronome_state->bpm, metronome_state->note_length);
+    pattern->beats_per_bar = metronome_state->beats_per_bar;
+    pattern->poly = metronome_state->poly;
     switch(metronome_state->output_mode) {
     case Loud:
-        furi_delay_ms(BEEP_DELAY_MS);
-        if(furi_hal_speaker_is_mine()) {
-            furi_hal_speaker_stop();
-            furi_hal_speaker_release();
-        }
+        pattern->output = ClickOutputSpeaker;
         break;
     case Vibro:
-        if(metronome_state->current_beat == 1) {
-            furi_delay_ms(BEEP_DELAY_MS);
-            notification_message(metronome_state->notifications, &sequence_reset_vibro);
-        } else {
-            furi_delay_ms((int)BEEP_DELAY_MS / 2);
-            notification_message(metronome_state->notifications, &sequence_reset_vibro);
-            furi_delay_ms((int)BEEP_DELAY_MS / 2);
-        }
+        pattern->output = ClickOutputVibro;
         break;
-    case Silent:
+    default:
+        pattern->output = ClickOutputNone;
         break;
     }
-    notification_message(metronome_state->notifications, &sequence_reset_rgb);
-
-    furi_mutex_release(metronome_state->mutex);
 }
 
-static uint32_t state_to_sleep_ticks(MetronomeState* metronome_state) {
-    // calculate time between beeps
-    uint32_t tps = furi_kernel_get_tick_frequency();
-    double multiplier = 4.0d / metronome_state->note_length;
-    double bps = (double)metronome_state->bpm / 60;
-    return (uint32_t)(round(tps / bps) - ((BEEP_DELAY_MS / 1000) * tps)) * multiplier;
+static void update_timer(MetronomeState* metronome_state) {
+    if(metronome_state->playing) {
+        ClickPattern pattern;
+        state_to_pattern(metronome_state, &pattern);
+        click_scheduler_set_pattern(metronome_state->scheduler, &pattern);
+    }
 }
 
-static void update_timer(MetronomeState* metronome_state) {
-    if(furi_timer_is_running(metronome_state->timer)) {
-        furi_timer_stop(metronome_state->timer);
-        furi_timer_start(metronome_state->timer, state_to_sleep_ticks(metronome_state));
+static void on_beat(MetronomeState* metronome_state, uint8_t beat) {
+    // LEDs are too slow for the interrupt, they follow the beat from here
+    metronome_state->current_beat = beat + 1;
+    if(beat == 0) {
+        // pronounced beat
+        notification_message(metronome_state->notifications, &sequence_set_only_red_255);
+    } else {
+        // unpronounced beat
+        notification_message(metronome_state->notifications, &sequence_set_only_green_255);
+    }
+
+    if(beat == 0 && metronome_state->ramp && ++metronome_state->ramp_bars > RAMP_BARS) {
+        metronome_state->ramp_bars = 1;
+        metronome_state->bpm += RAMP_STEP;
+        if(metronome_state->bpm >= metronome_state->ramp_target) {
+            metronome_state->bpm = metronome_state->ramp_target;
+            metronome_state->ramp = false;
+        }
+        update_timer(metronome_state);
     }
 }
 
@@ -244,6 +273,25 @@ static void cycle_beats_per_bar(MetronomeState* metronome_state) {
     if(metronome_state->beats_per_bar > metronome_state->note_length) {
         metronome_state->beats_per_bar = 1;
     }
+    update_timer(metronome_state);
+}
+
+static void cycle_poly(MetronomeState* metronome_state) {
+    // off, then 2 to 7 clicks against the bar
+    metronome_state->poly = metronome_state->poly ? metronome_state->poly + 1 : 2;
+    if(metronome_state->poly > 7) {
+        metronome_state->poly = 0;
+    }
+    update_timer(metronome_state);
+}
+
+static void toggle_ramp(MetronomeState* metronome_state) {
+    metronome_state->ramp = !metronome_state->ramp;
+    metronome_state->ramp_bars = 0;
+    metronome_state->ramp_target = metronome_state->bpm + RAMP_RANGE;
+    if(metronome_state->ramp_target > (double)BPM_BOUNDARY_HIGH) {
+        metronome_state->ramp_target = BPM_BOUNDARY_HIGH;
+    }
 }
 
 static void cycle_note_length(MetronomeState* metronome_state) {
@@ -260,6 +308,21 @@ static void cycle_output_mode(MetronomeState* metronome_state) {
     if(metronome_state->output_mode > Silent) {
         metronome_state->output_mode = Loud;
     }
+    update_timer(metronome_state);
+}
+
+static void toggle_playing(MetronomeState* metronome_state) {
+    metronome_state->playing = !metronome_state->playing;
+    if(metronome_state->playing) {
+        ClickPattern pattern;
+        state_to_pattern(metronome_state, &pattern);
+        metronome_state->ramp_bars = 0;
+        click_scheduler_start(metronome_state->scheduler, &pattern);
+    } else {
+        click_scheduler_stop(metronome_state->scheduler);
+        metronome_state->current_beat = 0;
+        notification_message(metronome_state->notifications, &sequence_reset_rgb);
+    }
 }
 
 static void metronome_state_init(MetronomeState* const metronome_state) {
@@ -268,16 +331,45 @@ static void metronome_state_init(MetronomeState* const metronome_state) {
     metronome_state->beats_per_bar = 4;
     metronome_state->note_length = 4;
     metronome_state->current_beat = 0;
+    metronome_state->poly = 0;
+    metronome_state->ramp = false;
+    metronome_state->ramp_target = 0;
+    metronome_state->ramp_bars = 0;
     metronome_state->output_mode = Loud;
     metronome_state->notifications = furi_record_open(RECORD_NOTIFICATION);
     metronome_state->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
 }
 
+static void load_tapped_tempo(MetronomeState* metronome_state) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    FlipperFormat* file = flipper_format_file_alloc(storage);
+    FuriString* file_type = furi_string_alloc();
+    uint32_t version = 0;
+    float bpm = 0;
+
+    if(flipper_format_file_open_existing(file, APP_DATA_PATH(TEMPO_FILE_NAME)) &&
+       flipper_format_read_header(file, file_type, &version) &&
+       furi_string_cmp_str(file_type, TEMPO_FILE_TYPE) == 0 && version == TEMPO_FILE_VERSION &&
+       flipper_format_read_float(file, "BPM", &bpm, 1)) {
+        // round to the fine step
+        double tempo = round(bpm / BPM_STEP_SIZE_FINE) * BPM_STEP_SIZE_FINE;
+        if(tempo >= (double)BPM_BOUNDARY_LOW && tempo <= (double)BPM_BOUNDARY_HIGH) {
+            metronome_state->bpm = tempo;
+        }
+    }
+
+    furi_string_free(file_type);
+    flipper_format_free(file);
+    storage_simply_remove(storage, APP_DATA_PATH(TEMPO_FILE_NAME));
+    furi_record_close(RECORD_STORAGE);
+}
+
 int32_t metronome_app() {
     FuriMessageQueue* event_queue = furi_message_queue_alloc(8, sizeof(PluginEvent));
 
     MetronomeState* metronome_state = malloc(sizeof(MetronomeState));
     metronome_state_init(metronome_state);
+    load_tapped_tempo(metronome_state);
 
     if(!metronome_state->mutex) {
         FURI_LOG_E("Metronome", "cannot create mutex\r\n");
@@ -289,8 +381,7 @@ int32_t metronome_app() {
     ViewPort* view_port = view_port_alloc();
     view_port_draw_callback_set(view_port, render_callback, metronome_state);
     view_port_input_callback_set(view_port, input_callback, event_queue);
-    metronome_state->timer =
-        furi_timer_alloc(timer_callback, FuriTimerTypePeriodic, metronome_state);
+    metronome_state->scheduler = click_scheduler_alloc(click_callback, event_queue);
 
     // Open GUI and register view_port
     Gui* gui = furi_record_open(RECORD_GUI);
@@ -320,13 +411,7 @@ int32_t metronome_app() {
                         decrease_bpm(metronome_state, BPM_STEP_SIZE_FINE);
                         break;
                     case InputKeyOk:
-                        metronome_state->playing = !metronome_state->playing;
-                        if(metronome_state->playing) {
-                            furi_timer_start(
-                                metronome_state->timer, state_to_sleep_ticks(metronome_state));
-                        } else {
-                            furi_timer_stop(metronome_state->timer);
-                        }
+                        toggle_playing(metronome_state);
                         break;
                     case InputKeyBack:
                         processing = false;
@@ -341,6 +426,7 @@ int32_t metronome_app() {
                         cycle_note_length(metronome_state);
                         break;
                     case InputKeyDown:
+                        toggle_ramp(metronome_state);
                         break;
                     case InputKeyRight:
                         increase_bpm(metronome_state, BPM_STEP_SIZE_COARSE);
@@ -349,6 +435,7 @@ int32_t metronome_app() {
                         decrease_bpm(metronome_state, BPM_STEP_SIZE_COARSE);
                         break;
                     case InputKeyOk:
+                        cycle_poly(metronome_state);
                         break;
                     case InputKeyBack:
                         processing = false;
@@ -378,6 +465,12 @@ int32_t metronome_app() {
                         break;
                     }
                 }
+            } else if(event.type == EventTypeBeat) {
+                on_beat(metronome_state, event.beat);
+            } else if(event.type == EventTypePoly) {
+                notification_message(metronome_state->notifications, &sequence_set_only_blue_255);
+            } else if(event.type == EventTypeClickEnd) {
+                notification_message(metronome_state->notifications, &sequence_reset_rgb);
             }
         }
 
@@ -385,12 +478,16 @@ int32_t metronome_app() {
         view_port_update(view_port);
     }
 
+    if(metronome_state->playing) {
+        click_scheduler_stop(metronome_state->scheduler);
+    }
+
     view_port_enabled_set(view_port, false);
     gui_remove_view_port(gui, view_port);
     furi_record_close(RECORD_GUI);
     view_port_free(view_port);
+    click_scheduler_free(metronome_state->scheduler);
     furi_message_queue_free(event_queue);
-    furi_timer_free(metronome_state->timer);
     furi_record_close(RECORD_NOTIFICATION);
     furi_mutex_free(metronome_state->mutex);
     free(metronome_state);
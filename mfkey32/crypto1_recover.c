@@ -0,0 +1,648 @@
+#pragma GCC optimize("O3")
+#pragma GCC optimize("-funroll-all-loops")
+
+#include "crypto1_recover.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define LF_POLY_ODD (0x29CE5C)
+#define LF_POLY_EVEN (0x870804)
+#define CONST_M1_1 (LF_POLY_EVEN << 1 | 1)
+#define CONST_M2_1 (LF_POLY_ODD << 1)
+#define CONST_M1_2 (LF_POLY_ODD)
+#define CONST_M2_2 (LF_POLY_EVEN << 1 | 1)
+#define BIT(x, n) ((x) >> (n)&1)
+#define BEBIT(x, n) BIT(x, (n) ^ 24)
+#define SWAPENDIAN(x) \
+    ((x) = ((x) >> 8 & 0xff00ff) | ((x)&0xff00ff) << 8, (x) = (x) >> 16 | (x) << 16)
+
+static const uint8_t table[256] = {
+    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3,
+    4, 4, 5, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4,
+    4, 5, 4, 5, 5, 6, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 2, 3, 3, 4, 3, 4, 4,
+    5, 3, 4, 4, 5, 4, 5, 5, 6, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 3, 4, 4, 5,
+    4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 2,
+    3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5,
+    5, 6, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4,
+    5, 4, 5, 5, 6, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7, 3, 4, 4, 5, 4, 5, 5, 6,
+    4, 5, 5, 6, 5, 6, 6, 7, 4, 5, 5, 6, 5, 6, 6, 7, 5, 6, 6, 7, 6, 7, 7, 8};
+static const uint8_t lookup1[256] = {
+    0, 0,  16, 16, 0,  16, 0,  0,  0, 16, 0,  0,  16, 16, 16, 16, 0, 0,  16, 16, 0,  16, 0,  0,
+    0, 16, 0,  0,  16, 16, 16, 16, 0, 0,  16, 16, 0,  16, 0,  0,  0, 16, 0,  0,  16, 16, 16, 16,
+    8, 8,  24, 24, 8,  24, 8,  8,  8, 24, 8,  8,  24, 24, 24, 24, 8, 8,  24, 24, 8,  24, 8,  8,
+    8, 24, 8,  8,  24, 24, 24, 24, 8, 8,  24, 24, 8,  24, 8,  8,  8, 24, 8,  8,  24, 24, 24, 24,
+    0, 0,  16, 16, 0,  16, 0,  0,  0, 16, 0,  0,  16, 16, 16, 16, 0, 0,  16, 16, 0,  16, 0,  0,
+    0, 16, 0,  0,  16, 16, 16, 16, 8, 8,  24, 24, 8,  24, 8,  8,  8, 24, 8,  8,  24, 24, 24, 24,
+    0, 0,  16, 16, 0,  16, 0,  0,  0, 16, 0,  0,  16, 16, 16, 16, 0, 0,  16, 16, 0,  16, 0,  0,
+    0, 16, 0,  0,  16, 16, 16, 16, 8, 8,  24, 24, 8,  24, 8,  8,  8, 24, 8,  8,  24, 24, 24, 24,
+    8, 8,  24, 24, 8,  24, 8,  8,  8, 24, 8,  8,  24, 24, 24, 24, 0, 0,  16, 16, 0,  16, 0,  0,
+    0, 16, 0,  0,  16, 16, 16, 16, 8, 8,  24, 24, 8,  24, 8,  8,  8, 24, 8,  8,  24, 24, 24, 24,
+    8, 8,  24, 24, 8,  24, 8,  8,  8, 24, 8,  8,  24, 24, 24, 24};
+static const uint8_t lookup2[256] = {
+    0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4,
+    4, 4, 4, 2, 2, 6, 6, 2, 6, 2, 2, 2, 6, 2, 2, 6, 6, 6, 6, 2, 2, 6, 6, 2, 6, 2, 2, 2, 6,
+    2, 2, 6, 6, 6, 6, 0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 2, 2, 6, 6, 2, 6, 2,
+    2, 2, 6, 2, 2, 6, 6, 6, 6, 0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 0, 0, 4, 4,
+    0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 2,
+    2, 6, 6, 2, 6, 2, 2, 2, 6, 2, 2, 6, 6, 6, 6, 0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4,
+    4, 4, 0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 2, 2, 6, 6, 2, 6, 2, 2, 2, 6, 2,
+    2, 6, 6, 6, 6, 2, 2, 6, 6, 2, 6, 2, 2, 2, 6, 2, 2, 6, 6, 6, 6, 2, 2, 6, 6, 2, 6, 2, 2,
+    2, 6, 2, 2, 6, 6, 6, 6, 2, 2, 6, 6, 2, 6, 2, 2, 2, 6, 2, 2, 6, 6, 6, 6};
+
+uint32_t prng_successor(uint32_t x, uint32_t n) {
+    SWAPENDIAN(x);
+    while(n--) x = x >> 1 | (x >> 16 ^ x >> 18 ^ x >> 19 ^ x >> 21) << 31;
+    return SWAPENDIAN(x);
+}
+
+static inline int filter(uint32_t const x) {
+    uint32_t f;
+    f = lookup1[x & 0xff] | lookup2[(x >> 8) & 0xff];
+    f |= 0x0d938 >> (x >> 16 & 0xf) & 1;
+    return BIT(0xEC57E80A, f);
+}
+
+static inline uint8_t evenparity32(uint32_t x) {
+    if((table[x & 0xff] + table[(x >> 8) & 0xff] + table[(x >> 16) & 0xff] + table[x >> 24]) % 2 ==
+       0) {
+        return 0;
+    } else {
+        return 1;
+    }
+    //return ((table[x & 0xff] + table[(x >> 8) & 0xff] + table[(x >> 16) & 0xff] + table[x >> 24]) % 2) & 0xFF;
+}
+
+static inline void update_contribution(unsigned int data[], int item, int mask1, int mask2) {
+    int p = data[item] >> 25;
+    p = p << 1 | evenparity32(data[item] & mask1);
+    p = p << 1 | evenparity32(data[item] & mask2);
+    data[item] = p << 24 | (data[item] & 0xffffff);
+}
+
+static void crypto1_get_lfsr(struct Crypto1State* state, uint64_t* lfsr) {
+    int i;
+    for(*lfsr = 0, i = 23; i >= 0; --i) {
+        *lfsr = *lfsr << 1 | BIT(state->odd, i ^ 3);
+        *lfsr = *lfsr << 1 | BIT(state->even, i ^ 3);
+    }
+}
+
+static inline uint32_t crypt_word(struct Crypto1State* s) {
+    // "in" and "x" are always 0 (last iteration)
+    uint32_t res_ret = 0;
+    uint32_t feedin, t;
+    for(int i = 0; i <= 31; i++) {
+        res_ret |= (filter(s->odd) << (24 ^ i)); //-V629
+        feedin = LF_POLY_EVEN & s->even;
+        feedin ^= LF_POLY_ODD & s->odd;
+        s->even = s->even << 1 | (evenparity32(feedin));
+        t = s->odd, s->odd = s->even, s->even = t;
+    }
+    return res_ret;
+}
+
+static inline void crypt_word_noret(struct Crypto1State* s, uint32_t in, int x) {
+    uint8_t ret;
+    uint32_t feedin, t, next_in;
+    for(int i = 0; i <= 31; i++) {
+        next_in = BEBIT(in, i);
+        ret = filter(s->odd);
+        feedin = ret & (!!x);
+        feedin ^= LF_POLY_EVEN & s->even;
+        feedin ^= LF_POLY_ODD & s->odd;
+        feedin ^= !!next_in;
+        s->even = s->even << 1 | (evenparity32(feedin));
+        t = s->odd, s->odd = s->even, s->even = t;
+    }
+    return;
+}
+
+static inline void rollback_word_noret(struct Crypto1State* s, uint32_t in, int x) {
+    uint8_t ret;
+    uint32_t feedin, t, next_in;
+    for(int i = 31; i >= 0; i--) {
+        next_in = BEBIT(in, i);
+        s->odd &= 0xffffff;
+        t = s->odd, s->odd = s->even, s->even = t;
+        ret = filter(s->odd);
+        feedin = ret & (!!x);
+        feedin ^= s->even & 1;
+        feedin ^= LF_POLY_EVEN & (s->even >>= 1);
+        feedin ^= LF_POLY_ODD & s->odd;
+        feedin ^= !!next_in;
+        s->even |= (evenparity32(feedin)) << 23;
+    }
+    return;
+}
+
+int key_already_found_for_nonce(
+    uint64_t* keyarray,
+    int keyarray_size,
+    uint32_t uid_xor_nt1,
+    uint32_t nr1_enc,
+    uint32_t p64b,
+    uint32_t ar1_enc) {
+    for(int k = 0; k < keyarray_size; k++) {
+        struct Crypto1State temp = {0, 0};
+
+        for(int i = 0; i < 24; i++) {
+            (&temp)->odd |= (BIT(keyarray[k], 2 * i + 1) << (i ^ 3));
+            (&temp)->even |= (BIT(keyarray[k], 2 * i) << (i ^ 3));
+        }
+
+        crypt_word_noret(&temp, uid_xor_nt1, 0);
+        crypt_word_noret(&temp, nr1_enc, 1);
+
+        if(ar1_enc == (crypt_word(&temp) ^ p64b)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int check_state(struct Crypto1State* t, struct Crypto1Params* p) {
+    if(!(t->odd | t->even)) return 0;
+    rollback_word_noret(t, 0, 0);
+    rollback_word_noret(t, p->nr0_enc, 1);
+    rollback_word_noret(t, p->uid_xor_nt0, 0);
+    struct Crypto1State temp = {t->odd, t->even};
+    crypt_word_noret(t, p->uid_xor_nt1, 0);
+    crypt_word_noret(t, p->nr1_enc, 1);
+    if(p->ar1_enc == (crypt_word(t) ^ p->p64b)) {
+        crypto1_get_lfsr(&temp, &(p->key));
+        return 1;
+    }
+    return 0;
+}
+
+// Bit-sliced check_state(): the leaves of old_recover() produce candidates
+// that are all checked against the same nonce, so they are collected 32 at
+// a time and stepped together, one candidate per bit of each 32-bit word.
+// The LFSR is kept as its bit history: h[u] is the newest bit of the state
+// at time u, whose odd register bit k is h[u - 2k] and even register bit k
+// is h[u - 1 - 2k]. The 96 rolled back and the 96 produced bits all fit in
+// a 48 + 96 words window, so no shifting is needed. Surviving lanes are
+// confirmed with check_state(), which also extracts the key.
+#define BS_LANES (32)
+#define BS_HISTORY (48 + 96)
+
+struct Crypto1Batch {
+    uint32_t odd[BS_LANES];
+    uint32_t even[BS_LANES];
+    int count;
+    uint32_t history[BS_HISTORY];
+    uint32_t scratch[BS_LANES]; // kept off the small worker thread stack
+};
+
+// Filter sub functions 0xf22c and 0xd938, and 0xEC57E80A split on e
+static inline uint32_t bs_fa(uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+    return c ^ ((b | (a ^ c)) & ~(d ^ (a & ~b)));
+}
+
+static inline uint32_t bs_fb(uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+    return a ^ (b ^ ((a ^ (c ^ d)) | (c ^ (a | b))));
+}
+
+static inline uint32_t bs_fc(uint32_t a, uint32_t b, uint32_t c, uint32_t d, uint32_t e) {
+    uint32_t f0 = a ^ ((a ^ (b & d)) & ~(a ^ (c ^ d)));
+    uint32_t g = a ^ ((a ^ d) & ~(a ^ (b & ~c)));
+    return f0 ^ (e & ~g);
+}
+
+// filter() of the odd register of the state whose newest bit is h[0]
+static inline uint32_t bs_filter(const uint32_t* h) {
+    uint32_t f4 = bs_fa(h[0], h[-2], h[-4], h[-6]);
+    uint32_t f3 = bs_fb(h[-8], h[-10], h[-12], h[-14]);
+    uint32_t f2 = bs_fa(h[-16], h[-18], h[-20], h[-22]);
+    uint32_t f1 = bs_fa(h[-24], h[-26], h[-28], h[-30]);
+    uint32_t f0 = bs_fb(h[-32], h[-34], h[-36], h[-38]);
+    return bs_fc(f0, f1, f2, f3, f4);
+}
+
+// LF_POLY_ODD and LF_POLY_EVEN taps of the state whose newest bit is h[0],
+// except the oldest bit (even bit 23, h[-47]) that is shifted out
+static inline uint32_t bs_feedback(const uint32_t* h) {
+    // Odd bits 2, 3, 4, 6, 9, 10, 11, 14, 15, 16, 19, 21
+    uint32_t fb = h[-4] ^ h[-6] ^ h[-8] ^ h[-12] ^ h[-18] ^ h[-20] ^ h[-22] ^ h[-28] ^ h[-30] ^
+                  h[-32] ^ h[-38] ^ h[-42];
+    // Even bits 2, 11, 16, 17, 18
+    return fb ^ h[-5] ^ h[-23] ^ h[-33] ^ h[-35] ^ h[-37];
+}
+
+// Transpose a 32x32 bit matrix, so that a[k] bit j becomes a[j] bit k
+static void bs_transpose32(uint32_t a[32]) {
+    uint32_t m = 0x0000FFFF;
+    for(int j = 16; j != 0; j >>= 1, m ^= (m << j)) {
+        for(int k = 0; k < 32; k = ((k | j) + 1) & ~j) {
+            uint32_t t = ((a[k] >> j) ^ a[k | j]) & m;
+            a[k] ^= t << j;
+            a[k | j] ^= t;
+        }
+    }
+}
+
+// rollback_word_noret() on all lanes, from the state whose newest bit is h[t]
+static inline int bs_rollback_word(uint32_t* h, int t, uint32_t in, int x) {
+    for(int i = 31; i >= 0; i--, t--) {
+        uint32_t w = h[t] ^ bs_feedback(&h[t - 1]) ^ (0 - BEBIT(in, i));
+        if(x) w ^= bs_filter(&h[t - 1]);
+        h[t - 48] = w;
+    }
+    return t;
+}
+
+// crypt_word_noret() on all lanes, from the state whose newest bit is h[u]
+static inline int bs_crypt_word(uint32_t* h, int u, uint32_t in, int x) {
+    for(int i = 0; i <= 31; i++, u++) {
+        uint32_t w = h[u - 47] ^ bs_feedback(&h[u]) ^ (0 - BEBIT(in, i));
+        if(x) w ^= bs_filter(&h[u]);
+        h[u + 1] = w;
+    }
+    return u;
+}
+
+// Check the collected candidates and empty the batch. Returns 1 with the
+// key in p->key if one of them is the right state.
+static int check_state_batch(struct Crypto1Batch* batch, struct Crypto1Params* p) {
+    int count = batch->count;
+    batch->count = 0;
+    if(count == 0) return 0;
+    for(int j = count; j < BS_LANES; j++) {
+        batch->odd[j] = 0;
+        batch->even[j] = 0;
+    }
+
+    // Load the candidates in the window, transposed
+    uint32_t* h = batch->history;
+    uint32_t* bits = batch->scratch;
+    memcpy(bits, batch->odd, sizeof(batch->scratch));
+    bs_transpose32(bits);
+    for(int k = 0; k < 24; k++) h[BS_HISTORY - 1 - 2 * k] = bits[k];
+    memcpy(bits, batch->even, sizeof(batch->scratch));
+    bs_transpose32(bits);
+    for(int k = 0; k < 24; k++) h[BS_HISTORY - 2 - 2 * k] = bits[k];
+
+    int t = BS_HISTORY - 1;
+    t = bs_rollback_word(h, t, 0, 0);
+    t = bs_rollback_word(h, t, p->nr0_enc, 1);
+    t = bs_rollback_word(h, t, p->uid_xor_nt0, 0);
+    t = bs_crypt_word(h, t, p->uid_xor_nt1, 0);
+    t = bs_crypt_word(h, t, p->nr1_enc, 1);
+
+    // crypt_word() compared bit by bit with ar1_enc, stopping as soon as
+    // all the lanes are rejected (unused lanes start rejected)
+    uint32_t ks = p->ar1_enc ^ p->p64b;
+    uint32_t rejected = count == BS_LANES ? 0 : ~((1U << count) - 1);
+    for(int i = 0; i <= 31; i++, t++) {
+        rejected |= bs_filter(&h[t]) ^ (0 - BIT(ks, 24 ^ i));
+        if(rejected == 0xFFFFFFFF) return 0;
+        if(i < 31) h[t + 1] = h[t - 47] ^ bs_feedback(&h[t]);
+    }
+
+    for(int j = 0; j < count; j++) {
+        if(BIT(rejected, j)) continue;
+        struct Crypto1State temp = {batch->odd[j], batch->even[j]};
+        if(check_state(&temp, p)) return 1;
+    }
+    return 0;
+}
+
+static inline int state_loop(unsigned int* states_buffer, int xks, int m1, int m2) {
+    int states_tail = 0;
+    int round = 0, s = 0, xks_bit = 0;
+
+    for(round = 1; round <= 12; round++) {
+        xks_bit = BIT(xks, round);
+
+        for(s = 0; s <= states_tail; s++) {
+            states_buffer[s] <<= 1;
+
+            if((filter(states_buffer[s]) ^ filter(states_buffer[s] | 1)) != 0) {
+                states_buffer[s] |= filter(states_buffer[s]) ^ xks_bit;
+                if(round > 4) {
+                    update_contribution(states_buffer, s, m1, m2);
+                }
+            } else if(filter(states_buffer[s]) == xks_bit) {
+                // TODO: Refactor
+                if(round > 4) {
+                    states_buffer[++states_tail] = states_buffer[s + 1];
+                    states_buffer[s + 1] = states_buffer[s] | 1;
+                    update_contribution(states_buffer, s, m1, m2);
+                    s++;
+                    update_contribution(states_buffer, s, m1, m2);
+                } else {
+                    states_buffer[++states_tail] = states_buffer[++s];
+                    states_buffer[s] = states_buffer[s - 1] | 1;
+                }
+            } else {
+                states_buffer[s--] = states_buffer[states_tail--];
+            }
+        }
+    }
+
+    return states_tail;
+}
+
+static int binsearch(unsigned int data[], int start, int stop) {
+    int mid, val = data[stop] & 0xff000000;
+    while(start != stop) {
+        mid = (stop - start) >> 1;
+        if((data[start + mid] ^ 0x80000000) > (val ^ 0x80000000))
+            stop = start + mid;
+        else
+            start += mid + 1;
+    }
+    return start;
+}
+static void quicksort(unsigned int array[], int low, int high) {
+    //if (SIZEOF(array) == 0)
+    //    return;
+    if(low >= high) return;
+    int middle = low + (high - low) / 2;
+    unsigned int pivot = array[middle];
+    int i = low, j = high;
+    while(i <= j) {
+        while(array[i] < pivot) {
+            i++;
+        }
+        while(array[j] > pivot) {
+            j--;
+        }
+        if(i <= j) { // swap
+            int temp = array[i];
+            array[i] = array[j];
+            array[j] = temp;
+            i++;
+            j--;
+        }
+    }
+    if(low < j) {
+        quicksort(array, low, j);
+    }
+    if(high > i) {
+        quicksort(array, i, high);
+    }
+}
+static int extend_table(unsigned int data[], int tbl, int end, int bit, int m1, int m2) {
+    for(data[tbl] <<= 1; tbl <= end; data[++tbl] <<= 1) {
+        if((filter(data[tbl]) ^ filter(data[tbl] | 1)) != 0) {
+            data[tbl] |= filter(data[tbl]) ^ bit;
+            update_contribution(data, tbl, m1, m2);
+        } else if(filter(data[tbl]) == bit) {
+            data[++end] = data[tbl + 1];
+            data[tbl + 1] = data[tbl] | 1;
+            update_contribution(data, tbl, m1, m2);
+            tbl++;
+            update_contribution(data, tbl, m1, m2);
+        } else {
+            data[tbl--] = data[end--];
+        }
+    }
+    return end;
+}
+
+static int old_recover(
+    unsigned int odd[],
+    int o_head,
+    int o_tail,
+    int oks,
+    unsigned int even[],
+    int e_head,
+    int e_tail,
+    int eks,
+    int rem,
+    int s,
+    struct Crypto1Params* p,
+    int first_run,
+    struct Crypto1Batch* batch) {
+    int o, e, i;
+    if(rem == -1) {
+        for(e = e_head; e <= e_tail; ++e) {
+            even[e] = (even[e] << 1) ^ evenparity32(even[e] & LF_POLY_EVEN);
+            for(o = o_head; o <= o_tail; ++o, ++s) {
+                batch->even[batch->count] = odd[o];
+                batch->odd[batch->count] = even[e] ^ evenparity32(odd[o] & LF_POLY_ODD);
+                if(++batch->count == BS_LANES && check_state_batch(batch, p)) {
+                    return -1;
+                }
+            }
+        }
+        return s;
+    }
+    if(first_run == 0) {
+        for(i = 0; (i < 4) && (rem-- != 0); i++) {
+            oks >>= 1;
+            eks >>= 1;
+            o_tail = extend_table(
+                odd, o_head, o_tail, oks & 1, LF_POLY_EVEN << 1 | 1, LF_POLY_ODD << 1);
+            if(o_head > o_tail) return s;
+            e_tail =
+                extend_table(even, e_head, e_tail, eks & 1, LF_POLY_ODD, LF_POLY_EVEN << 1 | 1);
+            if(e_head > e_tail) return s;
+        }
+    }
+    first_run = 0;
+    quicksort(odd, o_head, o_tail);
+    quicksort(even, e_head, e_tail);
+    while(o_tail >= o_head && e_tail >= e_head) {
+        if(((odd[o_tail] ^ even[e_tail]) >> 24) == 0) {
+            o_tail = binsearch(odd, o_head, o = o_tail);
+            e_tail = binsearch(even, e_head, e = e_tail);
+            s = old_recover(
+                odd, o_tail--, o, oks, even, e_tail--, e, eks, rem, s, p, first_run, batch);
+            if(s == -1) {
+                break;
+            }
+        } else if((odd[o_tail] ^ 0x80000000) > (even[e_tail] ^ 0x80000000)) {
+            o_tail = binsearch(odd, o_head, o_tail) - 1;
+        } else {
+            e_tail = binsearch(even, e_head, e_tail) - 1;
+        }
+    }
+    return s;
+}
+
+static inline bool should_stop(const Crypto1RecoverCallbacks* callbacks) {
+    return callbacks && callbacks->should_stop && callbacks->should_stop(callbacks->context);
+}
+
+// Returns 1 if the key was found, 0 if not, -1 if the search was aborted
+static int calculate_msb_tables(
+    int oks,
+    int eks,
+    int msb_round,
+    struct Crypto1Params* p,
+    unsigned int* states_buffer,
+    struct Msb* odd_msbs,
+    struct Msb* even_msbs,
+    unsigned int* temp_states_odd,
+    unsigned int* temp_states_even,
+    struct Crypto1Batch* batch,
+    int msb_limit,
+    const Crypto1RecoverCallbacks* callbacks) {
+    unsigned int msb_head = (msb_limit * msb_round); // msb_round ranges from 0 to (256/msb_limit)-1
+    unsigned int msb_tail = (msb_limit * (msb_round + 1));
+    int states_tail = 0, tail = 0;
+    int i = 0, j = 0, semi_state = 0, found = 0;
+    unsigned int msb = 0;
+    // TODO: Why is this necessary?
+    memset(odd_msbs, 0, msb_limit * sizeof(struct Msb));
+    memset(even_msbs, 0, msb_limit * sizeof(struct Msb));
+
+    for(semi_state = 1 << 20; semi_state >= 0; semi_state--) {
+        if(semi_state % 32768 == 0) {
+            if(should_stop(callbacks)) {
+                return -1;
+            }
+        }
+
+        if(filter(semi_state) == (oks & 1)) { //-V547
+            states_buffer[0] = semi_state;
+            states_tail = state_loop(states_buffer, oks, CONST_M1_1, CONST_M2_1);
+
+            for(i = states_tail; i >= 0; i--) {
+                msb = states_buffer[i] >> 24;
+                if((msb >= msb_head) && (msb < msb_tail)) {
+                    found = 0;
+                    for(j = 0; j < odd_msbs[msb - msb_head].tail - 1; j++) {
+                        if(odd_msbs[msb - msb_head].states[j] == states_buffer[i]) {
+                            found = 1;
+                            break;
+                        }
+                    }
+
+                    if(!found) {
+                        tail = odd_msbs[msb - msb_head].tail++;
+                        odd_msbs[msb - msb_head].states[tail] = states_buffer[i];
+                    }
+                }
+            }
+        }
+
+        if(filter(semi_state) == (eks & 1)) { //-V547
+            states_buffer[0] = semi_state;
+            states_tail = state_loop(states_buffer, eks, CONST_M1_2, CONST_M2_2);
+
+            for(i = 0; i <= states_tail; i++) {
+                msb = states_buffer[i] >> 24;
+                if((msb >= msb_head) && (msb < msb_tail)) {
+                    found = 0;
+
+                    for(j = 0; j < even_msbs[msb - msb_head].tail; j++) {
+                        if(even_msbs[msb - msb_head].states[j] == states_buffer[i]) {
+                            found = 1;
+                            break;
+                        }
+                    }
+
+                    if(!found) {
+                        tail = even_msbs[msb - msb_head].tail++;
+                        even_msbs[msb - msb_head].states[tail] = states_buffer[i];
+                    }
+                }
+            }
+        }
+    }
+
+    oks >>= 12;
+    eks >>= 12;
+
+    for(i = 0; i < msb_limit; i++) {
+        if(should_stop(callbacks)) {
+            return -1;
+        }
+        // TODO: Why is this necessary?
+        memset(temp_states_even, 0, sizeof(unsigned int) * TEMP_STATES_SIZE);
+        memset(temp_states_odd, 0, sizeof(unsigned int) * TEMP_STATES_SIZE);
+        memcpy(temp_states_odd, odd_msbs[i].states, odd_msbs[i].tail * sizeof(unsigned int));
+        memcpy(temp_states_even, even_msbs[i].states, even_msbs[i].tail * sizeof(unsigned int));
+        int res = old_recover(
+            temp_states_odd,
+            0,
+            odd_msbs[i].tail,
+            oks,
+            temp_states_even,
+            0,
+            even_msbs[i].tail,
+            eks,
+            3,
+            0,
+            p,
+            1,
+            batch);
+        // Check what's left in the batch before moving to the next msb
+        if(res == -1 || check_state_batch(batch, p)) {
+            return 1;
+        }
+        //odd_msbs[i].tail = 0;
+        //even_msbs[i].tail = 0;
+    }
+
+    return 0;
+}
+
+bool recover(
+    struct Crypto1Params* p,
+    int ks2,
+    int msb_limit,
+    int msb_start,
+    const Crypto1RecoverCallbacks* callbacks) {
+    bool found = false;
+    // The big tables first, while the largest free block is still whole
+    struct Msb* odd_msbs = (struct Msb*)malloc(msb_limit * sizeof(struct Msb));
+    struct Msb* even_msbs = (struct Msb*)malloc(msb_limit * sizeof(struct Msb));
+    unsigned int* states_buffer = malloc(sizeof(unsigned int) * STATES_BUFFER_SIZE);
+    unsigned int* temp_states_odd = malloc(sizeof(unsigned int) * TEMP_STATES_SIZE);
+    unsigned int* temp_states_even = malloc(sizeof(unsigned int) * TEMP_STATES_SIZE);
+    struct Crypto1Batch* batch = malloc(sizeof(struct Crypto1Batch));
+    batch->count = 0;
+    int oks = 0, eks = 0;
+    int i = 0, msb = 0;
+    for(i = 31; i >= 0; i -= 2) {
+        oks = oks << 1 | BEBIT(ks2, i);
+    }
+    for(i = 30; i >= 0; i -= 2) {
+        eks = eks << 1 | BEBIT(ks2, i);
+    }
+    for(msb = msb_start; msb <= ((256 / msb_limit) - 1); msb++) {
+        if(callbacks && callbacks->round_start) {
+            callbacks->round_start(callbacks->context, msb);
+        }
+        int res = calculate_msb_tables(
+            oks,
+            eks,
+            msb,
+            p,
+            states_buffer,
+            odd_msbs,
+            even_msbs,
+            temp_states_odd,
+            temp_states_even,
+            batch,
+            msb_limit,
+            callbacks);
+        if(res == 1) {
+            found = true;
+            break;
+        }
+        if(res == -1) {
+            break;
+        }
+        if(callbacks && callbacks->round_done) {
+            callbacks->round_done(callbacks->context, msb);
+        }
+    }
+    free(states_buffer);
+    free(odd_msbs);
+    free(even_msbs);
+    free(temp_states_odd);
+    free(temp_states_even);
+    free(batch);
+    return found;
+}
+
+size_t recover_ram_for_chunk(int msb_limit) {
+    return 2 * msb_limit * sizeof(struct Msb) +
+           sizeof(unsigned int) * (STATES_BUFFER_SIZE + 2 * TEMP_STATES_SIZE) +
+           sizeof(struct Crypto1Batch);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+// Crypto1 key recovery core of mfkey32, free of any Flipper API so that it
+// can be built both in the app and in the host batch tool (tools/)
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define STATES_BUFFER_SIZE (2 << 9)
+#define TEMP_STATES_SIZE (1280)
+
+struct Crypto1State {
+    uint32_t odd, even;
+};
+struct Crypto1Params {
+    uint64_t key;
+    uint32_t nr0_enc, uid_xor_nt0, uid_xor_nt1, nr1_enc, p64b, ar1_enc;
+};
+struct Msb {
+    int tail;
+    uint32_t states[768];
+};
+
+typedef struct {
+    // Polled during the search, return true to abort it
+    bool (*should_stop)(void* context);
+    // Called when msb round msb_round starts
+    void (*round_start)(void* context, int msb_round);
+    // Called when msb round msb_round is completed without finding the key
+    void (*round_done)(void* context, int msb_round);
+    void* context;
+} Crypto1RecoverCallbacks;
+
+uint32_t prng_successor(uint32_t x, uint32_t n);
+
+int key_already_found_for_nonce(
+    uint64_t* keyarray,
+    int keyarray_size,
+    uint32_t uid_xor_nt1,
+    uint32_t nr1_enc,
+    uint32_t p64b,
+    uint32_t ar1_enc);
+
+// Search the 256 msb values msb_limit at a time, starting from round msb_start.
+// Returns true with the key in p->key. Callbacks and their members can be NULL.
+bool recover(
+    struct Crypto1Params* p,
+    int ks2,
+    int msb_limit,
+    int msb_start,
+    const Crypto1RecoverCallbacks* callbacks);
+
+// Heap needed by recover() to search msb_limit msb values per round
+size_t recover_ram_for_chunk(int msb_limit);
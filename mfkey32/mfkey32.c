@@ -1,6 +1,3 @@
-#pragma GCC optimize("O3")
-#pragma GCC optimize("-funroll-all-loops")
-
 // TODO: Add keys to top of the user dictionary, not the bottom
 // TODO: More efficient dictionary bruteforce by scanning through hardcoded very common keys and previously found dictionary keys first?
 //       (a cache for napi_key_already_found_for_nonce)
@@ -24,43 +21,27 @@
 #include <lib/flipper_format/flipper_format.h>
 #include <dolphin/dolphin.h>
 #include <notification/notification_messages.h>
+#include "crypto1_recover.h"
+#include "key_cache.h"
 
 #define MF_CLASSIC_DICT_FLIPPER_PATH EXT_PATH("nfc/assets/mf_classic_dict.nfc")
 #define MF_CLASSIC_DICT_USER_PATH EXT_PATH("nfc/assets/mf_classic_dict_user.nfc")
 #define MF_CLASSIC_NONCE_PATH EXT_PATH("nfc/.mfkey32.log")
+#define MF_CLASSIC_CHECKPOINT_PATH EXT_PATH("nfc/.mfkey32.ckpt")
+#define MFKEY_CHECKPOINT_MAGIC (0x32334B4D) // "MK32"
 #define TAG "Mfkey32"
 #define NFC_MF_CLASSIC_KEY_LEN (13)
 
-#define MIN_RAM 115632
-#define LF_POLY_ODD (0x29CE5C)
-#define LF_POLY_EVEN (0x870804)
-#define CONST_M1_1 (LF_POLY_EVEN << 1 | 1)
-#define CONST_M2_1 (LF_POLY_ODD << 1)
-#define CONST_M1_2 (LF_POLY_ODD)
-#define CONST_M2_2 (LF_POLY_EVEN << 1 | 1)
-#define BIT(x, n) ((x) >> (n)&1)
-#define BEBIT(x, n) BIT(x, (n) ^ 24)
-#define SWAPENDIAN(x) \
-    ((x) = ((x) >> 8 & 0xff00ff) | ((x)&0xff00ff) << 8, (x) = (x) >> 16 | (x) << 16)
-//#define SIZEOF(arr) sizeof(arr) / sizeof(*arr)
+// Heap kept free while recover() runs, for the GUI, the checkpoint and key cache files, the
+// user dictionary stream and the key array growing as keys are found. malloc() crashes
+// instead of returning NULL, so this errs on the large side.
+#define RAM_RESERVE (16 * 1024)
 
 static int eta_round_time = 56;
 static int eta_total_time = 900;
-// MSB_LIMIT: Chunk size (out of 256)
+// MSB_LIMIT: Chunk size (out of 256), set by plan_msb_chunk() from the free heap
 static int MSB_LIMIT = 16;
 
-struct Crypto1State {
-    uint32_t odd, even;
-};
-struct Crypto1Params {
-    uint64_t key;
-    uint32_t nr0_enc, uid_xor_nt0, uid_xor_nt1, nr1_enc, p64b, ar1_enc;
-};
-struct Msb {
-    int tail;
-    uint32_t states[768];
-};
-
 typedef enum {
     EventTypeTick,
     EventTypeKey,
@@ -103,6 +84,7 @@ typedef struct {
     bool is_thread_running;
     bool close_thread_please;
     FuriThread* mfkeythread;
+    struct MfkeyCheckpoint* checkpoint;
 } ProgramState;
 
 // TODO: Merge this with Crypto1Params?
@@ -114,6 +96,8 @@ typedef struct {
     uint32_t ar0_enc; // first encrypted reader response
     uint32_t nr1_enc; // second encrypted reader challenge
     uint32_t ar1_enc; // second encrypted reader response
+    uint16_t sector;
+    uint16_t key_type; // 0 for key A, 1 for key B
 } MfClassicNonce;
 
 typedef struct {
@@ -133,489 +117,75 @@ typedef struct {
     uint32_t total_keys;
 } MfClassicDict;
 
-static const uint8_t table[256] = {
-    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3,
-    4, 4, 5, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4,
-    4, 5, 4, 5, 5, 6, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 2, 3, 3, 4, 3, 4, 4,
-    5, 3, 4, 4, 5, 4, 5, 5, 6, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 3, 4, 4, 5,
-    4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 2,
-    3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5,
-    5, 6, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4,
-    5, 4, 5, 5, 6, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7, 3, 4, 4, 5, 4, 5, 5, 6,
-    4, 5, 5, 6, 5, 6, 6, 7, 4, 5, 5, 6, 5, 6, 6, 7, 5, 6, 6, 7, 6, 7, 7, 8};
-static const uint8_t lookup1[256] = {
-    0, 0,  16, 16, 0,  16, 0,  0,  0, 16, 0,  0,  16, 16, 16, 16, 0, 0,  16, 16, 0,  16, 0,  0,
-    0, 16, 0,  0,  16, 16, 16, 16, 0, 0,  16, 16, 0,  16, 0,  0,  0, 16, 0,  0,  16, 16, 16, 16,
-    8, 8,  24, 24, 8,  24, 8,  8,  8, 24, 8,  8,  24, 24, 24, 24, 8, 8,  24, 24, 8,  24, 8,  8,
-    8, 24, 8,  8,  24, 24, 24, 24, 8, 8,  24, 24, 8,  24, 8,  8,  8, 24, 8,  8,  24, 24, 24, 24,
-    0, 0,  16, 16, 0,  16, 0,  0,  0, 16, 0,  0,  16, 16, 16, 16, 0, 0,  16, 16, 0,  16, 0,  0,
-    0, 16, 0,  0,  16, 16, 16, 16, 8, 8,  24, 24, 8,  24, 8,  8,  8, 24, 8,  8,  24, 24, 24, 24,
-    0, 0,  16, 16, 0,  16, 0,  0,  0, 16, 0,  0,  16, 16, 16, 16, 0, 0,  16, 16, 0,  16, 0,  0,
-    0, 16, 0,  0,  16, 16, 16, 16, 8, 8,  24, 24, 8,  24, 8,  8,  8, 24, 8,  8,  24, 24, 24, 24,
-    8, 8,  24, 24, 8,  24, 8,  8,  8, 24, 8,  8,  24, 24, 24, 24, 0, 0,  16, 16, 0,  16, 0,  0,
-    0, 16, 0,  0,  16, 16, 16, 16, 8, 8,  24, 24, 8,  24, 8,  8,  8, 24, 8,  8,  24, 24, 24, 24,
-    8, 8,  24, 24, 8,  24, 8,  8,  8, 24, 8,  8,  24, 24, 24, 24};
-static const uint8_t lookup2[256] = {
-    0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4,
-    4, 4, 4, 2, 2, 6, 6, 2, 6, 2, 2, 2, 6, 2, 2, 6, 6, 6, 6, 2, 2, 6, 6, 2, 6, 2, 2, 2, 6,
-    2, 2, 6, 6, 6, 6, 0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 2, 2, 6, 6, 2, 6, 2,
-    2, 2, 6, 2, 2, 6, 6, 6, 6, 0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 0, 0, 4, 4,
-    0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 2,
-    2, 6, 6, 2, 6, 2, 2, 2, 6, 2, 2, 6, 6, 6, 6, 0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4,
-    4, 4, 0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 2, 2, 6, 6, 2, 6, 2, 2, 2, 6, 2,
-    2, 6, 6, 6, 6, 2, 2, 6, 6, 2, 6, 2, 2, 2, 6, 2, 2, 6, 6, 6, 6, 2, 2, 6, 6, 2, 6, 2, 2,
-    2, 6, 2, 2, 6, 6, 6, 6, 2, 2, 6, 6, 2, 6, 2, 2, 2, 6, 2, 2, 6, 6, 6, 6};
-
-uint32_t prng_successor(uint32_t x, uint32_t n) {
-    SWAPENDIAN(x);
-    while(n--) x = x >> 1 | (x >> 16 ^ x >> 18 ^ x >> 19 ^ x >> 21) << 31;
-    return SWAPENDIAN(x);
-}
-
-static inline int filter(uint32_t const x) {
-    uint32_t f;
-    f = lookup1[x & 0xff] | lookup2[(x >> 8) & 0xff];
-    f |= 0x0d938 >> (x >> 16 & 0xf) & 1;
-    return BIT(0xEC57E80A, f);
-}
-
-static inline uint8_t evenparity32(uint32_t x) {
-    if((table[x & 0xff] + table[(x >> 8) & 0xff] + table[(x >> 16) & 0xff] + table[x >> 24]) % 2 ==
-       0) {
-        return 0;
-    } else {
-        return 1;
-    }
-    //return ((table[x & 0xff] + table[(x >> 8) & 0xff] + table[(x >> 16) & 0xff] + table[x >> 24]) % 2) & 0xFF;
-}
-
-static inline void update_contribution(unsigned int data[], int item, int mask1, int mask2) {
-    int p = data[item] >> 25;
-    p = p << 1 | evenparity32(data[item] & mask1);
-    p = p << 1 | evenparity32(data[item] & mask2);
-    data[item] = p << 24 | (data[item] & 0xffffff);
-}
-
-void crypto1_get_lfsr(struct Crypto1State* state, uint64_t* lfsr) {
-    int i;
-    for(*lfsr = 0, i = 23; i >= 0; --i) {
-        *lfsr = *lfsr << 1 | BIT(state->odd, i ^ 3);
-        *lfsr = *lfsr << 1 | BIT(state->even, i ^ 3);
-    }
-}
-
-static inline uint32_t crypt_word(struct Crypto1State* s) {
-    // "in" and "x" are always 0 (last iteration)
-    uint32_t res_ret = 0;
-    uint32_t feedin, t;
-    for(int i = 0; i <= 31; i++) {
-        res_ret |= (filter(s->odd) << (24 ^ i)); //-V629
-        feedin = LF_POLY_EVEN & s->even;
-        feedin ^= LF_POLY_ODD & s->odd;
-        s->even = s->even << 1 | (evenparity32(feedin));
-        t = s->odd, s->odd = s->even, s->even = t;
-    }
-    return res_ret;
-}
-
-static inline void crypt_word_noret(struct Crypto1State* s, uint32_t in, int x) {
-    uint8_t ret;
-    uint32_t feedin, t, next_in;
-    for(int i = 0; i <= 31; i++) {
-        next_in = BEBIT(in, i);
-        ret = filter(s->odd);
-        feedin = ret & (!!x);
-        feedin ^= LF_POLY_EVEN & s->even;
-        feedin ^= LF_POLY_ODD & s->odd;
-        feedin ^= !!next_in;
-        s->even = s->even << 1 | (evenparity32(feedin));
-        t = s->odd, s->odd = s->even, s->even = t;
-    }
-    return;
-}
-
-static inline void rollback_word_noret(struct Crypto1State* s, uint32_t in, int x) {
-    uint8_t ret;
-    uint32_t feedin, t, next_in;
-    for(int i = 31; i >= 0; i--) {
-        next_in = BEBIT(in, i);
-        s->odd &= 0xffffff;
-        t = s->odd, s->odd = s->even, s->even = t;
-        ret = filter(s->odd);
-        feedin = ret & (!!x);
-        feedin ^= s->even & 1;
-        feedin ^= LF_POLY_EVEN & (s->even >>= 1);
-        feedin ^= LF_POLY_ODD & s->odd;
-        feedin ^= !!next_in;
-        s->even |= (evenparity32(feedin)) << 23;
-    }
-    return;
-}
-
-int key_already_found_for_nonce(
-    uint64_t* keyarray,
-    int keyarray_size,
-    uint32_t uid_xor_nt1,
-    uint32_t nr1_enc,
-    uint32_t p64b,
-    uint32_t ar1_enc) {
-    for(int k = 0; k < keyarray_size; k++) {
-        struct Crypto1State temp = {0, 0};
-
-        for(int i = 0; i < 24; i++) {
-            (&temp)->odd |= (BIT(keyarray[k], 2 * i + 1) << (i ^ 3));
-            (&temp)->even |= (BIT(keyarray[k], 2 * i) << (i ^ 3));
-        }
-
-        crypt_word_noret(&temp, uid_xor_nt1, 0);
-        crypt_word_noret(&temp, nr1_enc, 1);
-
-        if(ar1_enc == (crypt_word(&temp) ^ p64b)) {
-            return 1;
-        }
-    }
-    return 0;
-}
-
-int check_state(struct Crypto1State* t, struct Crypto1Params* p) {
-    if(!(t->odd | t->even)) return 0;
-    rollback_word_noret(t, 0, 0);
-    rollback_word_noret(t, p->nr0_enc, 1);
-    rollback_word_noret(t, p->uid_xor_nt0, 0);
-    struct Crypto1State temp = {t->odd, t->even};
-    crypt_word_noret(t, p->uid_xor_nt1, 0);
-    crypt_word_noret(t, p->nr1_enc, 1);
-    if(p->ar1_enc == (crypt_word(t) ^ p->p64b)) {
-        crypto1_get_lfsr(&temp, &(p->key));
-        return 1;
-    }
-    return 0;
-}
-
-static inline int state_loop(unsigned int* states_buffer, int xks, int m1, int m2) {
-    int states_tail = 0;
-    int round = 0, s = 0, xks_bit = 0;
-
-    for(round = 1; round <= 12; round++) {
-        xks_bit = BIT(xks, round);
-
-        for(s = 0; s <= states_tail; s++) {
-            states_buffer[s] <<= 1;
-
-            if((filter(states_buffer[s]) ^ filter(states_buffer[s] | 1)) != 0) {
-                states_buffer[s] |= filter(states_buffer[s]) ^ xks_bit;
-                if(round > 4) {
-                    update_contribution(states_buffer, s, m1, m2);
-                }
-            } else if(filter(states_buffer[s]) == xks_bit) {
-                // TODO: Refactor
-                if(round > 4) {
-                    states_buffer[++states_tail] = states_buffer[s + 1];
-                    states_buffer[s + 1] = states_buffer[s] | 1;
-                    update_contribution(states_buffer, s, m1, m2);
-                    s++;
-                    update_contribution(states_buffer, s, m1, m2);
-                } else {
-                    states_buffer[++states_tail] = states_buffer[++s];
-                    states_buffer[s] = states_buffer[s - 1] | 1;
-                }
-            } else {
-                states_buffer[s--] = states_buffer[states_tail--];
-            }
-        }
-    }
+// Progress saved to MF_CLASSIC_CHECKPOINT_PATH, so that a relaunch resumes the attack
+typedef struct MfkeyCheckpoint {
+    MfClassicNonce* finished; // nonces fully searched, with or without a key
+    uint32_t finished_count;
+    uint64_t* keys; // keys found so far and not saved to the user dict yet
+    size_t key_count;
+    bool has_resume;
+    MfClassicNonce resume_nonce; // nonce being cracked
+    uint32_t resume_msb; // first msb of resume_nonce not searched yet
+} MfkeyCheckpoint;
 
-    return states_tail;
-}
-
-int binsearch(unsigned int data[], int start, int stop) {
-    int mid, val = data[stop] & 0xff000000;
-    while(start != stop) {
-        mid = (stop - start) >> 1;
-        if((data[start + mid] ^ 0x80000000) > (val ^ 0x80000000))
-            stop = start + mid;
-        else
-            start += mid + 1;
-    }
-    return start;
-}
-void quicksort(unsigned int array[], int low, int high) {
-    //if (SIZEOF(array) == 0)
-    //    return;
-    if(low >= high) return;
-    int middle = low + (high - low) / 2;
-    unsigned int pivot = array[middle];
-    int i = low, j = high;
-    while(i <= j) {
-        while(array[i] < pivot) {
-            i++;
-        }
-        while(array[j] > pivot) {
-            j--;
-        }
-        if(i <= j) { // swap
-            int temp = array[i];
-            array[i] = array[j];
-            array[j] = temp;
-            i++;
-            j--;
-        }
-    }
-    if(low < j) {
-        quicksort(array, low, j);
-    }
-    if(high > i) {
-        quicksort(array, i, high);
-    }
-}
-int extend_table(unsigned int data[], int tbl, int end, int bit, int m1, int m2) {
-    for(data[tbl] <<= 1; tbl <= end; data[++tbl] <<= 1) {
-        if((filter(data[tbl]) ^ filter(data[tbl] | 1)) != 0) {
-            data[tbl] |= filter(data[tbl]) ^ bit;
-            update_contribution(data, tbl, m1, m2);
-        } else if(filter(data[tbl]) == bit) {
-            data[++end] = data[tbl + 1];
-            data[tbl + 1] = data[tbl] | 1;
-            update_contribution(data, tbl, m1, m2);
-            tbl++;
-            update_contribution(data, tbl, m1, m2);
-        } else {
-            data[tbl--] = data[end--];
-        }
-    }
-    return end;
-}
-
-int old_recover(
-    unsigned int odd[],
-    int o_head,
-    int o_tail,
-    int oks,
-    unsigned int even[],
-    int e_head,
-    int e_tail,
-    int eks,
-    int rem,
-    int s,
-    struct Crypto1Params* p,
-    int first_run) {
-    int o, e, i;
-    if(rem == -1) {
-        for(e = e_head; e <= e_tail; ++e) {
-            even[e] = (even[e] << 1) ^ evenparity32(even[e] & LF_POLY_EVEN);
-            for(o = o_head; o <= o_tail; ++o, ++s) {
-                struct Crypto1State temp = {0, 0};
-                temp.even = odd[o];
-                temp.odd = even[e] ^ evenparity32(odd[o] & LF_POLY_ODD);
-                if(check_state(&temp, p)) {
-                    return -1;
-                }
-            }
-        }
-        return s;
-    }
-    if(first_run == 0) {
-        for(i = 0; (i < 4) && (rem-- != 0); i++) {
-            oks >>= 1;
-            eks >>= 1;
-            o_tail = extend_table(
-                odd, o_head, o_tail, oks & 1, LF_POLY_EVEN << 1 | 1, LF_POLY_ODD << 1);
-            if(o_head > o_tail) return s;
-            e_tail =
-                extend_table(even, e_head, e_tail, eks & 1, LF_POLY_ODD, LF_POLY_EVEN << 1 | 1);
-            if(e_head > e_tail) return s;
-        }
-    }
-    first_run = 0;
-    quicksort(odd, o_head, o_tail);
-    quicksort(even, e_head, e_tail);
-    while(o_tail >= o_head && e_tail >= e_head) {
-        if(((odd[o_tail] ^ even[e_tail]) >> 24) == 0) {
-            o_tail = binsearch(odd, o_head, o = o_tail);
-            e_tail = binsearch(even, e_head, e = e_tail);
-            s = old_recover(odd, o_tail--, o, oks, even, e_tail--, e, eks, rem, s, p, first_run);
-            if(s == -1) {
-                break;
-            }
-        } else if((odd[o_tail] ^ 0x80000000) > (even[e_tail] ^ 0x80000000)) {
-            o_tail = binsearch(odd, o_head, o_tail) - 1;
-        } else {
-            e_tail = binsearch(even, e_head, e_tail) - 1;
-        }
-    }
-    return s;
-}
-
-static inline int sync_state(ProgramState* program_state) {
+typedef struct {
+    uint32_t magic;
+    uint32_t finished_count;
+    uint32_t key_count;
+    uint32_t has_resume;
+    uint32_t resume_msb;
+    MfClassicNonce resume_nonce;
+} MfkeyCheckpointHeader;
+
+bool napi_mfkey_checkpoint_save(MfkeyCheckpoint* checkpoint);
+
+// recover() callbacks: update the ETA and the checkpoint as the search goes on
+static bool sync_state(void* ctx) {
+    ProgramState* program_state = ctx;
     int ts = furi_hal_rtc_get_timestamp();
     program_state->eta_round = program_state->eta_round - (ts - program_state->eta_timestamp);
     program_state->eta_total = program_state->eta_total - (ts - program_state->eta_timestamp);
     program_state->eta_timestamp = ts;
-    if(program_state->close_thread_please) {
-        return 1;
-    }
-    return 0;
+    return program_state->close_thread_please;
 }
 
-int calculate_msb_tables(
-    int oks,
-    int eks,
-    int msb_round,
-    struct Crypto1Params* p,
-    unsigned int* states_buffer,
-    struct Msb* odd_msbs,
-    struct Msb* even_msbs,
-    unsigned int* temp_states_odd,
-    unsigned int* temp_states_even,
-    ProgramState* program_state) {
-    //FURI_LOG_I(TAG, "MSB GO %i", msb_iter); // DEBUG
-    unsigned int msb_head = (MSB_LIMIT * msb_round); // msb_iter ranges from 0 to (256/MSB_LIMIT)-1
-    unsigned int msb_tail = (MSB_LIMIT * (msb_round + 1));
-    int states_tail = 0, tail = 0;
-    int i = 0, j = 0, semi_state = 0, found = 0;
-    unsigned int msb = 0;
-    // TODO: Why is this necessary?
-    memset(odd_msbs, 0, MSB_LIMIT * sizeof(struct Msb));
-    memset(even_msbs, 0, MSB_LIMIT * sizeof(struct Msb));
-
-    for(semi_state = 1 << 20; semi_state >= 0; semi_state--) {
-        if(semi_state % 32768 == 0) {
-            if(sync_state(program_state) == 1) {
-                return 0;
-            }
-        }
-
-        if(filter(semi_state) == (oks & 1)) { //-V547
-            states_buffer[0] = semi_state;
-            states_tail = state_loop(states_buffer, oks, CONST_M1_1, CONST_M2_1);
-
-            for(i = states_tail; i >= 0; i--) {
-                msb = states_buffer[i] >> 24;
-                if((msb >= msb_head) && (msb < msb_tail)) {
-                    found = 0;
-                    for(j = 0; j < odd_msbs[msb - msb_head].tail - 1; j++) {
-                        if(odd_msbs[msb - msb_head].states[j] == states_buffer[i]) {
-                            found = 1;
-                            break;
-                        }
-                    }
-
-                    if(!found) {
-                        tail = odd_msbs[msb - msb_head].tail++;
-                        odd_msbs[msb - msb_head].states[tail] = states_buffer[i];
-                    }
-                }
-            }
-        }
-
-        if(filter(semi_state) == (eks & 1)) { //-V547
-            states_buffer[0] = semi_state;
-            states_tail = state_loop(states_buffer, eks, CONST_M1_2, CONST_M2_2);
-
-            for(i = 0; i <= states_tail; i++) {
-                msb = states_buffer[i] >> 24;
-                if((msb >= msb_head) && (msb < msb_tail)) {
-                    found = 0;
-
-                    for(j = 0; j < even_msbs[msb - msb_head].tail; j++) {
-                        if(even_msbs[msb - msb_head].states[j] == states_buffer[i]) {
-                            found = 1;
-                            break;
-                        }
-                    }
-
-                    if(!found) {
-                        tail = even_msbs[msb - msb_head].tail++;
-                        even_msbs[msb - msb_head].states[tail] = states_buffer[i];
-                    }
-                }
-            }
-        }
-    }
-
-    oks >>= 12;
-    eks >>= 12;
-
-    for(i = 0; i < MSB_LIMIT; i++) {
-        if(sync_state(program_state) == 1) {
-            return 0;
-        }
-        // TODO: Why is this necessary?
-        memset(temp_states_even, 0, sizeof(unsigned int) * (1280));
-        memset(temp_states_odd, 0, sizeof(unsigned int) * (1280));
-        memcpy(temp_states_odd, odd_msbs[i].states, odd_msbs[i].tail * sizeof(unsigned int));
-        memcpy(temp_states_even, even_msbs[i].states, even_msbs[i].tail * sizeof(unsigned int));
-        int res = old_recover(
-            temp_states_odd,
-            0,
-            odd_msbs[i].tail,
-            oks,
-            temp_states_even,
-            0,
-            even_msbs[i].tail,
-            eks,
-            3,
-            0,
-            p,
-            1);
-        if(res == -1) {
-            return 1;
-        }
-        //odd_msbs[i].tail = 0;
-        //even_msbs[i].tail = 0;
-    }
+static void recover_round_start(void* ctx, int msb_round) {
+    ProgramState* program_state = ctx;
+    program_state->search = msb_round;
+    program_state->eta_round = eta_round_time;
+    program_state->eta_total = eta_total_time - (eta_round_time * msb_round);
+}
 
-    return 0;
+static void recover_round_done(void* ctx, int msb_round) {
+    ProgramState* program_state = ctx;
+    // Round completed without a key, don't search it again after a relaunch
+    program_state->checkpoint->resume_msb = (msb_round + 1) * MSB_LIMIT;
+    napi_mfkey_checkpoint_save(program_state->checkpoint);
 }
 
-bool recover(struct Crypto1Params* p, int ks2, ProgramState* program_state) {
-    bool found = false;
-    unsigned int* states_buffer = malloc(sizeof(unsigned int) * (2 << 9));
-    struct Msb* odd_msbs = (struct Msb*)malloc(MSB_LIMIT * sizeof(struct Msb));
-    struct Msb* even_msbs = (struct Msb*)malloc(MSB_LIMIT * sizeof(struct Msb));
-    unsigned int* temp_states_odd = malloc(sizeof(unsigned int) * (1280));
-    unsigned int* temp_states_even = malloc(sizeof(unsigned int) * (1280));
-    int oks = 0, eks = 0;
-    int i = 0, msb = 0;
-    for(i = 31; i >= 0; i -= 2) {
-        oks = oks << 1 | BEBIT(ks2, i);
-    }
-    for(i = 30; i >= 0; i -= 2) {
-        eks = eks << 1 | BEBIT(ks2, i);
-    }
-    int bench_start = furi_hal_rtc_get_timestamp();
-    program_state->eta_total = eta_total_time;
-    program_state->eta_timestamp = bench_start;
-    for(msb = 0; msb <= ((256 / MSB_LIMIT) - 1); msb++) {
-        program_state->search = msb;
-        program_state->eta_round = eta_round_time;
-        program_state->eta_total = eta_total_time - (eta_round_time * msb);
-        if(calculate_msb_tables(
-               oks,
-               eks,
-               msb,
-               p,
-               states_buffer,
-               odd_msbs,
-               even_msbs,
-               temp_states_odd,
-               temp_states_even,
-               program_state)) {
-            int bench_stop = furi_hal_rtc_get_timestamp();
-            FURI_LOG_I(TAG, "Cracked in %i seconds", bench_stop - bench_start);
-            found = true;
-            break;
-        }
-        if(program_state->close_thread_please) {
-            break;
-        }
+// Use the largest chunk that fits in the heap: every round scans all the
+// 2^20 semi states once, so fewer, bigger rounds crack proportionally faster.
+// The chunk must divide 256. recover() allocates the two tables first, one
+// after the other: if the largest free block holds both, the second one fits
+// wherever the first one went.
+static void plan_msb_chunk() {
+    size_t free_heap = memmgr_get_free_heap();
+    size_t max_block = memmgr_heap_get_max_free_block();
+    int msb_limit = 256;
+    while(msb_limit > 1 && (recover_ram_for_chunk(msb_limit) + RAM_RESERVE > free_heap ||
+                            2 * msb_limit * sizeof(struct Msb) > max_block)) {
+        msb_limit /= 2;
     }
-    free(states_buffer);
-    free(odd_msbs);
-    free(even_msbs);
-    free(temp_states_odd);
-    free(temp_states_even);
-    return found;
+    MSB_LIMIT = msb_limit;
+    eta_total_time = (256 / MSB_LIMIT) * eta_round_time;
+    FURI_LOG_I(
+        TAG,
+        "Heap %zu (block %zu): %d msb per round, %d rounds, ETA %d sec per nonce",
+        free_heap,
+        max_block,
+        MSB_LIMIT,
+        256 / MSB_LIMIT,
+        eta_total_time);
 }
 
 bool napi_mf_classic_dict_check_presence(MfClassicDictType dict_type) {
@@ -793,62 +363,110 @@ bool napi_mf_classic_dict_get_next_key(MfClassicDict* dict, uint64_t* key) {
     return key_read;
 }
 
-bool napi_mf_classic_dict_is_key_present_str(MfClassicDict* dict, FuriString* key) {
+// Dictionary keys are loaded once into a sorted, deduplicated array, so the
+// per-nonce dictionary attack doesn't go back to the SD card
+typedef struct {
+    uint64_t* keys;
+    size_t count;
+} MfClassicKeySet;
+
+static int napi_mf_classic_key_cmp(const void* a, const void* b) {
+    uint64_t ka = *(const uint64_t*)a;
+    uint64_t kb = *(const uint64_t*)b;
+    return (ka > kb) - (ka < kb);
+}
+
+MfClassicKeySet* napi_mf_classic_key_set_alloc() {
+    MfClassicKeySet* key_set = malloc(sizeof(MfClassicKeySet));
+    key_set->keys = NULL;
+    key_set->count = 0;
+    return key_set;
+}
+
+bool napi_mf_classic_key_set_load_dict(MfClassicKeySet* key_set, MfClassicDict* dict) {
+    furi_assert(key_set);
     furi_assert(dict);
-    furi_assert(dict->stream);
 
-    FuriString* next_line;
-    next_line = furi_string_alloc();
-
-    bool key_found = false;
-    stream_rewind(dict->stream);
-    while(!key_found) { //-V654
-        if(!stream_read_line(dict->stream, next_line)) break;
-        if(furi_string_get_char(next_line, 0) == '#') continue;
-        if(furi_string_size(next_line) != NFC_MF_CLASSIC_KEY_LEN) continue;
-        furi_string_left(next_line, 12);
-        if(!furi_string_equal(key, next_line)) continue;
-        key_found = true;
+    if(!napi_mf_classic_dict_rewind(dict)) return false;
+    size_t capacity = key_set->count + napi_mf_classic_dict_get_total_keys(dict);
+    if(capacity == 0) return true;
+    key_set->keys = realloc(key_set->keys, sizeof(uint64_t) * capacity); //-V701
+
+    FuriString* temp_key = furi_string_alloc();
+    while(key_set->count < capacity && napi_mf_classic_dict_get_next_key_str(dict, temp_key)) {
+        napi_mf_classic_dict_str_to_int(temp_key, &key_set->keys[key_set->count++]);
     }
+    furi_string_free(temp_key);
 
-    furi_string_free(next_line);
-    return key_found;
+    // Sort and drop the duplicates (keys present in both dictionaries)
+    qsort(key_set->keys, key_set->count, sizeof(uint64_t), napi_mf_classic_key_cmp);
+    size_t unique = 0;
+    for(size_t i = 0; i < key_set->count; i++) {
+        if(unique == 0 || key_set->keys[unique - 1] != key_set->keys[i]) {
+            key_set->keys[unique++] = key_set->keys[i];
+        }
+    }
+    key_set->count = unique;
+    FURI_LOG_I(TAG, "Key set holds %zu unique keys", key_set->count);
+    return true;
 }
 
-bool napi_mf_classic_dict_is_key_present(MfClassicDict* dict, uint8_t* key) {
-    FuriString* temp_key;
+void napi_mf_classic_key_set_free(MfClassicKeySet* key_set) {
+    furi_assert(key_set);
 
-    temp_key = furi_string_alloc();
-    napi_mf_classic_dict_int_to_str(key, temp_key);
-    bool key_found = napi_mf_classic_dict_is_key_present_str(dict, temp_key);
-    furi_string_free(temp_key);
-    return key_found;
+    free(key_set->keys);
+    free(key_set);
 }
 
 bool napi_key_already_found_for_nonce(
-    MfClassicDict* dict,
+    MfClassicKeySet* key_set,
     uint32_t uid_xor_nt1,
     uint32_t nr1_enc,
     uint32_t p64b,
     uint32_t ar1_enc) {
-    bool found = false;
-    uint64_t k = 0;
-    napi_mf_classic_dict_rewind(dict);
-    while(napi_mf_classic_dict_get_next_key(dict, &k)) {
-        struct Crypto1State temp = {0, 0};
-        int i;
-        for(i = 0; i < 24; i++) {
-            (&temp)->odd |= (BIT(k, 2 * i + 1) << (i ^ 3));
-            (&temp)->even |= (BIT(k, 2 * i) << (i ^ 3));
-        }
-        crypt_word_noret(&temp, uid_xor_nt1, 0);
-        crypt_word_noret(&temp, nr1_enc, 1);
-        if(ar1_enc == (crypt_word(&temp) ^ p64b)) {
-            found = true;
-            break;
+    return key_already_found_for_nonce(
+               key_set->keys, key_set->count, uid_xor_nt1, nr1_enc, p64b, ar1_enc) == 1;
+}
+
+// Keys of the shared key index for one card, the nonces of a log are mostly from the same one
+typedef struct {
+    uint32_t uid;
+    uint64_t* keys;
+    size_t count;
+    bool loaded;
+} MfkeyIndexedKeys;
+
+bool napi_key_index_found_for_nonce(
+    MfkeyIndexedKeys* indexed,
+    uint32_t uid,
+    uint32_t uid_xor_nt1,
+    uint32_t nr1_enc,
+    uint32_t p64b,
+    uint32_t ar1_enc) {
+    if(!indexed->loaded || indexed->uid != uid) {
+        Storage* storage = furi_record_open(RECORD_STORAGE);
+        size_t count = 0;
+        KeyCacheRecord* records = key_cache_find(storage, uid, &count);
+        furi_record_close(RECORD_STORAGE);
+
+        indexed->keys = realloc(indexed->keys, sizeof(uint64_t) * (count + 1)); //-V701
+        for(size_t i = 0; i < count; i++) {
+            indexed->keys[i] = records[i].key;
         }
+        free(records);
+
+        indexed->uid = uid;
+        indexed->count = count;
+        indexed->loaded = true;
     }
-    return found;
+
+    return indexed->count && key_already_found_for_nonce(
+                                 indexed->keys,
+                                 indexed->count,
+                                 uid_xor_nt1,
+                                 nr1_enc,
+                                 p64b,
+                                 ar1_enc) == 1;
 }
 
 bool napi_mf_classic_nonces_check_presence() {
@@ -861,11 +479,8 @@ bool napi_mf_classic_nonces_check_presence() {
     return nonces_present;
 }
 
-MfClassicNonceArray* napi_mf_classic_nonce_array_alloc(
-    MfClassicDict* system_dict,
-    bool system_dict_exists,
-    MfClassicDict* user_dict,
-    ProgramState* program_state) {
+MfClassicNonceArray*
+    napi_mf_classic_nonce_array_alloc(MfClassicKeySet* key_set, ProgramState* program_state) {
     MfClassicNonceArray* nonce_array = malloc(sizeof(MfClassicNonceArray));
     MfClassicNonce* remaining_nonce_array_init = malloc(sizeof(MfClassicNonce) * 1);
     nonce_array->remaining_nonce_array = remaining_nonce_array_init;
@@ -895,6 +510,7 @@ MfClassicNonceArray* napi_mf_classic_nonce_array_alloc(
         }
 
         // Read total amount of nonces
+        MfkeyIndexedKeys indexed = {0};
         FuriString* next_line;
         next_line = furi_string_alloc();
         while(!(program_state->close_thread_please)) {
@@ -923,6 +539,12 @@ MfClassicNonceArray* napi_mf_classic_nonce_array_alloc(
                 }
                 unsigned long value = strtoul(next_line_cstr, &endptr, 16);
                 switch(i) {
+                case 1:
+                    res.sector = strtoul(next_line_cstr, NULL, 10);
+                    break;
+                case 3:
+                    res.key_type = *next_line_cstr == 'B';
+                    break;
                 case 5:
                     res.uid = value;
                     break;
@@ -951,11 +573,10 @@ MfClassicNonceArray* napi_mf_classic_nonce_array_alloc(
             }
             (program_state->total)++;
             uint32_t p64b = prng_successor(res.nt1, 64);
-            if((system_dict_exists &&
-                napi_key_already_found_for_nonce(
-                    system_dict, res.uid ^ res.nt1, res.nr1_enc, p64b, res.ar1_enc)) ||
-               (napi_key_already_found_for_nonce(
-                   user_dict, res.uid ^ res.nt1, res.nr1_enc, p64b, res.ar1_enc))) {
+            if(napi_key_already_found_for_nonce(
+                   key_set, res.uid ^ res.nt1, res.nr1_enc, p64b, res.ar1_enc) ||
+               napi_key_index_found_for_nonce(
+                   &indexed, res.uid, res.uid ^ res.nt1, res.nr1_enc, p64b, res.ar1_enc)) {
                 (program_state->cracked)++;
                 (program_state->num_completed)++;
                 continue;
@@ -970,6 +591,7 @@ MfClassicNonceArray* napi_mf_classic_nonce_array_alloc(
             nonce_array->total_nonces++;
         }
         furi_string_free(next_line);
+        free(indexed.keys);
         buffered_file_stream_close(nonce_array->stream);
 
         array_loaded = true;
@@ -993,6 +615,117 @@ void napi_mf_classic_nonce_array_free(MfClassicNonceArray* nonce_array) {
     free(nonce_array);
 }
 
+MfkeyCheckpoint* napi_mfkey_checkpoint_load() {
+    MfkeyCheckpoint* checkpoint = malloc(sizeof(MfkeyCheckpoint));
+    memset(checkpoint, 0, sizeof(MfkeyCheckpoint));
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    Stream* stream = buffered_file_stream_alloc(storage);
+
+    do {
+        if(!buffered_file_stream_open(
+               stream, MF_CLASSIC_CHECKPOINT_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+            break;
+        }
+        MfkeyCheckpointHeader header;
+        if(stream_read(stream, (uint8_t*)&header, sizeof(header)) != sizeof(header)) break;
+        if(header.magic != MFKEY_CHECKPOINT_MAGIC) break;
+        size_t finished_size = sizeof(MfClassicNonce) * header.finished_count;
+        size_t keys_size = sizeof(uint64_t) * header.key_count;
+        if(stream_size(stream) != sizeof(header) + finished_size + keys_size) break;
+        MfClassicNonce* finished = malloc(finished_size + 1);
+        uint64_t* keys = malloc(keys_size + 1);
+        if(stream_read(stream, (uint8_t*)finished, finished_size) != finished_size ||
+           stream_read(stream, (uint8_t*)keys, keys_size) != keys_size) {
+            free(finished);
+            free(keys);
+            break;
+        }
+        checkpoint->finished = finished;
+        checkpoint->finished_count = header.finished_count;
+        checkpoint->keys = keys;
+        checkpoint->key_count = header.key_count;
+        checkpoint->has_resume = header.has_resume;
+        checkpoint->resume_nonce = header.resume_nonce;
+        checkpoint->resume_msb = header.resume_msb;
+        FURI_LOG_I(
+            TAG,
+            "Resuming: %lu nonces done, %zu keys found",
+            checkpoint->finished_count,
+            checkpoint->key_count);
+    } while(false);
+
+    buffered_file_stream_close(stream);
+    stream_free(stream);
+    furi_record_close(RECORD_STORAGE);
+    return checkpoint;
+}
+
+bool napi_mfkey_checkpoint_save(MfkeyCheckpoint* checkpoint) {
+    furi_assert(checkpoint);
+
+    MfkeyCheckpointHeader header = {
+        .magic = MFKEY_CHECKPOINT_MAGIC,
+        .finished_count = checkpoint->finished_count,
+        .key_count = checkpoint->key_count,
+        .has_resume = checkpoint->has_resume,
+        .resume_msb = checkpoint->resume_msb,
+        .resume_nonce = checkpoint->resume_nonce,
+    };
+    size_t finished_size = sizeof(MfClassicNonce) * checkpoint->finished_count;
+    size_t keys_size = sizeof(uint64_t) * checkpoint->key_count;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    Stream* stream = buffered_file_stream_alloc(storage);
+    bool saved = false;
+    do {
+        if(!buffered_file_stream_open(
+               stream, MF_CLASSIC_CHECKPOINT_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+            break;
+        }
+        if(stream_write(stream, (uint8_t*)&header, sizeof(header)) != sizeof(header)) break;
+        if(stream_write(stream, (uint8_t*)checkpoint->finished, finished_size) != finished_size)
+            break;
+        if(stream_write(stream, (uint8_t*)checkpoint->keys, keys_size) != keys_size) break;
+        saved = true;
+    } while(false);
+    buffered_file_stream_close(stream);
+    stream_free(stream);
+    furi_record_close(RECORD_STORAGE);
+
+    if(!saved) FURI_LOG_E(TAG, "Failed to save checkpoint");
+    return saved;
+}
+
+void napi_mfkey_checkpoint_remove() {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_remove(storage, MF_CLASSIC_CHECKPOINT_PATH);
+    furi_record_close(RECORD_STORAGE);
+}
+
+bool napi_mfkey_checkpoint_is_finished(MfkeyCheckpoint* checkpoint, MfClassicNonce* nonce) {
+    for(uint32_t i = 0; i < checkpoint->finished_count; i++) {
+        if(memcmp(&checkpoint->finished[i], nonce, sizeof(MfClassicNonce)) == 0) return true;
+    }
+    return false;
+}
+
+void napi_mfkey_checkpoint_finish_nonce(MfkeyCheckpoint* checkpoint, MfClassicNonce* nonce) {
+    checkpoint->finished = realloc( //-V701
+        checkpoint->finished,
+        sizeof(MfClassicNonce) * (checkpoint->finished_count + 1));
+    checkpoint->finished[checkpoint->finished_count++] = *nonce;
+    checkpoint->has_resume = false;
+    checkpoint->resume_msb = 0;
+}
+
+void napi_mfkey_checkpoint_free(MfkeyCheckpoint* checkpoint) {
+    furi_assert(checkpoint);
+
+    // Keys belong to mfkey32() once the checkpoint is loaded
+    free(checkpoint->finished);
+    free(checkpoint);
+}
+
 static void finished_beep() {
     // Beep to indicate completion
     NotificationApp* notification = furi_record_open("notification");
@@ -1018,27 +751,30 @@ void mfkey32(ProgramState* program_state) {
     bool system_dict_exists = napi_mf_classic_dict_check_presence(MfClassicDictTypeSystem);
     MfClassicDict* user_dict = {0};
     bool user_dict_exists = napi_mf_classic_dict_check_presence(MfClassicDictTypeUser);
-    uint32_t total_dict_keys = 0;
+    MfClassicKeySet* key_set = napi_mf_classic_key_set_alloc();
     if(system_dict_exists) {
         system_dict = napi_mf_classic_dict_alloc(MfClassicDictTypeSystem);
-        total_dict_keys += napi_mf_classic_dict_get_total_keys(system_dict);
+        if(system_dict) {
+            napi_mf_classic_key_set_load_dict(key_set, system_dict);
+            // The system dictionary is only read: its keys are all in the set now
+            napi_mf_classic_dict_free(system_dict);
+        }
     }
     user_dict = napi_mf_classic_dict_alloc(MfClassicDictTypeUser);
     if(user_dict_exists) {
-        total_dict_keys += napi_mf_classic_dict_get_total_keys(user_dict);
+        napi_mf_classic_key_set_load_dict(key_set, user_dict);
     }
     user_dict_exists = true;
-    program_state->dict_count = total_dict_keys;
+    program_state->dict_count = key_set->count;
     program_state->mfkey_state = DictionaryAttack;
     // Read nonces
     MfClassicNonceArray* nonce_arr;
-    nonce_arr = napi_mf_classic_nonce_array_alloc(
-        system_dict, system_dict_exists, user_dict, program_state);
-    if(system_dict_exists) {
-        napi_mf_classic_dict_free(system_dict);
-    }
+    nonce_arr = napi_mf_classic_nonce_array_alloc(key_set, program_state);
+    // Free the key set before the attack, recover() needs all the RAM it can get
+    napi_mf_classic_key_set_free(key_set);
     if(nonce_arr->total_nonces == 0) {
         // Nothing to crack
+        napi_mfkey_checkpoint_remove();
         program_state->err = ZeroNonces;
         program_state->mfkey_state = Error;
         napi_mf_classic_nonce_array_free(nonce_arr);
@@ -1046,12 +782,17 @@ void mfkey32(ProgramState* program_state) {
         free(keyarray);
         return;
     }
-    if(memmgr_get_free_heap() < MIN_RAM) {
-        // System has less than the guaranteed amount of RAM (140 KB) - adjust some parameters to run anyway at half speed
-        eta_round_time *= 2;
-        eta_total_time *= 2;
-        MSB_LIMIT /= 2;
+    // Pick up the keys and the progress of a previous, interrupted run
+    MfkeyCheckpoint* checkpoint = napi_mfkey_checkpoint_load();
+    program_state->checkpoint = checkpoint;
+    if(checkpoint->keys) {
+        free(keyarray);
+        keyarray = checkpoint->keys;
+        keyarray_size = checkpoint->key_count;
+        program_state->unique_cracked = keyarray_size;
     }
+    // Planned once everything the attack keeps around is allocated
+    plan_msb_chunk();
     program_state->mfkey_state = MfkeyAttack;
     // TODO: Work backwards on this array and free memory
     for(i = 0; i < nonce_arr->total_nonces; i++) {
@@ -1070,6 +811,22 @@ void mfkey32(ProgramState* program_state) {
             (program_state->num_completed)++;
             continue;
         }
+        if(napi_mfkey_checkpoint_is_finished(checkpoint, &next_nonce)) {
+            // Searched by a previous run, no key
+            nonce_arr->remaining_nonces--;
+            (program_state->num_completed)++;
+            continue;
+        }
+        int msb_start = 0;
+        if(checkpoint->has_resume &&
+           memcmp(&checkpoint->resume_nonce, &next_nonce, sizeof(MfClassicNonce)) == 0) {
+            // MSB_LIMIT may have changed since the checkpoint was saved
+            msb_start = checkpoint->resume_msb / MSB_LIMIT;
+        } else {
+            checkpoint->has_resume = true;
+            checkpoint->resume_nonce = next_nonce;
+            checkpoint->resume_msb = 0;
+        }
         FURI_LOG_I(TAG, "Cracking %8lx %8lx", next_nonce.uid, next_nonce.ar1_enc);
         struct Crypto1Params p = {
             0,
@@ -1079,17 +836,33 @@ void mfkey32(ProgramState* program_state) {
             next_nonce.nr1_enc,
             p64b,
             next_nonce.ar1_enc};
-        if(!recover(&p, next_nonce.ar0_enc ^ p64, program_state)) {
+        const Crypto1RecoverCallbacks callbacks = {
+            .should_stop = sync_state,
+            .round_start = recover_round_start,
+            .round_done = recover_round_done,
+            .context = program_state,
+        };
+        int bench_start = furi_hal_rtc_get_timestamp();
+        program_state->eta_total = eta_total_time;
+        program_state->eta_timestamp = bench_start;
+        if(!recover(&p, next_nonce.ar0_enc ^ p64, MSB_LIMIT, msb_start, &callbacks)) {
             if(program_state->close_thread_please) {
                 break;
             }
             // No key found in recover()
             (program_state->num_completed)++;
+            napi_mfkey_checkpoint_finish_nonce(checkpoint, &next_nonce);
+            napi_mfkey_checkpoint_save(checkpoint);
             continue;
         }
+        FURI_LOG_I(
+            TAG, "Cracked in %i seconds", (int)furi_hal_rtc_get_timestamp() - bench_start);
         (program_state->cracked)++;
         (program_state->num_completed)++;
         found_key = p.key;
+        Storage* storage = furi_record_open(RECORD_STORAGE);
+        key_cache_add(storage, next_nonce.uid, found_key, next_nonce.sector, next_nonce.key_type);
+        furi_record_close(RECORD_STORAGE);
         bool already_found = false;
         for(j = 0; j < keyarray_size; j++) {
             if(keyarray[j] == found_key) {
@@ -1104,6 +877,10 @@ void mfkey32(ProgramState* program_state) {
             keyarray[keyarray_size - 1] = found_key;
             (program_state->unique_cracked)++;
         }
+        napi_mfkey_checkpoint_finish_nonce(checkpoint, &next_nonce);
+        checkpoint->keys = keyarray;
+        checkpoint->key_count = keyarray_size;
+        napi_mfkey_checkpoint_save(checkpoint);
     }
     // TODO: Update display to show all keys were found
     // TODO: Prepend found key(s) to user dictionary file
@@ -1119,6 +896,16 @@ void mfkey32(ProgramState* program_state) {
         // TODO: Should we use DolphinDeedNfcMfcAdd?
         dolphin_deed(DolphinDeedNfcMfcAdd);
     }
+    if(program_state->close_thread_please) {
+        // Keys are in the user dict now, keep only the progress for the next run
+        checkpoint->keys = NULL;
+        checkpoint->key_count = 0;
+        napi_mfkey_checkpoint_save(checkpoint);
+    } else {
+        napi_mfkey_checkpoint_remove();
+    }
+    program_state->checkpoint = NULL;
+    napi_mfkey_checkpoint_free(checkpoint);
     napi_mf_classic_nonce_array_free(nonce_arr);
     napi_mf_classic_dict_free(user_dict);
     free(keyarray);
@@ -0,0 +1,314 @@
+// Host batch version of mfkey32: cracks every nonce of one or more
+// .mfkey32.log files using all the cores, with the same recover() core as
+// the app. Found keys are written in the user dictionary format.
+//
+// Build (from the mfkey32 directory):
+//   cc -O3 -pthread -o mfkey32_batch tools/mfkey32_batch.c crypto1_recover.c
+//
+// Usage:
+//   mfkey32_batch [-j threads] [-d dict.nfc]... [-o mf_classic_dict_user.nfc] log...
+
+#include "../crypto1_recover.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// No RAM constraint on the host: search all the 256 msb values in one round
+#define HOST_MSB_LIMIT 256
+
+typedef struct {
+    uint32_t uid; // serial number
+    uint32_t nt0; // tag challenge first
+    uint32_t nt1; // tag challenge second
+    uint32_t nr0_enc; // first encrypted reader challenge
+    uint32_t ar0_enc; // first encrypted reader response
+    uint32_t nr1_enc; // second encrypted reader challenge
+    uint32_t ar1_enc; // second encrypted reader response
+} MfClassicNonce;
+
+typedef struct {
+    uint64_t* keys;
+    size_t count;
+    size_t capacity;
+} KeyList;
+
+typedef struct {
+    MfClassicNonce* nonces;
+    size_t nonce_count;
+    size_t next_nonce; // next nonce to crack, protected by lock
+    size_t done;
+    size_t cracked;
+    KeyList dict_keys; // read only while cracking
+    KeyList found_keys; // protected by lock
+    pthread_mutex_t lock;
+} BatchState;
+
+static void key_list_add(KeyList* list, uint64_t key) {
+    for(size_t i = 0; i < list->count; i++) {
+        if(list->keys[i] == key) return;
+    }
+    if(list->count == list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : 64;
+        list->keys = realloc(list->keys, sizeof(uint64_t) * list->capacity);
+        if(!list->keys) {
+            perror("realloc");
+            exit(1);
+        }
+    }
+    list->keys[list->count++] = key;
+}
+
+// Read a dictionary: one 12 hex digits key per line, '#' starts a comment.
+// A missing file is not an error, it's just an empty dictionary.
+static void load_dict(const char* path, KeyList* list) {
+    FILE* fp = fopen(path, "r");
+    if(!fp) {
+        if(errno != ENOENT) perror(path);
+        return;
+    }
+    char line[256];
+    while(fgets(line, sizeof(line), fp)) {
+        if(line[0] == '#') continue;
+        line[strcspn(line, "\r\n")] = '\0';
+        if(strlen(line) != 12) continue;
+        char* endptr;
+        uint64_t key = strtoull(line, &endptr, 16);
+        if(*endptr != '\0') continue;
+        key_list_add(list, key);
+    }
+    fclose(fp);
+}
+
+// Parse the "Sec ..." lines of a nonce log, with the same field layout
+// napi_mf_classic_nonce_array_alloc() expects in the app.
+static void load_nonces(const char* path, BatchState* state, size_t* capacity) {
+    FILE* fp = fopen(path, "r");
+    if(!fp) {
+        perror(path);
+        exit(1);
+    }
+    char line[512];
+    while(fgets(line, sizeof(line), fp)) {
+        if(strncmp(line, "Sec", 3) != 0) continue;
+        const char* next_line_cstr = line;
+        MfClassicNonce res = {0};
+        char* endptr;
+        for(int i = 0; i <= 17; i++) {
+            if(i != 0) {
+                next_line_cstr = strchr(next_line_cstr, ' ');
+                if(next_line_cstr) {
+                    next_line_cstr++;
+                } else {
+                    break;
+                }
+            }
+            unsigned long value = strtoul(next_line_cstr, &endptr, 16);
+            switch(i) {
+            case 5:
+                res.uid = value;
+                break;
+            case 7:
+                res.nt0 = value;
+                break;
+            case 9:
+                res.nr0_enc = value;
+                break;
+            case 11:
+                res.ar0_enc = value;
+                break;
+            case 13:
+                res.nt1 = value;
+                break;
+            case 15:
+                res.nr1_enc = value;
+                break;
+            case 17:
+                res.ar1_enc = value;
+                break;
+            default:
+                break; // Do nothing
+            }
+            next_line_cstr = endptr;
+        }
+        // The same nonce is often logged more than once
+        bool duplicate = false;
+        for(size_t i = 0; i < state->nonce_count; i++) {
+            if(memcmp(&state->nonces[i], &res, sizeof(res)) == 0) {
+                duplicate = true;
+                break;
+            }
+        }
+        if(duplicate) continue;
+        if(state->nonce_count == *capacity) {
+            *capacity = *capacity ? *capacity * 2 : 64;
+            state->nonces = realloc(state->nonces, sizeof(MfClassicNonce) * *capacity);
+            if(!state->nonces) {
+                perror("realloc");
+                exit(1);
+            }
+        }
+        state->nonces[state->nonce_count++] = res;
+    }
+    fclose(fp);
+}
+
+static bool key_known_for_nonce(BatchState* state, MfClassicNonce* nonce, uint32_t p64b) {
+    if(key_already_found_for_nonce(
+           state->dict_keys.keys,
+           state->dict_keys.count,
+           nonce->uid ^ nonce->nt1,
+           nonce->nr1_enc,
+           p64b,
+           nonce->ar1_enc)) {
+        return true;
+    }
+    pthread_mutex_lock(&state->lock);
+    int found = key_already_found_for_nonce(
+        state->found_keys.keys,
+        state->found_keys.count,
+        nonce->uid ^ nonce->nt1,
+        nonce->nr1_enc,
+        p64b,
+        nonce->ar1_enc);
+    pthread_mutex_unlock(&state->lock);
+    return found;
+}
+
+static void* crack_worker(void* ctx) {
+    BatchState* state = ctx;
+    while(true) {
+        pthread_mutex_lock(&state->lock);
+        size_t i = state->next_nonce++;
+        pthread_mutex_unlock(&state->lock);
+        if(i >= state->nonce_count) break;
+
+        MfClassicNonce* nonce = &state->nonces[i];
+        uint32_t p64 = prng_successor(nonce->nt0, 64);
+        uint32_t p64b = prng_successor(nonce->nt1, 64);
+        bool cracked = key_known_for_nonce(state, nonce, p64b);
+        struct Crypto1Params p = {
+            0,
+            nonce->nr0_enc,
+            nonce->uid ^ nonce->nt0,
+            nonce->uid ^ nonce->nt1,
+            nonce->nr1_enc,
+            p64b,
+            nonce->ar1_enc};
+        if(!cracked && recover(&p, nonce->ar0_enc ^ p64, HOST_MSB_LIMIT, 0, NULL)) {
+            pthread_mutex_lock(&state->lock);
+            key_list_add(&state->found_keys, p.key);
+            pthread_mutex_unlock(&state->lock);
+            cracked = true;
+        }
+
+        pthread_mutex_lock(&state->lock);
+        state->done++;
+        if(cracked) state->cracked++;
+        fprintf(
+            stderr,
+            "[%zu/%zu] %08" PRIx32 " %08" PRIx32 ": %s\n",
+            state->done,
+            state->nonce_count,
+            nonce->uid,
+            nonce->ar1_enc,
+            cracked ? "cracked" : "no key");
+        pthread_mutex_unlock(&state->lock);
+    }
+    return NULL;
+}
+
+static void usage(const char* argv0) {
+    fprintf(
+        stderr,
+        "Usage: %s [-j threads] [-d dict.nfc]... [-o user_dict.nfc] log...\n"
+        "  -j  worker threads (default: online CPUs)\n"
+        "  -d  dictionary with known keys, nonces it cracks are skipped\n"
+        "  -o  user dictionary the new keys are appended to (default: stdout)\n",
+        argv0);
+    exit(1);
+}
+
+int main(int argc, char** argv) {
+    BatchState state;
+    memset(&state, 0, sizeof(state));
+    pthread_mutex_init(&state.lock, NULL);
+
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    const char* out_path = NULL;
+    int opt;
+    while((opt = getopt(argc, argv, "j:d:o:h")) != -1) {
+        switch(opt) {
+        case 'j':
+            threads = strtol(optarg, NULL, 10);
+            break;
+        case 'd':
+            load_dict(optarg, &state.dict_keys);
+            break;
+        case 'o':
+            out_path = optarg;
+            break;
+        default:
+            usage(argv[0]);
+        }
+    }
+    if(optind >= argc) usage(argv[0]);
+    if(threads < 1) threads = 1;
+    // Keys already in the output dictionary are not added again
+    if(out_path) load_dict(out_path, &state.dict_keys);
+
+    size_t capacity = 0;
+    for(int i = optind; i < argc; i++) {
+        load_nonces(argv[i], &state, &capacity);
+    }
+    fprintf(
+        stderr,
+        "%zu nonces, %zu known keys, %ld threads\n",
+        state.nonce_count,
+        state.dict_keys.count,
+        threads);
+
+    pthread_t* workers = malloc(sizeof(pthread_t) * threads);
+    for(long i = 0; i < threads; i++) {
+        if(pthread_create(&workers[i], NULL, crack_worker, &state) != 0) {
+            perror("pthread_create");
+            return 1;
+        }
+    }
+    for(long i = 0; i < threads; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+
+    FILE* out = stdout;
+    if(out_path) {
+        out = fopen(out_path, "a+");
+        if(!out) {
+            perror(out_path);
+            return 1;
+        }
+        // Keep the keys on their own lines if the file lacks a final newline
+        if(fseek(out, -1, SEEK_END) == 0 && fgetc(out) != '\n') fputc('\n', out);
+    }
+    for(size_t i = 0; i < state.found_keys.count; i++) {
+        fprintf(out, "%012" PRIX64 "\n", state.found_keys.keys[i]);
+    }
+    if(out != stdout) fclose(out);
+
+    fprintf(
+        stderr,
+        "%zu/%zu nonces cracked, %zu new keys\n",
+        state.cracked,
+        state.nonce_count,
+        state.found_keys.count);
+
+    free(state.nonces);
+    free(state.dict_keys.keys);
+    free(state.found_keys.keys);
+    pthread_mutex_destroy(&state.lock);
+    return 0;
+}
@@ -59,6 +59,11 @@ MifareFuzzerApp* mifare_fuzzer_alloc() {
     view_dispatcher_add_view(
         app->view_dispatcher, MifareFuzzerViewSelectAttack, submenu_get_view(app->submenu_attack));
 
+    // view: sequential attack start UID
+    app->byte_input = byte_input_alloc();
+    view_dispatcher_add_view(
+        app->view_dispatcher, MifareFuzzerViewByteInput, byte_input_get_view(app->byte_input));
+
     // view: emulator
     app->emulator_view = mifare_fuzzer_emulator_alloc();
     view_dispatcher_add_view(
@@ -96,12 +101,16 @@ void mifare_fuzzer_free(MifareFuzzerApp* app) {
     view_dispatcher_remove_view(app->view_dispatcher, MifareFuzzerViewSelectCard);
     view_dispatcher_remove_view(app->view_dispatcher, MifareFuzzerViewSelectAttack);
     view_dispatcher_remove_view(app->view_dispatcher, MifareFuzzerViewEmulator);
+    view_dispatcher_remove_view(app->view_dispatcher, MifareFuzzerViewByteInput);
 
     // Submenus
     //FURI_LOG_D(TAG, "mifare_fuzzer_free() :: Submenus");
     submenu_free(app->submenu_card);
     submenu_free(app->submenu_attack);
 
+    // Byte input
+    byte_input_free(app->byte_input);
+
     // View Dispatcher
     //FURI_LOG_D(TAG, "mifare_fuzzer_free() :: View Dispatcher");
     view_dispatcher_free(app->view_dispatcher);
@@ -11,4 +11,6 @@ typedef enum MifareFuzzerEvent {
     MifareFuzzerEventStopAttack,
     MifareFuzzerEventIncrementTicks,
     MifareFuzzerEventDecrementTicks,
+    MifareFuzzerEventSequentialValuesAttack,
+    MifareFuzzerEventUidStartEntered,
 } MifareFuzzerEvent;
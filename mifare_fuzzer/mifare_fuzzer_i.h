@@ -8,6 +8,7 @@
 #include <gui/scene_manager.h>
 
 #include <gui/modules/submenu.h>
+#include <gui/modules/byte_input.h>
 
 #include <dialogs/dialogs.h>
 
@@ -33,6 +34,8 @@
 #define MIFARE_FUZZER_TICK_PERIOD 200
 #define MIFARE_FUZZER_DEFAULT_TICKS_BETWEEN_CARDS 10
 #define MIFARE_FUZZER_MIN_TICKS_BETWEEN_CARDS 5
+// Below the minimum: the UID changes every time the reader polls it
+#define MIFARE_FUZZER_POLL_TICKS_BETWEEN_CARDS 0
 #define MIFARE_FUZZER_MAX_TICKS_BETWEEN_CARDS 50
 
 typedef enum MifareFuzzerSceneState {
@@ -45,6 +48,7 @@ typedef enum {
     MifareFuzzerViewSelectCard,
     MifareFuzzerViewSelectAttack,
     MifareFuzzerViewEmulator,
+    MifareFuzzerViewByteInput,
 } MifareFuzzerView;
 
 struct MifareFuzzerApp {
@@ -61,6 +65,7 @@ struct MifareFuzzerApp {
     // Common Views
     Submenu* submenu_card;
     Submenu* submenu_attack;
+    ByteInput* byte_input;
 
     MifareFuzzerEmulator* emulator_view;
 
@@ -68,6 +73,7 @@ struct MifareFuzzerApp {
 
     MifareCard card;
     MifareFuzzerAttack attack;
+    // First UID of the sequential attack
     FuriHalNfcDevData nfc_dev_data;
     FuriString* app_folder;
     FuriString* file_path;
@@ -9,6 +9,7 @@ MifareFuzzerWorker* mifare_fuzzer_worker_alloc() {
     mifare_fuzzer_worker->thread = furi_thread_alloc_ex(
         "MifareFuzzerWorker", 8192, mifare_fuzzer_worker_task, mifare_fuzzer_worker);
     mifare_fuzzer_worker->state = MifareFuzzerWorkerStateStop;
+    mifare_fuzzer_worker->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
     return mifare_fuzzer_worker;
 }
 
@@ -17,6 +18,7 @@ MifareFuzzerWorker* mifare_fuzzer_worker_alloc() {
 void mifare_fuzzer_worker_free(MifareFuzzerWorker* mifare_fuzzer_worker) {
     furi_assert(mifare_fuzzer_worker);
     furi_thread_free(mifare_fuzzer_worker->thread);
+    furi_mutex_free(mifare_fuzzer_worker->mutex);
     free(mifare_fuzzer_worker);
 }
 
@@ -35,6 +37,7 @@ void mifare_fuzzer_worker_stop(MifareFuzzerWorker* mifare_fuzzer_worker) {
 void mifare_fuzzer_worker_start(MifareFuzzerWorker* mifare_fuzzer_worker) {
     furi_assert(mifare_fuzzer_worker);
     mifare_fuzzer_worker->state = MifareFuzzerWorkerStateEmulate;
+    mifare_fuzzer_worker->activations = 0;
     furi_thread_start(mifare_fuzzer_worker->thread);
 }
 
@@ -45,12 +48,32 @@ int32_t mifare_fuzzer_worker_task(void* context) {
     MifareFuzzerWorker* mifare_fuzzer_worker = context;
 
     if(mifare_fuzzer_worker->state == MifareFuzzerWorkerStateEmulate) {
-        FuriHalNfcDevData params = mifare_fuzzer_worker->nfc_dev_data;
+        FuriHalNfcDevData params;
 
+        // The emulator stays armed for the whole attack, a new UID only changes the
+        // anticollision data loaded by the next listen call (BCC is computed by the chip)
         furi_hal_nfc_exit_sleep();
         while(mifare_fuzzer_worker->state == MifareFuzzerWorkerStateEmulate) {
-            furi_hal_nfc_listen(params.uid, params.uid_len, params.atqa, params.sak, false, 500);
-            furi_delay_ms(50);
+            furi_mutex_acquire(mifare_fuzzer_worker->mutex, FuriWaitForever);
+            params = mifare_fuzzer_worker->nfc_dev_data;
+            furi_mutex_release(mifare_fuzzer_worker->mutex);
+
+            bool activated = furi_hal_nfc_listen(
+                params.uid, params.uid_len, params.atqa, params.sak, false, 500);
+
+            if(activated) {
+                mifare_fuzzer_worker->activations++;
+            }
+
+            if(activated && mifare_fuzzer_worker->next_uid_callback) {
+                // Reader polled this UID, go on with the next one right away
+                furi_mutex_acquire(mifare_fuzzer_worker->mutex, FuriWaitForever);
+                mifare_fuzzer_worker->next_uid_callback(
+                    &mifare_fuzzer_worker->nfc_dev_data, mifare_fuzzer_worker->next_uid_context);
+                furi_mutex_release(mifare_fuzzer_worker->mutex);
+            } else {
+                furi_delay_ms(50);
+            }
         }
         furi_hal_nfc_sleep();
     }
@@ -76,12 +99,38 @@ bool mifare_fuzzer_worker_is_emulating(MifareFuzzerWorker* mifare_fuzzer_worker)
 void mifare_fuzzer_worker_set_nfc_dev_data(
     MifareFuzzerWorker* mifare_fuzzer_worker,
     FuriHalNfcDevData nfc_dev_data) {
+    furi_mutex_acquire(mifare_fuzzer_worker->mutex, FuriWaitForever);
     mifare_fuzzer_worker->nfc_dev_data = nfc_dev_data;
+    furi_mutex_release(mifare_fuzzer_worker->mutex);
 }
 
 /// @brief mifare_fuzzer_worker_get_nfc_dev_data()
 /// @param mifare_fuzzer_worker
 /// @return
 FuriHalNfcDevData mifare_fuzzer_worker_get_nfc_dev_data(MifareFuzzerWorker* mifare_fuzzer_worker) {
-    return mifare_fuzzer_worker->nfc_dev_data;
+    furi_mutex_acquire(mifare_fuzzer_worker->mutex, FuriWaitForever);
+    FuriHalNfcDevData nfc_dev_data = mifare_fuzzer_worker->nfc_dev_data;
+    furi_mutex_release(mifare_fuzzer_worker->mutex);
+    return nfc_dev_data;
+}
+
+/// @brief mifare_fuzzer_worker_set_next_uid_callback()
+/// @param mifare_fuzzer_worker
+/// @param callback NULL to keep the UID until it is set again
+/// @param context
+void mifare_fuzzer_worker_set_next_uid_callback(
+    MifareFuzzerWorker* mifare_fuzzer_worker,
+    MifareFuzzerWorkerNextUidCallback callback,
+    void* context) {
+    furi_assert(mifare_fuzzer_worker);
+    mifare_fuzzer_worker->next_uid_callback = callback;
+    mifare_fuzzer_worker->next_uid_context = context;
+}
+
+/// @brief mifare_fuzzer_worker_get_activations()
+/// @param mifare_fuzzer_worker
+/// @return reader activations since the worker was started
+uint32_t mifare_fuzzer_worker_get_activations(MifareFuzzerWorker* mifare_fuzzer_worker) {
+    furi_assert(mifare_fuzzer_worker);
+    return mifare_fuzzer_worker->activations;
 }
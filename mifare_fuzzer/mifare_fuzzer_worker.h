@@ -10,10 +10,17 @@ typedef enum MifareFuzzerWorkerState {
 #define UID_LEN 7
 #define ATQA_LEN 2
 
+// Fills the next UID to emulate, called from the worker thread after every reader activation
+typedef void (*MifareFuzzerWorkerNextUidCallback)(FuriHalNfcDevData* nfc_dev_data, void* context);
+
 typedef struct MifareFuzzerWorker {
     FuriThread* thread;
     MifareFuzzerWorkerState state;
+    FuriMutex* mutex;
     FuriHalNfcDevData nfc_dev_data;
+    MifareFuzzerWorkerNextUidCallback next_uid_callback;
+    void* next_uid_context;
+    uint32_t activations;
 } MifareFuzzerWorker;
 
 // worker
@@ -29,3 +36,8 @@ void mifare_fuzzer_worker_set_nfc_dev_data(
     MifareFuzzerWorker* mifare_fuzzer_worker,
     FuriHalNfcDevData nfc_dev_data);
 FuriHalNfcDevData mifare_fuzzer_worker_get_nfc_dev_data(MifareFuzzerWorker* mifare_fuzzer_worker);
+void mifare_fuzzer_worker_set_next_uid_callback(
+    MifareFuzzerWorker* mifare_fuzzer_worker,
+    MifareFuzzerWorkerNextUidCallback callback,
+    void* context);
+uint32_t mifare_fuzzer_worker_get_activations(MifareFuzzerWorker* mifare_fuzzer_worker);
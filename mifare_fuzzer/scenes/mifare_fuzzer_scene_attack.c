@@ -5,6 +5,7 @@ enum SubmenuIndex {
     SubmenuIndexTestValue,
     SubmenuIndexRandomValuesAttack,
     SubmenuIndexLoadUIDsFromFile,
+    SubmenuIndexSequentialValuesAttack,
 };
 
 /// @brief mifare_fuzzer_scene_attack_submenu_callback()
@@ -24,6 +25,9 @@ void mifare_fuzzer_scene_attack_submenu_callback(void* context, uint32_t index)
     case SubmenuIndexLoadUIDsFromFile:
         custom_event = MifareFuzzerEventLoadUIDsFromFileAttack;
         break;
+    case SubmenuIndexSequentialValuesAttack:
+        custom_event = MifareFuzzerEventSequentialValuesAttack;
+        break;
     default:
         return;
     }
@@ -57,6 +61,12 @@ void mifare_fuzzer_scene_attack_on_enter(void* context) {
         SubmenuIndexLoadUIDsFromFile,
         mifare_fuzzer_scene_attack_submenu_callback,
         app);
+    submenu_add_item(
+        submenu_attack,
+        "Sequential Values",
+        SubmenuIndexSequentialValuesAttack,
+        mifare_fuzzer_scene_attack_submenu_callback,
+        app);
 
     // set selected menu
     submenu_set_selected_item(
@@ -97,6 +107,16 @@ bool mifare_fuzzer_scene_attack_on_event(void* context, SceneManagerEvent event)
             // open next scene
             scene_manager_next_scene(app->scene_manager, MifareFuzzerSceneEmulator);
             consumed = true;
+        } else if(event.event == MifareFuzzerEventSequentialValuesAttack) {
+            // save selected item
+            scene_manager_set_scene_state(
+                app->scene_manager, MifareFuzzerSceneAttack, SubmenuIndexSequentialValuesAttack);
+            // set emulator attack
+            app->attack = MifareFuzzerAttackSequentialValues;
+            mifare_fuzzer_emulator_set_attack(app->emulator_view, app->attack);
+            // ask for the start of the range
+            scene_manager_next_scene(app->scene_manager, MifareFuzzerSceneUidStart);
+            consumed = true;
         } else if(event.event == MifareFuzzerEventLoadUIDsFromFileAttack) {
             // save selected item
             scene_manager_set_scene_state(
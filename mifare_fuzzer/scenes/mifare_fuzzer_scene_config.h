@@ -1,3 +1,4 @@
 ADD_SCENE(mifare_fuzzer, start, Start)
 ADD_SCENE(mifare_fuzzer, attack, Attack)
+ADD_SCENE(mifare_fuzzer, uid_start, UidStart)
 ADD_SCENE(mifare_fuzzer, emulator, Emulator)
\ No newline at end of file
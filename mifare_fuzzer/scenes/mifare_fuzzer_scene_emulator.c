@@ -61,6 +61,117 @@ void mifare_fuzzer_scene_emulator_on_enter(void* context) {
     view_dispatcher_switch_to_view(app->view_dispatcher, MifareFuzzerViewEmulator);
 }
 
+/// @brief mifare_fuzzer_scene_emulator_set_card_type()
+/// @param app
+/// @param nfc_dev_data
+static void mifare_fuzzer_scene_emulator_set_card_type(
+    MifareFuzzerApp* app,
+    FuriHalNfcDevData* nfc_dev_data) {
+    if(app->card == MifareCardClassic1k) {
+        nfc_dev_data->atqa[0] = 0x04;
+        nfc_dev_data->atqa[1] = 0x00;
+        nfc_dev_data->sak = 0x08;
+        nfc_dev_data->uid_len = 0x04;
+    } else if(app->card == MifareCardClassic4k) {
+        nfc_dev_data->atqa[0] = 0x02;
+        nfc_dev_data->atqa[1] = 0x00;
+        nfc_dev_data->sak = 0x18;
+        nfc_dev_data->uid_len = 0x04;
+    } else if(app->card == MifareCardUltralight) {
+        nfc_dev_data->atqa[0] = 0x44;
+        nfc_dev_data->atqa[1] = 0x00;
+        nfc_dev_data->sak = 0x00;
+        nfc_dev_data->uid_len = 0x07;
+    }
+}
+
+/// @brief mifare_fuzzer_scene_emulator_next_uid()
+/// Generates the UID following the one in nfc_dev_data, runs in the worker thread when
+/// the UID changes on every reader poll
+/// @param nfc_dev_data
+/// @param context
+static void
+    mifare_fuzzer_scene_emulator_next_uid(FuriHalNfcDevData* nfc_dev_data, void* context) {
+    MifareFuzzerApp* app = context;
+
+    if(app->attack == MifareFuzzerAttackTestValues) {
+        // Load test UIDs
+        for(uint8_t i = 0; i < nfc_dev_data->uid_len; i++) {
+            nfc_dev_data->uid[i] = id_uid_test[attack_step][i];
+        }
+        // Next UIDs on next loop
+        if(attack_step >= 8) {
+            attack_step = 0;
+        } else {
+            attack_step++;
+        }
+    } else if(app->attack == MifareFuzzerAttackRandomValues) {
+        if(app->card == MifareCardUltralight) {
+            // First byte of a 7 byte UID is the manufacturer-code
+            // https://github.com/Proxmark/proxmark3/blob/master/client/taginfo.c
+            // https://stackoverflow.com/questions/37837730/mifare-cards-distinguish-between-4-byte-and-7-byte-uids
+            // https://stackoverflow.com/questions/31233652/how-to-detect-manufacturer-from-nfc-tag-using-android
+
+            // TODO: Manufacture-code must be selectable from a list
+            // use a fixed manufacture-code for now: 0x04 = NXP Semiconductors Germany
+            nfc_dev_data->uid[0] = 0x04;
+            for(uint8_t i = 1; i < nfc_dev_data->uid_len; i++) {
+                nfc_dev_data->uid[i] = (furi_hal_random_get() & 0xFF);
+            }
+        } else {
+            for(uint8_t i = 0; i < nfc_dev_data->uid_len; i++) {
+                nfc_dev_data->uid[i] = (furi_hal_random_get() & 0xFF);
+            }
+        }
+    } else if(app->attack == MifareFuzzerAttackSequentialValues) {
+        if(attack_step == 0) {
+            // Start of the range
+            memcpy(nfc_dev_data->uid, app->nfc_dev_data.uid, nfc_dev_data->uid_len);
+            attack_step = 1;
+        } else {
+            // Increment as a big endian number, wraps around after FF..FF
+            for(int8_t i = nfc_dev_data->uid_len - 1; i >= 0; i--) {
+                if(++nfc_dev_data->uid[i] != 0x00) break;
+            }
+        }
+    } else if(app->attack == MifareFuzzerAttackLoadUidsFromFile) {
+        //bool end_of_list = false;
+        // read stream
+        while(true) {
+            furi_string_reset(app->uid_str);
+            if(!stream_read_line(app->uids_stream, app->uid_str)) {
+                // restart from beginning on empty line
+                stream_rewind(app->uids_stream);
+                continue;
+                //end_of_list = true;
+            }
+            // Skip comments
+            if(furi_string_get_char(app->uid_str, 0) == '#') continue;
+            // Skip lines with invalid length
+            if((furi_string_size(app->uid_str) != 9) && (furi_string_size(app->uid_str) != 15))
+                continue;
+            break;
+        }
+
+        // TODO: stop on end of list?
+        //if(end_of_list) break;
+
+        // parse string to UID
+        // TODO: a better validation on input?
+        for(uint8_t i = 0; i < nfc_dev_data->uid_len; i++) {
+            if(i <= ((furi_string_size(app->uid_str) - 1) / 2)) {
+                char temp_str[3];
+                temp_str[0] = furi_string_get_cstr(app->uid_str)[i * 2];
+                temp_str[1] = furi_string_get_cstr(app->uid_str)[i * 2 + 1];
+                temp_str[2] = '\0';
+                nfc_dev_data->uid[i] = (uint8_t)strtol(temp_str, NULL, 16);
+            } else {
+                nfc_dev_data->uid[i] = 0x00;
+            }
+        }
+    }
+}
+
 /// @brief mifare_fuzzer_scene_emulator_on_event()
 /// @param context
 /// @param event
@@ -78,125 +189,59 @@ bool mifare_fuzzer_scene_emulator_on_event(void* context, SceneManagerEvent even
         if(event.event == MifareFuzzerEventStartAttack) {
             //FURI_LOG_D(TAG, "mifare_fuzzer_scene_emulator_on_event() :: MifareFuzzerEventStartAttack");
 
-            // Stop worker
-            mifare_fuzzer_worker_stop(app->worker);
+            if(mifare_fuzzer_worker_is_emulating(app->worker)) {
+                // Emulator stays armed, only the UID changes
+                nfc_dev_data = mifare_fuzzer_worker_get_nfc_dev_data(app->worker);
+                mifare_fuzzer_scene_emulator_next_uid(&nfc_dev_data, app);
+                mifare_fuzzer_worker_set_nfc_dev_data(app->worker, nfc_dev_data);
+            } else {
+                // Set card type, a restarted attack goes on from the last UID
+                nfc_dev_data = mifare_fuzzer_worker_get_nfc_dev_data(app->worker);
+                mifare_fuzzer_scene_emulator_set_card_type(app, &nfc_dev_data);
+                mifare_fuzzer_scene_emulator_next_uid(&nfc_dev_data, app);
+                mifare_fuzzer_worker_set_nfc_dev_data(app->worker, nfc_dev_data);
 
-            // Set card type
-            // TODO: Move somewhere else, I do not like this to be there
-            if(app->card == MifareCardClassic1k) {
-                nfc_dev_data.atqa[0] = 0x04;
-                nfc_dev_data.atqa[1] = 0x00;
-                nfc_dev_data.sak = 0x08;
-                nfc_dev_data.uid_len = 0x04;
-            } else if(app->card == MifareCardClassic4k) {
-                nfc_dev_data.atqa[0] = 0x02;
-                nfc_dev_data.atqa[1] = 0x00;
-                nfc_dev_data.sak = 0x18;
-                nfc_dev_data.uid_len = 0x04;
-            } else if(app->card == MifareCardUltralight) {
-                nfc_dev_data.atqa[0] = 0x44;
-                nfc_dev_data.atqa[1] = 0x00;
-                nfc_dev_data.sak = 0x00;
-                nfc_dev_data.uid_len = 0x07;
-            }
-
-            // Set UIDs
-            if(app->attack == MifareFuzzerAttackTestValues) {
-                // Load test UIDs
-                for(uint8_t i = 0; i < nfc_dev_data.uid_len; i++) {
-                    nfc_dev_data.uid[i] = id_uid_test[attack_step][i];
-                }
-                // Next UIDs on next loop
-                if(attack_step >= 8) {
-                    attack_step = 0;
-                } else {
-                    attack_step++;
-                }
-            } else if(app->attack == MifareFuzzerAttackRandomValues) {
-                if(app->card == MifareCardUltralight) {
-                    // First byte of a 7 byte UID is the manufacturer-code
-                    // https://github.com/Proxmark/proxmark3/blob/master/client/taginfo.c
-                    // https://stackoverflow.com/questions/37837730/mifare-cards-distinguish-between-4-byte-and-7-byte-uids
-                    // https://stackoverflow.com/questions/31233652/how-to-detect-manufacturer-from-nfc-tag-using-android
-
-                    // TODO: Manufacture-code must be selectable from a list
-                    // use a fixed manufacture-code for now: 0x04 = NXP Semiconductors Germany
-                    nfc_dev_data.uid[0] = 0x04;
-                    for(uint8_t i = 1; i < nfc_dev_data.uid_len; i++) {
-                        nfc_dev_data.uid[i] = (furi_hal_random_get() & 0xFF);
-                    }
+                // Per poll timing: the worker moves to the next UID on every reader activation
+                if(emulator->ticks_between_cards == MIFARE_FUZZER_POLL_TICKS_BETWEEN_CARDS) {
+                    mifare_fuzzer_worker_set_next_uid_callback(
+                        app->worker, mifare_fuzzer_scene_emulator_next_uid, app);
                 } else {
-                    for(uint8_t i = 0; i < nfc_dev_data.uid_len; i++) {
-                        nfc_dev_data.uid[i] = (furi_hal_random_get() & 0xFF);
-                    }
-                }
-            } else if(app->attack == MifareFuzzerAttackLoadUidsFromFile) {
-                //bool end_of_list = false;
-                // read stream
-                while(true) {
-                    furi_string_reset(app->uid_str);
-                    if(!stream_read_line(app->uids_stream, app->uid_str)) {
-                        // restart from beginning on empty line
-                        stream_rewind(app->uids_stream);
-                        continue;
-                        //end_of_list = true;
-                    }
-                    // Skip comments
-                    if(furi_string_get_char(app->uid_str, 0) == '#') continue;
-                    // Skip lines with invalid length
-                    if((furi_string_size(app->uid_str) != 9) &&
-                       (furi_string_size(app->uid_str) != 15))
-                        continue;
-                    break;
+                    mifare_fuzzer_worker_set_next_uid_callback(app->worker, NULL, NULL);
                 }
 
-                // TODO: stop on end of list?
-                //if(end_of_list) break;
-
-                // parse string to UID
-                // TODO: a better validation on input?
-                for(uint8_t i = 0; i < nfc_dev_data.uid_len; i++) {
-                    if(i <= ((furi_string_size(app->uid_str) - 1) / 2)) {
-                        char temp_str[3];
-                        temp_str[0] = furi_string_get_cstr(app->uid_str)[i * 2];
-                        temp_str[1] = furi_string_get_cstr(app->uid_str)[i * 2 + 1];
-                        temp_str[2] = '\0';
-                        nfc_dev_data.uid[i] = (uint8_t)strtol(temp_str, NULL, 16);
-                    } else {
-                        nfc_dev_data.uid[i] = 0x00;
-                    }
-                }
+                // Start worker
+                mifare_fuzzer_worker_start(app->worker);
             }
 
-            mifare_fuzzer_worker_set_nfc_dev_data(app->worker, nfc_dev_data);
             mifare_fuzzer_emulator_set_nfc_dev_data(app->emulator_view, nfc_dev_data);
 
             // Reset tick_counter
             tick_counter = 0;
             mifare_fuzzer_emulator_set_tick_num(app->emulator_view, tick_counter);
 
-            // Start worker
-            mifare_fuzzer_worker_start(app->worker);
-
         } else if(event.event == MifareFuzzerEventStopAttack) {
             //FURI_LOG_D(TAG, "mifare_fuzzer_scene_emulator_on_event() :: MifareFuzzerEventStopAttack");
             // Stop worker
             mifare_fuzzer_worker_stop(app->worker);
         } else if(event.event == MifareFuzzerEventIncrementTicks) {
             if(!emulator->is_attacking) {
-                if(emulator->ticks_between_cards < MIFARE_FUZZER_MAX_TICKS_BETWEEN_CARDS) {
+                if(emulator->ticks_between_cards == MIFARE_FUZZER_POLL_TICKS_BETWEEN_CARDS) {
+                    emulator->ticks_between_cards = MIFARE_FUZZER_MIN_TICKS_BETWEEN_CARDS;
+                } else if(emulator->ticks_between_cards < MIFARE_FUZZER_MAX_TICKS_BETWEEN_CARDS) {
                     emulator->ticks_between_cards++;
-                    mifare_fuzzer_emulator_set_ticks_between_cards(
-                        app->emulator_view, emulator->ticks_between_cards);
                 };
+                mifare_fuzzer_emulator_set_ticks_between_cards(
+                    app->emulator_view, emulator->ticks_between_cards);
             };
         } else if(event.event == MifareFuzzerEventDecrementTicks) {
             if(!emulator->is_attacking) {
                 if(emulator->ticks_between_cards > MIFARE_FUZZER_MIN_TICKS_BETWEEN_CARDS) {
                     emulator->ticks_between_cards--;
-                    mifare_fuzzer_emulator_set_ticks_between_cards(
-                        app->emulator_view, emulator->ticks_between_cards);
+                } else {
+                    emulator->ticks_between_cards = MIFARE_FUZZER_POLL_TICKS_BETWEEN_CARDS;
                 };
+                mifare_fuzzer_emulator_set_ticks_between_cards(
+                    app->emulator_view, emulator->ticks_between_cards);
             };
         }
         consumed = true;
@@ -209,7 +254,12 @@ bool mifare_fuzzer_scene_emulator_on_event(void* context, SceneManagerEvent even
         //FURI_LOG_D(TAG, "Time is: %.2d:%.2d:%.2d", curr_dt.hour, curr_dt.minute, curr_dt.second);
 
         // If emulator is attacking
-        if(emulator->is_attacking) {
+        if(emulator->is_attacking &&
+           emulator->ticks_between_cards == MIFARE_FUZZER_POLL_TICKS_BETWEEN_CARDS) {
+            // UIDs are changed by the worker, only show where it got to
+            mifare_fuzzer_emulator_set_nfc_dev_data(
+                app->emulator_view, mifare_fuzzer_worker_get_nfc_dev_data(app->worker));
+        } else if(emulator->is_attacking) {
             // increment tick_counter
             tick_counter++;
             mifare_fuzzer_emulator_set_tick_num(app->emulator_view, tick_counter);
@@ -0,0 +1,67 @@
+#include "../mifare_fuzzer_i.h"
+#include "../mifare_fuzzer_custom_events.h"
+
+/// @brief mifare_fuzzer_scene_uid_start_byte_input_callback()
+/// @param context
+static void mifare_fuzzer_scene_uid_start_byte_input_callback(void* context) {
+    MifareFuzzerApp* app = context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, MifareFuzzerEventUidStartEntered);
+}
+
+/// @brief mifare_fuzzer_scene_uid_start_on_enter()
+/// @param context
+void mifare_fuzzer_scene_uid_start_on_enter(void* context) {
+    //FURI_LOG_D(TAG, "mifare_fuzzer_scene_uid_start_on_enter()");
+    MifareFuzzerApp* app = context;
+
+    if(app->card == MifareCardUltralight) {
+        app->nfc_dev_data.uid_len = 0x07;
+        // keep NXP manufacturer-code as default, see random values attack
+        if(app->nfc_dev_data.uid[0] == 0x00) {
+            app->nfc_dev_data.uid[0] = 0x04;
+        }
+    } else {
+        app->nfc_dev_data.uid_len = 0x04;
+    }
+
+    ByteInput* byte_input = app->byte_input;
+    byte_input_set_header_text(byte_input, "Enter first UID");
+    byte_input_set_result_callback(
+        byte_input,
+        mifare_fuzzer_scene_uid_start_byte_input_callback,
+        NULL,
+        app,
+        app->nfc_dev_data.uid,
+        app->nfc_dev_data.uid_len);
+
+    view_dispatcher_switch_to_view(app->view_dispatcher, MifareFuzzerViewByteInput);
+}
+
+/// @brief mifare_fuzzer_scene_uid_start_on_event()
+/// @param context
+/// @param event
+/// @return
+bool mifare_fuzzer_scene_uid_start_on_event(void* context, SceneManagerEvent event) {
+    //FURI_LOG_D(TAG, "mifare_fuzzer_scene_uid_start_on_event()");
+    MifareFuzzerApp* app = context;
+    bool consumed = false;
+
+    if(event.type == SceneManagerEventTypeCustom) {
+        if(event.event == MifareFuzzerEventUidStartEntered) {
+            // open next scene
+            scene_manager_next_scene(app->scene_manager, MifareFuzzerSceneEmulator);
+            consumed = true;
+        }
+    }
+
+    return consumed;
+}
+
+/// @brief mifare_fuzzer_scene_uid_start_on_exit()
+/// @param context
+void mifare_fuzzer_scene_uid_start_on_exit(void* context) {
+    //FURI_LOG_D(TAG, "mifare_fuzzer_scene_uid_start_on_exit()");
+    MifareFuzzerApp* app = context;
+    byte_input_set_result_callback(app->byte_input, NULL, NULL, NULL, NULL, 0);
+    byte_input_set_header_text(app->byte_input, "");
+}
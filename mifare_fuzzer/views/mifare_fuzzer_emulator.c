@@ -59,7 +59,11 @@ static void mifare_fuzzer_emulator_draw_callback(Canvas* canvas, void* _model) {
     canvas_draw_str(canvas, 4, 22, "c:");
     canvas_draw_str(canvas, 15, 22, model->mifare_card_dsc);
     // Timing
-    furi_string_printf(furi_string, "%d", model->ticks_between_cards);
+    if(model->ticks_between_cards) {
+        furi_string_printf(furi_string, "%d", model->ticks_between_cards);
+    } else {
+        furi_string_set_str(furi_string, "poll");
+    }
     canvas_draw_str(canvas, 90, 22, "t:");
     canvas_draw_str(canvas, 100, 22, furi_string_get_cstr(furi_string));
     // Attack
@@ -71,7 +75,10 @@ static void mifare_fuzzer_emulator_draw_callback(Canvas* canvas, void* _model) {
         elements_button_center(canvas, "Start");
         elements_button_right(canvas, "t+1");
     } else {
-        canvas_draw_line(canvas, 1, 49, (128 * model->tick_num / model->ticks_between_cards), 49);
+        if(model->ticks_between_cards) {
+            canvas_draw_line(
+                canvas, 1, 49, (128 * model->tick_num / model->ticks_between_cards), 49);
+        }
         elements_button_center(canvas, "Stop");
     }
 
@@ -247,6 +254,9 @@ void mifare_fuzzer_emulator_set_attack(
             case MifareFuzzerAttackRandomValues:
                 model->attack_dsc = "Random values";
                 break;
+            case MifareFuzzerAttackSequentialValues:
+                model->attack_dsc = "Sequential values";
+                break;
             case MifareFuzzerAttackLoadUidsFromFile:
                 model->attack_dsc = "Load Uids From File";
                 break;
@@ -17,6 +17,7 @@ typedef enum MifareFuzzerAttack {
     MifareFuzzerAttackTestValues = 1,
     MifareFuzzerAttackRandomValues,
     MifareFuzzerAttackLoadUidsFromFile,
+    MifareFuzzerAttackSequentialValues,
 } MifareFuzzerAttack;
 
 typedef struct MifareFuzzerEmulator {
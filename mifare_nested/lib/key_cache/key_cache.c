@@ -0,0 +1,171 @@
+#include "key_cache.h"
+
+#include <furi.h>
+#include <string.h>
+
+#define TAG "KeyCache"
+
+#define KEY_CACHE_FOLDER EXT_PATH("nfc/.cache")
+#define KEY_CACHE_MAGIC (0x3149434B) // "KCI1"
+
+typedef struct {
+    uint32_t magic;
+    uint32_t count;
+} KeyCacheHeader;
+
+static bool key_cache_seek(File* file, uint32_t index) {
+    return storage_file_seek(
+        file, sizeof(KeyCacheHeader) + index * sizeof(KeyCacheRecord), true);
+}
+
+static bool key_cache_read_record(File* file, uint32_t index, KeyCacheRecord* record) {
+    return key_cache_seek(file, index) &&
+           storage_file_read(file, record, sizeof(KeyCacheRecord)) == sizeof(KeyCacheRecord);
+}
+
+static bool key_cache_write_record(File* file, uint32_t index, const KeyCacheRecord* record) {
+    return key_cache_seek(file, index) &&
+           storage_file_write(file, record, sizeof(KeyCacheRecord)) == sizeof(KeyCacheRecord);
+}
+
+// Records in the file, 0 for a new or broken file
+static uint32_t key_cache_read_count(File* file) {
+    KeyCacheHeader header;
+
+    if(!storage_file_seek(file, 0, true) ||
+       storage_file_read(file, &header, sizeof(header)) != sizeof(header) ||
+       header.magic != KEY_CACHE_MAGIC || header.count > KEY_CACHE_MAX_RECORDS ||
+       storage_file_size(file) < sizeof(header) + header.count * sizeof(KeyCacheRecord)) {
+        return 0;
+    }
+
+    return header.count;
+}
+
+static bool key_cache_write_count(File* file, uint32_t count) {
+    KeyCacheHeader header = {.magic = KEY_CACHE_MAGIC, .count = count};
+
+    return storage_file_seek(file, 0, true) &&
+           storage_file_write(file, &header, sizeof(header)) == sizeof(header);
+}
+
+// First record not below (cuid, key)
+static bool key_cache_lower_bound(
+    File* file,
+    uint32_t count,
+    uint32_t cuid,
+    uint64_t key,
+    uint32_t* index) {
+    uint32_t low = 0, high = count;
+    KeyCacheRecord record;
+
+    while(low < high) {
+        uint32_t mid = low + (high - low) / 2;
+
+        if(!key_cache_read_record(file, mid, &record)) return false;
+
+        if(record.cuid < cuid || (record.cuid == cuid && record.key < key)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    *index = low;
+
+    return true;
+}
+
+KeyCacheRecord* key_cache_find(Storage* storage, uint32_t cuid, size_t* count) {
+    File* file = storage_file_alloc(storage);
+    KeyCacheRecord* records = NULL;
+    *count = 0;
+
+    if(storage_file_open(file, KEY_CACHE_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        uint32_t total = key_cache_read_count(file);
+        uint32_t index;
+        KeyCacheRecord record;
+
+        if(key_cache_lower_bound(file, total, cuid, 0, &index)) {
+            while(index < total && key_cache_read_record(file, index, &record) &&
+                  record.cuid == cuid) {
+                records = realloc(records, sizeof(KeyCacheRecord) * (*count + 1)); //-V701
+                records[(*count)++] = record;
+                index++;
+            }
+        }
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+
+    return records;
+}
+
+bool key_cache_add(
+    Storage* storage,
+    uint32_t cuid,
+    uint64_t key,
+    uint8_t sector,
+    uint8_t key_type) {
+    if(sector >= KEY_CACHE_SECTORS || key_type > 1) return false;
+
+    storage_common_mkdir(storage, KEY_CACHE_FOLDER);
+
+    File* file = storage_file_alloc(storage);
+    bool success = false;
+
+    do {
+        if(!storage_file_open(file, KEY_CACHE_PATH, FSAM_READ_WRITE, FSOM_OPEN_ALWAYS)) break;
+
+        uint32_t count = key_cache_read_count(file);
+        uint32_t index;
+        KeyCacheRecord record;
+
+        if(!key_cache_lower_bound(file, count, cuid, key, &index)) break;
+
+        bool exists = index < count && key_cache_read_record(file, index, &record) &&
+                      record.cuid == cuid && record.key == key;
+        bool counted = exists;
+
+        if(!exists) {
+            if(count >= KEY_CACHE_MAX_RECORDS) {
+                FURI_LOG_W(TAG, "Index is full, %012llX not added", key);
+                break;
+            }
+
+            // Make room from the end. The last record is copied past the end and counted
+            // before the rest moves up, so an interrupted insert leaves a duplicate next to
+            // its original but never drops a record, and the file stays sorted.
+            bool shifted = true;
+
+            for(uint32_t i = count; i > index && shifted; i--) {
+                shifted = key_cache_read_record(file, i - 1, &record) &&
+                          key_cache_write_record(file, i, &record);
+                if(shifted && i == count) {
+                    shifted = key_cache_write_count(file, count + 1);
+                    counted = shifted;
+                }
+            }
+
+            if(!shifted) break;
+
+            memset(&record, 0, sizeof(record));
+            record.cuid = cuid;
+            record.key = key;
+        }
+
+        if(record.hits[sector][key_type] < UINT8_MAX) record.hits[sector][key_type]++;
+
+        if(!key_cache_write_record(file, index, &record)) break;
+
+        success = counted || key_cache_write_count(file, count + 1);
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+
+    if(!success) FURI_LOG_E(TAG, "Failed to save %012llX", key);
+
+    return success;
+}
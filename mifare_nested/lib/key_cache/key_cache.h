@@ -0,0 +1,26 @@
+#pragma once
+
+#include <storage/storage.h>
+
+// Binary index of the keys found on each card, shared by Mifare Nested and Mfkey32.
+// Records are sorted by cuid then key, so the keys of a card are one binary search away
+#define KEY_CACHE_PATH EXT_PATH("nfc/.cache/mf_classic_keys.idx")
+#define KEY_CACHE_SECTORS 40
+#define KEY_CACHE_MAX_RECORDS 2048
+
+typedef struct {
+    uint64_t key;
+    uint32_t cuid;
+    uint8_t hits[KEY_CACHE_SECTORS][2]; // Times the key opened each sector, per key type
+} KeyCacheRecord;
+
+// Records of cuid, sorted by key. Returns NULL if there are none, caller frees them
+KeyCacheRecord* key_cache_find(Storage* storage, uint32_t cuid, size_t* count);
+
+// Count a hit of key for sector and key_type of cuid, the record is added if needed
+bool key_cache_add(
+    Storage* storage,
+    uint32_t cuid,
+    uint64_t key,
+    uint8_t sector,
+    uint8_t key_type);
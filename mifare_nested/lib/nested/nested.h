@@ -1,5 +1,6 @@
 #pragma once
 
+#include <furi.h>
 #include <lib/nfc/protocols/nfc_util.h>
 #include <lib/nfc/protocols/mifare_classic.h>
 #include <lib/nfc/protocols/crypto1.h>
@@ -8,6 +9,8 @@
 #include <stream/stream.h>
 #include <stream/buffered_file_stream.h>
 
+#include "nested_prng.h"
+
 typedef enum {
     MifareNestedNonceNoTag,
     MifareNestedNonceWeak,
@@ -30,6 +33,13 @@ struct nonce_info_hard {
     bool full;
 };
 
+// Encrypted nonce of nested_hard_nonce_attack(), the worker writes it to the nonces file
+struct nonce_hard {
+    uint32_t nt;
+    uint8_t parity;
+    bool last; // No more nonces for this file
+};
+
 struct nonce_info {
     uint32_t cuid;
     uint32_t target_nt[2];
@@ -62,6 +72,15 @@ struct nonce_info nested_attack(
     uint32_t distance,
     uint32_t delay);
 
+// Plain nonces that fit nt2, collected with a delay: distance (+- 2) PRNG steps
+// after nt1 and matching the parity. Writes up to 5 of them to nt, returns the count
+uint32_t nested_predict_nonces(
+    uint32_t nt1,
+    uint32_t nt2,
+    uint32_t distance,
+    const uint8_t* parity,
+    uint32_t* nt);
+
 struct nonce_info_hard nested_hard_nonce_attack(
     FuriHalNfcTxRxContext* tx_rx,
     uint8_t blockNo,
@@ -71,7 +90,7 @@ struct nonce_info_hard nested_hard_nonce_attack(
     uint64_t ui64Key,
     uint32_t* found,
     uint32_t* first_byte_sum,
-    Stream* file_stream);
+    FuriMessageQueue* queue);
 
 uint32_t nested_calibrate_distance(
     FuriHalNfcTxRxContext* tx_rx,
@@ -99,6 +118,28 @@ NestedCheckKeyResult nested_check_key(
     uint8_t keyType,
     uint64_t ui64Key);
 
+// Nonce of a nested auth, encrypted with the key being looked for
+struct nonce_encrypted {
+    uint32_t cuid;
+    uint32_t nt;
+    uint8_t parity[4];
+};
+
+// Auth with a known key and send a nested auth to targetBlockNo, without answering it
+bool nested_capture_nonce(
+    FuriHalNfcTxRxContext* tx_rx,
+    uint8_t blockNo,
+    uint8_t keyType,
+    uint64_t ui64Key,
+    uint8_t targetBlockNo,
+    uint8_t targetKeyType,
+    struct nonce_encrypted* nonce);
+
+// How well a candidate key decrypts a captured nonce: 0 if the parity doesn't
+// match, 1 if it does, 2 if the nonce also is a weak PRNG nonce.
+// The right key always gets the highest score the tag's PRNG allows
+uint8_t nested_key_fits_nonce(const struct nonce_encrypted* nonce, uint64_t ui64Key);
+
 bool nested_check_block(FuriHalNfcTxRxContext* tx_rx, uint8_t blockNo, uint8_t keyType);
 
 void nested_get_data();
@@ -0,0 +1,108 @@
+#include "nested_prng.h"
+
+#include "../../profile.h"
+
+// Positions of the 16 bit PRNG, one every NESTED_PRNG_GIANT_STEP steps, sorted
+// by state. Any state reaches one of them in at most 2 * NESTED_PRNG_GIANT_STEP
+// steps, instead of walking the whole 65535 steps period
+#define NESTED_PRNG_PERIOD 65535
+#define NESTED_PRNG_GIANT_STEP 256
+#define NESTED_PRNG_GIANT_COUNT (NESTED_PRNG_PERIOD / NESTED_PRNG_GIANT_STEP + 1)
+
+static uint32_t prng_giant_steps[NESTED_PRNG_GIANT_COUNT];
+static bool prng_giant_steps_ready = false;
+
+static inline uint16_t prng_step(uint16_t x) {
+    return x >> 1 | (x ^ x >> 2 ^ x >> 3 ^ x >> 5) << 15;
+}
+
+static void prng_build_giant_steps() {
+    uint16_t x = 1;
+
+    // State in the high half, giant step number in the low half
+    for(uint32_t i = 1, count = 0; i <= NESTED_PRNG_PERIOD; i++) {
+        if(i % NESTED_PRNG_GIANT_STEP == 1) {
+            uint32_t entry = (uint32_t)x << 16 | count++;
+            uint32_t j = count - 1;
+
+            for(; j > 0 && prng_giant_steps[j - 1] > entry; j--) {
+                prng_giant_steps[j] = prng_giant_steps[j - 1];
+            }
+
+            prng_giant_steps[j] = entry;
+        }
+
+        x = prng_step(x);
+    }
+
+    prng_giant_steps_ready = true;
+}
+
+static int32_t prng_find_giant_step(uint16_t x) {
+    int32_t low = 0, high = NESTED_PRNG_GIANT_COUNT - 1;
+
+    while(low <= high) {
+        int32_t mid = (low + high) / 2;
+        uint16_t state = prng_giant_steps[mid] >> 16;
+
+        if(state == x) {
+            return prng_giant_steps[mid] & 0xffff;
+        } else if(state < x) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+
+    return -1;
+}
+
+// Position (1 to 65535) of a 16 bit PRNG value, counting PRNG steps from 1.
+// Returns 0 for 0, which the PRNG never produces
+static uint32_t prng_position(uint16_t value) {
+    if(value == 0) return 0;
+    if(!prng_giant_steps_ready) prng_build_giant_steps();
+
+    uint16_t x = value << 8 | value >> 8;
+
+    for(uint32_t steps = 0;; steps++) {
+        int32_t giant = prng_find_giant_step(x);
+
+        if(giant >= 0) {
+            int32_t position = giant * NESTED_PRNG_GIANT_STEP + 1 - steps;
+            return position > 0 ? position : position + NESTED_PRNG_PERIOD;
+        }
+
+        x = prng_step(x);
+    }
+}
+
+void nonce_distance(uint32_t* msb, uint32_t* lsb) {
+    PROFILE_BEGIN(nonce_distance);
+    if(*msb) *msb = prng_position(*msb);
+    if(*lsb) *lsb = prng_position(*lsb);
+    PROFILE_END(nonce_distance);
+}
+
+bool validate_prng_nonce(uint32_t nonce) {
+    uint32_t msb = nonce >> 16;
+    uint32_t lsb = nonce & 0xffff;
+    nonce_distance(&msb, &lsb);
+    return ((65535 - msb + lsb) % 65535) == 16;
+}
+
+uint32_t nested_prng_distance(uint32_t nt1, uint32_t nt2, uint32_t min_distance) {
+    if(!validate_prng_nonce(nt1) || !validate_prng_nonce(nt2)) {
+        return UINT32_MAX;
+    }
+
+    uint32_t distance = (prng_position(nt2 >> 16) + NESTED_PRNG_PERIOD -
+                         prng_position(nt1 >> 16)) %
+                        NESTED_PRNG_PERIOD;
+
+    while(distance < min_distance) {
+        distance += NESTED_PRNG_PERIOD;
+    }
+
+    return distance;
+}
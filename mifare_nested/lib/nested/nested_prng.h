@@ -0,0 +1,17 @@
+#pragma once
+
+// Weak 16 bit PRNG of the tags, free of any Flipper API so that it can also
+// be built on the host (host/ in the repository root)
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Replace each non zero 16 bit PRNG value with its position (1 to 65535)
+void nonce_distance(uint32_t* msb, uint32_t* lsb);
+
+// True if the nonce was generated by the weak 16 bit PRNG
+bool validate_prng_nonce(uint32_t nonce);
+
+// PRNG steps from nt1 to nt2, at least min_distance (whole 65535 steps periods
+// are added to shorter ones). Returns UINT32_MAX if they aren't weak PRNG nonces
+uint32_t nested_prng_distance(uint32_t nt1, uint32_t nt2, uint32_t min_distance);
@@ -0,0 +1,391 @@
+#include "nested_recover.h"
+#include "../crypto1/crypto1.h"
+#include "../parity/parity.h"
+
+#define TAG "NestedRecover"
+
+// States of one semi-state after the first 8 extensions
+#define NESTED_RECOVER_EXPAND_SIZE (512)
+// States of one round per msb value and table, about 2250 are found in practice.
+// Extra room is left after them since partitions grow in place while extended
+#define NESTED_RECOVER_TABLE_SIZE (2560)
+#define NESTED_RECOVER_TABLE_HEADROOM (256)
+
+#define NESTED_RECOVER_ODD_M1 (LF_POLY_EVEN << 1 | 1)
+#define NESTED_RECOVER_ODD_M2 (LF_POLY_ODD << 1)
+#define NESTED_RECOVER_EVEN_M1 (LF_POLY_ODD)
+#define NESTED_RECOVER_EVEN_M2 (LF_POLY_EVEN << 1 | 1)
+
+typedef struct {
+    uint32_t* odd;
+    uint32_t* even;
+    uint32_t cuid;
+    uint32_t nt[2];
+    uint32_t ks[2];
+    uint32_t msb_limit;
+    int table_size;
+    bool done;
+    const NestedRecoverCallbacks* callbacks;
+} NestedRecoverSearch;
+
+static inline void nested_recover_update_contribution(uint32_t* item, uint32_t m1, uint32_t m2) {
+    uint32_t p = *item >> 25;
+    p = p << 1 | evenparity32(*item & m1);
+    p = p << 1 | evenparity32(*item & m2);
+    *item = p << 24 | (*item & 0xffffff);
+}
+
+// Shift one more keystream bit into table[head..tail], dropping the states that
+// don't produce it. States that fit both ways are doubled at the end of the table.
+// Returns the new tail, head - 1 if no state is left
+static int nested_recover_extend_table(
+    uint32_t* table,
+    int head,
+    int tail,
+    uint32_t bit,
+    bool contribution,
+    uint32_t m1,
+    uint32_t m2,
+    uint32_t in) {
+    in <<= 24;
+
+    for(int i = head; i <= tail; i++) {
+        table[i] <<= 1;
+        uint32_t filter = crypto1_filter(table[i]);
+
+        if(filter != crypto1_filter(table[i] | 1)) {
+            table[i] |= filter ^ bit;
+            if(contribution) {
+                nested_recover_update_contribution(&table[i], m1, m2);
+                table[i] ^= in;
+            }
+        } else if(filter == bit) {
+            table[++tail] = table[i + 1];
+            table[i + 1] = table[i] | 1;
+            if(contribution) {
+                nested_recover_update_contribution(&table[i], m1, m2);
+                table[i] ^= in;
+                i++;
+                nested_recover_update_contribution(&table[i], m1, m2);
+                table[i] ^= in;
+            } else {
+                i++;
+            }
+        } else {
+            table[i--] = table[tail--];
+        }
+    }
+
+    return tail;
+}
+
+static void nested_recover_sort(uint32_t* table, int low, int high) {
+    while(low < high) {
+        uint32_t pivot = table[low + (high - low) / 2];
+        int i = low, j = high;
+
+        while(i <= j) {
+            while(table[i] < pivot) i++;
+            while(table[j] > pivot) j--;
+            if(i <= j) {
+                uint32_t temp = table[i];
+                table[i++] = table[j];
+                table[j--] = temp;
+            }
+        }
+
+        // Recurse into the smaller half to keep the stack shallow
+        if(j - low < high - i) {
+            nested_recover_sort(table, low, j);
+            low = i;
+        } else {
+            nested_recover_sort(table, i, high);
+            high = j;
+        }
+    }
+}
+
+static void nested_recover_rollback_word(Crypto1* crypto1, uint32_t in) {
+    for(int i = 31; i >= 0; i--) {
+        uint32_t out;
+
+        crypto1->odd &= 0xffffff;
+        FURI_SWAP(crypto1->odd, crypto1->even);
+        out = crypto1->even & 1;
+        out ^= LF_POLY_EVEN & (crypto1->even >>= 1);
+        out ^= LF_POLY_ODD & crypto1->odd;
+        out ^= BEBIT(in, i);
+        crypto1->even |= evenparity32(out) << 23;
+    }
+}
+
+static uint64_t nested_recover_get_lfsr(Crypto1* crypto1) {
+    uint64_t lfsr = 0;
+
+    for(int i = 23; i >= 0; i--) {
+        lfsr = lfsr << 1 | FURI_BIT(crypto1->odd, i ^ 3);
+        lfsr = lfsr << 1 | FURI_BIT(crypto1->even, i ^ 3);
+    }
+
+    return lfsr;
+}
+
+// state is the cipher right after the first nonce, roll it back to the key
+// and see if the same key also encrypted the second one
+static void nested_recover_check_state(NestedRecoverSearch* search, Crypto1* state) {
+    nested_recover_rollback_word(state, search->cuid ^ search->nt[0]);
+    uint64_t key = nested_recover_get_lfsr(state);
+
+    Crypto1 crypto1;
+    crypto1_init(&crypto1, key);
+    if(crypto1_word(&crypto1, search->cuid ^ search->nt[1], 0) != search->ks[1]) {
+        return;
+    }
+
+    FURI_LOG_D(TAG, "Key candidate: %012llX", key);
+
+    const NestedRecoverCallbacks* callbacks = search->callbacks;
+    if(callbacks && callbacks->key_found && callbacks->key_found(callbacks->context, key)) {
+        search->done = true;
+    }
+}
+
+static void nested_recover_intersect(
+    NestedRecoverSearch* search,
+    int o_head,
+    int o_tail,
+    uint32_t oks,
+    int e_head,
+    int e_tail,
+    uint32_t eks,
+    int rem,
+    uint32_t in);
+
+static void nested_recover_descend(
+    NestedRecoverSearch* search,
+    int o_head,
+    int o_tail,
+    uint32_t oks,
+    int e_head,
+    int e_tail,
+    uint32_t eks,
+    int rem,
+    uint32_t in) {
+    uint32_t* odd = search->odd;
+    uint32_t* even = search->even;
+
+    if(rem == -1) {
+        for(int e = e_head; e <= e_tail && !search->done; e++) {
+            uint32_t even_state = even[e] << 1 ^ evenparity32(even[e] & LF_POLY_EVEN) ^
+                                  !!(in & 4);
+
+            for(int o = o_head; o <= o_tail && !search->done; o++) {
+                Crypto1 state = {
+                    .odd = even_state ^ evenparity32(odd[o] & LF_POLY_ODD),
+                    .even = odd[o],
+                };
+                nested_recover_check_state(search, &state);
+            }
+        }
+
+        return;
+    }
+
+    for(int i = 0; i < 4 && rem--; i++) {
+        oks >>= 1;
+        eks >>= 1;
+        in >>= 2;
+        o_tail = nested_recover_extend_table(
+            odd, o_head, o_tail, oks & 1, true, NESTED_RECOVER_ODD_M1, NESTED_RECOVER_ODD_M2, 0);
+        if(o_head > o_tail) return;
+        e_tail = nested_recover_extend_table(
+            even,
+            e_head,
+            e_tail,
+            eks & 1,
+            true,
+            NESTED_RECOVER_EVEN_M1,
+            NESTED_RECOVER_EVEN_M2,
+            in & 3);
+        if(e_head > e_tail) return;
+    }
+
+    nested_recover_intersect(search, o_head, o_tail, oks, e_head, e_tail, eks, rem, in);
+}
+
+// Only odd and even states with the same contribution byte can be merged.
+// Partitions are walked from the top, so the one being extended can only
+// overwrite partitions that are already done
+static void nested_recover_intersect(
+    NestedRecoverSearch* search,
+    int o_head,
+    int o_tail,
+    uint32_t oks,
+    int e_head,
+    int e_tail,
+    uint32_t eks,
+    int rem,
+    uint32_t in) {
+    uint32_t* odd = search->odd;
+    uint32_t* even = search->even;
+
+    nested_recover_sort(odd, o_head, o_tail);
+    nested_recover_sort(even, e_head, e_tail);
+
+    while(o_tail >= o_head && e_tail >= e_head && !search->done) {
+        uint32_t o_msb = odd[o_tail] >> 24;
+        uint32_t e_msb = even[e_tail] >> 24;
+
+        if(o_msb == e_msb) {
+            int o = o_tail, e = e_tail;
+            while(o_tail >= o_head && odd[o_tail] >> 24 == o_msb) o_tail--;
+            while(e_tail >= e_head && even[e_tail] >> 24 == e_msb) e_tail--;
+            nested_recover_descend(search, o_tail + 1, o, oks, e_tail + 1, e, eks, rem, in);
+        } else if(o_msb > e_msb) {
+            while(o_tail >= o_head && odd[o_tail] >> 24 == o_msb) o_tail--;
+        } else {
+            while(e_tail >= e_head && even[e_tail] >> 24 == e_msb) e_tail--;
+        }
+    }
+}
+
+// Build every state of the table after the first 8 keystream bits whose
+// contribution byte is in [msb_head, msb_head + msb_limit).
+// Returns the tail of the table, -2 if the table overflowed
+static int nested_recover_build_table(
+    NestedRecoverSearch* search,
+    uint32_t* table,
+    uint32_t* expand,
+    uint32_t semi_state,
+    int tail,
+    uint32_t ks,
+    uint32_t m1,
+    uint32_t m2,
+    uint32_t in,
+    uint32_t msb_head) {
+    int expand_tail = 0;
+    expand[0] = semi_state;
+
+    for(uint32_t bit = 1; bit <= 8 && expand_tail >= 0; bit++) {
+        expand_tail = nested_recover_extend_table(
+            expand,
+            0,
+            expand_tail,
+            FURI_BIT(ks, bit),
+            bit > 4,
+            m1,
+            m2,
+            bit > 4 ? (in >> (2 * (bit - 4))) & 3 : 0);
+    }
+
+    for(int i = 0; i <= expand_tail; i++) {
+        if((expand[i] >> 24) - msb_head < search->msb_limit) {
+            if(tail + 1 >= search->table_size) return -2;
+            table[++tail] = expand[i];
+        }
+    }
+
+    return tail;
+}
+
+bool nested_recover_key(
+    uint32_t cuid,
+    const uint32_t nt[2],
+    const uint32_t ks[2],
+    uint32_t msb_limit,
+    const NestedRecoverCallbacks* callbacks) {
+    size_t table_size = sizeof(uint32_t) * msb_limit *
+                        (NESTED_RECOVER_TABLE_SIZE + NESTED_RECOVER_TABLE_HEADROOM);
+    uint32_t* expand = malloc(sizeof(uint32_t) * NESTED_RECOVER_EXPAND_SIZE);
+    NestedRecoverSearch search = {
+        .odd = malloc(table_size),
+        .even = malloc(table_size),
+        .cuid = cuid,
+        .nt = {nt[0], nt[1]},
+        .ks = {ks[0], ks[1]},
+        .msb_limit = msb_limit,
+        .table_size = msb_limit * NESTED_RECOVER_TABLE_SIZE,
+        .done = false,
+        .callbacks = callbacks,
+    };
+    bool aborted = false;
+
+    uint32_t oks = 0, eks = 0;
+    for(int i = 31; i >= 0; i -= 2) {
+        oks = oks << 1 | BEBIT(ks[0], i);
+    }
+    for(int i = 30; i >= 0; i -= 2) {
+        eks = eks << 1 | BEBIT(ks[0], i);
+    }
+
+    // Input bits are fed to the even half, in the order the tables consume them
+    uint32_t in = cuid ^ nt[0];
+    in = (in >> 16 & 0xff) | (in << 16) | (in & 0xff00);
+    in <<= 1;
+
+    for(uint32_t round = 0; round < 256 / msb_limit && !search.done && !aborted; round++) {
+        uint32_t msb_head = round * msb_limit;
+        int o_tail = -1, e_tail = -1;
+
+        for(int32_t semi_state = 1 << 20; semi_state >= 0 && !aborted; semi_state--) {
+            if(semi_state % 32768 == 0 && callbacks && callbacks->should_stop &&
+               callbacks->should_stop(callbacks->context)) {
+                aborted = true;
+                break;
+            }
+
+            uint32_t filter = crypto1_filter(semi_state);
+            if(filter == (oks & 1)) {
+                o_tail = nested_recover_build_table(
+                    &search,
+                    search.odd,
+                    expand,
+                    semi_state,
+                    o_tail,
+                    oks,
+                    NESTED_RECOVER_ODD_M1,
+                    NESTED_RECOVER_ODD_M2,
+                    0,
+                    msb_head);
+            }
+            if(filter == (eks & 1)) {
+                e_tail = nested_recover_build_table(
+                    &search,
+                    search.even,
+                    expand,
+                    semi_state,
+                    e_tail,
+                    eks,
+                    NESTED_RECOVER_EVEN_M1,
+                    NESTED_RECOVER_EVEN_M2,
+                    in,
+                    msb_head);
+            }
+
+            if(o_tail == -2 || e_tail == -2) {
+                FURI_LOG_E(TAG, "Table overflow in round %lu", round);
+                aborted = true;
+            }
+        }
+
+        if(aborted) break;
+
+        nested_recover_intersect(&search, 0, o_tail, oks >> 8, 0, e_tail, eks >> 8, 7, in >> 8);
+
+        if(callbacks && callbacks->round_done) {
+            callbacks->round_done(callbacks->context, round);
+        }
+    }
+
+    free(expand);
+    free(search.odd);
+    free(search.even);
+
+    return !aborted;
+}
+
+size_t nested_recover_ram(uint32_t msb_limit) {
+    return sizeof(uint32_t) *
+           (NESTED_RECOVER_EXPAND_SIZE +
+            2 * msb_limit * (NESTED_RECOVER_TABLE_SIZE + NESTED_RECOVER_TABLE_HEADROOM));
+}
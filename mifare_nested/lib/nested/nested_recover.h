@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    // Polled during the search, return true to abort it
+    bool (*should_stop)(void* context);
+    // Called when round (0 to 256 / msb_limit - 1) is completed
+    void (*round_done)(void* context, uint32_t round);
+    // Called for every key that decrypts both nonces, return true to end the search
+    bool (*key_found)(void* context, uint64_t key);
+    void* context;
+} NestedRecoverCallbacks;
+
+// Recover the key behind two nested nonces of the same sector and key type.
+// nt is the plain tag nonce and ks the keystream it was encrypted with.
+// The odd/even tables are rebuilt for msb_limit msb values (power of two) per
+// round, a bigger limit is faster but needs more RAM.
+// Returns false if the search was aborted or ran out of table space.
+bool nested_recover_key(
+    uint32_t cuid,
+    const uint32_t nt[2],
+    const uint32_t ks[2],
+    uint32_t msb_limit,
+    const NestedRecoverCallbacks* callbacks);
+
+// Heap needed by nested_recover_key() to search msb_limit msb values per round
+size_t nested_recover_ram(uint32_t msb_limit);
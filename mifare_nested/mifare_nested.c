@@ -1,4 +1,5 @@
 #include "mifare_nested_i.h"
+#include "profile.h"
 #include <gui/elements.h>
 
 bool mifare_nested_custom_event_callback(void* context, uint32_t event) {
@@ -162,6 +163,30 @@ static void check_keys_draw_callback(Canvas* canvas, void* model) {
         canvas_set_font(canvas, FontSecondary);
         elements_multiline_text_aligned(
             canvas, 64, 23, AlignCenter, AlignTop, "Checking which keys you\nalready have...");
+    } else if(m->recovering_keys) {
+        char draw_str[32] = {};
+        canvas_set_font(canvas, FontPrimary);
+        canvas_draw_str_aligned(canvas, 64, 2, AlignCenter, AlignTop, "Recovering keys");
+        canvas_set_font(canvas, FontSecondary);
+
+        float progress = 0;
+        if(m->nonces_count != 0 && m->recovery_rounds != 0) {
+            progress = ((float)(m->nonces_checked) +
+                        (float)(m->recovery_round) / (float)(m->recovery_rounds)) /
+                       (float)(m->nonces_count);
+        }
+
+        if(progress > 1.0) {
+            progress = 1.0;
+        }
+
+        elements_progress_bar(canvas, 5, 15, 120, progress);
+        snprintf(
+            draw_str, sizeof(draw_str), "Nonces: %lu/%lu", m->nonces_checked, m->nonces_count);
+        canvas_draw_str_aligned(canvas, 1, 28, AlignLeft, AlignTop, draw_str);
+        snprintf(
+            draw_str, sizeof(draw_str), "Round: %lu/%lu", m->recovery_round, m->recovery_rounds);
+        canvas_draw_str_aligned(canvas, 1, 40, AlignLeft, AlignTop, draw_str);
     } else {
         char draw_str[32] = {};
         char draw_sub_str[32] = {};
@@ -397,12 +422,14 @@ int32_t mifare_nested_app(void* p) {
     UNUSED(p);
 
     MifareNested* mifare_nested = mifare_nested_alloc();
+    profile_start(); // "profile" CLI command in debug builds
 
     scene_manager_next_scene(mifare_nested->scene_manager, MifareNestedSceneStart);
 
     view_dispatcher_run(mifare_nested->view_dispatcher);
 
     mifare_nested_free(mifare_nested);
+    profile_stop();
 
     return 0;
 }
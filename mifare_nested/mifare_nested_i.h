@@ -134,8 +134,13 @@ typedef struct {
     uint32_t keys_checked;
     uint32_t keys_found;
     uint32_t keys_total;
+    uint32_t nonces_count;
+    uint32_t nonces_checked;
+    uint32_t recovery_round;
+    uint32_t recovery_rounds;
     bool lost_tag;
     bool processing_keys;
+    bool recovering_keys;
 } CheckKeysViewModel;
 
 static const NotificationSequence mifare_nested_sequence_blink_start_blue = {
@@ -1,18 +1,31 @@
 #include "mifare_nested_worker_i.h"
 
 #include "lib/nested/nested.h"
+#include "lib/nested/nested_recover.h"
+#include "lib/key_cache/key_cache.h"
 #include "lib/parity/parity.h"
+#include "profile.h"
 #include <lib/nfc/protocols/nfc_util.h>
 
 #include <storage/storage.h>
 #include <stream/stream.h>
 #include <stream/file_stream.h>
 #include "string.h"
+#include <stdio.h>
 #include <furi.h>
 #include <furi_hal.h>
 
 #define TAG "MifareNestedWorker"
 
+// Heap left to the rest of the app while keys are recovered
+#define NESTED_RECOVER_RAM_RESERVE 8192
+
+// Hard nested nonces queued between the NFC loop and the writer thread
+#define NESTED_HARD_NONCE_QUEUE_SIZE 64
+// Rows written to the nonces file at once
+#define NESTED_HARD_NONCE_BATCH 32
+#define NESTED_HARD_NONCE_FLUSH_MS 100
+
 // possible sum property values
 static uint16_t sums[] =
     {0, 32, 56, 64, 80, 96, 104, 112, 120, 128, 136, 144, 152, 160, 176, 192, 200, 224, 256};
@@ -86,6 +99,7 @@ int32_t mifare_nested_worker_task(void* context) {
     }
 
     mifare_nested_worker_change_state(mifare_nested_worker, MifareNestedWorkerStateReady);
+    profile_thread_exit("worker");
 
     return 0;
 }
@@ -219,6 +233,12 @@ bool mifare_nested_worker_read_key_cache(FuriHalNfcDevData* data, MfClassicData*
         load_success = key_read_success;
     } while(false);
 
+    if(!load_success) {
+        // Keys of the index may still be tried, don't keep a half read file
+        mf_data->key_a_mask = 0;
+        mf_data->key_b_mask = 0;
+    }
+
     furi_string_free(temp_str);
     flipper_format_free(file);
 
@@ -315,12 +335,7 @@ uint32_t mifare_nested_worker_predict_delay(
         mifare_classic_authex(crypto, tx_rx, cuid, blockNo, keyType, ui64Key, true, &nt2);
 
         // Searching for delay, where PRNG will be near 800
-        uint32_t nttmp = prng_successor(nt1, 100);
-
-        for(i = 101; i < 65565; i++) {
-            nttmp = prng_successor(nttmp, 1);
-            if(nttmp == nt2) break;
-        }
+        i = MIN(nested_prng_distance(nt1, nt2, 101), 65565);
 
         if(!rtr) {
             zero_prng_value = i;
@@ -380,12 +395,7 @@ uint32_t mifare_nested_worker_predict_delay(
             mifare_classic_authex(crypto, tx_rx, cuid, blockNo, keyType, ui64Key, true, &nt2);
 
             // Searching for delay, where PRNG will be near 800
-            uint32_t nttmp = prng_successor(nt1, 0);
-
-            for(i = 1; i < 65565; i++) {
-                nttmp = prng_successor(nttmp, 1);
-                if(nttmp == nt2) break;
-            }
+            i = MIN(nested_prng_distance(nt1, nt2, 1), 65565);
 
             if(!(i > previous - 50 && i < previous + 50) && rtz) {
                 repeat++;
@@ -559,8 +569,81 @@ SaveNoncesResult_t* mifare_nested_worker_write_nonces(
     return result;
 }
 
+uint32_t mifare_nested_worker_get_cuid(FuriHalNfcDevData* data) {
+    // Last 4 bytes of the UID, as for the crypto1 auth
+    return nfc_util_bytes2num(data->uid + data->uid_len - 4, 4);
+}
+
+// Look up the key index for the sectors the NFC app key cache has no key for,
+// the keys that opened a sector most often are tried first
+static void mifare_nested_worker_check_indexed_keys(
+    FuriHalNfcDevData* data,
+    MfClassicData* mf_data,
+    uint8_t sector_count) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    uint32_t cuid = mifare_nested_worker_get_cuid(data);
+    size_t count = 0;
+    KeyCacheRecord* records = key_cache_find(storage, cuid, &count);
+    size_t* order = malloc(sizeof(size_t) * (count + 1));
+    FuriHalNfcTxRxContext tx_rx = {};
+
+    for(uint8_t sector = 0; sector < sector_count && records; sector++) {
+        MfClassicSectorTrailer* trailer =
+            mifare_nested_worker_get_sector_trailer_by_sector(mf_data, sector);
+
+        for(uint8_t key_type = 0; key_type < 2; key_type++) {
+            uint64_t* mask = !key_type ? &mf_data->key_a_mask : &mf_data->key_b_mask;
+            size_t candidates = 0;
+
+            if(FURI_BIT(*mask, sector)) continue;
+
+            for(size_t i = 0; i < count; i++) {
+                uint8_t hits = records[i].hits[sector][key_type];
+
+                if(!hits) continue;
+
+                size_t j = candidates++;
+
+                for(; j > 0 && records[order[j - 1]].hits[sector][key_type] < hits; j--) {
+                    order[j] = order[j - 1];
+                }
+
+                order[j] = i;
+            }
+
+            for(size_t i = 0; i < candidates; i++) {
+                uint64_t key = records[order[i]].key;
+
+                if(nested_check_key(
+                       &tx_rx, mifare_nested_worker_get_block_by_sector(sector), key_type, key) !=
+                   NestedCheckKeyValid) {
+                    continue;
+                }
+
+                FURI_LOG_I(
+                    TAG,
+                    "Indexed %c key for sector %u: %012llX",
+                    !key_type ? 'A' : 'B',
+                    sector,
+                    key);
+
+                nfc_util_num2bytes(key, 6, !key_type ? trailer->key_a : trailer->key_b);
+                *mask |= (uint64_t)1 << sector;
+                key_cache_add(storage, cuid, key, sector, key_type);
+
+                break;
+            }
+        }
+    }
+
+    free(order);
+    free(records);
+    furi_record_close(RECORD_STORAGE);
+}
+
 bool mifare_nested_worker_check_initial_keys(
     NonceList_t* nonces,
+    FuriHalNfcDevData* data,
     MfClassicData* mf_data,
     uint8_t tries_count,
     uint8_t sector_count,
@@ -570,6 +653,8 @@ bool mifare_nested_worker_check_initial_keys(
     bool has_a_key, has_b_key;
     FuriHalNfcTxRxContext tx_rx = {};
 
+    mifare_nested_worker_check_indexed_keys(data, mf_data, sector_count);
+
     for(uint8_t sector = 0; sector < sector_count; sector++) {
         for(uint8_t key_type = 0; key_type < 2; key_type++) {
             for(uint8_t tries = 0; tries < tries_count; tries++) {
@@ -735,9 +820,11 @@ void mifare_nested_worker_collect_nonces_static(MifareNestedWorker* mifare_neste
     storage_common_mkdir(storage, furi_string_get_cstr(folder_path));
     furi_string_free(folder_path);
 
-    if(!mifare_nested_worker_read_key_cache(&data, mf_data) ||
-       !mifare_nested_worker_check_initial_keys(
-           &nonces, mf_data, 1, sector_count, &key, &key_block, &found_key_type)) {
+    // Sectors missing from the NFC app key cache may still be in the key index
+    mifare_nested_worker_read_key_cache(&data, mf_data);
+
+    if(!mifare_nested_worker_check_initial_keys(
+           &nonces, &data, mf_data, 1, sector_count, &key, &key_block, &found_key_type)) {
         mifare_nested_worker->callback(
             MifareNestedWorkerEventNeedKey, mifare_nested_worker->context);
         nfc_deactivate();
@@ -863,6 +950,86 @@ void mifare_nested_worker_collect_nonces_static(MifareNestedWorker* mifare_neste
     nfc_deactivate();
 }
 
+// Hard nested nonces are written by a second thread, so the NFC loop doesn't wait for storage
+typedef struct {
+    FuriThread* thread;
+    FuriMessageQueue* queue;
+    Stream* file_stream;
+} MifareNestedNonceWriter;
+
+static int32_t mifare_nested_worker_nonce_writer_task(void* context) {
+    MifareNestedNonceWriter* writer = context;
+    FuriString* rows = furi_string_alloc();
+    struct nonce_hard nonce;
+    uint32_t count = 0;
+
+    while(true) {
+        // Write what is left as soon as the NFC loop pauses
+        if(furi_message_queue_get(
+               writer->queue, &nonce, count ? NESTED_HARD_NONCE_FLUSH_MS : FuriWaitForever) !=
+           FuriStatusOk) {
+            stream_write_string(writer->file_stream, rows);
+            furi_string_reset(rows);
+            count = 0;
+            continue;
+        }
+
+        if(nonce.last) {
+            break;
+        }
+
+        furi_string_cat_printf(rows, "%lu|%u\n", nonce.nt, nonce.parity);
+
+        if(++count == NESTED_HARD_NONCE_BATCH) {
+            stream_write_string(writer->file_stream, rows);
+            furi_string_reset(rows);
+            count = 0;
+        }
+    }
+
+    if(count) {
+        stream_write_string(writer->file_stream, rows);
+    }
+
+    furi_string_free(rows);
+    profile_thread_exit("nonce_writer");
+
+    return 0;
+}
+
+static MifareNestedNonceWriter* mifare_nested_worker_nonce_writer_alloc() {
+    MifareNestedNonceWriter* writer = malloc(sizeof(MifareNestedNonceWriter));
+
+    writer->queue =
+        furi_message_queue_alloc(NESTED_HARD_NONCE_QUEUE_SIZE, sizeof(struct nonce_hard));
+    writer->thread = furi_thread_alloc_ex(
+        "MifareNestedNonceWriter", 2048, mifare_nested_worker_nonce_writer_task, writer);
+    writer->file_stream = NULL;
+
+    return writer;
+}
+
+static void mifare_nested_worker_nonce_writer_free(MifareNestedNonceWriter* writer) {
+    furi_thread_free(writer->thread);
+    furi_message_queue_free(writer->queue);
+    free(writer);
+}
+
+static void
+    mifare_nested_worker_nonce_writer_start(MifareNestedNonceWriter* writer, Stream* file_stream) {
+    writer->file_stream = file_stream;
+    furi_message_queue_reset(writer->queue);
+    furi_thread_start(writer->thread);
+}
+
+// Waits until every queued nonce is written
+static void mifare_nested_worker_nonce_writer_stop(MifareNestedNonceWriter* writer) {
+    struct nonce_hard nonce = {.last = true};
+
+    furi_message_queue_put(writer->queue, &nonce, FuriWaitForever);
+    furi_thread_join(writer->thread);
+}
+
 void mifare_nested_worker_collect_nonces_hard(MifareNestedWorker* mifare_nested_worker) {
     NonceList_t nonces;
     Storage* storage = furi_record_open(RECORD_STORAGE);
@@ -902,9 +1069,11 @@ void mifare_nested_worker_collect_nonces_hard(MifareNestedWorker* mifare_nested_
     storage_common_mkdir(storage, furi_string_get_cstr(folder_path));
     furi_string_free(folder_path);
 
-    if(!mifare_nested_worker_read_key_cache(&data, mf_data) ||
-       !mifare_nested_worker_check_initial_keys(
-           &nonces, mf_data, 1, sector_count, &key, &key_block, &found_key_type)) {
+    // Sectors missing from the NFC app key cache may still be in the key index
+    mifare_nested_worker_read_key_cache(&data, mf_data);
+
+    if(!mifare_nested_worker_check_initial_keys(
+           &nonces, &data, mf_data, 1, sector_count, &key, &key_block, &found_key_type)) {
         mifare_nested_worker->callback(
             MifareNestedWorkerEventNeedKey, mifare_nested_worker->context);
         nfc_deactivate();
@@ -919,6 +1088,7 @@ void mifare_nested_worker_collect_nonces_hard(MifareNestedWorker* mifare_nested_
         TAG, "Using %c key for block %lu: %012llX", !found_key_type ? 'A' : 'B', key_block, key);
 
     FuriHalNfcTxRxContext tx_rx = {};
+    MifareNestedNonceWriter* writer = mifare_nested_worker_nonce_writer_alloc();
     nonces.tries = 1;
     nonces.hardnested_states = 0;
     nonces.sector_count = sector_count;
@@ -1000,6 +1170,8 @@ void mifare_nested_worker_collect_nonces_hard(MifareNestedWorker* mifare_nested_
                 stream_write_string(file_stream, header);
                 furi_string_free(header);
 
+                mifare_nested_worker_nonce_writer_start(writer, file_stream);
+
                 uint32_t first_byte_sum = 0;
                 uint32_t* found = malloc(sizeof(uint32_t) * 256);
                 for(uint32_t i = 0; i < 256; i++) {
@@ -1016,9 +1188,11 @@ void mifare_nested_worker_collect_nonces_hard(MifareNestedWorker* mifare_nested_
                         key,
                         found,
                         &first_byte_sum,
-                        file_stream);
+                        writer->queue);
 
                     if(result.static_encrypted) {
+                        mifare_nested_worker_nonce_writer_stop(writer);
+                        mifare_nested_worker_nonce_writer_free(writer);
                         file_stream_close(file_stream);
 
                         storage_simply_remove(storage, furi_string_get_cstr(hardnested_file));
@@ -1087,6 +1261,8 @@ void mifare_nested_worker_collect_nonces_hard(MifareNestedWorker* mifare_nested_
                     }
                 }
 
+                mifare_nested_worker_nonce_writer_stop(writer);
+
                 free(found);
                 furi_string_free(hardnested_file);
                 file_stream_close(file_stream);
@@ -1094,6 +1270,8 @@ void mifare_nested_worker_collect_nonces_hard(MifareNestedWorker* mifare_nested_
         }
     }
 
+    mifare_nested_worker_nonce_writer_free(writer);
+
     SaveNoncesResult_t* result =
         mifare_nested_worker_write_nonces(&data, storage, &nonces, 1, 1, sector_count, 0, 0);
 
@@ -1150,9 +1328,11 @@ void mifare_nested_worker_collect_nonces(MifareNestedWorker* mifare_nested_worke
     storage_common_mkdir(storage, furi_string_get_cstr(folder_path));
     furi_string_free(folder_path);
 
-    if(!mifare_nested_worker_read_key_cache(&data, mf_data) ||
-       !mifare_nested_worker_check_initial_keys(
-           &nonces, mf_data, 3, sector_count, &key, &key_block, &found_key_type)) {
+    // Sectors missing from the NFC app key cache may still be in the key index
+    mifare_nested_worker_read_key_cache(&data, mf_data);
+
+    if(!mifare_nested_worker_check_initial_keys(
+           &nonces, &data, mf_data, 3, sector_count, &key, &key_block, &found_key_type)) {
         mifare_nested_worker->callback(
             MifareNestedWorkerEventNeedKey, mifare_nested_worker->context);
         nfc_deactivate();
@@ -1486,6 +1666,378 @@ void mifare_nested_worker_write_key(Storage* storage, FuriString* key) {
     file_stream_close(file_stream);
 }
 
+typedef struct {
+    MifareNestedWorker* mifare_nested_worker;
+    Stream* file_stream;
+    uint32_t key_type;
+    uint32_t sector;
+    bool found;
+} MifareNestedRecoverContext;
+
+static bool mifare_nested_worker_recover_should_stop(void* context) {
+    MifareNestedRecoverContext* recover = context;
+
+    return recover->mifare_nested_worker->state != MifareNestedWorkerStateValidating;
+}
+
+static void mifare_nested_worker_recover_round_done(void* context, uint32_t round) {
+    MifareNestedRecoverContext* recover = context;
+    MifareNestedWorker* mifare_nested_worker = recover->mifare_nested_worker;
+
+    mifare_nested_worker->context->keys->recovery_round = round + 1;
+    mifare_nested_worker->callback(
+        MifareNestedWorkerEventRecoveringKeys, mifare_nested_worker->context);
+}
+
+static bool mifare_nested_worker_recover_key_found(void* context, uint64_t key) {
+    MifareNestedRecoverContext* recover = context;
+    uint8_t key_bytes[6];
+
+    nfc_util_num2bytes(key, 6, key_bytes);
+
+    // Same format as the desktop app, mifare_nested_worker_check_keys() validates it on the tag
+    FuriString* str = furi_string_alloc_printf(
+        "Key %c sector %02lu: %02X %02X %02X %02X %02X %02X\n",
+        !recover->key_type ? 'A' : 'B',
+        recover->sector,
+        key_bytes[0],
+        key_bytes[1],
+        key_bytes[2],
+        key_bytes[3],
+        key_bytes[4],
+        key_bytes[5]);
+
+    stream_write_string(recover->file_stream, str);
+    furi_string_free(str);
+
+    FURI_LOG_I(
+        TAG,
+        "Recovered %c key for sector %lu: %012llX",
+        !recover->key_type ? 'A' : 'B',
+        recover->sector,
+        key);
+
+    recover->found = true;
+
+    return true;
+}
+
+static uint32_t mifare_nested_worker_recover_msb_limit() {
+    size_t free_heap = memmgr_get_free_heap();
+    size_t max_block = memmgr_heap_get_max_free_block();
+    uint32_t msb_limit = 256;
+
+    // Both tables are single allocations of half the needed RAM
+    while(msb_limit > 1 &&
+          (nested_recover_ram(msb_limit) + NESTED_RECOVER_RAM_RESERVE > free_heap ||
+           nested_recover_ram(msb_limit) / 2 > max_block)) {
+        msb_limit /= 2;
+    }
+
+    FURI_LOG_I(
+        TAG,
+        "Heap %zu (block %zu): %lu msb per round, %lu rounds",
+        free_heap,
+        max_block,
+        msb_limit,
+        256 / msb_limit);
+
+    return msb_limit;
+}
+
+// Nested: Key A cuid 0x.. nt0 0x.. ks0 0x.. par0 XXXX nt1 0x.. ks1 0x.. par1 XXXX sec N
+static bool mifare_nested_worker_parse_nonce(
+    FuriString* line,
+    uint32_t* key_type,
+    uint32_t* cuid,
+    uint32_t* nt,
+    uint32_t* ks,
+    uint8_t parity[2][4],
+    uint32_t* sector) {
+    char key_char = 0;
+    char par[2][5] = {};
+
+    if(sscanf(
+           furi_string_get_cstr(line),
+           "Nested: Key %c cuid 0x%lx nt0 0x%lx ks0 0x%lx par0 %4s nt1 0x%lx ks1 0x%lx par1 %4s sec %lu",
+           &key_char,
+           cuid,
+           &nt[0],
+           &ks[0],
+           par[0],
+           &nt[1],
+           &ks[1],
+           par[1],
+           sector) != 9) {
+        return false;
+    }
+
+    for(uint8_t type = 0; type < 2; type++) {
+        for(uint8_t i = 0; i < 4; i++) {
+            parity[type][i] = par[type][i] == '1';
+        }
+    }
+
+    *key_type = key_char == 'B';
+
+    return *sector < 40;
+}
+
+// Recover the keys of the Nested nonces on the device and write them to the .keys
+// file, as the desktop app would. HardNested nonces still need the desktop app.
+// Returns true if at least one key was written
+bool mifare_nested_worker_recover_keys(
+    MifareNestedWorker* mifare_nested_worker,
+    Storage* storage,
+    FuriHalNfcDevData* data) {
+    KeyInfo_t* key_info = mifare_nested_worker->context->keys;
+    Stream* nonces_stream = file_stream_alloc(storage);
+    FuriString* next_line = furi_string_alloc();
+    FuriString* path = furi_string_alloc();
+    uint32_t delay = 0;
+    uint32_t distance = 0;
+    uint32_t nonce_count = 0;
+    bool recovered[2][40] = {};
+
+    mifare_nested_worker_get_nonces_file_path(data, path);
+
+    if(!file_stream_open(
+           nonces_stream, furi_string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING)) {
+        file_stream_close(nonces_stream);
+        free(nonces_stream);
+        furi_string_free(next_line);
+        furi_string_free(path);
+
+        return false;
+    }
+
+    // Delay is written after the nonces
+    while(stream_read_line(nonces_stream, next_line)) {
+        if(furi_string_start_with_str(next_line, "Nested: Key")) {
+            nonce_count++;
+        } else if(furi_string_start_with_str(next_line, "Nested: Delay")) {
+            sscanf(
+                furi_string_get_cstr(next_line),
+                "Nested: Delay %lu, distance %lu",
+                &delay,
+                &distance);
+        }
+    }
+
+    if(!nonce_count) {
+        file_stream_close(nonces_stream);
+        free(nonces_stream);
+        furi_string_free(next_line);
+        furi_string_free(path);
+
+        return false;
+    }
+
+    FURI_LOG_I(TAG, "Recovering keys from %lu nonces", nonce_count);
+
+    MifareNestedRecoverContext recover = {
+        .mifare_nested_worker = mifare_nested_worker,
+        .file_stream = file_stream_alloc(storage),
+        .found = false,
+    };
+    NestedRecoverCallbacks callbacks = {
+        .should_stop = mifare_nested_worker_recover_should_stop,
+        .round_done = mifare_nested_worker_recover_round_done,
+        .key_found = mifare_nested_worker_recover_key_found,
+        .context = &recover,
+    };
+    uint32_t msb_limit = mifare_nested_worker_recover_msb_limit();
+
+    mifare_nested_worker_get_found_keys_file_path(data, path);
+    file_stream_open(
+        recover.file_stream, furi_string_get_cstr(path), FSAM_WRITE, FSOM_CREATE_ALWAYS);
+
+    key_info->total_nonces = nonce_count;
+    key_info->checked_nonces = 0;
+    key_info->recovery_round = 0;
+    key_info->recovery_rounds = 256 / msb_limit;
+
+    mifare_nested_worker->callback(
+        MifareNestedWorkerEventRecoveringKeys, mifare_nested_worker->context);
+
+    stream_rewind(nonces_stream);
+
+    while(mifare_nested_worker->state == MifareNestedWorkerStateValidating) {
+        uint32_t cuid, nt[2], ks[2];
+        uint8_t parity[2][4];
+        bool valid = true;
+
+        if(!stream_read_line(nonces_stream, next_line)) {
+            break;
+        }
+
+        if(!furi_string_start_with_str(next_line, "Nested: Key")) {
+            continue;
+        }
+
+        if(!mifare_nested_worker_parse_nonce(
+               next_line, &recover.key_type, &cuid, nt, ks, parity, &recover.sector)) {
+            FURI_LOG_E(TAG, "Can't parse nonce: %s", furi_string_get_cstr(next_line));
+            valid = false;
+        } else if(recovered[recover.key_type][recover.sector]) {
+            // Already have a key from another try
+            valid = false;
+        } else if(delay) {
+            // Collected with a delay: nt holds the auth nonce and ks the encrypted one
+            for(uint8_t type = 0; type < 2 && valid; type++) {
+                uint32_t predicted[5];
+
+                if(nested_predict_nonces(nt[type], ks[type], distance, parity[type], predicted) !=
+                   1) {
+                    valid = false;
+                } else {
+                    ks[type] ^= predicted[0];
+                    nt[type] = predicted[0];
+                }
+            }
+        }
+
+        if(valid) {
+            key_info->recovery_round = 0;
+            mifare_nested_worker->callback(
+                MifareNestedWorkerEventRecoveringKeys, mifare_nested_worker->context);
+
+            recover.found = false;
+            nested_recover_key(cuid, nt, ks, msb_limit, &callbacks);
+            recovered[recover.key_type][recover.sector] = recover.found;
+        }
+
+        key_info->checked_nonces++;
+    }
+
+    bool found = false;
+    for(uint8_t key_type = 0; key_type < 2; key_type++) {
+        for(uint8_t sector = 0; sector < 40; sector++) {
+            found |= recovered[key_type][sector];
+        }
+    }
+
+    file_stream_close(recover.file_stream);
+    free(recover.file_stream);
+    file_stream_close(nonces_stream);
+    free(nonces_stream);
+
+    if(!found || mifare_nested_worker->state != MifareNestedWorkerStateValidating) {
+        storage_simply_remove(storage, furi_string_get_cstr(path));
+        found = false;
+    }
+
+    furi_string_free(next_line);
+    furi_string_free(path);
+
+    return found;
+}
+
+typedef struct {
+    uint64_t* keys;
+    uint8_t* scores;
+    uint32_t count;
+    uint32_t size;
+} MifareNestedKeyCandidates;
+
+// Key X sector XX: XX XX XX XX XX XX
+static bool mifare_nested_worker_parse_key_line(
+    FuriString* line,
+    uint8_t* key_type,
+    uint8_t* sector,
+    uint64_t* key) {
+    char type;
+    unsigned int sector_value;
+    unsigned int bytes[6];
+
+    if(sscanf(
+           furi_string_get_cstr(line),
+           "Key %c sector %u: %x %x %x %x %x %x",
+           &type,
+           &sector_value,
+           &bytes[0],
+           &bytes[1],
+           &bytes[2],
+           &bytes[3],
+           &bytes[4],
+           &bytes[5]) != 8 ||
+       (type != 'A' && type != 'B') || sector_value >= 40) {
+        return false;
+    }
+
+    *key_type = type == 'B';
+    *sector = sector_value;
+    *key = 0;
+
+    for(uint8_t i = 0; i < 6; i++) {
+        *key = (*key << 8) | (bytes[i] & 0xFF);
+    }
+
+    return true;
+}
+
+// Returns false if the key already is a candidate
+static bool mifare_nested_worker_add_candidate(MifareNestedKeyCandidates* candidates, uint64_t key) {
+    for(uint32_t i = 0; i < candidates->count; i++) {
+        if(candidates->keys[i] == key) return false;
+    }
+
+    if(candidates->count == candidates->size) {
+        candidates->size += 8;
+        candidates->keys = realloc(candidates->keys, candidates->size * sizeof(uint64_t));
+        candidates->scores = realloc(candidates->scores, candidates->size);
+    }
+
+    candidates->keys[candidates->count] = key;
+    candidates->scores[candidates->count] = 0;
+    candidates->count++;
+
+    return true;
+}
+
+// Try the candidates that decrypt the captured nonce first. Stable, so keys that
+// score the same keep the order of the .keys file
+static void mifare_nested_worker_rank_candidates(
+    MifareNestedKeyCandidates* candidates,
+    const struct nonce_encrypted* nonce) {
+    for(uint32_t i = 0; i < candidates->count; i++) {
+        uint64_t key = candidates->keys[i];
+        uint8_t score = nested_key_fits_nonce(nonce, key);
+        uint32_t j = i;
+
+        for(; j > 0 && candidates->scores[j - 1] < score; j--) {
+            candidates->keys[j] = candidates->keys[j - 1];
+            candidates->scores[j] = candidates->scores[j - 1];
+        }
+
+        candidates->keys[j] = key;
+        candidates->scores[j] = score;
+    }
+}
+
+static NestedCheckKeyResult mifare_nested_worker_check_key(
+    MifareNestedWorker* mifare_nested_worker,
+    FuriHalNfcTxRxContext* tx_rx,
+    uint8_t sector,
+    uint8_t key_type,
+    uint64_t key) {
+    NestedCheckKeyResult result = NestedCheckKeyNoTag;
+
+    while(mifare_nested_worker->state == MifareNestedWorkerStateValidating) {
+        result = nested_check_key(
+            tx_rx, mifare_nested_worker_get_block_by_sector(sector), key_type, key);
+
+        if(result != NestedCheckKeyNoTag) break;
+
+        mifare_nested_worker->callback(
+            MifareNestedWorkerEventNoTagDetected, mifare_nested_worker->context);
+
+        furi_delay_ms(250);
+    }
+
+    return result;
+}
+
 void mifare_nested_worker_check_keys(MifareNestedWorker* mifare_nested_worker) {
     KeyInfo_t* key_info = mifare_nested_worker->context->keys;
     Storage* storage = furi_record_open(RECORD_STORAGE);
@@ -1495,14 +2047,13 @@ void mifare_nested_worker_check_keys(MifareNestedWorker* mifare_nested_worker) {
     FuriHalNfcDevData data = {};
     nested_get_data(&data);
     MfClassicType type = mifare_nested_worker_get_tag_type(data.atqa[0], data.atqa[1], data.sak);
-    NestedCheckKeyResult result = NestedCheckKeyNoTag;
     FuriHalNfcTxRxContext tx_rx = {};
     uint32_t key_count = 0;
     uint32_t sector_key_count = 0;
     uint64_t keys[80];
-    bool found_keys[2][40];
-    bool unique_keys[2][40];
+    MifareNestedKeyCandidates candidates[40][2] = {};
     uint32_t sector_count = 0;
+    uint32_t cuid = mifare_nested_worker_get_cuid(&data);
 
     if(type == MfClassicType4k) {
         sector_count = 40;
@@ -1517,33 +2068,41 @@ void mifare_nested_worker_check_keys(MifareNestedWorker* mifare_nested_worker) {
 
     uint32_t keys_count = sector_count * 2;
 
-    for(uint8_t key = 0; key < 2; key++) {
-        for(uint8_t i = 0; i < sector_count; i++) {
-            found_keys[key][i] = false;
-            unique_keys[key][i] = false;
-        }
-    }
-
     for(uint8_t i = 0; i < keys_count; i++) {
         keys[i] = -1;
     }
 
     mifare_nested_worker_get_found_keys_file_path(&data, path);
 
-    if(!file_stream_open(file_stream, furi_string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING)) {
+    bool opened =
+        file_stream_open(file_stream, furi_string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING);
+
+    if(!opened) {
         FURI_LOG_E(TAG, "Can't open %s", furi_string_get_cstr(path));
 
         file_stream_close(file_stream);
 
+        if(mifare_nested_worker_recover_keys(mifare_nested_worker, storage, &data)) {
+            opened = file_stream_open(
+                file_stream, furi_string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING);
+        }
+    }
+
+    if(!opened) {
+        file_stream_close(file_stream);
+
         mifare_nested_worker_get_nonces_file_path(&data, path);
 
-        if(!file_stream_open(
-               file_stream, furi_string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING)) {
-            mifare_nested_worker->callback(
-                MifareNestedWorkerEventNeedCollection, mifare_nested_worker->context);
-        } else {
-            mifare_nested_worker->callback(
-                MifareNestedWorkerEventNeedKeyRecovery, mifare_nested_worker->context);
+        // Nothing to report if the scene was left during key recovery
+        if(mifare_nested_worker->state == MifareNestedWorkerStateValidating) {
+            if(!file_stream_open(
+                   file_stream, furi_string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING)) {
+                mifare_nested_worker->callback(
+                    MifareNestedWorkerEventNeedCollection, mifare_nested_worker->context);
+            } else {
+                mifare_nested_worker->callback(
+                    MifareNestedWorkerEventNeedKeyRecovery, mifare_nested_worker->context);
+            }
         }
 
         file_stream_close(file_stream);
@@ -1556,100 +2115,110 @@ void mifare_nested_worker_check_keys(MifareNestedWorker* mifare_nested_worker) {
         return;
     };
 
-    while(true) {
-        if(!stream_read_line(file_stream, next_line)) {
-            break;
-        }
-
-        if(furi_string_start_with_str(next_line, "Key")) {
-            uint8_t key_type = furi_string_get_char(next_line, 4) == 'B';
-            uint8_t sector = atoi((char[]){furi_string_get_char(next_line, 13)}) * 10 +
-                             atoi((char[]){furi_string_get_char(next_line, 14)});
+    // Read the whole file once, every key is checked only once per sector and key type
+    while(stream_read_line(file_stream, next_line)) {
+        uint8_t key_type;
+        uint8_t sector;
+        uint64_t key;
 
-            if(!unique_keys[key_type][sector]) {
-                unique_keys[key_type][sector] = true;
-                sector_key_count++;
-            }
+        if(!mifare_nested_worker_parse_key_line(next_line, &key_type, &sector, &key) ||
+           sector >= sector_count) {
+            continue;
         }
 
-        key_count++;
-    }
+        if(candidates[sector][key_type].count == 0) sector_key_count++;
 
-    stream_rewind(file_stream);
+        if(mifare_nested_worker_add_candidate(&candidates[sector][key_type], key)) key_count++;
+    }
 
     key_info->total_keys = key_count;
     key_info->sector_keys = sector_key_count;
 
-    while(mifare_nested_worker->state == MifareNestedWorkerStateValidating) {
-        if(!stream_read_line(file_stream, next_line)) {
-            break;
-        }
+    // Known key for the nested auths, taken from the first sector solved
+    bool session_found = false;
+    uint8_t session_block = 0;
+    uint8_t session_key_type = 0;
+    uint64_t session_key = 0;
 
-        if(furi_string_start_with_str(next_line, "Key")) {
-            // Key X sector XX: XX XX XX XX XX XX
-            // 0000000000111111111122222222223333
-            // 0123456789012345678901234567890123
-            uint8_t keyChar[6];
-            uint8_t count = 0;
-
-            uint8_t key_type = furi_string_get_char(next_line, 4) == 'B';
-            uint8_t sector = atoi((char[]){furi_string_get_char(next_line, 13)}) * 10 +
-                             atoi((char[]){furi_string_get_char(next_line, 14)});
-
-            for(uint8_t i = 17; i < 33; i += 3) {
-                hex_char_to_uint8(
-                    furi_string_get_char(next_line, i),
-                    furi_string_get_char(next_line, i + 1),
-                    &keyChar[count]);
-                count++;
+    for(uint8_t sector = 0; sector < sector_count; sector++) {
+        for(uint8_t key_type = 0; key_type < 2; key_type++) {
+            MifareNestedKeyCandidates* sector_candidates = &candidates[sector][key_type];
+            uint8_t block = mifare_nested_worker_get_block_by_sector(sector);
+            uint32_t checked = 0;
+
+            if(mifare_nested_worker->state != MifareNestedWorkerStateValidating) break;
+
+            // A wrong key halts the card, so instead of one auth per candidate a
+            // single nested auth is captured and every candidate is tried on it
+            struct nonce_encrypted nonce;
+
+            if(session_found && sector_candidates->count > 1 &&
+               nested_capture_nonce(
+                   &tx_rx,
+                   session_block,
+                   session_key_type,
+                   session_key,
+                   block,
+                   key_type,
+                   &nonce)) {
+                mifare_nested_worker_rank_candidates(sector_candidates, &nonce);
             }
 
-            uint64_t key = nfc_util_bytes2num(keyChar, 6);
+            while(checked < sector_candidates->count) {
+                uint64_t key = sector_candidates->keys[checked];
 
-            key_info->checked_keys++;
+                NestedCheckKeyResult result = mifare_nested_worker_check_key(
+                    mifare_nested_worker, &tx_rx, sector, key_type, key);
 
-            if(found_keys[key_type][sector]) {
-                mifare_nested_worker->callback(
-                    MifareNestedWorkerEventKeyChecked, mifare_nested_worker->context);
+                if(result == NestedCheckKeyNoTag) break;
 
-                continue;
-            }
+                checked++;
+                key_info->checked_keys++;
 
-            while(mifare_nested_worker->state == MifareNestedWorkerStateValidating) {
-                result = nested_check_key(
-                    &tx_rx, mifare_nested_worker_get_block_by_sector(sector), key_type, key);
+                if(result == NestedCheckKeyValid) {
+                    FURI_LOG_I(
+                        TAG,
+                        "Found valid %c key for sector %u: %012llX",
+                        !key_type ? 'A' : 'B',
+                        sector,
+                        key);
+                    bool exists = false;
 
-                if(result == NestedCheckKeyNoTag) {
-                    mifare_nested_worker->callback(
-                        MifareNestedWorkerEventNoTagDetected, mifare_nested_worker->context);
+                    for(uint8_t i = 0; i < keys_count; i++) {
+                        if(keys[i] == key) {
+                            exists = true;
+                        }
+                    }
 
-                    furi_delay_ms(250);
-                } else {
-                    break;
-                }
-            }
+                    if(!exists) {
+                        keys[key_info->found_keys] = key;
+                    }
 
-            if(result == NestedCheckKeyValid) {
-                FURI_LOG_I(
-                    TAG, "Found valid %c key for sector %u: %012llX", key_type, sector, key);
-                bool exists = false;
+                    key_info->found_keys++;
+                    key_cache_add(storage, cuid, key, sector, key_type);
 
-                for(uint8_t i = 0; i < keys_count; i++) {
-                    if(keys[i] == key) {
-                        exists = true;
+                    if(!session_found) {
+                        session_found = true;
+                        session_block = block;
+                        session_key_type = key_type;
+                        session_key = key;
                     }
-                }
 
-                if(!exists) {
-                    keys[key_info->found_keys] = key;
+                    // The rest of this sector's candidates don't need checking
+                    key_info->checked_keys += sector_candidates->count - checked;
+                    checked = sector_candidates->count;
                 }
 
-                key_info->found_keys++;
-                found_keys[key_type][sector] = true;
+                mifare_nested_worker->callback(
+                    MifareNestedWorkerEventKeyChecked, mifare_nested_worker->context);
             }
+        }
+    }
 
-            mifare_nested_worker->callback(
-                MifareNestedWorkerEventKeyChecked, mifare_nested_worker->context);
+    for(uint8_t sector = 0; sector < sector_count; sector++) {
+        for(uint8_t key_type = 0; key_type < 2; key_type++) {
+            free(candidates[sector][key_type].keys);
+            free(candidates[sector][key_type].scores);
         }
     }
 
@@ -37,7 +37,8 @@ typedef enum {
     MifareNestedWorkerEventProcessingKeys,
     MifareNestedWorkerEventNeedKeyRecovery,
     MifareNestedWorkerEventNeedCollection,
-    MifareNestedWorkerEventHardnestedStatesFound
+    MifareNestedWorkerEventHardnestedStatesFound,
+    MifareNestedWorkerEventRecoveringKeys
 } MifareNestedWorkerEvent;
 
 typedef bool (*MifareNestedWorkerCallback)(MifareNestedWorkerEvent event, void* context);
@@ -88,6 +89,11 @@ typedef struct {
     uint32_t found_keys;
     uint32_t added_keys;
     uint32_t sector_keys;
+    // on-device recovery of the collected nonces
+    uint32_t total_nonces;
+    uint32_t checked_nonces;
+    uint32_t recovery_round;
+    uint32_t recovery_rounds;
     bool tag_lost;
 } KeyInfo_t;
 
@@ -24,6 +24,7 @@ bool mifare_nested_check_keys_worker_callback(MifareNestedWorkerEvent event, voi
             CheckKeysViewModel * model,
             {
                 model->lost_tag = false;
+                model->recovering_keys = false;
                 model->keys_checked = key_info->checked_keys;
                 model->keys_found = key_info->found_keys;
                 model->keys_total = key_info->sector_keys;
@@ -35,6 +36,20 @@ bool mifare_nested_check_keys_worker_callback(MifareNestedWorkerEvent event, voi
 
         with_view_model(
             plugin_state->view, CheckKeysViewModel * model, { model->lost_tag = true; }, true);
+    } else if(event == MifareNestedWorkerEventRecoveringKeys) {
+        KeyInfo_t* key_info = mifare_nested->keys;
+
+        with_view_model(
+            plugin_state->view,
+            CheckKeysViewModel * model,
+            {
+                model->recovering_keys = true;
+                model->nonces_count = key_info->total_nonces;
+                model->nonces_checked = key_info->checked_nonces;
+                model->recovery_round = key_info->recovery_round;
+                model->recovery_rounds = key_info->recovery_rounds;
+            },
+            true);
     } else if(event == MifareNestedWorkerEventProcessingKeys) {
         with_view_model(
             plugin_state->view,
@@ -67,6 +82,7 @@ void mifare_nested_scene_check_keys_on_enter(void* context) {
         {
             model->lost_tag = false;
             model->processing_keys = false;
+            model->recovering_keys = false;
             model->keys_count = 0;
             model->keys_checked = 0;
             model->keys_found = 0;
@@ -98,7 +114,8 @@ bool mifare_nested_scene_check_keys_on_event(void* context, SceneManagerEvent ev
         } else if(
             event.event == MifareNestedWorkerEventKeyChecked ||
             event.event == MifareNestedWorkerEventNoTagDetected ||
-            event.event == MifareNestedWorkerEventProcessingKeys) {
+            event.event == MifareNestedWorkerEventProcessingKeys ||
+            event.event == MifareNestedWorkerEventRecoveringKeys) {
             consumed = true;
         }
     }
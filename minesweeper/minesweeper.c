@@ -3,6 +3,7 @@
 #include <gui/gui.h>
 #include <input/input.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <notification/notification_messages.h>
 #include <dialogs/dialogs.h>
@@ -10,13 +11,21 @@
 #include <dolphin/dolphin.h>
 
 #include "assets.h"
+#include "profile.h"
 
 #define PLAYFIELD_WIDTH 16
 #define PLAYFIELD_HEIGHT 7
 #define TILE_WIDTH 8
 #define TILE_HEIGHT 8
 
+#define PLAYFIELD_CELLS (PLAYFIELD_WIDTH * PLAYFIELD_HEIGHT)
+#define CELL_INDEX(x, y) ((y) * PLAYFIELD_WIDTH + (x))
+#define CELL_X(cell) ((cell) % PLAYFIELD_WIDTH)
+#define CELL_Y(cell) ((cell) / PLAYFIELD_WIDTH)
+
 #define MINECOUNT 20
+// boards tried in no guessing mode before settling for one that needs a guess
+#define NO_GUESS_ATTEMPTS 200
 
 typedef enum {
     EventTypeTick,
@@ -57,9 +66,27 @@ typedef struct {
     int fields_cleared;
     int flags_set;
     bool game_started;
+    bool no_guess;
     uint32_t game_started_tick;
 } Minesweeper;
 
+// Cells of the playfield as a bit set, bit CELL_INDEX(x, y)
+typedef struct {
+    uint32_t bits[(PLAYFIELD_CELLS + 31) / 32];
+} CellSet;
+
+// "exactly `mines` of the uncleared `cells` around an opened number are mines"
+typedef struct {
+    CellSet cells;
+    int count;
+    int mines;
+} Constraint;
+
+typedef struct {
+    Minesweeper board;
+    Constraint constraints[PLAYFIELD_CELLS];
+} Solver;
+
 static void input_callback(InputEvent* input_event, FuriMessageQueue* event_queue) {
     furi_assert(event_queue);
 
@@ -91,6 +118,9 @@ static void render_callback(Canvas* const canvas, void* ctx) {
     }
     furi_string_printf(timeStr, "%01d:%02d", minutes, seconds);
     canvas_draw_str_aligned(canvas, 128, 0, AlignRight, AlignTop, furi_string_get_cstr(timeStr));
+    if(minesweeper_state->no_guess) {
+        canvas_draw_str_aligned(canvas, 64, 0, AlignCenter, AlignTop, "No guess");
+    }
 
     uint8_t* tile_to_draw;
 
@@ -160,30 +190,233 @@ static void render_callback(Canvas* const canvas, void* ctx) {
 }
 
 static void setup_playfield(Minesweeper* minesweeper_state) {
-    int mines_left = MINECOUNT;
     for(int y = 0; y < PLAYFIELD_HEIGHT; y++) {
         for(int x = 0; x < PLAYFIELD_WIDTH; x++) {
             minesweeper_state->minefield[x][y] = FieldEmpty;
             minesweeper_state->playfield[x][y] = TileTypeUncleared;
         }
     }
-    while(mines_left > 0) {
-        int rand_x = rand() % PLAYFIELD_WIDTH;
-        int rand_y = rand() % PLAYFIELD_HEIGHT;
-        // make sure first guess isn't a mine
-        if(minesweeper_state->minefield[rand_x][rand_y] == FieldEmpty &&
-           (minesweeper_state->cursor_x != rand_x || minesweeper_state->cursor_y != rand_y)) {
-            minesweeper_state->minefield[rand_x][rand_y] = FieldMine;
-            mines_left--;
-        }
-    }
     minesweeper_state->mines_left = MINECOUNT;
     minesweeper_state->fields_cleared = 0;
     minesweeper_state->flags_set = 0;
-    minesweeper_state->game_started_tick = furi_get_tick();
     minesweeper_state->game_started = false;
 }
 
+static bool is_near(int x1, int y1, int x2, int y2) {
+    return abs(x1 - x2) <= 1 && abs(y1 - y2) <= 1;
+}
+
+static int count_adjacent_mines(const Minesweeper* minesweeper_state, int cell_x, int cell_y) {
+    int hint = 0;
+    for(int y = cell_y - 1; y <= cell_y + 1; y++) {
+        for(int x = cell_x - 1; x <= cell_x + 1; x++) {
+            // make sure we don't go OOB
+            if(x >= 0 && x < PLAYFIELD_WIDTH && y >= 0 && y < PLAYFIELD_HEIGHT &&
+               minesweeper_state->minefield[x][y] == FieldMine) {
+                hint++;
+            }
+        }
+    }
+    return hint;
+}
+
+// Places the mines with a partial Fisher-Yates shuffle over every cell outside the 3x3
+// area around the first click, so the first click always opens a region
+static void place_mines(Minesweeper* minesweeper_state, int first_x, int first_y) {
+    uint8_t cells[PLAYFIELD_CELLS];
+    int count = 0;
+    for(int y = 0; y < PLAYFIELD_HEIGHT; y++) {
+        for(int x = 0; x < PLAYFIELD_WIDTH; x++) {
+            minesweeper_state->minefield[x][y] = FieldEmpty;
+            if(!is_near(x, y, first_x, first_y)) {
+                cells[count++] = CELL_INDEX(x, y);
+            }
+        }
+    }
+    for(int i = 0; i < MINECOUNT; i++) {
+        int j = i + rand() % (count - i);
+        uint8_t cell = cells[j];
+        cells[j] = cells[i];
+        cells[i] = cell;
+        minesweeper_state->minefield[CELL_X(cell)][CELL_Y(cell)] = FieldMine;
+    }
+}
+
+// Opens the cell, and every cell reachable from it through cells without adjacent mines.
+// Cells are marked as they are queued, so each one enters the queue at most once.
+static void clear_region(Minesweeper* minesweeper_state, int cell_x, int cell_y) {
+    uint8_t queue[PLAYFIELD_CELLS];
+    int head = 0;
+    int tail = 0;
+
+    minesweeper_state->playfield[cell_x][cell_y] =
+        count_adjacent_mines(minesweeper_state, cell_x, cell_y);
+    minesweeper_state->fields_cleared++;
+    queue[tail++] = CELL_INDEX(cell_x, cell_y);
+
+    while(head < tail) {
+        int cx = CELL_X(queue[head]);
+        int cy = CELL_Y(queue[head]);
+        head++;
+        if(minesweeper_state->playfield[cx][cy] != TileType0) continue;
+
+        // the field is "empty", auto open surrounding fields
+        for(int y = cy - 1; y <= cy + 1; y++) {
+            for(int x = cx - 1; x <= cx + 1; x++) {
+                if(x >= 0 && x < PLAYFIELD_WIDTH && y >= 0 && y < PLAYFIELD_HEIGHT &&
+                   minesweeper_state->playfield[x][y] == TileTypeUncleared) {
+                    // 〜(￣▽￣〜) don't judge me (〜￣▽￣)〜
+                    minesweeper_state->playfield[x][y] =
+                        count_adjacent_mines(minesweeper_state, x, y);
+                    minesweeper_state->fields_cleared++;
+                    queue[tail++] = CELL_INDEX(x, y);
+                }
+            }
+        }
+    }
+}
+
+static void cell_set_add(CellSet* set, int cell) {
+    set->bits[cell / 32] |= 1UL << (cell % 32);
+}
+
+static bool cell_set_has(const CellSet* set, int cell) {
+    return set->bits[cell / 32] & (1UL << (cell % 32));
+}
+
+static void constraint_build(const Minesweeper* board, int cell_x, int cell_y, Constraint* c) {
+    memset(c, 0, sizeof(Constraint));
+    c->mines = board->playfield[cell_x][cell_y];
+    for(int y = cell_y - 1; y <= cell_y + 1; y++) {
+        for(int x = cell_x - 1; x <= cell_x + 1; x++) {
+            if(x < 0 || x >= PLAYFIELD_WIDTH || y < 0 || y >= PLAYFIELD_HEIGHT) continue;
+            if(board->playfield[x][y] == TileTypeFlag) {
+                c->mines--;
+            } else if(board->playfield[x][y] == TileTypeUncleared) {
+                cell_set_add(&c->cells, CELL_INDEX(x, y));
+                c->count++;
+            }
+        }
+    }
+}
+
+// Opens (mine == false) or flags (mine == true) every still uncleared cell of the set,
+// returns true if anything changed
+static bool solver_apply(Minesweeper* board, const CellSet* set, bool mine) {
+    bool changed = false;
+    for(int cell = 0; cell < PLAYFIELD_CELLS; cell++) {
+        int x = CELL_X(cell);
+        int y = CELL_Y(cell);
+        if(!cell_set_has(set, cell) || board->playfield[x][y] != TileTypeUncleared) continue;
+        if(mine) {
+            board->playfield[x][y] = TileTypeFlag;
+            board->flags_set++;
+        } else {
+            clear_region(board, x, y);
+        }
+        changed = true;
+    }
+    return changed;
+}
+
+// One round of constraint propagation over every opened number: a number whose mines are
+// all flagged clears the rest, a number with as many uncleared cells as missing mines flags
+// them, and when one number's cells are a subset of a neighbour's the difference is solved
+// the same way. Deductions stay valid as the board changes, so they are applied at once.
+static bool solver_step(Solver* solver) {
+    Minesweeper* board = &solver->board;
+    bool progress = false;
+
+    for(int cell = 0; cell < PLAYFIELD_CELLS; cell++) {
+        int x = CELL_X(cell);
+        int y = CELL_Y(cell);
+        Constraint* c = &solver->constraints[cell];
+        c->count = 0;
+        if(board->playfield[x][y] >= TileType1 && board->playfield[x][y] <= TileType8) {
+            constraint_build(board, x, y, c);
+        }
+    }
+
+    for(int a = 0; a < PLAYFIELD_CELLS; a++) {
+        const Constraint* ca = &solver->constraints[a];
+        if(!ca->count) continue;
+        if(ca->mines == 0 || ca->mines == ca->count) {
+            progress |= solver_apply(board, &ca->cells, ca->mines != 0);
+            continue;
+        }
+        // neighbours sharing cells with `a` are at most two cells away
+        for(int y = CELL_Y(a) - 2; y <= CELL_Y(a) + 2; y++) {
+            for(int x = CELL_X(a) - 2; x <= CELL_X(a) + 2; x++) {
+                if(x < 0 || x >= PLAYFIELD_WIDTH || y < 0 || y >= PLAYFIELD_HEIGHT) continue;
+                const Constraint* cb = &solver->constraints[CELL_INDEX(x, y)];
+                if(cb == ca || cb->count <= ca->count) continue;
+
+                CellSet diff;
+                bool subset = true;
+                for(size_t i = 0; i < COUNT_OF(diff.bits); i++) {
+                    subset &= !(ca->cells.bits[i] & ~cb->cells.bits[i]);
+                    diff.bits[i] = cb->cells.bits[i] & ~ca->cells.bits[i];
+                }
+                if(!subset) continue;
+                int diff_mines = cb->mines - ca->mines;
+                if(diff_mines == 0 || diff_mines == cb->count - ca->count) {
+                    progress |= solver_apply(board, &diff, diff_mines != 0);
+                }
+            }
+        }
+    }
+
+    if(!progress) {
+        // the mine counter: all remaining mines found, or all remaining cells are mines
+        CellSet unknown = {0};
+        int unknown_count = 0;
+        for(int cell = 0; cell < PLAYFIELD_CELLS; cell++) {
+            if(board->playfield[CELL_X(cell)][CELL_Y(cell)] == TileTypeUncleared) {
+                cell_set_add(&unknown, cell);
+                unknown_count++;
+            }
+        }
+        int mines = MINECOUNT - board->flags_set;
+        if(mines == 0 || mines == unknown_count) {
+            progress = solver_apply(board, &unknown, mines != 0);
+        }
+    }
+    return progress;
+}
+
+// Plays the board from the first click using only deductions, true if that clears it
+static bool board_is_solvable(
+    const Minesweeper* minesweeper_state,
+    Solver* solver,
+    int first_x,
+    int first_y) {
+    Minesweeper* board = &solver->board;
+    setup_playfield(board);
+    memcpy(board->minefield, minesweeper_state->minefield, sizeof(board->minefield));
+
+    clear_region(board, first_x, first_y);
+    while(board->fields_cleared < PLAYFIELD_CELLS - MINECOUNT && solver_step(solver)) {
+    }
+    return board->fields_cleared == PLAYFIELD_CELLS - MINECOUNT;
+}
+
+static void generate_minefield(Minesweeper* minesweeper_state, int first_x, int first_y) {
+    place_mines(minesweeper_state, first_x, first_y);
+    if(!minesweeper_state->no_guess) return;
+
+    Solver* solver = malloc(sizeof(Solver));
+    int attempt = 1;
+    while(!board_is_solvable(minesweeper_state, solver, first_x, first_y)) {
+        if(attempt++ == NO_GUESS_ATTEMPTS) {
+            FURI_LOG_W("Minesweeper", "No board without guessing found");
+            break;
+        }
+        place_mines(minesweeper_state, first_x, first_y);
+    }
+    free(solver);
+    FURI_LOG_D("Minesweeper", "Board generated in %d attempts", attempt);
+}
+
 static void place_flag(Minesweeper* minesweeper_state) {
     if(minesweeper_state->playfield[minesweeper_state->cursor_x][minesweeper_state->cursor_y] ==
        TileTypeUncleared) {
@@ -258,102 +491,56 @@ static bool play_move(Minesweeper* minesweeper_state, int cursor_x, int cursor_y
         minesweeper_state->playfield[cursor_x][cursor_y] = TileTypeMine;
         return false;
     }
-
-    if(minesweeper_state->playfield[cursor_x][cursor_y] >= TileType1 &&
-       minesweeper_state->playfield[cursor_x][cursor_y] <= TileType8) {
-        // click on a cleared cell with a number
-        // count the flags around
-        int flags = 0;
-        for(int y = cursor_y - 1; y <= cursor_y + 1; y++) {
-            for(int x = cursor_x - 1; x <= cursor_x + 1; x++) {
-                if(x == cursor_x && y == cursor_y) {
-                    // we're on the cell the user selected, so ignore.
-                    continue;
-                }
-                // make sure we don't go OOB
-                if(x >= 0 && x < PLAYFIELD_WIDTH && y >= 0 && y < PLAYFIELD_HEIGHT) {
-                    if(minesweeper_state->playfield[x][y] == TileTypeFlag) {
-                        flags++;
-                    }
-                }
-            }
-        }
-        int mines = minesweeper_state->playfield[cursor_x][cursor_y]; // ¯\_(ツ)_/¯
-        if(flags == mines) {
-            // auto uncover all non-flags around (to win faster ;)
-            for(int auto_y = cursor_y - 1; auto_y <= cursor_y + 1; auto_y++) {
-                for(int auto_x = cursor_x - 1; auto_x <= cursor_x + 1; auto_x++) {
-                    if(auto_x == cursor_x && auto_y == cursor_y) {
-                        continue;
-                    }
-                    if(auto_x >= 0 && auto_x < PLAYFIELD_WIDTH && auto_y >= 0 &&
-                       auto_y < PLAYFIELD_HEIGHT) {
-                        if(minesweeper_state->playfield[auto_x][auto_y] == TileTypeUncleared) {
-                            if(!play_move(minesweeper_state, auto_x, auto_y)) {
-                                // flags were wrong, we got a mine!
-                                return false;
-                            }
-                        }
-                    }
-                }
-            }
-            // we're done without hitting a mine - so return
-            return true;
-        }
+    if(minesweeper_state->playfield[cursor_x][cursor_y] == TileTypeUncleared) {
+        clear_region(minesweeper_state, cursor_x, cursor_y);
+        return true;
     }
 
-    // calculate number of surrounding mines.
-    int hint = 0;
+    // click on a cleared cell with a number
+    // count the flags around
+    int flags = 0;
     for(int y = cursor_y - 1; y <= cursor_y + 1; y++) {
         for(int x = cursor_x - 1; x <= cursor_x + 1; x++) {
-            if(x == cursor_x && y == cursor_y) {
-                // we're on the cell the user selected, so ignore.
-                continue;
-            }
             // make sure we don't go OOB
             if(x >= 0 && x < PLAYFIELD_WIDTH && y >= 0 && y < PLAYFIELD_HEIGHT) {
-                if(minesweeper_state->minefield[x][y] == FieldMine) {
-                    hint++;
+                if(minesweeper_state->playfield[x][y] == TileTypeFlag) {
+                    flags++;
                 }
             }
         }
     }
-    // 〜(￣▽￣〜) don't judge me (〜￣▽￣)〜
-    minesweeper_state->playfield[cursor_x][cursor_y] = hint;
-    minesweeper_state->fields_cleared++;
-    FURI_LOG_D("Minesweeper", "Setting %d,%d to %d", cursor_x, cursor_y, hint);
-    if(hint == 0) {
-        // the field is "empty"
-        // auto open surrounding fields.
-        for(int auto_y = cursor_y - 1; auto_y <= cursor_y + 1; auto_y++) {
-            for(int auto_x = cursor_x - 1; auto_x <= cursor_x + 1; auto_x++) {
-                if(auto_x == cursor_x && auto_y == cursor_y) {
-                    continue;
-                }
-                if(auto_x >= 0 && auto_x < PLAYFIELD_WIDTH && auto_y >= 0 &&
-                   auto_y < PLAYFIELD_HEIGHT) {
-                    if(minesweeper_state->playfield[auto_x][auto_y] == TileTypeUncleared) {
-                        play_move(minesweeper_state, auto_x, auto_y);
-                    }
+    int mines = minesweeper_state->playfield[cursor_x][cursor_y]; // ¯\_(ツ)_/¯
+    if(flags != mines) {
+        return true;
+    }
+    // auto uncover all non-flags around (to win faster ;)
+    for(int auto_y = cursor_y - 1; auto_y <= cursor_y + 1; auto_y++) {
+        for(int auto_x = cursor_x - 1; auto_x <= cursor_x + 1; auto_x++) {
+            if(auto_x >= 0 && auto_x < PLAYFIELD_WIDTH && auto_y >= 0 &&
+               auto_y < PLAYFIELD_HEIGHT &&
+               minesweeper_state->playfield[auto_x][auto_y] == TileTypeUncleared) {
+                if(minesweeper_state->minefield[auto_x][auto_y] == FieldMine) {
+                    // flags were wrong, we got a mine!
+                    minesweeper_state->playfield[auto_x][auto_y] = TileTypeMine;
+                    return false;
                 }
+                clear_region(minesweeper_state, auto_x, auto_y);
             }
         }
     }
+    // we're done without hitting a mine - so return
     return true;
 }
 
 static void minesweeper_state_init(Minesweeper* const minesweeper_state) {
     minesweeper_state->cursor_x = minesweeper_state->cursor_y = 0;
-    minesweeper_state->game_started = false;
-    for(int y = 0; y < PLAYFIELD_HEIGHT; y++) {
-        for(int x = 0; x < PLAYFIELD_WIDTH; x++) {
-            minesweeper_state->playfield[x][y] = TileTypeUncleared;
-        }
-    }
+    minesweeper_state->no_guess = false;
+    setup_playfield(minesweeper_state);
 }
 
 int32_t minesweeper_app(void* p) {
     UNUSED(p);
+    profile_start(); // "profile" CLI command in debug builds
     FuriMessageQueue* event_queue = furi_message_queue_alloc(8, sizeof(PluginEvent));
 
     Minesweeper* minesweeper_state = malloc(sizeof(Minesweeper));
@@ -376,7 +563,7 @@ int32_t minesweeper_app(void* p) {
     dialog_message_set_header(message, "Minesweeper", 64, 3, AlignCenter, AlignTop);
     dialog_message_set_text(
         message,
-        "Hold OK pressed to toggle flags.\ngithub.com/panki27",
+        "Hold OK pressed to toggle flags.\nHold Up for no guessing mode.\ngithub.com/panki27",
         64,
         32,
         AlignCenter,
@@ -441,6 +628,11 @@ int32_t minesweeper_app(void* p) {
                     case InputKeyOk:
                         if(!minesweeper_state->game_started) {
                             setup_playfield(minesweeper_state);
+                            generate_minefield(
+                                minesweeper_state,
+                                minesweeper_state->cursor_x,
+                                minesweeper_state->cursor_y);
+                            minesweeper_state->game_started_tick = furi_get_tick();
                             minesweeper_state->game_started = true;
                         }
                         if(!play_move(
@@ -480,6 +672,11 @@ int32_t minesweeper_app(void* p) {
                     FURI_LOG_D("Minesweeper", "Got a long press!");
                     switch(event.input.key) {
                     case InputKeyUp:
+                        // takes effect with the next board
+                        furi_mutex_acquire(minesweeper_state->mutex, FuriWaitForever);
+                        minesweeper_state->no_guess = !minesweeper_state->no_guess;
+                        furi_mutex_release(minesweeper_state->mutex);
+                        break;
                     case InputKeyDown:
                     case InputKeyRight:
                     case InputKeyLeft:
@@ -510,6 +707,7 @@ int32_t minesweeper_app(void* p) {
     furi_message_queue_free(event_queue);
     furi_mutex_free(minesweeper_state->mutex);
     free(minesweeper_state);
+    profile_stop();
 
     return 0;
 }
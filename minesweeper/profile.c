@@ -0,0 +1,230 @@
+#include "profile.h"
+
+#ifdef PROFILE_ENABLED
+
+#include <cli/cli.h>
+#include <storage/storage.h>
+
+#define PROFILE_TAG "Profile"
+#define PROFILE_CLI_COMMAND "profile"
+#define PROFILE_LOG_PATH APP_DATA_PATH("profile.log")
+#define PROFILE_HEAP_SAMPLE_MS 50
+
+typedef struct {
+    const char* name;
+    uint32_t stack_free;
+} ProfileThread;
+
+static ProfileProbe* profile_probes[PROFILE_PROBES_MAX];
+static uint32_t profile_probes_count;
+
+static ProfileThread profile_threads[PROFILE_THREADS_MAX];
+static uint32_t profile_threads_count;
+static uint32_t profile_start_cycles;
+static bool profile_first_frame_logged;
+static FuriTimer* profile_heap_timer;
+static size_t profile_heap_start;
+static volatile size_t profile_heap_min;
+
+void profile_record(ProfileProbe* probe, uint32_t cycles) {
+    // the first record takes a slot, an interrupt can't get the same one
+    if(!__atomic_exchange_n(&probe->registered, true, __ATOMIC_ACQ_REL)) {
+        uint32_t slot = __atomic_fetch_add(&profile_probes_count, 1, __ATOMIC_ACQ_REL);
+        if(slot < PROFILE_PROBES_MAX) {
+            __atomic_store_n(&profile_probes[slot], probe, __ATOMIC_RELEASE);
+        }
+    }
+
+    if(probe->count == 0 || cycles < probe->min) probe->min = cycles;
+    if(cycles > probe->max) probe->max = cycles;
+    probe->total += cycles;
+    probe->count++;
+}
+
+void profile_reset(void) {
+    for(uint32_t i = 0; i < PROFILE_PROBES_MAX; i++) {
+        ProfileProbe* probe = __atomic_load_n(&profile_probes[i], __ATOMIC_ACQUIRE);
+        if(!probe) continue;
+        probe->count = 0;
+        probe->min = 0;
+        probe->max = 0;
+        probe->total = 0;
+    }
+}
+
+// one line of the table, times in microseconds
+static void profile_format(char* buf, size_t size, const ProfileProbe* probe) {
+    uint32_t per_us = furi_hal_cortex_instructions_per_microsecond();
+    uint32_t count = probe->count;
+    uint32_t avg = count ? probe->total / count : 0;
+    snprintf(
+        buf,
+        size,
+        "%-16s %8lu %8lu %8lu %8lu",
+        probe->name,
+        count,
+        probe->min / per_us,
+        avg / per_us,
+        probe->max / per_us);
+}
+
+static void profile_heap_sample(void* context) {
+    UNUSED(context);
+    size_t free_heap = memmgr_get_free_heap();
+    if(free_heap < profile_heap_min) profile_heap_min = free_heap;
+}
+
+void profile_thread_exit(const char* name) {
+    uint32_t stack_free = furi_thread_get_stack_space(furi_thread_get_current_id());
+
+    // a worker started again keeps the lowest mark of its runs
+    uint32_t count = MIN(profile_threads_count, (uint32_t)PROFILE_THREADS_MAX);
+    for(uint32_t i = 0; i < count; i++) {
+        const char* slot_name = __atomic_load_n(&profile_threads[i].name, __ATOMIC_ACQUIRE);
+        if(slot_name && strcmp(slot_name, name) == 0) {
+            profile_threads[i].stack_free = MIN(profile_threads[i].stack_free, stack_free);
+            return;
+        }
+    }
+
+    uint32_t slot = __atomic_fetch_add(&profile_threads_count, 1, __ATOMIC_ACQ_REL);
+    if(slot < PROFILE_THREADS_MAX) {
+        profile_threads[slot].stack_free = stack_free;
+        __atomic_store_n(&profile_threads[slot].name, name, __ATOMIC_RELEASE);
+    }
+}
+
+void profile_phase(const char* name) {
+    uint32_t us = (DWT->CYCCNT - profile_start_cycles) /
+                  furi_hal_cortex_instructions_per_microsecond();
+    FURI_LOG_I(PROFILE_TAG, "startup %s: %lu.%03lu ms", name, us / 1000, us % 1000);
+}
+
+void profile_first_frame(void) {
+    if(!__atomic_exchange_n(&profile_first_frame_logged, true, __ATOMIC_ACQ_REL)) {
+        profile_phase("first frame");
+    }
+}
+
+// heap line, then one line per thread that has reported its stack
+static bool profile_format_memory(char* buf, size_t size, uint32_t index) {
+    if(index == 0) {
+        size_t min = profile_heap_min;
+        snprintf(
+            buf,
+            size,
+            "heap: %u bytes used at peak, %u free at least",
+            profile_heap_start > min ? profile_heap_start - min : 0,
+            min);
+        return true;
+    }
+
+    index--;
+    if(index >= MIN(profile_threads_count, (uint32_t)PROFILE_THREADS_MAX)) return false;
+    const char* name = __atomic_load_n(&profile_threads[index].name, __ATOMIC_ACQUIRE);
+    snprintf(
+        buf,
+        size,
+        "stack %s: %lu bytes free at least",
+        name ? name : "?",
+        profile_threads[index].stack_free);
+    return true;
+}
+
+static void profile_cli(Cli* cli, FuriString* args, void* context) {
+    UNUSED(cli);
+    UNUSED(context);
+
+    if(furi_string_cmp_str(args, "reset") == 0) {
+        profile_reset();
+        printf("Probes cleared\r\n");
+        return;
+    }
+
+    char line[64];
+    printf("%-16s %8s %8s %8s %8s\r\n", "probe", "count", "min us", "avg us", "max us");
+    for(uint32_t i = 0; i < PROFILE_PROBES_MAX; i++) {
+        ProfileProbe* probe = __atomic_load_n(&profile_probes[i], __ATOMIC_ACQUIRE);
+        if(!probe) continue;
+        profile_format(line, sizeof(line), probe);
+        printf("%s\r\n", line);
+    }
+    if(profile_probes_count > PROFILE_PROBES_MAX) {
+        printf("%lu probes left out\r\n", profile_probes_count - PROFILE_PROBES_MAX);
+    }
+    for(uint32_t i = 0; profile_format_memory(line, sizeof(line), i); i++) {
+        printf("%s\r\n", line);
+    }
+}
+
+// Appends the memory summary of this run to the app's profile.log
+static void profile_save(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, STORAGE_APP_DATA_PATH_PREFIX);
+    File* file = storage_file_alloc(storage);
+
+    if(storage_file_open(file, PROFILE_LOG_PATH, FSAM_WRITE, FSOM_OPEN_APPEND)) {
+        FuriHalRtcDateTime datetime;
+        furi_hal_rtc_get_datetime(&datetime);
+        char line[64];
+        int len = snprintf(
+            line,
+            sizeof(line),
+            "--- %04d-%02d-%02d %02d:%02d:%02d\n",
+            datetime.year,
+            datetime.month,
+            datetime.day,
+            datetime.hour,
+            datetime.minute,
+            datetime.second);
+        storage_file_write(file, line, len);
+        for(uint32_t i = 0; profile_format_memory(line, sizeof(line) - 1, i); i++) {
+            strcat(line, "\n");
+            storage_file_write(file, line, strlen(line));
+        }
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+void profile_start(void) {
+    profile_start_cycles = DWT->CYCCNT;
+    profile_first_frame_logged = false;
+    profile_threads_count = 0;
+    profile_heap_start = memmgr_get_free_heap();
+    profile_heap_min = profile_heap_start;
+    profile_heap_timer = furi_timer_alloc(profile_heap_sample, FuriTimerTypePeriodic, NULL);
+    furi_timer_start(profile_heap_timer, furi_ms_to_ticks(PROFILE_HEAP_SAMPLE_MS));
+
+    Cli* cli = furi_record_open(RECORD_CLI);
+    cli_add_command(cli, PROFILE_CLI_COMMAND, CliCommandFlagParallelSafe, profile_cli, NULL);
+    furi_record_close(RECORD_CLI);
+}
+
+void profile_stop(void) {
+    Cli* cli = furi_record_open(RECORD_CLI);
+    cli_delete_command(cli, PROFILE_CLI_COMMAND);
+    furi_record_close(RECORD_CLI);
+
+    furi_timer_stop(profile_heap_timer);
+    furi_timer_free(profile_heap_timer);
+    profile_heap_sample(NULL);
+    profile_thread_exit("app");
+
+    char line[64];
+    for(uint32_t i = 0; i < PROFILE_PROBES_MAX; i++) {
+        ProfileProbe* probe = __atomic_load_n(&profile_probes[i], __ATOMIC_ACQUIRE);
+        if(!probe) continue;
+        profile_format(line, sizeof(line), probe);
+        FURI_LOG_I(PROFILE_TAG, "%s", line);
+    }
+    for(uint32_t i = 0; profile_format_memory(line, sizeof(line), i); i++) {
+        FURI_LOG_I(PROFILE_TAG, "%s", line);
+    }
+
+    profile_save();
+}
+
+#endif
@@ -51,6 +51,10 @@ PacsFuzzerApp* fuzzer_app_alloc() {
     view_dispatcher_add_view(
         app->view_dispatcher, FuzzerViewIDTextInput, text_input_get_view(app->text_input));
 
+    // Widget
+    app->widget = widget_alloc();
+    view_dispatcher_add_view(app->view_dispatcher, FuzzerViewIDWidget, widget_get_view(app->widget));
+
     // Main view
     app->main_view = fuzzer_view_main_alloc();
     view_dispatcher_add_view(
@@ -109,6 +113,10 @@ void fuzzer_app_free(PacsFuzzerApp* app) {
     view_dispatcher_remove_view(app->view_dispatcher, FuzzerViewIDTextInput);
     text_input_free(app->text_input);
 
+    // Widget
+    view_dispatcher_remove_view(app->view_dispatcher, FuzzerViewIDWidget);
+    widget_free(app->widget);
+
     scene_manager_free(app->scene_manager);
     view_dispatcher_free(app->view_dispatcher);
 
@@ -8,6 +8,7 @@
 #include <gui/scene_manager.h>
 #include <gui/modules/popup.h>
 #include <gui/modules/text_input.h>
+#include <gui/modules/widget.h>
 
 #include <dialogs/dialogs.h>
 #include <notification/notification_messages.h>
@@ -18,6 +19,7 @@
 #include "views/field_editor.h"
 
 #include "helpers/fuzzer_types.h"
+#include "helpers/fuzzer_calibration.h"
 #include "lib/worker/fake_worker.h"
 
 #include <flipper_format/flipper_format_i.h>
@@ -47,6 +49,7 @@ typedef struct {
     Popup* popup;
     DialogsApp* dialogs;
     TextInput* text_input;
+    Widget* widget;
     FuzzerViewMain* main_view;
     FuzzerViewAttack* attack_view;
     FuzzerViewFieldEditor* field_editor_view;
@@ -59,4 +62,6 @@ typedef struct {
 
     FuzzerWorker* worker;
     FuzzerPayload* payload;
+
+    FuzzerCalibration calibration;
 } PacsFuzzerApp;
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include "fuzzer_calibration.h"
+
+#include <storage/storage.h>
+#include <flipper_format/flipper_format.h>
+
+#define TAG "Fuzzer calibration"
+
+#define FUZZER_PROFILE_FILETYPE "Fuzzer timing profile"
+#define FUZZER_PROFILE_VERSION (1)
+
+static void fuzzer_calibration_next_stage(FuzzerCalibration* calibration) {
+    switch(calibration->stage) {
+    case FuzzerCalibrationStageVerify:
+    case FuzzerCalibrationStageEmuTime:
+        if(calibration->low < calibration->high) {
+            calibration->stage = FuzzerCalibrationStageEmuTime;
+            break;
+        }
+        calibration->emu_time = calibration->high;
+
+        // Idle time is searched with the emulation time already found
+        calibration->stage = FuzzerCalibrationStageIdleTime;
+        calibration->low = 0;
+        calibration->high = calibration->idle_time;
+        // fall through
+
+    case FuzzerCalibrationStageIdleTime:
+        if(calibration->low < calibration->high) {
+            break;
+        }
+        calibration->idle_time = calibration->high;
+        calibration->stage = FuzzerCalibrationStageDone;
+        break;
+
+    default:
+        break;
+    }
+}
+
+void fuzzer_calibration_reset(
+    FuzzerCalibration* calibration,
+    uint8_t idle_time,
+    uint8_t emu_time,
+    uint8_t emu_time_min) {
+    furi_assert(calibration);
+
+    calibration->stage = FuzzerCalibrationStageVerify;
+    calibration->idle_time = idle_time;
+    calibration->emu_time = emu_time;
+    calibration->low = MIN(emu_time_min, emu_time);
+    calibration->high = emu_time;
+    calibration->cycles = 0;
+    calibration->accepted = 0;
+    calibration->signals = 0;
+}
+
+void fuzzer_calibration_get_trial(
+    FuzzerCalibration* calibration,
+    uint8_t* idle_time,
+    uint8_t* emu_time) {
+    furi_assert(calibration);
+
+    uint8_t mid = calibration->low + (calibration->high - calibration->low) / 2;
+
+    switch(calibration->stage) {
+    case FuzzerCalibrationStageEmuTime:
+        *idle_time = calibration->idle_time;
+        *emu_time = mid;
+        break;
+    case FuzzerCalibrationStageIdleTime:
+        *idle_time = mid;
+        *emu_time = calibration->emu_time;
+        break;
+    default:
+        *idle_time = calibration->idle_time;
+        *emu_time = calibration->emu_time;
+        break;
+    }
+}
+
+void fuzzer_calibration_set_result(FuzzerCalibration* calibration, bool accepted) {
+    furi_assert(calibration);
+
+    uint8_t mid = calibration->low + (calibration->high - calibration->low) / 2;
+
+    switch(calibration->stage) {
+    case FuzzerCalibrationStageVerify:
+        if(!accepted) {
+            calibration->stage = FuzzerCalibrationStageFail;
+            return;
+        }
+        break;
+    case FuzzerCalibrationStageEmuTime:
+    case FuzzerCalibrationStageIdleTime:
+        if(accepted) {
+            calibration->high = mid;
+        } else {
+            calibration->low = mid + 1;
+        }
+        break;
+    default:
+        return;
+    }
+
+    FURI_LOG_D(
+        TAG,
+        "Stage %u %s, bounds %u..%u",
+        calibration->stage,
+        accepted ? "accepted" : "rejected",
+        calibration->low,
+        calibration->high);
+
+    fuzzer_calibration_next_stage(calibration);
+}
+
+bool fuzzer_timing_profile_save(
+    const char* path,
+    const char* protocol_name,
+    uint8_t idle_time,
+    uint8_t emu_time) {
+    furi_assert(path);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    FlipperFormat* file = flipper_format_file_alloc(storage);
+    bool res = false;
+
+    do {
+        storage_simply_mkdir(storage, FUZZER_PROFILE_FOLDER);
+        if(!flipper_format_file_open_always(file, path)) break;
+        if(!flipper_format_write_header_cstr(
+               file, FUZZER_PROFILE_FILETYPE, FUZZER_PROFILE_VERSION))
+            break;
+        if(!flipper_format_write_string_cstr(file, "Protocol", protocol_name)) break;
+
+        uint32_t value = emu_time;
+        if(!flipper_format_write_uint32(file, "Emu_time", &value, 1)) break;
+        value = idle_time;
+        if(!flipper_format_write_uint32(file, "Idle_time", &value, 1)) break;
+
+        res = true;
+    } while(false);
+
+    flipper_format_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    return res;
+}
+
+bool fuzzer_timing_profile_load(const char* path, uint8_t* idle_time, uint8_t* emu_time) {
+    furi_assert(path);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    FlipperFormat* file = flipper_format_file_alloc(storage);
+    FuriString* temp_str = furi_string_alloc();
+    bool res = false;
+
+    do {
+        uint32_t version;
+        if(!flipper_format_file_open_existing(file, path)) break;
+        if(!flipper_format_read_header(file, temp_str, &version)) break;
+        if(furi_string_cmp_str(temp_str, FUZZER_PROFILE_FILETYPE) ||
+           version != FUZZER_PROFILE_VERSION)
+            break;
+
+        uint32_t emu_value, idle_value;
+        if(!flipper_format_read_uint32(file, "Emu_time", &emu_value, 1)) break;
+        if(!flipper_format_read_uint32(file, "Idle_time", &idle_value, 1)) break;
+        if(emu_value > UINT8_MAX || idle_value > UINT8_MAX) break;
+
+        *emu_time = emu_value;
+        *idle_time = idle_value;
+        res = true;
+    } while(false);
+
+    furi_string_free(temp_str);
+    flipper_format_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    return res;
+}
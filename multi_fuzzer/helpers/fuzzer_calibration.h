@@ -0,0 +1,96 @@
+#pragma once
+
+#include <furi.h>
+
+// Replays of the known-good key per trial, all of them must be accepted
+#define FUZZER_CALIBRATION_CYCLES (3)
+// Accept signal input, pin 2 is pulled up and the reader output pulls it low
+#define FUZZER_CALIBRATION_GPIO (&gpio_ext_pa7)
+
+#define FUZZER_PROFILE_FOLDER APP_DATA_PATH("profiles")
+#define FUZZER_PROFILE_EXTENSION ".txt"
+
+typedef enum {
+    FuzzerCalibrationStageVerify = 0, // Initial timings must work, otherwise nothing to search
+    FuzzerCalibrationStageEmuTime,
+    FuzzerCalibrationStageIdleTime,
+    FuzzerCalibrationStageDone,
+    FuzzerCalibrationStageFail,
+} FuzzerCalibrationStage;
+
+typedef struct {
+    FuzzerCalibrationStage stage;
+    // Binary search bounds of the current stage, high is always known to work
+    uint8_t low;
+    uint8_t high;
+
+    // 1 = 100ms, as in the attack view
+    uint8_t idle_time;
+    uint8_t emu_time;
+
+    bool use_gpio;
+    uint8_t cycles;
+    // Replays the reader answered during the current trial
+    uint8_t accepted;
+    // GPIO edges since the last replay, contacts may bounce so only non-zero matters
+    volatile uint8_t signals;
+} FuzzerCalibration;
+
+/**
+ * Start a new calibration from the timings known to work
+ *
+ * @param calibration Pointer to a FuzzerCalibration
+ * @param idle_time Initial delay between emulations in tenths of a second
+ * @param emu_time Initial emulation time in tenths of a second
+ * @param emu_time_min Shortest emulation time to try
+ */
+void fuzzer_calibration_reset(
+    FuzzerCalibration* calibration,
+    uint8_t idle_time,
+    uint8_t emu_time,
+    uint8_t emu_time_min);
+
+/**
+ * Get timings of the next trial
+ *
+ * @param calibration Pointer to a FuzzerCalibration
+ * @param idle_time Delay between emulations in tenths of a second
+ * @param emu_time Emulation time in tenths of a second
+ */
+void fuzzer_calibration_get_trial(
+    FuzzerCalibration* calibration,
+    uint8_t* idle_time,
+    uint8_t* emu_time);
+
+/**
+ * Narrow the search with the outcome of the last trial
+ *
+ * @param calibration Pointer to a FuzzerCalibration
+ * @param accepted True if the reader accepted every replay
+ */
+void fuzzer_calibration_set_result(FuzzerCalibration* calibration, bool accepted);
+
+/**
+ * Save timing profile of a reader
+ *
+ * @param path file path to the profile
+ * @param protocol_name name of the calibrated protocol
+ * @param idle_time Delay between emulations in tenths of a second
+ * @param emu_time Emulation time in tenths of a second
+ * @return bool True if saving is successful
+ */
+bool fuzzer_timing_profile_save(
+    const char* path,
+    const char* protocol_name,
+    uint8_t idle_time,
+    uint8_t emu_time);
+
+/**
+ * Load timing profile of a reader
+ *
+ * @param path file path to the profile
+ * @param idle_time Delay between emulations in tenths of a second
+ * @param emu_time Emulation time in tenths of a second
+ * @return bool True if loading is successful
+ */
+bool fuzzer_timing_profile_load(const char* path, uint8_t* idle_time, uint8_t* emu_time);
@@ -17,6 +17,10 @@ typedef enum {
     FuzzerCustomEventViewAttackSave,
     FuzzerCustomEventViewAttackNextUid,
     FuzzerCustomEventViewAttackPrevUid,
+    FuzzerCustomEventViewAttackCalibrate,
+    FuzzerCustomEventViewAttackLoadProfile,
+
+    FuzzerCustomEventCalibrationCycle,
 
     FuzzerCustomEventViewFieldEditorBack,
     FuzzerCustomEventViewFieldEditorOk,
@@ -23,9 +23,16 @@ typedef enum {
 
 } FuzzerFieldEditorState;
 
+typedef enum {
+    FuzzerSaveNameStateKey = 0,
+    FuzzerSaveNameStateProfile,
+
+} FuzzerSaveNameState;
+
 typedef enum {
     FuzzerViewIDPopup,
     FuzzerViewIDTextInput,
+    FuzzerViewIDWidget,
 
     FuzzerViewIDMain,
     FuzzerViewIDAttack,
@@ -10,8 +10,19 @@
 #define TOTAL_PROTOCOL_COUNT fuzzer_proto_get_count_of_protocols()
 #define PROTOCOL_KEY_FOLDER EXT_PATH(PROTOCOL_KEY_FOLDER_NAME)
 
+// Parsed dictionary UIDs queued ahead of the emulation timer
+#define FUZZER_WORKER_PREFETCH_SIZE (32)
+// Only hit when the SD card stalls, the prefetch thread always answers within this
+#define FUZZER_WORKER_PREFETCH_WAIT_MS (1000)
+
 typedef uint8_t FuzzerWorkerPayload[MAX_PAYLOAD_SIZE];
 
+typedef struct {
+    FuzzerWorkerPayload payload;
+    // marks the end of the dictionary, the next item starts over from its beginning
+    bool end;
+} FuzzerWorkerPrefetchItem;
+
 struct FuzzerWorker {
     HardwareWorker* hw_worker;
 
@@ -24,7 +35,13 @@ struct FuzzerWorker {
     uint16_t index;
     Stream* uids_stream;
 
+    FuriThread* prefetch_thread;
+    FuriMessageQueue* prefetch_queue;
+    volatile bool prefetch_running;
+
     bool in_emu_phase;
+    // emulate the current key again instead of the next one
+    bool replay;
     FuriTimer* timer;
     uint16_t timer_idle_time_ms;
     uint16_t timer_emu_time_ms;
@@ -115,6 +132,83 @@ bool fuzzer_worker_save_key(FuzzerWorker* instance, const char* path) {
     return res;
 }
 
+static bool fuzzer_worker_parse_next_uid(
+    FuzzerWorker* instance,
+    FuriString* data_str,
+    FuzzerWorkerPayload payload) {
+    const FuzzerProtocol* protocol = instance->protocol;
+    const size_t str_len = protocol->data_size * 2 + 1;
+
+    while(true) {
+        furi_string_reset(data_str);
+        if(!stream_read_line(instance->uids_stream, data_str)) {
+            stream_rewind(instance->uids_stream);
+            return false;
+        }
+        if(furi_string_get_char(data_str, 0) == '#') {
+            // Skip comment string
+            continue;
+        }
+        if(furi_string_size(data_str) != str_len) {
+            // Ignore strin with bad length
+            FURI_LOG_W(TAG, "Bad string length");
+            continue;
+        }
+
+        const char* str = furi_string_get_cstr(data_str);
+        bool parse_ok = true;
+        for(uint8_t i = 0; i < protocol->data_size && parse_ok; i++) {
+            parse_ok = hex_char_to_uint8(str[i * 2], str[i * 2 + 1], &payload[i]);
+        }
+        if(parse_ok) {
+            return true;
+        }
+        FURI_LOG_W(TAG, "Bad uid \"%s\"", str);
+    }
+}
+
+// Keeps the queue full so the timer never waits for the SD card or the parser
+static int32_t fuzzer_worker_prefetch_thread(void* context) {
+    FuzzerWorker* instance = context;
+    FuriString* data_str = furi_string_alloc();
+    FuzzerWorkerPrefetchItem item;
+
+    while(instance->prefetch_running) {
+        memset(&item, 0, sizeof(item));
+        item.end = !fuzzer_worker_parse_next_uid(instance, data_str, item.payload);
+        while(instance->prefetch_running &&
+              furi_message_queue_put(instance->prefetch_queue, &item, furi_ms_to_ticks(100)) !=
+                  FuriStatusOk) {
+        }
+    }
+
+    furi_string_free(data_str);
+    return 0;
+}
+
+static void fuzzer_worker_prefetch_start(FuzzerWorker* instance) {
+    instance->prefetch_queue =
+        furi_message_queue_alloc(FUZZER_WORKER_PREFETCH_SIZE, sizeof(FuzzerWorkerPrefetchItem));
+    instance->prefetch_running = true;
+    instance->prefetch_thread = furi_thread_alloc_ex(
+        "FuzzerWorkerPrefetch", 1024, fuzzer_worker_prefetch_thread, instance);
+    furi_thread_set_priority(instance->prefetch_thread, FuriThreadPriorityLow);
+    furi_thread_start(instance->prefetch_thread);
+}
+
+static void fuzzer_worker_prefetch_stop(FuzzerWorker* instance) {
+    if(!instance->prefetch_thread) {
+        return;
+    }
+
+    instance->prefetch_running = false;
+    furi_thread_join(instance->prefetch_thread);
+    furi_thread_free(instance->prefetch_thread);
+    instance->prefetch_thread = NULL;
+    furi_message_queue_free(instance->prefetch_queue);
+    instance->prefetch_queue = NULL;
+}
+
 static bool fuzzer_worker_load_key(FuzzerWorker* instance, bool next) {
     furi_assert(instance);
     furi_assert(instance->protocol);
@@ -144,38 +238,15 @@ static bool fuzzer_worker_load_key(FuzzerWorker* instance, bool next) {
         if(next) {
             instance->index++;
         }
-        uint8_t str_len = protocol->data_size * 2 + 1;
-        FuriString* data_str = furi_string_alloc();
-        while(true) {
-            furi_string_reset(data_str);
-            if(!stream_read_line(instance->uids_stream, data_str)) {
-                stream_rewind(instance->uids_stream);
-                // TODO Check empty file & close stream and storage
-                break;
-            } else if(furi_string_get_char(data_str, 0) == '#') {
-                // Skip comment string
-                continue;
-            } else if(furi_string_size(data_str) != str_len) {
-                // Ignore strin with bad length
-                FURI_LOG_W(TAG, "Bad string length");
-                continue;
-            } else {
-                FURI_LOG_D(TAG, "Uid candidate: \"%s\"", furi_string_get_cstr(data_str));
-                bool parse_ok = true;
-                for(uint8_t i = 0; i < protocol->data_size; i++) {
-                    if(!hex_char_to_uint8(
-                           furi_string_get_cstr(data_str)[i * 2],
-                           furi_string_get_cstr(data_str)[i * 2 + 1],
-                           &instance->payload[i])) {
-                        parse_ok = false;
-                        break;
-                    }
-                }
-                res = parse_ok;
-            }
-            break;
+        FuzzerWorkerPrefetchItem item;
+        if(furi_message_queue_get(
+               instance->prefetch_queue,
+               &item,
+               furi_ms_to_ticks(FUZZER_WORKER_PREFETCH_WAIT_MS)) == FuriStatusOk &&
+           !item.end) {
+            memcpy(instance->payload, item.payload, protocol->data_size);
+            res = true;
         }
-        furi_string_free(data_str);
     }
 
     break;
@@ -249,7 +320,7 @@ static void fuzzer_worker_on_tick_callback(void* context) {
         instance->in_emu_phase = false;
         furi_timer_start(instance->timer, furi_ms_to_ticks(instance->timer_idle_time_ms));
     } else {
-        if(!fuzzer_worker_load_key(instance, true)) {
+        if(!instance->replay && !fuzzer_worker_load_key(instance, true)) {
             fuzzer_worker_pause(instance); // XXX
             if(instance->end_callback) {
                 instance->end_callback(instance->end_context);
@@ -336,9 +407,11 @@ bool fuzzer_worker_init_attack_file_dict(
 
     instance->attack_type = FuzzerWorkerAttackTypeLoadFileCustomUids;
     instance->index = 0;
+    fuzzer_worker_prefetch_start(instance);
 
     if(!fuzzer_worker_load_key(instance, false)) {
         instance->attack_type = FuzzerWorkerAttackTypeMax;
+        fuzzer_worker_prefetch_stop(instance);
         buffered_file_stream_close(instance->uids_stream);
         stream_free(instance->uids_stream);
     } else {
@@ -427,31 +500,48 @@ void fuzzer_worker_free(FuzzerWorker* instance) {
     free(instance);
 }
 
+static void
+    fuzzer_worker_start_timer(FuzzerWorker* instance, uint8_t idle_time, uint8_t emu_time) {
+    if(idle_time == 0) {
+        instance->timer_idle_time_ms = 10;
+    } else {
+        instance->timer_idle_time_ms = idle_time * 100;
+    }
+    if(emu_time == 0) {
+        instance->timer_emu_time_ms = 10;
+    } else {
+        instance->timer_emu_time_ms = emu_time * 100;
+    }
+
+    FURI_LOG_D(
+        TAG,
+        "Emu_time %u ms  Idle_time %u ms",
+        instance->timer_emu_time_ms,
+        instance->timer_idle_time_ms);
+
+    hardware_worker_emulate_start(instance->hw_worker);
+
+    instance->in_emu_phase = true;
+    furi_timer_start(instance->timer, furi_ms_to_ticks(instance->timer_emu_time_ms));
+}
+
 bool fuzzer_worker_start(FuzzerWorker* instance, uint8_t idle_time, uint8_t emu_time) {
     furi_assert(instance);
 
     if(instance->attack_type < FuzzerWorkerAttackTypeMax) {
-        if(idle_time == 0) {
-            instance->timer_idle_time_ms = 10;
-        } else {
-            instance->timer_idle_time_ms = idle_time * 100;
-        }
-        if(emu_time == 0) {
-            instance->timer_emu_time_ms = 10;
-        } else {
-            instance->timer_emu_time_ms = emu_time * 100;
-        }
-
-        FURI_LOG_D(
-            TAG,
-            "Emu_time %u ms  Idle_time %u ms",
-            instance->timer_emu_time_ms,
-            instance->timer_idle_time_ms);
+        instance->replay = false;
+        fuzzer_worker_start_timer(instance, idle_time, emu_time);
+        return true;
+    }
+    return false;
+}
 
-        hardware_worker_emulate_start(instance->hw_worker);
+bool fuzzer_worker_start_replay(FuzzerWorker* instance, uint8_t idle_time, uint8_t emu_time) {
+    furi_assert(instance);
 
-        instance->in_emu_phase = true;
-        furi_timer_start(instance->timer, furi_ms_to_ticks(instance->timer_emu_time_ms));
+    if(instance->attack_type < FuzzerWorkerAttackTypeMax) {
+        instance->replay = true;
+        fuzzer_worker_start_timer(instance, idle_time, emu_time);
         return true;
     }
     return false;
@@ -479,6 +569,7 @@ void fuzzer_worker_stop(FuzzerWorker* instance) {
     hardware_worker_stop(instance->hw_worker);
 
     if(instance->attack_type == FuzzerWorkerAttackTypeLoadFileCustomUids) {
+        fuzzer_worker_prefetch_stop(instance);
         buffered_file_stream_close(instance->uids_stream);
         stream_free(instance->uids_stream);
         instance->attack_type = FuzzerWorkerAttackTypeMax;
@@ -56,6 +56,16 @@ bool fuzzer_worker_start(FuzzerWorker* instance, uint8_t idle_time, uint8_t emu_
  */
 void fuzzer_worker_stop(FuzzerWorker* instance);
 
+/**
+ * Emulate the current UID over and over with the given timings
+ * 
+ * @param instance Pointer to a FuzzerWorker
+ * @param idle_time Delay between emulations in tenths of a second
+ * @param emu_time Emulation time of one UID in tenths of a second
+ * @return bool True if emulation has started
+ */
+bool fuzzer_worker_start_replay(FuzzerWorker* instance, uint8_t idle_time, uint8_t emu_time);
+
 void fuzzer_worker_start_emulate(FuzzerWorker* instance);
 
 /**
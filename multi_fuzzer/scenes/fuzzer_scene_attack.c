@@ -74,6 +74,27 @@ void fuzzer_scene_attack_callback(FuzzerCustomEvent event, void* context) {
     view_dispatcher_send_custom_event(app->view_dispatcher, event);
 }
 
+static bool fuzzer_scene_attack_load_profile(PacsFuzzerApp* app) {
+    furi_string_set_str(app->file_path, FUZZER_PROFILE_FOLDER);
+
+    DialogsFileBrowserOptions browser_options;
+    dialog_file_browser_set_basic_options(&browser_options, FUZZER_PROFILE_EXTENSION, NULL);
+    browser_options.base_path = FUZZER_PROFILE_FOLDER;
+    browser_options.hide_ext = true;
+
+    if(!dialog_file_browser_show(app->dialogs, app->file_path, app->file_path, &browser_options)) {
+        return false;
+    }
+
+    uint8_t idle_time, emu_time;
+    if(!fuzzer_timing_profile_load(furi_string_get_cstr(app->file_path), &idle_time, &emu_time)) {
+        return false;
+    }
+
+    fuzzer_view_attack_set_timings(app->attack_view, idle_time, emu_time);
+    return true;
+}
+
 void fuzzer_scene_attack_on_enter(void* context) {
     furi_assert(context);
     PacsFuzzerApp* app = context;
@@ -146,7 +167,16 @@ bool fuzzer_scene_attack_on_event(void* context, SceneManagerEvent event) {
                 notification_message(app->notifications, &sequence_blink_red_100);
             }
         } else if(event.event == FuzzerCustomEventViewAttackSave) {
+            scene_manager_set_scene_state(
+                app->scene_manager, FuzzerSceneSaveName, FuzzerSaveNameStateKey);
             scene_manager_next_scene(app->scene_manager, FuzzerSceneSaveName);
+        } else if(event.event == FuzzerCustomEventViewAttackCalibrate) {
+            scene_manager_set_scene_state(app->scene_manager, FuzzerSceneCalibration, 0);
+            scene_manager_next_scene(app->scene_manager, FuzzerSceneCalibration);
+        } else if(event.event == FuzzerCustomEventViewAttackLoadProfile) {
+            if(!fuzzer_scene_attack_load_profile(app)) {
+                notification_message(app->notifications, &sequence_blink_red_100);
+            }
         }
         // Callback from worker
         else if(event.event == FuzzerCustomEventViewAttackEnd) {
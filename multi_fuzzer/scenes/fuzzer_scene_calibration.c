@@ -0,0 +1,305 @@
+#include "../fuzzer_i.h"
+#include "../helpers/fuzzer_custom_event.h"
+
+typedef enum {
+    FuzzerSceneCalibrationStateSignal = 0,
+    FuzzerSceneCalibrationStateTrial,
+    FuzzerSceneCalibrationStateVerdict,
+    FuzzerSceneCalibrationStateResult,
+} FuzzerSceneCalibrationState;
+
+static void fuzzer_scene_calibration_widget_callback(
+    GuiButtonType result,
+    InputType type,
+    void* context) {
+    furi_assert(context);
+    PacsFuzzerApp* app = context;
+
+    if(type == InputTypeShort) {
+        view_dispatcher_send_custom_event(app->view_dispatcher, result);
+    }
+}
+
+static void fuzzer_scene_calibration_worker_tick_callback(void* context) {
+    furi_assert(context);
+    PacsFuzzerApp* app = context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, FuzzerCustomEventCalibrationCycle);
+}
+
+static void fuzzer_scene_calibration_gpio_callback(void* context) {
+    PacsFuzzerApp* app = context;
+    app->calibration.signals++;
+}
+
+static void fuzzer_scene_calibration_gpio_init(PacsFuzzerApp* app) {
+    furi_hal_gpio_init(
+        FUZZER_CALIBRATION_GPIO, GpioModeInterruptFall, GpioPullUp, GpioSpeedVeryHigh);
+    furi_hal_gpio_add_int_callback(
+        FUZZER_CALIBRATION_GPIO, fuzzer_scene_calibration_gpio_callback, app);
+}
+
+static void fuzzer_scene_calibration_gpio_deinit(PacsFuzzerApp* app) {
+    if(app->calibration.use_gpio) {
+        furi_hal_gpio_remove_int_callback(FUZZER_CALIBRATION_GPIO);
+        furi_hal_gpio_init_simple(FUZZER_CALIBRATION_GPIO, GpioModeAnalog);
+        app->calibration.use_gpio = false;
+    }
+}
+
+static void fuzzer_scene_calibration_set_state(
+    PacsFuzzerApp* app,
+    FuzzerSceneCalibrationState state) {
+    scene_manager_set_scene_state(app->scene_manager, FuzzerSceneCalibration, state);
+}
+
+static void fuzzer_scene_calibration_show_signal(PacsFuzzerApp* app) {
+    Widget* widget = app->widget;
+    widget_reset(widget);
+
+    widget_add_string_element(
+        widget, 64, 5, AlignCenter, AlignCenter, FontPrimary, "Timing Calibration");
+    widget_add_string_multiline_element(
+        widget,
+        64,
+        30,
+        AlignCenter,
+        AlignCenter,
+        FontSecondary,
+        "Current UID must open\nthe reader. Accept signal:\nconfirm or GND on pin 2");
+    widget_add_button_element(
+        widget, GuiButtonTypeLeft, "Confirm", fuzzer_scene_calibration_widget_callback, app);
+    widget_add_button_element(
+        widget, GuiButtonTypeRight, "GPIO", fuzzer_scene_calibration_widget_callback, app);
+}
+
+static void fuzzer_scene_calibration_show_trial(
+    PacsFuzzerApp* app,
+    uint8_t idle_time,
+    uint8_t emu_time) {
+    Widget* widget = app->widget;
+    widget_reset(widget);
+
+    FuriString* str = furi_string_alloc_printf(
+        "EmT: %d.%d TD: %d.%d\nReplaying %d times",
+        emu_time / 10,
+        emu_time % 10,
+        idle_time / 10,
+        idle_time % 10,
+        FUZZER_CALIBRATION_CYCLES);
+
+    widget_add_string_element(
+        widget, 64, 5, AlignCenter, AlignCenter, FontPrimary, "Calibrating...");
+    widget_add_string_multiline_element(
+        widget, 64, 30, AlignCenter, AlignCenter, FontSecondary, furi_string_get_cstr(str));
+    furi_string_free(str);
+}
+
+static void fuzzer_scene_calibration_show_verdict(PacsFuzzerApp* app) {
+    Widget* widget = app->widget;
+    widget_reset(widget);
+
+    widget_add_string_multiline_element(
+        widget,
+        64,
+        22,
+        AlignCenter,
+        AlignCenter,
+        FontPrimary,
+        "Did the reader accept\nevery replay?");
+    widget_add_button_element(
+        widget, GuiButtonTypeLeft, "No", fuzzer_scene_calibration_widget_callback, app);
+    widget_add_button_element(
+        widget, GuiButtonTypeRight, "Yes", fuzzer_scene_calibration_widget_callback, app);
+}
+
+static void fuzzer_scene_calibration_show_result(PacsFuzzerApp* app) {
+    Widget* widget = app->widget;
+    widget_reset(widget);
+    FuzzerCalibration* calibration = &app->calibration;
+
+    if(calibration->stage == FuzzerCalibrationStageDone) {
+        FuriString* str = furi_string_alloc_printf(
+            "EmT: %d.%d TD: %d.%d",
+            calibration->emu_time / 10,
+            calibration->emu_time % 10,
+            calibration->idle_time / 10,
+            calibration->idle_time % 10);
+
+        widget_add_string_element(
+            widget, 64, 5, AlignCenter, AlignCenter, FontPrimary, "Fastest Timings");
+        widget_add_string_element(
+            widget, 64, 26, AlignCenter, AlignCenter, FontSecondary, furi_string_get_cstr(str));
+        widget_add_button_element(
+            widget, GuiButtonTypeLeft, "Use", fuzzer_scene_calibration_widget_callback, app);
+        widget_add_button_element(
+            widget, GuiButtonTypeRight, "Save", fuzzer_scene_calibration_widget_callback, app);
+        furi_string_free(str);
+    } else {
+        widget_add_string_element(
+            widget, 64, 5, AlignCenter, AlignCenter, FontPrimary, "Calibration Failed");
+        widget_add_string_multiline_element(
+            widget,
+            64,
+            30,
+            AlignCenter,
+            AlignCenter,
+            FontSecondary,
+            "Reader rejected the UID\nwith the initial timings");
+        widget_add_button_element(
+            widget, GuiButtonTypeLeft, "Back", fuzzer_scene_calibration_widget_callback, app);
+    }
+}
+
+static void fuzzer_scene_calibration_next_trial(PacsFuzzerApp* app) {
+    FuzzerCalibration* calibration = &app->calibration;
+
+    if(calibration->stage == FuzzerCalibrationStageDone ||
+       calibration->stage == FuzzerCalibrationStageFail) {
+        fuzzer_scene_calibration_gpio_deinit(app);
+        notification_message(app->notifications, &sequence_blink_stop);
+        notification_message(app->notifications, &sequence_single_vibro);
+        fuzzer_scene_calibration_set_state(app, FuzzerSceneCalibrationStateResult);
+        fuzzer_scene_calibration_show_result(app);
+        return;
+    }
+
+    uint8_t idle_time, emu_time;
+    fuzzer_calibration_get_trial(calibration, &idle_time, &emu_time);
+
+    calibration->cycles = 0;
+    calibration->accepted = 0;
+    calibration->signals = 0;
+
+    fuzzer_scene_calibration_set_state(app, FuzzerSceneCalibrationStateTrial);
+    fuzzer_scene_calibration_show_trial(app, idle_time, emu_time);
+    notification_message(app->notifications, &sequence_blink_start_blue);
+
+    fuzzer_worker_start_replay(app->worker, idle_time, emu_time);
+}
+
+static void fuzzer_scene_calibration_on_cycle(PacsFuzzerApp* app) {
+    FuzzerCalibration* calibration = &app->calibration;
+
+    // Signals of the previous replay are counted when the next one starts
+    if(calibration->signals) {
+        calibration->accepted++;
+        calibration->signals = 0;
+    }
+
+    if(++calibration->cycles < FUZZER_CALIBRATION_CYCLES) {
+        return;
+    }
+
+    fuzzer_worker_pause(app->worker);
+
+    if(calibration->use_gpio) {
+        fuzzer_calibration_set_result(
+            calibration, calibration->accepted >= FUZZER_CALIBRATION_CYCLES);
+        fuzzer_scene_calibration_next_trial(app);
+    } else {
+        notification_message(app->notifications, &sequence_blink_stop);
+        fuzzer_scene_calibration_set_state(app, FuzzerSceneCalibrationStateVerdict);
+        fuzzer_scene_calibration_show_verdict(app);
+    }
+}
+
+void fuzzer_scene_calibration_on_enter(void* context) {
+    furi_assert(context);
+    PacsFuzzerApp* app = context;
+
+    fuzzer_worker_set_uid_chaged_callback(
+        app->worker, fuzzer_scene_calibration_worker_tick_callback, app);
+
+    if(scene_manager_get_scene_state(app->scene_manager, FuzzerSceneCalibration) ==
+       FuzzerSceneCalibrationStateResult) {
+        // Back from naming the profile
+        fuzzer_scene_calibration_show_result(app);
+    } else {
+        fuzzer_calibration_reset(
+            &app->calibration,
+            fuzzer_view_attack_get_time_delay(app->attack_view),
+            fuzzer_view_attack_get_emu_time(app->attack_view),
+            fuzzer_view_attack_get_emu_time_min(app->attack_view));
+        app->calibration.use_gpio = false;
+
+        fuzzer_scene_calibration_set_state(app, FuzzerSceneCalibrationStateSignal);
+        fuzzer_scene_calibration_show_signal(app);
+    }
+
+    view_dispatcher_switch_to_view(app->view_dispatcher, FuzzerViewIDWidget);
+}
+
+bool fuzzer_scene_calibration_on_event(void* context, SceneManagerEvent event) {
+    furi_assert(context);
+    PacsFuzzerApp* app = context;
+    bool consumed = false;
+
+    if(event.type != SceneManagerEventTypeCustom) {
+        return consumed;
+    }
+
+    FuzzerCalibration* calibration = &app->calibration;
+
+    switch(scene_manager_get_scene_state(app->scene_manager, FuzzerSceneCalibration)) {
+    case FuzzerSceneCalibrationStateSignal:
+        if(event.event == GuiButtonTypeLeft || event.event == GuiButtonTypeRight) {
+            if(event.event == GuiButtonTypeRight) {
+                fuzzer_scene_calibration_gpio_init(app);
+                calibration->use_gpio = true;
+            }
+            fuzzer_scene_calibration_next_trial(app);
+            consumed = true;
+        }
+        break;
+
+    case FuzzerSceneCalibrationStateTrial:
+        if(event.event == FuzzerCustomEventCalibrationCycle) {
+            fuzzer_scene_calibration_on_cycle(app);
+            consumed = true;
+        }
+        break;
+
+    case FuzzerSceneCalibrationStateVerdict:
+        if(event.event == GuiButtonTypeLeft || event.event == GuiButtonTypeRight) {
+            fuzzer_calibration_set_result(calibration, event.event == GuiButtonTypeRight);
+            fuzzer_scene_calibration_next_trial(app);
+            consumed = true;
+        }
+        break;
+
+    case FuzzerSceneCalibrationStateResult:
+        if(event.event == GuiButtonTypeLeft) {
+            if(calibration->stage == FuzzerCalibrationStageDone) {
+                fuzzer_view_attack_set_timings(
+                    app->attack_view, calibration->idle_time, calibration->emu_time);
+            }
+            scene_manager_previous_scene(app->scene_manager);
+            consumed = true;
+        } else if(event.event == GuiButtonTypeRight) {
+            fuzzer_view_attack_set_timings(
+                app->attack_view, calibration->idle_time, calibration->emu_time);
+            scene_manager_set_scene_state(
+                app->scene_manager, FuzzerSceneSaveName, FuzzerSaveNameStateProfile);
+            scene_manager_next_scene(app->scene_manager, FuzzerSceneSaveName);
+            consumed = true;
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return consumed;
+}
+
+void fuzzer_scene_calibration_on_exit(void* context) {
+    furi_assert(context);
+    PacsFuzzerApp* app = context;
+
+    fuzzer_worker_pause(app->worker);
+    fuzzer_worker_set_uid_chaged_callback(app->worker, NULL, NULL);
+    fuzzer_scene_calibration_gpio_deinit(app);
+    notification_message(app->notifications, &sequence_blink_stop);
+
+    widget_reset(app->widget);
+}
@@ -2,4 +2,5 @@ ADD_SCENE(fuzzer, main, Main)
 ADD_SCENE(fuzzer, attack, Attack)
 ADD_SCENE(fuzzer, field_editor, FieldEditor)
 ADD_SCENE(fuzzer, save_name, SaveName)
-ADD_SCENE(fuzzer, save_success, SaveSuccess)
\ No newline at end of file
+ADD_SCENE(fuzzer, save_success, SaveSuccess)
+ADD_SCENE(fuzzer, calibration, Calibration)
\ No newline at end of file
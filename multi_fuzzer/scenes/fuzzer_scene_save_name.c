@@ -11,10 +11,21 @@ static void fuzzer_scene_save_name_text_input_callback(void* context) {
 void fuzzer_scene_save_name_on_enter(void* context) {
     PacsFuzzerApp* app = context;
     TextInput* text_input = app->text_input;
+    bool profile = scene_manager_get_scene_state(app->scene_manager, FuzzerSceneSaveName) ==
+                   FuzzerSaveNameStateProfile;
 
-    name_generator_make_auto(app->key_name, KEY_NAME_SIZE, app->fuzzer_const->file_prefix);
+    const char* folder = profile ? FUZZER_PROFILE_FOLDER : app->fuzzer_const->path_key_folder;
+    const char* extension = profile ? FUZZER_PROFILE_EXTENSION :
+                                      app->fuzzer_const->key_extension;
+
+    if(profile) {
+        name_generator_make_auto(app->key_name, KEY_NAME_SIZE, "Reader");
+        text_input_set_header_text(text_input, "Name the reader");
+    } else {
+        name_generator_make_auto(app->key_name, KEY_NAME_SIZE, app->fuzzer_const->file_prefix);
+        text_input_set_header_text(text_input, "Name the key");
+    }
 
-    text_input_set_header_text(text_input, "Name the key");
     text_input_set_result_callback(
         text_input,
         fuzzer_scene_save_name_text_input_callback,
@@ -23,8 +34,8 @@ void fuzzer_scene_save_name_on_enter(void* context) {
         KEY_NAME_SIZE,
         true);
 
-    ValidatorIsFile* validator_is_file = validator_is_file_alloc_init(
-        app->fuzzer_const->path_key_folder, app->fuzzer_const->key_extension, app->key_name);
+    ValidatorIsFile* validator_is_file =
+        validator_is_file_alloc_init(folder, extension, app->key_name);
     text_input_set_validator(text_input, validator_is_file_callback, validator_is_file);
 
     view_dispatcher_switch_to_view(app->view_dispatcher, FuzzerViewIDTextInput);
@@ -37,14 +48,33 @@ bool fuzzer_scene_save_name_on_event(void* context, SceneManagerEvent event) {
     if(event.type == SceneManagerEventTypeCustom) {
         if(event.event == FuzzerCustomEventTextEditResult) {
             consumed = true;
-            furi_string_printf(
-                app->file_path,
-                "%s/%s%s",
-                app->fuzzer_const->path_key_folder,
-                app->key_name,
-                app->fuzzer_const->key_extension);
-
-            if(fuzzer_worker_save_key(app->worker, furi_string_get_cstr(app->file_path))) {
+            bool saved;
+
+            if(scene_manager_get_scene_state(app->scene_manager, FuzzerSceneSaveName) ==
+               FuzzerSaveNameStateProfile) {
+                furi_string_printf(
+                    app->file_path,
+                    "%s/%s%s",
+                    FUZZER_PROFILE_FOLDER,
+                    app->key_name,
+                    FUZZER_PROFILE_EXTENSION);
+                saved = fuzzer_timing_profile_save(
+                    furi_string_get_cstr(app->file_path),
+                    fuzzer_proto_get_name(app->fuzzer_state.proto_index),
+                    app->calibration.idle_time,
+                    app->calibration.emu_time);
+            } else {
+                furi_string_printf(
+                    app->file_path,
+                    "%s/%s%s",
+                    app->fuzzer_const->path_key_folder,
+                    app->key_name,
+                    app->fuzzer_const->key_extension);
+                saved =
+                    fuzzer_worker_save_key(app->worker, furi_string_get_cstr(app->file_path));
+            }
+
+            if(saved) {
                 scene_manager_next_scene(app->scene_manager, FuzzerSceneSaveSuccess);
             } else {
                 scene_manager_previous_scene(app->scene_manager);
@@ -261,6 +261,12 @@ static bool fuzzer_view_attack_input_idle(
     } else if(event->key == InputKeyOk && event->type == InputTypeShort) {
         view_attack->callback(FuzzerCustomEventViewAttackRunAttack, view_attack->context);
         return true;
+    } else if(event->key == InputKeyOk && event->type == InputTypeLong) {
+        view_attack->callback(FuzzerCustomEventViewAttackCalibrate, view_attack->context);
+        return true;
+    } else if(event->key == InputKeyUp && event->type == InputTypeLong) {
+        view_attack->callback(FuzzerCustomEventViewAttackLoadProfile, view_attack->context);
+        return true;
     } else if(event->key == InputKeyLeft) {
         if(!model->td_emt_cursor) {
             // TimeDelay --
@@ -492,4 +498,33 @@ uint8_t fuzzer_view_attack_get_emu_time(FuzzerViewAttack* view) {
         view->view, FuzzerViewAttackModel * model, { emu_time = model->emu_time; }, false);
 
     return emu_time;
+}
+
+uint8_t fuzzer_view_attack_get_emu_time_min(FuzzerViewAttack* view) {
+    furi_assert(view);
+    uint8_t emu_time_min;
+
+    with_view_model(
+        view->view,
+        FuzzerViewAttackModel * model,
+        { emu_time_min = model->emu_time_min; },
+        false);
+
+    return emu_time_min;
+}
+
+void fuzzer_view_attack_set_timings(
+    FuzzerViewAttack* view,
+    uint8_t time_delay,
+    uint8_t emu_time) {
+    furi_assert(view);
+
+    with_view_model(
+        view->view,
+        FuzzerViewAttackModel * model,
+        {
+            model->time_delay = CLAMP(time_delay, FUZZ_TIME_DELAY_MAX, model->time_delay_min);
+            model->emu_time = CLAMP(emu_time, FUZZ_TIME_DELAY_MAX, model->emu_time_min);
+        },
+        true);
 }
\ No newline at end of file
@@ -33,4 +33,8 @@ void fuzzer_view_update_state(FuzzerViewAttack* view, FuzzerAttackState state);
 
 uint8_t fuzzer_view_attack_get_time_delay(FuzzerViewAttack* view);
 
-uint8_t fuzzer_view_attack_get_emu_time(FuzzerViewAttack* view);
\ No newline at end of file
+uint8_t fuzzer_view_attack_get_emu_time(FuzzerViewAttack* view);
+
+uint8_t fuzzer_view_attack_get_emu_time_min(FuzzerViewAttack* view);
+
+void fuzzer_view_attack_set_timings(FuzzerViewAttack* view, uint8_t time_delay, uint8_t emu_time);
\ No newline at end of file
@@ -16,10 +16,15 @@
 #define MUSIC_PLAYER_EXAMPLE_FILE "Marble_Machine.fmf"
 
 #define MUSIC_PLAYER_SEMITONE_HISTORY_SIZE 4
+// Notes can be much shorter than a frame, redraw at most this often
+#define MUSIC_PLAYER_FRAME_PERIOD_MS 40
 
 typedef struct {
+    // Ring buffer, the newest note is at history_head
     uint8_t semitone_history[MUSIC_PLAYER_SEMITONE_HISTORY_SIZE];
     uint8_t duration_history[MUSIC_PLAYER_SEMITONE_HISTORY_SIZE];
+    uint8_t history_head;
+    bool dirty;
 
     uint8_t volume;
     uint8_t semitone;
@@ -36,6 +41,7 @@ typedef struct {
 
     ViewPort* view_port;
     Gui* gui;
+    FuriTimer* redraw_timer;
 
     MusicWorker* worker;
 } MusicPlayer;
@@ -190,10 +196,11 @@ static void render_callback(Canvas* canvas, void* ctx) {
 
     char duration_text[16];
     for(uint8_t i = 0; i < MUSIC_PLAYER_SEMITONE_HISTORY_SIZE; i++) {
-        if(music_player->model->duration_history[i] == 0xFF) {
+        uint8_t r = (music_player->model->history_head + i) % MUSIC_PLAYER_SEMITONE_HISTORY_SIZE;
+        if(music_player->model->duration_history[r] == 0xFF) {
             snprintf(duration_text, 15, "--");
         } else {
-            snprintf(duration_text, 15, "%d", music_player->model->duration_history[i]);
+            snprintf(duration_text, 15, "%d", music_player->model->duration_history[r]);
         }
 
         if(i == 0) {
@@ -206,7 +213,7 @@ static void render_callback(Canvas* canvas, void* ctx) {
             canvas,
             x_pos + 4,
             64 - 16 * i - 3,
-            semitone_to_note(music_player->model->semitone_history[i]));
+            semitone_to_note(music_player->model->semitone_history[r]));
         canvas_draw_str(canvas, x_pos + 31, 64 - 16 * i - 3, duration_text);
         canvas_draw_line(canvas, x_pos, 64 - 16 * i, x_pos + 48, 64 - 16 * i);
     }
@@ -230,11 +237,10 @@ static void music_worker_callback(
     MusicPlayer* music_player = context;
     furi_check(furi_mutex_acquire(music_player->model_mutex, FuriWaitForever) == FuriStatusOk);
 
-    for(size_t i = 0; i < MUSIC_PLAYER_SEMITONE_HISTORY_SIZE - 1; i++) {
-        size_t r = MUSIC_PLAYER_SEMITONE_HISTORY_SIZE - 1 - i;
-        music_player->model->duration_history[r] = music_player->model->duration_history[r - 1];
-        music_player->model->semitone_history[r] = music_player->model->semitone_history[r - 1];
-    }
+    // Step the ring head back instead of shifting the whole history
+    uint8_t head = music_player->model->history_head;
+    head = (head + MUSIC_PLAYER_SEMITONE_HISTORY_SIZE - 1) % MUSIC_PLAYER_SEMITONE_HISTORY_SIZE;
+    music_player->model->history_head = head;
 
     semitone = (semitone == 0xFF) ? 0xFF : semitone % 12;
 
@@ -243,16 +249,29 @@ static void music_worker_callback(
     music_player->model->duration = duration;
     music_player->model->position = position;
 
-    music_player->model->semitone_history[0] = semitone;
-    music_player->model->duration_history[0] = duration;
+    music_player->model->semitone_history[head] = semitone;
+    music_player->model->duration_history[head] = duration;
+    music_player->model->dirty = true;
 
+    // Drawing is left to redraw_timer_callback, the worker thread must not wait on the GUI
     furi_mutex_release(music_player->model_mutex);
-    view_port_update(music_player->view_port);
+}
+
+static void redraw_timer_callback(void* context) {
+    MusicPlayer* music_player = context;
+    furi_check(furi_mutex_acquire(music_player->model_mutex, FuriWaitForever) == FuriStatusOk);
+    bool dirty = music_player->model->dirty;
+    music_player->model->dirty = false;
+    furi_mutex_release(music_player->model_mutex);
+
+    if(dirty) view_port_update(music_player->view_port);
 }
 
 void music_player_clear(MusicPlayer* instance) {
     memset(instance->model->duration_history, 0xff, MUSIC_PLAYER_SEMITONE_HISTORY_SIZE);
     memset(instance->model->semitone_history, 0xff, MUSIC_PLAYER_SEMITONE_HISTORY_SIZE);
+    instance->model->history_head = 0;
+    instance->model->dirty = true;
     music_worker_clear(instance->worker);
 }
 
@@ -261,6 +280,8 @@ MusicPlayer* music_player_alloc() {
 
     instance->model = malloc(sizeof(MusicPlayerModel));
     instance->model->volume = 3;
+    instance->model->history_head = 0;
+    instance->model->dirty = false;
 
     instance->model_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
 
@@ -280,10 +301,17 @@ MusicPlayer* music_player_alloc() {
     instance->gui = furi_record_open(RECORD_GUI);
     gui_add_view_port(instance->gui, instance->view_port, GuiLayerFullscreen);
 
+    instance->redraw_timer =
+        furi_timer_alloc(redraw_timer_callback, FuriTimerTypePeriodic, instance);
+    furi_timer_start(instance->redraw_timer, furi_ms_to_ticks(MUSIC_PLAYER_FRAME_PERIOD_MS));
+
     return instance;
 }
 
 void music_player_free(MusicPlayer* instance) {
+    furi_timer_stop(instance->redraw_timer);
+    furi_timer_free(instance->redraw_timer);
+
     gui_remove_view_port(instance->gui, instance->view_port);
     furi_record_close(RECORD_GUI);
     view_port_free(instance->view_port);
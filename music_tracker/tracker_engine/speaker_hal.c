@@ -4,23 +4,23 @@
 #define FURI_HAL_SPEAKER_CHANNEL LL_TIM_CHANNEL_CH1
 #define FURI_HAL_SPEAKER_PRESCALER 500
 
-void tracker_speaker_play(float frequency, float pwm) {
-    uint32_t autoreload = (SystemCoreClock / FURI_HAL_SPEAKER_PRESCALER / frequency) - 1;
-    if(autoreload < 2) {
+uint16_t tracker_speaker_autoreload(uint32_t frequency) {
+    if(frequency == 0) return UINT16_MAX;
+
+    uint32_t autoreload =
+        ((SystemCoreClock / FURI_HAL_SPEAKER_PRESCALER) << TRACKER_FREQUENCY_SHIFT) / frequency;
+    if(autoreload < 3) {
         autoreload = 2;
     } else if(autoreload > UINT16_MAX) {
         autoreload = UINT16_MAX;
+    } else {
+        autoreload -= 1;
     }
 
-    if(pwm < 0) pwm = 0;
-    if(pwm > 1) pwm = 1;
-
-    uint32_t compare_value = pwm * autoreload;
-
-    if(compare_value == 0) {
-        compare_value = 1;
-    }
+    return autoreload;
+}
 
+void tracker_speaker_play(uint16_t autoreload, uint16_t compare_value) {
     if(LL_TIM_OC_GetCompareCH1(FURI_HAL_SPEAKER_TIMER) != compare_value) {
         LL_TIM_OC_SetCompareCH1(FURI_HAL_SPEAKER_TIMER, compare_value);
     }
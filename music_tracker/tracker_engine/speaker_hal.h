@@ -1,10 +1,15 @@
 #include <furi_hal.h>
 
+// Frequencies are fixed point, 1 Hz = 1 << TRACKER_FREQUENCY_SHIFT
+#define TRACKER_FREQUENCY_SHIFT 8
+
 void tracker_speaker_init();
 
 void tracker_speaker_deinit();
 
-void tracker_speaker_play(float frequency, float pwm);
+uint16_t tracker_speaker_autoreload(uint32_t frequency);
+
+void tracker_speaker_play(uint16_t autoreload, uint16_t compare);
 
 void tracker_speaker_stop();
 
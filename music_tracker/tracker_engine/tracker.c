@@ -15,18 +15,29 @@ typedef struct {
     int8_t value;
 } IntegerOscillator;
 
+// Channels share the speaker, it is switched between playing channels this many times per tick
+#define TRACKER_MUX_DIVIDER 16
+
+#define PWM_TO_Q16(pwm) ((uint32_t)((pwm)*65536.0f))
+
 typedef struct {
-    float frequency;
-    float frequency_target;
-    float pwm;
+    int32_t frequency; // 1/256 Hz, see TRACKER_FREQUENCY_SHIFT
+    int32_t frequency_target;
+    uint32_t pwm; // duty cycle, Q16
     bool play;
     IntegerOscillator vibrato;
+
+    // speaker settings for the current tick, replayed by the multiplexer
+    uint16_t autoreload;
+    uint16_t compare;
 } ChannelState;
 
 typedef struct {
     ChannelState* channels;
     uint8_t tick;
     uint8_t tick_limit;
+    uint8_t mux_tick;
+    uint8_t mux_channel;
 
     uint8_t pattern_index;
     uint8_t row_index;
@@ -50,17 +61,21 @@ struct Tracker {
 static void channels_state_init(ChannelState* channel) {
     channel->frequency = 0;
     channel->frequency_target = FREQUENCY_UNSET;
-    channel->pwm = PWM_DEFAULT;
+    channel->pwm = PWM_TO_Q16(PWM_DEFAULT);
     channel->play = false;
     channel->vibrato.speed = 0;
     channel->vibrato.depth = 0;
     channel->vibrato.direction = 0;
     channel->vibrato.value = 0;
+    channel->autoreload = 0;
+    channel->compare = 0;
 }
 
 static void tracker_song_state_init(Tracker* tracker) {
     tracker->song_state.tick = 0;
     tracker->song_state.tick_limit = 2;
+    tracker->song_state.mux_tick = 0;
+    tracker->song_state.mux_channel = 0;
     tracker->song_state.row_index = 0;
     tracker->song_state.order_list_index = 0;
     tracker->song_state.pattern_index = tracker->song->order_list[0];
@@ -95,35 +110,52 @@ static uint8_t record_get_effect_data(Row note) {
 }
 
 #define NOTES_PER_OCT 12
-const float notes_oct[NOTES_PER_OCT] = {
-    130.813f,
-    138.591f,
-    146.832f,
-    155.563f,
-    164.814f,
-    174.614f,
-    184.997f,
-    195.998f,
-    207.652f,
-    220.00f,
-    233.082f,
-    246.942f,
+// Octave 2, 1/256 Hz
+static const int32_t notes_oct[NOTES_PER_OCT] = {
+    33488, // 130.813 Hz
+    35479, // 138.591 Hz
+    37589, // 146.832 Hz
+    39824, // 155.563 Hz
+    42192, // 164.814 Hz
+    44701, // 174.614 Hz
+    47359, // 184.997 Hz
+    50175, // 195.998 Hz
+    53159, // 207.652 Hz
+    56320, // 220.000 Hz
+    59669, // 233.082 Hz
+    63217, // 246.942 Hz
+};
+
+// 2^(n/12), Q16, for arpeggio offsets 0..7 semitones
+static const uint32_t semitone_ratio[EFFECT_DATA_2_MAX + 1] = {
+    65536, 69433, 73562, 77936, 82570, 87480, 92682, 98193,
 };
 
-static float note_to_freq(uint8_t note) {
-    if(note == NOTE_NONE) return 0.0f;
+// 2^(n/84), Q16, for vibrato offsets in 1/7 of a semitone. The oscillator value can
+// overshoot the depth by one speed step, so the table covers -14..14.
+#define DETUNE_MAX (EFFECT_DATA_2_MAX * 2)
+static const uint32_t detune_ratio[DETUNE_MAX * 2 + 1] = {
+    58386, 58870, 59358, 59849, 60345, 60845, 61349, 61858, 62370, 62887,
+    63408, 63934, 64463, 64997, 65536, 66079, 66627, 67179, 67735, 68296,
+    68862, 69433, 70008, 70588, 71173, 71763, 72358, 72957, 73562,
+};
+
+static int32_t note_to_freq(uint8_t note) {
+    if(note == NOTE_NONE) return 0;
     note = note - NOTE_C2;
     uint8_t octave = note / NOTES_PER_OCT;
     uint8_t note_in_oct = note % NOTES_PER_OCT;
-    return notes_oct[note_in_oct] * (1 << octave);
+    return notes_oct[note_in_oct] << octave;
 }
 
-static float frequency_offset_semitones(float frequency, uint8_t semitones) {
-    return frequency * (1.0f + ((1.0f / 12.0f) * semitones));
+static int32_t frequency_offset_semitones(int32_t frequency, uint8_t semitones) {
+    return ((uint64_t)frequency * semitone_ratio[semitones]) >> 16;
 }
 
-static float frequency_get_seventh_of_a_semitone(float frequency) {
-    return frequency * ((1.0f / 12.0f) / 7.0f);
+static int32_t frequency_detune_sevenths(int32_t frequency, int8_t sevenths) {
+    if(sevenths > DETUNE_MAX) sevenths = DETUNE_MAX;
+    if(sevenths < -DETUNE_MAX) sevenths = -DETUNE_MAX;
+    return ((uint64_t)frequency * detune_ratio[sevenths + DETUNE_MAX]) >> 16;
 }
 
 static UnpackedRow get_current_row(const Song* song, SongState* song_state, uint8_t channel) {
@@ -196,22 +228,14 @@ static void advance_to_pattern(Tracker* tracker, Location advance) {
     tracker_send_position_message(tracker);
 }
 
-static void tracker_interrupt_body(Tracker* tracker) {
-    if(!tracker->playing) {
-        tracker_speaker_stop();
-        return;
-    }
-
-    const uint8_t channel_index = 0;
+// Pattern flow effects are taken from the first channel that has one
+static void tracker_handle_flow_effects(Tracker* tracker) {
     SongState* song_state = &tracker->song_state;
-    ChannelState* channel_state = &song_state->channels[channel_index];
     const Song* song = tracker->song;
-    UnpackedRow row = get_current_row(song, song_state, channel_index);
 
-    // load frequency from note at tick 0
-    if(song_state->tick == 0) {
-        bool invalidate_row = false;
-        // handle "on first tick" effects
+    for(uint8_t i = 0; i < song->channels_count; i++) {
+        UnpackedRow row = get_current_row(song, song_state, i);
+
         if(row.effect == EffectBreakPattern) {
             int16_t next_row_index = row.data;
             int16_t next_pattern_index =
@@ -224,8 +248,7 @@ static void tracker_interrupt_body(Tracker* tracker) {
                     .change_pattern = true,
                     .change_row = true,
                 });
-
-            invalidate_row = true;
+            break;
         }
 
         if(row.effect == EffectJumpToOrder) {
@@ -238,24 +261,28 @@ static void tracker_interrupt_body(Tracker* tracker) {
                     .pattern = next_pattern_index,
                     .change_pattern = true,
                 });
-
-            invalidate_row = true;
-        }
-
-        // tracker state can be affected by effects
-        if(!tracker->playing) {
-            tracker_speaker_stop();
-            return;
+            break;
         }
+    }
 
-        if(invalidate_row) {
-            row = get_current_row(song, song_state, channel_index);
+    // tracker state can be affected by effects
+    if(!tracker->playing) return;
 
-            if(row.effect == EffectSetSpeed) {
-                song_state->tick_limit = row.data;
-            }
+    for(uint8_t i = 0; i < song->channels_count; i++) {
+        UnpackedRow row = get_current_row(song, song_state, i);
+        if(row.effect == EffectSetSpeed) {
+            song_state->tick_limit = row.data;
         }
+    }
+}
 
+static void tracker_channel_tick(Tracker* tracker, uint8_t channel_index) {
+    SongState* song_state = &tracker->song_state;
+    ChannelState* channel_state = &song_state->channels[channel_index];
+    UnpackedRow row = get_current_row(tracker->song, song_state, channel_index);
+
+    // load frequency from note at tick 0
+    if(song_state->tick == 0) {
         // handle note effects
         if(row.note == NOTE_OFF) {
             channel_state->play = false;
@@ -269,7 +296,7 @@ static void tracker_interrupt_body(Tracker* tracker) {
             channel_state->vibrato.direction = 0;
 
             // reset pwm
-            channel_state->pwm = PWM_DEFAULT;
+            channel_state->pwm = PWM_TO_Q16(PWM_DEFAULT);
 
             if(row.effect == EffectSlideToNote) {
                 channel_state->frequency_target = note_to_freq(row.note);
@@ -280,78 +307,99 @@ static void tracker_interrupt_body(Tracker* tracker) {
         }
     }
 
-    if(channel_state->play) {
-        float frequency, pwm;
-
-        if((row.effect == EffectSlideUp || row.effect == EffectSlideDown) &&
-           row.data != EFFECT_DATA_NONE) {
-            // apply slide effect
-            channel_state->frequency += (row.effect == EffectSlideUp ? 1 : -1) * row.data;
-        } else if(row.effect == EffectSlideToNote) {
-            // apply slide to note effect, if target frequency is set
-            if(channel_state->frequency_target > 0) {
-                if(channel_state->frequency_target > channel_state->frequency) {
-                    channel_state->frequency += row.data;
-                    if(channel_state->frequency > channel_state->frequency_target) {
-                        channel_state->frequency = channel_state->frequency_target;
-                        channel_state->frequency_target = FREQUENCY_UNSET;
-                    }
-                } else if(channel_state->frequency_target < channel_state->frequency) {
-                    channel_state->frequency -= row.data;
-                    if(channel_state->frequency < channel_state->frequency_target) {
-                        channel_state->frequency = channel_state->frequency_target;
-                        channel_state->frequency_target = FREQUENCY_UNSET;
-                    }
+    if(!channel_state->play) return;
+
+    int32_t frequency;
+    uint32_t pwm;
+    int32_t step = (int32_t)row.data << TRACKER_FREQUENCY_SHIFT;
+
+    if((row.effect == EffectSlideUp || row.effect == EffectSlideDown) &&
+       row.data != EFFECT_DATA_NONE) {
+        // apply slide effect
+        channel_state->frequency += (row.effect == EffectSlideUp ? 1 : -1) * step;
+    } else if(row.effect == EffectSlideToNote) {
+        // apply slide to note effect, if target frequency is set
+        if(channel_state->frequency_target > 0) {
+            if(channel_state->frequency_target > channel_state->frequency) {
+                channel_state->frequency += step;
+                if(channel_state->frequency > channel_state->frequency_target) {
+                    channel_state->frequency = channel_state->frequency_target;
+                    channel_state->frequency_target = FREQUENCY_UNSET;
+                }
+            } else if(channel_state->frequency_target < channel_state->frequency) {
+                channel_state->frequency -= step;
+                if(channel_state->frequency < channel_state->frequency_target) {
+                    channel_state->frequency = channel_state->frequency_target;
+                    channel_state->frequency_target = FREQUENCY_UNSET;
                 }
             }
         }
+    }
 
-        frequency = channel_state->frequency;
-        pwm = channel_state->pwm;
-
-        // apply arpeggio effect
-        if(row.effect == EffectArpeggio) {
-            if(row.data != EFFECT_DATA_NONE) {
-                if((song_state->tick % 3) == 1) {
-                    uint8_t note_offset = EFFECT_DATA_GET_X(row.data);
-                    frequency = frequency_offset_semitones(frequency, note_offset);
-                } else if((song_state->tick % 3) == 2) {
-                    uint8_t note_offset = EFFECT_DATA_GET_Y(row.data);
-                    frequency = frequency_offset_semitones(frequency, note_offset);
-                }
-            }
-        } else if(row.effect == EffectVibrato) {
-            // apply vibrato effect, data = speed, depth
-            uint8_t vibrato_speed = EFFECT_DATA_GET_X(row.data);
-            uint8_t vibrato_depth = EFFECT_DATA_GET_Y(row.data);
-
-            // update vibrato parameters if speed or depth is non-zero
-            if(vibrato_speed != 0) channel_state->vibrato.speed = vibrato_speed;
-            if(vibrato_depth != 0) channel_state->vibrato.depth = vibrato_depth;
-
-            // update vibrato value
-            channel_state->vibrato.value +=
-                channel_state->vibrato.direction * channel_state->vibrato.speed;
-
-            // change direction if value is at the limit
-            if(channel_state->vibrato.value > channel_state->vibrato.depth) {
-                channel_state->vibrato.direction = -1;
-            } else if(channel_state->vibrato.value < -channel_state->vibrato.depth) {
-                channel_state->vibrato.direction = 1;
-            } else if(channel_state->vibrato.direction == 0) {
-                // set initial direction, if it is not set
-                channel_state->vibrato.direction = 1;
-            }
+    // sliding down must not go through zero
+    if(channel_state->frequency < (1 << TRACKER_FREQUENCY_SHIFT)) {
+        channel_state->frequency = 1 << TRACKER_FREQUENCY_SHIFT;
+    }
 
-            frequency +=
-                (frequency_get_seventh_of_a_semitone(frequency) * channel_state->vibrato.value);
-        } else if(row.effect == EffectPWM) {
-            pwm = (pwm - PWM_MIN) / EFFECT_DATA_1_MAX * row.data + PWM_MIN;
+    frequency = channel_state->frequency;
+    pwm = channel_state->pwm;
+
+    // apply arpeggio effect
+    if(row.effect == EffectArpeggio) {
+        if(row.data != EFFECT_DATA_NONE) {
+            if((song_state->tick % 3) == 1) {
+                uint8_t note_offset = EFFECT_DATA_GET_X(row.data);
+                frequency = frequency_offset_semitones(frequency, note_offset);
+            } else if((song_state->tick % 3) == 2) {
+                uint8_t note_offset = EFFECT_DATA_GET_Y(row.data);
+                frequency = frequency_offset_semitones(frequency, note_offset);
+            }
+        }
+    } else if(row.effect == EffectVibrato) {
+        // apply vibrato effect, data = speed, depth
+        uint8_t vibrato_speed = EFFECT_DATA_GET_X(row.data);
+        uint8_t vibrato_depth = EFFECT_DATA_GET_Y(row.data);
+
+        // update vibrato parameters if speed or depth is non-zero
+        if(vibrato_speed != 0) channel_state->vibrato.speed = vibrato_speed;
+        if(vibrato_depth != 0) channel_state->vibrato.depth = vibrato_depth;
+
+        // update vibrato value
+        channel_state->vibrato.value +=
+            channel_state->vibrato.direction * channel_state->vibrato.speed;
+
+        // change direction if value is at the limit
+        if(channel_state->vibrato.value > channel_state->vibrato.depth) {
+            channel_state->vibrato.direction = -1;
+        } else if(channel_state->vibrato.value < -channel_state->vibrato.depth) {
+            channel_state->vibrato.direction = 1;
+        } else if(channel_state->vibrato.direction == 0) {
+            // set initial direction, if it is not set
+            channel_state->vibrato.direction = 1;
         }
 
-        tracker_speaker_play(frequency, pwm);
-    } else {
-        tracker_speaker_stop();
+        frequency = frequency_detune_sevenths(frequency, channel_state->vibrato.value);
+    } else if(row.effect == EffectPWM) {
+        pwm = (pwm - PWM_TO_Q16(PWM_MIN)) * row.data / EFFECT_DATA_1_MAX + PWM_TO_Q16(PWM_MIN);
+    }
+
+    uint16_t autoreload = tracker_speaker_autoreload(frequency);
+    uint16_t compare = ((uint32_t)autoreload * pwm) >> 16;
+    channel_state->autoreload = autoreload;
+    channel_state->compare = compare == 0 ? 1 : compare;
+}
+
+static void tracker_tick(Tracker* tracker) {
+    SongState* song_state = &tracker->song_state;
+    const Song* song = tracker->song;
+
+    if(song_state->tick == 0) {
+        tracker_handle_flow_effects(tracker);
+        if(!tracker->playing) return;
+    }
+
+    for(uint8_t i = 0; i < song->channels_count; i++) {
+        tracker_channel_tick(tracker, i);
     }
 
     song_state->tick++;
@@ -376,6 +424,49 @@ static void tracker_interrupt_body(Tracker* tracker) {
     }
 }
 
+// Hand the speaker to the next playing channel, round robin
+static void tracker_mux_step(Tracker* tracker) {
+    SongState* song_state = &tracker->song_state;
+    uint8_t channels_count = tracker->song->channels_count;
+
+    for(uint8_t i = 1; i <= channels_count; i++) {
+        uint8_t channel_index = (song_state->mux_channel + i) % channels_count;
+        ChannelState* channel_state = &song_state->channels[channel_index];
+        if(channel_state->play) {
+            song_state->mux_channel = channel_index;
+            tracker_speaker_play(channel_state->autoreload, channel_state->compare);
+            return;
+        }
+    }
+
+    tracker_speaker_stop();
+}
+
+static void tracker_interrupt_body(Tracker* tracker) {
+    if(!tracker->playing) {
+        tracker_speaker_stop();
+        return;
+    }
+
+    SongState* song_state = &tracker->song_state;
+
+    // song ticks run at every TRACKER_MUX_DIVIDER interrupt, the others only switch channels
+    if(song_state->mux_tick == 0) {
+        tracker_tick(tracker);
+        if(!tracker->playing) {
+            tracker_speaker_stop();
+            return;
+        }
+    }
+
+    song_state->mux_tick++;
+    if(song_state->mux_tick >= TRACKER_MUX_DIVIDER) {
+        song_state->mux_tick = 0;
+    }
+
+    tracker_mux_step(tracker);
+}
+
 static void tracker_interrupt_cb(void* context) {
     Tracker* tracker = (Tracker*)context;
     tracker_debug_set(true);
@@ -429,7 +520,8 @@ void tracker_start(Tracker* tracker) {
     tracker_send_position_message(tracker);
     tracker_debug_init();
     tracker_speaker_init();
-    tracker_interrupt_init(tracker->song->ticks_per_second, tracker_interrupt_cb, tracker);
+    tracker_interrupt_init(
+        tracker->song->ticks_per_second * TRACKER_MUX_DIVIDER, tracker_interrupt_cb, tracker);
 }
 
 void tracker_stop(Tracker* tracker) {
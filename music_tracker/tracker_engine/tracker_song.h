@@ -80,7 +80,7 @@ typedef enum {
 #define EFFECT_DATA_1_MAX 0x3F
 #define EFFECT_DATA_2_MAX 0x07
 
-#define FREQUENCY_UNSET -1.0f
+#define FREQUENCY_UNSET -1
 
 #define PWM_MIN 0.01f
 #define PWM_MAX 0.5f
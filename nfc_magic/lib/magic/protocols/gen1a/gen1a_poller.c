@@ -140,34 +140,60 @@ NfcCommand gen1a_poller_request_mode_handler(Gen1aPoller* instance) {
     return command;
 }
 
+static NfcCommand
+    gen1a_poller_write_blocks(Gen1aPoller* instance, const MfClassicData* mfc_data) {
+    NfcCommand command = NfcCommandContinue;
+    uint16_t total_block_num = mf_classic_get_total_block_num(mfc_data->type);
+    uint32_t start_tick = furi_get_tick();
+    MfClassicBlock block = {};
+
+    // Unlock once and stream the whole image within this session
+    Gen1aPollerError error = gen1a_poller_data_access(instance);
+    while((error == Gen1aPollerErrorNone) && (instance->current_block < total_block_num)) {
+        if(instance->session_state == Gen1aPollerSessionStateStopRequest) break;
+
+        const MfClassicBlock* target = &mfc_data->block[instance->current_block];
+        error = gen1a_poller_read_block(instance, instance->current_block, &block);
+        if(error != Gen1aPollerErrorNone) break;
+
+        if(memcmp(&block, target, sizeof(MfClassicBlock)) == 0) {
+            instance->write_stats.blocks_skipped++;
+        } else {
+            error = gen1a_poller_write_block(instance, instance->current_block, target);
+            if(error != Gen1aPollerErrorNone) break;
+            instance->write_stats.blocks_written++;
+        }
+        instance->current_block++;
+    }
+    instance->write_stats.time_ms += furi_get_tick() - start_tick;
+
+    if((error == Gen1aPollerErrorTimeout) || (error == Gen1aPollerErrorNotPresent)) {
+        // Card left the field, start over once it is back. Blocks already written are skipped
+        FURI_LOG_D(TAG, "Card lost at block %d", instance->current_block);
+        instance->state = Gen1aPollerStateIdle;
+        command = NfcCommandReset;
+    } else if(error != Gen1aPollerErrorNone) {
+        FURI_LOG_D(TAG, "Failed at block %d: %d", instance->current_block, error);
+        instance->state = Gen1aPollerStateFail;
+    } else if(instance->current_block == total_block_num) {
+        FURI_LOG_D(
+            TAG,
+            "Written %d, skipped %d blocks in %lu ms",
+            instance->write_stats.blocks_written,
+            instance->write_stats.blocks_skipped,
+            instance->write_stats.time_ms);
+        instance->state = Gen1aPollerStateSuccess;
+    }
+
+    return command;
+}
+
 NfcCommand gen1a_poller_wipe_handler(Gen1aPoller* instance) {
     NfcCommand command = NfcCommandContinue;
-    Gen1aPollerError error = Gen1aPollerErrorNone;
 
     const MfClassicData* mfc_data =
         nfc_device_get_data(instance->mfc_device, NfcProtocolMfClassic);
-    uint16_t total_block_num = mf_classic_get_total_block_num(mfc_data->type);
-
-    if(instance->current_block == total_block_num) {
-        instance->state = Gen1aPollerStateSuccess;
-    } else {
-        do {
-            if(instance->current_block == 0) {
-                error = gen1a_poller_data_access(instance);
-                if(error != Gen1aPollerErrorNone) {
-                    instance->state = Gen1aPollerStateFail;
-                    break;
-                }
-            }
-            error = gen1a_poller_write_block(
-                instance, instance->current_block, &mfc_data->block[instance->current_block]);
-            if(error != Gen1aPollerErrorNone) {
-                instance->state = Gen1aPollerStateFail;
-                break;
-            }
-            instance->current_block++;
-        } while(false);
-    }
+    command = gen1a_poller_write_blocks(instance, mfc_data);
 
     return command;
 }
@@ -184,31 +210,9 @@ NfcCommand gen1a_poller_write_data_request_handler(Gen1aPoller* instance) {
 
 NfcCommand gen1a_poller_write_handler(Gen1aPoller* instance) {
     NfcCommand command = NfcCommandContinue;
-    Gen1aPollerError error = Gen1aPollerErrorNone;
 
     const MfClassicData* mfc_data = instance->gen1a_event_data.data_to_write.mfc_data;
-    uint16_t total_block_num = mf_classic_get_total_block_num(mfc_data->type);
-
-    if(instance->current_block == total_block_num) {
-        instance->state = Gen1aPollerStateSuccess;
-    } else {
-        do {
-            if(instance->current_block == 0) {
-                error = gen1a_poller_data_access(instance);
-                if(error != Gen1aPollerErrorNone) {
-                    instance->state = Gen1aPollerStateFail;
-                    break;
-                }
-            }
-            error = gen1a_poller_write_block(
-                instance, instance->current_block, &mfc_data->block[instance->current_block]);
-            if(error != Gen1aPollerErrorNone) {
-                instance->state = Gen1aPollerStateFail;
-                break;
-            }
-            instance->current_block++;
-        } while(false);
-    }
+    command = gen1a_poller_write_blocks(instance, mfc_data);
 
     return command;
 }
@@ -217,6 +221,7 @@ NfcCommand gen1a_poller_success_handler(Gen1aPoller* instance) {
     NfcCommand command = NfcCommandContinue;
 
     instance->gen1a_event.type = Gen1aPollerEventTypeSuccess;
+    instance->gen1a_event_data.success = instance->write_stats;
     command = instance->callback(instance->gen1a_event, instance->context);
     instance->state = Gen1aPollerStateIdle;
 
@@ -266,6 +271,7 @@ void gen1a_poller_start(Gen1aPoller* instance, Gen1aPollerCallback callback, voi
     instance->callback = callback;
     instance->context = context;
 
+    memset(&instance->write_stats, 0, sizeof(instance->write_stats));
     instance->session_state = Gen1aPollerSessionStateStarted;
     nfc_start(instance->nfc, gen1a_poller_run, instance);
 }
@@ -30,9 +30,16 @@ typedef struct {
     const MfClassicData* mfc_data;
 } Gen1aPollerEventDataRequestDataToWrite;
 
+typedef struct {
+    uint16_t blocks_written;
+    uint16_t blocks_skipped; // Already identical on the card
+    uint32_t time_ms;
+} Gen1aPollerEventDataSuccess;
+
 typedef union {
     Gen1aPollerEventDataRequestMode request_mode;
     Gen1aPollerEventDataRequestDataToWrite data_to_write;
+    Gen1aPollerEventDataSuccess success;
 } Gen1aPollerEventData;
 
 typedef struct {
@@ -130,3 +130,38 @@ Gen1aPollerError gen1a_poller_write_block(
 
     return ret;
 }
+
+Gen1aPollerError
+    gen1a_poller_read_block(Gen1aPoller* instance, uint8_t block_num, MfClassicBlock* block) {
+    furi_assert(instance);
+    furi_assert(block);
+
+    Gen1aPollerError ret = Gen1aPollerErrorNone;
+    bit_buffer_reset(instance->tx_buffer);
+
+    do {
+        bit_buffer_append_byte(instance->tx_buffer, 0x30);
+        bit_buffer_append_byte(instance->tx_buffer, block_num);
+        iso14443_crc_append(Iso14443CrcTypeA, instance->tx_buffer);
+
+        NfcError error = nfc_poller_trx(
+            instance->nfc, instance->tx_buffer, instance->rx_buffer, GEN1A_POLLER_MAX_FWT);
+
+        if(error != NfcErrorNone) {
+            ret = gen1a_poller_process_nfc_error(error);
+            break;
+        }
+        if(bit_buffer_get_size_bytes(instance->rx_buffer) != sizeof(MfClassicBlock) + 2) {
+            ret = Gen1aPollerErrorProtocol;
+            break;
+        }
+        if(!iso14443_crc_check(Iso14443CrcTypeA, instance->rx_buffer)) {
+            ret = Gen1aPollerErrorProtocol;
+            break;
+        }
+
+        bit_buffer_write_bytes(instance->rx_buffer, block->data, sizeof(MfClassicBlock));
+    } while(false);
+
+    return ret;
+}
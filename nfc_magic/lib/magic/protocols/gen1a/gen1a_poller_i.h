@@ -5,6 +5,8 @@
 #include <nfc/nfc_device.h>
 #include <nfc/protocols/mf_classic/mf_classic.h>
 
+#define TAG "Gen1aPoller"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -44,6 +46,7 @@ struct Gen1aPoller {
 
     uint16_t current_block;
     NfcDevice* mfc_device;
+    Gen1aPollerEventDataSuccess write_stats;
 
     BitBuffer* tx_buffer;
     BitBuffer* rx_buffer;
@@ -59,6 +62,9 @@ Gen1aPollerError gen1a_poller_wupa(Gen1aPoller* instance);
 
 Gen1aPollerError gen1a_poller_data_access(Gen1aPoller* instance);
 
+Gen1aPollerError
+    gen1a_poller_read_block(Gen1aPoller* instance, uint8_t block_num, MfClassicBlock* block);
+
 Gen1aPollerError
     gen1a_poller_write_block(Gen1aPoller* instance, uint8_t block_num, const MfClassicBlock* block);
 
@@ -177,48 +177,73 @@ NfcCommand gen4_poller_request_mode_handler(Gen4Poller* instance) {
     return command;
 }
 
-NfcCommand gen4_poller_wipe_handler(Gen4Poller* instance) {
-    NfcCommand command = NfcCommandContinue;
+static Gen4PollerError
+    gen4_poller_write_block_diff(Gen4Poller* instance, uint8_t block_num, const uint8_t* data) {
+    Gen4PollerError error = Gen4PollerErrorNone;
+    uint8_t block[GEN4_POLLER_BLOCK_SIZE] = {};
 
     do {
-        Gen4PollerError error = Gen4PollerErrorNone;
-        if(instance->current_block == 0) {
-            error = gen4_poller_set_config(
-                instance,
-                instance->password,
-                gen4_poller_default_config,
-                sizeof(gen4_poller_default_config),
-                false);
-            if(error != Gen4PollerErrorNone) {
-                FURI_LOG_D(TAG, "Failed to set default config: %d", error);
-                instance->state = Gen4PollerStateFail;
-                break;
-            }
-            error = gen4_poller_write_block(
-                instance, instance->password, instance->current_block, gen4_poller_default_block_0);
-            if(error != Gen4PollerErrorNone) {
-                FURI_LOG_D(TAG, "Failed to write 0 block: %d", error);
-                instance->state = Gen4PollerStateFail;
-                break;
-            }
-        } else if(instance->current_block < GEN4_POLLER_BLOCKS_TOTAL) {
-            const uint8_t* block = gen4_poller_is_sector_trailer(instance->current_block) ?
-                                       gen4_poller_default_sector_trailer_block :
-                                       gen4_poller_default_empty_block;
-            error = gen4_poller_write_block(
-                instance, instance->password, instance->current_block, block);
-            if(error != Gen4PollerErrorNone) {
-                FURI_LOG_D(TAG, "Failed to write %d block: %d", instance->current_block, error);
-                instance->state = Gen4PollerStateFail;
-                break;
-            }
-        } else {
-            instance->state = Gen4PollerStateSuccess;
+        error = gen4_poller_read_block(instance, instance->password, block_num, block);
+        if(error != Gen4PollerErrorNone) break;
+
+        if(memcmp(block, data, GEN4_POLLER_BLOCK_SIZE) == 0) {
+            instance->write_stats.blocks_skipped++;
             break;
         }
-        instance->current_block++;
+
+        error = gen4_poller_write_block(instance, instance->password, block_num, data);
+        if(error != Gen4PollerErrorNone) break;
+        instance->write_stats.blocks_written++;
     } while(false);
 
+    return error;
+}
+
+static NfcCommand gen4_poller_process_write_error(Gen4Poller* instance, Gen4PollerError error) {
+    NfcCommand command = NfcCommandContinue;
+
+    if(error == Gen4PollerErrorTimeout) {
+        // Card left the field, start over once it is back. Blocks already written are skipped
+        FURI_LOG_D(TAG, "Card lost at block %d", instance->current_block);
+        instance->state = Gen4PollerStateIdle;
+        command = NfcCommandReset;
+    } else {
+        FURI_LOG_D(TAG, "Failed to write %d block: %d", instance->current_block, error);
+        instance->state = Gen4PollerStateFail;
+    }
+
+    return command;
+}
+
+NfcCommand gen4_poller_wipe_handler(Gen4Poller* instance) {
+    NfcCommand command = NfcCommandContinue;
+    uint32_t start_tick = furi_get_tick();
+
+    Gen4PollerError error = gen4_poller_set_config(
+        instance,
+        instance->password,
+        gen4_poller_default_config,
+        sizeof(gen4_poller_default_config),
+        false);
+    while((error == Gen4PollerErrorNone) && (instance->current_block < GEN4_POLLER_BLOCKS_TOTAL)) {
+        const uint8_t* block = gen4_poller_default_empty_block;
+        if(instance->current_block == 0) {
+            block = gen4_poller_default_block_0;
+        } else if(gen4_poller_is_sector_trailer(instance->current_block)) {
+            block = gen4_poller_default_sector_trailer_block;
+        }
+        error = gen4_poller_write_block_diff(instance, instance->current_block, block);
+        if(error != Gen4PollerErrorNone) break;
+        instance->current_block++;
+    }
+    instance->write_stats.time_ms += furi_get_tick() - start_tick;
+
+    if(error != Gen4PollerErrorNone) {
+        command = gen4_poller_process_write_error(instance, error);
+    } else {
+        instance->state = Gen4PollerStateSuccess;
+    }
+
     return command;
 }
 
@@ -243,6 +268,7 @@ NfcCommand gen4_poller_request_write_data_handler(Gen4Poller* instance) {
 
 static NfcCommand gen4_poller_write_mf_classic(Gen4Poller* instance) {
     NfcCommand command = NfcCommandContinue;
+    uint32_t start_tick = furi_get_tick();
 
     do {
         const MfClassicData* mfc_data = instance->data;
@@ -277,30 +303,27 @@ static NfcCommand gen4_poller_write_mf_classic(Gen4Poller* instance) {
                 break;
             }
         }
-        if(instance->current_block < instance->total_blocks) {
-            FURI_LOG_D(TAG, "Writing block %d", instance->current_block);
-            Gen4PollerError error = gen4_poller_write_block(
-                instance,
-                instance->password,
-                instance->current_block,
-                mfc_data->block[instance->current_block].data);
+        while(instance->current_block < instance->total_blocks) {
+            Gen4PollerError error = gen4_poller_write_block_diff(
+                instance, instance->current_block, mfc_data->block[instance->current_block].data);
             if(error != Gen4PollerErrorNone) {
-                FURI_LOG_D(TAG, "Failed to write %d block: %d", instance->current_block, error);
-                instance->state = Gen4PollerStateFail;
+                command = gen4_poller_process_write_error(instance, error);
                 break;
             }
-        } else {
+            instance->current_block++;
+        }
+        if(instance->current_block == instance->total_blocks) {
             instance->state = Gen4PollerStateSuccess;
-            break;
         }
-        instance->current_block++;
     } while(false);
+    instance->write_stats.time_ms += furi_get_tick() - start_tick;
 
     return command;
 }
 
 static NfcCommand gen4_poller_write_mf_ultralight(Gen4Poller* instance) {
     NfcCommand command = NfcCommandContinue;
+    uint32_t start_tick = furi_get_tick();
 
     do {
         const MfUltralightData* mfu_data = instance->data;
@@ -357,64 +380,64 @@ static NfcCommand gen4_poller_write_mf_ultralight(Gen4Poller* instance) {
             }
         }
 
-        if(instance->current_block < mfu_data->pages_read) {
-            FURI_LOG_D(
-                TAG, "Writing page %zu / %zu", instance->current_block, mfu_data->pages_read);
+        // Page reads are not block sized, so pages are written without the diff
+        while(instance->current_block < mfu_data->pages_read) {
             Gen4PollerError error = gen4_poller_write_block(
                 instance,
                 instance->password,
                 instance->current_block,
                 mfu_data->page[instance->current_block].data);
             if(error != Gen4PollerErrorNone) {
-                FURI_LOG_D(TAG, "Failed to write %d page: %d", instance->current_block, error);
-                instance->state = Gen4PollerStateFail;
+                command = gen4_poller_process_write_error(instance, error);
                 break;
             }
+            instance->write_stats.blocks_written++;
             instance->current_block++;
-        } else {
-            uint8_t block[GEN4_POLLER_BLOCK_SIZE] = {};
-            bool write_success = true;
-            for(size_t i = 0; i < 8; i++) {
-                memcpy(block, &mfu_data->signature.data[i * 4], 4); //-V1086
-                Gen4PollerError error =
-                    gen4_poller_write_block(instance, instance->password, 0xF2 + i, block);
-                if(error != Gen4PollerErrorNone) {
-                    write_success = false;
-                    break;
-                }
-            }
-            if(!write_success) {
-                FURI_LOG_E(TAG, "Failed to write Signature");
-                instance->state = Gen4PollerStateFail;
-                break;
-            }
+        }
+        if(instance->current_block < mfu_data->pages_read) break;
 
-            block[0] = mfu_data->version.header;
-            block[1] = mfu_data->version.vendor_id;
-            block[2] = mfu_data->version.prod_type;
-            block[3] = mfu_data->version.prod_subtype;
+        uint8_t block[GEN4_POLLER_BLOCK_SIZE] = {};
+        bool write_success = true;
+        for(size_t i = 0; i < 8; i++) {
+            memcpy(block, &mfu_data->signature.data[i * 4], 4); //-V1086
             Gen4PollerError error =
-                gen4_poller_write_block(instance, instance->password, 0xFA, block);
+                gen4_poller_write_block(instance, instance->password, 0xF2 + i, block);
             if(error != Gen4PollerErrorNone) {
-                FURI_LOG_E(TAG, "Failed to write 1st part Version");
-                instance->state = Gen4PollerStateFail;
+                write_success = false;
                 break;
             }
+        }
+        if(!write_success) {
+            FURI_LOG_E(TAG, "Failed to write Signature");
+            instance->state = Gen4PollerStateFail;
+            break;
+        }
 
-            block[0] = mfu_data->version.prod_ver_major;
-            block[1] = mfu_data->version.prod_ver_minor;
-            block[2] = mfu_data->version.storage_size;
-            block[3] = mfu_data->version.protocol_type;
-            error = gen4_poller_write_block(instance, instance->password, 0xFB, block);
-            if(error != Gen4PollerErrorNone) {
-                FURI_LOG_E(TAG, "Failed to write 2nd part Version");
-                instance->state = Gen4PollerStateFail;
-                break;
-            }
+        block[0] = mfu_data->version.header;
+        block[1] = mfu_data->version.vendor_id;
+        block[2] = mfu_data->version.prod_type;
+        block[3] = mfu_data->version.prod_subtype;
+        Gen4PollerError error = gen4_poller_write_block(instance, instance->password, 0xFA, block);
+        if(error != Gen4PollerErrorNone) {
+            FURI_LOG_E(TAG, "Failed to write 1st part Version");
+            instance->state = Gen4PollerStateFail;
+            break;
+        }
 
-            instance->state = Gen4PollerStateSuccess;
+        block[0] = mfu_data->version.prod_ver_major;
+        block[1] = mfu_data->version.prod_ver_minor;
+        block[2] = mfu_data->version.storage_size;
+        block[3] = mfu_data->version.protocol_type;
+        error = gen4_poller_write_block(instance, instance->password, 0xFB, block);
+        if(error != Gen4PollerErrorNone) {
+            FURI_LOG_E(TAG, "Failed to write 2nd part Version");
+            instance->state = Gen4PollerStateFail;
+            break;
         }
+
+        instance->state = Gen4PollerStateSuccess;
     } while(false);
+    instance->write_stats.time_ms += furi_get_tick() - start_tick;
 
     return command;
 }
@@ -466,6 +489,7 @@ NfcCommand gen4_poller_success_handler(Gen4Poller* instance) {
     NfcCommand command = NfcCommandContinue;
 
     instance->gen4_event.type = Gen4PollerEventTypeSuccess;
+    instance->gen4_event_data.success = instance->write_stats;
     command = instance->callback(instance->gen4_event, instance->context);
     if(command != NfcCommandStop) {
         furi_delay_ms(100);
@@ -522,6 +546,7 @@ void gen4_poller_start(Gen4Poller* instance, Gen4PollerCallback callback, void*
 
     instance->callback = callback;
     instance->context = context;
+    memset(&instance->write_stats, 0, sizeof(instance->write_stats));
 
     nfc_poller_start(instance->poller, gen4_poller_callback, instance);
 }
@@ -52,10 +52,17 @@ typedef struct {
     uint32_t password;
 } Gen4PollerEventDataRequestNewPassword;
 
+typedef struct {
+    uint16_t blocks_written;
+    uint16_t blocks_skipped; // Already identical on the card
+    uint32_t time_ms;
+} Gen4PollerEventDataSuccess;
+
 typedef union {
     Gen4PollerEventDataRequestMode request_mode;
     Gen4PollerEventDataRequestDataToWrite request_data;
     Gen4PollerEventDataRequestNewPassword request_password;
+    Gen4PollerEventDataSuccess success;
 } Gen4PollerEventData;
 
 typedef struct {
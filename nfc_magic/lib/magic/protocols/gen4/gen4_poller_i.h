@@ -66,6 +66,7 @@ struct Gen4Poller {
 
     uint16_t current_block;
     uint16_t total_blocks;
+    Gen4PollerEventDataSuccess write_stats;
 
     NfcProtocol protocol;
     const NfcDeviceData* data;
@@ -87,6 +88,12 @@ Gen4PollerError gen4_poller_set_config(
     size_t config_size,
     bool fuse);
 
+Gen4PollerError gen4_poller_read_block(
+    Gen4Poller* instance,
+    uint32_t password,
+    uint8_t block_num,
+    uint8_t* data);
+
 Gen4PollerError gen4_poller_write_block(
     Gen4Poller* instance,
     uint32_t password,
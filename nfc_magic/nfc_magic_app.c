@@ -54,6 +54,7 @@ NfcMagicApp* nfc_magic_app_alloc() {
         instance->source_dev, nfc_magic_app_show_loading_popup, instance);
     instance->file_path = furi_string_alloc_set(NFC_APP_FOLDER);
     instance->file_name = furi_string_alloc();
+    instance->text_box_store = furi_string_alloc();
 
     // Open GUI record
     instance->gui = furi_record_open(RECORD_GUI);
@@ -116,6 +117,7 @@ void nfc_magic_app_free(NfcMagicApp* instance) {
     nfc_device_free(instance->source_dev);
     furi_string_free(instance->file_name);
     furi_string_free(instance->file_path);
+    furi_string_free(instance->text_box_store);
 
     // Submenu
     view_dispatcher_remove_view(instance->view_dispatcher, NfcMagicAppViewMenu);
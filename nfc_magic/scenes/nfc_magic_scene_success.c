@@ -11,9 +11,22 @@ void nfc_magic_scene_success_on_enter(void* context) {
     notification_message(instance->notifications, &sequence_success);
 
     Popup* popup = instance->popup;
-    popup_set_icon(popup, 32, 5, &I_DolphinNice_96x59);
-    popup_set_header(popup, "Success!", 10, 20, AlignLeft, AlignBottom);
-    popup_set_timeout(popup, 1500);
+    if(furi_string_empty(instance->text_box_store)) {
+        popup_set_icon(popup, 32, 5, &I_DolphinNice_96x59);
+        popup_set_header(popup, "Success!", 10, 20, AlignLeft, AlignBottom);
+        popup_set_timeout(popup, 1500);
+    } else {
+        // Write statistics
+        popup_set_header(popup, "Success!", 64, 10, AlignCenter, AlignCenter);
+        popup_set_text(
+            popup,
+            furi_string_get_cstr(instance->text_box_store),
+            64,
+            36,
+            AlignCenter,
+            AlignCenter);
+        popup_set_timeout(popup, 3000);
+    }
     popup_set_context(popup, instance);
     popup_set_callback(popup, nfc_magic_scene_success_popup_callback);
     popup_enable_timeout(popup);
@@ -39,4 +52,5 @@ void nfc_magic_scene_success_on_exit(void* context) {
 
     // Clear view
     popup_reset(instance->popup);
+    furi_string_reset(instance->text_box_store);
 }
@@ -5,6 +5,22 @@ enum {
     NfcMagicSceneWriteStateCardFound,
 };
 
+static void nfc_magic_scene_write_set_stats(
+    NfcMagicApp* instance,
+    uint16_t blocks_written,
+    uint16_t blocks_skipped,
+    uint32_t time_ms) {
+    uint32_t blocks_per_sec = (blocks_written + blocks_skipped) * 1000 / MAX(time_ms, 1UL);
+    furi_string_printf(
+        instance->text_box_store,
+        "Written %u, same %u\n%lu.%lu s, %lu blocks/s",
+        blocks_written,
+        blocks_skipped,
+        time_ms / 1000,
+        time_ms % 1000 / 100,
+        blocks_per_sec);
+}
+
 NfcCommand nfc_mafic_scene_write_gen1_poller_callback(Gen1aPollerEvent event, void* context) {
     NfcMagicApp* instance = context;
     furi_assert(event.data);
@@ -21,6 +37,11 @@ NfcCommand nfc_mafic_scene_write_gen1_poller_callback(Gen1aPollerEvent event, vo
             nfc_device_get_data(instance->source_dev, NfcProtocolMfClassic);
         event.data->data_to_write.mfc_data = mfc_data;
     } else if(event.type == Gen1aPollerEventTypeSuccess) {
+        nfc_magic_scene_write_set_stats(
+            instance,
+            event.data->success.blocks_written,
+            event.data->success.blocks_skipped,
+            event.data->success.time_ms);
         view_dispatcher_send_custom_event(
             instance->view_dispatcher, NfcMagicCustomEventWorkerSuccess);
         command = NfcCommandStop;
@@ -49,6 +70,11 @@ NfcCommand nfc_mafic_scene_write_gen4_poller_callback(Gen4PollerEvent event, voi
         event.data->request_data.protocol = protocol;
         event.data->request_data.data = nfc_device_get_data(instance->source_dev, protocol);
     } else if(event.type == Gen4PollerEventTypeSuccess) {
+        nfc_magic_scene_write_set_stats(
+            instance,
+            event.data->success.blocks_written,
+            event.data->success.blocks_skipped,
+            event.data->success.time_ms);
         view_dispatcher_send_custom_event(
             instance->view_dispatcher, NfcMagicCustomEventWorkerSuccess);
         command = NfcCommandStop;
@@ -1,4 +1,5 @@
 #include "nfc_maker.h"
+#include "nfc_maker_batch.h"
 
 static bool nfc_maker_custom_event_callback(void* context, uint32_t event) {
     furi_assert(context);
@@ -46,6 +47,10 @@ NfcMaker* nfc_maker_alloc() {
     app->popup = popup_alloc();
     view_dispatcher_add_view(app->view_dispatcher, NfcMakerViewPopup, popup_get_view(app->popup));
 
+    // Batch mode
+    app->batch = nfc_maker_batch_alloc();
+    app->batch_path = furi_string_alloc_set(NFC_APP_FOLDER);
+
     return app;
 }
 
@@ -62,6 +67,10 @@ void nfc_maker_free(NfcMaker* app) {
     view_dispatcher_remove_view(app->view_dispatcher, NfcMakerViewPopup);
     popup_free(app->popup);
 
+    // Batch mode
+    nfc_maker_batch_free(app->batch);
+    furi_string_free(app->batch_path);
+
     // View Dispatcher and Scene Manager
     view_dispatcher_free(app->view_dispatcher);
     scene_manager_free(app->scene_manager);
@@ -16,6 +16,8 @@
 #include <toolbox/name_generator.h>
 #include <applications/main/nfc/nfc_app_i.h>
 #include <furi_hal_bt.h>
+#include <dialogs/dialogs.h>
+#include "nfc_maker_writer.h"
 
 #define MAC_INPUT_LEN GAP_MAC_ADDR_SIZE
 #define MAIL_INPUT_LEN 128
@@ -57,6 +59,12 @@ typedef struct {
     char small_buf1[SMALL_INPUT_LEN];
     char small_buf2[SMALL_INPUT_LEN];
     char save_buf[BIG_INPUT_LEN];
+
+    // Batch mode
+    struct NfcMakerBatch* batch;
+    FuriString* batch_path;
+    Nfc* nfc;
+    NfcMakerWriter* writer;
 } NfcMaker;
 
 typedef enum {
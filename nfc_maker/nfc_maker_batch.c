@@ -0,0 +1,321 @@
+#include "nfc_maker_batch.h"
+
+#include <toolbox/stream/file_stream.h>
+#include <toolbox/hex.h>
+#include <ctype.h>
+
+#define TAG "NfcMakerBatch"
+
+#define FIELD_LEN BIG_INPUT_LEN
+
+struct NfcMakerBatch {
+    Stream* stream;
+    FuriString* line;
+    char field[FIELD_LEN];
+
+    uint32_t type;
+    const char* type_name;
+    size_t row_count;
+    size_t row_index;
+
+    // Reused for every row
+    uint8_t image[NTAG215_SIZE];
+    uint8_t payload[NDEF_PAYLOAD_MAX_LEN];
+    size_t image_used;
+};
+
+typedef struct {
+    const char* name;
+    uint32_t value;
+} NfcMakerBatchName;
+
+static const NfcMakerBatchName nfc_maker_batch_types[] = {
+    {"bluetooth", NfcMakerSceneBluetooth},
+    {"contact", NfcMakerSceneContact},
+    {"https", NfcMakerSceneHttps},
+    {"mail", NfcMakerSceneMail},
+    {"phone", NfcMakerScenePhone},
+    {"text", NfcMakerSceneText},
+    {"url", NfcMakerSceneUrl},
+    {"wifi", NfcMakerSceneWifi},
+};
+
+static const NfcMakerBatchName nfc_maker_batch_wifi_auths[] = {
+    {"open", WifiAuthenticationOpen},
+    {"wpa", WifiAuthenticationWpaPersonal},
+    {"wpa2", WifiAuthenticationWpa2Personal},
+    {"wpa-ent", WifiAuthenticationWpaEnterprise},
+    {"wpa2-ent", WifiAuthenticationWpa2Enterprise},
+    {"shared", WifiAuthenticationShared},
+};
+
+static const NfcMakerBatchName nfc_maker_batch_wifi_encrs[] = {
+    {"aes", WifiEncryptionAes},
+    {"tkip", WifiEncryptionTkip},
+    {"wep", WifiEncryptionWep},
+    {"none", WifiEncryptionNone},
+};
+
+static const NfcMakerBatchName*
+    nfc_maker_batch_find_name(const NfcMakerBatchName* names, size_t count, char* name) {
+    for(char* c = name; *c; c++) {
+        *c = tolower((unsigned char)*c);
+    }
+    for(size_t i = 0; i < count; i++) {
+        if(strcmp(names[i].name, name) == 0) return &names[i];
+    }
+    return NULL;
+}
+
+// Copy the next field of the line, missing fields are read as empty
+static bool nfc_maker_batch_next_field(const char** cursor, char* out, size_t out_size) {
+    const char* p = *cursor;
+    size_t len = 0;
+    bool fits = true;
+
+    if(p) {
+        bool quoted = (*p == '"');
+        if(quoted) p++;
+        for(; *p; p++) {
+            if(quoted && *p == '"') {
+                if(p[1] != '"') {
+                    quoted = false;
+                    continue;
+                }
+                p++;
+            } else if(!quoted && *p == ',') {
+                break;
+            }
+            if(len + 1 < out_size) {
+                out[len++] = *p;
+            } else {
+                fits = false;
+            }
+        }
+        *cursor = (*p == ',') ? p + 1 : NULL;
+    }
+    out[len] = '\0';
+
+    return fits;
+}
+
+static bool nfc_maker_batch_parse_mac(const char* str, uint8_t* mac) {
+    size_t nibbles = 0;
+
+    for(; *str; str++) {
+        if(*str == ':' || *str == '-' || *str == ' ') continue;
+        uint8_t nibble;
+        if(!hex_char_to_hex_nibble(*str, &nibble)) return false;
+        if(nibbles == MAC_INPUT_LEN * 2) return false;
+        if(nibbles % 2 == 0) {
+            mac[nibbles / 2] = nibble << 4;
+        } else {
+            mac[nibbles / 2] |= nibble;
+        }
+        nibbles++;
+    }
+
+    return nibbles == MAC_INPUT_LEN * 2;
+}
+
+static bool nfc_maker_batch_parse_row(NfcMakerBatch* batch, NfcMaker* app) {
+    const char* cursor = furi_string_get_cstr(batch->line);
+    bool ok = true;
+
+    memset(app->mac_buf, 0, sizeof(app->mac_buf));
+    memset(app->mail_buf, 0, sizeof(app->mail_buf));
+    memset(app->phone_buf, 0, sizeof(app->phone_buf));
+    memset(app->big_buf, 0, sizeof(app->big_buf));
+    memset(app->small_buf1, 0, sizeof(app->small_buf1));
+    memset(app->small_buf2, 0, sizeof(app->small_buf2));
+
+    switch(batch->type) {
+    case NfcMakerSceneBluetooth:
+        ok &= nfc_maker_batch_next_field(&cursor, batch->field, sizeof(batch->field));
+        ok &= nfc_maker_batch_parse_mac(batch->field, app->mac_buf);
+        break;
+    case NfcMakerSceneContact:
+        ok &= nfc_maker_batch_next_field(&cursor, app->small_buf1, SMALL_INPUT_LEN);
+        ok &= nfc_maker_batch_next_field(&cursor, app->small_buf2, SMALL_INPUT_LEN);
+        ok &= nfc_maker_batch_next_field(&cursor, app->mail_buf, MAIL_INPUT_LEN);
+        ok &= nfc_maker_batch_next_field(&cursor, app->phone_buf, PHONE_INPUT_LEN);
+        ok &= nfc_maker_batch_next_field(&cursor, app->big_buf, BIG_INPUT_LEN);
+        break;
+    case NfcMakerSceneHttps:
+        ok &= nfc_maker_batch_next_field(&cursor, app->big_buf, BIG_INPUT_LEN);
+        // The record prepends the scheme itself
+        if(strncmp(app->big_buf, "https://", 8) == 0) {
+            memmove(app->big_buf, &app->big_buf[8], strlen(app->big_buf) - 8 + 1);
+        }
+        break;
+    case NfcMakerSceneMail:
+        ok &= nfc_maker_batch_next_field(&cursor, app->mail_buf, MAIL_INPUT_LEN);
+        break;
+    case NfcMakerScenePhone:
+        ok &= nfc_maker_batch_next_field(&cursor, app->phone_buf, PHONE_INPUT_LEN);
+        break;
+    case NfcMakerSceneText:
+    case NfcMakerSceneUrl:
+        ok &= nfc_maker_batch_next_field(&cursor, app->big_buf, BIG_INPUT_LEN);
+        break;
+    case NfcMakerSceneWifi: {
+        ok &= nfc_maker_batch_next_field(&cursor, app->small_buf1, SMALL_INPUT_LEN);
+        ok &= nfc_maker_batch_next_field(&cursor, app->small_buf2, SMALL_INPUT_LEN);
+        bool open = !strlen(app->small_buf2);
+        uint32_t auth = open ? WifiAuthenticationOpen : WifiAuthenticationWpa2Personal;
+        uint32_t encr = open ? WifiEncryptionNone : WifiEncryptionAes;
+
+        ok &= nfc_maker_batch_next_field(&cursor, batch->field, sizeof(batch->field));
+        if(strlen(batch->field)) {
+            const NfcMakerBatchName* name = nfc_maker_batch_find_name(
+                nfc_maker_batch_wifi_auths, COUNT_OF(nfc_maker_batch_wifi_auths), batch->field);
+            if(name) {
+                auth = name->value;
+            } else {
+                ok = false;
+            }
+        }
+        ok &= nfc_maker_batch_next_field(&cursor, batch->field, sizeof(batch->field));
+        if(strlen(batch->field)) {
+            const NfcMakerBatchName* name = nfc_maker_batch_find_name(
+                nfc_maker_batch_wifi_encrs, COUNT_OF(nfc_maker_batch_wifi_encrs), batch->field);
+            if(name) {
+                encr = name->value;
+            } else {
+                ok = false;
+            }
+        }
+        // Same place the interactive scenes keep them, the encoder reads them from there
+        scene_manager_set_scene_state(app->scene_manager, NfcMakerSceneWifiAuth, auth);
+        scene_manager_set_scene_state(app->scene_manager, NfcMakerSceneWifiEncr, encr);
+        break;
+    }
+    default:
+        ok = false;
+        break;
+    }
+
+    return ok;
+}
+
+// Next non empty line, without surrounding whitespace
+static bool nfc_maker_batch_read_line(NfcMakerBatch* batch) {
+    while(stream_read_line(batch->stream, batch->line)) {
+        furi_string_trim(batch->line);
+        if(!furi_string_empty(batch->line)) return true;
+    }
+    return false;
+}
+
+NfcMakerBatch* nfc_maker_batch_alloc() {
+    NfcMakerBatch* batch = malloc(sizeof(NfcMakerBatch));
+    batch->stream = file_stream_alloc(furi_record_open(RECORD_STORAGE));
+    batch->line = furi_string_alloc();
+    return batch;
+}
+
+void nfc_maker_batch_free(NfcMakerBatch* batch) {
+    furi_assert(batch);
+    nfc_maker_batch_close(batch);
+    stream_free(batch->stream);
+    furi_record_close(RECORD_STORAGE);
+    furi_string_free(batch->line);
+    free(batch);
+}
+
+bool nfc_maker_batch_open(NfcMakerBatch* batch, const char* path) {
+    furi_assert(batch);
+    furi_assert(path);
+    bool success = false;
+
+    nfc_maker_batch_close(batch);
+    do {
+        if(!file_stream_open(batch->stream, path, FSAM_READ, FSOM_OPEN_EXISTING)) break;
+        if(!nfc_maker_batch_read_line(batch)) break;
+
+        const char* cursor = furi_string_get_cstr(batch->line);
+        nfc_maker_batch_next_field(&cursor, batch->field, sizeof(batch->field));
+        const NfcMakerBatchName* type = nfc_maker_batch_find_name(
+            nfc_maker_batch_types, COUNT_OF(nfc_maker_batch_types), batch->field);
+        if(!type) {
+            FURI_LOG_E(TAG, "Unknown record type: %s", batch->field);
+            break;
+        }
+        batch->type = type->value;
+        batch->type_name = type->name;
+
+        while(nfc_maker_batch_read_line(batch)) {
+            batch->row_count++;
+        }
+
+        success = nfc_maker_batch_rewind(batch);
+    } while(false);
+
+    if(!success) nfc_maker_batch_close(batch);
+
+    return success;
+}
+
+void nfc_maker_batch_close(NfcMakerBatch* batch) {
+    furi_assert(batch);
+    file_stream_close(batch->stream);
+    batch->type_name = NULL;
+    batch->row_count = 0;
+    batch->row_index = 0;
+}
+
+bool nfc_maker_batch_rewind(NfcMakerBatch* batch) {
+    furi_assert(batch);
+    batch->row_index = 0;
+    // Skip the header
+    return stream_rewind(batch->stream) && nfc_maker_batch_read_line(batch);
+}
+
+uint32_t nfc_maker_batch_get_type(NfcMakerBatch* batch) {
+    furi_assert(batch);
+    return batch->type;
+}
+
+const char* nfc_maker_batch_get_type_name(NfcMakerBatch* batch) {
+    furi_assert(batch);
+    return batch->type_name;
+}
+
+size_t nfc_maker_batch_get_row_count(NfcMakerBatch* batch) {
+    furi_assert(batch);
+    return batch->row_count;
+}
+
+size_t nfc_maker_batch_get_row_index(NfcMakerBatch* batch) {
+    furi_assert(batch);
+    return batch->row_index;
+}
+
+NfcMakerBatchRow nfc_maker_batch_next(NfcMakerBatch* batch, NfcMaker* app) {
+    furi_assert(batch);
+    furi_assert(app);
+
+    if(!nfc_maker_batch_read_line(batch)) return NfcMakerBatchRowEnd;
+    batch->row_index++;
+
+    batch->image_used = 0;
+    if(nfc_maker_batch_parse_row(batch, app)) {
+        batch->image_used = nfc_maker_ndef_build(app, batch->type, batch->image, batch->payload);
+    }
+    if(!batch->image_used) {
+        FURI_LOG_W(TAG, "Row %zu skipped", batch->row_index);
+        return NfcMakerBatchRowInvalid;
+    }
+
+    return NfcMakerBatchRowOk;
+}
+
+const uint8_t* nfc_maker_batch_get_image(NfcMakerBatch* batch) {
+    furi_assert(batch);
+    return batch->image;
+}
+
+size_t nfc_maker_batch_get_image_used(NfcMakerBatch* batch) {
+    furi_assert(batch);
+    return batch->image_used;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "nfc_maker.h"
+#include "nfc_maker_ndef.h"
+
+#define NFC_MAKER_BATCH_EXTENSION ".csv"
+
+/*
+ * Batch of records read from a CSV file.
+ *
+ * The first row names the record type in its first cell, other header cells are free text.
+ * Every following row fills the same inputs the interactive scenes would:
+ *   https, url, text:     link or text
+ *   mail, phone:          address or number
+ *   bluetooth:            MAC address, like AA:BB:CC:DD:EE:FF
+ *   wifi:                 SSID, password, [open|wpa|wpa2|wpa-ent|wpa2-ent|shared],
+ *                         [aes|tkip|wep|none], WPA2/AES by default or open without password
+ *   contact:              first name, last name, mail, phone, URL
+ * Fields may be quoted, with "" standing for a quote inside them.
+ */
+typedef struct NfcMakerBatch NfcMakerBatch;
+
+typedef enum {
+    NfcMakerBatchRowOk,
+    NfcMakerBatchRowInvalid, // Skipped, doesn't fit the inputs or the tag
+    NfcMakerBatchRowEnd,
+} NfcMakerBatchRow;
+
+NfcMakerBatch* nfc_maker_batch_alloc();
+
+void nfc_maker_batch_free(NfcMakerBatch* batch);
+
+/** Open a CSV file, parse its header and count the rows */
+bool nfc_maker_batch_open(NfcMakerBatch* batch, const char* path);
+
+void nfc_maker_batch_close(NfcMakerBatch* batch);
+
+/** Go back to the first row */
+bool nfc_maker_batch_rewind(NfcMakerBatch* batch);
+
+/** Record type, one of the NfcMakerScene ids selectable in the start menu */
+uint32_t nfc_maker_batch_get_type(NfcMakerBatch* batch);
+
+const char* nfc_maker_batch_get_type_name(NfcMakerBatch* batch);
+
+size_t nfc_maker_batch_get_row_count(NfcMakerBatch* batch);
+
+/** Number of the last row read, starting from 1 */
+size_t nfc_maker_batch_get_row_index(NfcMakerBatch* batch);
+
+/** Read the next row into the app inputs and encode it into the batch image
+ *
+ * The image and payload buffers are allocated once with the batch and reused for every row.
+ */
+NfcMakerBatchRow nfc_maker_batch_next(NfcMakerBatch* batch, NfcMaker* app);
+
+/** Image of the last row read, NTAG215_SIZE bytes */
+const uint8_t* nfc_maker_batch_get_image(NfcMakerBatch* batch);
+
+/** Bytes of the image up to the NDEF terminator */
+size_t nfc_maker_batch_get_image_used(NfcMakerBatch* batch);
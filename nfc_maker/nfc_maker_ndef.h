@@ -0,0 +1,32 @@
+#pragma once
+
+#include "nfc_maker.h"
+
+#define NTAG215_PAGES 135
+#define NTAG215_SIZE (NTAG215_PAGES * 4)
+// NDEF message lives in the user pages, the last 5 pages are configuration
+#define NTAG215_USER_PAGE_FIRST 4
+#define NTAG215_USER_PAGE_LAST (NTAG215_PAGES - 6)
+#define NDEF_PAYLOAD_MAX_LEN ((NTAG215_USER_PAGE_LAST - NTAG215_USER_PAGE_FIRST + 1) * 4)
+
+/** Encode the record of the given type from the input buffers into a NTAG215 image
+ *
+ * The serial number is randomized on each call. Both buffers are caller owned so that
+ * they can be reused across records.
+ *
+ * @param app NfcMaker instance holding the inputs
+ * @param type record type, one of the NfcMakerScene ids selectable in the start menu
+ * @param image NTAG215_SIZE bytes
+ * @param payload NDEF_PAYLOAD_MAX_LEN bytes of scratch space
+ * @return size of the image up to the NDEF terminator, 0 if the record does not fit
+ */
+size_t nfc_maker_ndef_build(NfcMaker* app, uint32_t type, uint8_t* image, uint8_t* payload);
+
+/** Save an image made by nfc_maker_ndef_build() as a .nfc file
+ *
+ * @param file FlipperFormat file instance, closed before returning
+ * @param path destination path
+ * @param image NTAG215_SIZE bytes
+ * @return true on success
+ */
+bool nfc_maker_ndef_save(FlipperFormat* file, const char* path, const uint8_t* image);
@@ -0,0 +1,200 @@
+#include "nfc_maker_writer.h"
+
+#include <furi.h>
+#include <nfc/nfc_poller.h>
+#include <nfc/protocols/iso14443_3a/iso14443_3a_poller.h>
+
+#define TAG "NfcMakerWriter"
+
+#define NTAG_CMD_READ (0x30)
+#define NTAG_CMD_WRITE (0xA2)
+#define NTAG_ACK (0x0A)
+#define NTAG_PAGE_SIZE (4)
+#define NTAG_USER_PAGE_FIRST (4)
+#define NTAG_CC_MAGIC (0xE1)
+#define NTAG_FWT (60000)
+
+typedef enum {
+    NfcMakerWriterStateWaitTag,
+    NfcMakerWriterStateWaitRemoval,
+} NfcMakerWriterState;
+
+struct NfcMakerWriter {
+    Nfc* nfc;
+    NfcPoller* poller;
+    BitBuffer* tx_buffer;
+    BitBuffer* rx_buffer;
+
+    NfcMakerWriterState state;
+    const uint8_t* volatile image;
+    size_t used;
+
+    uint8_t last_uid[10];
+    size_t last_uid_len;
+
+    NfcMakerWriterCallback callback;
+    void* context;
+};
+
+// Pages 0-3, UID and capability container
+static bool nfc_maker_writer_read_header(NfcMakerWriter* instance, Iso14443_3aPoller* poller) {
+    bit_buffer_reset(instance->tx_buffer);
+    bit_buffer_append_byte(instance->tx_buffer, NTAG_CMD_READ);
+    bit_buffer_append_byte(instance->tx_buffer, 0);
+
+    Iso14443_3aError error = iso14443_3a_poller_send_standard_frame(
+        poller, instance->tx_buffer, instance->rx_buffer, NTAG_FWT);
+
+    return error == Iso14443_3aErrorNone &&
+           bit_buffer_get_size_bytes(instance->rx_buffer) == NTAG_PAGE_SIZE * 4;
+}
+
+static bool nfc_maker_writer_write_page(
+    NfcMakerWriter* instance,
+    Iso14443_3aPoller* poller,
+    uint8_t page,
+    const uint8_t* data) {
+    bit_buffer_reset(instance->tx_buffer);
+    bit_buffer_append_byte(instance->tx_buffer, NTAG_CMD_WRITE);
+    bit_buffer_append_byte(instance->tx_buffer, page);
+    bit_buffer_append_bytes(instance->tx_buffer, data, NTAG_PAGE_SIZE);
+
+    Iso14443_3aError error = iso14443_3a_poller_send_standard_frame(
+        poller, instance->tx_buffer, instance->rx_buffer, NTAG_FWT);
+
+    // The 4 bit ACK has no CRC
+    return error == Iso14443_3aErrorWrongCrc && bit_buffer_get_size(instance->rx_buffer) == 4 &&
+           bit_buffer_get_byte(instance->rx_buffer, 0) == NTAG_ACK;
+}
+
+static bool nfc_maker_writer_write_image(NfcMakerWriter* instance, Iso14443_3aPoller* poller) {
+    const uint8_t* image = instance->image;
+    size_t used = instance->used;
+    bool success = false;
+
+    do {
+        if(!nfc_maker_writer_read_header(instance, poller)) break;
+        uint8_t cc[NTAG_PAGE_SIZE];
+        bit_buffer_write_bytes_mid(instance->rx_buffer, cc, NTAG_PAGE_SIZE * 3, NTAG_PAGE_SIZE);
+        if(cc[0] != NTAG_CC_MAGIC) {
+            FURI_LOG_W(TAG, "Not an NDEF formatted NTAG");
+            break;
+        }
+        if(cc[2] * 8U < used - NTAG_USER_PAGE_FIRST * NTAG_PAGE_SIZE) {
+            FURI_LOG_W(TAG, "Tag too small: %u bytes", cc[2] * 8U);
+            break;
+        }
+
+        // Only the pages holding the message, the rest of the tag is left as is
+        uint8_t pages = (used + NTAG_PAGE_SIZE - 1) / NTAG_PAGE_SIZE;
+        success = true;
+        for(uint8_t page = NTAG_USER_PAGE_FIRST; page < pages; page++) {
+            if(!nfc_maker_writer_write_page(
+                   instance, poller, page, &image[page * NTAG_PAGE_SIZE])) {
+                FURI_LOG_W(TAG, "Write failed on page %u", page);
+                success = false;
+                break;
+            }
+        }
+    } while(false);
+
+    return success;
+}
+
+static NfcCommand nfc_maker_writer_poller_callback(NfcGenericEvent event, void* context) {
+    furi_assert(context);
+    furi_assert(event.protocol == NfcProtocolIso14443_3a);
+
+    NfcMakerWriter* instance = context;
+    Iso14443_3aPoller* poller = event.instance;
+    const Iso14443_3aPollerEvent* iso3_event = event.event_data;
+    NfcCommand command = NfcCommandContinue;
+
+    if(iso3_event->type == Iso14443_3aPollerEventTypeError) {
+        instance->state = NfcMakerWriterStateWaitTag;
+    } else if(instance->state == NfcMakerWriterStateWaitRemoval) {
+        if(nfc_maker_writer_read_header(instance, poller)) {
+            furi_delay_ms(50);
+        } else {
+            // Gone, activate whatever comes next
+            instance->state = NfcMakerWriterStateWaitTag;
+            command = NfcCommandReset;
+        }
+    } else if(!instance->image) {
+        furi_delay_ms(50);
+    } else {
+        const Iso14443_3aData* data = iso14443_3a_poller_get_data(poller);
+        if(data->uid_len == instance->last_uid_len &&
+           memcmp(data->uid, instance->last_uid, data->uid_len) == 0) {
+            // Last written tag, taken out and put back
+            instance->state = NfcMakerWriterStateWaitRemoval;
+        } else if(nfc_maker_writer_write_image(instance, poller)) {
+            instance->last_uid_len = MIN(data->uid_len, sizeof(instance->last_uid));
+            memcpy(instance->last_uid, data->uid, instance->last_uid_len);
+            instance->image = NULL;
+            instance->state = NfcMakerWriterStateWaitRemoval;
+            instance->callback(NfcMakerWriterEventWritten, instance->context);
+        } else {
+            instance->state = NfcMakerWriterStateWaitRemoval;
+            instance->callback(NfcMakerWriterEventFail, instance->context);
+        }
+    }
+
+    return command;
+}
+
+NfcMakerWriter* nfc_maker_writer_alloc(Nfc* nfc) {
+    furi_assert(nfc);
+
+    NfcMakerWriter* instance = malloc(sizeof(NfcMakerWriter));
+    instance->nfc = nfc;
+    instance->tx_buffer = bit_buffer_alloc(NTAG_PAGE_SIZE + 2);
+    instance->rx_buffer = bit_buffer_alloc(NTAG_PAGE_SIZE * 4 + 2);
+
+    return instance;
+}
+
+void nfc_maker_writer_free(NfcMakerWriter* instance) {
+    furi_assert(instance);
+    furi_assert(!instance->poller);
+
+    bit_buffer_free(instance->tx_buffer);
+    bit_buffer_free(instance->rx_buffer);
+    free(instance);
+}
+
+void nfc_maker_writer_start(
+    NfcMakerWriter* instance,
+    NfcMakerWriterCallback callback,
+    void* context) {
+    furi_assert(instance);
+    furi_assert(callback);
+    furi_assert(!instance->poller);
+
+    instance->callback = callback;
+    instance->context = context;
+    instance->state = NfcMakerWriterStateWaitTag;
+    instance->last_uid_len = 0;
+
+    instance->poller = nfc_poller_alloc(instance->nfc, NfcProtocolIso14443_3a);
+    nfc_poller_start(instance->poller, nfc_maker_writer_poller_callback, instance);
+}
+
+void nfc_maker_writer_stop(NfcMakerWriter* instance) {
+    furi_assert(instance);
+
+    if(instance->poller) {
+        nfc_poller_stop(instance->poller);
+        nfc_poller_free(instance->poller);
+        instance->poller = NULL;
+    }
+    instance->image = NULL;
+}
+
+void nfc_maker_writer_set_image(NfcMakerWriter* instance, const uint8_t* image, size_t used) {
+    furi_assert(instance);
+    furi_assert(image);
+
+    instance->used = used;
+    instance->image = image;
+}
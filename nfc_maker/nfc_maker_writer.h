@@ -0,0 +1,36 @@
+#pragma once
+
+#include <nfc/nfc.h>
+
+/*
+ * Writes NDEF images to NTAG21x tags one after another as they are presented.
+ *
+ * A tag is only written once, the writer waits for it to leave the field before picking
+ * up the next one, so holding a tag on the back of the Flipper doesn't consume the batch.
+ */
+typedef struct NfcMakerWriter NfcMakerWriter;
+
+typedef enum {
+    NfcMakerWriterEventWritten, // Image written, a new one can be set
+    NfcMakerWriterEventFail, // Not an NTAG or too small, the image is kept for the next tag
+} NfcMakerWriterEvent;
+
+typedef void (*NfcMakerWriterCallback)(NfcMakerWriterEvent event, void* context);
+
+NfcMakerWriter* nfc_maker_writer_alloc(Nfc* nfc);
+
+void nfc_maker_writer_free(NfcMakerWriter* instance);
+
+void nfc_maker_writer_start(
+    NfcMakerWriter* instance,
+    NfcMakerWriterCallback callback,
+    void* context);
+
+void nfc_maker_writer_stop(NfcMakerWriter* instance);
+
+/** Queue the image for the next tag, the buffer must stay valid until it is written
+ *
+ * @param image NTAG215 image, pages 0-3 are left untouched on the tag
+ * @param used bytes of the image up to the NDEF terminator
+ */
+void nfc_maker_writer_set_image(NfcMakerWriter* instance, const uint8_t* image, size_t used);
@@ -0,0 +1,117 @@
+#include "../nfc_maker.h"
+#include "../nfc_maker_batch.h"
+#include <toolbox/path.h>
+
+enum BatchExportEvent {
+    BatchExportEventNext = 100,
+    BatchExportEventExit,
+};
+
+typedef struct {
+    FlipperFormat* file;
+    FuriString* name;
+    FuriString* path;
+    char text[32];
+    uint16_t saved;
+    uint16_t skipped;
+} NfcMakerSceneBatchExport;
+
+static NfcMakerSceneBatchExport* batch_export;
+
+static void nfc_maker_scene_batch_export_popup_callback(void* context) {
+    NfcMaker* app = context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, BatchExportEventExit);
+}
+
+static void nfc_maker_scene_batch_export_done(NfcMaker* app) {
+    Popup* popup = app->popup;
+    popup_set_header(popup, "Done!", 64, 20, AlignCenter, AlignCenter);
+    snprintf(
+        batch_export->text,
+        sizeof(batch_export->text),
+        "Saved %u, skipped %u",
+        batch_export->saved,
+        batch_export->skipped);
+    popup_set_text(popup, batch_export->text, 64, 40, AlignCenter, AlignCenter);
+    popup_set_timeout(popup, 3000);
+    popup_set_context(popup, app);
+    popup_set_callback(popup, nfc_maker_scene_batch_export_popup_callback);
+    popup_enable_timeout(popup);
+}
+
+void nfc_maker_scene_batch_export_on_enter(void* context) {
+    NfcMaker* app = context;
+
+    batch_export = malloc(sizeof(NfcMakerSceneBatchExport));
+    batch_export->file = flipper_format_file_alloc(furi_record_open(RECORD_STORAGE));
+    batch_export->name = furi_string_alloc();
+    batch_export->path = furi_string_alloc();
+    path_extract_filename(app->batch_path, batch_export->name, true);
+
+    nfc_maker_batch_rewind(app->batch);
+    popup_set_header(app->popup, "Exporting...", 64, 20, AlignCenter, AlignCenter);
+    view_dispatcher_switch_to_view(app->view_dispatcher, NfcMakerViewPopup);
+
+    // One row per event, keeps the view responsive and back working on long files
+    view_dispatcher_send_custom_event(app->view_dispatcher, BatchExportEventNext);
+}
+
+bool nfc_maker_scene_batch_export_on_event(void* context, SceneManagerEvent event) {
+    NfcMaker* app = context;
+    bool consumed = false;
+
+    if(event.type == SceneManagerEventTypeCustom) {
+        consumed = true;
+        if(event.event == BatchExportEventNext) {
+            NfcMakerBatchRow row = nfc_maker_batch_next(app->batch, app);
+            size_t index = nfc_maker_batch_get_row_index(app->batch);
+            if(row == NfcMakerBatchRowEnd) {
+                nfc_maker_scene_batch_export_done(app);
+                return consumed;
+            }
+
+            bool saved = false;
+            if(row == NfcMakerBatchRowOk) {
+                furi_string_printf(
+                    batch_export->path,
+                    NFC_APP_FOLDER "/%s_%03zu" NFC_APP_EXTENSION,
+                    furi_string_get_cstr(batch_export->name),
+                    index);
+                saved = nfc_maker_ndef_save(
+                    batch_export->file,
+                    furi_string_get_cstr(batch_export->path),
+                    nfc_maker_batch_get_image(app->batch));
+            }
+            if(saved) {
+                batch_export->saved++;
+            } else {
+                batch_export->skipped++;
+            }
+
+            snprintf(
+                batch_export->text,
+                sizeof(batch_export->text),
+                "Row %zu/%zu",
+                index,
+                nfc_maker_batch_get_row_count(app->batch));
+            popup_set_text(app->popup, batch_export->text, 64, 40, AlignCenter, AlignCenter);
+            view_dispatcher_send_custom_event(app->view_dispatcher, BatchExportEventNext);
+        } else if(event.event == BatchExportEventExit) {
+            scene_manager_previous_scene(app->scene_manager);
+        }
+    }
+
+    return consumed;
+}
+
+void nfc_maker_scene_batch_export_on_exit(void* context) {
+    NfcMaker* app = context;
+    popup_reset(app->popup);
+
+    flipper_format_free(batch_export->file);
+    furi_record_close(RECORD_STORAGE);
+    furi_string_free(batch_export->name);
+    furi_string_free(batch_export->path);
+    free(batch_export);
+    batch_export = NULL;
+}
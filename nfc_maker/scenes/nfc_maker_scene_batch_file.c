@@ -0,0 +1,32 @@
+#include "../nfc_maker.h"
+#include "../nfc_maker_batch.h"
+
+void nfc_maker_scene_batch_file_on_enter(void* context) {
+    NfcMaker* app = context;
+
+    DialogsFileBrowserOptions browser_options;
+    dialog_file_browser_set_basic_options(
+        &browser_options, NFC_MAKER_BATCH_EXTENSION, &I_Nfc_10px);
+    browser_options.base_path = NFC_APP_FOLDER;
+
+    DialogsApp* dialogs = furi_record_open(RECORD_DIALOGS);
+    bool success =
+        dialog_file_browser_show(dialogs, app->batch_path, app->batch_path, &browser_options);
+    furi_record_close(RECORD_DIALOGS);
+
+    if(success) {
+        scene_manager_next_scene(app->scene_manager, NfcMakerSceneBatchMenu);
+    } else {
+        scene_manager_previous_scene(app->scene_manager);
+    }
+}
+
+bool nfc_maker_scene_batch_file_on_event(void* context, SceneManagerEvent event) {
+    UNUSED(context);
+    UNUSED(event);
+    return false;
+}
+
+void nfc_maker_scene_batch_file_on_exit(void* context) {
+    UNUSED(context);
+}
@@ -0,0 +1,108 @@
+#include "../nfc_maker.h"
+#include "../nfc_maker_batch.h"
+
+enum SubmenuIndex {
+    SubmenuIndexExport,
+    SubmenuIndexWrite,
+};
+
+// Batch scenes post events to themselves, ids are kept apart so leftovers can be ignored
+enum PopupEvent {
+    PopupEventExit = 10,
+};
+
+static void nfc_maker_scene_batch_menu_submenu_callback(void* context, uint32_t index) {
+    NfcMaker* app = context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, index);
+}
+
+static void nfc_maker_scene_batch_menu_popup_callback(void* context) {
+    NfcMaker* app = context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, PopupEventExit);
+}
+
+void nfc_maker_scene_batch_menu_on_enter(void* context) {
+    NfcMaker* app = context;
+
+    if(!nfc_maker_batch_open(app->batch, furi_string_get_cstr(app->batch_path))) {
+        Popup* popup = app->popup;
+        popup_set_header(popup, "Invalid CSV", 64, 20, AlignCenter, AlignCenter);
+        popup_set_text(
+            popup, "First cell must be\nthe record type", 64, 40, AlignCenter, AlignCenter);
+        popup_set_timeout(popup, 2000);
+        popup_set_context(popup, app);
+        popup_set_callback(popup, nfc_maker_scene_batch_menu_popup_callback);
+        popup_enable_timeout(popup);
+        view_dispatcher_switch_to_view(app->view_dispatcher, NfcMakerViewPopup);
+        return;
+    }
+
+    Submenu* submenu = app->submenu;
+    char header[32];
+    snprintf(
+        header,
+        sizeof(header),
+        "%s: %zu rows",
+        nfc_maker_batch_get_type_name(app->batch),
+        nfc_maker_batch_get_row_count(app->batch));
+    submenu_set_header(submenu, header);
+
+    submenu_add_item(
+        submenu,
+        "Export .nfc files",
+        SubmenuIndexExport,
+        nfc_maker_scene_batch_menu_submenu_callback,
+        app);
+
+    submenu_add_item(
+        submenu,
+        "Write tags",
+        SubmenuIndexWrite,
+        nfc_maker_scene_batch_menu_submenu_callback,
+        app);
+
+    submenu_set_selected_item(
+        submenu, scene_manager_get_scene_state(app->scene_manager, NfcMakerSceneBatchMenu));
+
+    view_dispatcher_switch_to_view(app->view_dispatcher, NfcMakerViewSubmenu);
+}
+
+bool nfc_maker_scene_batch_menu_on_event(void* context, SceneManagerEvent event) {
+    NfcMaker* app = context;
+    bool consumed = false;
+
+    if(event.type == SceneManagerEventTypeCustom) {
+        consumed = true;
+        switch(event.event) {
+        case SubmenuIndexExport:
+            scene_manager_set_scene_state(app->scene_manager, NfcMakerSceneBatchMenu, event.event);
+            scene_manager_next_scene(app->scene_manager, NfcMakerSceneBatchExport);
+            break;
+        case SubmenuIndexWrite:
+            scene_manager_set_scene_state(app->scene_manager, NfcMakerSceneBatchMenu, event.event);
+            scene_manager_next_scene(app->scene_manager, NfcMakerSceneBatchWrite);
+            break;
+        case PopupEventExit:
+            nfc_maker_batch_close(app->batch);
+            scene_manager_search_and_switch_to_previous_scene(
+                app->scene_manager, NfcMakerSceneStart);
+            break;
+        default:
+            // Leftovers from the batch scenes
+            break;
+        }
+    } else if(event.type == SceneManagerEventTypeBack) {
+        // Skip the file browser
+        consumed = true;
+        nfc_maker_batch_close(app->batch);
+        scene_manager_search_and_switch_to_previous_scene(app->scene_manager, NfcMakerSceneStart);
+    }
+
+    return consumed;
+}
+
+void nfc_maker_scene_batch_menu_on_exit(void* context) {
+    NfcMaker* app = context;
+    submenu_reset(app->submenu);
+    popup_reset(app->popup);
+}
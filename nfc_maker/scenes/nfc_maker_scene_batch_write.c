@@ -0,0 +1,138 @@
+#include "../nfc_maker.h"
+#include "../nfc_maker_batch.h"
+
+enum BatchWriteEvent {
+    BatchWriteEventWritten = 200,
+    BatchWriteEventFail,
+    BatchWriteEventExit,
+};
+
+typedef struct {
+    char text[48];
+    uint16_t written;
+    uint16_t skipped;
+} NfcMakerSceneBatchWrite;
+
+static NfcMakerSceneBatchWrite* batch_write;
+
+static void nfc_maker_scene_batch_write_writer_callback(NfcMakerWriterEvent event, void* context) {
+    NfcMaker* app = context;
+    view_dispatcher_send_custom_event(
+        app->view_dispatcher,
+        event == NfcMakerWriterEventWritten ? BatchWriteEventWritten : BatchWriteEventFail);
+}
+
+static void nfc_maker_scene_batch_write_popup_callback(void* context) {
+    NfcMaker* app = context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, BatchWriteEventExit);
+}
+
+// Queue the next valid row for the writer, false at the end of the file
+static bool nfc_maker_scene_batch_write_next(NfcMaker* app) {
+    NfcMakerBatchRow row;
+    while((row = nfc_maker_batch_next(app->batch, app)) == NfcMakerBatchRowInvalid) {
+        batch_write->skipped++;
+    }
+    if(row == NfcMakerBatchRowEnd) return false;
+
+    nfc_maker_writer_set_image(
+        app->writer,
+        nfc_maker_batch_get_image(app->batch),
+        nfc_maker_batch_get_image_used(app->batch));
+
+    Popup* popup = app->popup;
+    popup_set_header(popup, "Apply tag", 64, 12, AlignCenter, AlignCenter);
+    snprintf(
+        batch_write->text,
+        sizeof(batch_write->text),
+        "Row %zu/%zu\nWritten %u",
+        nfc_maker_batch_get_row_index(app->batch),
+        nfc_maker_batch_get_row_count(app->batch),
+        batch_write->written);
+    popup_set_text(popup, batch_write->text, 64, 40, AlignCenter, AlignCenter);
+
+    return true;
+}
+
+static void nfc_maker_scene_batch_write_done(NfcMaker* app) {
+    nfc_maker_writer_stop(app->writer);
+
+    Popup* popup = app->popup;
+    popup_set_header(popup, "Done!", 64, 20, AlignCenter, AlignCenter);
+    snprintf(
+        batch_write->text,
+        sizeof(batch_write->text),
+        "Written %u, skipped %u",
+        batch_write->written,
+        batch_write->skipped);
+    popup_set_text(popup, batch_write->text, 64, 40, AlignCenter, AlignCenter);
+    popup_set_timeout(popup, 3000);
+    popup_set_context(popup, app);
+    popup_set_callback(popup, nfc_maker_scene_batch_write_popup_callback);
+    popup_enable_timeout(popup);
+}
+
+void nfc_maker_scene_batch_write_on_enter(void* context) {
+    NfcMaker* app = context;
+
+    batch_write = malloc(sizeof(NfcMakerSceneBatchWrite));
+    app->nfc = nfc_alloc();
+    app->writer = nfc_maker_writer_alloc(app->nfc);
+
+    nfc_maker_batch_rewind(app->batch);
+    view_dispatcher_switch_to_view(app->view_dispatcher, NfcMakerViewPopup);
+
+    if(nfc_maker_scene_batch_write_next(app)) {
+        nfc_maker_writer_start(app->writer, nfc_maker_scene_batch_write_writer_callback, app);
+    } else {
+        nfc_maker_scene_batch_write_done(app);
+    }
+}
+
+bool nfc_maker_scene_batch_write_on_event(void* context, SceneManagerEvent event) {
+    NfcMaker* app = context;
+    bool consumed = false;
+
+    if(event.type == SceneManagerEventTypeCustom) {
+        consumed = true;
+        switch(event.event) {
+        case BatchWriteEventWritten:
+            batch_write->written++;
+            if(!nfc_maker_scene_batch_write_next(app)) {
+                nfc_maker_scene_batch_write_done(app);
+            }
+            break;
+        case BatchWriteEventFail:
+            popup_set_header(app->popup, "Write failed", 64, 12, AlignCenter, AlignCenter);
+            snprintf(
+                batch_write->text,
+                sizeof(batch_write->text),
+                "Row %zu/%zu\nTry another tag",
+                nfc_maker_batch_get_row_index(app->batch),
+                nfc_maker_batch_get_row_count(app->batch));
+            popup_set_text(app->popup, batch_write->text, 64, 40, AlignCenter, AlignCenter);
+            break;
+        case BatchWriteEventExit:
+            scene_manager_previous_scene(app->scene_manager);
+            break;
+        default:
+            break;
+        }
+    }
+
+    return consumed;
+}
+
+void nfc_maker_scene_batch_write_on_exit(void* context) {
+    NfcMaker* app = context;
+
+    nfc_maker_writer_stop(app->writer);
+    nfc_maker_writer_free(app->writer);
+    app->writer = NULL;
+    nfc_free(app->nfc);
+    app->nfc = NULL;
+
+    popup_reset(app->popup);
+    free(batch_write);
+    batch_write = NULL;
+}
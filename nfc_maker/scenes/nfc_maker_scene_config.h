@@ -16,3 +16,7 @@ ADD_SCENE(nfc_maker, wifi_encr, WifiEncr)
 ADD_SCENE(nfc_maker, wifi_pass, WifiPass)
 ADD_SCENE(nfc_maker, save, Save)
 ADD_SCENE(nfc_maker, result, Result)
+ADD_SCENE(nfc_maker, batch_file, BatchFile)
+ADD_SCENE(nfc_maker, batch_menu, BatchMenu)
+ADD_SCENE(nfc_maker, batch_export, BatchExport)
+ADD_SCENE(nfc_maker, batch_write, BatchWrite)
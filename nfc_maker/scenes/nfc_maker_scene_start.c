@@ -43,6 +43,13 @@ void nfc_maker_scene_start_on_enter(void* context) {
     submenu_add_item(
         submenu, "WiFi Login", NfcMakerSceneWifi, nfc_maker_scene_start_submenu_callback, app);
 
+    submenu_add_item(
+        submenu,
+        "Batch from CSV",
+        NfcMakerSceneBatchFile,
+        nfc_maker_scene_start_submenu_callback,
+        app);
+
     submenu_set_selected_item(
         submenu, scene_manager_get_scene_state(app->scene_manager, NfcMakerSceneStart));
 
@@ -4,4 +4,6 @@ typedef enum {
     //NfcRfidDetectorCustomEvent
     NfcRfidDetectorCustomEventStartId = 100,
 
+    NfcRfidDetectorCustomEventHistogram,
+
 } NfcRfidDetectorCustomEvent;
@@ -0,0 +1,162 @@
+#include "nfc_rfid_detector_sampler.h"
+
+#define TAG "NfcRfidDetectorSampler"
+
+#define NFC_RFID_DETECTOR_SAMPLER_PERIOD_MS (5)
+// LF frequency is counted by the HAL timers over a fixed gate, sampling faster only repeats it
+#define NFC_RFID_DETECTOR_SAMPLER_RFID_DIVIDER (20)
+
+// Rolling windows: 2 s of NFC presence and 6.4 s of LF readings
+#define NFC_RFID_DETECTOR_SAMPLER_NFC_WINDOW (400)
+#define NFC_RFID_DETECTOR_SAMPLER_RFID_WINDOW (64)
+
+#define NFC_RFID_DETECTOR_SAMPLER_FLAG_STOP (1UL << 0)
+
+struct NfcRfidDetectorSampler {
+    FuriThread* thread;
+    FuriMutex* mutex;
+
+    bool nfc_window[NFC_RFID_DETECTOR_SAMPLER_NFC_WINDOW];
+    uint16_t nfc_index;
+    uint16_t nfc_count;
+    uint16_t nfc_present;
+
+    // 0 when no field was found
+    uint32_t rfid_window[NFC_RFID_DETECTOR_SAMPLER_RFID_WINDOW];
+    uint16_t rfid_index;
+    uint16_t rfid_count;
+};
+
+static void nfc_rfid_detector_sampler_reset(NfcRfidDetectorSampler* instance) {
+    memset(instance->nfc_window, 0, sizeof(instance->nfc_window));
+    instance->nfc_index = 0;
+    instance->nfc_count = 0;
+    instance->nfc_present = 0;
+
+    memset(instance->rfid_window, 0, sizeof(instance->rfid_window));
+    instance->rfid_index = 0;
+    instance->rfid_count = 0;
+}
+
+static void nfc_rfid_detector_sampler_add_nfc(NfcRfidDetectorSampler* instance, bool present) {
+    if(instance->nfc_count == NFC_RFID_DETECTOR_SAMPLER_NFC_WINDOW) {
+        // Window is full, the oldest sample drops out
+        if(instance->nfc_window[instance->nfc_index]) instance->nfc_present--;
+    } else {
+        instance->nfc_count++;
+    }
+    instance->nfc_window[instance->nfc_index] = present;
+    if(present) instance->nfc_present++;
+    instance->nfc_index = (instance->nfc_index + 1) % NFC_RFID_DETECTOR_SAMPLER_NFC_WINDOW;
+}
+
+static void nfc_rfid_detector_sampler_add_rfid(NfcRfidDetectorSampler* instance, uint32_t freq) {
+    instance->rfid_window[instance->rfid_index] = freq;
+    instance->rfid_index = (instance->rfid_index + 1) % NFC_RFID_DETECTOR_SAMPLER_RFID_WINDOW;
+    if(instance->rfid_count < NFC_RFID_DETECTOR_SAMPLER_RFID_WINDOW) instance->rfid_count++;
+}
+
+static int32_t nfc_rfid_detector_sampler_thread(void* context) {
+    NfcRfidDetectorSampler* instance = context;
+    uint32_t cycle = 0;
+
+    FURI_LOG_D(TAG, "Start");
+    while(true) {
+        uint32_t flags = furi_thread_flags_wait(
+            NFC_RFID_DETECTOR_SAMPLER_FLAG_STOP,
+            FuriFlagWaitAny,
+            furi_ms_to_ticks(NFC_RFID_DETECTOR_SAMPLER_PERIOD_MS));
+        if(!(flags & FuriFlagError) && (flags & NFC_RFID_DETECTOR_SAMPLER_FLAG_STOP)) break;
+
+        bool nfc_present = furi_hal_nfc_field_is_present();
+
+        uint32_t frequency = 0;
+        bool rfid_sample = (cycle++ % NFC_RFID_DETECTOR_SAMPLER_RFID_DIVIDER) == 0;
+        if(rfid_sample && !furi_hal_rfid_field_is_present(&frequency)) {
+            frequency = 0;
+        }
+
+        furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+        nfc_rfid_detector_sampler_add_nfc(instance, nfc_present);
+        if(rfid_sample) nfc_rfid_detector_sampler_add_rfid(instance, frequency);
+        furi_mutex_release(instance->mutex);
+    }
+    FURI_LOG_D(TAG, "Stop");
+
+    return 0;
+}
+
+NfcRfidDetectorSampler* nfc_rfid_detector_sampler_alloc() {
+    NfcRfidDetectorSampler* instance = malloc(sizeof(NfcRfidDetectorSampler));
+
+    instance->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    instance->thread = furi_thread_alloc_ex(
+        "NfcRfidDetectorSampler", 1024, nfc_rfid_detector_sampler_thread, instance);
+    furi_thread_set_priority(instance->thread, FuriThreadPriorityHigh);
+
+    return instance;
+}
+
+void nfc_rfid_detector_sampler_free(NfcRfidDetectorSampler* instance) {
+    furi_assert(instance);
+
+    furi_thread_free(instance->thread);
+    furi_mutex_free(instance->mutex);
+    free(instance);
+}
+
+void nfc_rfid_detector_sampler_start(NfcRfidDetectorSampler* instance) {
+    furi_assert(instance);
+
+    nfc_rfid_detector_sampler_reset(instance);
+    furi_thread_start(instance->thread);
+}
+
+void nfc_rfid_detector_sampler_stop(NfcRfidDetectorSampler* instance) {
+    furi_assert(instance);
+
+    furi_thread_flags_set(
+        furi_thread_get_id(instance->thread), NFC_RFID_DETECTOR_SAMPLER_FLAG_STOP);
+    furi_thread_join(instance->thread);
+}
+
+void nfc_rfid_detector_sampler_get_stats(
+    NfcRfidDetectorSampler* instance,
+    NfcRfidDetectorSamplerStats* stats) {
+    furi_assert(instance);
+    furi_assert(stats);
+
+    memset(stats, 0, sizeof(NfcRfidDetectorSamplerStats));
+
+    furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+
+    if(instance->nfc_count) {
+        stats->nfc_presence = instance->nfc_present * 100 / instance->nfc_count;
+    }
+
+    uint32_t rfid_sum = 0;
+    uint16_t rfid_present = 0;
+    for(size_t i = 0; i < instance->rfid_count; i++) {
+        uint32_t frequency = instance->rfid_window[i];
+        if(!frequency) continue;
+
+        int32_t bin = ((int32_t)frequency - (int32_t)NFC_RFID_DETECTOR_SAMPLER_BIN_START_HZ) /
+                      (int32_t)NFC_RFID_DETECTOR_SAMPLER_BIN_WIDTH_HZ;
+        bin = CLAMP(bin, NFC_RFID_DETECTOR_SAMPLER_BINS - 1, 0);
+        stats->rfid_bins[bin]++;
+        stats->rfid_bin_max = MAX(stats->rfid_bin_max, stats->rfid_bins[bin]);
+
+        if(!rfid_present || frequency < stats->rfid_frequency_min) {
+            stats->rfid_frequency_min = frequency;
+        }
+        stats->rfid_frequency_max = MAX(stats->rfid_frequency_max, frequency);
+        rfid_sum += frequency;
+        rfid_present++;
+    }
+    if(rfid_present) {
+        stats->rfid_frequency_avg = rfid_sum / rfid_present;
+        stats->rfid_presence = rfid_present * 100 / instance->rfid_count;
+    }
+
+    furi_mutex_release(instance->mutex);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <furi.h>
+#include <furi_hal.h>
+
+// LF histogram covers 110..150 KHz, readers sit at 125 KHz (EM/HID) and 134.2 KHz (FDX/HDX)
+#define NFC_RFID_DETECTOR_SAMPLER_BINS (40)
+#define NFC_RFID_DETECTOR_SAMPLER_BIN_START_HZ (110000UL)
+#define NFC_RFID_DETECTOR_SAMPLER_BIN_WIDTH_HZ (1000UL)
+
+typedef struct {
+    // LF frequency distribution over the rolling window, out of range readings land on the edges
+    uint16_t rfid_bins[NFC_RFID_DETECTOR_SAMPLER_BINS];
+    uint16_t rfid_bin_max;
+    uint32_t rfid_frequency_avg;
+    uint32_t rfid_frequency_min;
+    uint32_t rfid_frequency_max;
+    // Share of the window the field was seen, in percent. Drops as the reader gets out of reach
+    uint8_t rfid_presence;
+    uint8_t nfc_presence;
+} NfcRfidDetectorSamplerStats;
+
+typedef struct NfcRfidDetectorSampler NfcRfidDetectorSampler;
+
+NfcRfidDetectorSampler* nfc_rfid_detector_sampler_alloc();
+
+void nfc_rfid_detector_sampler_free(NfcRfidDetectorSampler* instance);
+
+/** Start sampling, field detection must already be running */
+void nfc_rfid_detector_sampler_start(NfcRfidDetectorSampler* instance);
+
+void nfc_rfid_detector_sampler_stop(NfcRfidDetectorSampler* instance);
+
+/** Snapshot of the rolling window, safe to call from the GUI thread */
+void nfc_rfid_detector_sampler_get_stats(
+    NfcRfidDetectorSampler* instance,
+    NfcRfidDetectorSamplerStats* stats);
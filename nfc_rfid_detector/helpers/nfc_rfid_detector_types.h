@@ -11,5 +11,6 @@ typedef enum {
     NfcRfidDetectorViewVariableItemList,
     NfcRfidDetectorViewSubmenu,
     NfcRfidDetectorViewFieldPresence,
+    NfcRfidDetectorViewHistogram,
     NfcRfidDetectorViewWidget,
 } NfcRfidDetectorView;
@@ -62,6 +62,15 @@ NfcRfidDetectorApp* nfc_rfid_detector_app_alloc() {
         NfcRfidDetectorViewFieldPresence,
         nfc_rfid_detector_view_field_presence_get_view(app->nfc_rfid_detector_field_presence));
 
+    // Histogram
+    app->nfc_rfid_detector_histogram = nfc_rfid_detector_view_histogram_alloc();
+    view_dispatcher_add_view(
+        app->view_dispatcher,
+        NfcRfidDetectorViewHistogram,
+        nfc_rfid_detector_view_histogram_get_view(app->nfc_rfid_detector_histogram));
+
+    app->sampler = nfc_rfid_detector_sampler_alloc();
+
     scene_manager_next_scene(app->scene_manager, NfcRfidDetectorSceneFieldPresence);
 
     return app;
@@ -82,6 +91,12 @@ void nfc_rfid_detector_app_free(NfcRfidDetectorApp* app) {
     view_dispatcher_remove_view(app->view_dispatcher, NfcRfidDetectorViewFieldPresence);
     nfc_rfid_detector_view_field_presence_free(app->nfc_rfid_detector_field_presence);
 
+    // Histogram
+    view_dispatcher_remove_view(app->view_dispatcher, NfcRfidDetectorViewHistogram);
+    nfc_rfid_detector_view_histogram_free(app->nfc_rfid_detector_histogram);
+
+    nfc_rfid_detector_sampler_free(app->sampler);
+
     // View dispatcher
     view_dispatcher_free(app->view_dispatcher);
     scene_manager_free(app->scene_manager);
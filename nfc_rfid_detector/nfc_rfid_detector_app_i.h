@@ -11,6 +11,8 @@
 #include <gui/modules/widget.h>
 #include <notification/notification_messages.h>
 #include "views/nfc_rfid_detector_view_field_presence.h"
+#include "views/nfc_rfid_detector_view_histogram.h"
+#include "helpers/nfc_rfid_detector_sampler.h"
 
 typedef struct NfcRfidDetectorApp NfcRfidDetectorApp;
 
@@ -22,6 +24,8 @@ struct NfcRfidDetectorApp {
     Submenu* submenu;
     Widget* widget;
     NfcRfidDetectorFieldPresence* nfc_rfid_detector_field_presence;
+    NfcRfidDetectorHistogram* nfc_rfid_detector_histogram;
+    NfcRfidDetectorSampler* sampler;
 };
 
 void nfc_rfid_detector_app_field_presence_start(NfcRfidDetectorApp* app);
@@ -1 +1,2 @@
 ADD_SCENE(nfc_rfid_detector, field_presence, FieldPresence)
+ADD_SCENE(nfc_rfid_detector, histogram, Histogram)
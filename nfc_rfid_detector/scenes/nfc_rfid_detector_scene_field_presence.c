@@ -37,6 +37,11 @@ void nfc_rfid_detector_scene_field_presence_on_enter(void* context) {
     // Start detection of field presence
     nfc_rfid_detector_app_field_presence_start(app);
 
+    nfc_rfid_detector_view_field_presence_set_callback(
+        app->nfc_rfid_detector_field_presence,
+        nfc_rfid_detector_scene_field_presence_callback,
+        app);
+
     view_dispatcher_switch_to_view(app->view_dispatcher, NfcRfidDetectorViewFieldPresence);
 }
 
@@ -47,6 +52,11 @@ bool nfc_rfid_detector_scene_field_presence_on_event(void* context, SceneManager
 
     if(event.type == SceneManagerEventTypeTick) {
         nfc_rfid_detector_scene_field_presence_update(app);
+    } else if(event.type == SceneManagerEventTypeCustom) {
+        if(event.event == NfcRfidDetectorCustomEventHistogram) {
+            scene_manager_next_scene(app->scene_manager, NfcRfidDetectorSceneHistogram);
+            consumed = true;
+        }
     }
 
     return consumed;
@@ -0,0 +1,52 @@
+#include "../nfc_rfid_detector_app_i.h"
+#include "../views/nfc_rfid_detector_view_histogram.h"
+
+static const NotificationSequence notification_app_display_on = {
+
+    &message_display_backlight_on,
+    NULL,
+};
+
+static void nfc_rfid_detector_scene_histogram_update(void* context) {
+    furi_assert(context);
+    NfcRfidDetectorApp* app = context;
+
+    NfcRfidDetectorSamplerStats stats;
+    nfc_rfid_detector_sampler_get_stats(app->sampler, &stats);
+
+    if(stats.nfc_presence || stats.rfid_presence)
+        notification_message(app->notifications, &notification_app_display_on);
+
+    nfc_rfid_detector_view_histogram_update(app->nfc_rfid_detector_histogram, &stats);
+}
+
+void nfc_rfid_detector_scene_histogram_on_enter(void* context) {
+    furi_assert(context);
+    NfcRfidDetectorApp* app = context;
+
+    // Sampling runs on its own thread, ticks only pick up the rolling window
+    nfc_rfid_detector_app_field_presence_start(app);
+    nfc_rfid_detector_sampler_start(app->sampler);
+
+    view_dispatcher_switch_to_view(app->view_dispatcher, NfcRfidDetectorViewHistogram);
+}
+
+bool nfc_rfid_detector_scene_histogram_on_event(void* context, SceneManagerEvent event) {
+    furi_assert(context);
+    NfcRfidDetectorApp* app = context;
+    bool consumed = false;
+
+    if(event.type == SceneManagerEventTypeTick) {
+        nfc_rfid_detector_scene_histogram_update(app);
+    }
+
+    return consumed;
+}
+
+void nfc_rfid_detector_scene_histogram_on_exit(void* context) {
+    furi_assert(context);
+    NfcRfidDetectorApp* app = context;
+
+    nfc_rfid_detector_sampler_stop(app->sampler);
+    nfc_rfid_detector_app_field_presence_stop(app);
+}
@@ -21,6 +21,8 @@ static const Icon* NfcRfidDetectorFieldPresenceIcons[] = {
 
 struct NfcRfidDetectorFieldPresence {
     View* view;
+    NfcRfidDetectorFieldPresenceCallback callback;
+    void* context;
 };
 
 typedef struct {
@@ -29,6 +31,15 @@ typedef struct {
     uint32_t rfid_frequency;
 } NfcRfidDetectorFieldPresenceModel;
 
+void nfc_rfid_detector_view_field_presence_set_callback(
+    NfcRfidDetectorFieldPresence* instance,
+    NfcRfidDetectorFieldPresenceCallback callback,
+    void* context) {
+    furi_assert(instance);
+    instance->callback = callback;
+    instance->context = context;
+}
+
 void nfc_rfid_detector_view_field_presence_update(
     NfcRfidDetectorFieldPresence* instance,
     bool nfc_field,
@@ -65,6 +76,7 @@ void nfc_rfid_detector_view_field_presence_draw(
         canvas_draw_icon(canvas, 22, 12, &I_Move_flipper_26x39);
         canvas_set_font(canvas, FontSecondary);
         canvas_draw_str(canvas, 56, 36, "Touch the reader");
+        canvas_draw_str(canvas, 56, 48, "OK: histogram");
     } else {
         if(model->nfc_field) {
             canvas_set_font(canvas, FontPrimary);
@@ -97,12 +109,15 @@ void nfc_rfid_detector_view_field_presence_draw(
 bool nfc_rfid_detector_view_field_presence_input(InputEvent* event, void* context) {
     furi_assert(context);
     NfcRfidDetectorFieldPresence* instance = context;
-    UNUSED(instance);
 
     if(event->key == InputKeyBack) {
         return false;
     }
 
+    if(event->key == InputKeyOk && event->type == InputTypeShort && instance->callback) {
+        instance->callback(NfcRfidDetectorCustomEventHistogram, instance->context);
+    }
+
     return true;
 }
 
@@ -6,6 +6,14 @@
 
 typedef struct NfcRfidDetectorFieldPresence NfcRfidDetectorFieldPresence;
 
+typedef void (
+    *NfcRfidDetectorFieldPresenceCallback)(NfcRfidDetectorCustomEvent event, void* context);
+
+void nfc_rfid_detector_view_field_presence_set_callback(
+    NfcRfidDetectorFieldPresence* instance,
+    NfcRfidDetectorFieldPresenceCallback callback,
+    void* context);
+
 void nfc_rfid_detector_view_field_presence_update(
     NfcRfidDetectorFieldPresence* instance,
     bool nfc_field,
@@ -0,0 +1,141 @@
+#include "nfc_rfid_detector_view_histogram.h"
+#include "../nfc_rfid_detector_app_i.h"
+
+#include <input/input.h>
+#include <gui/elements.h>
+
+#define HISTOGRAM_X (4)
+#define HISTOGRAM_BASE_Y (53)
+#define HISTOGRAM_HEIGHT (32)
+#define HISTOGRAM_BAR_STEP (3)
+
+struct NfcRfidDetectorHistogram {
+    View* view;
+};
+
+typedef struct {
+    NfcRfidDetectorSamplerStats stats;
+} NfcRfidDetectorHistogramModel;
+
+void nfc_rfid_detector_view_histogram_update(
+    NfcRfidDetectorHistogram* instance,
+    const NfcRfidDetectorSamplerStats* stats) {
+    furi_assert(instance);
+    furi_assert(stats);
+    with_view_model(
+        instance->view,
+        NfcRfidDetectorHistogramModel * model,
+        { model->stats = *stats; },
+        true);
+}
+
+static uint8_t nfc_rfid_detector_view_histogram_get_x(uint32_t frequency) {
+    uint32_t bin = (frequency - NFC_RFID_DETECTOR_SAMPLER_BIN_START_HZ) /
+                   NFC_RFID_DETECTOR_SAMPLER_BIN_WIDTH_HZ;
+    return HISTOGRAM_X + bin * HISTOGRAM_BAR_STEP;
+}
+
+void nfc_rfid_detector_view_histogram_draw(Canvas* canvas, NfcRfidDetectorHistogramModel* model) {
+    NfcRfidDetectorSamplerStats* stats = &model->stats;
+    char str[32];
+
+    canvas_clear(canvas);
+    canvas_set_color(canvas, ColorBlack);
+
+    canvas_set_font(canvas, FontSecondary);
+    snprintf(str, sizeof(str), "NFC %u%%", stats->nfc_presence);
+    canvas_draw_str_aligned(canvas, 0, 0, AlignLeft, AlignTop, str);
+    snprintf(str, sizeof(str), "LF %u%%", stats->rfid_presence);
+    canvas_draw_str_aligned(canvas, 128, 0, AlignRight, AlignTop, str);
+
+    if(stats->rfid_presence) {
+        snprintf(str, sizeof(str), "%.02f KHz", (double)stats->rfid_frequency_avg / 1000);
+        canvas_draw_str_aligned(canvas, 64, 0, AlignCenter, AlignTop, str);
+
+        // Spread of the window, a steady reader stays within a single bin
+        snprintf(
+            str,
+            sizeof(str),
+            "%.01f..%.01f",
+            (double)stats->rfid_frequency_min / 1000,
+            (double)stats->rfid_frequency_max / 1000);
+        canvas_draw_str_aligned(canvas, 64, 10, AlignCenter, AlignTop, str);
+    } else {
+        canvas_draw_str_aligned(canvas, 64, 0, AlignCenter, AlignTop, "No LF field");
+    }
+
+    // Bars are scaled to the tallest bin
+    for(size_t i = 0; i < NFC_RFID_DETECTOR_SAMPLER_BINS; i++) {
+        if(!stats->rfid_bins[i]) continue;
+        uint8_t height = MAX(stats->rfid_bins[i] * HISTOGRAM_HEIGHT / stats->rfid_bin_max, 1U);
+        canvas_draw_box(
+            canvas,
+            HISTOGRAM_X + i * HISTOGRAM_BAR_STEP,
+            HISTOGRAM_BASE_Y - height,
+            HISTOGRAM_BAR_STEP - 1,
+            height);
+    }
+    canvas_draw_line(canvas, 0, HISTOGRAM_BASE_Y, 127, HISTOGRAM_BASE_Y);
+
+    // Common reader carriers
+    uint8_t x_125 = nfc_rfid_detector_view_histogram_get_x(125000);
+    uint8_t x_134 = nfc_rfid_detector_view_histogram_get_x(134000);
+    canvas_draw_line(canvas, x_125, HISTOGRAM_BASE_Y, x_125, HISTOGRAM_BASE_Y + 2);
+    canvas_draw_line(canvas, x_134, HISTOGRAM_BASE_Y, x_134, HISTOGRAM_BASE_Y + 2);
+
+    canvas_draw_str_aligned(canvas, 0, 64, AlignLeft, AlignBottom, "110");
+    canvas_draw_str_aligned(canvas, x_125, 64, AlignCenter, AlignBottom, "125");
+    canvas_draw_str_aligned(canvas, x_134, 64, AlignCenter, AlignBottom, "134");
+    canvas_draw_str_aligned(canvas, 128, 64, AlignRight, AlignBottom, "150");
+}
+
+bool nfc_rfid_detector_view_histogram_input(InputEvent* event, void* context) {
+    furi_assert(context);
+    NfcRfidDetectorHistogram* instance = context;
+    UNUSED(instance);
+
+    if(event->key == InputKeyBack) {
+        return false;
+    }
+
+    return true;
+}
+
+void nfc_rfid_detector_view_histogram_enter(void* context) {
+    furi_assert(context);
+    NfcRfidDetectorHistogram* instance = context;
+    with_view_model(
+        instance->view,
+        NfcRfidDetectorHistogramModel * model,
+        { memset(&model->stats, 0, sizeof(model->stats)); },
+        true);
+}
+
+NfcRfidDetectorHistogram* nfc_rfid_detector_view_histogram_alloc() {
+    NfcRfidDetectorHistogram* instance = malloc(sizeof(NfcRfidDetectorHistogram));
+
+    // View allocation and configuration
+    instance->view = view_alloc();
+
+    view_allocate_model(
+        instance->view, ViewModelTypeLocking, sizeof(NfcRfidDetectorHistogramModel));
+    view_set_context(instance->view, instance);
+    view_set_draw_callback(
+        instance->view, (ViewDrawCallback)nfc_rfid_detector_view_histogram_draw);
+    view_set_input_callback(instance->view, nfc_rfid_detector_view_histogram_input);
+    view_set_enter_callback(instance->view, nfc_rfid_detector_view_histogram_enter);
+
+    return instance;
+}
+
+void nfc_rfid_detector_view_histogram_free(NfcRfidDetectorHistogram* instance) {
+    furi_assert(instance);
+
+    view_free(instance->view);
+    free(instance);
+}
+
+View* nfc_rfid_detector_view_histogram_get_view(NfcRfidDetectorHistogram* instance) {
+    furi_assert(instance);
+    return instance->view;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <gui/view.h>
+#include "../helpers/nfc_rfid_detector_types.h"
+#include "../helpers/nfc_rfid_detector_event.h"
+#include "../helpers/nfc_rfid_detector_sampler.h"
+
+typedef struct NfcRfidDetectorHistogram NfcRfidDetectorHistogram;
+
+void nfc_rfid_detector_view_histogram_update(
+    NfcRfidDetectorHistogram* instance,
+    const NfcRfidDetectorSamplerStats* stats);
+
+NfcRfidDetectorHistogram* nfc_rfid_detector_view_histogram_alloc();
+
+void nfc_rfid_detector_view_histogram_free(NfcRfidDetectorHistogram* instance);
+
+View* nfc_rfid_detector_view_histogram_get_view(NfcRfidDetectorHistogram* instance);
@@ -124,9 +124,15 @@ FuriString** Read_cmd = NULL; // Names of read cmd
 uint16_t Read_cmd_Total = 0;
 FuriString** Log = NULL; // Strings: var=n
 uint16_t Log_Total = 0;
+FuriString** Write_cmd = NULL; // W: and S: cmd, kept in memory to not re-read the file
+uint16_t Write_cmd_Total = 0;
 FuriString** ReadBatch_cmd = NULL; // Names of read batch cmd
 uint16_t ReadBatch_cmd_Total = 0;
-char* ReadBatch_cmd_curr = NULL; // =0xFFFFFFFF - finish
+uint16_t* ReadBatch_op = NULL; // running read batch, compiled to Read_cmd indexes
+uint16_t ReadBatch_op_Total = 0;
+uint16_t ReadBatch_op_curr = 0; // == _Total - finish
+char* ReadBatch_op_err = NULL; // name of the first unknown cmd of the batch
+uint8_t ReadBatch_op_err_len = 0;
 FuriString** WriteBatch_cmd = NULL; // Names of write batch cmd
 uint16_t WriteBatch_cmd_Total = 0;
 uint16_t WriteBatch_cmd_curr = 0; // == _Total - finish
@@ -309,6 +315,20 @@ void free_store(void) {
         free(Read_cmd);
         Read_cmd = NULL;
     }
+    if(Write_cmd_Total) {
+        for(uint16_t i = 0; i < Write_cmd_Total; i++) furi_string_free(Write_cmd[i]);
+        Write_cmd_Total = 0;
+    }
+    if(Write_cmd) {
+        free(Write_cmd);
+        Write_cmd = NULL;
+    }
+    if(ReadBatch_op) {
+        free(ReadBatch_op);
+        ReadBatch_op = NULL;
+    }
+    ReadBatch_op_Total = ReadBatch_op_curr = 0;
+    ReadBatch_op_err = NULL;
     if(ReadBatch_cmd_Total) {
         for(uint16_t i = 0; i < ReadBatch_cmd_Total; i++) furi_string_free(ReadBatch_cmd[i]);
         ReadBatch_cmd_Total = 0;
@@ -684,55 +704,74 @@ bool Run_Read_cmd(FuriString* cmd) {
     return true;
 }
 
+// Resolve the names of a read batch to Read_cmd indexes, stops at the first unknown name
+static bool Compile_ReadBatch_cmd(char* p) {
+    if(ReadBatch_op) free(ReadBatch_op);
+    ReadBatch_op_Total = ReadBatch_op_curr = 0;
+    ReadBatch_op_err = NULL;
+    uint16_t cnt = 1;
+    for(char* c = p; (c = strchr(c, ';')); c++) cnt++;
+    ReadBatch_op = malloc(sizeof(*ReadBatch_op) * cnt);
+    if(ReadBatch_op == NULL) {
+        ERR = 3;
+        strcpy(ERR_STR, "Memory low");
+        return false;
+    }
+    do {
+        char* end = strchr(p, ';');
+        uint8_t len;
+        if(end)
+            len = end - p;
+        else {
+            str_rtrim(p);
+            len = strlen(p);
+        }
+        uint16_t i = 0;
+        for(; i < Read_cmd_Total; i++) {
+            char* fs = (char*)furi_string_get_cstr(Read_cmd[i]);
+            if(strncmp(fs, p, len) == 0) {
+                char c = fs[len];
+                if(c == '=' || c == '*' || c == '[') break;
+            }
+        }
+        if(i == Read_cmd_Total) {
+            ReadBatch_op_err = p;
+            ReadBatch_op_err_len = len;
+            break;
+        }
+        ReadBatch_op[ReadBatch_op_Total++] = i;
+        p = end ? end + 1 : NULL;
+    } while(p);
+    return true;
+}
+
 // run commands one by one, true - command running
 bool Run_ReadBatch_cmd(FuriString* cmd) {
-    char* p;
     if(cmd) {
-        p = strchr((char*)furi_string_get_cstr(cmd), ':');
+        char* p = strchr((char*)furi_string_get_cstr(cmd), ':');
         if(p == NULL) {
             ERR = 5;
             strcpy(ERR_STR, "WRONG FORMAT");
             return false;
         }
-        p += 2;
-        ReadBatch_cmd_curr = NULL;
         free_Log();
-    } else {
-        if(ReadBatch_cmd_curr)
-            p = ReadBatch_cmd_curr;
-        else
-            return false;
-    }
-    char* end = strchr(p, ';');
-    uint8_t len;
-    if(end)
-        len = end - p;
-    else {
-        str_rtrim(p);
-        len = strlen(p);
+        if(!Compile_ReadBatch_cmd(p + 2)) return false;
     }
-    for(uint16_t i = 0; i < Read_cmd_Total; i++) {
-        FuriString* fs = Read_cmd[i];
-        if(strncmp((char*)furi_string_get_cstr(fs), p, len) == 0) {
-            char c = *((char*)furi_string_get_cstr(fs) + len);
-            if(c != '=' && c != '*' && c != '[') continue;
-            if(end)
-                ReadBatch_cmd_curr = end + 1;
-            else
-                ReadBatch_cmd_curr = (char*)0xFFFFFFFF;
-            if(!Run_Read_cmd(fs)) break;
-            return true;
-        }
-    }
-    if(NRF_ERROR) return false;
-    if(ERR == 0) {
+    if(ReadBatch_op_curr < ReadBatch_op_Total) {
+        if(Run_Read_cmd(Read_cmd[ReadBatch_op[ReadBatch_op_curr++]])) return true;
+    } else if(ReadBatch_op_err && ERR == 0 && !NRF_ERROR) {
         ERR = 4;
         strcpy(ERR_STR, "NOT FOUND");
         FuriString* fs = furi_string_alloc();
-        furi_string_set_strn(fs, p, len);
+        furi_string_set_strn(fs, ReadBatch_op_err, ReadBatch_op_err_len);
+        if(Log == NULL)
+            Log = malloc(sizeof(Log));
+        else
+            Log = realloc(Log, sizeof(Log) * (Log_Total + 1));
         Log[Log_Total++] = fs;
-        FURI_LOG_D(TAG, "CMD %s: %s", ERR_STR, p);
+        FURI_LOG_D(TAG, "CMD %s: %s", ERR_STR, furi_string_get_cstr(fs));
     }
+    if(NRF_ERROR) return false;
     view_Batch = Log_Total ? Log_Total - 1 : 0;
     return false;
 }
@@ -806,16 +845,8 @@ bool Run_WriteBatch_cmd() {
     FURI_LOG_D(
         TAG, "%cBatch: =%d, (%d)%s", rw_type == rwt_write_batch ? 'W' : 'S', (int)new, len, p);
     char *w, *delim_col, i, size;
-    FuriString* str = furi_string_alloc();
-    stream_rewind(file_stream);
-    while(stream_read_line(file_stream, str)) {
-        w = (char*)furi_string_get_cstr(str);
-        if(strncmp(w, SettingsFld_Write, sizeof(SettingsFld_Write) - 1) == 0)
-            w += sizeof(SettingsFld_Write);
-        else if(strncmp(w, SettingsFld_Set, sizeof(SettingsFld_Set) - 1) == 0)
-            w += sizeof(SettingsFld_Set);
-        else
-            continue;
+    for(uint16_t n = 0; n < Write_cmd_Total; n++) {
+        w = (char*)furi_string_get_cstr(Write_cmd[n]);
         delim_col = strchr(w, '=');
         if(delim_col == NULL) continue;
         size = 1;
@@ -827,7 +858,6 @@ bool Run_WriteBatch_cmd() {
             continue;
         if(strncmp(p, w, len) != 0) continue;
         delim_col++;
-        str_rtrim(delim_col);
         cmd_array_cnt = 255;
         do {
             memset(payload, 0, sizeof(payload));
@@ -976,6 +1006,21 @@ static uint8_t load_settings_file() {
                     break;
                 }
                 Read_cmd[Read_cmd_Total++] = furi_string_alloc_set_str(p);
+            } else if(
+                strncmp(p, SettingsFld_Write, sizeof(SettingsFld_Write) - 1) == 0 ||
+                strncmp(p, SettingsFld_Set, sizeof(SettingsFld_Set) - 1) == 0) {
+                p += sizeof(SettingsFld_Write); // same length as SettingsFld_Set
+                if(Write_cmd == NULL)
+                    Write_cmd = malloc(sizeof(Write_cmd));
+                else {
+                    Write_cmd = realloc(Write_cmd, sizeof(Write_cmd) * (Write_cmd_Total + 1));
+                }
+                if(Write_cmd == NULL) {
+                    FURI_LOG_D(TAG, "Memory low, err 8");
+                    err = 8;
+                    break;
+                }
+                Write_cmd[Write_cmd_Total++] = furi_string_alloc_set_str(p);
             } else if(strncmp(p, SettingsFld_ReadBatch, sizeof(SettingsFld_ReadBatch) - 1) == 0) {
                 p += sizeof(SettingsFld_ReadBatch);
                 if(ReadBatch_cmd == NULL)
@@ -1174,7 +1219,8 @@ void display_add_status(void) {
     else if(
         send_status == sst_ok &&
         (rw_type == rwt_read_cmd ||
-         (rw_type == rwt_read_batch && (uint32_t)ReadBatch_cmd_curr == 0xFFFFFFFF) ||
+         (rw_type == rwt_read_batch && ReadBatch_op_curr == ReadBatch_op_Total &&
+          ReadBatch_op_err == NULL) ||
          (rw_type == rwt_set_batch && SetBatch_cmd_curr == Log_Total) ||
          (rw_type == rwt_write_batch && WriteBatch_cmd_curr == Log_Total)))
         strcat(screen_buf, "OK");
@@ -1466,7 +1512,7 @@ void work_timer_callback(void* ctx) {
             }
         } else if(send_status == sst_ok) {
             if(rw_type == rwt_read_batch) {
-                if((uint32_t)ReadBatch_cmd_curr != 0xFFFFFFFF && ERR == 0 &&
+                if((ReadBatch_op_curr < ReadBatch_op_Total || ReadBatch_op_err) && ERR == 0 &&
                    furi_get_tick() - NRF_time >= delay_between_pkt) {
                     Run_ReadBatch_cmd(NULL);
                 }
@@ -24,6 +24,16 @@ static uint8_t currCh = 0; //for the progress bar or the channel selector
 
 static int delayPerChan = 150; //can set via up / down.
 
+//fast sweep: stay in RX, hop RF_CH and sample RPD in a burst after the PLL settles
+#define FAST_SETTLE_US 130 //PLL settle time after a channel change
+#define FAST_RPD_US 40 //RPD needs the receiver on for at least 40us
+#define FAST_BURST 4 //RPD samples per channel, ORed together
+#define WATERFALL_ROWS 52 //one row per sweep, fills the area under the header
+static bool isFastScan = false; //toggled via long up
+static uint8_t waterfall[WATERFALL_ROWS][128 / 8] = {0}; //1 bit per channel, XBM row layout
+static uint8_t waterfallHead = 0; //next row to write
+static uint8_t waterfallCount = 0; //rows filled so far
+
 bool showFreq = true;
 
 FuriThread* thread;
@@ -67,7 +77,7 @@ static void draw_callback(Canvas* canvas, void* ctx) {
     if(szuz) {
         canvas_set_font(canvas, FontSecondary);
         canvas_draw_str(canvas, 1, 22, "OK: scan / stop. Long: infinite.");
-        canvas_draw_str(canvas, 1, 33, "Up / Down to change channel time.");
+        canvas_draw_str(canvas, 1, 33, "Up / Down: ch. time. Long: fast");
         canvas_draw_str(canvas, 1, 44, "Left / Right to select channel");
         canvas_draw_str(canvas, 1, 56, "  to get it's frequency");
     }
@@ -81,7 +91,9 @@ static void draw_callback(Canvas* canvas, void* ctx) {
             canvas_draw_str(canvas, 37, 8, "scanning");
 
     } else {
-        if(showFreq) {
+        if(isFastScan && !showFreq) {
+            canvas_draw_str(canvas, 40, 8, "fast");
+        } else if(showFreq) {
             int freq = 2400 + currCh;
             char strfreq[10] = {0};
             snprintf(strfreq, sizeof(strfreq), "%d MHZ", freq);
@@ -95,6 +107,15 @@ static void draw_callback(Canvas* canvas, void* ctx) {
         }
     }
 
+    //draw the waterfall, newest sweep on top
+    if(isFastScan) {
+        for(uint8_t row = 0; row < waterfallCount; ++row) {
+            uint8_t idx = (waterfallHead + WATERFALL_ROWS - 1 - row) % WATERFALL_ROWS;
+            canvas_draw_xbm(canvas, 0, 12 + row, num_channels, 1, waterfall[idx]);
+        }
+        return;
+    }
+
     //draw the chart
     for(int i = 0; i < num_channels; ++i) {
         int h = 64 - nrf24values[i];
@@ -110,6 +131,31 @@ static void input_callback(InputEvent* input_event, void* ctx) {
     furi_message_queue_put(event_queue, &event, FuriWaitForever);
 }
 
+//one sweep over all channels without leaving RX, results go to the next waterfall row
+static void fast_sweep(void) {
+    uint8_t* row = waterfall[waterfallHead];
+    memset(row, 0, sizeof(waterfall[0]));
+    for(uint8_t i = 0; i < num_channels; i++) {
+        if(stopNrfScan) return;
+        currCh = i;
+        //RPD is latched until CE drops, so pulse it around the hop
+        furi_hal_gpio_write(nrf24_CE_PIN, false);
+        nrf24_write_reg(nrf24_HANDLE, REG_RF_CH, i);
+        furi_hal_gpio_write(nrf24_CE_PIN, true);
+        furi_delay_us(FAST_SETTLE_US + FAST_RPD_US);
+        uint8_t hit = 0;
+        for(uint8_t ii = 0; ii < FAST_BURST; ++ii) {
+            hit |= nrf24_get_rdp(nrf24_HANDLE);
+        }
+        if(hit & 0x01) {
+            row[i / 8] |= 1 << (i % 8);
+            if(nrf24values[i] < 65) nrf24values[i]++;
+        }
+    }
+    waterfallHead = (waterfallHead + 1) % WATERFALL_ROWS;
+    if(waterfallCount < WATERFALL_ROWS) waterfallCount++;
+}
+
 static int32_t scanner(void* context) {
     UNUSED(context);
     isScanning = true;
@@ -120,6 +166,13 @@ static int32_t scanner(void* context) {
     nrf24_set_rx_mode(nrf24_HANDLE, false);
     nrf24_write_reg(nrf24_HANDLE, REG_EN_AA, 0x0);
     nrf24_write_reg(nrf24_HANDLE, REG_RF_SETUP, 0x0f);
+    if(isFastScan) {
+        nrf24_set_rx_mode(nrf24_HANDLE, true);
+        while(!stopNrfScan) {
+            fast_sweep();
+            furi_delay_ms(1);
+        }
+    }
     while(true) { //scan until stopped somehow
         if(stopNrfScan) break;
         for(uint8_t i = 0; i < num_channels; i++) {
@@ -216,6 +269,9 @@ int32_t nrf24channelscanner_main(void* p) {
                     continue;
                 }
                 memset(nrf24values, 0, sizeof(nrf24values));
+                memset(waterfall, 0, sizeof(waterfall));
+                waterfallHead = 0;
+                waterfallCount = 0;
                 if(nrf24_check_connected(nrf24_HANDLE)) {
                     threadStoppedsoFree = false;
                     ifNotFoundNrf = false;
@@ -231,6 +287,11 @@ int32_t nrf24channelscanner_main(void* p) {
                     notification_message(notification, &sequence_error);
                 }
             }
+            //toggle the fast sweep with the waterfall view
+            if(event.input.type == InputTypeLong && event.input.key == InputKeyUp && !isScanning) {
+                isFastScan = !isFastScan;
+                showFreq = false;
+            }
             //change the delay
             if(event.input.type == InputTypeShort && event.input.key == InputKeyUp) {
                 ChangeDelay(50);
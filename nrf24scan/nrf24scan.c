@@ -43,6 +43,15 @@
 #define MAX_LOG_RECORDS 200
 #define MAX_FOUND_RECORDS 70
 #define LOG_REC_SIZE 34 // max packet size
+#define LOG_QUEUE_RECORDS 32 // records waiting for the log writer
+#define LOG_BATCH_SIZE 4096 // log file is appended in blocks of this size
+#define LOG_CMD_MARK 0xFF // first byte of a log writer command, never a valid record
+enum {
+    LOG_CMD_FLUSH = 0, // write pending records and close the file
+    LOG_CMD_NEW_FILE, // same, the next record goes to a new log file
+    LOG_CMD_EXIT
+};
+#define SNIFF_FLAG_EXIT (1 << 0)
 #define VIEW_LOG_MAX_X 22
 #define VIEW_LOG_WIDTH_B 10 // bytes
 
@@ -91,7 +100,8 @@ int16_t found_total;
 int16_t view_found;
 
 int8_t log_to_file = 0; // 0 - no, 1 - yes(new), 2 - append, -1 - only clear
-uint16_t log_arr_idx;
+uint16_t log_arr_idx; // records in the log ring
+uint16_t log_arr_head = 0; // oldest record in the log ring
 uint16_t view_log_arr_idx = 0;
 uint16_t view_log_arr_x = 0;
 bool save_to_new_log = true;
@@ -161,17 +171,35 @@ static void add_to_str_hex_bytes_shift_9b(char* out, char* arr, int bytes) {
     } while(--bytes);
 }
 
+uint8_t* log_rec(uint16_t idx) {
+    return APP->log_arr + ((log_arr_head + idx) % MAX_LOG_RECORDS) * LOG_REC_SIZE;
+}
+
+// Record length in bytes, including the 2 header bytes
+static uint8_t log_rec_len(uint8_t* ptr) {
+    int len;
+    if(ptr[0] & 0x80) { // RAW
+        len = (ptr[1] & 0b11) + 2 + ((ptr[1] & 0b100) ? 2 : 0) + (ptr[1] >> 3) +
+              2; // addr + PCF? + payload + crcmax
+    } else {
+        len = (ptr[1] >> 3);
+        if(len == 0) len = 32;
+    }
+    //if(len < NRF_Payload) len = NRF_Payload;
+    return MIN(len + 2, LOG_REC_SIZE);
+}
+
 void clear_log() {
     log_arr_idx = 0;
+    log_arr_head = 0;
     view_log_arr_idx = 0;
     last_packet_send = -1;
     found_total = 0;
     view_found = -1;
 }
 
-void write_to_log_file(Storage* storage, bool f_settings) {
-    if(log_arr_idx == 0 && !f_settings) return;
-    Stream* file_stream = file_stream_alloc(storage);
+// Open the settings file or the log file, the settings header is written to a new file
+static bool open_log_file(Stream* file_stream, bool f_settings) {
     FuriString* str = furi_string_alloc();
     furi_string_set(str, SCAN_APP_PATH_FOLDER);
     furi_string_cat(str, "/");
@@ -266,45 +294,82 @@ void write_to_log_file(Storage* storage, bool f_settings) {
                 notification_message(APP->notification, &sequence_blink_red_100);
             }
         }
-        if(fl) {
-            if(f_settings) {
-                save_settings = 0;
-                if(strcmp(addr_file_name, "NONE") == 0) strcpy(addr_file_name, SETTINGS_FILENAME);
-            } else {
-                int i = 0;
-                for(; i < log_arr_idx; i++) {
-                    furi_string_reset(str);
-                    uint8_t* ptr = APP->log_arr + i * LOG_REC_SIZE;
-                    int len;
-                    if(ptr[0] & 0x80) { // RAW
-                        len = (ptr[1] & 0b11) + 2 + ((ptr[1] & 0b100) ? 2 : 0) + (ptr[1] >> 3) +
-                              2; // addr + PCF? + payload + crcmax
-                    } else {
-                        len = (ptr[1] >> 3);
-                        if(len == 0) len = 32;
-                    }
-                    //if(len < NRF_Payload) len = NRF_Payload;
-                    add_to_furi_str_hex_bytes(str, (char*)ptr, len + 2);
-                    furi_string_cat(str, "\n");
-                    if(stream_write_string(file_stream, str) != furi_string_size(str)) {
-                        FURI_LOG_E(TAG, "Failed to write to file!");
-                        break;
-                    }
-                }
-                if(i == log_arr_idx) {
-                    notification_message(APP->notification, &sequence_blink_yellow_100);
-                    FURI_LOG_D(TAG, "File saved");
-                }
-                save_to_new_log = false;
-            }
-        }
-        file_stream_close(file_stream);
+        if(fl && !f_settings) save_to_new_log = false;
     } else {
         FURI_LOG_E(TAG, "Failed to open file %s", furi_string_get_cstr(str));
         notification_message(APP->notification, &sequence_blink_red_100);
     }
-    stream_free(file_stream);
     furi_string_free(str);
+    return fl;
+}
+
+void write_settings_file(Storage* storage) {
+    Stream* file_stream = file_stream_alloc(storage);
+    if(open_log_file(file_stream, true)) {
+        save_settings = 0;
+        if(strcmp(addr_file_name, "NONE") == 0) strcpy(addr_file_name, SETTINGS_FILENAME);
+    }
+    file_stream_close(file_stream);
+    stream_free(file_stream);
+}
+
+// Queue a log command, it is handled by the writer after the records queued before it
+static void log_writer_cmd(uint8_t cmd) {
+    uint8_t rec[LOG_REC_SIZE] = {LOG_CMD_MARK, cmd};
+    furi_message_queue_put(APP->log_queue, rec, FuriWaitForever);
+}
+
+static bool log_writer_flush(Stream* file_stream, bool* opened, char* batch, size_t* batch_len) {
+    if(*batch_len == 0) return true;
+    if(!*opened) *opened = open_log_file(file_stream, false);
+    bool ok = *opened && stream_write(file_stream, (uint8_t*)batch, *batch_len) == *batch_len;
+    if(ok) {
+        notification_message(APP->notification, &sequence_blink_yellow_100);
+        FURI_LOG_D(TAG, "Log saved: %d", (int)*batch_len);
+    } else {
+        FURI_LOG_E(TAG, "Failed to write to file!");
+    }
+    *batch_len = 0;
+    return ok;
+}
+
+// Appends the records queued by the RX path to the log file in LOG_BATCH_SIZE writes,
+// so the sniffing never waits for the SD card
+static int32_t log_writer_thread(void* ctx) {
+    UNUSED(ctx);
+    Stream* file_stream = file_stream_alloc(APP->storage);
+    char* batch = malloc(LOG_BATCH_SIZE);
+    size_t batch_len = 0;
+    bool opened = false;
+    uint8_t rec[LOG_REC_SIZE];
+    for(bool run = true; run;) {
+        furi_check(
+            furi_message_queue_get(APP->log_queue, rec, FuriWaitForever) == FuriStatusOk);
+        if(rec[0] != LOG_CMD_MARK) {
+            uint8_t len = log_rec_len(rec);
+            // hex line + '\n' + '\0'
+            if(batch_len + len * 2 + 2 > LOG_BATCH_SIZE) {
+                log_writer_flush(file_stream, &opened, batch, &batch_len);
+            }
+            batch[batch_len] = '\0';
+            add_to_str_hex_bytes(batch + batch_len, (char*)rec, len);
+            batch_len += len * 2;
+            batch[batch_len++] = '\n';
+            continue;
+        }
+        log_writer_flush(file_stream, &opened, batch, &batch_len);
+        if(opened) {
+            file_stream_close(file_stream);
+            opened = false;
+        }
+        if(rec[1] == LOG_CMD_NEW_FILE)
+            save_to_new_log = true;
+        else if(rec[1] == LOG_CMD_EXIT)
+            run = false;
+    }
+    free(batch);
+    stream_free(file_stream);
+    return 0;
 }
 
 static bool select_settings_file(Stream* stream) {
@@ -440,7 +505,7 @@ static uint8_t load_settings_file(Stream* file_stream) {
                 }
                 if(log_arr_idx < MAX_LOG_RECORDS - 1) {
                     if(ConvertHexToArray(
-                           line_ptr, APP->log_arr + log_arr_idx * LOG_REC_SIZE, LOG_REC_SIZE) > 0)
+                           line_ptr, log_rec(log_arr_idx), LOG_REC_SIZE) > 0)
                         err = 0;
                     log_arr_idx++;
                 }
@@ -497,7 +562,7 @@ static void prepare_nrf24(bool fsend_packet) {
     struct ADDRS* adr = what_to_do == 1 ? &addrs_sniff : &addrs;
     if(!fsend_packet) {
         uint8_t payload = NRF_Payload;
-        uint8_t* rec = APP->log_arr + view_log_arr_idx * LOG_REC_SIZE;
+        uint8_t* rec = log_rec(view_log_arr_idx);
         uint8_t addr_size = (*(rec + 1) & 0b11) + 2;
         bool setup_from_log = false;
         if(what_to_do >= 2) {
@@ -508,9 +573,9 @@ static void prepare_nrf24(bool fsend_packet) {
                 addrs.addr_len = addr_size;
                 payload = *(rec + 1) >> 3;
                 if(what_to_do == 2) {
-                    uint8_t* p = APP->log_arr + 2;
                     int16_t i = 0;
-                    for(i = 0; i < log_arr_idx; i++, p += LOG_REC_SIZE) {
+                    for(i = 0; i < log_arr_idx; i++) {
+                        uint8_t* p = log_rec(i) + 2;
                         if((*(p - 2) & 0x80) && (*(p - 1) & 0b11) + 2 == addr_size &&
                            rec + 2 != p) {
                             if(memcmp(p, addrs.addr_P0, addr_size - 1) == 0) {
@@ -649,9 +714,40 @@ static void start_scanning() {
     start_time = furi_get_tick();
 }
 
+uint16_t crc16_table[256]; // X^16+X^12+X^5+1, MSB first
+uint8_t crc8_table[256]; // x^8+x^2+x^1+1, MSB first
+
+void crc_tables_init() {
+    for(uint16_t i = 0; i < 256; i++) {
+        uint16_t crc16 = i << 8;
+        uint8_t crc8 = i;
+        for(uint8_t b = 0; b < 8; b++) {
+            crc16 = (crc16 & 0x8000) ? (crc16 << 1) ^ 0x1021 : crc16 << 1;
+            crc8 = (crc8 & 0x80) ? (crc8 << 1) ^ 0x07 : crc8 << 1;
+        }
+        crc16_table[i] = crc16;
+        crc8_table[i] = crc8;
+    }
+}
+
 // start bitnum = 7
 uint32_t calc_crc(uint32_t crc, uint8_t* ptr, uint8_t bitnum, uint16_t bits) {
     //uint8_t bitnum = 7;
+    // whole bytes via the tables, they may start at any bit of *ptr
+    if(view_log_decode_CRC == 2) {
+        crc &= 0xFFFF;
+        for(; bits >= 8; bits -= 8, ptr++) {
+            uint8_t b = bitnum == 7 ? *ptr : (*ptr << (7 - bitnum)) | (*(ptr + 1) >> (bitnum + 1));
+            crc = ((crc << 8) ^ crc16_table[((crc >> 8) ^ b) & 0xFF]) & 0xFFFF;
+        }
+    } else {
+        crc &= 0xFF;
+        for(; bits >= 8; bits -= 8, ptr++) {
+            uint8_t b = bitnum == 7 ? *ptr : (*ptr << (7 - bitnum)) | (*(ptr + 1) >> (bitnum + 1));
+            crc = crc8_table[(crc ^ b) & 0xFF];
+        }
+    }
+    // the rest bit by bit
     uint32_t crc_high, polynom;
     if(view_log_decode_CRC == 2) {
         crc_high = (1 << 16);
@@ -787,8 +883,8 @@ bool check_packet(uint8_t* pkt, uint16_t size) {
         if(i != found_total) { // found
             APP->found[i].total++;
         } else {
-            uint8_t* p = APP->log_arr + 2;
-            for(i = 0; i < log_arr_idx; i++, p += LOG_REC_SIZE) {
+            for(i = 0; i < log_arr_idx; i++) {
+                uint8_t* p = log_rec(i) + 2;
                 if((*(p - 2) & 0x80) && (*(p - 1) & 0b11) + 2 == addr_size && pkt != p) {
                     if(memcmp(p, pkt, addr_size) == 0) break;
                 }
@@ -811,7 +907,8 @@ bool nrf24_read_newpacket() {
     if(APP->log_arr == NULL) return false;
     bool found = false;
     uint8_t packetsize;
-    uint8_t* ptr = APP->log_arr + log_arr_idx * LOG_REC_SIZE;
+    uint8_t* rec = log_rec(log_arr_idx);
+    uint8_t* ptr = rec;
     uint8_t st;
     /* test pkts	
 	static int iii = 0;
@@ -875,12 +972,12 @@ bool nrf24_read_newpacket() {
         if(packetsize < 32) memset(ptr + packetsize, 0, 32 - packetsize);
         if(log_arr_idx < MAX_LOG_RECORDS - 1) {
             log_arr_idx++;
-        } else {
-            if(log_to_file == 1 || log_to_file == 2) {
-                write_to_log_file(APP->storage, false);
-                clear_log();
-            } else {
-                memmove(APP->log_arr, APP->log_arr + LOG_REC_SIZE, log_arr_idx * LOG_REC_SIZE);
+        } else { // ring is full, drop the oldest record
+            if(++log_arr_head >= MAX_LOG_RECORDS) log_arr_head = 0;
+        }
+        if(log_to_file == 1 || log_to_file == 2) {
+            if(furi_message_queue_put(APP->log_queue, rec, 0) != FuriStatusOk) {
+                FURI_LOG_E(TAG, "Log queue is full, record dropped");
             }
         }
         FURI_LOG_D(TAG, "Found packet #%d pipe %d", log_arr_idx, st);
@@ -890,10 +987,29 @@ bool nrf24_read_newpacket() {
     return found;
 }
 
+// RX path, polls the radio while the log or the addresses are viewed
+static int32_t sniff_thread(void* ctx) {
+    PluginState* plugin_state = ctx;
+    while(!(furi_thread_flags_get() & SNIFF_FLAG_EXIT)) {
+        furi_mutex_acquire(plugin_state->mutex, FuriWaitForever);
+        if(what_doing && what_to_do) {
+            nrf24_read_newpacket();
+            if(find_channel_period &&
+               furi_get_tick() - start_time >= (uint32_t)find_channel_period * 1000UL) {
+                if(++NRF_channel > MAX_CHANNEL) NRF_channel = 0;
+                start_scanning();
+            }
+        }
+        furi_mutex_release(plugin_state->mutex);
+        furi_delay_ms(1);
+    }
+    return 0;
+}
+
 bool nrf24_send_packet() {
     if(log_arr_idx == 0) return false;
     prepare_nrf24(!what_to_do);
-    uint8_t* ptr = APP->log_arr + view_log_arr_idx * LOG_REC_SIZE;
+    uint8_t* ptr = log_rec(view_log_arr_idx);
     nrf24_write_reg(nrf24_HANDLE, REG_RF_CH, *ptr & 0x7F);
     if(*ptr & 0x80) { // RAW packet
         //uint8_t pktinfo = *(ptr + 1);
@@ -988,7 +1104,7 @@ static void render_callback(Canvas* const canvas, void* ctx) {
         if(what_to_do == 1)
             snprintf(screen_buf, sizeof(screen_buf), "Min Payl: %d", NRF_Payload_sniff_min);
         else if(what_to_do >= 2) {
-            uint8_t* p = APP->log_arr + view_log_arr_idx * LOG_REC_SIZE;
+            uint8_t* p = log_rec(view_log_arr_idx);
             snprintf(
                 screen_buf,
                 sizeof(screen_buf),
@@ -1024,7 +1140,7 @@ static void render_callback(Canvas* const canvas, void* ctx) {
                 if(what_to_do == 1)
                     snprintf(screen_buf, sizeof(screen_buf), "Start sniff");
                 else {
-                    uint8_t* p = APP->log_arr + view_log_arr_idx * LOG_REC_SIZE;
+                    uint8_t* p = log_rec(view_log_arr_idx);
                     if(log_arr_idx && (*p & 0x80)) { // +RAW
                         snprintf(screen_buf, sizeof(screen_buf), "Start read: ");
                         add_to_str_hex_bytes(screen_buf, (char*)p + 2, (*(p + 1) & 0b11) + 2);
@@ -1072,7 +1188,7 @@ static void render_callback(Canvas* const canvas, void* ctx) {
                                 last_packet_send_st                  ? '*' :
                                                                        '!';
                 screen_buf[1] = '\0';
-                uint8_t* ptr = APP->log_arr + (page + i) * LOG_REC_SIZE;
+                uint8_t* ptr = log_rec(page + i);
                 uint8_t channel = *ptr++;
                 uint8_t* crcptr = NULL;
                 uint8_t pre = 0;
@@ -1297,7 +1413,7 @@ static void render_callback(Canvas* const canvas, void* ctx) {
             }
         }
         if(log_arr_idx) {
-            uint8_t* ptr = APP->log_arr + view_log_arr_idx * LOG_REC_SIZE;
+            uint8_t* ptr = log_rec(view_log_arr_idx);
             uint8_t pktinfo = *(ptr + 1);
             snprintf(screen_buf, 32, ">Ch: %d L: %d", *ptr & 0x7F, pktinfo >> 3);
             if(*ptr & 0x80) {
@@ -1402,6 +1518,13 @@ int32_t nrf24scan_app(void* p) {
     stream_free(file_stream);
     furi_string_free(path);
 
+    crc_tables_init();
+    APP->log_queue = furi_message_queue_alloc(LOG_QUEUE_RECORDS, LOG_REC_SIZE);
+    APP->log_thread = furi_thread_alloc_ex("Nrf24ScanLog", 1024, log_writer_thread, NULL);
+    furi_thread_start(APP->log_thread);
+    APP->sniff_thread = furi_thread_alloc_ex("Nrf24ScanRx", 2048, sniff_thread, plugin_state);
+    furi_thread_start(APP->sniff_thread);
+
     PluginEvent event;
     for(bool processing = true; processing;) {
         FuriStatus event_status = furi_message_queue_get(APP->event_queue, &event, 100);
@@ -1530,13 +1653,13 @@ int32_t nrf24scan_app(void* p) {
                             switch(menu_selected) {
                             case Menu_open_file:
                                 if(save_settings) {
-                                    write_to_log_file(APP->storage, true);
+                                    write_settings_file(APP->storage);
                                 } else {
                                     file_stream = file_stream_alloc(APP->storage);
                                     if(select_settings_file(file_stream)) {
                                         uint8_t err = load_settings_file(file_stream);
                                         if(!err)
-                                            save_to_new_log = true;
+                                            log_writer_cmd(LOG_CMD_NEW_FILE);
                                         else
                                             snprintf(
                                                 addr_file_name,
@@ -1576,15 +1699,15 @@ int32_t nrf24scan_app(void* p) {
                                 if(what_to_do) {
                                     if((addrs.addr_count ||
                                         (what_to_do >= 2 && log_arr_idx &&
-                                         *(APP->log_arr + view_log_arr_idx * LOG_REC_SIZE) &
+                                         *(log_rec(view_log_arr_idx)) &
                                              0x80)) ||
                                        what_to_do == 1) {
                                         if(log_to_file == -1) {
                                             log_to_file = 0;
                                             clear_log();
-                                            save_to_new_log = true;
+                                            log_writer_cmd(LOG_CMD_NEW_FILE);
                                         } else if(log_to_file == 1)
-                                            save_to_new_log = true;
+                                            log_writer_cmd(LOG_CMD_NEW_FILE);
                                         start_scanning();
                                         if(!NRF_ERROR) what_doing = 1;
                                     }
@@ -1603,7 +1726,7 @@ int32_t nrf24scan_app(void* p) {
                                 NRF_AA_OFF ^= 1;
                             } else if(menu_selected == Menu_log) { // Log
                                 if(log_arr_idx && (log_to_file == 1 || log_to_file == 2)) {
-                                    write_to_log_file(APP->storage, false);
+                                    log_writer_cmd(LOG_CMD_FLUSH);
                                     clear_log();
                                 }
                             }
@@ -1627,22 +1750,18 @@ int32_t nrf24scan_app(void* p) {
                 }
             }
         }
-        if(what_doing && what_to_do) {
-            nrf24_read_newpacket();
-            if(find_channel_period &&
-               furi_get_tick() - start_time >= (uint32_t)find_channel_period * 1000UL) {
-                if(++NRF_channel > MAX_CHANNEL) NRF_channel = 0;
-                start_scanning();
-            }
-        }
 
         furi_mutex_release(plugin_state->mutex);
         view_port_update(APP->view_port);
     }
+    furi_thread_flags_set(furi_thread_get_id(APP->sniff_thread), SNIFF_FLAG_EXIT);
+    furi_thread_join(APP->sniff_thread);
+    furi_thread_free(APP->sniff_thread);
     nrf24_set_idle(nrf24_HANDLE);
-    if(log_arr_idx && (log_to_file == 1 || log_to_file == 2)) {
-        write_to_log_file(APP->storage, false);
-    }
+    log_writer_cmd(LOG_CMD_EXIT);
+    furi_thread_join(APP->log_thread);
+    furi_thread_free(APP->log_thread);
+    furi_message_queue_free(APP->log_queue);
     nrf24_deinit();
     if(NRF_BOARD_POWER_5V) furi_hal_power_disable_otg();
 
@@ -34,6 +34,9 @@ typedef struct {
     ViewPort* view_port;
     Storage* storage;
     NotificationApp* notification;
-    uint8_t* log_arr;
+    uint8_t* log_arr; // ring of MAX_LOG_RECORDS records
+    FuriMessageQueue* log_queue; // records and commands for the log writer
+    FuriThread* log_thread;
+    FuriThread* sniff_thread;
     struct FOUND* found;
 } Nrf24Scan;
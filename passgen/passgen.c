@@ -1,9 +1,14 @@
 #include <furi.h>
 #include <furi_hal_random.h>
+#include <furi_hal_usb.h>
+#include <furi_hal_usb_hid.h>
 #include <gui/gui.h>
 #include <gui/elements.h>
 #include <input/input.h>
 #include <notification/notification_messages.h>
+#include <storage/storage.h>
+#include <toolbox/stream/file_stream.h>
+#include <math.h>
 #include <stdlib.h>
 #include <passgen_icons.h>
 
@@ -12,6 +17,21 @@
 #define PASSGEN_MAX_LENGTH 16
 #define PASSGEN_CHARACTERS_LENGTH (26 * 4)
 
+// passphrase mode: length is the number of words
+#define PASSGEN_MAX_WORDS 6
+#define PASSGEN_WORD_MAX_LENGTH 15
+#define PASSGEN_MAX_WORDLIST UINT16_MAX
+#define PASSGEN_BUFFER_SIZE (PASSGEN_MAX_WORDS * (PASSGEN_WORD_MAX_LENGTH + 1))
+_Static_assert(PASSGEN_BUFFER_SIZE > PASSGEN_MAX_LENGTH, "buffer must hold a password");
+
+#define PASSGEN_FOLDER EXT_PATH("apps_data/passgen")
+#define PASSGEN_WORDLIST_PATH PASSGEN_FOLDER "/wordlist.txt"
+#define PASSGEN_EXPORT_PATH PASSGEN_FOLDER "/passwords.txt"
+#define PASSGEN_BATCH_COUNT 20
+
+#define PASSGEN_HID_CONNECT_TIMEOUT_MS 5000
+#define PASSGEN_HID_KEY_DELAY_MS 30
+
 #define PASSGEN_DIGITS "0123456789"
 #define PASSGEN_LETTERS_LOW "abcdefghijklmnopqrstuvwxyz"
 #define PASSGEN_LETTERS_UP "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
@@ -26,7 +46,9 @@ typedef enum PassGen_Alphabet {
 
     DigitsLower = Digits | Lowercase,
     DigitsAllLetters = Digits | Lowercase | Uppercase,
-    Mixed = DigitsAllLetters | Special
+    Mixed = DigitsAllLetters | Special,
+
+    Words = 16 // passphrase from the SD card wordlist
 } PassGen_Alphabet;
 
 const char* const PassGen_AlphabetChars[16] = {
@@ -48,8 +70,8 @@ const char* const PassGen_AlphabetChars[16] = {
     PASSGEN_SPECIAL PASSGEN_LETTERS_UP PASSGEN_LETTERS_LOW PASSGEN_DIGITS,
 };
 
-const int AlphabetLevels[] = {Digits, Lowercase, DigitsLower, DigitsAllLetters, Mixed};
-const char* AlphabetLevelNames[] = {"1234", "abcd", "ab12", "Ab12", "Ab1#"};
+const int AlphabetLevels[] = {Digits, Lowercase, DigitsLower, DigitsAllLetters, Mixed, Words};
+const char* AlphabetLevelNames[] = {"1234", "abcd", "ab12", "Ab12", "Ab1#", "Word"};
 const int AlphabetLevelsCount = sizeof(AlphabetLevels) / sizeof(int);
 
 const NotificationSequence PassGen_Alert_vibro = {
@@ -66,17 +88,23 @@ typedef struct {
     Gui* gui;
     FuriMutex** mutex;
     NotificationApp* notify;
-    const char* alphabet;
-    char password[PASSGEN_MAX_LENGTH + 1];
-    int length; // must be <= PASSGEN_MAX_LENGTH
+    const char* alphabet; // NULL in passphrase mode
+    char password[PASSGEN_BUFFER_SIZE];
+    int length; // must be <= PASSGEN_MAX_LENGTH (PASSGEN_MAX_WORDS for passphrases)
     int level;
+    uint32_t word_count; // words in the wordlist, 0 until it has been read
 } PassGen;
 
+typedef struct {
+    uint16_t word; // line of the wordlist
+    uint16_t slot; // position in the output
+} PassGen_WordPick;
+
 void state_free(PassGen* app) {
     // NOTE: would have preferred if a "safe" memset() was available...
     //       but, since cannot prevent optimization from removing
     //       memset(), fill with random data instead.
-    furi_hal_random_fill_buf((void*)(app->password), PASSGEN_MAX_LENGTH);
+    furi_hal_random_fill_buf((void*)(app->password), PASSGEN_BUFFER_SIZE);
 
     gui_remove_view_port(app->gui, app->view_port);
     furi_record_close(RECORD_GUI);
@@ -89,13 +117,20 @@ void state_free(PassGen* app) {
 
 static void input_callback(InputEvent* input_event, void* ctx) {
     PassGen* app = ctx;
-    if(input_event->type == InputTypeShort) {
+    if(input_event->type == InputTypeShort || input_event->type == InputTypeLong) {
         furi_message_queue_put(app->input_queue, input_event, 0);
     }
 }
 
+// bits of entropy of one password with the current settings
+static int entropy_bits(PassGen* app) {
+    uint32_t symbols = app->alphabet ? strlen(app->alphabet) : app->word_count;
+    return (symbols > 1) ? (int)(app->length * log2f(symbols)) : 0;
+}
+
 static void render_callback(Canvas* canvas, void* ctx) {
     char str_length[8];
+    char str_entropy[8];
     PassGen* app = ctx;
     furi_check(furi_mutex_acquire(app->mutex, FuriWaitForever) == FuriStatusOk);
 
@@ -105,8 +140,24 @@ static void render_callback(Canvas* canvas, void* ctx) {
     canvas_set_font(canvas, FontPrimary);
     canvas_draw_str(canvas, 2, 11, "Password Generator");
 
+    canvas_set_font(canvas, FontSecondary);
+    snprintf(str_entropy, sizeof(str_entropy), "%db", entropy_bits(app));
+    canvas_draw_str_aligned(canvas, 126, 11, AlignRight, AlignBottom, str_entropy);
+
     canvas_set_color(canvas, ColorBlack);
-    canvas_draw_str_aligned(canvas, 64, 35, AlignCenter, AlignCenter, app->password);
+    if(app->alphabet) {
+        canvas_set_font(canvas, FontPrimary);
+        canvas_draw_str_aligned(canvas, 64, 35, AlignCenter, AlignCenter, app->password);
+    } else {
+        // two words per line
+        char lines[PASSGEN_BUFFER_SIZE];
+        strlcpy(lines, app->password, sizeof(lines));
+        int spaces = 0;
+        for(char* c = lines; *c; c++) {
+            if(*c == ' ' && (++spaces % 2) == 0) *c = '\n';
+        }
+        elements_multiline_text_aligned(canvas, 64, 32, AlignCenter, AlignCenter, lines);
+    }
 
     // Navigation menu:
     canvas_set_font(canvas, FontSecondary);
@@ -125,7 +176,10 @@ static void render_callback(Canvas* canvas, void* ctx) {
 
 void build_alphabet(PassGen* app) {
     PassGen_Alphabet mode = AlphabetLevels[app->level];
-    if(mode > 0 && mode < 16) {
+    if(mode == Words) {
+        app->alphabet = NULL;
+        if(app->length > PASSGEN_MAX_WORDS) app->length = PASSGEN_MAX_WORDS;
+    } else if(mode > 0 && mode < 16) {
         app->alphabet = PassGen_AlphabetChars[mode];
     } else {
         app->alphabet =
@@ -138,6 +192,7 @@ PassGen* state_init() {
     _Static_assert(8 <= PASSGEN_MAX_LENGTH, "app->length must be set <= PASSGEN_MAX_LENGTH");
     app->length = 8;
     app->level = 2;
+    app->word_count = 0;
     build_alphabet(app);
     app->input_queue = furi_message_queue_alloc(8, sizeof(InputEvent));
     app->view_port = view_port_alloc();
@@ -152,49 +207,234 @@ PassGen* state_init() {
     return app;
 }
 
-void generate(PassGen* app) {
-    memset(app->password, 0, PASSGEN_MAX_LENGTH + 1);
+// fills values with uniform random numbers below range (1..256)
+static void random_uint8(uint8_t* values, size_t count, uint32_t range) {
+    // largest multiple of range that fits, values at or above it would be biased
+    const uint32_t bound = 0x100 - (0x100 % range);
 
-    int char_option_count = strlen(app->alphabet);
-    if(char_option_count < 0) {
-        return;
-    }
-
-    // determine largest character value that avoids bias
-    char ceil = CHAR_MAX - (CHAR_MAX % char_option_count) - 1;
-
-    // iteratively fill the password buffer with random values
+    // iteratively fill the buffer with random values
     // then keep only values that are in-range (no bias)
-    void* remaining_buffer = app->password;
-    size_t remaining_length = (app->length * sizeof(char));
+    uint8_t* remaining_buffer = values;
+    size_t remaining_length = count;
 
     while(remaining_length != 0) {
         // fewer calls to hardware TRNG is more efficient
         furi_hal_random_fill_buf(remaining_buffer, remaining_length);
 
-        // keep only values that are in-range (no bias)
-        char* target = remaining_buffer;
-        char* source = remaining_buffer;
-        size_t valid_count = 0;
-
+        uint8_t* target = remaining_buffer;
         for(size_t i = 0; i < remaining_length; i++) {
-            int v = *source;
             // if the generated random value is in range, keep it
-            if(v < ceil) {
-                v %= char_option_count;
-                *target = app->alphabet[v];
-                // increment target pointer and count of valid items found
-                target++;
-                valid_count++;
+            if(remaining_buffer[i] < bound) {
+                *target++ = remaining_buffer[i] % range;
+            }
+        }
+        remaining_length -= target - remaining_buffer;
+        remaining_buffer = target;
+    }
+}
+
+// fills values with uniform random numbers below range (1..65536)
+static void random_uint16(uint16_t* values, size_t count, uint32_t range) {
+    const uint32_t bound = 0x10000 - (0x10000 % range);
+
+    uint16_t* remaining_buffer = values;
+    size_t remaining_length = count;
+
+    while(remaining_length != 0) {
+        furi_hal_random_fill_buf((uint8_t*)remaining_buffer, remaining_length * sizeof(uint16_t));
+
+        uint16_t* target = remaining_buffer;
+        for(size_t i = 0; i < remaining_length; i++) {
+            if(remaining_buffer[i] < bound) {
+                *target++ = remaining_buffer[i] % range;
             }
-            // always increment the source pointer
-            source++;
         }
-        remaining_length -= valid_count;
+        remaining_length -= target - remaining_buffer;
         remaining_buffer = target;
     }
 }
 
+// the word of a wordlist line, accepts plain lists and diceware "11111<tab>word" lines
+// returns its length, 0 for a blank line
+static size_t wordlist_word(FuriString* line, char* word) {
+    furi_string_trim(line);
+    size_t start = 0;
+    for(size_t i = 0; i < furi_string_size(line); i++) {
+        char c = furi_string_get_char(line, i);
+        if(c == ' ' || c == '\t') start = i + 1;
+    }
+    size_t length = 0;
+    for(size_t i = start; i < furi_string_size(line) && length < PASSGEN_WORD_MAX_LENGTH; i++) {
+        if(word) word[length] = furi_string_get_char(line, i);
+        length++;
+    }
+    if(word) word[length] = '\0';
+    return length;
+}
+
+// counts the words of the wordlist, 0 if there is none
+static uint32_t wordlist_count() {
+    uint32_t count = 0;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    Stream* stream = file_stream_alloc(storage);
+    FuriString* line = furi_string_alloc();
+
+    if(file_stream_open(stream, PASSGEN_WORDLIST_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        while(count < PASSGEN_MAX_WORDLIST && stream_read_line(stream, line)) {
+            if(wordlist_word(line, NULL)) count++;
+        }
+    }
+
+    furi_string_free(line);
+    file_stream_close(stream);
+    stream_free(stream);
+    furi_record_close(RECORD_STORAGE);
+    return count;
+}
+
+static int word_pick_compare(const void* a, const void* b) {
+    return ((const PassGen_WordPick*)a)->word - ((const PassGen_WordPick*)b)->word;
+}
+
+// draws count random words and reads them all in a single pass over the wordlist
+static bool
+    pick_words(uint32_t word_count, char (*words)[PASSGEN_WORD_MAX_LENGTH + 1], size_t count) {
+    PassGen_WordPick* picks = malloc(count * sizeof(PassGen_WordPick));
+    uint16_t* indices = malloc(count * sizeof(uint16_t));
+    random_uint16(indices, count, word_count);
+    for(size_t i = 0; i < count; i++) {
+        picks[i].word = indices[i];
+        picks[i].slot = i;
+    }
+    furi_hal_random_fill_buf((uint8_t*)indices, count * sizeof(uint16_t));
+    free(indices);
+    qsort(picks, count, sizeof(PassGen_WordPick), word_pick_compare);
+
+    size_t picked = 0;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    Stream* stream = file_stream_alloc(storage);
+    FuriString* line = furi_string_alloc();
+    char word[PASSGEN_WORD_MAX_LENGTH + 1];
+
+    if(file_stream_open(stream, PASSGEN_WORDLIST_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        uint32_t index = 0;
+        while(picked < count && stream_read_line(stream, line)) {
+            if(!wordlist_word(line, word)) continue;
+            while(picked < count && picks[picked].word == index) {
+                strlcpy(words[picks[picked].slot], word, sizeof(word));
+                picked++;
+            }
+            index++;
+        }
+    }
+
+    furi_hal_random_fill_buf((uint8_t*)word, sizeof(word));
+    furi_string_free(line);
+    file_stream_close(stream);
+    stream_free(stream);
+    furi_record_close(RECORD_STORAGE);
+    furi_hal_random_fill_buf((uint8_t*)picks, count * sizeof(PassGen_WordPick));
+    free(picks);
+    return picked == count;
+}
+
+// generates count passwords with the current settings in one pass,
+// passwords[i] starts at passwords + i * PASSGEN_BUFFER_SIZE
+bool generate_passwords(PassGen* app, char* passwords, size_t count) {
+    memset(passwords, 0, count * PASSGEN_BUFFER_SIZE);
+
+    if(app->alphabet) {
+        uint32_t char_option_count = strlen(app->alphabet);
+        uint8_t* values = malloc(count * app->length);
+        random_uint8(values, count * app->length, char_option_count);
+        for(size_t i = 0; i < count; i++) {
+            for(int c = 0; c < app->length; c++) {
+                passwords[i * PASSGEN_BUFFER_SIZE + c] =
+                    app->alphabet[values[i * app->length + c]];
+            }
+        }
+        furi_hal_random_fill_buf(values, count * app->length);
+        free(values);
+        return true;
+    }
+
+    size_t word_total = count * app->length;
+    char(*words)[PASSGEN_WORD_MAX_LENGTH + 1] =
+        malloc(word_total * (PASSGEN_WORD_MAX_LENGTH + 1));
+    bool picked = app->word_count > 0 && pick_words(app->word_count, words, word_total);
+    if(picked) {
+        for(size_t i = 0; i < count; i++) {
+            char* password = passwords + i * PASSGEN_BUFFER_SIZE;
+            for(int w = 0; w < app->length; w++) {
+                if(w) strlcat(password, " ", PASSGEN_BUFFER_SIZE);
+                strlcat(password, words[i * app->length + w], PASSGEN_BUFFER_SIZE);
+            }
+        }
+    }
+    furi_hal_random_fill_buf((uint8_t*)words, word_total * (PASSGEN_WORD_MAX_LENGTH + 1));
+    free(words);
+    return picked;
+}
+
+void generate(PassGen* app) {
+    generate_passwords(app, app->password, 1);
+}
+
+// writes a batch of fresh passwords to the SD card, one per line
+static bool export_passwords(PassGen* app) {
+    char* passwords = malloc(PASSGEN_BATCH_COUNT * PASSGEN_BUFFER_SIZE);
+    bool exported = generate_passwords(app, passwords, PASSGEN_BATCH_COUNT);
+
+    if(exported) {
+        Storage* storage = furi_record_open(RECORD_STORAGE);
+        storage_simply_mkdir(storage, PASSGEN_FOLDER);
+        File* file = storage_file_alloc(storage);
+        exported = storage_file_open(file, PASSGEN_EXPORT_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS);
+        for(size_t i = 0; exported && i < PASSGEN_BATCH_COUNT; i++) {
+            char* password = passwords + i * PASSGEN_BUFFER_SIZE;
+            size_t length = strlen(password);
+            password[length++] = '\n';
+            exported = storage_file_write(file, password, length) == length;
+        }
+        storage_file_close(file);
+        storage_file_free(file);
+        furi_record_close(RECORD_STORAGE);
+    }
+
+    furi_hal_random_fill_buf((uint8_t*)passwords, PASSGEN_BATCH_COUNT * PASSGEN_BUFFER_SIZE);
+    free(passwords);
+    return exported;
+}
+
+// types the password on the host as a USB keyboard (US layout)
+static bool type_password(const char* password) {
+    FuriHalUsbInterface* usb_mode_prev = furi_hal_usb_get_config();
+    furi_hal_usb_unlock();
+    if(!furi_hal_usb_set_config(&usb_hid, NULL)) return false;
+
+    for(uint32_t waited = 0;
+        !furi_hal_hid_is_connected() && waited < PASSGEN_HID_CONNECT_TIMEOUT_MS;
+        waited += 100) {
+        furi_delay_ms(100);
+    }
+
+    bool typed = furi_hal_hid_is_connected();
+    if(typed) {
+        for(const char* c = password; *c; c++) {
+            uint16_t key = HID_ASCII_TO_KEY(*c);
+            if(key == HID_KEYBOARD_NONE) continue;
+            furi_hal_hid_kb_press(key);
+            furi_delay_ms(PASSGEN_HID_KEY_DELAY_MS);
+            furi_hal_hid_kb_release(key);
+            furi_delay_ms(PASSGEN_HID_KEY_DELAY_MS);
+        }
+        furi_delay_ms(100);
+    }
+
+    furi_hal_usb_set_config(usb_mode_prev, NULL);
+    return typed;
+}
+
 void update_password(PassGen* app, bool vibro) {
     generate(app);
 
@@ -212,6 +452,25 @@ int32_t passgenapp(void) {
     while(1) {
         InputEvent input;
         while(furi_message_queue_get(app->input_queue, &input, FuriWaitForever) == FuriStatusOk) {
+            // slow output actions run unlocked, only this thread changes the settings
+            if(input.type == InputTypeLong && input.key == InputKeyOk) {
+                char password[PASSGEN_BUFFER_SIZE];
+                furi_check(furi_mutex_acquire(app->mutex, FuriWaitForever) == FuriStatusOk);
+                strlcpy(password, app->password, sizeof(password));
+                furi_mutex_release(app->mutex);
+                bool typed = type_password(password);
+                furi_hal_random_fill_buf((uint8_t*)password, sizeof(password));
+                notification_message(
+                    app->notify, typed ? &sequence_success : &sequence_blink_red_100);
+                continue;
+            }
+            if(input.type == InputTypeLong && input.key == InputKeyRight) {
+                notification_message(
+                    app->notify,
+                    export_passwords(app) ? &sequence_success : &sequence_blink_red_100);
+                continue;
+            }
+
             furi_check(furi_mutex_acquire(app->mutex, FuriWaitForever) == FuriStatusOk);
 
             if(input.type == InputTypeShort) {
@@ -229,7 +488,13 @@ int32_t passgenapp(void) {
                         notification_message(app->notify, &sequence_blink_red_100);
                     break;
                 case InputKeyUp:
-                    if(app->level < AlphabetLevelsCount - 1) {
+                    // passphrases need a wordlist, it is only counted once
+                    if(app->level < AlphabetLevelsCount - 1 &&
+                       AlphabetLevels[app->level + 1] == Words && !app->word_count) {
+                        app->word_count = wordlist_count();
+                    }
+                    if(app->level < AlphabetLevelsCount - 1 &&
+                       (AlphabetLevels[app->level + 1] != Words || app->word_count > 1)) {
                         app->level++;
                         build_alphabet(app);
                         update_password(app, false);
@@ -244,7 +509,7 @@ int32_t passgenapp(void) {
                         notification_message(app->notify, &sequence_blink_red_100);
                     break;
                 case InputKeyRight:
-                    if(app->length < PASSGEN_MAX_LENGTH) {
+                    if(app->length < (app->alphabet ? PASSGEN_MAX_LENGTH : PASSGEN_MAX_WORDS)) {
                         app->length++;
                         update_password(app, false);
                     } else
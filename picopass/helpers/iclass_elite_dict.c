@@ -14,6 +14,7 @@
 
 struct IclassEliteDict {
     Stream* stream;
+    FuriString* next_line;
     uint32_t total_keys;
 };
 
@@ -40,7 +41,8 @@ IclassEliteDict* iclass_elite_dict_alloc(IclassEliteDictType dict_type) {
     IclassEliteDict* dict = malloc(sizeof(IclassEliteDict));
     Storage* storage = furi_record_open(RECORD_STORAGE);
     dict->stream = buffered_file_stream_alloc(storage);
-    FuriString* next_line = furi_string_alloc();
+    dict->next_line = furi_string_alloc();
+    FuriString* next_line = dict->next_line;
 
     bool dict_loaded = false;
     do {
@@ -83,12 +85,13 @@ IclassEliteDict* iclass_elite_dict_alloc(IclassEliteDictType dict_type) {
 
     if(!dict_loaded) { //-V547
         buffered_file_stream_close(dict->stream);
+        stream_free(dict->stream);
+        furi_string_free(dict->next_line);
         free(dict);
         dict = NULL;
     }
 
     furi_record_close(RECORD_STORAGE);
-    furi_string_free(next_line);
 
     return dict;
 }
@@ -99,6 +102,7 @@ void iclass_elite_dict_free(IclassEliteDict* dict) {
 
     buffered_file_stream_close(dict->stream);
     stream_free(dict->stream);
+    furi_string_free(dict->next_line);
     free(dict);
 }
 
@@ -113,7 +117,7 @@ bool iclass_elite_dict_get_next_key(IclassEliteDict* dict, uint8_t* key) {
     furi_assert(dict->stream);
 
     uint8_t key_byte_tmp = 0;
-    FuriString* next_line = furi_string_alloc();
+    FuriString* next_line = dict->next_line;
 
     bool key_read = false;
     *key = 0ULL;
@@ -131,7 +135,6 @@ bool iclass_elite_dict_get_next_key(IclassEliteDict* dict, uint8_t* key) {
         key_read = true;
     }
 
-    furi_string_free(next_line);
     return key_read;
 }
 
@@ -147,7 +150,7 @@ bool iclass_elite_dict_add_key(IclassEliteDict* dict, uint8_t* key) {
     furi_assert(dict->stream);
 
     FuriString* key_str = furi_string_alloc();
-    for(size_t i = 0; i < 6; i++) {
+    for(size_t i = 0; i < ICLASS_ELITE_KEY_LEN; i++) {
         furi_string_cat_printf(key_str, "%02X", key[i]);
     }
     furi_string_cat_printf(key_str, "\n");
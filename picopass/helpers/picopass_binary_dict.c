@@ -0,0 +1,174 @@
+#include "picopass_binary_dict.h"
+
+#include <furi.h>
+#include <nfc/helpers/nfc_dict.h>
+#include <lib/toolbox/path.h>
+
+#define TAG "PicopassBinaryDict"
+
+#define PICOPASS_BINARY_DICT_MAGIC (0x31444250) // "PBD1"
+#define PICOPASS_BINARY_DICT_KEY_LEN (8)
+
+typedef struct {
+    uint32_t magic;
+    uint32_t txt_size;
+    uint32_t total_keys;
+} PicopassBinaryDictHeader;
+
+struct PicopassBinaryDict {
+    Storage* storage;
+    File* file;
+    uint32_t total_keys;
+    size_t batch_count;
+    size_t batch_index;
+    uint8_t* batch;
+};
+
+static bool picopass_binary_dict_is_valid(File* file, uint32_t txt_size) {
+    PicopassBinaryDictHeader header = {};
+    return storage_file_read(file, &header, sizeof(header)) == sizeof(header) &&
+           header.magic == PICOPASS_BINARY_DICT_MAGIC && header.txt_size == txt_size &&
+           storage_file_size(file) ==
+               sizeof(header) + header.total_keys * PICOPASS_BINARY_DICT_KEY_LEN;
+}
+
+uint32_t picopass_binary_dict_convert(Storage* storage, const char* txt_path, const char* bin_path) {
+    furi_assert(storage);
+    furi_assert(txt_path);
+    furi_assert(bin_path);
+
+    FileInfo info = {};
+    if(storage_common_stat(storage, txt_path, &info) != FSE_OK) return 0;
+    NfcDict* dict =
+        nfc_dict_alloc(txt_path, NfcDictModeOpenExisting, PICOPASS_BINARY_DICT_KEY_LEN);
+    if(!dict) return 0;
+
+    File* file = storage_file_alloc(storage);
+    uint8_t* batch = malloc(PICOPASS_BINARY_DICT_BATCH * PICOPASS_BINARY_DICT_KEY_LEN);
+    PicopassBinaryDictHeader header = {
+        .magic = 0,
+        .txt_size = info.size,
+        .total_keys = 0,
+    };
+
+    // The magic is only written once all keys are there
+    bool success = storage_file_open(file, bin_path, FSAM_WRITE, FSOM_CREATE_ALWAYS) &&
+                   storage_file_write(file, &header, sizeof(header)) == sizeof(header);
+    while(success) {
+        size_t count = 0;
+        while(count < PICOPASS_BINARY_DICT_BATCH &&
+              nfc_dict_get_next_key(
+                  dict, &batch[count * PICOPASS_BINARY_DICT_KEY_LEN], PICOPASS_BINARY_DICT_KEY_LEN)) {
+            count++;
+        }
+        if(count == 0) break;
+
+        size_t size = count * PICOPASS_BINARY_DICT_KEY_LEN;
+        success = storage_file_write(file, batch, size) == size;
+        header.total_keys += count;
+    }
+
+    header.magic = PICOPASS_BINARY_DICT_MAGIC;
+    success = success && storage_file_seek(file, 0, true) &&
+              storage_file_write(file, &header, sizeof(header)) == sizeof(header);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    free(batch);
+    nfc_dict_free(dict);
+
+    FURI_LOG_I(TAG, "Converted %lu keys from %s", header.total_keys, txt_path);
+    return success ? header.total_keys : 0;
+}
+
+PicopassBinaryDict* picopass_binary_dict_alloc(const char* txt_path) {
+    furi_assert(txt_path);
+
+    PicopassBinaryDict* dict = malloc(sizeof(PicopassBinaryDict));
+    dict->storage = furi_record_open(RECORD_STORAGE);
+    dict->file = storage_file_alloc(dict->storage);
+    dict->batch = malloc(PICOPASS_BINARY_DICT_BATCH * PICOPASS_BINARY_DICT_KEY_LEN);
+
+    FuriString* bin_path = furi_string_alloc_set(txt_path);
+    FuriString* name = furi_string_alloc();
+    path_extract_filename(bin_path, name, true);
+    furi_string_printf(
+        bin_path, "%s/%s.bin", PICOPASS_BINARY_DICT_FOLDER, furi_string_get_cstr(name));
+    furi_string_free(name);
+
+    bool loaded = false;
+    do {
+        FileInfo info = {};
+        if(storage_common_stat(dict->storage, txt_path, &info) != FSE_OK) break;
+
+        if(storage_file_open(
+               dict->file, furi_string_get_cstr(bin_path), FSAM_READ, FSOM_OPEN_EXISTING) &&
+           picopass_binary_dict_is_valid(dict->file, info.size)) {
+            loaded = true;
+            break;
+        }
+        storage_file_close(dict->file);
+
+        storage_simply_mkdir(dict->storage, PICOPASS_BINARY_DICT_FOLDER);
+        picopass_binary_dict_convert(dict->storage, txt_path, furi_string_get_cstr(bin_path));
+
+        loaded = storage_file_open(
+                     dict->file, furi_string_get_cstr(bin_path), FSAM_READ, FSOM_OPEN_EXISTING) &&
+                 picopass_binary_dict_is_valid(dict->file, info.size);
+    } while(false);
+
+    furi_string_free(bin_path);
+
+    if(!loaded) {
+        FURI_LOG_E(TAG, "Failed to load binary form of %s", txt_path);
+        picopass_binary_dict_free(dict);
+        return NULL;
+    }
+
+    dict->total_keys = (storage_file_size(dict->file) - sizeof(PicopassBinaryDictHeader)) /
+                       PICOPASS_BINARY_DICT_KEY_LEN;
+    return dict;
+}
+
+void picopass_binary_dict_free(PicopassBinaryDict* dict) {
+    furi_assert(dict);
+
+    storage_file_close(dict->file);
+    storage_file_free(dict->file);
+    furi_record_close(RECORD_STORAGE);
+    free(dict->batch);
+    free(dict);
+}
+
+uint32_t picopass_binary_dict_get_total_keys(PicopassBinaryDict* dict) {
+    furi_assert(dict);
+
+    return dict->total_keys;
+}
+
+bool picopass_binary_dict_get_next_key(PicopassBinaryDict* dict, uint8_t* key) {
+    furi_assert(dict);
+
+    if(dict->batch_index == dict->batch_count) {
+        size_t read = storage_file_read(
+            dict->file, dict->batch, PICOPASS_BINARY_DICT_BATCH * PICOPASS_BINARY_DICT_KEY_LEN);
+        dict->batch_count = read / PICOPASS_BINARY_DICT_KEY_LEN;
+        dict->batch_index = 0;
+        if(dict->batch_count == 0) return false;
+    }
+
+    memcpy(
+        key,
+        &dict->batch[dict->batch_index * PICOPASS_BINARY_DICT_KEY_LEN],
+        PICOPASS_BINARY_DICT_KEY_LEN);
+    dict->batch_index++;
+    return true;
+}
+
+bool picopass_binary_dict_rewind(PicopassBinaryDict* dict) {
+    furi_assert(dict);
+
+    dict->batch_count = 0;
+    dict->batch_index = 0;
+    return storage_file_seek(dict->file, sizeof(PicopassBinaryDictHeader), true);
+}
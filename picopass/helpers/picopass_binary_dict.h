@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <storage/storage.h>
+
+#define PICOPASS_BINARY_DICT_FOLDER APP_DATA_PATH("cache")
+// Keys read from the SD card at once
+#define PICOPASS_BINARY_DICT_BATCH (512)
+
+/*
+ * Packed form of a .txt key dictionary: a small header followed by 8 bytes per key, read
+ * PICOPASS_BINARY_DICT_BATCH keys at a time so an attack does no parsing and rarely
+ * touches the SD card between auth attempts.
+ *
+ * The binary file is converted from the text dictionary when it is missing, incomplete or
+ * the text dictionary size changed.
+ */
+typedef struct PicopassBinaryDict PicopassBinaryDict;
+
+/** Convert a text dictionary into its packed form
+ *
+ * @return number of keys written, 0 on failure
+ */
+uint32_t picopass_binary_dict_convert(Storage* storage, const char* txt_path, const char* bin_path);
+
+/** Open the packed form of a text dictionary, converting it first if needed
+ *
+ * @return NULL if the dictionary cannot be read or the packed form cannot be written
+ */
+PicopassBinaryDict* picopass_binary_dict_alloc(const char* txt_path);
+
+void picopass_binary_dict_free(PicopassBinaryDict* dict);
+
+uint32_t picopass_binary_dict_get_total_keys(PicopassBinaryDict* dict);
+
+bool picopass_binary_dict_get_next_key(PicopassBinaryDict* dict, uint8_t* key);
+
+bool picopass_binary_dict_rewind(PicopassBinaryDict* dict);
@@ -0,0 +1,157 @@
+#include "picopass_keytable_cache.h"
+#include "../lib/loclass/optimized_elite.h"
+
+#include <furi.h>
+#include <nfc/helpers/nfc_dict.h>
+#include <lib/toolbox/path.h>
+
+#define TAG "PicopassKeytableCache"
+
+#define PICOPASS_KEYTABLE_CACHE_MAGIC (0x31544B50) // "PKT1"
+// Entries read from the SD card at once
+#define PICOPASS_KEYTABLE_CACHE_BATCH (8)
+
+typedef struct {
+    uint32_t magic;
+    uint32_t dict_size;
+    uint32_t total_keys;
+} PicopassKeytableCacheHeader;
+
+struct PicopassKeytableCache {
+    Storage* storage;
+    File* file;
+    uint32_t total_keys;
+    size_t batch_count;
+    size_t batch_index;
+    PicopassKeytableEntry batch[PICOPASS_KEYTABLE_CACHE_BATCH];
+};
+
+static bool picopass_keytable_cache_is_valid(File* file, uint32_t dict_size) {
+    PicopassKeytableCacheHeader header = {};
+    return storage_file_read(file, &header, sizeof(header)) == sizeof(header) &&
+           header.magic == PICOPASS_KEYTABLE_CACHE_MAGIC && header.dict_size == dict_size &&
+           storage_file_size(file) ==
+               sizeof(header) + header.total_keys * sizeof(PicopassKeytableEntry);
+}
+
+static bool picopass_keytable_cache_build(PicopassKeytableCache* cache, const char* dict_path) {
+    NfcDict* dict = nfc_dict_alloc(dict_path, NfcDictModeOpenExisting, sizeof(cache->batch[0].key));
+    if(!dict) return false;
+
+    FileInfo info = {};
+    storage_common_stat(cache->storage, dict_path, &info);
+    PicopassKeytableCacheHeader header = {
+        .magic = 0,
+        .dict_size = info.size,
+        .total_keys = 0,
+    };
+
+    uint32_t start = furi_get_tick();
+    // The magic is only written once all entries are there
+    bool success = storage_file_write(cache->file, &header, sizeof(header)) == sizeof(header);
+    while(success) {
+        size_t count = 0;
+        while(count < PICOPASS_KEYTABLE_CACHE_BATCH &&
+              nfc_dict_get_next_key(dict, cache->batch[count].key, sizeof(cache->batch[0].key))) {
+            loclass_hash2(cache->batch[count].key, cache->batch[count].keytable);
+            count++;
+        }
+        if(count == 0) break;
+
+        size_t size = count * sizeof(PicopassKeytableEntry);
+        success = storage_file_write(cache->file, cache->batch, size) == size;
+        header.total_keys += count;
+    }
+
+    header.magic = PICOPASS_KEYTABLE_CACHE_MAGIC;
+    success = success && storage_file_seek(cache->file, 0, true) &&
+              storage_file_write(cache->file, &header, sizeof(header)) == sizeof(header);
+
+    nfc_dict_free(dict);
+    FURI_LOG_I(
+        TAG, "Built %lu keytables in %lu ms", header.total_keys, furi_get_tick() - start);
+
+    return success;
+}
+
+PicopassKeytableCache* picopass_keytable_cache_alloc(const char* dict_path) {
+    furi_assert(dict_path);
+
+    PicopassKeytableCache* cache = malloc(sizeof(PicopassKeytableCache));
+    cache->storage = furi_record_open(RECORD_STORAGE);
+    cache->file = storage_file_alloc(cache->storage);
+
+    FuriString* cache_path = furi_string_alloc_set(dict_path);
+    FuriString* name = furi_string_alloc();
+    path_extract_filename(cache_path, name, true);
+    furi_string_printf(
+        cache_path, "%s/%s.keytable", PICOPASS_KEYTABLE_CACHE_FOLDER, furi_string_get_cstr(name));
+    furi_string_free(name);
+
+    bool loaded = false;
+    do {
+        FileInfo info = {};
+        if(storage_common_stat(cache->storage, dict_path, &info) != FSE_OK) break;
+
+        if(storage_file_open(
+               cache->file, furi_string_get_cstr(cache_path), FSAM_READ, FSOM_OPEN_EXISTING) &&
+           picopass_keytable_cache_is_valid(cache->file, info.size)) {
+            loaded = true;
+            break;
+        }
+        storage_file_close(cache->file);
+
+        storage_simply_mkdir(cache->storage, PICOPASS_KEYTABLE_CACHE_FOLDER);
+        if(!storage_file_open(
+               cache->file,
+               furi_string_get_cstr(cache_path),
+               FSAM_READ_WRITE,
+               FSOM_CREATE_ALWAYS)) {
+            break;
+        }
+        if(!picopass_keytable_cache_build(cache, dict_path)) break;
+
+        storage_file_seek(cache->file, 0, true);
+        loaded = picopass_keytable_cache_is_valid(cache->file, info.size);
+    } while(false);
+
+    furi_string_free(cache_path);
+
+    if(!loaded) {
+        FURI_LOG_E(TAG, "Failed to load keytable cache of %s", dict_path);
+        picopass_keytable_cache_free(cache);
+        return NULL;
+    }
+
+    cache->total_keys = (storage_file_size(cache->file) - sizeof(PicopassKeytableCacheHeader)) /
+                        sizeof(PicopassKeytableEntry);
+    return cache;
+}
+
+void picopass_keytable_cache_free(PicopassKeytableCache* cache) {
+    furi_assert(cache);
+
+    storage_file_close(cache->file);
+    storage_file_free(cache->file);
+    furi_record_close(RECORD_STORAGE);
+    free(cache);
+}
+
+uint32_t picopass_keytable_cache_get_total_keys(PicopassKeytableCache* cache) {
+    furi_assert(cache);
+
+    return cache->total_keys;
+}
+
+const PicopassKeytableEntry* picopass_keytable_cache_get_next(PicopassKeytableCache* cache) {
+    furi_assert(cache);
+
+    if(cache->batch_index == cache->batch_count) {
+        size_t read = storage_file_read(cache->file, cache->batch, sizeof(cache->batch));
+        cache->batch_count = read / sizeof(PicopassKeytableEntry);
+        cache->batch_index = 0;
+        if(cache->batch_count == 0) return NULL;
+    }
+
+    return &cache->batch[cache->batch_index++];
+}
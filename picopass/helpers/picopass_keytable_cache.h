@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <storage/storage.h>
+
+#define PICOPASS_KEYTABLE_LEN (128)
+#define PICOPASS_KEYTABLE_CACHE_FOLDER APP_DATA_PATH("cache")
+
+/*
+ * loclass_hash2() keytables of every key of an elite dictionary, kept on the SD card next
+ * to the app data. hash2 only depends on the key, so it is computed once per dictionary
+ * instead of once per key and card, leaving the cheap CSN dependent part to the attack.
+ *
+ * The cache is rebuilt when it is missing, incomplete or the dictionary size changed.
+ */
+typedef struct {
+    uint8_t key[8];
+    uint8_t keytable[PICOPASS_KEYTABLE_LEN];
+} PicopassKeytableEntry;
+
+typedef struct PicopassKeytableCache PicopassKeytableCache;
+
+/** Open the cache of a dictionary, building it first if needed
+ *
+ * @return NULL if the dictionary cannot be read or the cache cannot be written
+ */
+PicopassKeytableCache* picopass_keytable_cache_alloc(const char* dict_path);
+
+void picopass_keytable_cache_free(PicopassKeytableCache* cache);
+
+uint32_t picopass_keytable_cache_get_total_keys(PicopassKeytableCache* cache);
+
+/** Next entry of the dictionary
+ *
+ * @return entry that stays valid until the next call, NULL at the end
+ */
+const PicopassKeytableEntry* picopass_keytable_cache_get_next(PicopassKeytableCache* cache);
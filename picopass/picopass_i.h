@@ -34,6 +34,9 @@
 #include <nfc/helpers/nfc_dict.h>
 #include "protocol/picopass_poller.h"
 #include "protocol/picopass_listener.h"
+#include "helpers/picopass_keytable_cache.h"
+#include "helpers/picopass_binary_dict.h"
+#include "loclass_attack.h"
 
 #define PICOPASS_TEXT_STORE_SIZE 128
 
@@ -53,6 +56,9 @@ enum PicopassCustomEvent {
     PicopassCustomEventDictAttackUpdateView,
     PicopassCustomEventLoclassGotMac,
     PicopassCustomEventLoclassGotStandardKey,
+    PicopassCustomEventLoclassAttackProgress,
+    PicopassCustomEventLoclassAttackSuccess,
+    PicopassCustomEventLoclassAttackFail,
 
     PicopassCustomEventPollerSuccess,
     PicopassCustomEventPollerFail,
@@ -89,7 +95,9 @@ struct Picopass {
     Nfc* nfc;
     PicopassPoller* poller;
     PicopassListener* listener;
-    NfcDict* dict;
+    LoclassAttack* loclass_attack;
+    PicopassBinaryDict* dict;
+    PicopassKeytableCache* keytable_cache;
 
     char text_store[PICOPASS_TEXT_STORE_SIZE + 1];
     FuriString* text_box_store;
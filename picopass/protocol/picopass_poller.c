@@ -179,6 +179,7 @@ NfcCommand picopass_poller_auth_handler(PicopassPoller* instance) {
     do {
         // Request key
         instance->event.type = PicopassPollerEventTypeRequestKey;
+        instance->event_data.req_key.keytable = NULL;
         command = instance->callback(instance->event, instance->context);
         if(command != NfcCommandContinue) break;
 
@@ -187,19 +188,6 @@ NfcCommand picopass_poller_auth_handler(PicopassPoller* instance) {
             break;
         }
 
-        FURI_LOG_D(
-            TAG,
-            "Try to %s auth with key %02x%02x%02x%02x%02x%02x%02x%02x",
-            instance->event_data.req_key.is_elite_key ? "elite" : "standard",
-            instance->event_data.req_key.key[0],
-            instance->event_data.req_key.key[1],
-            instance->event_data.req_key.key[2],
-            instance->event_data.req_key.key[3],
-            instance->event_data.req_key.key[4],
-            instance->event_data.req_key.key[5],
-            instance->event_data.req_key.key[6],
-            instance->event_data.req_key.key[7]);
-
         PicopassReadCheckResp read_check_resp = {};
         uint8_t* csn = instance->serial_num.data;
         memset(instance->div_key, 0, sizeof(instance->div_key));
@@ -226,11 +214,16 @@ NfcCommand picopass_poller_auth_handler(PicopassPoller* instance) {
         }
         memcpy(ccnr, read_check_resp.data, sizeof(PicopassReadCheckResp)); // last 4 bytes left 0
 
-        loclass_iclass_calc_div_key(
-            csn,
-            instance->event_data.req_key.key,
-            div_key,
-            instance->event_data.req_key.is_elite_key);
+        if(instance->event_data.req_key.is_elite_key && instance->event_data.req_key.keytable) {
+            loclass_iclass_calc_div_key_keytable(
+                csn, instance->event_data.req_key.keytable, div_key);
+        } else {
+            loclass_iclass_calc_div_key(
+                csn,
+                instance->event_data.req_key.key,
+                div_key,
+                instance->event_data.req_key.is_elite_key);
+        }
         loclass_opt_doReaderMAC(ccnr, div_key, mac.data);
 
         PicopassCheckResp check_resp = {};
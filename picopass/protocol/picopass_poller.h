@@ -32,6 +32,8 @@ typedef struct {
     uint8_t key[PICOPASS_KEY_LEN];
     bool is_key_provided;
     bool is_elite_key;
+    // Optional loclass_hash2() keytable of an elite key, NULL to derive it from key
+    const uint8_t* keytable;
 } PicopassPollerEventDataRequestKey;
 
 typedef struct {
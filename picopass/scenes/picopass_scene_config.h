@@ -18,4 +18,5 @@ ADD_SCENE(picopass, key_menu, KeyMenu)
 ADD_SCENE(picopass, elite_dict_attack, EliteDictAttack)
 ADD_SCENE(picopass, emulate, Emulate)
 ADD_SCENE(picopass, loclass, Loclass)
+ADD_SCENE(picopass, loclass_attack, LoclassAttack)
 ADD_SCENE(picopass, key_input, KeyInput)
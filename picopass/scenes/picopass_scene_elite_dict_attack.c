@@ -16,32 +16,68 @@ const char* picopass_dict_name[] = {
     [PicopassSceneEliteDictAttackDictElite] = "Elite System Dictionary",
 };
 
+static void picopass_elite_dict_attack_close_dict(Picopass* picopass) {
+    if(picopass->dict) {
+        picopass_binary_dict_free(picopass->dict);
+        picopass->dict = NULL;
+    }
+    if(picopass->keytable_cache) {
+        picopass_keytable_cache_free(picopass->keytable_cache);
+        picopass->keytable_cache = NULL;
+    }
+}
+
+// Elite dictionaries go through their keytable cache, the packed dictionary is the fallback
+static void picopass_elite_dict_attack_open_dict(Picopass* picopass, const char* path, bool elite) {
+    if(elite) {
+        picopass->keytable_cache = picopass_keytable_cache_alloc(path);
+    }
+    if(picopass->keytable_cache) {
+        picopass->dict_attack_ctx.total_keys =
+            picopass_keytable_cache_get_total_keys(picopass->keytable_cache);
+    } else {
+        picopass->dict = picopass_binary_dict_alloc(path);
+        picopass->dict_attack_ctx.total_keys =
+            picopass->dict ? picopass_binary_dict_get_total_keys(picopass->dict) : 0;
+    }
+}
+
+static bool picopass_elite_dict_attack_get_next_key(
+    Picopass* picopass,
+    uint8_t* key,
+    const uint8_t** keytable) {
+    *keytable = NULL;
+    if(picopass->keytable_cache) {
+        const PicopassKeytableEntry* entry =
+            picopass_keytable_cache_get_next(picopass->keytable_cache);
+        if(!entry) return false;
+        memcpy(key, entry->key, PICOPASS_KEY_LEN);
+        *keytable = entry->keytable;
+        return true;
+    }
+    return picopass->dict && picopass_binary_dict_get_next_key(picopass->dict, key);
+}
+
 static bool picopass_elite_dict_attack_change_dict(Picopass* picopass) {
     bool success = false;
 
     do {
         uint32_t scene_state =
             scene_manager_get_scene_state(picopass->scene_manager, PicopassSceneEliteDictAttack);
-        nfc_dict_free(picopass->dict);
-        picopass->dict = NULL;
+        picopass_elite_dict_attack_close_dict(picopass);
         if(scene_state == PicopassSceneEliteDictAttackDictElite) break;
         if(scene_state == PicopassSceneEliteDictAttackDictEliteUser) {
             if(!nfc_dict_check_presence(PICOPASS_ICLASS_STANDARD_DICT_FLIPPER_NAME)) break;
-            picopass->dict = nfc_dict_alloc(
-                PICOPASS_ICLASS_STANDARD_DICT_FLIPPER_NAME,
-                NfcDictModeOpenExisting,
-                PICOPASS_KEY_LEN);
+            picopass_elite_dict_attack_open_dict(
+                picopass, PICOPASS_ICLASS_STANDARD_DICT_FLIPPER_NAME, false);
             scene_state = PicopassSceneEliteDictAttackDictStandart;
         } else if(scene_state == PicopassSceneEliteDictAttackDictStandart) {
             if(!nfc_dict_check_presence(PICOPASS_ICLASS_ELITE_DICT_FLIPPER_NAME)) break;
-            picopass->dict = nfc_dict_alloc(
-                PICOPASS_ICLASS_ELITE_DICT_FLIPPER_NAME,
-                NfcDictModeOpenExisting,
-                PICOPASS_KEY_LEN);
+            picopass_elite_dict_attack_open_dict(
+                picopass, PICOPASS_ICLASS_ELITE_DICT_FLIPPER_NAME, true);
             scene_state = PicopassSceneEliteDictAttackDictElite;
         }
         picopass->dict_attack_ctx.card_detected = true;
-        picopass->dict_attack_ctx.total_keys = nfc_dict_get_total_keys(picopass->dict);
         picopass->dict_attack_ctx.current_key = 0;
         picopass->dict_attack_ctx.name = picopass_dict_name[scene_state];
         scene_manager_set_scene_state(
@@ -62,10 +98,12 @@ NfcCommand picopass_elite_dict_attack_worker_callback(PicopassPollerEvent event,
         event.data->req_mode.mode = PicopassPollerModeRead;
     } else if(event.type == PicopassPollerEventTypeRequestKey) {
         uint8_t key[PICOPASS_KEY_LEN] = {};
+        const uint8_t* keytable = NULL;
         bool is_key_provided = true;
-        if(!nfc_dict_get_next_key(picopass->dict, key, PICOPASS_KEY_LEN)) {
+        if(!picopass_elite_dict_attack_get_next_key(picopass, key, &keytable)) {
             if(picopass_elite_dict_attack_change_dict(picopass)) {
-                is_key_provided = nfc_dict_get_next_key(picopass->dict, key, PICOPASS_KEY_LEN);
+                is_key_provided =
+                    picopass_elite_dict_attack_get_next_key(picopass, key, &keytable);
                 view_dispatcher_send_custom_event(
                     picopass->view_dispatcher, PicopassCustomEventDictAttackUpdateView);
             } else {
@@ -77,6 +115,7 @@ NfcCommand picopass_elite_dict_attack_worker_callback(PicopassPollerEvent event,
         memcpy(event.data->req_key.key, key, PICOPASS_KEY_LEN);
         event.data->req_key.is_elite_key =
             (scene_state != PicopassSceneEliteDictAttackDictStandart);
+        event.data->req_key.keytable = keytable;
         event.data->req_key.is_key_provided = is_key_provided;
         if(is_key_provided) {
             picopass->dict_attack_ctx.current_key++;
@@ -139,22 +178,20 @@ void picopass_scene_elite_dict_attack_on_enter(void* context) {
 
     bool use_user_dict = nfc_dict_check_presence(PICOPASS_ICLASS_ELITE_DICT_USER_NAME);
     if(use_user_dict) {
-        picopass->dict = nfc_dict_alloc(
-            PICOPASS_ICLASS_ELITE_DICT_USER_NAME, NfcDictModeOpenExisting, PICOPASS_KEY_LEN);
-        if(nfc_dict_get_total_keys(picopass->dict) == 0) {
-            nfc_dict_free(picopass->dict);
+        picopass_elite_dict_attack_open_dict(picopass, PICOPASS_ICLASS_ELITE_DICT_USER_NAME, true);
+        if(picopass->dict_attack_ctx.total_keys == 0) {
+            picopass_elite_dict_attack_close_dict(picopass);
             use_user_dict = false;
         }
     }
     if(use_user_dict) {
         state = PicopassSceneEliteDictAttackDictEliteUser;
     } else {
-        picopass->dict = nfc_dict_alloc(
-            PICOPASS_ICLASS_STANDARD_DICT_FLIPPER_NAME, NfcDictModeOpenExisting, PICOPASS_KEY_LEN);
+        picopass_elite_dict_attack_open_dict(
+            picopass, PICOPASS_ICLASS_STANDARD_DICT_FLIPPER_NAME, false);
         state = PicopassSceneEliteDictAttackDictStandart;
     }
     picopass->dict_attack_ctx.card_detected = true;
-    picopass->dict_attack_ctx.total_keys = nfc_dict_get_total_keys(picopass->dict);
     picopass->dict_attack_ctx.current_key = 0;
     picopass->dict_attack_ctx.name = picopass_dict_name[state];
     scene_manager_set_scene_state(picopass->scene_manager, PicopassSceneEliteDictAttack, state);
@@ -217,10 +254,7 @@ bool picopass_scene_elite_dict_attack_on_event(void* context, SceneManagerEvent
 void picopass_scene_elite_dict_attack_on_exit(void* context) {
     Picopass* picopass = context;
 
-    if(picopass->dict) {
-        nfc_dict_free(picopass->dict);
-        picopass->dict = NULL;
-    }
+    picopass_elite_dict_attack_close_dict(picopass);
     picopass->dict_attack_ctx.current_key = 0;
     picopass->dict_attack_ctx.total_keys = 0;
 
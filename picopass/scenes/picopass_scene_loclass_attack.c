@@ -0,0 +1,186 @@
+#include "../picopass_i.h"
+#include "../helpers/iclass_elite_dict.h"
+
+enum {
+    PicopassSceneLoclassAttackStateRunning,
+    PicopassSceneLoclassAttackStateSuccess,
+    PicopassSceneLoclassAttackStateFail,
+};
+
+static void picopass_scene_loclass_attack_callback(LoclassAttackEvent event, void* context) {
+    furi_assert(context);
+    Picopass* picopass = context;
+
+    if(event == LoclassAttackEventProgress) {
+        view_dispatcher_send_custom_event(
+            picopass->view_dispatcher, PicopassCustomEventLoclassAttackProgress);
+    } else if(event == LoclassAttackEventSuccess) {
+        view_dispatcher_send_custom_event(
+            picopass->view_dispatcher, PicopassCustomEventLoclassAttackSuccess);
+    } else if(event == LoclassAttackEventFail) {
+        view_dispatcher_send_custom_event(
+            picopass->view_dispatcher, PicopassCustomEventLoclassAttackFail);
+    }
+}
+
+static void picopass_scene_loclass_attack_widget_callback(
+    GuiButtonType result,
+    InputType type,
+    void* context) {
+    furi_assert(context);
+    Picopass* picopass = context;
+
+    if(type == InputTypeShort) {
+        view_dispatcher_send_custom_event(picopass->view_dispatcher, result);
+    }
+}
+
+static void picopass_scene_loclass_attack_show_progress(Picopass* picopass) {
+    LoclassAttackProgress progress = {};
+    loclass_attack_get_progress(picopass->loclass_attack, &progress);
+
+    FuriString* str = furi_string_alloc_printf(
+        "CSN %u of %u\n", progress.items_done + 1, progress.items_total);
+    if(progress.bytes_to_recover) {
+        furi_string_cat_printf(
+            str,
+            "%u bytes: %lu%%\n",
+            progress.bytes_to_recover,
+            (uint32_t)((uint64_t)progress.candidates_done * 100 / progress.candidates_total));
+        if(progress.candidates_per_second) {
+            uint32_t left = (progress.candidates_total - progress.candidates_done) /
+                            progress.candidates_per_second;
+            furi_string_cat_printf(
+                str,
+                "%lu keys/s, %lum%02lus left",
+                progress.candidates_per_second,
+                left / 60,
+                left % 60);
+        }
+    }
+
+    Widget* widget = picopass->widget;
+    widget_reset(widget);
+    widget_add_string_element(
+        widget, 64, 5, AlignCenter, AlignCenter, FontPrimary, "Loclass Attack");
+    widget_add_string_multiline_element(
+        widget, 64, 36, AlignCenter, AlignCenter, FontSecondary, furi_string_get_cstr(str));
+    furi_string_free(str);
+}
+
+static void picopass_scene_loclass_attack_show_result(Picopass* picopass) {
+    Widget* widget = picopass->widget;
+    widget_reset(widget);
+
+    uint8_t key[PICOPASS_KEY_LEN] = {};
+    if(loclass_attack_get_key(picopass->loclass_attack, key)) {
+        FuriString* str = furi_string_alloc();
+        for(size_t i = 0; i < PICOPASS_KEY_LEN; i++) {
+            furi_string_cat_printf(str, "%02X", key[i]);
+        }
+        widget_add_string_element(
+            widget, 64, 5, AlignCenter, AlignCenter, FontPrimary, "Key Found");
+        widget_add_string_element(
+            widget, 64, 24, AlignCenter, AlignCenter, FontSecondary, furi_string_get_cstr(str));
+        widget_add_button_element(
+            widget,
+            GuiButtonTypeCenter,
+            "Add to Dict",
+            picopass_scene_loclass_attack_widget_callback,
+            picopass);
+        furi_string_free(str);
+    } else {
+        widget_add_string_element(
+            widget, 64, 5, AlignCenter, AlignCenter, FontPrimary, "Attack Failed");
+        widget_add_string_multiline_element(
+            widget,
+            64,
+            36,
+            AlignCenter,
+            AlignCenter,
+            FontSecondary,
+            "Collected MACs do not\nlead to a key, collect\nthem again");
+    }
+}
+
+void picopass_scene_loclass_attack_on_enter(void* context) {
+    Picopass* picopass = context;
+
+    scene_manager_set_scene_state(
+        picopass->scene_manager,
+        PicopassSceneLoclassAttack,
+        PicopassSceneLoclassAttackStateRunning);
+
+    picopass->loclass_attack = loclass_attack_alloc();
+    if(loclass_attack_start(
+           picopass->loclass_attack, picopass_scene_loclass_attack_callback, picopass)) {
+        picopass_scene_loclass_attack_show_progress(picopass);
+    } else {
+        scene_manager_set_scene_state(
+            picopass->scene_manager,
+            PicopassSceneLoclassAttack,
+            PicopassSceneLoclassAttackStateFail);
+        widget_add_string_element(
+            picopass->widget, 64, 5, AlignCenter, AlignCenter, FontPrimary, "No Loclass Log");
+        widget_add_string_multiline_element(
+            picopass->widget,
+            64,
+            36,
+            AlignCenter,
+            AlignCenter,
+            FontSecondary,
+            "Collect reader MACs\nwith Loclass first");
+    }
+
+    view_dispatcher_switch_to_view(picopass->view_dispatcher, PicopassViewWidget);
+}
+
+bool picopass_scene_loclass_attack_on_event(void* context, SceneManagerEvent event) {
+    Picopass* picopass = context;
+    bool consumed = false;
+
+    if(event.type == SceneManagerEventTypeCustom) {
+        if(event.event == PicopassCustomEventLoclassAttackProgress) {
+            if(scene_manager_get_scene_state(
+                   picopass->scene_manager, PicopassSceneLoclassAttack) ==
+               PicopassSceneLoclassAttackStateRunning) {
+                picopass_scene_loclass_attack_show_progress(picopass);
+            }
+            consumed = true;
+        } else if(
+            event.event == PicopassCustomEventLoclassAttackSuccess ||
+            event.event == PicopassCustomEventLoclassAttackFail) {
+            bool success = event.event == PicopassCustomEventLoclassAttackSuccess;
+            scene_manager_set_scene_state(
+                picopass->scene_manager,
+                PicopassSceneLoclassAttack,
+                success ? PicopassSceneLoclassAttackStateSuccess :
+                          PicopassSceneLoclassAttackStateFail);
+            notification_message(
+                picopass->notifications, success ? &sequence_success : &sequence_error);
+            picopass_scene_loclass_attack_show_result(picopass);
+            consumed = true;
+        } else if(event.event == GuiButtonTypeCenter) {
+            uint8_t key[PICOPASS_KEY_LEN] = {};
+            IclassEliteDict* dict = iclass_elite_dict_alloc(IclassEliteDictTypeUser);
+            if(dict && loclass_attack_get_key(picopass->loclass_attack, key)) {
+                iclass_elite_dict_add_key(dict, key);
+                notification_message(picopass->notifications, &sequence_single_vibro);
+            }
+            if(dict) iclass_elite_dict_free(dict);
+            consumed = scene_manager_previous_scene(picopass->scene_manager);
+        }
+    }
+
+    return consumed;
+}
+
+void picopass_scene_loclass_attack_on_exit(void* context) {
+    Picopass* picopass = context;
+
+    // Saves the progress so the next run resumes
+    loclass_attack_free(picopass->loclass_attack);
+    picopass->loclass_attack = NULL;
+
+    widget_reset(picopass->widget);
+}
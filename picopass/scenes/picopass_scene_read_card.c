@@ -7,19 +7,48 @@ enum {
     PicopassSceneReadCardDictElite,
 };
 
+static void picopass_read_card_close_dict(Picopass* picopass) {
+    if(picopass->dict) {
+        picopass_binary_dict_free(picopass->dict);
+        picopass->dict = NULL;
+    }
+    if(picopass->keytable_cache) {
+        picopass_keytable_cache_free(picopass->keytable_cache);
+        picopass->keytable_cache = NULL;
+    }
+}
+
+static bool picopass_read_card_get_next_key(
+    Picopass* picopass,
+    uint8_t* key,
+    const uint8_t** keytable) {
+    *keytable = NULL;
+    if(picopass->keytable_cache) {
+        const PicopassKeytableEntry* entry =
+            picopass_keytable_cache_get_next(picopass->keytable_cache);
+        if(!entry) return false;
+        memcpy(key, entry->key, PICOPASS_KEY_LEN);
+        *keytable = entry->keytable;
+        return true;
+    }
+    return picopass->dict && picopass_binary_dict_get_next_key(picopass->dict, key);
+}
+
 static bool picopass_read_card_change_dict(Picopass* picopass) {
     bool success = false;
 
     do {
         uint32_t scene_state =
             scene_manager_get_scene_state(picopass->scene_manager, PicopassSceneReadCard);
-        nfc_dict_free(picopass->dict);
-        picopass->dict = NULL;
+        picopass_read_card_close_dict(picopass);
         if(scene_state == PicopassSceneReadCardDictElite) break;
         if(!nfc_dict_check_presence(PICOPASS_ICLASS_ELITE_DICT_FLIPPER_NAME)) break;
 
-        picopass->dict = nfc_dict_alloc(
-            PICOPASS_ICLASS_ELITE_DICT_FLIPPER_NAME, NfcDictModeOpenExisting, PICOPASS_KEY_LEN);
+        picopass->keytable_cache =
+            picopass_keytable_cache_alloc(PICOPASS_ICLASS_ELITE_DICT_FLIPPER_NAME);
+        if(!picopass->keytable_cache) {
+            picopass->dict = picopass_binary_dict_alloc(PICOPASS_ICLASS_ELITE_DICT_FLIPPER_NAME);
+        }
         scene_manager_set_scene_state(
             picopass->scene_manager, PicopassSceneReadCard, PicopassSceneReadCardDictElite);
         success = true;
@@ -38,10 +67,11 @@ NfcCommand picopass_read_card_worker_callback(PicopassPollerEvent event, void* c
         event.data->req_mode.mode = PicopassPollerModeRead;
     } else if(event.type == PicopassPollerEventTypeRequestKey) {
         uint8_t key[PICOPASS_KEY_LEN] = {};
+        const uint8_t* keytable = NULL;
         bool is_key_provided = true;
-        if(!nfc_dict_get_next_key(picopass->dict, key, PICOPASS_KEY_LEN)) {
+        if(!picopass_read_card_get_next_key(picopass, key, &keytable)) {
             if(picopass_read_card_change_dict(picopass)) {
-                is_key_provided = nfc_dict_get_next_key(picopass->dict, key, PICOPASS_KEY_LEN);
+                is_key_provided = picopass_read_card_get_next_key(picopass, key, &keytable);
             } else {
                 is_key_provided = false;
             }
@@ -50,6 +80,7 @@ NfcCommand picopass_read_card_worker_callback(PicopassPollerEvent event, void* c
             scene_manager_get_scene_state(picopass->scene_manager, PicopassSceneReadCard);
         memcpy(event.data->req_key.key, key, PICOPASS_KEY_LEN);
         event.data->req_key.is_elite_key = (scene_state == PicopassSceneReadCardDictElite);
+        event.data->req_key.keytable = keytable;
         event.data->req_key.is_key_provided = is_key_provided;
     } else if(event.type == PicopassPollerEventTypeSuccess) {
         const PicopassDeviceData* data = picopass_poller_get_data(picopass->poller);
@@ -75,8 +106,7 @@ void picopass_scene_read_card_on_enter(void* context) {
     popup_set_header(popup, "Detecting\npicopass\ncard", 68, 30, AlignLeft, AlignTop);
     popup_set_icon(popup, 0, 3, &I_RFIDDolphinReceive_97x61);
 
-    picopass->dict = nfc_dict_alloc(
-        PICOPASS_ICLASS_STANDARD_DICT_FLIPPER_NAME, NfcDictModeOpenExisting, PICOPASS_KEY_LEN);
+    picopass->dict = picopass_binary_dict_alloc(PICOPASS_ICLASS_STANDARD_DICT_FLIPPER_NAME);
     scene_manager_set_scene_state(
         picopass->scene_manager, PicopassSceneReadCard, PicopassSceneReadCardDictStandart);
     // Start worker
@@ -110,10 +140,7 @@ bool picopass_scene_read_card_on_event(void* context, SceneManagerEvent event) {
 void picopass_scene_read_card_on_exit(void* context) {
     Picopass* picopass = context;
 
-    if(picopass->dict) {
-        nfc_dict_free(picopass->dict);
-        picopass->dict = NULL;
-    }
+    picopass_read_card_close_dict(picopass);
     picopass_poller_stop(picopass->poller);
     picopass_poller_free(picopass->poller);
 
@@ -4,6 +4,7 @@ enum SubmenuIndex {
     SubmenuIndexEliteDictAttack,
     SubmenuIndexSaved,
     SubmenuIndexLoclass,
+    SubmenuIndexLoclassAttack,
 };
 
 void picopass_scene_start_submenu_callback(void* context, uint32_t index) {
@@ -27,6 +28,12 @@ void picopass_scene_start_on_enter(void* context) {
 
     submenu_add_item(
         submenu, "Loclass", SubmenuIndexLoclass, picopass_scene_start_submenu_callback, picopass);
+    submenu_add_item(
+        submenu,
+        "Loclass Attack",
+        SubmenuIndexLoclassAttack,
+        picopass_scene_start_submenu_callback,
+        picopass);
 
     submenu_set_selected_item(
         submenu, scene_manager_get_scene_state(picopass->scene_manager, PicopassSceneStart));
@@ -61,6 +68,11 @@ bool picopass_scene_start_on_event(void* context, SceneManagerEvent event) {
                 picopass->scene_manager, PicopassSceneStart, PicopassSceneLoclass);
             scene_manager_next_scene(picopass->scene_manager, PicopassSceneLoclass);
             consumed = true;
+        } else if(event.event == SubmenuIndexLoclassAttack) {
+            scene_manager_set_scene_state(
+                picopass->scene_manager, PicopassSceneStart, SubmenuIndexLoclassAttack);
+            scene_manager_next_scene(picopass->scene_manager, PicopassSceneLoclassAttack);
+            consumed = true;
         }
     }
 
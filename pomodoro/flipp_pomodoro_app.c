@@ -20,12 +20,44 @@ static void flipp_pomodoro_app_tick_event_callback(void* ctx) {
     scene_manager_handle_custom_event(app->scene_manager, FlippPomodoroAppCustomEventTimerTick);
 };
 
+static void flipp_pomodoro_app_record_stage(
+    FlippPomodoroApp* app,
+    FlippPomodoroStageOutcome outcome,
+    uint32_t ended_at) {
+    flipp_pomodoro_statistics__record_stage(
+        app->statistics,
+        flipp_pomodoro__get_stage(app->state),
+        outcome,
+        flipp_pomodoro__stage_started_timestamp(app->state),
+        ended_at);
+}
+
+void flipp_pomodoro_app_catch_up(FlippPomodoroApp* app) {
+    furi_assert(app);
+    while(flipp_pomodoro__is_stage_expired(app->state)) {
+        const PomodoroStage stage = flipp_pomodoro__get_stage(app->state);
+        flipp_pomodoro_app_record_stage(
+            app,
+            FlippPomodoroStageOutcomeCompleted,
+            flipp_pomodoro__stage_expires_timestamp(app->state));
+
+        // The session is over once its long break ran out, the next one starts fresh
+        if(stage == FlippPomodoroStageLongBreak) {
+            flipp_pomodoro__destroy(app->state);
+            app->state = flipp_pomodoro__new();
+            break;
+        }
+        flipp_pomodoro__complete_stage(app->state);
+    }
+}
+
 static bool flipp_pomodoro_app_custom_event_callback(void* ctx, uint32_t event) {
     furi_assert(ctx);
     FlippPomodoroApp* app = ctx;
 
     switch(event) {
     case FlippPomodoroAppCustomEventStageSkip:
+        flipp_pomodoro_app_record_stage(app, FlippPomodoroStageOutcomeAborted, time_now());
         flipp_pomodoro__toggle_stage(app->state);
         view_dispatcher_send_custom_event(
             app->view_dispatcher, FlippPomodoroAppCustomEventStateUpdated);
@@ -35,11 +67,13 @@ static bool flipp_pomodoro_app_custom_event_callback(void* ctx, uint32_t event)
             // REGISTER a deed on work stage complete to get an acheivement
             dolphin_deed(DolphinDeedPluginGameWin);
             FURI_LOG_I(TAG, "Focus stage reward added");
-
-            flipp_pomodoro_statistics__increase_focus_stages_completed(app->statistics);
         };
 
-        flipp_pomodoro__toggle_stage(app->state);
+        flipp_pomodoro_app_record_stage(
+            app,
+            FlippPomodoroStageOutcomeCompleted,
+            flipp_pomodoro__stage_expires_timestamp(app->state));
+        flipp_pomodoro__complete_stage(app->state);
         notification_message(
             app->notification_app,
             stage_start_notification_sequence_map[flipp_pomodoro__get_stage(app->state)]);
@@ -54,7 +88,7 @@ static bool flipp_pomodoro_app_custom_event_callback(void* ctx, uint32_t event)
 
 FlippPomodoroApp* flipp_pomodoro_app_alloc() {
     FlippPomodoroApp* app = malloc(sizeof(FlippPomodoroApp));
-    app->state = flipp_pomodoro__new();
+    app->state = flipp_pomodoro__load();
 
     app->scene_manager = scene_manager_alloc(&flipp_pomodoro_scene_handlers, app);
     app->gui = furi_record_open(RECORD_GUI);
@@ -62,6 +96,7 @@ FlippPomodoroApp* flipp_pomodoro_app_alloc() {
 
     app->view_dispatcher = view_dispatcher_alloc();
     app->statistics = flipp_pomodoro_statistics__new();
+    flipp_pomodoro_app_catch_up(app);
 
     view_dispatcher_enable_queue(app->view_dispatcher);
     view_dispatcher_set_event_callback_context(app->view_dispatcher, app);
@@ -99,6 +134,8 @@ void flipp_pomodoro_app_free(FlippPomodoroApp* app) {
     flipp_pomodoro_view_timer_free(app->timer_view);
     flipp_pomodoro_info_view_free(app->info_view);
     flipp_pomodoro_statistics__destroy(app->statistics);
+    // The timer only lives on timestamps, saving them keeps the session going while closed
+    flipp_pomodoro__save(app->state);
     flipp_pomodoro__destroy(app->state);
     free(app);
     furi_record_close(RECORD_GUI);
@@ -20,6 +20,7 @@ typedef enum {
     FlippPomodoroAppCustomEventTimerAskHint,
     FlippPomodoroAppCustomEventStateUpdated,
     FlippPomodoroAppCustomEventResumeTimer,
+    FlippPomodoroAppCustomEventExportStatistics,
 } FlippPomodoroAppCustomEvent;
 
 typedef struct {
@@ -36,4 +37,8 @@ typedef struct {
 typedef enum {
     FlippPomodoroAppViewTimer,
     FlippPomodoroAppViewInfo,
-} FlippPomodoroAppView;
\ No newline at end of file
+} FlippPomodoroAppView;
+
+/// @brief Counts the stages that ran out while the app was closed or busy elsewhere
+/// @param app - the app whose state may have expired
+void flipp_pomodoro_app_catch_up(FlippPomodoroApp* app);
\ No newline at end of file
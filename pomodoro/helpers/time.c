@@ -4,6 +4,7 @@
 
 const int TIME_SECONDS_IN_MINUTE = 60;
 const int TIME_MINUTES_IN_HOUR = 60;
+const int TIME_SECONDS_IN_DAY = 24 * 60 * 60;
 
 uint32_t time_now() {
     return furi_hal_rtc_get_timestamp();
@@ -18,3 +19,32 @@ TimeDifference time_difference_seconds(uint32_t begin, uint32_t end) {
     return (
         TimeDifference){.total_seconds = duration_seconds, .minutes = minutes, .seconds = seconds};
 };
+
+uint32_t time_day(uint32_t timestamp) {
+    return timestamp / TIME_SECONDS_IN_DAY;
+};
+
+uint32_t time_week(uint32_t day) {
+    // 1970-01-01 was a Thursday
+    return (day + 3) / 7;
+};
+
+uint8_t time_weekday(uint32_t day) {
+    return (day + 3) % 7;
+};
+
+void time_date(uint32_t day, uint16_t* year, uint8_t* month, uint8_t* month_day) {
+    // Counted in 400 year eras of March-based years, so leap days fall at the end of a year
+    const uint32_t shifted = day + 719468;
+    const uint32_t era = shifted / 146097;
+    const uint32_t day_of_era = shifted - era * 146097;
+    const uint32_t year_of_era =
+        (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    const uint32_t day_of_year =
+        day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    const uint32_t march_month = (5 * day_of_year + 2) / 153;
+
+    *month_day = day_of_year - (153 * march_month + 2) / 5 + 1;
+    *month = march_month < 10 ? march_month + 3 : march_month - 9;
+    *year = year_of_era + era * 400 + (*month <= 2);
+};
@@ -5,6 +5,7 @@
 
 extern const int TIME_SECONDS_IN_MINUTE;
 extern const int TIME_MINUTES_IN_HOUR;
+extern const int TIME_SECONDS_IN_DAY;
 
 /// @brief Container for a time period
 typedef struct {
@@ -22,3 +23,25 @@ uint32_t time_now();
 /// @param end - end timestamp of the period to measure
 /// @return TimeDifference struct
 TimeDifference time_difference_seconds(uint32_t begin, uint32_t end);
+
+/// @brief Day number of a timestamp, counted from 1970-01-01
+/// @param timestamp - RTC timestamp, the RTC keeps local time
+/// @return Days since the epoch
+uint32_t time_day(uint32_t timestamp);
+
+/// @brief Week number of a day, weeks start on Monday
+/// @param day - day number from time_day
+/// @return Weeks since the one the epoch falls into
+uint32_t time_week(uint32_t day);
+
+/// @brief Day of the week
+/// @param day - day number from time_day
+/// @return 0 for Monday to 6 for Sunday
+uint8_t time_weekday(uint32_t day);
+
+/// @brief Calendar date of a day
+/// @param day - day number from time_day
+/// @param year - receives the year
+/// @param month - receives the month, 1 to 12
+/// @param month_day - receives the day of the month, 1 to 31
+void time_date(uint32_t day, uint16_t* year, uint8_t* month, uint8_t* month_day);
@@ -1,8 +1,11 @@
 #include <furi.h>
 #include <furi_hal.h>
+#include <storage/storage.h>
 #include "../helpers/time.h"
 #include "flipp_pomodoro.h"
 
+#define SESSION_PATH APP_DATA_PATH("session")
+
 PomodoroStage stages_sequence[] = {
     FlippPomodoroStageFocus,
     FlippPomodoroStageRest,
@@ -30,7 +33,7 @@ char* next_stage_label[] = {
 };
 
 PomodoroStage flipp_pomodoro__stage_by_index(int index) {
-    const int one_loop_size = sizeof(stages_sequence);
+    const int one_loop_size = sizeof(stages_sequence) / sizeof(stages_sequence[0]);
     return stages_sequence[index % one_loop_size];
 }
 
@@ -40,6 +43,12 @@ void flipp_pomodoro__toggle_stage(FlippPomodoroState* state) {
     state->started_at_timestamp = time_now();
 };
 
+void flipp_pomodoro__complete_stage(FlippPomodoroState* state) {
+    furi_assert(state);
+    state->started_at_timestamp = flipp_pomodoro__stage_expires_timestamp(state);
+    state->current_stage_index = state->current_stage_index + 1;
+};
+
 PomodoroStage flipp_pomodoro__get_stage(FlippPomodoroState* state) {
     furi_assert(state);
     return flipp_pomodoro__stage_by_index(state->current_stage_index);
@@ -70,6 +79,10 @@ uint32_t flipp_pomodoro__current_stage_total_duration(FlippPomodoroState* state)
     return stage_duration_seconds_map[flipp_pomodoro__get_stage(state)];
 };
 
+uint32_t flipp_pomodoro__stage_started_timestamp(FlippPomodoroState* state) {
+    return state->started_at_timestamp;
+};
+
 uint32_t flipp_pomodoro__stage_expires_timestamp(FlippPomodoroState* state) {
     return state->started_at_timestamp + flipp_pomodoro__current_stage_total_duration(state);
 };
@@ -91,4 +104,36 @@ FlippPomodoroState* flipp_pomodoro__new() {
     state->started_at_timestamp = now;
     state->current_stage_index = 0;
     return state;
+};
+
+FlippPomodoroState* flipp_pomodoro__load() {
+    FlippPomodoroState* state = flipp_pomodoro__new();
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+
+    FlippPomodoroState saved;
+    if(storage_file_open(file, SESSION_PATH, FSAM_READ, FSOM_OPEN_EXISTING) &&
+       storage_file_read(file, &saved, sizeof(saved)) == sizeof(saved)) {
+        *state = saved;
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    return state;
+};
+
+void flipp_pomodoro__save(FlippPomodoroState* state) {
+    furi_assert(state);
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, STORAGE_APP_DATA_PATH_PREFIX);
+    File* file = storage_file_alloc(storage);
+
+    if(storage_file_open(file, SESSION_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        storage_file_write(file, state, sizeof(FlippPomodoroState));
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
 };
\ No newline at end of file
@@ -20,6 +20,14 @@ typedef struct {
 /// @returns A new pre-populated state for pomodoro timer
 FlippPomodoroState* flipp_pomodoro__new();
 
+/// @brief Restores the session saved when the app was last closed
+/// @returns The saved state, or a new one if there is none
+FlippPomodoroState* flipp_pomodoro__load();
+
+/// @brief Saves the session, so it goes on when the app is opened again
+/// @param state - pointer to the state of pomorodo
+void flipp_pomodoro__save(FlippPomodoroState* state);
+
 /// @brief Extract current stage of pomodoro
 /// @param state - pointer to the state of pomorodo
 /// @returns Current stage value
@@ -51,3 +59,17 @@ bool flipp_pomodoro__is_stage_expired(FlippPomodoroState* state);
 /// @brief Rotate stage of the timer
 /// @param state - pointer to the state of pomorodo.
 void flipp_pomodoro__toggle_stage(FlippPomodoroState* state);
+
+/// @brief Timestamp the current stage started at
+/// @param state - pointer to the state of pomorodo.
+/// @returns RTC timestamp
+uint32_t flipp_pomodoro__stage_started_timestamp(FlippPomodoroState* state);
+
+/// @brief Timestamp the current stage runs out at
+/// @param state - pointer to the state of pomorodo.
+/// @returns RTC timestamp
+uint32_t flipp_pomodoro__stage_expires_timestamp(FlippPomodoroState* state);
+
+/// @brief Rotate to the next stage, starting it when the current one ran out
+/// @param state - pointer to the state of pomorodo.
+void flipp_pomodoro__complete_stage(FlippPomodoroState* state);
@@ -1,23 +1,277 @@
 #include "flipp_pomodoro_statistics.h"
+#include "../helpers/time.h"
+#include <storage/storage.h>
+
+#define STATISTICS_LOG_PATH APP_DATA_PATH("stages.log")
+#define STATISTICS_INDEX_PATH APP_DATA_PATH("statistics.idx")
+#define STATISTICS_EXPORT_PATH APP_DATA_PATH("history.csv")
+// "FPS" and the layout version, an index of another layout is rebuilt
+#define STATISTICS_MAGIC 0x01535046
+
+/// @brief A line of the log, appended when a stage ends
+typedef struct {
+    uint32_t ended_at;
+    uint16_t seconds;
+    uint8_t stage;
+    uint8_t outcome;
+} FlippPomodoroStatisticsRecord;
+
+static const char* const stage_names[] = {
+    [FlippPomodoroStageFocus] = "focus",
+    [FlippPomodoroStageRest] = "rest",
+    [FlippPomodoroStageLongBreak] = "long break",
+};
+
+static void flipp_pomodoro_statistics__reset(FlippPomodoroStatistics* statistics) {
+    memset(statistics, 0, sizeof(FlippPomodoroStatistics));
+    statistics->magic = STATISTICS_MAGIC;
+}
+
+// Totals of the given day or week, moving the window forward if it is a new one
+static FlippPomodoroStatisticsTotals* flipp_pomodoro_statistics__slot(
+    FlippPomodoroStatisticsTotals* totals,
+    size_t count,
+    uint32_t* last,
+    uint32_t at) {
+    if(at > *last) {
+        const uint32_t by = at - *last;
+        if(by >= count) {
+            memset(totals, 0, sizeof(FlippPomodoroStatisticsTotals) * count);
+        } else {
+            memmove(totals + by, totals, sizeof(FlippPomodoroStatisticsTotals) * (count - by));
+            memset(totals, 0, sizeof(FlippPomodoroStatisticsTotals) * by);
+        }
+        *last = at;
+    }
+    // The clock may have been set back past the window
+    return *last - at < count ? &totals[*last - at] : NULL;
+}
+
+static void flipp_pomodoro_statistics__count(
+    FlippPomodoroStatistics* statistics,
+    const FlippPomodoroStatisticsRecord* record) {
+    // Only focus makes it into the history
+    if(record->stage != FlippPomodoroStageFocus) return;
+
+    const uint32_t day = time_day(record->ended_at);
+    FlippPomodoroStatisticsTotals* slots[] = {
+        flipp_pomodoro_statistics__slot(
+            statistics->days, FLIPP_POMODORO_STATISTICS_DAYS, &statistics->last_day, day),
+        flipp_pomodoro_statistics__slot(
+            statistics->weeks,
+            FLIPP_POMODORO_STATISTICS_WEEKS,
+            &statistics->last_week,
+            time_week(day)),
+    };
+
+    for(size_t i = 0; i < COUNT_OF(slots); i++) {
+        if(!slots[i]) continue;
+        if(record->outcome == FlippPomodoroStageOutcomeCompleted) {
+            slots[i]->focus_completed++;
+        } else {
+            slots[i]->focus_aborted++;
+        }
+        slots[i]->focus_minutes += record->seconds / TIME_SECONDS_IN_MINUTE;
+    }
+
+    if(record->outcome != FlippPomodoroStageOutcomeCompleted) return;
+
+    statistics->focus_stages_completed++;
+    if(statistics->streak && day == statistics->streak_day) return;
+    if(statistics->streak && day == statistics->streak_day + 1) {
+        statistics->streak++;
+    } else {
+        statistics->streak = 1;
+    }
+    statistics->streak_day = day;
+    statistics->best_streak = MAX(statistics->best_streak, statistics->streak);
+}
+
+// Counts in the records from log_size to the end of the log
+static void
+    flipp_pomodoro_statistics__read_log(FlippPomodoroStatistics* statistics, Storage* storage) {
+    File* file = storage_file_alloc(storage);
+
+    if(storage_file_open(file, STATISTICS_LOG_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        // A log shorter than what was counted was deleted or replaced, start over
+        if(storage_file_size(file) < statistics->log_size) {
+            flipp_pomodoro_statistics__reset(statistics);
+        }
+        storage_file_seek(file, statistics->log_size, true);
+
+        FlippPomodoroStatisticsRecord record;
+        while(storage_file_read(file, &record, sizeof(record)) == sizeof(record)) {
+            flipp_pomodoro_statistics__count(statistics, &record);
+            statistics->log_size += sizeof(record);
+        }
+    } else {
+        flipp_pomodoro_statistics__reset(statistics);
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+}
+
+static void
+    flipp_pomodoro_statistics__save_index(FlippPomodoroStatistics* statistics, Storage* storage) {
+    File* file = storage_file_alloc(storage);
+    if(storage_file_open(file, STATISTICS_INDEX_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        storage_file_write(file, statistics, sizeof(FlippPomodoroStatistics));
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+}
 
 FlippPomodoroStatistics* flipp_pomodoro_statistics__new() {
     FlippPomodoroStatistics* statistics = malloc(sizeof(FlippPomodoroStatistics));
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, STORAGE_APP_DATA_PATH_PREFIX);
 
-    statistics->focus_stages_completed = 0;
+    File* file = storage_file_alloc(storage);
+    bool loaded = storage_file_open(file, STATISTICS_INDEX_PATH, FSAM_READ, FSOM_OPEN_EXISTING) &&
+                  storage_file_read(file, statistics, sizeof(FlippPomodoroStatistics)) ==
+                      sizeof(FlippPomodoroStatistics) &&
+                  statistics->magic == STATISTICS_MAGIC;
+    storage_file_close(file);
+    storage_file_free(file);
+    if(!loaded) {
+        flipp_pomodoro_statistics__reset(statistics);
+    }
 
+    const uint32_t log_size = statistics->log_size;
+    flipp_pomodoro_statistics__read_log(statistics, storage);
+    if(!loaded || statistics->log_size != log_size) {
+        flipp_pomodoro_statistics__save_index(statistics, storage);
+    }
+
+    furi_record_close(RECORD_STORAGE);
     return statistics;
 }
 
 // Return the number of completed focus stages
-uint8_t
+uint32_t
     flipp_pomodoro_statistics__get_focus_stages_completed(FlippPomodoroStatistics* statistics) {
     return statistics->focus_stages_completed;
 }
 
-// Increase the number of completed focus stages by one
-void flipp_pomodoro_statistics__increase_focus_stages_completed(
-    FlippPomodoroStatistics* statistics) {
-    statistics->focus_stages_completed++;
+void flipp_pomodoro_statistics__record_stage(
+    FlippPomodoroStatistics* statistics,
+    PomodoroStage stage,
+    FlippPomodoroStageOutcome outcome,
+    uint32_t started_at,
+    uint32_t ended_at) {
+    furi_assert(statistics);
+    const FlippPomodoroStatisticsRecord record = {
+        .ended_at = ended_at,
+        .seconds = MIN(ended_at - started_at, UINT16_MAX),
+        .stage = stage,
+        .outcome = outcome,
+    };
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    bool written = storage_file_open(file, STATISTICS_LOG_PATH, FSAM_WRITE, FSOM_OPEN_APPEND) &&
+                   storage_file_write(file, &record, sizeof(record)) == sizeof(record);
+    storage_file_close(file);
+    storage_file_free(file);
+
+    // Without the SD card the stage still counts until the app is closed
+    flipp_pomodoro_statistics__count(statistics, &record);
+    if(written) {
+        statistics->log_size += sizeof(record);
+        flipp_pomodoro_statistics__save_index(statistics, storage);
+    }
+    furi_record_close(RECORD_STORAGE);
+}
+
+static FlippPomodoroStatisticsTotals flipp_pomodoro_statistics__get(
+    const FlippPomodoroStatisticsTotals* totals,
+    size_t count,
+    uint32_t last,
+    uint32_t current,
+    uint32_t ago) {
+    const int64_t slot = (int64_t)last - current + ago;
+    if(slot < 0 || slot >= (int64_t)count) {
+        return (FlippPomodoroStatisticsTotals){0};
+    }
+    return totals[slot];
+}
+
+FlippPomodoroStatisticsTotals
+    flipp_pomodoro_statistics__get_day(FlippPomodoroStatistics* statistics, uint32_t days_ago) {
+    return flipp_pomodoro_statistics__get(
+        statistics->days,
+        FLIPP_POMODORO_STATISTICS_DAYS,
+        statistics->last_day,
+        time_day(time_now()),
+        days_ago);
+}
+
+FlippPomodoroStatisticsTotals
+    flipp_pomodoro_statistics__get_week(FlippPomodoroStatistics* statistics, uint32_t weeks_ago) {
+    return flipp_pomodoro_statistics__get(
+        statistics->weeks,
+        FLIPP_POMODORO_STATISTICS_WEEKS,
+        statistics->last_week,
+        time_week(time_day(time_now())),
+        weeks_ago);
+}
+
+uint16_t flipp_pomodoro_statistics__get_streak(FlippPomodoroStatistics* statistics) {
+    // Still alive until a whole day passes without focus
+    return time_day(time_now()) <= statistics->streak_day + 1 ? statistics->streak : 0;
+}
+
+uint16_t flipp_pomodoro_statistics__get_best_streak(FlippPomodoroStatistics* statistics) {
+    return statistics->best_streak;
+}
+
+bool flipp_pomodoro_statistics__export(FlippPomodoroStatistics* statistics) {
+    UNUSED(statistics);
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* log = storage_file_alloc(storage);
+    File* csv = storage_file_alloc(storage);
+    FuriString* line = furi_string_alloc_set("date,time,stage,outcome,minutes\n");
+
+    bool exported = false;
+    do {
+        if(!storage_file_open(csv, STATISTICS_EXPORT_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) break;
+        if(!storage_file_write(csv, furi_string_get_cstr(line), furi_string_size(line))) break;
+        exported = true;
+        // No log yet makes an empty history
+        if(!storage_file_open(log, STATISTICS_LOG_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) break;
+
+        FlippPomodoroStatisticsRecord record;
+        while(exported && storage_file_read(log, &record, sizeof(record)) == sizeof(record)) {
+            uint16_t year;
+            uint8_t month;
+            uint8_t month_day;
+            time_date(time_day(record.ended_at), &year, &month, &month_day);
+            const uint32_t second_of_day = record.ended_at % TIME_SECONDS_IN_DAY;
+
+            furi_string_printf(
+                line,
+                "%04u-%02u-%02u,%02lu:%02lu,%s,%s,%u\n",
+                year,
+                month,
+                month_day,
+                second_of_day / 3600,
+                second_of_day / TIME_SECONDS_IN_MINUTE % TIME_MINUTES_IN_HOUR,
+                record.stage < COUNT_OF(stage_names) ? stage_names[record.stage] : "unknown",
+                record.outcome == FlippPomodoroStageOutcomeCompleted ? "completed" : "aborted",
+                record.seconds / TIME_SECONDS_IN_MINUTE);
+            const size_t size = furi_string_size(line);
+            exported = storage_file_write(csv, furi_string_get_cstr(line), size) == size;
+        }
+    } while(false);
+
+    furi_string_free(line);
+    storage_file_close(log);
+    storage_file_free(log);
+    storage_file_close(csv);
+    storage_file_free(csv);
+    furi_record_close(RECORD_STORAGE);
+    return exported;
 }
 
 void flipp_pomodoro_statistics__destroy(FlippPomodoroStatistics* statistics) {
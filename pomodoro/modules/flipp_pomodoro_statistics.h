@@ -1,18 +1,50 @@
 #pragma once
 #include <furi_hal.h>
+#include "flipp_pomodoro.h"
+
+/** Days and weeks of history kept in the index */
+#define FLIPP_POMODORO_STATISTICS_DAYS 28
+#define FLIPP_POMODORO_STATISTICS_WEEKS 12
+
+/** @brief How a stage ended */
+typedef enum {
+    FlippPomodoroStageOutcomeCompleted,
+    FlippPomodoroStageOutcomeAborted,
+} FlippPomodoroStageOutcome;
+
+/** @brief Focus totals of a day or a week */
+typedef struct {
+    uint16_t focus_completed;
+    uint16_t focus_aborted;
+    uint16_t focus_minutes;
+} FlippPomodoroStatisticsTotals;
 
 /** @brief FlippPomodoroStatistics structure
  *
- *  This structure is used to keep track of completed focus stages.
+ *  Every stage that ends is appended to a log on the SD card. This structure aggregates the
+ *  log into per-day and per-week totals and is saved next to it as an index, so opening the
+ *  app only reads the records added since.
  */
 typedef struct {
-    uint8_t focus_stages_completed;
+    uint32_t magic;
+    // bytes of the log already counted in
+    uint32_t log_size;
+    uint32_t focus_stages_completed;
+    // days[0] is last_day, days[1] the day before and so on, the same for weeks
+    uint32_t last_day;
+    uint32_t last_week;
+    FlippPomodoroStatisticsTotals days[FLIPP_POMODORO_STATISTICS_DAYS];
+    FlippPomodoroStatisticsTotals weeks[FLIPP_POMODORO_STATISTICS_WEEKS];
+    // days in a row with a completed focus stage, the last one being streak_day
+    uint16_t streak;
+    uint16_t best_streak;
+    uint32_t streak_day;
 } FlippPomodoroStatistics;
 
-/** @brief Allocate and initialize a new FlippPomodoroStatistics
+/** @brief Allocate a new FlippPomodoroStatistics and load it from the SD card
  *
- *  This function allocates a new FlippPomodoroStatistics structure, initializes its members
- *  and returns a pointer to it.
+ *  This function loads the index and counts in the log records it doesn't cover yet. A
+ *  missing or outdated index is rebuilt from the whole log.
  *
  *  @return A pointer to a new FlippPomodoroStatistics structure
  */
@@ -20,21 +52,71 @@ FlippPomodoroStatistics* flipp_pomodoro_statistics__new();
 
 /** @brief Get the number of completed focus stages
  *
- *  This function retrieves the number of completed focus stages in a FlippPomodoroStatistics structure.
+ *  This function retrieves the number of focus stages completed since the log was started.
  *
  *  @param statistics A pointer to a FlippPomodoroStatistics structure
  *  @return The number of completed focus stages
  */
-uint8_t flipp_pomodoro_statistics__get_focus_stages_completed(FlippPomodoroStatistics* statistics);
+uint32_t
+    flipp_pomodoro_statistics__get_focus_stages_completed(FlippPomodoroStatistics* statistics);
+
+/** @brief Log a stage that ended
+ *
+ *  This function appends the stage to the log, counts it in and saves the index.
+ *
+ *  @param statistics A pointer to a FlippPomodoroStatistics structure
+ *  @param stage The stage that ended
+ *  @param outcome Whether it ran out or was skipped
+ *  @param started_at Timestamp the stage started at
+ *  @param ended_at Timestamp the stage ended at
+ */
+void flipp_pomodoro_statistics__record_stage(
+    FlippPomodoroStatistics* statistics,
+    PomodoroStage stage,
+    FlippPomodoroStageOutcome outcome,
+    uint32_t started_at,
+    uint32_t ended_at);
+
+/** @brief Get the focus totals of a day
+ *
+ *  @param statistics A pointer to a FlippPomodoroStatistics structure
+ *  @param days_ago 0 for today, 1 for yesterday and so on
+ *  @return The totals, all zero for days out of the history
+ */
+FlippPomodoroStatisticsTotals
+    flipp_pomodoro_statistics__get_day(FlippPomodoroStatistics* statistics, uint32_t days_ago);
+
+/** @brief Get the focus totals of a week
+ *
+ *  @param statistics A pointer to a FlippPomodoroStatistics structure
+ *  @param weeks_ago 0 for this week, 1 for the last one and so on
+ *  @return The totals, all zero for weeks out of the history
+ */
+FlippPomodoroStatisticsTotals
+    flipp_pomodoro_statistics__get_week(FlippPomodoroStatistics* statistics, uint32_t weeks_ago);
+
+/** @brief Get the current streak
+ *
+ *  @param statistics A pointer to a FlippPomodoroStatistics structure
+ *  @return Days in a row up to today or yesterday with a completed focus stage
+ */
+uint16_t flipp_pomodoro_statistics__get_streak(FlippPomodoroStatistics* statistics);
+
+/** @brief Get the longest streak so far
+ *
+ *  @param statistics A pointer to a FlippPomodoroStatistics structure
+ *  @return The longest run of days with a completed focus stage
+ */
+uint16_t flipp_pomodoro_statistics__get_best_streak(FlippPomodoroStatistics* statistics);
 
-/** @brief Increase the number of completed focus stages
+/** @brief Export the whole log as CSV
  *
- *  This function increases the count of the completed focus stages by one in a FlippPomodoroStatistics structure.
+ *  This function writes every logged stage as a line of history.csv next to the log.
  *
  *  @param statistics A pointer to a FlippPomodoroStatistics structure
+ *  @return true if the file was written
  */
-void flipp_pomodoro_statistics__increase_focus_stages_completed(
-    FlippPomodoroStatistics* statistics);
+bool flipp_pomodoro_statistics__export(FlippPomodoroStatistics* statistics);
 
 /** @brief Free a FlippPomodoroStatistics structure
  *
@@ -42,4 +124,4 @@ void flipp_pomodoro_statistics__increase_focus_stages_completed(
  *
  *  @param statistics A pointer to a FlippPomodoroStatistics structure
  */
-void flipp_pomodoro_statistics__destroy(FlippPomodoroStatistics* state);
\ No newline at end of file
+void flipp_pomodoro_statistics__destroy(FlippPomodoroStatistics* state);
@@ -15,18 +15,26 @@ void flipp_pomodoro_scene_info_on_back_to_timer(void* ctx) {
         app->view_dispatcher, FlippPomodoroAppCustomEventResumeTimer);
 };
 
+void flipp_pomodoro_scene_info_on_export(void* ctx) {
+    furi_assert(ctx);
+    FlippPomodoroApp* app = ctx;
+
+    view_dispatcher_send_custom_event(
+        app->view_dispatcher, FlippPomodoroAppCustomEventExportStatistics);
+};
+
 void flipp_pomodoro_scene_info_on_enter(void* ctx) {
     furi_assert(ctx);
     FlippPomodoroApp* app = ctx;
 
     view_dispatcher_switch_to_view(app->view_dispatcher, FlippPomodoroAppViewInfo);
-    flipp_pomodoro_info_view_set_pomodoros_completed(
-        flipp_pomodoro_info_view_get_view(app->info_view),
-        flipp_pomodoro_statistics__get_focus_stages_completed(app->statistics));
+    flipp_pomodoro_info_view_set_statistics(
+        flipp_pomodoro_info_view_get_view(app->info_view), app->statistics);
     flipp_pomodoro_info_view_set_mode(
         flipp_pomodoro_info_view_get_view(app->info_view), FlippPomodoroInfoViewModeStats);
     flipp_pomodoro_info_view_set_resume_timer_cb(
         app->info_view, flipp_pomodoro_scene_info_on_back_to_timer, app);
+    flipp_pomodoro_info_view_set_export_cb(app->info_view, flipp_pomodoro_scene_info_on_export);
 };
 
 void flipp_pomodoro_scene_info_handle_custom_event(
@@ -34,6 +42,11 @@ void flipp_pomodoro_scene_info_handle_custom_event(
     FlippPomodoroAppCustomEvent custom_event) {
     if(custom_event == FlippPomodoroAppCustomEventResumeTimer) {
         scene_manager_next_scene(app->scene_manager, FlippPomodoroSceneTimer);
+    } else if(custom_event == FlippPomodoroAppCustomEventExportStatistics) {
+        flipp_pomodoro_info_view_set_status(
+            flipp_pomodoro_info_view_get_view(app->info_view),
+            flipp_pomodoro_statistics__export(app->statistics) ? "Saved to history.csv" :
+                                                                 "Export failed");
     }
 };
 
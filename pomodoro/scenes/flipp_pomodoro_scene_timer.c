@@ -79,10 +79,7 @@ void flipp_pomodoro_scene_timer_on_enter(void* ctx) {
 
     FlippPomodoroApp* app = ctx;
 
-    if(flipp_pomodoro__is_stage_expired(app->state)) {
-        flipp_pomodoro__destroy(app->state);
-        app->state = flipp_pomodoro__new();
-    }
+    flipp_pomodoro_app_catch_up(app);
 
     view_dispatcher_switch_to_view(app->view_dispatcher, FlippPomodoroAppViewTimer);
     flipp_pomodoro_scene_timer_sync_view_state(app);
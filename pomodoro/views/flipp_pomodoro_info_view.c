@@ -4,9 +4,14 @@
 #include <gui/elements.h>
 #include <gui/view.h>
 #include "flipp_pomodoro_info_view.h"
+#include "../helpers/time.h"
 // Auto-compiled icons
 #include "flipp_pomodoro_icons.h"
 
+#define HISTORY_DAYS 14
+#define HISTORY_TOP 12
+#define HISTORY_BOTTOM 50
+
 enum {
     ViewInputConsumed = true,
     ViewInputNotConusmed = false,
@@ -15,22 +20,42 @@ enum {
 struct FlippPomodoroInfoView {
     View* view;
     FlippPomodoroInfoViewUserActionCb resume_timer_cb;
+    FlippPomodoroInfoViewUserActionCb export_cb;
     void* user_action_cb_ctx;
 };
 
 typedef struct {
-    uint8_t pomodoros_completed;
+    uint32_t pomodoros_completed;
+    uint16_t streak;
+    uint16_t best_streak;
+    // newest first, days[0] is today
+    uint16_t days[HISTORY_DAYS];
+    uint16_t weeks[FLIPP_POMODORO_STATISTICS_WEEKS];
+    uint8_t today_weekday;
+    bool weekly;
+    const char* status;
     FlippPomodoroInfoViewMode mode;
 } FlippPomodoroInfoViewModel;
 
+static const char* const mode_button_label[] = {
+    [FlippPomodoroInfoViewModeStats] = "Stats",
+    [FlippPomodoroInfoViewModeHistory] = "History",
+    [FlippPomodoroInfoViewModeAbout] = "Guide",
+};
+
 static void
     flipp_pomodoro_info_view_draw_statistics(Canvas* canvas, FlippPomodoroInfoViewModel* model) {
     FuriString* stats_string = furi_string_alloc();
 
     furi_string_printf(
         stats_string,
-        "So Long,\nand Thanks for All the Focus...\nand for completing\n\e#%i\e# pomodoro(s)",
-        model->pomodoros_completed);
+        "%s\n\e#%lu\e# pomodoro(s) completed\nToday %u, this week %u\nStreak %u day(s), best %u",
+        model->status ? model->status : "Thanks for All the Focus...",
+        model->pomodoros_completed,
+        model->days[0],
+        model->weeks[0],
+        model->streak,
+        model->best_streak);
     const char* stats_string_formatted = furi_string_get_cstr(stats_string);
 
     elements_text_box(
@@ -46,14 +71,47 @@ static void
 
     furi_string_free(stats_string);
 
-    elements_button_left(canvas, "Guide");
+    elements_button_center(canvas, "Export");
+}
+
+static void
+    flipp_pomodoro_info_view_draw_history(Canvas* canvas, FlippPomodoroInfoViewModel* model) {
+    const uint16_t* values = model->weekly ? model->weeks : model->days;
+    const size_t count = model->weekly ? FLIPP_POMODORO_STATISTICS_WEEKS : HISTORY_DAYS;
+    const uint8_t bar_width = canvas_width(canvas) / count;
+    const uint8_t height = HISTORY_BOTTOM - HISTORY_TOP;
+
+    uint16_t peak = 1;
+    for(size_t i = 0; i < count; i++) {
+        peak = MAX(peak, values[i]);
+    }
+
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str_aligned(
+        canvas, 0, 0, AlignLeft, AlignTop, model->weekly ? "Per week" : "Per day");
+    FuriString* peak_string = furi_string_alloc_printf("max %u", peak);
+    canvas_draw_str_aligned(
+        canvas, canvas_width(canvas), 0, AlignRight, AlignTop, furi_string_get_cstr(peak_string));
+    furi_string_free(peak_string);
+
+    // Oldest on the left, today or this week on the right
+    for(size_t i = 0; i < count; i++) {
+        const size_t ago = count - 1 - i;
+        const uint8_t x = i * bar_width;
+        const uint8_t bar_height = values[ago] * height / peak;
+        canvas_draw_box(canvas, x + 1, HISTORY_BOTTOM - bar_height, bar_width - 2, bar_height);
+        // Weeks start with a tick under Monday
+        if(!model->weekly && (model->today_weekday + 7 - ago % 7) % 7 == 0) {
+            canvas_draw_line(canvas, x, HISTORY_BOTTOM + 1, x, HISTORY_BOTTOM + 2);
+        }
+    }
+    canvas_draw_line(canvas, 0, HISTORY_BOTTOM, canvas_width(canvas) - 1, HISTORY_BOTTOM);
 }
 
 static void
     flipp_pomodoro_info_view_draw_about(Canvas* canvas, FlippPomodoroInfoViewModel* model) {
     UNUSED(model);
     canvas_draw_icon(canvas, 0, 0, &I_flipp_pomodoro_learn_50x128);
-    elements_button_left(canvas, "Stats");
 }
 
 static void flipp_pomodoro_info_view_draw_callback(Canvas* canvas, void* _model) {
@@ -67,10 +125,14 @@ static void flipp_pomodoro_info_view_draw_callback(Canvas* canvas, void* _model)
 
     if(model->mode == FlippPomodoroInfoViewModeStats) {
         flipp_pomodoro_info_view_draw_statistics(canvas, model);
+    } else if(model->mode == FlippPomodoroInfoViewModeHistory) {
+        flipp_pomodoro_info_view_draw_history(canvas, model);
     } else {
         flipp_pomodoro_info_view_draw_about(canvas, model);
     }
 
+    elements_button_left(
+        canvas, mode_button_label[(model->mode + 1) % FlippPomodoroInfoViewModeCount]);
     elements_button_right(canvas, "Resume");
 }
 
@@ -84,14 +146,38 @@ void flipp_pomodoro_info_view_toggle_mode(FlippPomodoroInfoView* info_view) {
         flipp_pomodoro_info_view_get_view(info_view),
         FlippPomodoroInfoViewModel * model,
         {
-            flipp_pomodoro_info_view_set_mode(
-                flipp_pomodoro_info_view_get_view(info_view),
-                (model->mode == FlippPomodoroInfoViewModeStats) ? FlippPomodoroInfoViewModeAbout :
-                                                                  FlippPomodoroInfoViewModeStats);
+            model->mode = (model->mode + 1) % FlippPomodoroInfoViewModeCount;
+            model->status = NULL;
         },
         true);
 }
 
+// Up and down switch the history between days and weeks, true if it was shown
+static bool flipp_pomodoro_info_view_toggle_history_scale(FlippPomodoroInfoView* info_view) {
+    bool toggled = false;
+    with_view_model(
+        flipp_pomodoro_info_view_get_view(info_view),
+        FlippPomodoroInfoViewModel * model,
+        {
+            toggled = model->mode == FlippPomodoroInfoViewModeHistory;
+            if(toggled) model->weekly = !model->weekly;
+        },
+        true);
+    return toggled;
+}
+
+static bool flipp_pomodoro_info_view_is_mode(
+    FlippPomodoroInfoView* info_view,
+    FlippPomodoroInfoViewMode mode) {
+    bool is_mode = false;
+    with_view_model(
+        flipp_pomodoro_info_view_get_view(info_view),
+        FlippPomodoroInfoViewModel * model,
+        { is_mode = model->mode == mode; },
+        false);
+    return is_mode;
+}
+
 bool flipp_pomodoro_info_view_input_callback(InputEvent* event, void* ctx) {
     FlippPomodoroInfoView* info_view = ctx;
 
@@ -102,6 +188,13 @@ bool flipp_pomodoro_info_view_input_callback(InputEvent* event, void* ctx) {
         } else if(event->key == InputKeyLeft) {
             flipp_pomodoro_info_view_toggle_mode(info_view);
             return ViewInputConsumed;
+        } else if(event->key == InputKeyUp || event->key == InputKeyDown) {
+            return flipp_pomodoro_info_view_toggle_history_scale(info_view);
+        } else if(
+            event->key == InputKeyOk && info_view->export_cb != NULL &&
+            flipp_pomodoro_info_view_is_mode(info_view, FlippPomodoroInfoViewModeStats)) {
+            info_view->export_cb(info_view->user_action_cb_ctx);
+            return ViewInputConsumed;
         }
     }
 
@@ -111,6 +204,8 @@ bool flipp_pomodoro_info_view_input_callback(InputEvent* event, void* ctx) {
 FlippPomodoroInfoView* flipp_pomodoro_info_view_alloc() {
     FlippPomodoroInfoView* info_view = malloc(sizeof(FlippPomodoroInfoView));
     info_view->view = view_alloc();
+    info_view->resume_timer_cb = NULL;
+    info_view->export_cb = NULL;
 
     view_allocate_model(
         flipp_pomodoro_info_view_get_view(info_view),
@@ -135,12 +230,30 @@ void flipp_pomodoro_info_view_free(FlippPomodoroInfoView* info_view) {
     free(info_view);
 }
 
-void flipp_pomodoro_info_view_set_pomodoros_completed(View* view, uint8_t pomodoros_completed) {
+void flipp_pomodoro_info_view_set_statistics(View* view, FlippPomodoroStatistics* statistics) {
     with_view_model(
         view,
         FlippPomodoroInfoViewModel * model,
-        { model->pomodoros_completed = pomodoros_completed; },
-        false);
+        {
+            model->pomodoros_completed =
+                flipp_pomodoro_statistics__get_focus_stages_completed(statistics);
+            model->streak = flipp_pomodoro_statistics__get_streak(statistics);
+            model->best_streak = flipp_pomodoro_statistics__get_best_streak(statistics);
+            for(size_t i = 0; i < HISTORY_DAYS; i++) {
+                model->days[i] = flipp_pomodoro_statistics__get_day(statistics, i).focus_completed;
+            }
+            for(size_t i = 0; i < FLIPP_POMODORO_STATISTICS_WEEKS; i++) {
+                model->weeks[i] =
+                    flipp_pomodoro_statistics__get_week(statistics, i).focus_completed;
+            }
+            model->today_weekday = time_weekday(time_day(time_now()));
+            model->status = NULL;
+        },
+        true);
+}
+
+void flipp_pomodoro_info_view_set_status(View* view, const char* status) {
+    with_view_model(view, FlippPomodoroInfoViewModel * model, { model->status = status; }, true);
 }
 
 void flipp_pomodoro_info_view_set_resume_timer_cb(
@@ -150,3 +263,9 @@ void flipp_pomodoro_info_view_set_resume_timer_cb(
     info_view->resume_timer_cb = user_action_cb;
     info_view->user_action_cb_ctx = user_action_cb_ctx;
 }
+
+void flipp_pomodoro_info_view_set_export_cb(
+    FlippPomodoroInfoView* info_view,
+    FlippPomodoroInfoViewUserActionCb user_action_cb) {
+    info_view->export_cb = user_action_cb;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <gui/view.h>
+#include "../modules/flipp_pomodoro_statistics.h"
 
 /** @brief Mode types for FlippPomodoroInfoView
  *
@@ -8,7 +9,9 @@
  */
 typedef enum {
     FlippPomodoroInfoViewModeStats,
+    FlippPomodoroInfoViewModeHistory,
     FlippPomodoroInfoViewModeAbout,
+    FlippPomodoroInfoViewModeCount,
 } FlippPomodoroInfoViewMode;
 
 /** @brief Forward declaration of the FlippPomodoroInfoView struct */
@@ -42,13 +45,20 @@ View* flipp_pomodoro_info_view_get_view(FlippPomodoroInfoView* info_view);
  */
 void flipp_pomodoro_info_view_free(FlippPomodoroInfoView* info_view);
 
-/** @brief Set the number of completed pomodoros in the view
+/** @brief Set the statistics shown in the view
  *
- *  Sets the number of completed pomodoros that should be displayed in the view.
+ *  Copies the totals, streaks and history that should be displayed in the view.
  *  @param info_view A pointer to the view
- *  @param pomodoros_completed The number of completed pomodoros
+ *  @param statistics The statistics to show
  */
-void flipp_pomodoro_info_view_set_pomodoros_completed(View* info_view, uint8_t pomodoros_completed);
+void flipp_pomodoro_info_view_set_statistics(View* info_view, FlippPomodoroStatistics* statistics);
+
+/** @brief Set the line telling how the last export went
+ *
+ *  @param info_view A pointer to the view
+ *  @param status The message, NULL to show the usual text
+ */
+void flipp_pomodoro_info_view_set_status(View* info_view, const char* status);
 
 /** @brief Set the callback function to be called when the timer should be resumed
  *
@@ -62,6 +72,15 @@ void flipp_pomodoro_info_view_set_resume_timer_cb(
     FlippPomodoroInfoViewUserActionCb user_action_cb,
     void* user_action_cb_ctx);
 
+/** @brief Set the callback function to be called when the statistics should be exported
+ *
+ *  @param info_view A pointer to the FlippPomodoroInfoView
+ *  @param user_action_cb The callback function, called with the resume timer context
+ */
+void flipp_pomodoro_info_view_set_export_cb(
+    FlippPomodoroInfoView* info_view,
+    FlippPomodoroInfoViewUserActionCb user_action_cb);
+
 /** @brief Set the mode of the view
  *
  *  Sets the mode that should be used in the view.
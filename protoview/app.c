@@ -2,6 +2,7 @@
  * See the LICENSE file for information about the license. */
 
 #include "app.h"
+#include "profile.h"
 
 RawSamplesBuffer *RawSamples, *DetectedSamples;
 extern const SubGhzProtocolRegistry protoview_protocol_registry;
@@ -151,11 +152,14 @@ ProtoViewApp* protoview_app_alloc() {
 
     // Signal found and visualization defaults
     app->signal_bestlen = 0;
-    app->signal_last_scan_idx = 0;
+    scan_state_reset(&app->scan, 0);
     app->signal_decoded = false;
     app->us_scale = PROTOVIEW_RAW_VIEW_DEFAULT_SCALE;
     app->signal_offset = 0;
     app->msg_info = NULL;
+    app->capture = NULL;
+    app->capture_reader = NULL;
+    app->capture_page = 0;
 
     // Init Worker & Protocol
     app->txrx = malloc(sizeof(ProtoViewTxRx));
@@ -163,6 +167,8 @@ ProtoViewApp* protoview_app_alloc() {
     /* Setup rx state. */
     app->txrx->freq_mod_changed = false;
     app->txrx->debug_timer_sampling = false;
+    app->txrx->loaded_modulation = -1;
+    app->txrx->tuned_frequency = 0;
     app->txrx->last_g0_change_time = DWT->CYCCNT;
     app->txrx->last_g0_value = false;
 
@@ -209,6 +215,10 @@ void protoview_app_free(ProtoViewApp* app) {
     // Worker stuff.
     free(app->txrx);
 
+    // Long captures.
+    capture_stop(app);
+    if(app->capture_reader) capture_reader_close(app->capture_reader);
+
     // Raw samples buffers.
     raw_samples_free(RawSamples);
     raw_samples_free(DetectedSamples);
@@ -219,24 +229,15 @@ void protoview_app_free(ProtoViewApp* app) {
 
 /* Called periodically. Do signal processing here. Data we process here
  * will be later displayed by the render callback. The side effect of this
- * function is to scan for signals and set DetectedSamples. */
+ * function is to scan for signals and set DetectedSamples.
+ *
+ * The scan is incremental: only the samples received since the last call
+ * are examined, so we can call it at every tick without the cost growing
+ * with the size of the buffer. */
 static void timer_callback(void* ctx) {
     ProtoViewApp* app = ctx;
-    uint32_t delta, lastidx = app->signal_last_scan_idx;
-
-    /* scan_for_signal(), called by this function, deals with a
-     * circular buffer. To never miss anything, even if a signal spawns
-     * cross-boundaries, it is enough if we scan each time the buffer fills
-     * for 50% more compared to the last scan. Thanks to this check we
-     * can avoid scanning too many times to just find the same data. */
-    if(lastidx < RawSamples->idx) {
-        delta = RawSamples->idx - lastidx;
-    } else {
-        delta = RawSamples->total - lastidx + RawSamples->idx;
-    }
-    if(delta < RawSamples->total / 2) return;
-    app->signal_last_scan_idx = RawSamples->idx;
-    scan_for_signal(app, RawSamples, ProtoViewModulations[app->modulation].duration_filter);
+    scan_for_new_samples(
+        app, RawSamples, ProtoViewModulations[app->modulation].duration_filter);
 }
 
 /* This is the navigation callback we use in the view dispatcher used
@@ -258,6 +259,7 @@ static bool keyboard_view_dispatcher_navigation_callback(void* ctx) {
 int32_t protoview_app_entry(void* p) {
     UNUSED(p);
     ProtoViewApp* app = protoview_app_alloc();
+    profile_start(); /* "profile" CLI command in debug builds. */
 
     /* Create a timer. We do data analysis in the callback. */
     FuriTimer* timer = furi_timer_alloc(timer_callback, FuriTimerTypePeriodic, app);
@@ -395,6 +397,7 @@ int32_t protoview_app_entry(void* p) {
     }
 
     furi_timer_free(timer);
+    profile_stop();
     protoview_app_free(app);
     return 0;
 }
@@ -25,7 +25,9 @@
 #define TAG "ProtoView"
 #define PROTOVIEW_RAW_VIEW_DEFAULT_SCALE 100 // 100us is 1 pixel by default
 #define BITMAP_SEEK_NOT_FOUND UINT32_MAX // Returned by function as sentinel
+#define BITMAP_PATTERN_MAX_BITS 128 // Max len of compiled bitmap patterns
 #define PROTOVIEW_VIEW_PRIVDATA_LEN 64 // View specific private data len
+#define PROTOVIEW_CAPTURE_PATH EXT_PATH("subghz/protoview_capture.pvc")
 
 #define DEBUG_MSG 0
 
@@ -35,6 +37,16 @@ typedef struct ProtoViewApp ProtoViewApp;
 typedef struct ProtoViewMsgInfo ProtoViewMsgInfo;
 typedef struct ProtoViewFieldSet ProtoViewFieldSet;
 typedef struct ProtoViewDecoder ProtoViewDecoder;
+typedef struct ProtoViewCapture ProtoViewCapture;
+typedef struct ProtoViewCaptureReader ProtoViewCaptureReader;
+typedef struct ProtoViewTxSequencer ProtoViewTxSequencer;
+
+/* A bits pattern compiled by bitmap_pattern_compile(), in order to
+ * match/seek it a word at a time. */
+typedef struct {
+    uint32_t words[BITMAP_PATTERN_MAX_BITS / 32];
+    uint32_t len; /* Pattern len in bits. */
+} BitmapPattern;
 
 /* ============================== enumerations ============================== */
 
@@ -86,6 +98,10 @@ struct ProtoViewTxRx {
                                    radio with the right parameters. */
     TxRxState txrx_state; /* Receiving, idle or sleeping? */
 
+    /* What the CC1101 was last set up with, see radio_configure(). */
+    int loaded_modulation; /* -1 when the registers must be loaded again. */
+    uint32_t tuned_frequency; /* 0 when the PLL was not tuned yet. */
+
     /* Timer sampling mode state. */
     bool debug_timer_sampling; /* Read data from GDO0 in a busy loop. Only
                                    for testing. */
@@ -97,6 +113,35 @@ struct ProtoViewTxRx {
 
 typedef struct ProtoViewTxRx ProtoViewTxRx;
 
+/* ============================ Signal scanning ============================= */
+
+/* Coherent signals are made of pulses that can be classified in at most
+ * SEARCH_CLASSES duration classes, separately for each level. See
+ * search_coherent_signal() in signal.c. */
+#define SEARCH_CLASSES 3
+typedef struct {
+    uint32_t dur[2]; /* dur[0] = low, dur[1] = high */
+    uint32_t count[2]; /* Associated observed frequency. */
+} ProtoViewPulseClass;
+
+/* State of the incremental scanner. Instead of rescanning the whole
+ * buffer at every tick, scan_for_new_samples() only feeds the samples
+ * arrived since the last call to the current run of coherent pulses,
+ * remembering the classes and the run start across calls. All the
+ * indexes are absolute (not masked) RawSamplesBuffer write indexes. */
+typedef struct {
+    ProtoViewPulseClass classes[SEARCH_CLASSES]; /* Current run classes. */
+    uint32_t pos; /* Next sample to examine. */
+    uint32_t run_start; /* First sample of the current run. */
+    uint32_t run_len; /* Samples accepted in the current run. */
+    /* A run that ended is not decoded immediately: decoders want to see
+     * a few samples after the end of the signal, so we wait for them. */
+    uint32_t pending_start; /* First sample of the ended run. */
+    uint32_t pending_len; /* Its length, or zero if nothing is pending. */
+    uint32_t pending_short_dur; /* Short pulse duration of the ended run. */
+    uint32_t pending_wait; /* Trailing samples we are still waiting for. */
+} ProtoViewScanState;
+
 /* ============================== Main app state ============================ */
 
 #define ALERT_MAX_LEN 32
@@ -139,8 +184,7 @@ struct ProtoViewApp {
     /* Generic app state. */
     int running; /* Once false exists the app. */
     uint32_t signal_bestlen; /* Longest coherent signal observed so far. */
-    uint32_t signal_last_scan_idx; /* Index of the buffer last time we
-                                      performed the scan. */
+    ProtoViewScanState scan; /* Incremental scanner of RawSamples. */
     bool signal_decoded; /* Was the current signal decoded? */
     ProtoViewMsgInfo* msg_info; /* Decoded message info if not NULL. */
     bool direct_sampling_enabled; /* This special view needs an explicit
@@ -157,6 +201,11 @@ struct ProtoViewApp {
     uint32_t us_scale; /* microseconds per pixel. */
     uint32_t signal_offset; /* Long press left/right panning in raw view. */
 
+    /* Long captures state, see capture.c. */
+    ProtoViewCapture* capture; /* Samples are streamed here if not NULL. */
+    ProtoViewCaptureReader* capture_reader; /* Capture we are paging. */
+    uint32_t capture_page; /* First sample of the capture page shown. */
+
     /* Configuration view app state. */
     uint32_t frequency; /* Current frequency. */
     uint8_t modulation; /* Current modulation ID, array index in the
@@ -239,8 +288,57 @@ typedef struct ProtoViewDecoder {
     /* This method takes the fields supported by the decoder, and
      * renders a message in 'samples'. */
     void (*build_message)(RawSamplesBuffer* samples, ProtoViewFieldSet* fields);
+    /* The following are cheap features of the signals the decoder is
+     * able to decode. They are checked by decode_signal() before calling
+     * decode(), so that we can skip decoders that have no chance to
+     * match the signal. Each field left to zero/NULL means no constraint,
+     * so it is always safe to leave them unset. Note that they must be
+     * at least as permissive as the checks performed inside decode()
+     * itself, otherwise valid messages would be discarded. */
+    uint32_t min_bits; /* Minimum bits in the bitmap. */
+    uint32_t short_pulse_min; /* Short pulse duration range, in */
+    uint32_t short_pulse_max; /* microseconds. */
+    const char* const* preambles; /* NULL terminated list of patterns, in
+                                     the bitmap_seek_bits() format, the
+                                     decoder seeks. One of them must be
+                                     present. */
 } ProtoViewDecoder;
 
+/* ============================== TX sequencer ============================== */
+
+/* How a field of the template changes from a message to the next one when
+ * sending a sequence with tx_sequencer.c. Integer values of bytes fields
+ * are big endian. */
+typedef enum {
+    SeqGenIncrement, /* Add 'step', wrapping around at the field width. */
+    SeqGenRange, /* Add 'step', start again from 'min' once past 'max'
+                    (or from 'max' once under 'min' if 'step' is negative). */
+    SeqGenList, /* Take the values of 'list' in turn. */
+    SeqGenChecksum, /* Recompute it over other fields. */
+} ProtoViewSeqGenType;
+
+typedef enum {
+    SeqChecksumCrc8, /* crc8() with 'init' and 'poly'. */
+    SeqChecksumSum, /* sum_bytes() starting from 'init'. */
+    SeqChecksumXor, /* xor_bytes() starting from 'init'. */
+} ProtoViewSeqChecksumType;
+
+#define SEQ_LIST_MAX 8
+typedef struct {
+    ProtoViewSeqGenType type;
+    uint32_t field; /* Index of the field in the template. */
+    int32_t step; /* Increment and range step. */
+    int64_t min, max; /* Range bounds, included. */
+    uint64_t list[SEQ_LIST_MAX]; /* List values. */
+    uint32_t list_len;
+    /* Checksum of the fields from 'first' to 'last' included: integers
+     * big endian in as many bytes as their bits need, bytes and strings
+     * as they are. */
+    ProtoViewSeqChecksumType checksum;
+    uint32_t first, last;
+    uint8_t init, poly;
+} ProtoViewSeqGen;
+
 extern RawSamplesBuffer *RawSamples, *DetectedSamples;
 
 /* app_subghz.c */
@@ -258,8 +356,12 @@ void protoview_rx_callback(bool level, uint32_t duration, void* context);
 uint32_t duration_delta(uint32_t a, uint32_t b);
 void reset_current_signal(ProtoViewApp* app);
 void scan_for_signal(ProtoViewApp* app, RawSamplesBuffer* source, uint32_t min_duration);
+void scan_state_reset(ProtoViewScanState* st, uint32_t pos);
+void scan_for_new_samples(ProtoViewApp* app, RawSamplesBuffer* source, uint32_t min_duration);
 bool bitmap_get(uint8_t* b, uint32_t blen, uint32_t bitpos);
 void bitmap_set(uint8_t* b, uint32_t blen, uint32_t bitpos, bool val);
+uint32_t bitmap_get_bits(uint8_t* b, uint32_t blen, uint32_t bitpos, uint32_t count);
+void bitmap_set_bits(uint8_t* b, uint32_t blen, uint32_t bitpos, uint32_t val, uint32_t count);
 void bitmap_copy(
     uint8_t* d,
     uint32_t dlen,
@@ -277,6 +379,14 @@ uint32_t bitmap_seek_bits(
     uint32_t startpos,
     uint32_t maxbits,
     const char* bits);
+bool bitmap_pattern_compile(BitmapPattern* p, const char* bits);
+bool bitmap_match_pattern(uint8_t* b, uint32_t blen, uint32_t bitpos, const BitmapPattern* p);
+uint32_t bitmap_seek_pattern(
+    uint8_t* b,
+    uint32_t blen,
+    uint32_t startpos,
+    uint32_t maxbits,
+    const BitmapPattern* p);
 bool bitmap_match_bitmap(
     uint8_t* b1,
     uint32_t b1len,
@@ -304,6 +414,27 @@ uint32_t convert_from_diff_manchester(
 void init_msg_info(ProtoViewMsgInfo* i, ProtoViewApp* app);
 void free_msg_info(ProtoViewMsgInfo* i);
 
+/* capture.c */
+void capture_add(ProtoViewCapture* c, bool level, uint32_t dur);
+bool capture_start(ProtoViewApp* app, const char* path);
+void capture_stop(ProtoViewApp* app);
+uint32_t capture_get_count(ProtoViewCapture* c);
+ProtoViewCaptureReader* capture_reader_open(const char* path);
+void capture_reader_close(ProtoViewCaptureReader* r);
+uint32_t capture_reader_count(ProtoViewCaptureReader* r);
+bool capture_reader_load(ProtoViewCaptureReader* r, RawSamplesBuffer* dst, uint32_t first);
+
+/* tx_sequencer.c */
+ProtoViewTxSequencer* tx_sequencer_new(
+    ProtoViewDecoder* decoder,
+    ProtoViewFieldSet* fields,
+    uint32_t count,
+    uint32_t gap_us);
+void tx_sequencer_free(ProtoViewTxSequencer* seq);
+bool tx_sequencer_add_gen(ProtoViewTxSequencer* seq, const ProtoViewSeqGen* gen);
+bool tx_sequencer_run(ProtoViewApp* app, ProtoViewTxSequencer* seq);
+uint32_t tx_sequencer_sent(ProtoViewTxSequencer* seq);
+
 /* signal_file.c */
 bool save_signal(ProtoViewApp* app, const char* filename);
 
@@ -324,6 +455,7 @@ void view_enter_direct_sampling(ProtoViewApp* app);
 void view_exit_direct_sampling(ProtoViewApp* app);
 void view_exit_settings(ProtoViewApp* app);
 void view_exit_info(ProtoViewApp* app);
+void notify_signal_sent(ProtoViewApp* app);
 void adjust_raw_view_scale(ProtoViewApp* app, uint32_t short_pulse_dur);
 
 /* ui.c */
@@ -33,13 +33,8 @@ ProtoViewModulation ProtoViewModulations[] = {
     {NULL, NULL, 0, NULL, 0} /* End of list sentinel. */
 };
 
-/* Called after the application initialization in order to setup the
- * subghz system and put it into idle state. */
-void radio_begin(ProtoViewApp* app) {
-    furi_assert(app);
-    subghz_devices_reset(app->radio_device);
-    subghz_devices_idle(app->radio_device);
-
+/* Load the CC1101 registers of the current modulation. */
+static void radio_load_preset(ProtoViewApp* app) {
     /* The CC1101 preset can be either one of the standard presets, if
      * the modulation "custom" field is NULL, or a custom preset we
      * defined in custom_presets.h. */
@@ -52,19 +47,48 @@ void radio_begin(ProtoViewApp* app) {
             FuriHalSubGhzPresetCustom,
             ProtoViewModulations[app->modulation].custom);
     }
+    app->txrx->loaded_modulation = app->modulation;
+}
+
+/* Called after the application initialization in order to setup the
+ * subghz system and put it into idle state. */
+void radio_begin(ProtoViewApp* app) {
+    furi_assert(app);
+    subghz_devices_reset(app->radio_device);
+    subghz_devices_idle(app->radio_device);
+    radio_load_preset(app);
     furi_hal_gpio_init(
         subghz_devices_get_data_gpio(app->radio_device), GpioModeInput, GpioPullNo, GpioSpeedLow);
+    app->txrx->tuned_frequency = 0; /* The reset lost it. */
     app->txrx->txrx_state = TxRxStateIDLE;
 }
 
+/* Put the radio in idle state with the current modulation and frequency.
+ * Every register write costs SPI traffic and every frequency change a PLL
+ * calibration, so only what changed since the last call is written:
+ * switching between RX and TX, or sending many signals in a row, costs
+ * nothing here. */
+static void radio_configure(ProtoViewApp* app) {
+    subghz_devices_idle(app->radio_device);
+    if(app->txrx->loaded_modulation != (int)app->modulation) radio_load_preset(app);
+    if(app->txrx->tuned_frequency != app->frequency) {
+        uint32_t value = subghz_devices_set_frequency(app->radio_device, app->frequency);
+        FURI_LOG_E(TAG, "Switched to frequency: %lu", value);
+        app->txrx->tuned_frequency = app->frequency;
+    }
+}
+
 /* ================================= Reception ============================== */
 
 /* We avoid the subghz provided abstractions and put the data in our
- * simple abstraction: the RawSamples circular buffer. */
+ * simple abstraction: the RawSamples circular buffer. When a long capture
+ * is active, samples are also streamed to the SD card. */
 void protoview_rx_callback(bool level, uint32_t duration, void* context) {
-    UNUSED(context);
+    ProtoViewApp* app = context;
     /* Add data to the circular buffer. */
     raw_samples_add(RawSamples, level, duration);
+    ProtoViewCapture* capture = __atomic_load_n(&app->capture, __ATOMIC_ACQUIRE);
+    if(capture) capture_add(capture, level, duration);
     // FURI_LOG_E(TAG, "FEED: %d %d", (int)level, (int)duration);
     return;
 }
@@ -79,15 +103,12 @@ uint32_t radio_rx(ProtoViewApp* app) {
 
     if(app->txrx->txrx_state == TxRxStateRx) return app->frequency;
 
-    subghz_devices_idle(app->radio_device); /* Put it into idle state in case it is sleeping. */
-    uint32_t value = subghz_devices_set_frequency(app->radio_device, app->frequency);
-    FURI_LOG_E(TAG, "Switched to frequency: %lu", value);
-
+    radio_configure(app);
     subghz_devices_flush_rx(app->radio_device);
     subghz_devices_set_rx(app->radio_device);
 
     if(!app->txrx->debug_timer_sampling) {
-        subghz_devices_start_async_rx(app->radio_device, protoview_rx_callback, NULL);
+        subghz_devices_start_async_rx(app->radio_device, protoview_rx_callback, app);
     } else {
         furi_hal_gpio_init(
             subghz_devices_get_data_gpio(app->radio_device),
@@ -97,7 +118,7 @@ uint32_t radio_rx(ProtoViewApp* app) {
         raw_sampling_worker_start(app);
     }
     app->txrx->txrx_state = TxRxStateRx;
-    return value;
+    return app->frequency;
 }
 
 /* Stop receiving (if active) and put the radio on idle state. */
@@ -125,29 +146,31 @@ void radio_sleep(ProtoViewApp* app) {
     }
     subghz_devices_sleep(app->radio_device);
     app->txrx->txrx_state = TxRxStateSleep;
+    /* The PATABLE and test registers don't survive the sleep. */
+    app->txrx->loaded_modulation = -1;
 }
 
 /* =============================== Transmission ============================= */
 
 /* This function suspends the current RX state, switches to TX mode,
  * transmits the signal provided by the callback data_feeder, and later
- * restores the RX state if there was one. */
+ * restores the RX state if there was one. The radio is not reset around
+ * the transmission: RX and TX share the preset and the frequency, so
+ * radio_configure() has nothing to write unless the user changed them.
+ * Many messages in a row are better sent with a single call, with a
+ * feeder that chains them, as tx_sequencer.c does. */
 void radio_tx_signal(ProtoViewApp* app, FuriHalSubGhzAsyncTxCallback data_feeder, void* ctx) {
     TxRxState oldstate = app->txrx->txrx_state;
 
     if(oldstate == TxRxStateRx) radio_rx_end(app);
-    radio_begin(app);
-
-    subghz_devices_idle(app->radio_device);
-    uint32_t value = subghz_devices_set_frequency(app->radio_device, app->frequency);
-    FURI_LOG_E(TAG, "Switched to frequency: %lu", value);
+    radio_configure(app);
 
     subghz_devices_start_async_tx(app->radio_device, data_feeder, ctx);
-    while(!subghz_devices_is_async_complete_tx(app->radio_device)) furi_delay_ms(10);
+    while(!subghz_devices_is_async_complete_tx(app->radio_device)) furi_delay_ms(1);
     subghz_devices_stop_async_tx(app->radio_device);
     subghz_devices_idle(app->radio_device);
+    app->txrx->txrx_state = TxRxStateIDLE;
 
-    radio_begin(app);
     if(oldstate == TxRxStateRx) radio_rx(app);
 }
 
@@ -168,6 +191,8 @@ void protoview_timer_isr(void* ctx) {
         dur /= furi_hal_cortex_instructions_per_microsecond();
         if(dur > 15000) dur = 15000;
         raw_samples_add(RawSamples, app->txrx->last_g0_value, dur);
+        ProtoViewCapture* capture = __atomic_load_n(&app->capture, __ATOMIC_ACQUIRE);
+        if(capture) capture_add(capture, app->txrx->last_g0_value, dur);
         app->txrx->last_g0_value = level;
         app->txrx->last_g0_change_time = now;
     }
@@ -0,0 +1,242 @@
+/* Copyright (C) 2022-2023 Salvatore Sanfilippo -- All Rights Reserved
+ * See the LICENSE file for information about the license. */
+
+#include "app.h"
+#include <storage/storage.h>
+
+/* ============================== Long captures ===============================
+ * The RawSamples circular buffer only holds the last few thousands samples,
+ * so the start of long transmissions (for instance long bursts of rolling
+ * codes) is lost. In capture mode we also stream every sample received to a
+ * file on the SD card, so that it can be later paged back into a
+ * RawSamplesBuffer, displayed and decoded.
+ *
+ * The RX callback / ISR can't touch the SD card, so it writes samples into
+ * one half of a double buffer. When the half is full, the producer switches
+ * to the other half and wakes up a worker thread that writes the full half
+ * to the file. If the SD is so slow that both halves are full, samples are
+ * dropped (and counted), since blocking inside the ISR is not an option.
+ *
+ * File format: a CaptureFileHeader followed by 16 bit little endian
+ * samples, with the level in the most significant bit and the duration in
+ * microseconds (saturated at 32767) in the other 15 bits.
+ * ========================================================================== */
+
+#define CAPTURE_MAGIC "PVC1"
+
+typedef struct {
+    char magic[4]; /* CAPTURE_MAGIC */
+    uint32_t frequency; /* Frequency the capture was done at. */
+    uint32_t modulation; /* Index in ProtoViewModulations[]. */
+} CaptureFileHeader;
+
+#define CAPTURE_HALF_SAMPLES 1024 /* Samples of each half of the buffer. */
+
+typedef enum {
+    CaptureFlagFlush = (1 << 0), /* A full half is ready to be written. */
+    CaptureFlagStop = (1 << 1), /* Write the partial half and exit. */
+} CaptureFlags;
+
+struct ProtoViewCapture {
+    Storage* storage;
+    File* file;
+    FuriThread* thread;
+    uint16_t buf[2][CAPTURE_HALF_SAMPLES];
+    /* Producer side. */
+    uint32_t cur; /* Half the producer is filling. */
+    uint32_t fill; /* Samples in the half being filled. */
+    uint32_t dropped; /* Samples dropped because the SD was too slow. */
+    /* Set by the producer when it hands a full half to the worker,
+     * cleared by the worker once written. */
+    bool writing;
+    /* Worker side. */
+    uint32_t written; /* Samples written to the file. */
+    bool io_error; /* A write failed: the capture is truncated. */
+};
+
+struct ProtoViewCaptureReader {
+    Storage* storage;
+    File* file;
+    uint32_t count; /* Samples in the file. */
+    uint32_t frequency;
+    uint32_t modulation;
+};
+
+/* Write the first 'count' samples of the specified half. Worker side. */
+static void capture_write_half(ProtoViewCapture* c, uint32_t half, uint32_t count) {
+    if(count == 0 || c->io_error) return;
+    size_t len = count * sizeof(uint16_t);
+    if(storage_file_write(c->file, c->buf[half], len) != len) {
+        FURI_LOG_E(TAG, "Capture: short write, capture truncated");
+        c->io_error = true;
+        return;
+    }
+    c->written += count;
+}
+
+static int32_t capture_worker(void* ctx) {
+    ProtoViewCapture* c = ctx;
+    while(1) {
+        uint32_t flags = furi_thread_flags_wait(
+            CaptureFlagFlush | CaptureFlagStop, FuriFlagWaitAny, FuriWaitForever);
+        if(flags & FuriFlagError) continue;
+
+        if(flags & CaptureFlagFlush) {
+            capture_write_half(c, c->cur ^ 1, CAPTURE_HALF_SAMPLES);
+            __atomic_store_n(&c->writing, false, __ATOMIC_RELEASE);
+        }
+
+        /* When we are asked to stop, the producer is already detached, so
+         * we can access its state. */
+        if(flags & CaptureFlagStop) {
+            capture_write_half(c, c->cur, c->fill);
+            break;
+        }
+    }
+    return 0;
+}
+
+/* Hand the current (full) half to the worker and start filling the other
+ * one. Returns false if the worker is still busy writing the other half.
+ * Producer side. */
+static bool capture_swap(ProtoViewCapture* c) {
+    if(__atomic_load_n(&c->writing, __ATOMIC_ACQUIRE)) return false;
+    c->writing = true;
+    c->cur ^= 1;
+    c->fill = 0;
+    furi_thread_flags_set(furi_thread_get_id(c->thread), CaptureFlagFlush);
+    return true;
+}
+
+/* Add a sample to the capture. Called from the RX callback / timer ISR,
+ * so it must never block. */
+void capture_add(ProtoViewCapture* c, bool level, uint32_t dur) {
+    /* The half may be still full from the last call, if the worker was
+     * busy at the time. */
+    if(c->fill == CAPTURE_HALF_SAMPLES && !capture_swap(c)) {
+        c->dropped++;
+        return;
+    }
+    if(dur > 0x7fff) dur = 0x7fff;
+    c->buf[c->cur][c->fill++] = (level ? 0x8000 : 0) | dur;
+    if(c->fill == CAPTURE_HALF_SAMPLES) capture_swap(c);
+}
+
+/* Start streaming the received samples to the file at 'path'. Returns
+ * false if the file can't be created. The capture is attached to the app
+ * only once fully initialized, so the RX path can start using it. */
+bool capture_start(ProtoViewApp* app, const char* path) {
+    if(app->capture) return true;
+
+    ProtoViewCapture* c = malloc(sizeof(*c));
+    memset(c, 0, sizeof(*c));
+    c->storage = furi_record_open(RECORD_STORAGE);
+    c->file = storage_file_alloc(c->storage);
+
+    CaptureFileHeader hdr;
+    memcpy(hdr.magic, CAPTURE_MAGIC, sizeof(hdr.magic));
+    hdr.frequency = app->frequency;
+    hdr.modulation = app->modulation;
+
+    if(!storage_file_open(c->file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS) ||
+       storage_file_write(c->file, &hdr, sizeof(hdr)) != sizeof(hdr)) {
+        FURI_LOG_E(TAG, "Capture: unable to create %s", path);
+        storage_file_free(c->file);
+        furi_record_close(RECORD_STORAGE);
+        free(c);
+        return false;
+    }
+
+    c->thread = furi_thread_alloc_ex("ProtoViewCapture", 1024, capture_worker, c);
+    furi_thread_start(c->thread);
+    __atomic_store_n(&app->capture, c, __ATOMIC_RELEASE);
+    return true;
+}
+
+/* Stop the capture, if active, writing the remaining samples. */
+void capture_stop(ProtoViewApp* app) {
+    ProtoViewCapture* c = app->capture;
+    if(c == NULL) return;
+
+    /* Detach the capture from the RX path first. The producer runs in
+     * interrupt context: once we are here executing after the store, it
+     * can't be in the middle of capture_add(). */
+    __atomic_store_n(&app->capture, NULL, __ATOMIC_RELEASE);
+
+    furi_thread_flags_set(furi_thread_get_id(c->thread), CaptureFlagStop);
+    furi_thread_join(c->thread);
+    furi_thread_free(c->thread);
+
+    if(c->dropped)
+        FURI_LOG_E(TAG, "Capture: %lu samples dropped", (unsigned long)c->dropped);
+    storage_file_close(c->file);
+    storage_file_free(c->file);
+    furi_record_close(RECORD_STORAGE);
+    free(c);
+}
+
+/* Return the number of samples captured so far. */
+uint32_t capture_get_count(ProtoViewCapture* c) {
+    return c->written + c->fill;
+}
+
+/* Open a capture file for reading. Returns NULL if the file does not exist
+ * or is not a valid capture. */
+ProtoViewCaptureReader* capture_reader_open(const char* path) {
+    ProtoViewCaptureReader* r = malloc(sizeof(*r));
+    r->storage = furi_record_open(RECORD_STORAGE);
+    r->file = storage_file_alloc(r->storage);
+
+    CaptureFileHeader hdr;
+    if(!storage_file_open(r->file, path, FSAM_READ, FSOM_OPEN_EXISTING) ||
+       storage_file_read(r->file, &hdr, sizeof(hdr)) != sizeof(hdr) ||
+       memcmp(hdr.magic, CAPTURE_MAGIC, sizeof(hdr.magic)) != 0) {
+        capture_reader_close(r);
+        return NULL;
+    }
+    r->count = (storage_file_size(r->file) - sizeof(hdr)) / sizeof(uint16_t);
+    r->frequency = hdr.frequency;
+    r->modulation = hdr.modulation;
+    return r;
+}
+
+void capture_reader_close(ProtoViewCaptureReader* r) {
+    storage_file_close(r->file);
+    storage_file_free(r->file);
+    furi_record_close(RECORD_STORAGE);
+    free(r);
+}
+
+/* Return the number of samples in the capture. */
+uint32_t capture_reader_count(ProtoViewCaptureReader* r) {
+    return r->count;
+}
+
+/* Load into 'dst' the page of dst->total samples starting at sample
+ * 'first' of the capture. The page replaces the content of the buffer and
+ * its first sample is at index zero. If the capture ends before the page,
+ * the remaining samples are zero. Returns false on read errors or if
+ * 'first' is past the end of the capture. */
+bool capture_reader_load(ProtoViewCaptureReader* r, RawSamplesBuffer* dst, uint32_t first) {
+    if(first >= r->count) return false;
+    if(!storage_file_seek(r->file, sizeof(CaptureFileHeader) + first * sizeof(uint16_t), true))
+        return false;
+
+    raw_samples_reset(dst);
+    uint32_t todo = r->count - first;
+    if(todo > dst->total) todo = dst->total;
+
+    uint16_t block[128];
+    uint32_t j = 0;
+    while(j < todo) {
+        uint32_t n = todo - j;
+        if(n > COUNT_OF(block)) n = COUNT_OF(block);
+        size_t len = n * sizeof(uint16_t);
+        if(storage_file_read(r->file, block, len) != len) return false;
+        for(uint32_t k = 0; k < n; k++, j++) {
+            dst->samples[j].level = block[k] >> 15;
+            dst->samples[j].dur = block[k] & 0x7fff;
+        }
+    }
+    return true;
+}
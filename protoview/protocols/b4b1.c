@@ -12,6 +12,10 @@
 
 #include "../app.h"
 
+/* The common part of the sync patterns below: one pulse, 30 gaps. */
+static const char sync_prefix[] = "1000000000000000000000000000000";
+static const char* const preambles[] = {sync_prefix, NULL};
+
 static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo* info) {
     if(numbits < 30) return false;
 
@@ -90,4 +94,8 @@ ProtoViewDecoder B4B1Decoder = {
     .name = "PT/SC remote",
     .decode = decode,
     .get_fields = get_fields,
-    .build_message = build_message};
+    .build_message = build_message,
+    .min_bits = 30,
+    .short_pulse_min = 100,
+    .short_pulse_max = 1000,
+    .preambles = preambles};
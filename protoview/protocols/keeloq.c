@@ -27,12 +27,14 @@
 
 #include "../app.h"
 
+/* In the sync pattern, we require the 12 high/low pulses and at least
+ * half the gap we expect (5 pulses times, one is the final zero in the
+ * 24 symbols high/low sequence, then other 4). */
+static const char sync_pattern[] = "101010101010101010101010"
+                                   "0000";
+static const char* const preambles[] = {sync_pattern, NULL};
+
 static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo* info) {
-    /* In the sync pattern, we require the 12 high/low pulses and at least
-     * half the gap we expect (5 pulses times, one is the final zero in the
-     * 24 symbols high/low sequence, then other 4). */
-    const char* sync_pattern = "101010101010101010101010"
-                               "0000";
     uint8_t sync_len = 24 + 4;
     if(numbits - sync_len + sync_len < 3 * 66) return false;
     uint32_t off = bitmap_seek_bits(bits, numbytes, 0, numbits, sync_pattern);
@@ -117,5 +119,12 @@ static void build_message(RawSamplesBuffer* samples, ProtoViewFieldSet* fieldset
     }
 }
 
-ProtoViewDecoder KeeloqDecoder =
-    {.name = "Keeloq", .decode = decode, .get_fields = get_fields, .build_message = build_message};
+ProtoViewDecoder KeeloqDecoder = {
+    .name = "Keeloq",
+    .decode = decode,
+    .get_fields = get_fields,
+    .build_message = build_message,
+    .min_bits = 3 * 66,
+    .short_pulse_min = 100,
+    .short_pulse_max = 800,
+    .preambles = preambles};
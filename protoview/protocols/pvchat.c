@@ -75,9 +75,11 @@
  *    second. More than enough for the simple chat we have here.
  */
 
+static const char sync_pattern[] = "1010101010101010" // Preamble
+                                   "1100110011001010"; // Sync
+static const char* const preambles[] = {sync_pattern, NULL};
+
 static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo* info) {
-    const char* sync_pattern = "1010101010101010" // Preamble
-                               "1100110011001010"; // Sync
     uint8_t sync_len = 32;
 
     /* This is a variable length message, however the minimum length
@@ -202,4 +204,8 @@ ProtoViewDecoder ProtoViewChatDecoder = {
     .name = "ProtoView chat",
     .decode = decode,
     .get_fields = get_fields,
-    .build_message = build_message};
+    .build_message = build_message,
+    .min_bits = 32 + 8 * 4,
+    .short_pulse_min = 50,
+    .short_pulse_max = 600,
+    .preambles = preambles};
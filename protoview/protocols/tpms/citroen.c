@@ -10,12 +10,14 @@
 
 #include "../../app.h"
 
+/* We consider a preamble of 17 symbols. They are more, but the decoding
+ * is more likely to happen if we don't pretend to receive from the
+ * very start of the message. */
+static const char sync_pattern[] = "10101010101010110";
+static const char* const preambles[] = {sync_pattern, NULL};
+
 static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo* info) {
-    /* We consider a preamble of 17 symbols. They are more, but the decoding
-     * is more likely to happen if we don't pretend to receive from the
-     * very start of the message. */
     uint32_t sync_len = 17;
-    const char* sync_pattern = "10101010101010110";
     if(numbits - sync_len < 8 * 10) return false; /* Expect 10 bytes. */
 
     uint64_t off = bitmap_seek_bits(bits, numbytes, 0, numbits, sync_pattern);
@@ -54,5 +56,10 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     return true;
 }
 
-ProtoViewDecoder CitroenTPMSDecoder =
-    {.name = "Citroen TPMS", .decode = decode, .get_fields = NULL, .build_message = NULL};
+ProtoViewDecoder CitroenTPMSDecoder = {
+    .name = "Citroen TPMS",
+    .decode = decode,
+    .get_fields = NULL,
+    .build_message = NULL,
+    .min_bits = 17 + 8 * 10,
+    .preambles = preambles};
@@ -13,9 +13,11 @@
 
 #include "../../app.h"
 
+static const char sync_pattern[] = "010101010101"
+                                   "0110";
+static const char* const preambles[] = {sync_pattern, NULL};
+
 static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo* info) {
-    const char* sync_pattern = "010101010101"
-                               "0110";
     uint8_t sync_len = 12 + 4; /* We just use 12 preamble symbols + sync. */
     if(numbits - sync_len < 8 * 8) return false;
 
@@ -57,5 +59,10 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     return true;
 }
 
-ProtoViewDecoder FordTPMSDecoder =
-    {.name = "Ford TPMS", .decode = decode, .get_fields = NULL, .build_message = NULL};
+ProtoViewDecoder FordTPMSDecoder = {
+    .name = "Ford TPMS",
+    .decode = decode,
+    .get_fields = NULL,
+    .build_message = NULL,
+    .min_bits = 16 + 8 * 8,
+    .preambles = preambles};
@@ -25,6 +25,9 @@ static const char* test_vector =
     "0101010101010101" // Two FF bytes (usually). Unknown.
     "0110010101010101"; // CRC8 with (poly 7, initialization 0).
 
+static const char sync_pattern[] = "01010101010101010110";
+static const char* const preambles[] = {sync_pattern, NULL};
+
 static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo* info) {
     if(USE_TEST_VECTOR) { /* Test vector to check that decoding works. */
         bitmap_set_pattern(bits, numbytes, 0, test_vector);
@@ -33,7 +36,6 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
 
     if(numbits - 12 < 9 * 8) return false;
 
-    const char* sync_pattern = "01010101010101010110";
     uint64_t off = bitmap_seek_bits(bits, numbytes, 0, numbits, sync_pattern);
     if(off == BITMAP_SEEK_NOT_FOUND) return false;
     FURI_LOG_E(TAG, "Renault TPMS preamble+sync found");
@@ -116,4 +118,6 @@ ProtoViewDecoder RenaultTPMSDecoder = {
     .name = "Renault TPMS",
     .decode = decode,
     .get_fields = get_fields,
-    .build_message = build_message};
+    .build_message = build_message,
+    .min_bits = USE_TEST_VECTOR ? 0 : 12 + 9 * 8,
+    .preambles = USE_TEST_VECTOR ? NULL : preambles};
@@ -17,6 +17,10 @@
 static const char* test_vector =
     "000000111101010101011010010110010110101001010110100110011001100101010101011010100110100110011010101010101010101010101010101010101010101010101010";
 
+static const char sync_pattern[] = "1111010101"
+                                   "01011010";
+static const char* const preambles[] = {sync_pattern, NULL};
+
 static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo* info) {
     if(USE_TEST_VECTOR) { /* Test vector to check that decoding works. */
         bitmap_set_pattern(bits, numbytes, 0, test_vector);
@@ -25,8 +29,6 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
 
     if(numbits < 64) return false; /* Preamble + data. */
 
-    const char* sync_pattern = "1111010101"
-                               "01011010";
     uint64_t off = bitmap_seek_bits(bits, numbytes, 0, numbits, sync_pattern);
     if(off == BITMAP_SEEK_NOT_FOUND) return false;
     FURI_LOG_E(TAG, "Schrader TPMS gap+preamble found");
@@ -66,5 +68,10 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     return true;
 }
 
-ProtoViewDecoder SchraderTPMSDecoder =
-    {.name = "Schrader TPMS", .decode = decode, .get_fields = NULL, .build_message = NULL};
+ProtoViewDecoder SchraderTPMSDecoder = {
+    .name = "Schrader TPMS",
+    .decode = decode,
+    .get_fields = NULL,
+    .build_message = NULL,
+    .min_bits = USE_TEST_VECTOR ? 0 : 64,
+    .preambles = USE_TEST_VECTOR ? NULL : preambles};
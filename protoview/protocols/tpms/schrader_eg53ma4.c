@@ -18,9 +18,11 @@
 
 #include "../../app.h"
 
+static const char sync_pattern[] = "010101010101"
+                                   "01100101";
+static const char* const preambles[] = {sync_pattern, NULL};
+
 static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo* info) {
-    const char* sync_pattern = "010101010101"
-                               "01100101";
     uint8_t sync_len = 12 + 8; /* We just use 12 preamble symbols + sync. */
     if(numbits - sync_len + 8 < 8 * 10) return false;
 
@@ -58,5 +60,10 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     return true;
 }
 
-ProtoViewDecoder SchraderEG53MA4TPMSDecoder =
-    {.name = "Schrader EG53MA4 TPMS", .decode = decode, .get_fields = NULL, .build_message = NULL};
+ProtoViewDecoder SchraderEG53MA4TPMSDecoder = {
+    .name = "Schrader EG53MA4 TPMS",
+    .decode = decode,
+    .get_fields = NULL,
+    .build_message = NULL,
+    .min_bits = 20 - 8 + 8 * 10,
+    .preambles = preambles};
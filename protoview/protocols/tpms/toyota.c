@@ -27,13 +27,13 @@
 
 #include "../../app.h"
 
+static const char* const sync[] = {"00111100", "001111100", "00111101", "001111101", NULL};
+
 static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo* info) {
     if(numbits - 6 < 64 * 2)
         return false; /* Ask for 64 bit of data (each bit
                                            is two symbols in the bitmap). */
 
-    char* sync[] = {"00111100", "001111100", "00111101", "001111101", NULL};
-
     int j;
     uint32_t off = 0;
     for(j = 0; sync[j]; j++) {
@@ -77,5 +77,10 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     return true;
 }
 
-ProtoViewDecoder ToyotaTPMSDecoder =
-    {.name = "Toyota TPMS", .decode = decode, .get_fields = NULL, .build_message = NULL};
+ProtoViewDecoder ToyotaTPMSDecoder = {
+    .name = "Toyota TPMS",
+    .decode = decode,
+    .get_fields = NULL,
+    .build_message = NULL,
+    .min_bits = 6 + 64 * 2,
+    .preambles = sync};
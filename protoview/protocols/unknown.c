@@ -293,7 +293,7 @@ static bool decode(uint8_t* bits, uint32_t numbytes, uint32_t numbits, ProtoView
     /* We think there is a message and we know where it starts and the
      * line code used. We can turn it into bits and bytes. */
     uint32_t decoded;
-    uint8_t data[32];
+    uint8_t data[32] = {0}; /* Bits past the decoded ones must read as zero. */
     uint32_t datalen;
 
     char symbol1[5], symbol2[5];
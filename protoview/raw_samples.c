@@ -7,45 +7,60 @@
 #include <furi_hal.h>
 #include "raw_samples.h"
 
-/* Allocate and initialize a samples buffer. */
-RawSamplesBuffer* raw_samples_alloc(void) {
-    RawSamplesBuffer* buf = malloc(sizeof(*buf));
-    buf->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+/* Allocate and initialize a samples buffer able to hold 'total' samples,
+ * that must be a power of two. The samples are allocated together with
+ * the buffer structure. */
+RawSamplesBuffer* raw_samples_alloc_size(uint32_t total) {
+    furi_assert(total && (total & (total - 1)) == 0);
+    RawSamplesBuffer* buf = malloc(sizeof(*buf) + sizeof(RawSample) * total);
+    buf->samples = (RawSample*)(buf + 1);
+    buf->total = total;
+    buf->mask = total - 1;
     raw_samples_reset(buf);
     return buf;
 }
 
-/* Free a sample buffer. Should be called when the mutex is released. */
+/* Allocate a samples buffer of the default size. */
+RawSamplesBuffer* raw_samples_alloc(void) {
+    return raw_samples_alloc_size(RAW_SAMPLES_NUM);
+}
+
+/* Free a sample buffer. Should be called when the producer (if any)
+ * was already stopped. */
 void raw_samples_free(RawSamplesBuffer* s) {
-    furi_mutex_free(s->mutex);
     free(s);
 }
 
 /* This just set all the samples to zero and also resets the internal
  * index. There is no need to call it after raw_samples_alloc(), but only
- * when one wants to reset the whole buffer of samples. */
+ * when one wants to reset the whole buffer of samples.
+ *
+ * If the producer is running while we reset, a few samples may
+ * survive the memset: this is harmless, since they are real samples
+ * anyway, just like the ones that will arrive immediately after. */
 void raw_samples_reset(RawSamplesBuffer* s) {
-    furi_mutex_acquire(s->mutex, FuriWaitForever);
-    s->total = RAW_SAMPLES_NUM;
-    s->idx = 0;
     s->short_pulse_dur = 0;
-    memset(s->samples, 0, sizeof(s->samples));
-    furi_mutex_release(s->mutex);
+    memset(s->samples, 0, sizeof(RawSample) * s->total);
+    __atomic_store_n(&s->idx, 0, __ATOMIC_RELEASE);
 }
 
 /* Set the raw sample internal index so that what is currently at
- * offset 'offset', will appear to be at 0 index. */
+ * offset 'offset', will appear to be at 0 index. This must only be
+ * called on buffers that have no producer, like the snapshots
+ * obtained with raw_samples_copy(). */
 void raw_samples_center(RawSamplesBuffer* s, uint32_t offset) {
-    s->idx = (s->idx + offset) % RAW_SAMPLES_NUM;
+    s->idx += offset;
 }
 
-/* Add the specified sample in the circular buffer. */
+/* Add the specified sample in the circular buffer. This is the producer
+ * side of the buffer and is called from the RX callback / ISR, so it
+ * must be fast and must never block: the sample is written first, and
+ * only then the new index is made visible to the consumer. */
 void raw_samples_add(RawSamplesBuffer* s, bool level, uint32_t dur) {
-    furi_mutex_acquire(s->mutex, FuriWaitForever);
-    s->samples[s->idx].level = level;
-    s->samples[s->idx].dur = dur;
-    s->idx = (s->idx + 1) % RAW_SAMPLES_NUM;
-    furi_mutex_release(s->mutex);
+    uint32_t idx = s->idx;
+    s->samples[idx & s->mask].level = level;
+    s->samples[idx & s->mask].dur = dur;
+    __atomic_store_n(&s->idx, idx + 1, __ATOMIC_RELEASE);
 }
 
 /* This is like raw_samples_add(), however in case a sample of the
@@ -57,37 +72,65 @@ void raw_samples_add(RawSamplesBuffer* s, bool level, uint32_t dur) {
  * This function is a bit slower so the internal data sampling should
  * be performed with raw_samples_add(). */
 void raw_samples_add_or_update(RawSamplesBuffer* s, bool level, uint32_t dur) {
-    furi_mutex_acquire(s->mutex, FuriWaitForever);
-    uint32_t previdx = (s->idx - 1) % RAW_SAMPLES_NUM;
+    uint32_t previdx = (s->idx - 1) & s->mask;
     if(s->samples[previdx].level == level && s->samples[previdx].dur != 0) {
         /* Update the last sample: it has the same level. */
         s->samples[previdx].dur += dur;
     } else {
         /* Add a new sample. */
-        s->samples[s->idx].level = level;
-        s->samples[s->idx].dur = dur;
-        s->idx = (s->idx + 1) % RAW_SAMPLES_NUM;
+        raw_samples_add(s, level, dur);
     }
-    furi_mutex_release(s->mutex);
 }
 
 /* Get the sample from the buffer. It is possible to use out of range indexes
- * as 'idx' because the modulo operation will rewind back from the start. */
+ * as 'idx' because the modulo operation will rewind back from the start.
+ *
+ * No locking is performed: to examine a buffer that is being
+ * written, take a snapshot with raw_samples_copy() first. */
 void raw_samples_get(RawSamplesBuffer* s, uint32_t idx, bool* level, uint32_t* dur) {
-    furi_mutex_acquire(s->mutex, FuriWaitForever);
-    idx = (s->idx + idx) % RAW_SAMPLES_NUM;
+    idx = (s->idx + idx) & s->mask;
     *level = s->samples[idx].level;
     *dur = s->samples[idx].dur;
-    furi_mutex_release(s->mutex);
 }
 
-/* Copy one buffer to the other, including current index. */
-void raw_samples_copy(RawSamplesBuffer* dst, RawSamplesBuffer* src) {
-    furi_mutex_acquire(src->mutex, FuriWaitForever);
-    furi_mutex_acquire(dst->mutex, FuriWaitForever);
-    dst->idx = src->idx;
+/* Return the index of the next sample the producer will write, that is
+ * the total number of samples written so far (not masked). Can be called
+ * concurrently with raw_samples_add(). */
+uint32_t raw_samples_write_idx(RawSamplesBuffer* s) {
+    return __atomic_load_n(&s->idx, __ATOMIC_ACQUIRE);
+}
+
+/* Take a snapshot of 'src' into 'dst'. The source buffer may be
+ * concurrently written by its producer: we load the write index, then
+ * copy the whole window with (at most) two memcpy() calls so that the
+ * oldest sample ends at index 0 of 'dst' and dst->idx is zero (from the
+ * point of view of raw_samples_get() this is the same as copying the
+ * index with the samples).
+ *
+ * Samples the producer wrote while we were copying overwrote the oldest
+ * part of the window: we detect how many by reloading the index, and
+ * zero them in the copy, so that they will look like a signal
+ * interruption to the detector instead of mixing old and new data.
+ *
+ * The return value is the source write index at the time of the
+ * snapshot: the sample at index 0 of 'dst' is the one that was written
+ * as sample number 'retval - src->total' in 'src'.
+ *
+ * The two buffers must have the same size. */
+uint32_t raw_samples_copy(RawSamplesBuffer* dst, RawSamplesBuffer* src) {
+    furi_assert(dst->total == src->total);
+    uint32_t start = raw_samples_write_idx(src);
+    uint32_t head = start & src->mask;
+    uint32_t tail = src->total - head;
+
+    memcpy(dst->samples, src->samples + head, tail * sizeof(src->samples[0]));
+    memcpy(dst->samples + tail, src->samples, head * sizeof(src->samples[0]));
+
+    uint32_t clobbered = raw_samples_write_idx(src) - start;
+    if(clobbered > src->total) clobbered = src->total;
+    if(clobbered) memset(dst->samples, 0, clobbered * sizeof(dst->samples[0]));
+
+    dst->idx = 0;
     dst->short_pulse_dur = src->short_pulse_dur;
-    memcpy(dst->samples, src->samples, sizeof(dst->samples));
-    furi_mutex_release(src->mutex);
-    furi_mutex_release(dst->mutex);
+    return start;
 }
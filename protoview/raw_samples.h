@@ -2,32 +2,46 @@
  * See the LICENSE file for information about the license. */
 
 /* Our circular buffer of raw samples, used in order to display
- * the signal. */
+ * the signal.
+ *
+ * The buffer is written by a single producer (the RX callback or the
+ * timer ISR) and read by a single consumer (the app timer / GUI). No
+ * lock is used: the producer writes the sample and only later publishes
+ * the new write index with release semantics, while the consumer loads
+ * the index with acquire semantics and takes snapshots of whole windows
+ * with raw_samples_copy(). */
 
 #define RAW_SAMPLES_NUM \
-    2048 /* Use a power of two: we take the modulo
-                                of the index quite often to normalize inside
-                                the range, and division is slow. */
+    2048 /* Default size. Sizes must be a power of two: we take the
+                            modulo of the index quite often to normalize
+                            inside the range, and division is slow. */
+
+typedef struct {
+    uint16_t level : 1;
+    uint16_t dur : 15;
+} RawSample;
+
 typedef struct RawSamplesBuffer {
-    FuriMutex* mutex;
-    struct {
-        uint16_t level : 1;
-        uint16_t dur : 15;
-    } samples[RAW_SAMPLES_NUM];
-    uint32_t idx; /* Current idx (next to write). */
-    uint32_t total; /* Total samples: same as RAW_SAMPLES_NUM, we provide
-                       this field for a cleaner interface with the user, but
-                       we always use RAW_SAMPLES_NUM when taking the modulo so
-                       the compiler can optimize % as bit masking. */
+    RawSample* samples; /* 'total' samples, allocated with the struct. */
+    uint32_t idx; /* Current idx (next to write). Only the producer
+                     writes it, see raw_samples_add(). It is never
+                     normalized into the range: it is the total number of
+                     samples written, and gets masked on access. This way
+                     the consumer can tell how many samples arrived since
+                     the last time it looked, even across wrap arounds. */
+    uint32_t total; /* Number of samples in the buffer, a power of two. */
+    uint32_t mask; /* total-1, to normalize indexes with a bitwise AND. */
     /* Signal features. */
     uint32_t short_pulse_dur; /* Duration of the shortest pulse. */
 } RawSamplesBuffer;
 
 RawSamplesBuffer* raw_samples_alloc(void);
+RawSamplesBuffer* raw_samples_alloc_size(uint32_t total);
 void raw_samples_reset(RawSamplesBuffer* s);
 void raw_samples_center(RawSamplesBuffer* s, uint32_t offset);
 void raw_samples_add(RawSamplesBuffer* s, bool level, uint32_t dur);
 void raw_samples_add_or_update(RawSamplesBuffer* s, bool level, uint32_t dur);
 void raw_samples_get(RawSamplesBuffer* s, uint32_t idx, bool* level, uint32_t* dur);
-void raw_samples_copy(RawSamplesBuffer* dst, RawSamplesBuffer* src);
+uint32_t raw_samples_write_idx(RawSamplesBuffer* s);
+uint32_t raw_samples_copy(RawSamplesBuffer* dst, RawSamplesBuffer* src);
 void raw_samples_free(RawSamplesBuffer* s);
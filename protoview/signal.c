@@ -2,6 +2,7 @@
  * See the LICENSE file for information about the license. */
 
 #include "app.h"
+#include "profile.h"
 
 bool decode_signal(RawSamplesBuffer* s, uint64_t len, ProtoViewMsgInfo* info);
 
@@ -59,10 +60,80 @@ void reset_current_signal(ProtoViewApp* app) {
     app->signal_decoded = false;
     raw_samples_reset(DetectedSamples);
     raw_samples_reset(RawSamples);
+    scan_state_reset(&app->scan, 0);
     free_msg_info(app->msg_info);
     app->msg_info = NULL;
 }
 
+/* Maximum duration of a pulse to be considered part of a coherent signal.
+ * The minimum is passed to the scanning functions, as it depends on the
+ * data rate and in general on the signal to analyze. */
+#define SEARCH_MAX_DURATION 4000
+
+/* Try to add a sample to the set of classes of the current run.
+ * If the sample matches a class we already have, or we can populate a
+ * new (yet empty) class, true is returned and the class is updated.
+ * Otherwise false is returned: the sample does not belong to the
+ * run. */
+static bool pulse_classes_add(
+    ProtoViewPulseClass* classes,
+    bool level,
+    uint32_t dur,
+    uint32_t min_duration) {
+    if(dur < min_duration || dur > SEARCH_MAX_DURATION) return false;
+
+    for(uint32_t k = 0; k < SEARCH_CLASSES; k++) {
+        if(classes[k].count[level] == 0) {
+            classes[k].dur[level] = dur;
+            classes[k].count[level] = 1;
+            return true; /* Sample accepted. */
+        } else {
+            uint32_t classavg = classes[k].dur[level];
+            uint32_t count = classes[k].count[level];
+            uint32_t delta = duration_delta(dur, classavg);
+            /* Is the difference in duration between this signal and
+             * the class we are inspecting less than a given percentage?
+             * If so, accept this signal. */
+            if(delta < classavg / 5) { /* 100%/5 = 20%. */
+                /* It is useful to compute the average of the class
+                 * we are observing. We know how many samples we got so
+                 * far, so we can recompute the average easily.
+                 * By always having a better estimate of the pulse len
+                 * we can avoid missing next samples in case the first
+                 * observed samples are too off. */
+                classavg = ((classavg * count) + dur) / (count + 1);
+                classes[k].dur[level] = classavg;
+                classes[k].count[level]++;
+                return true; /* Sample accepted. */
+            }
+        }
+    }
+    return false;
+}
+
+/* Return the shortest pulse we found among the classes. This will be
+ * used when scaling for visualization, and as sampling rate by the
+ * decoders. */
+static uint32_t pulse_classes_short_dur(ProtoViewPulseClass* classes) {
+    uint32_t short_dur[2] = {0, 0};
+    for(int j = 0; j < SEARCH_CLASSES; j++) {
+        for(int level = 0; level < 2; level++) {
+            if(classes[j].dur[level] == 0) continue;
+            if(classes[j].count[level] < 3) continue;
+            if(short_dur[level] == 0 || short_dur[level] > classes[j].dur[level]) {
+                short_dur[level] = classes[j].dur[level];
+            }
+        }
+    }
+
+    /* Use the average between high and low short pulses duration.
+     * Often they are a bit different, and using the average is more robust
+     * when we do decoding sampling at short_pulse_dur intervals. */
+    if(short_dur[0] == 0) short_dur[0] = short_dur[1];
+    if(short_dur[1] == 0) short_dur[1] = short_dur[0];
+    return (short_dur[0] + short_dur[1]) / 2;
+}
+
 /* This function starts scanning samples at offset idx looking for the
  * longest run of pulses, either high or low, that are not much different
  * from each other, for a maximum of three duration classes.
@@ -75,88 +146,22 @@ void reset_current_signal(ProtoViewApp* app) {
  *
  * For instance Oregon2 sensors, in the case of protocol 2.1 will send
  * pulses of ~400us (RF on) VS ~580us (RF off). */
-#define SEARCH_CLASSES 3
 uint32_t search_coherent_signal(RawSamplesBuffer* s, uint32_t idx, uint32_t min_duration) {
-    struct {
-        uint32_t dur[2]; /* dur[0] = low, dur[1] = high */
-        uint32_t count[2]; /* Associated observed frequency. */
-    } classes[SEARCH_CLASSES];
-
+    ProtoViewPulseClass classes[SEARCH_CLASSES];
     memset(classes, 0, sizeof(classes));
 
-    // Set a min/max duration limit for samples to be considered part of a
-    // coherent signal. The maximum length is fixed while the minimum
-    // is passed as argument, as depends on the data rate and in general
-    // on the signal to analyze.
-    uint32_t max_duration = 4000;
-
     uint32_t len = 0; /* Observed len of coherent samples. */
-    s->short_pulse_dur = 0;
     for(uint32_t j = idx; j < idx + s->total; j++) {
         bool level;
         uint32_t dur;
         raw_samples_get(s, j, &level, &dur);
-
-        if(dur < min_duration || dur > max_duration) break; /* return. */
-
-        /* Let's see if it matches a class we already have or if we
-         * can populate a new (yet empty) class. */
-        uint32_t k;
-        for(k = 0; k < SEARCH_CLASSES; k++) {
-            if(classes[k].count[level] == 0) {
-                classes[k].dur[level] = dur;
-                classes[k].count[level] = 1;
-                break; /* Sample accepted. */
-            } else {
-                uint32_t classavg = classes[k].dur[level];
-                uint32_t count = classes[k].count[level];
-                uint32_t delta = duration_delta(dur, classavg);
-                /* Is the difference in duration between this signal and
-                 * the class we are inspecting less than a given percentage?
-                 * If so, accept this signal. */
-                if(delta < classavg / 5) { /* 100%/5 = 20%. */
-                    /* It is useful to compute the average of the class
-                     * we are observing. We know how many samples we got so
-                     * far, so we can recompute the average easily.
-                     * By always having a better estimate of the pulse len
-                     * we can avoid missing next samples in case the first
-                     * observed samples are too off. */
-                    classavg = ((classavg * count) + dur) / (count + 1);
-                    classes[k].dur[level] = classavg;
-                    classes[k].count[level]++;
-                    break; /* Sample accepted. */
-                }
-            }
-        }
-
-        if(k == SEARCH_CLASSES) break; /* No match, return. */
-
-        /* If we are here, we accepted this sample. Try with the next
-         * one. */
+        if(!pulse_classes_add(classes, level, dur, min_duration)) break;
         len++;
     }
 
     /* Update the buffer setting the shortest pulse we found
-     * among the three classes. This will be used when scaling
-     * for visualization. */
-    uint32_t short_dur[2] = {0, 0};
-    for(int j = 0; j < SEARCH_CLASSES; j++) {
-        for(int level = 0; level < 2; level++) {
-            if(classes[j].dur[level] == 0) continue;
-            if(classes[j].count[level] < 3) continue;
-            if(short_dur[level] == 0 || short_dur[level] > classes[j].dur[level]) {
-                short_dur[level] = classes[j].dur[level];
-            }
-        }
-    }
-
-    /* Use the average between high and low short pulses duration.
-     * Often they are a bit different, and using the average is more robust
-     * when we do decoding sampling at short_pulse_dur intervals. */
-    if(short_dur[0] == 0) short_dur[0] = short_dur[1];
-    if(short_dur[1] == 0) short_dur[1] = short_dur[0];
-    s->short_pulse_dur = (short_dur[0] + short_dur[1]) / 2;
-
+     * among the three classes. */
+    s->short_pulse_dur = pulse_classes_short_dur(classes);
     return len;
 }
 
@@ -180,75 +185,210 @@ void notify_signal_detected(ProtoViewApp* app, bool decoded) {
         notification_message(app->notification, &unknown_seq);
 }
 
+/* Min run of coherent samples. With less than a few samples it's very
+ * easy to mistake noise for signal. */
+#define SEARCH_MIN_RUN 18
+
+/* Attempt to decode the coherent run of 'len' samples starting at index
+ * 'i' of the buffer 'copy', that must be a buffer nobody is writing to.
+ * The copy->short_pulse_dur field must be already set to the short
+ * pulse duration of the run. If the signal is better than the one we
+ * have, it is set in DetectedSamples global signal buffer, that is
+ * what is rendered on the screen. */
+static void consider_signal(ProtoViewApp* app, RawSamplesBuffer* copy, uint32_t i, uint32_t len) {
+    /* Allocate the message information that some decoder may
+     * fill, in case it is able to decode a message. */
+    ProtoViewMsgInfo* info = malloc(sizeof(ProtoViewMsgInfo));
+    init_msg_info(info, app);
+    info->short_pulse_dur = copy->short_pulse_dur;
+
+    uint32_t saved_idx = copy->idx; /* Save index, see later. */
+
+    /* decode_signal() expects the detected signal to start
+     * from index zero .*/
+    raw_samples_center(copy, i);
+    bool decoded = decode_signal(copy, len, info);
+    copy->idx = saved_idx; /* Restore the index as the caller may be
+                              scanning the signal in a loop. */
+
+    /* Accept this signal as the new signal if either it's longer
+     * than the previous undecoded one, or the previous one was
+     * unknown and this is decoded. */
+    bool oldsignal_not_decoded = app->signal_decoded == false ||
+                                 app->msg_info->decoder == &UnknownDecoder;
+
+    if(oldsignal_not_decoded &&
+       (len > app->signal_bestlen || (decoded && info->decoder != &UnknownDecoder))) {
+        free_msg_info(app->msg_info);
+        app->msg_info = info;
+        app->signal_bestlen = len;
+        app->signal_decoded = decoded;
+        raw_samples_copy(DetectedSamples, copy);
+        raw_samples_center(DetectedSamples, i);
+        FURI_LOG_E(
+            TAG,
+            "===> Displayed sample updated (%d samples %lu us)",
+            (int)len,
+            DetectedSamples->short_pulse_dur);
+
+        adjust_raw_view_scale(app, DetectedSamples->short_pulse_dur);
+        if(app->msg_info->decoder != &UnknownDecoder) notify_signal_detected(app, decoded);
+    } else {
+        /* If the structure was not filled, discard it. Otherwise
+         * now the owner is app->msg_info. */
+        free_msg_info(info);
+    }
+}
+
 /* Search the source buffer with the stored signal (last N samples received)
  * in order to find a coherent signal. If a signal that does not appear to
  * be just noise is found, it is set in DetectedSamples global signal
- * buffer, that is what is rendered on the screen. */
+ * buffer, that is what is rendered on the screen.
+ *
+ * This scans the whole buffer from scratch: it is used for buffers
+ * that are filled in one go, like the ones created by the message
+ * builder. Live data is scanned by scan_for_new_samples(). */
 void scan_for_signal(ProtoViewApp* app, RawSamplesBuffer* source, uint32_t min_duration) {
     /* We need to work on a copy: the source buffer may be populated
      * by the background thread receiving data. */
-    RawSamplesBuffer* copy = raw_samples_alloc();
+    PROFILE_BEGIN(scan_for_signal);
+    RawSamplesBuffer* copy = raw_samples_alloc_size(source->total);
     raw_samples_copy(copy, source);
 
     /* Try to seek on data that looks to have a regular high low high low
      * pattern. */
-    uint32_t minlen = 18; /* Min run of coherent samples. With less
-                                       than a few samples it's very easy to
-                                       mistake noise for signal. */
-
     uint32_t i = 0;
 
     while(i < copy->total - 1) {
         uint32_t thislen = search_coherent_signal(copy, i, min_duration);
 
         /* For messages that are long enough, attempt decoding. */
-        if(thislen > minlen) {
-            /* Allocate the message information that some decoder may
-             * fill, in case it is able to decode a message. */
-            ProtoViewMsgInfo* info = malloc(sizeof(ProtoViewMsgInfo));
-            init_msg_info(info, app);
-            info->short_pulse_dur = copy->short_pulse_dur;
-
-            uint32_t saved_idx = copy->idx; /* Save index, see later. */
-
-            /* decode_signal() expects the detected signal to start
-             * from index zero .*/
-            raw_samples_center(copy, i);
-            bool decoded = decode_signal(copy, thislen, info);
-            copy->idx = saved_idx; /* Restore the index as we are scanning
-                                      the signal in the loop. */
-
-            /* Accept this signal as the new signal if either it's longer
-             * than the previous undecoded one, or the previous one was
-             * unknown and this is decoded. */
-            bool oldsignal_not_decoded = app->signal_decoded == false ||
-                                         app->msg_info->decoder == &UnknownDecoder;
-
-            if(oldsignal_not_decoded &&
-               (thislen > app->signal_bestlen || (decoded && info->decoder != &UnknownDecoder))) {
-                free_msg_info(app->msg_info);
-                app->msg_info = info;
-                app->signal_bestlen = thislen;
-                app->signal_decoded = decoded;
-                raw_samples_copy(DetectedSamples, copy);
-                raw_samples_center(DetectedSamples, i);
-                FURI_LOG_E(
-                    TAG,
-                    "===> Displayed sample updated (%d samples %lu us)",
-                    (int)thislen,
-                    DetectedSamples->short_pulse_dur);
-
-                adjust_raw_view_scale(app, DetectedSamples->short_pulse_dur);
-                if(app->msg_info->decoder != &UnknownDecoder) notify_signal_detected(app, decoded);
-            } else {
-                /* If the structure was not filled, discard it. Otherwise
-                 * now the owner is app->msg_info. */
-                free_msg_info(info);
-            }
-        }
+        if(thislen > SEARCH_MIN_RUN) consider_signal(app, copy, i, thislen);
         i += thislen ? thislen : 1;
     }
     raw_samples_free(copy);
+    PROFILE_END(scan_for_signal);
+}
+
+/* =============================================================================
+ * Incremental scanning
+ *
+ * The live RawSamples buffer is scanned by feeding each new sample, exactly
+ * once, to the current run of coherent pulses. When a sample does not fit
+ * the run, the run ends: if it is long enough it becomes pending, and it is
+ * decoded as soon as a few trailing samples arrived (decoders look at some
+ * samples after the end of the signal). Only then we take a snapshot of
+ * the buffer, so the memcpy is paid just for candidate signals.
+ * ===========================================================================*/
+
+/* Number of samples received after the end of a run before decoding it.
+ * Matches the 'after_samples' that decode_signal() passes to the
+ * decoders. */
+#define SCAN_TRAILING_SAMPLES 100
+
+/* Samples preceding the run that decode_signal() looks at: the run must
+ * start at least this number of samples after the oldest one still in the
+ * buffer, otherwise we can't decode it. */
+#define SCAN_LEADING_SAMPLES 32
+
+/* Runs longer than this are split: the run must fit the buffer of 'total'
+ * samples together with its leading and trailing samples. */
+#define SCAN_MAX_RUN(total) ((total) - SCAN_LEADING_SAMPLES - SCAN_TRAILING_SAMPLES * 2)
+
+/* Reset the incremental scanner so that the next sample to examine is
+ * the one at absolute index 'pos'. */
+void scan_state_reset(ProtoViewScanState* st, uint32_t pos) {
+    memset(st, 0, sizeof(*st));
+    st->pos = pos;
+    st->run_start = pos;
+}
+
+/* Decode the pending run, if any. The snapshot of the source buffer is
+ * taken only the first time it is needed in a given scan, since later
+ * runs are included in it as well. Returns the (possibly just allocated)
+ * snapshot. */
+static RawSamplesBuffer* scan_flush_pending(
+    ProtoViewApp* app,
+    RawSamplesBuffer* source,
+    RawSamplesBuffer* copy,
+    uint32_t* copy_end) {
+    ProtoViewScanState* st = &app->scan;
+    if(st->pending_len == 0) return copy;
+
+    if(copy == NULL) {
+        copy = raw_samples_alloc_size(source->total);
+        *copy_end = raw_samples_copy(copy, source);
+    }
+
+    /* Index of the run start inside the snapshot, where index zero is the
+     * sample written as 'copy_end - total'. If the run is too old, the
+     * producer already overwrote it: drop it. */
+    uint32_t offset = st->pending_start + source->total - *copy_end;
+    if(offset >= SCAN_LEADING_SAMPLES && offset < source->total) {
+        copy->short_pulse_dur = st->pending_short_dur;
+        consider_signal(app, copy, offset, st->pending_len);
+    }
+    st->pending_len = 0;
+    return copy;
+}
+
+/* End the current run at the absolute index 'pos' (excluded), setting it
+ * as the pending run if it is long enough. */
+static void scan_end_run(ProtoViewScanState* st, uint32_t pos) {
+    if(st->run_len > SEARCH_MIN_RUN) {
+        st->pending_start = st->run_start;
+        st->pending_len = st->run_len;
+        st->pending_short_dur = pulse_classes_short_dur(st->classes);
+        st->pending_wait = SCAN_TRAILING_SAMPLES;
+    }
+    memset(st->classes, 0, sizeof(st->classes));
+    st->run_start = pos;
+    st->run_len = 0;
+}
+
+/* Examine the samples arrived in 'source' since the last call, see the
+ * top comment of this section. */
+void scan_for_new_samples(ProtoViewApp* app, RawSamplesBuffer* source, uint32_t min_duration) {
+    PROFILE_BEGIN(scan_new_samples);
+    ProtoViewScanState* st = &app->scan;
+    RawSamplesBuffer* copy = NULL;
+    uint32_t copy_end = 0;
+    uint32_t end = raw_samples_write_idx(source);
+
+    /* If we are so late that the producer wrapped around, the samples
+     * we did not see are lost: restart from the most recent half. */
+    if(end - st->pos > source->total) scan_state_reset(st, end - source->total / 2);
+
+    /* The signal ended and nothing else is arriving: no reason to wait
+     * for the trailing samples. */
+    if(st->pos == end) copy = scan_flush_pending(app, source, copy, &copy_end);
+
+    while(st->pos != end) {
+        uint32_t idx = st->pos & source->mask;
+        bool level = source->samples[idx].level;
+        uint32_t dur = source->samples[idx].dur;
+
+        if(st->pending_len && --st->pending_wait == 0)
+            copy = scan_flush_pending(app, source, copy, &copy_end);
+
+        if(st->run_len == SCAN_MAX_RUN(source->total) ||
+           !pulse_classes_add(st->classes, level, dur, min_duration)) {
+            /* Recycle the sample as the first of a new run, like the full
+             * scan does, but a pending run must be decoded first. */
+            if(st->run_len > SEARCH_MIN_RUN)
+                copy = scan_flush_pending(app, source, copy, &copy_end);
+            scan_end_run(st, st->pos);
+            if(pulse_classes_add(st->classes, level, dur, min_duration))
+                st->run_len = 1;
+            else
+                st->run_start = st->pos + 1;
+        } else {
+            st->run_len++;
+        }
+        st->pos++;
+    }
+    if(copy) raw_samples_free(copy);
+    PROFILE_END(scan_new_samples);
 }
 
 /* =============================================================================
@@ -286,6 +426,51 @@ bool bitmap_get(uint8_t* b, uint32_t blen, uint32_t bitpos) {
     return (b[byte] & (1 << bit)) != 0;
 }
 
+/* Return the mask with the 'count' less significant bits set, for
+ * count from 0 to 32. */
+static inline uint32_t bitmap_low_mask(uint32_t count) {
+    return count >= 32 ? UINT32_MAX : (1UL << count) - 1;
+}
+
+/* Load the 5 bytes starting at 'byte' as a 40 bits integer, with
+ * out of range bytes reading as zero. Any 32 bits window starting inside
+ * the first byte is contained in the result. */
+static inline uint64_t bitmap_load40(uint8_t* b, uint32_t blen, uint32_t byte) {
+    uint64_t acc = 0;
+    if(byte + 5 <= blen) {
+        for(int j = 0; j < 5; j++) acc = (acc << 8) | b[byte + j];
+    } else {
+        for(uint32_t j = byte; j < byte + 5; j++) acc = (acc << 8) | (j < blen ? b[j] : 0);
+    }
+    return acc;
+}
+
+/* Get 'count' bits (from 1 to 32) starting at 'bitpos', as an integer
+ * where the first bit of the bitmap is the most significant of the
+ * returned value. Out of range bits read as zero, like in bitmap_get(). */
+uint32_t bitmap_get_bits(uint8_t* b, uint32_t blen, uint32_t bitpos, uint32_t count) {
+    uint64_t acc = bitmap_load40(b, blen, bitpos / 8);
+    return (acc >> (40 - (bitpos & 7) - count)) & bitmap_low_mask(count);
+}
+
+/* Set 'count' bits (from 1 to 32) starting at 'bitpos' to the 'count'
+ * less significant bits of 'val', most significant first. This is the
+ * reverse of bitmap_get_bits(). Out of range bits are discarded. */
+void bitmap_set_bits(uint8_t* b, uint32_t blen, uint32_t bitpos, uint32_t val, uint32_t count) {
+    while(count) {
+        uint32_t byte = bitpos / 8;
+        uint32_t skew = bitpos & 7;
+        uint32_t n = 8 - skew; /* Bits we can set in this byte. */
+        if(n > count) n = count;
+        uint32_t shift = 8 - skew - n;
+        uint8_t mask = bitmap_low_mask(n) << shift;
+        uint8_t bits = ((val >> (count - n)) & bitmap_low_mask(n)) << shift;
+        if(byte < blen) b[byte] = (b[byte] & ~mask) | bits;
+        bitpos += n;
+        count -= n;
+    }
+}
+
 /* Copy 'count' bits from the bitmap 's' of 'slen' total bytes, to the
  * bitmap 'd' of 'dlen' total bytes. The bits are copied starting from
  * offset 'soff' of the source bitmap to the offset 'doff' of the
@@ -313,29 +498,8 @@ void bitmap_copy(
          * of the loop will be < 8. */
     }
 
-    /* Copy the bits needed to reach an offset where we can copy
-     * two half bytes of src to a full byte of destination. */
-    while(count > 8 && (doff & 7) != 0) {
-        bool bit = bitmap_get(s, slen, soff++);
-        bitmap_set(d, dlen, doff++, bit);
-        count--;
-    }
-
-    /* If we are here and count > 8, we have an offset that is byte aligned
-     * to the destination bitmap, but not aligned to the source bitmap.
-     * We can copy fast enough by shifting each two bytes of the original
-     * bitmap.
-     *
-     * This is how it works:
-     *
-     *  dst:
-     *  +--------+--------+--------+
-     *  | 0      | 1      | 2      |
-     *  |        |        |        | <- data to fill
-     *  +--------+--------+--------+
-     *            ^
-     *            |
-     *            doff = 8
+    /* Otherwise move 32 bits at a time: bitmap_get_bits() does the
+     * shifting needed to realign the source to the destination, as in:
      *
      *  src:
      *  +--------+--------+--------+
@@ -346,40 +510,13 @@ void bitmap_copy(
      *               |
      *               soff = 11
      *
-     *  skew = 11%8 = 3
-     *  each destination byte in dst will receive:
-     *
-     *  dst[doff/8] = (src[soff/8] << skew) | (src[soff/8+1] >> (8-skew))
-     *
-     *  dstbyte = doff/8 = 8/8 = 1
-     *  srcbyte = soff/8 = 11/8 = 1
-     *
-     *  so dst[1] will get:
-     *  src[1] << 3, that is "ld!HELLO" << 3 = "HELLO..."
-     *      xored with
-     *  src[2] << 5, that is "WORLDS!!" >> 5 = ".....WOR"
-     *  That is "HELLOWOR"
-     */
-    if(count > 8) {
-        uint8_t skew = soff % 8; /* Don't worry, compiler will optimize. */
-        uint32_t didx = doff / 8;
-        uint32_t sidx = soff / 8;
-        while(count > 8 && didx < dlen && sidx < slen) {
-            d[didx] = ((s[sidx] << skew) | (s[sidx + 1] >> (8 - skew)));
-            sidx++;
-            didx++;
-            soff += 8;
-            doff += 8;
-            count -= 8;
-        }
-    }
-
-    /* Here count is guaranteed to be < 8.
-     * Copy the final bits bit by bit. */
+     *  (src[1] << 3) | (src[2] >> 5) = "HELLOWOR", and so forth. */
     while(count) {
-        bool bit = bitmap_get(s, slen, soff++);
-        bitmap_set(d, dlen, doff++, bit);
-        count--;
+        uint32_t n = count > 32 ? 32 : count;
+        bitmap_set_bits(d, dlen, doff, bitmap_get_bits(s, slen, soff, n), n);
+        soff += n;
+        doff += n;
+        count -= n;
     }
 }
 
@@ -399,10 +536,67 @@ void bitmap_reverse_bytes_bits(uint8_t* p, uint32_t len) {
     }
 }
 
+/* Compile a sequence of bits, provided as a string in the form
+ * "11010110...", into a BitmapPattern, that is the same bits packed into
+ * 32 bit words, as returned by bitmap_get_bits(): word 'k' holds the bits
+ * from k*32 to k*32+31, the last word only the remaining bits.
+ * Returns false if the pattern is longer than BITMAP_PATTERN_MAX_BITS. */
+bool bitmap_pattern_compile(BitmapPattern* p, const char* bits) {
+    memset(p, 0, sizeof(*p));
+    for(; bits[p->len]; p->len++) {
+        if(p->len == BITMAP_PATTERN_MAX_BITS) return false;
+        uint32_t* w = p->words + p->len / 32;
+        *w = (*w << 1) | (bits[p->len] == '1');
+    }
+    return true;
+}
+
+/* Like bitmap_match_bits() but with a compiled pattern: matches up to 32
+ * bits per step. */
+bool bitmap_match_pattern(uint8_t* b, uint32_t blen, uint32_t bitpos, const BitmapPattern* p) {
+    for(uint32_t off = 0; off < p->len; off += 32) {
+        uint32_t n = p->len - off > 32 ? 32 : p->len - off;
+        if(bitmap_get_bits(b, blen, bitpos + off, n) != p->words[off / 32]) return false;
+    }
+    return true;
+}
+
+/* Like bitmap_seek_bits() but with a compiled pattern. For each byte of
+ * the bitmap we load a single 40 bits window, and test the first word of
+ * the pattern at all the 8 bit offsets inside it with a shift and a
+ * compare. Only when the first word matches we check the rest. */
+uint32_t bitmap_seek_pattern(
+    uint8_t* b,
+    uint32_t blen,
+    uint32_t startpos,
+    uint32_t maxbits,
+    const BitmapPattern* p) {
+    uint32_t endpos = startpos + blen * 8;
+    uint32_t end2 = startpos + maxbits;
+    if(end2 < endpos) endpos = end2;
+    if(p->len == 0) return startpos < endpos ? startpos : BITMAP_SEEK_NOT_FOUND;
+
+    uint32_t head = p->len > 32 ? 32 : p->len;
+    uint32_t mask = bitmap_low_mask(head);
+    uint32_t j = startpos;
+    while(j < endpos) {
+        uint64_t acc = bitmap_load40(b, blen, j / 8);
+        for(uint32_t skew = j & 7; skew < 8 && j < endpos; skew++, j++) {
+            if(((acc >> (40 - skew - head)) & mask) != p->words[0]) continue;
+            if(p->len <= 32 || bitmap_match_pattern(b, blen, j, p)) return j;
+        }
+    }
+    return BITMAP_SEEK_NOT_FOUND;
+}
+
 /* Return true if the specified sequence of bits, provided as a string in the
  * form "11010110..." is found in the 'b' bitmap of 'blen' bits at 'bitpos'
  * position. */
 bool bitmap_match_bits(uint8_t* b, uint32_t blen, uint32_t bitpos, const char* bits) {
+    BitmapPattern p;
+    if(bitmap_pattern_compile(&p, bits)) return bitmap_match_pattern(b, blen, bitpos, &p);
+
+    /* Pattern too long to be compiled, check it bit by bit. */
     for(size_t j = 0; bits[j]; j++) {
         bool expected = (bits[j] == '1') ? true : false;
         if(bitmap_get(b, blen, bitpos + j) != expected) return false;
@@ -415,15 +609,18 @@ bool bitmap_match_bits(uint8_t* b, uint32_t blen, uint32_t bitpos, const char* b
  * Returns the offset (in bits) of the match, or BITMAP_SEEK_NOT_FOUND if not
  * found.
  *
- * Note: there are better algorithms, such as Boyer-Moore. Here we hope that
- * for the kind of patterns we search we'll have a lot of early stops so
- * we use a vanilla approach. */
+ * The pattern is compiled and searched with bitmap_seek_pattern(): decoders
+ * seeking the same pattern many times should compile it just once and call
+ * it directly. */
 uint32_t bitmap_seek_bits(
     uint8_t* b,
     uint32_t blen,
     uint32_t startpos,
     uint32_t maxbits,
     const char* bits) {
+    BitmapPattern p;
+    if(bitmap_pattern_compile(&p, bits)) return bitmap_seek_pattern(b, blen, startpos, maxbits, &p);
+
     uint32_t endpos = startpos + blen * 8;
     uint32_t end2 = startpos + maxbits;
     if(end2 < endpos) endpos = end2;
@@ -434,7 +631,8 @@ uint32_t bitmap_seek_bits(
 
 /* Compare bitmaps b1 and b2 (possibly overlapping or the same bitmap),
  * at the specified offsets, for cmplen bits. Returns true if the
- * exact same bits are found, otherwise false. */
+ * exact same bits are found, otherwise false. Compares 32 bits at
+ * a time. */
 bool bitmap_match_bitmap(
     uint8_t* b1,
     uint32_t b1len,
@@ -443,10 +641,14 @@ bool bitmap_match_bitmap(
     uint32_t b2len,
     uint32_t b2off,
     uint32_t cmplen) {
-    for(uint32_t j = 0; j < cmplen; j++) {
-        bool bit1 = bitmap_get(b1, b1len, b1off + j);
-        bool bit2 = bitmap_get(b2, b2len, b2off + j);
-        if(bit1 != bit2) return false;
+    while(cmplen) {
+        uint32_t n = cmplen > 32 ? 32 : cmplen;
+        uint32_t bits1 = bitmap_get_bits(b1, b1len, b1off, n);
+        uint32_t bits2 = bitmap_get_bits(b2, b2len, b2off, n);
+        if(bits1 != bits2) return false;
+        b1off += n;
+        b2off += n;
+        cmplen -= n;
     }
     return true;
 }
@@ -556,15 +758,19 @@ uint32_t convert_from_line_code(
     const char* zero_pattern,
     const char* one_pattern) {
     uint32_t decoded = 0; /* Number of bits extracted. */
+    BitmapPattern zero, one;
+    if(!bitmap_pattern_compile(&zero, zero_pattern) ||
+       !bitmap_pattern_compile(&one, one_pattern))
+        return 0;
     len *= 8; /* Convert bytes to bits. */
     while(off < len) {
         bool bitval;
-        if(bitmap_match_bits(bits, len, off, zero_pattern)) {
+        if(bitmap_match_pattern(bits, len, off, &zero)) {
             bitval = false;
-            off += strlen(zero_pattern);
-        } else if(bitmap_match_bits(bits, len, off, one_pattern)) {
+            off += zero.len;
+        } else if(bitmap_match_pattern(bits, len, off, &one)) {
             bitval = true;
-            off += strlen(one_pattern);
+            off += one.len;
         } else {
             break;
         }
@@ -617,20 +823,105 @@ void init_msg_info(ProtoViewMsgInfo* i, ProtoViewApp* app) {
     i->fieldset = fieldset_new();
 }
 
+/* =============================================================================
+ * Decoders dispatch
+ *
+ * Most signals can't be decoded by most decoders, and calling all of them
+ * is the main CPU cost of scanning in busy environments. So before calling
+ * a decoder we check the cheap features it declares in its
+ * ProtoViewDecoder structure against the signal.
+ *
+ * For the preambles, we build an index of all the 8 bits windows (at any
+ * bit offset) present in the bitmap: a 256 bits set that is computed in a
+ * single pass. Every full byte of the preamble a decoder seeks must be
+ * present in the set, otherwise bitmap_seek_bits() can't find it.
+ * ===========================================================================*/
+
+typedef struct {
+    uint32_t windows[256 / 32]; /* Set of 8 bits windows present. */
+} BitmapWindowsIndex;
+
+/* Populate the index with the windows of the first 'numbytes' bytes of
+ * the bitmap 'b'. */
+static void bitmap_windows_index(BitmapWindowsIndex* idx, uint8_t* b, uint32_t numbytes) {
+    memset(idx, 0, sizeof(*idx));
+    if(numbytes == 0) return;
+
+    idx->windows[b[0] >> 5] |= 1UL << (b[0] & 31);
+    uint32_t acc = b[0];
+    for(uint32_t j = 1; j < numbytes; j++) {
+        acc = (acc << 8) | b[j];
+        for(int shift = 7; shift >= 0; shift--) {
+            uint8_t w = acc >> shift;
+            idx->windows[w >> 5] |= 1UL << (w & 31);
+        }
+    }
+}
+
+/* Return true if every full byte of the pattern (in the "0101..." string
+ * format) is present in the index. */
+static bool bitmap_windows_match(BitmapWindowsIndex* idx, const char* pat) {
+    uint32_t w = 0, len = 0;
+    for(; *pat; pat++) {
+        w = (w << 1) | (*pat == '1');
+        if(++len % 8 == 0) {
+            w &= 0xff;
+            if(!(idx->windows[w >> 5] & (1UL << (w & 31)))) return false;
+        }
+    }
+    return true;
+}
+
+/* Return true if, according to its declared features, the decoder 'd'
+ * may be able to decode the signal. */
+static bool decoder_is_plausible(
+    ProtoViewDecoder* d,
+    BitmapWindowsIndex* idx,
+    uint32_t numbits,
+    uint32_t short_pulse_dur) {
+    if(numbits < d->min_bits) return false;
+    if(d->short_pulse_min && short_pulse_dur < d->short_pulse_min) return false;
+    if(d->short_pulse_max && short_pulse_dur > d->short_pulse_max) return false;
+    if(d->preambles == NULL) return true;
+    for(int j = 0; d->preambles[j]; j++)
+        if(bitmap_windows_match(idx, d->preambles[j])) return true;
+    return false;
+}
+
+/* The bitmap the signal is converted to before decoding. It is large,
+ * and we need it for every candidate signal, so instead of allocating it
+ * each time we reuse a static arena. In the unlikely case decode_signal()
+ * is called concurrently (the app timer and the message builder), the
+ * second caller allocates its own. */
+#define DECODE_BITMAP_SIZE 4096
+static uint8_t DecodeBitmap[DECODE_BITMAP_SIZE];
+static uint32_t DecodeBitmapUsed; /* Bytes written by the last user. */
+static bool DecodeBitmapBusy;
+
 /* This function is called when a new signal is detected. It converts it
  * to a bitstream, and the calls the protocol specific functions for
  * decoding. If the signal was decoded correctly by some protocol, true
  * is returned. Otherwise false is returned. */
 bool decode_signal(RawSamplesBuffer* s, uint64_t len, ProtoViewMsgInfo* info) {
-    uint32_t bitmap_bits_size = 4096 * 8;
-    uint32_t bitmap_size = bitmap_bits_size / 8;
+    uint32_t bitmap_size = DECODE_BITMAP_SIZE;
 
     /* We call the decoders with an offset a few samples before the actual
      * signal detected and for a len of a few bits after its end. */
     uint32_t before_samples = 32;
     uint32_t after_samples = 100;
 
-    uint8_t* bitmap = malloc(bitmap_size);
+    /* Grab the arena, clearing what the previous signal left there, so
+     * that bits after the end of this signal are zero. */
+    uint8_t* bitmap;
+    bool arena = !__atomic_exchange_n(&DecodeBitmapBusy, true, __ATOMIC_ACQUIRE);
+    if(arena) {
+        bitmap = DecodeBitmap;
+        memset(bitmap, 0, DecodeBitmapUsed);
+    } else {
+        bitmap = malloc(bitmap_size);
+        memset(bitmap, 0, bitmap_size);
+    }
+
     uint32_t bits = convert_signal_to_bits(
         bitmap,
         bitmap_size,
@@ -639,6 +930,11 @@ bool decode_signal(RawSamplesBuffer* s, uint64_t len, ProtoViewMsgInfo* info) {
         len + before_samples + after_samples,
         s->short_pulse_dur);
 
+    /* Decoders may match patterns crossing the end of the signal, so
+     * index a few bytes more: they are zero anyway. */
+    uint32_t used_bytes = (bits + 7) / 8 + 8;
+    if(used_bytes > bitmap_size) used_bytes = bitmap_size;
+
     if(DEBUG_MSG) { /* Useful for debugging purposes. Don't remove. */
         char* str = malloc(1024);
         uint32_t j;
@@ -650,24 +946,31 @@ bool decode_signal(RawSamplesBuffer* s, uint64_t len, ProtoViewMsgInfo* info) {
         free(str);
     }
 
-    /* Try all the decoders available. */
-    int j = 0;
+    /* Try all the plausible decoders. */
+    BitmapWindowsIndex idx;
+    bitmap_windows_index(&idx, bitmap, used_bytes);
 
+    int j = 0;
     bool decoded = false;
     while(Decoders[j]) {
-        uint32_t start_time = furi_get_tick();
-        decoded = Decoders[j]->decode(bitmap, bitmap_size, bits, info);
-        uint32_t delta = furi_get_tick() - start_time;
-        FURI_LOG_E(TAG, "Decoder %s took %lu ms", Decoders[j]->name, (unsigned long)delta);
-        if(decoded) {
-            info->decoder = Decoders[j];
-            break;
+        if(decoder_is_plausible(Decoders[j], &idx, bits, s->short_pulse_dur)) {
+            uint32_t start_time = furi_get_tick();
+            decoded = Decoders[j]->decode(bitmap, bitmap_size, bits, info);
+            uint32_t delta = furi_get_tick() - start_time;
+            if(DEBUG_MSG)
+                FURI_LOG_E(
+                    TAG, "Decoder %s took %lu ms", Decoders[j]->name, (unsigned long)delta);
+            UNUSED(delta);
+            if(decoded) {
+                info->decoder = Decoders[j];
+                break;
+            }
         }
         j++;
     }
 
     if(!decoded) {
-        FURI_LOG_E(TAG, "No decoding possible");
+        if(DEBUG_MSG) FURI_LOG_E(TAG, "No decoding possible");
     } else {
         FURI_LOG_E(TAG, "+++ Decoded %s", info->decoder->name);
         /* The message was correctly decoded: fill the info structure
@@ -687,6 +990,12 @@ bool decode_signal(RawSamplesBuffer* s, uint64_t len, ProtoViewMsgInfo* info) {
                 info->pulses_count);
         }
     }
-    free(bitmap);
+
+    if(arena) {
+        DecodeBitmapUsed = used_bytes;
+        __atomic_store_n(&DecodeBitmapBusy, false, __ATOMIC_RELEASE);
+    } else {
+        free(bitmap);
+    }
     return decoded;
 }
@@ -0,0 +1,353 @@
+/* Copyright (C) 2022-2023 Salvatore Sanfilippo -- All Rights Reserved
+ * See the LICENSE file for information about the license. */
+
+#include "app.h"
+
+/* =============================== TX sequencer ===============================
+ * Sends a sequence of messages built by a decoder build_message() method in
+ * a single transmission, so that for instance a TPMS frame can be replayed
+ * with an incrementing counter, or a range of IDs can be swept, without
+ * rebuilding and re-arming the radio for each message.
+ *
+ * The messages are rendered from a fieldset template: before each message
+ * the generators (see ProtoViewSeqGen in app.h) update the template fields
+ * they are attached to, in the order they were added, so a checksum
+ * generator added last sees the new values of the other fields. Increments
+ * and ranges start from the template value, so they leave the first
+ * message alone, while lists and checksums set every message.
+ *
+ * Rendering happens in a worker thread, since the TX feeder runs in
+ * interrupt context. There are two sample buffers: while the feeder sends
+ * one, the worker renders the next message into the other. When the feeder
+ * is done with a buffer it hands it back to the worker, and sends the gap
+ * between messages meanwhile. If the worker is late, the feeder keeps the
+ * radio idle sending short gaps until the next message is ready.
+ * ========================================================================== */
+
+#define TX_SEQ_SAMPLES 1024 /* Samples of each buffer, a power of two. */
+#define TX_SEQ_EDGE_GAP 10000 /* Microseconds before the first message and
+                                 after the last one, like single signals. */
+#define TX_SEQ_WAIT_GAP 1000 /* Microseconds of each gap sent while waiting
+                                for the worker. */
+#define TX_SEQ_CHECKSUM_MAX 64 /* Bytes a checksum can cover. */
+
+typedef enum {
+    TxSeqFlagRender = (1 << 0), /* A buffer was sent and can be reused. */
+    TxSeqFlagStop = (1 << 1), /* Transmission over, exit. */
+} TxSeqFlags;
+
+typedef enum {
+    TxSeqStateStartGap,
+    TxSeqStateSamples,
+    TxSeqStateGap,
+    TxSeqStateEndGap,
+    TxSeqStateDone,
+} TxSeqState;
+
+struct ProtoViewTxSequencer {
+    ProtoViewDecoder* decoder;
+    ProtoViewFieldSet* fields; /* The template, advanced in place. */
+    ProtoViewSeqGen* gens;
+    uint32_t numgens;
+    uint32_t count; /* Messages to send. */
+    uint32_t gap_us; /* Gap between messages. */
+    FuriThread* thread;
+    RawSamplesBuffer* buf[2];
+    uint32_t len[2]; /* Samples of the message in each buffer. */
+    /* Set by the worker once a buffer holds the next message to send,
+     * cleared by the feeder once it was sent. */
+    bool ready[2];
+    /* Worker side. */
+    uint32_t rendered; /* Messages rendered so far. */
+    uint32_t next; /* Buffer the next message is rendered into. */
+    /* Feeder side. */
+    TxSeqState state;
+    uint32_t cur; /* Buffer being sent. */
+    uint32_t pos; /* Next sample to send. */
+    uint32_t sent; /* Messages sent. */
+    uint32_t waits; /* Gaps sent waiting for the worker. */
+};
+
+/* ============================ Field access ================================ */
+
+/* Return the value of an integer like field. Bytes fields are taken as a
+ * big endian number, only their last 8 bytes count. */
+static int64_t seq_field_get(ProtoViewField* f) {
+    switch(f->type) {
+    case FieldTypeSignedInt:
+        return f->value;
+    case FieldTypeFloat:
+        return (int64_t)f->fvalue;
+    case FieldTypeBytes: {
+        uint64_t v = 0;
+        for(uint32_t j = 0; j < (f->len + 1) / 2; j++) v = (v << 8) | f->bytes[j];
+        return v;
+    }
+    case FieldTypeStr:
+        return 0;
+    default:
+        return f->uvalue;
+    }
+}
+
+/* Set the value of an integer like field, wrapping around at its width
+ * like field_incr_value() does. */
+static void seq_field_set(ProtoViewField* f, int64_t v) {
+    switch(f->type) {
+    case FieldTypeSignedInt: {
+        /* Sign extend the low 'len' bits. */
+        uint32_t shift = 64 - f->len;
+        f->value = (int64_t)((uint64_t)v << shift) >> shift;
+        break;
+    }
+    case FieldTypeFloat:
+        f->fvalue = v;
+        break;
+    case FieldTypeBytes:
+        for(int32_t j = (f->len + 1) / 2 - 1; j >= 0; j--) {
+            f->bytes[j] = v & 0xff;
+            v = (uint64_t)v >> 8;
+        }
+        break;
+    case FieldTypeStr:
+        break;
+    default:
+        f->uvalue = f->len < 64 ? (uint64_t)v & ((1ULL << f->len) - 1) : (uint64_t)v;
+        break;
+    }
+}
+
+/* Append the field to 'buf' as a checksum sees it: integers big endian in
+ * as many bytes as their bits need, bytes and strings as they are.
+ * Returns the new length, never more than 'size'. */
+static uint32_t seq_field_serialize(ProtoViewField* f, uint8_t* buf, uint32_t len, uint32_t size) {
+    uint32_t n;
+    const uint8_t* src = NULL;
+    uint8_t tmp[8];
+
+    switch(f->type) {
+    case FieldTypeBytes:
+        n = (f->len + 1) / 2;
+        src = f->bytes;
+        break;
+    case FieldTypeStr:
+        n = f->len;
+        src = (uint8_t*)f->str;
+        break;
+    case FieldTypeFloat:
+        return len; /* No obvious byte representation. */
+    default: {
+        uint64_t v = seq_field_get(f);
+        n = (f->len + 7) / 8;
+        if(n > sizeof(tmp)) n = sizeof(tmp);
+        for(int32_t j = n - 1; j >= 0; j--) {
+            tmp[j] = v & 0xff;
+            v >>= 8;
+        }
+        src = tmp;
+        break;
+    }
+    }
+
+    if(n > size - len) n = size - len;
+    memcpy(buf + len, src, n);
+    return len + n;
+}
+
+/* ============================== Generators ================================ */
+
+/* Update the field of the generator 'g' for message number 'n'. */
+static void seq_gen_apply(ProtoViewTxSequencer* seq, ProtoViewSeqGen* g, uint32_t n) {
+    ProtoViewField* f = seq->fields->fields[g->field];
+
+    switch(g->type) {
+    case SeqGenIncrement:
+        if(n) seq_field_set(f, seq_field_get(f) + g->step);
+        break;
+    case SeqGenRange: {
+        if(n == 0) break;
+        int64_t v = seq_field_get(f) + g->step;
+        if(v > g->max || v < g->min) v = g->step >= 0 ? g->min : g->max;
+        seq_field_set(f, v);
+        break;
+    }
+    case SeqGenList:
+        if(g->list_len) seq_field_set(f, g->list[n % g->list_len]);
+        break;
+    case SeqGenChecksum: {
+        uint8_t data[TX_SEQ_CHECKSUM_MAX];
+        uint32_t len = 0;
+        for(uint32_t j = g->first; j <= g->last && j < seq->fields->numfields; j++)
+            len = seq_field_serialize(seq->fields->fields[j], data, len, sizeof(data));
+
+        uint8_t sum;
+        if(g->checksum == SeqChecksumCrc8)
+            sum = crc8(data, len, g->init, g->poly);
+        else if(g->checksum == SeqChecksumSum)
+            sum = sum_bytes(data, len, g->init);
+        else
+            sum = xor_bytes(data, len, g->init);
+        seq_field_set(f, sum);
+        break;
+    }
+    }
+}
+
+/* Render the next message of the sequence into the buffer 'half'. */
+static void seq_render(ProtoViewTxSequencer* seq, uint32_t half) {
+    for(uint32_t j = 0; j < seq->numgens; j++) seq_gen_apply(seq, &seq->gens[j], seq->rendered);
+
+    RawSamplesBuffer* buf = seq->buf[half];
+    raw_samples_reset(buf);
+    seq->decoder->build_message(buf, seq->fields);
+    seq->len[half] = buf->idx < buf->total ? buf->idx : buf->total;
+    seq->rendered++;
+    __atomic_store_n(&seq->ready[half], true, __ATOMIC_RELEASE);
+}
+
+/* Render messages into the free buffers, in the order the feeder will
+ * send them, until the sequence is fully rendered. */
+static void seq_render_free(ProtoViewTxSequencer* seq) {
+    while(seq->rendered < seq->count &&
+          !__atomic_load_n(&seq->ready[seq->next], __ATOMIC_ACQUIRE)) {
+        seq_render(seq, seq->next);
+        seq->next ^= 1;
+    }
+}
+
+static int32_t seq_worker(void* ctx) {
+    ProtoViewTxSequencer* seq = ctx;
+    while(1) {
+        uint32_t flags = furi_thread_flags_wait(
+            TxSeqFlagRender | TxSeqFlagStop, FuriFlagWaitAny, FuriWaitForever);
+        if(flags & FuriFlagError) continue;
+        if(flags & TxSeqFlagStop) break;
+        seq_render_free(seq);
+    }
+    return 0;
+}
+
+/* ================================= Feeder ================================= */
+
+/* Data feeder for radio_tx_signal(). Called in interrupt context, so it
+ * only reads the buffers the worker rendered and never blocks. */
+static LevelDuration seq_feed(void* ctx) {
+    ProtoViewTxSequencer* seq = ctx;
+
+    switch(seq->state) {
+    case TxSeqStateStartGap:
+        seq->state = TxSeqStateSamples;
+        return level_duration_make(0, TX_SEQ_EDGE_GAP);
+
+    case TxSeqStateGap:
+        seq->state = TxSeqStateSamples;
+        return level_duration_make(0, seq->gap_us);
+
+    case TxSeqStateSamples: {
+        uint32_t cur = seq->cur;
+        if(!__atomic_load_n(&seq->ready[cur], __ATOMIC_ACQUIRE)) {
+            seq->waits++;
+            return level_duration_make(0, TX_SEQ_WAIT_GAP);
+        }
+
+        RawSample* s = &seq->buf[cur]->samples[seq->pos++];
+        LevelDuration ld = level_duration_make(s->level, s->dur);
+        if(seq->pos >= seq->len[cur]) {
+            /* Message sent: give the buffer back to the worker. */
+            seq->pos = 0;
+            seq->sent++;
+            seq->cur ^= 1;
+            seq->state = seq->sent == seq->count ? TxSeqStateEndGap : TxSeqStateGap;
+            __atomic_store_n(&seq->ready[cur], false, __ATOMIC_RELEASE);
+            furi_thread_flags_set(furi_thread_get_id(seq->thread), TxSeqFlagRender);
+        }
+        return ld;
+    }
+
+    case TxSeqStateEndGap:
+        seq->state = TxSeqStateDone;
+        return level_duration_make(0, TX_SEQ_EDGE_GAP);
+
+    default:
+        return level_duration_reset();
+    }
+}
+
+/* ================================== API =================================== */
+
+/* Create a sequencer sending 'count' messages of 'decoder', built from the
+ * 'fields' template, with 'gap_us' microseconds between them. The template
+ * is not copied: it is advanced in place while sending, and must stay
+ * valid until the sequencer is freed. */
+ProtoViewTxSequencer* tx_sequencer_new(
+    ProtoViewDecoder* decoder,
+    ProtoViewFieldSet* fields,
+    uint32_t count,
+    uint32_t gap_us) {
+    ProtoViewTxSequencer* seq = malloc(sizeof(*seq));
+    memset(seq, 0, sizeof(*seq));
+    seq->decoder = decoder;
+    seq->fields = fields;
+    seq->count = count;
+    seq->gap_us = gap_us;
+    return seq;
+}
+
+void tx_sequencer_free(ProtoViewTxSequencer* seq) {
+    free(seq->gens);
+    free(seq);
+}
+
+/* Attach a generator to a field of the template. Returns false if the
+ * field does not exist. */
+bool tx_sequencer_add_gen(ProtoViewTxSequencer* seq, const ProtoViewSeqGen* gen) {
+    if(gen->field >= seq->fields->numfields) return false;
+    seq->numgens++;
+    seq->gens = realloc(seq->gens, sizeof(ProtoViewSeqGen) * seq->numgens);
+    seq->gens[seq->numgens - 1] = *gen;
+    return true;
+}
+
+/* Send the sequence, blocking until the last message was transmitted.
+ * Afterwards the template holds the fields of the message that would
+ * follow, so running the sequencer again continues the sequence.
+ * Returns false if nothing was sent. */
+bool tx_sequencer_run(ProtoViewApp* app, ProtoViewTxSequencer* seq) {
+    if(seq->decoder->build_message == NULL || seq->count == 0) return false;
+
+    seq->buf[0] = raw_samples_alloc_size(TX_SEQ_SAMPLES);
+    seq->buf[1] = raw_samples_alloc_size(TX_SEQ_SAMPLES);
+    seq->state = TxSeqStateStartGap;
+    seq->cur = seq->next = seq->pos = 0;
+    seq->rendered = seq->sent = seq->waits = 0;
+    seq->ready[0] = seq->ready[1] = false;
+
+    /* The first two messages are ready before the radio starts. */
+    seq_render_free(seq);
+    bool ok = seq->len[0] != 0;
+    if(ok) {
+        seq->thread = furi_thread_alloc_ex("ProtoViewTxSeq", 2048, seq_worker, seq);
+        furi_thread_start(seq->thread);
+        radio_tx_signal(app, seq_feed, seq);
+        furi_thread_flags_set(furi_thread_get_id(seq->thread), TxSeqFlagStop);
+        furi_thread_join(seq->thread);
+        furi_thread_free(seq->thread);
+        seq->thread = NULL;
+
+        /* Leave the template at the message after the last one sent. */
+        for(uint32_t j = 0; j < seq->numgens; j++)
+            seq_gen_apply(seq, &seq->gens[j], seq->rendered);
+        if(seq->waits)
+            FURI_LOG_E(TAG, "TX sequencer: waited %lu times", (unsigned long)seq->waits);
+    }
+
+    raw_samples_free(seq->buf[0]);
+    raw_samples_free(seq->buf[1]);
+    seq->buf[0] = seq->buf[1] = NULL;
+    return ok;
+}
+
+/* Return the number of messages sent by the last run. */
+uint32_t tx_sequencer_sent(ProtoViewTxSequencer* seq) {
+    return seq->sent;
+}
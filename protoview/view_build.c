@@ -7,6 +7,8 @@ extern ProtoViewDecoder* Decoders[]; // Defined in signal.c.
 
 /* Our view private data. */
 #define USER_VALUE_LEN 64
+#define SEQ_COUNT 10 /* Messages sent by a long press of down. */
+#define SEQ_GAP 100000 /* Microseconds between them. */
 typedef struct {
     ProtoViewDecoder* decoder; /* Decoder we are using to create a
                                        message. */
@@ -18,6 +20,8 @@ typedef struct {
                                        fields. */
     char* user_value; /* Keyboard input to replace the current
                                        field value goes here. */
+    uint32_t counters; /* Bitmap of the fields that go up by one at
+                                       every message of a sequence. */
 } BuildViewPrivData;
 
 /* Not all the decoders support message bulding, so we can't just
@@ -80,7 +84,13 @@ static void render_view_set_fields(Canvas* const canvas, ProtoViewApp* app) {
     canvas_set_color(canvas, ColorBlack);
     ProtoViewField* field = privdata->fieldset->fields[privdata->cur_field];
     snprintf(
-        buf, sizeof(buf), "%s %s:%d", field->name, field_get_type_name(field), (int)field->len);
+        buf,
+        sizeof(buf),
+        "%s %s:%d%s",
+        field->name,
+        field_get_type_name(field),
+        (int)field->len,
+        privdata->counters & (1 << privdata->cur_field) ? " +1" : "");
     buf[0] = toupper(buf[0]);
     canvas_set_font(canvas, FontPrimary);
     canvas_draw_str_aligned(canvas, 64, 30, AlignCenter, AlignCenter, buf);
@@ -168,6 +178,29 @@ static bool increment_current_field(ProtoViewApp* app, int incr) {
     return field_incr_value(f, incr);
 }
 
+/* Send SEQ_COUNT messages in a single transmission, the fields marked as
+ * counters going up by one at every message. Afterwards they hold the
+ * value of the message that would follow, so the next sequence continues
+ * the count. */
+static void send_sequence(ProtoViewApp* app) {
+    BuildViewPrivData* privdata = app->view_privdata;
+    ProtoViewFieldSet* fs = privdata->fieldset;
+    ProtoViewTxSequencer* seq = tx_sequencer_new(privdata->decoder, fs, SEQ_COUNT, SEQ_GAP);
+
+    for(uint32_t j = 0; j < fs->numfields && j < 32; j++) {
+        if(!(privdata->counters & (1 << j))) continue;
+        ProtoViewSeqGen gen = {.type = SeqGenIncrement, .field = j, .step = 1};
+        tx_sequencer_add_gen(seq, &gen);
+    }
+
+    bool sent = tx_sequencer_run(app, seq);
+    tx_sequencer_free(seq);
+    if(sent) {
+        notify_signal_sent(app);
+        ui_show_alert(app, "Sequence sent", 1500);
+    }
+}
+
 /* Handle input for fields editing mode. */
 static void process_input_set_fields(ProtoViewApp* app, InputEvent input) {
     BuildViewPrivData* privdata = app->view_privdata;
@@ -198,6 +231,14 @@ static void process_input_set_fields(ProtoViewApp* app, InputEvent input) {
     } else if(input.type == InputTypeRepeat && input.key == InputKeyLeft) {
         int times = 10;
         while(times--) increment_current_field(app, -1);
+    } else if(input.type == InputTypeLong && input.key == InputKeyUp) {
+        // Mark the field as a counter for sequences, or unmark it.
+        // Strings and floats can't be counted.
+        ProtoViewField* f = fs->fields[privdata->cur_field];
+        if(f->type != FieldTypeStr && f->type != FieldTypeFloat && privdata->cur_field < 32)
+            privdata->counters ^= 1 << privdata->cur_field;
+    } else if(input.type == InputTypeLong && input.key == InputKeyDown) {
+        if(privdata->decoder->build_message) send_sequence(app);
     } else if(input.type == InputTypeLong && input.key == InputKeyOk) {
         // Build the message in a fresh raw buffer.
         if(privdata->decoder->build_message) {
@@ -65,6 +65,78 @@ void render_view_raw_pulses(Canvas* const canvas, ProtoViewApp* app) {
         canvas_draw_str_with_border(
             canvas, 1, 61, app->msg_info->decoder->name, ColorWhite, ColorBlack);
     }
+
+    /* Show the long capture state, if any. */
+    if(app->capture) {
+        snprintf(buf, sizeof(buf), "REC %lu", (unsigned long)capture_get_count(app->capture));
+        canvas_set_font(canvas, FontSecondary);
+        canvas_draw_str_with_border(canvas, 1, 8, buf, ColorWhite, ColorBlack);
+    } else if(app->capture_reader) {
+        snprintf(
+            buf,
+            sizeof(buf),
+            "%lu/%lu",
+            (unsigned long)app->capture_page,
+            (unsigned long)capture_reader_count(app->capture_reader));
+        canvas_set_font(canvas, FontSecondary);
+        canvas_draw_str_with_border(canvas, 1, 8, buf, ColorWhite, ColorBlack);
+    }
+}
+
+/* Start or stop streaming the received samples to the capture file. */
+static void toggle_capture(ProtoViewApp* app) {
+    if(app->capture) {
+        capture_stop(app);
+        ui_show_alert(app, "Capture saved", 1000);
+        return;
+    }
+
+    /* We are going to overwrite the capture file: stop paging it. */
+    if(app->capture_reader) {
+        capture_reader_close(app->capture_reader);
+        app->capture_reader = NULL;
+    }
+    if(capture_start(app, PROTOVIEW_CAPTURE_PATH))
+        ui_show_alert(app, "Capturing to SD", 1000);
+    else
+        ui_show_alert(app, "Can't create file", 1000);
+}
+
+/* Load the next page of the capture file and scan it for signals, just
+ * like we do with the live samples. Successive pages overlap a bit, so
+ * that signals crossing a page boundary are seen entirely in one page. */
+#define CAPTURE_PAGE_OVERLAP 256
+static void load_next_capture_page(ProtoViewApp* app) {
+    if(app->capture) {
+        ui_show_alert(app, "Stop capture first", 1000);
+        return;
+    }
+
+    RawSamplesBuffer* page = raw_samples_alloc();
+    if(app->capture_reader == NULL) {
+        app->capture_reader = capture_reader_open(PROTOVIEW_CAPTURE_PATH);
+        app->capture_page = 0;
+        if(app->capture_reader == NULL) {
+            ui_show_alert(app, "No capture", 1000);
+            raw_samples_free(page);
+            return;
+        }
+    } else {
+        app->capture_page += page->total - CAPTURE_PAGE_OVERLAP;
+        if(app->capture_page >= capture_reader_count(app->capture_reader))
+            app->capture_page = 0;
+    }
+
+    if(capture_reader_load(app->capture_reader, page, app->capture_page)) {
+        /* Make sure the best signal of the page will be accepted as
+         * the current signal. */
+        app->signal_decoded = false;
+        app->signal_bestlen = 0;
+        scan_for_signal(app, page, ProtoViewModulations[app->modulation].duration_filter);
+    } else {
+        ui_show_alert(app, "Capture read error", 1000);
+    }
+    raw_samples_free(page);
 }
 
 /* Handle input for the raw pulses view. */
@@ -81,6 +153,12 @@ void process_input_raw_pulses(ProtoViewApp* app, InputEvent input) {
         if(input.key == InputKeyOk) {
             /* Reset the current sample to capture the next. */
             reset_current_signal(app);
+        } else if(input.key == InputKeyDown) {
+            /* Start/stop streaming samples to SD. */
+            toggle_capture(app);
+        } else if(input.key == InputKeyUp) {
+            /* Page the capture file. */
+            load_next_capture_page(app);
         }
     } else if(input.type == InputTypeShort) {
         if(input.key == InputKeyOk) {
@@ -112,8 +112,7 @@ void view_exit_settings(ProtoViewApp* app) {
             app->frequency,
             ProtoViewModulations[app->modulation].name);
         radio_rx_end(app);
-        radio_begin(app);
-        radio_rx(app);
+        radio_rx(app); /* Loads the new preset and frequency. */
         app->txrx->freq_mod_changed = false;
     }
 }
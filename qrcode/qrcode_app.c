@@ -13,6 +13,7 @@
 #define TAG "qrcode"
 #define QRCODE_FOLDER STORAGE_APP_DATA_PATH_PREFIX
 #define QRCODE_EXTENSION ".qrcode"
+#define QRCODE_EXPORT_EXTENSION ".pbm"
 #define QRCODE_FILETYPE "QRCode"
 #define QRCODE_FILE_VERSION 1
 
@@ -25,6 +26,20 @@
  */
 #define MAX_QRCODE_VERSION 11
 
+/**
+ * The qrcode is pre-rendered at its final pixel size into a square 1-bpp
+ * bitmap no larger than the screen height.
+ */
+#define QRCODE_BITMAP_DIM 64
+#define QRCODE_BITMAP_SIZE (QRCODE_BITMAP_DIM * QRCODE_BITMAP_DIM / 8)
+
+/**
+ * Exported images have pixels of this many modules, with the four module wide
+ * quiet zone readers need around the code.
+ */
+#define QRCODE_EXPORT_SCALE 4
+#define QRCODE_EXPORT_QUIET_ZONE 4
+
 /** Valid ECC levels are Low (0), Medium (1), Quartile (2), and High (3) */
 #define MAX_QRCODE_ECC 3
 
@@ -62,6 +77,8 @@ typedef struct {
     FuriMutex** mutex;
     FuriString* message;
     QRCode* qrcode;
+    uint8_t bitmap[QRCODE_BITMAP_SIZE];
+    uint8_t bitmap_dim;
     uint8_t min_mode;
     uint8_t max_mode;
     uint8_t min_version;
@@ -69,6 +86,7 @@ typedef struct {
     bool loading;
     bool too_long;
     bool show_stats;
+    bool exported;
     uint8_t selected_idx;
     bool edit;
     uint8_t set_mode;
@@ -180,25 +198,14 @@ static void render_callback(Canvas* canvas, void* ctx) {
         canvas_draw_str_aligned(
             canvas, width / 2, height / 2, AlignCenter, AlignCenter, "Loading...");
     } else if(instance->qrcode) {
-        uint8_t size = instance->qrcode->size;
-        uint8_t pixel_size = height / size;
-        uint8_t top = (height - pixel_size * size) / 2;
-        uint8_t left = ((instance->show_stats ? 65 : width) - pixel_size * size) / 2;
-        for(uint8_t y = 0; y < size; y++) {
-            for(uint8_t x = 0; x < size; x++) {
-                if(qrcode_getModule(instance->qrcode, x, y)) {
-                    if(pixel_size == 1) {
-                        canvas_draw_dot(canvas, left + x * pixel_size, top + y * pixel_size);
-                    } else {
-                        canvas_draw_box(
-                            canvas,
-                            left + x * pixel_size,
-                            top + y * pixel_size,
-                            pixel_size,
-                            pixel_size);
-                    }
-                }
-            }
+        uint8_t size = instance->bitmap_dim;
+        uint8_t top = (height - size) / 2;
+        uint8_t left = ((instance->show_stats ? 65 : width) - size) / 2;
+        canvas_draw_xbm(canvas, left, top, size, size, instance->bitmap);
+
+        if(instance->exported && !instance->show_stats) {
+            canvas_set_font(canvas, FontSecondary);
+            canvas_draw_str(canvas, 0, height - 1, "Saved");
         }
 
         if(instance->show_stats) {
@@ -380,6 +387,38 @@ static void qrcode_free(QRCode* qrcode) {
     free(qrcode);
 }
 
+/**
+ * Render the current qrcode into the app's bitmap, scaling each module to the
+ * largest whole number of pixels that fits. The bitmap is in XBM layout: rows
+ * padded to whole bytes, least significant bit first.
+ * @param instance The qrcode app instance
+ */
+static void render_bitmap(QRCodeApp* instance) {
+    furi_assert(instance);
+    furi_assert(instance->qrcode);
+
+    QRCode* qrcode = instance->qrcode;
+    uint8_t pixel_size = QRCODE_BITMAP_DIM / qrcode->size;
+    uint8_t dim = pixel_size * qrcode->size;
+    uint8_t row_bytes = (dim + 7) / 8;
+
+    memset(instance->bitmap, 0, sizeof(instance->bitmap));
+    for(uint8_t y = 0; y < qrcode->size; y++) {
+        uint8_t* row = instance->bitmap + y * pixel_size * row_bytes;
+        for(uint8_t x = 0; x < qrcode->size; x++) {
+            if(!qrcode_getModule(qrcode, x, y)) continue;
+            for(uint8_t px = x * pixel_size; px < (x + 1) * pixel_size; px++) {
+                row[px / 8] |= 1 << (px % 8);
+            }
+        }
+        // the remaining pixel rows of this module row are identical
+        for(uint8_t py = 1; py < pixel_size; py++) {
+            memcpy(row + py * row_bytes, row, row_bytes);
+        }
+    }
+    instance->bitmap_dim = dim;
+}
+
 /**
  * Rebuild the qrcode. Assumes that instance->message is the message to encode,
  * that the mutex has been acquired, and the specified version/ecc will be
@@ -415,9 +454,75 @@ static bool rebuild_qrcode(QRCodeApp* instance, uint8_t mode, uint8_t version, u
 
         return false;
     }
+
+    render_bitmap(instance);
     return true;
 }
 
+/**
+ * Export the current qrcode as a binary PBM (P4) image next to its file, with
+ * a quiet zone and QRCODE_EXPORT_SCALE pixels per module, so it can be printed
+ * or shown at a size the screen can't manage. PBM rows are most significant
+ * bit first and 1 is black.
+ * @param instance The qrcode app instance
+ * @param file_path Path of the loaded .qrcode file
+ * @returns true if the image was written
+ */
+static bool qrcode_export_pbm(QRCodeApp* instance, const char* file_path) {
+    furi_assert(instance);
+    furi_assert(instance->qrcode);
+
+    QRCode* qrcode = instance->qrcode;
+    uint16_t modules = qrcode->size + 2 * QRCODE_EXPORT_QUIET_ZONE;
+    uint16_t dim = modules * QRCODE_EXPORT_SCALE;
+    uint16_t row_bytes = (dim + 7) / 8;
+
+    FuriString* path = furi_string_alloc_set_str(file_path);
+    size_t ext = furi_string_search_rchar(path, '.', 0);
+    if(ext != FURI_STRING_FAILURE) furi_string_left(path, ext);
+    furi_string_cat_str(path, QRCODE_EXPORT_EXTENSION);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    uint8_t* row = malloc(row_bytes);
+    bool saved = false;
+
+    if(storage_file_open(file, furi_string_get_cstr(path), FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        char header[20];
+        int len = snprintf(header, sizeof(header), "P4\n%u %u\n", dim, dim);
+        saved = storage_file_write(file, header, len) == (size_t)len;
+
+        // every pixel row of a module row is the same, build it once
+        for(uint16_t y = 0; saved && y < modules; y++) {
+            memset(row, 0, row_bytes);
+            for(uint16_t x = 0; x < modules; x++) {
+                int16_t qx = x - QRCODE_EXPORT_QUIET_ZONE;
+                int16_t qy = y - QRCODE_EXPORT_QUIET_ZONE;
+                if(qx < 0 || qy < 0 || qx >= qrcode->size || qy >= qrcode->size) continue;
+                if(!qrcode_getModule(qrcode, qx, qy)) continue;
+                uint16_t left = x * QRCODE_EXPORT_SCALE;
+                for(uint16_t px = left; px < left + QRCODE_EXPORT_SCALE; px++) {
+                    row[px / 8] |= 0x80 >> (px % 8);
+                }
+            }
+            for(uint8_t py = 0; saved && py < QRCODE_EXPORT_SCALE; py++) {
+                saved = storage_file_write(file, row, row_bytes) == row_bytes;
+            }
+        }
+    }
+
+    if(!saved) {
+        FURI_LOG_E(TAG, "Could not export %s", furi_string_get_cstr(path));
+    }
+
+    free(row);
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    furi_string_free(path);
+    return saved;
+}
+
 /**
  * Determine the minimum version and maximum ECC for a message of a given
  * length and mode.
@@ -486,6 +591,7 @@ static bool qrcode_load_string(
     }
     instance->too_long = false;
     instance->show_stats = false;
+    instance->exported = false;
     instance->selected_idx = 0;
     instance->edit = false;
 
@@ -713,6 +819,7 @@ static QRCodeApp* qrcode_app_alloc() {
     instance->loading = true;
     instance->too_long = false;
     instance->show_stats = false;
+    instance->exported = false;
     instance->selected_idx = 0;
     instance->edit = false;
 
@@ -792,10 +899,18 @@ int32_t qrcode_app(void* p) {
                     instance->edit = false;
                     furi_mutex_release(instance->mutex);
                     break;
-                } else if(input.key == InputKeyRight) {
+                }
+
+                instance->exported = false;
+                if(input.key == InputKeyRight) {
                     instance->show_stats = true;
                 } else if(input.key == InputKeyLeft) {
                     instance->show_stats = false;
+                } else if(
+                    input.key == InputKeyOk && !instance->show_stats && !instance->loading &&
+                    instance->qrcode) {
+                    instance->exported =
+                        qrcode_export_pbm(instance, furi_string_get_cstr(file_path));
                 } else if(instance->show_stats && !instance->loading && instance->qrcode) {
                     if(input.key == InputKeyUp) {
                         if(!instance->edit) {
@@ -6,7 +6,6 @@
 #include <notification/notification_messages.h>
 #include <gui/elements.h>
 
-static const uint32_t EVENT_PERIOD_MS = 10;
 static const float BEEP_FREQ = 1000.0f;
 static const float BEEP_VOL = 0.9f;
 static const GpioPin* const radarPin = &gpio_ext_pc3; // Pin 7
@@ -18,6 +17,54 @@ bool muted = false;
 bool active = false;
 bool continuous = false; // Start with no signal from OUT
 bool altPinout; // Sets which GPIO pinout config to use
+bool showLog = false;
+
+// Edges of OUT are timestamped in the interrupt, the app sleeps until one comes in
+#define EDGE_RING_SIZE 16
+// A level shorter than this is noise on the wire, the module holds OUT high for ~2 s
+#define GLITCH_US 1000
+#define DETECTION_LOG_SIZE 5
+
+typedef struct {
+    uint32_t tick;
+    uint32_t cycles;
+    bool level;
+} Edge;
+
+typedef struct {
+    FuriMessageQueue* event_queue;
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t overflows;
+    Edge edges[EDGE_RING_SIZE];
+} EdgeRing;
+
+typedef struct {
+    uint32_t startMs; // since the app was started
+    uint32_t lengthMs; // 0 while the presence lasts
+} Detection;
+
+typedef enum {
+    EventTypeInput,
+    EventTypeEdge,
+} EventType;
+
+typedef struct {
+    EventType type;
+    InputEvent input;
+} Event;
+
+EdgeRing edgeRing;
+uint32_t startTick;
+uint32_t detections = 0;
+uint32_t glitches = 0;
+Detection detectionLog[DETECTION_LOG_SIZE]; // Newest first
+uint8_t detectionLogCount = 0;
+
+// Glitch filter state
+bool hasCandidate = false;
+Edge candidate;
+Edge presenceStart;
 
 static void start_feedback(NotificationApp* notifications) {
     // Set LED to red for detection
@@ -48,10 +95,54 @@ static void stop_feedback(NotificationApp* notifications) {
     }
 }
 
+static void draw_log(Canvas* canvas) {
+    char text[32];
+    canvas_set_font(canvas, FontPrimary);
+    snprintf(text, sizeof(text), "%lu detections", detections);
+    canvas_draw_str(canvas, 0, 9, text);
+    canvas_set_font(canvas, FontSecondary);
+    // edges the ring had no room for matter more than the filtered ones
+    if(edgeRing.overflows) {
+        snprintf(text, sizeof(text), "%lu lost", edgeRing.overflows);
+    } else {
+        snprintf(text, sizeof(text), "%lu glitches", glitches);
+    }
+    canvas_draw_str_aligned(canvas, 127, 9, AlignRight, AlignBottom, text);
+
+    for(uint8_t i = 0; i < detectionLogCount; i++) {
+        const Detection* detection = &detectionLog[i];
+        uint32_t start = detection->startMs / 1000;
+        if(detection->lengthMs == 0) {
+            snprintf(
+                text,
+                sizeof(text),
+                "%02lu:%02lu:%02lu  present",
+                start / 3600,
+                start / 60 % 60,
+                start % 60);
+        } else {
+            snprintf(
+                text,
+                sizeof(text),
+                "%02lu:%02lu:%02lu  %lu.%lus",
+                start / 3600,
+                start / 60 % 60,
+                start % 60,
+                detection->lengthMs / 1000,
+                detection->lengthMs / 100 % 10);
+        }
+        canvas_draw_str(canvas, 0, 21 + i * 10, text);
+    }
+}
+
 static void draw_callback(Canvas* canvas, void* ctx) {
     furi_assert(ctx);
 
     canvas_clear(canvas);
+    if(showLog) {
+        draw_log(canvas);
+        return;
+    }
     canvas_set_font(canvas, FontPrimary);
     elements_multiline_text_aligned(canvas, 64, 2, AlignCenter, AlignTop, "Microwave Radar");
     canvas_set_font(canvas, FontSecondary);
@@ -111,20 +202,100 @@ static void draw_callback(Canvas* canvas, void* ctx) {
 static void input_callback(InputEvent* input_event, void* ctx) {
     furi_assert(ctx);
     FuriMessageQueue* event_queue = ctx;
-    furi_message_queue_put(event_queue, input_event, FuriWaitForever);
+    Event event = {.type = EventTypeInput, .input = *input_event};
+    furi_message_queue_put(event_queue, &event, FuriWaitForever);
 }
 
-static void get_reading() {
-    if(altPinout) {
-        continuous = furi_hal_gpio_read(altRadarPin);
+static const GpioPin* get_radar_pin() {
+    return altPinout ? altRadarPin : radarPin;
+}
+
+// Both edges of OUT, the level is read back so a missed edge can't invert the state
+static void edge_callback(void* ctx) {
+    uint32_t cycles = DWT->CYCCNT;
+    EdgeRing* ring = ctx;
+
+    uint32_t head = ring->head;
+    if(head - ring->tail < EDGE_RING_SIZE) {
+        Edge* edge = &ring->edges[head % EDGE_RING_SIZE];
+        edge->tick = furi_get_tick();
+        edge->cycles = cycles;
+        edge->level = furi_hal_gpio_read(get_radar_pin());
+        ring->head = head + 1;
     } else {
-        continuous = furi_hal_gpio_read(radarPin);
+        ring->overflows++;
+    }
+
+    Event event = {.type = EventTypeEdge};
+    furi_message_queue_put(ring->event_queue, &event, 0);
+}
+
+// Only the selected pin raises interrupts, the other one stays a plain input
+static void attach_radar_pin() {
+    const GpioPin* idlePin = altPinout ? radarPin : altRadarPin;
+    furi_hal_gpio_remove_int_callback(idlePin);
+    furi_hal_gpio_init(idlePin, GpioModeInput, GpioPullDown, GpioSpeedVeryHigh);
+
+    const GpioPin* pin = get_radar_pin();
+    furi_hal_gpio_init(pin, GpioModeInterruptRiseFall, GpioPullDown, GpioSpeedVeryHigh);
+    furi_hal_gpio_add_int_callback(pin, edge_callback, &edgeRing);
+
+    // Start from the current level, queued edges belong to the old pin
+    edgeRing.tail = edgeRing.head;
+    hasCandidate = false;
+    continuous = furi_hal_gpio_read(pin);
+}
+
+static void commit_reading(const Edge* edge) {
+    continuous = edge->level;
+
+    if(continuous) {
+        presenceStart = *edge;
+        detections++;
+        memmove(&detectionLog[1], &detectionLog[0], sizeof(Detection) * (DETECTION_LOG_SIZE - 1));
+        detectionLog[0].startMs = edge->tick - startTick;
+        detectionLog[0].lengthMs = 0;
+        if(detectionLogCount < DETECTION_LOG_SIZE) detectionLogCount++;
+    } else if(detectionLogCount > 0 && detectionLog[0].lengthMs == 0) {
+        detectionLog[0].lengthMs = MAX(edge->tick - presenceStart.tick, 1u);
+    }
+}
+
+// Runs the queued edges through the glitch filter and updates 'continuous'
+static void get_reading() {
+    uint32_t glitchCycles = GLITCH_US * furi_hal_cortex_instructions_per_microsecond();
+
+    while(edgeRing.tail != edgeRing.head) {
+        Edge edge = edgeRing.edges[edgeRing.tail % EDGE_RING_SIZE];
+        edgeRing.tail++;
+
+        if(hasCandidate) {
+            hasCandidate = false;
+            if(edge.cycles - candidate.cycles < glitchCycles) {
+                glitches++;
+                if(edge.level == continuous) continue;
+            } else {
+                commit_reading(&candidate);
+            }
+        }
+        if(edge.level != continuous) {
+            candidate = edge;
+            hasCandidate = true;
+        }
+    }
+
+    // The new level has been stable for long enough
+    if(hasCandidate && DWT->CYCCNT - candidate.cycles >= glitchCycles) {
+        hasCandidate = false;
+        commit_reading(&candidate);
     }
 }
 
 int32_t app_radar_scanner(void* p) {
     UNUSED(p);
-    FuriMessageQueue* event_queue = furi_message_queue_alloc(8, sizeof(InputEvent));
+    FuriMessageQueue* event_queue = furi_message_queue_alloc(8, sizeof(Event));
+    edgeRing.event_queue = event_queue;
+    startTick = furi_get_tick();
 
     // I'm keeping the forced backlight as you will likely be away from Flipper
     NotificationApp* notifications = furi_record_open(RECORD_NOTIFICATION);
@@ -145,6 +316,7 @@ int32_t app_radar_scanner(void* p) {
     furi_hal_gpio_init(altRadarPin, GpioModeInput, GpioPullDown, GpioSpeedVeryHigh);
     furi_hal_gpio_init(altGroundPin, GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
     furi_hal_gpio_write(altGroundPin, false);
+    attach_radar_pin();
 
     // Auto 5v power
     uint8_t attempts = 0;
@@ -158,10 +330,38 @@ int32_t app_radar_scanner(void* p) {
     bool running = true; // to prevent unwanted false positives
 
     while(running) {
+        // Wait for an edge or a key, only poll while the glitch filter waits on a level
+        Event event;
+        uint32_t timeout = hasCandidate ? 1 : FuriWaitForever;
+        if(furi_message_queue_get(event_queue, &event, timeout) == FuriStatusOk &&
+           event.type == EventTypeInput) {
+            if(event.input.type == InputTypePress) {
+                if(event.input.key == InputKeyBack) {
+                    break;
+                }
+                if(event.input.key == InputKeyOk) {
+                    active = !active; // Toggle the value of 'active'
+                    stop_feedback(notifications);
+                }
+                if(event.input.key == InputKeyDown) {
+                    muted = !muted; // Toggle the value of 'muted'
+                    stop_feedback(notifications);
+                }
+                if(event.input.key == InputKeyRight) {
+                    altPinout = !altPinout; // Toggle alternate pinout
+                    attach_radar_pin();
+                }
+                if(event.input.key == InputKeyUp) {
+                    showLog = !showLog; // Toggle the detection log
+                }
+            }
+        }
+
+        // Edges are filtered and logged even on standby
+        get_reading();
+
         if(active) {
             // start and stop feedback if sensor state is active
-            get_reading();
-
             if(continuous && !alarming) {
                 presenceDetected = true;
                 start_feedback(notifications);
@@ -174,28 +374,14 @@ int32_t app_radar_scanner(void* p) {
             alarming = continuous;
         }
 
-        // Exit on back key
-        InputEvent event;
-        if(furi_message_queue_get(event_queue, &event, EVENT_PERIOD_MS) == FuriStatusOk) {
-            if(event.type == InputTypePress) {
-                if(event.key == InputKeyBack) {
-                    break;
-                }
-                if(event.key == InputKeyOk) {
-                    active = !active; // Toggle the value of 'active'
-                    stop_feedback(notifications);
-                }
-                if(event.key == InputKeyDown) {
-                    muted = !muted; // Toggle the value of 'muted'
-                    stop_feedback(notifications);
-                }
-                if(event.key == InputKeyRight) {
-                    altPinout = !altPinout; // Toggle alternate pinout
-                }
-            }
-        }
+        view_port_update(view_port);
     }
 
+    furi_hal_gpio_remove_int_callback(get_radar_pin());
+    furi_hal_gpio_init(radarPin, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
+    furi_hal_gpio_init(altRadarPin, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
+    furi_hal_gpio_init(altGroundPin, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
+
     // return control of the LED, beeper, backlight, and stop vibration
     stop_feedback(notifications);
     notification_message_block(notifications, &sequence_display_backlight_enforce_auto);
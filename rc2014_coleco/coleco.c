@@ -2,6 +2,8 @@
 #include <furi_hal_gpio.h>
 #include <furi_hal_power.h>
 #include <gui/gui.h>
+#include <storage/storage.h>
+#include <flipper_format/flipper_format.h>
 #include "coleco_icons.h"
 
 #define CODE_0 0x0A
@@ -18,16 +20,43 @@
 #define CODE_S 0x09
 #define CODE_N 0x0F
 
-const GpioPin* const pin_up = &gpio_ext_pa6;
-const GpioPin* const pin_down = &gpio_ext_pc0;
-const GpioPin* const pin_right = &gpio_ext_pb2;
-const GpioPin* const pin_left = &gpio_ext_pc3;
-const GpioPin* const pin_code0 = &gpio_ext_pa7;
-const GpioPin* const pin_code1 = &gpio_ext_pa4;
-const GpioPin* const pin_code2 = &gpio_ibutton;
-const GpioPin* const pin_code3 = &gpio_ext_pc1;
-const GpioPin* const pin_fire = &gpio_ext_pb3;
-const GpioPin* const pin_alt = &gpio_usart_tx;
+// Output lines, as bits of a single word holding their (active low) levels
+#define LINE_UP (1 << 0)
+#define LINE_DOWN (1 << 1)
+#define LINE_RIGHT (1 << 2)
+#define LINE_LEFT (1 << 3)
+#define LINE_FIRE (1 << 4)
+#define LINE_ALT (1 << 5)
+#define LINE_CODE_SHIFT 6
+#define LINE_CODE_MASK (0x0F << LINE_CODE_SHIFT)
+#define LINE_CODE(code) ((uint32_t)(code) << LINE_CODE_SHIFT)
+#define LINES_IDLE \
+    (LINE_UP | LINE_DOWN | LINE_RIGHT | LINE_LEFT | LINE_FIRE | LINE_ALT | LINE_CODE(CODE_N))
+
+// Indexed by line bit
+static const GpioPin* const line_pins[] = {
+    &gpio_ext_pa6, // up
+    &gpio_ext_pc0, // down
+    &gpio_ext_pb2, // right
+    &gpio_ext_pc3, // left
+    &gpio_ext_pb3, // fire
+    &gpio_usart_tx, // alt
+    &gpio_ext_pa7, // code0
+    &gpio_ext_pa4, // code1
+    &gpio_ibutton, // code2
+    &gpio_ext_pc1, // code3
+};
+
+#define MACRO_FOLDER EXT_PATH("apps_data/coleco")
+#define MACRO_PATH MACRO_FOLDER "/macro.txt"
+#define MACRO_FILETYPE "Coleco Macro"
+#define MACRO_VERSION 1
+#define MACRO_KEY_STEPS "Steps"
+#define MACRO_KEY_FRAME "Frame"
+#define MACRO_KEY_LINES "Lines"
+#define MACRO_MAX_STEPS 512
+// ColecoVision (NTSC) frames per second, the time base of a macro
+#define COLECO_FRAME_RATE 60
 
 typedef enum {
     EventTypeTick,
@@ -39,10 +68,28 @@ typedef struct {
     InputEvent input;
 } PluginEvent;
 
+typedef enum {
+    PlayerEventStop = (1 << 0),
+} PlayerEvent;
+
+// Timed line states, frame[i] counted from the start of the recording
+typedef struct {
+    uint32_t count;
+    uint32_t frame[MACRO_MAX_STEPS];
+    uint32_t lines[MACRO_MAX_STEPS];
+} Macro;
+
 typedef struct {
     bool dpad;
     int row;
     int column;
+    uint32_t lines;
+    Macro* macro;
+    bool recording;
+    uint32_t record_start;
+    bool playing;
+    FuriThread* player;
+    FuriMessageQueue* event_queue;
     FuriMutex* mutex;
 } Coleco;
 
@@ -61,6 +108,12 @@ static void render_callback(Canvas* const canvas, void* context) {
         canvas_draw_icon(canvas, 27, 52, hvr ? &I_ColecoFire_hvr_18x9 : &I_ColecoFire_18x9);
     }
 
+    if(coleco->recording || coleco->playing) {
+        canvas_set_font(canvas, FontSecondary);
+        canvas_draw_str_aligned(
+            canvas, 2, 4, AlignLeft, AlignTop, coleco->recording ? "REC" : "PLAY");
+    }
+
     canvas_draw_icon(
         canvas,
         27,
@@ -138,34 +191,188 @@ static void input_callback(InputEvent* input_event, FuriMessageQueue* event_queu
     furi_message_queue_put(event_queue, &event, FuriWaitForever);
 }
 
-static void coleco_write_code(uint8_t code) {
-    furi_hal_gpio_write(pin_code0, (code & 1));
-    furi_hal_gpio_write(pin_code1, (code & 2));
-    furi_hal_gpio_write(pin_code2, (code & 4));
-    furi_hal_gpio_write(pin_code3, (code & 8));
+// Drive every line at once: one BSRR store per GPIO port, so the pins of a port (and the
+// code nibble within it) never show a half-updated state
+static void coleco_write_lines(uint32_t lines) {
+    GPIO_TypeDef* const ports[] = {GPIOA, GPIOB, GPIOC};
+    uint32_t bsrr[COUNT_OF(ports)] = {0};
+
+    for(size_t i = 0; i < COUNT_OF(line_pins); i++) {
+        const GpioPin* pin = line_pins[i];
+        const uint32_t bits = (lines & (1 << i)) ? pin->pin : ((uint32_t)pin->pin << 16);
+        for(size_t p = 0; p < COUNT_OF(ports); p++) {
+            if(pin->port == ports[p]) bsrr[p] |= bits;
+        }
+    }
+
+    for(size_t p = 0; p < COUNT_OF(ports); p++) {
+        if(bsrr[p]) ports[p]->BSRR = bsrr[p];
+    }
+}
+
+static uint32_t coleco_frame(uint32_t start) {
+    return (furi_get_tick() - start) * COLECO_FRAME_RATE / furi_kernel_get_tick_frequency();
+}
+
+static uint32_t coleco_frame_ticks(uint32_t frame) {
+    return (frame * furi_kernel_get_tick_frequency() + COLECO_FRAME_RATE / 2) / COLECO_FRAME_RATE;
 }
 
-static void coleco_gpio_init() {
+static void coleco_record_step(Coleco* coleco) {
+    Macro* macro = coleco->macro;
+    if(macro->count == MACRO_MAX_STEPS) {
+        FURI_LOG_W("Coleco", "macro full, recording stopped");
+        coleco->recording = false;
+        return;
+    }
+
+    macro->frame[macro->count] = coleco_frame(coleco->record_start);
+    macro->lines[macro->count] = coleco->lines;
+    macro->count++;
+}
+
+// Caller holds the mutex
+static void coleco_set_lines(Coleco* coleco, uint32_t lines) {
+    if(lines == coleco->lines) return;
+
+    coleco_write_lines(lines);
+    coleco->lines = lines;
+    if(coleco->recording) coleco_record_step(coleco);
+}
+
+static void coleco_set_line(Coleco* coleco, uint32_t line, bool level) {
+    coleco_set_lines(coleco, level ? (coleco->lines | line) : (coleco->lines & ~line));
+}
+
+static void coleco_write_code(Coleco* coleco, uint8_t code) {
+    coleco_set_lines(coleco, (coleco->lines & ~LINE_CODE_MASK) | LINE_CODE(code));
+}
+
+static void coleco_gpio_init(Coleco* coleco) {
     // configure output pins
-    furi_hal_gpio_init(pin_up, GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
-    furi_hal_gpio_init(pin_down, GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
-    furi_hal_gpio_init(pin_right, GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
-    furi_hal_gpio_init(pin_left, GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
-    furi_hal_gpio_init(pin_code0, GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
-    furi_hal_gpio_init(pin_code1, GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
-    furi_hal_gpio_init(pin_code2, GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
-    furi_hal_gpio_init(pin_code3, GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
-    furi_hal_gpio_init(pin_fire, GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
-    furi_hal_gpio_init(pin_alt, GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
-
-    furi_hal_gpio_write(pin_up, true);
-    furi_hal_gpio_write(pin_down, true);
-    furi_hal_gpio_write(pin_right, true);
-    furi_hal_gpio_write(pin_left, true);
-    furi_hal_gpio_write(pin_fire, true);
-    furi_hal_gpio_write(pin_alt, true);
-
-    coleco_write_code(CODE_N);
+    for(size_t i = 0; i < COUNT_OF(line_pins); i++) {
+        furi_hal_gpio_init(line_pins[i], GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
+    }
+
+    coleco->lines = LINES_IDLE;
+    coleco_write_lines(coleco->lines);
+}
+
+static bool coleco_macro_save(const Macro* macro) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, MACRO_FOLDER);
+    FlipperFormat* file = flipper_format_file_alloc(storage);
+
+    bool saved = flipper_format_file_open_always(file, MACRO_PATH) &&
+                 flipper_format_write_header_cstr(file, MACRO_FILETYPE, MACRO_VERSION) &&
+                 flipper_format_write_uint32(file, MACRO_KEY_STEPS, &macro->count, 1) &&
+                 flipper_format_write_uint32(file, MACRO_KEY_FRAME, macro->frame, macro->count) &&
+                 flipper_format_write_uint32(file, MACRO_KEY_LINES, macro->lines, macro->count);
+
+    flipper_format_file_close(file);
+    flipper_format_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    if(!saved) FURI_LOG_E("Coleco", "cannot save macro");
+    return saved;
+}
+
+static bool coleco_macro_load(Macro* macro) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    FlipperFormat* file = flipper_format_file_alloc(storage);
+    FuriString* filetype = furi_string_alloc();
+    uint32_t version = 0;
+    uint32_t count = 0;
+
+    bool loaded = flipper_format_file_open_existing(file, MACRO_PATH) &&
+                  flipper_format_read_header(file, filetype, &version) &&
+                  furi_string_equal_str(filetype, MACRO_FILETYPE) &&
+                  version == MACRO_VERSION &&
+                  flipper_format_read_uint32(file, MACRO_KEY_STEPS, &count, 1) &&
+                  count > 0 && count <= MACRO_MAX_STEPS &&
+                  flipper_format_read_uint32(file, MACRO_KEY_FRAME, macro->frame, count) &&
+                  flipper_format_read_uint32(file, MACRO_KEY_LINES, macro->lines, count);
+    macro->count = loaded ? count : 0;
+
+    furi_string_free(filetype);
+    flipper_format_file_close(file);
+    flipper_format_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    if(!loaded) FURI_LOG_E("Coleco", "cannot load macro");
+    return loaded;
+}
+
+static void coleco_record_toggle(Coleco* coleco) {
+    if(coleco->recording) {
+        // closing step, so a replay also keeps the final state for as long as it was held
+        coleco_record_step(coleco);
+        coleco->recording = false;
+        coleco_macro_save(coleco->macro);
+    } else {
+        coleco->macro->count = 0;
+        coleco->record_start = furi_get_tick();
+        coleco->recording = true;
+        coleco_record_step(coleco);
+    }
+}
+
+// Applies each step at the start of its frame, counted from an absolute start tick so that
+// lateness never accumulates
+static int32_t coleco_player(void* context) {
+    Coleco* coleco = context;
+    const Macro* macro = coleco->macro;
+    const uint32_t start = furi_get_tick();
+
+    for(uint32_t i = 0; i < macro->count; i++) {
+        const uint32_t due = start + coleco_frame_ticks(macro->frame[i]);
+        const uint32_t now = furi_get_tick();
+        const uint32_t wait = ((int32_t)(due - now) > 0) ? (due - now) : 0;
+
+        uint32_t flags = furi_thread_flags_wait(PlayerEventStop, FuriFlagWaitAny, wait);
+        if(!(flags & FuriFlagError) && (flags & PlayerEventStop)) break;
+
+        furi_mutex_acquire(coleco->mutex, FuriWaitForever);
+        coleco_set_lines(coleco, macro->lines[i]);
+        furi_mutex_release(coleco->mutex);
+    }
+
+    furi_mutex_acquire(coleco->mutex, FuriWaitForever);
+    coleco_set_lines(coleco, LINES_IDLE);
+    coleco->playing = false;
+    furi_mutex_release(coleco->mutex);
+
+    // redraw; the main loop reaps the thread
+    PluginEvent event = {.type = EventTypeTick};
+    furi_message_queue_put(coleco->event_queue, &event, 0);
+
+    return 0;
+}
+
+// Caller holds the mutex
+static void coleco_play_toggle(Coleco* coleco) {
+    if(coleco->playing) {
+        furi_thread_flags_set(furi_thread_get_id(coleco->player), PlayerEventStop);
+        return;
+    }
+    if(coleco->player || coleco->recording || !coleco_macro_load(coleco->macro)) return;
+
+    coleco->playing = true;
+    coleco->player = furi_thread_alloc();
+    furi_thread_set_name(coleco->player, "ColecoMacroPlayer");
+    furi_thread_set_stack_size(coleco->player, 1024);
+    furi_thread_set_context(coleco->player, coleco);
+    furi_thread_set_callback(coleco->player, coleco_player);
+    furi_thread_start(coleco->player);
+}
+
+// Caller holds the mutex, the player no longer needs it once 'playing' is cleared
+static void coleco_player_reap(Coleco* coleco) {
+    if(coleco->player && !coleco->playing) {
+        furi_thread_join(coleco->player);
+        furi_thread_free(coleco->player);
+        coleco->player = NULL;
+    }
 }
 
 static Coleco* coleco_alloc() {
@@ -174,10 +381,17 @@ static Coleco* coleco_alloc() {
     coleco->dpad = false;
     coleco->row = 0;
     coleco->column = 1;
+    coleco->lines = LINES_IDLE;
+    coleco->macro = malloc(sizeof(Macro));
+    coleco->macro->count = 0;
+    coleco->recording = false;
+    coleco->playing = false;
+    coleco->player = NULL;
 
     coleco->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
     if(!coleco->mutex) {
         FURI_LOG_E("Coleco", "cannot create mutex\r\n");
+        free(coleco->macro);
         free(coleco);
         return NULL;
     }
@@ -189,6 +403,7 @@ static void coleco_free(Coleco* coleco) {
     furi_assert(coleco);
 
     furi_mutex_free(coleco->mutex);
+    free(coleco->macro);
     free(coleco);
 }
 
@@ -201,6 +416,7 @@ int32_t coleco_app(void* p) {
     if(coleco == NULL) {
         return 255;
     }
+    coleco->event_queue = event_queue;
 
     // set system callbacks
     ViewPort* view_port = view_port_alloc();
@@ -211,7 +427,7 @@ int32_t coleco_app(void* p) {
     Gui* gui = furi_record_open("gui");
     gui_add_view_port(gui, view_port, GuiLayerFullscreen);
 
-    coleco_gpio_init();
+    coleco_gpio_init(coleco);
     furi_hal_power_enable_otg();
 
     PluginEvent event;
@@ -219,119 +435,132 @@ int32_t coleco_app(void* p) {
         FuriStatus event_status = furi_message_queue_get(event_queue, &event, 100);
 
         furi_mutex_acquire(coleco->mutex, FuriWaitForever);
+        coleco_player_reap(coleco);
 
         if(event_status == FuriStatusOk) {
-            // press events
-            if(event.type == EventTypeKey) {
+            if(event.type == EventTypeKey && coleco->playing) {
+                // the macro owns the lines, only stopping it is allowed
+                if((event.input.key == InputKeyBack && event.input.type == InputTypePress) ||
+                   (event.input.key == InputKeyRight && event.input.type == InputTypeLong)) {
+                    coleco_play_toggle(coleco);
+                }
+            } else if(event.type == EventTypeKey) {
+                // press events
                 switch(event.input.key) {
                 case InputKeyUp:
                     if(coleco->dpad) {
                         if(event.input.type == InputTypePress) {
-                            furi_hal_gpio_write(pin_up, false);
+                            coleco_set_line(coleco, LINE_UP, false);
                         } else if(event.input.type == InputTypeRelease) {
-                            furi_hal_gpio_write(pin_up, true);
+                            coleco_set_line(coleco, LINE_UP, true);
                         }
                     } else {
                         if(event.input.type == InputTypePress && coleco->column < 2) {
                             coleco->column++;
-                            coleco_write_code(CODE_N);
+                            coleco_write_code(coleco, CODE_N);
                         }
                     }
                     break;
                 case InputKeyDown:
                     if(coleco->dpad) {
                         if(event.input.type == InputTypePress) {
-                            furi_hal_gpio_write(pin_down, false);
+                            coleco_set_line(coleco, LINE_DOWN, false);
                         } else if(event.input.type == InputTypeRelease) {
-                            furi_hal_gpio_write(pin_down, true);
+                            coleco_set_line(coleco, LINE_DOWN, true);
                         }
                     } else {
                         if(event.input.type == InputTypePress && coleco->column > 0) {
                             coleco->column--;
-                            coleco_write_code(CODE_N);
+                            coleco_write_code(coleco, CODE_N);
                         }
                     }
                     break;
                 case InputKeyRight:
                     if(coleco->dpad) {
                         if(event.input.type == InputTypePress) {
-                            furi_hal_gpio_write(pin_right, false);
+                            coleco_set_line(coleco, LINE_RIGHT, false);
                         } else if(event.input.type == InputTypeRelease) {
-                            furi_hal_gpio_write(pin_right, true);
+                            coleco_set_line(coleco, LINE_RIGHT, true);
                         }
                     } else {
                         if(event.input.type == InputTypePress && coleco->row < 4) {
                             coleco->row++;
-                            coleco_write_code(CODE_N);
+                            coleco_write_code(coleco, CODE_N);
+                        } else if(event.input.type == InputTypeLong) {
+                            coleco_play_toggle(coleco);
                         }
                     }
                     break;
                 case InputKeyLeft:
                     if(coleco->dpad) {
                         if(event.input.type == InputTypePress) {
-                            furi_hal_gpio_write(pin_left, false);
+                            coleco_set_line(coleco, LINE_LEFT, false);
                         } else if(event.input.type == InputTypeRelease) {
-                            furi_hal_gpio_write(pin_left, true);
+                            coleco_set_line(coleco, LINE_LEFT, true);
                         }
                     } else {
                         if(event.input.type == InputTypePress && coleco->row > 0) {
                             coleco->row--;
-                            coleco_write_code(CODE_N);
+                            coleco_write_code(coleco, CODE_N);
+                        } else if(event.input.type == InputTypeLong) {
+                            coleco_record_toggle(coleco);
                         }
                     }
                     break;
                 case InputKeyOk:
                     if(coleco->dpad) {
                         if(event.input.type == InputTypePress) {
-                            furi_hal_gpio_write(pin_fire, false);
+                            coleco_set_line(coleco, LINE_FIRE, false);
                         } else if(event.input.type == InputTypeRelease) {
-                            furi_hal_gpio_write(pin_fire, true);
+                            coleco_set_line(coleco, LINE_FIRE, true);
                         }
                     } else {
                         if(event.input.type == InputTypePress) {
                             if(coleco->row == 0) {
                                 if(coleco->column == 2) {
-                                    furi_hal_gpio_write(pin_alt, false);
+                                    coleco_set_line(coleco, LINE_ALT, false);
                                 } else {
                                     coleco->dpad = true;
                                 }
                             } else if(coleco->row == 1) {
                                 if(coleco->column == 0) {
-                                    coleco_write_code(CODE_1);
+                                    coleco_write_code(coleco, CODE_1);
                                 } else if(coleco->column == 1) {
-                                    coleco_write_code(CODE_2);
+                                    coleco_write_code(coleco, CODE_2);
                                 } else {
-                                    coleco_write_code(CODE_3);
+                                    coleco_write_code(coleco, CODE_3);
                                 }
                             } else if(coleco->row == 2) {
                                 if(coleco->column == 0) {
-                                    coleco_write_code(CODE_4);
+                                    coleco_write_code(coleco, CODE_4);
                                 } else if(coleco->column == 1) {
-                                    coleco_write_code(CODE_5);
+                                    coleco_write_code(coleco, CODE_5);
                                 } else {
-                                    coleco_write_code(CODE_6);
+                                    coleco_write_code(coleco, CODE_6);
                                 }
                             } else if(coleco->row == 3) {
                                 if(coleco->column == 0) {
-                                    coleco_write_code(CODE_7);
+                                    coleco_write_code(coleco, CODE_7);
                                 } else if(coleco->column == 1) {
-                                    coleco_write_code(CODE_8);
+                                    coleco_write_code(coleco, CODE_8);
                                 } else {
-                                    coleco_write_code(CODE_9);
+                                    coleco_write_code(coleco, CODE_9);
                                 }
                             } else if(coleco->row == 4) {
                                 if(coleco->column == 0) {
-                                    coleco_write_code(CODE_S);
+                                    coleco_write_code(coleco, CODE_S);
                                 } else if(coleco->column == 1) {
-                                    coleco_write_code(CODE_0);
+                                    coleco_write_code(coleco, CODE_0);
                                 } else {
-                                    coleco_write_code(CODE_H);
+                                    coleco_write_code(coleco, CODE_H);
                                 }
                             }
                         }
                         if(event.input.type == InputTypeRelease) {
-                            furi_hal_gpio_write(pin_alt, true);
-                            coleco_write_code(CODE_N);
+                            coleco_set_lines(
+                                coleco,
+                                (coleco->lines & ~LINE_CODE_MASK) | LINE_ALT |
+                                    LINE_CODE(CODE_N));
                         }
                     }
                     break;
@@ -347,14 +576,25 @@ int32_t coleco_app(void* p) {
                 default:
                     break;
                 }
-
-                view_port_update(view_port);
             }
+
+            view_port_update(view_port);
         }
 
         furi_mutex_release(coleco->mutex);
     }
 
+    // stop a running macro, the player needs the mutex to finish
+    furi_mutex_acquire(coleco->mutex, FuriWaitForever);
+    if(coleco->playing) coleco_play_toggle(coleco);
+    if(coleco->recording) coleco_record_toggle(coleco);
+    furi_mutex_release(coleco->mutex);
+    if(coleco->player) {
+        furi_thread_join(coleco->player);
+        furi_thread_free(coleco->player);
+        coleco->player = NULL;
+    }
+
     furi_hal_power_disable_otg();
 
     view_port_enabled_set(view_port, false);
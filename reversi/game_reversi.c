@@ -24,8 +24,9 @@ typedef struct {
     FuriMutex* mutex;
 } AppState;
 
-#define MENU_ITEMS_COUNT 2
-static const char* popup_menu_strings[] = {"Resume", "New Game"};
+#define MENU_ITEMS_COUNT 3
+#define MENU_ITEM_LEVEL 2
+static const char* popup_menu_strings[] = {"Resume", "New Game", NULL};
 
 static void draw_menu(Canvas* const canvas, const AppState* app_state);
 static void gray_canvas(Canvas* const canvas);
@@ -72,30 +73,30 @@ static void draw_callback(Canvas* const canvas, void* ctx) {
 
     canvas_set_color(canvas, ColorBlack);
     // draw pieces
-    int blacks = 0, whites = 0;
     const int radius = FRAME_CELL_SIZE >> 1;
     for(uint8_t i = 0; i < BOARD_SIZE; i++) {
         for(uint8_t j = 0; j < BOARD_SIZE; j++) {
-            if(!game_state->board[i][j]) {
+            int8_t piece = get_piece(game_state, i, j);
+            if(!piece) {
                 continue;
             }
-            if(game_state->board[i][j] == BLACK) {
+            if(piece == BLACK) {
                 canvas_draw_disc(
                     canvas,
                     FRAME_LEFT + FRAME_CELL_SIZE * i + radius + 1,
                     FRAME_TOP + FRAME_CELL_SIZE * j + radius + 1,
                     radius);
-                blacks++;
             } else {
                 canvas_draw_circle(
                     canvas,
                     FRAME_LEFT + FRAME_CELL_SIZE * i + radius + 1,
                     FRAME_TOP + FRAME_CELL_SIZE * j + radius + 1,
                     radius);
-                whites++;
             }
         }
     }
+    int blacks = count_pieces(game_state, BLACK);
+    int whites = count_pieces(game_state, WHITE);
 
     canvas_set_font(canvas, FontPrimary);
     // draw score
@@ -133,6 +134,10 @@ static void draw_callback(Canvas* const canvas, void* ctx) {
     } else {
         canvas_draw_str_aligned(canvas, 70, 12, AlignLeft, AlignTop, "Computer turn");
     }
+    if(!game_state->is_game_over) {
+        canvas_draw_str_aligned(
+            canvas, 70, 24, AlignLeft, AlignTop, difficulty_name(game_state->difficulty));
+    }
 
     if(app_state->screen == AppScreenMenu) {
         draw_menu(canvas, app_state);
@@ -144,19 +149,28 @@ static void draw_callback(Canvas* const canvas, void* ctx) {
 static void draw_menu(Canvas* const canvas, const AppState* app_state) {
     gray_canvas(canvas);
     canvas_set_color(canvas, ColorWhite);
-    canvas_draw_rbox(canvas, 28, 16, 72, 32, 4);
+    canvas_draw_rbox(canvas, 28, 10, 72, 44, 4);
     canvas_set_color(canvas, ColorBlack);
-    canvas_draw_rframe(canvas, 28, 16, 72, 32, 4);
+    canvas_draw_rframe(canvas, 28, 10, 72, 44, 4);
+
+    char level_str[20];
+    snprintf(
+        level_str, sizeof(level_str), "< %s >", difficulty_name(app_state->game.difficulty));
 
     for(int i = 0; i < MENU_ITEMS_COUNT; i++) {
         if(i == app_state->selected_menu_item) {
             canvas_set_color(canvas, ColorBlack);
-            canvas_draw_box(canvas, 34, 20 + 12 * i, 60, 12);
+            canvas_draw_box(canvas, 34, 14 + 12 * i, 60, 12);
         }
 
         canvas_set_color(canvas, i == app_state->selected_menu_item ? ColorWhite : ColorBlack);
         canvas_draw_str_aligned(
-            canvas, 64, 26 + 12 * i, AlignCenter, AlignCenter, popup_menu_strings[i]);
+            canvas,
+            64,
+            20 + 12 * i,
+            AlignCenter,
+            AlignCenter,
+            i == MENU_ITEM_LEVEL ? level_str : popup_menu_strings[i]);
     }
 }
 
@@ -259,7 +273,22 @@ bool handle_key_menu(AppState* app_state, InputKey key) {
             app_state->selected_menu_item++;
         }
         break;
+    case InputKeyLeft:
+        if(app_state->selected_menu_item == MENU_ITEM_LEVEL) {
+            app_state->game.difficulty =
+                (app_state->game.difficulty + DifficultyCount - 1) % DifficultyCount;
+        }
+        break;
+    case InputKeyRight:
+        if(app_state->selected_menu_item == MENU_ITEM_LEVEL) {
+            app_state->game.difficulty = (app_state->game.difficulty + 1) % DifficultyCount;
+        }
+        break;
     case InputKeyOk:
+        if(app_state->selected_menu_item == MENU_ITEM_LEVEL) {
+            app_state->game.difficulty = (app_state->game.difficulty + 1) % DifficultyCount;
+            break;
+        }
         if(app_state->selected_menu_item == 1) {
             // new game
             init_game(&app_state->game);
@@ -267,6 +296,10 @@ bool handle_key_menu(AppState* app_state, InputKey key) {
         }
         app_state->screen = AppScreenGame;
         break;
+    case InputKeyBack:
+        save_game(&app_state->game);
+        app_state->screen = AppScreenGame;
+        break;
     default:
         break;
     }
@@ -292,6 +325,7 @@ int32_t game_reversi_app() {
     AppState app_state;
     app_state.screen = AppScreenGame;
     if(!load_game(&app_state.game)) {
+        app_state.game.difficulty = DifficultyNormal;
         init_game(&app_state.game);
     }
 
@@ -314,7 +348,12 @@ int32_t game_reversi_app() {
         // check if it's computer's turn
         if(!app_state.game.is_game_over &&
            (app_state.game.current_player != app_state.game.human_color)) {
-            computer_move(&app_state.game);
+            // search without holding the mutex, the board is only read while thinking
+            int8_t square = computer_think(&app_state.game);
+            furi_mutex_acquire(app_state.mutex, FuriWaitForever);
+            computer_move(&app_state.game, square);
+            furi_mutex_release(app_state.mutex);
+            view_port_update(view_port);
         }
         FuriStatus event_status = furi_message_queue_get(event_queue, &input, 100);
         if(event_status == FuriStatusOk) {
@@ -3,117 +3,190 @@
 
 #include "reversi.h"
 
-// Psst! Most of this file was written with Copilot
-
-// Check if the move is legal by checking if it results in any opponent pieces being captured
-bool is_legal_move(int8_t board[BOARD_SIZE][BOARD_SIZE], int row, int col, int player) {
-    if(board[row][col] != 0) return false;
-    int opponent = -player;
-    for(int i = -1; i <= 1; i++) {
-        for(int j = -1; j <= 1; j++) {
-            if(i == 0 && j == 0) continue;
-            int r = row + i, c = col + j;
-            if(r >= 0 && r < BOARD_SIZE && c >= 0 && c < BOARD_SIZE && board[r][c] == opponent) {
-                int k = 2;
-                while(true) {
-                    r += i;
-                    c += j;
-                    if(r < 0 || r >= BOARD_SIZE || c < 0 || c >= BOARD_SIZE) break;
-                    if(board[r][c] == player) return true;
-                    if(board[r][c] == 0) break;
-                    k++;
-                }
-            }
-        }
+#define SQUARE(x, y) ((y) * BOARD_SIZE + (x))
+#define BIT(square) (1ULL << (square))
+
+#define NOT_FILE_A 0xfefefefefefefefeULL
+#define NOT_FILE_H 0x7f7f7f7f7f7f7f7fULL
+
+#define SCORE_INFINITY 1000000
+#define SCORE_WIN 10000
+#define MOBILITY_WEIGHT 8
+// how many nodes are searched between checks of the time budget
+#define SEARCH_CHECK_MASK 0xff
+
+typedef struct {
+    const char* name;
+    uint8_t depth;
+    uint32_t time_ms;
+} DifficultyLevel;
+
+static const DifficultyLevel difficulty_levels[DifficultyCount] = {
+    {"Easy", 1, 100},
+    {"Normal", 4, 500},
+    {"Hard", 12, 2000},
+};
+
+// Classic positional weights: corners are worth the most, the squares next to them give
+// the corners away
+static const int8_t square_weights[BOARD_SIZE * BOARD_SIZE] = {
+    100, -20, 10, 5,  5,  10, -20, 100, //
+    -20, -50, -2, -2, -2, -2, -50, -20, //
+    10,  -2,  -1, -1, -1, -1, -2,  10, //
+    5,   -2,  -1, -1, -1, -1, -2,  5, //
+    5,   -2,  -1, -1, -1, -1, -2,  5, //
+    10,  -2,  -1, -1, -1, -1, -2,  10, //
+    -20, -50, -2, -2, -2, -2, -50, -20, //
+    100, -20, 10, 5,  5,  10, -20, 100, //
+};
+
+#define CORNERS (BIT(0) | BIT(7) | BIT(56) | BIT(63))
+
+typedef struct {
+    uint32_t start;
+    uint32_t budget;
+    uint32_t nodes;
+    bool aborted;
+} SearchContext;
+
+// Moves every piece of the bitboard one step into direction `dir` (0..7), pieces that
+// would wrap around to the other side of the board are dropped
+static inline uint64_t shift(uint64_t b, uint8_t dir) {
+    switch(dir) {
+    case 0:
+        return (b << 1) & NOT_FILE_A; // right
+    case 1:
+        return (b >> 1) & NOT_FILE_H; // left
+    case 2:
+        return b << 8; // down
+    case 3:
+        return b >> 8; // up
+    case 4:
+        return (b << 9) & NOT_FILE_A; // down right
+    case 5:
+        return (b << 7) & NOT_FILE_H; // down left
+    case 6:
+        return (b >> 7) & NOT_FILE_A; // up right
+    default:
+        return (b >> 9) & NOT_FILE_H; // up left
     }
-    return false;
 }
 
-// Check if the game is over by checking if there are no more moves left for
-// either player
-bool is_game_over(int8_t board[BOARD_SIZE][BOARD_SIZE]) {
-    for(int i = 0; i < BOARD_SIZE; i++) {
-        for(int j = 0; j < BOARD_SIZE; j++) {
-            if(is_legal_move(board, i, j, BLACK) || is_legal_move(board, i, j, WHITE)) {
-                return false;
-            }
+// All the empty squares where `own` captures at least one piece of `opp`
+static uint64_t legal_moves(uint64_t own, uint64_t opp) {
+    uint64_t empty = ~(own | opp);
+    uint64_t moves = 0;
+    for(uint8_t dir = 0; dir < 8; dir++) {
+        uint64_t x = shift(own, dir) & opp;
+        // a line can hold at most 6 opponent pieces between two of ours
+        for(uint8_t i = 0; i < 5; i++) {
+            x |= shift(x, dir) & opp;
         }
+        moves |= shift(x, dir) & empty;
     }
-    return true;
+    return moves;
 }
 
-bool has_legal_moves(int8_t board[BOARD_SIZE][BOARD_SIZE], int8_t player_color) {
-    for(int i = 0; i < BOARD_SIZE; i++) {
-        for(int j = 0; j < BOARD_SIZE; j++) {
-            if(is_legal_move(board, i, j, player_color)) {
-                return true;
-            }
-        }
-    }
-    return false;
-}
-
-// Calculate the heuristic value of the current board. This function can
-// be replaced with a more complex evaluation function that takes into
-// account factors such as mobility, piece square tables, etc.
-int heuristic(int8_t board[BOARD_SIZE][BOARD_SIZE]) {
-    int white = 0, black = 0;
-    for(int i = 0; i < BOARD_SIZE; i++) {
-        for(int j = 0; j < BOARD_SIZE; j++) {
-            if(board[i][j] == 1) white++;
-            if(board[i][j] == -1) black++;
+// Opponent pieces flipped by placing a piece on `move`
+static uint64_t flips(uint64_t own, uint64_t opp, uint64_t move) {
+    uint64_t flipped = 0;
+    for(uint8_t dir = 0; dir < 8; dir++) {
+        uint64_t line = 0;
+        uint64_t x = shift(move, dir);
+        while(x & opp) {
+            line |= x;
+            x = shift(x, dir);
         }
+        if(x & own) flipped |= line;
     }
-    return white - black;
+    return flipped;
 }
 
-// Make a move on the board and capture any opponent pieces
-void make_move(GameState* state, int x, int y, int player) {
-    state->board[x][y] = player;
-    int opponent = -player;
-    for(int i = -1; i <= 1; i++) {
-        for(int j = -1; j <= 1; j++) {
-            if(i == 0 && j == 0) continue;
-            int r = x + i, c = y + j;
-            if(r >= 0 && r < BOARD_SIZE && c >= 0 && c < BOARD_SIZE &&
-               state->board[r][c] == opponent) {
-                int k = 2;
-                while(true) {
-                    r += i;
-                    c += j;
-                    if(r < 0 || r >= BOARD_SIZE || c < 0 || c >= BOARD_SIZE) break;
-                    if(state->board[r][c] == player) {
-                        r -= i;
-                        c -= j;
-                        while(r != x || c != y) {
-                            state->board[r][c] = player;
-                            r -= i;
-                            c -= j;
-                        }
-                        break;
-                    }
-                    if(state->board[r][c] == 0) break;
-                    k++;
-                }
-            }
-        }
+static int evaluate(uint64_t own, uint64_t opp, uint64_t own_moves) {
+    int score = 0;
+    for(uint64_t b = own; b; b &= b - 1) {
+        score += square_weights[__builtin_ctzll(b)];
     }
-    state->is_game_over = is_game_over(state->board);
+    for(uint64_t b = opp; b; b &= b - 1) {
+        score -= square_weights[__builtin_ctzll(b)];
+    }
+    int mobility = __builtin_popcountll(own_moves) -
+                   __builtin_popcountll(legal_moves(opp, own));
+    return score + MOBILITY_WEIGHT * mobility;
 }
 
-void init_game(GameState* state) {
-    for(int i = 0; i < BOARD_SIZE; i++) {
-        for(int j = 0; j < BOARD_SIZE; j++) {
-            state->board[i][j] = 0;
+static int final_score(uint64_t own, uint64_t opp) {
+    int diff = __builtin_popcountll(own) - __builtin_popcountll(opp);
+    if(diff > 0) return SCORE_WIN + diff;
+    if(diff < 0) return -SCORE_WIN + diff;
+    return 0;
+}
+
+static int
+    negamax(SearchContext* ctx, uint64_t own, uint64_t opp, uint8_t depth, int alpha, int beta) {
+    if(ctx->aborted) return 0;
+    if((++ctx->nodes & SEARCH_CHECK_MASK) == 0 && furi_get_tick() - ctx->start >= ctx->budget) {
+        ctx->aborted = true;
+        return 0;
+    }
+
+    uint64_t moves = legal_moves(own, opp);
+    if(!moves) {
+        if(!legal_moves(opp, own)) return final_score(own, opp);
+        // pass
+        return -negamax(ctx, opp, own, depth, -beta, -alpha);
+    }
+    if(depth == 0) return evaluate(own, opp, moves);
+
+    // try the corners first, they are the most likely to cut the search
+    uint64_t ordered[2] = {moves & CORNERS, moves & ~CORNERS};
+    for(uint8_t i = 0; i < 2; i++) {
+        for(uint64_t b = ordered[i]; b; b &= b - 1) {
+            uint64_t move = b & -b;
+            uint64_t flipped = flips(own, opp, move);
+            int score =
+                -negamax(ctx, opp & ~flipped, own | flipped | move, depth - 1, -beta, -alpha);
+            if(ctx->aborted) return 0;
+            if(score >= beta) return score;
+            if(score > alpha) alpha = score;
         }
     }
+    return alpha;
+}
+
+static uint64_t* player_pieces(GameState* state, int8_t player) {
+    return player == BLACK ? &state->black : &state->white;
+}
 
+static uint64_t player_pieces_const(const GameState* state, int8_t player) {
+    return player == BLACK ? state->black : state->white;
+}
+
+static uint64_t player_moves(const GameState* state, int8_t player) {
+    return legal_moves(player_pieces_const(state, player), player_pieces_const(state, -player));
+}
+
+// Check if the game is over by checking if there are no more moves left for
+// either player
+static bool is_game_over(const GameState* state) {
+    return !player_moves(state, BLACK) && !player_moves(state, WHITE);
+}
+
+// Make a move on the board and capture any opponent pieces
+static void make_move(GameState* state, int8_t square, int8_t player) {
+    uint64_t* own = player_pieces(state, player);
+    uint64_t* opp = player_pieces(state, -player);
+    uint64_t flipped = flips(*own, *opp, BIT(square));
+    *own |= flipped | BIT(square);
+    *opp &= ~flipped;
+    state->is_game_over = is_game_over(state);
+}
+
+void init_game(GameState* state) {
     // Place the initial pieces
     int mid = BOARD_SIZE / 2;
-    state->board[mid - 1][mid - 1] = WHITE;
-    state->board[mid][mid] = WHITE;
-    state->board[mid - 1][mid] = BLACK;
-    state->board[mid][mid - 1] = BLACK;
+    state->white = BIT(SQUARE(mid - 1, mid - 1)) | BIT(SQUARE(mid, mid));
+    state->black = BIT(SQUARE(mid - 1, mid)) | BIT(SQUARE(mid, mid - 1));
 
     state->cursor_x = mid - 1;
     state->cursor_y = mid + 1;
@@ -123,6 +196,24 @@ void init_game(GameState* state) {
     state->current_player = WHITE;
 
     state->is_game_over = false;
+    if(state->difficulty >= DifficultyCount) {
+        state->difficulty = DifficultyNormal;
+    }
+}
+
+int8_t get_piece(const GameState* state, uint8_t x, uint8_t y) {
+    uint64_t bit = BIT(SQUARE(x, y));
+    if(state->black & bit) return BLACK;
+    if(state->white & bit) return WHITE;
+    return 0;
+}
+
+uint8_t count_pieces(const GameState* state, int8_t player) {
+    return __builtin_popcountll(player_pieces_const(state, player));
+}
+
+const char* difficulty_name(uint8_t difficulty) {
+    return difficulty_levels[difficulty % DifficultyCount].name;
 }
 
 void human_move(GameState* game_state) {
@@ -130,39 +221,70 @@ void human_move(GameState* game_state) {
         return;
     }
 
-    if(is_legal_move(
-           game_state->board,
-           game_state->cursor_x,
-           game_state->cursor_y,
-           game_state->current_player)) {
-        make_move(
-            game_state, game_state->cursor_x, game_state->cursor_y, game_state->current_player);
+    int8_t square = SQUARE(game_state->cursor_x, game_state->cursor_y);
+    if(player_moves(game_state, game_state->current_player) & BIT(square)) {
+        make_move(game_state, square, game_state->current_player);
         game_state->current_player = -game_state->current_player;
     }
 }
 
-void computer_move(GameState* game_state) {
-    if(game_state->current_player == game_state->human_color) {
-        return;
-    }
-    int best_row = -1, best_col = -1, best_score = -1000000;
-    for(int i = 0; i < BOARD_SIZE; i++) {
-        for(int j = 0; j < BOARD_SIZE; j++) {
-            if(!is_legal_move(game_state->board, i, j, game_state->current_player)) {
-                continue;
-            }
-            int score = heuristic(game_state->board);
-            if(score > best_score) {
-                best_score = score;
-                best_row = i;
-                best_col = j;
+// Iterative deepening: every finished depth replaces the best move, a depth cut short by
+// the time budget is thrown away
+int8_t computer_think(const GameState* game_state) {
+    uint64_t own = player_pieces_const(game_state, game_state->current_player);
+    uint64_t opp = player_pieces_const(game_state, -game_state->current_player);
+    uint64_t moves = legal_moves(own, opp);
+    if(!moves) return -1;
+
+    const DifficultyLevel* level = &difficulty_levels[game_state->difficulty % DifficultyCount];
+    SearchContext ctx = {
+        .start = furi_get_tick(),
+        .budget = furi_ms_to_ticks(level->time_ms),
+        .nodes = 0,
+        .aborted = false,
+    };
+    uint8_t empties = __builtin_popcountll(~(own | opp));
+
+    int8_t best = __builtin_ctzll(moves);
+    for(uint8_t depth = 1; depth <= level->depth && !ctx.aborted; depth++) {
+        int8_t iteration_best = best;
+        int alpha = -SCORE_INFINITY;
+
+        // the previous best move goes first
+        uint64_t ordered[2] = {BIT(best), moves & ~BIT(best)};
+        for(uint8_t i = 0; i < 2 && !ctx.aborted; i++) {
+            for(uint64_t b = ordered[i]; b && !ctx.aborted; b &= b - 1) {
+                uint64_t move = b & -b;
+                uint64_t flipped = flips(own, opp, move);
+                int score = -negamax(
+                    &ctx,
+                    opp & ~flipped,
+                    own | flipped | move,
+                    depth - 1,
+                    -SCORE_INFINITY,
+                    -alpha);
+                if(!ctx.aborted && score > alpha) {
+                    alpha = score;
+                    iteration_best = __builtin_ctzll(move);
+                }
             }
         }
+
+        if(!ctx.aborted) best = iteration_best;
+        // the whole game has been searched, going deeper changes nothing
+        if(depth >= empties) break;
+    }
+    return best;
+}
+
+void computer_move(GameState* game_state, int8_t square) {
+    if(game_state->current_player == game_state->human_color) {
+        return;
     }
-    if(best_row != -1) {
-        make_move(game_state, best_row, best_col, game_state->current_player);
+    if(square >= 0) {
+        make_move(game_state, square, game_state->current_player);
     }
-    if(has_legal_moves(game_state->board, game_state->human_color)) {
+    if(player_moves(game_state, game_state->human_color)) {
         game_state->current_player = -game_state->current_player;
     }
 }
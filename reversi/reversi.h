@@ -7,15 +7,32 @@
 #define WHITE -1
 #define BOARD_SIZE 8
 
+typedef enum {
+    DifficultyEasy,
+    DifficultyNormal,
+    DifficultyHard,
+    DifficultyCount,
+} Difficulty;
+
+// The board is kept as two bitboards, bit (y * BOARD_SIZE + x) is the cell at column x, row y
 typedef struct {
-    int8_t board[BOARD_SIZE][BOARD_SIZE];
+    uint64_t black;
+    uint64_t white;
     int8_t current_player;
     int8_t human_color;
     uint8_t cursor_x;
     uint8_t cursor_y;
     uint8_t is_game_over;
+    uint8_t difficulty;
 } GameState;
 
 void init_game(GameState* state);
-void computer_move(GameState* game_state);
+int8_t get_piece(const GameState* state, uint8_t x, uint8_t y);
+uint8_t count_pieces(const GameState* state, int8_t player);
+const char* difficulty_name(uint8_t difficulty);
+
+// Searches for the computer's move, returns the square index or -1 if it has to pass.
+// Only reads the state, so it can run while the GUI is drawing it.
+int8_t computer_think(const GameState* game_state);
+void computer_move(GameState* game_state, int8_t square);
 void human_move(GameState* game_state);
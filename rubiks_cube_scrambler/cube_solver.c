@@ -0,0 +1,697 @@
+#include "cube_solver.h"
+#include <furi_hal_random.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TABLES_PATH APP_DATA_PATH("pruning.bin")
+#define TABLES_MAGIC 0x45425543 // "CUBE"
+#define TABLES_VERSION 2
+
+#define TWIST_COUNT 2187 // 3^7 corner orientations
+#define FLIP_COUNT 2048 // 2^11 edge orientations
+#define SLICE_COUNT 495 // positions of the 4 middle layer edges, 12 choose 4
+#define SUBSET_COUNT 70 // 4 out of 8 positions
+#define CORNER_CLASS_COUNT 6
+#define TETRADS_COUNT (SUBSET_COUNT * CORNER_CLASS_COUNT * SUBSET_COUNT)
+#define HALF_CORNERS_COUNT 96 // corner permutations made of half turns
+#define HALF_TURNS_COUNT (HALF_CORNERS_COUNT * 24 * 24)
+#define HALF_EDGES_COUNT (24 * 24 * 24) // edges within their own slice
+#define UNKNOWN 0xf
+
+#define STAGE_COUNT 4
+#define STOP_CHECK_INTERVAL 1024
+
+enum { URF, UFL, ULB, UBR, DFR, DLF, DBL, DRB };
+enum { UR, UF, UL, UB, DR, DF, DL, DB, FR, FL, BL, BR };
+
+typedef struct {
+    uint8_t cp[8]; // corner at each position
+    uint8_t co[8]; // its twist, 0..2
+    uint8_t ep[12]; // edge at each position
+    uint8_t eo[12]; // its flip, 0..1
+} Cube;
+
+// Distances to the goal of every stage, 4 bits per entry in the big tables
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint8_t flip[FLIP_COUNT];
+    uint8_t twist[TWIST_COUNT];
+    uint8_t slice[SLICE_COUNT];
+    uint8_t tetrads[TETRADS_COUNT / 2];
+    uint8_t half_turns[HALF_TURNS_COUNT / 2];
+    uint8_t half_edges[HALF_EDGES_COUNT / 2];
+} PruningTables;
+
+typedef struct {
+    Cube cubes[CUBE_SOLVER_MAX_MOVES + 1];
+    uint8_t moves[CUBE_SOLVER_MAX_MOVES];
+    uint8_t stage;
+    uint32_t nodes;
+    volatile bool* stop;
+    bool aborted;
+} Search;
+
+struct CubeSolver {
+    Cube moves[CUBE_MOVE_COUNT];
+    PruningTables* tables;
+};
+
+// Ranks of the corner permutations made of half turns, sorted
+static uint16_t half_corners[HALF_CORNERS_COUNT];
+// Class of the corner order within both tetrads, indexed by the ranks of both orders
+static uint8_t corner_classes[24 * 24];
+static uint16_t corner_class_orders[CORNER_CLASS_COUNT];
+
+// clang-format off
+static const Cube face_turns[6] = {
+    // U
+    {{UBR, URF, UFL, ULB, DFR, DLF, DBL, DRB}, {0, 0, 0, 0, 0, 0, 0, 0},
+     {UB, UR, UF, UL, DR, DF, DL, DB, FR, FL, BL, BR}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}},
+    // R
+    {{DFR, UFL, ULB, URF, DRB, DLF, DBL, UBR}, {2, 0, 0, 1, 1, 0, 0, 2},
+     {FR, UF, UL, UB, BR, DF, DL, DB, DR, FL, BL, UR}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}},
+    // F
+    {{UFL, DLF, ULB, UBR, URF, DFR, DBL, DRB}, {1, 2, 0, 0, 2, 1, 0, 0},
+     {UR, FL, UL, UB, DR, FR, DL, DB, UF, DF, BL, BR}, {0, 1, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0}},
+    // D
+    {{URF, UFL, ULB, UBR, DLF, DBL, DRB, DFR}, {0, 0, 0, 0, 0, 0, 0, 0},
+     {UR, UF, UL, UB, DF, DL, DB, DR, FR, FL, BL, BR}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}},
+    // L
+    {{URF, ULB, DBL, UBR, DFR, UFL, DLF, DRB}, {0, 1, 2, 0, 0, 2, 1, 0},
+     {UR, UF, BL, UB, DR, DF, FL, DB, FR, UL, DL, BR}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}},
+    // B
+    {{URF, UFL, UBR, DRB, DFR, DLF, ULB, DBL}, {0, 0, 1, 2, 0, 0, 2, 1},
+     {UR, UF, UL, BR, DR, DF, DL, BL, FR, FL, UB, DB}, {0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 1, 1}},
+};
+
+// Every stage keeps what the ones before it solved: edge orientations need F and B to be
+// turned twice, corner orientations and the middle layer R and L as well, the corner tetrads
+// and edge slices every face
+static const uint8_t stage_moves[STAGE_COUNT][CUBE_MOVE_COUNT] = {
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17},
+    {0, 1, 2, 3, 4, 5, 7, 9, 10, 11, 12, 13, 14, 16},
+    {0, 1, 2, 4, 7, 9, 10, 11, 13, 16},
+    {1, 4, 7, 10, 13, 16},
+};
+static const uint8_t stage_move_count[STAGE_COUNT] = {18, 14, 10, 6};
+// the longest each stage can take
+static const uint8_t stage_max_length[STAGE_COUNT] = {7, 10, 13, 15};
+static const uint8_t tetrad_corners[2][4] = {{URF, ULB, DLF, DRB}, {UFL, UBR, DFR, DBL}};
+// clang-format on
+
+static void cube_reset(Cube* cube) {
+    for(uint8_t i = 0; i < 8; i++) {
+        cube->cp[i] = i;
+        cube->co[i] = 0;
+    }
+    for(uint8_t i = 0; i < 12; i++) {
+        cube->ep[i] = i;
+        cube->eo[i] = 0;
+    }
+}
+
+// The cube `a` turned by `b`
+static void cube_multiply(const Cube* a, const Cube* b, Cube* result) {
+    for(uint8_t i = 0; i < 8; i++) {
+        result->cp[i] = a->cp[b->cp[i]];
+        uint8_t twist = a->co[b->cp[i]] + b->co[i];
+        result->co[i] = twist >= 3 ? twist - 3 : twist;
+    }
+    for(uint8_t i = 0; i < 12; i++) {
+        result->ep[i] = a->ep[b->ep[i]];
+        result->eo[i] = a->eo[b->ep[i]] ^ b->eo[i];
+    }
+}
+
+static uint16_t choose(uint8_t n, uint8_t k) {
+    if(k > n) return 0;
+    uint16_t result = 1;
+    for(uint8_t i = 1; i <= k; i++) {
+        result = result * (n - k + i) / i;
+    }
+    return result;
+}
+
+// Lehmer code of a permutation of 0..count-1
+static uint16_t perm_rank(const uint8_t* perm, uint8_t count) {
+    uint16_t rank = 0;
+    for(uint8_t i = 0; i < count; i++) {
+        uint8_t smaller = 0;
+        for(uint8_t j = i + 1; j < count; j++) {
+            if(perm[j] < perm[i]) smaller++;
+        }
+        rank = rank * (count - i) + smaller;
+    }
+    return rank;
+}
+
+static void perm_unrank(uint16_t rank, uint8_t* perm, uint8_t count) {
+    uint8_t digits[8];
+    for(int8_t i = count - 1; i >= 0; i--) {
+        digits[i] = rank % (count - i);
+        rank /= count - i;
+    }
+    uint8_t used = 0;
+    for(uint8_t i = 0; i < count; i++) {
+        uint8_t value = 0;
+        for(uint8_t skip = digits[i];; value++) {
+            if(used & (1 << value)) continue;
+            if(skip-- == 0) break;
+        }
+        used |= 1 << value;
+        perm[i] = value;
+    }
+}
+
+static uint16_t flip_get(const Cube* cube) {
+    uint16_t flip = 0;
+    for(uint8_t i = 0; i < 11; i++) {
+        flip = flip * 2 + cube->eo[i];
+    }
+    return flip;
+}
+
+static void flip_set(Cube* cube, uint16_t flip) {
+    uint8_t sum = 0;
+    for(int8_t i = 10; i >= 0; i--) {
+        cube->eo[i] = flip & 1;
+        sum += cube->eo[i];
+        flip >>= 1;
+    }
+    cube->eo[11] = sum & 1;
+}
+
+static uint16_t twist_get(const Cube* cube) {
+    uint16_t twist = 0;
+    for(uint8_t i = 0; i < 7; i++) {
+        twist = twist * 3 + cube->co[i];
+    }
+    return twist;
+}
+
+static void twist_set(Cube* cube, uint16_t twist) {
+    uint8_t sum = 0;
+    for(int8_t i = 6; i >= 0; i--) {
+        cube->co[i] = twist % 3;
+        sum += cube->co[i];
+        twist /= 3;
+    }
+    cube->co[7] = (3 - sum % 3) % 3;
+}
+
+// 0 when the middle layer edges are in the middle layer, in any order
+static uint16_t slice_get(const Cube* cube) {
+    uint16_t slice = 0;
+    uint8_t found = 0;
+    for(int8_t i = 11; i >= 0; i--) {
+        if(cube->ep[i] >= FR) slice += choose(11 - i, ++found);
+    }
+    return slice;
+}
+
+static void slice_set(Cube* cube, uint16_t slice) {
+    uint8_t left = 4;
+    for(uint8_t i = 0; i < 12; i++) {
+        uint16_t count = choose(11 - i, left);
+        if(left && slice >= count) {
+            slice -= count;
+            cube->ep[i] = FR;
+            left--;
+        } else {
+            cube->ep[i] = UR;
+        }
+    }
+}
+
+static uint16_t corners_get(const Cube* cube) {
+    return perm_rank(cube->cp, 8);
+}
+
+static void corners_set(Cube* cube, uint16_t rank) {
+    perm_unrank(rank, cube->cp, 8);
+}
+
+// Index of a set of 4 out of the first 8 positions
+static uint8_t subset_get(const uint8_t* pieces, bool (*in_set)(uint8_t)) {
+    uint8_t subset = 0;
+    uint8_t found = 0;
+    for(int8_t i = 7; i >= 0; i--) {
+        if(in_set(pieces[i])) subset += choose(7 - i, ++found);
+    }
+    return subset;
+}
+
+static void subset_set(uint8_t subset, bool* in_set) {
+    uint8_t left = 4;
+    for(uint8_t i = 0; i < 8; i++) {
+        uint8_t count = choose(7 - i, left);
+        in_set[i] = left && subset >= count;
+        if(in_set[i]) {
+            subset -= count;
+            left--;
+        }
+    }
+}
+
+// Half turns never take a corner out of its tetrad, the corners of a tetrad are numbered
+// by their index halved
+static bool corner_in_first_tetrad(uint8_t corner) {
+    return tetrad_corners[0][corner / 2] == corner;
+}
+
+// Edges at even positions belong to the slice between F and B, odd ones to the slice between
+// R and L
+static bool edge_in_odd_slice(uint8_t edge) {
+    return edge & 1;
+}
+
+// Which right coset of the half turn group the corners are in: where the first tetrad is and
+// the class of the order within both tetrads. Combined with the positions of the odd slice
+// edges this tells exactly how far stage 3 is from its goal.
+static uint16_t tetrads_get(const Cube* cube) {
+    uint8_t perms[2][4];
+    uint8_t counts[2] = {0, 0};
+    for(uint8_t i = 0; i < 8; i++) {
+        uint8_t tetrad = !corner_in_first_tetrad(cube->cp[i]);
+        perms[tetrad][counts[tetrad]++] = cube->cp[i] / 2;
+    }
+    uint8_t order = corner_classes[perm_rank(perms[0], 4) * 24 + perm_rank(perms[1], 4)];
+    uint16_t corners = subset_get(cube->cp, corner_in_first_tetrad) * CORNER_CLASS_COUNT + order;
+    return corners * SUBSET_COUNT + subset_get(cube->ep, edge_in_odd_slice);
+}
+
+static void tetrads_set(Cube* cube, uint16_t coordinate) {
+    bool in_set[8];
+    uint8_t perms[2][4];
+    uint8_t counts[2] = {0, 0};
+
+    subset_set(coordinate % SUBSET_COUNT, in_set);
+    for(uint8_t i = 0; i < 8; i++) {
+        cube->ep[i] = in_set[i] ? counts[1]++ * 2 + 1 : counts[0]++ * 2;
+    }
+
+    coordinate /= SUBSET_COUNT;
+    uint16_t order = corner_class_orders[coordinate % CORNER_CLASS_COUNT];
+    perm_unrank(order / 24, perms[0], 4);
+    perm_unrank(order % 24, perms[1], 4);
+    subset_set(coordinate / CORNER_CLASS_COUNT, in_set);
+    counts[0] = counts[1] = 0;
+    for(uint8_t i = 0; i < 8; i++) {
+        uint8_t tetrad = !in_set[i];
+        cube->cp[i] = tetrad_corners[tetrad][perms[tetrad][counts[tetrad]++]];
+    }
+}
+
+static uint16_t half_corners_get(const Cube* cube) {
+    uint16_t rank = corners_get(cube);
+    uint8_t low = 0;
+    uint8_t high = HALF_CORNERS_COUNT - 1;
+    while(low < high) {
+        uint8_t middle = (low + high) / 2;
+        if(half_corners[middle] < rank) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+// The order of the edges within the slice between F and B, between R and L and the middle
+// layer
+static void slice_perms_get(const Cube* cube, uint8_t* ranks) {
+    uint8_t perm[4];
+    for(uint8_t slice = 0; slice < 3; slice++) {
+        for(uint8_t i = 0; i < 4; i++) {
+            perm[i] = slice < 2 ? cube->ep[i * 2 + slice] / 2 : cube->ep[FR + i] - FR;
+        }
+        ranks[slice] = perm_rank(perm, 4);
+    }
+}
+
+static void slice_perms_set(Cube* cube, const uint8_t* ranks) {
+    uint8_t perm[4];
+    for(uint8_t slice = 0; slice < 3; slice++) {
+        perm_unrank(ranks[slice], perm, 4);
+        for(uint8_t i = 0; i < 4; i++) {
+            if(slice < 2) {
+                cube->ep[i * 2 + slice] = perm[i] * 2 + slice;
+            } else {
+                cube->ep[FR + i] = perm[i] + FR;
+            }
+        }
+    }
+}
+
+// The corners with the order of the edges in the U and D layers
+static uint16_t half_turns_get(const Cube* cube) {
+    uint8_t ranks[3];
+    slice_perms_get(cube, ranks);
+    return (half_corners_get(cube) * 24 + ranks[1]) * 24 + ranks[0];
+}
+
+static void half_turns_set(Cube* cube, uint16_t coordinate) {
+    uint8_t ranks[3] = {coordinate % 24, coordinate / 24 % 24, 0};
+    slice_perms_set(cube, ranks);
+    corners_set(cube, half_corners[coordinate / (24 * 24)]);
+}
+
+static uint16_t half_edges_get(const Cube* cube) {
+    uint8_t ranks[3];
+    slice_perms_get(cube, ranks);
+    return (ranks[2] * 24 + ranks[1]) * 24 + ranks[0];
+}
+
+static void half_edges_set(Cube* cube, uint16_t coordinate) {
+    uint8_t ranks[3] = {coordinate % 24, coordinate / 24 % 24, coordinate / (24 * 24)};
+    slice_perms_set(cube, ranks);
+}
+
+static uint8_t table_get(const uint8_t* table, bool packed, uint16_t index) {
+    if(!packed) return table[index];
+    return index & 1 ? table[index / 2] >> 4 : table[index / 2] & 0xf;
+}
+
+static void table_set(uint8_t* table, bool packed, uint16_t index, uint8_t value) {
+    if(!packed) {
+        table[index] = value;
+    } else if(index & 1) {
+        table[index / 2] = (table[index / 2] & 0x0f) | (value << 4);
+    } else {
+        table[index / 2] = (table[index / 2] & 0xf0) | value;
+    }
+}
+
+// Breadth first search over one coordinate from the solved state. Coordinates the moves
+// can't reach stay UNKNOWN.
+static void table_generate(
+    CubeSolver* solver,
+    uint8_t* table,
+    bool packed,
+    uint16_t count,
+    uint16_t (*get)(const Cube*),
+    void (*set)(Cube*, uint16_t),
+    uint8_t stage) {
+    Cube cube;
+    Cube turned;
+    cube_reset(&cube);
+    memset(table, packed ? 0xff : UNKNOWN, packed ? count / 2 : count);
+    table_set(table, packed, get(&cube), 0);
+
+    bool found = true;
+    for(uint8_t depth = 0; found; depth++) {
+        found = false;
+        for(uint16_t index = 0; index < count; index++) {
+            if(table_get(table, packed, index) != depth) continue;
+            set(&cube, index);
+            for(uint8_t i = 0; i < stage_move_count[stage]; i++) {
+                cube_multiply(&cube, &solver->moves[stage_moves[stage][i]], &turned);
+                uint16_t next = get(&turned);
+                if(table_get(table, packed, next) == UNKNOWN) {
+                    table_set(table, packed, next, depth + 1);
+                    found = true;
+                }
+            }
+        }
+    }
+}
+
+static void tables_generate(CubeSolver* solver) {
+    PruningTables* tables = solver->tables;
+    tables->magic = TABLES_MAGIC;
+    tables->version = TABLES_VERSION;
+    table_generate(solver, tables->flip, false, FLIP_COUNT, flip_get, flip_set, 0);
+    table_generate(solver, tables->twist, false, TWIST_COUNT, twist_get, twist_set, 1);
+    table_generate(solver, tables->slice, false, SLICE_COUNT, slice_get, slice_set, 1);
+    table_generate(solver, tables->tetrads, true, TETRADS_COUNT, tetrads_get, tetrads_set, 2);
+    table_generate(
+        solver, tables->half_turns, true, HALF_TURNS_COUNT, half_turns_get, half_turns_set, 3);
+    table_generate(
+        solver, tables->half_edges, true, HALF_EDGES_COUNT, half_edges_get, half_edges_set, 3);
+}
+
+// Closes the solved corners under the half turns, the list is kept sorted
+static void half_corners_generate(CubeSolver* solver) {
+    uint8_t count = 1;
+    half_corners[0] = 0;
+    Cube cube;
+    Cube turned;
+    cube_reset(&cube);
+    for(uint8_t done = 0; done < count; done++) {
+        corners_set(&cube, half_corners[done]);
+        for(uint8_t i = 0; i < stage_move_count[3]; i++) {
+            cube_multiply(&cube, &solver->moves[stage_moves[3][i]], &turned);
+            uint16_t rank = corners_get(&turned);
+            uint8_t at = count;
+            for(uint8_t j = 0; j < count; j++) {
+                if(half_corners[j] >= rank) {
+                    at = j;
+                    break;
+                }
+            }
+            if(at < count && half_corners[at] == rank) continue;
+            furi_check(count < HALF_CORNERS_COUNT);
+            memmove(&half_corners[at + 1], &half_corners[at], (count - at) * sizeof(uint16_t));
+            half_corners[at] = rank;
+            count++;
+            // the one being expanded moved along
+            if(at <= done) done++;
+        }
+    }
+}
+
+// Orders within the tetrads are in the same class when a half turn permutation relabels one
+// into the other
+static void corner_classes_generate(void) {
+    uint8_t perms[2][4];
+    uint8_t relabeled[2][4];
+    Cube cube;
+    uint8_t classes = 0;
+    memset(corner_classes, 0xff, sizeof(corner_classes));
+    for(uint16_t order = 0; order < 24 * 24; order++) {
+        if(corner_classes[order] != 0xff) continue;
+        perm_unrank(order / 24, perms[0], 4);
+        perm_unrank(order % 24, perms[1], 4);
+        for(uint8_t i = 0; i < HALF_CORNERS_COUNT; i++) {
+            corners_set(&cube, half_corners[i]);
+            for(uint8_t tetrad = 0; tetrad < 2; tetrad++) {
+                for(uint8_t j = 0; j < 4; j++) {
+                    relabeled[tetrad][j] = cube.cp[tetrad_corners[tetrad][perms[tetrad][j]]] / 2;
+                }
+            }
+            corner_classes[perm_rank(relabeled[0], 4) * 24 + perm_rank(relabeled[1], 4)] =
+                classes;
+        }
+        furi_check(classes < CORNER_CLASS_COUNT);
+        corner_class_orders[classes++] = order;
+    }
+}
+
+CubeSolver* cube_solver_alloc(void) {
+    CubeSolver* solver = malloc(sizeof(CubeSolver));
+    solver->tables = NULL;
+
+    // every move is the quarter turn of its face done one to three times
+    for(uint8_t face = 0; face < 6; face++) {
+        Cube cube;
+        cube_reset(&cube);
+        for(uint8_t turn = 0; turn < 3; turn++) {
+            cube_multiply(&cube, &face_turns[face], &solver->moves[face * 3 + turn]);
+            cube = solver->moves[face * 3 + turn];
+        }
+    }
+    half_corners_generate(solver);
+    corner_classes_generate();
+    return solver;
+}
+
+void cube_solver_free(CubeSolver* solver) {
+    free(solver->tables);
+    free(solver);
+}
+
+bool cube_solver_load_tables(CubeSolver* solver, Storage* storage) {
+    if(solver->tables) return true;
+    // malloc() would crash the app rather than fail
+    if(memmgr_heap_get_max_free_block() < sizeof(PruningTables) + 8 * 1024) return false;
+    solver->tables = malloc(sizeof(PruningTables));
+
+    File* file = storage_file_alloc(storage);
+    bool loaded = false;
+    if(storage_file_open(file, TABLES_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        loaded = storage_file_read(file, solver->tables, sizeof(PruningTables)) ==
+                     sizeof(PruningTables) &&
+                 solver->tables->magic == TABLES_MAGIC &&
+                 solver->tables->version == TABLES_VERSION;
+    }
+    storage_file_close(file);
+
+    if(!loaded) {
+        tables_generate(solver);
+        // without an SD card the tables are generated again on the next start
+        if(storage_file_open(file, TABLES_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+            storage_file_write(file, solver->tables, sizeof(PruningTables));
+        }
+        storage_file_close(file);
+    }
+
+    storage_file_free(file);
+    return true;
+}
+
+static bool move_redundant(uint8_t last, uint8_t move) {
+    uint8_t last_face = last / 3;
+    uint8_t face = move / 3;
+    // turns of opposite faces commute, only one order is tried
+    return face == last_face || (face == (last_face + 3) % 6 && face < last_face);
+}
+
+// Lower bound of the moves left in the stage, 0 exactly when it is done
+static uint8_t stage_distance(const CubeSolver* solver, uint8_t stage, const Cube* cube) {
+    const PruningTables* tables = solver->tables;
+    switch(stage) {
+    case 0:
+        return tables->flip[flip_get(cube)];
+    case 1:
+        return MAX(tables->twist[twist_get(cube)], tables->slice[slice_get(cube)]);
+    case 2:
+        return table_get(tables->tetrads, true, tetrads_get(cube));
+    default:
+        return MAX(
+            table_get(tables->half_turns, true, half_turns_get(cube)),
+            table_get(tables->half_edges, true, half_edges_get(cube)));
+    }
+}
+
+static bool search_aborted(Search* search) {
+    if(++search->nodes % STOP_CHECK_INTERVAL == 0 && *search->stop) search->aborted = true;
+    return search->aborted;
+}
+
+// Depth first up to `togo` more moves, returns true once the stage is done or the search was
+// aborted
+static bool
+    stage_search(const CubeSolver* solver, Search* search, uint8_t depth, uint8_t togo) {
+    if(togo == 0) return true;
+
+    const Cube* cube = &search->cubes[depth];
+    for(uint8_t i = 0; i < stage_move_count[search->stage]; i++) {
+        uint8_t move = stage_moves[search->stage][i];
+        if(depth && move_redundant(search->moves[depth - 1], move)) continue;
+
+        Cube* next = &search->cubes[depth + 1];
+        cube_multiply(cube, &solver->moves[move], next);
+        if(search_aborted(search)) return true;
+        if(stage_distance(solver, search->stage, next) > togo - 1) continue;
+
+        search->moves[depth] = move;
+        if(stage_search(solver, search, depth + 1, togo - 1)) return true;
+    }
+    return false;
+}
+
+// Iterative deepening, so every stage takes as few moves as it can
+static uint8_t stage_solve(const CubeSolver* solver, Search* search, uint8_t depth) {
+    uint8_t length = stage_distance(solver, search->stage, &search->cubes[depth]);
+    while(!stage_search(solver, search, depth, length)) {
+        length++;
+        furi_check(length <= stage_max_length[search->stage]);
+    }
+    return length;
+}
+
+static uint32_t random_below(uint32_t count) {
+    // rejecting the top of the range keeps every value equally likely
+    uint32_t limit = UINT32_MAX - UINT32_MAX % count;
+    uint32_t value;
+    do {
+        value = furi_hal_random_get();
+    } while(value >= limit);
+    return value % count;
+}
+
+static bool perm_is_odd(const uint8_t* perm, uint8_t count) {
+    bool odd = false;
+    for(uint8_t i = 0; i < count; i++) {
+        for(uint8_t j = i + 1; j < count; j++) {
+            if(perm[j] < perm[i]) odd = !odd;
+        }
+    }
+    return odd;
+}
+
+// Every reachable state is equally likely: random permutations with matching parity and
+// random orientations whose last piece makes them valid
+static void cube_randomize(Cube* cube) {
+    cube_reset(cube);
+    for(uint8_t i = 7; i > 0; i--) {
+        uint8_t j = random_below(i + 1);
+        uint8_t corner = cube->cp[i];
+        cube->cp[i] = cube->cp[j];
+        cube->cp[j] = corner;
+    }
+    for(uint8_t i = 11; i > 0; i--) {
+        uint8_t j = random_below(i + 1);
+        uint8_t edge = cube->ep[i];
+        cube->ep[i] = cube->ep[j];
+        cube->ep[j] = edge;
+    }
+    if(perm_is_odd(cube->cp, 8) != perm_is_odd(cube->ep, 12)) {
+        uint8_t edge = cube->ep[0];
+        cube->ep[0] = cube->ep[1];
+        cube->ep[1] = edge;
+    }
+    twist_set(cube, random_below(TWIST_COUNT));
+    flip_set(cube, random_below(FLIP_COUNT));
+}
+
+// Turns of the same face where one stage ends and the next begins add up
+static uint8_t moves_merge(uint8_t* moves, uint8_t count) {
+    uint8_t length = 0;
+    for(uint8_t i = 0; i < count; i++) {
+        if(length && moves[length - 1] / 3 == moves[i] / 3) {
+            uint8_t face = moves[i] / 3;
+            uint8_t turns = (moves[length - 1] % 3 + moves[i] % 3 + 2) % 4;
+            if(turns) {
+                moves[length - 1] = face * 3 + turns - 1;
+            } else {
+                length--;
+            }
+        } else {
+            moves[length++] = moves[i];
+        }
+    }
+    return length;
+}
+
+uint8_t cube_solver_random_scramble(CubeSolver* solver, uint8_t* moves, volatile bool* stop) {
+    furi_assert(solver->tables);
+    Search* search = malloc(sizeof(Search));
+    search->nodes = 0;
+    search->stop = stop;
+    search->aborted = false;
+
+    cube_randomize(&search->cubes[0]);
+    uint8_t length = 0;
+    for(search->stage = 0; search->stage < STAGE_COUNT && !search->aborted; search->stage++) {
+        length += stage_solve(solver, search, length);
+    }
+    if(search->aborted) length = 0;
+    length = moves_merge(search->moves, length);
+
+    // the scramble undoes the solution: reversed, every turn the other way
+    for(uint8_t i = 0; i < length; i++) {
+        uint8_t move = search->moves[length - 1 - i];
+        moves[i] = move / 3 * 3 + (2 - move % 3);
+    }
+
+    free(search);
+    return length;
+}
+
+void cube_solver_move_name(uint8_t move, char* name) {
+    static const char faces[] = "URFDLB";
+    static const char* const turns[] = {"", "2", "'"};
+    snprintf(name, 3, "%c%s", faces[move / 3], turns[move % 3]);
+}
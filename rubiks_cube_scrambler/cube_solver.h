@@ -0,0 +1,29 @@
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+
+// Thistlethwaite's four stage solver. Each stage solves the cube a bit further with fewer kinds
+// of moves: first the edge orientations, then the corner orientations with the middle layer
+// edges, then the corner tetrads and the other edge slices, and the rest with half turns.
+// Every stage is searched for its shortest solution with small pruning tables.
+
+#define CUBE_SOLVER_MAX_MOVES 45
+// a move is face * 3 + turn, faces are U R F D L B and turns are clockwise, half, counter
+#define CUBE_MOVE_COUNT 18
+
+typedef struct CubeSolver CubeSolver;
+
+CubeSolver* cube_solver_alloc(void);
+void cube_solver_free(CubeSolver* solver);
+
+// Reads the pruning tables from the SD card, they are generated and saved the first time.
+// Returns false if there isn't enough memory for them.
+bool cube_solver_load_tables(CubeSolver* solver, Storage* storage);
+
+// Scramble of a uniformly random cube state: the solution of that state, inverted.
+// Returns the number of moves, 0 if the search was stopped.
+uint8_t cube_solver_random_scramble(CubeSolver* solver, uint8_t* moves, volatile bool* stop);
+
+// Writes the move in the usual notation, at most 3 characters including the terminator
+void cube_solver_move_name(uint8_t move, char* name);
@@ -4,15 +4,71 @@
 #include <input/input.h>
 #include <gui/elements.h>
 #include <furi_hal.h>
+#include <storage/storage.h>
 
 #include "scrambler.h"
-#include "furi_hal_random.h"
+#include "cube_solver.h"
 
-bool scrambleStarted = false;
-char scramble_str[100] = {0};
-char scramble_start[100] = {0};
-char scramble_end[100] = {0};
-bool notifications_enabled = false;
+#define TICK_MS 50
+// WCA inspection: starting after 15 s costs 2 s, after 17 s the attempt is a DNF
+#define INSPECTION_MS 15000
+#define INSPECTION_LIMIT_MS 17000
+#define PENALTY_MS 2000
+#define NO_TIME 0
+#define DNF UINT32_MAX
+#define RECENT_COUNT 12
+#define MOVES_PER_LINE 9
+
+typedef enum {
+    ScreenScramble,
+    ScreenInspection,
+    ScreenTiming,
+    ScreenResult,
+    ScreenStats,
+} Screen;
+
+typedef enum {
+    WorkerFlagGenerate = 1 << 0,
+    WorkerFlagStop = 1 << 1,
+} WorkerFlag;
+
+typedef struct {
+    uint8_t moves[CUBE_SOLVER_MAX_MOVES];
+    uint8_t length; // 0 until it is generated
+} Scramble;
+
+typedef struct {
+    uint32_t recent[RECENT_COUNT]; // the last results in a ring, DNF for did not finish
+    uint16_t count;
+    uint16_t finished;
+    uint32_t total;
+    uint32_t best;
+    uint32_t best_ao5;
+    uint32_t best_ao12;
+} Session;
+
+typedef struct {
+    FuriMessageQueue* event_queue;
+    ViewPort* view_port;
+    FuriMutex* mutex;
+    FuriThread* worker;
+    CubeSolver* solver;
+    volatile bool stop;
+
+    // the worker fills these, the next scramble is ready before the current one is done
+    bool preparing;
+    Scramble current;
+    Scramble next;
+
+    Screen screen;
+    uint32_t inspection_start;
+    uint8_t calls; // inspection warnings given at 8 and 12 s
+    uint32_t timer_start;
+    bool penalty;
+    uint32_t result;
+    bool vibration;
+    Session session;
+} ScramblerApp;
 
 static void success_vibration() {
     furi_hal_vibro_on(false);
@@ -21,43 +77,239 @@ static void success_vibration() {
     furi_hal_vibro_on(false);
     return;
 }
-void split_array(char original[], int size, char first[], char second[]) {
-    int32_t mid = size / 2;
-    if(size % 2 != 0) {
-        mid++;
+
+static void format_time(uint32_t time, char* buffer, size_t size) {
+    if(time == NO_TIME) {
+        snprintf(buffer, size, "-");
+    } else if(time == DNF) {
+        snprintf(buffer, size, "DNF");
+    } else if(time >= 60000) {
+        snprintf(buffer, size, "%lu:%02lu.%02lu", time / 60000, time / 1000 % 60, time / 10 % 100);
+    } else {
+        snprintf(buffer, size, "%lu.%02lu", time / 1000, time / 10 % 100);
+    }
+}
+
+// Average of the last `count` results the WCA way: the best and the worst one don't count,
+// and with more than one DNF the average is a DNF too
+static uint32_t session_average(const Session* session, uint8_t count) {
+    if(session->count < count) return NO_TIME;
+
+    uint32_t times[RECENT_COUNT];
+    for(uint8_t i = 0; i < count; i++) {
+        uint32_t time = session->recent[(session->count - 1 - i) % RECENT_COUNT];
+        uint8_t j = i;
+        for(; j > 0 && times[j - 1] > time; j--) {
+            times[j] = times[j - 1];
+        }
+        times[j] = time;
+    }
+    if(times[count - 2] == DNF) return DNF;
+
+    uint32_t sum = 0;
+    for(uint8_t i = 1; i < count - 1; i++) {
+        sum += times[i];
+    }
+    return (sum + (count - 2) / 2) / (count - 2);
+}
+
+static void session_update_best(uint32_t* best, uint32_t time) {
+    if(time == NO_TIME || time == DNF) return;
+    if(*best == NO_TIME || time < *best) *best = time;
+}
+
+static void session_add(Session* session, uint32_t time) {
+    session->recent[session->count % RECENT_COUNT] = time;
+    session->count++;
+    if(time != DNF) {
+        session->finished++;
+        session->total += time;
     }
-    int32_t first_index = 0, second_index = 0;
-    for(int32_t i = 0; i < size; i++) {
-        if(i < mid) {
-            first[first_index++] = original[i];
+    session_update_best(&session->best, time);
+    session_update_best(&session->best_ao5, session_average(session, 5));
+    session_update_best(&session->best_ao12, session_average(session, 12));
+}
+
+// Called with the mutex held. Without a next scramble yet the current one stays empty until
+// the worker is done.
+static void scramble_advance(ScramblerApp* app) {
+    app->current = app->next;
+    app->next.length = 0;
+    furi_thread_flags_set(furi_thread_get_id(app->worker), WorkerFlagGenerate);
+    if(app->vibration && app->current.length) success_vibration();
+}
+
+static int32_t scrambler_worker(void* context) {
+    ScramblerApp* app = context;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    // the first start generates the tables, that takes a few seconds
+    bool solver = cube_solver_load_tables(app->solver, storage);
+    furi_record_close(RECORD_STORAGE);
+
+    Scramble scramble;
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    app->preparing = false;
+    furi_mutex_release(app->mutex);
+
+    while(!app->stop) {
+        furi_mutex_acquire(app->mutex, FuriWaitForever);
+        bool wanted = !app->current.length || !app->next.length;
+        furi_mutex_release(app->mutex);
+        if(!wanted) {
+            furi_thread_flags_wait(
+                WorkerFlagGenerate | WorkerFlagStop, FuriFlagWaitAny, FuriWaitForever);
+            continue;
+        }
+
+        if(solver) {
+            scramble.length =
+                cube_solver_random_scramble(app->solver, scramble.moves, &app->stop);
         } else {
-            if(i == mid && (original[i] == '2' || original[i] == '\'')) {
-                continue;
-            }
-            second[second_index++] = original[i];
+            scramble.length = scramble_random_moves(scramble.moves);
         }
+        if(app->stop) break;
+
+        furi_mutex_acquire(app->mutex, FuriWaitForever);
+        if(!app->current.length) {
+            app->current = scramble;
+        } else {
+            app->next = scramble;
+        }
+        furi_mutex_release(app->mutex);
+        view_port_update(app->view_port);
     }
-    first[first_index] = '\0';
-    second[second_index] = '\0';
+    return 0;
 }
-void genScramble() {
-    scrambleReplace();
-    strcpy(scramble_str, printData());
-    split_array(scramble_str, strlen(scramble_str), scramble_start, scramble_end);
+
+static void draw_scramble(Canvas* canvas, ScramblerApp* app) {
+    canvas_set_font(canvas, FontSecondary);
+    if(app->current.length) {
+        char name[3];
+        for(uint8_t i = 0; i < app->current.length; i++) {
+            cube_solver_move_name(app->current.moves[i], name);
+            canvas_draw_str(canvas, 1 + i % MOVES_PER_LINE * 14, 9 + i / MOVES_PER_LINE * 9, name);
+        }
+    } else {
+        canvas_draw_str_aligned(
+            canvas,
+            64,
+            24,
+            AlignCenter,
+            AlignCenter,
+            app->preparing ? "Preparing tables..." : "Generating scramble...");
+    }
+    elements_button_left(canvas, app->vibration ? "On" : "Off");
+    if(app->current.length) elements_button_center(canvas, "Start");
+    elements_button_right(canvas, "New");
 }
 
-static void draw_callback(Canvas* canvas, void* ctx) {
-    UNUSED(ctx);
-    canvas_clear(canvas);
+static void draw_inspection(Canvas* canvas, ScramblerApp* app) {
+    char buffer[8];
+    uint32_t elapsed = furi_get_tick() - app->inspection_start;
+    if(elapsed < INSPECTION_MS) {
+        snprintf(buffer, sizeof(buffer), "%lu", (INSPECTION_MS - elapsed + 999) / 1000);
+    } else {
+        snprintf(buffer, sizeof(buffer), "+2");
+    }
+
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str_aligned(canvas, 64, 2, AlignCenter, AlignTop, "Inspection");
+    canvas_set_font(canvas, FontBigNumbers);
+    canvas_draw_str_aligned(canvas, 64, 30, AlignCenter, AlignCenter, buffer);
+    elements_button_center(canvas, "Go");
+}
+
+static void draw_time(Canvas* canvas, uint32_t time, bool penalty) {
+    char buffer[16];
+    if(time == DNF) {
+        canvas_set_font(canvas, FontPrimary);
+        canvas_draw_str_aligned(canvas, 64, 24, AlignCenter, AlignCenter, "DNF");
+        return;
+    }
+    format_time(time, buffer, sizeof(buffer));
+    if(penalty) strlcat(buffer, "+", sizeof(buffer));
+    canvas_set_font(canvas, FontBigNumbers);
+    canvas_draw_str_aligned(canvas, 64, 24, AlignCenter, AlignCenter, buffer);
+}
+
+static void draw_result(Canvas* canvas, ScramblerApp* app) {
+    char ao5[12];
+    char ao12[12];
+    char buffer[32];
+    draw_time(canvas, app->result, app->penalty);
+
+    format_time(session_average(&app->session, 5), ao5, sizeof(ao5));
+    format_time(session_average(&app->session, 12), ao12, sizeof(ao12));
+    snprintf(buffer, sizeof(buffer), "ao5: %s   ao12: %s", ao5, ao12);
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str_aligned(canvas, 64, 44, AlignCenter, AlignBottom, buffer);
+    elements_button_center(canvas, "Next");
+}
+
+static void draw_stats(Canvas* canvas, ScramblerApp* app) {
+    const Session* session = &app->session;
+    char first[12];
+    char second[12];
+    char buffer[40];
+
     canvas_set_font(canvas, FontPrimary);
-    canvas_draw_str(canvas, 4, 13, "Rubik's Cube Scrambler");
+    canvas_draw_str(canvas, 2, 10, "Session");
     canvas_set_font(canvas, FontSecondary);
-    canvas_draw_str_aligned(canvas, 64, 28, AlignCenter, AlignCenter, scramble_start);
-    canvas_draw_str_aligned(canvas, 64, 38, AlignCenter, AlignCenter, scramble_end);
-    elements_button_center(canvas, "New");
 
-    elements_button_left(canvas, notifications_enabled ? "On" : "Off");
-};
+    snprintf(
+        buffer,
+        sizeof(buffer),
+        "Solves: %u (%u DNF)",
+        session->count,
+        session->count - session->finished);
+    canvas_draw_str(canvas, 2, 21, buffer);
+
+    format_time(session->best, first, sizeof(first));
+    format_time(
+        session->finished ? session->total / session->finished : NO_TIME,
+        second,
+        sizeof(second));
+    snprintf(buffer, sizeof(buffer), "Best: %s  Mean: %s", first, second);
+    canvas_draw_str(canvas, 2, 31, buffer);
+
+    format_time(session_average(session, 5), first, sizeof(first));
+    format_time(session->best_ao5, second, sizeof(second));
+    snprintf(buffer, sizeof(buffer), "ao5: %s  best: %s", first, second);
+    canvas_draw_str(canvas, 2, 41, buffer);
+
+    format_time(session_average(session, 12), first, sizeof(first));
+    format_time(session->best_ao12, second, sizeof(second));
+    snprintf(buffer, sizeof(buffer), "ao12: %s  best: %s", first, second);
+    canvas_draw_str(canvas, 2, 51, buffer);
+
+    canvas_draw_str_aligned(canvas, 64, 63, AlignCenter, AlignBottom, "Hold OK to reset");
+}
+
+static void draw_callback(Canvas* canvas, void* ctx) {
+    ScramblerApp* app = ctx;
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    canvas_clear(canvas);
+    switch(app->screen) {
+    case ScreenScramble:
+        draw_scramble(canvas, app);
+        break;
+    case ScreenInspection:
+        draw_inspection(canvas, app);
+        break;
+    case ScreenTiming:
+        draw_time(canvas, furi_get_tick() - app->timer_start, app->penalty);
+        canvas_set_font(canvas, FontSecondary);
+        canvas_draw_str_aligned(canvas, 64, 60, AlignCenter, AlignBottom, "Any button stops");
+        break;
+    case ScreenResult:
+        draw_result(canvas, app);
+        break;
+    case ScreenStats:
+        draw_stats(canvas, app);
+        break;
+    }
+    furi_mutex_release(app->mutex);
+}
 
 static void input_callback(InputEvent* input_event, void* ctx) {
     furi_assert(ctx);
@@ -65,49 +317,127 @@ static void input_callback(InputEvent* input_event, void* ctx) {
     furi_message_queue_put(event_queue, input_event, FuriWaitForever);
 }
 
-int32_t rubiks_cube_scrambler_main(void* p) {
-    UNUSED(p);
-    InputEvent event;
-
-    FuriMessageQueue* event_queue = furi_message_queue_alloc(8, sizeof(InputEvent));
-
-    ViewPort* view_port = view_port_alloc();
-
-    view_port_draw_callback_set(view_port, draw_callback, NULL);
+static void scrambler_finish(ScramblerApp* app, uint32_t result) {
+    app->result = result;
+    session_add(&app->session, result);
+    app->screen = ScreenResult;
+}
 
-    view_port_input_callback_set(view_port, input_callback, event_queue);
+// Inspection calls like a judge would, and the DNF once the inspection is over
+static void scrambler_tick(ScramblerApp* app) {
+    if(app->screen != ScreenInspection) return;
 
-    Gui* gui = furi_record_open(RECORD_GUI);
-    gui_add_view_port(gui, view_port, GuiLayerFullscreen);
+    uint32_t elapsed = furi_get_tick() - app->inspection_start;
+    if(elapsed > INSPECTION_LIMIT_MS) {
+        app->penalty = false;
+        scrambler_finish(app, DNF);
+    } else if(elapsed >= 8000U + app->calls * 4000U && app->calls < 2) {
+        app->calls++;
+        if(app->vibration) success_vibration();
+    }
+}
 
-    while(true) {
-        furi_check(furi_message_queue_get(event_queue, &event, FuriWaitForever) == FuriStatusOk);
+// Screens change on presses, so the release of the same button does nothing on the next one
+static bool scrambler_handle_input(ScramblerApp* app, const InputEvent* event) {
+    if(app->screen == ScreenStats && event->key == InputKeyOk && event->type == InputTypeLong) {
+        memset(&app->session, 0, sizeof(Session));
+        return true;
+    }
+    if(event->type != InputTypePress) return true;
 
-        if(event.key == InputKeyOk && event.type == InputTypeShort) {
-            genScramble();
-            if(notifications_enabled) {
-                success_vibration();
-            }
+    switch(app->screen) {
+    case ScreenScramble:
+        if(event->key == InputKeyOk && app->current.length) {
+            app->inspection_start = furi_get_tick();
+            app->calls = 0;
+            app->screen = ScreenInspection;
+        } else if(event->key == InputKeyRight) {
+            scramble_advance(app);
+        } else if(event->key == InputKeyLeft) {
+            app->vibration = !app->vibration;
+            if(app->vibration) success_vibration();
+        } else if(event->key == InputKeyDown) {
+            app->screen = ScreenStats;
+        } else if(event->key == InputKeyBack) {
+            return false;
+        }
+        break;
+    case ScreenInspection:
+        if(event->key == InputKeyOk) {
+            app->penalty = furi_get_tick() - app->inspection_start > INSPECTION_MS;
+            app->timer_start = furi_get_tick();
+            app->screen = ScreenTiming;
+        } else if(event->key == InputKeyBack) {
+            app->screen = ScreenScramble;
         }
-        if(event.key == InputKeyLeft && event.type == InputTypeShort) {
-            if(notifications_enabled) {
-                notifications_enabled = false;
-            } else {
-                notifications_enabled = true;
-                success_vibration();
-            }
+        break;
+    case ScreenTiming: {
+        uint32_t time = furi_get_tick() - app->timer_start;
+        scrambler_finish(app, app->penalty ? time + PENALTY_MS : time);
+        break;
+    }
+    case ScreenResult:
+        if(event->key == InputKeyOk || event->key == InputKeyBack) {
+            scramble_advance(app);
+            app->screen = ScreenScramble;
         }
-        if(event.key == InputKeyBack) {
-            break;
+        break;
+    case ScreenStats:
+        if(event->key == InputKeyBack || event->key == InputKeyUp) {
+            app->screen = ScreenScramble;
         }
-        view_port_update(view_port);
+        break;
     }
+    return true;
+}
 
-    furi_message_queue_free(event_queue);
+int32_t rubiks_cube_scrambler_main(void* p) {
+    UNUSED(p);
+    ScramblerApp* app = malloc(sizeof(ScramblerApp));
+    memset(app, 0, sizeof(ScramblerApp));
+    app->preparing = true;
+    app->screen = ScreenScramble;
+
+    app->event_queue = furi_message_queue_alloc(8, sizeof(InputEvent));
+    app->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    app->solver = cube_solver_alloc();
+
+    app->view_port = view_port_alloc();
+    view_port_draw_callback_set(app->view_port, draw_callback, app);
+    view_port_input_callback_set(app->view_port, input_callback, app->event_queue);
+
+    Gui* gui = furi_record_open(RECORD_GUI);
+    gui_add_view_port(gui, app->view_port, GuiLayerFullscreen);
 
-    gui_remove_view_port(gui, view_port);
+    app->worker = furi_thread_alloc_ex("CubeScrambler", 2048, scrambler_worker, app);
+    // the timer has to stay responsive while a scramble is searched for
+    furi_thread_set_priority(app->worker, FuriThreadPriorityLow);
+    furi_thread_start(app->worker);
 
-    view_port_free(view_port);
+    bool running = true;
+    InputEvent event;
+    while(running) {
+        bool input = furi_message_queue_get(app->event_queue, &event, TICK_MS) == FuriStatusOk;
+        furi_mutex_acquire(app->mutex, FuriWaitForever);
+        if(input) running = scrambler_handle_input(app, &event);
+        scrambler_tick(app);
+        bool animated = app->screen == ScreenInspection || app->screen == ScreenTiming;
+        furi_mutex_release(app->mutex);
+        if(input || animated) view_port_update(app->view_port);
+    }
+
+    app->stop = true;
+    furi_thread_flags_set(furi_thread_get_id(app->worker), WorkerFlagStop);
+    furi_thread_join(app->worker);
+    furi_thread_free(app->worker);
+
+    gui_remove_view_port(gui, app->view_port);
+    view_port_free(app->view_port);
     furi_record_close(RECORD_GUI);
+
+    cube_solver_free(app->solver);
+    furi_mutex_free(app->mutex);
+    furi_message_queue_free(app->event_queue);
+    free(app);
     return 0;
 }
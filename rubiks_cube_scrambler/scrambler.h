@@ -1,2 +1,9 @@
-void scrambleReplace();
-char* printData();
+#pragma once
+
+#include <stdint.h>
+
+#define SLEN 20
+
+// Fallback when the solver's tables don't fit in memory: SLEN random moves in the solver's
+// encoding, none of them on the face of either move before it
+uint8_t scramble_random_moves(uint8_t* moves);
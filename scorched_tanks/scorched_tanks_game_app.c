@@ -2,7 +2,6 @@
 #include <gui/gui.h>
 #include <input/input.h>
 #include <stdlib.h>
-#include <math.h>
 #include <notification/notification.h>
 #include <notification/notification_messages.h>
 
@@ -13,7 +12,11 @@
 #define PLAYER_INIT_POWER 50
 #define ENEMY_INIT_LOCATION_X 108
 #define TANK_BARREL_LENGTH 8
-#define GRAVITY_FORCE (double)0.5
+#define FIXED_SHIFT 16
+#define FIXED_ONE (1 << FIXED_SHIFT)
+#define INT_TO_FIXED(v) ((int32_t)(v) * FIXED_ONE)
+#define FIXED_ROUND(v) (((v) + FIXED_ONE / 2) >> FIXED_SHIFT)
+#define GRAVITY_FORCE (FIXED_ONE / 2)
 #define MIN_GROUND_HEIGHT 35
 #define MAX_GROUND_HEIGHT 55
 #define MAX_FIRE_POWER 100
@@ -22,35 +25,29 @@
 #define MAX_WIND 10
 #define MAX_PLAYER_DIFF_X 20
 #define MAX_ENEMY_DIFF_X 20
-
-// That's a filthy workaround but sin(player.aimAngle) breaks it all... If you're able to fix it, please do create a PR!
-double scorched_tanks_sin[91] = {
-    0.000,  -0.017, -0.035, -0.052, -0.070, -0.087, -0.105, -0.122, -0.139, -0.156, -0.174, -0.191,
-    -0.208, -0.225, -0.242, -0.259, -0.276, -0.292, -0.309, -0.326, -0.342, -0.358, -0.375, -0.391,
-    -0.407, -0.423, -0.438, -0.454, -0.469, -0.485, -0.500, -0.515, -0.530, -0.545, -0.559, -0.574,
-    -0.588, -0.602, -0.616, -0.629, -0.643, -0.656, -0.669, -0.682, -0.695, -0.707, -0.719, -0.731,
-    -0.743, -0.755, -0.766, -0.777, -0.788, -0.799, -0.809, -0.819, -0.829, -0.839, -0.848, -0.857,
-    -0.866, -0.875, -0.883, -0.891, -0.899, -0.906, -0.914, -0.921, -0.927, -0.934, -0.940, -0.946,
-    -0.951, -0.956, -0.961, -0.966, -0.970, -0.974, -0.978, -0.982, -0.985, -0.988, -0.990, -0.993,
-    -0.995, -0.996, -0.998, -0.999, -0.999, -1.000, -1.000};
-double scorched_tanks_cos[91] = {
-    1.000, 1.000, 0.999, 0.999, 0.998, 0.996, 0.995, 0.993, 0.990, 0.988, 0.985, 0.982, 0.978,
-    0.974, 0.970, 0.966, 0.961, 0.956, 0.951, 0.946, 0.940, 0.934, 0.927, 0.921, 0.914, 0.906,
-    0.899, 0.891, 0.883, 0.875, 0.866, 0.857, 0.848, 0.839, 0.829, 0.819, 0.809, 0.799, 0.788,
-    0.777, 0.766, 0.755, 0.743, 0.731, 0.719, 0.707, 0.695, 0.682, 0.669, 0.656, 0.643, 0.629,
-    0.616, 0.602, 0.588, 0.574, 0.559, 0.545, 0.530, 0.515, 0.500, 0.485, 0.469, 0.454, 0.438,
-    0.423, 0.407, 0.391, 0.375, 0.358, 0.342, 0.326, 0.309, 0.292, 0.276, 0.259, 0.242, 0.225,
-    0.208, 0.191, 0.174, 0.156, 0.139, 0.122, 0.105, 0.087, 0.070, 0.052, 0.035, 0.017, 0.000};
-double scorched_tanks_tan[91] = {
-    0.000,   -0.017,  -0.035,    -0.052, -0.070, -0.087, -0.105, -0.123, -0.141,  -0.158,  -0.176,
-    -0.194,  -0.213,  -0.231,    -0.249, -0.268, -0.287, -0.306, -0.325, -0.344,  -0.364,  -0.384,
-    -0.404,  -0.424,  -0.445,    -0.466, -0.488, -0.510, -0.532, -0.554, -0.577,  -0.601,  -0.625,
-    -0.649,  -0.674,  -0.700,    -0.727, -0.754, -0.781, -0.810, -0.839, -0.869,  -0.900,  -0.932,
-    -0.966,  -1.000,  -1.036,    -1.072, -1.111, -1.150, -1.192, -1.235, -1.280,  -1.327,  -1.376,
-    -1.428,  -1.483,  -1.540,    -1.600, -1.664, -1.732, -1.804, -1.881, -1.963,  -2.050,  -2.144,
-    -2.246,  -2.356,  -2.475,    -2.605, -2.747, -2.904, -3.078, -3.271, -3.487,  -3.732,  -4.011,
-    -4.331,  -4.704,  -5.144,    -5.671, -6.313, -7.115, -8.144, -9.513, -11.429, -14.298, -19.077,
-    -28.627, -57.254, -90747.269};
+#define CRATER_RADIUS 4
+
+// Projectile physics run in Q16.16 fixed point, the sin/cos tables hold the values scaled
+// by FIXED_ONE for every whole degree of aim (sin is negated since y grows downwards)
+static const int32_t scorched_tanks_sin[91] = {
+    0, -1144, -2287, -3430, -4572, -5712, -6850, -7987, -9121, -10252, -11380, -12505, -13626,
+    -14742, -15855, -16962, -18064, -19161, -20252, -21336, -22415, -23486, -24550, -25607, -26656,
+    -27697, -28729, -29753, -30767, -31772, -32768, -33754, -34729, -35693, -36647, -37590, -38521,
+    -39441, -40348, -41243, -42126, -42995, -43852, -44695, -45525, -46341, -47143, -47930, -48703,
+    -49461, -50203, -50931, -51643, -52339, -53020, -53684, -54332, -54963, -55578, -56175, -56756,
+    -57319, -57865, -58393, -58903, -59396, -59870, -60326, -60764, -61183, -61584, -61966, -62328,
+    -62672, -62997, -63303, -63589, -63856, -64104, -64332, -64540, -64729, -64898, -65048, -65177,
+    -65287, -65376, -65446, -65496, -65526, -65536,
+};
+static const int32_t scorched_tanks_cos[91] = {
+    65536, 65526, 65496, 65446, 65376, 65287, 65177, 65048, 64898, 64729, 64540, 64332, 64104,
+    63856, 63589, 63303, 62997, 62672, 62328, 61966, 61584, 61183, 60764, 60326, 59870, 59396,
+    58903, 58393, 57865, 57319, 56756, 56175, 55578, 54963, 54332, 53684, 53020, 52339, 51643,
+    50931, 50203, 49461, 48703, 47930, 47143, 46341, 45525, 44695, 43852, 42995, 42126, 41243,
+    40348, 39441, 38521, 37590, 36647, 35693, 34729, 33754, 32768, 31772, 30767, 29753, 28729,
+    27697, 26656, 25607, 24550, 23486, 22415, 21336, 20252, 19161, 18064, 16962, 15855, 14742,
+    13626, 12505, 11380, 10252, 9121, 7987, 6850, 5712, 4572, 3430, 2287, 1144, 0,
+};
 uint8_t scorched_tanks_ground_modifiers[SCREEN_WIDTH] = {
     0,  0,  0,  0,  0,  0, 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
     0,  0,  0,  0,  0,  0, 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
@@ -58,6 +55,8 @@ uint8_t scorched_tanks_ground_modifiers[SCREEN_WIDTH] = {
     18, 16, 14, 12, 10, 8, 6,  4,  2,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
     0,  0,  0,  0,  0,  0, 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
     0,  0,  0,  0,  0,  0, 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0};
+// How deep below the impact point a crater reaches, by horizontal distance from it
+static const uint8_t scorched_tanks_crater_depth[CRATER_RADIUS + 1] = {4, 3, 3, 2, 1};
 
 typedef struct {
     //    +-----x
@@ -73,9 +72,9 @@ typedef struct {
     //    |
     //    |
     //    y
-    double x;
-    double y;
-} PointDetailed;
+    int32_t x;
+    int32_t y;
+} PointFixed;
 
 typedef struct {
     uint8_t locationX;
@@ -85,7 +84,8 @@ typedef struct {
 } Tank;
 
 typedef struct {
-    Point ground[SCREEN_WIDTH];
+    // ground height (y of the surface) for every column of the screen
+    uint8_t ground[SCREEN_WIDTH];
     Tank player;
     Tank enemy;
     bool isPlayerTurn;
@@ -93,8 +93,8 @@ typedef struct {
     int windSpeed;
     Point trajectory[SCREEN_WIDTH];
     uint8_t trajectoryAnimationStep;
-    PointDetailed bulletPosition;
-    PointDetailed bulletVector;
+    PointFixed bulletPosition;
+    PointFixed bulletVector;
     FuriMutex* mutex;
 } Game;
 
@@ -129,8 +129,7 @@ void scorched_tanks_generate_ground(Game* game_state) {
                 int newPoint = lastHeight + diffHeight;
                 newPoint = newPoint < MIN_GROUND_HEIGHT ? MIN_GROUND_HEIGHT : newPoint;
                 newPoint = newPoint > MAX_GROUND_HEIGHT ? MAX_GROUND_HEIGHT : newPoint;
-                game_state->ground[index].x = index;
-                game_state->ground[index].y = newPoint - scorched_tanks_ground_modifiers[a];
+                game_state->ground[index] = newPoint - scorched_tanks_ground_modifiers[a];
                 lastHeight = newPoint;
             } else {
                 a += b;
@@ -164,40 +163,68 @@ void scorched_tanks_init_game(Game* game_state) {
     scorched_tanks_generate_ground(game_state);
 }
 
+// Blows a crater into the heightmap around column x, only the columns within
+// CRATER_RADIUS of the impact are touched
+static void scorched_tanks_make_crater(Game* game_state, int x) {
+    int impactY = game_state->ground[x];
+
+    for(int dx = -CRATER_RADIUS; dx <= CRATER_RADIUS; dx++) {
+        int column = x + dx;
+        if(column < 0 || column >= SCREEN_WIDTH) {
+            continue;
+        }
+
+        int depth = scorched_tanks_crater_depth[abs(dx)];
+        // a column rising above the crater is a wall next to it, the heightmap can't
+        // hold a tunnel through it
+        if(game_state->ground[column] < impactY - depth) {
+            continue;
+        }
+
+        int bottom = impactY + depth;
+        bottom = bottom > SCREEN_HEIGHT - 2 ? SCREEN_HEIGHT - 2 : bottom;
+        if(game_state->ground[column] < bottom) {
+            game_state->ground[column] = bottom;
+        }
+    }
+}
+
+static bool scorched_tanks_is_tank_hit(const Game* game_state, uint8_t locationX) {
+    int64_t distanceX = INT_TO_FIXED(locationX) - game_state->bulletPosition.x;
+    int64_t distanceY = INT_TO_FIXED(game_state->ground[locationX] - TANK_COLLIDER_SIZE) -
+                        game_state->bulletPosition.y;
+    // anything closer than the next whole pixel counts, as the distance used to be truncated
+    int64_t hitDistance = INT_TO_FIXED(TANK_COLLIDER_SIZE + 1);
+
+    return distanceX * distanceX + distanceY * distanceY < hitDistance * hitDistance;
+}
+
 void scorched_tanks_calculate_trajectory(Game* game_state) {
     if(game_state->isShooting) {
-        game_state->bulletVector.x += ((double)game_state->windSpeed - MAX_WIND / 2) / 40;
+        game_state->bulletVector.x += INT_TO_FIXED(game_state->windSpeed - MAX_WIND / 2) / 40;
         game_state->bulletVector.y += GRAVITY_FORCE;
 
         game_state->bulletPosition.x += game_state->bulletVector.x;
         game_state->bulletPosition.y += game_state->bulletVector.y;
 
-        int totalDistanceToEnemy = 100;
-
-        if(game_state->isPlayerTurn) {
-            double distanceToEnemyX = game_state->enemy.locationX - game_state->bulletPosition.x;
-            double distanceToEnemyY = game_state->ground[game_state->enemy.locationX].y -
-                                      TANK_COLLIDER_SIZE - game_state->bulletPosition.y;
-            totalDistanceToEnemy =
-                sqrt(distanceToEnemyX * distanceToEnemyX + distanceToEnemyY * distanceToEnemyY);
-        } else {
-            double distanceToEnemyX = game_state->player.locationX - game_state->bulletPosition.x;
-            double distanceToEnemyY = game_state->ground[game_state->player.locationX].y -
-                                      TANK_COLLIDER_SIZE - game_state->bulletPosition.y;
-            totalDistanceToEnemy =
-                sqrt(distanceToEnemyX * distanceToEnemyX + distanceToEnemyY * distanceToEnemyY);
-        }
+        uint8_t targetX = game_state->isPlayerTurn ? game_state->enemy.locationX :
+                                                     game_state->player.locationX;
 
-        if(totalDistanceToEnemy <= TANK_COLLIDER_SIZE) {
+        if(scorched_tanks_is_tank_hit(game_state, targetX)) {
             game_state->isShooting = false;
             scorched_tanks_init_game(game_state);
             game_state->isPlayerTurn = !game_state->isPlayerTurn;
             return;
         }
 
-        if(game_state->bulletPosition.x > SCREEN_WIDTH ||
-           game_state->bulletPosition.y >
-               game_state->ground[(int)round(game_state->bulletPosition.x)].y) {
+        int column = FIXED_ROUND(game_state->bulletPosition.x);
+        bool isOutside = column < 0 || column >= SCREEN_WIDTH;
+
+        if(isOutside ||
+           game_state->bulletPosition.y > INT_TO_FIXED(game_state->ground[column])) {
+            if(!isOutside) {
+                scorched_tanks_make_crater(game_state, column);
+            }
             game_state->isShooting = false;
             game_state->bulletPosition.x = 0;
             game_state->bulletPosition.y = 0;
@@ -206,16 +233,21 @@ void scorched_tanks_calculate_trajectory(Game* game_state) {
             return;
         }
 
-        if(game_state->bulletPosition.y > 0) {
-            game_state->trajectory[game_state->trajectoryAnimationStep].x =
-                round(game_state->bulletPosition.x);
+        if(game_state->bulletPosition.y > 0 &&
+           game_state->trajectoryAnimationStep < SCREEN_WIDTH) {
+            game_state->trajectory[game_state->trajectoryAnimationStep].x = column;
             game_state->trajectory[game_state->trajectoryAnimationStep].y =
-                round(game_state->bulletPosition.y);
+                FIXED_ROUND(game_state->bulletPosition.y);
             game_state->trajectoryAnimationStep++;
         }
     }
 }
 
+// One coordinate of the barrel tip, `direction` is the sin or cos of the aim angle
+static int scorched_tanks_barrel_end(int from, int32_t direction) {
+    return (INT_TO_FIXED(from) + TANK_BARREL_LENGTH * direction) / FIXED_ONE;
+}
+
 static void scorched_tanks_draw_tank(Canvas* const canvas, uint8_t x, uint8_t y, bool isPlayer) {
     uint8_t lineIndex = 0;
 
@@ -260,16 +292,19 @@ static void scorched_tanks_render_callback(Canvas* const canvas, void* ctx) {
     canvas_set_color(canvas, ColorBlack);
 
     if(game_state->isShooting) {
-        canvas_draw_dot(canvas, game_state->bulletPosition.x, game_state->bulletPosition.y);
+        canvas_draw_dot(
+            canvas,
+            FIXED_ROUND(game_state->bulletPosition.x),
+            FIXED_ROUND(game_state->bulletPosition.y));
     }
 
     for(int a = 1; a < SCREEN_WIDTH; a++) {
         canvas_draw_line(
             canvas,
-            game_state->ground[a - 1].x,
-            game_state->ground[a - 1].y,
-            game_state->ground[a].x,
-            game_state->ground[a].y);
+            a - 1,
+            game_state->ground[a - 1],
+            a,
+            game_state->ground[a]);
 
         if(game_state->trajectory[a].y != 0) {
             canvas_draw_dot(canvas, game_state->trajectory[a].x, game_state->trajectory[a].y);
@@ -279,13 +314,13 @@ static void scorched_tanks_render_callback(Canvas* const canvas, void* ctx) {
     scorched_tanks_draw_tank(
         canvas,
         game_state->enemy.locationX,
-        game_state->ground[game_state->enemy.locationX].y - TANK_COLLIDER_SIZE,
+        game_state->ground[game_state->enemy.locationX] - TANK_COLLIDER_SIZE,
         true);
 
     scorched_tanks_draw_tank(
         canvas,
         game_state->player.locationX,
-        game_state->ground[game_state->player.locationX].y - TANK_COLLIDER_SIZE,
+        game_state->ground[game_state->player.locationX] - TANK_COLLIDER_SIZE,
         false);
 
     int aimX1 = 0;
@@ -295,23 +330,23 @@ static void scorched_tanks_render_callback(Canvas* const canvas, void* ctx) {
 
     if(game_state->isPlayerTurn) {
         aimX1 = game_state->player.locationX;
-        aimY1 = game_state->ground[game_state->player.locationX].y - TANK_COLLIDER_SIZE;
+        aimY1 = game_state->ground[game_state->player.locationX] - TANK_COLLIDER_SIZE;
 
-        double sinFromAngle = scorched_tanks_sin[game_state->player.aimAngle];
-        double cosFromAngle = scorched_tanks_cos[game_state->player.aimAngle];
-        aimX2 = aimX1 + TANK_BARREL_LENGTH * cosFromAngle;
-        aimY2 = aimY1 + TANK_BARREL_LENGTH * sinFromAngle;
+        int32_t sinFromAngle = scorched_tanks_sin[game_state->player.aimAngle];
+        int32_t cosFromAngle = scorched_tanks_cos[game_state->player.aimAngle];
+        aimX2 = scorched_tanks_barrel_end(aimX1, cosFromAngle);
+        aimY2 = scorched_tanks_barrel_end(aimY1, sinFromAngle);
 
         aimX1 += 1;
         aimX2 += 1;
     } else {
         aimX1 = game_state->enemy.locationX;
-        aimY1 = game_state->ground[game_state->enemy.locationX].y - TANK_COLLIDER_SIZE;
+        aimY1 = game_state->ground[game_state->enemy.locationX] - TANK_COLLIDER_SIZE;
 
-        double sinFromAngle = scorched_tanks_sin[game_state->enemy.aimAngle];
-        double cosFromAngle = scorched_tanks_cos[game_state->enemy.aimAngle];
-        aimX2 = aimX1 + TANK_BARREL_LENGTH * cosFromAngle;
-        aimY2 = aimY1 + TANK_BARREL_LENGTH * sinFromAngle;
+        int32_t sinFromAngle = scorched_tanks_sin[game_state->enemy.aimAngle];
+        int32_t cosFromAngle = scorched_tanks_cos[game_state->enemy.aimAngle];
+        aimX2 = scorched_tanks_barrel_end(aimX1, cosFromAngle);
+        aimY2 = scorched_tanks_barrel_end(aimY1, sinFromAngle);
 
         aimX2 = aimX1 - (aimX2 - aimX1);
 
@@ -420,34 +455,30 @@ const NotificationSequence sequence_long_vibro = {
 static void scorched_tanks_fire(Game* game_state) {
     if(!game_state->isShooting) {
         if(game_state->isPlayerTurn) {
-            double sinFromAngle = scorched_tanks_sin[game_state->player.aimAngle];
-            double cosFromAngle = scorched_tanks_cos[game_state->player.aimAngle];
+            int32_t sinFromAngle = scorched_tanks_sin[game_state->player.aimAngle];
+            int32_t cosFromAngle = scorched_tanks_cos[game_state->player.aimAngle];
             uint8_t aimX1 = game_state->player.locationX;
             uint8_t aimY1 =
-                game_state->ground[game_state->player.locationX].y - TANK_COLLIDER_SIZE;
-            int aimX2 = aimX1 + TANK_BARREL_LENGTH * cosFromAngle;
-            int aimY2 = aimY1 + TANK_BARREL_LENGTH * sinFromAngle;
-            game_state->bulletPosition.x = aimX2;
-            game_state->bulletPosition.y = aimY2;
-            game_state->bulletVector.x = scorched_tanks_cos[game_state->player.aimAngle] *
-                                         ((double)game_state->player.firePower / 10);
-            game_state->bulletVector.y = scorched_tanks_sin[game_state->player.aimAngle] *
-                                         ((double)game_state->player.firePower / 10);
+                game_state->ground[game_state->player.locationX] - TANK_COLLIDER_SIZE;
+            int aimX2 = scorched_tanks_barrel_end(aimX1, cosFromAngle);
+            int aimY2 = scorched_tanks_barrel_end(aimY1, sinFromAngle);
+            game_state->bulletPosition.x = INT_TO_FIXED(aimX2);
+            game_state->bulletPosition.y = INT_TO_FIXED(aimY2);
+            game_state->bulletVector.x = cosFromAngle * game_state->player.firePower / 10;
+            game_state->bulletVector.y = sinFromAngle * game_state->player.firePower / 10;
         } else {
-            double sinFromAngle = scorched_tanks_sin[game_state->enemy.aimAngle];
-            double cosFromAngle = scorched_tanks_cos[game_state->enemy.aimAngle];
+            int32_t sinFromAngle = scorched_tanks_sin[game_state->enemy.aimAngle];
+            int32_t cosFromAngle = scorched_tanks_cos[game_state->enemy.aimAngle];
             uint8_t aimX1 = game_state->enemy.locationX;
-            uint8_t aimY1 = game_state->ground[game_state->enemy.locationX].y - TANK_COLLIDER_SIZE;
-            int aimX2 = aimX1 + TANK_BARREL_LENGTH * cosFromAngle;
-            int aimY2 = aimY1 + TANK_BARREL_LENGTH * sinFromAngle;
+            uint8_t aimY1 = game_state->ground[game_state->enemy.locationX] - TANK_COLLIDER_SIZE;
+            int aimX2 = scorched_tanks_barrel_end(aimX1, cosFromAngle);
+            int aimY2 = scorched_tanks_barrel_end(aimY1, sinFromAngle);
             aimX2 = aimX1 - (aimX2 - aimX1);
 
-            game_state->bulletPosition.x = aimX2;
-            game_state->bulletPosition.y = aimY2;
-            game_state->bulletVector.x = -scorched_tanks_cos[game_state->enemy.aimAngle] *
-                                         ((double)game_state->enemy.firePower / 10);
-            game_state->bulletVector.y = scorched_tanks_sin[game_state->enemy.aimAngle] *
-                                         ((double)game_state->enemy.firePower / 10);
+            game_state->bulletPosition.x = INT_TO_FIXED(aimX2);
+            game_state->bulletPosition.y = INT_TO_FIXED(aimY2);
+            game_state->bulletVector.x = -cosFromAngle * game_state->enemy.firePower / 10;
+            game_state->bulletVector.y = sinFromAngle * game_state->enemy.firePower / 10;
         }
 
         game_state->trajectoryAnimationStep = 0;
@@ -2,17 +2,54 @@
 #include <gui/gui.h>
 #include <input/input.h>
 #include <stdlib.h>
+#include <storage/storage.h>
+#include <flipper_format/flipper_format.h>
 
 #include <furi_hal.h>
 
+#define TAG "SentrySafe"
+
+// The lock wakes up on a 3.4 ms low pulse on its data line, then reads a frame at 4800 baud
+#define WAKE_PULSE_US 3400
+#define UART_BAUDRATE 4800
+// Time the lock needs after a frame before it listens again
+#define FRAME_GAP_MS 100
+#define OPEN_DELAY_MS 500
+
+#define SWEEP_CODES 100000
+#define SWEEP_SAVE_EVERY 100
+#define SWEEP_FILE_NAME "sweep.txt"
+#define SWEEP_FILE_TYPE "Sentry Safe Sweep"
+#define SWEEP_FILE_VERSION 1
+
+typedef enum {
+    StatusIdle,
+    StatusSending,
+    StatusDone,
+    StatusSweeping,
+    StatusSweepPaused,
+    StatusSweepDone,
+} Status;
+
 typedef struct {
     uint8_t status;
     FuriMutex* mutex;
+    uint32_t sweep_next; // next code the sweep tries
 } SentryState;
 
+typedef enum {
+    WorkerEvtStop = (1 << 0),
+    WorkerEvtOpen = (1 << 1),
+    WorkerEvtSweep = (1 << 2),
+    WorkerEvtPause = (1 << 3),
+} WorkerEvtFlags;
+
+#define WORKER_ALL_EVENTS (WorkerEvtStop | WorkerEvtOpen | WorkerEvtSweep | WorkerEvtPause)
+
 typedef enum {
     EventTypeTick,
     EventTypeKey,
+    EventTypeWorker,
 } EventType;
 
 typedef struct {
@@ -20,7 +57,19 @@ typedef struct {
     InputEvent input;
 } Event;
 
-const char* status_texts[3] = {"[Press OK to open safe]", "Sending...", "Done !"};
+typedef struct {
+    SentryState* state;
+    FuriMessageQueue* event_queue;
+} SentryWorker;
+
+const char* status_texts[] = {
+    "[Press OK to open safe]",
+    "Sending...",
+    "Done !",
+    "Sweeping...",
+    "Sweep paused",
+    "Sweep done",
+};
 
 static void sentry_safe_render_callback(Canvas* const canvas, void* ctx) {
     furi_assert(ctx);
@@ -41,6 +90,20 @@ static void sentry_safe_render_callback(Canvas* const canvas, void* ctx) {
     canvas_draw_str_aligned(
         canvas, 64, 50, AlignCenter, AlignBottom, status_texts[sentry_state->status]);
 
+    canvas_set_font(canvas, FontSecondary);
+    char sweep_text[32];
+    if(sentry_state->status >= StatusSweeping || sentry_state->sweep_next > 0) {
+        snprintf(
+            sweep_text,
+            sizeof(sweep_text),
+            "Sweep %05lu  %lu%%",
+            sentry_state->sweep_next,
+            sentry_state->sweep_next * 100 / SWEEP_CODES);
+    } else {
+        snprintf(sweep_text, sizeof(sweep_text), "Right: sweep all codes");
+    }
+    canvas_draw_str_aligned(canvas, 64, 38, AlignCenter, AlignBottom, sweep_text);
+
     furi_mutex_release(sentry_state->mutex);
 }
 
@@ -51,25 +114,25 @@ static void sentry_safe_input_callback(InputEvent* input_event, FuriMessageQueue
     furi_message_queue_put(event_queue, &event, FuriWaitForever);
 }
 
+// Runs on the worker thread, LPUART1 stays initialized for the whole session. PC1 is both the
+// UART TX pin and the wake line, so it is only taken back as a GPIO for the pulse.
 void send_request(int command, int a, int b, int c, int d, int e) {
     int checksum = (command + a + b + c + d + e);
 
     furi_hal_gpio_init_simple(&gpio_ext_pc1, GpioModeOutputPushPull);
     furi_hal_gpio_write(&gpio_ext_pc1, false);
-    furi_delay_ms(3.4);
+    furi_delay_us(WAKE_PULSE_US);
     furi_hal_gpio_write(&gpio_ext_pc1, true);
-
-    furi_hal_uart_init(FuriHalUartIdLPUART1, 4800);
-    //furi_hal_uart_set_br(FuriHalUartIdLPUART1, 4800);
-    //furi_hal_uart_set_irq_cb(FuriHalUartIdLPUART1, usb_uart_on_irq_cb, usb_uart);
-
+    furi_hal_gpio_init_ex(
+        &gpio_ext_pc1,
+        GpioModeAltFunctionPushPull,
+        GpioPullUp,
+        GpioSpeedVeryHigh,
+        GpioAltFn8LPUART1);
+
+    // Returns once the last byte is out
     uint8_t data[8] = {0x0, command, a, b, c, d, e, checksum};
     furi_hal_uart_tx(FuriHalUartIdLPUART1, data, 8);
-
-    furi_delay_ms(100);
-
-    furi_hal_uart_set_irq_cb(FuriHalUartIdLPUART1, NULL, NULL);
-    furi_hal_uart_deinit(FuriHalUartIdLPUART1);
 }
 
 void reset_code(int a, int b, int c, int d, int e) {
@@ -80,6 +143,142 @@ void try_code(int a, int b, int c, int d, int e) {
     send_request(0x71, a, b, c, d, e);
 }
 
+static bool sweep_read(Storage* storage, uint32_t* next) {
+    FlipperFormat* file = flipper_format_file_alloc(storage);
+    FuriString* file_type = furi_string_alloc();
+    uint32_t version = 0;
+    bool loaded = false;
+
+    do {
+        if(!flipper_format_file_open_existing(file, APP_DATA_PATH(SWEEP_FILE_NAME))) break;
+        if(!flipper_format_read_header(file, file_type, &version)) break;
+        if(furi_string_cmp_str(file_type, SWEEP_FILE_TYPE) != 0 || version != SWEEP_FILE_VERSION)
+            break;
+        if(!flipper_format_read_uint32(file, "Next", next, 1)) break;
+        loaded = *next <= SWEEP_CODES;
+    } while(false);
+
+    furi_string_free(file_type);
+    flipper_format_free(file);
+    return loaded;
+}
+
+static void sweep_write(Storage* storage, uint32_t next) {
+    FlipperFormat* file = flipper_format_file_alloc(storage);
+
+    if(!flipper_format_file_open_always(file, APP_DATA_PATH(SWEEP_FILE_NAME)) ||
+       !flipper_format_write_header_cstr(file, SWEEP_FILE_TYPE, SWEEP_FILE_VERSION) ||
+       !flipper_format_write_uint32(file, "Next", &next, 1)) {
+        FURI_LOG_E(TAG, "cannot save the sweep position");
+    }
+
+    flipper_format_free(file);
+}
+
+static void sentry_worker_notify(SentryWorker* worker, uint8_t status) {
+    if(status != 0xff) {
+        furi_mutex_acquire(worker->state->mutex, FuriWaitForever);
+        worker->state->status = status;
+        furi_mutex_release(worker->state->mutex);
+    }
+
+    Event event = {.type = EventTypeWorker};
+    furi_message_queue_put(worker->event_queue, &event, 0);
+}
+
+// Sleeps unless told to stop or pause, returns the flags that cut the wait short
+static uint32_t sentry_worker_wait(uint32_t ms) {
+    uint32_t flags = furi_thread_flags_wait(WorkerEvtStop | WorkerEvtPause, FuriFlagWaitAny, ms);
+    return (flags & FuriFlagError) ? 0 : flags;
+}
+
+// Tries every code from the saved position on, the lock gives no answer so the user stops the
+// sweep when the safe opens. Returns the flags that interrupted it.
+static uint32_t sentry_worker_sweep(SentryWorker* worker, Storage* storage) {
+    uint32_t flags = 0;
+
+    sentry_worker_notify(worker, StatusSweeping);
+
+    while(true) {
+        furi_mutex_acquire(worker->state->mutex, FuriWaitForever);
+        uint32_t code = worker->state->sweep_next;
+        furi_mutex_release(worker->state->mutex);
+
+        if(code >= SWEEP_CODES) {
+            sweep_write(storage, code);
+            sentry_worker_notify(worker, StatusSweepDone);
+            break;
+        }
+
+        try_code(code / 10000, code / 1000 % 10, code / 100 % 10, code / 10 % 10, code % 10);
+
+        furi_mutex_acquire(worker->state->mutex, FuriWaitForever);
+        // a reset from the GUI wins over the code that was just sent
+        if(worker->state->sweep_next == code) worker->state->sweep_next = code + 1;
+        code = worker->state->sweep_next;
+        furi_mutex_release(worker->state->mutex);
+
+        if(code % SWEEP_SAVE_EVERY == 0) sweep_write(storage, code);
+        sentry_worker_notify(worker, 0xff);
+
+        flags = sentry_worker_wait(FRAME_GAP_MS);
+        if(flags) {
+            sweep_write(storage, code);
+            sentry_worker_notify(worker, StatusSweepPaused);
+            break;
+        }
+    }
+
+    return flags;
+}
+
+static int32_t sentry_worker_thread(void* context) {
+    SentryWorker* worker = context;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+
+    uint32_t next = 0;
+    if(sweep_read(storage, &next)) {
+        furi_mutex_acquire(worker->state->mutex, FuriWaitForever);
+        worker->state->sweep_next = next;
+        furi_mutex_release(worker->state->mutex);
+        sentry_worker_notify(worker, 0xff);
+    }
+
+    furi_hal_uart_init(FuriHalUartIdLPUART1, UART_BAUDRATE);
+
+    for(bool running = true; running;) {
+        uint32_t flags =
+            furi_thread_flags_wait(WORKER_ALL_EVENTS, FuriFlagWaitAny, FuriWaitForever);
+
+        if(flags & WorkerEvtStop) break;
+
+        if(flags & WorkerEvtOpen) {
+            reset_code(1, 2, 3, 4, 5);
+            flags = sentry_worker_wait(OPEN_DELAY_MS);
+            if(!(flags & WorkerEvtStop)) {
+                try_code(1, 2, 3, 4, 5);
+                flags = sentry_worker_wait(FRAME_GAP_MS);
+            }
+            sentry_worker_notify(worker, StatusDone);
+        } else if(flags & WorkerEvtSweep) {
+            flags = sentry_worker_sweep(worker, storage);
+        }
+
+        if(flags & WorkerEvtStop) running = false;
+    }
+
+    furi_hal_uart_set_irq_cb(FuriHalUartIdLPUART1, NULL, NULL);
+    furi_hal_uart_deinit(FuriHalUartIdLPUART1);
+
+    furi_mutex_acquire(worker->state->mutex, FuriWaitForever);
+    next = worker->state->sweep_next;
+    furi_mutex_release(worker->state->mutex);
+    sweep_write(storage, next);
+
+    furi_record_close(RECORD_STORAGE);
+    return 0;
+}
+
 int32_t sentry_safe_app(void* p) {
     UNUSED(p);
 
@@ -87,7 +286,8 @@ int32_t sentry_safe_app(void* p) {
 
     SentryState* sentry_state = malloc(sizeof(SentryState));
 
-    sentry_state->status = 0;
+    sentry_state->status = StatusIdle;
+    sentry_state->sweep_next = 0;
 
     sentry_state->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
     if(!sentry_state->mutex) {
@@ -105,6 +305,13 @@ int32_t sentry_safe_app(void* p) {
     Gui* gui = furi_record_open(RECORD_GUI);
     gui_add_view_port(gui, view_port, GuiLayerFullscreen);
 
+    // All the traffic to the lock goes through the worker, so the GUI never waits on the UART
+    SentryWorker worker = {.state = sentry_state, .event_queue = event_queue};
+    FuriThread* worker_thread =
+        furi_thread_alloc_ex("SentrySafeWorker", 2 * 1024, sentry_worker_thread, &worker);
+    furi_thread_start(worker_thread);
+    FuriThreadId worker_id = furi_thread_get_id(worker_thread);
+
     Event event;
     for(bool processing = true; processing;) {
         FuriStatus event_status = furi_message_queue_get(event_queue, &event, 100);
@@ -121,22 +328,32 @@ int32_t sentry_safe_app(void* p) {
                     case InputKeyDown:
                         break;
                     case InputKeyRight:
+                        if(sentry_state->status == StatusSweeping) {
+                            furi_thread_flags_set(worker_id, WorkerEvtPause);
+                        } else if(sentry_state->status != StatusSending) {
+                            sentry_state->status = StatusSweeping;
+                            furi_thread_flags_set(worker_id, WorkerEvtSweep);
+                        }
                         break;
                     case InputKeyLeft:
+                        // start the sweep over
+                        if(sentry_state->status != StatusSweeping &&
+                           sentry_state->status != StatusSending) {
+                            sentry_state->sweep_next = 0;
+                            sentry_state->status = StatusIdle;
+                        }
                         break;
                     case InputKeyOk:
 
-                        if(sentry_state->status == 2) {
-                            sentry_state->status = 0;
-
-                        } else if(sentry_state->status == 0) {
-                            sentry_state->status = 1;
+                        if(sentry_state->status == StatusDone) {
+                            sentry_state->status = StatusIdle;
 
-                            reset_code(1, 2, 3, 4, 5);
-                            furi_delay_ms(500);
-                            try_code(1, 2, 3, 4, 5);
-
-                            sentry_state->status = 2;
+                        } else if(
+                            sentry_state->status == StatusIdle ||
+                            sentry_state->status == StatusSweepPaused ||
+                            sentry_state->status == StatusSweepDone) {
+                            sentry_state->status = StatusSending;
+                            furi_thread_flags_set(worker_id, WorkerEvtOpen);
                         }
 
                         break;
@@ -154,6 +371,10 @@ int32_t sentry_safe_app(void* p) {
         view_port_update(view_port);
     }
 
+    furi_thread_flags_set(worker_id, WorkerEvtStop);
+    furi_thread_join(worker_thread);
+    furi_thread_free(worker_thread);
+
     // Reset GPIO pins to default state
     furi_hal_gpio_init(&gpio_ext_pc1, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
 
@@ -24,7 +24,15 @@
 #define BOARD_Y 8
 #define GAME_START_LIVES 3
 #define SAVING_DIRECTORY STORAGE_APP_DATA_PATH_PREFIX
-#define SAVING_FILENAME SAVING_DIRECTORY "/game_simon_says.save"
+#define STATS_FILENAME SAVING_DIRECTORY "/simon_says.stats"
+#define STATS_MAGIC 0x01534d53 // "SMS" and the layout version
+
+// Playback timing in milliseconds, a shape is shown for less time every level down to the
+// minimum, the gap after it is half as long
+#define PLAYBACK_LEAD_IN_MS 700
+#define PLAYBACK_START_MS 500
+#define PLAYBACK_MIN_MS 160
+#define PLAYBACK_STEP_MS 20
 
 // Define Notes
 // Shamelessly stolen from Ocarina application
@@ -45,6 +53,26 @@ typedef enum shape_names { up, down, left, right, number_of_shapes } Direction;
 
 typedef enum currently_playing { simon, player } currently_playing;
 
+typedef enum { SimonEventTypeInput, SimonEventTypePlayback } SimonEventType;
+
+typedef struct {
+    SimonEventType type;
+    InputEvent input;
+    uint32_t tick; // when the key was pressed or released
+} SimonEvent;
+
+/* Kept on the SD card across games */
+typedef struct {
+    uint32_t magic;
+    uint32_t longest_sequence; // the high score
+    uint32_t games;
+    uint32_t reactions; // correct presses that were timed
+    uint32_t reaction_total_ms;
+    uint32_t fastest_reaction_ms;
+    uint32_t best_average_ms; // lowest average reaction time of a whole game
+    uint32_t last_average_ms;
+} SimonStats;
+
 typedef struct {
     /* Game state. */
     enum game_state gameState; // This is the current game state
@@ -69,8 +97,19 @@ typedef struct {
     bool set_board_neutral; // This is used to track if the board should be neutral or not
     int moveIndex; // This is used to track the current move in the sequence
 
-    uint32_t last_button_press_tick;
+    /* Playback of Simon's sequence, stepped by a timer */
+    FuriTimer* playback_timer;
+    uint32_t playback_at; // tick the current step was due at
+    bool playback_lit; // a shape of the sequence is shown
+
+    /* Reaction times of the current game */
+    uint32_t last_button_press_tick; // end of Simon's turn or the last correct press
+    uint32_t reactions;
+    uint32_t reaction_total_ms;
+    SimonStats stats;
+
     NotificationApp* notification;
+    FuriMessageQueue* event_queue;
     FuriMutex* mutex;
 } SimonData;
 
@@ -104,42 +143,6 @@ const NotificationSequence sequence_player_submit_move = {
     NULL,
 };
 
-const NotificationSequence sequence_up = {
-    // &message_vibro_on,
-    &message_note_g4,
-    &message_delay_100,
-    // &message_vibro_off,
-    &message_sound_off,
-    NULL,
-};
-
-const NotificationSequence sequence_down = {
-    // &message_vibro_on,
-    &message_note_c3,
-    &message_delay_100,
-    // &message_vibro_off,
-    &message_sound_off,
-    NULL,
-};
-
-const NotificationSequence sequence_left = {
-    // &message_vibro_on,
-    &message_note_e3,
-    &message_delay_100,
-    // &message_vibro_off,
-    &message_sound_off,
-    NULL,
-};
-
-const NotificationSequence sequence_right = {
-    // &message_vibro_on,
-    &message_note_g3,
-    &message_delay_100,
-    // &message_vibro_off,
-    &message_sound_off,
-    NULL,
-};
-
 // Indicate that it's Simon's turn
 const NotificationSequence sequence_simon_is_playing = {
     &message_red_255,
@@ -154,6 +157,19 @@ const NotificationSequence sequence_player_is_playing = {
     NULL,
 };
 
+// Lit with every shape Simon shows
+const NotificationSequence sequence_shape_on = {
+    &message_blue_255,
+    &message_do_not_reset,
+    NULL,
+};
+
+const NotificationSequence sequence_shape_off = {
+    &message_blue_0,
+    &message_do_not_reset,
+    NULL,
+};
+
 const NotificationSequence sequence_cleanup = {
     &message_red_0,
     &message_green_0,
@@ -223,6 +239,34 @@ void stop_sound() {
     }
 }
 
+/* Light up a shape and start its note, it lasts until clear_shape() */
+void show_shape(SimonData* app, enum shape_names shape) {
+    app->selectedShape = shape;
+    app->set_board_neutral = false;
+
+    switch(shape) {
+    case up:
+        play_sound_up(app);
+        break;
+    case down:
+        play_sound_down(app);
+        break;
+    case left:
+        play_sound_left(app);
+        break;
+    case right:
+        play_sound_right(app);
+        break;
+    default:
+        break;
+    }
+}
+
+void clear_shape(SimonData* app) {
+    app->set_board_neutral = true;
+    stop_sound();
+}
+
 /* Main Render Function */
 void simon_draw_callback(Canvas* canvas, void* ctx) {
     furi_assert(ctx);
@@ -281,27 +325,19 @@ void simon_draw_callback(Canvas* canvas, void* ctx) {
         if(simon_state->set_board_neutral) {
             // Draw Neutral Board
             canvas_draw_icon(canvas, BOARD_X, BOARD_Y, &I_board); // Draw Board
-
-            // Stop Sound TODO: Move this to a better place
-            //@todo Sound
-            stop_sound();
         } else {
             switch(simon_state->selectedShape) {
             case up:
                 canvas_draw_icon(canvas, BOARD_X, BOARD_Y, &I_up); // Draw Up
-                play_sound_up(simon_state);
                 break;
             case down:
                 canvas_draw_icon(canvas, BOARD_X, BOARD_Y, &I_down); // Draw Down
-                play_sound_down(simon_state);
                 break;
             case left:
                 canvas_draw_icon(canvas, BOARD_X, BOARD_Y, &I_left); // Draw Left
-                play_sound_left(simon_state);
                 break;
             case right:
                 canvas_draw_icon(canvas, BOARD_X, BOARD_Y, &I_right); // Draw Right
-                play_sound_right(simon_state);
                 break;
             default:
                 if(DEBUG_MSG)
@@ -314,7 +350,6 @@ void simon_draw_callback(Canvas* canvas, void* ctx) {
 
     // ######################### Game Over #########################
     if(simon_state->gameState == gameOver) {
-        stop_sound(); //TODO: Make a game over sequence
         canvas_set_color(canvas, ColorXOR);
         canvas_set_font(canvas, FontPrimary);
 
@@ -351,6 +386,19 @@ void simon_draw_callback(Canvas* canvas, void* ctx) {
             AlignCenter,
             AlignCenter,
             "Press OK to restart");
+
+        // Reaction times of this game against the best game so far
+        if(simon_state->stats.last_average_ms) {
+            char str_reaction[32];
+            snprintf(
+                str_reaction,
+                sizeof(str_reaction),
+                "Avg %lums  Best %lums",
+                simon_state->stats.last_average_ms,
+                simon_state->stats.best_average_ms);
+            canvas_draw_str_aligned(
+                canvas, SCREEN_XRES / 2, SCREEN_YRES - 5, AlignCenter, AlignCenter, str_reaction);
+        }
     }
 
     // ######################### Victory #########################
@@ -366,40 +414,48 @@ void simon_draw_callback(Canvas* canvas, void* ctx) {
 void simon_input_callback(InputEvent* input_event, void* ctx) {
     furi_assert(ctx);
     FuriMessageQueue* event_queue = ctx;
-    furi_message_queue_put(event_queue, input_event, FuriWaitForever);
+    // Stamped here, the main loop may still be busy with the last event
+    SimonEvent event = {.type = SimonEventTypeInput, .input = *input_event};
+    event.tick = furi_get_tick();
+    furi_message_queue_put(event_queue, &event, FuriWaitForever);
+}
+
+void simon_playback_callback(void* ctx) {
+    furi_assert(ctx);
+    SimonData* app = ctx;
+    SimonEvent event = {.type = SimonEventTypePlayback};
+    furi_message_queue_put(app->event_queue, &event, 0);
 }
 
 /* ======================== Simon Game Engine ======================== */
 
-bool load_game(SimonData* app) {
+void load_stats(SimonData* app) {
     Storage* storage = furi_record_open(RECORD_STORAGE);
-    storage_common_migrate(storage, EXT_PATH("apps/Games/game_simon_says.save"), SAVING_FILENAME);
-
     File* file = storage_file_alloc(storage);
 
-    uint16_t bytes_readed = 0;
-    if(storage_file_open(file, SAVING_FILENAME, FSAM_READ, FSOM_OPEN_EXISTING)) {
-        if(storage_file_size(file) > sizeof(SimonData)) {
-            storage_simply_remove(storage, SAVING_FILENAME);
-            FURI_LOG_E(
-                TAG, "Error: file is larger than the data structure! The file has been deleted.");
-        } else {
-            bytes_readed = storage_file_read(file, app, sizeof(SimonData));
-        }
-        storage_file_close(file);
-        storage_file_free(file);
-    }
+    bool loaded = storage_file_open(file, STATS_FILENAME, FSAM_READ, FSOM_OPEN_EXISTING) &&
+                  storage_file_read(file, &app->stats, sizeof(SimonStats)) ==
+                      sizeof(SimonStats) &&
+                  app->stats.magic == STATS_MAGIC;
 
+    storage_file_close(file);
+    storage_file_free(file);
     furi_record_close(RECORD_STORAGE);
-    return bytes_readed == sizeof(SimonData);
+
+    if(!loaded) {
+        memset(&app->stats, 0, sizeof(SimonStats));
+        app->stats.magic = STATS_MAGIC;
+    }
+    app->highScore = app->stats.longest_sequence;
 }
 
-void save_game(SimonData* app) {
+void save_stats(SimonData* app) {
     Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, SAVING_DIRECTORY);
 
     File* file = storage_file_alloc(storage);
-    if(storage_file_open(file, SAVING_FILENAME, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
-        storage_file_write(file, app, sizeof(SimonData));
+    if(storage_file_open(file, STATS_FILENAME, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        storage_file_write(file, &app->stats, sizeof(SimonStats));
     }
     storage_file_close(file);
     storage_file_free(file);
@@ -407,6 +463,37 @@ void save_game(SimonData* app) {
     furi_record_close(RECORD_STORAGE);
 }
 
+/* Time from the end of Simon's turn, or from the last correct press, to this one */
+void record_reaction(SimonData* app, uint32_t tick) {
+    uint32_t reaction = (tick - app->last_button_press_tick) * 1000 /
+                        furi_kernel_get_tick_frequency();
+    app->last_button_press_tick = tick;
+
+    app->reactions++;
+    app->reaction_total_ms += reaction;
+    if(!app->stats.fastest_reaction_ms || reaction < app->stats.fastest_reaction_ms) {
+        app->stats.fastest_reaction_ms = reaction;
+    }
+}
+
+/* Add the finished game to the statistics and save them */
+void record_game(SimonData* app) {
+    app->stats.longest_sequence = app->highScore;
+    if(app->reactions) {
+        uint32_t average = app->reaction_total_ms / app->reactions;
+        app->stats.games++;
+        app->stats.reactions += app->reactions;
+        app->stats.reaction_total_ms += app->reaction_total_ms;
+        app->stats.last_average_ms = average;
+        if(!app->stats.best_average_ms || average < app->stats.best_average_ms) {
+            app->stats.best_average_ms = average;
+        }
+        app->reactions = 0;
+        app->reaction_total_ms = 0;
+    }
+    save_stats(app);
+}
+
 int getRandomIntInRange(int lower, int upper) {
     return (rand() % (upper - lower + 1)) + lower;
 }
@@ -420,24 +507,60 @@ void play_sound_wrong_move() {
     notification_message(furi_record_open(RECORD_NOTIFICATION), &sequence_error);
 }
 
+/* A shape is shown for less time the longer the sequence gets */
+uint32_t shape_duration(const SimonData* app) {
+    int32_t duration = PLAYBACK_START_MS - app->currentScore * PLAYBACK_STEP_MS;
+    return MAX(duration, PLAYBACK_MIN_MS);
+}
+
+/* The next step is due a set time after the last one was due, however late that one was
+ * handled, so the lengths of the shapes and gaps do not drift */
+void schedule_playback(SimonData* app, uint32_t duration_ms) {
+    app->playback_at += furi_ms_to_ticks(duration_ms);
+    int32_t wait = app->playback_at - furi_get_tick();
+    furi_timer_start(app->playback_timer, MAX(wait, 1));
+}
+
+/* Simon plays the sequence so far */
+void start_playback(SimonData* app) {
+    app->activePlayer = simon;
+    app->moveIndex = 0;
+    app->playback_lit = false;
+    app->numberOfMillisecondsBeforeShapeDisappears = shape_duration(app);
+    notification_message(app->notification, &sequence_simon_is_playing);
+
+    app->playback_at = furi_get_tick();
+    schedule_playback(app, PLAYBACK_LEAD_IN_MS);
+}
+
+void stop_playback(SimonData* app) {
+    furi_timer_stop(app->playback_timer);
+    if(app->playback_lit) {
+        app->playback_lit = false;
+        clear_shape(app);
+        notification_message(app->notification, &sequence_shape_off);
+    }
+}
+
 /* Restart game and give player a chance to try again on same sequence */
 // @todo restartGame
 void resetGame(SimonData* app) {
     app->moveIndex = 0;
-    app->numberOfMillisecondsBeforeShapeDisappears = 500;
     app->activePlayer = simon;
     app->is_wrong_direction = false;
-    app->last_button_press_tick = 0;
     app->set_board_neutral = true;
-    app->activePlayer = simon;
+    start_playback(app);
 }
 
 /* Set gameover state */
 void game_over(SimonData* app) {
-    if(app->is_new_highscore) save_game(app); // Save highscore but only on change
+    stop_playback(app);
+    clear_shape(app);
+    record_game(app);
     app->gameover = true;
     app->lives = GAME_START_LIVES; // Show 3 lives in game over screen to match new game start
     app->gameState = gameOver;
+    notification_message(app->notification, &sequence_player_is_playing);
 }
 
 /* Called after gameover to restart the game. This function
@@ -449,8 +572,9 @@ void restart_game_after_gameover(SimonData* app) {
     app->currentScore = 0;
     app->is_new_highscore = false;
     app->lives = GAME_START_LIVES;
+    app->reactions = 0;
+    app->reaction_total_ms = 0;
     app->simonMoves[0] = rand() % number_of_shapes;
-    resetGame(app);
 }
 
 void addNewSimonMove(int addAtIndex, SimonData* app) {
@@ -459,12 +583,75 @@ void addNewSimonMove(int addAtIndex, SimonData* app) {
 
 void startNewRound(SimonData* app) {
     addNewSimonMove(app->currentScore, app);
+    start_playback(app);
+}
+
+enum shape_names getCurrentSimonMove(SimonData* app) {
+    return app->simonMoves[app->moveIndex];
+}
+
+bool isRoundComplete(SimonData* app) {
+    return app->moveIndex == app->currentScore;
+}
+
+void onRoundComplete(SimonData* app) {
+    app->currentScore++;
+    //TODO: Hacky way of handling highscore by subtracting 1 to account for the first move
+    if(app->currentScore - 1 > app->highScore) {
+        app->highScore = app->currentScore - 1;
+        app->is_new_highscore = true;
+    }
+    if(app->sound_enabled) {
+        play_sound_sequence_correct();
+    }
+    startNewRound(app);
+}
+
+/* The player repeats the sequence, reaction times count from now */
+void start_player_turn(SimonData* app) {
+    app->activePlayer = player;
     app->moveIndex = 0;
-    app->activePlayer = simon;
+    app->last_button_press_tick = furi_get_tick();
+    notification_message(app->notification, &sequence_player_is_playing);
+
+    // The first round has nothing to repeat
+    if(isRoundComplete(app)) {
+        onRoundComplete(app);
+    }
 }
 
-void onPlayerAnsweredCorrect(SimonData* app) {
+/* Playback timer fired: turn the shape off, or on after the gap */
+void playback_step(SimonData* app) {
+    if(app->gameState != inGame || app->activePlayer != simon) {
+        return;
+    }
+
+    if(app->playback_lit) {
+        app->playback_lit = false;
+        clear_shape(app);
+        notification_message(app->notification, &sequence_shape_off);
+        app->moveIndex++;
+        if(app->moveIndex >= app->currentScore) {
+            start_player_turn(app);
+        } else {
+            schedule_playback(app, app->numberOfMillisecondsBeforeShapeDisappears / 2);
+        }
+    } else if(app->moveIndex < app->currentScore) {
+        app->playback_lit = true;
+        show_shape(app, getCurrentSimonMove(app));
+        notification_message(app->notification, &sequence_shape_on);
+        schedule_playback(app, app->numberOfMillisecondsBeforeShapeDisappears);
+    } else {
+        start_player_turn(app);
+    }
+}
+
+void onPlayerAnsweredCorrect(SimonData* app, uint32_t tick) {
+    record_reaction(app, tick);
     app->moveIndex++;
+    if(isRoundComplete(app)) {
+        onRoundComplete(app);
+    }
 }
 
 void onPlayerAnsweredWrong(SimonData* app) {
@@ -484,71 +671,20 @@ void onPlayerAnsweredWrong(SimonData* app) {
     }
 }
 
-bool isRoundComplete(SimonData* app) {
-    return app->moveIndex == app->currentScore;
-}
-
-enum shape_names getCurrentSimonMove(SimonData* app) {
-    return app->simonMoves[app->moveIndex];
-}
-
-void onPlayerSelectedShapeCallback(enum shape_names shape, SimonData* app) {
+void onPlayerSelectedShapeCallback(enum shape_names shape, SimonData* app, uint32_t tick) {
+    show_shape(app, shape);
     if(shape == getCurrentSimonMove(app)) {
-        onPlayerAnsweredCorrect(app);
+        onPlayerAnsweredCorrect(app, tick);
     } else {
         onPlayerAnsweredWrong(app);
     }
 }
 
-//@todo gametick
-void game_tick(SimonData* simon_state) {
-    if(simon_state->gameState == inGame) {
-        if(simon_state->activePlayer == simon) {
-            // ############### Simon Turn ###############
-            notification_message(simon_state->notification, &sequence_simon_is_playing);
-
-            //@todo Gameplay
-            if(simon_state->set_board_neutral) {
-                if(simon_state->moveIndex < simon_state->currentScore) {
-                    simon_state->selectedShape = getCurrentSimonMove(simon_state);
-                    simon_state->set_board_neutral = false;
-                    simon_state->moveIndex++;
-                } else {
-                    simon_state->activePlayer = player;
-                    simon_state->set_board_neutral = true;
-                    simon_state->moveIndex = 0;
-                }
-            } else {
-                simon_state->set_board_neutral = true;
-            }
-        } else {
-            // ############### Player Turn ###############
-            notification_message(simon_state->notification, &sequence_player_is_playing);
-
-            // It's Player's Turn
-            if(isRoundComplete(simon_state)) {
-                simon_state->activePlayer = simon;
-                simon_state->currentScore++;
-                // app->numberOfMillisecondsBeforeShapeDisappears -= 50;
-                //TODO: Hacky way of handling highscore by subtracting 1 to account for the first move
-                if(simon_state->currentScore - 1 > simon_state->highScore) {
-                    simon_state->highScore = simon_state->currentScore - 1;
-                    simon_state->is_new_highscore = true;
-                }
-                if(simon_state->sound_enabled) {
-                    play_sound_sequence_correct();
-                }
-                startNewRound(simon_state);
-            }
-        }
-    }
-}
-
 /* ======================== Main Entry Point ============================== */
 
 int32_t simon_says_app_entry(void* p) {
     UNUSED(p);
-    FuriMessageQueue* event_queue = furi_message_queue_alloc(8, sizeof(InputEvent));
+    FuriMessageQueue* event_queue = furi_message_queue_alloc(8, sizeof(SimonEvent));
 
     SimonData* simon_state = malloc(sizeof(SimonData));
 
@@ -558,6 +694,9 @@ int32_t simon_says_app_entry(void* p) {
         free(simon_state);
         return -1;
     }
+    simon_state->event_queue = event_queue;
+    simon_state->playback_timer =
+        furi_timer_alloc(simon_playback_callback, FuriTimerTypeOnce, simon_state);
 
     // Configure view port
     ViewPort* view_port = view_port_alloc();
@@ -571,84 +710,73 @@ int32_t simon_says_app_entry(void* p) {
     NotificationApp* notification = furi_record_open(RECORD_NOTIFICATION);
     simon_state->notification = notification;
 
-    InputEvent input;
+    SimonEvent event;
 
     // Show Main Menu Screen
-    //load_game(simon_state);
+    load_stats(simon_state);
     restart_game_after_gameover(simon_state);
     simon_state->gameState = mainMenu;
 
     while(true) {
-        game_tick(simon_state);
-
-        FuriStatus q_status = furi_message_queue_get(
-            event_queue, &input, simon_state->numberOfMillisecondsBeforeShapeDisappears);
+        // Everything happens on an input or a playback step, nothing to do in between
+        furi_message_queue_get(event_queue, &event, FuriWaitForever);
         furi_mutex_acquire(simon_state->mutex, FuriWaitForever);
 
-        if(q_status == FuriStatusOk) {
+        if(event.type == SimonEventTypePlayback) {
+            playback_step(simon_state);
+        } else {
+            InputEvent input = event.input;
             //FURI_LOG_D(TAG, "Got input event: %d", input.key);
             //break out of the loop if the back key is pressed
             if(input.key == InputKeyBack && input.type == InputTypeLong) {
-                // Save high score before quitting
-                //if(simon_state->is_new_highscore) {
-                //  save_game(simon_state);
-                //}
+                // Keep the reaction times of a game left unfinished
+                if(simon_state->gameState == inGame) {
+                    record_game(simon_state);
+                }
+                furi_mutex_release(simon_state->mutex);
                 break;
             }
 
             //@todo Set Game States
-            if(input.key == InputKeyOk && simon_state->gameState != inGame) {
+            if(input.key == InputKeyOk && input.type == InputTypePress &&
+               simon_state->gameState != inGame) {
                 restart_game_after_gameover(simon_state);
                 // Set Simon Board state
                 startNewRound(simon_state);
-                view_port_update(view_port);
-            }
-
-            // Keep LED on if it is Simon's turn
-            if(simon_state->activePlayer == player) {
-                notification_message(notification, &sequence_player_is_playing);
-
+            } else if(simon_state->gameState == inGame && simon_state->activePlayer == player) {
                 if(input.type == InputTypePress) {
-                    simon_state->set_board_neutral = false;
-
                     switch(input.key) {
                     case InputKeyUp:
-                        simon_state->selectedShape = up;
-                        onPlayerSelectedShapeCallback(up, simon_state);
+                        onPlayerSelectedShapeCallback(up, simon_state, event.tick);
                         break;
                     case InputKeyDown:
-                        simon_state->selectedShape = down;
-                        onPlayerSelectedShapeCallback(down, simon_state);
+                        onPlayerSelectedShapeCallback(down, simon_state, event.tick);
                         break;
                     case InputKeyLeft:
-                        simon_state->selectedShape = left;
-                        onPlayerSelectedShapeCallback(left, simon_state);
+                        onPlayerSelectedShapeCallback(left, simon_state, event.tick);
                         break;
                     case InputKeyRight:
-                        simon_state->selectedShape = right;
-                        onPlayerSelectedShapeCallback(right, simon_state);
+                        onPlayerSelectedShapeCallback(right, simon_state, event.tick);
                         break;
                     default:
-                        simon_state->set_board_neutral = true;
+                        clear_shape(simon_state);
                         break;
                     }
-                } else {
-                    //FURI_LOG_D(TAG, "Input type is not short");
-                    simon_state->set_board_neutral = true;
                 }
             }
-        }
 
-        // @todo Animation Loop for debug
-        // if(simon_state->gameState == inGame && simon_state->activePlayer == simon) {
-        //     simon_state->currentScore++;
-        //     simon_state->set_board_neutral = !simon_state->set_board_neutral;
-        // }
+            // The note of a key lasts while it is held, unless Simon already took over
+            if(input.type == InputTypeRelease && !simon_state->playback_lit) {
+                clear_shape(simon_state);
+            }
+        }
 
         furi_mutex_release(simon_state->mutex);
         view_port_update(view_port);
     }
 
+    furi_timer_stop(simon_state->playback_timer);
+    furi_timer_free(simon_state->playback_timer);
     stop_sound();
     notification_message(notification, &sequence_cleanup);
     gui_remove_view_port(gui, view_port);
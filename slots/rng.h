@@ -0,0 +1,73 @@
+//
+// Random numbers for games of chance
+//
+// The same copy of rng.c/rng.h lives in every game that uses it, keep them in sync.
+//
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * xoshiro128** state, never all zero
+ */
+typedef struct {
+    uint32_t state[4];
+} Rng;
+
+/**
+ * Seeds from the hardware random number generator. Building with RNG_FIXED_SEED defined,
+ * e.g. cdefines=["RNG_FIXED_SEED=1234"] in application.fam, seeds with it instead so a
+ * game can be replayed.
+ *
+ * @param rng   Generator to seed
+ */
+void rng_init(Rng* rng);
+
+/**
+ * Seeds with a fixed value, the same seed gives the same numbers
+ *
+ * @param rng   Generator to seed
+ * @param seed  Any value
+ */
+void rng_seed(Rng* rng, uint32_t seed);
+
+/**
+ * Next 32 random bits
+ *
+ * @param rng   Seeded generator
+ * @return      Random value
+ */
+uint32_t rng_next(Rng* rng);
+
+/**
+ * Random number in a range, every one equally likely. Unlike rand() % n there is no bias
+ * towards the low numbers, the few draws that would cause it are drawn again.
+ *
+ * @param rng   Seeded generator
+ * @param n     Size of the range, at least 1
+ * @return      Value from 0 to n - 1
+ */
+uint32_t rng_uniform(Rng* rng, uint32_t n);
+
+/**
+ * Fisher-Yates shuffle, every order equally likely
+ *
+ * @param rng   Seeded generator
+ * @param items Array to shuffle
+ * @param count Number of items
+ * @param size  Size of an item in bytes
+ */
+void rng_shuffle(Rng* rng, void* items, size_t count, size_t size);
+
+#ifdef FURI_DEBUG
+/**
+ * Chi-square test of rng_uniform on a copy of the generator, logs the result
+ *
+ * @param rng   Seeded generator, left as it is
+ * @return      true if the numbers look uniform
+ */
+bool rng_self_test(const Rng* rng);
+#endif
@@ -8,6 +8,8 @@
 #include <furi_hal.h>
 #include <slotmachine_icons.h>
 
+#include "rng.h"
+
 const Icon* slot_frames[] = {&I_x2, &I_x3, &I_x4, &I_x2_2, &I_x5};
 
 const uint8_t slot_coef[] = {2, 3, 4, 2, 5};
@@ -29,6 +31,7 @@ typedef struct {
     double money, winamount;
     SlotColumn* columns[4];
     bool winview, loseview;
+    Rng rng;
 } SlotMachineApp;
 
 typedef struct {
@@ -37,7 +40,7 @@ typedef struct {
 
 #define START_MONEY 1500;
 #define START_BET 300;
-#define SLOTS_RAND_MAX 5;
+#define SLOTS_RAND_MAX 5
 #define DEFAULT_SPEED 16;
 #define HIGHSCORES_FILENAME APP_DATA_PATH("slotmachine.save")
 
@@ -191,7 +194,7 @@ void slotmachine_draw_callback(Canvas* canvas, void* ctx) {
                 slotmachine->columns[i]->y = 13;
                 slotmachine->columns[i]->times--;
                 slotmachine->columns[i]->speed--;
-                slotmachine->columns[i]->value = rand() % SLOTS_RAND_MAX;
+                slotmachine->columns[i]->value = rng_uniform(&slotmachine->rng, SLOTS_RAND_MAX);
 
                 if(slotmachine->columns[i]->times == 0) {
                     slotmachine->columns[i]->y = 23;
@@ -243,6 +246,10 @@ SlotMachineApp* slotmachine_app_alloc() {
     app->winview = false;
     app->loseview = false;
     app->winamount = 0;
+    rng_init(&app->rng);
+#ifdef FURI_DEBUG
+    rng_self_test(&app->rng);
+#endif
 
     int x = 7;
 
@@ -303,7 +310,7 @@ int32_t slotmachine_app(void* p) {
                 } else if(
                     input.key == InputKeyOk && input.type == InputTypeShort &&
                     slotmachine->bet <= slotmachine->money) {
-                    COLUMNS_COUNT = rand() % 3 + 2;
+                    COLUMNS_COUNT = rng_uniform(&slotmachine->rng, 3) + 2;
                     slotmachine->money -= slotmachine->bet;
                     slotmachine->columns[0]->spining = true;
 
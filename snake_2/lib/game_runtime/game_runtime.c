@@ -0,0 +1,201 @@
+#include "game_runtime.h"
+
+#define TAG "GameRuntime"
+
+// Must be a power of two
+#define INPUT_RING_SIZE 32
+// Steps run at most to catch up after a stall, older time is dropped
+#define MAX_CATCH_UP_STEPS 5
+
+#define FLAG_WAKE (1UL << 0)
+
+struct GameRuntime {
+    GameRuntimeConfig config;
+    ViewPort* view_port;
+    Gui* gui;
+    FuriThreadId thread_id;
+    uint32_t step_ticks;
+    volatile bool running;
+
+    // The update side steps buffers[work], publishing swaps it with buffers[ready] and drawing
+    // swaps buffers[ready] with buffers[front] when a newer state is there. Only the index
+    // swaps are done under the mutex, so drawing never waits for a step and vice versa.
+    uint8_t* buffers[3];
+    uint8_t work;
+    uint8_t ready;
+    uint8_t front;
+    bool fresh;
+    uint32_t step_start; // tick at which the step after the published state started
+    FuriMutex* swap_mutex;
+
+    // Single producer (input service), single consumer (game thread) ring
+    InputEvent inputs[INPUT_RING_SIZE];
+    uint32_t input_head;
+    uint32_t input_tail;
+    uint32_t dropped_inputs;
+};
+
+static void game_runtime_input_callback(InputEvent* event, void* context) {
+    GameRuntime* runtime = context;
+
+    uint32_t head = runtime->input_head;
+    uint32_t tail = __atomic_load_n(&runtime->input_tail, __ATOMIC_ACQUIRE);
+    if(head - tail == INPUT_RING_SIZE) {
+        runtime->dropped_inputs++;
+    } else {
+        runtime->inputs[head & (INPUT_RING_SIZE - 1)] = *event;
+        __atomic_store_n(&runtime->input_head, head + 1, __ATOMIC_RELEASE);
+    }
+    furi_thread_flags_set(runtime->thread_id, FLAG_WAKE);
+}
+
+static bool game_runtime_input_pop(GameRuntime* runtime, InputEvent* event) {
+    uint32_t tail = runtime->input_tail;
+    if(tail == __atomic_load_n(&runtime->input_head, __ATOMIC_ACQUIRE)) return false;
+
+    *event = runtime->inputs[tail & (INPUT_RING_SIZE - 1)];
+    __atomic_store_n(&runtime->input_tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static void game_runtime_draw_callback(Canvas* canvas, void* context) {
+    GameRuntime* runtime = context;
+
+    furi_mutex_acquire(runtime->swap_mutex, FuriWaitForever);
+    if(runtime->fresh) {
+        uint8_t front = runtime->front;
+        runtime->front = runtime->ready;
+        runtime->ready = front;
+        runtime->fresh = false;
+    }
+    const void* state = runtime->buffers[runtime->front];
+    uint32_t step_start = runtime->step_start;
+    furi_mutex_release(runtime->swap_mutex);
+
+    float alpha = (float)(furi_get_tick() - step_start) / runtime->step_ticks;
+    if(alpha > 1.0f) alpha = 1.0f;
+
+    runtime->config.draw(canvas, state, alpha, runtime->config.context);
+}
+
+static void game_runtime_publish(GameRuntime* runtime, uint32_t step_start) {
+    uint8_t published = runtime->work;
+
+    furi_mutex_acquire(runtime->swap_mutex, FuriWaitForever);
+    runtime->work = runtime->ready;
+    runtime->ready = published;
+    runtime->fresh = true;
+    runtime->step_start = step_start;
+    furi_mutex_release(runtime->swap_mutex);
+
+    // Only the next publish writes the published buffer, so it can be copied unlocked
+    memcpy(
+        runtime->buffers[runtime->work], runtime->buffers[published], runtime->config.state_size);
+}
+
+GameRuntime* game_runtime_alloc(const GameRuntimeConfig* config, const void* initial_state) {
+    furi_assert(config);
+    furi_assert(config->update);
+    furi_assert(config->draw);
+    furi_assert(config->state_size);
+
+    GameRuntime* runtime = malloc(sizeof(GameRuntime));
+    runtime->config = *config;
+    runtime->thread_id = furi_thread_get_current_id();
+    runtime->step_ticks = MAX(furi_ms_to_ticks(config->step_ms), 1UL);
+    runtime->swap_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+
+    runtime->buffers[0] = malloc(config->state_size * 3);
+    for(uint8_t i = 0; i < 3; i++) {
+        runtime->buffers[i] = runtime->buffers[0] + config->state_size * i;
+        memcpy(runtime->buffers[i], initial_state, config->state_size);
+    }
+    runtime->work = 0;
+    runtime->ready = 1;
+    runtime->front = 2;
+    runtime->step_start = furi_get_tick();
+
+    runtime->view_port = view_port_alloc();
+    view_port_draw_callback_set(runtime->view_port, game_runtime_draw_callback, runtime);
+    view_port_input_callback_set(runtime->view_port, game_runtime_input_callback, runtime);
+    runtime->gui = furi_record_open(RECORD_GUI);
+    gui_add_view_port(runtime->gui, runtime->view_port, GuiLayerFullscreen);
+
+    return runtime;
+}
+
+void game_runtime_free(GameRuntime* runtime) {
+    furi_assert(runtime);
+
+    view_port_enabled_set(runtime->view_port, false);
+    gui_remove_view_port(runtime->gui, runtime->view_port);
+    furi_record_close(RECORD_GUI);
+    view_port_free(runtime->view_port);
+
+    if(runtime->dropped_inputs) {
+        FURI_LOG_W(TAG, "%lu input events dropped", runtime->dropped_inputs);
+    }
+
+    furi_mutex_free(runtime->swap_mutex);
+    free(runtime->buffers[0]);
+    free(runtime);
+}
+
+void game_runtime_run(GameRuntime* runtime) {
+    furi_assert(runtime);
+
+    const GameRuntimeConfig* config = &runtime->config;
+    uint32_t step_ticks = runtime->step_ticks;
+    uint32_t frame_ticks = furi_ms_to_ticks(config->frame_ms);
+    uint32_t last_tick = furi_get_tick();
+    uint32_t accumulator = 0;
+
+    runtime->running = true;
+    while(runtime->running) {
+        void* state = runtime->buffers[runtime->work];
+        bool changed = false;
+
+        // Inputs go first, so a step sees every key pressed before it
+        InputEvent event;
+        while(runtime->running && game_runtime_input_pop(runtime, &event)) {
+            if(config->input && !config->input(state, &event, config->context)) {
+                runtime->running = false;
+            }
+            changed = true;
+        }
+        if(!runtime->running) break;
+
+        uint32_t now = furi_get_tick();
+        accumulator = MIN(accumulator + (now - last_tick), step_ticks * MAX_CATCH_UP_STEPS);
+        last_tick = now;
+        while(accumulator >= step_ticks) {
+            config->update(state, config->context);
+            accumulator -= step_ticks;
+            changed = true;
+        }
+
+        if(changed) game_runtime_publish(runtime, now - accumulator);
+        if(changed || frame_ticks) view_port_update(runtime->view_port);
+
+        uint32_t timeout = step_ticks - accumulator;
+        if(frame_ticks && frame_ticks < timeout) timeout = frame_ticks;
+        furi_thread_flags_wait(FLAG_WAKE, FuriFlagWaitAny, timeout);
+    }
+}
+
+void game_runtime_stop(GameRuntime* runtime) {
+    furi_assert(runtime);
+
+    runtime->running = false;
+    furi_thread_flags_set(runtime->thread_id, FLAG_WAKE);
+}
+
+void* game_runtime_get_state(GameRuntime* runtime) {
+    furi_assert(runtime);
+    return runtime->buffers[runtime->work];
+}
+
+uint32_t game_runtime_get_dropped_inputs(const GameRuntime* runtime) {
+    furi_assert(runtime);
+    return runtime->dropped_inputs;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <furi.h>
+#include <gui/gui.h>
+#include <input/input.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Small game loop shared by the games: a fixed timestep update, a triple buffered state so
+ * drawing never waits for an update, and an input ring that doesn't block the input service.
+ *
+ * All callbacks but `draw` run on the thread that called game_runtime_run(), `draw` runs on
+ * the GUI thread and only ever sees a published copy of the state.
+ */
+typedef struct GameRuntime GameRuntime;
+
+/**
+ * @brief Applies one input event to the state, events are handled in order before the next step.
+ * @return false to stop the game.
+ */
+typedef bool (*GameRuntimeInputCallback)(void* state, const InputEvent* event, void* context);
+
+/** @brief Advances the state by one fixed step. */
+typedef void (*GameRuntimeUpdateCallback)(void* state, void* context);
+
+/**
+ * @brief Draws a published state.
+ * @param alpha how far the clock is into the next step, 0..1, for interpolating motion
+ */
+typedef void (
+    *GameRuntimeDrawCallback)(Canvas* canvas, const void* state, float alpha, void* context);
+
+typedef struct {
+    size_t state_size;
+    uint32_t step_ms; // length of one update step
+    uint32_t frame_ms; // redraw period, 0 redraws only after a step or an input
+    GameRuntimeInputCallback input;
+    GameRuntimeUpdateCallback update;
+    GameRuntimeDrawCallback draw;
+    void* context;
+} GameRuntimeConfig;
+
+/**
+ * @brief Allocates the runtime and shows its fullscreen view port. Must be called from the
+ *        thread that will call game_runtime_run().
+ * @param initial_state copied into every buffer
+ */
+GameRuntime* game_runtime_alloc(const GameRuntimeConfig* config, const void* initial_state);
+
+void game_runtime_free(GameRuntime* runtime);
+
+/** @brief Runs the game until an input callback returns false or game_runtime_stop() is called. */
+void game_runtime_run(GameRuntime* runtime);
+
+void game_runtime_stop(GameRuntime* runtime);
+
+/** @brief The state owned by the update side, only safe to use from the game thread. */
+void* game_runtime_get_state(GameRuntime* runtime);
+
+/** @brief Input events lost because the ring was full, it should stay 0. */
+uint32_t game_runtime_get_dropped_inputs(const GameRuntime* runtime);
+
+#ifdef __cplusplus
+}
+#endif
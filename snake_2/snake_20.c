@@ -5,6 +5,7 @@
 #include <dolphin/dolphin.h>
 #include <notification/notification.h>
 #include <notification/notification_messages.h>
+#include <game_runtime.h>
 
 typedef struct {
     //    +-----x
@@ -40,31 +41,56 @@ typedef enum {
     DirectionLeft,
 } Direction;
 
-#define MAX_SNAKE_LEN 15 * 31 //128 * 64 / 4
+#define FIELD_WIDTH 31
+#define FIELD_HEIGHT 15
+#define MAX_SNAKE_LEN (FIELD_WIDTH * FIELD_HEIGHT) //128 * 64 / 4
+
+// The fruit only appears where the snake can turn, on the cells with even x and y
+#define FRUIT_COLUMNS 16
+#define FRUIT_ROWS 8
+#define FRUIT_CELLS (FRUIT_COLUMNS * FRUIT_ROWS)
+#define NOT_FREE 0xFF
+
+// Autoplay follows a cycle through every cell but the last column, a closed tour needs an even
+// number of cells
+#define CYCLE_WIDTH (FIELD_WIDTH - 1)
+#define CYCLE_LENGTH (CYCLE_WIDTH * FIELD_HEIGHT)
+// cells kept between a shortcut and the tail, the snake grows while it gets there
+#define AUTOPLAY_MARGIN 4
+// steps the game over screen stays before autoplay starts over
+#define AUTOPLAY_RESTART_STEPS 80
 
 #define x_back_symbol 50
 #define y_back_symbol 9
 
+// Autoplay moves every step, the player every few
+#define STEP_MS 25
+#define NORMAL_STEPS 10
+#define BOOST_STEPS 5
+
 typedef struct {
-    FuriMutex* mutex;
+    // A ring, the head is at points[head] and the body follows it backwards
     Point points[MAX_SNAKE_LEN];
+    uint16_t head;
     uint16_t len;
+    // A bit per cell the snake covers
+    uint32_t occupied[FIELD_HEIGHT];
+    // Fruit cells neither the snake nor the fruit is on, free_slot says where a cell sits in
+    // free_cells or is NOT_FREE
+    uint8_t free_cells[FRUIT_CELLS];
+    uint8_t free_slot[FRUIT_CELLS];
+    uint8_t free_count;
     Direction currentMovement;
     Direction nextMovement; // if backward of currentMovement, ignore
     Point fruit;
     GameState state;
+    bool boost;
+    uint8_t step;
+    bool autoplay;
+    // moves autoplay follows the cycle before the body is sure to lie along it
+    uint16_t autoplay_settle;
 } SnakeState;
 
-typedef enum {
-    EventTypeTick,
-    EventTypeKey,
-} EventType;
-
-typedef struct {
-    EventType type;
-    InputEvent input;
-} SnakeEvent;
-
 const NotificationSequence sequence_fail = {
     &message_vibro_on,
 
@@ -97,10 +123,15 @@ const NotificationSequence sequence_eat = {
     NULL,
 };
 
-static void snake_game_render_callback(Canvas* const canvas, void* ctx) {
-    furi_assert(ctx);
-    const SnakeState* snake_state = ctx;
-    furi_mutex_acquire(snake_state->mutex, FuriWaitForever);
+static Point snake_game_segment(SnakeState const* const snake_state, uint16_t i) {
+    return snake_state->points[(snake_state->head + MAX_SNAKE_LEN - i) % MAX_SNAKE_LEN];
+}
+
+static void
+    snake_game_render_callback(Canvas* const canvas, const void* state, float alpha, void* ctx) {
+    UNUSED(alpha);
+    UNUSED(ctx);
+    const SnakeState* snake_state = state;
 
     // Before the function is called, the state is set with the canvas_reset(canvas)
 
@@ -118,7 +149,7 @@ static void snake_game_render_callback(Canvas* const canvas, void* ctx) {
 
     // Snake
     for(uint16_t i = 0; i < snake_state->len; i++) {
-        Point p = snake_state->points[i];
+        Point p = snake_game_segment(snake_state, i);
         p.x = p.x * 4 + 2;
         p.y = p.y * 4 + 2;
         canvas_draw_box(canvas, p.x, p.y, 4, 4);
@@ -187,29 +218,82 @@ static void snake_game_render_callback(Canvas* const canvas, void* ctx) {
             canvas_draw_dot(canvas, x_back_symbol - 1, y_back_symbol - 3);
         }
     }
+}
 
-    furi_mutex_release(snake_state->mutex);
+static uint8_t snake_game_fruit_cell(Point const p) {
+    return p.y / 2 * FRUIT_COLUMNS + p.x / 2;
 }
 
-static void snake_game_input_callback(InputEvent* input_event, FuriMessageQueue* event_queue) {
-    furi_assert(event_queue);
+static void snake_game_free_cells_add(SnakeState* const snake_state, uint8_t cell) {
+    snake_state->free_slot[cell] = snake_state->free_count;
+    snake_state->free_cells[snake_state->free_count++] = cell;
+}
 
-    SnakeEvent event = {.type = EventTypeKey, .input = *input_event};
-    furi_message_queue_put(event_queue, &event, FuriWaitForever);
+static void snake_game_free_cells_remove(SnakeState* const snake_state, uint8_t cell) {
+    uint8_t slot = snake_state->free_slot[cell];
+    if(slot == NOT_FREE) {
+        return;
+    }
+    // the last cell takes the removed one's slot
+    uint8_t last = snake_state->free_cells[--snake_state->free_count];
+    snake_state->free_cells[slot] = last;
+    snake_state->free_slot[last] = slot;
+    snake_state->free_slot[cell] = NOT_FREE;
 }
 
-static void snake_game_update_timer_callback(FuriMessageQueue* event_queue) {
-    furi_assert(event_queue);
+static void snake_game_occupy(SnakeState* const snake_state, Point const p) {
+    snake_state->occupied[p.y] |= 1UL << p.x;
+    if(p.x % 2 == 0 && p.y % 2 == 0) {
+        snake_game_free_cells_remove(snake_state, snake_game_fruit_cell(p));
+    }
+}
 
-    SnakeEvent event = {.type = EventTypeTick};
-    furi_message_queue_put(event_queue, &event, 0);
+static void snake_game_vacate(SnakeState* const snake_state, Point const p) {
+    snake_state->occupied[p.y] &= ~(1UL << p.x);
+    if(p.x % 2 == 0 && p.y % 2 == 0) {
+        snake_game_free_cells_add(snake_state, snake_game_fruit_cell(p));
+    }
+}
+
+static bool snake_game_place_fruit(SnakeState* const snake_state) {
+    if(snake_state->free_count == 0) {
+        return false;
+    }
+
+    uint8_t slot = rand() % snake_state->free_count;
+    if(snake_state->autoplay) {
+        // The cycle misses the last column, take the next free cell that is on it
+        uint8_t tries = snake_state->free_count;
+        while(snake_state->free_cells[slot] % FRUIT_COLUMNS == FRUIT_COLUMNS - 1) {
+            if(--tries == 0) {
+                return false;
+            }
+            slot = (slot + 1) % snake_state->free_count;
+        }
+    }
+
+    uint8_t cell = snake_state->free_cells[slot];
+    snake_game_free_cells_remove(snake_state, cell);
+    snake_state->fruit.x = cell % FRUIT_COLUMNS * 2;
+    snake_state->fruit.y = cell / FRUIT_COLUMNS * 2;
+    return true;
 }
 
 static void snake_game_init_game(SnakeState* const snake_state) {
-    Point p[] = {{8, 6}, {7, 6}, {6, 6}, {5, 6}, {4, 6}, {3, 6}, {2, 6}};
-    memcpy(snake_state->points, p, sizeof(p)); //-V1086
+    memset(snake_state->occupied, 0, sizeof(snake_state->occupied));
+    snake_state->free_count = 0;
+    for(uint8_t cell = 0; cell < FRUIT_CELLS; cell++) {
+        snake_game_free_cells_add(snake_state, cell);
+    }
 
-    snake_state->len = 7;
+    // tail first, the head ends up at points[6]
+    Point p[] = {{2, 6}, {3, 6}, {4, 6}, {5, 6}, {6, 6}, {7, 6}, {8, 6}};
+    for(uint8_t i = 0; i < COUNT_OF(p); i++) {
+        snake_state->points[i] = p[i];
+        snake_game_occupy(snake_state, p[i]);
+    }
+    snake_state->head = COUNT_OF(p) - 1;
+    snake_state->len = COUNT_OF(p);
 
     snake_state->currentMovement = DirectionRight;
 
@@ -217,69 +301,23 @@ static void snake_game_init_game(SnakeState* const snake_state) {
 
     Point f = {18, 6};
     snake_state->fruit = f;
+    snake_game_free_cells_remove(snake_state, snake_game_fruit_cell(f));
 
     snake_state->state = GameStateLife;
-}
-
-static Point snake_game_get_new_fruit(SnakeState const* const snake_state) {
-    // 1 bit for each point on the playing field where the snake can turn
-    // and where the fruit can appear
-    uint16_t buffer[8];
-    memset(buffer, 0, sizeof(buffer));
-    uint8_t empty = 8 * 16;
-
-    for(uint16_t i = 0; i < snake_state->len; i++) {
-        Point p = snake_state->points[i];
-
-        if(p.x % 2 != 0 || p.y % 2 != 0) {
-            continue;
-        }
-        p.x /= 2;
-        p.y /= 2;
-
-        buffer[p.y] |= 1 << p.x;
-        empty--;
-    }
-    // Bit set if snake use that playing field
-
-    uint16_t newFruit = rand() % empty;
-
-    // Skip random number of _empty_ fields
-    for(uint8_t y = 0; y < 8; y++) {
-        for(uint16_t x = 0, mask = 1; x < 16; x += 1, mask <<= 1) {
-            if((buffer[y] & mask) == 0) {
-                if(newFruit == 0) {
-                    Point p = {
-                        .x = x * 2,
-                        .y = y * 2,
-                    };
-                    return p;
-                }
-                newFruit--;
-            }
-        }
-    }
-    // We will never be here
-    Point p = {0, 0};
-    return p;
+    snake_state->boost = false;
+    snake_state->step = 0;
+    snake_state->autoplay_settle = snake_state->len;
 }
 
 static bool snake_game_collision_with_frame(Point const next_step) {
     // if x == 0 && currentMovement == left then x - 1 == 255 ,
     // so check only x > right border
-    return next_step.x > 30 || next_step.y > 14;
+    return next_step.x > FIELD_WIDTH - 1 || next_step.y > FIELD_HEIGHT - 1;
 }
 
 static bool
     snake_game_collision_with_tail(SnakeState const* const snake_state, Point const next_step) {
-    for(uint16_t i = 0; i < snake_state->len; i++) {
-        Point p = snake_state->points[i];
-        if(p.x == next_step.x && p.y == next_step.y) {
-            return true;
-        }
-    }
-
-    return false;
+    return snake_state->occupied[next_step.y] & (1UL << next_step.x);
 }
 
 static Direction snake_game_get_turn_snake(SnakeState const* const snake_state) {
@@ -288,9 +326,8 @@ static Direction snake_game_get_turn_snake(SnakeState const* const snake_state)
     return is_orthogonal ? snake_state->nextMovement : snake_state->currentMovement;
 }
 
-static Point snake_game_get_next_step(SnakeState const* const snake_state) {
-    Point next_step = snake_state->points[0];
-    switch(snake_state->currentMovement) {
+static Point snake_game_step_from(Point next_step, Direction const direction) {
+    switch(direction) {
     // +-----x
     // |
     // |
@@ -311,17 +348,135 @@ static Point snake_game_get_next_step(SnakeState const* const snake_state) {
     return next_step;
 }
 
-static void snake_game_move_snake(SnakeState* const snake_state, Point const next_step) {
-    memmove(snake_state->points + 1, snake_state->points, snake_state->len * sizeof(Point));
-    snake_state->points[0] = next_step;
+static Point snake_game_get_next_step(SnakeState const* const snake_state) {
+    return snake_game_step_from(
+        snake_state->points[snake_state->head], snake_state->currentMovement);
 }
 
 static void
-    snake_game_process_game_step(SnakeState* const snake_state, NotificationApp* notification) {
-    if(snake_state->state == GameStateGameOver) {
+    snake_game_move_snake(SnakeState* const snake_state, Point const next_step, bool grow) {
+    if(!grow) {
+        snake_game_vacate(snake_state, snake_game_segment(snake_state, snake_state->len - 1));
+    }
+    snake_state->head = (snake_state->head + 1) % MAX_SNAKE_LEN;
+    snake_state->points[snake_state->head] = next_step;
+    snake_game_occupy(snake_state, next_step);
+}
+
+// Position of a cell on the autoplay cycle: right along the top row, down and up the columns
+// from 29 to 1 below it and back up column 0
+static uint16_t snake_game_cycle_index(Point const p) {
+    if(p.y == 0) {
+        return p.x;
+    }
+    if(p.x == 0) {
+        return CYCLE_LENGTH - p.y;
+    }
+    uint16_t column = CYCLE_WIDTH - 1 - p.x;
+    uint16_t row = column % 2 == 0 ? p.y - 1 : FIELD_HEIGHT - 1 - p.y;
+    return CYCLE_WIDTH + column * (FIELD_HEIGHT - 1) + row;
+}
+
+// How far ahead of from the cycle gets to to
+static uint16_t snake_game_cycle_distance(uint16_t from, uint16_t to) {
+    return (to + CYCLE_LENGTH - from) % CYCLE_LENGTH;
+}
+
+static bool snake_game_autoplay_free(SnakeState const* const snake_state, Point const p) {
+    return !snake_game_collision_with_frame(p) && p.x < CYCLE_WIDTH &&
+           !snake_game_collision_with_tail(snake_state, p);
+}
+
+// Follows the cycle, which can't go wrong once the body lies along it, and cuts ahead towards
+// the fruit while the snake is short and the cut stays clear of the tail
+static Direction snake_game_autoplay(SnakeState* const snake_state) {
+    Point head = snake_state->points[snake_state->head];
+    bool on_cycle = head.x < CYCLE_WIDTH;
+    Point tail = snake_game_segment(snake_state, snake_state->len - 1);
+    uint16_t from = snake_game_cycle_index(head);
+    uint16_t to_fruit =
+        snake_game_cycle_distance(from, snake_game_cycle_index(snake_state->fruit));
+    uint16_t to_tail = snake_game_cycle_distance(from, snake_game_cycle_index(tail));
+    bool shortcuts = on_cycle && snake_state->autoplay_settle == 0 &&
+                     snake_state->len < CYCLE_LENGTH / 2;
+
+    int8_t next = -1;
+    int8_t shortcut = -1;
+    int8_t any = -1;
+    uint16_t best = 1;
+    for(uint8_t direction = DirectionUp; direction <= DirectionLeft; direction++) {
+        Point p = snake_game_step_from(head, direction);
+        if(!snake_game_autoplay_free(snake_state, p)) {
+            continue;
+        }
+        any = direction;
+        uint16_t distance = snake_game_cycle_distance(from, snake_game_cycle_index(p));
+        if(distance == 1) {
+            next = direction;
+        }
+        if(shortcuts && distance > best && distance <= to_fruit &&
+           distance + AUTOPLAY_MARGIN < to_tail) {
+            best = distance;
+            shortcut = direction;
+        }
+    }
+
+    if(shortcut >= 0) {
+        return shortcut;
+    }
+    if(on_cycle && next >= 0) {
+        if(snake_state->autoplay_settle > 0) {
+            snake_state->autoplay_settle--;
+        }
+        return next;
+    }
+    // off the cycle, the body is out of order until it has followed the cycle again
+    snake_state->autoplay_settle = snake_state->len;
+    return any >= 0 ? (Direction)any : snake_state->currentMovement;
+}
+
+static void snake_game_autoplay_toggle(SnakeState* const snake_state) {
+    snake_state->autoplay = !snake_state->autoplay;
+    snake_state->autoplay_settle = snake_state->len;
+    snake_state->boost = false;
+    snake_state->step = 0;
+    if(snake_state->autoplay && snake_state->fruit.x >= CYCLE_WIDTH) {
+        // out of reach of the cycle, put it somewhere else
+        snake_game_free_cells_add(snake_state, snake_game_fruit_cell(snake_state->fruit));
+        snake_game_place_fruit(snake_state);
+    }
+}
+
+// Autoplay keeps quiet, it would beep all the time
+static void snake_game_notify(
+    SnakeState const* const snake_state,
+    NotificationApp* notification,
+    const NotificationSequence* sequence) {
+    if(!snake_state->autoplay) {
+        notification_message(notification, sequence);
+    }
+}
+
+static void snake_game_process_game_step(void* state, void* ctx) {
+    SnakeState* const snake_state = state;
+    NotificationApp* notification = ctx;
+    if(snake_state->state == GameStateGameOver && snake_state->autoplay &&
+       ++snake_state->step >= AUTOPLAY_RESTART_STEPS) {
+        snake_game_init_game(snake_state);
+        return;
+    }
+    if(snake_state->state == GameStateGameOver || snake_state->state == GameStatePause) {
         return;
     }
+    uint8_t period = snake_state->autoplay ? 1 : snake_state->boost ? BOOST_STEPS : NORMAL_STEPS;
+    if(++snake_state->step < period) {
+        return;
+    }
+    snake_state->step = 0;
 
+    if(snake_state->autoplay) {
+        snake_state->nextMovement = snake_game_autoplay(snake_state);
+    }
     snake_state->currentMovement = snake_game_get_turn_snake(snake_state);
 
     Point next_step = snake_game_get_next_step(snake_state);
@@ -333,7 +488,9 @@ static void
             return;
         } else if(snake_state->state == GameStateLastChance) {
             snake_state->state = GameStateGameOver;
-            notification_message_block(notification, &sequence_fail);
+            if(!snake_state->autoplay) {
+                notification_message_block(notification, &sequence_fail);
+            }
             return;
         }
     } else {
@@ -345,7 +502,9 @@ static void
     crush = snake_game_collision_with_tail(snake_state, next_step);
     if(crush) {
         snake_state->state = GameStateGameOver;
-        notification_message_block(notification, &sequence_fail);
+        if(!snake_state->autoplay) {
+            notification_message_block(notification, &sequence_fail);
+        }
         return;
     }
 
@@ -355,174 +514,164 @@ static void
         if(snake_state->len >= MAX_SNAKE_LEN) {
             //You win!!!
             snake_state->state = GameStateGameOver;
-            notification_message_block(notification, &sequence_fail);
+            if(!snake_state->autoplay) {
+                notification_message_block(notification, &sequence_fail);
+            }
             return;
         }
     }
 
-    snake_game_move_snake(snake_state, next_step);
+    snake_game_move_snake(snake_state, next_step, eatFruit);
 
     if(eatFruit) {
-        snake_state->fruit = snake_game_get_new_fruit(snake_state);
-        notification_message(notification, &sequence_eat);
-        notification_message(notification, &sequence_blink_red_100);
+        if(!snake_game_place_fruit(snake_state)) {
+            // no cell left for a fruit, you win too
+            snake_state->state = GameStateGameOver;
+            if(!snake_state->autoplay) {
+                notification_message_block(notification, &sequence_fail);
+            }
+            return;
+        }
+        snake_game_notify(snake_state, notification, &sequence_eat);
+        snake_game_notify(snake_state, notification, &sequence_blink_red_100);
+    }
+}
+
+static bool snake_game_input_callback(void* state, const InputEvent* input, void* ctx) {
+    UNUSED(ctx);
+    SnakeState* const snake_state = state;
+
+    // press events
+    if(input->type == InputTypePress) {
+        switch(input->key) {
+        case InputKeyUp:
+            if(snake_state->state != GameStatePause) {
+                snake_state->nextMovement = DirectionUp;
+                snake_state->autoplay = false;
+            }
+            break;
+        case InputKeyDown:
+            if(snake_state->state != GameStatePause) {
+                snake_state->nextMovement = DirectionDown;
+                snake_state->autoplay = false;
+            }
+            break;
+        case InputKeyRight:
+            if(snake_state->state != GameStatePause) {
+                snake_state->nextMovement = DirectionRight;
+                snake_state->autoplay = false;
+            }
+            break;
+        case InputKeyLeft:
+            if(snake_state->state != GameStatePause) {
+                snake_state->nextMovement = DirectionLeft;
+                snake_state->autoplay = false;
+            }
+            break;
+        case InputKeyOk:
+            if(snake_state->state == GameStateGameOver) {
+                snake_game_init_game(snake_state);
+            }
+            if(snake_state->state == GameStatePause) {
+                snake_state->boost = false;
+                snake_state->state = GameStateLife;
+            }
+            break;
+        case InputKeyBack:
+            if(snake_state->state == GameStateLife) {
+                snake_state->state = GameStatePause;
+                break;
+            }
+            if(snake_state->state == GameStatePause) {
+                snake_state->boost = false;
+                snake_state->state = GameStateLife;
+                break;
+            }
+            if(snake_state->state == GameStateGameOver) {
+                snake_game_init_game(snake_state);
+            }
+        default:
+            break;
+        }
+    }
+    //LongPress Events
+    if(input->type == InputTypeLong) {
+        switch(input->key) {
+        case InputKeyUp:
+            if(snake_state->state != GameStatePause) {
+                snake_state->nextMovement = DirectionUp;
+                snake_state->boost = true;
+            }
+            break;
+        case InputKeyDown:
+            if(snake_state->state != GameStatePause) {
+                snake_state->nextMovement = DirectionDown;
+                snake_state->boost = true;
+            }
+            break;
+        case InputKeyRight:
+            if(snake_state->state != GameStatePause) {
+                snake_state->nextMovement = DirectionRight;
+                snake_state->boost = true;
+            }
+            break;
+        case InputKeyLeft:
+            if(snake_state->state != GameStatePause) {
+                snake_state->nextMovement = DirectionLeft;
+                snake_state->boost = true;
+            }
+            break;
+        case InputKeyOk:
+            if(snake_state->state != GameStatePause && snake_state->state != GameStateGameOver) {
+                snake_game_autoplay_toggle(snake_state);
+            }
+            break;
+        case InputKeyBack:
+            return false;
+        default:
+            break;
+        }
     }
+    //ReleaseKey Event
+    if(input->type == InputTypeRelease) {
+        if(snake_state->state != GameStatePause) {
+            snake_state->boost = false;
+        }
+    }
+    return true;
 }
 
 int32_t snake_20_app(void* p) {
     UNUSED(p);
 
-    FuriMessageQueue* event_queue = furi_message_queue_alloc(8, sizeof(SnakeEvent));
-
     SnakeState* snake_state = malloc(sizeof(SnakeState));
+    snake_state->autoplay = false;
     snake_game_init_game(snake_state);
 
-    snake_state->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
-    if(!snake_state->mutex) {
-        FURI_LOG_E("SnakeGame", "cannot create mutex\r\n");
-        furi_message_queue_free(event_queue);
-        free(snake_state);
-        return 255;
-    }
-
-    ViewPort* view_port = view_port_alloc();
-    view_port_draw_callback_set(view_port, snake_game_render_callback, snake_state);
-    view_port_input_callback_set(view_port, snake_game_input_callback, event_queue);
-
-    FuriTimer* timer =
-        furi_timer_alloc(snake_game_update_timer_callback, FuriTimerTypePeriodic, event_queue);
-    furi_timer_start(timer, furi_kernel_get_tick_frequency() / 4);
-
-    // Open GUI and register view_port
-    Gui* gui = furi_record_open(RECORD_GUI);
-    gui_add_view_port(gui, view_port, GuiLayerFullscreen);
     NotificationApp* notification = furi_record_open(RECORD_NOTIFICATION);
 
+    GameRuntimeConfig config = {
+        .state_size = sizeof(SnakeState),
+        .step_ms = STEP_MS,
+        .input = snake_game_input_callback,
+        .update = snake_game_process_game_step,
+        .draw = snake_game_render_callback,
+        .context = notification,
+    };
+    GameRuntime* runtime = game_runtime_alloc(&config, snake_state);
+    free(snake_state);
+
     notification_message_block(notification, &sequence_display_backlight_enforce_on);
 
     dolphin_deed(DolphinDeedPluginGameStart);
 
-    SnakeEvent event;
-    for(bool processing = true; processing;) {
-        FuriStatus event_status = furi_message_queue_get(event_queue, &event, 100);
-
-        furi_mutex_acquire(snake_state->mutex, FuriWaitForever);
-
-        if(event_status == FuriStatusOk) {
-            if(event.type == EventTypeKey) {
-                // press events
-                if(event.input.type == InputTypePress) {
-                    switch(event.input.key) {
-                    case InputKeyUp:
-                        if(snake_state->state != GameStatePause) {
-                            snake_state->nextMovement = DirectionUp;
-                        }
-                        break;
-                    case InputKeyDown:
-                        if(snake_state->state != GameStatePause) {
-                            snake_state->nextMovement = DirectionDown;
-                        }
-                        break;
-                    case InputKeyRight:
-                        if(snake_state->state != GameStatePause) {
-                            snake_state->nextMovement = DirectionRight;
-                        }
-                        break;
-                    case InputKeyLeft:
-                        if(snake_state->state != GameStatePause) {
-                            snake_state->nextMovement = DirectionLeft;
-                        }
-                        break;
-                    case InputKeyOk:
-                        if(snake_state->state == GameStateGameOver) {
-                            snake_game_init_game(snake_state);
-                        }
-                        if(snake_state->state == GameStatePause) {
-                            furi_timer_start(timer, furi_kernel_get_tick_frequency() / 4);
-                            snake_state->state = GameStateLife;
-                        }
-                        break;
-                    case InputKeyBack:
-                        if(snake_state->state == GameStateLife) {
-                            furi_timer_stop(timer);
-                            snake_state->state = GameStatePause;
-                            break;
-                        }
-                        if(snake_state->state == GameStatePause) {
-                            furi_timer_start(timer, furi_kernel_get_tick_frequency() / 4);
-                            snake_state->state = GameStateLife;
-                            break;
-                        }
-                        if(snake_state->state == GameStateGameOver) {
-                            snake_game_init_game(snake_state);
-                        }
-                    default:
-                        break;
-                    }
-                }
-                //LongPress Events
-                if(event.input.type == InputTypeLong) {
-                    switch(event.input.key) {
-                    case InputKeyUp:
-                        if(snake_state->state != GameStatePause) {
-                            snake_state->nextMovement = DirectionUp;
-                            furi_timer_start(timer, furi_kernel_get_tick_frequency() / 8);
-                        }
-                        break;
-                    case InputKeyDown:
-                        if(snake_state->state != GameStatePause) {
-                            snake_state->nextMovement = DirectionDown;
-                            furi_timer_start(timer, furi_kernel_get_tick_frequency() / 8);
-                        }
-                        break;
-                    case InputKeyRight:
-                        if(snake_state->state != GameStatePause) {
-                            snake_state->nextMovement = DirectionRight;
-                            furi_timer_start(timer, furi_kernel_get_tick_frequency() / 8);
-                        }
-                        break;
-                    case InputKeyLeft:
-                        if(snake_state->state != GameStatePause) {
-                            snake_state->nextMovement = DirectionLeft;
-                            furi_timer_start(timer, furi_kernel_get_tick_frequency() / 8);
-                        }
-                        break;
-                    case InputKeyBack:
-                        processing = false;
-                        break;
-                    default:
-                        break;
-                    }
-                }
-                //ReleaseKey Event
-                if(event.input.type == InputTypeRelease) {
-                    if(snake_state->state != GameStatePause) {
-                        furi_timer_start(timer, furi_kernel_get_tick_frequency() / 4);
-                    }
-                }
-            } else if(event.type == EventTypeTick) {
-                snake_game_process_game_step(snake_state, notification);
-            }
-        } else {
-            // event timeout
-        }
-
-        furi_mutex_release(snake_state->mutex);
-        view_port_update(view_port);
-    }
+    game_runtime_run(runtime);
 
     // Wait for all notifications to be played and return backlight to normal state
     notification_message_block(notification, &sequence_display_backlight_enforce_auto);
 
-    furi_timer_free(timer);
-    view_port_enabled_set(view_port, false);
-    gui_remove_view_port(gui, view_port);
-    furi_record_close(RECORD_GUI);
+    game_runtime_free(runtime);
     furi_record_close(RECORD_NOTIFICATION);
-    view_port_free(view_port);
-    furi_message_queue_free(event_queue);
-    furi_mutex_free(snake_state->mutex);
-    free(snake_state);
 
     return 0;
-}
\ No newline at end of file
+}
@@ -145,12 +145,41 @@ void generate_deck(Deck* deck_ptr, uint8_t deck_count) {
     }
 }
 
-void shuffle_deck(Deck* deck_ptr) {
-    srand(DWT->CYCCNT);
+// xorshift32, the state must never be 0
+static uint32_t next_random(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// Uniform number in [0, bound): values from the incomplete block at the top of the 32 bit
+// range are drawn again, a plain modulo would favour the low numbers
+static uint32_t random_below(uint32_t* state, uint32_t bound) {
+    uint32_t limit = UINT32_MAX - UINT32_MAX % bound;
+    uint32_t value;
+    do {
+        value = next_random(state);
+    } while(value >= limit);
+    return value % bound;
+}
+
+void shuffle_deck(Deck* deck_ptr, uint32_t seed) {
+    // spread the seed over all the bits so that neighbouring seeds give unrelated deals
+    uint32_t state = seed;
+    state ^= state >> 16;
+    state *= 0x85ebca6b;
+    state ^= state >> 13;
+    state *= 0xc2b2ae35;
+    state ^= state >> 16;
+    if(state == 0) state = 0x9e3779b9;
+
     deck_ptr->index = 0;
     int max = deck_ptr->deck_count * 52;
     for(int i = 0; i < max; i++) {
-        int r = i + (rand() % (max - i));
+        int r = i + random_below(&state, max - i);
         Card tmp = deck_ptr->cards[i];
         deck_ptr->cards[i] = deck_ptr->cards[r];
         deck_ptr->cards[r] = tmp;
@@ -220,7 +249,6 @@ void free_hand(Hand* hand_ptr) {
 }
 
 void add_to_hand(Hand* hand_ptr, Card card) {
-    FURI_LOG_D("CARD", "Adding to hand");
     if(hand_ptr->index < hand_ptr->max) {
         hand_ptr->cards[hand_ptr->index] = card;
         hand_ptr->index++;
@@ -314,7 +342,6 @@ void draw_hand_column(
 }
 
 Card remove_from_deck(uint16_t index, Deck* deck) {
-    FURI_LOG_D("CARD", "Removing from deck");
     Card result = {0, 0, true, false};
     if(deck->card_count > 0) {
         deck->card_count--;
@@ -334,7 +361,6 @@ Card remove_from_deck(uint16_t index, Deck* deck) {
 }
 
 void extract_hand_region(Hand* hand, Hand* to, uint8_t start_index) {
-    FURI_LOG_D("CARD", "Extracting hand region");
     if(start_index >= hand->index) return;
 
     for(uint8_t i = start_index; i < hand->index; i++) {
@@ -344,7 +370,6 @@ void extract_hand_region(Hand* hand, Hand* to, uint8_t start_index) {
 }
 
 void add_hand_region(Hand* to, Hand* from) {
-    FURI_LOG_D("CARD", "Adding hand region");
     if((to->index + from->index) <= to->max) {
         for(int i = 0; i < from->index; i++) {
             add_to_hand(to, from->cards[i]);
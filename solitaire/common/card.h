@@ -98,11 +98,12 @@ void draw_card_back_at(int8_t pos_x, int8_t pos_y, Canvas* const canvas);
 void generate_deck(Deck* deck_ptr, uint8_t deck_count);
 
 /**
- * Shuffles the deck
+ * Shuffles the deck, the same seed always gives the same order
  *
  * @param deck_ptr Pointer to the deck
+ * @param seed     Seed of the shuffle
  */
-void shuffle_deck(Deck* deck_ptr);
+void shuffle_deck(Deck* deck_ptr, uint32_t seed);
 
 /**
  * Calculates the hand count for blackjack
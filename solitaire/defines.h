@@ -6,8 +6,12 @@
 #include <flipper_format/flipper_format_i.h>
 #include "common/card.h"
 #include "common/queue.h"
+#include "solver.h"
 
 #define APP_NAME "Solitaire"
+#define UNDO_DEPTH 32
+// deals are numbered from 1 to DEAL_COUNT
+#define DEAL_COUNT (1 << 20)
 
 typedef enum {
     EventTypeTick,
@@ -21,6 +25,12 @@ typedef struct {
 
 typedef enum { GameStateGameOver, GameStateStart, GameStatePlay, GameStateAnimate } PlayState;
 
+typedef enum {
+    AssistNone,
+    AssistHint, // waiting for the solver to pick the move to show
+    AssistAutoSolve, // playing the solver's moves one by one
+} AssistMode;
+
 typedef struct {
     uint8_t* buffer;
     Card card;
@@ -55,4 +65,18 @@ typedef struct {
     CardAnimation animation;
     uint8_t* buffer;
     FuriMutex* mutex;
+
+    uint32_t deal; // deal number, the seed of the shuffle
+    Board* undo; // ring buffer of the last UNDO_DEPTH positions
+    uint8_t undo_start;
+    uint8_t undo_count;
+    Board undo_pending; // position before the cards in hand were picked up
+
+    Solver* solver;
+    AssistMode assist;
+    Board assist_board; // position the auto solve is playing on
+    uint16_t assist_step;
+    unsigned int assist_tick;
+    int8_t hint_row; // where the hinted move goes, -1 if no hint is shown
+    int8_t hint_column;
 } GameState;
\ No newline at end of file
@@ -1,12 +1,15 @@
 #include <stdlib.h>
 #include <dolphin/dolphin.h>
 #include <furi.h>
+#include <furi_hal.h>
 #include <gui/canvas_i.h>
 #include "defines.h"
 #include "common/ui.h"
 #include "solitaire_icons.h"
 #include <notification/notification.h>
 #include <notification/notification_messages.h>
+#define AUTO_SOLVE_DELAY_MS 250
+
 void init(GameState* game_state);
 
 const NotificationSequence sequence_fail = {
@@ -124,6 +127,16 @@ static void draw_scene(Canvas* const canvas, const GameState* game_state) {
             columns[game_state->selectColumn][0],
             columns[game_state->selectColumn][game_state->selectRow + 1]};
 
+        if(game_state->hint_row >= 0) {
+            draw_rounded_box(
+                canvas,
+                columns[game_state->hint_column][0],
+                columns[game_state->hint_column][game_state->hint_row + 1],
+                CARD_WIDTH,
+                CARD_HEIGHT,
+                Inverse);
+        }
+
         /*     draw_icon_clip(canvas, &I_card_graphics, pos[0] + CARD_HALF_WIDTH, pos[1] + CARD_HALF_HEIGHT, 30, 5, 5, 5,
                             Filled);*/
 
@@ -170,9 +183,14 @@ static void render_callback(Canvas* const canvas, void* ctx) {
     case GameStateAnimate:
         draw_animation(canvas, game_state);
         break;
-    case GameStateStart:
+    case GameStateStart: {
         canvas_draw_icon(canvas, 0, 0, &I_solitaire_main);
+        char deal[20];
+        snprintf(deal, sizeof(deal), "< Deal %lu >", game_state->deal);
+        canvas_set_font(canvas, FontSecondary);
+        canvas_draw_str_aligned(canvas, 126, 63, AlignRight, AlignBottom, deal);
         break;
+    }
     case GameStatePlay:
         draw_scene(canvas, game_state);
         break;
@@ -273,6 +291,210 @@ bool place_on_top(Card* where, Card what) {
     return false;
 }
 
+static uint32_t random_deal(void) {
+    return (furi_hal_random_get() & (DEAL_COUNT - 1)) + 1;
+}
+
+static uint8_t card_code(Card card) {
+    // the game counts the ranks from the 2 with the ace last, the board from the ace
+    uint8_t rank = card.character == 12 ? 0 : card.character + 1;
+    return card.pip * 13 + rank;
+}
+
+static Card code_card(uint8_t code) {
+    uint8_t card = code & ~BOARD_FACE_DOWN;
+    uint8_t rank = card % 13;
+    return (Card){card / 13, rank == 0 ? 12 : rank - 1, false, (code & BOARD_FACE_DOWN) != 0};
+}
+
+// Only valid while no cards are in hand
+static void board_from_game(const GameState* game_state, Board* board) {
+    for(uint8_t i = 0; i < BOARD_COLUMNS; i++) {
+        const Hand* hand = &game_state->bottom_columns[i];
+        board->column_count[i] = hand->index;
+        for(uint8_t j = 0; j < hand->index; j++) {
+            board->columns[i][j] = card_code(hand->cards[j]) |
+                                   (hand->cards[j].flipped ? BOARD_FACE_DOWN : 0);
+        }
+    }
+
+    board->stock_count = game_state->deck.card_count;
+    for(uint8_t i = 0; i < board->stock_count; i++) {
+        board->stock[i] = card_code(game_state->deck.cards[i]);
+    }
+    board->waste = game_state->deck.index;
+
+    for(uint8_t i = 0; i < BOARD_FOUNDATIONS; i++) {
+        Card top = game_state->top_cards[i];
+        board->foundations[i] = top.disabled ? BOARD_NO_CARD : card_code(top);
+    }
+}
+
+static void board_to_game(const Board* board, GameState* game_state) {
+    for(uint8_t i = 0; i < BOARD_COLUMNS; i++) {
+        Hand* hand = &game_state->bottom_columns[i];
+        hand->index = board->column_count[i];
+        for(uint8_t j = 0; j < hand->index; j++) {
+            hand->cards[j] = code_card(board->columns[i][j]);
+        }
+    }
+
+    game_state->deck.card_count = board->stock_count;
+    for(uint8_t i = 0; i < board->stock_count; i++) {
+        game_state->deck.cards[i] = code_card(board->stock[i]);
+    }
+    game_state->deck.index = board->waste;
+
+    for(uint8_t i = 0; i < BOARD_FOUNDATIONS; i++) {
+        uint8_t top = board->foundations[i];
+        game_state->top_cards[i] = top == BOARD_NO_CARD ? (Card){0, 0, true, false} :
+                                                           code_card(top);
+    }
+
+    game_state->dragging_hand.index = 0;
+    game_state->dragging_deck = false;
+    game_state->dragging_column = 8;
+    game_state->selected_card = 0;
+}
+
+static void push_undo(GameState* game_state, const Board* board) {
+    game_state->undo[(game_state->undo_start + game_state->undo_count) % UNDO_DEPTH] = *board;
+    if(game_state->undo_count < UNDO_DEPTH) {
+        game_state->undo_count++;
+    } else {
+        // the oldest position got overwritten
+        game_state->undo_start = (game_state->undo_start + 1) % UNDO_DEPTH;
+    }
+}
+
+static void stop_assist(GameState* game_state) {
+    if(game_state->assist != AssistNone) {
+        solver_stop(game_state->solver);
+        game_state->assist = AssistNone;
+    }
+    game_state->hint_row = -1;
+}
+
+static bool undo(GameState* game_state) {
+    stop_assist(game_state);
+    if(game_state->dragging_hand.index > 0) {
+        // put the cards in hand back where they were taken from
+        board_to_game(&game_state->undo_pending, game_state);
+        return true;
+    }
+    if(game_state->undo_count == 0) return false;
+
+    game_state->undo_count--;
+    board_to_game(
+        &game_state->undo[(game_state->undo_start + game_state->undo_count) % UNDO_DEPTH],
+        game_state);
+    return true;
+}
+
+static bool start_assist(GameState* game_state, AssistMode mode) {
+    stop_assist(game_state);
+    if(game_state->dragging_hand.index > 0) return false;
+
+    Board* board = &game_state->assist_board;
+    board_from_game(game_state, board);
+    if(mode == AssistHint) {
+        // turning a card needs no search
+        for(uint8_t i = 0; i < BOARD_COLUMNS; i++) {
+            uint8_t count = board->column_count[i];
+            if(count && (board->columns[i][count - 1] & BOARD_FACE_DOWN)) {
+                game_state->selectRow = 1;
+                game_state->selectColumn = i;
+                game_state->selected_card = 0;
+                return true;
+            }
+        }
+    }
+
+    solver_start(game_state->solver, board);
+    // the moves found assume the top cards are turned
+    board_turn_top_cards(board);
+    game_state->assist = mode;
+    game_state->assist_step = 0;
+    game_state->assist_tick = furi_get_tick();
+    return true;
+}
+
+static void show_hint(GameState* game_state, const SolverMove* move) {
+    game_state->selected_card = 0;
+    game_state->hint_row = -1;
+    if(move->type == SolverMoveDraw) {
+        game_state->selectRow = 0;
+        game_state->selectColumn = 0;
+        return;
+    }
+
+    if(move->from == BOARD_WASTE) {
+        game_state->selectRow = 0;
+        game_state->selectColumn = 1;
+    } else {
+        game_state->selectRow = 1;
+        game_state->selectColumn = move->from;
+        if(move->type == SolverMoveToColumn) game_state->selected_card = move->count - 1;
+    }
+
+    if(move->type == SolverMoveToFoundation) {
+        game_state->hint_row = 0;
+        game_state->hint_column = move->to + 3;
+    } else {
+        game_state->hint_row = 1;
+        game_state->hint_column = move->to;
+    }
+}
+
+// Picks up the solver's result once it is done, the auto solve plays a move at a time
+static void update_assist(GameState* game_state, NotificationApp* notification) {
+    if(game_state->assist == AssistNone || !solver_is_done(game_state->solver)) return;
+
+    const SolverMove* moves;
+    uint16_t count = solver_get_moves(game_state->solver, &moves);
+    bool solved = solver_is_solved(game_state->solver);
+
+    if(game_state->assist == AssistAutoSolve && solved) {
+        if(game_state->assist_step >= count) {
+            game_state->assist = AssistNone;
+            return;
+        }
+        if(game_state->last_tick - game_state->assist_tick <
+           furi_ms_to_ticks(AUTO_SOLVE_DELAY_MS)) {
+            return;
+        }
+        game_state->assist_tick = game_state->last_tick;
+
+        Board current;
+        board_from_game(game_state, &current);
+        push_undo(game_state, &current);
+
+        SolverMove move = moves[game_state->assist_step++];
+        solver_apply_move(&game_state->assist_board, &move);
+        board_to_game(&game_state->assist_board, game_state);
+        game_state->had_change = true;
+        return;
+    }
+
+    // a hint, or no solution was found: point at the move that gets the furthest
+    if(count > 0) show_hint(game_state, &moves[0]);
+    if(count == 0 || game_state->assist == AssistAutoSolve) {
+        notification_message(notification, &sequence_fail);
+    }
+    game_state->assist = AssistNone;
+    game_state->had_change = true;
+}
+
+static void select_deal(GameState* game_state, InputKey key) {
+    if(key == InputKeyLeft) {
+        game_state->deal = game_state->deal > 1 ? game_state->deal - 1 : DEAL_COUNT;
+    } else if(key == InputKeyRight) {
+        game_state->deal = game_state->deal < DEAL_COUNT ? game_state->deal + 1 : 1;
+    } else {
+        game_state->deal = random_deal();
+    }
+}
+
 void tick(GameState* game_state, NotificationApp* notification) {
     game_state->last_tick = furi_get_tick();
     uint8_t row = game_state->selectRow;
@@ -288,9 +510,22 @@ void tick(GameState* game_state, NotificationApp* notification) {
 
             return;
         }
+
+        if(game_state->input != InputKeyMAX) {
+            game_state->hint_row = -1;
+            if(game_state->assist == AssistAutoSolve || game_state->input == InputKeyOk) {
+                stop_assist(game_state);
+            }
+        }
+        update_assist(game_state, notification);
     }
     if(handleInput(game_state)) {
         if(game_state->state == GameStatePlay) {
+            bool returned = false;
+            if(game_state->dragging_hand.index == 0) {
+                board_from_game(game_state, &game_state->undo_pending);
+            }
+
             if(game_state->longPress && game_state->dragging_hand.index == 1) {
                 for(uint8_t i = 0; i < 4; i++) {
                     if(place_on_top(
@@ -313,6 +548,7 @@ void tick(GameState* game_state, NotificationApp* notification) {
                     //place
                     if(game_state->dragging_deck) {
                         wasAction = true;
+                        returned = true;
                         game_state->dragging_deck = false;
                         game_state->dragging_hand.index = 0;
                     }
@@ -361,6 +597,7 @@ void tick(GameState* game_state, NotificationApp* notification) {
                         if(game_state->dragging_column == column ||
                            (curr_hand->index == 0 && first.character == 11) ||
                            can_place_card(curr_hand->cards[curr_hand->index - 1], first)) {
+                            returned = game_state->dragging_column == column;
                             add_hand_region(curr_hand, &(game_state->dragging_hand));
                             remove_drag(game_state);
                             wasAction = true;
@@ -371,6 +608,8 @@ void tick(GameState* game_state, NotificationApp* notification) {
 
             if(!wasAction) {
                 notification_message(notification, &sequence_fail);
+            } else if(game_state->dragging_hand.index == 0 && !returned) {
+                push_undo(game_state, &game_state->undo_pending);
             }
         }
     }
@@ -378,6 +617,7 @@ void tick(GameState* game_state, NotificationApp* notification) {
         if(game_state->animation.started && !game_state->longPress &&
            game_state->input == InputKeyOk) {
             init(game_state);
+            game_state->deal = random_deal();
             game_state->state = GameStateStart;
         }
 
@@ -390,6 +630,7 @@ void tick(GameState* game_state, NotificationApp* notification) {
             if(game_state->animation.indexes[0] == 13 && game_state->animation.indexes[1] == 13 &&
                game_state->animation.indexes[2] == 13 && game_state->animation.indexes[3] == 13) {
                 init(game_state);
+                game_state->deal = random_deal();
                 game_state->state = GameStateStart;
                 return;
             }
@@ -420,8 +661,10 @@ void init(GameState* game_state) {
     game_state->selectColumn = 0;
     game_state->selected_card = 0;
     game_state->selectRow = 0;
+    stop_assist(game_state);
+    game_state->undo_count = 0;
     generate_deck(&(game_state->deck), 1);
-    shuffle_deck(&(game_state->deck));
+    shuffle_deck(&(game_state->deck), game_state->deal);
     game_state->dragging_deck = false;
     game_state->animation.started = false;
     game_state->animation.deck = -1;
@@ -453,6 +696,14 @@ void init_start(GameState* game_state) {
 
     init_hand(&(game_state->dragging_hand), 13);
     game_state->animation.buffer = make_buffer();
+
+    game_state->deal = random_deal();
+    game_state->undo = malloc(sizeof(Board) * UNDO_DEPTH);
+    game_state->undo_start = 0;
+    game_state->undo_count = 0;
+    game_state->solver = solver_alloc();
+    game_state->assist = AssistNone;
+    game_state->hint_row = -1;
 }
 
 static void input_callback(InputEvent* input_event, FuriMessageQueue* event_queue) {
@@ -511,11 +762,18 @@ int32_t solitaire_app(void* p) {
                     switch(event.input.key) {
                     case InputKeyUp:
                     case InputKeyDown:
-                    case InputKeyRight:
-                    case InputKeyLeft:
                     case InputKeyOk:
                         game_state->input = event.input.key;
                         break;
+                    case InputKeyRight:
+                    case InputKeyLeft:
+                        if(game_state->state == GameStatePlay &&
+                           !start_assist(
+                               game_state,
+                               event.input.key == InputKeyRight ? AssistHint : AssistAutoSolve)) {
+                            notification_message(notification, &sequence_fail);
+                        }
+                        break;
                     case InputKeyBack:
                         processing = false;
                         return_code = 1;
@@ -533,18 +791,22 @@ int32_t solitaire_app(void* p) {
                         if(event.input.key == InputKeyOk && game_state->state == GameStateStart) {
                             game_state->state = GameStatePlay;
                             init(game_state);
+                        } else if(game_state->state == GameStateStart) {
+                            select_deal(game_state, event.input.key);
                         } else {
                             game_state->input = event.input.key;
                         }
                         break;
-                    case InputKeyBack:
-                        init(game_state);
-                        processing = false;
-                        return_code = 1;
-                        break;
                     default:
                         break;
                     }
+                } else if(event.input.type == InputTypeShort && event.input.key == InputKeyBack) {
+                    if(game_state->state == GameStatePlay) {
+                        if(!undo(game_state)) notification_message(notification, &sequence_fail);
+                    } else {
+                        processing = false;
+                        return_code = 1;
+                    }
                 }
             } else if(event.type == EventTypeTick) {
                 tick(game_state, notification);
@@ -567,6 +829,8 @@ int32_t solitaire_app(void* p) {
     furi_mutex_free(game_state->mutex);
 
 free_and_exit:
+    solver_free(game_state->solver);
+    free(game_state->undo);
     free(game_state->animation.buffer);
     ui_cleanup();
     for(uint8_t i = 0; i < 7; i++) free_hand(&(game_state->bottom_columns[i]));
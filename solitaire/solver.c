@@ -0,0 +1,426 @@
+#include "solver.h"
+#include <string.h>
+
+#define SUIT(card) ((card) / 13)
+#define RANK(card) ((card) % 13)
+#define IS_RED(card) (SUIT(card) == 1 || SUIT(card) == 2)
+#define RANK_KING 12
+
+// Candidate moves of a position are numbered: the 8 moves to the foundations (from every
+// column, then from the waste) come first, then column to column, waste to column and
+// finally turning the next stock card
+#define SLOT_COLUMN_TO_COLUMN 8
+#define SLOT_WASTE_TO_COLUMN (SLOT_COLUMN_TO_COLUMN + BOARD_COLUMNS * BOARD_COLUMNS)
+#define SLOT_DRAW (SLOT_WASTE_TO_COLUMN + BOARD_COLUMNS)
+#define SLOT_COUNT (SLOT_DRAW + 1)
+
+// Bounds the search: it stops once this many distinct positions have been seen
+#define SOLVER_TABLE_SIZE 8192
+#define SOLVER_STATE_BUDGET (SOLVER_TABLE_SIZE * 3 / 4)
+
+typedef struct {
+    uint8_t slot; // next candidate move to try
+    SolverMove move; // the move that leads to the next frame
+} SolverFrame;
+
+typedef struct {
+    Board board;
+    SolverFrame frames[SOLVER_MAX_MOVES + 1];
+    uint32_t table[SOLVER_TABLE_SIZE];
+    uint16_t visited;
+    int16_t best_score;
+} SolverSearch;
+
+struct Solver {
+    FuriThread* thread;
+    Board root;
+    volatile bool stop;
+    volatile bool done;
+    bool solved;
+    uint16_t move_count;
+    SolverMove moves[SOLVER_MAX_MOVES];
+};
+
+static uint8_t column_top(const Board* board, uint8_t column) {
+    uint8_t count = board->column_count[column];
+    return count ? board->columns[column][count - 1] : BOARD_NO_CARD;
+}
+
+// Card a move from the column or the waste would take, BOARD_NO_CARD if there is none
+static uint8_t source_card(const Board* board, uint8_t from) {
+    if(from != BOARD_WASTE) return column_top(board, from);
+    return board->waste >= 0 ? board->stock[board->waste] : BOARD_NO_CARD;
+}
+
+// Foundation pile the card can go to, -1 if none
+static int8_t foundation_for(const Board* board, uint8_t card) {
+    for(uint8_t i = 0; i < BOARD_FOUNDATIONS; i++) {
+        uint8_t top = board->foundations[i];
+        if(RANK(card) == 0 ? top == BOARD_NO_CARD : top == card - 1) return i;
+    }
+    return -1;
+}
+
+// A card may go to the foundation for good once both opposite coloured cards of the rank
+// below are there: nothing could be placed on it in the columns any more
+static bool is_safe_to_foundation(const Board* board, uint8_t card) {
+    if(RANK(card) <= 1) return true;
+
+    int8_t lowest = RANK_KING;
+    for(uint8_t suit = 0; suit < 4; suit++) {
+        if(IS_RED(suit * 13) == IS_RED(card)) continue;
+        int8_t rank = -1;
+        for(uint8_t i = 0; i < BOARD_FOUNDATIONS; i++) {
+            uint8_t top = board->foundations[i];
+            if(top != BOARD_NO_CARD && SUIT(top) == suit) rank = RANK(top);
+        }
+        if(rank < lowest) lowest = rank;
+    }
+    return lowest >= RANK(card) - 1;
+}
+
+static bool fits_column(uint8_t top, uint8_t card) {
+    if(top == BOARD_NO_CARD) return RANK(card) == RANK_KING;
+    if(top & BOARD_FACE_DOWN) return false;
+    return IS_RED(top) != IS_RED(card) && RANK(top) == RANK(card) + 1;
+}
+
+static uint8_t first_face_up(const Board* board, uint8_t column) {
+    uint8_t i = 0;
+    while(i < board->column_count[column] && (board->columns[column][i] & BOARD_FACE_DOWN)) i++;
+    return i;
+}
+
+static uint8_t take_from_waste(Board* board) {
+    uint8_t card = board->stock[board->waste];
+    memmove(
+        &board->stock[board->waste],
+        &board->stock[board->waste + 1],
+        board->stock_count - board->waste - 1);
+    board->stock_count--;
+    board->waste--;
+    return card;
+}
+
+static void return_to_waste(Board* board, uint8_t card) {
+    board->waste++;
+    memmove(
+        &board->stock[board->waste + 1],
+        &board->stock[board->waste],
+        board->stock_count - board->waste);
+    board->stock[board->waste] = card;
+    board->stock_count++;
+}
+
+static void flip_column_top(Board* board, uint8_t column, SolverMove* move) {
+    uint8_t count = board->column_count[column];
+    move->flipped = count && (board->columns[column][count - 1] & BOARD_FACE_DOWN);
+    if(move->flipped) board->columns[column][count - 1] &= ~BOARD_FACE_DOWN;
+}
+
+void board_turn_top_cards(Board* board) {
+    for(uint8_t i = 0; i < BOARD_COLUMNS; i++) {
+        uint8_t count = board->column_count[i];
+        if(count) board->columns[i][count - 1] &= ~BOARD_FACE_DOWN;
+    }
+}
+
+void solver_apply_move(Board* board, SolverMove* move) {
+    move->flipped = false;
+    switch(move->type) {
+    case SolverMoveDraw:
+        board->waste = board->waste + 1 >= board->stock_count ? -1 : board->waste + 1;
+        break;
+    case SolverMoveToFoundation:
+        if(move->from == BOARD_WASTE) {
+            board->foundations[move->to] = take_from_waste(board);
+        } else {
+            board->foundations[move->to] =
+                board->columns[move->from][--board->column_count[move->from]];
+            flip_column_top(board, move->from, move);
+        }
+        break;
+    case SolverMoveToColumn:
+        if(move->from == BOARD_WASTE) {
+            board->columns[move->to][board->column_count[move->to]++] = take_from_waste(board);
+        } else {
+            board->column_count[move->from] -= move->count;
+            memcpy(
+                &board->columns[move->to][board->column_count[move->to]],
+                &board->columns[move->from][board->column_count[move->from]],
+                move->count);
+            board->column_count[move->to] += move->count;
+            flip_column_top(board, move->from, move);
+        }
+        break;
+    }
+}
+
+static void undo_move(Board* board, const SolverMove* move) {
+    if(move->flipped) {
+        board->columns[move->from][board->column_count[move->from] - 1] |= BOARD_FACE_DOWN;
+    }
+    switch(move->type) {
+    case SolverMoveDraw:
+        board->waste = board->waste < 0 ? board->stock_count - 1 : board->waste - 1;
+        break;
+    case SolverMoveToFoundation: {
+        uint8_t card = board->foundations[move->to];
+        board->foundations[move->to] = RANK(card) == 0 ? BOARD_NO_CARD : card - 1;
+        if(move->from == BOARD_WASTE) {
+            return_to_waste(board, card);
+        } else {
+            board->columns[move->from][board->column_count[move->from]++] = card;
+        }
+        break;
+    }
+    case SolverMoveToColumn:
+        if(move->from == BOARD_WASTE) {
+            return_to_waste(board, board->columns[move->to][--board->column_count[move->to]]);
+        } else {
+            board->column_count[move->to] -= move->count;
+            memcpy(
+                &board->columns[move->from][board->column_count[move->from]],
+                &board->columns[move->to][board->column_count[move->to]],
+                move->count);
+            board->column_count[move->from] += move->count;
+        }
+        break;
+    }
+}
+
+// Builds the candidate move numbered `slot`, false if it is not legal or not worth trying
+static bool generate_move(const Board* board, uint8_t slot, SolverMove* move) {
+    if(slot < SLOT_COLUMN_TO_COLUMN) {
+        uint8_t card = source_card(board, slot);
+        if(card == BOARD_NO_CARD || (card & BOARD_FACE_DOWN)) return false;
+        int8_t foundation = foundation_for(board, card);
+        if(foundation < 0) return false;
+        *move = (SolverMove){SolverMoveToFoundation, slot, foundation, 1, false};
+        return true;
+    }
+
+    if(slot < SLOT_WASTE_TO_COLUMN) {
+        uint8_t from = (slot - SLOT_COLUMN_TO_COLUMN) / BOARD_COLUMNS;
+        uint8_t to = (slot - SLOT_COLUMN_TO_COLUMN) % BOARD_COLUMNS;
+        uint8_t count = board->column_count[from];
+        uint8_t first = first_face_up(board, from);
+        if(from == to || first >= count) return false;
+
+        uint8_t top = column_top(board, to);
+        uint8_t index;
+        if(top == BOARD_NO_CARD) {
+            // a king already at the bottom of its column gains nothing by moving
+            if(first == 0) return false;
+            index = first;
+        } else {
+            // the ranks fall by one down the run, so only one card can fit
+            int8_t offset = RANK(board->columns[from][first]) - (RANK(top) - 1);
+            if(offset < 0 || first + offset >= count) return false;
+            index = first + offset;
+        }
+        if(!fits_column(top, board->columns[from][index])) return false;
+        // splitting a run only helps if the card left behind can go to the foundation
+        if(index > first && foundation_for(board, board->columns[from][index - 1]) < 0) {
+            return false;
+        }
+        if(board->column_count[to] + count - index > BOARD_COLUMN_MAX) return false;
+
+        *move = (SolverMove){SolverMoveToColumn, from, to, count - index, false};
+        return true;
+    }
+
+    if(slot < SLOT_DRAW) {
+        uint8_t to = slot - SLOT_WASTE_TO_COLUMN;
+        if(board->waste < 0 || board->column_count[to] >= BOARD_COLUMN_MAX) return false;
+        if(!fits_column(column_top(board, to), board->stock[board->waste])) return false;
+        *move = (SolverMove){SolverMoveToColumn, BOARD_WASTE, to, 1, false};
+        return true;
+    }
+
+    if(board->stock_count == 0) return false;
+    *move = (SolverMove){SolverMoveDraw, BOARD_WASTE, 0, 0, false};
+    return true;
+}
+
+static uint32_t hash_bytes(uint32_t hash, const uint8_t* data, uint8_t length) {
+    for(uint8_t i = 0; i < length; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t mix(uint32_t hash) {
+    hash ^= hash >> 16;
+    hash *= 0x7feb352du;
+    hash ^= hash >> 15;
+    return hash;
+}
+
+// The order of the columns and of the foundation piles does not matter, positions that
+// only differ in it hash the same
+static uint32_t hash_board(const Board* board) {
+    uint32_t hash = 0;
+    for(uint8_t i = 0; i < BOARD_COLUMNS; i++) {
+        hash += mix(hash_bytes(2166136261u, board->columns[i], board->column_count[i]));
+    }
+
+    uint8_t suits[4] = {0};
+    for(uint8_t i = 0; i < BOARD_FOUNDATIONS; i++) {
+        uint8_t top = board->foundations[i];
+        if(top != BOARD_NO_CARD) suits[SUIT(top)] = RANK(top) + 1;
+    }
+    hash = hash_bytes(hash, suits, sizeof(suits));
+    hash = hash_bytes(hash, board->stock, board->stock_count);
+    return mix(hash_bytes(hash, (const uint8_t*)&board->waste, 1));
+}
+
+// Remembers the position, false if it has been seen before
+static bool visit(SolverSearch* search) {
+    uint32_t hash = hash_board(&search->board);
+    if(hash == 0) hash = 1;
+
+    uint32_t index = hash & (SOLVER_TABLE_SIZE - 1);
+    while(search->table[index] != 0) {
+        if(search->table[index] == hash) return false;
+        index = (index + 1) & (SOLVER_TABLE_SIZE - 1);
+    }
+    search->table[index] = hash;
+    search->visited++;
+    return true;
+}
+
+static int16_t progress(const Board* board) {
+    int16_t score = 0;
+    for(uint8_t i = 0; i < BOARD_FOUNDATIONS; i++) {
+        if(board->foundations[i] != BOARD_NO_CARD) score += 2 * (RANK(board->foundations[i]) + 1);
+    }
+    for(uint8_t i = 0; i < BOARD_COLUMNS; i++) {
+        score -= first_face_up(board, i);
+    }
+    return score;
+}
+
+static void keep_line(Solver* solver, const SolverSearch* search, uint16_t depth) {
+    for(uint16_t i = 0; i < depth; i++) {
+        solver->moves[i] = search->frames[i].move;
+    }
+    solver->move_count = depth;
+}
+
+// Depth first search over the positions, moves are made and taken back on a single board
+// so the memory use only depends on the depth limit
+static void solver_search(Solver* solver, SolverSearch* search) {
+    Board* board = &search->board;
+    uint16_t depth = 0;
+
+    search->frames[0].slot = 0;
+    search->best_score = progress(board);
+    visit(search);
+
+    while(!solver->stop && search->visited < SOLVER_STATE_BUDGET) {
+        int16_t score = progress(board);
+        if(score > search->best_score) {
+            search->best_score = score;
+            keep_line(solver, search, depth);
+        }
+        if(score == 2 * 52) {
+            solver->solved = true;
+            break;
+        }
+
+        SolverFrame* frame = &search->frames[depth];
+        bool advanced = false;
+        while(depth < SOLVER_MAX_MOVES && frame->slot < SLOT_COUNT) {
+            uint8_t slot = frame->slot++;
+            if(!generate_move(board, slot, &frame->move)) continue;
+
+            if(frame->move.type == SolverMoveToFoundation &&
+               is_safe_to_foundation(board, source_card(board, slot))) {
+                // nothing else can be better here
+                frame->slot = SLOT_COUNT;
+            }
+
+            solver_apply_move(board, &frame->move);
+            if(visit(search)) {
+                advanced = true;
+                break;
+            }
+            undo_move(board, &frame->move);
+        }
+
+        if(advanced) {
+            depth++;
+            search->frames[depth].slot = 0;
+        } else {
+            if(depth == 0) break;
+            depth--;
+            undo_move(board, &search->frames[depth].move);
+        }
+    }
+}
+
+static int32_t solver_thread(void* context) {
+    Solver* solver = context;
+    SolverSearch* search = malloc(sizeof(SolverSearch));
+    memset(search->table, 0, sizeof(search->table));
+    search->visited = 0;
+    search->board = solver->root;
+
+    // the player has to turn the top cards by hand, the search takes them as turned
+    board_turn_top_cards(&search->board);
+
+    solver_search(solver, search);
+
+    free(search);
+    solver->done = true;
+    return 0;
+}
+
+Solver* solver_alloc(void) {
+    Solver* solver = malloc(sizeof(Solver));
+    solver->thread = furi_thread_alloc_ex("SolitaireSolver", 1024, solver_thread, solver);
+    // keep the game responsive while searching
+    furi_thread_set_priority(solver->thread, FuriThreadPriorityLow);
+    solver->stop = false;
+    solver->done = false;
+    solver->solved = false;
+    solver->move_count = 0;
+    return solver;
+}
+
+void solver_free(Solver* solver) {
+    solver_stop(solver);
+    furi_thread_free(solver->thread);
+    free(solver);
+}
+
+void solver_start(Solver* solver, const Board* board) {
+    solver_stop(solver);
+    solver->root = *board;
+    solver->stop = false;
+    solver->done = false;
+    solver->solved = false;
+    solver->move_count = 0;
+    furi_thread_start(solver->thread);
+}
+
+void solver_stop(Solver* solver) {
+    if(furi_thread_get_state(solver->thread) != FuriThreadStateStopped) {
+        solver->stop = true;
+        furi_thread_join(solver->thread);
+    }
+}
+
+bool solver_is_done(const Solver* solver) {
+    return solver->done;
+}
+
+bool solver_is_solved(const Solver* solver) {
+    return solver->solved;
+}
+
+uint16_t solver_get_moves(const Solver* solver, const SolverMove** moves) {
+    *moves = solver->moves;
+    return solver->move_count;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <furi.h>
+
+#define BOARD_COLUMNS 7
+#define BOARD_COLUMN_MAX 21
+#define BOARD_STOCK_MAX 24
+#define BOARD_FOUNDATIONS 4
+// card codes are suit * 13 + rank, rank 0 is the ace and 12 the king
+#define BOARD_FACE_DOWN 0x80
+#define BOARD_NO_CARD 0xff
+#define BOARD_WASTE 7
+
+#define SOLVER_MAX_MOVES 200
+
+// Compact copy of the table, used for the undo history and by the solver
+typedef struct {
+    uint8_t columns[BOARD_COLUMNS][BOARD_COLUMN_MAX];
+    uint8_t column_count[BOARD_COLUMNS];
+    uint8_t stock[BOARD_STOCK_MAX]; // the deck, the waste pile is stock[0..waste]
+    uint8_t stock_count;
+    int8_t waste; // index of the visible waste card, -1 if none is turned
+    uint8_t foundations[BOARD_FOUNDATIONS]; // top card of every pile or BOARD_NO_CARD
+} Board;
+
+typedef enum {
+    SolverMoveDraw,
+    SolverMoveToFoundation,
+    SolverMoveToColumn,
+} SolverMoveType;
+
+typedef struct {
+    uint8_t type;
+    uint8_t from; // column index or BOARD_WASTE
+    uint8_t to; // column or foundation index
+    uint8_t count; // cards moved between columns
+    uint8_t flipped; // the move turned up a face down card, used to take it back
+} SolverMove;
+
+typedef struct Solver Solver;
+
+// Turns up the face down cards lying on top of the columns
+void board_turn_top_cards(Board* board);
+
+// Applies a move produced by the solver, face down cards it uncovers are turned up
+void solver_apply_move(Board* board, SolverMove* move);
+
+Solver* solver_alloc(void);
+void solver_free(Solver* solver);
+
+// Starts searching for a solution of `board` in a background thread, a running search is
+// cancelled first. The search gives up after a fixed number of positions.
+void solver_start(Solver* solver, const Board* board);
+void solver_stop(Solver* solver);
+bool solver_is_done(const Solver* solver);
+
+// Valid once the search is done: either the winning line or, when the budget ran out
+// first, the line that got the most cards to the foundations
+bool solver_is_solved(const Solver* solver);
+uint16_t solver_get_moves(const Solver* solver, const SolverMove** moves);
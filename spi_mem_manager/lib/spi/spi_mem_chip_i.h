@@ -48,11 +48,13 @@ typedef enum {
     SPIMemChipCMDReadJEDECChipID = 0x9F,
     SPIMemChipCMDReadData = 0x03,
     SPIMemChipCMDChipErase = 0xC7,
+    SPIMemChipCMDSectorErase = 0x20,
     SPIMemChipCMDWriteEnable = 0x06,
     SPIMemChipCMDWriteDisable = 0x04,
     SPIMemChipCMDReadStatus = 0x05,
     SPIMemChipCMDWriteData = 0x02,
-    SPIMemChipCMDReleasePowerDown = 0xAB
+    SPIMemChipCMDReleasePowerDown = 0xAB,
+    SPIMemChipCMDEnter4ByteAddress = 0xB7
 } SPIMemChipCMD;
 
 enum SPIMemChipStatusBit {
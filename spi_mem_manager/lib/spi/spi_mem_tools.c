@@ -3,8 +3,14 @@
 #include "spi_mem_chip_i.h"
 #include "spi_mem_tools.h"
 
-static uint8_t spi_mem_tools_addr_to_byte_arr(uint32_t addr, uint8_t* cmd) {
-    uint8_t len = 3; // TODO(add support of 4 bytes address mode)
+// Chips above 16 MB are switched to 4 byte addresses, see spi_mem_tools_set_address_mode()
+static uint8_t spi_mem_tools_get_address_size(SPIMemChip* chip) {
+    if(chip->size > SPI_MEM_3BYTE_ADDRESS_LIMIT) return 4;
+    return 3;
+}
+
+static uint8_t spi_mem_tools_addr_to_byte_arr(SPIMemChip* chip, uint32_t addr, uint8_t* cmd) {
+    uint8_t len = spi_mem_tools_get_address_size(chip);
     for(uint8_t i = 0; i < len; i++) {
         cmd[i] = (addr >> ((len - (i + 1)) * 8)) & 0xFF;
     }
@@ -39,11 +45,12 @@ static bool spi_mem_tools_trx(
     return success;
 }
 
-static bool spi_mem_tools_write_buffer(uint8_t* data, size_t size, size_t offset) {
+static bool
+    spi_mem_tools_write_buffer(SPIMemChip* chip, uint8_t* data, size_t size, size_t offset) {
     furi_hal_spi_acquire(&furi_hal_spi_bus_handle_external);
     uint8_t cmd = (uint8_t)SPIMemChipCMDWriteData;
     uint8_t address[4];
-    uint8_t address_size = spi_mem_tools_addr_to_byte_arr(offset, address);
+    uint8_t address_size = spi_mem_tools_addr_to_byte_arr(chip, offset, address);
     bool success = false;
     do {
         if(!furi_hal_spi_bus_tx(&furi_hal_spi_bus_handle_external, &cmd, 1, SPI_MEM_SPI_TIMEOUT))
@@ -84,15 +91,28 @@ bool spi_mem_tools_check_chip_info(SPIMemChip* chip) {
     return false;
 }
 
-bool spi_mem_tools_read_block(SPIMemChip* chip, size_t offset, uint8_t* data, size_t block_size) {
+// EN4B is volatile (lost on power cycle) and supported by every chip in the database
+// above 16 MB. Micron parts only accept it after a write enable, the others ignore that
+static bool spi_mem_tools_set_address_mode(SPIMemChip* chip) {
+    if(spi_mem_tools_get_address_size(chip) == 3) return true;
+    if(!spi_mem_tools_trx(SPIMemChipCMDWriteEnable, NULL, 0, NULL, 0)) return false;
+    return spi_mem_tools_trx(SPIMemChipCMDEnter4ByteAddress, NULL, 0, NULL, 0);
+}
+
+static bool spi_mem_tools_prepare_chip(SPIMemChip* chip) {
     if(!spi_mem_tools_check_chip_info(chip)) return false;
+    return spi_mem_tools_set_address_mode(chip);
+}
+
+bool spi_mem_tools_read_block(SPIMemChip* chip, size_t offset, uint8_t* data, size_t block_size) {
+    if(!spi_mem_tools_prepare_chip(chip)) return false;
     for(size_t i = 0; i < block_size; i += SPI_MEM_MAX_BLOCK_SIZE) {
         uint8_t cmd[4];
         if((offset + SPI_MEM_MAX_BLOCK_SIZE) > chip->size) return false;
         if(!spi_mem_tools_trx(
                SPIMemChipCMDReadData,
                cmd,
-               spi_mem_tools_addr_to_byte_arr(offset, cmd),
+               spi_mem_tools_addr_to_byte_arr(chip, offset, cmd),
                data,
                SPI_MEM_MAX_BLOCK_SIZE))
             return false;
@@ -102,6 +122,28 @@ bool spi_mem_tools_read_block(SPIMemChip* chip, size_t offset, uint8_t* data, si
     return true;
 }
 
+bool spi_mem_tools_read_stream_start(SPIMemChip* chip, size_t offset) {
+    if(!spi_mem_tools_prepare_chip(chip)) return false;
+    if(offset >= chip->size) return false;
+    uint8_t cmd[5] = {(uint8_t)SPIMemChipCMDReadData};
+    uint8_t cmd_size = 1 + spi_mem_tools_addr_to_byte_arr(chip, offset, &cmd[1]);
+    furi_hal_spi_acquire(&furi_hal_spi_bus_handle_external);
+    if(!furi_hal_spi_bus_tx(
+           &furi_hal_spi_bus_handle_external, cmd, cmd_size, SPI_MEM_SPI_TIMEOUT)) {
+        furi_hal_spi_release(&furi_hal_spi_bus_handle_external);
+        return false;
+    }
+    return true;
+}
+
+bool spi_mem_tools_read_stream(uint8_t* data, size_t size) {
+    return furi_hal_spi_bus_rx(&furi_hal_spi_bus_handle_external, data, size, SPI_MEM_SPI_TIMEOUT);
+}
+
+void spi_mem_tools_read_stream_stop() {
+    furi_hal_spi_release(&furi_hal_spi_bus_handle_external);
+}
+
 size_t spi_mem_tools_get_file_max_block_size(SPIMemChip* chip) {
     UNUSED(chip);
     return (SPI_MEM_FILE_BUFFER_SIZE);
@@ -140,13 +182,58 @@ bool spi_mem_tools_erase_chip(SPIMemChip* chip) {
     return true;
 }
 
+bool spi_mem_tools_erase_sector(SPIMemChip* chip, size_t offset) {
+    uint8_t cmd[4];
+    do {
+        if(!spi_mem_tools_prepare_chip(chip)) break;
+        if((offset % SPI_MEM_SECTOR_SIZE) || offset >= chip->size) break;
+        if(!spi_mem_tools_set_write_enabled(chip, true)) break;
+        if(!spi_mem_tools_trx(
+               SPIMemChipCMDSectorErase,
+               cmd,
+               spi_mem_tools_addr_to_byte_arr(chip, offset, cmd),
+               NULL,
+               0))
+            break;
+        return true;
+    } while(0);
+    return false;
+}
+
 bool spi_mem_tools_write_bytes(SPIMemChip* chip, size_t offset, uint8_t* data, size_t block_size) {
     do {
-        if(!spi_mem_tools_check_chip_info(chip)) break;
+        if(!spi_mem_tools_prepare_chip(chip)) break;
         if(!spi_mem_tools_set_write_enabled(chip, true)) break;
         if((offset + block_size) > chip->size) break;
-        if(!spi_mem_tools_write_buffer(data, block_size, offset)) break;
+        if(!spi_mem_tools_write_buffer(chip, data, block_size, offset)) break;
         return true;
     } while(0);
     return false;
 }
+
+uint32_t spi_mem_tools_crc32(uint32_t crc, const uint8_t* data, size_t size) {
+    // half byte table, 64 bytes of flash instead of 1 KB and still far faster than SPI
+    static const uint32_t crc32_table[16] = {
+        0x00000000,
+        0x1DB71064,
+        0x3B6E20C8,
+        0x26D930AC,
+        0x76DC4190,
+        0x6B6B51F4,
+        0x4DB26158,
+        0x5005713C,
+        0xEDB88320,
+        0xF00F9344,
+        0xD6D6A3E8,
+        0xCB61B38C,
+        0x9B64C2B0,
+        0x86D3D2D4,
+        0xA00AE278,
+        0xBDBDF21C};
+    crc = ~crc;
+    for(size_t i = 0; i < size; i++) {
+        crc = crc32_table[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+        crc = crc32_table[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+    }
+    return ~crc;
+}
@@ -5,10 +5,21 @@
 #define SPI_MEM_SPI_TIMEOUT 1000
 #define SPI_MEM_MAX_BLOCK_SIZE 256
 #define SPI_MEM_FILE_BUFFER_SIZE 4096
+#define SPI_MEM_SECTOR_SIZE 4096
+#define SPI_MEM_3BYTE_ADDRESS_LIMIT (16 * 1024 * 1024)
 
 bool spi_mem_tools_read_chip_info(SPIMemChip* chip);
 bool spi_mem_tools_read_block(SPIMemChip* chip, size_t offset, uint8_t* data, size_t block_size);
+// Streaming read: one READ command stays open (bus held, CS low) from start to stop,
+// every spi_mem_tools_read_stream() continues where the previous one ended
+bool spi_mem_tools_read_stream_start(SPIMemChip* chip, size_t offset);
+bool spi_mem_tools_read_stream(uint8_t* data, size_t size);
+void spi_mem_tools_read_stream_stop();
 size_t spi_mem_tools_get_file_max_block_size(SPIMemChip* chip);
 SPIMemChipStatus spi_mem_tools_get_chip_status(SPIMemChip* chip);
 bool spi_mem_tools_erase_chip(SPIMemChip* chip);
+// Erase the SPI_MEM_SECTOR_SIZE sector at offset, which must be sector aligned
+bool spi_mem_tools_erase_sector(SPIMemChip* chip, size_t offset);
 bool spi_mem_tools_write_bytes(SPIMemChip* chip, size_t offset, uint8_t* data, size_t block_size);
+// CRC-32 (IEEE, same as zlib crc32()), start with crc = 0 and feed the data in any chunks
+uint32_t spi_mem_tools_crc32(uint32_t crc, const uint8_t* data, size_t size);
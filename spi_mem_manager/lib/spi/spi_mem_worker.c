@@ -7,9 +7,11 @@ typedef enum {
     SPIMemEventVerify = (1 << 3),
     SPIMemEventErase = (1 << 4),
     SPIMemEventWrite = (1 << 5),
+    SPIMemEventSmartWrite = (1 << 6),
+    SPIMemEventVerifyCrc = (1 << 7),
     SPIMemEventAll =
         (SPIMemEventStopThread | SPIMemEventChipDetect | SPIMemEventRead | SPIMemEventVerify |
-         SPIMemEventErase | SPIMemEventWrite)
+         SPIMemEventErase | SPIMemEventWrite | SPIMemEventSmartWrite | SPIMemEventVerifyCrc)
 } SPIMemEventEventType;
 
 static int32_t spi_mem_worker_thread(void* thread_context);
@@ -46,8 +48,10 @@ static int32_t spi_mem_worker_thread(void* thread_context) {
             if(flags & SPIMemEventChipDetect) worker->mode_index = SPIMemWorkerModeChipDetect;
             if(flags & SPIMemEventRead) worker->mode_index = SPIMemWorkerModeRead;
             if(flags & SPIMemEventVerify) worker->mode_index = SPIMemWorkerModeVerify;
+            if(flags & SPIMemEventVerifyCrc) worker->mode_index = SPIMemWorkerModeVerifyCrc;
             if(flags & SPIMemEventErase) worker->mode_index = SPIMemWorkerModeErase;
             if(flags & SPIMemEventWrite) worker->mode_index = SPIMemWorkerModeWrite;
+            if(flags & SPIMemEventSmartWrite) worker->mode_index = SPIMemWorkerModeSmartWrite;
             if(spi_mem_worker_modes[worker->mode_index].process) {
                 spi_mem_worker_modes[worker->mode_index].process(worker);
             }
@@ -104,6 +108,18 @@ void spi_mem_worker_verify_start(
     furi_thread_flags_set(furi_thread_get_id(worker->thread), SPIMemEventVerify);
 }
 
+void spi_mem_worker_verify_crc_start(
+    SPIMemChip* chip_info,
+    SPIMemWorker* worker,
+    SPIMemWorkerCallback callback,
+    void* context) {
+    furi_check(worker->mode_index == SPIMemWorkerModeIdle);
+    worker->callback = callback;
+    worker->cb_ctx = context;
+    worker->chip_info = chip_info;
+    furi_thread_flags_set(furi_thread_get_id(worker->thread), SPIMemEventVerifyCrc);
+}
+
 void spi_mem_worker_erase_start(
     SPIMemChip* chip_info,
     SPIMemWorker* worker,
@@ -127,3 +143,15 @@ void spi_mem_worker_write_start(
     worker->chip_info = chip_info;
     furi_thread_flags_set(furi_thread_get_id(worker->thread), SPIMemEventWrite);
 }
+
+void spi_mem_worker_smart_write_start(
+    SPIMemChip* chip_info,
+    SPIMemWorker* worker,
+    SPIMemWorkerCallback callback,
+    void* context) {
+    furi_check(worker->mode_index == SPIMemWorkerModeIdle);
+    worker->callback = callback;
+    worker->cb_ctx = context;
+    worker->chip_info = chip_info;
+    furi_thread_flags_set(furi_thread_get_id(worker->thread), SPIMemEventSmartWrite);
+}
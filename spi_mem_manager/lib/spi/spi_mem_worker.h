@@ -42,6 +42,11 @@ void spi_mem_worker_verify_start(
     SPIMemWorker* worker,
     SPIMemWorkerCallback callback,
     void* context);
+void spi_mem_worker_verify_crc_start(
+    SPIMemChip* chip_info,
+    SPIMemWorker* worker,
+    SPIMemWorkerCallback callback,
+    void* context);
 void spi_mem_worker_erase_start(
     SPIMemChip* chip_info,
     SPIMemWorker* worker,
@@ -52,3 +57,8 @@ void spi_mem_worker_write_start(
     SPIMemWorker* worker,
     SPIMemWorkerCallback callback,
     void* context);
+void spi_mem_worker_smart_write_start(
+    SPIMemChip* chip_info,
+    SPIMemWorker* worker,
+    SPIMemWorkerCallback callback,
+    void* context);
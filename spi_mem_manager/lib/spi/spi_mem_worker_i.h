@@ -7,8 +7,10 @@ typedef enum {
     SPIMemWorkerModeChipDetect,
     SPIMemWorkerModeRead,
     SPIMemWorkerModeVerify,
+    SPIMemWorkerModeVerifyCrc,
     SPIMemWorkerModeErase,
-    SPIMemWorkerModeWrite
+    SPIMemWorkerModeWrite,
+    SPIMemWorkerModeSmartWrite
 } SPIMemWorkerMode;
 
 struct SPIMemWorker {
@@ -6,16 +6,20 @@
 static void spi_mem_worker_chip_detect_process(SPIMemWorker* worker);
 static void spi_mem_worker_read_process(SPIMemWorker* worker);
 static void spi_mem_worker_verify_process(SPIMemWorker* worker);
+static void spi_mem_worker_verify_crc_process(SPIMemWorker* worker);
 static void spi_mem_worker_erase_process(SPIMemWorker* worker);
 static void spi_mem_worker_write_process(SPIMemWorker* worker);
+static void spi_mem_worker_smart_write_process(SPIMemWorker* worker);
 
 const SPIMemWorkerModeType spi_mem_worker_modes[] = {
     [SPIMemWorkerModeIdle] = {.process = NULL},
     [SPIMemWorkerModeChipDetect] = {.process = spi_mem_worker_chip_detect_process},
     [SPIMemWorkerModeRead] = {.process = spi_mem_worker_read_process},
     [SPIMemWorkerModeVerify] = {.process = spi_mem_worker_verify_process},
+    [SPIMemWorkerModeVerifyCrc] = {.process = spi_mem_worker_verify_crc_process},
     [SPIMemWorkerModeErase] = {.process = spi_mem_worker_erase_process},
-    [SPIMemWorkerModeWrite] = {.process = spi_mem_worker_write_process}};
+    [SPIMemWorkerModeWrite] = {.process = spi_mem_worker_write_process},
+    [SPIMemWorkerModeSmartWrite] = {.process = spi_mem_worker_smart_write_process}};
 
 static void spi_mem_worker_run_callback(SPIMemWorker* worker, SPIMemCustomEventWorker event) {
     if(worker->callback) {
@@ -42,6 +46,117 @@ static size_t spi_mem_worker_modes_get_total_size(SPIMemWorker* worker) {
     return total_size;
 }
 
+// File pipe: a second thread does the SD side of read, verify and write
+// through two blocks, so file I/O of one block overlaps SPI of the next
+#define SPI_MEM_WORKER_PIPE_BLOCKS 2
+#define SPI_MEM_WORKER_PIPE_TIMEOUT 100
+
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    bool success;
+} SPIMemWorkerBlock;
+
+typedef struct {
+    SPIMemWorker* worker;
+    FuriThread* thread;
+    FuriMessageQueue* free_blocks;
+    FuriMessageQueue* filled_blocks;
+    SPIMemWorkerBlock blocks[SPI_MEM_WORKER_PIPE_BLOCKS];
+    // true: chip blocks are written to file, false: file blocks are read ahead
+    bool to_file;
+    size_t total_size;
+    volatile bool stop;
+} SPIMemWorkerPipe;
+
+static int32_t spi_mem_worker_pipe_thread(void* context) {
+    SPIMemWorkerPipe* pipe = context;
+    size_t offset = 0;
+    SPIMemWorkerBlock* block;
+    while(!pipe->stop) {
+        if(pipe->to_file) {
+            if(furi_message_queue_get(
+                   pipe->filled_blocks, &block, SPI_MEM_WORKER_PIPE_TIMEOUT) != FuriStatusOk)
+                continue;
+            block->success =
+                spi_mem_file_write_block(pipe->worker->cb_ctx, block->data, block->size);
+            furi_message_queue_put(pipe->free_blocks, &block, FuriWaitForever);
+        } else {
+            if(offset >= pipe->total_size) break;
+            if(furi_message_queue_get(
+                   pipe->free_blocks, &block, SPI_MEM_WORKER_PIPE_TIMEOUT) != FuriStatusOk)
+                continue;
+            block->size = MIN((size_t)SPI_MEM_FILE_BUFFER_SIZE, pipe->total_size - offset);
+            block->success =
+                spi_mem_file_read_block(pipe->worker->cb_ctx, block->data, block->size);
+            furi_message_queue_put(pipe->filled_blocks, &block, FuriWaitForever);
+            if(!block->success) break;
+            offset += block->size;
+        }
+    }
+    return 0;
+}
+
+static SPIMemWorkerPipe*
+    spi_mem_worker_pipe_alloc(SPIMemWorker* worker, bool to_file, size_t total_size) {
+    SPIMemWorkerPipe* pipe = malloc(sizeof(SPIMemWorkerPipe));
+    pipe->worker = worker;
+    pipe->to_file = to_file;
+    pipe->total_size = total_size;
+    pipe->stop = false;
+    pipe->free_blocks =
+        furi_message_queue_alloc(SPI_MEM_WORKER_PIPE_BLOCKS, sizeof(SPIMemWorkerBlock*));
+    pipe->filled_blocks =
+        furi_message_queue_alloc(SPI_MEM_WORKER_PIPE_BLOCKS, sizeof(SPIMemWorkerBlock*));
+    for(size_t i = 0; i < SPI_MEM_WORKER_PIPE_BLOCKS; i++) {
+        SPIMemWorkerBlock* block = &pipe->blocks[i];
+        block->data = malloc(SPI_MEM_FILE_BUFFER_SIZE);
+        block->size = 0;
+        block->success = true;
+        furi_message_queue_put(pipe->free_blocks, &block, 0);
+    }
+    pipe->thread = furi_thread_alloc_ex("SPIMemFilePipe", 2048, spi_mem_worker_pipe_thread, pipe);
+    furi_thread_start(pipe->thread);
+    return pipe;
+}
+
+// Wait for a block, NULL if the worker is asked to stop meanwhile
+static SPIMemWorkerBlock*
+    spi_mem_worker_pipe_get(SPIMemWorkerPipe* pipe, FuriMessageQueue* queue) {
+    SPIMemWorkerBlock* block;
+    while(furi_message_queue_get(queue, &block, SPI_MEM_WORKER_PIPE_TIMEOUT) != FuriStatusOk) {
+        if(spi_mem_worker_check_for_stop(pipe->worker)) return NULL;
+    }
+    return block;
+}
+
+static void spi_mem_worker_pipe_put(FuriMessageQueue* queue, SPIMemWorkerBlock* block) {
+    furi_message_queue_put(queue, &block, FuriWaitForever);
+}
+
+// Wait until the file thread wrote every block handed to it
+static bool spi_mem_worker_pipe_flush(SPIMemWorkerPipe* pipe) {
+    bool success = true;
+    for(size_t i = 0; i < SPI_MEM_WORKER_PIPE_BLOCKS; i++) {
+        SPIMemWorkerBlock* block;
+        furi_message_queue_get(pipe->free_blocks, &block, FuriWaitForever);
+        if(!block->success) success = false;
+    }
+    return success;
+}
+
+static void spi_mem_worker_pipe_free(SPIMemWorkerPipe* pipe) {
+    pipe->stop = true;
+    furi_thread_join(pipe->thread);
+    furi_thread_free(pipe->thread);
+    furi_message_queue_free(pipe->free_blocks);
+    furi_message_queue_free(pipe->filled_blocks);
+    for(size_t i = 0; i < SPI_MEM_WORKER_PIPE_BLOCKS; i++) {
+        free(pipe->blocks[i].data);
+    }
+    free(pipe);
+}
+
 // ChipDetect
 static void spi_mem_worker_chip_detect_process(SPIMemWorker* worker) {
     SPIMemCustomEventWorker event;
@@ -58,41 +173,65 @@ static void spi_mem_worker_chip_detect_process(SPIMemWorker* worker) {
 }
 
 // Read
-static bool spi_mem_worker_read(SPIMemWorker* worker, SPIMemCustomEventWorker* event) {
-    uint8_t data_buffer[SPI_MEM_FILE_BUFFER_SIZE];
+static bool
+    spi_mem_worker_read(SPIMemWorker* worker, uint32_t* crc, SPIMemCustomEventWorker* event) {
     size_t chip_size = spi_mem_chip_get_size(worker->chip_info);
     size_t offset = 0;
     bool success = true;
+    // the SD card sits on another bus, so the READ command can stay open across file writes
+    if(!spi_mem_tools_read_stream_start(worker->chip_info, offset)) {
+        *event = SPIMemCustomEventWorkerChipFail;
+        return false;
+    }
+    SPIMemWorkerPipe* pipe = spi_mem_worker_pipe_alloc(worker, true, chip_size);
     while(true) {
-        furi_delay_tick(10); // to give some time to OS
         size_t block_size = SPI_MEM_FILE_BUFFER_SIZE;
         if(spi_mem_worker_check_for_stop(worker)) break;
         if(offset >= chip_size) break;
         if((offset + block_size) > chip_size) block_size = chip_size - offset;
-        if(!spi_mem_tools_read_block(worker->chip_info, offset, data_buffer, block_size)) {
-            *event = SPIMemCustomEventWorkerChipFail;
+        SPIMemWorkerBlock* block = spi_mem_worker_pipe_get(pipe, pipe->free_blocks);
+        if(!block) break;
+        if(!block->success) { // the file write of its previous contents failed
+            spi_mem_worker_pipe_put(pipe->free_blocks, block);
             success = false;
             break;
         }
-        if(!spi_mem_file_write_block(worker->cb_ctx, data_buffer, block_size)) {
+        if(!spi_mem_tools_read_stream(block->data, block_size)) {
+            spi_mem_worker_pipe_put(pipe->free_blocks, block);
+            *event = SPIMemCustomEventWorkerChipFail;
             success = false;
             break;
         }
+        *crc = spi_mem_tools_crc32(*crc, block->data, block_size);
+        block->size = block_size;
+        spi_mem_worker_pipe_put(pipe->filled_blocks, block);
         offset += block_size;
         spi_mem_worker_run_callback(worker, SPIMemCustomEventWorkerBlockReaded);
     }
+    spi_mem_tools_read_stream_stop();
+    if(!spi_mem_worker_pipe_flush(pipe) && success) {
+        *event = SPIMemCustomEventWorkerFileFail;
+        success = false;
+    }
+    spi_mem_worker_pipe_free(pipe);
     if(success) *event = SPIMemCustomEventWorkerDone;
     return success;
 }
 
 static void spi_mem_worker_read_process(SPIMemWorker* worker) {
     SPIMemCustomEventWorker event = SPIMemCustomEventWorkerFileFail;
+    uint32_t crc = 0;
+    bool success = false;
     do {
         if(!spi_mem_worker_await_chip_busy(worker)) break;
         if(!spi_mem_file_create_open(worker->cb_ctx)) break;
-        if(!spi_mem_worker_read(worker, &event)) break;
+        if(!spi_mem_worker_read(worker, &crc, &event)) break;
+        success = !spi_mem_worker_check_for_stop(worker);
     } while(0);
     spi_mem_file_close(worker->cb_ctx);
+    if(success && !spi_mem_file_save_crc(worker->cb_ctx, crc)) {
+        event = SPIMemCustomEventWorkerFileFail;
+    }
     spi_mem_worker_run_callback(worker, event);
 }
 
@@ -100,32 +239,35 @@ static void spi_mem_worker_read_process(SPIMemWorker* worker) {
 static bool
     spi_mem_worker_verify(SPIMemWorker* worker, size_t total_size, SPIMemCustomEventWorker* event) {
     uint8_t data_buffer_chip[SPI_MEM_FILE_BUFFER_SIZE];
-    uint8_t data_buffer_file[SPI_MEM_FILE_BUFFER_SIZE];
     size_t offset = 0;
     bool success = true;
+    if(!spi_mem_tools_read_stream_start(worker->chip_info, offset)) {
+        *event = SPIMemCustomEventWorkerChipFail;
+        return false;
+    }
+    SPIMemWorkerPipe* pipe = spi_mem_worker_pipe_alloc(worker, false, total_size);
     while(true) {
-        furi_delay_tick(10); // to give some time to OS
-        size_t block_size = SPI_MEM_FILE_BUFFER_SIZE;
         if(spi_mem_worker_check_for_stop(worker)) break;
         if(offset >= total_size) break;
-        if((offset + block_size) > total_size) block_size = total_size - offset;
-        if(!spi_mem_tools_read_block(worker->chip_info, offset, data_buffer_chip, block_size)) {
-            *event = SPIMemCustomEventWorkerChipFail;
+        SPIMemWorkerBlock* block = spi_mem_worker_pipe_get(pipe, pipe->filled_blocks);
+        if(!block) break;
+        size_t block_size = block->size;
+        if(!block->success) {
             success = false;
-            break;
-        }
-        if(!spi_mem_file_read_block(worker->cb_ctx, data_buffer_file, block_size)) {
+        } else if(!spi_mem_tools_read_stream(data_buffer_chip, block_size)) {
+            *event = SPIMemCustomEventWorkerChipFail;
             success = false;
-            break;
-        }
-        if(memcmp(data_buffer_chip, data_buffer_file, block_size) != 0) {
+        } else if(memcmp(data_buffer_chip, block->data, block_size) != 0) {
             *event = SPIMemCustomEventWorkerVerifyFail;
             success = false;
-            break;
         }
+        spi_mem_worker_pipe_put(pipe->free_blocks, block);
+        if(!success) break;
         offset += block_size;
         spi_mem_worker_run_callback(worker, SPIMemCustomEventWorkerBlockReaded);
     }
+    spi_mem_tools_read_stream_stop();
+    spi_mem_worker_pipe_free(pipe);
     if(success) *event = SPIMemCustomEventWorkerDone;
     return success;
 }
@@ -142,6 +284,57 @@ static void spi_mem_worker_verify_process(SPIMemWorker* worker) {
     spi_mem_worker_run_callback(worker, event);
 }
 
+// Verify against the CRC saved with the dump, only the chip is read
+static bool spi_mem_worker_verify_crc(
+    SPIMemWorker* worker,
+    size_t total_size,
+    uint32_t file_crc,
+    SPIMemCustomEventWorker* event) {
+    uint8_t data_buffer_chip[SPI_MEM_FILE_BUFFER_SIZE];
+    uint32_t crc = 0;
+    size_t offset = 0;
+    bool success = true;
+    if(!spi_mem_tools_read_stream_start(worker->chip_info, offset)) {
+        *event = SPIMemCustomEventWorkerChipFail;
+        return false;
+    }
+    while(true) {
+        size_t block_size = SPI_MEM_FILE_BUFFER_SIZE;
+        if(spi_mem_worker_check_for_stop(worker)) break;
+        if(offset >= total_size) {
+            if(crc != file_crc) {
+                *event = SPIMemCustomEventWorkerVerifyFail;
+                success = false;
+            }
+            break;
+        }
+        if((offset + block_size) > total_size) block_size = total_size - offset;
+        if(!spi_mem_tools_read_stream(data_buffer_chip, block_size)) {
+            *event = SPIMemCustomEventWorkerChipFail;
+            success = false;
+            break;
+        }
+        crc = spi_mem_tools_crc32(crc, data_buffer_chip, block_size);
+        offset += block_size;
+        spi_mem_worker_run_callback(worker, SPIMemCustomEventWorkerBlockReaded);
+    }
+    spi_mem_tools_read_stream_stop();
+    if(success) *event = SPIMemCustomEventWorkerDone;
+    return success;
+}
+
+static void spi_mem_worker_verify_crc_process(SPIMemWorker* worker) {
+    SPIMemCustomEventWorker event = SPIMemCustomEventWorkerFileFail;
+    size_t total_size = spi_mem_worker_modes_get_total_size(worker);
+    uint32_t file_crc;
+    do {
+        if(!spi_mem_worker_await_chip_busy(worker)) break;
+        if(!spi_mem_file_load_crc(worker->cb_ctx, &file_crc)) break;
+        if(!spi_mem_worker_verify_crc(worker, total_size, file_crc, &event)) break;
+    } while(0);
+    spi_mem_worker_run_callback(worker, event);
+}
+
 // Erase
 static void spi_mem_worker_erase_process(SPIMemWorker* worker) {
     SPIMemCustomEventWorker event = SPIMemCustomEventWorkerChipFail;
@@ -173,28 +366,28 @@ static bool spi_mem_worker_write_block_by_page(
 static bool
     spi_mem_worker_write(SPIMemWorker* worker, size_t total_size, SPIMemCustomEventWorker* event) {
     bool success = true;
-    uint8_t data_buffer[SPI_MEM_FILE_BUFFER_SIZE];
     size_t page_size = spi_mem_chip_get_page_size(worker->chip_info);
     size_t offset = 0;
+    SPIMemWorkerPipe* pipe = spi_mem_worker_pipe_alloc(worker, false, total_size);
     while(true) {
-        furi_delay_tick(10); // to give some time to OS
-        size_t block_size = SPI_MEM_FILE_BUFFER_SIZE;
         if(spi_mem_worker_check_for_stop(worker)) break;
         if(offset >= total_size) break;
-        if((offset + block_size) > total_size) block_size = total_size - offset;
-        if(!spi_mem_file_read_block(worker->cb_ctx, data_buffer, block_size)) {
+        SPIMemWorkerBlock* block = spi_mem_worker_pipe_get(pipe, pipe->filled_blocks);
+        if(!block) break;
+        size_t block_size = block->size;
+        if(!block->success) {
             *event = SPIMemCustomEventWorkerFileFail;
             success = false;
-            break;
-        }
-        if(!spi_mem_worker_write_block_by_page(
-               worker, offset, data_buffer, block_size, page_size)) {
+        } else if(!spi_mem_worker_write_block_by_page(
+                      worker, offset, block->data, block_size, page_size)) {
             success = false;
-            break;
         }
+        spi_mem_worker_pipe_put(pipe->free_blocks, block);
+        if(!success) break;
         offset += block_size;
         spi_mem_worker_run_callback(worker, SPIMemCustomEventWorkerBlockReaded);
     }
+    spi_mem_worker_pipe_free(pipe);
     return success;
 }
 
@@ -212,3 +405,98 @@ static void spi_mem_worker_write_process(SPIMemWorker* worker) {
     spi_mem_file_close(worker->cb_ctx);
     spi_mem_worker_run_callback(worker, event);
 }
+
+// Smart write: sectors equal to the file are skipped, a sector is erased only when
+// some bit has to go from 0 to 1, and only pages that still differ are programmed
+static bool
+    spi_mem_worker_sector_needs_erase(const uint8_t* chip, const uint8_t* file, size_t size) {
+    for(size_t i = 0; i < size; i++) {
+        if((chip[i] & file[i]) != file[i]) return true;
+    }
+    return false;
+}
+
+static bool spi_mem_worker_smart_write_sector(
+    SPIMemWorker* worker,
+    size_t offset,
+    uint8_t* chip_data,
+    uint8_t* file_data,
+    size_t size,
+    size_t page_size) {
+    if(spi_mem_worker_sector_needs_erase(chip_data, file_data, size)) {
+        if(!spi_mem_worker_await_chip_busy(worker)) return false;
+        if(!spi_mem_tools_erase_sector(worker->chip_info, offset)) return false;
+        memset(chip_data, 0xFF, size);
+    }
+    for(size_t i = 0; i < size; i += page_size) {
+        size_t chunk_size = MIN(page_size, size - i);
+        // after an erase this also skips pages that are all 0xFF in the file
+        if(memcmp(&chip_data[i], &file_data[i], chunk_size) == 0) continue;
+        if(!spi_mem_worker_await_chip_busy(worker)) return false;
+        if(!spi_mem_tools_write_bytes(worker->chip_info, offset + i, &file_data[i], chunk_size))
+            return false;
+    }
+    return true;
+}
+
+static bool spi_mem_worker_smart_write(
+    SPIMemWorker* worker,
+    size_t total_size,
+    SPIMemCustomEventWorker* event) {
+    uint8_t data_buffer_chip[SPI_MEM_SECTOR_SIZE];
+    bool success = true;
+    size_t chip_size = spi_mem_chip_get_size(worker->chip_info);
+    size_t page_size = spi_mem_chip_get_page_size(worker->chip_info);
+    size_t offset = 0;
+    SPIMemWorkerPipe* pipe = spi_mem_worker_pipe_alloc(worker, false, total_size);
+    while(true) {
+        if(spi_mem_worker_check_for_stop(worker)) break;
+        if(offset >= total_size) break;
+        SPIMemWorkerBlock* block = spi_mem_worker_pipe_get(pipe, pipe->filled_blocks);
+        if(!block) break;
+        size_t block_size = block->size;
+        size_t sector_size = MIN((size_t)SPI_MEM_SECTOR_SIZE, chip_size - offset);
+        if(!block->success) {
+            *event = SPIMemCustomEventWorkerFileFail;
+            success = false;
+        } else if(
+            !spi_mem_worker_await_chip_busy(worker) ||
+            !spi_mem_tools_read_stream_start(worker->chip_info, offset)) {
+            success = false;
+        } else {
+            success = spi_mem_tools_read_stream(data_buffer_chip, sector_size);
+            spi_mem_tools_read_stream_stop();
+        }
+        if(success) {
+            // the file ends inside this sector, keep the rest of it as it is on the chip
+            memcpy(
+                &block->data[block_size],
+                &data_buffer_chip[block_size],
+                sector_size - block_size);
+            if(memcmp(data_buffer_chip, block->data, sector_size) != 0) {
+                success = spi_mem_worker_smart_write_sector(
+                    worker, offset, data_buffer_chip, block->data, sector_size, page_size);
+            }
+        }
+        spi_mem_worker_pipe_put(pipe->free_blocks, block);
+        if(!success) break;
+        offset += block_size;
+        spi_mem_worker_run_callback(worker, SPIMemCustomEventWorkerBlockReaded);
+    }
+    spi_mem_worker_pipe_free(pipe);
+    return success;
+}
+
+static void spi_mem_worker_smart_write_process(SPIMemWorker* worker) {
+    SPIMemCustomEventWorker event = SPIMemCustomEventWorkerChipFail;
+    size_t total_size =
+        spi_mem_worker_modes_get_total_size(worker); // need to be executed before opening file
+    do {
+        if(!spi_mem_file_open(worker->cb_ctx)) break;
+        if(!spi_mem_worker_smart_write(worker, total_size, &event)) break;
+        if(!spi_mem_worker_await_chip_busy(worker)) break;
+        event = SPIMemCustomEventWorkerDone;
+    } while(0);
+    spi_mem_file_close(worker->cb_ctx);
+    spi_mem_worker_run_callback(worker, event);
+}
@@ -24,7 +24,12 @@ void spi_mem_scene_write_on_enter(void* context) {
         app->view_progress, spi_mem_tools_get_file_max_block_size(app->chip_info));
     view_dispatcher_switch_to_view(app->view_dispatcher, SPIMemViewProgress);
     spi_mem_worker_start_thread(app->worker);
-    spi_mem_worker_write_start(app->chip_info, app->worker, spi_mem_scene_write_callback, app);
+    if(app->mode == SPIMemModeSmartWrite) {
+        spi_mem_worker_smart_write_start(
+            app->chip_info, app->worker, spi_mem_scene_write_callback, app);
+    } else {
+        spi_mem_worker_write_start(app->chip_info, app->worker, spi_mem_scene_write_callback, app);
+    }
 }
 
 bool spi_mem_scene_write_on_event(void* context, SceneManagerEvent event) {
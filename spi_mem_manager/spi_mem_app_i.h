@@ -26,6 +26,7 @@
 
 #define TAG "SPIMem"
 #define SPI_MEM_FILE_EXTENSION ".bin"
+#define SPI_MEM_CRC_FILE_EXTENSION ".crc"
 #define SPI_MEM_FILE_PREFIX "SPIMem"
 #define SPI_MEM_FILE_NAME_SIZE 100
 #define SPI_MEM_TEXT_BUFFER_SIZE 128
@@ -33,6 +34,7 @@
 typedef enum {
     SPIMemModeRead,
     SPIMemModeWrite,
+    SPIMemModeSmartWrite,
     SPIMemModeCompare,
     SPIMemModeErase,
     SPIMemModeDelete,
@@ -1,6 +1,19 @@
 #include "spi_mem_app_i.h"
 
+// Sidecar next to the dump: "name.bin" -> "name.crc"
+static void spi_mem_file_get_crc_path(SPIMemApp* app, FuriString* crc_path) {
+    furi_string_set(crc_path, app->file_path);
+    if(furi_string_end_with(crc_path, SPI_MEM_FILE_EXTENSION)) {
+        furi_string_left(crc_path, furi_string_size(crc_path) - strlen(SPI_MEM_FILE_EXTENSION));
+    }
+    furi_string_cat(crc_path, SPI_MEM_CRC_FILE_EXTENSION);
+}
+
 bool spi_mem_file_delete(SPIMemApp* app) {
+    FuriString* crc_path = furi_string_alloc();
+    spi_mem_file_get_crc_path(app, crc_path);
+    storage_simply_remove(app->storage, furi_string_get_cstr(crc_path));
+    furi_string_free(crc_path);
     return (storage_simply_remove(app->storage, furi_string_get_cstr(app->file_path)));
 }
 
@@ -66,3 +79,41 @@ size_t spi_mem_file_get_size(SPIMemApp* app) {
         return 0;
     return file_info.size;
 }
+
+bool spi_mem_file_save_crc(SPIMemApp* app, uint32_t crc) {
+    bool success = false;
+    FuriString* crc_path = furi_string_alloc();
+    FuriString* crc_str = furi_string_alloc_printf("%08lX\n", crc);
+    File* file = storage_file_alloc(app->storage);
+    spi_mem_file_get_crc_path(app, crc_path);
+    if(storage_file_open(file, furi_string_get_cstr(crc_path), FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        size_t size = furi_string_size(crc_str);
+        success = (storage_file_write(file, furi_string_get_cstr(crc_str), size) == size);
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_string_free(crc_str);
+    furi_string_free(crc_path);
+    return success;
+}
+
+bool spi_mem_file_load_crc(SPIMemApp* app, uint32_t* crc) {
+    bool success = false;
+    char crc_str[9] = {0};
+    FuriString* crc_path = furi_string_alloc();
+    File* file = storage_file_alloc(app->storage);
+    spi_mem_file_get_crc_path(app, crc_path);
+    do {
+        if(!storage_file_open(file, furi_string_get_cstr(crc_path), FSAM_READ, FSOM_OPEN_EXISTING))
+            break;
+        if(storage_file_read(file, crc_str, 8) != 8) break;
+        char* end;
+        *crc = strtoul(crc_str, &end, 16);
+        if(*end != '\0') break;
+        success = true;
+    } while(0);
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_string_free(crc_path);
+    return success;
+}
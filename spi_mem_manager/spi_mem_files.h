@@ -11,3 +11,6 @@ bool spi_mem_file_read_block(SPIMemApp* app, uint8_t* data, size_t size);
 void spi_mem_file_close(SPIMemApp* app);
 void spi_mem_file_show_storage_error(SPIMemApp* app, const char* error_text);
 size_t spi_mem_file_get_size(SPIMemApp* app);
+// CRC-32 of a dump, kept in a sidecar file so the chip can be verified without reading it back
+bool spi_mem_file_save_crc(SPIMemApp* app, uint32_t crc);
+bool spi_mem_file_load_crc(SPIMemApp* app, uint32_t* crc);
@@ -8,6 +8,8 @@
 #define TAG "SubBruteWorker"
 #define SUBBRUTE_TX_TIMEOUT 6
 #define SUBBRUTE_MANUAL_TRANSMIT_INTERVAL 250
+#define SUBBRUTE_SESSION_POLL_MS 1
+#define SUBBRUTE_WORKER_SLICE_STEPS 16
 
 SubBruteWorker* subbrute_worker_alloc(const SubGhzDevice* radio_device) {
     SubBruteWorker* instance = malloc(sizeof(SubBruteWorker));
@@ -31,6 +33,10 @@ SubBruteWorker* subbrute_worker_alloc(const SubGhzDevice* radio_device) {
     instance->tx_timeout_ms = SUBBRUTE_TX_TIMEOUT;
     instance->decoder_result = NULL;
     instance->transmitter = NULL;
+    instance->encoder = NULL;
+    instance->de_bruijn = false;
+    instance->target_count = 0;
+    instance->target_index = 0;
     instance->environment = subghz_environment_alloc();
     subghz_environment_set_protocol_registry(
         instance->environment, (void*)&subghz_protocol_registry);
@@ -38,6 +44,7 @@ SubBruteWorker* subbrute_worker_alloc(const SubGhzDevice* radio_device) {
     instance->transmit_mode = false;
 
     instance->radio_device = radio_device;
+    instance->radio_ready = false;
 
     return instance;
 }
@@ -65,6 +72,10 @@ void subbrute_worker_free(SubBruteWorker* instance) {
 }
 
 uint64_t subbrute_worker_get_step(SubBruteWorker* instance) {
+    // Multi target run: the step of the initiated attack, whatever target is on air
+    if(instance->target_index != 0) {
+        return instance->targets[0].step;
+    }
     return instance->step;
 }
 
@@ -80,6 +91,45 @@ bool subbrute_worker_set_step(SubBruteWorker* instance, uint64_t step) {
     return true;
 }
 
+/**
+ * Store the attack fields of the worker in the current target
+ */
+static void subbrute_worker_save_target(SubBruteWorker* instance) {
+    SubBruteWorkerTarget* target = &instance->targets[instance->target_index];
+
+    target->attack = instance->attack;
+    target->frequency = instance->frequency;
+    target->preset = instance->preset;
+    target->file = instance->file;
+    target->bits = instance->bits;
+    target->te = instance->te;
+    target->repeat = instance->repeat;
+    target->step = instance->step;
+    target->max_value = instance->max_value;
+}
+
+/**
+ * Make target index the one the worker sends
+ */
+static void subbrute_worker_load_target(SubBruteWorker* instance, uint8_t index) {
+    const SubBruteWorkerTarget* target = &instance->targets[index];
+
+    instance->target_index = index;
+    instance->attack = target->attack;
+    instance->frequency = target->frequency;
+    instance->preset = target->preset;
+    instance->file = target->file;
+    instance->bits = target->bits;
+    instance->te = target->te;
+    instance->repeat = target->repeat;
+    instance->step = target->step;
+    instance->max_value = target->max_value;
+
+    instance->protocol_name = subbrute_protocol_file(instance->file);
+    instance->encoder = subbrute_encoder_get(instance->file);
+    subbrute_protocol_key_generator_init(&instance->key_generator, instance->file, instance->step);
+}
+
 bool subbrute_worker_init_default_attack(
     SubBruteWorker* instance,
     SubBruteAttacks attack_type,
@@ -104,10 +154,17 @@ bool subbrute_worker_init_default_attack(
     instance->load_index = 0;
     instance->file_key = 0;
     instance->two_bytes = false;
+    instance->de_bruijn = false;
+    // The file was checked by tuning the radio outside the worker
+    instance->radio_ready = false;
 
     instance->max_value =
         subbrute_protocol_calc_max_value(instance->attack, instance->bits, instance->two_bytes);
 
+    instance->target_count = 1;
+    instance->target_index = 0;
+    subbrute_worker_save_target(instance);
+
     instance->initiated = true;
     instance->state = SubBruteWorkerStateReady;
     subbrute_worker_send_callback(instance);
@@ -153,10 +210,17 @@ bool subbrute_worker_init_file_attack(
     instance->repeat = repeats;
     instance->file_key = file_key;
     instance->two_bytes = two_bytes;
+    instance->de_bruijn = false;
+    // The file was checked by tuning the radio outside the worker
+    instance->radio_ready = false;
 
     instance->max_value =
         subbrute_protocol_calc_max_value(instance->attack, instance->bits, instance->two_bytes);
 
+    // Only default attacks can be scheduled together
+    instance->target_count = 0;
+    instance->target_index = 0;
+
     instance->initiated = true;
     instance->state = SubBruteWorkerStateReady;
     subbrute_worker_send_callback(instance);
@@ -177,6 +241,61 @@ bool subbrute_worker_init_file_attack(
     return true;
 }
 
+bool subbrute_worker_add_target(
+    SubBruteWorker* instance,
+    SubBruteAttacks attack_type,
+    const SubBruteProtocol* protocol,
+    uint8_t repeats) {
+    furi_assert(instance);
+    furi_assert(protocol);
+
+    if(instance->worker_running || instance->target_count == 0 ||
+       instance->target_count >= SUBBRUTE_WORKER_MAX_TARGETS ||
+       attack_type == SubBruteAttackLoadFile) {
+        return false;
+    }
+    if(!subghz_devices_is_frequency_valid(instance->radio_device, protocol->frequency)) {
+        FURI_LOG_W(TAG, "Target frequency not allowed: %ld", protocol->frequency);
+        return false;
+    }
+
+    SubBruteWorkerTarget* target = &instance->targets[instance->target_count++];
+    target->attack = attack_type;
+    target->frequency = protocol->frequency;
+    target->preset = protocol->preset;
+    target->file = protocol->file;
+    target->bits = protocol->bits;
+    target->te = protocol->te;
+    target->repeat = repeats;
+    target->step = 0;
+    target->max_value = subbrute_protocol_calc_max_value(attack_type, protocol->bits, false);
+    target->finished = false;
+
+    // Scheduled targets are sent frame by frame
+    instance->de_bruijn = false;
+
+    return true;
+}
+
+uint8_t subbrute_worker_get_targets_progress(
+    SubBruteWorker* instance,
+    SubBruteWorkerTargetProgress* progress) {
+    furi_assert(instance);
+    furi_assert(progress);
+
+    if(instance->target_count < 2) {
+        return 0;
+    }
+    for(uint8_t i = 0; i < instance->target_count; i++) {
+        const SubBruteWorkerTarget* target = &instance->targets[i];
+        progress[i].attack = target->attack;
+        progress[i].step = i == instance->target_index ? instance->step : target->step;
+        progress[i].max_value = target->max_value;
+    }
+
+    return instance->target_count;
+}
+
 bool subbrute_worker_start(SubBruteWorker* instance) {
     furi_assert(instance);
 
@@ -244,6 +363,7 @@ bool subbrute_worker_transmit_current_key(SubBruteWorker* instance, uint64_t ste
 
     bool result;
     instance->protocol_name = subbrute_protocol_file(instance->file);
+    instance->encoder = subbrute_encoder_get(instance->file);
     FlipperFormat* flipper_format = flipper_format_string_alloc();
     Stream* stream = flipper_format_get_raw_stream(flipper_format);
 
@@ -310,6 +430,34 @@ void subbrute_worker_set_callback(
     instance->context = context;
 }
 
+/**
+ * Bring the radio to idle with the preset and frequency of the target being
+ * sent. The chip is reset only the first time, after that the preset is
+ * loaded and the PLL calibrated again only when they change.
+ */
+static void subbrute_worker_radio_setup(SubBruteWorker* instance) {
+    if(!instance->radio_ready) {
+        subghz_devices_reset(instance->radio_device);
+        subghz_devices_idle(instance->radio_device);
+        subghz_devices_load_preset(instance->radio_device, instance->preset, NULL);
+        instance->radio_preset = instance->preset;
+        instance->radio_frequency = 0;
+        instance->radio_ready = true;
+    } else {
+        subghz_devices_idle(instance->radio_device);
+        if(instance->radio_preset != instance->preset) {
+            subghz_devices_load_preset(instance->radio_device, instance->preset, NULL);
+            instance->radio_preset = instance->preset;
+        }
+    }
+
+    if(instance->radio_frequency != instance->frequency) {
+        subghz_devices_set_frequency(
+            instance->radio_device, instance->frequency); // TODO is freq valid check
+        instance->radio_frequency = instance->frequency;
+    }
+}
+
 void subbrute_worker_subghz_transmit(SubBruteWorker* instance, FlipperFormat* flipper_format) {
     const uint8_t timeout = instance->tx_timeout_ms;
     while(instance->transmit_mode) {
@@ -324,11 +472,7 @@ void subbrute_worker_subghz_transmit(SubBruteWorker* instance, FlipperFormat* fl
         subghz_transmitter_alloc_init(instance->environment, instance->protocol_name);
     subghz_transmitter_deserialize(instance->transmitter, flipper_format);
 
-    subghz_devices_reset(instance->radio_device);
-    subghz_devices_idle(instance->radio_device);
-    subghz_devices_load_preset(instance->radio_device, instance->preset, NULL);
-    subghz_devices_set_frequency(
-        instance->radio_device, instance->frequency); // TODO is freq valid check
+    subbrute_worker_radio_setup(instance);
 
     if(subghz_devices_set_tx(instance->radio_device)) {
         subghz_devices_start_async_tx(
@@ -348,12 +492,309 @@ void subbrute_worker_subghz_transmit(SubBruteWorker* instance, FlipperFormat* fl
     instance->transmit_mode = false;
 }
 
+/**
+ * Session mode: used by the attack thread, the radio is configured and the
+ * transmitter allocated once, then only the key payload changes every step.
+ * Protocols with a direct encoder skip the transmitter altogether.
+ */
+void subbrute_worker_session_start(SubBruteWorker* instance) {
+    while(instance->transmit_mode) {
+        furi_delay_ms(instance->tx_timeout_ms);
+    }
+    instance->transmit_mode = true;
+
+    if(instance->transmitter != NULL) {
+        subghz_transmitter_free(instance->transmitter);
+        instance->transmitter = NULL;
+    }
+    if(instance->encoder == NULL) {
+        instance->transmitter =
+            subghz_transmitter_alloc_init(instance->environment, instance->protocol_name);
+    }
+
+    subbrute_worker_radio_setup(instance);
+}
+
+void subbrute_worker_session_transmit(SubBruteWorker* instance, FlipperFormat* flipper_format) {
+    subghz_transmitter_deserialize(instance->transmitter, flipper_format);
+
+    if(subghz_devices_set_tx(instance->radio_device)) {
+        subghz_devices_start_async_tx(
+            instance->radio_device, subghz_transmitter_yield, instance->transmitter);
+        while(!subghz_devices_is_async_complete_tx(instance->radio_device)) {
+            furi_delay_ms(SUBBRUTE_SESSION_POLL_MS);
+        }
+        subghz_devices_stop_async_tx(instance->radio_device);
+    }
+
+    subghz_devices_idle(instance->radio_device);
+    subghz_transmitter_stop(instance->transmitter);
+}
+
+static LevelDuration subbrute_worker_encoder_yield(void* context) {
+    SubBruteWorker* instance = context;
+
+    if(instance->upload_repeat == 0) {
+        return level_duration_reset();
+    }
+
+    LevelDuration ret = instance->upload[instance->upload_front];
+    if(++instance->upload_front == instance->upload_size) {
+        instance->upload_front = 0;
+        instance->upload_repeat--;
+    }
+    return ret;
+}
+
+void subbrute_worker_session_transmit_key(SubBruteWorker* instance, uint64_t key) {
+    instance->upload_size = subbrute_encoder_build(
+        instance->encoder, instance->upload, key, instance->bits, instance->te);
+    instance->upload_front = 0;
+    instance->upload_repeat = instance->repeat;
+
+    if(subghz_devices_set_tx(instance->radio_device)) {
+        subghz_devices_start_async_tx(
+            instance->radio_device, subbrute_worker_encoder_yield, instance);
+        while(!subghz_devices_is_async_complete_tx(instance->radio_device)) {
+            furi_delay_ms(SUBBRUTE_SESSION_POLL_MS);
+        }
+        subghz_devices_stop_async_tx(instance->radio_device);
+    }
+
+    subghz_devices_idle(instance->radio_device);
+}
+
+static LevelDuration subbrute_worker_de_bruijn_yield(void* context) {
+    SubBruteWorker* instance = context;
+
+    // Header, then the bit pairs, then the trailer, all from the same upload buffer
+    if(instance->upload_front < instance->upload_size) {
+        return instance->upload[instance->upload_front++];
+    }
+    if(instance->de_bruijn_pair_front < COUNT_OF(instance->de_bruijn_pair)) {
+        return instance->de_bruijn_pair[instance->de_bruijn_pair_front++];
+    }
+
+    bool bit;
+    if(subbrute_protocol_de_bruijn_next_bit(&instance->de_bruijn_state, &bit)) {
+        instance->encoder->bit(instance->de_bruijn_pair, bit, instance->te);
+        instance->de_bruijn_pair_front = 1;
+        instance->de_bruijn_sent++;
+        return instance->de_bruijn_pair[0];
+    }
+
+    if(!instance->de_bruijn_trailer) {
+        instance->de_bruijn_trailer = true;
+        instance->upload_size = instance->encoder->trailer(instance->upload, instance->te);
+        instance->upload_front = 0;
+        if(instance->upload_size > 0) {
+            return instance->upload[instance->upload_front++];
+        }
+    }
+
+    return level_duration_reset();
+}
+
+/**
+ * Send the De Bruijn stream of the whole keyspace, step follows the number
+ * of codes already covered
+ *
+ * @return true if the stream was sent to the end
+ */
+bool subbrute_worker_session_transmit_de_bruijn(SubBruteWorker* instance) {
+    bool completed = false;
+
+    subbrute_protocol_de_bruijn_init(&instance->de_bruijn_state, instance->bits);
+    instance->upload_size =
+        instance->encoder->header(instance->upload, instance->bits, instance->te);
+    instance->upload_front = 0;
+    instance->de_bruijn_pair_front = COUNT_OF(instance->de_bruijn_pair);
+    instance->de_bruijn_trailer = false;
+    instance->de_bruijn_sent = 0;
+    instance->step = 0;
+
+    if(subghz_devices_set_tx(instance->radio_device)) {
+        subghz_devices_start_async_tx(
+            instance->radio_device, subbrute_worker_de_bruijn_yield, instance);
+        while(!subghz_devices_is_async_complete_tx(instance->radio_device)) {
+            if(!instance->worker_running) {
+                break;
+            }
+            const uint32_t sent = instance->de_bruijn_sent;
+            if(sent >= instance->bits) {
+                instance->step = MIN((uint64_t)(sent - instance->bits), instance->max_value);
+            }
+            furi_delay_ms(SUBBRUTE_SESSION_POLL_MS);
+        }
+        completed = subghz_devices_is_async_complete_tx(instance->radio_device);
+        subghz_devices_stop_async_tx(instance->radio_device);
+        if(completed) {
+            instance->step = instance->max_value;
+        }
+    }
+
+    subghz_devices_idle(instance->radio_device);
+
+    return completed;
+}
+
+/**
+ * Change the protocol and the radio setup in the middle of a session, for
+ * multi target runs
+ */
+void subbrute_worker_session_switch(SubBruteWorker* instance) {
+    if(instance->transmitter != NULL) {
+        subghz_transmitter_free(instance->transmitter);
+        instance->transmitter = NULL;
+    }
+    if(instance->encoder == NULL) {
+        instance->transmitter =
+            subghz_transmitter_alloc_init(instance->environment, instance->protocol_name);
+    }
+
+    subbrute_worker_radio_setup(instance);
+}
+
+void subbrute_worker_session_stop(SubBruteWorker* instance) {
+    subghz_devices_idle(instance->radio_device);
+
+    if(instance->transmitter != NULL) {
+        subghz_transmitter_free(instance->transmitter);
+        instance->transmitter = NULL;
+    }
+
+    instance->transmit_mode = false;
+}
+
 void subbrute_worker_send_callback(SubBruteWorker* instance) {
     if(instance->callback != NULL) {
         instance->callback(instance->context, instance->state);
     }
 }
 
+/**
+ * Send the current step of the loaded target
+ */
+static void
+    subbrute_worker_transmit_step(SubBruteWorker* instance, FlipperFormat* flipper_format) {
+    if(instance->encoder != NULL) {
+        uint64_t key;
+        if(instance->attack == SubBruteAttackLoadFile) {
+            key = subbrute_protocol_file_key(
+                instance->step, instance->load_index, instance->file_key, instance->two_bytes);
+        } else {
+            key = subbrute_protocol_key_generator_next(&instance->key_generator);
+        }
+        subbrute_worker_session_transmit_key(instance, key);
+        return;
+    }
+
+    Stream* stream = flipper_format_get_raw_stream(flipper_format);
+    stream_clean(stream);
+    if(instance->attack == SubBruteAttackLoadFile) {
+        subbrute_protocol_file_payload(
+            stream,
+            instance->step,
+            instance->bits,
+            instance->te,
+            instance->repeat,
+            instance->load_index,
+            instance->file_key,
+            instance->two_bytes);
+    } else {
+        subbrute_protocol_default_payload(
+            stream,
+            instance->file,
+            instance->step,
+            instance->bits,
+            instance->te,
+            instance->repeat);
+    }
+#ifdef FURI_DEBUG
+    //FURI_LOG_I(TAG, "Payload: %s", furi_string_get_cstr(payload));
+    //furi_delay_ms(SUBBRUTE_MANUAL_TRANSMIT_INTERVAL / 4);
+#endif
+
+    //        size_t written = stream_write_stream_write_string(stream, payload);
+    //        if(written <= 0) {
+    //            FURI_LOG_W(TAG, "Error creating packet! BREAK");
+    //            instance->worker_running = false;
+    //            local_state = SubBruteWorkerStateIDLE;
+    //            furi_string_free(payload);
+    //            break;
+    //        }
+
+    subbrute_worker_session_transmit(instance, flipper_format);
+}
+
+/**
+ * Multi target run: every target gets SUBBRUTE_WORKER_SLICE_STEPS steps in
+ * turn. Targets are visited in frequency order, so the radio is retuned only
+ * when the frequency or the preset actually changes.
+ *
+ * @return SubBruteWorkerStateFinished once every target reached its max value
+ */
+static SubBruteWorkerState
+    subbrute_worker_run_targets(SubBruteWorker* instance, FlipperFormat* flipper_format) {
+    uint8_t order[SUBBRUTE_WORKER_MAX_TARGETS];
+    for(uint8_t i = 0; i < instance->target_count; i++) {
+        uint8_t j = i;
+        while(j > 0) {
+            const SubBruteWorkerTarget* prev = &instance->targets[order[j - 1]];
+            const SubBruteWorkerTarget* target = &instance->targets[i];
+            if(prev->frequency < target->frequency ||
+               (prev->frequency == target->frequency && prev->preset <= target->preset)) {
+                break;
+            }
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+
+    // Target 0 may have been moved or tuned since init, the others restart when done
+    subbrute_worker_save_target(instance);
+    for(uint8_t i = 0; i < instance->target_count; i++) {
+        SubBruteWorkerTarget* target = &instance->targets[i];
+        if(i != 0 && target->finished) {
+            target->step = 0;
+        }
+        target->finished = false;
+    }
+
+    // The session starts tuned for target 0
+    uint8_t left = instance->target_count;
+    while(instance->worker_running && left > 0) {
+        for(uint8_t i = 0; i < instance->target_count && instance->worker_running; i++) {
+            if(instance->targets[order[i]].finished) {
+                continue;
+            }
+
+            subbrute_worker_load_target(instance, order[i]);
+            subbrute_worker_session_switch(instance);
+
+            for(uint8_t n = 0; n < SUBBRUTE_WORKER_SLICE_STEPS && instance->worker_running;
+                n++) {
+                subbrute_worker_transmit_step(instance, flipper_format);
+
+                if(instance->step + 1 > instance->max_value) {
+                    instance->targets[order[i]].finished = true;
+                    left--;
+                    break;
+                }
+                instance->step++;
+                furi_delay_ms(instance->tx_timeout_ms);
+            }
+            subbrute_worker_save_target(instance);
+        }
+    }
+
+    // Leave the initiated attack loaded for manual transmit and the next start
+    subbrute_worker_load_target(instance, 0);
+
+    return left == 0 ? SubBruteWorkerStateFinished : SubBruteWorkerStateTx;
+}
+
 /**
  * Entrypoint for worker
  *
@@ -381,61 +822,42 @@ int32_t subbrute_worker_thread(void* context) {
     subbrute_worker_send_callback(instance);
 
     instance->protocol_name = subbrute_protocol_file(instance->file);
+    instance->encoder = subbrute_encoder_get(instance->file);
 
     FlipperFormat* flipper_format = flipper_format_string_alloc();
-    Stream* stream = flipper_format_get_raw_stream(flipper_format);
 
-    while(instance->worker_running) {
-        stream_clean(stream);
-        if(instance->attack == SubBruteAttackLoadFile) {
-            subbrute_protocol_file_payload(
-                stream,
-                instance->step,
-                instance->bits,
-                instance->te,
-                instance->repeat,
-                instance->load_index,
-                instance->file_key,
-                instance->two_bytes);
-        } else {
-            subbrute_protocol_default_payload(
-                stream,
-                instance->file,
-                instance->step,
-                instance->bits,
-                instance->te,
-                instance->repeat);
-        }
-#ifdef FURI_DEBUG
-        //FURI_LOG_I(TAG, "Payload: %s", furi_string_get_cstr(payload));
-        //furi_delay_ms(SUBBRUTE_MANUAL_TRANSMIT_INTERVAL / 4);
-#endif
-
-        //        size_t written = stream_write_stream_write_string(stream, payload);
-        //        if(written <= 0) {
-        //            FURI_LOG_W(TAG, "Error creating packet! BREAK");
-        //            instance->worker_running = false;
-        //            local_state = SubBruteWorkerStateIDLE;
-        //            furi_string_free(payload);
-        //            break;
-        //        }
+    subbrute_worker_session_start(instance);
+    subbrute_protocol_key_generator_init(&instance->key_generator, instance->file, instance->step);
 
-        subbrute_worker_subghz_transmit(instance, flipper_format);
-
-        if(instance->step + 1 > instance->max_value) {
+    if(instance->de_bruijn) {
+        if(subbrute_worker_session_transmit_de_bruijn(instance)) {
 #ifdef FURI_DEBUG
-            FURI_LOG_I(TAG, "Worker finished to end");
+            FURI_LOG_I(TAG, "De Bruijn stream finished");
 #endif
             local_state = SubBruteWorkerStateFinished;
-            //            furi_string_free(payload);
-            break;
         }
-        instance->step++;
+    } else if(instance->target_count > 1) {
+        local_state = subbrute_worker_run_targets(instance, flipper_format);
+    } else {
+        while(instance->worker_running) {
+            subbrute_worker_transmit_step(instance, flipper_format);
 
-        //        furi_string_free(payload);
-        furi_delay_ms(instance->tx_timeout_ms);
+            if(instance->step + 1 > instance->max_value) {
+#ifdef FURI_DEBUG
+                FURI_LOG_I(TAG, "Worker finished to end");
+#endif
+                local_state = SubBruteWorkerStateFinished;
+                //            furi_string_free(payload);
+                break;
+            }
+            instance->step++;
+
+            //        furi_string_free(payload);
+            furi_delay_ms(instance->tx_timeout_ms);
+        }
     }
 
+    subbrute_worker_session_stop(instance);
     flipper_format_free(flipper_format);
 
     instance->worker_running = false; // Because we have error states
@@ -473,6 +895,26 @@ void subbrute_worker_set_te(SubBruteWorker* instance, uint32_t te) {
     instance->te = te;
 }
 
+bool subbrute_worker_is_de_bruijn_supported(SubBruteWorker* instance) {
+    furi_assert(instance);
+
+    // Loaded files only change one or two bytes of the key, no keyspace to cover
+    if(instance->attack == SubBruteAttackLoadFile || instance->target_count > 1 ||
+       instance->bits > SUBBRUTE_DE_BRUIJN_MAX_BITS) {
+        return false;
+    }
+    const SubBruteEncoder* encoder = subbrute_encoder_get(instance->file);
+    return encoder != NULL && encoder->de_bruijn;
+}
+
+bool subbrute_worker_get_de_bruijn(SubBruteWorker* instance) {
+    return instance->de_bruijn;
+}
+
+void subbrute_worker_set_de_bruijn(SubBruteWorker* instance, bool de_bruijn) {
+    instance->de_bruijn = de_bruijn && subbrute_worker_is_de_bruijn_supported(instance);
+}
+
 // void subbrute_worker_timeout_inc(SubBruteWorker* instance) {
 //     if(instance->tx_timeout_ms < 255) {
 //         instance->tx_timeout_ms++;
@@ -493,6 +935,7 @@ bool subbrute_worker_is_tx_allowed(SubBruteWorker* instance, uint32_t value) {
         return false;
     } else {
         subghz_devices_set_frequency(instance->radio_device, value);
+        instance->radio_frequency = value;
         res = subghz_devices_set_tx(instance->radio_device);
         subghz_devices_idle(instance->radio_device);
     }
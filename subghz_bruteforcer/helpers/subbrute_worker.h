@@ -12,6 +12,14 @@ typedef enum {
 
 typedef void (*SubBruteWorkerCallback)(void* context, SubBruteWorkerState state);
 
+#define SUBBRUTE_WORKER_MAX_TARGETS 4
+
+typedef struct {
+    SubBruteAttacks attack;
+    uint64_t step;
+    uint64_t max_value;
+} SubBruteWorkerTargetProgress;
+
 typedef struct SubBruteWorker SubBruteWorker;
 
 SubBruteWorker* subbrute_worker_alloc(const SubGhzDevice* radio_device);
@@ -33,6 +41,14 @@ bool subbrute_worker_init_file_attack(
     SubBruteProtocol* protocol,
     uint8_t repeats,
     bool two_bytes);
+bool subbrute_worker_add_target(
+    SubBruteWorker* instance,
+    SubBruteAttacks attack_type,
+    const SubBruteProtocol* protocol,
+    uint8_t repeats);
+uint8_t subbrute_worker_get_targets_progress(
+    SubBruteWorker* instance,
+    SubBruteWorkerTargetProgress* progress);
 bool subbrute_worker_start(SubBruteWorker* instance);
 void subbrute_worker_stop(SubBruteWorker* instance);
 bool subbrute_worker_transmit_current_key(SubBruteWorker* instance, uint64_t step);
@@ -48,6 +64,9 @@ uint8_t subbrute_worker_get_repeats(SubBruteWorker* instance);
 void subbrute_worker_set_repeats(SubBruteWorker* instance, uint8_t repeats);
 uint32_t subbrute_worker_get_te(SubBruteWorker* instance);
 void subbrute_worker_set_te(SubBruteWorker* instance, uint32_t te);
+bool subbrute_worker_is_de_bruijn_supported(SubBruteWorker* instance);
+bool subbrute_worker_get_de_bruijn(SubBruteWorker* instance);
+void subbrute_worker_set_de_bruijn(SubBruteWorker* instance, bool de_bruijn);
 
 // void subbrute_worker_timeout_inc(SubBruteWorker* instance);
 
@@ -1,11 +1,29 @@
 #pragma once
 
 #include "subbrute_worker.h"
+#include "../subbrute_encoders.h"
 #include <lib/subghz/protocols/base.h>
 #include <lib/subghz/transmitter.h>
 #include <lib/subghz/receiver.h>
 #include <lib/subghz/environment.h>
 
+/**
+ * One sweep of a multi target run. Target 0 is the attack the worker was
+ * initiated with, the others are added with subbrute_worker_add_target()
+ */
+typedef struct {
+    SubBruteAttacks attack;
+    uint32_t frequency;
+    FuriHalSubGhzPreset preset;
+    SubBruteFileProtocol file;
+    uint8_t bits;
+    uint32_t te;
+    uint8_t repeat;
+    uint64_t step;
+    uint64_t max_value;
+    bool finished;
+} SubBruteWorkerTarget;
+
 struct SubBruteWorker {
     SubBruteWorkerState state;
     volatile bool worker_running;
@@ -24,6 +42,27 @@ struct SubBruteWorker {
     uint8_t tx_timeout_ms;
     const SubGhzDevice* radio_device;
 
+    // What the radio was last set up with, so only what changed is written again
+    bool radio_ready;
+    FuriHalSubGhzPreset radio_preset;
+    uint32_t radio_frequency;
+
+    // Direct encoder, NULL when the payload goes through the transmitter
+    const SubBruteEncoder* encoder;
+    LevelDuration upload[SUBBRUTE_ENCODER_MAX_UPLOAD];
+    size_t upload_size;
+    size_t upload_front;
+    uint8_t upload_repeat;
+    SubBruteKeyGenerator key_generator; // Default attack keys for the direct encoder
+
+    // De Bruijn mode, the whole keyspace is sent as a single stream
+    bool de_bruijn;
+    SubBruteDeBruijn de_bruijn_state;
+    LevelDuration de_bruijn_pair[2];
+    uint8_t de_bruijn_pair_front;
+    bool de_bruijn_trailer;
+    volatile uint32_t de_bruijn_sent; // Bits sent, updated from the yield callback
+
     // Initiated values
     SubBruteAttacks attack; // Attack state
     uint32_t frequency;
@@ -37,6 +76,11 @@ struct SubBruteWorker {
     uint64_t max_value; // Max step
     bool two_bytes;
 
+    // Multi target run, the fields above hold the target being sent
+    SubBruteWorkerTarget targets[SUBBRUTE_WORKER_MAX_TARGETS];
+    uint8_t target_count;
+    uint8_t target_index;
+
     // Manual transmit
     uint32_t last_time_tx_data;
 
@@ -47,4 +91,10 @@ struct SubBruteWorker {
 
 int32_t subbrute_worker_thread(void* context);
 void subbrute_worker_subghz_transmit(SubBruteWorker* instance, FlipperFormat* flipper_format);
+void subbrute_worker_session_start(SubBruteWorker* instance);
+void subbrute_worker_session_transmit(SubBruteWorker* instance, FlipperFormat* flipper_format);
+void subbrute_worker_session_transmit_key(SubBruteWorker* instance, uint64_t key);
+bool subbrute_worker_session_transmit_de_bruijn(SubBruteWorker* instance);
+void subbrute_worker_session_switch(SubBruteWorker* instance);
+void subbrute_worker_session_stop(SubBruteWorker* instance);
 void subbrute_worker_send_callback(SubBruteWorker* instance);
\ No newline at end of file
@@ -97,6 +97,12 @@ bool subbrute_scene_run_attack_on_event(void* context, SceneManagerEvent event)
         instance->device->current_step = step;
         subbrute_attack_view_set_current_step(view, step);
 
+        SubBruteWorkerTargetProgress targets[SUBBRUTE_WORKER_MAX_TARGETS];
+        uint8_t target_count = subbrute_worker_get_targets_progress(instance->worker, targets);
+        if(target_count > 1) {
+            subbrute_attack_view_set_targets(view, targets, target_count);
+        }
+
         consumed = true;
     }
 
@@ -68,6 +68,18 @@ bool subbrute_scene_start_on_event(void* context, SceneManagerEvent event) {
                    instance->device->extra_repeats))) {
                 furi_crash("Invalid attack set!");
             }
+
+            // Attacks scheduled with a long OK are time-sliced with the selected one
+            const uint64_t scheduled = subbrute_main_view_get_scheduled(instance->view_main);
+            for(uint8_t i = 0; i < SubBruteAttackLoadFile; i++) {
+                if(i != instance->settings->last_index && (scheduled & (1ULL << i))) {
+                    subbrute_worker_add_target(
+                        instance->worker,
+                        i,
+                        subbrute_protocol(i),
+                        instance->settings->repeat_values[i]);
+                }
+            }
             subbrute_settings_save(instance->settings);
             scene_manager_next_scene(instance->scene_manager, SubBruteSceneSetupAttack);
 
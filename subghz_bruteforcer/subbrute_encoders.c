@@ -0,0 +1,163 @@
+#include "subbrute_encoders.h"
+
+#define TAG "SubBruteEncoders"
+
+#define SUBBRUTE_CAME_TE_SHORT 320
+#define SUBBRUTE_CAME_TE_LONG 640
+#define SUBBRUTE_NICE_FLO_TE_SHORT 700
+#define SUBBRUTE_NICE_FLO_TE_LONG 1400
+#define SUBBRUTE_PRINCETON_TE 400
+#define SUBBRUTE_PRINCETON_GUARD_TIME 30
+
+/**
+ * Pulse distance coding shared by CAME and Nice FLO:
+ * low header, high start bit, then low/high pairs with the bit in the low part
+ */
+static void subbrute_encoder_pulse_distance_bit(
+    LevelDuration* pair,
+    bool bit,
+    uint32_t te_short,
+    uint32_t te_long) {
+    if(bit) {
+        pair[0] = level_duration_make(false, te_long);
+        pair[1] = level_duration_make(true, te_short);
+    } else {
+        pair[0] = level_duration_make(false, te_short);
+        pair[1] = level_duration_make(true, te_long);
+    }
+}
+
+static size_t subbrute_encoder_no_framing(LevelDuration* upload, uint32_t te) {
+    UNUSED(upload);
+    UNUSED(te);
+    return 0;
+}
+
+static size_t subbrute_encoder_came_header(LevelDuration* upload, uint8_t bits, uint32_t te) {
+    UNUSED(te);
+    uint32_t header_te;
+    switch(bits) {
+    case 24:
+        header_te = 76;
+        break;
+    case 12:
+        header_te = 47;
+        break;
+    default:
+        header_te = 16;
+        break;
+    }
+
+    upload[0] = level_duration_make(false, SUBBRUTE_CAME_TE_SHORT * header_te);
+    upload[1] = level_duration_make(true, SUBBRUTE_CAME_TE_SHORT);
+    return 2;
+}
+
+static void subbrute_encoder_came_bit(LevelDuration* pair, bool bit, uint32_t te) {
+    UNUSED(te);
+    subbrute_encoder_pulse_distance_bit(pair, bit, SUBBRUTE_CAME_TE_SHORT, SUBBRUTE_CAME_TE_LONG);
+}
+
+static size_t subbrute_encoder_nice_flo_header(LevelDuration* upload, uint8_t bits, uint32_t te) {
+    UNUSED(bits);
+    UNUSED(te);
+    upload[0] = level_duration_make(false, SUBBRUTE_NICE_FLO_TE_SHORT * 36);
+    upload[1] = level_duration_make(true, SUBBRUTE_NICE_FLO_TE_SHORT);
+    return 2;
+}
+
+static void subbrute_encoder_nice_flo_bit(LevelDuration* pair, bool bit, uint32_t te) {
+    UNUSED(te);
+    subbrute_encoder_pulse_distance_bit(
+        pair, bit, SUBBRUTE_NICE_FLO_TE_SHORT, SUBBRUTE_NICE_FLO_TE_LONG);
+}
+
+static size_t subbrute_encoder_princeton_header(LevelDuration* upload, uint8_t bits, uint32_t te) {
+    UNUSED(upload);
+    UNUSED(bits);
+    UNUSED(te);
+    return 0;
+}
+
+static void subbrute_encoder_princeton_bit(LevelDuration* pair, bool bit, uint32_t te) {
+    if(te == 0) {
+        te = SUBBRUTE_PRINCETON_TE;
+    }
+    if(bit) {
+        pair[0] = level_duration_make(true, te * 3);
+        pair[1] = level_duration_make(false, te);
+    } else {
+        pair[0] = level_duration_make(true, te);
+        pair[1] = level_duration_make(false, te * 3);
+    }
+}
+
+static size_t subbrute_encoder_princeton_trailer(LevelDuration* upload, uint32_t te) {
+    if(te == 0) {
+        te = SUBBRUTE_PRINCETON_TE;
+    }
+
+    // Stop bit and guard time
+    upload[0] = level_duration_make(true, te);
+    upload[1] = level_duration_make(false, te * SUBBRUTE_PRINCETON_GUARD_TIME);
+    return 2;
+}
+
+static const SubBruteEncoder subbrute_encoder_came = {
+    .header = subbrute_encoder_came_header,
+    .bit = subbrute_encoder_came_bit,
+    .trailer = subbrute_encoder_no_framing,
+    .de_bruijn = true,
+};
+
+static const SubBruteEncoder subbrute_encoder_nice_flo = {
+    .header = subbrute_encoder_nice_flo_header,
+    .bit = subbrute_encoder_nice_flo_bit,
+    .trailer = subbrute_encoder_no_framing,
+    .de_bruijn = true,
+};
+
+/**
+ * PT2262/PT2272 style decoders latch a word only after its sync, so a
+ * stream without per-code framing is useless for them
+ */
+static const SubBruteEncoder subbrute_encoder_princeton = {
+    .header = subbrute_encoder_princeton_header,
+    .bit = subbrute_encoder_princeton_bit,
+    .trailer = subbrute_encoder_princeton_trailer,
+    .de_bruijn = false,
+};
+
+const SubBruteEncoder* subbrute_encoder_get(SubBruteFileProtocol file) {
+    switch(file) {
+    case CAMEFileProtocol:
+        return &subbrute_encoder_came;
+    case NICEFileProtocol:
+        return &subbrute_encoder_nice_flo;
+    case PrincetonFileProtocol:
+    case PT2260FileProtocol:
+        return &subbrute_encoder_princeton;
+    default:
+        // Everything else still goes through the SubGhz transmitter
+        return NULL;
+    }
+}
+
+size_t subbrute_encoder_build(
+    const SubBruteEncoder* encoder,
+    LevelDuration* upload,
+    uint64_t key,
+    uint8_t bits,
+    uint32_t te) {
+    furi_assert(encoder);
+    furi_assert(bits <= 64);
+
+    size_t index = encoder->header(upload, bits, te);
+    for(uint8_t i = bits; i > 0; i--) {
+        encoder->bit(&upload[index], (key >> (i - 1)) & 1, te);
+        index += 2;
+    }
+    index += encoder->trailer(&upload[index], te);
+
+    return index;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "subbrute_protocols.h"
+#include <lib/toolbox/level_duration.h>
+
+/**
+ * Longest upload an encoder can build: two level/duration pairs per bit for
+ * up to 64 bits, plus header, start and stop/guard entries
+ */
+#define SUBBRUTE_ENCODER_MAX_UPLOAD (2 * 64 + 4)
+
+/** Longest header or trailer of an encoder */
+#define SUBBRUTE_ENCODER_MAX_FRAMING 2
+
+/**
+ * Direct level/duration encoder of a protocol, used instead of the SubGhz
+ * transmitter so no FlipperFormat text has to be built for every key.
+ * te is the base duration in us, 0 for the protocol default.
+ */
+typedef struct {
+    /** Entries sent before the first bit, returns their count */
+    size_t (*header)(LevelDuration* upload, uint8_t bits, uint32_t te);
+    /** Level/duration pair of one bit */
+    void (*bit)(LevelDuration* pair, bool bit, uint32_t te);
+    /** Entries sent after the last bit, returns their count */
+    size_t (*trailer)(LevelDuration* upload, uint32_t te);
+    /** Receivers shift bits in and match any window, so De Bruijn streams work */
+    bool de_bruijn;
+} SubBruteEncoder;
+
+/**
+ * Get the direct encoder of a protocol
+ *
+ * @param file protocol
+ * @return encoder, or NULL if the protocol has to be sent through the SubGhz transmitter
+ */
+const SubBruteEncoder* subbrute_encoder_get(SubBruteFileProtocol file);
+
+/**
+ * Build the upload of one key frame
+ *
+ * @param encoder encoder from subbrute_encoder_get()
+ * @param upload destination, at least SUBBRUTE_ENCODER_MAX_UPLOAD entries
+ * @param key key to send, MSB first
+ * @param bits key length
+ * @param te base duration in us, 0 for the protocol default
+ * @return number of entries written to upload
+ */
+size_t subbrute_encoder_build(
+    const SubBruteEncoder* encoder,
+    LevelDuration* upload,
+    uint64_t key,
+    uint8_t bits,
+    uint32_t te);
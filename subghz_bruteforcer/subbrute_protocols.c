@@ -1,5 +1,4 @@
 #include "subbrute_protocols.h"
-#include "math.h"
 
 #define TAG "SubBruteProtocols"
 
@@ -569,10 +568,9 @@ SubBruteFileProtocol subbrute_protocol_file_protocol_name(FuriString* name) {
     return UnknownFileProtocol;
 }
 
-void subbrute_protocol_create_candidate_for_existing_file(
-    FuriString* candidate,
+uint64_t subbrute_protocol_file_key(
     uint64_t step,
-    size_t bit_index,
+    uint8_t bit_index,
     uint64_t file_key,
     bool two_bytes) {
     uint8_t p[8];
@@ -582,105 +580,181 @@ void subbrute_protocol_create_candidate_for_existing_file(
     uint8_t low_byte = step & (0xff);
     uint8_t high_byte = (step >> 8) & 0xff;
 
-    size_t size = sizeof(uint64_t);
-    for(size_t i = 0; i < size; i++) {
-        if(i == bit_index - 1 && two_bytes) {
-            furi_string_cat_printf(candidate, "%02X %02X", high_byte, low_byte);
-            i++;
-        } else if(i == bit_index) {
-            furi_string_cat_printf(candidate, "%02X", low_byte);
-        } else if(p[i] != 0) {
-            furi_string_cat_printf(candidate, "%02X", p[i]);
-        } else {
-            furi_string_cat_printf(candidate, "%s", "00");
-        }
+    if(two_bytes && bit_index > 0) {
+        p[bit_index - 1] = high_byte;
+        p[bit_index] = low_byte;
+    } else if(bit_index < 8) {
+        p[bit_index] = low_byte;
+    }
 
-        if(i < size - 1) {
-            furi_string_push_back(candidate, ' ');
-        }
+    uint64_t key = 0;
+    for(int i = 0; i < 8; i++) {
+        key = (key << 8) | p[i];
     }
 
-#ifdef FURI_DEBUG
-    FURI_LOG_D(TAG, "file candidate: %s, step: %lld", furi_string_get_cstr(candidate), step);
-#endif
+    return key;
 }
 
-void subbrute_protocol_create_candidate_for_default(
-    FuriString* candidate,
+/**
+ * Tri-state protocols (SMC5326, UNILARM, PT2260) send 8 base 3 digits with two
+ * bits per digit. Each table packs 4 digits into one byte, digit 0 in bits 0-1.
+ */
+#define SUBBRUTE_TRISTATE_DIGITS 8
+#define SUBBRUTE_TRISTATE_HALF 81 // 3^4, values of 4 digits
+
+// Digits 0, 1, 2 as 00, 10, 11
+static const uint8_t subbrute_tristate_00_10_11[SUBBRUTE_TRISTATE_HALF] = {
+    0x00, 0x02, 0x03, 0x08, 0x0A, 0x0B, 0x0C, 0x0E, 0x0F, 0x20, 0x22, 0x23, 0x28, 0x2A,
+    0x2B, 0x2C, 0x2E, 0x2F, 0x30, 0x32, 0x33, 0x38, 0x3A, 0x3B, 0x3C, 0x3E, 0x3F, 0x80,
+    0x82, 0x83, 0x88, 0x8A, 0x8B, 0x8C, 0x8E, 0x8F, 0xA0, 0xA2, 0xA3, 0xA8, 0xAA, 0xAB,
+    0xAC, 0xAE, 0xAF, 0xB0, 0xB2, 0xB3, 0xB8, 0xBA, 0xBB, 0xBC, 0xBE, 0xBF, 0xC0, 0xC2,
+    0xC3, 0xC8, 0xCA, 0xCB, 0xCC, 0xCE, 0xCF, 0xE0, 0xE2, 0xE3, 0xE8, 0xEA, 0xEB, 0xEC,
+    0xEE, 0xEF, 0xF0, 0xF2, 0xF3, 0xF8, 0xFA, 0xFB, 0xFC, 0xFE, 0xFF,
+};
+
+// Digits 0, 1, 2 as 00, 01, 11
+static const uint8_t subbrute_tristate_00_01_11[SUBBRUTE_TRISTATE_HALF] = {
+    0x00, 0x01, 0x03, 0x04, 0x05, 0x07, 0x0C, 0x0D, 0x0F, 0x10, 0x11, 0x13, 0x14, 0x15,
+    0x17, 0x1C, 0x1D, 0x1F, 0x30, 0x31, 0x33, 0x34, 0x35, 0x37, 0x3C, 0x3D, 0x3F, 0x40,
+    0x41, 0x43, 0x44, 0x45, 0x47, 0x4C, 0x4D, 0x4F, 0x50, 0x51, 0x53, 0x54, 0x55, 0x57,
+    0x5C, 0x5D, 0x5F, 0x70, 0x71, 0x73, 0x74, 0x75, 0x77, 0x7C, 0x7D, 0x7F, 0xC0, 0xC1,
+    0xC3, 0xC4, 0xC5, 0xC7, 0xCC, 0xCD, 0xCF, 0xD0, 0xD1, 0xD3, 0xD4, 0xD5, 0xD7, 0xDC,
+    0xDD, 0xDF, 0xF0, 0xF1, 0xF3, 0xF4, 0xF5, 0xF7, 0xFC, 0xFD, 0xFF,
+};
+
+struct SubBruteTristateLayout {
+    const uint8_t* half_lut; // 4 digits -> 8 bits, the first 3 entries are single digits
+    uint8_t shift; // Position of the digits in the key
+    uint64_t tail; // Fixed bits below the digits
+};
+
+static const SubBruteTristateLayout subbrute_tristate_smc5326 = {
+    .half_lut = subbrute_tristate_00_10_11,
+    .shift = 9,
+    .tail = 0x01D5, // gate1 111010101, gate2 would be 101110101
+};
+
+static const SubBruteTristateLayout subbrute_tristate_unilarm = {
+    .half_lut = subbrute_tristate_00_10_11,
+    .shift = 9,
+    .tail = 3 << 7, // gate1, gate2 would be 3 << 5
+};
+
+static const SubBruteTristateLayout subbrute_tristate_pt2260 = {
+    .half_lut = subbrute_tristate_00_01_11,
+    .shift = 8,
+    .tail = 0x03, // button open, lock 0x0C, stop 0x30, close 0xC0
+};
+
+static const SubBruteTristateLayout* subbrute_protocol_tristate_layout(SubBruteFileProtocol file) {
+    switch(file) {
+    case SMC5326FileProtocol:
+        return &subbrute_tristate_smc5326;
+    case UNILARMFileProtocol:
+        return &subbrute_tristate_unilarm;
+    case PT2260FileProtocol:
+        return &subbrute_tristate_pt2260;
+    default:
+        return NULL;
+    }
+}
+
+uint64_t subbrute_protocol_default_key(SubBruteFileProtocol file, uint64_t step) {
+    const SubBruteTristateLayout* layout = subbrute_protocol_tristate_layout(file);
+    if(layout == NULL) {
+        return step;
+    }
+
+    // Only the 8 lowest digits are sent, higher ones wrap like the original counter
+    const uint64_t code =
+        layout->half_lut[step % SUBBRUTE_TRISTATE_HALF] |
+        ((uint64_t)layout->half_lut[(step / SUBBRUTE_TRISTATE_HALF) % SUBBRUTE_TRISTATE_HALF]
+         << 8);
+    return (code << layout->shift) | layout->tail;
+}
+
+void subbrute_protocol_key_generator_init(
+    SubBruteKeyGenerator* instance,
     SubBruteFileProtocol file,
     uint64_t step) {
-    uint8_t p[8];
-    if(file == SMC5326FileProtocol) {
-        const uint8_t lut[] = {0x00, 0x02, 0x03}; // 00, 10, 11
-        const uint64_t gate1 = 0x01D5; // 111010101
-        //const uint8_t gate2 = 0x0175; // 101110101
-
-        uint64_t total = 0;
-        for(size_t j = 0; j < 8; j++) {
-            total |= lut[step % 3] << (2 * j);
-            double sub_step = (double)step / 3;
-            step = (uint64_t)floor(sub_step);
-        }
-        total <<= 9;
-        total |= gate1;
+    furi_assert(instance);
 
-        for(int i = 0; i < 8; i++) {
-            p[i] = (uint8_t)(total >> 8 * (7 - i)) & 0xFF;
-        }
-    } else if(file == UNILARMFileProtocol) {
-        const uint8_t lut[] = {0x00, 0x02, 0x03}; // 00, 10, 11
-        const uint64_t gate1 = 3 << 7;
-        //const uint8_t gate2 = 3 << 5;
-
-        uint64_t total = 0;
-        for(size_t j = 0; j < 8; j++) {
-            total |= lut[step % 3] << (2 * j);
-            double sub_step = (double)step / 3;
-            step = (uint64_t)floor(sub_step);
-        }
-        total <<= 9;
-        total |= gate1;
+    instance->layout = subbrute_protocol_tristate_layout(file);
+    instance->step = step;
+    instance->code = 0;
+    if(instance->layout == NULL) {
+        return;
+    }
 
-        for(int i = 0; i < 8; i++) {
-            p[i] = (uint8_t)(total >> 8 * (7 - i)) & 0xFF;
-        }
-    } else if(file == PT2260FileProtocol) {
-        const uint8_t lut[] = {0x00, 0x01, 0x03}; // 00, 01, 11
-        const uint64_t button_open = 0x03; // 11
-        //const uint8_t button_lock = 0x0C; // 1100
-        //const uint8_t button_stop = 0x30; // 110000
-        //const uint8_t button_close = 0xC0; // 11000000
-
-        uint64_t total = 0;
-        for(size_t j = 0; j < 8; j++) {
-            total |= lut[step % 3] << (2 * j);
-            double sub_step = (double)step / 3;
-            step = (uint64_t)floor(sub_step);
-        }
-        total <<= 8;
-        total |= button_open;
+    uint64_t value = step;
+    for(size_t j = 0; j < SUBBRUTE_TRISTATE_DIGITS; j++) {
+        instance->digits[j] = value % 3;
+        value /= 3;
+        instance->code |= (uint16_t)instance->layout->half_lut[instance->digits[j]] << (2 * j);
+    }
+}
+
+uint64_t subbrute_protocol_key_generator_next(SubBruteKeyGenerator* instance) {
+    furi_assert(instance);
 
-        for(int i = 0; i < 8; i++) {
-            p[i] = (uint8_t)(total >> 8 * (7 - i)) & 0xFF;
+    const SubBruteTristateLayout* layout = instance->layout;
+    if(layout == NULL) {
+        return instance->step++;
+    }
+
+    const uint64_t key = ((uint64_t)instance->code << layout->shift) | layout->tail;
+
+    // Base 3 increment, the carry stops after 1.5 digits on average
+    instance->step++;
+    for(size_t j = 0; j < SUBBRUTE_TRISTATE_DIGITS; j++) {
+        uint8_t digit = instance->digits[j] + 1;
+        if(digit == 3) {
+            digit = 0;
         }
-    } else {
-        for(int i = 0; i < 8; i++) {
-            p[i] = (uint8_t)(step >> 8 * (7 - i)) & 0xFF;
+        instance->digits[j] = digit;
+        instance->code = (instance->code & ~(0x03 << (2 * j))) |
+                         ((uint16_t)layout->half_lut[digit] << (2 * j));
+        if(digit != 0) {
+            break;
         }
     }
 
+    return key;
+}
+
+/**
+ * Key in the "XX XX XX XX XX XX XX XX" form of the Key field
+ */
+static void subbrute_protocol_key_to_str(FuriString* candidate, uint64_t key) {
     size_t size = sizeof(uint64_t);
     for(size_t i = 0; i < size; i++) {
-        if(p[i] != 0) {
-            furi_string_cat_printf(candidate, "%02X", p[i]);
-        } else {
-            furi_string_cat_printf(candidate, "%s", "00");
-        }
+        furi_string_cat_printf(candidate, "%02X", (uint8_t)(key >> 8 * (7 - i)) & 0xFF);
 
         if(i < size - 1) {
             furi_string_push_back(candidate, ' ');
         }
     }
+}
+
+void subbrute_protocol_create_candidate_for_existing_file(
+    FuriString* candidate,
+    uint64_t step,
+    size_t bit_index,
+    uint64_t file_key,
+    bool two_bytes) {
+    subbrute_protocol_key_to_str(
+        candidate, subbrute_protocol_file_key(step, bit_index, file_key, two_bytes));
+
+#ifdef FURI_DEBUG
+    FURI_LOG_D(TAG, "file candidate: %s, step: %lld", furi_string_get_cstr(candidate), step);
+#endif
+}
+
+void subbrute_protocol_create_candidate_for_default(
+    FuriString* candidate,
+    SubBruteFileProtocol file,
+    uint64_t step) {
+    subbrute_protocol_key_to_str(candidate, subbrute_protocol_default_key(file, step));
 
 #ifdef FURI_DEBUG
     FURI_LOG_D(TAG, "candidate: %s, step: %lld", furi_string_get_cstr(candidate), step);
@@ -873,3 +947,74 @@ uint64_t
 
     return max_value;
 }
+
+void subbrute_protocol_de_bruijn_init(SubBruteDeBruijn* instance, uint8_t order) {
+    furi_assert(instance);
+    furi_assert(order > 0 && order <= SUBBRUTE_DE_BRUIJN_MAX_BITS);
+
+    // The first Lyndon word is "0", its length always divides order
+    instance->word[1] = 0;
+    instance->len = 1;
+    instance->period = 1;
+    instance->pos = 1;
+    instance->order = order;
+    instance->tail = order - 1;
+    instance->done = false;
+}
+
+/**
+ * Next Lyndon word with a length dividing order, iterative FKM algorithm
+ *
+ * @return false when there are no more words
+ */
+static bool subbrute_protocol_de_bruijn_next_word(SubBruteDeBruijn* instance) {
+    while(true) {
+        // Extend the prenecklace periodically up to order
+        while(instance->len < instance->order) {
+            instance->word[instance->len + 1] =
+                instance->word[instance->len + 1 - instance->period];
+            instance->len++;
+        }
+        // Drop the trailing ones and increment the last zero
+        while(instance->len > 0 && instance->word[instance->len] == 1) {
+            instance->len--;
+        }
+        if(instance->len == 0) {
+            return false;
+        }
+        instance->word[instance->len] = 1;
+        instance->period = instance->len;
+        if(instance->order % instance->period == 0) {
+            return true;
+        }
+    }
+}
+
+bool subbrute_protocol_de_bruijn_next_bit(SubBruteDeBruijn* instance, bool* bit) {
+    furi_assert(instance);
+    furi_assert(bit);
+
+    if(!instance->done && instance->pos > instance->period) {
+        if(subbrute_protocol_de_bruijn_next_word(instance)) {
+            instance->pos = 1;
+        } else {
+            instance->done = true;
+        }
+    }
+
+    if(!instance->done) {
+        *bit = instance->word[instance->pos++];
+        return true;
+    }
+    if(instance->tail > 0) {
+        instance->tail--;
+        *bit = false;
+        return true;
+    }
+
+    return false;
+}
+
+uint64_t subbrute_protocol_de_bruijn_length(uint8_t order) {
+    return (1ULL << order) + order - 1;
+}
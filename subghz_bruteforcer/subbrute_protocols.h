@@ -6,6 +6,7 @@
 #include <toolbox/stream/stream.h>
 
 #define SUBBRUTE_PROTOCOL_MAX_REPEATS 9
+#define SUBBRUTE_DE_BRUIJN_MAX_BITS 24
 
 typedef enum {
     CAMEFileProtocol,
@@ -81,6 +82,35 @@ typedef struct {
     SubBruteFileProtocol file;
 } SubBruteProtocol;
 
+/**
+ * Binary De Bruijn sequence B(2, order) generator, one bit at a time.
+ * Lyndon words whose length divides order are concatenated in lexicographic
+ * order, then the first order - 1 bits (all zeros) are repeated at the end so
+ * every one of the 2^order codes shows up once as a window of the stream.
+ */
+typedef struct {
+    uint8_t word[SUBBRUTE_DE_BRUIJN_MAX_BITS + 1]; // Current prenecklace, 1-based
+    uint8_t len; // Length of the prenecklace
+    uint8_t period; // Length of the Lyndon word being sent
+    uint8_t pos; // Next bit of the Lyndon word to send
+    uint8_t order;
+    uint8_t tail; // Closing zeros left to send
+    bool done; // All the Lyndon words are sent
+} SubBruteDeBruijn;
+
+typedef struct SubBruteTristateLayout SubBruteTristateLayout;
+
+/**
+ * Keys of consecutive steps of a default attack. Tri-state protocols keep
+ * their base 3 digits and only the ones touched by the carry are re-encoded.
+ */
+typedef struct {
+    const SubBruteTristateLayout* layout; // NULL for plain binary keys
+    uint64_t step; // Step of the key returned by the next call
+    uint8_t digits[8];
+    uint16_t code;
+} SubBruteKeyGenerator;
+
 const SubBruteProtocol* subbrute_protocol(SubBruteAttacks index);
 const char* subbrute_protocol_preset(FuriHalSubGhzPreset preset);
 const char* subbrute_protocol_file(SubBruteFileProtocol protocol);
@@ -89,6 +119,18 @@ SubBruteFileProtocol subbrute_protocol_file_protocol_name(FuriString* name);
 uint8_t subbrute_protocol_repeats_count(SubBruteAttacks index);
 const char* subbrute_protocol_name(SubBruteAttacks index);
 
+uint64_t subbrute_protocol_default_key(SubBruteFileProtocol file, uint64_t step);
+void subbrute_protocol_key_generator_init(
+    SubBruteKeyGenerator* instance,
+    SubBruteFileProtocol file,
+    uint64_t step);
+uint64_t subbrute_protocol_key_generator_next(SubBruteKeyGenerator* instance);
+uint64_t subbrute_protocol_file_key(
+    uint64_t step,
+    uint8_t bit_index,
+    uint64_t file_key,
+    bool two_bytes);
+
 void subbrute_protocol_default_payload(
     Stream* stream,
     SubBruteFileProtocol file,
@@ -126,3 +168,7 @@ void subbrute_protocol_file_generate_file(
     bool two_bytes);
 uint64_t
     subbrute_protocol_calc_max_value(SubBruteAttacks attack_type, uint8_t bits, bool two_bytes);
+
+void subbrute_protocol_de_bruijn_init(SubBruteDeBruijn* instance, uint8_t order);
+bool subbrute_protocol_de_bruijn_next_bit(SubBruteDeBruijn* instance, bool* bit);
+uint64_t subbrute_protocol_de_bruijn_length(uint8_t order);
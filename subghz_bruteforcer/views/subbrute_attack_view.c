@@ -29,6 +29,8 @@ typedef struct {
     uint8_t repeat_count;
     bool is_attacking;
     IconAnimation* icon;
+    SubBruteWorkerTargetProgress targets[SUBBRUTE_WORKER_MAX_TARGETS];
+    uint8_t target_count; // Multi target run when > 1
 } SubBruteAttackViewModel;
 
 void subbrute_attack_view_set_callback(
@@ -206,6 +208,23 @@ void subbrute_attack_view_set_current_step(SubBruteAttackView* instance, uint64_
         true);
 }
 
+void subbrute_attack_view_set_targets(
+    SubBruteAttackView* instance,
+    const SubBruteWorkerTargetProgress* targets,
+    uint8_t count) {
+    furi_assert(instance);
+    furi_assert(count <= SUBBRUTE_WORKER_MAX_TARGETS);
+
+    with_view_model(
+        instance->view,
+        SubBruteAttackViewModel * model,
+        {
+            memcpy(model->targets, targets, sizeof(SubBruteWorkerTargetProgress) * count);
+            model->target_count = count;
+        },
+        true);
+}
+
 // We need to call init every time, because not every time we calls enter
 // normally, call enter only once
 void subbrute_attack_view_init_values(
@@ -239,6 +258,7 @@ void subbrute_attack_view_init_values(
             model->current_step = current_step;
             model->is_attacking = is_attacking;
             model->repeat_count = extra_repeats;
+            model->target_count = 0;
             if(is_attacking) {
                 icon_animation_start(model->icon);
             } else {
@@ -261,6 +281,37 @@ void subbrute_attack_view_exit(void* context) {
         false);
 }
 
+/**
+ * One row per target of a multi target run: name and a small progress bar
+ */
+static void subbrute_attack_view_draw_targets(Canvas* canvas, SubBruteAttackViewModel* model) {
+    const uint8_t row_height = 10;
+    const uint8_t y_first = 12;
+    const uint8_t bar_x = 92;
+    const uint8_t bar_width = 34;
+    FuriString* name = furi_string_alloc();
+
+    canvas_set_font(canvas, FontSecondary);
+    for(uint8_t i = 0; i < model->target_count; i++) {
+        const SubBruteWorkerTargetProgress* target = &model->targets[i];
+        const uint8_t y = y_first + i * row_height;
+
+        furi_string_set(name, subbrute_protocol_name(target->attack));
+        elements_string_fit_width(canvas, name, bar_x - 4);
+        canvas_draw_str_aligned(canvas, 2, y, AlignLeft, AlignTop, furi_string_get_cstr(name));
+
+        float progress_value =
+            target->max_value ? (float)target->step / (float)target->max_value : 1.0f;
+        if(progress_value > 1) {
+            progress_value = 1;
+        }
+        canvas_draw_frame(canvas, bar_x, y + 1, bar_width, 7);
+        canvas_draw_box(canvas, bar_x + 2, y + 3, (bar_width - 4) * progress_value, 3);
+    }
+
+    furi_string_free(name);
+}
+
 void subbrute_attack_view_draw(Canvas* canvas, void* context) {
     furi_assert(context);
     SubBruteAttackViewModel* model = (SubBruteAttackViewModel*)context;
@@ -278,7 +329,9 @@ void subbrute_attack_view_draw(Canvas* canvas, void* context) {
 
     // Current Step / Max value
     const uint8_t y_frequency = 17;
-    if(model->max_value > 9999) {
+    if(model->is_attacking && model->target_count > 1) {
+        subbrute_attack_view_draw_targets(canvas, model);
+    } else if(model->max_value > 9999) {
         canvas_set_font(canvas, FontBigNumbers);
         snprintf(buffer, sizeof(buffer), "%05d/", (int)model->current_step);
         canvas_draw_str_aligned(canvas, 5, y_frequency, AlignLeft, AlignTop, buffer);
@@ -330,8 +383,10 @@ void subbrute_attack_view_draw(Canvas* canvas, void* context) {
             canvas, x - icon_width_with_offset, y - icon_v_offset, model->icon);
         // Progress bar
         // Resolution: 128x64 px
-        float progress_value = (float)model->current_step / (float)model->max_value;
-        elements_progress_bar(canvas, 8, 37, 110, progress_value > 1 ? 1 : progress_value);
+        if(model->target_count < 2) {
+            float progress_value = (float)model->current_step / (float)model->max_value;
+            elements_progress_bar(canvas, 8, 37, 110, progress_value > 1 ? 1 : progress_value);
+        }
 
         snprintf(
             buffer,
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../subbrute_custom_event.h"
+#include "../helpers/subbrute_worker.h"
 #include <gui/view.h>
 #include <input/input.h>
 #include <gui/elements.h>
@@ -22,4 +23,8 @@ void subbrute_attack_view_init_values(
     uint64_t max_value,
     uint64_t current_step,
     bool is_attacking,
-    uint8_t extra_repeats);
\ No newline at end of file
+    uint8_t extra_repeats);
+void subbrute_attack_view_set_targets(
+    SubBruteAttackView* instance,
+    const SubBruteWorkerTargetProgress* targets,
+    uint8_t count);
@@ -29,6 +29,7 @@ struct SubBruteMainView {
     uint64_t key_from_file;
     uint8_t repeat_values[SubBruteAttackTotalCount];
     uint8_t window_position;
+    uint64_t scheduled; // Attacks to run along with the selected one, bit per attack
 };
 
 typedef struct {
@@ -38,6 +39,7 @@ typedef struct {
     bool is_select_byte;
     bool two_bytes;
     uint64_t key_from_file;
+    uint64_t scheduled;
 } SubBruteMainViewModel;
 
 void subbrute_main_view_set_callback(
@@ -185,6 +187,15 @@ void subbrute_main_view_draw_is_ordinary_selected(Canvas* canvas, SubBruteMainVi
                     subbrute_protocol_name(position));
             }
 
+            // Scheduled for a multi target run
+            if(model->scheduled & (1ULL << position)) {
+                canvas_draw_disc(
+                    canvas,
+                    screen_width - 22,
+                    string_height_offset + (item_position * item_height) + STATUS_BAR_Y_SHIFT,
+                    2);
+            }
+
             uint8_t current_repeat_count = model->repeat_values[position];
             uint8_t min_repeat_count = subbrute_protocol_repeats_count(position);
 
@@ -296,6 +307,18 @@ bool subbrute_main_view_input_ordinary_protocol(
         instance->repeat_values[index] = CLAMP(current_repeats + 1, max_repeats, min_repeats);
 
         updated = true;
+    } else if(event->key == InputKeyOk && event->type == InputTypeLong) {
+        // Toggle the attack in the schedule, the selected one is always sent
+        const uint64_t mask = 1ULL << index;
+        if(index == SubBruteAttackLoadFile) {
+            // Files can't be scheduled
+        } else if(instance->scheduled & mask) {
+            instance->scheduled &= ~mask;
+            updated = true;
+        } else if(__builtin_popcountll(instance->scheduled) < SUBBRUTE_WORKER_MAX_TARGETS - 1) {
+            instance->scheduled |= mask;
+            updated = true;
+        }
     } else if(event->key == InputKeyOk && is_short) {
         if(index == SubBruteAttackLoadFile) {
             instance->callback(SubBruteCustomEventTypeLoadFile, instance->context);
@@ -366,6 +389,7 @@ bool subbrute_main_view_input(InputEvent* event, void* context) {
                 model->key_from_file = instance->key_from_file;
                 model->is_select_byte = instance->is_select_byte;
                 model->two_bytes = instance->two_bytes;
+                model->scheduled = instance->scheduled;
                 model->repeat_values[model->index] = instance->repeat_values[instance->index];
             },
             true);
@@ -397,6 +421,7 @@ SubBruteMainView* subbrute_main_view_alloc() {
     instance->key_from_file = 0;
     instance->is_select_byte = false;
     instance->two_bytes = false;
+    instance->scheduled = 0;
 
     with_view_model(
         instance->view,
@@ -407,6 +432,7 @@ SubBruteMainView* subbrute_main_view_alloc() {
             model->key_from_file = instance->key_from_file;
             model->is_select_byte = instance->is_select_byte;
             model->two_bytes = instance->two_bytes;
+            model->scheduled = instance->scheduled;
         },
         true);
 
@@ -486,3 +512,8 @@ bool subbrute_main_view_get_two_bytes(SubBruteMainView* instance) {
     furi_assert(instance);
     return instance->two_bytes;
 }
+
+uint64_t subbrute_main_view_get_scheduled(SubBruteMainView* instance) {
+    furi_assert(instance);
+    return instance->scheduled;
+}
@@ -27,6 +27,7 @@ void subbrute_main_view_set_index(
 SubBruteAttacks subbrute_main_view_get_index(SubBruteMainView* instance);
 const uint8_t* subbrute_main_view_get_repeats(SubBruteMainView* instance);
 bool subbrute_main_view_get_two_bytes(SubBruteMainView* instance);
+uint64_t subbrute_main_view_get_scheduled(SubBruteMainView* instance);
 void subbrute_attack_view_enter(void* context);
 void subbrute_attack_view_exit(void* context);
 bool subbrute_attack_view_input(InputEvent* event, void* context);
@@ -424,21 +424,6 @@ static uint8_t swd_read_ap(AppFSM* const ctx, uint8_t ap, uint8_t ap_off, uint32
     return ret;
 }
 
-static uint8_t swd_read_ap_single(AppFSM* const ctx, uint8_t ap, uint8_t ap_off, uint32_t* data) {
-    uint8_t ret = swd_select(ctx, ap, (ap_off >> 4) & 0x0F, 0);
-    if(ret != 1) {
-        DBGS("swd_select failed");
-        return ret;
-    }
-    *data = 0;
-    ret = swd_transfer(ctx, true, false, (ap_off >> 2) & 3, data);
-    if(ret != 1) {
-        DBG("failed: %d", ret);
-        return ret;
-    }
-    return ret;
-}
-
 static uint8_t swd_write_ap(AppFSM* const ctx, uint8_t ap, uint8_t ap_off, uint32_t data) {
     uint8_t ret = swd_select(ctx, ap, (ap_off >> 4) & 0x0F, 0);
     if(ret != 1) {
@@ -485,32 +470,63 @@ uint8_t swd_read_memory(AppFSM* const ctx, uint8_t ap, uint32_t address, uint32_
     return ret;
 }
 
+/* retry a transfer as long as the target answers WAIT */
+static uint8_t
+    swd_transfer_wait(AppFSM* const ctx, bool ap, bool write, uint8_t a23, uint32_t* data) {
+    uint8_t ret = 0;
+    for(uint32_t tries = 0; tries < SWD_WAIT_RETRIES; tries++) {
+        ret = swd_transfer(ctx, ap, write, a23, data);
+        if(ret != 2) {
+            break;
+        }
+    }
+    return ret;
+}
+
 static uint8_t swd_read_memory_block(
     AppFSM* const ctx,
     uint8_t ap,
     uint32_t address,
     uint8_t* buf,
     uint32_t len) {
-    uint8_t ret = 0;
-    uint32_t data = 0;
     uint32_t csw = 0x23000012;
+    uint32_t pos = 0;
 
-    ret |= swd_write_ap(ctx, ap, MEMAP_CSW, csw);
-    ret |= swd_write_ap(ctx, ap, MEMAP_TAR, address);
-    ret |= swd_read_ap_single(ctx, ap, MEMAP_DRW, &data);
-
-    for(size_t pos = 0; pos < len; pos += 4) {
-        data = 0xDEADBEEF;
-        ret |= swd_read_ap_single(ctx, ap, MEMAP_DRW, &data);
-        DBG("read %lX", data);
+    uint8_t ret = swd_write_ap(ctx, ap, MEMAP_CSW, csw);
 
-        memcpy(&buf[pos], &data, 4);
+    while(ret == 1 && pos < len) {
+        uint32_t tar = address + pos;
+        uint32_t chunk = MIN(len - pos, MEMAP_TAR_WRAP - (tar & (MEMAP_TAR_WRAP - 1)));
+        uint32_t words = (chunk + 3) / 4;
+        uint32_t data = 0;
 
+        ret = swd_write_ap(ctx, ap, MEMAP_TAR, tar);
         if(ret != 1) {
-            swd_abort(ctx);
-            return ret;
+            break;
+        }
+
+        /* AP reads are posted, each DRW read returns the word of the previous one
+           and RDBUFF returns the last one without starting another access */
+        ret = swd_transfer_wait(ctx, true, false, (MEMAP_DRW >> 2) & 3, &data);
+        for(uint32_t word = 1; ret == 1 && word <= words; word++) {
+            data = 0xDEADBEEF;
+            if(word < words) {
+                ret = swd_transfer_wait(ctx, true, false, (MEMAP_DRW >> 2) & 3, &data);
+            } else {
+                ret = swd_transfer_wait(ctx, false, false, REG_RDBUFF, &data);
+            }
+            if(ret == 1) {
+                uint32_t size = MIN(len - pos, 4UL);
+                memcpy(&buf[pos], &data, size);
+                pos += size;
+            }
         }
     }
+
+    if(ret != 1) {
+        DBG("read from 0x%08lX failed", address + pos);
+        swd_abort(ctx);
+    }
     return ret;
 }
 
@@ -728,19 +744,12 @@ static void swd_script_log(ScriptContext* ctx, FuriLogLevel level, const char* f
 /* read characters until newline was read */
 static bool swd_script_seek_newline(ScriptContext* ctx) {
     while(true) {
-        uint8_t ch = 0;
+        char ch = ctx->text[ctx->line_pos];
 
-        if(ctx->script_file) {
-            if(storage_file_read(ctx->script_file, &ch, 1) != 1) {
-                return false;
-            }
-        } else {
-            ch = ctx->line_data[ctx->line_pos];
-            if(ch == 0) {
-                return false;
-            }
-            ctx->line_pos++;
+        if(ch == 0) {
+            return false;
         }
+        ctx->line_pos++;
         if(ch == '\n') {
             return true;
         }
@@ -751,35 +760,19 @@ static bool swd_script_seek_newline(ScriptContext* ctx) {
    returns false if EOF or newline was read */
 static bool swd_script_skip_whitespace(ScriptContext* ctx) {
     while(true) {
-        uint8_t ch = 0;
-        uint64_t start_pos = 0;
+        char ch = ctx->text[ctx->line_pos];
 
-        if(ctx->script_file) {
-            start_pos = storage_file_tell(ctx->script_file);
-
-            if(storage_file_read(ctx->script_file, &ch, 1) != 1) {
-                return false;
-            }
-        } else {
-            start_pos = ctx->line_pos;
-            ch = ctx->line_data[ctx->line_pos];
-
-            if(ch == 0) {
-                return false;
-            }
-            ctx->line_pos++;
-        }
-        if(ch == '\n') {
+        if(ch == 0) {
             return false;
         }
         if(ch != ' ') {
-            if(ctx->script_file) {
-                storage_file_seek(ctx->script_file, start_pos, true);
-            } else {
-                ctx->line_pos = start_pos;
+            if(ch == '\n') {
+                ctx->line_pos++;
+                return false;
             }
             return true;
         }
+        ctx->line_pos++;
     }
 }
 
@@ -790,41 +783,24 @@ static bool swd_script_get_string(ScriptContext* ctx, char* str, size_t max_leng
     str[pos] = '\000';
 
     while(true) {
-        char ch = 0;
-        uint64_t start_pos = 0;
-
-        if(ctx->script_file) {
-            start_pos = storage_file_tell(ctx->script_file);
-
-            if(storage_file_read(ctx->script_file, &ch, 1) != 1) {
-                DBGS("end reached");
-                return false;
-            }
-        } else {
-            start_pos = ctx->line_pos;
-            ch = ctx->line_data[ctx->line_pos];
+        char ch = ctx->text[ctx->line_pos];
 
-            if(ch == 0) {
-                DBGS("end reached");
-                return false;
-            }
-            ctx->line_pos++;
+        if(ch == 0) {
+            DBGS("end reached");
+            return false;
         }
 
         if(ch == '"') {
+            ctx->line_pos++;
             quot = !quot;
             continue;
         }
         if(!quot) {
             if(ch == ' ') {
+                ctx->line_pos++;
                 break;
             }
             if(ch == '\r' || ch == '\n') {
-                if(ctx->script_file) {
-                    storage_file_seek(ctx->script_file, start_pos, true);
-                } else {
-                    ctx->line_pos = start_pos;
-                }
                 break;
             }
         }
@@ -832,6 +808,7 @@ static bool swd_script_get_string(ScriptContext* ctx, char* str, size_t max_leng
             DBGS("too long");
             return false;
         }
+        ctx->line_pos++;
         str[pos++] = ch;
         str[pos] = '\000';
     }
@@ -2006,102 +1983,229 @@ static const ScriptFunctionInfo script_funcs[] = {
 
 /************************** script main code **************************/
 
+static size_t swd_script_find_func(const char* line) {
+    size_t entry = 0;
+
+    for(; entry < COUNT(script_funcs); entry++) {
+        if(!strncmp(line, script_funcs[entry].prefix, strlen(script_funcs[entry].prefix))) {
+            break;
+        }
+    }
+    return entry;
+}
+
+static bool swd_execute_script_func(ScriptContext* const ctx, size_t entry) {
+    DBG("command: '%s'", script_funcs[entry].prefix);
+
+    if(!ctx->status_ignore) {
+        snprintf(
+            ctx->app->state_string,
+            sizeof(ctx->app->state_string),
+            "CMD: %s",
+            script_funcs[entry].prefix);
+    }
+    swd_script_gui_refresh(ctx);
+
+    /* function, execute */
+    bool success = script_funcs[entry].func(ctx);
+
+    if(!success && !ctx->errors_ignore) {
+        swd_script_log(ctx, FuriLogLevelError, "Command failed: %s", script_funcs[entry].prefix);
+        snprintf(
+            ctx->app->state_string,
+            sizeof(ctx->app->state_string),
+            "Command failed: %s",
+            script_funcs[entry].prefix);
+        return false;
+    }
+
+    return true;
+}
+
 static bool swd_execute_script_line(ScriptContext* const ctx) {
-    char buffer[64];
-    uint64_t start_pos = 0;
+    const char* line = &ctx->text[ctx->line_pos];
 
-    if(ctx->script_file) {
-        start_pos = storage_file_tell(ctx->script_file);
-        uint16_t ret = storage_file_read(ctx->script_file, buffer, 2);
-        storage_file_seek(ctx->script_file, start_pos, true);
+    if(line[0] == 0 || line[1] == 0) {
+        return true;
+    }
 
-        if(ret < 2) {
-            return true;
-        }
-    } else {
-        start_pos = ctx->line_pos;
-        strncpy(buffer, ctx->line_data, 2);
+    if(line[0] == '\n' || (line[0] == '\r' && line[1] == '\n')) {
+        swd_script_seek_newline(ctx);
+        return true;
+    }
 
-        if(buffer[0] == 0 || buffer[1] == 0) {
-            return true;
-        }
+    if(ctx->abort) {
+        DBGS("aborting");
+        return false;
     }
 
-    if(buffer[0] == '\n' || (buffer[0] == '\r' && buffer[1] == '\n')) {
+    size_t entry = swd_script_find_func(line);
+
+    if(entry >= COUNT(script_funcs)) {
+        swd_script_log(ctx, FuriLogLevelError, "unknown command '%s'", line);
+        return false;
+    }
+    ctx->line_pos += strlen(script_funcs[entry].prefix);
+
+    if(ctx->goto_active) {
+        DBG("ignore: '%s'", script_funcs[entry].prefix);
+
+        /* only execute label handlers */
+        if(line[0] == '.') {
+            return script_funcs[entry].func(ctx);
+        }
         swd_script_seek_newline(ctx);
         return true;
     }
 
-    for(size_t entry = 0; entry < COUNT(script_funcs); entry++) {
-        if(ctx->abort) {
-            DBGS("aborting");
+    return swd_execute_script_func(ctx, entry);
+}
+
+static bool swd_script_load(ScriptContext* ctx, const char* filename) {
+    File* file = storage_file_alloc(ctx->app->storage);
+    bool success = false;
+
+    do {
+        if(!storage_file_open(file, filename, FSAM_READ, FSOM_OPEN_EXISTING)) {
+            FURI_LOG_E(TAG, "open, %s", storage_file_get_error_desc(file));
+            DBG("Failed to open '%s'", filename);
             break;
         }
-        size_t expected = strlen(script_funcs[entry].prefix);
 
-        if(ctx->script_file) {
-            storage_file_seek(ctx->script_file, start_pos, true);
+        uint64_t size = storage_file_size(file);
+        if(size > SCRIPT_MAX_SIZE) {
+            DBG("'%s' is too large", filename);
+            break;
+        }
 
-            if(storage_file_read(ctx->script_file, buffer, expected) != expected) {
-                continue;
-            }
-        } else {
-            ctx->line_pos = start_pos;
+        ctx->script_data = malloc(size + 1);
+        if(storage_file_read(file, ctx->script_data, size) != size) {
+            DBG("Failed to read '%s'", filename);
+            break;
+        }
+        ctx->script_data[size] = '\000';
+        ctx->text = ctx->script_data;
+        success = true;
+    } while(false);
 
-            if(strlen(ctx->line_data) < expected) {
-                continue;
+    storage_file_close(file);
+    storage_file_free(file);
+
+    return success;
+}
+
+typedef struct {
+    char name[64];
+    uint32_t op;
+} ScriptLabel;
+
+/* Resolve the command of every line and the target of every goto once, so loops
+   jump straight to their label instead of re-reading the script from the start */
+static bool swd_script_compile(ScriptContext* ctx, uint32_t* error_line) {
+    const char* text = ctx->text;
+    uint32_t lines = 1;
+    uint32_t labels_max = 0;
+    uint32_t labels_count = 0;
+    bool success = true;
+
+    for(uint32_t pos = 0; text[pos]; pos++) {
+        if(text[pos] == '\n') {
+            lines++;
+            if(!strncmp(&text[pos + 1], ".label", 6)) {
+                labels_max++;
             }
-            strncpy(buffer, ctx->line_data, expected);
-            ctx->line_pos += expected;
         }
+    }
+    if(!strncmp(text, ".label", 6)) {
+        labels_max++;
+    }
 
-        buffer[expected] = '\000';
-        if(strncmp(buffer, script_funcs[entry].prefix, expected)) {
-            continue;
-        }
-        bool success = true;
+    ctx->ops = malloc(lines * sizeof(ScriptOp));
+    ctx->ops_count = 0;
+    ScriptLabel* labels = malloc(MAX(labels_max, 1UL) * sizeof(ScriptLabel));
 
-        if(ctx->goto_active) {
-            DBG("ignore: '%s'", script_funcs[entry].prefix);
+    uint32_t pos = 0;
+    for(uint32_t line = 1; success && text[pos]; line++) {
+        const char* line_text = &text[pos];
+        *error_line = line;
 
-            /* only execute label handlers */
-            if(buffer[0] == '.') {
-                success = script_funcs[entry].func(ctx);
-            } else {
-                swd_script_seek_newline(ctx);
-            }
-        } else {
-            DBG("command: '%s'", script_funcs[entry].prefix);
+        if(line_text[0] != '\n' && !(line_text[0] == '\r' && line_text[1] == '\n')) {
+            size_t entry = swd_script_find_func(line_text);
 
-            if(!ctx->status_ignore) {
+            if(entry >= COUNT(script_funcs)) {
+                swd_script_log(ctx, FuriLogLevelError, "unknown command in line %lu", line);
                 snprintf(
-                    ctx->app->state_string,
-                    sizeof(ctx->app->state_string),
-                    "CMD: %s",
-                    script_funcs[entry].prefix);
+                    ctx->app->state_string, sizeof(ctx->app->state_string), "Unknown command");
+                success = false;
+                break;
             }
-            swd_script_gui_refresh(ctx);
+            uint32_t args = pos + strlen(script_funcs[entry].prefix);
+
+            if(script_funcs[entry].func == &swd_scriptfunc_label) {
+                ctx->line_pos = args;
+                swd_script_skip_whitespace(ctx);
+                if(!swd_script_get_string(
+                       ctx, labels[labels_count].name, sizeof(labels[labels_count].name))) {
+                    swd_script_log(ctx, FuriLogLevelError, "failed to parse label");
+                    snprintf(
+                        ctx->app->state_string,
+                        sizeof(ctx->app->state_string),
+                        "Invalid label");
+                    success = false;
+                    break;
+                }
+                labels[labels_count++].op = ctx->ops_count;
+            } else if(script_funcs[entry].func != &swd_scriptfunc_comment) {
+                ScriptOp* op = &ctx->ops[ctx->ops_count++];
+                op->func = entry;
+                op->line = line;
+                op->target = 0;
+                op->args = args;
+            }
+        }
 
-            /* function, execute */
-            success = script_funcs[entry].func(ctx);
+        /* next line */
+        while(text[pos] && text[pos] != '\n') {
+            pos++;
+        }
+        if(text[pos]) {
+            pos++;
+        }
+    }
 
-            if(!success && !ctx->errors_ignore) {
-                swd_script_log(
-                    ctx, FuriLogLevelError, "Command failed: %s", script_funcs[entry].prefix);
-                snprintf(
-                    ctx->app->state_string,
-                    sizeof(ctx->app->state_string),
-                    "Command failed: %s",
-                    script_funcs[entry].prefix);
-                return false;
-            }
+    for(uint32_t num = 0; success && num < ctx->ops_count; num++) {
+        ScriptOp* op = &ctx->ops[num];
+        char label[64];
+
+        if(script_funcs[op->func].func != &swd_scriptfunc_goto) {
+            continue;
+        }
+        *error_line = op->line;
+        ctx->line_pos = op->args;
+        swd_script_skip_whitespace(ctx);
+        if(!swd_script_get_string(ctx, label, sizeof(label))) {
+            swd_script_log(ctx, FuriLogLevelError, "failed to parse target label");
+            snprintf(ctx->app->state_string, sizeof(ctx->app->state_string), "Invalid goto");
+            success = false;
+            break;
         }
 
-        return true;
+        /* like before, a missing label skips the rest of the script */
+        op->target = ctx->ops_count;
+        for(uint32_t label_num = 0; label_num < labels_count; label_num++) {
+            if(!strcmp(label, labels[label_num].name)) {
+                op->target = labels[label_num].op;
+                break;
+            }
+        }
+        if(op->target == ctx->ops_count) {
+            swd_script_log(ctx, FuriLogLevelWarn, "label '%s' not found", label);
+        }
     }
-    swd_script_log(ctx, FuriLogLevelError, "unknown command '%s'", buffer);
 
-    return false;
+    free(labels);
+
+    return success;
 }
 
 static bool swd_execute_script(AppFSM* const ctx, const char* filename) {
@@ -2124,44 +2228,45 @@ static bool swd_execute_script(AppFSM* const ctx, const char* filename) {
         return false;
     }
 
-    /* first allocate a file object */
-    ctx->script->script_file = storage_file_alloc(ctx->storage);
-
-    /* then get our script opened */
-    if(!storage_file_open(ctx->script->script_file, filename, FSAM_READ, FSOM_OPEN_EXISTING)) {
-        FURI_LOG_E(TAG, "open, %s", storage_file_get_error_desc(ctx->script->script_file));
-        DBG("Failed to open '%s'", filename);
-        storage_file_free(ctx->script->script_file);
+    /* the script is read once and executed from RAM */
+    if(!swd_script_load(ctx->script, filename)) {
+        free(ctx->script->script_data);
         parent = ctx->script->parent;
         free(ctx->script);
         ctx->script = parent;
         return false;
     }
 
+    uint32_t line = 0;
+    bool compiled = swd_script_compile(ctx->script, &line);
+
     do {
-        success = true;
+        success = compiled;
         ctx->script->restart = false;
 
-        storage_file_seek(ctx->script->script_file, 0, true);
-
-        uint32_t line = 1;
-        while(line < SCRIPT_MAX_LINES) {
+        uint32_t op_num = 0;
+        uint32_t executed = 0;
+        while(compiled && op_num < ctx->script->ops_count && executed < SCRIPT_MAX_LINES) {
             if(ctx->script->abort) {
                 DBGS("Abort requested");
                 break;
             }
-            if(storage_file_eof(ctx->script->script_file)) {
-                break;
-            }
+            const ScriptOp* op = &ctx->script->ops[op_num];
+            line = op->line;
+
             DBG("line %lu", line);
-            if(!swd_execute_script_line(ctx->script)) {
-                success = false;
-                break;
+            if(script_funcs[op->func].func == &swd_scriptfunc_goto) {
+                op_num = op->target;
+                executed = 0;
+                continue;
             }
-            if(ctx->script->restart) {
+            ctx->script->line_pos = op->args;
+            if(!swd_execute_script_func(ctx->script, op->func)) {
+                success = false;
                 break;
             }
-            line++;
+            op_num++;
+            executed++;
         }
 
         if(ctx->script->restart) {
@@ -2170,7 +2275,7 @@ static bool swd_execute_script(AppFSM* const ctx, const char* filename) {
             DBGS("Finished");
         }
 
-        if(line >= SCRIPT_MAX_LINES) {
+        if(executed >= SCRIPT_MAX_LINES) {
             success = true;
             char text_buf[128];
 
@@ -2193,7 +2298,7 @@ static bool swd_execute_script(AppFSM* const ctx, const char* filename) {
             dialog_message_set_header(message, "SWD Probe", 16, 2, AlignLeft, AlignTop);
             dialog_message_set_icon(message, &I_app, 3, 2);
             dialog_message_set_text(message, text_buf, 3, 16, AlignLeft, AlignTop);
-            dialog_message_set_buttons(message, "Back", "Retry", NULL);
+            dialog_message_set_buttons(message, "Back", compiled ? "Retry" : NULL, NULL);
             if(dialog_message_show(ctx->dialogs, message) == DialogMessageButtonCenter) {
                 ctx->script->restart = true;
             }
@@ -2201,8 +2306,8 @@ static bool swd_execute_script(AppFSM* const ctx, const char* filename) {
         }
     } while(ctx->script->restart);
 
-    storage_file_close(ctx->script->script_file);
-    storage_file_free(ctx->script->script_file);
+    free(ctx->script->ops);
+    free(ctx->script->script_data);
 
     parent = ctx->script->parent;
     free(ctx->script);
@@ -3126,6 +3231,7 @@ int32_t swd_probe_app_main(void* p) {
     app->commandline = malloc(sizeof(ScriptContext));
     app->commandline->max_tries = 1;
     app->commandline->app = app;
+    app->commandline->text = app->commandline->line_data;
 
     DBGS("view_port_alloc");
     app->view_port = view_port_alloc();
@@ -39,10 +39,12 @@
 #define TIMEOUT 3
 #define QUEUE_SIZE 8
 #define IDLE_BITS 8
+#define SWD_WAIT_RETRIES 100
 #define CLOCK_DELAY 0
 
 #define MAX_FILE_LENGTH 128
 #define SCRIPT_MAX_LINES 1000
+#define SCRIPT_MAX_SIZE 16384
 
 typedef enum {
     ModePageScan = 0,
@@ -77,10 +79,13 @@ typedef enum {
 #define REG_EVENTSTAT_BANK 0x04
 
 #define REG_SELECT 0x02
+#define REG_RDBUFF 0x03
 
 #define MEMAP_CSW 0x00
 #define MEMAP_TAR 0x04
 #define MEMAP_DRW 0x0C
+/* TAR auto-increment is only guaranteed within a 1 KB window */
+#define MEMAP_TAR_WRAP 0x400
 #define AP_IDR 0xFC
 #define AP_BASE 0xF8
 
@@ -209,6 +214,14 @@ typedef struct {
     bool script_detected_executed;
 } AppFSM;
 
+/* one script line, compiled once when the script is loaded */
+typedef struct {
+    uint8_t func; /* index into script_funcs */
+    uint16_t line; /* line in the script file, for error messages */
+    uint16_t target; /* goto: index of the op following the label */
+    uint32_t args; /* offset of the arguments in the script text */
+} ScriptOp;
+
 struct sScriptContext {
     AppFSM* app;
     ScriptContext* parent;
@@ -216,10 +229,15 @@ struct sScriptContext {
 
     /* when used with string input */
     char line_data[128];
+
+    /* text the script helpers parse, line_data or the loaded script */
+    const char* text;
     uint64_t line_pos;
 
     /* when used with file input */
-    File* script_file;
+    char* script_data;
+    ScriptOp* ops;
+    uint32_t ops_count;
 
     uint64_t position;
     uint32_t selected_ap;
@@ -5,6 +5,8 @@
 #include <gui/icon_i.h>
 #include <gui/elements.h>
 #include <input/input.h>
+#include <storage/storage.h>
+#include <flipper_format/flipper_format.h>
 #include <stdlib.h>
 #include <stdio.h>
 
@@ -14,6 +16,9 @@
 #define DINO_START_Y 34 // 64 - 22 - BACKGROUND_H / 2 - 2
 
 #define FPS 20
+// The game advances in fixed steps, late timer ticks are caught up with several steps
+#define STEP_MS (1000 / FPS)
+#define MAX_STEPS_PER_TICK 5
 
 #define DINO_RUNNING_MS_PER_FRAME 500
 
@@ -22,8 +27,13 @@
 
 #define CACTUS_W 10
 #define CACTUS_H 10
-#define START_x_speed 35
-#define X_INCREASE 3
+#define CACTUS_SPAWN_X 120
+
+#define DIFFICULTY_FILE_NAME "difficulty.txt"
+#define DIFFICULTY_FILE_TYPE "T-Rex Runner Difficulty"
+#define DIFFICULTY_FILE_VERSION 1
+#define PATTERNS_MAX 8
+#define PATTERN_CACTI_MAX 4
 
 #define BACKGROUND_W 128
 #define BACKGROUND_H 12
@@ -38,12 +48,29 @@ typedef struct {
     InputEvent input;
 } PluginEvent;
 
+typedef struct {
+    uint8_t count;
+    uint32_t offsets[PATTERN_CACTI_MAX]; // distance of every cactus from the first, increasing
+} ObstaclePattern;
+
+typedef struct {
+    uint32_t start_speed; // px per second
+    uint32_t speed_step; // added after every cleared pattern
+    uint32_t max_speed;
+    uint32_t spawn_chance; // a pattern spawns with a chance of 1 in N steps
+    uint8_t pattern_count;
+    ObstaclePattern patterns[PATTERNS_MAX];
+} Difficulty;
+
 typedef struct {
     FuriTimer* timer;
     uint32_t last_tick;
+    uint32_t step_ticks;
+    uint32_t accumulator; // ticks not simulated yet
     const Icon* dino_icon;
     int dino_frame_ms;
     FuriMutex* mutex;
+    Difficulty difficulty;
 
     // Dino info
     float y_position;
@@ -51,29 +78,84 @@ typedef struct {
     int y_acceleration;
     float x_speed;
 
-    // Cactus info
-    int cactus_position;
-    int has_cactus;
+    // Cactus info, position of the first cactus of the pattern
+    float cactus_position;
+    const ObstaclePattern* cactus_pattern; // NULL when there are no cacti
 
     // Horizontal line
-    int background_position;
+    float background_position;
 
     int lost;
 
     int score;
 } GameState;
 
-static void timer_callback(void* ctx) {
-    GameState* game_state = ctx;
-    furi_mutex_acquire(game_state->mutex, FuriWaitForever);
+static const Difficulty default_difficulty = {
+    .start_speed = 35,
+    .speed_step = 3,
+    .max_speed = 120,
+    .spawn_chance = 30,
+    .pattern_count = 1,
+    .patterns = {{.count = 1, .offsets = {0}}},
+};
+
+static bool difficulty_read(Storage* storage, const char* path, Difficulty* difficulty) {
+    FlipperFormat* file = flipper_format_file_alloc(storage);
+    FuriString* file_type = furi_string_alloc();
+    uint32_t version = 0;
+    bool loaded = false;
+
+    do {
+        if(!flipper_format_file_open_existing(file, path)) break;
+        if(!flipper_format_read_header(file, file_type, &version)) break;
+        if(furi_string_cmp_str(file_type, DIFFICULTY_FILE_TYPE) != 0 ||
+           version != DIFFICULTY_FILE_VERSION)
+            break;
+        if(!flipper_format_read_uint32(file, "Start speed", &difficulty->start_speed, 1)) break;
+        if(!flipper_format_read_uint32(file, "Speed step", &difficulty->speed_step, 1)) break;
+        if(!flipper_format_read_uint32(file, "Max speed", &difficulty->max_speed, 1)) break;
+        if(!flipper_format_read_uint32(file, "Spawn chance", &difficulty->spawn_chance, 1)) break;
+
+        // Every "Pattern" line is one pattern
+        difficulty->pattern_count = 0;
+        uint32_t count = 0;
+        while(difficulty->pattern_count < PATTERNS_MAX &&
+              flipper_format_get_value_count(file, "Pattern", &count)) {
+            ObstaclePattern* pattern = &difficulty->patterns[difficulty->pattern_count];
+            if(count == 0 || count > PATTERN_CACTI_MAX ||
+               !flipper_format_read_uint32(file, "Pattern", pattern->offsets, count))
+                break;
+            pattern->count = count;
+            difficulty->pattern_count++;
+        }
 
-    if(game_state == NULL) {
-        return;
+        loaded = difficulty->pattern_count > 0 && difficulty->spawn_chance > 0 &&
+                 difficulty->start_speed > 0;
+    } while(false);
+
+    furi_string_free(file_type);
+    flipper_format_free(file);
+    return loaded;
+}
+
+// A file in the app data folder overrides the one shipped with the app
+static void difficulty_load(Difficulty* difficulty) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    if(!difficulty_read(storage, APP_DATA_PATH(DIFFICULTY_FILE_NAME), difficulty) &&
+       !difficulty_read(storage, APP_ASSETS_PATH(DIFFICULTY_FILE_NAME), difficulty)) {
+        FURI_LOG_W("T-rex runner", "no difficulty file, using the defaults");
+        *difficulty = default_difficulty;
     }
+    furi_record_close(RECORD_STORAGE);
+}
 
-    uint32_t ticks_elapsed = furi_get_tick() - game_state->last_tick;
-    game_state->last_tick = furi_get_tick();
-    int delta_time_ms = ticks_elapsed * 1000 / furi_kernel_get_tick_frequency();
+static float cactus_last_offset(const ObstaclePattern* pattern) {
+    return pattern->offsets[pattern->count - 1];
+}
+
+static void game_step(GameState* const game_state) {
+    const int delta_time_ms = STEP_MS;
+    const Difficulty* difficulty = &game_state->difficulty;
 
     // dino update
     game_state->dino_frame_ms += delta_time_ms;
@@ -99,39 +181,62 @@ static void timer_callback(void* ctx) {
         game_state->y_position = DINO_START_Y;
     }
 
-    // Update Cactus state
-    if(game_state->has_cactus) {
-        game_state->cactus_position =
-            game_state->cactus_position - (game_state->x_speed - 15) * delta_time_ms / 1000;
-        if(game_state->cactus_position <= 0) {
-            game_state->has_cactus = 0;
+    float distance = game_state->x_speed * delta_time_ms / 1000;
+
+    // Update Cactus state, the cacti move with the ground
+    if(game_state->cactus_pattern) {
+        game_state->cactus_position = game_state->cactus_position - distance;
+        if(game_state->cactus_position + cactus_last_offset(game_state->cactus_pattern) <=
+           -CACTUS_W) {
+            game_state->cactus_pattern = NULL;
             game_state->score = game_state->score + 1;
 
             // Increase speed
-            game_state->x_speed = game_state->x_speed + X_INCREASE;
+            game_state->x_speed = game_state->x_speed + difficulty->speed_step;
+            if(game_state->x_speed > difficulty->max_speed) {
+                game_state->x_speed = difficulty->max_speed;
+            }
         }
     }
     // Create cactus (random frame in 1.5s)
-    else {
-        uint8_t randomuint8[1];
-        furi_hal_random_fill_buf(randomuint8, 1);
-        if(randomuint8[0] % 30 == 0) {
-            game_state->has_cactus = 1;
-            game_state->cactus_position = 120;
-        }
+    else if(furi_hal_random_get() % difficulty->spawn_chance == 0) {
+        game_state->cactus_pattern =
+            &difficulty->patterns[furi_hal_random_get() % difficulty->pattern_count];
+        game_state->cactus_position = CACTUS_SPAWN_X;
     }
 
     // Move horizontal line
     if(game_state->background_position <= -BACKGROUND_W)
         game_state->background_position += BACKGROUND_W;
-    game_state->background_position =
-        game_state->background_position - game_state->x_speed * delta_time_ms / 1000;
+    game_state->background_position = game_state->background_position - distance;
 
     // Lose condition
-    if(game_state->has_cactus && ((game_state->y_position + 22 >= (64 - CACTUS_H)) &&
-                                  ((DINO_START_X + 20) >= game_state->cactus_position) &&
-                                  (DINO_START_X <= (game_state->cactus_position + CACTUS_W))))
-        game_state->lost = 1;
+    if(game_state->cactus_pattern && game_state->y_position + 22 >= (64 - CACTUS_H)) {
+        for(uint8_t i = 0; i < game_state->cactus_pattern->count; i++) {
+            float cactus_x = game_state->cactus_position + game_state->cactus_pattern->offsets[i];
+            if((DINO_START_X + 20) >= cactus_x && DINO_START_X <= (cactus_x + CACTUS_W))
+                game_state->lost = 1;
+        }
+    }
+}
+
+static void timer_callback(void* ctx) {
+    GameState* game_state = ctx;
+    furi_mutex_acquire(game_state->mutex, FuriWaitForever);
+
+    uint32_t now = furi_get_tick();
+    game_state->accumulator += now - game_state->last_tick;
+    game_state->last_tick = now;
+
+    // Drop the time we can't catch up with instead of stalling the timer thread
+    if(game_state->accumulator > game_state->step_ticks * MAX_STEPS_PER_TICK) {
+        game_state->accumulator = game_state->step_ticks * MAX_STEPS_PER_TICK;
+    }
+
+    while(game_state->accumulator >= game_state->step_ticks) {
+        game_state->accumulator -= game_state->step_ticks;
+        if(!game_state->lost) game_step(game_state);
+    }
 
     furi_mutex_release(game_state->mutex);
 }
@@ -166,13 +271,15 @@ static void render_callback(Canvas* const canvas, void* ctx) {
         canvas_draw_icon(canvas, DINO_START_X, game_state->y_position, game_state->dino_icon);
 
         // Show cactus
-        if(game_state->has_cactus)
-            //canvas_draw_triangle(canvas, game_state->cactus_position, 64 - BACKGROUND_H + CACTUS_W, CACTUS_W, CACTUS_H, CanvasDirectionBottomToTop);
-            canvas_draw_icon(
-                canvas,
-                game_state->cactus_position,
-                64 - BACKGROUND_H / 2 - CACTUS_H - 2,
-                &I_Cactus);
+        if(game_state->cactus_pattern) {
+            for(uint8_t i = 0; i < game_state->cactus_pattern->count; i++) {
+                int cactus_x =
+                    game_state->cactus_position + game_state->cactus_pattern->offsets[i];
+                if(cactus_x <= -CACTUS_W || cactus_x >= BACKGROUND_W) continue;
+                canvas_draw_icon(
+                    canvas, cactus_x, 64 - BACKGROUND_H / 2 - CACTUS_H - 2, &I_Cactus);
+            }
+        }
 
         // Show score
         if(game_state->score == 0) canvas_set_font(canvas, FontSecondary);
@@ -188,27 +295,31 @@ static void render_callback(Canvas* const canvas, void* ctx) {
 }
 
 static void game_state_init(GameState* const game_state) {
+    difficulty_load(&game_state->difficulty);
     game_state->last_tick = furi_get_tick();
+    game_state->step_ticks = furi_ms_to_ticks(STEP_MS);
+    game_state->accumulator = 0;
     game_state->dino_frame_ms = 0;
     game_state->dino_icon = &I_Dino;
     game_state->y_acceleration = game_state->y_speed = 0;
     game_state->y_position = DINO_START_Y;
-    game_state->has_cactus = 0;
+    game_state->cactus_pattern = NULL;
     game_state->background_position = 0;
     game_state->lost = 0;
-    game_state->x_speed = START_x_speed;
+    game_state->x_speed = game_state->difficulty.start_speed;
     game_state->score = 0;
     game_state->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
 }
 
 static void game_state_reinit(GameState* const game_state) {
     game_state->last_tick = furi_get_tick();
+    game_state->accumulator = 0;
     game_state->y_acceleration = game_state->y_speed = 0;
     game_state->y_position = DINO_START_Y;
-    game_state->has_cactus = 0;
+    game_state->cactus_pattern = NULL;
     game_state->background_position = 0;
     game_state->lost = 0;
-    game_state->x_speed = START_x_speed;
+    game_state->x_speed = game_state->difficulty.start_speed;
     game_state->score = 0;
 }
 
@@ -240,6 +351,7 @@ int32_t trexrunner_app() {
     PluginEvent event;
     for(bool processing = true; processing;) {
         FuriStatus event_status = furi_message_queue_get(event_queue, &event, 100);
+        furi_mutex_acquire(game_state->mutex, FuriWaitForever);
         if(event_status == FuriStatusOk) {
             // press events
             if(event.type == EventTypeKey) {
@@ -73,7 +73,9 @@ static void tama_p1_hal_sleep_until(timestamp_t ts) {
             // we're ahead or behind, otherwise around the step call we'll always have to
             // delay a tick and run more and more behind.
             furi_mutex_release(g_state_mutex);
-            furi_delay_tick(1);
+            // Whole slice in one go, the timestamp runs at TAMA_TIMESTAMP_FREQ
+            uint32_t ticks = delay / (TAMA_TIMESTAMP_FREQ / furi_kernel_get_tick_frequency());
+            furi_delay_tick(MAX(ticks, 1UL));
             while(furi_mutex_acquire(g_state_mutex, FuriWaitForever) != FuriStatusOk)
                 furi_delay_tick(1);
         } else {
@@ -105,6 +107,9 @@ static void tama_p1_hal_set_lcd_icon(u8_t icon, bool_t val) {
 }
 
 static void tama_p1_hal_play_frequency(bool_t en) {
+    // Silent while catching up
+    if(en && !g_ctx->fast_forward_done) return;
+
     if(en) {
         if(furi_hal_speaker_is_mine() || furi_hal_speaker_acquire(30)) {
             furi_hal_speaker_start(g_ctx->frequency, 0.5f);
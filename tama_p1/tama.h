@@ -8,20 +8,38 @@
 #define TAMA_SCREEN_SCALE_FACTOR 2
 #define TAMA_LCD_ICON_SIZE 14
 #define TAMA_LCD_ICON_MARGIN 1
+// TIM2 rate, the timestamp unit of the HAL
+#define TAMA_TIMESTAMP_FREQ 64000
+// Emulated time run between two sleeps of the worker (~16 ms)
+#define TAMA_RUN_SLICE (TAMA_TIMESTAMP_FREQ / 64)
+// Upper bound of instructions per slice, keeps the worker responsive if it falls behind
+#define TAMA_RUN_MAX_OPS 2048
+// E0C6S46 clock, the unit of tick_counter
+#define TAMA_TICK_FREQUENCY 32768
+// The time the app was closed is emulated on load, up to this many seconds
+#define TAMA_FAST_FORWARD_MAX (12 * 60 * 60)
+// Instructions per batch while fast forwarding, the GUI gets the state in between
+#define TAMA_FAST_FORWARD_OPS 4096
+// The ROM is read by the worker in reads of this size, so the first frame doesn't wait for it
+#define TAMA_ROM_CHUNK 1024
 
 #define STATE_FILE_MAGIC "TLST"
-#define STATE_FILE_VERSION 2
+#define STATE_FILE_VERSION 3 // 3 appends the RTC time of the save
 #define TAMA_SAVE_PATH APP_DATA_PATH("save.bin")
 
 typedef struct {
     FuriThread* thread;
     hal_t hal;
-    uint8_t* rom;
+    uint8_t* rom; // set by the worker once the ROM is loaded and the emulator ready
+    size_t rom_size; // 0 when there is no ROM
+    volatile size_t rom_loaded; // bytes read so far, for the loading screen
     // 32x16 screen, perfectly represented through uint32_t
     uint32_t framebuffer[16];
     uint8_t icons;
     bool halted;
     bool fast_forward_done;
+    uint32_t fast_forward_ticks; // emulated time to catch up with
+    uint32_t fast_forward_progress;
     bool buzzer_on;
     float frequency;
 } TamaApp;
@@ -1,12 +1,16 @@
 #include <furi.h>
 #include <furi_hal_bus.h>
+#include <furi_hal_rtc.h>
 #include <gui/gui.h>
+#include <gui/elements.h>
 #include <input/input.h>
 #include <storage/storage.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <stm32wbxx_ll_tim.h>
 #include "tamalib/tamalib.h"
 #include "tama.h"
+#include "profile.h"
 #include "compiled/assets_icons.h"
 
 TamaApp* g_ctx;
@@ -422,12 +426,32 @@ static void tama_p1_draw_callback(Canvas* const canvas, void* cb_ctx) {
     FuriMutex* const mutex = cb_ctx;
     if(furi_mutex_acquire(mutex, 25) != FuriStatusOk) return;
 
-    if(g_ctx->rom == NULL) {
+    profile_first_frame();
+
+    if(g_ctx->rom_size == 0) {
         canvas_set_font(canvas, FontPrimary);
         canvas_draw_str(canvas, 30, 30, "No ROM");
+    } else if(g_ctx->rom == NULL) {
+        canvas_set_font(canvas, FontPrimary);
+        canvas_draw_str_aligned(canvas, 64, 20, AlignCenter, AlignBottom, "Loading ROM");
+        elements_progress_bar(
+            canvas, 14, 30, 100, (float)g_ctx->rom_loaded / (float)g_ctx->rom_size);
     } else if(g_ctx->halted) {
         canvas_set_font(canvas, FontPrimary);
         canvas_draw_str(canvas, 30, 30, "Halted");
+    } else if(!g_ctx->fast_forward_done && g_ctx->fast_forward_ticks) {
+        char progress[32];
+        snprintf(
+            progress,
+            sizeof(progress),
+            "%lu / %lu min",
+            g_ctx->fast_forward_progress / TAMA_TICK_FREQUENCY / 60,
+            g_ctx->fast_forward_ticks / TAMA_TICK_FREQUENCY / 60);
+        canvas_set_font(canvas, FontPrimary);
+        canvas_draw_str_aligned(canvas, 64, 20, AlignCenter, AlignBottom, "Catching up");
+        canvas_set_font(canvas, FontSecondary);
+        canvas_draw_str_aligned(canvas, 64, 36, AlignCenter, AlignBottom, progress);
+        canvas_draw_str_aligned(canvas, 64, 60, AlignCenter, AlignBottom, "Back: skip");
     } else {
         if(in_menu) {
             // switch(layout_mode)
@@ -489,7 +513,8 @@ static void tama_p1_load_state() {
         }
 
         storage_file_read(file, &buf, 1);
-        if(buf[0] != STATE_FILE_VERSION) {
+        uint8_t version = buf[0];
+        if(version != STATE_FILE_VERSION && version != 2) {
             FURI_LOG_E(TAG, "FATAL: Unsupported version");
             error = true;
         }
@@ -570,6 +595,16 @@ static void tama_p1_load_state() {
             }
             FURI_LOG_D(TAG, "Refreshing Hardware");
             tamalib_refresh_hw();
+
+            if(version >= 3 && storage_file_read(file, &buf, 4) == 4) {
+                uint32_t saved = buf[0] | (buf[1] << 8) | (buf[2] << 16) | (buf[3] << 24);
+                uint32_t now = furi_hal_rtc_get_timestamp();
+                if(now > saved) {
+                    uint32_t elapsed = MIN(now - saved, (uint32_t)TAMA_FAST_FORWARD_MAX);
+                    g_ctx->fast_forward_ticks = elapsed * TAMA_TICK_FREQUENCY;
+                    FURI_LOG_D(TAG, "Catching up %lu s", elapsed);
+                }
+            }
         }
     }
 
@@ -681,6 +716,13 @@ static void tama_p1_save_state() {
             buf[0] = GET_IO_MEMORY(state->memory, i + MEM_IO_ADDR) & 0xF;
             offset += storage_file_write(file, &buf, 1);
         }
+
+        uint32_t timestamp = furi_hal_rtc_get_timestamp();
+        buf[0] = timestamp & 0xFF;
+        buf[1] = (timestamp >> 8) & 0xFF;
+        buf[2] = (timestamp >> 16) & 0xFF;
+        buf[3] = (timestamp >> 24) & 0xFF;
+        offset += storage_file_write(file, &buf, sizeof(buf));
     }
     storage_file_close(file);
     storage_file_free(file);
@@ -689,27 +731,101 @@ static void tama_p1_save_state() {
     FURI_LOG_D(TAG, "Finished Writing %lu", offset);
 }
 
+// Runs the emulator flat out, without sound, for the time the app was closed.
+// The state mutex is handed over between batches so the progress can be drawn
+// and Back can skip the rest (by setting fast_forward_done).
+static void tama_p1_fast_forward(FuriMutex* mutex) {
+    state_t* state = tamalib_get_state();
+    uint32_t start = *(state->tick_counter);
+
+    tamalib_set_speed(0);
+    while(!g_ctx->fast_forward_done && !furi_thread_flags_get()) {
+        tamalib_run(TAMA_FAST_FORWARD_OPS, 0);
+        g_ctx->fast_forward_progress = *(state->tick_counter) - start;
+        if(g_ctx->fast_forward_progress >= g_ctx->fast_forward_ticks) break;
+
+        furi_mutex_release(mutex);
+        furi_thread_yield();
+        while(furi_mutex_acquire(mutex, FuriWaitForever) != FuriStatusOk) furi_delay_tick(1);
+    }
+    g_ctx->fast_forward_done = true;
+    tamalib_set_speed(speed);
+    cpu_sync_ref_timestamp();
+}
+
+// Reads the ROM a chunk at a time, the app thread draws the progress meanwhile.
+// Returns NULL if the read failed or the app is closing.
+static uint8_t* tama_p1_load_rom() {
+    uint8_t* rom = malloc(g_ctx->rom_size);
+    bool loaded = false;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* rom_file = storage_file_alloc(storage);
+    if(storage_file_open(rom_file, TAMA_ROM_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        size_t read = 0;
+        while(read < g_ctx->rom_size && !furi_thread_flags_get()) {
+            size_t to_read = MIN(g_ctx->rom_size - read, (size_t)TAMA_ROM_CHUNK);
+            size_t now_read = storage_file_read(rom_file, rom + read, to_read);
+            if(now_read == 0) break;
+
+            // Reorder endianess of ROM, chunks are even so words are never split
+            for(size_t i = read; i + 1 < read + now_read; i += 2) {
+                uint8_t b = rom[i];
+                rom[i] = rom[i + 1];
+                rom[i + 1] = b & 0xF;
+            }
+            read += now_read;
+            g_ctx->rom_loaded = read;
+        }
+        loaded = read == g_ctx->rom_size;
+    }
+    storage_file_close(rom_file);
+    storage_file_free(rom_file);
+    furi_record_close(RECORD_STORAGE);
+
+    if(!loaded) {
+        free(rom);
+        return NULL;
+    }
+    return rom;
+}
+
 static int32_t tama_p1_worker(void* context) {
     bool running = true;
     FuriMutex* mutex = context;
+
+    uint8_t* rom = tama_p1_load_rom();
+    profile_phase("rom");
     while(furi_mutex_acquire(mutex, FuriWaitForever) != FuriStatusOk) furi_delay_tick(1);
+    if(rom == NULL) {
+        if(!furi_thread_flags_get()) g_ctx->rom_size = 0; // shows "No ROM"
+        furi_mutex_release(mutex);
+        return 0;
+    }
+
+    // Init TamaLIB
+    g_ctx->rom = rom;
+    tamalib_init((u12_t*)g_ctx->rom, NULL, TAMA_TIMESTAMP_FREQ);
+    tamalib_set_speed(speed);
 
     cpu_sync_ref_timestamp();
     LL_TIM_EnableCounter(TIM2);
 
     tama_p1_load_state();
+    profile_phase("state");
+    if(g_ctx->fast_forward_ticks) tama_p1_fast_forward(mutex);
+    g_ctx->fast_forward_done = true;
 
     while(running) {
         if(furi_thread_flags_get()) {
             running = false;
         } else {
-            // FURI_LOG_D(TAG, "Stepping"); // enabling this cause blank screen somehow
-            // for (int i = 0; i < 100; ++i)
-            tamalib_step(); // tamalib_mainloop();
+            tamalib_run(TAMA_RUN_MAX_OPS, TAMA_RUN_SLICE);
         }
     }
     LL_TIM_DisableCounter(TIM2);
     furi_mutex_release(mutex);
+    profile_thread_exit("emulator");
     return 0;
 }
 
@@ -718,38 +834,16 @@ static void tama_p1_init(TamaApp* const ctx) {
     memset(ctx, 0, sizeof(TamaApp));
     tama_p1_hal_init(&ctx->hal);
 
-    // Load ROM
+    // The ROM itself is loaded by the worker, only its size is needed here
     Storage* storage = furi_record_open(RECORD_STORAGE);
     storage_common_migrate(storage, EXT_PATH("tama_p1"), STORAGE_APP_DATA_PATH_PREFIX);
     FileInfo fi;
-    if(storage_common_stat(storage, TAMA_ROM_PATH, &fi) == FSE_OK) {
-        File* rom_file = storage_file_alloc(storage);
-        if(storage_file_open(rom_file, TAMA_ROM_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
-            ctx->rom = malloc((size_t)fi.size);
-            uint8_t* buf_ptr = ctx->rom;
-            size_t read = 0;
-            while(read < fi.size) {
-                size_t to_read = fi.size - read;
-                if(to_read > UINT16_MAX) to_read = UINT16_MAX;
-                uint16_t now_read = storage_file_read(rom_file, buf_ptr, (uint16_t)to_read);
-                read += now_read;
-                buf_ptr += now_read;
-            }
-
-            // Reorder endianess of ROM
-            for(size_t i = 0; i < fi.size; i += 2) {
-                uint8_t b = ctx->rom[i];
-                ctx->rom[i] = ctx->rom[i + 1];
-                ctx->rom[i + 1] = b & 0xF;
-            }
-        }
-
-        storage_file_close(rom_file);
-        storage_file_free(rom_file);
+    if(storage_common_stat(storage, TAMA_ROM_PATH, &fi) == FSE_OK && fi.size > 0) {
+        ctx->rom_size = (size_t)fi.size;
     }
     furi_record_close(RECORD_STORAGE);
 
-    if(ctx->rom != NULL) {
+    if(ctx->rom_size != 0) {
         // Init TIM2
         // 64KHz
 
@@ -765,15 +859,9 @@ static void tama_p1_init(TamaApp* const ctx) {
         LL_TIM_DisableCounter(TIM2);
         LL_TIM_SetCounter(TIM2, 0);
 
-        // Init TamaLIB
         tamalib_register_hal(&ctx->hal);
-        tamalib_init((u12_t*)ctx->rom, NULL, 64000);
-        tamalib_set_speed(speed);
-
-        // TODO: implement fast forwarding
-        // ctx->fast_forward_done = true;
 
-        // Start stepping thread
+        // Start loading and stepping thread
         ctx->thread = furi_thread_alloc();
         furi_thread_set_name(ctx->thread, "TamaLIB");
         furi_thread_set_stack_size(ctx->thread, 2 * 1024);
@@ -786,18 +874,22 @@ static void tama_p1_init(TamaApp* const ctx) {
 static void tama_p1_deinit(TamaApp* const ctx) {
     if(ctx->rom != NULL) {
         tamalib_release();
+        free(ctx->rom);
+    }
+    if(ctx->thread != NULL) {
         furi_thread_free(ctx->thread);
         furi_hal_bus_disable(FuriHalBusTIM2);
-        free(ctx->rom);
     }
 }
 
 int32_t tama_p1_app(void* p) {
     UNUSED(p);
 
+    profile_start(); // "profile" CLI command in debug builds
     TamaApp* ctx = malloc(sizeof(TamaApp));
     g_state_mutex = furi_mutex_alloc(FuriMutexTypeRecursive);
     tama_p1_init(ctx);
+    profile_phase("init");
 
     FuriMessageQueue* event_queue = furi_message_queue_alloc(8, sizeof(TamaEvent));
 
@@ -835,7 +927,17 @@ int32_t tama_p1_app(void* p) {
                 // InputType input_type = event.input.type; // idk why this is a variable
                 btn_state_t tama_btn_state = 0; // BTN_STATE_RELEASED is 0
 
-                if(in_menu) {
+                if(ctx->rom == NULL) {
+                    // No emulator yet, or no ROM, only Back does something
+                    if(event.input.key == InputKeyBack && event.input.type == InputTypeShort) {
+                        running = false;
+                    }
+                } else if(!ctx->fast_forward_done) {
+                    // Buttons are ignored while catching up, Back skips the rest
+                    if(event.input.key == InputKeyBack && event.input.type == InputTypeShort) {
+                        ctx->fast_forward_done = true;
+                    }
+                } else if(in_menu) {
                     // if(menu_cursor >= 2 &&
                     //    (event.input.key == InputKeyUp || event.input.key == InputKeyDown)) {
                     //     tama_btn_state = BTN_STATE_RELEASED;
@@ -1175,10 +1277,11 @@ int32_t tama_p1_app(void* p) {
         //     FURI_LOG_D(TAG, "Timed out");
         // }
     }
-    if(ctx->rom != NULL) {
+    if(ctx->thread != NULL) {
         furi_thread_flags_set(furi_thread_get_id(ctx->thread), 1);
         furi_thread_join(ctx->thread);
     }
+    profile_stop();
     furi_timer_free(timer);
     view_port_enabled_set(view_port, false);
     gui_remove_view_port(gui, view_port);
@@ -20,6 +20,7 @@
 #include "cpu.h"
 #include "hw.h"
 #include "hal.h"
+#include "../profile.h"
 
 #define TICK_FREQUENCY 32768 // Hz
 
@@ -170,6 +171,9 @@ static u32_t ts_freq;
 static u8_t speed_ratio = 1;
 static timestamp_t ref_ts;
 
+static bool_t cpu_halted = 0; // waiting for an interrupt after HALT
+static bool_t defer_sleep = 0; // cpu_run() sleeps once per slice instead
+
 static state_t cpu_state = {
     .pc = &pc,
     .x = &x,
@@ -767,7 +771,13 @@ static void op_nop7_cb(u8_t arg0, u8_t arg1) {
 static void op_halt_cb(u8_t arg0, u8_t arg1) {
     UNUSED(arg0);
     UNUSED(arg1);
-    g_hal->halt();
+    if(I) {
+        /* Resumed by the next interrupt, see cpu_step() */
+        cpu_halted = 1;
+    } else {
+        /* Nothing can wake the CPU up anymore */
+        g_hal->halt();
+    }
 }
 
 static void op_inc_x_cb(u8_t arg0, u8_t arg1) {
@@ -1817,6 +1827,26 @@ static const op_t ops[] = {
     {NULL, 0, 0, 0, 0, 0, NULL},
 };
 
+/* Index in ops[] of every 12-bit OP code, the NULL entry if unknown */
+#define OP_CODE_NUM 4096
+static u8_t* op_table = NULL;
+
+static void build_op_table(void) {
+    u12_t op;
+    u8_t i;
+
+    for(op = 0; op < OP_CODE_NUM; op++) {
+        /* First match wins, like the former linear lookup */
+        for(i = 0; ops[i].log != NULL; i++) {
+            if((op & ops[i].mask) == ops[i].code) {
+                break;
+            }
+        }
+
+        op_table[op] = i;
+    }
+}
+
 static timestamp_t wait_for_cycles(timestamp_t since, u8_t cycles) {
     timestamp_t deadline;
 
@@ -1828,7 +1858,9 @@ static timestamp_t wait_for_cycles(timestamp_t since, u8_t cycles) {
     }
 
     deadline = since + (cycles * ts_freq) / (TICK_FREQUENCY * speed_ratio);
-    g_hal->sleep_until(deadline);
+    if(!defer_sleep) {
+        g_hal->sleep_until(deadline);
+    }
 
     return deadline;
 }
@@ -1851,6 +1883,7 @@ static void process_interrupts(void) {
 
             ref_ts = wait_for_cycles(ref_ts, 12);
             interrupts[i].triggered = 0;
+            cpu_halted = 0;
         }
     }
 }
@@ -1915,6 +1948,7 @@ void cpu_reset(void) {
     y = 0; // undef
     sp = 0; // undef
     flags = 0;
+    cpu_halted = 0;
 
     /* Init RAM to zeros */
     for(i = 0; i < MEM_BUFFER_SIZE; i++) {
@@ -1933,12 +1967,35 @@ bool_t cpu_init(const u12_t* program, breakpoint_t* breakpoints, u32_t freq) {
     g_breakpoints = breakpoints;
     ts_freq = freq;
 
+    if(op_table == NULL) {
+        op_table = (u8_t*)g_hal->malloc(OP_CODE_NUM);
+        if(!op_table) {
+            g_hal->log(LOG_ERROR, "Cannot allocate memory for the OP code table!\n");
+            return 1;
+        }
+
+        build_op_table();
+    }
+
     cpu_reset();
 
     return 0;
 }
 
 void cpu_release(void) {
+    g_hal->free(op_table);
+    op_table = NULL;
+}
+
+/* Ticks until the next timer event, at most one 256 Hz period */
+static u8_t halt_cycles(void) {
+    u32_t cycles = TIMER_1HZ_PERIOD - (tick_counter - clk_timer_timestamp);
+
+    if(prog_timer_enabled) {
+        cycles = MIN(cycles, TIMER_256HZ_PERIOD - (tick_counter - prog_timer_timestamp));
+    }
+
+    return MAX(MIN(cycles, TIMER_256HZ_PERIOD), 1);
 }
 
 int cpu_step(void) {
@@ -1947,51 +2004,54 @@ int cpu_step(void) {
     breakpoint_t* bp = g_breakpoints;
     static u8_t previous_cycles = 0;
 
-    op = g_program[pc];
-
-    /* Lookup the OP code */
-    for(i = 0; ops[i].log != NULL; i++) {
-        if((op & ops[i].mask) == ops[i].code) {
-            break;
-        }
-    }
+    if(cpu_halted) {
+        /* Skip the idle time up to the next timer event in one go */
+        ref_ts = wait_for_cycles(ref_ts, previous_cycles);
+        previous_cycles = halt_cycles();
+        i = 1; // not a PSET
+    } else {
+        op = g_program[pc];
 
-    if(ops[i].log == NULL) {
-        g_hal->log(LOG_ERROR, "Unknown op-code 0x%X (pc = 0x%04X)\n", op, pc);
-        return 1;
-    }
+        /* Lookup the OP code */
+        i = op_table[op & (OP_CODE_NUM - 1)];
 
-    next_pc = (pc + 1) & 0x1FFF;
+        if(ops[i].log == NULL) {
+            g_hal->log(LOG_ERROR, "Unknown op-code 0x%X (pc = 0x%04X)\n", op, pc);
+            return 1;
+        }
 
-    /* Display the operation along with the current state of the processor */
-    print_state(i, op, pc);
-
-    /* Match the speed of the real processor
-	 * NOTE: For better accuracy, the final wait should happen here, however
-	 * the downside is that all interrupts will likely be delayed by one OP
-	 */
-    ref_ts = wait_for_cycles(ref_ts, previous_cycles);
-
-    /* Process the OP code */
-    if(ops[i].cb != NULL) {
-        if(ops[i].mask_arg0 != 0) {
-            /* Two arguments */
-            ops[i].cb(
-                (op & ops[i].mask_arg0) >> ops[i].shift_arg0,
-                op & ~(ops[i].mask | ops[i].mask_arg0));
-        } else {
-            /* One arguments */
-            ops[i].cb((op & ~ops[i].mask) >> ops[i].shift_arg0, 0);
+        next_pc = (pc + 1) & 0x1FFF;
+
+        /* Display the operation along with the current state of the processor */
+        print_state(i, op, pc);
+
+        /* Match the speed of the real processor
+         * NOTE: For better accuracy, the final wait should happen here, however
+         * the downside is that all interrupts will likely be delayed by one OP
+         */
+        ref_ts = wait_for_cycles(ref_ts, previous_cycles);
+
+        /* Process the OP code */
+        if(ops[i].cb != NULL) {
+            if(ops[i].mask_arg0 != 0) {
+                /* Two arguments */
+                ops[i].cb(
+                    (op & ops[i].mask_arg0) >> ops[i].shift_arg0,
+                    op & ~(ops[i].mask | ops[i].mask_arg0));
+            } else {
+                /* One arguments */
+                ops[i].cb((op & ~ops[i].mask) >> ops[i].shift_arg0, 0);
+            }
         }
-    }
 
-    /* Prepare for the next instruction */
-    pc = next_pc;
-    previous_cycles = ops[i].cycles;
+        /* Prepare for the next instruction */
+        pc = next_pc;
+        previous_cycles = ops[i].cycles;
 
-    if(i > 0) {
-        /* OP code is not PSET, reset NP */
-        np = (pc >> 8) & 0x1F;
+        if(i > 0) {
+            /* OP code is not PSET, reset NP */
+            np = (pc >> 8) & 0x1F;
+        }
     }
 
     /* Handle timers using the internal tick counter */
@@ -2031,3 +2091,26 @@ int cpu_step(void) {
 
     return 0;
 }
+
+int cpu_run(u32_t max_ops, timestamp_t slice) {
+    int res = 0;
+
+    defer_sleep = 1;
+    while(max_ops-- && !res) {
+        PROFILE_BEGIN(cpu_step);
+        res = cpu_step();
+        PROFILE_END(cpu_step);
+
+        /* Stop once the emulation is a full slice ahead of the host */
+        if(speed_ratio != 0 && (int32_t)(ref_ts - g_hal->get_timestamp()) >= (int32_t)slice) {
+            break;
+        }
+    }
+    defer_sleep = 0;
+
+    if(speed_ratio != 0) {
+        g_hal->sleep_until(ref_ts);
+    }
+
+    return res;
+}
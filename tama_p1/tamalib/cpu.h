@@ -211,5 +211,11 @@ bool_t cpu_init(const u12_t* program, breakpoint_t* breakpoints, u32_t freq);
 void cpu_release(void);
 
 int cpu_step(void);
+/* Executes up to max_ops instructions without sleeping, stops once the emulated time
+ * is slice ahead of the host, then sleeps once until it is reached.
+ * At speed 0 (as fast as possible) the slice is ignored.
+ * Returns 1 if a breakpoint was hit.
+ */
+int cpu_run(u32_t max_ops, timestamp_t slice);
 
 #endif /* _CPU_H_ */
@@ -112,6 +112,18 @@ void tamalib_step(void) {
     }
 }
 
+void tamalib_run(u32_t max_ops, timestamp_t slice) {
+    if(exec_mode != EXEC_MODE_RUN) {
+        tamalib_step();
+        return;
+    }
+
+    if(cpu_run(max_ops, slice)) {
+        exec_mode = EXEC_MODE_PAUSE;
+        step_depth = cpu_get_depth();
+    }
+}
+
 void tamalib_mainloop(void) {
     timestamp_t ts;
 
@@ -62,4 +62,9 @@ void tamalib_set_exec_mode(exec_mode_t mode);
 void tamalib_step(void);
 void tamalib_mainloop(void);
 
+/* Same as tamalib_step(), but runs up to max_ops instructions per call and sleeps
+ * once per time slice instead of after every instruction (EXEC_MODE_RUN only).
+ */
+void tamalib_run(u32_t max_ops, timestamp_t slice);
+
 #endif /* _TAMALIB_H_ */
@@ -40,6 +40,7 @@ static void say_something(char* something) {
     if(furi_hal_speaker_is_mine() || furi_hal_speaker_acquire(1000)) {
         voice.begin();
         voice.say(something);
+        voice.end();
         furi_hal_speaker_release();
     }
 }
@@ -33,6 +33,8 @@ unsigned char phonemeLengthOutput[60]; //tab47416
 
 // contains the soundbuffer position
 int bufferpos;
+// time owed to the DMA output since the last emitted sample, see Output8BitAry()
+uint32_t outputTime;
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 //
@@ -2425,22 +2427,17 @@ void STM32SAM::Output8BitAry(int index, unsigned char ary[5]) {
 
     int sample_uS = bufferpos - bufferposOld;
 
-    uint32_t f = 0;
+    // each value lasts sample_uS / (_STM32SAM_SPEED + 1) microseconds, hold it for as many
+    // samples of the fixed DMA rate as that covers, carrying the remainder to the next one
+    uint32_t sample_unit = 1000000UL * (_STM32SAM_SPEED + 1);
 
-    // write a little bit in advance
     for(k = 0; k < 5; k++) {
-        //   buffer[bufferpos / 50 + k] = ary[k];
-
-        // f = micros() + sample_uS / (_STM32SAM_SPEED + 1);
-        // while(micros() < f) {
-        // };
-        f = sample_uS / (_STM32SAM_SPEED + 1);
-        furi_delay_us(f);
-        SetAUDIO(ary[k]);
-        //  delayMicroseconds(sample_uS / 5 );
+        outputTime += sample_uS * SAM_SAMPLE_RATE;
+        while(outputTime >= sample_unit) {
+            outputTime -= sample_unit;
+            PushSample(ary[k]);
+        }
     }
-
-    //  SetAUDIO(ary[0]);
 }
 
 void STM32SAM::Output8Bit(int index, unsigned char A) {
@@ -3551,11 +3548,16 @@ int STM32SAM::SAMMain() {
 
     //mem[40158] = 255;
 
-    PrepareOutput();
-
     return 1;
 }
 
+// render the phonemes left by SAMMain() or CacheLoad() to the current output
+void STM32SAM::Speak() {
+    OutputStart();
+    PrepareOutput();
+    OutputStop();
+}
+
 //void Code48547()
 void STM32SAM::PrepareOutput() {
     A = 0;
@@ -5337,6 +5339,11 @@ void STM32SAM::sam(
     mouth = _mouth;
     throat = _throat;
 
+    if(CacheLoad(argv)) {
+        Speak();
+        return;
+    }
+
     int i;
 
     for(i = 0; i < 256; i++) {
@@ -5365,6 +5372,9 @@ void STM32SAM::sam(
     if(!SAMMain()) {
         return;
     }
+
+    CacheStore(argv);
+    Speak();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -5388,6 +5398,11 @@ void STM32SAM::sam(
     mouth = _mouth;
     throat = _throat;
 
+    if(CacheLoad(argv)) {
+        Speak();
+        return;
+    }
+
     int i;
 
     for(i = 0; i < 256; i++) {
@@ -5415,6 +5430,9 @@ void STM32SAM::sam(
     if(!SAMMain()) {
         return;
     }
+
+    CacheStore(argv);
+    Speak();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -5615,6 +5633,201 @@ void STM32SAM::setMouth(unsigned char _mouth /* = 128 */) {
 void STM32SAM::setThroat(unsigned char _throat /* = 128 */) {
     throat = _throat;
 }
+////////////////////////////////////////////////////////////////////////////////////////////
+//
+//           STM32SAM setOutput, renderBuffer, renderWav (render without the speaker)
+//
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <storage/storage.h>
+
+#define SAM_OUTPUT_BLOCK_SIZE 256
+
+// while set, samples go to the callback in blocks instead of the speaker DMA
+static STM32SAMOutputCallback samOutputCallback = NULL;
+static void* samOutputContext = NULL;
+static unsigned char samOutputBlock[SAM_OUTPUT_BLOCK_SIZE];
+static size_t samOutputBlockCount;
+
+void STM32SAM::setOutput(STM32SAMOutputCallback callback, void* context) {
+    samOutputCallback = callback;
+    samOutputContext = context;
+}
+
+void STM32SAM::OutputFlush() {
+    if(samOutputBlockCount) {
+        samOutputCallback(samOutputBlock, samOutputBlockCount, samOutputContext);
+        samOutputBlockCount = 0;
+    }
+}
+
+typedef struct {
+    unsigned char* buffer;
+    size_t size;
+    size_t count;
+} SamRenderBuffer;
+
+static void sam_render_buffer_callback(const unsigned char* samples, size_t count, void* context) {
+    SamRenderBuffer* render = (SamRenderBuffer*)context;
+    if(count > render->size - render->count) count = render->size - render->count;
+    memcpy(render->buffer + render->count, samples, count);
+    render->count += count;
+}
+
+size_t STM32SAM::renderBuffer(const char* argv, unsigned char* buffer, size_t size) {
+    SamRenderBuffer render = {buffer, size, 0};
+    setOutput(sam_render_buffer_callback, &render);
+    say(argv);
+    setOutput(NULL, NULL);
+    return render.count;
+}
+
+typedef struct {
+    File* file;
+    uint32_t size;
+    bool error;
+} SamRenderWav;
+
+static void sam_render_wav_callback(const unsigned char* samples, size_t count, void* context) {
+    SamRenderWav* render = (SamRenderWav*)context;
+    if(render->error) return;
+    if(storage_file_write(render->file, samples, count) != count) render->error = true;
+    render->size += count;
+}
+
+// 8 bit PCM is unsigned in WAV, which is what SAM renders
+static bool sam_render_wav_header(File* file, uint32_t data_size) {
+    uint8_t header[44];
+    uint32_t riff_size = data_size + 36;
+    uint32_t fmt_size = 16;
+    uint16_t format = 1;
+    uint16_t channels = 1;
+    uint32_t sample_rate = SAM_SAMPLE_RATE;
+    uint32_t byte_rate = SAM_SAMPLE_RATE;
+    uint16_t block_align = 1;
+    uint16_t bits_per_sample = 8;
+
+    memcpy(&header[0], "RIFF", 4);
+    memcpy(&header[4], &riff_size, 4);
+    memcpy(&header[8], "WAVEfmt ", 8);
+    memcpy(&header[16], &fmt_size, 4);
+    memcpy(&header[20], &format, 2);
+    memcpy(&header[22], &channels, 2);
+    memcpy(&header[24], &sample_rate, 4);
+    memcpy(&header[28], &byte_rate, 4);
+    memcpy(&header[32], &block_align, 2);
+    memcpy(&header[34], &bits_per_sample, 2);
+    memcpy(&header[36], "data", 4);
+    memcpy(&header[40], &data_size, 4);
+
+    if(!storage_file_seek(file, 0, true)) return false;
+    return storage_file_write(file, header, sizeof(header)) == sizeof(header);
+}
+
+bool STM32SAM::renderWav(const char* argv, const char* path) {
+    Storage* storage = (Storage*)furi_record_open(RECORD_STORAGE);
+    SamRenderWav render = {storage_file_alloc(storage), 0, false};
+
+    bool success = false;
+    do {
+        if(!storage_file_open(render.file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) break;
+        // placeholder until the length is known
+        if(!sam_render_wav_header(render.file, 0)) break;
+
+        setOutput(sam_render_wav_callback, &render);
+        say(argv);
+        setOutput(NULL, NULL);
+
+        if(render.error) break;
+        if(!sam_render_wav_header(render.file, render.size)) break;
+        success = true;
+    } while(0);
+
+    storage_file_close(render.file);
+    storage_file_free(render.file);
+    furi_record_close(RECORD_STORAGE);
+    return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+//
+//           STM32SAM setCacheSize (phrase cache)
+//
+////////////////////////////////////////////////////////////////////////////////////////////
+
+// Phonemes as left by SAMMain(), right before PrepareOutput() splits them up for Render(),
+// so a cached phrase skips TextToPhonemes() and the whole parser pipeline.
+struct SamCacheEntry {
+    char text[256 + 1];
+    unsigned char phonetic;
+    unsigned char singmode;
+    unsigned char pitch;
+    unsigned char speed;
+    unsigned char mouth;
+    unsigned char throat;
+    unsigned char phonemeindex[256];
+    unsigned char phonemeLength[256];
+    unsigned char stress[256];
+    uint32_t lastUsed; // 0 marks a free entry
+};
+
+static SamCacheEntry* samCache = NULL;
+static unsigned char samCacheSize = 0;
+static uint32_t samCacheClock = 0;
+
+void STM32SAM::setCacheSize(unsigned char entries) {
+    free(samCache);
+    samCache = NULL;
+    samCacheSize = entries;
+    if(entries) samCache = (SamCacheEntry*)malloc(sizeof(SamCacheEntry) * entries);
+}
+
+SamCacheEntry* STM32SAM::CacheFind(const char* argv) {
+    for(unsigned char i = 0; i < samCacheSize; i++) {
+        SamCacheEntry* entry = &samCache[i];
+        if(entry->lastUsed && entry->phonetic == phonetic && entry->singmode == singmode &&
+           entry->pitch == pitch && entry->speed == speed && entry->mouth == mouth &&
+           entry->throat == throat && strncmp(entry->text, argv, 256) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+bool STM32SAM::CacheLoad(const char* argv) {
+    SamCacheEntry* entry = CacheFind(argv);
+    if(!entry) return false;
+
+    Init();
+    memcpy(phonemeindex, entry->phonemeindex, 256);
+    memcpy(phonemeLength, entry->phonemeLength, 256);
+    memcpy(stress, entry->stress, 256);
+    entry->lastUsed = ++samCacheClock;
+    return true;
+}
+
+void STM32SAM::CacheStore(const char* argv) {
+    if(!samCacheSize || CacheFind(argv)) return;
+
+    SamCacheEntry* entry = &samCache[0];
+    for(unsigned char i = 1; i < samCacheSize; i++) {
+        if(samCache[i].lastUsed < entry->lastUsed) entry = &samCache[i];
+    }
+
+    strncpy(entry->text, argv, 256);
+    entry->text[256] = 0;
+    entry->phonetic = phonetic;
+    entry->singmode = singmode;
+    entry->pitch = pitch;
+    entry->speed = speed;
+    entry->mouth = mouth;
+    entry->throat = throat;
+    memcpy(entry->phonemeindex, phonemeindex, 256);
+    memcpy(entry->phonemeLength, phonemeLength, 256);
+    memcpy(entry->stress, stress, 256);
+    entry->lastUsed = ++samCacheClock;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////
 //
 //           Hardware
@@ -5626,11 +5839,145 @@ void STM32SAM::setThroat(unsigned char _throat /* = 128 */) {
 // Set PA8 pin as PWM, at 256 timer ticks overflow (8bit resolution)
 
 #include <math.h>
+#include <furi_hal_bus.h>
+#include <furi_hal_interrupt.h>
+#include <stm32wbxx_ll_dma.h>
 #include <stm32wbxx_ll_tim.h>
 
 #define FURI_HAL_SPEAKER_TIMER TIM16
 #define FURI_HAL_SPEAKER_CHANNEL LL_TIM_CHANNEL_CH1
 
+// Samples are played by TIM2 update events copying the DMA ring buffer into the TIM16 compare
+// register, so the renderer only has to stay ahead of playback instead of timing every sample.
+// The ring is split in halves like wav_player's: the DMA plays one while the other is filled.
+
+#define SAM_SAMPLE_RATE_TIMER TIM2
+#define SAM_DMA_INSTANCE DMA1, LL_DMA_CHANNEL_1
+#define SAM_DMA_HALF_SIZE 512
+#define SAM_DMA_BUFFER_SIZE (SAM_DMA_HALF_SIZE * 2)
+#define SAM_DMA_TIMEOUT 100
+
+static uint16_t samDmaBuffer[SAM_DMA_BUFFER_SIZE];
+static uint8_t samPwmTable[256];
+static FuriSemaphore* samDmaSemaphore = NULL;
+// halves played since OutputStart(), counted by the DMA interrupt
+static volatile uint32_t samDmaHalves;
+// samples written since OutputStart()
+static uint32_t samDmaWritten;
+static bool samDmaRunning;
+
+static void sam_dma_isr(void* ctx) {
+    UNUSED(ctx);
+
+    if(LL_DMA_IsActiveFlag_HT1(DMA1)) {
+        LL_DMA_ClearFlag_HT1(DMA1);
+        samDmaHalves = samDmaHalves + 1;
+        furi_semaphore_release(samDmaSemaphore);
+    }
+
+    if(LL_DMA_IsActiveFlag_TC1(DMA1)) {
+        LL_DMA_ClearFlag_TC1(DMA1);
+        samDmaHalves = samDmaHalves + 1;
+        furi_semaphore_release(samDmaSemaphore);
+    }
+}
+
+void STM32SAM::end(void) {
+    furi_hal_interrupt_set_isr(FuriHalInterruptIdDma1Ch1, NULL, NULL);
+    furi_semaphore_free(samDmaSemaphore);
+    samDmaSemaphore = NULL;
+
+    LL_TIM_DisableCounter(SAM_SAMPLE_RATE_TIMER);
+    furi_hal_bus_disable(FuriHalBusTIM2);
+
+    LL_TIM_DisableAllOutputs(FURI_HAL_SPEAKER_TIMER);
+    LL_TIM_DisableCounter(FURI_HAL_SPEAKER_TIMER);
+} // end
+
+void STM32SAM::OutputStart(void) {
+    outputTime = 0;
+    samOutputBlockCount = 0;
+    if(samOutputCallback) return;
+
+    samDmaHalves = 0;
+    samDmaWritten = 0;
+    samDmaRunning = false;
+
+    LL_DMA_DisableChannel(SAM_DMA_INSTANCE);
+    LL_DMA_ClearFlag_HT1(DMA1);
+    LL_DMA_ClearFlag_TC1(DMA1);
+    LL_DMA_ConfigAddresses(
+        SAM_DMA_INSTANCE,
+        (uint32_t)samDmaBuffer,
+        (uint32_t) & (FURI_HAL_SPEAKER_TIMER->CCR1),
+        LL_DMA_DIRECTION_MEMORY_TO_PERIPH);
+    LL_DMA_SetDataLength(SAM_DMA_INSTANCE, SAM_DMA_BUFFER_SIZE);
+    LL_TIM_SetCounter(SAM_SAMPLE_RATE_TIMER, 0);
+
+    while(furi_semaphore_acquire(samDmaSemaphore, 0) == FuriStatusOk)
+        ;
+}
+
+void STM32SAM::OutputStop(void) {
+    if(samOutputCallback) {
+        OutputFlush();
+        return;
+    }
+    if(samDmaWritten == 0) return;
+
+    // finish the current half and queue one more of silence, so the DMA is playing silence,
+    // not stale samples, by the time it is stopped
+    do {
+        PushSample(128);
+    } while(samDmaWritten % SAM_DMA_HALF_SIZE);
+    for(int i = 0; i < SAM_DMA_HALF_SIZE; i++) {
+        PushSample(128);
+    }
+
+    if(!samDmaRunning) DmaStart();
+    while(samDmaHalves * SAM_DMA_HALF_SIZE + SAM_DMA_HALF_SIZE < samDmaWritten) {
+        if(furi_semaphore_acquire(samDmaSemaphore, SAM_DMA_TIMEOUT) != FuriStatusOk) break;
+    }
+
+    LL_TIM_DisableDMAReq_UPDATE(SAM_SAMPLE_RATE_TIMER);
+    LL_TIM_DisableCounter(SAM_SAMPLE_RATE_TIMER);
+    LL_DMA_DisableChannel(SAM_DMA_INSTANCE);
+    samDmaRunning = false;
+}
+
+void STM32SAM::DmaStart(void) {
+    LL_DMA_EnableChannel(SAM_DMA_INSTANCE);
+    LL_TIM_EnableDMAReq_UPDATE(SAM_SAMPLE_RATE_TIMER);
+    LL_TIM_EnableCounter(SAM_SAMPLE_RATE_TIMER);
+    samDmaRunning = true;
+}
+
+void STM32SAM::PushSample(unsigned char sample) {
+    if(samOutputCallback) {
+        samOutputBlock[samOutputBlockCount++] = sample;
+        if(samOutputBlockCount == SAM_OUTPUT_BLOCK_SIZE) OutputFlush();
+        return;
+    }
+
+    // both halves are filled before playback starts, after that the half being played
+    // and the one after it are off limits
+    while(samDmaWritten >= (samDmaHalves + 2) * SAM_DMA_HALF_SIZE) {
+        if(!samDmaRunning) {
+            DmaStart();
+        } else if(furi_semaphore_acquire(samDmaSemaphore, SAM_DMA_TIMEOUT) != FuriStatusOk) {
+            break;
+        }
+    }
+
+    // if rendering fell behind playback, skip ahead to the half after the one being played
+    if(samDmaWritten < samDmaHalves * SAM_DMA_HALF_SIZE) {
+        samDmaWritten = (samDmaHalves + 1) * SAM_DMA_HALF_SIZE;
+    }
+
+    samDmaBuffer[samDmaWritten % SAM_DMA_BUFFER_SIZE] = samPwmTable[sample];
+    samDmaWritten++;
+}
+
 void STM32SAM::begin(void) {
 #ifdef USE_ROGER_CORE
 
@@ -5667,37 +6014,45 @@ void STM32SAM::begin(void) {
 
     LL_TIM_EnableAllOutputs(FURI_HAL_SPEAKER_TIMER);
     LL_TIM_EnableCounter(FURI_HAL_SPEAKER_TIMER);
-} // begin
-
-inline void STM32SAM::SetAUDIO(unsigned char main_volume) {
-#ifdef USE_ROGER_CORE
-    Timer1.setCompare(TIMER_CH1, main_volume);
-#endif
 
-#ifdef USE_STM32duino_CORE
-    PWM->setCaptureCompare(1, main_volume, TICK_COMPARE_FORMAT);
-#endif
+    // soft clip curve from volume to PWM compare value, looked up per sample by PushSample()
+    for(int i = 0; i < 256; i++) {
+        float data = i;
+        data /= 255.0f;
+        data -= 0.5f;
+        data *= 4.0f;
+        data = tanhf(data);
+
+        data += 0.5f;
+        data *= 255.0f;
+
+        if(data < 0) {
+            data = 0;
+        } else if(data > 255) {
+            data = 255;
+        }
 
-    // if(main_volume > 64) {
-    //     LL_TIM_OC_SetCompareCH1(FURI_HAL_SPEAKER_TIMER, 127);
-    // } else {
-    //     LL_TIM_OC_SetCompareCH1(FURI_HAL_SPEAKER_TIMER, main_volume);
-    // }
-
-    float data = main_volume;
-    data /= 255.0f;
-    data -= 0.5f;
-    data *= 4.0f;
-    data = tanhf(data);
-
-    data += 0.5f;
-    data *= 255.0f;
-
-    if(data < 0) {
-        data = 0;
-    } else if(data > 255) {
-        data = 255;
+        samPwmTable[i] = data;
     }
 
-    LL_TIM_OC_SetCompareCH1(FURI_HAL_SPEAKER_TIMER, data);
-}
\ No newline at end of file
+    // the sample rate matches the PWM period, 64 MHz / 5 / 256
+    furi_hal_bus_enable(FuriHalBusTIM2);
+    memset(&TIM_InitStruct, 0, sizeof(LL_TIM_InitTypeDef));
+    TIM_InitStruct.Prescaler = 0;
+    TIM_InitStruct.Autoreload = 64000000 / SAM_SAMPLE_RATE - 1;
+    LL_TIM_Init(SAM_SAMPLE_RATE_TIMER, &TIM_InitStruct);
+
+    LL_DMA_SetPeriphRequest(SAM_DMA_INSTANCE, LL_DMAMUX_REQ_TIM2_UP);
+    LL_DMA_SetDataTransferDirection(SAM_DMA_INSTANCE, LL_DMA_DIRECTION_MEMORY_TO_PERIPH);
+    LL_DMA_SetChannelPriorityLevel(SAM_DMA_INSTANCE, LL_DMA_PRIORITY_VERYHIGH);
+    LL_DMA_SetMode(SAM_DMA_INSTANCE, LL_DMA_MODE_CIRCULAR);
+    LL_DMA_SetPeriphIncMode(SAM_DMA_INSTANCE, LL_DMA_PERIPH_NOINCREMENT);
+    LL_DMA_SetMemoryIncMode(SAM_DMA_INSTANCE, LL_DMA_MEMORY_INCREMENT);
+    LL_DMA_SetPeriphSize(SAM_DMA_INSTANCE, LL_DMA_PDATAALIGN_HALFWORD);
+    LL_DMA_SetMemorySize(SAM_DMA_INSTANCE, LL_DMA_MDATAALIGN_HALFWORD);
+    LL_DMA_EnableIT_TC(SAM_DMA_INSTANCE);
+    LL_DMA_EnableIT_HT(SAM_DMA_INSTANCE);
+
+    samDmaSemaphore = furi_semaphore_alloc(2, 0);
+    furi_hal_interrupt_set_isr(FuriHalInterruptIdDma1Ch1, sam_dma_isr, NULL);
+} // begin
\ No newline at end of file
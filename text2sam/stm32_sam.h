@@ -5,12 +5,21 @@
 
 // SAM Text-To-Speech (TTS), ported from https://github.com/s-macke/SAM
 
+// rate the rendered speech is played at by the speaker DMA
+#define SAM_SAMPLE_RATE 50000
+
+// receives rendered 8 bit unsigned samples at SAM_SAMPLE_RATE, see STM32SAM::setOutput()
+typedef void (*STM32SAMOutputCallback)(const unsigned char* samples, size_t count, void* context);
+
+struct SamCacheEntry;
+
 class STM32SAM {
 public:
     STM32SAM(uint32_t STM32SAM_SPEED);
     STM32SAM();
 
     void begin(void);
+    void end(void);
 
     void
         sam(const char* argv,
@@ -47,8 +56,24 @@ public:
     void setMouth(unsigned char _mouth = 128);
     void setThroat(unsigned char _throat = 128);
 
+    // NULL callback plays on the speaker (needs begin()), otherwise samples go to the callback
+    void setOutput(STM32SAMOutputCallback callback, void* context);
+    // render say(argv) without the speaker, return the number of samples stored
+    size_t renderBuffer(const char* argv, unsigned char* buffer, size_t size);
+    bool renderWav(const char* argv, const char* path);
+    // keep the phonemes of the last `entries` phrases, 0 disables the cache (the default)
+    void setCacheSize(unsigned char entries);
+
 private:
-    void SetAUDIO(unsigned char main_volume);
+    void OutputStart(void);
+    void OutputStop(void);
+    void DmaStart(void);
+    void PushSample(unsigned char sample);
+    void OutputFlush();
+    void Speak();
+    SamCacheEntry* CacheFind(const char* argv);
+    bool CacheLoad(const char* argv);
+    void CacheStore(const char* argv);
 
     void Output8BitAry(int index, unsigned char ary[5]);
     void Output8Bit(int index, unsigned char A);
@@ -10,6 +10,7 @@
 #include <assets_icons.h>
 
 #define CONFIG_FILE_PATH APP_DATA_PATH("timelapse.conf")
+#define PROGRESS_FILE_PATH APP_DATA_PATH("timelapse.progress")
 
 // Часть кода покрадена из https://github.com/zmactep/flipperzero-hello-world
 
@@ -21,7 +22,11 @@ bool InfiniteShot = false; // Бесконечная съёмка
 bool Bulb = false; // Режим BULB
 int32_t Backlight = 0; // Подсветка: вкл/выкл/авто
 int32_t Delay = 3; // Задержка на отскочить
+int32_t Exposure = 400; // Нажатие спуска, мс. На короткие нажатия фотик плохо реагирует
+int32_t RampTime = 0; // Интервал к последнему кадру серии, 0 - без рампы
+int32_t RampExposure = 0; // Нажатие спуска к последнему кадру серии, мс, 0 - без рампы
 bool Work = false;
+uint32_t NextShot = 0; // Тик следующего кадра, считаем от него, а не от прошлого срабатывания
 
 const NotificationSequence sequence_click = {
     &message_note_c7,
@@ -33,6 +38,7 @@ const NotificationSequence sequence_click = {
 typedef enum {
     EventTypeTick,
     EventTypeInput,
+    EventTypeShot,
 } EventType;
 
 typedef struct {
@@ -115,6 +121,76 @@ static void timer_callback(FuriMessageQueue* event_queue) {
     furi_message_queue_put(event_queue, &event, 0);
 }
 
+static void shot_timer_callback(FuriMessageQueue* event_queue) {
+    furi_assert(event_queue);
+
+    // Кадр терять нельзя, ждём место в очереди
+    ZeitrafferEvent event = {.type = EventTypeShot};
+    furi_message_queue_put(event_queue, &event, FuriWaitForever);
+}
+
+static void pulse_timer_callback(void* ctx) {
+    UNUSED(ctx);
+
+    // Отпускаем спуск без furi_delay_ms, основной цикл в это время не стоит
+    gpio_item_set_pin(4, false);
+    gpio_item_set_pin(5, false);
+}
+
+// Линейная рампа от первого кадра серии к последнему ("holy grail" день-ночь)
+static int32_t ramp(int32_t from, int32_t to, int32_t shot) {
+    if(to <= 0 || Count < 2 || InfiniteShot) return from;
+    if(shot > Count - 1) shot = Count - 1;
+    return from + (to - from) * shot / (Count - 1);
+}
+
+// Таймер кадра взводится на абсолютный дедлайн, поэтому интервалы не плывут
+static void schedule_shot(FuriTimer* shot_timer) {
+    int32_t wait = (int32_t)(NextShot - furi_get_tick());
+    if(wait < 1) wait = 1;
+    furi_timer_start(shot_timer, wait);
+}
+
+static int32_t seconds_to_shot(void) {
+    int32_t left = (int32_t)(NextShot - furi_get_tick());
+    if(left < 0) left = 0;
+    return (left + furi_ms_to_ticks(1000) - 1) / furi_ms_to_ticks(1000);
+}
+
+// Прогресс серии на карте, чтобы многочасовая съёмка пережила перезапуск
+static void progress_save(Storage* storage) {
+    FlipperFormat* save = flipper_format_file_alloc(storage);
+    if(flipper_format_file_open_always(save, PROGRESS_FILE_PATH)) {
+        flipper_format_write_header_cstr(save, "Zeitraffer progress", 1);
+        flipper_format_write_int32(save, "Count", &Count, 1);
+        flipper_format_write_int32(save, "WorkCount", &WorkCount, 1);
+        flipper_format_write_int32(save, "WorkTime", &WorkTime, 1);
+    }
+    flipper_format_free(save);
+}
+
+static void progress_load(Storage* storage) {
+    FlipperFormat* load = flipper_format_file_alloc(storage);
+    int32_t count = 0;
+    int32_t work_count = 0;
+    int32_t work_time = 0;
+    if(flipper_format_file_open_existing(load, PROGRESS_FILE_PATH) &&
+       flipper_format_read_int32(load, "Count", &count, 1) &&
+       flipper_format_read_int32(load, "WorkCount", &work_count, 1) &&
+       flipper_format_read_int32(load, "WorkTime", &work_time, 1) && count == Count &&
+       work_count > 0) {
+        // Продолжаем с паузы, по ОК
+        WorkCount = work_count;
+        WorkTime = work_time > 0 ? work_time : Delay;
+        InfiniteShot = (Count == 0);
+    }
+    flipper_format_free(load);
+}
+
+static void progress_clear(Storage* storage) {
+    storage_simply_remove(storage, PROGRESS_FILE_PATH);
+}
+
 int32_t zeitraffer_app(void* p) {
     UNUSED(p);
 
@@ -145,6 +221,10 @@ int32_t zeitraffer_app(void* p) {
     // Запускаем таймер
     //furi_timer_start(timer, 1500);
 
+    // Таймер кадра и таймер отпускания спуска
+    FuriTimer* shot_timer = furi_timer_alloc(shot_timer_callback, FuriTimerTypeOnce, event_queue);
+    FuriTimer* pulse_timer = furi_timer_alloc(pulse_timer_callback, FuriTimerTypeOnce, NULL);
+
     // Включаем нотификации
     NotificationApp* notifications = furi_record_open(RECORD_NOTIFICATION);
 
@@ -174,12 +254,20 @@ int32_t zeitraffer_app(void* p) {
             notification_message(notifications, &sequence_error);
             break;
         }
+        // Старые конфиги этих ключей не знают, оставляем по умолчанию
+        flipper_format_read_int32(load, "Exposure", &Exposure, 1);
+        flipper_format_read_int32(load, "RampTime", &RampTime, 1);
+        flipper_format_read_int32(load, "RampExposure", &RampExposure, 1);
         notification_message(notifications, &sequence_success);
 
     } while(0);
 
     flipper_format_free(load);
 
+    if(Exposure < 1) Exposure = 1;
+
+    progress_load(storage);
+
     // Бесконечный цикл обработки очереди событий
     while(1) {
         // Выбираем событие из очереди в переменную event (ждем бесконечно долго, если очередь пуста)
@@ -202,6 +290,7 @@ int32_t zeitraffer_app(void* p) {
                         } else
                             InfiniteShot = false;
 
+                        progress_clear(storage);
                         notification_message(notifications, &sequence_success);
                     }
                 }
@@ -241,7 +330,10 @@ int32_t zeitraffer_app(void* p) {
                     if(furi_timer_is_running(timer)) {
                         notification_message(notifications, &sequence_click);
                         furi_timer_stop(timer);
+                        furi_timer_stop(shot_timer);
+                        WorkTime = seconds_to_shot();
                         Work = false;
+                        if(!Bulb) progress_save(storage);
                     } else {
                         furi_timer_start(timer, 1000);
                         Work = true;
@@ -267,6 +359,9 @@ int32_t zeitraffer_app(void* p) {
                         } else
                             Bulb = false;
 
+                        NextShot = furi_get_tick() + furi_ms_to_ticks(WorkTime * 1000);
+                        schedule_shot(shot_timer);
+
                         notification_message(notifications, &sequence_success);
                     }
                 }
@@ -278,6 +373,7 @@ int32_t zeitraffer_app(void* p) {
                         notification_message(notifications, &sequence_error);
                     } else {
                         notification_message(notifications, &sequence_click);
+                        furi_timer_stop(pulse_timer);
                         gpio_item_set_all_pins(false);
                         furi_timer_stop(timer);
                         notification_message(
@@ -325,47 +421,56 @@ int32_t zeitraffer_app(void* p) {
             view_port_update(view_port);
         }
 
-        // Наше событие — это сработавший таймер
-        else if(event.type == EventTypeTick) {
-            WorkTime--;
-
-            if(WorkTime < 1) { // фоткаем
-                notification_message(notifications, &sequence_blink_white_100);
-                if(Bulb) {
-                    gpio_item_set_all_pins(false);
-                    WorkCount = 0;
-                } else {
-                    WorkCount--;
-                    view_port_update(view_port);
-                    notification_message(notifications, &sequence_click);
-                    // Дрыгаем ногами
-                    //gpio_item_set_all_pins(true);
-                    gpio_item_set_pin(4, true);
-                    gpio_item_set_pin(5, true);
-                    furi_delay_ms(400); // На короткие нажатия фотик плохо реагирует
-                    gpio_item_set_pin(4, false);
-                    gpio_item_set_pin(5, false);
-                    //gpio_item_set_all_pins(false);
-
-                    if(InfiniteShot) WorkCount++;
-
-                    WorkTime = Time;
-                    view_port_update(view_port);
-                }
+        // Пора делать кадр
+        else if(event.type == EventTypeShot) {
+            if(!Work) continue; // Событие от таймера, который успели поставить на паузу
+
+            notification_message(notifications, &sequence_blink_white_100);
+            if(Bulb) {
+                gpio_item_set_all_pins(false);
+                WorkCount = 0;
             } else {
-                // Отправляем нотификацию мигания синим светодиодом
-                notification_message(notifications, &sequence_blink_blue_100);
+                int32_t shot = Count - WorkCount; // Номер кадра в серии, для рампы
+                WorkCount--;
+                notification_message(notifications, &sequence_click);
+                // Дрыгаем ногами, отпустит pulse_timer
+                gpio_item_set_pin(4, true);
+                gpio_item_set_pin(5, true);
+                furi_timer_start(
+                    pulse_timer, furi_ms_to_ticks(ramp(Exposure, RampExposure, shot)));
+
+                if(InfiniteShot) WorkCount++;
+
+                if(WorkCount > 0) {
+                    NextShot += furi_ms_to_ticks(ramp(Time, RampTime, shot + 1) * 1000);
+                    schedule_shot(shot_timer);
+                    WorkTime = seconds_to_shot();
+                    progress_save(storage);
+                }
             }
 
             if(WorkCount < 1) { // закончили
                 Work = false;
-                gpio_item_set_all_pins(false);
+                // Пины кадра отпустит pulse_timer, остальные гасим сразу
+                if(!furi_timer_is_running(pulse_timer)) gpio_item_set_all_pins(false);
                 furi_timer_stop(timer);
                 notification_message(notifications, &sequence_audiovisual_alert);
                 WorkTime = 3;
                 WorkCount = 0;
+                progress_clear(storage);
             }
 
+            view_port_update(view_port);
+        }
+
+        // Наше событие — это сработавший таймер
+        else if(event.type == EventTypeTick) {
+            // Обратный отсчёт только для экрана, кадры снимает shot_timer
+            WorkTime = seconds_to_shot();
+
+            // Отправляем нотификацию мигания синим светодиодом
+            notification_message(notifications, &sequence_blink_blue_100);
+
             switch(Backlight) { // чо по подсветке?
             case 1:
                 notification_message(notifications, &sequence_display_backlight_on);
@@ -418,6 +523,18 @@ int32_t zeitraffer_app(void* p) {
             notification_message(notifications, &sequence_error);
             break;
         }
+        if(!flipper_format_write_int32(save, "Exposure", &Exposure, 1)) {
+            notification_message(notifications, &sequence_error);
+            break;
+        }
+        if(!flipper_format_write_int32(save, "RampTime", &RampTime, 1)) {
+            notification_message(notifications, &sequence_error);
+            break;
+        }
+        if(!flipper_format_write_int32(save, "RampExposure", &RampExposure, 1)) {
+            notification_message(notifications, &sequence_error);
+            break;
+        }
 
     } while(0);
 
@@ -425,8 +542,10 @@ int32_t zeitraffer_app(void* p) {
 
     furi_record_close(RECORD_STORAGE);
 
-    // Очищаем таймер
+    // Очищаем таймеры
     furi_timer_free(timer);
+    furi_timer_free(shot_timer);
+    furi_timer_free(pulse_timer);
 
     // Специальная очистка памяти, занимаемой очередью
     furi_message_queue_free(event_queue);
@@ -25,6 +25,11 @@
 #define TOTP_AUTO_LOCK_IDLE_TIMEOUT_SEC (60)
 #endif
 
+// Delay after the last user input before token changes journal is compacted. (milliseconds)
+#ifndef TOTP_JOURNAL_COMPACTION_IDLE_MS
+#define TOTP_JOURNAL_COMPACTION_IDLE_MS (10000)
+#endif
+
 // Enables\disables Bluetooth token input automation
 #ifndef TOTP_NO_BADBT_AUTOMATION
 #define TOTP_BADBT_AUTOMATION_ENABLED
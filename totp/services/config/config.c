@@ -16,6 +16,8 @@
 #define CONFIG_FILE_PATH CONFIG_FILE_DIRECTORY_PATH "/totp.conf"
 #define CONFIG_FILE_BACKUP_DIR CONFIG_FILE_DIRECTORY_PATH "/backups"
 #define CONFIG_FILE_BACKUP_BASE_PATH CONFIG_FILE_BACKUP_DIR "/totp.conf"
+#define CONFIG_FILE_COMPACT_PATH CONFIG_FILE_DIRECTORY_PATH "/totp.conf.compact"
+#define CONFIG_JOURNAL_COMPACTION_THRESHOLD (32)
 
 struct ConfigFileContext {
     /**
@@ -121,6 +123,13 @@ static bool totp_open_config_file(Storage* storage, FlipperFormat** file) {
         conf_file_exists = storage_common_stat(storage, CONFIG_FILE_PATH, NULL) == FSE_OK;
     }
 
+    if(!conf_file_exists &&
+       storage_common_stat(storage, CONFIG_FILE_COMPACT_PATH, NULL) == FSE_OK) {
+        FURI_LOG_W(LOGGING_TAG, "Restoring config file from interrupted compaction");
+        conf_file_exists =
+            storage_common_rename(storage, CONFIG_FILE_COMPACT_PATH, CONFIG_FILE_PATH) == FSE_OK;
+    }
+
     if(conf_file_exists) {
         FURI_LOG_D(LOGGING_TAG, "Config file %s found", CONFIG_FILE_PATH);
         if(!flipper_format_file_open_existing(fff_data_file, CONFIG_FILE_PATH)) {
@@ -191,9 +200,63 @@ static bool totp_open_config_file(Storage* storage, FlipperFormat** file) {
     return true;
 }
 
+/**
+ * @brief Writes all the journaled token changes into config file and discards the journal
+ * @param context config file context
+ * @return \c true if compaction succeeded; \c false otherwise
+ */
+static bool totp_config_file_compact_i(ConfigFileContext* context) {
+    if(totp_token_info_iterator_get_journal_records_count(context->token_info_iterator_context) ==
+       0) {
+        return true;
+    }
+
+    if(!totp_token_info_iterator_write_compacted(
+           context->token_info_iterator_context, CONFIG_FILE_COMPACT_PATH)) {
+        FURI_LOG_E(LOGGING_TAG, "Unable to write compacted config file");
+        storage_common_remove(context->storage, CONFIG_FILE_COMPACT_PATH);
+        return false;
+    }
+
+    totp_close_config_file(context->config_file);
+
+    // Compacted file carries a new journal generation, so the old journal is discarded
+    // on attach and is never applied twice, even if interrupted right after the rename
+    bool result = storage_common_remove(context->storage, CONFIG_FILE_PATH) == FSE_OK &&
+                  storage_common_rename(
+                      context->storage, CONFIG_FILE_COMPACT_PATH, CONFIG_FILE_PATH) == FSE_OK;
+
+    if(!totp_open_config_file(context->storage, &context->config_file)) {
+        context->config_file = NULL;
+        return false;
+    }
+
+    totp_token_info_iterator_attach_to_config_file(
+        context->token_info_iterator_context, context->config_file);
+
+    FURI_LOG_D(LOGGING_TAG, "Config journal compacted. Result: %d", result);
+    return result;
+}
+
+bool totp_config_file_compact(const PluginState* plugin_state, bool force) {
+    if(plugin_state->config_file_context == NULL) return false;
+    if(!force &&
+       totp_token_info_iterator_get_journal_records_count(
+           plugin_state->config_file_context->token_info_iterator_context) <
+           CONFIG_JOURNAL_COMPACTION_THRESHOLD) {
+        return true;
+    }
+
+    return totp_config_file_compact_i(plugin_state->config_file_context);
+}
+
 char* totp_config_file_backup(const PluginState* plugin_state) {
     if(plugin_state->config_file_context == NULL) return NULL;
 
+    if(!totp_config_file_compact_i(plugin_state->config_file_context)) {
+        return NULL;
+    }
+
     totp_close_config_file(plugin_state->config_file_context->config_file);
 
     char* result = totp_config_file_backup_i(plugin_state->config_file_context->storage);
@@ -223,6 +286,9 @@ bool totp_config_file_update_timezone_offset(const PluginState* plugin_state) {
         update_result = true;
     } while(false);
 
+    totp_token_info_iterator_rebuild_index(
+        plugin_state->config_file_context->token_info_iterator_context);
+
     return update_result;
 }
 
@@ -241,6 +307,9 @@ bool totp_config_file_update_notification_method(const PluginState* plugin_state
         update_result = true;
     } while(false);
 
+    totp_token_info_iterator_rebuild_index(
+        plugin_state->config_file_context->token_info_iterator_context);
+
     return update_result;
 }
 
@@ -265,6 +334,9 @@ bool totp_config_file_update_automation_method(const PluginState* plugin_state)
         update_result = true;
     } while(false);
 
+    totp_token_info_iterator_rebuild_index(
+        plugin_state->config_file_context->token_info_iterator_context);
+
     return update_result;
 }
 
@@ -303,6 +375,9 @@ bool totp_config_file_update_user_settings(const PluginState* plugin_state) {
         update_result = true;
     } while(false);
 
+    totp_token_info_iterator_rebuild_index(
+        plugin_state->config_file_context->token_info_iterator_context);
+
     return update_result;
 }
 
@@ -566,11 +641,15 @@ bool totp_config_file_update_crypto_signatures(const PluginState* plugin_state)
         update_result = true;
     } while(false);
 
+    totp_token_info_iterator_rebuild_index(
+        plugin_state->config_file_context->token_info_iterator_context);
+
     return update_result;
 }
 
 void totp_config_file_close(PluginState* const plugin_state) {
     if(plugin_state->config_file_context == NULL) return;
+    totp_config_file_compact_i(plugin_state->config_file_context);
     totp_token_info_iterator_free(plugin_state->config_file_context->token_info_iterator_context);
     totp_close_config_file(plugin_state->config_file_context->config_file);
     free(plugin_state->config_file_context);
@@ -582,6 +661,8 @@ void totp_config_file_reset(PluginState* const plugin_state) {
     totp_config_file_close(plugin_state);
     Storage* storage = totp_open_storage();
     storage_simply_remove(storage, CONFIG_FILE_PATH);
+    storage_simply_remove(storage, CONFIG_JOURNAL_FILE_PATH);
+    storage_simply_remove(storage, CONFIG_FILE_COMPACT_PATH);
     totp_close_storage();
 }
 
@@ -590,6 +671,11 @@ bool totp_config_file_update_encryption(
     uint8_t new_crypto_key_slot,
     const uint8_t* new_pin,
     uint8_t new_pin_length) {
+    // Token secrets are re-encrypted in config file only, so the journal is folded into it first
+    if(!totp_config_file_compact_i(plugin_state->config_file_context)) {
+        return false;
+    }
+
     FlipperFormat* config_file = plugin_state->config_file_context->config_file;
     Stream* stream = flipper_format_get_raw_stream(config_file);
     size_t original_offset = stream_tell(stream);
@@ -602,6 +688,7 @@ bool totp_config_file_update_encryption(
     }
 
     CryptoSettings old_crypto_settings = plugin_state->crypto_settings;
+    totp_secret_cache_wipe(plugin_state->secret_cache_context);
 
     memset(&plugin_state->crypto_settings.iv[0], 0, CRYPTO_IV_LENGTH);
     memset(&plugin_state->crypto_settings.salt[0], 0, CRYPTO_SALT_LENGTH);
@@ -701,6 +788,9 @@ bool totp_config_file_update_encryption(
 
     stream_seek(stream, original_offset, StreamOffsetFromStart);
 
+    totp_token_info_iterator_rebuild_index(
+        plugin_state->config_file_context->token_info_iterator_context);
+
     return result;
 }
 
@@ -20,6 +20,15 @@ typedef uint8_t TotpConfigFileUpdateResult;
  */
 char* totp_config_file_backup(const PluginState* plugin_state);
 
+/**
+ * @brief Writes journaled token changes into an application config file
+ * @param plugin_state application state
+ * @param force \c true to compact regardless of the journal size;
+ *              \c false to compact only once the journal grew big enough
+ * @return \c true if config file is up to date; \c false otherwise
+ */
+bool totp_config_file_compact(const PluginState* plugin_state, bool force);
+
 /**
  * @brief Loads basic information from an application config file into application state without loading all the tokens
  * @param plugin_state application state
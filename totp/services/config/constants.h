@@ -4,7 +4,9 @@
 
 #define CONFIG_FILE_DIRECTORY_PATH EXT_PATH("apps_data/totp")
 #define CONFIG_FILE_HEADER "Flipper TOTP plugin config file"
-#define CONFIG_FILE_ACTUAL_VERSION (10)
+#define CONFIG_FILE_ACTUAL_VERSION (11)
+#define CONFIG_JOURNAL_FILE_PATH CONFIG_FILE_DIRECTORY_PATH "/totp.conf.journal"
+#define CONFIG_JOURNAL_FILE_HEADER "Flipper TOTP plugin config journal"
 
 #define TOTP_CONFIG_KEY_TIMEZONE "Timezone"
 #define TOTP_CONFIG_KEY_TOKEN_NAME "TokenName"
@@ -15,6 +17,7 @@
 #define TOTP_CONFIG_KEY_TOKEN_AUTOMATION_FEATURES "TokenAutomationFeatures"
 #define TOTP_CONFIG_KEY_TOKEN_TYPE "TokenType"
 #define TOTP_CONFIG_KEY_TOKEN_COUNTER "TokenCounter"
+#define TOTP_CONFIG_KEY_TOKEN_PINNED "TokenPinned"
 #define TOTP_CONFIG_KEY_CRYPTO_VERIFY "Crypto"
 #define TOTP_CONFIG_KEY_SALT "Salt"
 #define TOTP_CONFIG_KEY_PINSET "PinIsSet"
@@ -24,3 +27,7 @@
 #define TOTP_CONFIG_KEY_FONT "Font"
 #define TOTP_CONFIG_KEY_CRYPTO_VERSION "CryptoVersion"
 #define TOTP_CONFIG_KEY_CRYPTO_KEY_SLOT "CryptoKeySlot"
+#define TOTP_CONFIG_KEY_JOURNAL_GENERATION "JournalGeneration"
+#define TOTP_JOURNAL_KEY_PUT "JournalPut"
+#define TOTP_JOURNAL_KEY_REMOVE "JournalRemove"
+#define TOTP_JOURNAL_KEY_MOVE "JournalMove"
@@ -113,6 +113,14 @@ bool totp_config_migrate_to_latest(
 
         flipper_format_rewind(fff_backup_data_file);
 
+        if(flipper_format_read_string(
+               fff_backup_data_file, TOTP_CONFIG_KEY_JOURNAL_GENERATION, temp_str)) {
+            flipper_format_write_string(
+                fff_data_file, TOTP_CONFIG_KEY_JOURNAL_GENERATION, temp_str);
+        }
+
+        flipper_format_rewind(fff_backup_data_file);
+
         while(true) {
             if(!flipper_format_read_string(
                    fff_backup_data_file, TOTP_CONFIG_KEY_TOKEN_NAME, temp_str)) {
@@ -202,6 +210,16 @@ bool totp_config_migrate_to_latest(
                     (const uint8_t*)&default_counter,
                     sizeof(default_counter));
             }
+
+            if(current_version > 10) {
+                flipper_format_read_string(
+                    fff_backup_data_file, TOTP_CONFIG_KEY_TOKEN_PINNED, temp_str);
+                flipper_format_write_string(fff_data_file, TOTP_CONFIG_KEY_TOKEN_PINNED, temp_str);
+            } else {
+                const bool default_pinned = false;
+                flipper_format_write_bool(
+                    fff_data_file, TOTP_CONFIG_KEY_TOKEN_PINNED, &default_pinned, 1);
+            }
         }
 
         Stream* stream = flipper_format_get_raw_stream(fff_data_file);
@@ -6,16 +6,20 @@
 #include "../../types/common.h"
 #include "../../types/crypto_settings.h"
 
-#define CONFIG_FILE_PART_FILE_PATH CONFIG_FILE_DIRECTORY_PATH "/totp.conf.part"
-#define STREAM_COPY_BUFFER_SIZE (128)
+#define TOKEN_OFFSETS_GROW_STEP (16)
+#define TOKEN_OFFSET_JOURNAL_FLAG (0x80000000)
 
 struct TokenInfoIteratorContext {
     size_t total_count;
     size_t current_index;
     size_t last_seek_offset;
-    size_t last_seek_index;
+    uint32_t* token_offsets;
+    size_t token_offsets_capacity;
     TokenInfo* current_token;
     FlipperFormat* config_file;
+    FlipperFormat* journal_file;
+    uint32_t journal_generation;
+    size_t journal_records_count;
     CryptoSettings* crypto_settings;
     Storage* storage;
 };
@@ -46,269 +50,447 @@ static bool
     return found;
 }
 
-static bool seek_to_token(size_t token_index, TokenInfoIteratorContext* context) {
-    furi_check(context != NULL && context->config_file != NULL);
-    if(token_index >= context->total_count) {
+static bool is_at_line_start_with(Stream* stream, const char* prefix, size_t prefix_length) {
+    char buffer[sizeof(TOTP_JOURNAL_KEY_REMOVE) + 1];
+    furi_check(prefix_length <= sizeof(buffer));
+    size_t buffer_read_size = stream_read(stream, (uint8_t*)&buffer[0], prefix_length);
+    if(buffer_read_size == 0 ||
+       !stream_seek(stream, -(int32_t)buffer_read_size, StreamOffsetFromCurrent)) {
         return false;
     }
 
-    Stream* stream = flipper_format_get_raw_stream(context->config_file);
-    long token_index_diff = (long)token_index - (long)context->last_seek_index;
-    size_t token_index_diff_weight = (size_t)labs(token_index_diff);
-    StreamDirection direction = token_index_diff >= 0 ? StreamDirectionForward :
-                                                        StreamDirectionBackward;
-    if(token_index_diff_weight > token_index || context->last_seek_offset == 0) {
-        context->last_seek_offset = 0;
-        context->last_seek_index = 0;
-        token_index_diff = token_index + 1;
-        direction = StreamDirectionForward;
-    } else if(token_index_diff_weight > (context->total_count - token_index - 1)) {
-        context->last_seek_offset = stream_size(stream);
-        context->last_seek_index = context->total_count - 1;
-        token_index_diff = -(long)(context->total_count - token_index);
-        direction = StreamDirectionBackward;
-    }
-
-    if(!stream_seek(stream, context->last_seek_offset, StreamOffsetFromStart)) {
-        return false;
-    }
+    return buffer_read_size == prefix_length && strncmp(buffer, prefix, prefix_length) == 0;
+}
 
-    if(token_index_diff != 0) {
-        long i = 0;
-        long i_inc = token_index_diff >= 0 ? 1 : -1;
-        do {
-            if(!flipper_format_seek_to_siblinig_token_start(stream, direction)) {
-                break;
-            }
+static bool is_at_token_start(Stream* stream) {
+    return is_at_line_start_with(
+        stream,
+        "\n" TOTP_CONFIG_KEY_TOKEN_NAME ":",
+        sizeof(TOTP_CONFIG_KEY_TOKEN_NAME) + 1);
+}
 
-            i += i_inc;
-        } while((i_inc > 0 && i < token_index_diff) || (i_inc < 0 && i > token_index_diff));
+static bool is_at_journal_record_start(Stream* stream) {
+    return is_at_line_start_with(stream, "\nJournal", sizeof("\nJournal") - 1);
+}
 
-        if((i_inc > 0 && i < token_index_diff) || (i_inc < 0 && i > token_index_diff)) {
-            context->last_seek_offset = 0;
-            FURI_LOG_D(LOGGING_TAG, "Was not able to move");
-            return false;
-        }
+static void token_offsets_ensure_capacity(TokenInfoIteratorContext* context, size_t count) {
+    if(count <= context->token_offsets_capacity) return;
+    context->token_offsets_capacity =
+        (count / TOKEN_OFFSETS_GROW_STEP + 1) * TOKEN_OFFSETS_GROW_STEP;
+    context->token_offsets =
+        realloc(context->token_offsets, context->token_offsets_capacity * sizeof(uint32_t));
+    furi_check(context->token_offsets != NULL);
+}
 
-        context->last_seek_offset = stream_tell(stream);
-        context->last_seek_index = token_index;
-    }
+static void
+    token_offsets_insert(TokenInfoIteratorContext* context, size_t index, uint32_t offset) {
+    token_offsets_ensure_capacity(context, context->total_count + 1);
+    memmove(
+        &context->token_offsets[index + 1],
+        &context->token_offsets[index],
+        (context->total_count - index) * sizeof(uint32_t));
+    context->token_offsets[index] = offset;
+    context->total_count++;
+}
 
-    return true;
+static void token_offsets_remove(TokenInfoIteratorContext* context, size_t index) {
+    context->total_count--;
+    memmove(
+        &context->token_offsets[index],
+        &context->token_offsets[index + 1],
+        (context->total_count - index) * sizeof(uint32_t));
 }
 
-static bool stream_insert_stream(Stream* dst, Stream* src) {
-    uint8_t buffer[STREAM_COPY_BUFFER_SIZE];
-    size_t buffer_read_size;
-    while((buffer_read_size = stream_read(src, buffer, sizeof(buffer))) != 0) {
-        if(!stream_insert(dst, buffer, buffer_read_size)) {
-            return false;
-        }
-    }
+static void token_offsets_move(TokenInfoIteratorContext* context, size_t index, size_t new_index) {
+    uint32_t offset = context->token_offsets[index];
+    token_offsets_remove(context, index);
+    token_offsets_insert(context, new_index, offset);
+}
 
-    return true;
+static void journal_close(TokenInfoIteratorContext* context) {
+    if(context->journal_file == NULL) return;
+    flipper_format_file_close(context->journal_file);
+    flipper_format_free(context->journal_file);
+    context->journal_file = NULL;
 }
 
-static bool ensure_stream_ends_with_lf(Stream* stream) {
-    uint8_t last_char;
-    size_t original_pos = stream_tell(stream);
-    if(!stream_seek(stream, -1, StreamOffsetFromEnd) || stream_read(stream, &last_char, 1) < 1) {
+/**
+ * @brief Opens existing journal file, a journal left from another config file generation
+ *        (e.g. after an interrupted compaction) is discarded
+ * @param context token info iterator context
+ * @return \c true if journal file is opened; \c false otherwise
+ */
+static bool journal_open_existing(TokenInfoIteratorContext* context) {
+    if(context->journal_file != NULL) return true;
+    if(storage_common_stat(context->storage, CONFIG_JOURNAL_FILE_PATH, NULL) != FSE_OK) {
         return false;
     }
 
-    const uint8_t lf = '\n';
-    if(last_char != lf && !stream_write(stream, &lf, 1)) {
+    FlipperFormat* journal_file = flipper_format_file_alloc(context->storage);
+    FuriString* temp_str = furi_string_alloc();
+    uint32_t version;
+    uint32_t generation;
+    bool valid = flipper_format_file_open_existing(journal_file, CONFIG_JOURNAL_FILE_PATH) &&
+                 flipper_format_read_header(journal_file, temp_str, &version) &&
+                 furi_string_cmp_str(temp_str, CONFIG_JOURNAL_FILE_HEADER) == 0 &&
+                 flipper_format_read_uint32(
+                     journal_file, TOTP_CONFIG_KEY_JOURNAL_GENERATION, &generation, 1) &&
+                 generation == context->journal_generation;
+    furi_string_free(temp_str);
+
+    if(!valid) {
+        FURI_LOG_W(LOGGING_TAG, "Discarding outdated config journal");
+        flipper_format_file_close(journal_file);
+        flipper_format_free(journal_file);
+        storage_common_remove(context->storage, CONFIG_JOURNAL_FILE_PATH);
         return false;
     }
 
-    if(!stream_seek(stream, original_pos, StreamOffsetFromStart)) {
+    context->journal_file = journal_file;
+    return true;
+}
+
+static bool journal_open_always(TokenInfoIteratorContext* context) {
+    if(journal_open_existing(context)) {
+        return flipper_format_seek_to_end(context->journal_file);
+    }
+
+    FlipperFormat* journal_file = flipper_format_file_alloc(context->storage);
+    if(!flipper_format_file_open_always(journal_file, CONFIG_JOURNAL_FILE_PATH) ||
+       !flipper_format_write_header_cstr(
+           journal_file, CONFIG_JOURNAL_FILE_HEADER, CONFIG_FILE_ACTUAL_VERSION) ||
+       !flipper_format_write_uint32(
+           journal_file, TOTP_CONFIG_KEY_JOURNAL_GENERATION, &context->journal_generation, 1)) {
+        flipper_format_file_close(journal_file);
+        flipper_format_free(journal_file);
         return false;
     }
 
+    context->journal_file = journal_file;
+    context->journal_records_count = 0;
     return true;
 }
 
-static bool
-    totp_token_info_iterator_save_current_token_info_changes(TokenInfoIteratorContext* context) {
-    bool is_new_token = context->current_index >= context->total_count;
-    Stream* stream = flipper_format_get_raw_stream(context->config_file);
-    if(is_new_token) {
-        if(!ensure_stream_ends_with_lf(stream) ||
-           !flipper_format_seek_to_end(context->config_file)) {
-            return false;
+static bool journal_read_record_args(
+    TokenInfoIteratorContext* context,
+    size_t record_offset,
+    const char* key,
+    uint32_t* args,
+    uint16_t args_count) {
+    Stream* stream = flipper_format_get_raw_stream(context->journal_file);
+    size_t key_length = strlen(key);
+    char prefix[sizeof(TOTP_JOURNAL_KEY_REMOVE) + 1];
+    if(key_length + 2 > sizeof(prefix)) return false;
+    prefix[0] = '\n';
+    memcpy(&prefix[1], key, key_length);
+    prefix[key_length + 1] = ':';
+
+    // Key lookup must not run past the current line into another record
+    return stream_seek(stream, record_offset, StreamOffsetFromStart) &&
+           is_at_line_start_with(stream, prefix, key_length + 2) &&
+           stream_seek(stream, 1, StreamOffsetFromCurrent) &&
+           flipper_format_read_uint32(context->journal_file, key, args, args_count);
+}
+
+/**
+ * @brief Applies all the journal records on top of config file token offsets
+ * @param context token info iterator context
+ */
+static void journal_replay(TokenInfoIteratorContext* context) {
+    context->journal_records_count = 0;
+    if(!journal_open_existing(context)) return;
+
+    Stream* stream = flipper_format_get_raw_stream(context->journal_file);
+    stream_rewind(stream);
+    while(stream_seek_to_char(stream, '\n', StreamDirectionForward)) {
+        size_t record_offset = stream_tell(stream);
+        uint32_t args[2];
+        bool applied = true;
+        if(journal_read_record_args(context, record_offset, TOTP_JOURNAL_KEY_PUT, args, 1)) {
+            // Token itself starts at the LF which ends the record line
+            applied = stream_seek(stream, record_offset + 1, StreamOffsetFromStart) &&
+                      stream_seek_to_char(stream, '\n', StreamDirectionForward) &&
+                      args[0] <= context->total_count;
+            if(applied) {
+                uint32_t token_offset = stream_tell(stream) | TOKEN_OFFSET_JOURNAL_FLAG;
+                if(args[0] == context->total_count) {
+                    token_offsets_insert(context, args[0], token_offset);
+                } else {
+                    context->token_offsets[args[0]] = token_offset;
+                }
+            }
+        } else if(journal_read_record_args(
+                      context, record_offset, TOTP_JOURNAL_KEY_REMOVE, args, 1)) {
+            applied = args[0] < context->total_count;
+            if(applied) {
+                token_offsets_remove(context, args[0]);
+            }
+        } else if(journal_read_record_args(
+                      context, record_offset, TOTP_JOURNAL_KEY_MOVE, args, 2)) {
+            applied = args[0] < context->total_count && args[1] < context->total_count;
+            if(applied) {
+                token_offsets_move(context, args[0], args[1]);
+            }
+        } else {
+            stream_seek(stream, record_offset, StreamOffsetFromStart);
+            continue;
         }
-    } else {
-        if(!seek_to_token(context->current_index, context)) {
-            return false;
+
+        if(!applied) {
+            FURI_LOG_W(LOGGING_TAG, "Skipping broken config journal record at %zu", record_offset);
         }
-    }
 
-    size_t offset_start = stream_tell(stream);
+        context->journal_records_count++;
 
-    size_t offset_end;
-    if(is_new_token) {
-        offset_end = offset_start;
-    } else if(context->current_index + 1 >= context->total_count) {
-        offset_end = stream_size(stream);
-    } else if(seek_to_token(context->current_index + 1, context)) {
-        offset_end = stream_tell(stream);
-    } else {
-        return false;
+        stream_seek(stream, record_offset, StreamOffsetFromStart);
     }
+}
 
-    FlipperFormat* temp_ff = flipper_format_file_alloc(context->storage);
-    if(!flipper_format_file_open_always(temp_ff, CONFIG_FILE_PART_FILE_PATH)) {
-        flipper_format_free(temp_ff);
-        return false;
+static void token_offsets_build(TokenInfoIteratorContext* context) {
+    Stream* stream = flipper_format_get_raw_stream(context->config_file);
+    size_t original_offset = stream_tell(stream);
+    context->total_count = 0;
+    stream_rewind(stream);
+    while(flipper_format_seek_to_siblinig_token_start(stream, StreamDirectionForward)) {
+        token_offsets_ensure_capacity(context, context->total_count + 1);
+        context->token_offsets[context->total_count] = stream_tell(stream);
+        context->total_count++;
     }
 
-    TokenInfo* token_info = context->current_token;
-    bool result = false;
+    stream_seek(stream, original_offset, StreamOffsetFromStart);
 
-    do {
-        if(!flipper_format_write_string(temp_ff, TOTP_CONFIG_KEY_TOKEN_NAME, token_info->name)) {
-            break;
-        }
+    journal_replay(context);
+}
 
-        if(!flipper_format_write_hex(
-               temp_ff,
-               TOTP_CONFIG_KEY_TOKEN_SECRET,
-               token_info->token,
-               token_info->token_length)) {
-            break;
-        }
+static void journal_generation_load(TokenInfoIteratorContext* context) {
+    Stream* stream = flipper_format_get_raw_stream(context->config_file);
+    size_t original_offset = stream_tell(stream);
+    if(!flipper_format_rewind(context->config_file) ||
+       !flipper_format_read_uint32(
+           context->config_file,
+           TOTP_CONFIG_KEY_JOURNAL_GENERATION,
+           &context->journal_generation,
+           1)) {
+        context->journal_generation = 0;
+    }
 
-        uint32_t tmp_uint32 = token_info->algo;
-        if(!flipper_format_write_uint32(temp_ff, TOTP_CONFIG_KEY_TOKEN_ALGO, &tmp_uint32, 1)) {
-            break;
-        }
+    stream_seek(stream, original_offset, StreamOffsetFromStart);
+}
 
-        tmp_uint32 = token_info->digits;
-        if(!flipper_format_write_uint32(temp_ff, TOTP_CONFIG_KEY_TOKEN_DIGITS, &tmp_uint32, 1)) {
-            break;
-        }
+static FlipperFormat* seek_to_token(size_t token_index, TokenInfoIteratorContext* context) {
+    furi_check(context != NULL && context->config_file != NULL);
+    if(token_index >= context->total_count) {
+        return NULL;
+    }
 
-        tmp_uint32 = token_info->duration;
-        if(!flipper_format_write_uint32(temp_ff, TOTP_CONFIG_KEY_TOKEN_DURATION, &tmp_uint32, 1)) {
-            break;
+    bool in_journal = context->token_offsets[token_index] & TOKEN_OFFSET_JOURNAL_FLAG;
+    FlipperFormat* token_file = in_journal ? context->journal_file : context->config_file;
+    Stream* stream = flipper_format_get_raw_stream(token_file);
+    uint32_t token_offset = context->token_offsets[token_index] & ~TOKEN_OFFSET_JOURNAL_FLAG;
+    if(!stream_seek(stream, token_offset, StreamOffsetFromStart) || !is_at_token_start(stream)) {
+        // File was changed behind the index, fall back to a single rescan
+        FURI_LOG_D(LOGGING_TAG, "Token offsets are outdated, rebuilding");
+        token_offsets_build(context);
+        if(token_index >= context->total_count) {
+            return NULL;
         }
 
-        tmp_uint32 = token_info->automation_features;
-        if(!flipper_format_write_uint32(
-               temp_ff, TOTP_CONFIG_KEY_TOKEN_AUTOMATION_FEATURES, &tmp_uint32, 1)) {
-            break;
+        in_journal = context->token_offsets[token_index] & TOKEN_OFFSET_JOURNAL_FLAG;
+        token_file = in_journal ? context->journal_file : context->config_file;
+        stream = flipper_format_get_raw_stream(token_file);
+        token_offset = context->token_offsets[token_index] & ~TOKEN_OFFSET_JOURNAL_FLAG;
+        if(!stream_seek(stream, token_offset, StreamOffsetFromStart)) {
+            return NULL;
         }
+    }
 
-        tmp_uint32 = token_info->type;
-        if(!flipper_format_write_uint32(temp_ff, TOTP_CONFIG_KEY_TOKEN_TYPE, &tmp_uint32, 1)) {
-            break;
-        }
+    if(!in_journal) {
+        context->last_seek_offset = token_offset;
+    }
 
-        if(!flipper_format_write_hex(
-               temp_ff,
-               TOTP_CONFIG_KEY_TOKEN_COUNTER,
-               (uint8_t*)&token_info->counter,
-               sizeof(token_info->counter))) {
-            break;
-        }
+    return token_file;
+}
 
-        Stream* temp_stream = flipper_format_get_raw_stream(temp_ff);
+static bool write_token_info(FlipperFormat* file, const TokenInfo* token_info) {
+    if(!flipper_format_write_string(file, TOTP_CONFIG_KEY_TOKEN_NAME, token_info->name)) {
+        return false;
+    }
 
-        if(!stream_rewind(temp_stream)) {
-            break;
-        }
+    if(!flipper_format_write_hex(
+           file, TOTP_CONFIG_KEY_TOKEN_SECRET, token_info->token, token_info->token_length)) {
+        return false;
+    }
 
-        if(!stream_seek(stream, offset_start, StreamOffsetFromStart)) {
-            break;
-        }
+    uint32_t tmp_uint32 = token_info->algo;
+    if(!flipper_format_write_uint32(file, TOTP_CONFIG_KEY_TOKEN_ALGO, &tmp_uint32, 1)) {
+        return false;
+    }
 
-        if(offset_end != offset_start && !stream_delete(stream, offset_end - offset_start)) {
-            break;
-        }
+    tmp_uint32 = token_info->digits;
+    if(!flipper_format_write_uint32(file, TOTP_CONFIG_KEY_TOKEN_DIGITS, &tmp_uint32, 1)) {
+        return false;
+    }
 
-        if(!is_new_token && !stream_write_char(stream, '\n')) {
-            break;
-        }
+    tmp_uint32 = token_info->duration;
+    if(!flipper_format_write_uint32(file, TOTP_CONFIG_KEY_TOKEN_DURATION, &tmp_uint32, 1)) {
+        return false;
+    }
 
-        if(!stream_insert_stream(stream, temp_stream)) {
-            break;
-        }
+    tmp_uint32 = token_info->automation_features;
+    if(!flipper_format_write_uint32(
+           file, TOTP_CONFIG_KEY_TOKEN_AUTOMATION_FEATURES, &tmp_uint32, 1)) {
+        return false;
+    }
 
-        if(is_new_token) {
-            context->total_count++;
-        }
+    tmp_uint32 = token_info->type;
+    if(!flipper_format_write_uint32(file, TOTP_CONFIG_KEY_TOKEN_TYPE, &tmp_uint32, 1)) {
+        return false;
+    }
 
-        result = true;
-    } while(false);
+    if(!flipper_format_write_hex(
+           file,
+           TOTP_CONFIG_KEY_TOKEN_COUNTER,
+           (uint8_t*)&token_info->counter,
+           sizeof(token_info->counter))) {
+        return false;
+    }
 
-    flipper_format_free(temp_ff);
-    storage_common_remove(context->storage, CONFIG_FILE_PART_FILE_PATH);
+    return flipper_format_write_bool(file, TOTP_CONFIG_KEY_TOKEN_PINNED, &token_info->pinned, 1);
+}
 
-    stream_seek(stream, offset_start, StreamOffsetFromStart);
-    context->last_seek_offset = offset_start;
-    context->last_seek_index = context->current_index;
+static bool
+    totp_token_info_iterator_save_current_token_info_changes(TokenInfoIteratorContext* context) {
+    if(!journal_open_always(context)) {
+        return false;
+    }
 
+    uint32_t token_index = MIN(context->current_index, context->total_count);
+    if(!flipper_format_write_uint32(
+           context->journal_file, TOTP_JOURNAL_KEY_PUT, &token_index, 1)) {
+        return false;
+    }
+
+    // Token starts at the LF which ends the record line
+    Stream* stream = flipper_format_get_raw_stream(context->journal_file);
+    uint32_t token_offset = (stream_tell(stream) - 1) | TOKEN_OFFSET_JOURNAL_FLAG;
+    if(!write_token_info(context->journal_file, context->current_token)) {
+        return false;
+    }
+
+    if(token_index == context->total_count) {
+        token_offsets_insert(context, token_index, token_offset);
+    } else {
+        context->token_offsets[token_index] = token_offset;
+    }
+
+    context->journal_records_count++;
+    return true;
+}
+
+/**
+ * @brief Copies config file header (everything before the first token) except the journal
+ *        generation, the result doesn't end with LF
+ * @param src config file stream
+ * @param dst stream to copy header to
+ * @param header_end offset of the header end in \p src
+ * @return \c true if header is copied; \c false otherwise
+ */
+static bool stream_copy_config_header(Stream* src, Stream* dst, size_t header_end) {
+    if(!stream_rewind(src)) {
+        return false;
+    }
+
+    FuriString* line = furi_string_alloc();
+    bool result = true;
+    bool first_line = true;
+    while(result && stream_tell(src) < header_end && stream_read_line(src, line)) {
+        furi_string_trim(line, "\r\n");
+        if(furi_string_empty(line) ||
+           furi_string_start_with_str(line, TOTP_CONFIG_KEY_JOURNAL_GENERATION ":")) {
+            continue;
+        }
+
+        result = (first_line || stream_write_char(dst, '\n')) &&
+                 stream_write_string(dst, line) == furi_string_size(line);
+        first_line = false;
+    }
+
+    furi_string_free(line);
     return result;
 }
 
-TokenInfoIteratorContext* totp_token_info_iterator_alloc(
-    Storage* storage,
-    FlipperFormat* config_file,
-    CryptoSettings* crypto_settings) {
-    Stream* stream = flipper_format_get_raw_stream(config_file);
-    stream_rewind(stream);
-    size_t tokens_count = 0;
-    while(true) {
-        if(!flipper_format_seek_to_siblinig_token_start(stream, StreamDirectionForward)) {
+/**
+ * @brief Copies a single token starting at the current position of \p src,
+ *        the result starts with LF and doesn't end with LF
+ * @param src config file or journal stream positioned to the token start
+ * @param dst stream to copy token to
+ * @return \c true if token is copied; \c false otherwise
+ */
+static bool stream_copy_token(Stream* src, Stream* dst) {
+    size_t token_start = stream_tell(src);
+    size_t token_end = stream_size(src);
+    while(stream_seek_to_char(src, '\n', StreamDirectionForward)) {
+        if(is_at_token_start(src) || is_at_journal_record_start(src)) {
+            token_end = stream_tell(src);
             break;
         }
+    }
 
-        tokens_count++;
+    uint8_t last_char;
+    while(token_end > token_start + 1 &&
+          stream_seek(src, token_end - 1, StreamOffsetFromStart) &&
+          stream_read(src, &last_char, 1) == 1 && (last_char == '\n' || last_char == '\r')) {
+        token_end--;
     }
 
+    size_t token_size = token_end - token_start;
+    return stream_seek(src, token_start, StreamOffsetFromStart) &&
+           stream_copy(src, dst, token_size) == token_size;
+}
+
+TokenInfoIteratorContext* totp_token_info_iterator_alloc(
+    Storage* storage,
+    FlipperFormat* config_file,
+    CryptoSettings* crypto_settings) {
     TokenInfoIteratorContext* context = malloc(sizeof(TokenInfoIteratorContext));
     furi_check(context != NULL);
 
-    context->total_count = tokens_count;
+    context->current_index = 0;
+    context->last_seek_offset = 0;
+    context->token_offsets = NULL;
+    context->token_offsets_capacity = 0;
     context->current_token = token_info_alloc();
     context->config_file = config_file;
+    context->journal_file = NULL;
+    context->journal_records_count = 0;
     context->crypto_settings = crypto_settings;
     context->storage = storage;
+    journal_generation_load(context);
+    token_offsets_build(context);
     return context;
 }
 
 void totp_token_info_iterator_free(TokenInfoIteratorContext* context) {
     if(context == NULL) return;
+    journal_close(context);
     token_info_free(context->current_token);
+    free(context->token_offsets);
     free(context);
 }
 
 bool totp_token_info_iterator_remove_current_token_info(TokenInfoIteratorContext* context) {
-    if(!seek_to_token(context->current_index, context)) {
+    if(context->current_index >= context->total_count || !journal_open_always(context)) {
         return false;
     }
 
-    Stream* stream = flipper_format_get_raw_stream(context->config_file);
-    size_t begin_offset = stream_tell(stream);
-    size_t end_offset;
-    if(!ensure_stream_ends_with_lf(stream)) {
+    uint32_t token_index = context->current_index;
+    if(!flipper_format_write_uint32(
+           context->journal_file, TOTP_JOURNAL_KEY_REMOVE, &token_index, 1)) {
         return false;
     }
 
-    if(context->current_index >= context->total_count - 1) {
-        end_offset = stream_size(stream) - 1;
-    } else if(seek_to_token(context->current_index + 1, context)) {
-        end_offset = stream_tell(stream);
-    } else {
-        return false;
-    }
-
-    if(!stream_seek(stream, begin_offset, StreamOffsetFromStart) ||
-       !stream_delete(stream, end_offset - begin_offset)) {
-        return false;
-    }
-
-    context->total_count--;
+    context->journal_records_count++;
+    token_offsets_remove(context, context->current_index);
     if(context->current_index >= context->total_count) {
         context->current_index = context->total_count - 1;
     }
@@ -321,77 +503,21 @@ bool totp_token_info_iterator_move_current_token_info(
     size_t new_index) {
     if(context->current_index == new_index) return true;
 
-    Stream* stream = flipper_format_get_raw_stream(context->config_file);
-
-    if(!ensure_stream_ends_with_lf(stream)) {
+    if(context->current_index >= context->total_count || !journal_open_always(context)) {
         return false;
     }
 
-    if(!seek_to_token(context->current_index, context)) {
+    new_index = MIN(new_index, context->total_count - 1);
+    uint32_t indexes[] = {context->current_index, new_index};
+    if(!flipper_format_write_uint32(context->journal_file, TOTP_JOURNAL_KEY_MOVE, indexes, 2)) {
         return false;
     }
 
-    size_t begin_offset = stream_tell(stream);
-    size_t end_offset;
-    if(context->current_index >= context->total_count - 1) {
-        end_offset = stream_size(stream) - 1;
-    } else if(seek_to_token(context->current_index + 1, context)) {
-        end_offset = stream_tell(stream);
-    } else {
-        return false;
-    }
-
-    Stream* temp_stream = file_stream_alloc(context->storage);
-    if(!file_stream_open(
-           temp_stream, CONFIG_FILE_PART_FILE_PATH, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS)) {
-        stream_free(temp_stream);
-        return false;
-    }
-
-    size_t moving_size = end_offset - begin_offset;
-
-    bool result = false;
-    do {
-        if(!stream_seek(stream, begin_offset, StreamOffsetFromStart)) {
-            break;
-        }
-
-        if(stream_copy(stream, temp_stream, moving_size) < moving_size) {
-            break;
-        }
-
-        if(!stream_rewind(temp_stream)) {
-            break;
-        }
-
-        if(!stream_seek(stream, begin_offset, StreamOffsetFromStart)) {
-            break;
-        }
-
-        if(!stream_delete(stream, moving_size)) {
-            break;
-        }
-
-        context->last_seek_offset = 0;
-        context->last_seek_index = 0;
-        if(new_index >= context->total_count - 1) {
-            if(!stream_seek(stream, stream_size(stream) - 1, StreamOffsetFromStart)) {
-                break;
-            }
-        } else if(!seek_to_token(new_index, context)) {
-            break;
-        }
-
-        result = stream_insert_stream(stream, temp_stream);
-    } while(false);
-
-    stream_free(temp_stream);
-    storage_common_remove(context->storage, CONFIG_FILE_PART_FILE_PATH);
-
+    context->journal_records_count++;
+    token_offsets_move(context, context->current_index, new_index);
     context->last_seek_offset = 0;
-    context->last_seek_index = 0;
 
-    return result;
+    return true;
 }
 
 TotpIteratorUpdateTokenResult totp_token_info_iterator_update_current_token(
@@ -413,11 +539,12 @@ TotpIteratorUpdateTokenResult totp_token_info_iterator_update_current_token(
 
 TotpIteratorUpdateTokenResult
     totp_token_info_iterator_current_token_inc_counter(TokenInfoIteratorContext* context) {
-    if(!seek_to_token(context->current_index, context)) {
+    FlipperFormat* token_file = seek_to_token(context->current_index, context);
+    if(token_file == NULL) {
         return TotpIteratorUpdateTokenResultFileUpdateFailed;
     }
 
-    Stream* stream = flipper_format_get_raw_stream(context->config_file);
+    Stream* stream = flipper_format_get_raw_stream(token_file);
 
     size_t offset_start = stream_tell(stream);
 
@@ -448,7 +575,7 @@ TotpIteratorUpdateTokenResult
     TotpIteratorUpdateTokenResult result = TotpIteratorUpdateTokenResultFileUpdateFailed;
     if(found && stream_seek(stream, 1, StreamOffsetFromCurrent) &&
        flipper_format_write_hex(
-           context->config_file,
+           token_file,
            TOTP_CONFIG_KEY_TOKEN_COUNTER,
            (uint8_t*)&token_info->counter,
            sizeof(token_info->counter))) {
@@ -482,22 +609,23 @@ TotpIteratorUpdateTokenResult totp_token_info_iterator_add_new_token(
 bool totp_token_info_iterator_go_to(TokenInfoIteratorContext* context, size_t token_index) {
     furi_check(context != NULL);
     context->current_index = token_index;
-    if(!seek_to_token(context->current_index, context)) {
+    FlipperFormat* token_file = seek_to_token(context->current_index, context);
+    if(token_file == NULL) {
         return false;
     }
 
-    Stream* stream = flipper_format_get_raw_stream(context->config_file);
+    Stream* stream = flipper_format_get_raw_stream(token_file);
     size_t original_offset = stream_tell(stream);
 
     if(!flipper_format_read_string(
-           context->config_file, TOTP_CONFIG_KEY_TOKEN_NAME, context->current_token->name)) {
+           token_file, TOTP_CONFIG_KEY_TOKEN_NAME, context->current_token->name)) {
         stream_seek(stream, original_offset, StreamOffsetFromStart);
         return false;
     }
 
     uint32_t secret_bytes_count;
     if(!flipper_format_get_value_count(
-           context->config_file, TOTP_CONFIG_KEY_TOKEN_SECRET, &secret_bytes_count)) {
+           token_file, TOTP_CONFIG_KEY_TOKEN_SECRET, &secret_bytes_count)) {
         secret_bytes_count = 0;
     }
     TokenInfo* tokenInfo = context->current_token;
@@ -511,7 +639,7 @@ bool totp_token_info_iterator_go_to(TokenInfoIteratorContext* context, size_t to
         FuriString* temp_str = furi_string_alloc();
 
         if(flipper_format_read_string(
-               context->config_file, TOTP_CONFIG_KEY_TOKEN_SECRET, temp_str)) {
+               token_file, TOTP_CONFIG_KEY_TOKEN_SECRET, temp_str)) {
             if(token_info_set_secret(
                    tokenInfo,
                    furi_string_get_cstr(temp_str),
@@ -543,7 +671,7 @@ bool totp_token_info_iterator_go_to(TokenInfoIteratorContext* context, size_t to
             tokenInfo->token = malloc(tokenInfo->token_length);
             furi_check(tokenInfo->token != NULL);
             if(!flipper_format_read_hex(
-                   context->config_file,
+                   token_file,
                    TOTP_CONFIG_KEY_TOKEN_SECRET,
                    tokenInfo->token,
                    tokenInfo->token_length)) {
@@ -558,45 +686,50 @@ bool totp_token_info_iterator_go_to(TokenInfoIteratorContext* context, size_t to
 
     uint32_t temp_data32;
     if(!flipper_format_read_uint32(
-           context->config_file, TOTP_CONFIG_KEY_TOKEN_ALGO, &temp_data32, 1) ||
+           token_file, TOTP_CONFIG_KEY_TOKEN_ALGO, &temp_data32, 1) ||
        !token_info_set_algo_from_int(tokenInfo, temp_data32)) {
         tokenInfo->algo = TokenHashAlgoDefault;
     }
 
     if(!flipper_format_read_uint32(
-           context->config_file, TOTP_CONFIG_KEY_TOKEN_DIGITS, &temp_data32, 1) ||
+           token_file, TOTP_CONFIG_KEY_TOKEN_DIGITS, &temp_data32, 1) ||
        !token_info_set_digits_from_int(tokenInfo, temp_data32)) {
         tokenInfo->digits = TokenDigitsCountSix;
     }
 
     if(!flipper_format_read_uint32(
-           context->config_file, TOTP_CONFIG_KEY_TOKEN_DURATION, &temp_data32, 1) ||
+           token_file, TOTP_CONFIG_KEY_TOKEN_DURATION, &temp_data32, 1) ||
        !token_info_set_duration_from_int(tokenInfo, temp_data32)) {
         tokenInfo->duration = TokenDurationDefault;
     }
 
     if(flipper_format_read_uint32(
-           context->config_file, TOTP_CONFIG_KEY_TOKEN_AUTOMATION_FEATURES, &temp_data32, 1)) {
+           token_file, TOTP_CONFIG_KEY_TOKEN_AUTOMATION_FEATURES, &temp_data32, 1)) {
         tokenInfo->automation_features = temp_data32;
     } else {
         tokenInfo->automation_features = TokenAutomationFeatureNone;
     }
 
     if(flipper_format_read_uint32(
-           context->config_file, TOTP_CONFIG_KEY_TOKEN_TYPE, &temp_data32, 1)) {
+           token_file, TOTP_CONFIG_KEY_TOKEN_TYPE, &temp_data32, 1)) {
         tokenInfo->type = temp_data32;
     } else {
         tokenInfo->type = TokenTypeTOTP;
     }
 
     if(!flipper_format_read_hex(
-           context->config_file,
+           token_file,
            TOTP_CONFIG_KEY_TOKEN_COUNTER,
            (uint8_t*)&tokenInfo->counter,
            sizeof(tokenInfo->counter))) {
         tokenInfo->counter = 0;
     }
 
+    if(!flipper_format_read_bool(
+           token_file, TOTP_CONFIG_KEY_TOKEN_PINNED, &tokenInfo->pinned, 1)) {
+        tokenInfo->pinned = false;
+    }
+
     stream_seek(stream, original_offset, StreamOffsetFromStart);
 
     if(token_update_needed && !totp_token_info_iterator_save_current_token_info_changes(context)) {
@@ -623,6 +756,69 @@ void totp_token_info_iterator_attach_to_config_file(
     TokenInfoIteratorContext* context,
     FlipperFormat* config_file) {
     context->config_file = config_file;
+    journal_close(context);
+    journal_generation_load(context);
+    token_offsets_build(context);
     Stream* stream = flipper_format_get_raw_stream(context->config_file);
     stream_seek(stream, context->last_seek_offset, StreamOffsetFromStart);
 }
+
+void totp_token_info_iterator_rebuild_index(TokenInfoIteratorContext* context) {
+    if(context == NULL) return;
+    token_offsets_build(context);
+}
+
+size_t
+    totp_token_info_iterator_get_journal_records_count(const TokenInfoIteratorContext* context) {
+    return context->journal_records_count;
+}
+
+bool totp_token_info_iterator_write_compacted(
+    TokenInfoIteratorContext* context,
+    const char* file_path) {
+    Stream* stream = flipper_format_get_raw_stream(context->config_file);
+    size_t original_offset = stream_tell(stream);
+    Stream* target_stream = file_stream_alloc(context->storage);
+    bool result = false;
+
+    do {
+        if(!file_stream_open(target_stream, file_path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+            break;
+        }
+
+        if(!stream_rewind(stream)) {
+            break;
+        }
+
+        size_t header_end =
+            flipper_format_seek_to_siblinig_token_start(stream, StreamDirectionForward) ?
+                stream_tell(stream) :
+                stream_size(stream);
+        if(!stream_copy_config_header(stream, target_stream, header_end)) {
+            break;
+        }
+
+        if(stream_write_format(
+               target_stream,
+               "\n" TOTP_CONFIG_KEY_JOURNAL_GENERATION ": %" PRIu32,
+               context->journal_generation + 1) == 0) {
+            break;
+        }
+
+        bool tokens_copied = true;
+        for(size_t i = 0; i < context->total_count && tokens_copied; i++) {
+            FlipperFormat* token_file = seek_to_token(i, context);
+            tokens_copied =
+                token_file != NULL &&
+                stream_copy_token(flipper_format_get_raw_stream(token_file), target_stream);
+        }
+
+        result = tokens_copied && stream_write_char(target_stream, '\n');
+    } while(false);
+
+    file_stream_close(target_stream);
+    stream_free(target_stream);
+    stream_seek(stream, original_offset, StreamOffsetFromStart);
+
+    return result;
+}
@@ -134,6 +134,31 @@ void totp_token_info_iterator_attach_to_config_file(
     TokenInfoIteratorContext* context,
     FlipperFormat* config_file);
 
+/**
+ * @brief Rebuilds token offsets index, must be called once config file was modified
+ *        outside of token info iterator (e.g. settings or encryption updates)
+ * @param context token info iterator context
+ */
+void totp_token_info_iterator_rebuild_index(TokenInfoIteratorContext* context);
+
+/**
+ * @brief Gets amount of token changes kept in the journal and not yet written to config file
+ * @param context token info iterator context
+ * @return amount of journal records
+ */
+size_t
+    totp_token_info_iterator_get_journal_records_count(const TokenInfoIteratorContext* context);
+
+/**
+ * @brief Writes a new config file with all the journal records applied to the given path
+ * @param context token info iterator context
+ * @param file_path path to write new config file to
+ * @return \c true if operation succeeded; \c false otherwise
+ */
+bool totp_token_info_iterator_write_compacted(
+    TokenInfoIteratorContext* context,
+    const char* file_path);
+
 #ifdef __cplusplus
 }
 #endif
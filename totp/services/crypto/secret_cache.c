@@ -0,0 +1,138 @@
+#include "secret_cache.h"
+#include <stdlib.h>
+#include <string.h>
+#include <furi/core/check.h>
+#include <furi/core/kernel.h>
+#include <furi/core/mutex.h>
+#include <memset_s.h>
+#include "crypto_facade.h"
+
+#define SECRET_CACHE_CAPACITY (8)
+
+typedef struct {
+    uint8_t* encrypted_data;
+    size_t encrypted_data_length;
+    uint8_t* decrypted_data;
+    size_t decrypted_data_length;
+    uint32_t last_used;
+} TotpSecretCacheEntry;
+
+struct TotpSecretCacheContext {
+    FuriMutex* mutex;
+    TotpSecretCacheEntry entries[SECRET_CACHE_CAPACITY];
+};
+
+static void secret_cache_entry_wipe(TotpSecretCacheEntry* entry) {
+    if(entry->decrypted_data != NULL) {
+        memset_s(
+            entry->decrypted_data,
+            entry->decrypted_data_length,
+            0,
+            entry->decrypted_data_length);
+        free(entry->decrypted_data);
+    }
+
+    if(entry->encrypted_data != NULL) {
+        free(entry->encrypted_data);
+    }
+
+    memset(entry, 0, sizeof(TotpSecretCacheEntry));
+}
+
+static TotpSecretCacheEntry* secret_cache_find(
+    TotpSecretCacheContext* context,
+    const uint8_t* encrypted_data,
+    size_t encrypted_data_length) {
+    for(uint8_t i = 0; i < SECRET_CACHE_CAPACITY; i++) {
+        TotpSecretCacheEntry* entry = &context->entries[i];
+        if(entry->encrypted_data != NULL &&
+           entry->encrypted_data_length == encrypted_data_length &&
+           memcmp(entry->encrypted_data, encrypted_data, encrypted_data_length) == 0) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+static TotpSecretCacheEntry* secret_cache_get_free_entry(TotpSecretCacheContext* context) {
+    TotpSecretCacheEntry* lru_entry = &context->entries[0];
+    for(uint8_t i = 0; i < SECRET_CACHE_CAPACITY; i++) {
+        TotpSecretCacheEntry* entry = &context->entries[i];
+        if(entry->encrypted_data == NULL) {
+            return entry;
+        }
+
+        if(entry->last_used < lru_entry->last_used) {
+            lru_entry = entry;
+        }
+    }
+
+    secret_cache_entry_wipe(lru_entry);
+    return lru_entry;
+}
+
+TotpSecretCacheContext* totp_secret_cache_alloc() {
+    TotpSecretCacheContext* context = malloc(sizeof(TotpSecretCacheContext));
+    furi_check(context != NULL);
+    memset(context, 0, sizeof(TotpSecretCacheContext));
+    context->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    return context;
+}
+
+uint8_t* totp_secret_cache_decrypt(
+    TotpSecretCacheContext* context,
+    const uint8_t* encrypted_data,
+    const size_t encrypted_data_length,
+    const CryptoSettings* crypto_settings,
+    size_t* decrypted_data_length) {
+    furi_check(context != NULL);
+    furi_check(furi_mutex_acquire(context->mutex, FuriWaitForever) == FuriStatusOk);
+
+    TotpSecretCacheEntry* entry =
+        secret_cache_find(context, encrypted_data, encrypted_data_length);
+    if(entry == NULL) {
+        size_t plain_length;
+        uint8_t* plain_data = totp_crypto_decrypt(
+            encrypted_data, encrypted_data_length, crypto_settings, &plain_length);
+        if(plain_data == NULL) {
+            furi_mutex_release(context->mutex);
+            return NULL;
+        }
+
+        entry = secret_cache_get_free_entry(context);
+        entry->encrypted_data = malloc(encrypted_data_length);
+        furi_check(entry->encrypted_data != NULL);
+        memcpy(entry->encrypted_data, encrypted_data, encrypted_data_length);
+        entry->encrypted_data_length = encrypted_data_length;
+        entry->decrypted_data = plain_data;
+        entry->decrypted_data_length = plain_length;
+    }
+
+    entry->last_used = furi_get_tick();
+
+    uint8_t* result = malloc(entry->decrypted_data_length);
+    furi_check(result != NULL);
+    memcpy(result, entry->decrypted_data, entry->decrypted_data_length);
+    *decrypted_data_length = entry->decrypted_data_length;
+
+    furi_mutex_release(context->mutex);
+    return result;
+}
+
+void totp_secret_cache_wipe(TotpSecretCacheContext* context) {
+    if(context == NULL) return;
+    furi_check(furi_mutex_acquire(context->mutex, FuriWaitForever) == FuriStatusOk);
+    for(uint8_t i = 0; i < SECRET_CACHE_CAPACITY; i++) {
+        secret_cache_entry_wipe(&context->entries[i]);
+    }
+
+    furi_mutex_release(context->mutex);
+}
+
+void totp_secret_cache_free(TotpSecretCacheContext* context) {
+    if(context == NULL) return;
+    totp_secret_cache_wipe(context);
+    furi_mutex_free(context->mutex);
+    free(context);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "../../types/crypto_settings.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct TotpSecretCacheContext TotpSecretCacheContext;
+
+/**
+ * @brief Initializes a new decrypted secrets cache
+ * @return Secrets cache context
+ */
+TotpSecretCacheContext* totp_secret_cache_alloc();
+
+/**
+ * @brief Decrypts token secret, reusing previously decrypted secret if it is still cached
+ * @param context secrets cache context
+ * @param encrypted_data encrypted data to be decrypted
+ * @param encrypted_data_length encrypted data length
+ * @param crypto_settings crypto settings
+ * @param[out] decrypted_data_length decrypted data length
+ * @return Decrypted data, must be zeroed and freed by the caller
+ */
+uint8_t* totp_secret_cache_decrypt(
+    TotpSecretCacheContext* context,
+    const uint8_t* encrypted_data,
+    const size_t encrypted_data_length,
+    const CryptoSettings* crypto_settings,
+    size_t* decrypted_data_length);
+
+/**
+ * @brief Zeroes and drops all the cached secrets
+ * @param context secrets cache context
+ */
+void totp_secret_cache_wipe(TotpSecretCacheContext* context);
+
+/**
+ * @brief Wipes secrets cache and releases all the resources
+ * @param context secrets cache context
+ */
+void totp_secret_cache_free(TotpSecretCacheContext* context);
+
+#ifdef __cplusplus
+}
+#endif
@@ -142,6 +142,7 @@ static bool totp_activate_initial_scene(PluginState* const plugin_state) {
 
 static bool on_user_idle(void* context) {
     PluginState* plugin_state = context;
+    totp_secret_cache_wipe(plugin_state->secret_cache_context);
     if(plugin_state->current_scene != TotpSceneAuthentication &&
        plugin_state->current_scene != TotpSceneStandby) {
         totp_scene_director_activate_scene(plugin_state, TotpSceneAuthentication);
@@ -156,6 +157,7 @@ static bool totp_plugin_state_init(PluginState* const plugin_state) {
     plugin_state->gui = furi_record_open(RECORD_GUI);
     plugin_state->dialogs_app = furi_record_open(RECORD_DIALOGS);
     memset(&plugin_state->crypto_settings.iv[0], 0, CRYPTO_IV_LENGTH);
+    plugin_state->secret_cache_context = totp_secret_cache_alloc();
 
     if(!totp_config_file_load(plugin_state)) {
         totp_dialogs_config_loading_error(plugin_state);
@@ -209,6 +211,8 @@ static void totp_plugin_state_free(PluginState* plugin_state) {
         furi_message_queue_free(plugin_state->event_queue);
     }
 
+    totp_secret_cache_free(plugin_state->secret_cache_context);
+
     free(plugin_state);
 }
 
@@ -255,9 +259,24 @@ int32_t totp_app() {
 
     PluginEvent event;
     bool processing = true;
+    uint32_t last_input_tick = furi_get_tick();
     while(processing) {
-        if(furi_message_queue_get(plugin_state->event_queue, &event, FuriWaitForever) ==
-           FuriStatusOk) {
+        FuriStatus event_status = furi_message_queue_get(
+            plugin_state->event_queue, &event, furi_ms_to_ticks(TOTP_JOURNAL_COMPACTION_IDLE_MS));
+        if(event_status == FuriStatusOk && event.type == EventTypeKey) {
+            last_input_tick = furi_get_tick();
+        } else if(
+            furi_get_tick() - last_input_tick >=
+                furi_ms_to_ticks(TOTP_JOURNAL_COMPACTION_IDLE_MS) &&
+            plugin_state->current_scene != TotpSceneStandby &&
+            furi_mutex_acquire(main_loop_mutex, FuriWaitForever) == FuriStatusOk) {
+            // No user input for a while, good time to fold token changes journal into config
+            totp_config_file_compact(plugin_state, false);
+            furi_mutex_release(main_loop_mutex);
+            last_input_tick = furi_get_tick();
+        }
+
+        if(event_status == FuriStatusOk) {
             if(event.type == EventForceCloseApp) {
                 processing = false;
             } else if(event.type == EventForceRedraw) {
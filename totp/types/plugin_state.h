@@ -7,6 +7,7 @@
 #include "../ui/totp_scenes_enum.h"
 #include "../services/config/config_file_context.h"
 #include "../services/idle_timeout/idle_timeout.h"
+#include "../services/crypto/secret_cache.h"
 #include "notification_method.h"
 #include "automation_method.h"
 #include "automation_kb_layout.h"
@@ -90,4 +91,9 @@ typedef struct {
      * @brief Crypto settings
      */
     CryptoSettings crypto_settings;
+
+    /**
+     * @brief Decrypted secrets cache, wiped on lock and on IDLE timeout
+     */
+    TotpSecretCacheContext* secret_cache_context;
 } PluginState;
@@ -245,5 +245,6 @@ void token_info_set_defaults(TokenInfo* token_info) {
     token_info->automation_features = TokenAutomationFeatureNone;
     token_info->type = TokenTypeTOTP;
     token_info->counter = 0;
+    token_info->pinned = false;
     furi_string_reset(token_info->name);
 }
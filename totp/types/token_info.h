@@ -214,6 +214,11 @@ typedef struct {
      * @brief HOTP counter
      */
     uint64_t counter;
+
+    /**
+     * @brief Whether token is shown on the glance screen
+     */
+    bool pinned;
 } TokenInfo;
 
 /**
@@ -9,6 +9,7 @@
 #include "scenes/token_menu/totp_scene_token_menu.h"
 #include "scenes/app_settings/totp_app_settings.h"
 #include "scenes/standby/standby.h"
+#include "scenes/glance/totp_scene_glance.h"
 
 void totp_scene_director_activate_scene(PluginState* const plugin_state, Scene scene) {
     totp_scene_director_deactivate_active_scene(plugin_state);
@@ -30,6 +31,9 @@ void totp_scene_director_activate_scene(PluginState* const plugin_state, Scene s
     case TotpSceneAppSettings:
         totp_scene_app_settings_activate(plugin_state);
         break;
+    case TotpSceneGlance:
+        totp_scene_glance_activate(plugin_state);
+        break;
     case TotpSceneNone:
     case TotpSceneStandby:
         break;
@@ -61,6 +65,9 @@ void totp_scene_director_deactivate_active_scene(PluginState* const plugin_state
     case TotpSceneAppSettings:
         totp_scene_app_settings_deactivate(plugin_state);
         break;
+    case TotpSceneGlance:
+        totp_scene_glance_deactivate(plugin_state);
+        break;
     case TotpSceneNone:
     case TotpSceneStandby:
         break;
@@ -88,6 +95,9 @@ void totp_scene_director_render(Canvas* const canvas, PluginState* const plugin_
     case TotpSceneAppSettings:
         totp_scene_app_settings_render(canvas, plugin_state);
         break;
+    case TotpSceneGlance:
+        totp_scene_glance_render(canvas, plugin_state);
+        break;
     case TotpSceneNone:
         break;
     case TotpSceneStandby:
@@ -118,6 +128,9 @@ bool totp_scene_director_handle_event(PluginEvent* const event, PluginState* con
     case TotpSceneAppSettings:
         processing = totp_scene_app_settings_handle_event(event, plugin_state);
         break;
+    case TotpSceneGlance:
+        processing = totp_scene_glance_handle_event(event, plugin_state);
+        break;
     case TotpSceneNone:
     case TotpSceneStandby:
         break;
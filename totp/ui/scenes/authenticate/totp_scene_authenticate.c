@@ -21,6 +21,8 @@ typedef struct {
 } SceneState;
 
 void totp_scene_authenticate_activate(PluginState* plugin_state) {
+    totp_secret_cache_wipe(plugin_state->secret_cache_context);
+
     SceneState* scene_state = malloc(sizeof(SceneState));
     furi_check(scene_state != NULL);
     scene_state->code_length = 0;
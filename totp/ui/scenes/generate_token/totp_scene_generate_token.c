@@ -219,7 +219,8 @@ void totp_scene_generate_token_activate(PluginState* plugin_state) {
         totp_token_info_iterator_get_current_token(iterator_context),
         scene_state->last_code_update_sync,
         plugin_state->timezone_offset,
-        &plugin_state->crypto_settings);
+        &plugin_state->crypto_settings,
+        plugin_state->secret_cache_context);
 
     totp_generate_code_worker_set_code_generated_handler(
         scene_state->generate_code_worker_context, &on_new_token_code_generated, plugin_state);
@@ -339,6 +340,11 @@ bool totp_scene_generate_token_handle_event(
         return false;
     }
 
+    if(event->input.type == InputTypeShort && event->input.key == InputKeyDown) {
+        totp_scene_director_activate_scene(plugin_state, TotpSceneGlance);
+        return true;
+    }
+
     SceneState* scene_state;
     if(event->input.type == InputTypeLong) {
         if(event->input.key == InputKeyDown &&
@@ -0,0 +1,283 @@
+#include "totp_scene_glance.h"
+#include <gui/gui.h>
+#include <roll_value.h>
+#include "../../constants.h"
+#include "../../scene_director.h"
+#include "../../../services/config/config.h"
+#include "../../../types/token_info.h"
+#include "../../../config/app/config.h"
+#include "../../../workers/glance_codes/glance_codes.h"
+#include "../../../workers/usb_type_code/usb_type_code.h"
+#ifdef TOTP_BADBT_AUTOMATION_ENABLED
+#include "../../../workers/bt_type_code/bt_type_code.h"
+#endif
+
+#define ROW_HEIGHT (21)
+#define ROWS_VISIBLE (SCREEN_HEIGHT / ROW_HEIGHT)
+
+typedef struct {
+    TokenInfo* tokens[TOTP_GLANCE_CODES_MAX_TOKENS];
+    size_t tokens_count;
+    uint8_t selected;
+    uint8_t top;
+    TotpGlanceCodesWorkerContext* glance_codes_worker_context;
+    char typed_code[TokenDigitsCountMax + 1];
+    FuriMutex* typed_code_sync;
+    TotpUsbTypeCodeWorkerContext* usb_type_code_worker_context;
+} SceneState;
+
+static void collect_pinned_tokens(PluginState* plugin_state, SceneState* scene_state) {
+    TokenInfoIteratorContext* iterator_context =
+        totp_config_get_token_iterator_context(plugin_state);
+    size_t total_count = totp_token_info_iterator_get_total_count(iterator_context);
+    if(total_count == 0) {
+        return;
+    }
+
+    size_t current_token_index =
+        totp_token_info_iterator_get_current_token_index(iterator_context);
+    for(size_t i = 0; i < total_count && scene_state->tokens_count < TOTP_GLANCE_CODES_MAX_TOKENS;
+        i++) {
+        if(!totp_token_info_iterator_go_to(iterator_context, i)) {
+            continue;
+        }
+
+        const TokenInfo* token_info =
+            totp_token_info_iterator_get_current_token(iterator_context);
+        if(token_info->pinned && token_info->type == TokenTypeTOTP) {
+            scene_state->tokens[scene_state->tokens_count] = token_info_clone(token_info);
+            furi_check(scene_state->tokens[scene_state->tokens_count] != NULL);
+            scene_state->tokens_count++;
+        }
+    }
+
+    totp_token_info_iterator_go_to(iterator_context, current_token_index);
+}
+
+static void on_codes_updated(void* context) {
+    PluginState* const plugin_state = context;
+    totp_scene_director_force_redraw(plugin_state);
+}
+
+void totp_scene_glance_activate(PluginState* plugin_state) {
+    SceneState* scene_state = malloc(sizeof(SceneState));
+    furi_check(scene_state != NULL);
+    scene_state->tokens_count = 0;
+    scene_state->selected = 0;
+    scene_state->top = 0;
+    scene_state->glance_codes_worker_context = NULL;
+    scene_state->typed_code[0] = '\0';
+
+    collect_pinned_tokens(plugin_state, scene_state);
+
+    scene_state->typed_code_sync = furi_mutex_alloc(FuriMutexTypeNormal);
+    if(plugin_state->automation_method & AutomationMethodBadUsb) {
+        scene_state->usb_type_code_worker_context = totp_usb_type_code_worker_start(
+            scene_state->typed_code,
+            TokenDigitsCountMax + 1,
+            scene_state->typed_code_sync,
+            plugin_state->automation_kb_layout);
+    }
+
+#ifdef TOTP_BADBT_AUTOMATION_ENABLED
+    if(plugin_state->automation_method & AutomationMethodBadBt) {
+        if(plugin_state->bt_type_code_worker_context == NULL) {
+            plugin_state->bt_type_code_worker_context = totp_bt_type_code_worker_init();
+        }
+        totp_bt_type_code_worker_start(
+            plugin_state->bt_type_code_worker_context,
+            scene_state->typed_code,
+            TokenDigitsCountMax + 1,
+            scene_state->typed_code_sync,
+            plugin_state->automation_kb_layout);
+    }
+#endif
+
+    plugin_state->current_scene_state = scene_state;
+
+    if(scene_state->tokens_count > 0) {
+        scene_state->glance_codes_worker_context = totp_glance_codes_worker_start(
+            (const TokenInfo* const*)scene_state->tokens,
+            scene_state->tokens_count,
+            plugin_state->timezone_offset,
+            &plugin_state->crypto_settings,
+            plugin_state->secret_cache_context);
+        totp_glance_codes_worker_set_codes_updated_handler(
+            scene_state->glance_codes_worker_context, &on_codes_updated, plugin_state);
+    }
+}
+
+void totp_scene_glance_render(Canvas* const canvas, PluginState* plugin_state) {
+    const SceneState* scene_state = (SceneState*)plugin_state->current_scene_state;
+    if(scene_state->tokens_count == 0) {
+        canvas_set_font(canvas, FontPrimary);
+        canvas_draw_str_aligned(
+            canvas,
+            SCREEN_WIDTH_CENTER,
+            SCREEN_HEIGHT_CENTER - 6,
+            AlignCenter,
+            AlignCenter,
+            "No pinned tokens");
+        canvas_set_font(canvas, FontSecondary);
+        canvas_draw_str_aligned(
+            canvas,
+            SCREEN_WIDTH_CENTER,
+            SCREEN_HEIGHT_CENTER + 8,
+            AlignCenter,
+            AlignCenter,
+            "Pin them in token menu");
+        return;
+    }
+
+    char code[TokenDigitsCountMax + 1];
+    char next_code[TokenDigitsCountMax + 1];
+    char line[32];
+    uint8_t seconds_left;
+    for(uint8_t row = 0; row < ROWS_VISIBLE; row++) {
+        uint8_t index = scene_state->top + row;
+        if(index >= scene_state->tokens_count) {
+            break;
+        }
+
+        int32_t y = row * ROW_HEIGHT;
+        if(index == scene_state->selected) {
+            canvas_draw_rframe(canvas, 0, y, SCREEN_WIDTH, ROW_HEIGHT, 3);
+        }
+
+        canvas_set_font(canvas, FontSecondary);
+        canvas_draw_str_aligned(
+            canvas,
+            3,
+            y + 2,
+            AlignLeft,
+            AlignTop,
+            furi_string_get_cstr(scene_state->tokens[index]->name));
+
+        if(!totp_glance_codes_worker_get_codes(
+               scene_state->glance_codes_worker_context, index, code, next_code, &seconds_left)) {
+            continue;
+        }
+
+        canvas_draw_str_aligned(canvas, SCREEN_WIDTH - 3, y + 2, AlignRight, AlignTop, code);
+
+        canvas_set_font(canvas, FontKeyboard);
+        snprintf(line, sizeof(line), "%2us   next %s", seconds_left, next_code);
+        canvas_draw_str_aligned(canvas, SCREEN_WIDTH - 3, y + 12, AlignRight, AlignTop, line);
+    }
+}
+
+static void type_selected_code(PluginState* plugin_state, SceneState* scene_state, bool bt) {
+    char next_code[TokenDigitsCountMax + 1];
+    uint8_t seconds_left;
+    if(furi_mutex_acquire(scene_state->typed_code_sync, FuriWaitForever) != FuriStatusOk) {
+        return;
+    }
+
+    bool generated = totp_glance_codes_worker_get_codes(
+        scene_state->glance_codes_worker_context,
+        scene_state->selected,
+        scene_state->typed_code,
+        next_code,
+        &seconds_left);
+    furi_mutex_release(scene_state->typed_code_sync);
+    if(!generated) {
+        return;
+    }
+
+    TokenAutomationFeature features =
+        scene_state->tokens[scene_state->selected]->automation_features;
+    if(!bt) {
+        totp_usb_type_code_worker_notify(
+            scene_state->usb_type_code_worker_context, TotpUsbTypeCodeWorkerEventType, features);
+    }
+#ifdef TOTP_BADBT_AUTOMATION_ENABLED
+    else {
+        totp_bt_type_code_worker_notify(
+            plugin_state->bt_type_code_worker_context, TotpBtTypeCodeWorkerEventType, features);
+    }
+#else
+    UNUSED(plugin_state);
+#endif
+}
+
+bool totp_scene_glance_handle_event(const PluginEvent* const event, PluginState* plugin_state) {
+    if(event->type != EventTypeKey) {
+        return true;
+    }
+
+    SceneState* scene_state = (SceneState*)plugin_state->current_scene_state;
+    if(event->input.type == InputTypeLong && event->input.key == InputKeyOk) {
+#ifdef TOTP_BADBT_AUTOMATION_ENABLED
+        if(scene_state->tokens_count > 0 &&
+           plugin_state->automation_method & AutomationMethodBadBt) {
+            type_selected_code(plugin_state, scene_state, true);
+        }
+#endif
+        return true;
+    }
+
+    if(event->input.type == InputTypeShort && event->input.key == InputKeyOk) {
+        if(scene_state->tokens_count > 0 &&
+           plugin_state->automation_method & AutomationMethodBadUsb) {
+            type_selected_code(plugin_state, scene_state, false);
+        }
+        return true;
+    }
+
+    if(event->input.type != InputTypePress && event->input.type != InputTypeRepeat) {
+        return true;
+    }
+
+    switch(event->input.key) {
+    case InputKeyUp:
+    case InputKeyDown:
+        if(scene_state->tokens_count > 0) {
+            totp_roll_value_uint8_t(
+                &scene_state->selected,
+                event->input.key == InputKeyUp ? -1 : 1,
+                0,
+                scene_state->tokens_count - 1,
+                RollOverflowBehaviorRoll);
+            if(scene_state->selected < scene_state->top) {
+                scene_state->top = scene_state->selected;
+            } else if(scene_state->selected >= scene_state->top + ROWS_VISIBLE) {
+                scene_state->top = scene_state->selected - ROWS_VISIBLE + 1;
+            }
+        }
+        break;
+    case InputKeyBack:
+        totp_scene_director_activate_scene(plugin_state, TotpSceneGenerateToken);
+        break;
+    default:
+        break;
+    }
+
+    return true;
+}
+
+void totp_scene_glance_deactivate(PluginState* plugin_state) {
+    if(plugin_state->current_scene_state == NULL) return;
+    SceneState* scene_state = (SceneState*)plugin_state->current_scene_state;
+
+    if(scene_state->glance_codes_worker_context != NULL) {
+        totp_glance_codes_worker_stop(scene_state->glance_codes_worker_context);
+    }
+
+    if(plugin_state->automation_method & AutomationMethodBadUsb) {
+        totp_usb_type_code_worker_stop(scene_state->usb_type_code_worker_context);
+    }
+#ifdef TOTP_BADBT_AUTOMATION_ENABLED
+    if(plugin_state->automation_method & AutomationMethodBadBt) {
+        totp_bt_type_code_worker_stop(plugin_state->bt_type_code_worker_context);
+    }
+#endif
+
+    furi_mutex_free(scene_state->typed_code_sync);
+
+    for(size_t i = 0; i < scene_state->tokens_count; i++) {
+        token_info_free(scene_state->tokens[i]);
+    }
+
+    free(scene_state);
+    plugin_state->current_scene_state = NULL;
+}
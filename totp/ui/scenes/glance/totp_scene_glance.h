@@ -0,0 +1,10 @@
+#pragma once
+
+#include <gui/gui.h>
+#include "../../../types/plugin_state.h"
+#include "../../../types/plugin_event.h"
+
+void totp_scene_glance_activate(PluginState* plugin_state);
+void totp_scene_glance_render(Canvas* const canvas, PluginState* plugin_state);
+bool totp_scene_glance_handle_event(const PluginEvent* const event, PluginState* plugin_state);
+void totp_scene_glance_deactivate(PluginState* plugin_state);
@@ -10,15 +10,22 @@
 #include "../../../config/app/config.h"
 #include <roll_value.h>
 
-#define SCREEN_HEIGHT_THIRD (SCREEN_HEIGHT / 3)
-#define SCREEN_HEIGHT_THIRD_CENTER (SCREEN_HEIGHT_THIRD >> 1)
+#define SCREEN_HEIGHT_QUARTER (SCREEN_HEIGHT / 4)
+#define SCREEN_HEIGHT_QUARTER_CENTER (SCREEN_HEIGHT_QUARTER >> 1)
 
-typedef enum { AddNewToken, DeleteToken, AppSettings } Control;
+typedef enum { AddNewToken, DeleteToken, PinToken, AppSettings } Control;
 
 typedef struct {
     Control selected_control;
 } SceneState;
 
+static TotpIteratorUpdateTokenResult
+    toggle_token_pinned(TokenInfo* const token_info, const void* context) {
+    UNUSED(context);
+    token_info->pinned = !token_info->pinned;
+    return TotpIteratorUpdateTokenResultSuccess;
+}
+
 void totp_scene_token_menu_activate(PluginState* plugin_state) {
     SceneState* scene_state = malloc(sizeof(SceneState));
     furi_check(scene_state != NULL);
@@ -47,28 +54,38 @@ void totp_scene_token_menu_render(Canvas* const canvas, PluginState* plugin_stat
             "Settings",
             scene_state->selected_control == AppSettings);
     } else {
+        const TokenInfo* token_info =
+            totp_token_info_iterator_get_current_token(iterator_context);
         ui_control_button_render(
             canvas,
             SCREEN_WIDTH_CENTER - 36,
-            SCREEN_HEIGHT_THIRD_CENTER - 8,
+            SCREEN_HEIGHT_QUARTER_CENTER - 7,
             72,
-            16,
+            14,
             "Add new token",
             scene_state->selected_control == AddNewToken);
         ui_control_button_render(
             canvas,
             SCREEN_WIDTH_CENTER - 36,
-            SCREEN_HEIGHT_THIRD + SCREEN_HEIGHT_THIRD_CENTER - 8,
+            SCREEN_HEIGHT_QUARTER + SCREEN_HEIGHT_QUARTER_CENTER - 7,
             72,
-            16,
+            14,
             "Delete token",
             scene_state->selected_control == DeleteToken);
         ui_control_button_render(
             canvas,
             SCREEN_WIDTH_CENTER - 36,
-            SCREEN_HEIGHT_THIRD + SCREEN_HEIGHT_THIRD + SCREEN_HEIGHT_THIRD_CENTER - 8,
+            SCREEN_HEIGHT_QUARTER * 2 + SCREEN_HEIGHT_QUARTER_CENTER - 7,
+            72,
+            14,
+            token_info->pinned ? "Unpin token" : "Pin token",
+            scene_state->selected_control == PinToken);
+        ui_control_button_render(
+            canvas,
+            SCREEN_WIDTH_CENTER - 36,
+            SCREEN_HEIGHT_QUARTER * 3 + SCREEN_HEIGHT_QUARTER_CENTER - 7,
             72,
-            16,
+            14,
             "Settings",
             scene_state->selected_control == AppSettings);
     }
@@ -91,9 +108,9 @@ bool totp_scene_token_menu_handle_event(const PluginEvent* const event, PluginSt
                 AddNewToken,
                 AppSettings,
                 RollOverflowBehaviorRoll);
-            if(scene_state->selected_control == DeleteToken &&
+            if(scene_state->selected_control == PinToken &&
                totp_token_info_iterator_get_total_count(iterator_context) == 0) {
-                scene_state->selected_control--;
+                scene_state->selected_control = AddNewToken;
             }
             break;
         }
@@ -108,7 +125,7 @@ bool totp_scene_token_menu_handle_event(const PluginEvent* const event, PluginSt
                 RollOverflowBehaviorRoll);
             if(scene_state->selected_control == DeleteToken &&
                totp_token_info_iterator_get_total_count(iterator_context) == 0) {
-                scene_state->selected_control++;
+                scene_state->selected_control = AppSettings;
             }
             break;
         }
@@ -164,6 +181,17 @@ bool totp_scene_token_menu_handle_event(const PluginEvent* const event, PluginSt
                 }
                 break;
             }
+            case PinToken: {
+                TokenInfoIteratorContext* iterator_context =
+                    totp_config_get_token_iterator_context(plugin_state);
+                if(totp_token_info_iterator_update_current_token(
+                       iterator_context, &toggle_token_pinned, NULL) !=
+                   TotpIteratorUpdateTokenResultSuccess) {
+                    totp_dialogs_config_updating_error(plugin_state);
+                    return false;
+                }
+                break;
+            }
             case AppSettings: {
                 totp_scene_director_activate_scene(plugin_state, TotpSceneAppSettings);
                 break;
@@ -40,6 +40,11 @@ enum Scenes {
      */
     TotpSceneAppSettings,
 
+    /**
+     * @brief Scene showing current and next codes of all the pinned tokens at once
+     */
+    TotpSceneGlance,
+
     /**
      * @brief Scene which informs user that CLI command is running
      */
@@ -1,7 +1,7 @@
 #include "generate_totp_code.h"
 #include <furi/core/thread.h>
 #include <furi/core/check.h>
-#include "../../services/crypto/crypto_facade.h"
+#include "../../services/crypto/secret_cache.h"
 #include "../../services/totp/totp.h"
 #include "../../services/convert/convert.h"
 #include <furi_hal_rtc.h>
@@ -16,6 +16,7 @@ struct TotpGenerateCodeWorkerContext {
     const TokenInfo* token_info;
     float timezone_offset;
     const CryptoSettings* crypto_settings;
+    TotpSecretCacheContext* secret_cache;
     TOTP_NEW_CODE_GENERATED_HANDLER on_new_code_generated_handler;
     void* on_new_code_generated_handler_context;
     TOTP_CODE_LIFETIME_CHANGED_HANDLER on_code_lifetime_changed_handler;
@@ -63,14 +64,35 @@ static TOTP_ALGO get_totp_algo_impl(TokenHashAlgo algo) {
     return NULL;
 }
 
+void totp_generate_code_format_totp_at(
+    char* code_buffer,
+    const TokenInfo* token_info,
+    const uint8_t* key,
+    size_t key_length,
+    uint32_t timestamp,
+    float timezone_offset) {
+    uint64_t otp_code = totp_at(
+        get_totp_algo_impl(token_info->algo),
+        key,
+        key_length,
+        timestamp,
+        timezone_offset,
+        token_info->duration);
+    int_token_to_str(otp_code, code_buffer, token_info->digits, token_info->algo);
+}
+
 static void generate_totp_code(
     TotpGenerateCodeWorkerContext* context,
     const TokenInfo* token_info,
     uint32_t current_ts) {
     if(token_info->token != NULL && token_info->token_length > 0) {
         size_t key_length;
-        uint8_t* key = totp_crypto_decrypt(
-            token_info->token, token_info->token_length, context->crypto_settings, &key_length);
+        uint8_t* key = totp_secret_cache_decrypt(
+            context->secret_cache,
+            token_info->token,
+            token_info->token_length,
+            context->crypto_settings,
+            &key_length);
 
         uint64_t otp_code;
         if(token_info->type == TokenTypeTOTP) {
@@ -159,7 +181,8 @@ TotpGenerateCodeWorkerContext* totp_generate_code_worker_start(
     const TokenInfo* token_info,
     FuriMutex* code_buffer_sync,
     float timezone_offset,
-    const CryptoSettings* crypto_settings) {
+    const CryptoSettings* crypto_settings,
+    TotpSecretCacheContext* secret_cache) {
     TotpGenerateCodeWorkerContext* context = malloc(sizeof(TotpGenerateCodeWorkerContext));
     furi_check(context != NULL);
     context->code_buffer = code_buffer;
@@ -167,6 +190,7 @@ TotpGenerateCodeWorkerContext* totp_generate_code_worker_start(
     context->code_buffer_sync = code_buffer_sync;
     context->timezone_offset = timezone_offset;
     context->crypto_settings = crypto_settings;
+    context->secret_cache = secret_cache;
     context->thread = furi_thread_alloc();
     furi_thread_set_name(context->thread, "TOTPGenerateWorker");
     furi_thread_set_stack_size(context->thread, 2048);
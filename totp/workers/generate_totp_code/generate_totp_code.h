@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <furi/core/mutex.h>
 #include "../../types/token_info.h"
+#include "../../services/crypto/secret_cache.h"
 
 typedef uint8_t TotpGenerateCodeWorkerEvent;
 
@@ -39,6 +40,7 @@ enum TotGenerateCodeWorkerEvents {
  * @param code_buffer_sync code buffer synchronization primitive
  * @param timezone_offset timezone offset to be used to generate code
  * @param crypto_settings crypto settings
+ * @param secret_cache decrypted secrets cache
  * @return worker context
  */
 TotpGenerateCodeWorkerContext* totp_generate_code_worker_start(
@@ -46,7 +48,8 @@ TotpGenerateCodeWorkerContext* totp_generate_code_worker_start(
     const TokenInfo* token_info,
     FuriMutex* code_buffer_sync,
     float timezone_offset,
-    const CryptoSettings* crypto_settings);
+    const CryptoSettings* crypto_settings,
+    TotpSecretCacheContext* secret_cache);
 
 /**
  * @brief Stops generate code worker
@@ -84,3 +87,20 @@ void totp_generate_code_worker_set_lifetime_changed_handler(
     TotpGenerateCodeWorkerContext* context,
     TOTP_CODE_LIFETIME_CHANGED_HANDLER on_code_lifetime_changed_handler,
     void* on_code_lifetime_changed_handler_context);
+
+/**
+ * @brief Generates TOTP code for the given token at the given moment of time
+ * @param[out] code_buffer buffer to write code to, at least \c TokenDigitsCountMax + 1 bytes
+ * @param token_info token info to be used to generate code
+ * @param key decrypted token secret
+ * @param key_length decrypted token secret length
+ * @param timestamp moment of time to generate code for
+ * @param timezone_offset timezone offset to be used to generate code
+ */
+void totp_generate_code_format_totp_at(
+    char* code_buffer,
+    const TokenInfo* token_info,
+    const uint8_t* key,
+    size_t key_length,
+    uint32_t timestamp,
+    float timezone_offset);
@@ -0,0 +1,197 @@
+#include "glance_codes.h"
+#include <furi/core/thread.h>
+#include <furi/core/check.h>
+#include <furi_hal_rtc.h>
+#include <timezone_utils.h>
+#include <memset_s.h>
+#include "../generate_totp_code/generate_totp_code.h"
+
+#define ONE_SEC_MS (1000)
+#define NO_PERIOD (UINT64_MAX)
+
+typedef struct {
+    uint64_t period;
+    uint8_t seconds_left;
+    char code[TokenDigitsCountMax + 1];
+    char next_code[TokenDigitsCountMax + 1];
+} GlanceCodes;
+
+struct TotpGlanceCodesWorkerContext {
+    FuriThread* thread;
+    FuriMutex* codes_sync;
+    const TokenInfo* const* tokens;
+    size_t tokens_count;
+    GlanceCodes codes[TOTP_GLANCE_CODES_MAX_TOKENS];
+    float timezone_offset;
+    const CryptoSettings* crypto_settings;
+    TotpSecretCacheContext* secret_cache;
+    TOTP_GLANCE_CODES_UPDATED_HANDLER on_codes_updated_handler;
+    void* on_codes_updated_handler_context;
+};
+
+static void generate_codes(
+    TotpGlanceCodesWorkerContext* context,
+    const TokenInfo* token_info,
+    uint32_t ts,
+    char* code,
+    char* next_code) {
+    size_t key_length = 0;
+    uint8_t* key = NULL;
+    if(token_info->token != NULL && token_info->token_length > 0) {
+        key = totp_secret_cache_decrypt(
+            context->secret_cache,
+            token_info->token,
+            token_info->token_length,
+            context->crypto_settings,
+            &key_length);
+    }
+
+    if(code != NULL) {
+        totp_generate_code_format_totp_at(
+            code, token_info, key, key_length, ts, context->timezone_offset);
+    }
+
+    totp_generate_code_format_totp_at(
+        next_code,
+        token_info,
+        key,
+        key_length,
+        ts + token_info->duration,
+        context->timezone_offset);
+
+    if(key != NULL) {
+        memset_s(key, key_length, 0, key_length);
+        free(key);
+    }
+}
+
+static void update_token_codes(TotpGlanceCodesWorkerContext* context, size_t index, uint32_t ts) {
+    const TokenInfo* token_info = context->tokens[index];
+    GlanceCodes* codes = &context->codes[index];
+    uint64_t ts_adjusted =
+        timezone_offset_apply(ts, timezone_offset_from_hours(context->timezone_offset));
+    uint64_t period = ts_adjusted / token_info->duration;
+    uint8_t seconds_left = token_info->duration - ts_adjusted % token_info->duration;
+
+    if(period == codes->period) {
+        codes->seconds_left = seconds_left;
+        return;
+    }
+
+    char code[TokenDigitsCountMax + 1];
+    char next_code[TokenDigitsCountMax + 1];
+    if(codes->period != NO_PERIOD && period == codes->period + 1) {
+        // Current code was already generated a period ago, only the next one is new
+        generate_codes(context, token_info, ts, NULL, next_code);
+        furi_check(furi_mutex_acquire(context->codes_sync, FuriWaitForever) == FuriStatusOk);
+        memcpy(codes->code, codes->next_code, sizeof(codes->code));
+    } else {
+        generate_codes(context, token_info, ts, code, next_code);
+        furi_check(furi_mutex_acquire(context->codes_sync, FuriWaitForever) == FuriStatusOk);
+        memcpy(codes->code, code, sizeof(codes->code));
+    }
+
+    memcpy(codes->next_code, next_code, sizeof(codes->next_code));
+    codes->period = period;
+    codes->seconds_left = seconds_left;
+    furi_mutex_release(context->codes_sync);
+}
+
+static int32_t totp_glance_codes_worker_callback(void* context) {
+    furi_check(context);
+
+    TotpGlanceCodesWorkerContext* t_context = context;
+    uint32_t flags = 0;
+
+    do {
+        uint32_t ts = furi_hal_rtc_get_timestamp();
+        for(size_t i = 0; i < t_context->tokens_count; i++) {
+            update_token_codes(t_context, i, ts);
+        }
+
+        if(t_context->on_codes_updated_handler != NULL) {
+            (*(t_context->on_codes_updated_handler))(t_context->on_codes_updated_handler_context);
+        }
+
+        flags =
+            furi_thread_flags_wait(TotpGlanceCodesWorkerEventStop, FuriFlagWaitAny, ONE_SEC_MS);
+        if(flags == (uint32_t)FuriFlagErrorTimeout) {
+            flags = 0;
+        }
+
+        furi_check((flags & FuriFlagError) == 0); //-V562
+    } while(!(flags & TotpGlanceCodesWorkerEventStop));
+
+    return 0;
+}
+
+TotpGlanceCodesWorkerContext* totp_glance_codes_worker_start(
+    const TokenInfo* const* tokens,
+    size_t tokens_count,
+    float timezone_offset,
+    const CryptoSettings* crypto_settings,
+    TotpSecretCacheContext* secret_cache) {
+    furi_check(tokens_count <= TOTP_GLANCE_CODES_MAX_TOKENS);
+    TotpGlanceCodesWorkerContext* context = malloc(sizeof(TotpGlanceCodesWorkerContext));
+    furi_check(context != NULL);
+    context->codes_sync = furi_mutex_alloc(FuriMutexTypeNormal);
+    context->tokens = tokens;
+    context->tokens_count = tokens_count;
+    for(size_t i = 0; i < TOTP_GLANCE_CODES_MAX_TOKENS; i++) {
+        context->codes[i].period = NO_PERIOD;
+    }
+    context->timezone_offset = timezone_offset;
+    context->crypto_settings = crypto_settings;
+    context->secret_cache = secret_cache;
+    context->on_codes_updated_handler = NULL;
+    context->on_codes_updated_handler_context = NULL;
+    context->thread = furi_thread_alloc();
+    furi_thread_set_name(context->thread, "TOTPGlanceWorker");
+    furi_thread_set_stack_size(context->thread, 2048);
+    furi_thread_set_context(context->thread, context);
+    furi_thread_set_callback(context->thread, totp_glance_codes_worker_callback);
+    furi_thread_start(context->thread);
+    return context;
+}
+
+void totp_glance_codes_worker_stop(TotpGlanceCodesWorkerContext* context) {
+    furi_check(context != NULL);
+    furi_thread_flags_set(furi_thread_get_id(context->thread), TotpGlanceCodesWorkerEventStop);
+    furi_thread_join(context->thread);
+    furi_thread_free(context->thread);
+    furi_mutex_free(context->codes_sync);
+    memset_s(context->codes, sizeof(context->codes), 0, sizeof(context->codes));
+    free(context);
+}
+
+void totp_glance_codes_worker_set_codes_updated_handler(
+    TotpGlanceCodesWorkerContext* context,
+    TOTP_GLANCE_CODES_UPDATED_HANDLER on_codes_updated_handler,
+    void* on_codes_updated_handler_context) {
+    furi_check(context != NULL);
+    context->on_codes_updated_handler_context = on_codes_updated_handler_context;
+    context->on_codes_updated_handler = on_codes_updated_handler;
+}
+
+bool totp_glance_codes_worker_get_codes(
+    TotpGlanceCodesWorkerContext* context,
+    size_t index,
+    char* code,
+    char* next_code,
+    uint8_t* seconds_left) {
+    furi_check(context != NULL);
+    furi_check(index < context->tokens_count);
+    bool generated = false;
+    if(furi_mutex_acquire(context->codes_sync, FuriWaitForever) == FuriStatusOk) {
+        const GlanceCodes* codes = &context->codes[index];
+        generated = codes->period != NO_PERIOD;
+        if(generated) {
+            memcpy(code, codes->code, sizeof(codes->code));
+            memcpy(next_code, codes->next_code, sizeof(codes->next_code));
+            *seconds_left = codes->seconds_left;
+        }
+        furi_mutex_release(context->codes_sync);
+    }
+
+    return generated;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stdlib.h>
+#include <furi/core/mutex.h>
+#include "../../types/token_info.h"
+#include "../../services/crypto/secret_cache.h"
+
+#define TOTP_GLANCE_CODES_MAX_TOKENS (8)
+
+typedef uint8_t TotpGlanceCodesWorkerEvent;
+
+typedef void (*TOTP_GLANCE_CODES_UPDATED_HANDLER)(void* context);
+
+typedef struct TotpGlanceCodesWorkerContext TotpGlanceCodesWorkerContext;
+
+/**
+ * @brief Glance codes worker events
+ */
+enum TotpGlanceCodesWorkerEvents {
+
+    /**
+     * @brief Reserved, should not be used anywhere
+     */
+    TotpGlanceCodesWorkerEventReserved = 0b00,
+
+    /**
+     * @brief Stop worker
+     */
+    TotpGlanceCodesWorkerEventStop = 0b01
+};
+
+/**
+ * @brief Starts glance codes worker which keeps current and next period codes
+ *        for several TOTP tokens at once
+ * @param tokens TOTP tokens to generate codes for, must outlive the worker
+ * @param tokens_count amount of tokens, up to \c TOTP_GLANCE_CODES_MAX_TOKENS
+ * @param timezone_offset timezone offset to be used to generate codes
+ * @param crypto_settings crypto settings
+ * @param secret_cache decrypted secrets cache
+ * @return worker context
+ */
+TotpGlanceCodesWorkerContext* totp_glance_codes_worker_start(
+    const TokenInfo* const* tokens,
+    size_t tokens_count,
+    float timezone_offset,
+    const CryptoSettings* crypto_settings,
+    TotpSecretCacheContext* secret_cache);
+
+/**
+ * @brief Stops glance codes worker
+ * @param context worker context
+ */
+void totp_glance_codes_worker_stop(TotpGlanceCodesWorkerContext* context);
+
+/**
+ * @brief Sets new handler for "codes updated" event, called once a second
+ * @param context worker context
+ * @param on_codes_updated_handler handler
+ * @param on_codes_updated_handler_context handler context
+ */
+void totp_glance_codes_worker_set_codes_updated_handler(
+    TotpGlanceCodesWorkerContext* context,
+    TOTP_GLANCE_CODES_UPDATED_HANDLER on_codes_updated_handler,
+    void* on_codes_updated_handler_context);
+
+/**
+ * @brief Copies codes of the given token
+ * @param context worker context
+ * @param index token index
+ * @param[out] code buffer for the current code, at least \c TokenDigitsCountMax + 1 bytes
+ * @param[out] next_code buffer for the next period code, at least \c TokenDigitsCountMax + 1 bytes
+ * @param[out] seconds_left seconds left till the current code expires
+ * @return \c true if codes have already been generated; \c false otherwise
+ */
+bool totp_glance_codes_worker_get_codes(
+    TotpGlanceCodesWorkerContext* context,
+    size_t index,
+    char* code,
+    char* next_code,
+    uint8_t* seconds_left);
@@ -0,0 +1,158 @@
+#include "pitch_detector.h"
+
+#include <string.h>
+
+#define MIN_LAG (1000000 / PITCH_MAX_HZ / PITCH_SAMPLE_US)
+#define MAX_LAG (1000000 / PITCH_MIN_HZ / PITCH_SAMPLE_US)
+// the first dip of the normalized difference below this is the period
+#define YIN_THRESHOLD 0.2f
+// without one, the deepest dip still counts if it gets this low
+#define YIN_FALLBACK 0.35f
+
+// 32 bits of the bitmap starting at any bit
+static inline uint32_t pitch_bits_at(const uint32_t* bits, uint32_t position) {
+    uint32_t word = position / 32;
+    uint32_t shift = position % 32;
+    if(!shift) return bits[word];
+    return (bits[word] >> shift) | (bits[word + 1] << (32 - shift));
+}
+
+// Bits that differ between the window and the window shifted by lag
+static uint32_t pitch_difference(const uint32_t* bits, uint32_t lag) {
+    uint32_t difference = 0;
+    for(uint32_t word = 0; word < PITCH_WINDOW_BITS / 32; word++) {
+        difference += __builtin_popcount(bits[word] ^ pitch_bits_at(bits, lag + word * 32));
+    }
+    return difference;
+}
+
+static void pitch_fill_bits(
+    PitchDetector* detector,
+    const uint32_t* edges,
+    size_t count,
+    bool level,
+    uint32_t start,
+    uint32_t sample_ticks) {
+    memset(detector->bits, 0, sizeof(detector->bits));
+
+    // a bit holds the level at its sample time
+    uint32_t bit = 0;
+    for(size_t i = 0; i <= count; i++) {
+        uint32_t end = PITCH_FRAME_BITS;
+        if(i < count) {
+            uint32_t time = PITCH_EDGE_TIME(edges[i]) - start;
+            uint32_t edge_bit = (time + sample_ticks - 1) / sample_ticks;
+            if(edge_bit < end) end = edge_bit;
+        }
+        for(; level && bit < end; bit++) {
+            detector->bits[bit / 32] |= 1UL << (bit % 32);
+        }
+        if(bit < end) bit = end;
+        if(i < count) level = PITCH_EDGE_LEVEL(edges[i]);
+    }
+}
+
+// Period in bits from the cumulative mean normalized difference, 0 if there is none
+static float pitch_yin(const uint32_t* bits) {
+    uint64_t sum = 0;
+    float previous = 1.0f;
+    float before_previous = 1.0f;
+    float best = YIN_FALLBACK;
+    float best_lag = 0;
+
+    for(uint32_t lag = 1; lag <= MAX_LAG + 1; lag++) {
+        uint32_t difference = pitch_difference(bits, lag);
+        sum += difference;
+        float normalized = sum ? (float)difference * lag / sum : 1.0f;
+
+        // a local minimum one lag back
+        uint32_t dip = lag - 1;
+        if(dip >= MIN_LAG && previous <= before_previous && previous < normalized &&
+           previous < best) {
+            best = previous;
+            // the vertex of a parabola through the dip and its neighbours
+            float curvature = before_previous - 2 * previous + normalized;
+            float offset = curvature > 0 ? (before_previous - normalized) / (2 * curvature) : 0;
+            best_lag = dip + offset;
+            if(best < YIN_THRESHOLD) break;
+        }
+        before_previous = previous;
+        previous = normalized;
+    }
+
+    return best_lag;
+}
+
+// Average period over chains of rising edges one period apart. Every chain starts in the
+// first period and follows the same point of the waveform for as long as it can, so the
+// result is as fine as the edge times.
+static float pitch_refine(
+    const uint32_t* edges,
+    size_t count,
+    uint32_t start,
+    float coarse_ticks) {
+    uint32_t period = coarse_ticks;
+    uint32_t tolerance = period / 8;
+    uint64_t total = 0;
+    uint32_t periods = 0;
+    bool first = true;
+    uint32_t first_time = 0;
+
+    for(size_t i = 0; i < count; i++) {
+        if(!PITCH_EDGE_LEVEL(edges[i])) continue;
+        uint32_t chain_start = PITCH_EDGE_TIME(edges[i]) - start;
+        if(first) {
+            first = false;
+            first_time = chain_start;
+        } else if(chain_start - first_time >= period) {
+            break;
+        }
+
+        uint32_t anchor = chain_start;
+        size_t next = i + 1;
+        while(true) {
+            uint32_t expected = anchor + period;
+            uint32_t closest = tolerance + 1;
+            size_t found = count;
+            for(; next < count; next++) {
+                uint32_t time = PITCH_EDGE_TIME(edges[next]) - start;
+                if(time > expected + tolerance) break;
+                uint32_t error = time > expected ? time - expected : expected - time;
+                if(PITCH_EDGE_LEVEL(edges[next]) && error < closest) {
+                    closest = error;
+                    found = next;
+                }
+            }
+            if(found == count) break;
+            anchor = PITCH_EDGE_TIME(edges[found]) - start;
+            next = found + 1;
+            periods++;
+        }
+        total += anchor - chain_start;
+    }
+
+    // a single period is no better than the bitmap
+    if(periods < 2) return coarse_ticks;
+    return (float)total / periods;
+}
+
+float pitch_detector_run(
+    PitchDetector* detector,
+    const uint32_t* edges,
+    size_t count,
+    bool level,
+    uint32_t start,
+    uint32_t ticks_per_us) {
+    if(count < 4) return 0;
+
+    uint32_t sample_ticks = PITCH_SAMPLE_US * ticks_per_us;
+    pitch_fill_bits(detector, edges, count, level, start, sample_ticks);
+
+    float lag = pitch_yin(detector->bits);
+    if(lag == 0) return 0;
+
+    float period = pitch_refine(edges, count, start, lag * sample_ticks);
+    float frequency = ticks_per_us * 1000000.0f / period;
+    if(frequency < PITCH_MIN_HZ || frequency > PITCH_MAX_HZ) return 0;
+    return frequency;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Pitch of a one bit signal, like the output of a comparator behind a microphone. The edges
+// are turned into a bitmap and YIN (a normalized difference function) picks the period, so
+// the extra crossings from overtones don't get mistaken for the fundamental. The period is
+// then measured again on the edge times themselves, which are far finer than the bitmap.
+
+// bitmap resolution
+#define PITCH_SAMPLE_US 20
+#define PITCH_FRAME_BITS 4096
+// the frame is the window plus the longest period
+#define PITCH_WINDOW_BITS 2048
+#define PITCH_FRAME_US (PITCH_FRAME_BITS * PITCH_SAMPLE_US)
+
+#define PITCH_MIN_HZ 30
+#define PITCH_MAX_HZ 1500
+
+// Edges are packed as the time in ticks with the level after the edge in the lowest bit
+#define PITCH_EDGE(time, level) (((time) & ~1UL) | ((level) ? 1 : 0))
+#define PITCH_EDGE_TIME(edge) ((edge) & ~1UL)
+#define PITCH_EDGE_LEVEL(edge) (((edge) & 1) != 0)
+
+typedef struct {
+    uint32_t bits[PITCH_FRAME_BITS / 32 + 1];
+} PitchDetector;
+
+// Frequency in Hz of the frame starting at start, 0 without a clear pitch. level is the level
+// at the start of the frame and edges are the changes inside it, oldest first.
+float pitch_detector_run(
+    PitchDetector* detector,
+    const uint32_t* edges,
+    size_t count,
+    bool level,
+    uint32_t start,
+    uint32_t ticks_per_us);
@@ -0,0 +1,223 @@
+#include "tone_generator.h"
+
+#include <furi_hal.h>
+#include <furi_hal_interrupt.h>
+#include <stm32wbxx_ll_tim.h>
+#include <stm32wbxx_ll_dma.h>
+#include <math.h>
+
+#define SPEAKER_TIMER TIM16
+#define SPEAKER_CHANNEL LL_TIM_CHANNEL_CH1
+#define DMA_INSTANCE DMA1, LL_DMA_CHANNEL_1
+
+// 64 MHz / 5 / 256, one sample per PWM period
+#define PWM_PRESCALER 4
+#define PWM_AUTORELOAD 255
+#define SAMPLE_RATE (64000000 / (PWM_PRESCALER + 1) / (PWM_AUTORELOAD + 1))
+#define PWM_CENTER (PWM_AUTORELOAD / 2)
+
+// each half is refilled while the other one plays, 5 ms of sound
+#define BUFFER_LENGTH 512
+
+#define SINE_BITS 10
+#define SINE_SIZE (1 << SINE_BITS)
+
+// gain is the peak PWM swing in 1/256 steps, ramped so starts, stops and volume changes
+// don't click
+#define GAIN_SHIFT 8
+#define GAIN_MAX (PWM_CENTER << GAIN_SHIFT)
+#define GAIN_STEP (GAIN_MAX / 256)
+// longer than the 256 sample ramp
+#define RAMP_MS 10
+
+struct ToneGenerator {
+    uint16_t buffer[BUFFER_LENGTH];
+    int16_t sine[SINE_SIZE];
+
+    bool running;
+    volatile uint32_t phase_step;
+    volatile ToneWaveform waveform;
+    volatile int32_t target_gain;
+    uint32_t phase;
+    int32_t gain;
+};
+
+static const char* const tone_waveform_names[ToneWaveformCount] = {
+    [ToneWaveformSine] = "Sine",
+    [ToneWaveformHarmonic] = "Harmonic",
+    [ToneWaveformTriangle] = "Triangle",
+    [ToneWaveformSquare] = "Square",
+};
+
+// Q15 sample at the given phase, a full turn is 2^32
+static inline int32_t tone_generator_sample(ToneGenerator* generator, uint32_t phase) {
+    const int16_t* sine = generator->sine;
+    switch(generator->waveform) {
+    case ToneWaveformHarmonic: {
+        // the fundamental with half of the 2nd and a quarter of the 3rd harmonic
+        int32_t first = sine[phase >> (32 - SINE_BITS)];
+        int32_t second = sine[(phase * 2) >> (32 - SINE_BITS)];
+        int32_t third = sine[(phase * 3) >> (32 - SINE_BITS)];
+        return (first * 4 + second * 2 + third) / 7;
+    }
+    case ToneWaveformTriangle: {
+        int32_t ramp = phase >> 16;
+        return (ramp < 32768 ? ramp - 16384 : 49151 - ramp) * 2;
+    }
+    case ToneWaveformSquare:
+        return phase < 0x80000000 ? INT16_MAX : -INT16_MAX;
+    default:
+        return sine[phase >> (32 - SINE_BITS)];
+    }
+}
+
+static void tone_generator_fill(ToneGenerator* generator, uint16_t* samples) {
+    uint32_t phase_step = generator->phase_step;
+    int32_t target_gain = generator->target_gain;
+
+    for(size_t i = 0; i < BUFFER_LENGTH / 2; i++) {
+        if(generator->gain < target_gain) {
+            generator->gain = MIN(generator->gain + GAIN_STEP, target_gain);
+        } else if(generator->gain > target_gain) {
+            generator->gain = MAX(generator->gain - GAIN_STEP, target_gain);
+        }
+
+        int32_t sample = tone_generator_sample(generator, generator->phase);
+        samples[i] = PWM_CENTER + ((sample * (generator->gain >> GAIN_SHIFT)) >> 15);
+        generator->phase += phase_step;
+    }
+}
+
+// Refilling takes a few microseconds, doing it right here means the GUI can never make the
+// sound stutter
+static void tone_generator_dma_isr(void* context) {
+    ToneGenerator* generator = context;
+
+    if(LL_DMA_IsActiveFlag_HT1(DMA1)) {
+        LL_DMA_ClearFlag_HT1(DMA1);
+        tone_generator_fill(generator, generator->buffer);
+    }
+
+    if(LL_DMA_IsActiveFlag_TC1(DMA1)) {
+        LL_DMA_ClearFlag_TC1(DMA1);
+        tone_generator_fill(generator, generator->buffer + BUFFER_LENGTH / 2);
+    }
+}
+
+ToneGenerator* tone_generator_alloc() {
+    ToneGenerator* generator = malloc(sizeof(ToneGenerator));
+    generator->running = false;
+    generator->phase_step = 0;
+    generator->waveform = ToneWaveformSine;
+    generator->target_gain = GAIN_MAX;
+    generator->phase = 0;
+    generator->gain = 0;
+
+    for(size_t i = 0; i < SINE_SIZE; i++) {
+        generator->sine[i] = sinf(i * 2 * (float)M_PI / SINE_SIZE) * INT16_MAX;
+    }
+    return generator;
+}
+
+void tone_generator_free(ToneGenerator* generator) {
+    furi_assert(generator);
+    tone_generator_stop(generator);
+    free(generator);
+}
+
+bool tone_generator_start(ToneGenerator* generator) {
+    furi_assert(generator);
+    if(generator->running) return true;
+    if(!furi_hal_speaker_acquire(1000)) return false;
+
+    // fade in from silence
+    generator->gain = 0;
+    generator->phase = 0;
+    tone_generator_fill(generator, generator->buffer);
+    tone_generator_fill(generator, generator->buffer + BUFFER_LENGTH / 2);
+
+    LL_TIM_InitTypeDef tim_init = {0};
+    tim_init.Prescaler = PWM_PRESCALER;
+    tim_init.Autoreload = PWM_AUTORELOAD;
+    LL_TIM_Init(SPEAKER_TIMER, &tim_init);
+
+    LL_TIM_OC_InitTypeDef oc_init = {0};
+    oc_init.OCMode = LL_TIM_OCMODE_PWM1;
+    oc_init.OCState = LL_TIM_OCSTATE_ENABLE;
+    oc_init.CompareValue = PWM_CENTER;
+    LL_TIM_OC_Init(SPEAKER_TIMER, SPEAKER_CHANNEL, &oc_init);
+
+    LL_DMA_ConfigAddresses(
+        DMA_INSTANCE,
+        (uint32_t)generator->buffer,
+        (uint32_t) & (SPEAKER_TIMER->CCR1),
+        LL_DMA_DIRECTION_MEMORY_TO_PERIPH);
+    LL_DMA_SetDataLength(DMA_INSTANCE, BUFFER_LENGTH);
+    LL_DMA_SetPeriphRequest(DMA_INSTANCE, LL_DMAMUX_REQ_TIM16_UP);
+    LL_DMA_SetDataTransferDirection(DMA_INSTANCE, LL_DMA_DIRECTION_MEMORY_TO_PERIPH);
+    LL_DMA_SetChannelPriorityLevel(DMA_INSTANCE, LL_DMA_PRIORITY_VERYHIGH);
+    LL_DMA_SetMode(DMA_INSTANCE, LL_DMA_MODE_CIRCULAR);
+    LL_DMA_SetPeriphIncMode(DMA_INSTANCE, LL_DMA_PERIPH_NOINCREMENT);
+    LL_DMA_SetMemoryIncMode(DMA_INSTANCE, LL_DMA_MEMORY_INCREMENT);
+    LL_DMA_SetPeriphSize(DMA_INSTANCE, LL_DMA_PDATAALIGN_HALFWORD);
+    LL_DMA_SetMemorySize(DMA_INSTANCE, LL_DMA_MDATAALIGN_HALFWORD);
+    LL_DMA_ClearFlag_HT1(DMA1);
+    LL_DMA_ClearFlag_TC1(DMA1);
+    LL_DMA_EnableIT_TC(DMA_INSTANCE);
+    LL_DMA_EnableIT_HT(DMA_INSTANCE);
+
+    furi_hal_interrupt_set_isr(FuriHalInterruptIdDma1Ch1, tone_generator_dma_isr, generator);
+    LL_DMA_EnableChannel(DMA_INSTANCE);
+    LL_TIM_EnableDMAReq_UPDATE(SPEAKER_TIMER);
+    LL_TIM_EnableAllOutputs(SPEAKER_TIMER);
+    LL_TIM_EnableCounter(SPEAKER_TIMER);
+
+    generator->running = true;
+    return true;
+}
+
+void tone_generator_stop(ToneGenerator* generator) {
+    furi_assert(generator);
+    if(!generator->running) return;
+
+    // fade out before cutting the PWM, the ramp takes at most a buffer and a bit
+    int32_t target_gain = generator->target_gain;
+    generator->target_gain = 0;
+    furi_delay_ms(RAMP_MS + BUFFER_LENGTH * 1000 / SAMPLE_RATE);
+
+    LL_TIM_DisableAllOutputs(SPEAKER_TIMER);
+    LL_TIM_DisableCounter(SPEAKER_TIMER);
+    LL_TIM_DisableDMAReq_UPDATE(SPEAKER_TIMER);
+    LL_DMA_DisableChannel(DMA_INSTANCE);
+    LL_DMA_DisableIT_TC(DMA_INSTANCE);
+    LL_DMA_DisableIT_HT(DMA_INSTANCE);
+    furi_hal_interrupt_set_isr(FuriHalInterruptIdDma1Ch1, NULL, NULL);
+    furi_hal_speaker_release();
+
+    generator->target_gain = target_gain;
+    generator->running = false;
+}
+
+void tone_generator_set_frequency(ToneGenerator* generator, float frequency) {
+    furi_assert(generator);
+    // 2^32 steps make a turn, double keeps the step exact to the last bit
+    uint32_t phase_step = 0;
+    if(frequency > 0) phase_step = frequency * 4294967296.0 / SAMPLE_RATE;
+    generator->phase_step = phase_step;
+}
+
+void tone_generator_set_volume(ToneGenerator* generator, float volume) {
+    furi_assert(generator);
+    generator->target_gain = CLAMP(volume, 1.0f, 0.0f) * GAIN_MAX;
+}
+
+void tone_generator_set_waveform(ToneGenerator* generator, ToneWaveform waveform) {
+    furi_assert(generator);
+    furi_assert(waveform < ToneWaveformCount);
+    generator->waveform = waveform;
+}
+
+const char* tone_generator_waveform_name(ToneWaveform waveform) {
+    furi_assert(waveform < ToneWaveformCount);
+    return tone_waveform_names[waveform];
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <furi.h>
+
+// Plays a tone on the speaker as 8-bit PWM samples fed by DMA. A 32-bit phase accumulator
+// steps through a waveform table, so the pitch is exact to a small fraction of a cent
+// instead of whatever the speaker timer's divider can hit. Changes of pitch, waveform and
+// volume are made on the fly without restarting the tone.
+
+typedef enum {
+    ToneWaveformSine,
+    ToneWaveformHarmonic, // sine with its 2nd and 3rd harmonics, easier to hear on low notes
+    ToneWaveformTriangle,
+    ToneWaveformSquare,
+    ToneWaveformCount,
+} ToneWaveform;
+
+typedef struct ToneGenerator ToneGenerator;
+
+ToneGenerator* tone_generator_alloc();
+void tone_generator_free(ToneGenerator* generator);
+
+// false if the speaker is busy
+bool tone_generator_start(ToneGenerator* generator);
+void tone_generator_stop(ToneGenerator* generator);
+
+void tone_generator_set_frequency(ToneGenerator* generator, float frequency);
+void tone_generator_set_volume(ToneGenerator* generator, float volume);
+void tone_generator_set_waveform(ToneGenerator* generator, ToneWaveform waveform);
+
+const char* tone_generator_waveform_name(ToneWaveform waveform);
@@ -0,0 +1,144 @@
+#include "tuner.h"
+#include "pitch_detector.h"
+
+#include <furi_hal.h>
+#include <string.h>
+
+#define TUNER_PIN (&gpio_ext_pa6)
+// holds a frame of a high note with a few overtone crossings per period
+#define EDGE_RING_SIZE 1024
+#define TUNER_INTERVAL_MS 100
+#define TUNER_HISTORY 3
+
+typedef enum {
+    TunerEvtStop = (1 << 0),
+} TunerEvtFlags;
+
+struct Tuner {
+    TunerCallback callback;
+    void* context;
+    FuriThread* thread;
+    bool running;
+
+    // the interrupt keeps writing over the oldest edges, the worker only looks at the newest
+    uint32_t edges[EDGE_RING_SIZE];
+    volatile uint32_t head;
+
+    uint32_t frame[EDGE_RING_SIZE];
+    PitchDetector detector;
+    float history[TUNER_HISTORY];
+};
+
+static void tuner_edge_callback(void* context) {
+    uint32_t cycles = DWT->CYCCNT;
+    Tuner* tuner = context;
+
+    uint32_t head = tuner->head;
+    tuner->edges[head % EDGE_RING_SIZE] = PITCH_EDGE(cycles, furi_hal_gpio_read(TUNER_PIN));
+    tuner->head = head + 1;
+}
+
+// Pitch of the last frame, 0 if there is none
+static float tuner_measure(Tuner* tuner) {
+    uint32_t head = tuner->head;
+    uint32_t ticks_per_us = furi_hal_cortex_instructions_per_microsecond();
+    uint32_t start = DWT->CYCCNT - PITCH_FRAME_US * ticks_per_us;
+
+    uint32_t available = MIN(head, EDGE_RING_SIZE);
+    uint32_t count = 0;
+    while(count < available) {
+        uint32_t edge = tuner->edges[(head - 1 - count) % EDGE_RING_SIZE];
+        if((int32_t)(PITCH_EDGE_TIME(edge) - start) < 0) break;
+        count++;
+    }
+    // more edges than that is noise
+    if(count == EDGE_RING_SIZE) return 0;
+
+    bool level;
+    if(count < available) {
+        level = PITCH_EDGE_LEVEL(tuner->edges[(head - 1 - count) % EDGE_RING_SIZE]);
+    } else if(count) {
+        level = !PITCH_EDGE_LEVEL(tuner->edges[(head - count) % EDGE_RING_SIZE]);
+    } else {
+        return 0;
+    }
+
+    for(uint32_t i = 0; i < count; i++) {
+        tuner->frame[i] = tuner->edges[(head - count + i) % EDGE_RING_SIZE];
+    }
+    return pitch_detector_run(&tuner->detector, tuner->frame, count, level, start, ticks_per_us);
+}
+
+// Median of the last few readings, so a single octave slip doesn't move the needle
+static float tuner_filter(Tuner* tuner, float frequency) {
+    memmove(tuner->history + 1, tuner->history, sizeof(float) * (TUNER_HISTORY - 1));
+    tuner->history[0] = frequency;
+
+    float a = tuner->history[0];
+    float b = tuner->history[1];
+    float c = tuner->history[2];
+    if(a == 0 || b == 0 || c == 0) return frequency;
+    if((a <= b && b <= c) || (c <= b && b <= a)) return b;
+    if((b <= a && a <= c) || (c <= a && a <= b)) return a;
+    return c;
+}
+
+static int32_t tuner_worker(void* context) {
+    Tuner* tuner = context;
+
+    while(1) {
+        uint32_t events =
+            furi_thread_flags_wait(TunerEvtStop, FuriFlagWaitAny, TUNER_INTERVAL_MS);
+        if(events != (uint32_t)FuriFlagErrorTimeout) {
+            furi_check((events & FuriFlagError) == 0);
+            if(events & TunerEvtStop) break;
+        }
+
+        float frequency = tuner_filter(tuner, tuner_measure(tuner));
+        tuner->callback(frequency, tuner->context);
+    }
+
+    return 0;
+}
+
+Tuner* tuner_alloc(TunerCallback callback, void* context) {
+    furi_assert(callback);
+    Tuner* tuner = malloc(sizeof(Tuner));
+    tuner->callback = callback;
+    tuner->context = context;
+    tuner->running = false;
+    tuner->thread = furi_thread_alloc_ex("Tuner", 1024, tuner_worker, tuner);
+    return tuner;
+}
+
+void tuner_free(Tuner* tuner) {
+    furi_assert(tuner);
+    tuner_stop(tuner);
+    furi_thread_free(tuner->thread);
+    free(tuner);
+}
+
+void tuner_start(Tuner* tuner) {
+    furi_assert(tuner);
+    if(tuner->running) return;
+
+    tuner->head = 0;
+    memset(tuner->history, 0, sizeof(tuner->history));
+
+    furi_hal_gpio_init(TUNER_PIN, GpioModeInterruptRiseFall, GpioPullNo, GpioSpeedVeryHigh);
+    furi_thread_start(tuner->thread);
+    tuner->running = true;
+    furi_hal_gpio_add_int_callback(TUNER_PIN, tuner_edge_callback, tuner);
+}
+
+void tuner_stop(Tuner* tuner) {
+    furi_assert(tuner);
+    if(!tuner->running) return;
+
+    furi_hal_gpio_remove_int_callback(TUNER_PIN);
+    furi_hal_gpio_init(TUNER_PIN, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
+
+    furi_thread_flags_set(furi_thread_get_id(tuner->thread), TunerEvtStop);
+    furi_thread_join(tuner->thread);
+    tuner->running = false;
+}
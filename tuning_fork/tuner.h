@@ -0,0 +1,17 @@
+#pragma once
+
+#include <furi.h>
+
+// Listens to a microphone through a comparator on GPIO pin 3 (A6) and reports the pitch a
+// few times a second. The edges are timestamped in the interrupt with the cycle counter.
+
+// Called from the tuner's thread, frequency is 0 while there is no clear pitch
+typedef void (*TunerCallback)(float frequency, void* context);
+
+typedef struct Tuner Tuner;
+
+Tuner* tuner_alloc(TunerCallback callback, void* context);
+void tuner_free(Tuner* tuner);
+
+void tuner_start(Tuner* tuner);
+void tuner_stop(Tuner* tuner);
@@ -3,6 +3,7 @@
 #include <input/input.h>
 #include <string.h>
 #include <stdlib.h>
+#include <math.h>
 
 #include <gui/gui.h>
 #include <gui/elements.h>
@@ -13,6 +14,8 @@
 
 #include "notes.h"
 #include "tunings.h"
+#include "tone_generator.h"
+#include "tuner.h"
 
 typedef enum {
     EventTypeTick,
@@ -24,7 +27,10 @@ typedef struct {
     InputEvent input;
 } PluginEvent;
 
-enum Page { Tunings, Notes };
+enum Page { Tunings, Notes, Listen };
+
+// the tuner's needle covers this much either way
+#define TUNER_RANGE_CENTS 50
 
 typedef struct {
     FuriMutex* mutex;
@@ -34,6 +40,13 @@ typedef struct {
     int current_tuning_index;
     float volume;
     TUNING tuning;
+    ToneWaveform waveform;
+    ToneGenerator* tone;
+    Tuner* tuner;
+    // the note the tuner compares against, -1 picks the closest one
+    int tuner_note_index;
+    // written by the tuner's thread
+    volatile float tuner_frequency;
 } TuningForkState;
 
 static TUNING current_tuning(TuningForkState* tuningForkState) {
@@ -113,23 +126,158 @@ static void decrease_volume(TuningForkState* tuning_fork_state) {
     }
 }
 
+static void next_waveform(TuningForkState* tuning_fork_state) {
+    tuning_fork_state->waveform = (tuning_fork_state->waveform + 1) % ToneWaveformCount;
+    tone_generator_set_waveform(tuning_fork_state->tone, tuning_fork_state->waveform);
+}
+
+static void prev_waveform(TuningForkState* tuning_fork_state) {
+    tuning_fork_state->waveform =
+        (tuning_fork_state->waveform + ToneWaveformCount - 1) % ToneWaveformCount;
+    tone_generator_set_waveform(tuning_fork_state->tone, tuning_fork_state->waveform);
+}
+
 static void play(TuningForkState* tuning_fork_state) {
-    if(furi_hal_speaker_is_mine() || furi_hal_speaker_acquire(1000)) {
-        furi_hal_speaker_start(
-            current_tuning_note_freq(tuning_fork_state), tuning_fork_state->volume);
+    tone_generator_set_frequency(
+        tuning_fork_state->tone, current_tuning_note_freq(tuning_fork_state));
+    tone_generator_set_volume(tuning_fork_state->tone, tuning_fork_state->volume);
+    tone_generator_start(tuning_fork_state->tone);
+}
+
+static void stop(TuningForkState* tuning_fork_state) {
+    tone_generator_stop(tuning_fork_state->tone);
+}
+
+// The tone follows the new note and volume without being restarted
+static void replay(TuningForkState* tuning_fork_state) {
+    tone_generator_set_frequency(
+        tuning_fork_state->tone, current_tuning_note_freq(tuning_fork_state));
+    tone_generator_set_volume(tuning_fork_state->tone, tuning_fork_state->volume);
+}
+
+static void tuner_callback(float frequency, void* context) {
+    TuningForkState* tuning_fork_state = context;
+    // a float store is atomic, taking the mutex here could deadlock with tuner_stop
+    tuning_fork_state->tuner_frequency = frequency;
+}
+
+static void enter_tuner(TuningForkState* tuning_fork_state) {
+    // the speaker would only be heard by the microphone
+    tuning_fork_state->playing = false;
+    stop(tuning_fork_state);
+    tuning_fork_state->tuner_note_index = -1;
+    tuning_fork_state->tuner_frequency = 0;
+    tuner_start(tuning_fork_state->tuner);
+    tuning_fork_state->page = Listen;
+}
+
+static void exit_tuner(TuningForkState* tuning_fork_state) {
+    tuner_stop(tuning_fork_state->tuner);
+    tuning_fork_state->page = Notes;
+}
+
+static void next_tuner_note(TuningForkState* tuning_fork_state) {
+    if(tuning_fork_state->tuner_note_index == tuning_fork_state->tuning.notes_length - 1) {
+        tuning_fork_state->tuner_note_index = -1;
+    } else {
+        tuning_fork_state->tuner_note_index += 1;
     }
 }
 
-static void stop() {
-    if(furi_hal_speaker_is_mine()) {
-        furi_hal_speaker_stop();
-        furi_hal_speaker_release();
+static void prev_tuner_note(TuningForkState* tuning_fork_state) {
+    if(tuning_fork_state->tuner_note_index == -1) {
+        tuning_fork_state->tuner_note_index = tuning_fork_state->tuning.notes_length - 1;
+    } else {
+        tuning_fork_state->tuner_note_index -= 1;
     }
 }
 
-static void replay(TuningForkState* tuning_fork_state) {
-    stop();
-    play(tuning_fork_state);
+static float cents_between(float frequency, float reference) {
+    return 1200.0f * log2f(frequency / reference);
+}
+
+// The chosen note, or the one closest to the frequency in auto mode
+static int tuner_target_note(TuningForkState* tuning_fork_state, float frequency) {
+    if(tuning_fork_state->tuner_note_index >= 0) return tuning_fork_state->tuner_note_index;
+
+    TUNING* tuning = &tuning_fork_state->tuning;
+    int closest = 0;
+    for(int i = 1; i < tuning->notes_length; ++i) {
+        float distance = fabsf(cents_between(frequency, tuning->notes[i].frequency));
+        if(distance < fabsf(cents_between(frequency, tuning->notes[closest].frequency))) {
+            closest = i;
+        }
+    }
+    return closest;
+}
+
+static void render_tuner(Canvas* const canvas, TuningForkState* tuning_fork_state) {
+    FuriString* tempStr = furi_string_alloc();
+    float frequency = tuning_fork_state->tuner_frequency;
+    int note_index = tuner_target_note(tuning_fork_state, frequency);
+    NOTE* note = &tuning_fork_state->tuning.notes[note_index];
+
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str_aligned(
+        canvas, 64, 8, AlignCenter, AlignCenter, tuning_fork_state->tuning.label);
+    if(tuning_fork_state->tuner_note_index < 0 && frequency == 0) {
+        furi_string_printf(tempStr, "< Auto >");
+    } else {
+        furi_string_printf(tempStr, "< %s >", note->label);
+    }
+    canvas_draw_str_aligned(
+        canvas, 64, 20, AlignCenter, AlignCenter, furi_string_get_cstr(tempStr));
+
+    // one pixel per cent
+    canvas_draw_line(canvas, 64 - TUNER_RANGE_CENTS, 34, 64 + TUNER_RANGE_CENTS, 34);
+    canvas_draw_line(canvas, 64, 29, 64, 39);
+    canvas_draw_line(canvas, 64 - TUNER_RANGE_CENTS / 2, 32, 64 - TUNER_RANGE_CENTS / 2, 36);
+    canvas_draw_line(canvas, 64 + TUNER_RANGE_CENTS / 2, 32, 64 + TUNER_RANGE_CENTS / 2, 36);
+
+    canvas_set_font(canvas, FontSecondary);
+    if(frequency > 0) {
+        float cents = cents_between(frequency, note->frequency);
+        int needle = CLAMP(cents, TUNER_RANGE_CENTS, -TUNER_RANGE_CENTS);
+        canvas_draw_box(canvas, 64 + needle - 1, 29, 3, 11);
+        furi_string_printf(
+            tempStr,
+            "%s%.1f Hz  %+.1f c",
+            tuning_fork_state->tuner_note_index < 0 ? "Auto  " : "",
+            (double)frequency,
+            (double)cents);
+    } else {
+        furi_string_printf(tempStr, "Listening on pin 3");
+    }
+    canvas_draw_str_aligned(
+        canvas, 64, 46, AlignCenter, AlignCenter, furi_string_get_cstr(tempStr));
+
+    elements_button_left(canvas, "Prev");
+    elements_button_right(canvas, "Next");
+
+    furi_string_free(tempStr);
+}
+
+static void tuner_input(TuningForkState* tuning_fork_state, InputEvent* input) {
+    if(input->type != InputTypeShort && input->type != InputTypeRepeat &&
+       input->type != InputTypeLong) {
+        return;
+    }
+
+    switch(input->key) {
+    case InputKeyRight:
+        next_tuner_note(tuning_fork_state);
+        break;
+    case InputKeyLeft:
+        prev_tuner_note(tuning_fork_state);
+        break;
+    case InputKeyBack:
+        if(input->type == InputTypeShort) {
+            exit_tuner(tuning_fork_state);
+        }
+        break;
+    default:
+        break;
+    }
 }
 
 static void render_callback(Canvas* const canvas, void* ctx) {
@@ -141,6 +289,13 @@ static void render_callback(Canvas* const canvas, void* ctx) {
 
     canvas_draw_frame(canvas, 0, 0, 128, 64);
 
+    if(tuning_fork_state->page == Listen) {
+        render_tuner(canvas, tuning_fork_state);
+        furi_string_free(tempStr);
+        furi_mutex_release(tuning_fork_state->mutex);
+        return;
+    }
+
     canvas_set_font(canvas, FontPrimary);
 
     if(tuning_fork_state->page == Tunings) {
@@ -148,7 +303,14 @@ static void render_callback(Canvas* const canvas, void* ctx) {
         current_tuning_label(tuning_fork_state, tuningLabel);
         furi_string_printf(tempStr, "< %s >", tuningLabel);
         canvas_draw_str_aligned(
-            canvas, 64, 28, AlignCenter, AlignCenter, furi_string_get_cstr(tempStr));
+            canvas, 64, 24, AlignCenter, AlignCenter, furi_string_get_cstr(tempStr));
+        furi_string_reset(tempStr);
+
+        canvas_set_font(canvas, FontSecondary);
+        furi_string_printf(
+            tempStr, "Wave: %s", tone_generator_waveform_name(tuning_fork_state->waveform));
+        canvas_draw_str_aligned(
+            canvas, 64, 38, AlignCenter, AlignCenter, furi_string_get_cstr(tempStr));
         furi_string_reset(tempStr);
     } else {
         char tuningLabel[20];
@@ -201,6 +363,9 @@ static void tuning_fork_state_init(TuningForkState* const tuning_fork_state) {
     tuning_fork_state->tuning = GuitarStandard6;
     tuning_fork_state->current_tuning_index = 2;
     tuning_fork_state->current_tuning_note_index = 0;
+    tuning_fork_state->waveform = ToneWaveformSine;
+    tuning_fork_state->tuner_note_index = -1;
+    tuning_fork_state->tuner_frequency = 0;
 }
 
 int32_t tuning_fork_app() {
@@ -216,6 +381,10 @@ int32_t tuning_fork_app() {
         return 255;
     }
 
+    tuning_fork_state->tone = tone_generator_alloc();
+    tone_generator_set_waveform(tuning_fork_state->tone, tuning_fork_state->waveform);
+    tuning_fork_state->tuner = tuner_alloc(tuner_callback, tuning_fork_state);
+
     // Set system callbacks
     ViewPort* view_port = view_port_alloc();
     view_port_draw_callback_set(view_port, render_callback, tuning_fork_state);
@@ -232,7 +401,9 @@ int32_t tuning_fork_app() {
 
         if(event_status == FuriStatusOk) {
             if(event.type == EventTypeKey) {
-                if(event.input.type == InputTypeShort) {
+                if(tuning_fork_state->page == Listen) {
+                    tuner_input(tuning_fork_state, &event.input);
+                } else if(event.input.type == InputTypeShort) {
                     // push events
                     switch(event.input.key) {
                     case InputKeyUp:
@@ -241,6 +412,8 @@ int32_t tuning_fork_app() {
                             if(tuning_fork_state->playing) {
                                 replay(tuning_fork_state);
                             }
+                        } else {
+                            next_waveform(tuning_fork_state);
                         }
                         break;
                     case InputKeyDown:
@@ -249,6 +422,8 @@ int32_t tuning_fork_app() {
                             if(tuning_fork_state->playing) {
                                 replay(tuning_fork_state);
                             }
+                        } else {
+                            prev_waveform(tuning_fork_state);
                         }
                         break;
                     case InputKeyRight:
@@ -279,7 +454,7 @@ int32_t tuning_fork_app() {
                             if(tuning_fork_state->playing) {
                                 play(tuning_fork_state);
                             } else {
-                                stop();
+                                stop(tuning_fork_state);
                             }
                         }
                         break;
@@ -289,7 +464,7 @@ int32_t tuning_fork_app() {
                         } else {
                             tuning_fork_state->playing = false;
                             tuning_fork_state->current_tuning_note_index = 0;
-                            stop();
+                            stop(tuning_fork_state);
                             tuning_fork_state->page = Tunings;
                         }
                         break;
@@ -326,13 +501,16 @@ int32_t tuning_fork_app() {
 
                         break;
                     case InputKeyOk:
+                        if(tuning_fork_state->page == Notes) {
+                            enter_tuner(tuning_fork_state);
+                        }
                         break;
                     case InputKeyBack:
                         if(tuning_fork_state->page == Tunings) {
                             processing = false;
                         } else {
                             tuning_fork_state->playing = false;
-                            stop();
+                            stop(tuning_fork_state);
                             tuning_fork_state->page = Tunings;
                             tuning_fork_state->current_tuning_note_index = 0;
                         }
@@ -376,7 +554,7 @@ int32_t tuning_fork_app() {
                             processing = false;
                         } else {
                             tuning_fork_state->playing = false;
-                            stop();
+                            stop(tuning_fork_state);
                             tuning_fork_state->page = Tunings;
                             tuning_fork_state->current_tuning_note_index = 0;
                         }
@@ -396,6 +574,8 @@ int32_t tuning_fork_app() {
     gui_remove_view_port(gui, view_port);
     furi_record_close("gui");
     view_port_free(view_port);
+    tuner_free(tuning_fork_state->tuner);
+    tone_generator_free(tuning_fork_state->tone);
     furi_message_queue_free(event_queue);
     furi_mutex_free(tuning_fork_state->mutex);
     furi_record_close(RECORD_NOTIFICATION);
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <storage/storage.h>
+
+// Ring buffered writer that moves storage_file_write() off the UART worker.
+// Data is flushed by its own low priority thread in whole chunks, bytes that do not fit
+// in the ring are dropped and counted instead of stalling the producer.
+typedef struct BufferedFileWriter BufferedFileWriter;
+
+// The card is written in chunks of this size, or of half the ring if that is smaller
+#define BUFFERED_FILE_WRITER_CHUNK_SIZE (4096)
+#define BUFFERED_FILE_WRITER_MIN_SIZE (1024)
+// Default for how long data may wait in the ring before a partial chunk is written
+#define BUFFERED_FILE_WRITER_FLUSH_MS (1000)
+
+// Called on the writer thread once everything before the rotation point is written.
+// It closes the file and opens the next one on the same File, a header for it can be
+// written there directly. Returns false if there is no next file, the data is then lost.
+typedef bool (*BufferedFileWriterRotateCallback)(File* file, void* context);
+
+// size is a power of two of at least BUFFERED_FILE_WRITER_MIN_SIZE
+BufferedFileWriter* buffered_file_writer_alloc(File* file, size_t size, const char* name);
+
+// Writes out everything still buffered, the file itself is left open
+void buffered_file_writer_free(BufferedFileWriter* writer);
+
+// Partial chunks are written once data waited this long, call before the first write
+void buffered_file_writer_set_flush_interval(BufferedFileWriter* writer, uint32_t ms);
+
+// Moves on to the next file once this one holds max_size bytes or is max_ms old, 0 turns a
+// limit off. Files are only switched between two write() calls, so a chunk passed to one
+// call never spans two files. Call before the first write.
+void buffered_file_writer_set_rotation(
+    BufferedFileWriter* writer,
+    size_t max_size,
+    uint32_t max_ms,
+    BufferedFileWriterRotateCallback callback,
+    void* context);
+
+// Safe to call from one producer thread, returns false if the chunk was dropped
+bool buffered_file_writer_write(BufferedFileWriter* writer, const uint8_t* data, size_t len);
+
+uint32_t buffered_file_writer_get_dropped(BufferedFileWriter* writer);
@@ -0,0 +1,96 @@
+#include "../uart_terminal_app_i.h"
+
+// The status is redrawn every this many 100 ms ticks
+#define CAPTURE_STATUS_TICKS (5)
+
+static void uart_terminal_capture_handle_rx_data_cb(uint8_t* buf, size_t len, void* context) {
+    furi_assert(context);
+    UART_TerminalApp* app = context;
+
+    // Nothing is rendered per chunk, so high baudrates are limited by the SD card only
+    uart_capture_feed(app->capture, buf, len);
+}
+
+static void uart_terminal_scene_capture_update_status(UART_TerminalApp* app) {
+    uint32_t now = furi_get_tick();
+    uint32_t bytes = uart_capture_get_bytes(app->capture);
+    uint32_t elapsed = now - app->capture_status_tick;
+    uint32_t rate = elapsed ? (bytes - app->capture_status_bytes) * 1000 / elapsed : 0;
+    app->capture_status_tick = now;
+    app->capture_status_bytes = bytes;
+
+    furi_string_printf(
+        app->capture_status,
+        "Capturing at %d baud\n%s\n\nRate: %lu B/s\nTotal: %lu bytes\nDropped: %lu bytes\n\nPress BACK to stop\n",
+        app->BAUDRATE,
+        uart_capture_get_path(app->capture),
+        rate,
+        bytes,
+        uart_capture_get_dropped(app->capture));
+    text_box_set_text(app->text_box, furi_string_get_cstr(app->capture_status));
+}
+
+void uart_terminal_scene_capture_on_enter(void* context) {
+    UART_TerminalApp* app = context;
+
+    int baudrate = atoi(app->selected_tx_string);
+    if(baudrate > 0 && app->BAUDRATE != baudrate) {
+        uart_terminal_uart_free(app->uart);
+        app->BAUDRATE = baudrate;
+        app->uart = uart_terminal_uart_init(app);
+    }
+
+    TextBox* text_box = app->text_box;
+    text_box_reset(text_box);
+    text_box_set_font(text_box, TextBoxFontText);
+    text_box_set_focus(text_box, TextBoxFocusStart);
+
+    app->capture = uart_capture_alloc(furi_record_open(RECORD_STORAGE), app->BAUDRATE);
+    if(app->capture) {
+        app->capture_status_tick = furi_get_tick();
+        app->capture_status_bytes = 0;
+        uart_terminal_scene_capture_update_status(app);
+        uart_terminal_uart_set_handle_rx_data_cb(
+            app->uart, uart_terminal_capture_handle_rx_data_cb);
+    } else {
+        text_box_set_text(text_box, "Cannot create capture file\n\nIs the SD card inserted?\n");
+    }
+
+    scene_manager_set_scene_state(app->scene_manager, UART_TerminalSceneCapture, 0);
+    view_dispatcher_switch_to_view(app->view_dispatcher, UART_TerminalAppViewConsoleOutput);
+}
+
+bool uart_terminal_scene_capture_on_event(void* context, SceneManagerEvent event) {
+    UART_TerminalApp* app = context;
+
+    bool consumed = false;
+
+    if(event.type == SceneManagerEventTypeCustom) {
+        consumed = true;
+    } else if(event.type == SceneManagerEventTypeTick) {
+        uint32_t ticks = scene_manager_get_scene_state(app->scene_manager, UART_TerminalSceneCapture);
+        if(app->capture && ++ticks >= CAPTURE_STATUS_TICKS) {
+            uart_terminal_scene_capture_update_status(app);
+            ticks = 0;
+        }
+        scene_manager_set_scene_state(app->scene_manager, UART_TerminalSceneCapture, ticks);
+        consumed = true;
+    }
+
+    return consumed;
+}
+
+void uart_terminal_scene_capture_on_exit(void* context) {
+    UART_TerminalApp* app = context;
+
+    // Unregister rx callback before the capture goes away
+    uart_terminal_uart_set_handle_rx_data_cb(app->uart, NULL);
+
+    if(app->capture) {
+        uart_capture_free(app->capture);
+        app->capture = NULL;
+    }
+    furi_record_close(RECORD_STORAGE);
+
+    text_box_reset(app->text_box);
+}
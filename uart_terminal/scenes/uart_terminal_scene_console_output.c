@@ -4,19 +4,8 @@ void uart_terminal_console_output_handle_rx_data_cb(uint8_t* buf, size_t len, vo
     furi_assert(context);
     UART_TerminalApp* app = context;
 
-    // If text box store gets too big, then truncate it
-    app->text_box_store_strlen += len;
-    if(app->text_box_store_strlen >= UART_TERMINAL_TEXT_BOX_STORE_SIZE - 1) {
-        furi_string_right(app->text_box_store, app->text_box_store_strlen / 2);
-        app->text_box_store_strlen = furi_string_size(app->text_box_store) + len;
-    }
-
-    // Null-terminate buf and append to text box store
-    buf[len] = '\0';
-    furi_string_cat_printf(app->text_box_store, "%s", buf);
-
-    view_dispatcher_send_custom_event(
-        app->view_dispatcher, UART_TerminalEventRefreshConsoleOutput);
+    // Shown by the next tick
+    text_box_store_append(app->text_box_store, (char*)buf, len);
 }
 
 void uart_terminal_scene_console_output_on_enter(void* context) {
@@ -162,25 +151,22 @@ void uart_terminal_scene_console_output_on_enter(void* context) {
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
     if(app->is_command) {
-        furi_string_reset(app->text_box_store);
-        app->text_box_store_strlen = 0;
+        text_box_store_reset(app->text_box_store);
 
         if(0 == strncmp("help", app->selected_tx_string, strlen("help"))) {
             const char* help_msg =
                 "UART terminal for Flipper\n\nI'm in github: cool4uma\n\nThis app is a modified\nWiFi Marauder companion,\nThanks 0xchocolate(github)\nfor great code and app.\n\n";
-            furi_string_cat_str(app->text_box_store, help_msg);
-            app->text_box_store_strlen += strlen(help_msg);
+            text_box_store_append_str(app->text_box_store, help_msg);
         }
 
         if(app->show_stopscan_tip) {
             const char* help_msg = "Press BACK to return\n";
-            furi_string_cat_str(app->text_box_store, help_msg);
-            app->text_box_store_strlen += strlen(help_msg);
+            text_box_store_append_str(app->text_box_store, help_msg);
         }
     }
 
     // Set starting text - for "View Log", this will just be what was already in the text box store
-    text_box_set_text(app->text_box, furi_string_get_cstr(app->text_box_store));
+    text_box_store_show(app->text_box_store, app->text_box);
 
     scene_manager_set_scene_state(app->scene_manager, UART_TerminalSceneConsoleOutput, 0);
     view_dispatcher_switch_to_view(app->view_dispatcher, UART_TerminalAppViewConsoleOutput);
@@ -209,9 +195,9 @@ bool uart_terminal_scene_console_output_on_event(void* context, SceneManagerEven
     bool consumed = false;
 
     if(event.type == SceneManagerEventTypeCustom) {
-        text_box_set_text(app->text_box, furi_string_get_cstr(app->text_box_store));
         consumed = true;
     } else if(event.type == SceneManagerEventTypeTick) {
+        text_box_store_update(app->text_box_store, app->text_box);
         consumed = true;
     }
 
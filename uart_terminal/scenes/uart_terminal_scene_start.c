@@ -44,8 +44,17 @@ const UART_TerminalItem items[NUM_MENU_ITEMS] = {
      FOCUS_CONSOLE_END,
      NO_TIP},
     {"Help", {""}, 1, {"help"}, NO_ARGS, FOCUS_CONSOLE_START, SHOW_STOPSCAN_TIP},
+    {"Capture",
+     {"115200", "230400", "460800", "921600", "1000000", "1500000", "2000000"},
+     7,
+     {"115200", "230400", "460800", "921600", "1000000", "1500000", "2000000"},
+     NO_ARGS,
+     FOCUS_CONSOLE_START,
+     NO_TIP},
 };
 
+#define CAPTURE_MENU_INDEX (NUM_MENU_ITEMS - 1)
+
 static void uart_terminal_scene_start_var_list_enter_callback(void* context, uint32_t index) {
     furi_assert(context);
     UART_TerminalApp* app = context;
@@ -66,7 +75,9 @@ static void uart_terminal_scene_start_var_list_enter_callback(void* context, uin
 
     bool needs_keyboard = (item->needs_keyboard == TOGGLE_ARGS) ? (selected_option_index != 0) :
                                                                   item->needs_keyboard;
-    if(needs_keyboard) {
+    if(index == CAPTURE_MENU_INDEX) {
+        view_dispatcher_send_custom_event(app->view_dispatcher, UART_TerminalEventStartCapture);
+    } else if(needs_keyboard) {
         view_dispatcher_send_custom_event(app->view_dispatcher, UART_TerminalEventStartKeyboard);
     } else {
         view_dispatcher_send_custom_event(app->view_dispatcher, UART_TerminalEventStartConsole);
@@ -126,6 +137,10 @@ bool uart_terminal_scene_start_on_event(void* context, SceneManagerEvent event)
             scene_manager_set_scene_state(
                 app->scene_manager, UART_TerminalSceneStart, app->selected_menu_index);
             scene_manager_next_scene(app->scene_manager, UART_TerminalAppViewConsoleOutput);
+        } else if(event.event == UART_TerminalEventStartCapture) {
+            scene_manager_set_scene_state(
+                app->scene_manager, UART_TerminalSceneStart, app->selected_menu_index);
+            scene_manager_next_scene(app->scene_manager, UART_TerminalSceneCapture);
         }
         consumed = true;
     } else if(event.type == SceneManagerEventTypeTick) {
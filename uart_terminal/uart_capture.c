@@ -0,0 +1,167 @@
+#include "uart_capture.h"
+#include "buffered_file_writer.h"
+
+#include <furi.h>
+#include <furi_hal.h>
+
+#define UART_CAPTURE_MAGIC "UARTCAP1"
+#define UART_CAPTURE_HEADER_SIZE (sizeof(UART_CAPTURE_MAGIC) - 1 + 4)
+#define UART_CAPTURE_RECORD_HEADER_SIZE (6)
+#define UART_CAPTURE_MAX_CHUNK (512)
+// Past this the cycle counter may have wrapped, the tick count is used instead
+#define UART_CAPTURE_CYCLES_GAP_MS (30 * 1000)
+
+struct UART_TerminalCapture {
+    File* file;
+    BufferedFileWriter* writer;
+    FuriString* path;
+    // the parts after the first one, only touched by the writer thread
+    FuriString* part_path;
+    uint32_t part;
+    uint32_t baudrate;
+    uint32_t last_cycles;
+    uint32_t last_tick;
+    // cycles since the last record that are not yet a whole microsecond
+    uint32_t pending_cycles;
+    volatile uint32_t bytes;
+    uint8_t record[UART_CAPTURE_RECORD_HEADER_SIZE + UART_CAPTURE_MAX_CHUNK];
+};
+
+static void uart_capture_put_le(uint8_t* out, uint32_t value, size_t size) {
+    for(size_t i = 0; i < size; i++) {
+        out[i] = value >> (8 * i);
+    }
+}
+
+static size_t uart_capture_header(uint8_t* header, uint32_t baudrate) {
+    memcpy(header, UART_CAPTURE_MAGIC, sizeof(UART_CAPTURE_MAGIC) - 1);
+    uart_capture_put_le(&header[sizeof(UART_CAPTURE_MAGIC) - 1], baudrate, 4);
+    return UART_CAPTURE_HEADER_SIZE;
+}
+
+// A full file goes on in capture_N.1.bin, capture_N.2.bin..., each with its own header
+static bool uart_capture_rotate(File* file, void* context) {
+    UART_TerminalCapture* capture = context;
+
+    storage_file_close(file);
+
+    // path minus the ".bin"
+    furi_string_set(capture->part_path, capture->path);
+    furi_string_left(capture->part_path, furi_string_size(capture->path) - 4);
+    furi_string_cat_printf(capture->part_path, ".%lu.bin", ++capture->part);
+    if(!storage_file_open(
+           file, furi_string_get_cstr(capture->part_path), FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        return false;
+    }
+
+    uint8_t header[UART_CAPTURE_HEADER_SIZE];
+    size_t size = uart_capture_header(header, capture->baudrate);
+    return storage_file_write(file, header, size) == size;
+}
+
+UART_TerminalCapture* uart_capture_alloc(Storage* storage, uint32_t baudrate) {
+    storage_simply_mkdir(storage, UART_CAPTURE_FOLDER);
+
+    UART_TerminalCapture* capture = malloc(sizeof(UART_TerminalCapture));
+    capture->path = furi_string_alloc();
+    capture->part_path = furi_string_alloc();
+    capture->part = 0;
+    capture->baudrate = baudrate;
+    capture->file = storage_file_alloc(storage);
+
+    for(int i = 0;; i++) {
+        furi_string_printf(capture->path, "%s/capture_%d.bin", UART_CAPTURE_FOLDER, i);
+        if(!storage_file_exists(storage, furi_string_get_cstr(capture->path))) break;
+    }
+
+    if(!storage_file_open(
+           capture->file, furi_string_get_cstr(capture->path), FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        storage_file_free(capture->file);
+        furi_string_free(capture->part_path);
+        furi_string_free(capture->path);
+        free(capture);
+        return NULL;
+    }
+
+    capture->writer =
+        buffered_file_writer_alloc(capture->file, UART_CAPTURE_BUFFER_SIZE, "UART_TerminalCapture");
+    buffered_file_writer_set_rotation(
+        capture->writer, UART_CAPTURE_FILE_SIZE_MAX, 0, uart_capture_rotate, capture);
+
+    uint8_t header[UART_CAPTURE_HEADER_SIZE];
+    size_t size = uart_capture_header(header, baudrate);
+    buffered_file_writer_write(capture->writer, header, size);
+
+    capture->last_cycles = DWT->CYCCNT;
+    capture->last_tick = furi_get_tick();
+
+    return capture;
+}
+
+void uart_capture_free(UART_TerminalCapture* capture) {
+    furi_assert(capture);
+
+    buffered_file_writer_free(capture->writer);
+    storage_file_close(capture->file);
+    storage_file_free(capture->file);
+    furi_string_free(capture->part_path);
+    furi_string_free(capture->path);
+    free(capture);
+}
+
+// Microseconds since the previous call, from the cycle counter for short gaps
+static uint32_t uart_capture_elapsed_us(UART_TerminalCapture* capture) {
+    uint32_t cycles = DWT->CYCCNT;
+    uint32_t tick = furi_get_tick();
+    uint32_t per_us = furi_hal_cortex_instructions_per_microsecond();
+    uint32_t elapsed;
+
+    if(tick - capture->last_tick > UART_CAPTURE_CYCLES_GAP_MS) {
+        elapsed = (tick - capture->last_tick) * 1000;
+        capture->pending_cycles = 0;
+    } else {
+        uint32_t total = capture->pending_cycles + (cycles - capture->last_cycles);
+        elapsed = total / per_us;
+        capture->pending_cycles = total % per_us;
+    }
+
+    capture->last_cycles = cycles;
+    capture->last_tick = tick;
+    return elapsed;
+}
+
+void uart_capture_feed(UART_TerminalCapture* capture, const uint8_t* data, size_t len) {
+    furi_assert(capture);
+
+    uint32_t elapsed = uart_capture_elapsed_us(capture);
+    while(len > 0) {
+        size_t chunk = MIN(len, (size_t)UART_CAPTURE_MAX_CHUNK);
+        uart_capture_put_le(capture->record, elapsed, 4);
+        uart_capture_put_le(&capture->record[4], chunk, 2);
+        memcpy(&capture->record[UART_CAPTURE_RECORD_HEADER_SIZE], data, chunk);
+
+        // header and data go in together, or are dropped together
+        buffered_file_writer_write(
+            capture->writer, capture->record, UART_CAPTURE_RECORD_HEADER_SIZE + chunk);
+
+        capture->bytes += chunk;
+        elapsed = 0;
+        data += chunk;
+        len -= chunk;
+    }
+}
+
+uint32_t uart_capture_get_bytes(UART_TerminalCapture* capture) {
+    furi_assert(capture);
+    return capture->bytes;
+}
+
+uint32_t uart_capture_get_dropped(UART_TerminalCapture* capture) {
+    furi_assert(capture);
+    return buffered_file_writer_get_dropped(capture->writer);
+}
+
+const char* uart_capture_get_path(UART_TerminalCapture* capture) {
+    furi_assert(capture);
+    return furi_string_get_cstr(capture->path);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <storage/storage.h>
+
+#define UART_CAPTURE_FOLDER EXT_PATH("apps_data/uart_terminal")
+#define UART_CAPTURE_BUFFER_SIZE (32 * 1024)
+// A capture goes on in a new file once this one is this big
+#define UART_CAPTURE_FILE_SIZE_MAX (64 * 1024 * 1024)
+
+// Raw rx capture to a binary log, written by a BufferedFileWriter thread.
+//
+// File layout, little endian:
+//   header  "UARTCAP1", u32 baudrate
+//   record  u32 microseconds since the previous record, u16 length, length data bytes
+// A record holds one chunk as it came out of the DMA ring, so timestamps mark when the
+// rx worker picked the chunk up rather than when each byte arrived. Past
+// UART_CAPTURE_FILE_SIZE_MAX the capture goes on in capture_N.1.bin and so on, each part
+// starts with its own header and only holds whole records.
+typedef struct UART_TerminalCapture UART_TerminalCapture;
+
+// Opens the next free capture_N.bin, returns NULL if it cannot be created
+UART_TerminalCapture* uart_capture_alloc(Storage* storage, uint32_t baudrate);
+
+// Writes out what is buffered and closes the file
+void uart_capture_free(UART_TerminalCapture* capture);
+
+// Called from the rx worker for every received chunk
+void uart_capture_feed(UART_TerminalCapture* capture, const uint8_t* data, size_t len);
+
+uint32_t uart_capture_get_bytes(UART_TerminalCapture* capture);
+
+uint32_t uart_capture_get_dropped(UART_TerminalCapture* capture);
+
+const char* uart_capture_get_path(UART_TerminalCapture* capture);
@@ -1,4 +1,5 @@
 #include "uart_terminal_app_i.h"
+#include "profile.h"
 
 #include <furi.h>
 #include <furi_hal.h>
@@ -53,8 +54,8 @@ UART_TerminalApp* uart_terminal_app_alloc() {
     app->text_box = text_box_alloc();
     view_dispatcher_add_view(
         app->view_dispatcher, UART_TerminalAppViewConsoleOutput, text_box_get_view(app->text_box));
-    app->text_box_store = furi_string_alloc();
-    furi_string_reserve(app->text_box_store, UART_TERMINAL_TEXT_BOX_STORE_SIZE);
+    app->text_box_store = text_box_store_alloc(UART_TERMINAL_TEXT_BOX_STORE_SIZE);
+    app->capture_status = furi_string_alloc();
 
     app->text_input = text_input_alloc();
     view_dispatcher_add_view(
@@ -73,7 +74,8 @@ void uart_terminal_app_free(UART_TerminalApp* app) {
     view_dispatcher_remove_view(app->view_dispatcher, UART_TerminalAppViewConsoleOutput);
     view_dispatcher_remove_view(app->view_dispatcher, UART_TerminalAppViewTextInput);
     text_box_free(app->text_box);
-    furi_string_free(app->text_box_store);
+    text_box_store_free(app->text_box_store);
+    furi_string_free(app->capture_status);
     text_input_free(app->text_input);
 
     // View dispatcher
@@ -93,10 +95,12 @@ int32_t uart_terminal_app(void* p) {
     UART_TerminalApp* uart_terminal_app = uart_terminal_app_alloc();
 
     uart_terminal_app->uart = uart_terminal_uart_init(uart_terminal_app);
+    profile_start(); // "profile" CLI command in debug builds
 
     view_dispatcher_run(uart_terminal_app->view_dispatcher);
 
     uart_terminal_app_free(uart_terminal_app);
+    profile_stop();
 
     return 0;
 }
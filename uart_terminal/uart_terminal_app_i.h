@@ -4,6 +4,8 @@
 #include "scenes/uart_terminal_scene.h"
 #include "uart_terminal_custom_event.h"
 #include "uart_terminal_uart.h"
+#include "text_box_store.h"
+#include "uart_capture.h"
 
 #include <gui/gui.h>
 #include <gui/view_dispatcher.h>
@@ -14,7 +16,7 @@
 
 #include <xtreme.h>
 
-#define NUM_MENU_ITEMS (5)
+#define NUM_MENU_ITEMS (6)
 
 #define UART_TERMINAL_TEXT_BOX_STORE_SIZE (4096)
 #define UART_TERMINAL_TEXT_INPUT_STORE_SIZE (512)
@@ -28,8 +30,7 @@ struct UART_TerminalApp {
     SceneManager* scene_manager;
 
     char text_input_store[UART_TERMINAL_TEXT_INPUT_STORE_SIZE + 1];
-    FuriString* text_box_store;
-    size_t text_box_store_strlen;
+    TextBoxStore* text_box_store;
     TextBox* text_box;
     TextInput* text_input;
 
@@ -45,6 +46,11 @@ struct UART_TerminalApp {
     bool show_stopscan_tip;
     int BAUDRATE;
     int TERMINAL_MODE; //1=AT mode, 0=other mode
+
+    UART_TerminalCapture* capture;
+    FuriString* capture_status;
+    uint32_t capture_status_bytes;
+    uint32_t capture_status_tick;
 };
 
 typedef enum {
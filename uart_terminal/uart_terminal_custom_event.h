@@ -4,4 +4,5 @@ typedef enum {
     UART_TerminalEventRefreshConsoleOutput = 0,
     UART_TerminalEventStartConsole,
     UART_TerminalEventStartKeyboard,
+    UART_TerminalEventStartCapture,
 } UART_TerminalCustomEvent;
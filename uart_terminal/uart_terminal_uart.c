@@ -1,5 +1,7 @@
 #include "uart_terminal_app_i.h"
 #include "uart_terminal_uart.h"
+#include "uart_dma.h"
+#include "profile.h"
 
 //#define UART_CH (FuriHalUartIdUSART1)
 //#define BAUDRATE (115200)
@@ -7,7 +9,7 @@
 struct UART_TerminalUart {
     UART_TerminalApp* app;
     FuriThread* rx_thread;
-    FuriStreamBuffer* rx_stream;
+    UartDma* rx_dma;
     uint8_t rx_buf[RX_BUF_SIZE + 1];
     void (*handle_rx_data_cb)(uint8_t* buf, size_t len, void* context);
 };
@@ -26,15 +28,6 @@ void uart_terminal_uart_set_handle_rx_data_cb(
 
 #define WORKER_ALL_RX_EVENTS (WorkerEvtStop | WorkerEvtRxDone)
 
-void uart_terminal_uart_on_irq_cb(UartIrqEvent ev, uint8_t data, void* context) {
-    UART_TerminalUart* uart = (UART_TerminalUart*)context;
-
-    if(ev == UartIrqEventRXNE) {
-        furi_stream_buffer_send(uart->rx_stream, &data, 1, 0);
-        furi_thread_flags_set(furi_thread_get_id(uart->rx_thread), WorkerEvtRxDone);
-    }
-}
-
 static int32_t uart_worker(void* context) {
     UART_TerminalUart* uart = (void*)context;
 
@@ -44,15 +37,18 @@ static int32_t uart_worker(void* context) {
         furi_check((events & FuriFlagError) == 0);
         if(events & WorkerEvtStop) break;
         if(events & WorkerEvtRxDone) {
-            size_t len = furi_stream_buffer_receive(uart->rx_stream, uart->rx_buf, RX_BUF_SIZE, 0);
+            PROFILE_BEGIN(uart_worker_rx);
+            size_t len = uart_dma_receive(uart->rx_dma, uart->rx_buf, RX_BUF_SIZE);
             if(len > 0) {
                 if(uart->handle_rx_data_cb) uart->handle_rx_data_cb(uart->rx_buf, len, uart->app);
             }
+            PROFILE_END(uart_worker_rx);
         }
     }
 
-    furi_hal_uart_set_irq_cb(UART_CH, NULL, NULL);
-    furi_stream_buffer_free(uart->rx_stream);
+    uart_dma_stop(uart->rx_dma);
+    uart_dma_free(uart->rx_dma);
+    profile_thread_exit("uart");
 
     return 0;
 }
@@ -64,8 +60,12 @@ void uart_terminal_uart_tx(uint8_t* data, size_t len) {
 UART_TerminalUart* uart_terminal_uart_init(UART_TerminalApp* app) {
     UART_TerminalUart* uart = malloc(sizeof(UART_TerminalUart));
     uart->app = app;
+    if(app->BAUDRATE == 0) {
+        app->BAUDRATE = 115200;
+    }
     // Init all rx stream and thread early to avoid crashes
-    uart->rx_stream = furi_stream_buffer_alloc(RX_BUF_SIZE, 1);
+    uart->rx_dma =
+        uart_dma_alloc(app->BAUDRATE > HIGH_BAUDRATE ? RX_DMA_HIGH_BAUDRATE_SIZE : RX_BUF_SIZE);
     uart->rx_thread = furi_thread_alloc();
     furi_thread_set_name(uart->rx_thread, "UART_TerminalUartRxThread");
     furi_thread_set_stack_size(uart->rx_thread, 1024);
@@ -80,11 +80,8 @@ UART_TerminalUart* uart_terminal_uart_init(UART_TerminalApp* app) {
         furi_hal_uart_init(UART_CH, app->BAUDRATE);
     }
 
-    if(app->BAUDRATE == 0) {
-        app->BAUDRATE = 115200;
-    }
     furi_hal_uart_set_br(UART_CH, app->BAUDRATE);
-    furi_hal_uart_set_irq_cb(UART_CH, uart_terminal_uart_on_irq_cb, uart);
+    uart_dma_start(uart->rx_dma, UART_CH, furi_thread_get_id(uart->rx_thread), WorkerEvtRxDone);
 
     return uart;
 }
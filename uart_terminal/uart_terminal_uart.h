@@ -3,6 +3,9 @@
 #include "furi_hal.h"
 
 #define RX_BUF_SIZE (320)
+// DMA ring used above HIGH_BAUDRATE, holds ~40 ms at 2 Mbaud between two worker wakeups
+#define RX_DMA_HIGH_BAUDRATE_SIZE (8192)
+#define HIGH_BAUDRATE (230400)
 
 typedef struct UART_TerminalUart UART_TerminalUart;
 
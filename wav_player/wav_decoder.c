@@ -0,0 +1,108 @@
+#include "wav_decoder.h"
+
+static const int8_t ima_index_table[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8};
+
+static const int16_t ima_step_table[89] = {
+    7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,
+    25,    28,    31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,
+    88,    97,    107,   118,   130,   143,   157,   173,   190,   209,   230,   253,   279,
+    307,   337,   371,   408,   449,   494,   544,   598,   658,   724,   796,   876,   963,
+    1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,  2272,  2499,  2749,  3024,  3327,
+    3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,  9493,  10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+
+typedef struct {
+    int32_t predictor;
+    int32_t index;
+} ImaState;
+
+int16_t wav_decoder_mulaw(uint8_t data) {
+    data = ~data;
+    int32_t value = (((int32_t)data & 0x0F) << 3) + 0x84;
+    value <<= (data & 0x70) >> 4;
+    return (data & 0x80) ? 0x84 - value : value - 0x84;
+}
+
+int16_t wav_decoder_alaw(uint8_t data) {
+    data ^= 0x55;
+    int32_t value = ((int32_t)data & 0x0F) << 4;
+    int32_t segment = (data & 0x70) >> 4;
+
+    if(segment == 0) {
+        value += 8;
+    } else {
+        value = (value + 0x108) << (segment - 1);
+    }
+
+    return (data & 0x80) ? value : -value;
+}
+
+static inline int16_t ima_decode_nibble(ImaState* state, uint8_t nibble) {
+    int32_t step = ima_step_table[state->index];
+    int32_t diff = step >> 3;
+
+    if(nibble & 1) diff += step >> 2;
+    if(nibble & 2) diff += step >> 1;
+    if(nibble & 4) diff += step;
+    if(nibble & 8) diff = -diff;
+
+    state->predictor += diff;
+    if(state->predictor > INT16_MAX) state->predictor = INT16_MAX;
+    if(state->predictor < INT16_MIN) state->predictor = INT16_MIN;
+
+    state->index += ima_index_table[nibble];
+    if(state->index < 0) state->index = 0;
+    if(state->index > 88) state->index = 88;
+
+    return state->predictor;
+}
+
+size_t wav_decoder_ima_frames(size_t block_align, uint16_t channels) {
+    if(block_align < 4 * channels) return 0;
+    // 8 samples per 4 bytes of each channel, plus the one in the header
+    return (block_align - 4 * channels) / (4 * channels) * 8 + 1;
+}
+
+size_t wav_decoder_ima_block(const uint8_t* block, size_t size, uint16_t channels, int16_t* out) {
+    size_t frames = wav_decoder_ima_frames(size, channels);
+    if(frames == 0) return 0;
+
+    const size_t groups = (frames - 1) / 8;
+    const uint8_t* data = block + 4 * channels;
+
+    for(uint16_t ch = 0; ch < channels; ch++) {
+        const uint8_t* header = block + 4 * ch;
+        ImaState state = {
+            .predictor = (int16_t)((uint16_t)header[1] << 8 | header[0]),
+            .index = header[2] > 88 ? 88 : header[2],
+        };
+
+        int16_t* dst = out;
+        // the first channel is stored, the second one is averaged into it
+        if(ch == 0) {
+            *dst++ = state.predictor;
+        } else {
+            *dst = (*dst + state.predictor) >> 1;
+            dst++;
+        }
+
+        for(size_t group = 0; group < groups; group++) {
+            const uint8_t* src = data + (group * channels + ch) * 4;
+            for(size_t i = 0; i < 4; i++) {
+                int16_t low = ima_decode_nibble(&state, src[i] & 0x0F);
+                int16_t high = ima_decode_nibble(&state, src[i] >> 4);
+                if(ch == 0) {
+                    dst[0] = low;
+                    dst[1] = high;
+                } else {
+                    dst[0] = (dst[0] + low) >> 1;
+                    dst[1] = (dst[1] + high) >> 1;
+                }
+                dst += 2;
+            }
+        }
+    }
+
+    return frames;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// G.711 companded byte to a linear 16-bit sample
+int16_t wav_decoder_mulaw(uint8_t data);
+
+int16_t wav_decoder_alaw(uint8_t data);
+
+// Frames held by an IMA-ADPCM block of block_align bytes
+size_t wav_decoder_ima_frames(size_t block_align, uint16_t channels);
+
+// Decode one IMA-ADPCM block (possibly cut short at the end of the file),
+// stereo is mixed down to mono. Returns the number of samples written to out.
+size_t wav_decoder_ima_block(const uint8_t* block, size_t size, uint16_t channels, int16_t* out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -8,6 +8,12 @@ const char* format_text(FormatTag tag) {
         return "PCM";
     case FormatTagIEEE_FLOAT:
         return "IEEE FLOAT";
+    case FormatTagALAW:
+        return "A-law";
+    case FormatTagMULAW:
+        return "u-law";
+    case FormatTagIMA_ADPCM:
+        return "IMA ADPCM";
     default:
         return "Unknown";
     }
@@ -29,10 +35,64 @@ void wav_parser_free(WavParser* parser) {
     free(parser);
 }
 
+// Chunks are word aligned, an odd sized chunk is followed by a pad byte
+static bool wav_parser_skip(Stream* stream, uint32_t size) {
+    return stream_seek(stream, size + (size & 1), StreamOffsetFromCurrent);
+}
+
+static bool wav_parser_find_chunks(WavParser* parser, Stream* stream) {
+    bool has_format = false;
+    WavDataChunk chunk;
+
+    while(stream_read(stream, (uint8_t*)&chunk, sizeof(WavDataChunk)) == sizeof(WavDataChunk)) {
+        if(memcmp(chunk.data, "fmt ", 4) == 0) {
+            // fields past the PCM ones (cbSize, IMA samples per block) are not needed
+            const size_t fields = sizeof(WavFormatChunk) - sizeof(WavDataChunk);
+            if(chunk.size < fields) return false;
+
+            memcpy(&parser->format, &chunk, sizeof(WavDataChunk));
+            if(stream_read(stream, (uint8_t*)&parser->format + sizeof(WavDataChunk), fields) !=
+               fields) {
+                return false;
+            }
+            if(!wav_parser_skip(stream, chunk.size - fields)) return false;
+            has_format = true;
+        } else if(memcmp(chunk.data, "data", 4) == 0) {
+            parser->data = chunk;
+            return has_format;
+        } else if(!wav_parser_skip(stream, chunk.size)) {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+static bool wav_parser_check_format(WavFormatChunk* format, WavPlayerApp* app) {
+    if(format->channels != 1 && format->channels != 2) return false;
+
+    switch(format->tag) {
+    case FormatTagPCM:
+        if(format->bits_per_sample != 8 && format->bits_per_sample != 16) return false;
+        format->block_align = format->channels * format->bits_per_sample / 8;
+        return true;
+    case FormatTagALAW:
+    case FormatTagMULAW:
+        if(format->bits_per_sample != 8) return false;
+        format->block_align = format->channels;
+        return true;
+    case FormatTagIMA_ADPCM:
+        // a 4 byte header per channel, then groups of 4 bytes per channel
+        return format->bits_per_sample == 4 && format->block_align > 4 * format->channels &&
+               format->block_align % (4 * format->channels) == 0 &&
+               format->block_align <= app->samples_count;
+    default:
+        return false;
+    }
+}
+
 bool wav_parser_parse(WavParser* parser, Stream* stream, WavPlayerApp* app) {
     stream_read(stream, (uint8_t*)&parser->header, sizeof(WavHeaderChunk));
-    stream_read(stream, (uint8_t*)&parser->format, sizeof(WavFormatChunk));
-    stream_read(stream, (uint8_t*)&parser->data, sizeof(WavDataChunk));
 
     if(memcmp(parser->header.riff, "RIFF", 4) != 0 ||
        memcmp(parser->header.wave, "WAVE", 4) != 0) {
@@ -40,17 +100,19 @@ bool wav_parser_parse(WavParser* parser, Stream* stream, WavPlayerApp* app) {
         return false;
     }
 
-    if(memcmp(parser->format.fmt, "fmt ", 4) != 0) {
-        FURI_LOG_E(TAG, "WAV: wrong format");
+    if(!wav_parser_find_chunks(parser, stream)) {
+        FURI_LOG_E(TAG, "WAV: no format or data chunk");
         return false;
     }
 
-    if(parser->format.tag != FormatTagPCM || memcmp(parser->data.data, "data", 4) != 0) {
+    if(!wav_parser_check_format(&parser->format, app)) {
         FURI_LOG_E(
             TAG,
-            "WAV: non-PCM format %u, next '%lu'",
+            "WAV: unsupported format %u, ch: %u, bits: %u, align: %u",
             parser->format.tag,
-            (uint32_t)parser->data.data);
+            parser->format.channels,
+            parser->format.bits_per_sample,
+            parser->format.block_align);
         return false;
     }
 
@@ -66,6 +128,8 @@ bool wav_parser_parse(WavParser* parser, Stream* stream, WavPlayerApp* app) {
     app->sample_rate = parser->format.sample_rate;
     app->num_channels = parser->format.channels;
     app->bits_per_sample = parser->format.bits_per_sample;
+    app->format_tag = parser->format.tag;
+    app->block_align = parser->format.block_align;
 
     parser->wav_data_start = stream_tell(stream);
     parser->wav_data_end = parser->wav_data_start + parser->data.size;
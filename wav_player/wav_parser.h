@@ -12,6 +12,7 @@
 #include <toolbox/stream/file_stream.h>
 
 #include "wav_player_view.h"
+#include "wav_player_prefetch.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -20,6 +21,9 @@ extern "C" {
 typedef enum {
     FormatTagPCM = 0x0001,
     FormatTagIEEE_FLOAT = 0x0003,
+    FormatTagALAW = 0x0006,
+    FormatTagMULAW = 0x0007,
+    FormatTagIMA_ADPCM = 0x0011,
 } FormatTag;
 
 typedef struct {
@@ -50,6 +54,7 @@ typedef struct {
     Storage* storage;
     Stream* stream;
     WavParser* parser;
+    WavPlayerPrefetch* prefetch;
     uint16_t* sample_buffer;
     uint8_t* tmp_buffer;
 
@@ -57,6 +62,14 @@ typedef struct {
 
     uint16_t num_channels;
     uint16_t bits_per_sample;
+    uint16_t format_tag;
+    // bytes per frame, or per compressed block for IMA-ADPCM
+    uint16_t block_align;
+
+    // IMA-ADPCM block decoded to mono, played out over several refills
+    int16_t* decoded;
+    size_t decoded_pos;
+    size_t decoded_count;
 
     size_t samples_count_half;
     size_t samples_count;
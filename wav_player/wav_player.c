@@ -10,6 +10,8 @@
 #include "wav_player_hal.h"
 #include "wav_parser.h"
 #include "wav_player_view.h"
+#include "wav_player_prefetch.h"
+#include "wav_decoder.h"
 #include <math.h>
 
 #include <wav_player_icons.h>
@@ -20,6 +22,9 @@
 
 #define WAVPLAYER_FOLDER "/ext/wav_player"
 
+// The first two buffers are filled before playback starts, give the card time
+#define WAV_PLAYER_START_TIMEOUT 1000
+
 static bool open_wav_stream(Stream* stream) {
     DialogsApp* dialogs = furi_record_open(RECORD_DIALOGS);
     bool result = false;
@@ -92,6 +97,7 @@ static WavPlayerApp* app_alloc() {
     app->tmp_buffer = malloc(sizeof(uint8_t) * app->samples_count);
     app->queue = furi_message_queue_alloc(10, sizeof(WavPlayerEvent));
 
+    app->decoded = NULL;
     app->volume = 10.0f;
     app->play = true;
 
@@ -127,186 +133,221 @@ static void app_free(WavPlayerApp* app) {
     free(app);
 }
 
-// TODO: that works only with 8-bit 2ch audio
-static bool fill_data(WavPlayerApp* app, size_t index) {
-    if(app->num_channels == 1 && app->bits_per_sample == 8) {
-        uint16_t* sample_buffer_start = &app->sample_buffer[index];
-        size_t count = stream_read(app->stream, app->tmp_buffer, app->samples_count_half);
-
-        for(size_t i = count; i < app->samples_count_half; i++) {
-            app->tmp_buffer[i] = 0;
-        }
-
-        //for(size_t i = 0; i < app->samples_count; i += 2)
-        for(size_t i = 0; i < app->samples_count_half; i++) //now works with mono!
-        {
-            float data = app->tmp_buffer[i];
-            data -= UINT8_MAX / 2; // to signed
-            data /= UINT8_MAX / 2; // scale -1..1
-
-            data *= app->volume; // volume
-            data = tanhf(data); // hyperbolic tangent limiter
+// Soft clip curve, tanh(x) * 127 for 0 <= x < 4 (tanh(4) is already 0.9993)
+#define SOFT_CLIP_LUT_BITS 9
+#define SOFT_CLIP_LUT_SIZE (1 << SOFT_CLIP_LUT_BITS)
+#define SOFT_CLIP_RANGE_BITS 2
+#define SOFT_CLIP_SHIFT (15 + SOFT_CLIP_RANGE_BITS - SOFT_CLIP_LUT_BITS)
 
-            data *= UINT8_MAX / 2; // scale -128..127
-            data += UINT8_MAX / 2; // to unsigned
+static uint8_t soft_clip_lut[SOFT_CLIP_LUT_SIZE];
 
-            if(data < 0) {
-                data = 0;
-            }
-
-            if(data > 255) {
-                data = 255;
-            }
+static void soft_clip_lut_init() {
+    for(size_t i = 0; i < SOFT_CLIP_LUT_SIZE; i++) {
+        float x = ((float)i + 0.5f) * (1 << SOFT_CLIP_RANGE_BITS) / SOFT_CLIP_LUT_SIZE;
+        soft_clip_lut[i] = (uint8_t)(tanhf(x) * (UINT8_MAX / 2) + 0.5f);
+    }
+}
 
-            //uint8_t data = app->tmp_buffer[i];
+// sample is Q15, gain is Q8, returns the unsigned 8-bit PWM value
+static inline uint16_t soft_clip(int32_t sample, int32_t gain) {
+    int32_t x = (sample * gain) >> 8;
+    uint32_t index = (uint32_t)(x < 0 ? -x : x) >> SOFT_CLIP_SHIFT;
+    int32_t y = index < SOFT_CLIP_LUT_SIZE ? soft_clip_lut[index] : UINT8_MAX / 2;
 
-            sample_buffer_start[i] = data;
-        }
+    return x < 0 ? UINT8_MAX / 2 - y : UINT8_MAX / 2 + y;
+}
 
-        wav_player_view_set_data(app->view, sample_buffer_start, app->samples_count_half);
+static inline int32_t sample_16(const uint8_t* data) {
+    return (int16_t)((uint16_t)data[1] << 8 | data[0]);
+}
 
-        return count != app->samples_count_half;
+static void convert_mono_8(const uint8_t* in, uint16_t* out, size_t count, int32_t gain) {
+    for(size_t i = 0; i < count; i++) {
+        out[i] = soft_clip(((int32_t)in[i] - 128) << 8, gain);
     }
+}
 
-    if(app->num_channels == 1 && app->bits_per_sample == 16) {
-        uint16_t* sample_buffer_start = &app->sample_buffer[index];
-        size_t count = stream_read(app->stream, app->tmp_buffer, app->samples_count);
+static void convert_stereo_8(const uint8_t* in, uint16_t* out, size_t count, int32_t gain) {
+    for(size_t i = 0; i < count; i++, in += 2) {
+        out[i] = soft_clip(((int32_t)in[0] + in[1] - 256) << 7, gain); // (L + R) / 2
+    }
+}
 
-        for(size_t i = count; i < app->samples_count; i++) {
-            //app->tmp_buffer[i] = 0;
-        }
+static void convert_mono_16(const uint8_t* in, uint16_t* out, size_t count, int32_t gain) {
+    for(size_t i = 0; i < count; i++, in += 2) {
+        out[i] = soft_clip(sample_16(in), gain);
+    }
+}
 
-        for(size_t i = 0; i < app->samples_count; i += 2) {
-            int16_t int_16 =
-                (((int16_t)app->tmp_buffer[i + 1] << 8) + (int16_t)app->tmp_buffer[i]);
+static void convert_stereo_16(const uint8_t* in, uint16_t* out, size_t count, int32_t gain) {
+    for(size_t i = 0; i < count; i++, in += 4) {
+        out[i] = soft_clip((sample_16(in) + sample_16(in + 2)) >> 1, gain); // (L + R) / 2
+    }
+}
 
-            float data = ((float)int_16 / 256.0 + 127.0);
-            data -= UINT8_MAX / 2; // to signed
-            data /= UINT8_MAX / 2; // scale -1..1
+// G.711 bytes expanded to 16-bit, filled at start
+static int16_t mulaw_lut[256];
+static int16_t alaw_lut[256];
 
-            data *= app->volume; // volume
-            data = tanhf(data); // hyperbolic tangent limiter
+static void companding_lut_init() {
+    for(size_t i = 0; i < 256; i++) {
+        mulaw_lut[i] = wav_decoder_mulaw(i);
+        alaw_lut[i] = wav_decoder_alaw(i);
+    }
+}
 
-            data *= UINT8_MAX / 2; // scale -128..127
-            data += UINT8_MAX / 2; // to unsigned
+static inline void convert_companded(
+    const int16_t* lut,
+    size_t channels,
+    const uint8_t* in,
+    uint16_t* out,
+    size_t count,
+    int32_t gain) {
+    for(size_t i = 0; i < count; i++, in += channels) {
+        int32_t sample = channels == 1 ? lut[in[0]] : (lut[in[0]] + lut[in[1]]) >> 1;
+        out[i] = soft_clip(sample, gain);
+    }
+}
 
-            if(data < 0) {
-                data = 0;
-            }
+static void convert_mono_mulaw(const uint8_t* in, uint16_t* out, size_t count, int32_t gain) {
+    convert_companded(mulaw_lut, 1, in, out, count, gain);
+}
 
-            if(data > 255) {
-                data = 255;
-            }
+static void convert_stereo_mulaw(const uint8_t* in, uint16_t* out, size_t count, int32_t gain) {
+    convert_companded(mulaw_lut, 2, in, out, count, gain);
+}
 
-            sample_buffer_start[i / 2] = data;
-        }
+static void convert_mono_alaw(const uint8_t* in, uint16_t* out, size_t count, int32_t gain) {
+    convert_companded(alaw_lut, 1, in, out, count, gain);
+}
 
-        wav_player_view_set_data(app->view, sample_buffer_start, app->samples_count_half);
+static void convert_stereo_alaw(const uint8_t* in, uint16_t* out, size_t count, int32_t gain) {
+    convert_companded(alaw_lut, 2, in, out, count, gain);
+}
 
-        return count != app->samples_count;
+static void convert_q15(const int16_t* in, uint16_t* out, size_t count, int32_t gain) {
+    for(size_t i = 0; i < count; i++) {
+        out[i] = soft_clip(in[i], gain);
     }
+}
 
-    if(app->num_channels == 2 && app->bits_per_sample == 16) {
-        uint16_t* sample_buffer_start = &app->sample_buffer[index];
-        size_t count = stream_read(app->stream, app->tmp_buffer, app->samples_count);
-
-        for(size_t i = 0; i < app->samples_count; i += 4) {
-            int16_t L = (((int16_t)app->tmp_buffer[i + 1] << 8) + (int16_t)app->tmp_buffer[i]);
-            int16_t R = (((int16_t)app->tmp_buffer[i + 3] << 8) + (int16_t)app->tmp_buffer[i + 2]);
-            int32_t int_16 = L / 2 + R / 2; // (L + R) / 2
-
-            float data = ((float)int_16 / 256.0 + 127.0);
-            data -= UINT8_MAX / 2; // to signed
-            data /= UINT8_MAX / 2; // scale -1..1
-
-            data *= app->volume; // volume
-            data = tanhf(data); // hyperbolic tangent limiter
+typedef void (*ConvertKernel)(const uint8_t* in, uint16_t* out, size_t count, int32_t gain);
 
-            data *= UINT8_MAX / 2; // scale -128..127
-            data += UINT8_MAX / 2; // to unsigned
+static ConvertKernel convert_kernel(WavPlayerApp* app) {
+    const bool stereo = app->num_channels == 2;
 
-            if(data < 0) {
-                data = 0;
-            }
+    switch(app->format_tag) {
+    case FormatTagPCM:
+        if(app->bits_per_sample == 8) return stereo ? convert_stereo_8 : convert_mono_8;
+        return stereo ? convert_stereo_16 : convert_mono_16;
+    case FormatTagMULAW:
+        return stereo ? convert_stereo_mulaw : convert_mono_mulaw;
+    case FormatTagALAW:
+        return stereo ? convert_stereo_alaw : convert_mono_alaw;
+    default:
+        return NULL;
+    }
+}
 
-            if(data > 255) {
-                data = 255;
-            }
+// Read whole frames into tmp_buffer and convert them in place of the PWM buffer
+static bool fill_frames(WavPlayerApp* app, uint16_t* out, uint32_t timeout, int32_t gain) {
+    ConvertKernel convert = convert_kernel(app);
+    if(convert == NULL) return true;
+
+    const size_t frame_size = app->block_align;
+    // tmp_buffer holds samples_count bytes, read as many whole frames as fit
+    const size_t chunk = app->samples_count / frame_size;
+    uint8_t silence = 0x00;
+    if(app->format_tag == FormatTagMULAW) {
+        silence = 0xFF;
+    } else if(app->format_tag == FormatTagALAW) {
+        silence = 0xD5;
+    } else if(app->bits_per_sample == 8) {
+        silence = 0x80;
+    }
 
-            sample_buffer_start[i / 4] = data;
+    bool eof = false;
+    for(size_t done = 0; done < app->samples_count_half; done += chunk) {
+        size_t frames = MIN(chunk, app->samples_count_half - done);
+        size_t size = frames * frame_size;
+        size_t count =
+            eof ? 0 : wav_player_prefetch_read(app->prefetch, app->tmp_buffer, size, timeout);
+
+        if(count != size) {
+            memset(&app->tmp_buffer[count], silence, size - count);
+            eof = wav_player_prefetch_eof(app->prefetch);
+            if(!eof) FURI_LOG_W(TAG, "Underrun, %u of %u bytes", count, size);
+            // don't spend the budget twice in one refill
+            timeout = 0;
         }
 
-        count = stream_read(app->stream, app->tmp_buffer, app->samples_count);
-
-        for(size_t i = 0; i < app->samples_count; i += 4) {
-            int16_t L = (((int16_t)app->tmp_buffer[i + 1] << 8) + (int16_t)app->tmp_buffer[i]);
-            int16_t R = (((int16_t)app->tmp_buffer[i + 3] << 8) + (int16_t)app->tmp_buffer[i + 2]);
-            int32_t int_16 = L / 2 + R / 2; // (L + R) / 2
-
-            float data = ((float)int_16 / 256.0 + 127.0);
-            data -= UINT8_MAX / 2; // to signed
-            data /= UINT8_MAX / 2; // scale -1..1
-
-            data *= app->volume; // volume
-            data = tanhf(data); // hyperbolic tangent limiter
+        convert(app->tmp_buffer, &out[done], frames, gain);
+    }
 
-            data *= UINT8_MAX / 2; // scale -128..127
-            data += UINT8_MAX / 2; // to unsigned
+    return eof;
+}
 
-            if(data < 0) {
-                data = 0;
+// Decode IMA-ADPCM a block at a time, the rest of the last block is kept for the next refill
+static bool fill_adpcm(WavPlayerApp* app, uint16_t* out, uint32_t timeout, int32_t gain) {
+    bool eof = false;
+    size_t done = 0;
+
+    while(done < app->samples_count_half) {
+        if(app->decoded_pos == app->decoded_count) {
+            size_t count =
+                eof ? 0 :
+                      wav_player_prefetch_read(
+                          app->prefetch, app->tmp_buffer, app->block_align, timeout);
+
+            app->decoded_pos = 0;
+            app->decoded_count =
+                wav_decoder_ima_block(app->tmp_buffer, count, app->num_channels, app->decoded);
+
+            if(count != app->block_align) {
+                eof = wav_player_prefetch_eof(app->prefetch);
+                if(!eof) FURI_LOG_W(TAG, "Underrun, block of %u bytes", app->block_align);
+                timeout = 0;
             }
 
-            if(data > 255) {
-                data = 255;
+            if(app->decoded_count == 0) {
+                for(; done < app->samples_count_half; done++) {
+                    out[done] = UINT8_MAX / 2;
+                }
+                break;
             }
-
-            sample_buffer_start[i / 4 + app->samples_count / 4] = data;
         }
 
-        wav_player_view_set_data(app->view, sample_buffer_start, app->samples_count_half);
-
-        return count != app->samples_count;
+        size_t count =
+            MIN(app->samples_count_half - done, app->decoded_count - app->decoded_pos);
+        convert_q15(&app->decoded[app->decoded_pos], &out[done], count, gain);
+        app->decoded_pos += count;
+        done += count;
     }
 
-    if(app->num_channels == 2 && app->bits_per_sample == 8) {
-        uint16_t* sample_buffer_start = &app->sample_buffer[index];
-        size_t count = stream_read(app->stream, app->tmp_buffer, app->samples_count);
-
-        for(size_t i = count; i < app->samples_count; i++) {
-            app->tmp_buffer[i] = 0;
-        }
-
-        for(size_t i = 0; i < app->samples_count; i += 2) {
-            float data = (app->tmp_buffer[i] + app->tmp_buffer[i + 1]) / 2; // (L + R) / 2
-            data -= UINT8_MAX / 2; // to signed
-            data /= UINT8_MAX / 2; // scale -1..1
-
-            data *= app->volume; // volume
-            data = tanhf(data); // hyperbolic tangent limiter
-
-            data *= UINT8_MAX / 2; // scale -128..127
-            data += UINT8_MAX / 2; // to unsigned
-
-            if(data < 0) {
-                data = 0;
-            }
-
-            if(data > 255) {
-                data = 255;
-            }
+    return eof;
+}
 
-            //uint8_t data = app->tmp_buffer[i];
+// Waits at most timeout ms for the prefetch thread, a late read is played as silence
+static bool fill_data(WavPlayerApp* app, size_t index, uint32_t timeout) {
+    uint16_t* sample_buffer_start = &app->sample_buffer[index];
+    const int32_t gain = app->volume > 0 ? (int32_t)(app->volume * 256) : 0;
 
-            sample_buffer_start[i / 2] = data;
-        }
+    bool eof = app->format_tag == FormatTagIMA_ADPCM ?
+                   fill_adpcm(app, sample_buffer_start, timeout, gain) :
+                   fill_frames(app, sample_buffer_start, timeout, gain);
 
-        wav_player_view_set_data(app->view, sample_buffer_start, app->samples_count_half);
+    wav_player_view_set_data(app->view, sample_buffer_start, app->samples_count_half);
 
-        return count != app->samples_count;
-    }
+    return eof;
+}
 
-    return true;
+// Continue playback from position, dropping what is buffered or half decoded
+static void wav_player_seek(WavPlayerApp* app, size_t position) {
+    size_t start = wav_parser_get_data_start(app->parser);
+    position = start + (position - start) / app->block_align * app->block_align;
+    wav_player_prefetch_seek(app->prefetch, position);
+    app->decoded_pos = 0;
+    app->decoded_count = 0;
 }
 
 static void ctrl_callback(WavPlayerCtrl ctrl, void* ctx) {
@@ -347,17 +388,38 @@ static void app_run(WavPlayerApp* app) {
     if(!open_wav_stream(app->stream)) return;
     if(!wav_parser_parse(app->parser, app->stream, app)) return;
 
+    soft_clip_lut_init();
+    companding_lut_init();
+
+    app->prefetch = wav_player_prefetch_alloc(
+        app->stream,
+        wav_parser_get_data_start(app->parser),
+        wav_parser_get_data_end(app->parser),
+        app->block_align);
+    if(app->format_tag == FormatTagIMA_ADPCM) {
+        app->decoded = malloc(
+            sizeof(int16_t) * wav_decoder_ima_frames(app->block_align, app->num_channels));
+    }
+    app->decoded_pos = 0;
+    app->decoded_count = 0;
+    // left/right moves 1% of the file, in whole blocks
+    const size_t seek_step =
+        MAX(wav_parser_get_data_len(app->parser) / 100 / app->block_align, 1U) *
+        app->block_align;
+    // half of the time one half of the DMA buffer takes to play
+    const uint32_t refill_timeout = app->samples_count_half * 1000 / MAX(app->sample_rate, 1UL) / 2;
+
     wav_player_view_set_volume(app->view, app->volume);
     wav_player_view_set_start(app->view, wav_parser_get_data_start(app->parser));
-    wav_player_view_set_current(app->view, stream_tell(app->stream));
+    wav_player_view_set_current(app->view, wav_player_prefetch_tell(app->prefetch));
     wav_player_view_set_end(app->view, wav_parser_get_data_end(app->parser));
     wav_player_view_set_play(app->view, app->play);
 
     wav_player_view_set_context(app->view, app->queue);
     wav_player_view_set_ctrl_callback(app->view, ctrl_callback);
 
-    bool eof = fill_data(app, 0);
-    eof = fill_data(app, app->samples_count_half);
+    bool eof = fill_data(app, 0, WAV_PLAYER_START_TIMEOUT);
+    eof = fill_data(app, app->samples_count_half, WAV_PLAYER_START_TIMEOUT);
 
     if(furi_hal_speaker_acquire(1000)) {
         wav_player_speaker_init(app->sample_rate);
@@ -376,27 +438,23 @@ static void app_run(WavPlayerApp* app) {
                     wav_player_view_set_chans(app->view, app->num_channels);
                     wav_player_view_set_bits(app->view, app->bits_per_sample);
 
-                    eof = fill_data(app, 0);
-                    wav_player_view_set_current(app->view, stream_tell(app->stream));
+                    eof = fill_data(app, 0, refill_timeout);
                     if(eof) {
-                        stream_seek(
-                            app->stream,
-                            wav_parser_get_data_start(app->parser),
-                            StreamOffsetFromStart);
+                        wav_player_seek(app, wav_parser_get_data_start(app->parser));
                     }
+                    wav_player_view_set_current(
+                        app->view, wav_player_prefetch_tell(app->prefetch));
 
                 } else if(event.type == WavPlayerEventFullTransfer) {
                     wav_player_view_set_chans(app->view, app->num_channels);
                     wav_player_view_set_bits(app->view, app->bits_per_sample);
 
-                    eof = fill_data(app, app->samples_count_half);
-                    wav_player_view_set_current(app->view, stream_tell(app->stream));
+                    eof = fill_data(app, app->samples_count_half, refill_timeout);
                     if(eof) {
-                        stream_seek(
-                            app->stream,
-                            wav_parser_get_data_start(app->parser),
-                            StreamOffsetFromStart);
+                        wav_player_seek(app, wav_parser_get_data_start(app->parser));
                     }
+                    wav_player_view_set_current(
+                        app->view, wav_player_prefetch_tell(app->prefetch));
                 } else if(event.type == WavPlayerEventCtrlVolUp) {
                     if(app->volume < 9.9) app->volume += 0.4;
                     wav_player_view_set_volume(app->view, app->volume);
@@ -404,24 +462,17 @@ static void app_run(WavPlayerApp* app) {
                     if(app->volume > 0.01) app->volume -= 0.4;
                     wav_player_view_set_volume(app->view, app->volume);
                 } else if(event.type == WavPlayerEventCtrlMoveL) {
-                    int32_t seek =
-                        stream_tell(app->stream) - wav_parser_get_data_start(app->parser);
-                    seek = MIN(
-                        seek,
-                        (int32_t)(wav_parser_get_data_len(app->parser) / (size_t)100) % 2 ?
-                            ((int32_t)(wav_parser_get_data_len(app->parser) / (size_t)100) - 1) :
-                            (int32_t)(wav_parser_get_data_len(app->parser) / (size_t)100));
-                    stream_seek(app->stream, -seek, StreamOffsetFromCurrent);
-                    wav_player_view_set_current(app->view, stream_tell(app->stream));
+                    size_t position = wav_player_prefetch_tell(app->prefetch);
+                    size_t seek = position - wav_parser_get_data_start(app->parser);
+                    wav_player_seek(app, position - MIN(seek, seek_step));
+                    wav_player_view_set_current(
+                        app->view, wav_player_prefetch_tell(app->prefetch));
                 } else if(event.type == WavPlayerEventCtrlMoveR) {
-                    int32_t seek = wav_parser_get_data_end(app->parser) - stream_tell(app->stream);
-                    seek = MIN(
-                        seek,
-                        (int32_t)(wav_parser_get_data_len(app->parser) / (size_t)100) % 2 ?
-                            ((int32_t)(wav_parser_get_data_len(app->parser) / (size_t)100) - 1) :
-                            (int32_t)(wav_parser_get_data_len(app->parser) / (size_t)100));
-                    stream_seek(app->stream, seek, StreamOffsetFromCurrent);
-                    wav_player_view_set_current(app->view, stream_tell(app->stream));
+                    size_t position = wav_player_prefetch_tell(app->prefetch);
+                    size_t seek = wav_parser_get_data_end(app->parser) - position;
+                    wav_player_seek(app, position + MIN(seek, seek_step));
+                    wav_player_view_set_current(
+                        app->view, wav_player_prefetch_tell(app->prefetch));
                 } else if(event.type == WavPlayerEventCtrlOk) {
                     app->play = !app->play;
                     wav_player_view_set_play(app->view, app->play);
@@ -442,6 +493,11 @@ static void app_run(WavPlayerApp* app) {
         furi_hal_speaker_release();
     }
 
+    wav_player_prefetch_free(app->prefetch);
+    app->prefetch = NULL;
+    free(app->decoded);
+    app->decoded = NULL;
+
     // Reset GPIO pin and bus states
     wav_player_hal_deinit();
 
@@ -0,0 +1,169 @@
+#include "wav_player_prefetch.h"
+#include <furi.h>
+
+#define TAG "WavPrefetch"
+
+typedef enum {
+    WavPlayerPrefetchEventWake = (1 << 0),
+    WavPlayerPrefetchEventStop = (1 << 1),
+} WavPlayerPrefetchEvent;
+
+#define WAV_PLAYER_PREFETCH_EVENTS (WavPlayerPrefetchEventWake | WavPlayerPrefetchEventStop)
+
+// Ring slots mirror stream offsets (offset % size), so a read that stops at a
+// chunk boundary never wraps around the end of the ring.
+struct WavPlayerPrefetch {
+    Stream* stream;
+    FuriThread* thread;
+    FuriMutex* mutex;
+    uint8_t* ring;
+
+    size_t start;
+    size_t end;
+    size_t align;
+    size_t read_pos;
+    size_t fill_pos;
+    // bumped by every seek, reads started before it are thrown away
+    uint32_t generation;
+};
+
+static size_t wav_player_prefetch_next_read(WavPlayerPrefetch* prefetch) {
+    size_t size = WAV_PLAYER_PREFETCH_CHUNK - prefetch->fill_pos % WAV_PLAYER_PREFETCH_CHUNK;
+    size_t space = WAV_PLAYER_PREFETCH_SIZE - (prefetch->fill_pos - prefetch->read_pos);
+
+    size = MIN(size, prefetch->end - prefetch->fill_pos);
+    // wait until the whole read fits behind the consumer
+    return size <= space ? size : 0;
+}
+
+static int32_t wav_player_prefetch_worker(void* context) {
+    WavPlayerPrefetch* prefetch = context;
+    size_t stream_pos = stream_tell(prefetch->stream);
+
+    while(!(furi_thread_flags_get() & WavPlayerPrefetchEventStop)) {
+        furi_check(furi_mutex_acquire(prefetch->mutex, FuriWaitForever) == FuriStatusOk);
+        size_t pos = prefetch->fill_pos;
+        uint32_t generation = prefetch->generation;
+        size_t size = wav_player_prefetch_next_read(prefetch);
+        furi_mutex_release(prefetch->mutex);
+
+        if(size == 0) {
+            uint32_t flags = furi_thread_flags_wait(
+                WAV_PLAYER_PREFETCH_EVENTS, FuriFlagWaitAny, FuriWaitForever);
+            if(flags & WavPlayerPrefetchEventStop) break;
+            continue;
+        }
+
+        if(stream_pos != pos) {
+            stream_seek(prefetch->stream, pos, StreamOffsetFromStart);
+        }
+
+        size_t count = stream_read(
+            prefetch->stream, &prefetch->ring[pos % WAV_PLAYER_PREFETCH_SIZE], size);
+        stream_pos = pos + count;
+
+        furi_check(furi_mutex_acquire(prefetch->mutex, FuriWaitForever) == FuriStatusOk);
+        if(generation == prefetch->generation) {
+            prefetch->fill_pos += count;
+            if(count != size) {
+                // data chunk claims more than the file holds
+                FURI_LOG_W(TAG, "short read at %u", prefetch->fill_pos);
+                prefetch->end = prefetch->fill_pos;
+            }
+        }
+        furi_mutex_release(prefetch->mutex);
+    }
+
+    return 0;
+}
+
+WavPlayerPrefetch*
+    wav_player_prefetch_alloc(Stream* stream, size_t start, size_t end, size_t align) {
+    WavPlayerPrefetch* prefetch = malloc(sizeof(WavPlayerPrefetch));
+    prefetch->stream = stream;
+    prefetch->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    prefetch->ring = malloc(WAV_PLAYER_PREFETCH_SIZE);
+    prefetch->start = start;
+    prefetch->end = end;
+    prefetch->align = MAX(align, 1U);
+    prefetch->read_pos = start;
+    prefetch->fill_pos = start;
+    prefetch->generation = 0;
+
+    prefetch->thread =
+        furi_thread_alloc_ex("WavPrefetch", 2048, wav_player_prefetch_worker, prefetch);
+    furi_thread_start(prefetch->thread);
+
+    return prefetch;
+}
+
+void wav_player_prefetch_free(WavPlayerPrefetch* prefetch) {
+    furi_thread_flags_set(furi_thread_get_id(prefetch->thread), WavPlayerPrefetchEventStop);
+    furi_thread_join(prefetch->thread);
+    furi_thread_free(prefetch->thread);
+
+    furi_mutex_free(prefetch->mutex);
+    free(prefetch->ring);
+    free(prefetch);
+}
+
+size_t wav_player_prefetch_read(
+    WavPlayerPrefetch* prefetch,
+    uint8_t* data,
+    size_t size,
+    uint32_t timeout) {
+    uint32_t start = furi_get_tick();
+    size_t done = 0;
+
+    while(true) {
+        furi_check(furi_mutex_acquire(prefetch->mutex, FuriWaitForever) == FuriStatusOk);
+        size_t count = MIN(size - done, prefetch->fill_pos - prefetch->read_pos);
+        // never hand out part of a block while the rest is still on the card
+        if(prefetch->fill_pos < prefetch->end) count -= count % prefetch->align;
+        size_t offset = prefetch->read_pos % WAV_PLAYER_PREFETCH_SIZE;
+        size_t tail = MIN(count, WAV_PLAYER_PREFETCH_SIZE - offset);
+
+        memcpy(&data[done], &prefetch->ring[offset], tail);
+        memcpy(&data[done + tail], prefetch->ring, count - tail);
+        prefetch->read_pos += count;
+        done += count;
+
+        bool eof = prefetch->read_pos >= prefetch->end;
+        furi_mutex_release(prefetch->mutex);
+
+        if(count) {
+            furi_thread_flags_set(
+                furi_thread_get_id(prefetch->thread), WavPlayerPrefetchEventWake);
+        }
+
+        if(done == size || eof || furi_get_tick() - start >= timeout) break;
+        furi_delay_tick(1);
+    }
+
+    return done;
+}
+
+void wav_player_prefetch_seek(WavPlayerPrefetch* prefetch, size_t position) {
+    furi_check(furi_mutex_acquire(prefetch->mutex, FuriWaitForever) == FuriStatusOk);
+    position = CLAMP(position, prefetch->end, prefetch->start);
+    prefetch->read_pos = position;
+    prefetch->fill_pos = position;
+    prefetch->generation++;
+    furi_mutex_release(prefetch->mutex);
+
+    furi_thread_flags_set(furi_thread_get_id(prefetch->thread), WavPlayerPrefetchEventWake);
+}
+
+size_t wav_player_prefetch_tell(WavPlayerPrefetch* prefetch) {
+    furi_check(furi_mutex_acquire(prefetch->mutex, FuriWaitForever) == FuriStatusOk);
+    size_t position = prefetch->read_pos;
+    furi_mutex_release(prefetch->mutex);
+    return position;
+}
+
+bool wav_player_prefetch_eof(WavPlayerPrefetch* prefetch) {
+    furi_check(furi_mutex_acquire(prefetch->mutex, FuriWaitForever) == FuriStatusOk);
+    bool eof = prefetch->read_pos >= prefetch->end;
+    furi_mutex_release(prefetch->mutex);
+    return eof;
+}
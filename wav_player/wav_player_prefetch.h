@@ -0,0 +1,43 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <toolbox/stream/stream.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Ring of raw file bytes filled ahead of playback by a reader thread
+#define WAV_PLAYER_PREFETCH_SIZE (32 * 1024)
+// Reads are split at multiples of this file offset
+#define WAV_PLAYER_PREFETCH_CHUNK (8 * 1024)
+
+typedef struct WavPlayerPrefetch WavPlayerPrefetch;
+
+// Start reading stream bytes [start, end) in the background. Reads return whole
+// blocks of align bytes (a frame or a compressed block) except at the end.
+WavPlayerPrefetch*
+    wav_player_prefetch_alloc(Stream* stream, size_t start, size_t end, size_t align);
+
+void wav_player_prefetch_free(WavPlayerPrefetch* prefetch);
+
+// Copy up to size bytes, waiting at most timeout ms for the reader to catch up.
+// Returns less than size at the end of data or if the reader fell behind.
+size_t wav_player_prefetch_read(
+    WavPlayerPrefetch* prefetch,
+    uint8_t* data,
+    size_t size,
+    uint32_t timeout);
+
+// Drop buffered data and continue from position (absolute stream offset, a
+// whole number of blocks away from start)
+void wav_player_prefetch_seek(WavPlayerPrefetch* prefetch, size_t position);
+
+// Stream offset of the next byte returned by wav_player_prefetch_read()
+size_t wav_player_prefetch_tell(WavPlayerPrefetch* prefetch);
+
+bool wav_player_prefetch_eof(WavPlayerPrefetch* prefetch);
+
+#ifdef __cplusplus
+}
+#endif
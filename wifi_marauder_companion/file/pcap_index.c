@@ -0,0 +1,336 @@
+#include "pcap_index.h"
+
+#include <furi.h>
+
+#define PCAP_INDEX_MAX_NETWORKS (64)
+// Enough for radiotap, the 802.11 header and an EAPOL M1 carrying a PMKID
+#define PCAP_INDEX_FRAME_SIZE (320)
+// Anything larger is taken as lost sync and the stream is searched for a header again
+#define PCAP_INDEX_MAX_RECORD (4096)
+
+#define PCAP_MAGIC (0xA1B2C3D4)
+#define PCAP_GLOBAL_HEADER_SIZE (24)
+#define PCAP_RECORD_HEADER_SIZE (16)
+#define PCAP_LINKTYPE_IEEE802_11 (105)
+#define PCAP_LINKTYPE_RADIOTAP (127)
+
+#define EAPOL_KEY_INFO_INSTALL (0x0040)
+#define EAPOL_KEY_INFO_ACK (0x0080)
+#define EAPOL_KEY_INFO_MIC (0x0100)
+#define EAPOL_KEY_INFO_SECURE (0x0200)
+
+typedef enum {
+    PcapIndexStateMagic,
+    PcapIndexStateGlobalHeader,
+    PcapIndexStateRecordHeader,
+    PcapIndexStateRecordData,
+} PcapIndexState;
+
+typedef struct {
+    uint8_t bssid[6];
+    bool used;
+    bool pmkid;
+    char ssid[33];
+    uint16_t eapol[4];
+} PcapIndexNetwork;
+
+struct PcapIndex {
+    PcapIndexState state;
+    uint32_t link_type;
+    uint32_t magic;
+    uint8_t header[PCAP_GLOBAL_HEADER_SIZE];
+    size_t header_len;
+    // current record, only the first PCAP_INDEX_FRAME_SIZE bytes are kept
+    uint8_t frame[PCAP_INDEX_FRAME_SIZE];
+    size_t frame_len;
+    size_t record_len;
+    size_t record_read;
+
+    uint32_t packets;
+    uint32_t eapol[4];
+    uint32_t pmkids;
+    uint16_t networks;
+    uint32_t networks_dropped;
+    PcapIndexNetwork table[PCAP_INDEX_MAX_NETWORKS];
+};
+
+static uint32_t pcap_index_read_le32(const uint8_t* data) {
+    return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static PcapIndexNetwork* pcap_index_lookup(PcapIndex* index, const uint8_t* bssid) {
+    // FNV-1a, open addressing with linear probing
+    uint32_t hash = 2166136261UL;
+    for(size_t i = 0; i < 6; i++) {
+        hash = (hash ^ bssid[i]) * 16777619UL;
+    }
+
+    for(size_t probe = 0; probe < PCAP_INDEX_MAX_NETWORKS; probe++) {
+        PcapIndexNetwork* network = &index->table[(hash + probe) % PCAP_INDEX_MAX_NETWORKS];
+        if(!network->used) {
+            network->used = true;
+            memcpy(network->bssid, bssid, 6);
+            index->networks++;
+            return network;
+        }
+        if(memcmp(network->bssid, bssid, 6) == 0) return network;
+    }
+
+    index->networks_dropped++;
+    return NULL;
+}
+
+static void pcap_index_parse_beacon(PcapIndex* index, const uint8_t* frame, size_t len) {
+    if(len < 36) return;
+    PcapIndexNetwork* network = pcap_index_lookup(index, &frame[16]);
+    if(!network || network->ssid[0]) return;
+
+    // tagged parameters follow the timestamp, interval and capabilities
+    for(size_t pos = 36; pos + 2 <= len; pos += 2 + frame[pos + 1]) {
+        uint8_t tag_len = frame[pos + 1];
+        if(pos + 2 + tag_len > len) break;
+        if(frame[pos] != 0) continue;
+        if(tag_len == 0 || tag_len > 32 || frame[pos + 2] == 0) break; // hidden
+        memcpy(network->ssid, &frame[pos + 2], tag_len);
+        network->ssid[tag_len] = '\0';
+        break;
+    }
+}
+
+static bool pcap_index_has_pmkid(const uint8_t* key_data, size_t len) {
+    for(size_t pos = 0; pos + 2 <= len; pos += 2 + key_data[pos + 1]) {
+        uint8_t kde_len = key_data[pos + 1];
+        if(pos + 2 + kde_len > len) break;
+        // vendor KDE 00:0F:AC type 4 holds the 16 byte PMKID
+        if(key_data[pos] == 0xDD && kde_len >= 20 && key_data[pos + 2] == 0x00 &&
+           key_data[pos + 3] == 0x0F && key_data[pos + 4] == 0xAC && key_data[pos + 5] == 0x04) {
+            for(size_t i = 0; i < 16; i++) {
+                if(key_data[pos + 6 + i]) return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void pcap_index_parse_data(PcapIndex* index, const uint8_t* frame, size_t len) {
+    static const uint8_t eapol_llc[] = {0xAA, 0xAA, 0x03, 0x00, 0x00, 0x00, 0x88, 0x8E};
+    uint8_t subtype = (frame[0] >> 4) & 0x0F;
+    uint8_t flags = frame[1];
+    bool to_ds = flags & 0x01;
+    bool from_ds = flags & 0x02;
+    if(flags & 0x40) return; // protected
+
+    size_t header_len = 24;
+    if(to_ds && from_ds) header_len += 6;
+    if(subtype & 0x08) {
+        header_len += 2; // QoS control
+        if(flags & 0x80) header_len += 4; // HT control
+    }
+
+    // LLC and EAPOL header, then the key descriptor up to the key data length
+    size_t eapol = header_len + sizeof(eapol_llc);
+    size_t key = eapol + 4;
+    if(len < key + 95) return;
+    if(memcmp(&frame[header_len], eapol_llc, sizeof(eapol_llc)) != 0) return;
+    if(frame[eapol + 1] != 3) return; // not an EAPOL-Key
+
+    const uint8_t* bssid = &frame[16];
+    if(!to_ds && from_ds) {
+        bssid = &frame[10];
+    } else if(to_ds && !from_ds) {
+        bssid = &frame[4];
+    }
+    PcapIndexNetwork* network = pcap_index_lookup(index, bssid);
+
+    uint16_t key_info = (frame[key + 1] << 8) | frame[key + 2];
+    size_t key_data_len = (frame[key + 93] << 8) | frame[key + 94];
+    size_t message;
+    if(!(key_info & EAPOL_KEY_INFO_MIC)) {
+        message = 0;
+    } else if(key_info & EAPOL_KEY_INFO_ACK) {
+        message = 2;
+    } else if((key_info & EAPOL_KEY_INFO_SECURE) || key_data_len == 0) {
+        message = 3;
+    } else {
+        message = 1;
+    }
+    if(message == 0 && !(key_info & EAPOL_KEY_INFO_ACK)) return;
+    if(message == 2 && !(key_info & EAPOL_KEY_INFO_INSTALL)) return;
+
+    index->eapol[message]++;
+    if(network && network->eapol[message] < UINT16_MAX) network->eapol[message]++;
+
+    if(message == 0) {
+        size_t available = len - (key + 95);
+        if(pcap_index_has_pmkid(&frame[key + 95], MIN(key_data_len, available))) {
+            index->pmkids++;
+            if(network) network->pmkid = true;
+        }
+    }
+}
+
+static void pcap_index_parse_frame(PcapIndex* index) {
+    const uint8_t* frame = index->frame;
+    size_t len = index->frame_len;
+    index->packets++;
+
+    if(index->link_type == PCAP_LINKTYPE_RADIOTAP) {
+        if(len < 4) return;
+        size_t radiotap_len = frame[2] | (frame[3] << 8);
+        if(radiotap_len > len) return;
+        frame += radiotap_len;
+        len -= radiotap_len;
+    } else if(index->link_type != PCAP_LINKTYPE_IEEE802_11) {
+        return;
+    }
+    if(len < 24) return;
+
+    uint8_t type = (frame[0] >> 2) & 0x03;
+    uint8_t subtype = (frame[0] >> 4) & 0x0F;
+    if(type == 0 && (subtype == 8 || subtype == 5)) {
+        pcap_index_parse_beacon(index, frame, len);
+    } else if(type == 2) {
+        pcap_index_parse_data(index, frame, len);
+    }
+}
+
+PcapIndex* pcap_index_alloc() {
+    PcapIndex* index = malloc(sizeof(PcapIndex));
+    index->state = PcapIndexStateMagic;
+    return index;
+}
+
+void pcap_index_free(PcapIndex* index) {
+    furi_assert(index);
+    free(index);
+}
+
+void pcap_index_feed(PcapIndex* index, const uint8_t* data, size_t len) {
+    furi_assert(index);
+
+    while(len) {
+        switch(index->state) {
+        case PcapIndexStateMagic:
+            // the board restarts the stream with a fresh header for every capture
+            index->magic = (index->magic >> 8) | ((uint32_t)*data << 24);
+            data++;
+            len--;
+            if(index->magic == PCAP_MAGIC) {
+                index->header_len = 4;
+                index->state = PcapIndexStateGlobalHeader;
+            }
+            break;
+        case PcapIndexStateGlobalHeader:
+        case PcapIndexStateRecordHeader: {
+            size_t needed = index->state == PcapIndexStateGlobalHeader ?
+                                PCAP_GLOBAL_HEADER_SIZE :
+                                PCAP_RECORD_HEADER_SIZE;
+            size_t chunk = MIN(len, needed - index->header_len);
+            memcpy(&index->header[index->header_len], data, chunk);
+            index->header_len += chunk;
+            data += chunk;
+            len -= chunk;
+            if(index->header_len < needed) break;
+
+            index->header_len = 0;
+            if(index->state == PcapIndexStateGlobalHeader) {
+                index->link_type = pcap_index_read_le32(&index->header[20]);
+                index->state = PcapIndexStateRecordHeader;
+                break;
+            }
+            index->record_len = pcap_index_read_le32(&index->header[8]);
+            if(index->record_len > PCAP_INDEX_MAX_RECORD) {
+                index->magic = 0;
+                index->state = PcapIndexStateMagic;
+                break;
+            }
+            index->record_read = 0;
+            index->frame_len = 0;
+            index->state = PcapIndexStateRecordData;
+            break;
+        }
+        case PcapIndexStateRecordData: {
+            size_t chunk = MIN(len, index->record_len - index->record_read);
+            if(index->frame_len < PCAP_INDEX_FRAME_SIZE) {
+                size_t kept = MIN(chunk, PCAP_INDEX_FRAME_SIZE - index->frame_len);
+                memcpy(&index->frame[index->frame_len], data, kept);
+                index->frame_len += kept;
+            }
+            index->record_read += chunk;
+            data += chunk;
+            len -= chunk;
+            if(index->record_read == index->record_len) {
+                pcap_index_parse_frame(index);
+                index->state = PcapIndexStateRecordHeader;
+            }
+            break;
+        }
+        }
+    }
+}
+
+bool pcap_index_save(PcapIndex* index, Storage* storage, const char* path) {
+    furi_assert(index);
+    File* file = storage_file_alloc(storage);
+    FuriString* text = furi_string_alloc();
+
+    furi_string_printf(
+        text,
+        "Packets: %lu\nNetworks: %u\nEAPOL M1-4: %lu/%lu/%lu/%lu\nPMKIDs: %lu\n",
+        index->packets,
+        index->networks,
+        index->eapol[0],
+        index->eapol[1],
+        index->eapol[2],
+        index->eapol[3],
+        index->pmkids);
+    if(index->networks_dropped) {
+        furi_string_cat_printf(text, "Table full, %lu missed\n", index->networks_dropped);
+    }
+
+    for(size_t i = 0; i < PCAP_INDEX_MAX_NETWORKS; i++) {
+        PcapIndexNetwork* network = &index->table[i];
+        if(!network->used) continue;
+        const uint8_t* b = network->bssid;
+        furi_string_cat_printf(
+            text,
+            "\n%s\n%02X:%02X:%02X:%02X:%02X:%02X\n",
+            network->ssid[0] ? network->ssid : "<hidden>",
+            b[0],
+            b[1],
+            b[2],
+            b[3],
+            b[4],
+            b[5]);
+        if(network->eapol[0] || network->eapol[1] || network->eapol[2] || network->eapol[3]) {
+            furi_string_cat_printf(
+                text,
+                "EAPOL %u/%u/%u/%u\n",
+                network->eapol[0],
+                network->eapol[1],
+                network->eapol[2],
+                network->eapol[3]);
+        }
+        if(network->pmkid) furi_string_cat_str(text, "PMKID\n");
+    }
+
+    bool success = false;
+    if(storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        size_t size = furi_string_size(text);
+        success = storage_file_write(file, furi_string_get_cstr(text), size) == size;
+        storage_file_close(file);
+    }
+
+    furi_string_free(text);
+    storage_file_free(file);
+    return success;
+}
+
+bool pcap_index_sidecar_path(const char* pcap_path, char* out, size_t out_size) {
+    const char* extension = strrchr(pcap_path, '.');
+    size_t stem = extension ? (size_t)(extension - pcap_path) : strlen(pcap_path);
+    if(stem + strlen(PCAP_INDEX_SIDECAR_EXTENSION) >= out_size) return false;
+    memcpy(out, pcap_path, stem);
+    strcpy(&out[stem], PCAP_INDEX_SIDECAR_EXTENSION);
+    return true;
+}
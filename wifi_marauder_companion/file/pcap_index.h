@@ -0,0 +1,22 @@
+#pragma once
+
+#include <storage/storage.h>
+
+// Streaming summary of a capture, fed the same bytes as the pcap file.
+// It only keeps a fixed BSSID table and counters, so it can run while recording
+// and is saved as a small text sidecar the log viewer can show without the pcap.
+typedef struct PcapIndex PcapIndex;
+
+#define PCAP_INDEX_SIDECAR_EXTENSION ".summary"
+
+PcapIndex* pcap_index_alloc();
+
+void pcap_index_free(PcapIndex* index);
+
+void pcap_index_feed(PcapIndex* index, const uint8_t* data, size_t len);
+
+// Writes the summary as text, replacing any existing file
+bool pcap_index_save(PcapIndex* index, Storage* storage, const char* path);
+
+// "dir/name.pcap" becomes "dir/name.summary", returns false if it does not fit
+bool pcap_index_sidecar_path(const char* pcap_path, char* out, size_t out_size);
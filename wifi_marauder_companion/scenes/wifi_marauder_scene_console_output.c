@@ -29,26 +29,52 @@ bool _wifi_marauder_is_save_pcaps_enabled(WifiMarauderApp* app) {
            strncmp("sniff", app->selected_tx_string, strlen("sniff")) == 0;
 }
 
+// The writers drop what the SD card cannot keep up with, say so in the console
+static void _wifi_marauder_report_dropped(WifiMarauderApp* app) {
+    uint32_t dropped = 0;
+    if(app->capture_writer) dropped += buffered_file_writer_get_dropped(app->capture_writer);
+    if(app->log_writer) dropped += buffered_file_writer_get_dropped(app->log_writer);
+    if(dropped == app->reported_dropped) return;
+
+    char msg[48];
+    snprintf(msg, sizeof(msg), "\n[SD too slow: %lu bytes dropped]\n", dropped);
+    text_box_store_append_str(app->text_box_store, msg);
+    app->reported_dropped = dropped;
+}
+
+// Name the pcap after the log of the same run, so the log viewer can find its summary
+static char* _wifi_marauder_resolve_pcap_path(WifiMarauderApp* app, const char* prefix) {
+    char* pcap_path = NULL;
+    if(app->is_writing_log) {
+        FuriString* path = furi_string_alloc_set_str(app->log_file_path);
+        FuriString* name = furi_string_alloc();
+        path_extract_filename(path, name, true);
+        furi_string_printf(
+            path, "%s/%s.pcap", MARAUDER_APP_FOLDER_PCAPS, furi_string_get_cstr(name));
+        if(!storage_file_exists(app->storage, furi_string_get_cstr(path))) {
+            pcap_path = strdup(furi_string_get_cstr(path));
+        }
+        furi_string_free(name);
+        furi_string_free(path);
+    }
+    if(pcap_path == NULL) {
+        pcap_path = sequential_file_resolve_path(
+            app->storage, MARAUDER_APP_FOLDER_PCAPS, prefix, "pcap");
+    }
+    return pcap_path;
+}
+
 void wifi_marauder_console_output_handle_rx_data_cb(uint8_t* buf, size_t len, void* context) {
     furi_assert(context);
     WifiMarauderApp* app = context;
 
     if(app->is_writing_log) {
         app->has_saved_logs_this_session = true;
-        storage_file_write(app->log_file, buf, len);
+        buffered_file_writer_write(app->log_writer, buf, len);
     }
 
-    // If text box store gets too big, then truncate it
-    app->text_box_store_strlen += len;
-    if(app->text_box_store_strlen >= WIFI_MARAUDER_TEXT_BOX_STORE_SIZE - 1) {
-        furi_string_right(app->text_box_store, app->text_box_store_strlen / 2);
-        app->text_box_store_strlen = furi_string_size(app->text_box_store) + len;
-    }
-
-    // Null-terminate buf and append to text box store
-    buf[len] = '\0';
-    furi_string_cat_printf(app->text_box_store, "%s", buf);
-    view_dispatcher_send_custom_event(app->view_dispatcher, WifiMarauderEventRefreshConsoleOutput);
+    // Shown by the next tick
+    text_box_store_append(app->text_box_store, (char*)buf, len);
 }
 
 void wifi_marauder_console_output_handle_rx_packets_cb(uint8_t* buf, size_t len, void* context) {
@@ -56,7 +82,8 @@ void wifi_marauder_console_output_handle_rx_packets_cb(uint8_t* buf, size_t len,
     WifiMarauderApp* app = context;
 
     if(app->is_writing_pcap) {
-        storage_file_write(app->capture_file, buf, len);
+        buffered_file_writer_write(app->capture_writer, buf, len);
+        pcap_index_feed(app->capture_index, buf, len);
     }
 }
 
@@ -77,24 +104,23 @@ void wifi_marauder_scene_console_output_on_enter(void* context) {
 
     // Set command-related messages
     if(app->is_command) {
-        furi_string_reset(app->text_box_store);
-        app->text_box_store_strlen = 0;
+        text_box_store_reset(app->text_box_store);
         // Help message
         if(0 == strncmp("help", app->selected_tx_string, strlen("help"))) {
             const char* help_msg = "Marauder companion " WIFI_MARAUDER_APP_VERSION "\n";
-            furi_string_cat_str(app->text_box_store, help_msg);
-            app->text_box_store_strlen += strlen(help_msg);
+            text_box_store_append_str(app->text_box_store, help_msg);
         }
         // Stopscan message
         if(app->show_stopscan_tip) {
             const char* help_msg = "Press BACK to send stopscan\n";
-            furi_string_cat_str(app->text_box_store, help_msg);
-            app->text_box_store_strlen += strlen(help_msg);
+            text_box_store_append_str(app->text_box_store, help_msg);
         }
     }
 
     // Set starting text
-    text_box_set_text(app->text_box, furi_string_get_cstr(app->text_box_store));
+    text_box_store_show(app->text_box_store, app->text_box);
+
+    app->reported_dropped = 0;
 
     // Set scene state and switch view
     scene_manager_set_scene_state(app->scene_manager, WifiMarauderSceneConsoleOutput, 0);
@@ -127,6 +153,8 @@ void wifi_marauder_scene_console_output_on_enter(void* context) {
             if(app->log_file_path != NULL) {
                 if(storage_file_open(
                        app->log_file, app->log_file_path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+                    app->log_writer = buffered_file_writer_alloc(
+                        app->log_file, WIFI_MARAUDER_LOG_BUFFER_SIZE, "MarauderLogWriter");
                     app->is_writing_log = true;
                 } else {
                     dialog_message_show_storage_error(app->dialogs, "Cannot open log file");
@@ -138,12 +166,23 @@ void wifi_marauder_scene_console_output_on_enter(void* context) {
 
         // If it is a sniff function or script, open the pcap file for recording
         if(_wifi_marauder_is_save_pcaps_enabled(app)) {
-            if(sequential_file_open(
-                   app->storage, app->capture_file, MARAUDER_APP_FOLDER_PCAPS, prefix, "pcap")) {
+            char* pcap_path = _wifi_marauder_resolve_pcap_path(app, prefix);
+            if(pcap_path != NULL &&
+               storage_file_open(app->capture_file, pcap_path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+                app->capture_writer = buffered_file_writer_alloc(
+                    app->capture_file, WIFI_MARAUDER_PCAP_BUFFER_SIZE, "MarauderPcapWriter");
+                app->capture_index = pcap_index_alloc();
+                if(!pcap_index_sidecar_path(
+                       pcap_path,
+                       app->capture_summary_path,
+                       sizeof(app->capture_summary_path))) {
+                    app->capture_summary_path[0] = '\0';
+                }
                 app->is_writing_pcap = true;
             } else {
                 dialog_message_show_storage_error(app->dialogs, "Cannot open pcap file");
             }
+            free(pcap_path);
         }
 
         // Send command with newline '\n'
@@ -167,9 +206,10 @@ bool wifi_marauder_scene_console_output_on_event(void* context, SceneManagerEven
     bool consumed = false;
 
     if(event.type == SceneManagerEventTypeCustom) {
-        text_box_set_text(app->text_box, furi_string_get_cstr(app->text_box_store));
         consumed = true;
     } else if(event.type == SceneManagerEventTypeTick) {
+        _wifi_marauder_report_dropped(app);
+        text_box_store_update(app->text_box_store, app->text_box);
         consumed = true;
     }
 
@@ -194,12 +234,28 @@ void wifi_marauder_scene_console_output_on_exit(void* context) {
     wifi_marauder_script_worker_free(app->script_worker);
     app->script_worker = NULL;
 
+    // Writers flush what they still hold before the files are closed
     app->is_writing_pcap = false;
+    if(app->capture_writer) {
+        buffered_file_writer_free(app->capture_writer);
+        app->capture_writer = NULL;
+    }
     if(app->capture_file && storage_file_is_open(app->capture_file)) {
         storage_file_close(app->capture_file);
     }
+    if(app->capture_index) {
+        if(app->capture_summary_path[0]) {
+            pcap_index_save(app->capture_index, app->storage, app->capture_summary_path);
+        }
+        pcap_index_free(app->capture_index);
+        app->capture_index = NULL;
+    }
 
     app->is_writing_log = false;
+    if(app->log_writer) {
+        buffered_file_writer_free(app->log_writer);
+        app->log_writer = NULL;
+    }
     if(app->log_file && storage_file_is_open(app->log_file)) {
         storage_file_close(app->log_file);
     }
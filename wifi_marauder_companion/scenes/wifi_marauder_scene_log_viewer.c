@@ -10,18 +10,56 @@ void wifi_marauder_scene_log_viewer_widget_callback(
     }
 }
 
+// The pcap recorded alongside a log shares its name, show its summary above the first page
+static void _prepend_capture_summary(WifiMarauderApp* app) {
+    FuriString* path = furi_string_alloc_set_str(app->log_file_path);
+    FuriString* summary = furi_string_alloc();
+    path_extract_filename(path, summary, true);
+    furi_string_printf(
+        path,
+        "%s/%s%s",
+        MARAUDER_APP_FOLDER_PCAPS,
+        furi_string_get_cstr(summary),
+        PCAP_INDEX_SIDECAR_EXTENSION);
+
+    File* file = storage_file_alloc(app->storage);
+    if(storage_file_open(file, furi_string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING)) {
+        char temp[64 + 1];
+        furi_string_set_str(summary, "--- Capture summary ---\n");
+        while(furi_string_size(summary) < WIFI_MARAUDER_TEXT_BOX_STORE_SIZE) {
+            uint16_t num_bytes = storage_file_read(file, temp, sizeof(temp) - 1);
+            if(num_bytes == 0) {
+                break;
+            }
+            temp[num_bytes] = '\0';
+            furi_string_cat_str(summary, temp);
+        }
+        furi_string_cat_str(summary, "--- Log ---\n");
+        furi_string_cat(summary, app->log_viewer_text);
+        furi_string_set(app->log_viewer_text, summary);
+        storage_file_close(file);
+    }
+
+    storage_file_free(file);
+    furi_string_free(summary);
+    furi_string_free(path);
+}
+
 static void _read_log_page_into_text_store(WifiMarauderApp* app) {
     char temp[64 + 1];
     storage_file_seek(
         app->log_file, WIFI_MARAUDER_TEXT_BOX_STORE_SIZE * (app->open_log_file_page - 1), true);
-    furi_string_reset(app->text_box_store);
+    furi_string_reset(app->log_viewer_text);
     for(uint16_t i = 0; i < (WIFI_MARAUDER_TEXT_BOX_STORE_SIZE / (sizeof(temp) - 1)); i++) {
         uint16_t num_bytes = storage_file_read(app->log_file, temp, sizeof(temp) - 1);
         if(num_bytes == 0) {
             break;
         }
         temp[num_bytes] = '\0';
-        furi_string_cat_str(app->text_box_store, temp);
+        furi_string_cat_str(app->log_viewer_text, temp);
+    }
+    if(app->open_log_file_page == 1) {
+        _prepend_capture_summary(app);
     }
 }
 
@@ -47,7 +85,7 @@ void wifi_marauder_scene_log_viewer_setup_widget(WifiMarauderApp* app, bool call
 
     widget_reset(widget);
 
-    if(furi_string_empty(app->text_box_store)) {
+    if(furi_string_empty(app->log_viewer_text)) {
         char help_msg[256];
         snprintf(
             help_msg,
@@ -55,11 +93,11 @@ void wifi_marauder_scene_log_viewer_setup_widget(WifiMarauderApp* app, bool call
             "The log is empty! :(\nTry sending a command?\n\nSaving pcaps to flipper sdcard: %s\nSaving logs to flipper sdcard: %s",
             app->ok_to_save_pcaps ? "ON" : "OFF",
             app->ok_to_save_logs ? "ON" : "OFF");
-        furi_string_set_str(app->text_box_store, help_msg);
+        furi_string_set_str(app->log_viewer_text, help_msg);
     }
 
     widget_add_text_scroll_element(
-        widget, 0, 0, 128, 53, furi_string_get_cstr(app->text_box_store));
+        widget, 0, 0, 128, 53, furi_string_get_cstr(app->log_viewer_text));
 
     if(1 < app->open_log_file_page && app->open_log_file_page < app->open_log_file_num_pages) {
         // hide "Browse" text for middle pages
@@ -112,7 +150,8 @@ void wifi_marauder_scene_log_viewer_on_enter(void* context) {
     app->open_log_file_page = 0;
     app->open_log_file_num_pages = 0;
     bool saved_logs_exist = false;
-    if(!app->has_saved_logs_this_session && furi_string_empty(app->text_box_store)) {
+    if(!app->has_saved_logs_this_session && furi_string_empty(app->log_viewer_text) &&
+       text_box_store_is_empty(app->text_box_store)) {
         // no commands sent yet this session, find last saved log
         if(storage_dir_open(app->log_file, MARAUDER_APP_FOLDER_LOGS)) {
             char name[70];
@@ -0,0 +1,88 @@
+#include "text_box_store.h"
+
+struct TextBoxStore {
+    FuriMutex* mutex;
+    char* ring;
+    size_t size;
+    // ring position of the oldest byte
+    size_t head;
+    size_t length;
+    bool changed;
+    // copy handed to the TextBox, only touched from the scene thread
+    char* text;
+};
+
+TextBoxStore* text_box_store_alloc(size_t size) {
+    furi_assert(size);
+    TextBoxStore* store = malloc(sizeof(TextBoxStore));
+    store->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    store->ring = malloc(size);
+    store->size = size;
+    store->text = malloc(size + 1);
+    return store;
+}
+
+void text_box_store_free(TextBoxStore* store) {
+    furi_assert(store);
+    furi_mutex_free(store->mutex);
+    free(store->ring);
+    free(store->text);
+    free(store);
+}
+
+void text_box_store_reset(TextBoxStore* store) {
+    furi_check(furi_mutex_acquire(store->mutex, FuriWaitForever) == FuriStatusOk);
+    store->head = 0;
+    store->length = 0;
+    store->changed = true;
+    furi_mutex_release(store->mutex);
+}
+
+// drop the oldest line, or a quarter of the store if it has no line end that soon
+static void text_box_store_drop_line(TextBoxStore* store) {
+    size_t limit = MAX(store->size / 4, 1U);
+    while(store->length && limit--) {
+        char c = store->ring[store->head];
+        store->head = (store->head + 1) % store->size;
+        store->length--;
+        if(c == '\n') break;
+    }
+}
+
+void text_box_store_append(TextBoxStore* store, const char* data, size_t len) {
+    furi_check(furi_mutex_acquire(store->mutex, FuriWaitForever) == FuriStatusOk);
+    for(size_t i = 0; i < len; i++) {
+        if(data[i] == '\0') continue;
+        if(store->length == store->size) text_box_store_drop_line(store);
+        store->ring[(store->head + store->length) % store->size] = data[i];
+        store->length++;
+    }
+    store->changed = true;
+    furi_mutex_release(store->mutex);
+}
+
+void text_box_store_append_str(TextBoxStore* store, const char* str) {
+    text_box_store_append(store, str, strlen(str));
+}
+
+bool text_box_store_is_empty(TextBoxStore* store) {
+    return store->length == 0;
+}
+
+void text_box_store_show(TextBoxStore* store, TextBox* text_box) {
+    furi_check(furi_mutex_acquire(store->mutex, FuriWaitForever) == FuriStatusOk);
+    size_t first = MIN(store->length, store->size - store->head);
+    memcpy(store->text, store->ring + store->head, first);
+    memcpy(store->text + first, store->ring, store->length - first);
+    store->text[store->length] = '\0';
+    store->changed = false;
+    furi_mutex_release(store->mutex);
+
+    text_box_set_text(text_box, store->text);
+}
+
+bool text_box_store_update(TextBoxStore* store, TextBox* text_box) {
+    if(!store->changed) return false;
+    text_box_store_show(store, text_box);
+    return true;
+}
@@ -61,8 +61,9 @@ WifiMarauderApp* wifi_marauder_app_alloc() {
     app->text_box = text_box_alloc();
     view_dispatcher_add_view(
         app->view_dispatcher, WifiMarauderAppViewConsoleOutput, text_box_get_view(app->text_box));
-    app->text_box_store = furi_string_alloc();
-    furi_string_reserve(app->text_box_store, WIFI_MARAUDER_TEXT_BOX_STORE_SIZE);
+    app->text_box_store = text_box_store_alloc(WIFI_MARAUDER_TEXT_BOX_STORE_SIZE);
+    app->log_viewer_text = furi_string_alloc();
+    furi_string_reserve(app->log_viewer_text, WIFI_MARAUDER_TEXT_BOX_STORE_SIZE);
 
     app->text_input = text_input_alloc();
     view_dispatcher_add_view(
@@ -145,7 +146,8 @@ void wifi_marauder_app_free(WifiMarauderApp* app) {
 
     widget_free(app->widget);
     text_box_free(app->text_box);
-    furi_string_free(app->text_box_store);
+    text_box_store_free(app->text_box_store);
+    furi_string_free(app->log_viewer_text);
     text_input_free(app->text_input);
     submenu_free(app->submenu);
     variable_item_list_free(app->var_item_list);
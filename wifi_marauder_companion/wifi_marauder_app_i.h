@@ -6,7 +6,10 @@
 #include "scenes/wifi_marauder_scene.h"
 #include "wifi_marauder_custom_event.h"
 #include "wifi_marauder_uart.h"
+#include "text_box_store.h"
 #include "file/sequential_file.h"
+#include "file/buffered_file_writer.h"
+#include "file/pcap_index.h"
 #include "script/wifi_marauder_script.h"
 #include "script/wifi_marauder_script_worker.h"
 #include "script/wifi_marauder_script_executor.h"
@@ -32,6 +35,8 @@
 
 #define WIFI_MARAUDER_TEXT_BOX_STORE_SIZE (4096)
 #define WIFI_MARAUDER_TEXT_INPUT_STORE_SIZE (512)
+#define WIFI_MARAUDER_PCAP_BUFFER_SIZE (16 * 1024)
+#define WIFI_MARAUDER_LOG_BUFFER_SIZE (4 * 1024)
 
 #define MARAUDER_APP_FOLDER_USER "apps_data/marauder"
 #define MARAUDER_APP_FOLDER EXT_PATH(MARAUDER_APP_FOLDER_USER)
@@ -56,13 +61,18 @@ struct WifiMarauderApp {
     SceneManager* scene_manager;
 
     char text_input_store[WIFI_MARAUDER_TEXT_INPUT_STORE_SIZE + 1];
-    FuriString* text_box_store;
-    size_t text_box_store_strlen;
+    TextBoxStore* text_box_store;
+    FuriString* log_viewer_text;
     TextBox* text_box;
     TextInput* text_input;
     Storage* storage;
     File* capture_file;
     File* log_file;
+    BufferedFileWriter* capture_writer;
+    BufferedFileWriter* log_writer;
+    PcapIndex* capture_index;
+    char capture_summary_path[100];
+    uint32_t reported_dropped;
     char log_file_path[100];
     File* save_pcap_setting_file;
     File* save_logs_setting_file;
@@ -1,5 +1,6 @@
 #include "wifi_marauder_app_i.h"
 #include "wifi_marauder_uart.h"
+#include "uart_dma.h"
 
 #include <xtreme.h>
 #define XTREME_UART_CH \
@@ -14,7 +15,7 @@ struct WifiMarauderUart {
     WifiMarauderApp* app;
     FuriHalUartId channel;
     FuriThread* rx_thread;
-    FuriStreamBuffer* rx_stream;
+    UartDma* rx_dma;
     uint8_t rx_buf[RX_BUF_SIZE + 1];
     void (*handle_rx_data_cb)(uint8_t* buf, size_t len, void* context);
 };
@@ -33,15 +34,6 @@ void wifi_marauder_uart_set_handle_rx_data_cb(
 
 #define WORKER_ALL_RX_EVENTS (WorkerEvtStop | WorkerEvtRxDone)
 
-void wifi_marauder_uart_on_irq_cb(UartIrqEvent ev, uint8_t data, void* context) {
-    WifiMarauderUart* uart = (WifiMarauderUart*)context;
-
-    if(ev == UartIrqEventRXNE) {
-        furi_stream_buffer_send(uart->rx_stream, &data, 1, 0);
-        furi_thread_flags_set(furi_thread_get_id(uart->rx_thread), WorkerEvtRxDone);
-    }
-}
-
 static int32_t uart_worker(void* context) {
     WifiMarauderUart* uart = (void*)context;
 
@@ -51,15 +43,13 @@ static int32_t uart_worker(void* context) {
         furi_check((events & FuriFlagError) == 0);
         if(events & WorkerEvtStop) break;
         if(events & WorkerEvtRxDone) {
-            size_t len = furi_stream_buffer_receive(uart->rx_stream, uart->rx_buf, RX_BUF_SIZE, 0);
+            size_t len = uart_dma_receive(uart->rx_dma, uart->rx_buf, RX_BUF_SIZE);
             if(len > 0) {
                 if(uart->handle_rx_data_cb) uart->handle_rx_data_cb(uart->rx_buf, len, uart->app);
             }
         }
     }
 
-    furi_stream_buffer_free(uart->rx_stream);
-
     return 0;
 }
 
@@ -82,7 +72,7 @@ WifiMarauderUart*
 
     uart->app = app;
     uart->channel = channel;
-    uart->rx_stream = furi_stream_buffer_alloc(RX_BUF_SIZE, 1);
+    uart->rx_dma = uart_dma_alloc(RX_BUF_SIZE);
     uart->rx_thread = furi_thread_alloc();
     furi_thread_set_name(uart->rx_thread, thread_name);
     furi_thread_set_stack_size(uart->rx_thread, 1024);
@@ -95,7 +85,7 @@ WifiMarauderUart*
         furi_hal_uart_init(channel, BAUDRATE);
     }
     furi_hal_uart_set_br(channel, BAUDRATE);
-    furi_hal_uart_set_irq_cb(channel, wifi_marauder_uart_on_irq_cb, uart);
+    uart_dma_start(uart->rx_dma, channel, furi_thread_get_id(uart->rx_thread), WorkerEvtRxDone);
 
     return uart;
 }
@@ -117,11 +107,12 @@ WifiMarauderUart* wifi_marauder_lp_uart_init(WifiMarauderApp* app) {
 void wifi_marauder_uart_free(WifiMarauderUart* uart) {
     furi_assert(uart);
 
+    uart_dma_stop(uart->rx_dma);
     furi_thread_flags_set(furi_thread_get_id(uart->rx_thread), WorkerEvtStop);
     furi_thread_join(uart->rx_thread);
     furi_thread_free(uart->rx_thread);
 
-    furi_hal_uart_set_irq_cb(uart->channel, NULL, NULL);
+    uart_dma_free(uart->rx_dma);
     if(uart->channel == FuriHalUartIdLPUART1) {
         furi_hal_uart_deinit(uart->channel);
     } else {
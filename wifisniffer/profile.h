@@ -0,0 +1,104 @@
+#pragma once
+
+#include <furi.h>
+#include <furi_hal.h>
+
+/**
+ * Named probes timing hot code with the DWT cycle counter.
+ *
+ * Each probe keeps the count and the min/avg/max cycles of the scopes it measured. It takes
+ * a slot in a static table the first time it is recorded, also from interrupts. While the
+ * app runs the "profile" CLI command prints the table ("profile reset" clears it), and the
+ * table is logged when the app exits.
+ *
+ * Probes are compiled into debug builds, or with PROFILE_ENABLE defined, and are empty
+ * otherwise:
+ *
+ *     PROFILE_BEGIN(fill);
+ *     ...
+ *     PROFILE_END(fill);
+ *
+ * A name is used once in a function, and every return in between needs its PROFILE_END.
+ *
+ * The same builds watch memory: the free heap is sampled while the app runs, and worker
+ * threads report the least stack they had left with profile_thread_exit(). When the app
+ * exits the stack and heap high-water marks are logged and appended to profile.log in the
+ * app's data folder, which is what its application.fam stack_size should be sized from.
+ *
+ * Startup is timed with profile_phase() at the end of each step and profile_first_frame()
+ * in the draw callback, both log the time since profile_start(). Call profile_start() first
+ * thing in the entry point for these to mean time since launch.
+ */
+#if defined(FURI_DEBUG) || defined(PROFILE_ENABLE)
+#define PROFILE_ENABLED
+#endif
+
+#define PROFILE_PROBES_MAX 16
+#define PROFILE_THREADS_MAX 8
+
+typedef struct {
+    const char* name;
+    bool registered;
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+} ProfileProbe;
+
+#ifdef PROFILE_ENABLED
+
+#define PROFILE_BEGIN(probe)                                       \
+    static ProfileProbe profile_probe_##probe = {.name = #probe}; \
+    const uint32_t profile_start_##probe = DWT->CYCCNT
+
+#define PROFILE_END(probe) \
+    profile_record(&profile_probe_##probe, DWT->CYCCNT - profile_start_##probe)
+
+void profile_record(ProfileProbe* probe, uint32_t cycles);
+
+/** Register the "profile" CLI command and start sampling the heap, call from the app
+ * thread when the app starts */
+void profile_start(void);
+
+/** Log the table and the memory summary, unregister the CLI command. Call from the app
+ * thread before the app exits, after its workers were joined */
+void profile_stop(void);
+
+/** Record the least free stack of the calling thread, call as a worker returns */
+void profile_thread_exit(const char* name);
+
+/** Log the time since profile_start() as the end of a startup step, from any thread */
+void profile_phase(const char* name);
+
+/** Log the time to the first frame, call from the draw callback, only the first call logs */
+void profile_first_frame(void);
+
+/** Clear the numbers of all the probes */
+void profile_reset(void);
+
+#else
+
+#define PROFILE_BEGIN(probe)
+#define PROFILE_END(probe)
+
+static inline void profile_start(void) {
+}
+
+static inline void profile_stop(void) {
+}
+
+static inline void profile_reset(void) {
+}
+
+static inline void profile_thread_exit(const char* name) {
+    UNUSED(name);
+}
+
+static inline void profile_phase(const char* name) {
+    UNUSED(name);
+}
+
+static inline void profile_first_frame(void) {
+}
+
+#endif
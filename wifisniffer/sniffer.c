@@ -8,14 +8,20 @@
 
 #include "helpers/minmea.h"
 #include "wifisniffer_icons.h"
+#include "profile.h"
 
 #define appname "ll-wifisniffer"
 
 #define RX_BUF_SIZE 2048
-#define MAX_ACCESS_POINTS 2048 // imagine getting this many access points
+#define MAX_ACCESS_POINTS 1024 // imagine getting this many access points
 
 #define MAX_SSID_LENGTH 32
-#define MAX_BSSID_LENGTH 18
+#define BSSID_SIZE 6
+
+// bssid -> access point lookup, open addressing kept at most half full
+#define AP_TABLE_BITS 11
+#define AP_TABLE_SIZE (1 << AP_TABLE_BITS)
+#define AP_SLOT_EMPTY 0xFFFF
 
 #define UART_CH_ESP \
     (xtreme_settings.uart_esp_channel == UARTDefault ? FuriHalUartIdUSART1 : FuriHalUartIdLPUART1)
@@ -41,13 +47,8 @@ typedef struct {
 } Event;
 
 typedef struct {
-    char* recievedMac;
-    char* sentMac;
-} Packet;
-
-typedef struct {
-    char* ssid;
-    char* bssid;
+    char ssid[MAX_SSID_LENGTH + 1];
+    uint8_t bssid[BSSID_SIZE];
     int8_t rssi;
     uint8_t channel;
     FuriHalRtcDateTime datetime;
@@ -72,9 +73,12 @@ typedef struct {
     File* file;
     char* dataString;
     uint16_t access_points_count;
+    // stored in arrival order, ap_table and ap_order hold indexes into it
     AccessPoint access_points[MAX_ACCESS_POINTS];
+    uint16_t ap_table[AP_TABLE_SIZE];
+    // access points sorted by ssid, access_points_index is a position in here
+    uint16_t ap_order[MAX_ACCESS_POINTS];
     int16_t access_points_index;
-    AccessPoint active_access_point;
     bool extra_info;
     bool pressedButton;
     float last_latitude;
@@ -94,17 +98,35 @@ static void input_callback(InputEvent* input_event, FuriMessageQueue* queue) {
     furi_message_queue_put(queue, &event, FuriWaitForever);
 }
 
+static void format_bssid(FuriString* str, const uint8_t* bssid) {
+    furi_string_printf(
+        str,
+        "%02x:%02x:%02x:%02x:%02x:%02x",
+        bssid[0],
+        bssid[1],
+        bssid[2],
+        bssid[3],
+        bssid[4],
+        bssid[5]);
+}
+
 static void show_access_point(Canvas* canvas, Context* context) {
     Context* ctx = context;
 
-    AccessPoint ap = ctx->active_access_point;
+    AccessPoint ap = ctx->access_points[ctx->ap_order[ctx->access_points_index]];
 
     canvas_draw_str_aligned(canvas, 62, 25, AlignCenter, AlignBottom, ap.ssid);
 
     canvas_set_font(canvas, FontSecondary);
 
+    format_bssid(ctx->buffer, ap.bssid);
     canvas_draw_str_aligned(
-        canvas, 38 + (ctx->access_points_count > 99 ? 5 : 0), 12, AlignLeft, AlignBottom, ap.bssid);
+        canvas,
+        38 + (ctx->access_points_count > 99 ? 5 : 0),
+        12,
+        AlignLeft,
+        AlignBottom,
+        furi_string_get_cstr(ctx->buffer));
 
     furi_string_printf(ctx->buffer, "Signal strength: %ddBm", ap.rssi);
     canvas_draw_str_aligned(
@@ -170,27 +192,125 @@ static void render_callback(Canvas* canvas, void* context) {
     furi_mutex_release(ctx->mutex);
 }
 
-// order ctx->access_points by ssid alphabetically
-static void sort_access_points(Context* ctx) {
-    for(int i = 0; i < ctx->access_points_count; i++) {
-        for(int j = i + 1; j < ctx->access_points_count; j++) {
-            if(strcmp(ctx->access_points[i].ssid, ctx->access_points[j].ssid) > 0) {
-                AccessPoint temp = ctx->access_points[i];
-                ctx->access_points[i] = ctx->access_points[j];
-                ctx->access_points[j] = temp;
-            }
+static uint16_t ap_table_hash(const uint8_t* bssid) {
+    uint64_t key = 0;
+    for(size_t i = 0; i < BSSID_SIZE; i++) {
+        key = (key << 8) | bssid[i];
+    }
+    return (key * 0x9E3779B97F4A7C15ULL) >> (64 - AP_TABLE_BITS);
+}
+
+// returns the slot holding bssid, or the empty slot it would be inserted at
+static uint16_t ap_table_probe(Context* ctx, const uint8_t* bssid) {
+    uint16_t slot = ap_table_hash(bssid);
+    while(ctx->ap_table[slot] != AP_SLOT_EMPTY &&
+          memcmp(ctx->access_points[ctx->ap_table[slot]].bssid, bssid, BSSID_SIZE) != 0) {
+        slot = (slot + 1) & (AP_TABLE_SIZE - 1);
+    }
+    return slot;
+}
+
+static AccessPoint* find_access_point(Context* ctx, const uint8_t* bssid) {
+    uint16_t slot = ap_table_probe(ctx, bssid);
+    if(ctx->ap_table[slot] == AP_SLOT_EMPTY) return NULL;
+    return &ctx->access_points[ctx->ap_table[slot]];
+}
+
+// empty a slot, shifting back the entries that probed past it
+static void ap_table_remove(Context* ctx, uint16_t slot) {
+    uint16_t hole = slot;
+    uint16_t next = (slot + 1) & (AP_TABLE_SIZE - 1);
+    while(ctx->ap_table[next] != AP_SLOT_EMPTY) {
+        uint16_t home = ap_table_hash(ctx->access_points[ctx->ap_table[next]].bssid);
+        if(((next - home) & (AP_TABLE_SIZE - 1)) >= ((next - hole) & (AP_TABLE_SIZE - 1))) {
+            ctx->ap_table[hole] = ctx->ap_table[next];
+            hole = next;
         }
+        next = (next + 1) & (AP_TABLE_SIZE - 1);
     }
+    ctx->ap_table[hole] = AP_SLOT_EMPTY;
 }
 
-// set the index from the active access point
-static void set_index_from_access_points(Context* ctx) {
-    for(int i = 0; i < ctx->access_points_count; i++) {
-        if(ctx->access_points[i].bssid == ctx->active_access_point.bssid) {
-            ctx->access_points_index = i;
-            break;
+// add the ap at ctx->access_points[ctx->access_points_count] to the table and the ssid order
+static void add_access_point(Context* ctx) {
+    uint16_t index = ctx->access_points_count;
+    const AccessPoint* ap = &ctx->access_points[index];
+
+    ctx->ap_table[ap_table_probe(ctx, ap->bssid)] = index;
+
+    // binary search for the first ap sorting after the new one
+    uint16_t low = 0;
+    uint16_t high = ctx->access_points_count;
+    while(low < high) {
+        uint16_t mid = (low + high) / 2;
+        if(strcmp(ctx->access_points[ctx->ap_order[mid]].ssid, ap->ssid) <= 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
         }
     }
+    memmove(
+        &ctx->ap_order[low + 1],
+        &ctx->ap_order[low],
+        (ctx->access_points_count - low) * sizeof(uint16_t));
+    ctx->ap_order[low] = index;
+    ctx->access_points_count++;
+
+    // keep the same ap selected
+    if(ctx->access_points_index < 0) {
+        ctx->access_points_index = 0;
+    } else if(ctx->access_points_count > 1 && low <= ctx->access_points_index) {
+        ctx->access_points_index++;
+    }
+}
+
+// remove the ap at position in the ssid order
+static void remove_access_point(Context* ctx, uint16_t position) {
+    uint16_t index = ctx->ap_order[position];
+    uint16_t last = ctx->access_points_count - 1;
+
+    ap_table_remove(ctx, ap_table_probe(ctx, ctx->access_points[index].bssid));
+    memmove(
+        &ctx->ap_order[position],
+        &ctx->ap_order[position + 1],
+        (last - position) * sizeof(uint16_t));
+
+    // fill the hole in the storage with the last ap
+    if(index != last) {
+        ctx->ap_table[ap_table_probe(ctx, ctx->access_points[last].bssid)] = index;
+        for(uint16_t i = 0; i < last; i++) {
+            if(ctx->ap_order[i] == last) {
+                ctx->ap_order[i] = index;
+                break;
+            }
+        }
+        ctx->access_points[index] = ctx->access_points[last];
+    }
+    ctx->access_points_count--;
+}
+
+// parse "xx:xx:xx:xx:xx:xx"
+static bool parse_bssid(const char* str, uint8_t* bssid) {
+    for(size_t i = 0; i < BSSID_SIZE; i++) {
+        if(!isxdigit((unsigned char)str[0]) || !isxdigit((unsigned char)str[1])) return false;
+        if(str[2] != (i < BSSID_SIZE - 1 ? ':' : '\0')) return false;
+        bssid[i] = strtol(str, NULL, 16);
+        str += 3;
+    }
+    return true;
+}
+
+// split the next comma separated field in place, returns an empty string past the end
+static char* next_field(char** cursor) {
+    char* field = *cursor;
+    char* comma = strchr(field, ',');
+    if(comma) {
+        *comma = '\0';
+        *cursor = comma + 1;
+    } else {
+        *cursor = field + strlen(field);
+    }
+    return field;
 }
 
 static void removeSpaces(char* str) {
@@ -217,74 +337,24 @@ static void removeSpaces(char* str) {
 static void parseLine(void* context, char* line) {
     Context* ctx = context;
 
-    AccessPoint ap = {.ssid = malloc(MAX_SSID_LENGTH + 1), .bssid = malloc(MAX_BSSID_LENGTH + 1)};
+    char* cursor = line;
+    char* type = next_field(&cursor);
 
-    Packet pkt = {.recievedMac = malloc(18 + 1), .sentMac = malloc(18 + 1)};
-
-    char* token = strtok(line, ",");
-    int i = 0;
-    bool isAp = false;
-    bool isValid = true;
-    UNUSED(isValid);
-    while(token != NULL) {
-        switch(i) {
-        case 0:
-            if(strcmp(token, "AR") == 0) {
-                isAp = true;
-                isValid = true;
-            } else if(strcmp(token, "PK") == 0) {
-                isAp = false;
-                isValid = true;
-            }
-            break;
-        case 1:
-            if(isAp && isValid) {
-                removeSpaces(token);
-                strcpy(ap.ssid, token);
-            } else if(!isAp && isValid) {
-                strncpy(pkt.recievedMac, token, 18);
-                pkt.recievedMac[18] = '\0';
-            }
-            break;
-        case 2:
-            if(isAp && isValid) {
-                strcpy(ap.bssid, token);
-            } else if(!isAp && isValid) {
-                strncpy(pkt.sentMac, token, 18);
-                pkt.sentMac[18] = '\0';
-            }
-            break;
-        case 3:
-            if(isAp && isValid) {
-                ap.rssi = atoi(token);
-            }
-            break;
-        case 4:
-            if(isAp && isValid) {
-                ap.channel = atoi(token);
-            }
-            break;
-        }
-
-        token = strtok(NULL, ",");
-        i++;
-    }
-
-    if(isAp && isValid) {
-        // free the packet
-        free(pkt.recievedMac);
-        free(pkt.sentMac);
+    if(strcmp(type, "AR") == 0) {
+        char* ssid = next_field(&cursor);
+        char* bssid = next_field(&cursor);
+        int rssi = atoi(next_field(&cursor));
+        int channel = atoi(next_field(&cursor));
+        removeSpaces(ssid);
 
         // check if values are valid
-        // bssid needs an ":"
+        // bssid needs to be a mac address
         // rssi needs to be negative
         // channel needs to be between 1 and 14
         // ssid needs to be at least 1 character long
-        if(ap.bssid[2] != ':' || ap.bssid[5] != ':' || ap.bssid[8] != ':' || ap.bssid[11] != ':' ||
-           ap.bssid[14] != ':' || ap.rssi > 0 || ap.channel < 1 || ap.channel > 14 ||
-           strlen(ap.ssid) < 1) {
-            free(ap.ssid);
-            free(ap.bssid);
+        AccessPoint ap = {.rssi = rssi, .channel = channel};
+        if(!parse_bssid(bssid, ap.bssid) || rssi > 0 || channel < 1 || channel > 14 ||
+           strlen(ssid) < 1) {
             return;
         }
 
@@ -301,73 +371,37 @@ static void parseLine(void* context, char* line) {
             ap.longitude = ctx->last_longitude;
         }
 
-        // check if ap is already in the list otherwise add it but update the rssi
-        bool found = false;
-        for(size_t i = 0; i < ctx->access_points_count; i++) {
-            if(strcmp(ctx->access_points[i].bssid, ap.bssid) == 0) {
-                found = true;
-                //update rssi channel datetime
-                ctx->access_points[i].rssi = ap.rssi;
-                ctx->access_points[i].channel = ap.channel;
-                ctx->access_points[i].datetime = ap.datetime;
-                ctx->access_points[i].latitude = ap.latitude;
-                ctx->access_points[i].longitude = ap.longitude;
-
-                if(strcmp(ctx->active_access_point.bssid, ap.bssid) == 0) {
-                    ctx->active_access_point.rssi = ap.rssi;
-                    ctx->active_access_point.channel = ap.channel;
-                    ctx->active_access_point.datetime = ap.datetime;
-                    ctx->active_access_point.latitude = ap.latitude;
-                    ctx->active_access_point.longitude = ap.longitude;
-                }
-
-                free(ap.ssid);
-                free(ap.bssid);
-
-                break;
-            }
+        // update the ap if it is already known, otherwise add it
+        AccessPoint* known = find_access_point(ctx, ap.bssid);
+        if(known) {
+            known->rssi = ap.rssi;
+            known->channel = ap.channel;
+            known->datetime = ap.datetime;
+            known->latitude = ap.latitude;
+            known->longitude = ap.longitude;
+        } else if(ctx->access_points_count < MAX_ACCESS_POINTS) {
+            strncpy(ap.ssid, ssid, MAX_SSID_LENGTH);
+            ctx->access_points[ctx->access_points_count] = ap;
+            add_access_point(ctx);
         }
-
-        if(!found) {
-            memcpy(&ctx->access_points[ctx->access_points_count], &ap, sizeof(AccessPoint));
-            ctx->access_points_count++;
-        }
-
-        sort_access_points(ctx);
-        set_index_from_access_points(ctx);
-    } else {
-        // it is a packet so screw the ap
-        free(ap.ssid);
-        free(ap.bssid);
+    } else if(strcmp(type, "PK") == 0) {
+        uint8_t recievedMac[BSSID_SIZE];
+        uint8_t sentMac[BSSID_SIZE];
 
         // check if values are valid
-        // mac needs to be 6 characters long
-        if(strlen(pkt.recievedMac) != 17 || strlen(pkt.sentMac) != 17 ||
-           ctx->access_points_count == 0) {
-            free(pkt.recievedMac);
-            free(pkt.sentMac);
+        if(!parse_bssid(next_field(&cursor), recievedMac) ||
+           !parse_bssid(next_field(&cursor), sentMac) || ctx->access_points_count == 0) {
             return;
         }
 
         furi_hal_light_set(LightGreen, 0);
         furi_hal_light_set(LightBlue, 255);
 
-        for(size_t i = 0; i < ctx->access_points_count; i++) {
-            if(strcmp(ctx->access_points[i].bssid, pkt.recievedMac) == 0) {
-                ctx->access_points[i].packetRxCount++;
-                break;
-            }
-        }
-
-        for(size_t i = 0; i < ctx->access_points_count; i++) {
-            if(strcmp(ctx->access_points[i].bssid, pkt.sentMac) == 0) {
-                ctx->access_points[i].packetTxCount++;
-                break;
-            }
-        }
+        AccessPoint* ap = find_access_point(ctx, recievedMac);
+        if(ap) ap->packetRxCount++;
 
-        free(pkt.recievedMac);
-        free(pkt.sentMac);
+        ap = find_access_point(ctx, sentMac);
+        if(ap) ap->packetTxCount++;
     }
 }
 
@@ -454,6 +488,7 @@ static int32_t uart_worker_esp(void* context) {
     furi_hal_uart_set_irq_cb(UART_CH_ESP, NULL, NULL);
 
     furi_stream_buffer_free(ctx->rx_stream_esp);
+    profile_thread_exit("esp");
 
     return 0;
 }
@@ -574,12 +609,14 @@ static int32_t uart_worker_gps(void* context) {
     furi_hal_uart_set_irq_cb(UART_CH_GPS, NULL, NULL);
 
     furi_stream_buffer_free(ctx->rx_stream_gps);
+    profile_thread_exit("gps");
 
     return 0;
 }
 
 int32_t wifisniffer_app(void* p) {
     UNUSED(p);
+    profile_start(); // "profile" CLI command in debug builds
 
     // if(UART_CH_ESP == UART_CH_GPS) {
     //     FURI_LOG_I(appname, "ESP and GPS uart can't be the same");
@@ -609,6 +646,7 @@ int32_t wifisniffer_app(void* p) {
 
     ctx->access_points_count = 0;
     ctx->access_points_index = 0;
+    memset(ctx->ap_table, 0xFF, sizeof(ctx->ap_table));
 
     ctx->pressedButton = false;
 
@@ -682,11 +720,7 @@ int32_t wifisniffer_app(void* p) {
                 } else if(event.input.type == InputTypeLong && event.input.key == InputKeyOk) {
                     // remove accespoint
                     if(ctx->access_points_count > 0) {
-                        for(int i = ctx->access_points_index; i < ctx->access_points_count - 1;
-                            i++) {
-                            ctx->access_points[i] = ctx->access_points[i + 1];
-                        }
-                        ctx->access_points_count--;
+                        remove_access_point(ctx, ctx->access_points_index);
                         if(ctx->access_points_index >= ctx->access_points_count) {
                             ctx->access_points_index = ctx->access_points_count - 1;
                         }
@@ -696,13 +730,11 @@ int32_t wifisniffer_app(void* p) {
                     if(ctx->access_points_index < 0) {
                         ctx->access_points_index = ctx->access_points_count - 1;
                     }
-                    ctx->active_access_point = ctx->access_points[ctx->access_points_index];
                 } else if(event.input.type == InputTypePress && event.input.key == InputKeyUp) {
                     ctx->access_points_index++;
                     if(ctx->access_points_index >= ctx->access_points_count) {
                         ctx->access_points_index = 0;
                     }
-                    ctx->active_access_point = ctx->access_points[ctx->access_points_index];
                 } else if(event.input.type == InputTypePress && event.input.key == InputKeyLeft) {
                 } else if(event.input.type == InputTypePress && event.input.key == InputKeyRight) {
                 }
@@ -713,7 +745,6 @@ int32_t wifisniffer_app(void* p) {
                 // fix for the empty active access point when there was no interaction
                 if(!ctx->pressedButton) {
                     ctx->access_points_index = 0;
-                    ctx->active_access_point = ctx->access_points[ctx->access_points_index];
                 }
 
                 break;
@@ -759,13 +790,14 @@ int32_t wifisniffer_app(void* p) {
     }
 
     for(int i = 0; i < ctx->access_points_count; i++) {
-        AccessPoint ap = ctx->access_points[i];
+        AccessPoint ap = ctx->access_points[ctx->ap_order[i]];
+        format_bssid(ctx->buffer, ap.bssid);
         furi_string_printf(
             ctx->buffer2,
             "%s,%s,%s,%d,%d,%d,%d,%d,%d,%d,%d,%f,%f\r\n",
             "Accesspoint",
             ap.ssid,
-            ap.bssid,
+            furi_string_get_cstr(ctx->buffer),
             ap.rssi,
             ap.channel,
             ap.datetime.year,
@@ -829,5 +861,6 @@ int32_t wifisniffer_app(void* p) {
         furi_hal_power_disable_otg();
     }
 
+    profile_stop();
     return 0;
 }
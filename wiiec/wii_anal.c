@@ -41,18 +41,42 @@
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
 //+============================================================================ ========================================
-// OS Callback : Timer tick
-// We register this function to be called when the OS signals a timer 'tick' event
+// Controller polling thread
+// Samples the controller at a fixed rate (of 'fps'), without holding up the GUI thread
+// ecPoll() only posts WIIEC events when the controller state changes,
+//   the TICK event that follows each sample paces the (animated) screen redraws
 //
-static void cbTimer(FuriMessageQueue* queue) {
+#define POLL_STOP (1 << 0)
+
+static int32_t pollThread(void* ctx) {
     ENTER;
-    furi_assert(queue);
+    furi_assert(ctx);
+
+    state_t* state = ctx;
+    uint32_t period = state->timerHz / state->fps;
+    uint32_t next = furi_get_tick();
+
+    while(true) {
+        if(furi_mutex_acquire(state->mutex, FuriWaitForever) == FuriStatusOk) {
+            if(state->timerEn) {
+                eventMsg_t message = {.id = EVID_TICK};
+                ecPoll(&state->ec, state->queue);
+                furi_message_queue_put(state->queue, &message, 0);
+            }
+            furi_mutex_release(state->mutex);
+        }
+
+        // Sleep until the next sample is due ...if we have fallen behind, sample again now
+        uint32_t now = furi_get_tick();
+        next += period;
+        if((int32_t)(next - now) < 0) next = now;
 
-    eventMsg_t message = {.id = EVID_TICK};
-    furi_message_queue_put(queue, &message, 0);
+        uint32_t flags = furi_thread_flags_wait(POLL_STOP, FuriFlagWaitAny, next - now);
+        if(!(flags & FuriFlagError) && (flags & POLL_STOP)) break;
+    }
 
     LEAVE;
-    return;
+    return 0;
 }
 
 //+============================================================================ ========================================
@@ -212,7 +236,8 @@ static inline bool stateInit(state_t* const state) {
 
     // Timer
     state->timerEn = false;
-    state->timer = NULL;
+    state->poller = NULL;
+    state->queue = NULL;
     state->timerHz = furi_kernel_get_tick_frequency();
     state->fps = 30;
 
@@ -271,13 +296,9 @@ void timerEn(state_t* state, bool on) {
         if(state->timerEn) {
             WARN(wii_errs[WARN_SCAN_START]);
         } else {
-            // Set the timer to fire at 'fps' times/second
-            if(furi_timer_start(state->timer, state->timerHz / state->fps) == FuriStatusOk) {
-                state->timerEn = true;
-                INFO("%s : monitor started", __func__);
-            } else {
-                ERROR(wii_errs[ERR_TIMER_START]);
-            }
+            // The polling thread samples the controller 'fps' times/second while enabled
+            state->timerEn = true;
+            INFO("%s : monitor started", __func__);
         }
 
         // DISable scanning
@@ -285,13 +306,8 @@ void timerEn(state_t* state, bool on) {
         if(!state->timerEn) {
             WARN(wii_errs[WARN_SCAN_STOP]);
         } else {
-            // Stop the timer
-            if(furi_timer_stop(state->timer) == FuriStatusOk) {
-                state->timerEn = false;
-                INFO("%s : monitor stopped", __func__);
-            } else {
-                ERROR(wii_errs[ERR_TIMER_STOP]);
-            }
+            state->timerEn = false;
+            INFO("%s : monitor stopped", __func__);
         }
     }
 
@@ -367,12 +383,18 @@ int32_t wii_ec_anal(void) {
     // 8. Attach the viewport to the GUI
     gui_add_view_port(gui, vpp, GuiLayerFullscreen);
 
-    // ===== Timer =====
-    // 9. Allocate a timer
-    if(!(state->timer = furi_timer_alloc(cbTimer, FuriTimerTypePeriodic, queue))) {
+    // ===== Polling thread =====
+    // 9. Start the controller polling thread (it idles until scanning is enabled)
+    state->queue = queue;
+    if(!(state->poller = furi_thread_alloc())) {
         ERROR(wii_errs[(error = ERR_NO_TIMER)]);
         goto bail;
     }
+    furi_thread_set_name(state->poller, "WiiEcPoll");
+    furi_thread_set_stack_size(state->poller, 2048);
+    furi_thread_set_context(state->poller, state);
+    furi_thread_set_callback(state->poller, pollThread);
+    furi_thread_start(state->poller);
 
     // === System Notifications ===
     // 10. Acquire a handle for the system notification queue
@@ -444,12 +466,8 @@ int32_t wii_ec_anal(void) {
             // *** Handle events ***
             switch(msg.id) {
             //---------------------------------------------
-            case EVID_TICK: // Timer events
-                //! I would prefer to have ecPoll() called by cbTimer()
-                //! ...but how does cbTimer() get the required access to the state variables?  Namely: 'state->ec'
-                //! So, for now, the timer pushes a message to call ecPoll()
-                //!                                       which, in turn, will push WIIEC event meesages! <facepalm>
-                ecPoll(&state->ec, queue);
+            case EVID_TICK: // Poll events
+                // The controller has already been read by pollThread(), just redraw (animations)
                 break;
 
             //---------------------------------------------
@@ -493,11 +511,12 @@ bail:
         state->notify = NULL;
     }
 
-    // 9. Stop the timer
-    if(state && state->timer) {
-        (void)furi_timer_stop(state->timer);
-        furi_timer_free(state->timer);
-        state->timer = NULL;
+    // 9. Stop the polling thread
+    if(state && state->poller) {
+        furi_thread_flags_set(furi_thread_get_id(state->poller), POLL_STOP);
+        furi_thread_join(state->poller);
+        furi_thread_free(state->poller);
+        state->poller = NULL;
         state->timerEn = false;
     }
 
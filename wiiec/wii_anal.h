@@ -61,7 +61,8 @@ typedef struct state {
     bool run; // true : plugin is running
 
     bool timerEn; // controller scanning enabled
-    FuriTimer* timer; // the timer
+    FuriThread* poller; // controller polling thread
+    FuriMessageQueue* queue; // event queue (for the polling thread)
     uint32_t timerHz; // system ticks per second
     int fps; // poll/refresh [frames]-per-second
 
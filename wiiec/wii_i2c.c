@@ -102,8 +102,12 @@ static void dump(const uint8_t* buf, const unsigned int len, const char* id) {
 static void decrypt(uint8_t* buf, const uint8_t* encKey, const uint8_t reg, unsigned int len) {
 #if 1 // Use standard algorithm
     // decrypted_byte = (encrypted_byte XOR encKey[1][address%8]) + encKey[2][address%8]
-    for(uint8_t* p = buf; p < buf + len; p++)
-        *p = (*p ^ encKey[(reg + (p - buf)) % 8]) + encKey[8 + ((reg + (p - buf)) % 8)];
+    // The two key halves are 8-entry XOR/ADD tables, indexed by the (wrapping) register address
+    const uint8_t* xorKey = encKey;
+    const uint8_t* addKey = encKey + 8;
+    uint8_t k = reg & 7;
+
+    for(uint8_t* p = buf; p < buf + len; p++, k = (k + 1) & 7) *p = (*p ^ xorKey[k]) + addKey[k];
 
 #else //! This is (I think) a shortcut for an all-zero key [not tested]
     (void)encKey;
@@ -128,17 +132,17 @@ int ecRead(wiiEC_t* pec) {
         goto bail;
     }
 
-    if(!furi_hal_i2c_is_device_ready(i2cBus, i2cAddr, i2cTimeout)) {
-        INFO("%s : device disconnected", __func__);
-        pec->init = false;
-        rv = 2;
-        goto bail;
-    }
-
+    // One bus transaction per sample - only probe for the device if the read fails
     if(!furi_hal_i2c_trxd(
            i2cBus, i2cAddr, &regJoy, 1, pec->joy, JOY_LEN, i2cTimeout, i2cReadWait)) {
-        ERROR("%s : trxd fail", __func__);
-        rv = 3;
+        if(!furi_hal_i2c_is_device_ready(i2cBus, i2cAddr, i2cTimeout)) {
+            INFO("%s : device disconnected", __func__);
+            pec->init = false;
+            rv = 2;
+        } else {
+            ERROR("%s : trxd fail", __func__);
+            rv = 3;
+        }
         goto bail;
     }
 
@@ -210,7 +214,7 @@ bool ecInit(wiiEC_t* pec, const uint8_t* encKey) {
         ERROR("%s : T(R)x fail (pid)", __func__);
         goto bail;
     }
-    if(pec->encrypt) decrypt(pec->joy, pec->encKey, regJoy, JOY_LEN);
+    if(pec->encrypt) decrypt(pec->pid, pec->encKey, regPid, PID_LEN);
     dump(pec->pid, PID_LEN, "pid"); // debug INFO
 
     // Find the StringID in the lookup table
@@ -264,7 +268,7 @@ bool ecInit(wiiEC_t* pec, const uint8_t* encKey) {
         ERROR("%s : trx fail (cal)", __func__);
         goto bail;
     }
-    if(pec->encrypt) decrypt(pec->joy, pec->encKey, regJoy, JOY_LEN);
+    if(pec->encrypt) decrypt(pec->calF, pec->encKey, regCal, CAL_LEN);
     dump(pec->calF, CAL_LEN, "cal");
 
     ecCalibrate(pec, CAL_RESET | CAL_FACTORY); // Load factory default calibration
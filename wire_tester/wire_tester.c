@@ -11,11 +11,65 @@
 
 //#define TAG "wire_tester"
 
-static const uint32_t EVENT_PERIOD_MS = 10; // check for input changes often
 static const float BEEP_FREQ = 2400.0f; // louder than other frequencies
 static const float BEEP_VOL = 0.8f;
 static const GpioPin* const INPUT_PIN = &gpio_ext_pb2; // pin 6
 
+// edges are timestamped in the interrupt, the main loop only wakes up when something happens
+#define EDGE_RING_SIZE 32
+// a level that lasts less than this is contact bounce or noise
+#define GLITCH_US 50
+// even the shortest contact beeps long enough to be heard
+#define MIN_FEEDBACK_MS 100
+#define CONTACT_LOG_SIZE 5
+
+typedef struct {
+    uint32_t tick;
+    uint32_t cycles;
+    bool level;
+} Edge;
+
+typedef struct {
+    FuriMessageQueue* event_queue;
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t overflows;
+    Edge edges[EDGE_RING_SIZE];
+} EdgeRing;
+
+typedef struct {
+    uint32_t start_ms; // since the app was started
+    uint32_t width_us; // 0 while the contact lasts
+} Contact;
+
+typedef struct {
+    FuriMutex* mutex;
+    EdgeRing ring;
+    uint32_t start_tick;
+
+    // glitch filter
+    bool level;
+    bool has_candidate;
+    Edge candidate;
+    Edge contact_start;
+
+    uint32_t contacts;
+    uint32_t glitches;
+    Contact log[CONTACT_LOG_SIZE]; // newest first
+    uint8_t log_count;
+    bool show_log;
+} WireTester;
+
+typedef enum {
+    EventTypeInput,
+    EventTypeEdge,
+} EventType;
+
+typedef struct {
+    EventType type;
+    InputEvent input;
+} Event;
+
 static void start_feedback(NotificationApp* notifications) {
     // set LED to green
     notification_message_block(notifications, &sequence_set_only_green_255);
@@ -39,26 +93,156 @@ static void stop_feedback(NotificationApp* notifications) {
 
 static void draw_callback(Canvas* canvas, void* ctx) {
     furi_assert(ctx);
+    WireTester* app = ctx;
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+
     canvas_clear(canvas);
-    canvas_draw_icon(canvas, 0, 0, &I_background_128x64);
+    char text[32];
+    if(app->show_log) {
+        canvas_set_font(canvas, FontPrimary);
+        snprintf(text, sizeof(text), "%lu contacts", app->contacts);
+        canvas_draw_str(canvas, 0, 9, text);
+        canvas_set_font(canvas, FontSecondary);
+        // edges the ring had no room for matter more than the filtered ones
+        if(app->ring.overflows) {
+            snprintf(text, sizeof(text), "%lu lost", app->ring.overflows);
+        } else {
+            snprintf(text, sizeof(text), "%lu glitches", app->glitches);
+        }
+        canvas_draw_str_aligned(canvas, 127, 9, AlignRight, AlignBottom, text);
+
+        for(uint8_t i = 0; i < app->log_count; i++) {
+            const Contact* contact = &app->log[i];
+            int written = snprintf(
+                text,
+                sizeof(text),
+                "%lu.%03lus  ",
+                contact->start_ms / 1000,
+                contact->start_ms % 1000);
+            if(contact->width_us == 0) {
+                snprintf(text + written, sizeof(text) - written, "closed");
+            } else if(contact->width_us < 10000) {
+                snprintf(text + written, sizeof(text) - written, "%lu us", contact->width_us);
+            } else {
+                snprintf(
+                    text + written, sizeof(text) - written, "%lu ms", contact->width_us / 1000);
+            }
+            canvas_draw_str(canvas, 0, 21 + i * 10, text);
+        }
+    } else {
+        canvas_draw_icon(canvas, 0, 0, &I_background_128x64);
+        canvas_set_font(canvas, FontSecondary);
+        snprintf(text, sizeof(text), "Contacts: %lu", app->contacts);
+        canvas_draw_str_aligned(canvas, 127, 40, AlignRight, AlignBottom, text);
+    }
+
+    furi_mutex_release(app->mutex);
 }
 
 static void input_callback(InputEvent* input_event, void* ctx) {
     furi_assert(ctx);
     FuriMessageQueue* event_queue = ctx;
-    furi_message_queue_put(event_queue, input_event, FuriWaitForever);
+    Event event = {.type = EventTypeInput, .input = *input_event};
+    furi_message_queue_put(event_queue, &event, FuriWaitForever);
+}
+
+// Both edges of the input pin, the level is read back so a missed edge can't invert the state
+static void edge_callback(void* ctx) {
+    uint32_t cycles = DWT->CYCCNT;
+    EdgeRing* ring = ctx;
+
+    uint32_t head = ring->head;
+    if(head - ring->tail < EDGE_RING_SIZE) {
+        Edge* edge = &ring->edges[head % EDGE_RING_SIZE];
+        edge->tick = furi_get_tick();
+        edge->cycles = cycles;
+        edge->level = furi_hal_gpio_read(INPUT_PIN);
+        ring->head = head + 1;
+    } else {
+        ring->overflows++;
+    }
+
+    Event event = {.type = EventTypeEdge};
+    furi_message_queue_put(ring->event_queue, &event, 0);
+}
+
+static uint32_t edge_interval_us(const Edge* from, const Edge* to) {
+    // the cycle counter wraps after a minute at 64 MHz
+    if(to->tick - from->tick > 30000) return (to->tick - from->tick) * 1000;
+    return (to->cycles - from->cycles) / furi_hal_cortex_instructions_per_microsecond();
+}
+
+// A filtered level change, returns true when a contact was made
+static bool wire_tester_commit(WireTester* app, const Edge* edge) {
+    app->level = edge->level;
+    bool closed = !edge->level;
+
+    if(closed) {
+        app->contact_start = *edge;
+        app->contacts++;
+        memmove(&app->log[1], &app->log[0], sizeof(Contact) * (CONTACT_LOG_SIZE - 1));
+        app->log[0].start_ms = edge->tick - app->start_tick;
+        app->log[0].width_us = 0;
+        if(app->log_count < CONTACT_LOG_SIZE) app->log_count++;
+    } else if(app->log_count > 0 && app->log[0].width_us == 0) {
+        app->log[0].width_us = MAX(edge_interval_us(&app->contact_start, edge), 1u);
+    }
+
+    return closed;
+}
+
+// Runs every queued edge through the glitch filter, returns true if a contact was made
+static bool wire_tester_process(WireTester* app) {
+    bool contact = false;
+    uint32_t glitch_cycles = GLITCH_US * furi_hal_cortex_instructions_per_microsecond();
+
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+
+    EdgeRing* ring = &app->ring;
+    while(ring->tail != ring->head) {
+        Edge edge = ring->edges[ring->tail % EDGE_RING_SIZE];
+        ring->tail++;
+
+        if(app->has_candidate) {
+            app->has_candidate = false;
+            if(edge.cycles - app->candidate.cycles < glitch_cycles) {
+                app->glitches++;
+                if(edge.level == app->level) continue;
+            } else {
+                contact |= wire_tester_commit(app, &app->candidate);
+            }
+        }
+        if(edge.level != app->level) {
+            app->candidate = edge;
+            app->has_candidate = true;
+        }
+    }
+
+    // the new level has been stable for long enough
+    if(app->has_candidate && DWT->CYCCNT - app->candidate.cycles >= glitch_cycles) {
+        app->has_candidate = false;
+        contact |= wire_tester_commit(app, &app->candidate);
+    }
+
+    furi_mutex_release(app->mutex);
+    return contact;
 }
 
 int32_t app_main(void* p) {
     UNUSED(p);
-    FuriMessageQueue* event_queue = furi_message_queue_alloc(8, sizeof(InputEvent));
+    FuriMessageQueue* event_queue = furi_message_queue_alloc(8, sizeof(Event));
+
+    WireTester* app = malloc(sizeof(WireTester));
+    app->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    app->ring.event_queue = event_queue;
+    app->start_tick = furi_get_tick();
 
     // force backlight on because our hands will be busy with wires
     NotificationApp* notifications = furi_record_open(RECORD_NOTIFICATION);
     notification_message_block(notifications, &sequence_display_backlight_enforce_on);
 
     ViewPort* view_port = view_port_alloc();
-    view_port_draw_callback_set(view_port, draw_callback, view_port);
+    view_port_draw_callback_set(view_port, draw_callback, app);
     view_port_input_callback_set(view_port, input_callback, event_queue);
 
     Gui* gui = furi_record_open(RECORD_GUI);
@@ -68,31 +252,69 @@ int32_t app_main(void* p) {
     stop_feedback(notifications);
 
     // set input to be normally high; it will be low when shorted to ground
-    furi_hal_gpio_init(INPUT_PIN, GpioModeInput, GpioPullUp, GpioSpeedLow);
+    furi_hal_gpio_init(INPUT_PIN, GpioModeInterruptRiseFall, GpioPullUp, GpioSpeedLow);
+    app->level = true;
+    // a wire connected before the start counts as a contact
+    if(!furi_hal_gpio_read(INPUT_PIN)) edge_callback(&app->ring);
+    furi_hal_gpio_add_int_callback(INPUT_PIN, edge_callback, &app->ring);
 
     bool alarming = false;
+    uint32_t feedback_start = 0;
+    bool stop_pending = false;
     bool running = true;
     while(running) {
-        // start and stop feedback on the transition
-        bool continuous = !furi_hal_gpio_read(INPUT_PIN);
-        if(continuous && !alarming) {
-            start_feedback(notifications);
-        } else if(!continuous && alarming) {
-            stop_feedback(notifications);
+        // only wake up on a timer while the glitch filter or a short beep is waiting
+        uint32_t timeout = FuriWaitForever;
+        if(app->has_candidate) {
+            timeout = 1;
+        } else if(stop_pending) {
+            uint32_t elapsed = furi_get_tick() - feedback_start;
+            uint32_t beep_ticks = furi_ms_to_ticks(MIN_FEEDBACK_MS);
+            timeout = elapsed < beep_ticks ? beep_ticks - elapsed : 0;
         }
-        alarming = continuous;
-
-        // exit on back key
-        InputEvent event;
-        if(furi_message_queue_get(event_queue, &event, EVENT_PERIOD_MS) == FuriStatusOk) {
-            if((event.type == InputTypePress || event.type == InputTypeRepeat) &&
-               event.key == InputKeyBack) {
-                running = false;
+
+        Event event;
+        if(furi_message_queue_get(event_queue, &event, timeout) == FuriStatusOk &&
+           event.type == EventTypeInput) {
+            if(event.input.type == InputTypePress || event.input.type == InputTypeRepeat) {
+                if(event.input.key == InputKeyBack) {
+                    // exit on back key
+                    running = false;
+                } else if(event.input.key == InputKeyOk) {
+                    furi_mutex_acquire(app->mutex, FuriWaitForever);
+                    app->show_log = !app->show_log;
+                    furi_mutex_release(app->mutex);
+                } else if(event.input.key == InputKeyDown) {
+                    furi_mutex_acquire(app->mutex, FuriWaitForever);
+                    app->contacts = 0;
+                    app->glitches = 0;
+                    app->ring.overflows = 0;
+                    app->log_count = 0;
+                    furi_mutex_release(app->mutex);
+                }
             }
         }
+
+        // start and stop feedback on the transition
+        if(wire_tester_process(app)) {
+            if(!alarming) start_feedback(notifications);
+            alarming = true;
+            feedback_start = furi_get_tick();
+        }
+        stop_pending = alarming && app->level;
+        if(stop_pending &&
+           furi_get_tick() - feedback_start >= furi_ms_to_ticks(MIN_FEEDBACK_MS)) {
+            stop_feedback(notifications);
+            alarming = false;
+            stop_pending = false;
+        }
+
         view_port_update(view_port);
     }
 
+    furi_hal_gpio_remove_int_callback(INPUT_PIN);
+    furi_hal_gpio_init(INPUT_PIN, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
+
     // return control of the LED, beeper, and backlight
     stop_feedback(notifications);
     notification_message_block(notifications, &sequence_display_backlight_enforce_auto);
@@ -105,5 +327,8 @@ int32_t app_main(void* p) {
     furi_record_close(RECORD_GUI);
     furi_record_close(RECORD_NOTIFICATION);
 
+    furi_mutex_free(app->mutex);
+    free(app);
+
     return 0;
 }
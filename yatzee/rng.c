@@ -0,0 +1,111 @@
+#include "rng.h"
+
+#include <furi.h>
+#include <furi_hal.h>
+
+#define RNG_TAG "Rng"
+// dice faces drawn 1000 times each, chi-square with 5 degrees of freedom is above 20.5 in
+// one run out of a thousand
+#define RNG_TEST_BINS 6
+#define RNG_TEST_DRAWS 1000
+#define RNG_TEST_LIMIT_TENTHS 205
+
+static uint32_t rotl(uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+// Spreads a seed over the state, consecutive values never all come out zero
+static uint32_t splitmix32(uint32_t* x) {
+    uint32_t z = (*x += 0x9E3779B9);
+    z = (z ^ (z >> 16)) * 0x85EBCA6B;
+    z = (z ^ (z >> 13)) * 0xC2B2AE35;
+    return z ^ (z >> 16);
+}
+
+void rng_seed(Rng* rng, uint32_t seed) {
+    for(uint8_t i = 0; i < 4; i++) {
+        rng->state[i] = splitmix32(&seed);
+    }
+}
+
+void rng_init(Rng* rng) {
+#ifdef RNG_FIXED_SEED
+    rng_seed(rng, RNG_FIXED_SEED);
+#else
+    do {
+        furi_hal_random_fill_buf((uint8_t*)rng->state, sizeof(rng->state));
+    } while(!(rng->state[0] | rng->state[1] | rng->state[2] | rng->state[3]));
+#endif
+}
+
+uint32_t rng_next(Rng* rng) {
+    uint32_t* s = rng->state;
+    const uint32_t result = rotl(s[1] * 5, 7) * 9;
+    const uint32_t t = s[1] << 9;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 11);
+
+    return result;
+}
+
+uint32_t rng_uniform(Rng* rng, uint32_t n) {
+    furi_assert(n);
+    // The high half of value * n is in range. 2^32 % n of the low halves would make some
+    // results come up once more often than the others, those are drawn again.
+    uint64_t product = (uint64_t)rng_next(rng) * n;
+    uint32_t low = product;
+    if(low < n) {
+        const uint32_t threshold = (0u - n) % n;
+        while(low < threshold) {
+            product = (uint64_t)rng_next(rng) * n;
+            low = product;
+        }
+    }
+    return product >> 32;
+}
+
+void rng_shuffle(Rng* rng, void* items, size_t count, size_t size) {
+    uint8_t* bytes = items;
+    for(size_t i = count; i > 1; i--) {
+        size_t j = rng_uniform(rng, i);
+        if(j == i - 1) continue;
+
+        uint8_t* a = bytes + (i - 1) * size;
+        uint8_t* b = bytes + j * size;
+        for(size_t k = 0; k < size; k++) {
+            uint8_t swap = a[k];
+            a[k] = b[k];
+            b[k] = swap;
+        }
+    }
+}
+
+#ifdef FURI_DEBUG
+bool rng_self_test(const Rng* rng) {
+    Rng copy = *rng;
+    uint16_t bins[RNG_TEST_BINS] = {0};
+    for(uint32_t i = 0; i < RNG_TEST_BINS * RNG_TEST_DRAWS; i++) {
+        bins[rng_uniform(&copy, RNG_TEST_BINS)]++;
+    }
+
+    // chi-square times the expected count of a bin
+    uint32_t sum = 0;
+    for(uint8_t i = 0; i < RNG_TEST_BINS; i++) {
+        int32_t difference = bins[i] - RNG_TEST_DRAWS;
+        sum += difference * difference;
+    }
+
+    bool passed = sum * 10 < RNG_TEST_LIMIT_TENTHS * RNG_TEST_DRAWS;
+    if(passed) {
+        FURI_LOG_I(RNG_TAG, "Chi-square %lu/%u, uniform", sum, RNG_TEST_DRAWS);
+    } else {
+        FURI_LOG_E(RNG_TAG, "Chi-square %lu/%u, not uniform", sum, RNG_TEST_DRAWS);
+    }
+    return passed;
+}
+#endif
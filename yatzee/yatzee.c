@@ -10,12 +10,20 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "rng.h"
+
 #define BASE_X 18
 #define BASE_Y 44
 #define DICE_OFFSET 12
 #define HOLD "*"
 #define MAX_DICE 5
 #define NUM_SCORES 13
+#define NUM_FACES 6
+// sorted rolls of five dice
+#define NUM_ROLLS 252
+// sorted handfuls of none up to five dice, the rolls numbered last
+#define NUM_KEEPS 462
+#define ROLL_OFFSET (NUM_KEEPS - NUM_ROLLS)
 
 bool new_game = true;
 bool game_over = false;
@@ -38,7 +46,6 @@ typedef struct {
     bool used;
     int8_t row;
     int8_t col;
-    uint8_t (*fn)(); // pointer to function that calculates score
 } Score;
 
 typedef struct {
@@ -97,301 +104,244 @@ uint8_t upperScore = 0;
 int32_t lowerScore = 0;
 int32_t totalScore = 0;
 uint8_t roll = 0;
+Rng rng;
 uint8_t totalrolls = 0;
 
 // #############################################
-// # The following methods add the score for   #
-// # whichever number is mentioned.            #
+// # Scoring                                   #
+// # A roll is counted once into how many dice #
+// # show each face, every category score of   #
+// # every possible roll is looked up in a     #
+// # table filled in when the app starts.      #
 // #############################################
-static uint8_t ones() {
-    uint8_t sum = 0;
-    for(uint8_t i = 0; i < 5; i++) {
-        if(die[i].value == 1) {
-            sum++;
-        }
-    }
-    return sum;
-}
 
-static uint8_t twos() {
-    uint8_t sum = 0;
-    for(uint8_t i = 0; i < 5; i++) {
-        if(die[i].value == 2) {
-            sum = sum + 2;
+// order of the scorecard
+typedef enum {
+    ScoreOnes,
+    ScoreTwos,
+    ScoreThrees,
+    ScoreFours,
+    ScoreFives,
+    ScoreSixes,
+    ScoreThreeKind,
+    ScoreFourKind,
+    ScoreFullHouse,
+    ScoreSmallStraight,
+    ScoreLargeStraight,
+    ScoreChance,
+    ScoreYatzee,
+} ScoreCategory;
+
+// dice showing each face, counts[0] are the ones
+uint8_t counts[NUM_FACES];
+// index of the current roll into roll_scores
+uint16_t current_roll = 0;
+
+// binomial[n][k] for numbering the sorted dice
+static uint16_t binomial[NUM_FACES + MAX_DICE][MAX_DICE + 1];
+// where the numbers of 0, 1, ... 5 dice start, the 252 rolls of five come last
+static uint16_t keep_offset[MAX_DICE + 1];
+static uint8_t roll_scores[NUM_ROLLS][NUM_SCORES];
+
+// Number of a handful of dice between 0 and NUM_KEEPS, given by how many show each face.
+// Sorted, the dice are a combination with repetition and get its rank in the combinatorial
+// number system.
+static uint16_t dice_index(const uint8_t* dice) {
+    uint16_t index = 0;
+    uint8_t size = 0;
+    for(uint8_t face = 0; face < NUM_FACES; face++) {
+        for(uint8_t i = 0; i < dice[face]; i++) {
+            size++;
+            index += binomial[face + size - 1][size];
         }
     }
-    return sum;
+    return keep_offset[size] + index;
 }
 
-static uint8_t threes() {
-    uint8_t sum = 0;
-    for(uint8_t i = 0; i < 5; i++) {
-        if(die[i].value == 3) {
-            sum = sum + 3;
+// Steps to the next way of putting the same number of dice on the faces, false after the last
+static bool dice_next(uint8_t* dice) {
+    for(uint8_t face = 0; face < NUM_FACES - 1; face++) {
+        if(dice[face]) {
+            uint8_t rest = dice[face] - 1;
+            dice[face] = 0;
+            dice[face + 1]++;
+            dice[0] = rest;
+            return true;
         }
     }
-    return sum;
+    return false;
 }
 
-static uint8_t fours() {
-    uint8_t sum = 0;
-    for(uint8_t i = 0; i < 5; i++) {
-        if(die[i].value == 4) {
-            sum = sum + 4;
+// Steps to the next handful out of the dice, starting from none, false after all of them
+static bool dice_next_keep(uint8_t* keep, const uint8_t* dice) {
+    for(uint8_t face = 0; face < NUM_FACES; face++) {
+        if(keep[face] < dice[face]) {
+            keep[face]++;
+            return true;
         }
+        keep[face] = 0;
     }
-    return sum;
+    return false;
 }
 
-static uint8_t fives() {
+static void score_roll(const uint8_t* dice, uint8_t* scores) {
     uint8_t sum = 0;
-    for(uint8_t i = 0; i < 5; i++) {
-        if(die[i].value == 5) {
-            sum = sum + 5;
-        }
+    uint8_t most = 0;
+    uint8_t run = 0;
+    uint8_t longest = 0;
+    bool pair = false;
+    bool three = false;
+
+    for(uint8_t face = 0; face < NUM_FACES; face++) {
+        scores[ScoreOnes + face] = dice[face] * (face + 1);
+        sum += scores[ScoreOnes + face];
+        most = MAX(most, dice[face]);
+        run = dice[face] ? run + 1 : 0;
+        longest = MAX(longest, run);
+        pair |= dice[face] == 2;
+        three |= dice[face] == 3;
     }
-    return sum;
+
+    scores[ScoreThreeKind] = most >= 3 ? sum : 0;
+    scores[ScoreFourKind] = most >= 4 ? sum : 0;
+    scores[ScoreFullHouse] = three && pair ? 25 : 0;
+    scores[ScoreSmallStraight] = longest >= 4 ? 30 : 0;
+    scores[ScoreLargeStraight] = longest == 5 ? 40 : 0;
+    scores[ScoreChance] = sum;
+    scores[ScoreYatzee] = most == 5 ? 50 : 0;
 }
 
-static uint8_t sixes() {
-    uint8_t sum = 0;
-    for(uint8_t i = 0; i < 5; i++) {
-        if(die[i].value == 6) {
-            sum = sum + 6;
+static void scores_init() {
+    for(uint8_t n = 0; n < NUM_FACES + MAX_DICE; n++) {
+        binomial[n][0] = 1;
+        for(uint8_t k = 1; k <= MAX_DICE; k++) {
+            binomial[n][k] = n ? binomial[n - 1][k - 1] + binomial[n - 1][k] : 0;
         }
     }
-    return sum;
-}
-
-// ####################################################
-// # Helper methods for the special score types       #
-// # defined before them so they can be used          #
-// # since this whole thing is a linear mess          #
-// # lol.                                             #
-// # add_dice:                                        #
-// #    inputs: none                                  #
-// #    output: int8_t value of roll                  #
-// # check_if_score_used:
-// #    inputs: Score
-// #    output: true if score.used = true
-// # # # # # # # # # # # # # # # # # # # # # # # # # #
-int8_t add_dice() {
-    int8_t sum = 0;
-    for(int8_t i = 0; i < MAX_DICE; i++) {
-        sum += die[i].value;
+    for(uint8_t size = 1; size <= MAX_DICE; size++) {
+        keep_offset[size] = keep_offset[size - 1] + binomial[NUM_FACES + size - 2][size - 1];
     }
-    return sum;
-}
 
-bool check_if_score_used(Score score) {
-    if(score.used == true) {
-        return true;
-    } else {
-        return false;
-    }
+    uint8_t dice[NUM_FACES] = {MAX_DICE};
+    do {
+        score_roll(dice, roll_scores[dice_index(dice) - ROLL_OFFSET]);
+    } while(dice_next(dice));
 }
 
-// #############################################
-// # Methods to calculate scores for the fancy #
-// # scoring types: 3 of a kind, 4 of a kind,  #
-// # Full house, small straight, large straight#
-// # chance & yatzee.                          #
-// #############################################
-static uint8_t threekind() {
-    int8_t score = 0;
-    for(int8_t num = 1; num < 7; num++) {
-        int8_t sum = 0;
-
-        for(int8_t i = 0; i < MAX_DICE; i++) {
-            if(die[i].value == num) {
-                sum++;
-            }
-            if(sum > 2) {
-                score = add_dice();
-            }
-        }
+// count the dice once after they change
+static void count_dice() {
+    memset(counts, 0, sizeof(counts));
+    for(uint8_t i = 0; i < MAX_DICE; i++) {
+        counts[die[i].value - 1]++;
     }
-    return score;
+    current_roll = dice_index(counts) - ROLL_OFFSET;
 }
 
-static uint8_t fourkind() {
-    int8_t score = 0;
-    for(int8_t num = 1; num < 7; num++) {
-        int8_t sum = 0;
+// Scorecard in the order of ScoreCategory
+Score scorecard[13] = {
+    {.name = "1", .value = 0, .used = false, .row = 0, .col = 0},
+    {.name = "2", .value = 0, .used = false, .row = 1, .col = 0},
+    {.name = "3", .value = 0, .used = false, .row = 2, .col = 0},
+    {.name = "4", .value = 0, .used = false, .row = 3, .col = 0},
+    {.name = "5", .value = 0, .used = false, .row = 0, .col = 1},
+    {.name = "6", .value = 0, .used = false, .row = 1, .col = 1},
+    {.name = "3k", .value = 0, .used = false, .row = 2, .col = 1},
+    {.name = "4k", .value = 0, .used = false, .row = 3, .col = 1},
+    {.name = "Fh", .value = 0, .used = false, .row = 0, .col = 2},
+    {.name = "Sm", .value = 0, .used = false, .row = 1, .col = 2},
+    {.name = "Lg", .value = 0, .used = false, .row = 2, .col = 2},
+    {.name = "Ch", .value = 0, .used = false, .row = 3, .col = 2},
+    {.name = "Yz", .value = 0, .used = false, .row = 2, .col = 3},
+};
 
-        for(int8_t i = 0; i < MAX_DICE; i++) {
-            if(die[i].value == num) {
-                sum++;
-            }
-            if(sum > 3) {
-                score = add_dice();
-            }
-        }
-    }
-    return score;
+static uint8_t score(uint8_t category) {
+    return roll_scores[current_roll][category];
 }
 
-static uint8_t fullhouse() {
-    bool check1 = false;
-    bool check2 = false;
-    int8_t val1 = 0;
-    int8_t val2 = 0;
-    UNUSED(val2);
-    UNUSED(val1);
-
-    //check 1 for three of a kind
-    for(int8_t num = 1; num < 7; num++) {
-        int8_t sum = 0;
-
-        for(int8_t i = 0; i < MAX_DICE; i++) {
-            if(die[i].value == num) {
-                sum++;
-            }
-            if(sum > 2) {
-                val1 = die[i].value;
-                check1 = true;
-            }
-        }
-    }
-
-    // return if check 1 failed
-    if(check1 == false) {
-        return 0;
-    }
+// #############################################
+// # Hold advisor                              #
+// # Finds the dice to hold that score the     #
+// # most this turn on average, over the       #
+// # rerolls left and the open categories.     #
+// #############################################
 
-    // check 2 for two of a kind.
-    for(int8_t num = 1; num < 7; num++) {
-        if(num == val1) {
-            continue;
-        }
-        int8_t sum = 0;
-
-        for(int8_t i = 0; i < MAX_DICE; i++) {
-            if(die[i].value == num) {
-                sum++;
-            }
-            if(sum > 1) {
-                val2 = die[i].value;
-                check2 = true;
-            }
-        }
-        if(check1 && check2) {
-            return 25;
+// Expected points of every handful of dice kept for a reroll. The last NUM_ROLLS are the
+// rolls themselves, worth what they score with one reroll less.
+static float keep_values[NUM_KEEPS];
+// dice to hold as a bitmask of die[]
+uint8_t advice = 0;
+bool advisor = true;
+
+// best the roll scores in an open category, another yatzee gets its bonus
+static float final_value(uint16_t roll) {
+    uint8_t best = 0;
+    for(uint8_t i = 0; i < NUM_SCORES; i++) {
+        if(!scorecard[i].used) {
+            best = MAX(best, roll_scores[roll][i]);
+        } else if(i == ScoreYatzee) {
+            best = MAX(best, 2 * roll_scores[roll][i]);
         }
     }
-    return 0;
+    return best;
 }
 
-// # # # # # # # # # # # # # # # # # # # # # # # # # # #
-// # I'm dumb so I asked ChatGPT to write the          #
-// # smallstraight function for me. Then I adapted it  #
-// # fo the largestraight function.                    #
-// # # # # # # # # # # # # # # # # # # # # # # # # # # #
-static uint8_t smallstraight() {
-    // Create a new array with the frequencies of the different die faces
-    int8_t frequencies[6] = {0};
-
-    for(int8_t i = 0; i < 5; i++) {
-        int8_t face = die[i].value;
-        frequencies[face - 1]++;
-    }
-
-    // Check if there is a sequence of 4 consecutive die faces with at least one die
-    bool found_small_straight = false;
-    for(int i = 0; i < 3 && !found_small_straight; i++) {
-        if(frequencies[i] > 0 && frequencies[i + 1] > 0 && frequencies[i + 2] > 0 &&
-           frequencies[i + 3] > 0) {
-            found_small_straight = true;
+// Best handful out of the dice by keep_values, written to keep
+static float best_keep(const uint8_t* dice, uint8_t* keep) {
+    uint8_t trial[NUM_FACES] = {0};
+    float best = -1;
+    do {
+        float value = keep_values[dice_index(trial)];
+        if(value > best) {
+            best = value;
+            if(keep) memcpy(keep, trial, sizeof(trial));
         }
-    }
-
-    if(found_small_straight) {
-        return 30;
-    } else {
-        return 0;
-    }
+    } while(dice_next_keep(trial, dice));
+    return best;
 }
 
-static uint8_t largestraight() {
-    // Create a new array with the frequencies of the different die faces
-    int8_t frequencies[6] = {0};
+static void advise() {
+    advice = 0;
+    if(totalrolls == 0 || totalrolls >= 3) return;
 
-    for(int8_t i = 0; i < 5; i++) {
-        int8_t face = die[i].value;
-        frequencies[face - 1]++;
+    float* roll_values = keep_values + ROLL_OFFSET;
+    for(uint16_t roll = 0; roll < NUM_ROLLS; roll++) {
+        roll_values[roll] = final_value(roll);
     }
 
-    // Check if there is a sequence of 4 consecutive die faces with at least one die
-    bool found_large_straight = false;
-    for(int i = 0; i < 3 && !found_large_straight; i++) {
-        if(frequencies[i] > 0 && frequencies[i + 1] > 0 && frequencies[i + 2] > 0 &&
-           frequencies[i + 3] > 0 && frequencies[i + 4] > 0) {
-            found_large_straight = true;
+    for(uint8_t reroll = 3 - totalrolls; reroll > 0; reroll--) {
+        // a handful is worth the average of itself with one more die, down to none kept
+        for(int8_t size = MAX_DICE - 1; size >= 0; size--) {
+            uint8_t dice[NUM_FACES] = {size};
+            do {
+                float sum = 0;
+                for(uint8_t face = 0; face < NUM_FACES; face++) {
+                    dice[face]++;
+                    sum += keep_values[dice_index(dice)];
+                    dice[face]--;
+                }
+                keep_values[dice_index(dice)] = sum / NUM_FACES;
+            } while(dice_next(dice));
         }
-    }
 
-    if(found_large_straight) {
-        return 40;
-    } else {
-        return 0;
-    }
-}
-
-static uint8_t chance() {
-    // chance allows your roll to count for the raw number of pips showing
-    int8_t sum = 0;
-    for(int8_t i = 0; i < MAX_DICE; i++) {
-        sum += die[i].value;
+        if(reroll == 1) break;
+        // before the last reroll a roll is worth the best it can hold for the next one,
+        // the handfuls it holds are all smaller so rolls can be overwritten one by one
+        uint8_t dice[NUM_FACES] = {MAX_DICE};
+        do {
+            roll_values[dice_index(dice) - ROLL_OFFSET] = best_keep(dice, NULL);
+        } while(dice_next(dice));
     }
-    return sum;
-}
 
-static uint8_t yatzee() {
-    // checks if all die.values are equal to the first die
-    int8_t val = die[0].value;
-    for(int8_t i = 1; i < MAX_DICE; i++) {
-        // if value is the same as the first die, continue to next
-        if(die[i].value == val) {
-            continue;
-        } else {
-            // if any value is not equal to the first die,
-            // this is not a yatzee and we return 0
-            return 0;
+    uint8_t keep[NUM_FACES];
+    best_keep(counts, keep);
+    for(uint8_t i = 0; i < MAX_DICE; i++) {
+        if(keep[die[i].value - 1]) {
+            keep[die[i].value - 1]--;
+            advice |= 1 << i;
         }
     }
-    return 50;
 }
 
-// # # # # # # # # # # # # # # # # # # # # # # # # # #
-// # Method to return true if yatzee returns 50      #
-// #                                                 #
-// # # # # # # # # # # # # # # # # # # # # # # # # # #
-// static bool check_for_bonus_yatzee() {
-//   if (yatzee()==50){
-//     return true;
-//   } else {
-//     return false;
-//   }
-// }
-
-// Scorecard defined here so that we can use pointers to the functions
-// defined above
-Score scorecard[13] = {
-    {.name = "1", .value = 0, .used = false, .row = 0, .col = 0, .fn = &ones},
-    {.name = "2", .value = 0, .used = false, .row = 1, .col = 0, .fn = &twos},
-    {.name = "3", .value = 0, .used = false, .row = 2, .col = 0, .fn = &threes},
-    {.name = "4", .value = 0, .used = false, .row = 3, .col = 0, .fn = &fours},
-    {.name = "5", .value = 0, .used = false, .row = 0, .col = 1, .fn = &fives},
-    {.name = "6", .value = 0, .used = false, .row = 1, .col = 1, .fn = &sixes},
-    {.name = "3k", .value = 0, .used = false, .row = 2, .col = 1, .fn = &threekind},
-    {.name = "4k", .value = 0, .used = false, .row = 3, .col = 1, .fn = &fourkind},
-    {.name = "Fh", .value = 0, .used = false, .row = 0, .col = 2, .fn = &fullhouse},
-    {.name = "Sm", .value = 0, .used = false, .row = 1, .col = 2, .fn = &smallstraight},
-    {.name = "Lg", .value = 0, .used = false, .row = 2, .col = 2, .fn = &largestraight},
-    {.name = "Ch", .value = 0, .used = false, .row = 3, .col = 2, .fn = &chance},
-    {.name = "Yz", .value = 0, .used = false, .row = 2, .col = 3, .fn = &yatzee},
-};
-
 // #############################################
 // # begin draw callback                       #
 // #                                           #
@@ -416,7 +366,7 @@ static void app_draw_callback(Canvas* canvas, void* ctx) {
         snprintf(
             bigbuffer,
             sizeof(bigbuffer),
-            "Up: Roll\nLeft/Right: Move cursor\nOK: Hold Die\nDown: Score");
+            "Up: Roll\nLeft/Right: Move cursor\nOK: Hold Die, long: Hints\nDown: Score");
         elements_multiline_text_aligned(canvas, 0, 8, AlignLeft, AlignTop, bigbuffer);
         elements_button_center(canvas, "Start!");
         return;
@@ -482,6 +432,14 @@ static void app_draw_callback(Canvas* canvas, void* ctx) {
             }
         }
 
+        // Frames the dice the advisor would hold for the next roll
+        for(int8_t i = 0; advisor && i < MAX_DICE; i++) {
+            if(advice & (1 << i)) {
+                canvas_draw_rframe(
+                    canvas, position[die[i].index].x - 1, position[die[i].index].y - 1, 18, 18, 2);
+            }
+        }
+
         // Update die cursor location
         if(cursor.index != -1) {
             elements_multiline_text_aligned(
@@ -512,7 +470,7 @@ static void app_draw_callback(Canvas* canvas, void* ctx) {
         // otherwise, show current scores value.
         for(int8_t i = 0; i < 8; i++) {
             if(scoreCursor.index == i && scorecard[i].used == false) {
-                int possiblescore = (int)(*scorecard[i].fn)();
+                int possiblescore = score(i);
 
                 snprintf(buffer, sizeof(buffer), "%s: %3u ", scorecard[i].name, possiblescore);
                 canvas_draw_str_aligned(
@@ -542,7 +500,7 @@ static void app_draw_callback(Canvas* canvas, void* ctx) {
         // NUM_SCORES minus one because the yatzee is 12 and is handled separately
         for(int8_t i = 8; i < NUM_SCORES - 1; i++) {
             if(scoreCursor.index == i && scorecard[i].used == false) {
-                int possiblescore = (int)(*scorecard[i].fn)();
+                int possiblescore = score(i);
 
                 snprintf(buffer, sizeof(buffer), " %s: %3u ", scorecard[i].name, possiblescore);
                 canvas_draw_str_aligned(
@@ -570,7 +528,7 @@ static void app_draw_callback(Canvas* canvas, void* ctx) {
 
         // update yatzee score
         if(scoreCursor.index == 12 && scorecard[12].used == false) {
-            int possiblescore = (int)(*scorecard[12].fn)();
+            int possiblescore = score(ScoreYatzee);
 
             snprintf(buffer, sizeof(buffer), "Yz\n%u", possiblescore);
             elements_multiline_text_aligned(canvas, 93, 10, AlignCenter, AlignTop, buffer);
@@ -642,9 +600,11 @@ static void roll_dice() {
     for(uint8_t i = 0; i < MAX_DICE; i++) {
         // dont reroll if the dice is being held
         if(die[i].isHeld == false) {
-            die[i].value = 1 + rand() % 6;
+            die[i].value = 1 + rng_uniform(&rng, NUM_FACES);
         }
     }
+    count_dice();
+    advise();
     // if 3 rolls have been used, force user to select a score.
     if(totalrolls == 3) {
         scoreCursor.index = 0;
@@ -659,6 +619,7 @@ static void clear_board() {
     }
     scoreCursor.index = -1;
     cursor.index = 0;
+    advice = 0;
 }
 
 static void add_score() {
@@ -671,7 +632,7 @@ static void add_score() {
 
     // extra yatzee scores
     if(scoreCursor.index == 12 && scorecard[scoreCursor.index].used) {
-        uint8_t yatzee_score = (*scorecard[12].fn)();
+        uint8_t yatzee_score = score(ScoreYatzee);
         scorecard[12].value += 2 * yatzee_score;
         lowerScore += 100;
         num_bonus_yatzees++;
@@ -680,7 +641,7 @@ static void add_score() {
     // upper score
     for(int8_t i = 0; i < 6; i++) {
         if(scoreCursor.index == i && scorecard[scoreCursor.index].used == false) {
-            scorecard[i].value = (*scorecard[i].fn)();
+            scorecard[i].value = score(i);
             upperScore += scorecard[i].value;
             scorecard[i].used = true;
         }
@@ -689,7 +650,7 @@ static void add_score() {
     // lower score
     for(int8_t i = 6; i < 13; i++) {
         if(scoreCursor.index == i && scorecard[scoreCursor.index].used == false) {
-            scorecard[i].value = (*scorecard[i].fn)();
+            scorecard[i].value = score(i);
             lowerScore += scorecard[i].value;
             scorecard[i].used = true;
         }
@@ -704,6 +665,13 @@ static void add_score() {
 int32_t yatzee_main(void* p) {
     UNUSED(p);
 
+    rng_init(&rng);
+#ifdef FURI_DEBUG
+    rng_self_test(&rng);
+#endif
+    scores_init();
+    count_dice();
+
     // Initialize event queue to handle incoming events like button presses
     // Use FuriMessageQueue as type as defined in furi api
     // InputEvents are supported by app_input_callback
@@ -731,7 +699,13 @@ int32_t yatzee_main(void* p) {
             cursor.index = -1;
         }
         if(furi_message_queue_get(event_queue, &event, 100) == FuriStatusOk) {
-            if((event.type == InputTypePress) || event.type == InputTypeRepeat) {
+            bool pressed = event.type == InputTypePress || event.type == InputTypeRepeat;
+            // OK holds a die on release, so that holding it down can toggle the hints
+            if(event.key == InputKeyOk) {
+                pressed = event.type == InputTypeShort;
+                if(event.type == InputTypeLong) advisor = !advisor;
+            }
+            if(pressed) {
                 switch(event.key) {
                 case InputKeyLeft:
                     if(cursor.index == -1) {